@@ -1,4 +1,5 @@
 #include <adf/wrapper/wrapper.h>
+#include <algorithm>
 #include <xtlm.h>
 #define BUSWIDTH 128
 
@@ -34,6 +35,8 @@ public:
   void read128(uint64_t Addr, uint32_t *Data);
   void writeGM(uint64_t addr, const void *data, uint64_t size);
   void readGM(uint64_t addr, void *data, uint64_t size);
+  void writeBlock(uint64_t addr, const uint32_t *data, uint64_t count);
+  void readBlock(uint64_t addr, uint32_t *data, uint64_t count);
   void aximm_transaction(xtlm::xtlm_aximm_initiator_rd_socket_util &rd_util,
                          xtlm::xtlm_aximm_initiator_wr_socket_util &wr_util,
                          xtlm::xtlm_command command, unsigned long long address,
@@ -46,6 +49,8 @@ private:
   static PSIP_ps_i3 *psObj;
   // Sets attributes for PS-ME, common to both R/W transaction
   void set_payload_attr(xtlm::aximm_payload *trans, size_t transBytes);
+  void blockTransaction(xtlm::xtlm_command command, uint64_t addr,
+                        unsigned char *data, uint64_t size);
   void main_action();
   void response_process();
   sc_event transRspAvail;
@@ -166,6 +171,47 @@ void PSIP_ps_i3::readGM(uint64_t addr, void *data, uint64_t size) {
   toggle_AIE_array_clk.notify(SC_ZERO_TIME);
 }
 
+void PSIP_ps_i3::writeBlock(uint64_t addr, const uint32_t *data,
+                            uint64_t count) {
+  blockTransaction(xtlm::XTLM_WRITE_COMMAND, addr, (unsigned char *)data,
+                   count * sizeof(uint32_t));
+}
+
+void PSIP_ps_i3::readBlock(uint64_t addr, uint32_t *data, uint64_t count) {
+  blockTransaction(xtlm::XTLM_READ_COMMAND, addr, (unsigned char *)data,
+                   count * sizeof(uint32_t));
+}
+
+// Move consecutive words between the host and the memory of a tile in as few
+// transactions as possible: the words before the first 16-byte boundary and
+// after the last one go one at a time, and the 16-byte beats in between in
+// bursts of at most 4096 bytes, which may not cross a 4KB boundary.
+void PSIP_ps_i3::blockTransaction(xtlm::xtlm_command command, uint64_t addr,
+                                  unsigned char *data, uint64_t size) {
+  auto word = [&]() {
+    if (command == xtlm::XTLM_WRITE_COMMAND)
+      write32(addr, *(uint32_t *)data);
+    else
+      *(uint32_t *)data = read32(addr);
+    addr += sizeof(uint32_t);
+    data += sizeof(uint32_t);
+    size -= sizeof(uint32_t);
+  };
+  while (size && addr % 16)
+    word();
+  while (size >= 16) {
+    uint64_t burst =
+        std::min<uint64_t>(size & ~uint64_t(15), 4096 - addr % 4096);
+    aximm_transaction(*PS_AxiMM_Rd_Util, *PS_AxiMM_Wr_Util, command, addr,
+                      data, burst);
+    addr += burst;
+    data += burst;
+    size -= burst;
+  }
+  while (size)
+    word();
+}
+
 void PSIP_ps_i3::aximm_transaction(
     xtlm::xtlm_aximm_initiator_rd_socket_util &rd_util,
     xtlm::xtlm_aximm_initiator_wr_socket_util &wr_util,
@@ -287,6 +333,12 @@ void ess_WriteGM(uint64 addr, const void *data, uint64_t size) {
 void ess_ReadGM(uint64 addr, void *data, uint64_t size) {
   (PSIP_ps_i3::getInstance())->readGM(addr, data, size);
 }
+void ess_WriteBlock(uint64 addr, const uint32_t *data, uint64_t count) {
+  (PSIP_ps_i3::getInstance())->writeBlock(addr, data, count);
+}
+void ess_ReadBlock(uint64 addr, uint32_t *data, uint64_t count) {
+  (PSIP_ps_i3::getInstance())->readBlock(addr, data, count);
+}
 IPBlock *create_ip(sc_module_name name) {
   return (PSIP_ps_i3::createInstance(name));
 }
@@ -0,0 +1,151 @@
+//===-  nn_ops.h - softmax and normalization kernels for bfloat16 rows -===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This is the implementation of the softmax, layernorm and RMSnorm of a row of
+// bfloat16 values, and of the reductions they are built from. The rows are
+// processed by vectors of 16 lanes, so their size must be a multiple of 16.
+// The sums are accumulated in accfloat accumulators, and the exponential and
+// the inverse come from the lookup tables of lut_based_ops.cpp, which must be
+// linked with the kernel.
+//===----------------------------------------------------------------------===//
+
+#ifndef NN_OPS_H
+#define NN_OPS_H
+
+#include "aie_api/aie.hpp"
+#include "lut_based_ops.h"
+#include "vec_math.h"
+
+// Get the largest of the n values of in.
+inline __attribute__((always_inline)) bfloat16
+getRowMaxBf16(const bfloat16 *__restrict in, int n) {
+  aie::vector<bfloat16, 16> maxVec = aie::load_v<16>(in);
+  for (int i = 16; i < n; i += 16)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      maxVec = aie::max(maxVec, aie::load_v<16>(in + i));
+    }
+  return aie::reduce_max(maxVec);
+}
+
+// Store exp(in[i] - max) in out, and return the sum of the stored values.
+inline __attribute__((always_inline)) float
+getRowExpSumBf16(const bfloat16 *__restrict in, bfloat16 *__restrict out,
+                 bfloat16 max, int n) {
+  const aie::vector<bfloat16, 16> maxVec = aie::broadcast<bfloat16, 16>(max);
+  aie::accum<accfloat, 16> sumAcc;
+  sumAcc.from_vector(aie::zeros<bfloat16, 16>());
+  for (int i = 0; i < n; i += 16)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      aie::vector<bfloat16, 16> x = aie::sub(aie::load_v<16>(in + i), maxVec);
+      aie::accum<accfloat, 16> expAcc = getExpBf16(x);
+      aie::vector<bfloat16, 16> expVec = expAcc.to_vector<bfloat16>();
+      aie::store_v(out + i, expVec);
+      sumAcc = aie::add(sumAcc, expVec);
+    }
+  return aie::reduce_add(sumAcc.to_vector<float>());
+}
+
+// Multiply the n values of inout by scale.
+inline __attribute__((always_inline)) void
+scaleRowBf16(bfloat16 *__restrict inout, bfloat16 scale, int n) {
+  for (int i = 0; i < n; i += 16)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      aie::accum<accfloat, 16> acc =
+          aie::mul(aie::load_v<16>(inout + i), scale);
+      aie::store_v(inout + i, acc.to_vector<bfloat16>());
+    }
+}
+
+// Store the softmax of the n values of in in out. The max is subtracted from
+// the values before the exponential for it not to overflow, and the sum of the
+// exponentials is accumulated as they are stored, so that the row is read
+// twice from in and once from out.
+inline __attribute__((always_inline)) void
+softmaxBf16(const bfloat16 *__restrict in, bfloat16 *__restrict out, int n) {
+  bfloat16 max = getRowMaxBf16(in, n);
+  float sum = getRowExpSumBf16(in, out, max, n);
+  scaleRowBf16(out, getInvBf16(sum), n);
+}
+
+// Get the sum and the sum of the squares of the n values of in, in one pass.
+inline __attribute__((always_inline)) void
+getRowMomentsBf16(const bfloat16 *__restrict in, int n, float &sum,
+                  float &sumSquares) {
+  const aie::vector<bfloat16, 16> one = aie::broadcast<bfloat16, 16>(1.0f);
+  aie::accum<accfloat, 16> sumAcc, squaresAcc;
+  sumAcc.from_vector(aie::zeros<bfloat16, 16>());
+  squaresAcc.from_vector(aie::zeros<bfloat16, 16>());
+  for (int i = 0; i < n; i += 16)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      aie::vector<bfloat16, 16> x = aie::load_v<16>(in + i);
+      sumAcc = aie::mac(sumAcc, x, one);
+      squaresAcc = aie::mac(squaresAcc, x, x);
+    }
+  sum = aie::reduce_add(sumAcc.to_vector<float>());
+  sumSquares = aie::reduce_add(squaresAcc.to_vector<float>());
+}
+
+// Get 1 / sqrt(x) for a scalar x, with the vector implementation.
+inline __attribute__((always_inline)) bfloat16 getRsqrtBf16(float x) {
+  aie::vector<bfloat16, 16> xVec = aie::broadcast<bfloat16, 16>(x);
+  aie::vector<bfloat16, 16> rsqrtX = getRsqrtBf16((v16bfloat16)xVec);
+  return rsqrtX[0];
+}
+
+// Store (in[i] - mean) / sqrt(var + epsilon) * gamma[i] + beta[i] in out, with
+// the mean and the variance of the n values of in. The statistics are
+// computed in a single pass over in, and the normalization in a second one.
+inline __attribute__((always_inline)) void
+layerNormBf16(const bfloat16 *__restrict in, const bfloat16 *__restrict gamma,
+              const bfloat16 *__restrict beta, bfloat16 *__restrict out, int n,
+              float epsilon) {
+  float sum, sumSquares;
+  getRowMomentsBf16(in, n, sum, sumSquares);
+  float invN = 1.0f / n;
+  float mean = sum * invN;
+  float var = sumSquares * invN - mean * mean;
+  const aie::vector<bfloat16, 16> meanVec = aie::broadcast<bfloat16, 16>(mean);
+  const bfloat16 rstd = getRsqrtBf16(var + epsilon);
+  for (int i = 0; i < n; i += 16)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      aie::vector<bfloat16, 16> centered =
+          aie::sub(aie::load_v<16>(in + i), meanVec);
+      aie::accum<accfloat, 16> scale =
+          aie::mul(aie::load_v<16>(gamma + i), rstd);
+      aie::accum<accfloat, 16> acc;
+      acc.from_vector(aie::load_v<16>(beta + i));
+      acc = aie::mac(acc, centered, scale.to_vector<bfloat16>());
+      aie::store_v(out + i, acc.to_vector<bfloat16>());
+    }
+}
+
+// Store in[i] / sqrt(mean(in^2) + epsilon) * gamma[i] in out.
+inline __attribute__((always_inline)) void
+rmsNormBf16(const bfloat16 *__restrict in, const bfloat16 *__restrict gamma,
+            bfloat16 *__restrict out, int n, float epsilon) {
+  aie::accum<accfloat, 16> squaresAcc;
+  squaresAcc.from_vector(aie::zeros<bfloat16, 16>());
+  for (int i = 0; i < n; i += 16)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      aie::vector<bfloat16, 16> x = aie::load_v<16>(in + i);
+      squaresAcc = aie::mac(squaresAcc, x, x);
+    }
+  float meanSquares = aie::reduce_add(squaresAcc.to_vector<float>()) / n;
+  const bfloat16 rrms = getRsqrtBf16(meanSquares + epsilon);
+  for (int i = 0; i < n; i += 16)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      aie::accum<accfloat, 16> scale =
+          aie::mul(aie::load_v<16>(gamma + i), rrms);
+      aie::accum<accfloat, 16> acc =
+          aie::mul(aie::load_v<16>(in + i), scale.to_vector<bfloat16>());
+      aie::store_v(out + i, acc.to_vector<bfloat16>());
+    }
+}
+
+#endif // NN_OPS_H
@@ -22,6 +22,12 @@ MLIR_CAPI_EXPORTED void aieRegisterAllDialects(MlirContext context);
 /** Registers all AIE passes for symbolic access with the global registry. */
 MLIR_CAPI_EXPORTED void aieRegisterAllPasses();
 
+/** Registers the AIE extensions of upstream dialects, such as the AIEVec
+ * transform ops, with a registry.
+ */
+MLIR_CAPI_EXPORTED void
+aieRegisterAllDialectExtensions(MlirDialectRegistry registry);
+
 #ifdef __cplusplus
 }
 #endif
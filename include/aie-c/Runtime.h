@@ -0,0 +1,81 @@
+//===- Runtime.h ------------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_C_RUNTIME_H
+#define AIE_C_RUNTIME_H
+
+#include "mlir-c/Support.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** A kernel of an xclbin loaded on a RyzenAI NPU, with its IPU instructions
+ * and the host buffers of its buffer sets. A run can be in flight on each
+ * buffer set at the same time. This is the runtime of the XCLBin of the
+ * Python bindings.
+ */
+typedef struct AieXCLBin AieXCLBin;
+
+/** Returns the error of the last runtime call that failed on this thread. */
+MLIR_CAPI_EXPORTED const char *aieRuntimeGetLastError(void);
+
+/** Loads the xclbin on the device and creates a hardware context for its
+ * kernel. Returns null on failure.
+ */
+MLIR_CAPI_EXPORTED AieXCLBin *aieXCLBinCreate(const char *xclBinPath,
+                                              const char *kernelName,
+                                              int deviceIndex);
+
+MLIR_CAPI_EXPORTED void aieXCLBinDestroy(AieXCLBin *xclBin);
+
+/** Loads the IPU instructions shared by all the runs. Loading instructions of
+ * the same size again reuses the instruction buffer and the prepared runs.
+ */
+MLIR_CAPI_EXPORTED MlirLogicalResult
+aieXCLBinLoadInstructions(AieXCLBin *xclBin, const uint32_t *insts,
+                          size_t count);
+
+/** Loads the IPU instructions of the runs after the first one, which skip
+ * the persistent transfers of the data resident in the array.
+ */
+MLIR_CAPI_EXPORTED MlirLogicalResult
+aieXCLBinLoadResidentInstructions(AieXCLBin *xclBin, const uint32_t *insts,
+                                  size_t count);
+
+/** Allocates a zeroed host buffer of the given size as the next kernel
+ * argument of the buffer set. Returns the host mapping of the buffer, valid
+ * until the xclbin is destroyed, or null on failure.
+ */
+MLIR_CAPI_EXPORTED void *aieXCLBinAddBuffer(AieXCLBin *xclBin,
+                                            size_t bufferSet, size_t bytes);
+
+/** Syncs the buffers of the set to the device and starts a run on them. If a
+ * run is still in flight on the set, this waits for it first.
+ */
+MLIR_CAPI_EXPORTED MlirLogicalResult aieXCLBinSubmit(AieXCLBin *xclBin,
+                                                     size_t bufferSet);
+
+/** Returns whether the last run submitted on the buffer set has finished. */
+MLIR_CAPI_EXPORTED bool aieXCLBinIsDone(AieXCLBin *xclBin, size_t bufferSet);
+
+/** Waits for the last run submitted on the buffer set, at most timeoutMs
+ * milliseconds unless it is 0, and syncs the buffers of the set back from the
+ * device. Fails if the run times out or does not complete.
+ */
+MLIR_CAPI_EXPORTED MlirLogicalResult aieXCLBinWait(AieXCLBin *xclBin,
+                                                   size_t bufferSet,
+                                                   unsigned timeoutMs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AIE_C_RUNTIME_H
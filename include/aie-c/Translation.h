@@ -19,11 +19,58 @@ MLIR_CAPI_EXPORTED MlirStringRef aieTranslateAIEVecToCpp(MlirOperation op,
                                                          bool aieml);
 MLIR_CAPI_EXPORTED MlirStringRef aieTranslateModuleToLLVMIR(MlirOperation op);
 MLIR_CAPI_EXPORTED MlirStringRef aieTranslateToIPU(MlirOperation op);
+MLIR_CAPI_EXPORTED MlirStringRef aieTranslateToIPUPatches(MlirOperation op);
 MLIR_CAPI_EXPORTED MlirStringRef aieTranslateToXAIEV2(MlirOperation op);
 MLIR_CAPI_EXPORTED MlirStringRef aieTranslateToBCF(MlirOperation op, int col,
                                                    int row);
+MLIR_CAPI_EXPORTED MlirStringRef aieTranslateToLdScript(MlirOperation op,
+                                                        int col, int row);
 MLIR_CAPI_EXPORTED MlirStringRef aieLLVMLink(MlirStringRef *modules,
-                                             int nModules);
+                                             int nModules, int optLevel);
+/// The fields of the shim tile BD written by an IPU instruction.
+typedef struct {
+  uint32_t column;
+  uint32_t columnNum;
+  uint32_t ddrId;
+  uint32_t bdId;
+  uint32_t bufferLength;
+  uint32_t bufferOffset;
+  uint32_t enablePacket;
+  uint32_t outOfOrderId;
+  uint32_t packetId;
+  uint32_t packetType;
+  uint32_t d0Size;
+  uint32_t d0Stride;
+  uint32_t d1Size;
+  uint32_t d1Stride;
+  uint32_t d2Stride;
+  uint32_t iterationCurrent;
+  uint32_t iterationSize;
+  uint32_t iterationStride;
+  uint32_t nextBd;
+  uint32_t useNextBd;
+  uint32_t validBd;
+  uint32_t lockRelVal;
+  uint32_t lockRelId;
+  uint32_t lockAcqEnable;
+  uint32_t lockAcqVal;
+  uint32_t lockAcqId;
+  /// 64, 128 or 256 bytes, the latter for any other value.
+  uint32_t burstLength;
+  uint32_t axCache;
+  uint32_t axQos;
+} AieIPUShimTileBD;
+/// Encode an IPU instruction into the given words, 2 for a sync, 3 for a
+/// write32 and 10 for a shim tile BD, as in aieTranslateToIPU.
+MLIR_CAPI_EXPORTED void aieIPUEncodeSync(uint32_t *words, uint32_t column,
+                                         uint32_t row, uint32_t direction,
+                                         uint32_t channel, uint32_t columnNum,
+                                         uint32_t rowNum);
+MLIR_CAPI_EXPORTED void aieIPUEncodeWrite32(uint32_t *words, uint32_t column,
+                                            uint32_t row, uint32_t address,
+                                            uint32_t value);
+MLIR_CAPI_EXPORTED void
+aieIPUEncodeWriteBdShimTile(uint32_t *words, const AieIPUShimTileBD *bd);
 MLIR_CAPI_EXPORTED MlirLogicalResult aieTranslateToCDODirect(
     MlirOperation moduleOp, MlirStringRef workDirPath, bool bigEndian,
     bool emitUnified, bool axiDebug, bool aieSim, size_t partitionStartCol);
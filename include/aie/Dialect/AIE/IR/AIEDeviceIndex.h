@@ -0,0 +1,77 @@
+//===- AIEDeviceIndex.h -----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// An index of the ops of a device by tile and by symbol, built in a single
+// walk of the device. It is an analysis, so a pass gets it with
+// `getAnalysis<DeviceIndex>()`, and a pass that doesn't add, erase or move
+// the indexed ops marks it preserved for the passes that follow.
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_DEVICEINDEX_H
+#define AIE_DEVICEINDEX_H
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+
+namespace xilinx::AIE {
+
+class DeviceIndex {
+public:
+  explicit DeviceIndex(mlir::Operation *op);
+
+  /// Return the tile at the given coordinates, or null if there is none.
+  TileOp getTile(TileID id) const { return tiles.lookup(id); }
+  TileOp getTile(int col, int row) const { return getTile({col, row}); }
+
+  /// Return the last tile of the device, or null if there is none.
+  TileOp getLastTile() const { return lastTile; }
+
+  /// Return the buffers of a tile, in the order of the device.
+  llvm::ArrayRef<BufferOp> getBuffers(TileOp tile) const;
+
+  /// Return the locks of a tile, in the order of the device.
+  llvm::ArrayRef<LockOp> getLocks(TileOp tile) const;
+
+  /// Return the DMA ops (aie.mem, aie.memtile_dma and aie.shim_dma) of a
+  /// tile.
+  llvm::ArrayRef<mlir::Operation *> getDMAs(TileOp tile) const;
+
+  /// Return the op of the device defining the symbol, or null if there is
+  /// none.
+  mlir::Operation *lookupSymbol(llvm::StringRef name) const {
+    return symbols.lookup(name);
+  }
+
+  /// Return the first shim DMA allocation of the symbol, or nothing if it
+  /// has none.
+  std::optional<ShimDMAAllocationOp>
+  getShimDMAAllocation(llvm::StringRef symName) const;
+
+  /// Record ops created after the index was built.
+  void addTile(TileOp tile);
+  void addBuffer(BufferOp buffer);
+  void addLock(LockOp lock);
+
+private:
+  llvm::DenseMap<TileID, TileOp> tiles;
+  TileOp lastTile;
+  llvm::DenseMap<mlir::Operation *, llvm::SmallVector<BufferOp, 4>> buffers;
+  llvm::DenseMap<mlir::Operation *, llvm::SmallVector<LockOp, 4>> locks;
+  llvm::DenseMap<mlir::Operation *, llvm::SmallVector<mlir::Operation *, 1>>
+      dmas;
+  llvm::StringMap<mlir::Operation *> symbols;
+  llvm::StringMap<ShimDMAAllocationOp> shimDMAAllocations;
+};
+
+} // namespace xilinx::AIE
+
+#endif // AIE_DEVICEINDEX_H
@@ -45,6 +45,11 @@ struct HasValidDMAChannels
 };
 
 class TileOp;
+
+// Whether the given tile element (e.g. CoreOp, BufferOp) is declared on a group
+// of tiles, such as an AIEX herd, rather than on a TileOp. Such an element has
+// no tile coordinates until it is lowered to the tiles of the group.
+bool isHerdElement(mlir::Operation *op);
 } // namespace xilinx::AIE
 
 namespace xilinx::AIE {
@@ -255,6 +260,13 @@ void printObjectFifoConsumerTiles(mlir::OpAsmPrinter &printer,
 
 int32_t getBufferBaseAddress(mlir::Operation *bufOp);
 
+// Verify the AXI settings of a shim DMA BD: the length of its bursts in bytes
+// and the AxCACHE and AxQoS bits of its transactions.
+mlir::LogicalResult verifyShimAxiSettings(mlir::Operation *op,
+                                          std::optional<int64_t> burstLength,
+                                          std::optional<int64_t> axCache,
+                                          std::optional<int64_t> axQos);
+
 } // namespace xilinx::AIE
 
 // include TableGen generated Op definitions
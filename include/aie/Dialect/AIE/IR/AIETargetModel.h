@@ -16,6 +16,7 @@
 #include "llvm/ADT/DenseSet.h"
 
 #include <iostream>
+#include <vector>
 
 namespace xilinx::AIE {
 
@@ -52,6 +53,9 @@ using TileID = struct TileID {
   int col, row;
 };
 
+/// The type of a tile of the device.
+enum class AIETileType : uint8_t { None, ShimNOC, ShimPL, Mem, Core };
+
 class AIETargetModel {
 public:
   AIETargetModel() = default;
@@ -67,27 +71,47 @@ public:
   /// Return the number of rows in the device.
   virtual int rows() const = 0;
 
+  /// Return the type of the given tile.  This and the queries below read the
+  /// tables built by buildTables() for the tiles of the device, and only
+  /// compute the answer for the tiles outside of it.
+  AIETileType getTileType(int col, int row) const {
+    if (isInTables(col, row))
+      return tileTypes[getTableIndex(col, row)];
+    return computeTileType(col, row);
+  }
+
   /// Return true if the given tile is a 'Core' tile.  These tiles
   /// include a Core, TileDMA, tile memory, and stream connections.
-  virtual bool isCoreTile(int col, int row) const = 0;
+  bool isCoreTile(int col, int row) const {
+    return getTileType(col, row) == AIETileType::Core;
+  }
 
   /// Return true if the given tile is an AIE2 'Memory' tile.  These tiles
   /// include a TileDMA, tile memory, and stream connections, but no core.
-  virtual bool isMemTile(int col, int row) const = 0;
+  bool isMemTile(int col, int row) const {
+    return getTileType(col, row) == AIETileType::Mem;
+  }
 
   /// Return true if the given tile is a Shim NOC tile.  These tiles include a
   /// ShimDMA and a connection to the memory-mapped NOC.  They do not contain
   /// any memory.
-  virtual bool isShimNOCTile(int col, int row) const = 0;
+  bool isShimNOCTile(int col, int row) const {
+    return getTileType(col, row) == AIETileType::ShimNOC;
+  }
 
   /// Return true if the given tile is a Shim PL interface tile.  These
   /// tiles do not include a ShimDMA and instead include connections to the PL.
   /// They do not contain any memory.
-  virtual bool isShimPLTile(int col, int row) const = 0;
+  bool isShimPLTile(int col, int row) const {
+    return getTileType(col, row) == AIETileType::ShimPL;
+  }
 
   /// Return true if the given tile is either a Shim NOC or a Shim PL interface
   /// tile.
-  virtual bool isShimNOCorPLTile(int col, int row) const = 0;
+  bool isShimNOCorPLTile(int col, int row) const {
+    AIETileType type = getTileType(col, row);
+    return type == AIETileType::ShimNOC || type == AIETileType::ShimPL;
+  }
 
   /// Return true if the given tile ID is valid.
   virtual bool isValidTile(TileID src) const {
@@ -165,6 +189,13 @@ public:
   /// Return the size (in bytes) of the local data memory of a core.
   virtual uint32_t getLocalMemorySize() const = 0;
 
+  /// Return the size (in bytes) of the program memory of a core.
+  virtual uint32_t getProgramMemorySize() const = 0;
+
+  /// Return the number of banks the data memory of the given tile is split
+  /// into.  All banks have the same size.
+  virtual uint32_t getNumBanks(int col, int row) const = 0;
+
   /// Return the number of lock objects
   virtual uint32_t getNumLocks(int col, int row) const = 0;
 
@@ -177,13 +208,20 @@ public:
   virtual uint32_t getMemTileSize() const = 0;
   /// Return the number of destinations of connections inside a switchbox. These
   /// are the targets of connect operations in the switchbox.
-  virtual uint32_t getNumDestSwitchboxConnections(int col, int row,
-                                                  WireBundle bundle) const = 0;
+  uint32_t getNumDestSwitchboxConnections(int col, int row,
+                                          WireBundle bundle) const {
+    if (isInTables(col, row))
+      return destSwitchboxConnections[getTableIndex(col, row, bundle)];
+    return computeNumDestSwitchboxConnections(col, row, bundle);
+  }
   /// Return the number of sources of connections inside a switchbox.  These are
   /// the origins of connect operations in the switchbox.
-  virtual uint32_t
-  getNumSourceSwitchboxConnections(int col, int row,
-                                   WireBundle bundle) const = 0;
+  uint32_t getNumSourceSwitchboxConnections(int col, int row,
+                                            WireBundle bundle) const {
+    if (isInTables(col, row))
+      return sourceSwitchboxConnections[getTableIndex(col, row, bundle)];
+    return computeNumSourceSwitchboxConnections(col, row, bundle);
+  }
   /// Return the number of destinations of connections inside a shimmux.  These
   /// are the targets of connect operations in the switchbox.
   virtual uint32_t getNumDestShimMuxConnections(int col, int row,
@@ -200,15 +238,49 @@ public:
 
   // Run consistency checks on the target model.
   void validate() const;
+
+protected:
+  /// Compute the type of the given tile.
+  virtual AIETileType computeTileType(int col, int row) const = 0;
+  /// Compute the number of destinations of connections inside a switchbox.
+  virtual uint32_t
+  computeNumDestSwitchboxConnections(int col, int row,
+                                     WireBundle bundle) const = 0;
+  /// Compute the number of sources of connections inside a switchbox.
+  virtual uint32_t
+  computeNumSourceSwitchboxConnections(int col, int row,
+                                       WireBundle bundle) const = 0;
+
+  /// Precompute the answers of the queries above for every tile of the
+  /// device.  This must be called by the constructor of each concrete model,
+  /// once the geometry it depends on is initialized.
+  void buildTables();
+
+private:
+  static constexpr unsigned numBundles = getMaxEnumValForWireBundle() + 1;
+
+  bool isInTables(int col, int row) const {
+    return col >= 0 && col < tableColumns && row >= 0 && row < tableRows;
+  }
+  size_t getTableIndex(int col, int row) const {
+    return static_cast<size_t>(col) * tableRows + row;
+  }
+  size_t getTableIndex(int col, int row, WireBundle bundle) const {
+    return getTableIndex(col, row) * numBundles +
+           static_cast<unsigned>(bundle);
+  }
+
+  int tableColumns = 0;
+  int tableRows = 0;
+  std::vector<AIETileType> tileTypes;
+  std::vector<uint8_t> destSwitchboxConnections;
+  std::vector<uint8_t> sourceSwitchboxConnections;
 };
 
 class AIE1TargetModel : public AIETargetModel {
 public:
   AIE1TargetModel() = default;
 
-  bool isCoreTile(int col, int row) const override { return row > 0; }
-  bool isMemTile(int col, int row) const override { return false; }
-
   AIEArch getTargetArch() const override;
 
   std::optional<TileID> getMemWest(TileID src) const override;
@@ -239,15 +311,13 @@ public:
   uint32_t getMemNorthBaseAddress() const override { return 0x00030000; }
   uint32_t getMemEastBaseAddress() const override { return 0x00038000; }
   uint32_t getLocalMemorySize() const override { return 0x00008000; }
+  uint32_t getProgramMemorySize() const override { return 0x00004000; }
+  uint32_t getNumBanks(int col, int row) const override { return 8; }
   uint32_t getNumLocks(int col, int row) const override { return 16; }
   uint32_t getNumBDs(int col, int row) const override { return 16; }
   uint32_t getNumMemTileRows() const override { return 0; }
   uint32_t getMemTileSize() const override { return 0; }
 
-  uint32_t getNumDestSwitchboxConnections(int col, int row,
-                                          WireBundle bundle) const override;
-  uint32_t getNumSourceSwitchboxConnections(int col, int row,
-                                            WireBundle bundle) const override;
   uint32_t getNumDestShimMuxConnections(int col, int row,
                                         WireBundle bundle) const override;
   uint32_t getNumSourceShimMuxConnections(int col, int row,
@@ -264,6 +334,14 @@ public:
       return true;
     return false;
   }
+
+protected:
+  uint32_t
+  computeNumDestSwitchboxConnections(int col, int row,
+                                     WireBundle bundle) const override;
+  uint32_t
+  computeNumSourceSwitchboxConnections(int col, int row,
+                                       WireBundle bundle) const override;
 };
 
 class AIE2TargetModel : public AIETargetModel {
@@ -296,6 +374,11 @@ public:
   uint32_t getMemNorthBaseAddress() const override { return 0x00060000; }
   uint32_t getMemEastBaseAddress() const override { return 0x00070000; }
   uint32_t getLocalMemorySize() const override { return 0x00010000; }
+  uint32_t getProgramMemorySize() const override { return 0x00004000; }
+
+  uint32_t getNumBanks(int col, int row) const override {
+    return isMemTile(col, row) ? 16 : 8;
+  }
 
   uint32_t getNumLocks(int col, int row) const override {
     return isMemTile(col, row) ? 64 : 16;
@@ -307,10 +390,6 @@ public:
 
   uint32_t getMemTileSize() const override { return 0x00080000; }
 
-  uint32_t getNumDestSwitchboxConnections(int col, int row,
-                                          WireBundle bundle) const override;
-  uint32_t getNumSourceSwitchboxConnections(int col, int row,
-                                            WireBundle bundle) const override;
   uint32_t getNumDestShimMuxConnections(int col, int row,
                                         WireBundle bundle) const override;
   uint32_t getNumSourceShimMuxConnections(int col, int row,
@@ -318,6 +397,14 @@ public:
   bool isLegalMemtileConnection(WireBundle srcBundle, int srcChan,
                                 WireBundle dstBundle,
                                 int dstChan) const override;
+
+protected:
+  uint32_t
+  computeNumDestSwitchboxConnections(int col, int row,
+                                     WireBundle bundle) const override;
+  uint32_t
+  computeNumSourceSwitchboxConnections(int col, int row,
+                                       WireBundle bundle) const override;
 };
 
 class VC1902TargetModel : public AIE1TargetModel {
@@ -325,22 +412,18 @@ class VC1902TargetModel : public AIE1TargetModel {
       2, 3, 6, 7, 10, 11, 18, 19, 26, 27, 34, 35, 42, 43, 46, 47};
 
 public:
-  VC1902TargetModel() = default;
+  VC1902TargetModel() { buildTables(); }
 
   int columns() const override { return 50; }
 
   int rows() const override { return 9; /* One Shim row and 8 Core rows. */ }
 
-  bool isShimNOCTile(int col, int row) const override {
-    return row == 0 && nocColumns.contains(col);
-  }
-
-  bool isShimPLTile(int col, int row) const override {
-    return row == 0 && !nocColumns.contains(col);
-  }
-
-  bool isShimNOCorPLTile(int col, int row) const override {
-    return isShimNOCTile(col, row) || isShimPLTile(col, row);
+protected:
+  AIETileType computeTileType(int col, int row) const override {
+    if (row == 0)
+      return nocColumns.contains(col) ? AIETileType::ShimNOC
+                                      : AIETileType::ShimPL;
+    return row > 0 ? AIETileType::Core : AIETileType::None;
   }
 };
 
@@ -348,7 +431,7 @@ class VE2302TargetModel : public AIE2TargetModel {
   llvm::SmallDenseSet<unsigned, 8> nocColumns = {2, 3, 6, 7, 10, 11};
 
 public:
-  VE2302TargetModel() = default;
+  VE2302TargetModel() { buildTables(); }
 
   int columns() const override { return 17; }
 
@@ -356,21 +439,6 @@ public:
     return 4; /* One Shim row, 1 memtile rows, and 2 Core rows. */
   }
 
-  bool isCoreTile(int col, int row) const override { return row > 1; }
-  bool isMemTile(int col, int row) const override { return row == 1; }
-
-  bool isShimNOCTile(int col, int row) const override {
-    return row == 0 && nocColumns.contains(col);
-  }
-
-  bool isShimPLTile(int col, int row) const override {
-    return row == 0 && !nocColumns.contains(col);
-  }
-
-  bool isShimNOCorPLTile(int col, int row) const override {
-    return isShimNOCTile(col, row) || isShimPLTile(col, row);
-  }
-
   uint32_t getNumMemTileRows() const override { return 1; }
 
   bool isValidTraceMaster(int col, int row, WireBundle destBundle,
@@ -393,6 +461,16 @@ public:
       return true;
     return false;
   }
+
+protected:
+  AIETileType computeTileType(int col, int row) const override {
+    if (row == 0)
+      return nocColumns.contains(col) ? AIETileType::ShimNOC
+                                      : AIETileType::ShimPL;
+    if (row > 0 && row <= static_cast<int>(getNumMemTileRows()))
+      return AIETileType::Mem;
+    return row > 0 ? AIETileType::Core : AIETileType::None;
+  }
 };
 
 class VE2802TargetModel : public AIE2TargetModel {
@@ -400,7 +478,7 @@ class VE2802TargetModel : public AIE2TargetModel {
                                                   22, 23, 30, 31, 34, 35};
 
 public:
-  VE2802TargetModel() = default;
+  VE2802TargetModel() { buildTables(); }
 
   int columns() const override { return 38; }
 
@@ -408,24 +486,6 @@ public:
     return 11; /* One Shim row, 2 memtile rows, and 8 Core rows. */
   }
 
-  bool isCoreTile(int col, int row) const override { return row > 2; }
-
-  bool isMemTile(int col, int row) const override {
-    return row == 1 || row == 2;
-  }
-
-  bool isShimNOCTile(int col, int row) const override {
-    return row == 0 && nocColumns.contains(col);
-  }
-
-  bool isShimPLTile(int col, int row) const override {
-    return row == 0 && !nocColumns.contains(col);
-  }
-
-  bool isShimNOCorPLTile(int col, int row) const override {
-    return isShimNOCTile(col, row) || isShimPLTile(col, row);
-  }
-
   uint32_t getNumMemTileRows() const override { return 2; }
 
   bool isValidTraceMaster(int col, int row, WireBundle destBundle,
@@ -448,13 +508,23 @@ public:
       return true;
     return false;
   }
+
+protected:
+  AIETileType computeTileType(int col, int row) const override {
+    if (row == 0)
+      return nocColumns.contains(col) ? AIETileType::ShimNOC
+                                      : AIETileType::ShimPL;
+    if (row > 0 && row <= static_cast<int>(getNumMemTileRows()))
+      return AIETileType::Mem;
+    return row > 0 ? AIETileType::Core : AIETileType::None;
+  }
 };
 
 class IPUTargetModel : public AIE2TargetModel {
   llvm::SmallDenseSet<unsigned, 16> nocColumns = {0, 1, 2, 3};
 
 public:
-  IPUTargetModel() = default;
+  IPUTargetModel() { buildTables(); }
 
   int columns() const override { return 5; }
 
@@ -462,22 +532,91 @@ public:
     return 6; /* 1 Shim row, 1 memtile row, and 4 Core rows. */
   }
 
-  bool isCoreTile(int col, int row) const override { return row > 1; }
-  bool isMemTile(int col, int row) const override { return row == 1; }
+  uint32_t getNumMemTileRows() const override { return 1; }
 
-  bool isShimNOCTile(int col, int row) const override {
-    return row == 0 && nocColumns.contains(col);
+  bool isValidTraceMaster(int col, int row, WireBundle destBundle,
+                          int destIndex) const override {
+    if (isCoreTile(col, row) && destBundle == WireBundle::South)
+      return true;
+    if (isCoreTile(col, row) && destBundle == WireBundle::DMA && destIndex == 0)
+      return true;
+    if (isMemTile(col, row) && destBundle == WireBundle::South)
+      return true;
+    if (isMemTile(col, row) && destBundle == WireBundle::DMA && destIndex == 5)
+      return true;
+    if (isShimNOCorPLTile(col, row) && destBundle == WireBundle::South)
+      return true;
+    if (isShimNOCorPLTile(col, row) && destBundle == WireBundle::West &&
+        destIndex == 0)
+      return true;
+    if (isShimNOCorPLTile(col, row) && destBundle == WireBundle::East &&
+        destIndex == 0)
+      return true;
+    return false;
   }
 
-  bool isShimPLTile(int col, int row) const override {
-    return row == 0 && !nocColumns.contains(col);
+protected:
+  AIETileType computeTileType(int col, int row) const override {
+    if (row == 0)
+      return nocColumns.contains(col) ? AIETileType::ShimNOC
+                                      : AIETileType::ShimPL;
+    if (row > 0 && row <= static_cast<int>(getNumMemTileRows()))
+      return AIETileType::Mem;
+    return row > 0 ? AIETileType::Core : AIETileType::None;
   }
+};
 
-  bool isShimNOCorPLTile(int col, int row) const override {
-    return isShimNOCTile(col, row) || isShimPLTile(col, row);
+/// The geometry of a device of the NPU family.  The defaults describe the
+/// Phoenix array of the IPU target.
+struct NPUGeometry {
+  int columns = 5;
+  int memTileRows = 1;
+  int coreRows = 4;
+  /// The columns whose shim tile is a Shim NOC tile; the others are Shim PL
+  /// tiles.
+  std::vector<unsigned> nocColumns = {0, 1, 2, 3};
+  uint32_t shimBDs = 16;
+  uint32_t memTileBDs = 48;
+  uint32_t coreBDs = 16;
+
+  bool operator<(const NPUGeometry &rhs) const {
+    return std::tie(columns, memTileRows, coreRows, nocColumns, shimBDs,
+                    memTileBDs, coreBDs) <
+           std::tie(rhs.columns, rhs.memTileRows, rhs.coreRows, rhs.nocColumns,
+                    rhs.shimBDs, rhs.memTileBDs, rhs.coreBDs);
   }
+};
 
-  uint32_t getNumMemTileRows() const override { return 1; }
+/// An AIE2 device of the NPU family whose geometry is given by the
+/// description of the device instead of being fixed.
+class NPUTargetModel : public AIE2TargetModel {
+  NPUGeometry geometry;
+  llvm::SmallDenseSet<unsigned, 16> nocColumns;
+
+public:
+  explicit NPUTargetModel(const NPUGeometry &geometry)
+      : geometry(geometry),
+        nocColumns(geometry.nocColumns.begin(), geometry.nocColumns.end()) {
+    buildTables();
+  }
+
+  const NPUGeometry &getGeometry() const { return geometry; }
+
+  int columns() const override { return geometry.columns; }
+
+  int rows() const override {
+    return 1 + geometry.memTileRows + geometry.coreRows;
+  }
+
+  uint32_t getNumMemTileRows() const override { return geometry.memTileRows; }
+
+  uint32_t getNumBDs(int col, int row) const override {
+    if (isMemTile(col, row))
+      return geometry.memTileBDs;
+    if (isShimNOCorPLTile(col, row))
+      return geometry.shimBDs;
+    return geometry.coreBDs;
+  }
 
   bool isValidTraceMaster(int col, int row, WireBundle destBundle,
                           int destIndex) const override {
@@ -499,6 +638,16 @@ public:
       return true;
     return false;
   }
+
+protected:
+  AIETileType computeTileType(int col, int row) const override {
+    if (row == 0)
+      return nocColumns.contains(col) ? AIETileType::ShimNOC
+                                      : AIETileType::ShimPL;
+    if (row > 0 && row <= geometry.memTileRows)
+      return AIETileType::Mem;
+    return row > 0 ? AIETileType::Core : AIETileType::None;
+  }
 };
 
 } // namespace xilinx::AIE
@@ -0,0 +1,54 @@
+//===- AIELiveRanges.h ------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_LIVE_RANGES_H
+#define AIE_LIVE_RANGES_H
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+namespace xilinx::AIE {
+
+// The live ranges of the memrefs accessed by a core, shared by
+// aie-reuse-buffers and aie-allocate-scratchpads. The operations of the core
+// are numbered in program order, and the live range of a memref spans the
+// operations from its first to its last access, and all the operations of any
+// loop containing one of them.
+class CoreLiveRanges {
+public:
+  CoreLiveRanges(CoreOp core);
+
+  // Whether each region of the core has a single block. Control flow between
+  // blocks would need a proper liveness analysis, so the live ranges are only
+  // computed for the cores where this holds.
+  bool isStructured() const { return structured; }
+
+  // Collect the operations of the core accessing a memref, following the
+  // memrefs derived from it. Returns false if the memref escapes the core or
+  // flows into a loop-carried value or a terminator, where accesses can't be
+  // tracked, or if a memref other than the result of a memref.alloc is
+  // deallocated. The deallocations are not accesses.
+  bool collectAccesses(mlir::Value memref,
+                       llvm::SmallVectorImpl<mlir::Operation *> &accesses);
+
+  // Return the first and last positions of the live range spanning the
+  // accesses, each one hoisted to the outermost loop around it in the core.
+  std::pair<int, int> getLiveRange(llvm::ArrayRef<mlir::Operation *> accesses);
+
+private:
+  CoreOp core;
+  bool structured = true;
+  llvm::DenseMap<mlir::Operation *, int> first, last;
+};
+
+} // namespace xilinx::AIE
+
+#endif // AIE_LIVE_RANGES_H
@@ -41,7 +41,26 @@ std::unique_ptr<mlir::OperationPass<DeviceOp>>
 createAIEObjectFifoStatefulTransformPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>>
 createAIEObjectFifoRegisterProcessPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIEObjectFifoTuneDepthsPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIEObjectFifoAnalyzeDataflowPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIEObjectFifoPropagateLayoutsPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIEPlaceTilesPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIECascadeReductionsPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIELowerCascadeFlowsPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIEReuseBuffersPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIEAllocateScratchpadsPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIECompactBDChainsPass();
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createAIESplitCoresPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIEEstimateCoreCyclesPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIEResourceInitialValuesPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIESelectFlowSwitchingPass();
 
 /// Generate the code for registering passes.
 #define GEN_PASS_REGISTRATION
@@ -59,10 +78,13 @@ std::unique_ptr<mlir::OperationPass<DeviceOp>> createAIELowerCascadeFlowsPass();
 struct AIEPathfinderPass : AIERoutePathfinderFlowsBase<AIEPathfinderPass> {
 
   DynamicTileAnalysis analyzer;
+  // Set when the pass was created with a custom router, in which case the
+  // Pathfinder options of the pass do not apply.
+  bool customRouter = false;
 
   AIEPathfinderPass() = default;
   AIEPathfinderPass(DynamicTileAnalysis analyzer)
-      : analyzer(std::move(analyzer)) {}
+      : analyzer(std::move(analyzer)), customRouter(true) {}
 
   void runOnOperation() override;
 
@@ -65,6 +65,7 @@ using Channel = struct Channel {
   int usedCapacity = 0; // how many flows are actually using this Channel
   std::set<int> fixedCapacity; // channels not available to the algorithm
   int overCapacityCount = 0;   // history of Channel being over capacity
+  double bandwidthUsage = 0.0; // estimated MB/s carried by this Channel
 };
 
 struct SwitchboxNode;
@@ -184,6 +185,8 @@ using PathEndPointNode = struct PathEndPointNode : PathEndPoint {
 using FlowNode = struct FlowNode {
   PathEndPointNode src;
   std::vector<PathEndPointNode> dsts;
+  // Expected throughput in MB/s; 0 if the flow has no bandwidth annotation.
+  double bandwidth = 0.0;
 };
 
 class Router {
@@ -195,21 +198,59 @@ public:
   virtual void initialize(int maxCol, int maxRow,
                           const AIETargetModel &targetModel) = 0;
   virtual void addFlow(TileID srcCoords, Port srcPort, TileID dstCoords,
-                       Port dstPort) = 0;
+                       Port dstPort, double bandwidth) = 0;
   virtual bool addFixedConnection(ConnectOp connectOp) = 0;
+  // Keep track of the ports used by packet-switched routes. Routers which do
+  // not model packet-switched routes can ignore them.
+  virtual void addFixedPacketConnection(MasterSetOp masterSetOp) {}
+  virtual void addFixedPacketConnection(PacketRulesOp packetRulesOp) {}
   virtual std::optional<std::map<PathEndPoint, SwitchSettings>>
   findPaths(int maxIterations) = 0;
   virtual Switchbox *getSwitchbox(TileID coords) = 0;
 };
 
+// Options controlling the search performed by Pathfinder::findPaths.
+struct PathfinderOptions {
+  // After the first iteration, rip up and reroute only the flows that cross
+  // an overused channel, connecting each destination with an A* search.
+  bool incremental = false;
+  // Run the shortest-path searches of one iteration concurrently against the
+  // channel demands at the start of the iteration, then merge their channel
+  // usage in flow order.  The routing is deterministic but may differ from
+  // the sequential mode, which updates demands after every flow.
+  bool parallel = false;
+  // Context providing the thread pool for parallel routing.
+  mlir::MLIRContext *context = nullptr;
+  // Include the estimated utilisation of every channel, from the bandwidth
+  // annotations of the flows routed over it, in the channel demand.
+  bool bandwidthAware = false;
+  // Throughput of a single stream connection in MB/s, used to normalise the
+  // channel utilisation.
+  double linkBandwidth = 4000.0;
+};
+
+// The outgoing channels of the switchbox with id `i` are
+// `channels[offsets[i]]` to `channels[offsets[i + 1] - 1]`, ordered by the id
+// of their target, which is also in `targets` so that a search can scan them
+// without following the pointers.
+struct SwitchboxCSR {
+  std::vector<SwitchboxNode *> nodes;
+  std::vector<size_t> offsets;
+  std::vector<int> targets;
+  std::vector<ChannelEdge *> channels;
+};
+
 class Pathfinder : public Router {
 public:
   Pathfinder() = default;
+  explicit Pathfinder(PathfinderOptions options) : options(options) {}
   void initialize(int maxCol, int maxRow,
                   const AIETargetModel &targetModel) override;
   void addFlow(TileID srcCoords, Port srcPort, TileID dstCoords,
-               Port dstPort) override;
+               Port dstPort, double bandwidth) override;
   bool addFixedConnection(ConnectOp connectOp) override;
+  void addFixedPacketConnection(MasterSetOp masterSetOp) override;
+  void addFixedPacketConnection(PacketRulesOp packetRulesOp) override;
   std::optional<std::map<PathEndPoint, SwitchSettings>>
   findPaths(int maxIterations) override;
 
@@ -221,15 +262,74 @@ public:
     return *sb;
   }
 
-private:
+protected:
+  std::optional<std::map<PathEndPoint, SwitchSettings>>
+  findPathsIncremental(int maxIterations);
+
+  PathfinderOptions options;
   SwitchboxGraph graph;
   std::vector<FlowNode> flows;
   std::map<TileID, SwitchboxNode> grid;
   // Use a list instead of a vector because nodes have an edge list of raw
   // pointers to edges (so growing a vector would invalidate the pointers).
   std::list<ChannelEdge> edges;
+  // The switchbox graph in compressed sparse row form, for the shortest-path
+  // searches. Only built by initialize(), since the topology never changes
+  // afterwards.
+  SwitchboxCSR csr;
 };
 
+// A packet-switched flow: every destination of the flow receives the packets
+// carrying the given ID.
+using PacketFlowNode = struct PacketFlowNode {
+  FlowNode flow;
+  int id;
+};
+
+// The packet-switched connections of a switchbox, each tagged with the ID of
+// the packets it carries.
+using PacketConnections = std::vector<std::pair<Connect, int>>;
+
+// PacketPathfinder routes packet-switched flows on the same switchbox graph as
+// the circuit-switched flows. The connections used by the circuit-switched
+// flows, as routed by findPaths, are reserved. Each packet flow is then
+// connected with an A* search which prefers connections already carrying
+// packets with other IDs, so that compatible flows share master ports instead
+// of each claiming their own.
+class PacketPathfinder : public Pathfinder {
+public:
+  using Pathfinder::Pathfinder;
+  void addPacketFlow(int id, TileID srcCoords, Port srcPort, TileID dstCoords,
+                     Port dstPort);
+  // Must be called after findPaths. Returns std::nullopt if some packet flow
+  // can't be routed.
+  std::optional<std::map<TileID, PacketConnections>> findPacketPaths();
+
+private:
+  std::vector<PacketFlowNode> packetFlows;
+};
+
+// Routing along the rows and columns of the array, one switchbox at a time,
+// for the routers which work on a logical model of the switchboxes instead of
+// the SwitchboxGraph of a target: aie-herd-routing, and aie-create-packet-flows
+// without use-pathfinder.
+
+// The number of channels of each outgoing bundle of a logical switchbox.
+int getLogicalNumDestChannels(WireBundle bundle);
+
+// Build a route from the switchbox of `src` to the switchbox of `dst`. The
+// route leaves each switchbox towards the destination if it can, and by
+// another side otherwise, but never by the side it entered by.
+// `findChannel(tile, in, bundle)` returns the channel of `bundle` by which the
+// route entering the switchbox of `tile` by `in` can leave it, if any.
+// `addConnect(tile, connect)` records each connection of the route, the last
+// one ending at `dstPort`. Fails if the route gets stuck in a switchbox.
+mlir::LogicalResult buildDimensionOrderedRoute(
+    TileID src, Port srcPort, TileID dst, Port dstPort,
+    llvm::function_ref<std::optional<int>(TileID, Port, WireBundle)>
+        findChannel,
+    llvm::function_ref<void(TileID, Connect)> addConnect);
+
 // DynamicTileAnalysis integrates the Pathfinder class into the MLIR
 // environment. It passes flows to the Pathfinder as ordered pairs of ints.
 // Detailed routing is received as SwitchboxSettings
@@ -248,6 +348,14 @@ public:
 
   const int maxIterations = 1000; // how long until declared unroutable
 
+  // When not empty, the routing solutions are cached in this directory, in
+  // files named after a hash of the routing problem: the device, the tiles,
+  // the fixed connections, the flows and `routerDescription`. A cached
+  // solution is reused instead of routing the same problem again.
+  std::string cacheDir;
+  // The router and its options, which are part of the routing problem.
+  std::string routerDescription;
+
   DynamicTileAnalysis() : pathfinder(std::make_shared<Pathfinder>()) {}
   DynamicTileAnalysis(std::shared_ptr<Router> p) : pathfinder(std::move(p)) {}
 
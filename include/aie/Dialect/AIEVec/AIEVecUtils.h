@@ -19,9 +19,12 @@
 
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 
+#include <array>
 #include <cassert>
 #include <numeric>
+#include <optional>
 
 namespace xilinx::aievec {
 
@@ -244,6 +247,55 @@ isAssumingNoImplicitBroadcastOfDynamicSizes(mlir::OpBuilder &builder) {
   return isAssumingNoImplicitBroadcastOfDynamicSizes(builder.getBlock());
 }
 
+// Returns the shape `{r, s, t}` of the `aievec.matmul` multiplying an `r x s`
+// tile of `lhsTy` elements by an `s x t` tile of `rhsTy` elements into an
+// `r x t` accumulator of `accTy` elements. When several shapes are available,
+// the one with the most MACs per instruction is chosen.
+inline std::optional<std::array<int64_t, 3>>
+getAIEMLMatMulShape(mlir::Type lhsTy, mlir::Type rhsTy, mlir::Type accTy) {
+  if (lhsTy.isBF16() && rhsTy.isBF16() && accTy.isF32())
+    return {{4, 8, 4}};
+  if (accTy.isInteger(32)) {
+    if (lhsTy.isInteger(8) && rhsTy.isInteger(4))
+      return {{4, 16, 8}};
+    if (lhsTy.isInteger(8) && rhsTy.isInteger(8))
+      return {{4, 8, 8}};
+    if (lhsTy.isInteger(16) && rhsTy.isInteger(8))
+      return {{4, 4, 8}};
+    if (lhsTy.isInteger(16) && rhsTy.isInteger(16))
+      return {{4, 2, 8}};
+  }
+  if (accTy.isInteger(64)) {
+    if (lhsTy.isInteger(16) && rhsTy.isInteger(8))
+      return {{4, 8, 4}};
+    if (lhsTy.isInteger(16) && rhsTy.isInteger(16))
+      return {{4, 4, 4}};
+    if (lhsTy.isInteger(32) && rhsTy.isInteger(16))
+      return {{4, 2, 4}};
+  }
+  return std::nullopt;
+}
+
+// Return true if `op`, or any operation nested in it, may write to `memref`.
+// Operations of unknown effects are assumed to write to every buffer.
+inline bool mayWriteTo(mlir::Operation *op, mlir::Value memref) {
+  auto result = op->walk([&](mlir::Operation *nested) {
+    auto effectOp = llvm::dyn_cast<mlir::MemoryEffectOpInterface>(nested);
+    if (!effectOp) {
+      if (nested->hasTrait<mlir::OpTrait::HasRecursiveMemoryEffects>())
+        return mlir::WalkResult::advance();
+      return mlir::WalkResult::interrupt();
+    }
+    llvm::SmallVector<mlir::MemoryEffects::EffectInstance> effects;
+    effectOp.getEffects<mlir::MemoryEffects::Write>(effects);
+    for (mlir::MemoryEffects::EffectInstance &effect : effects)
+      if (!effect.getValue() || effect.getValue() == memref)
+        return mlir::WalkResult::interrupt();
+    return mlir::WalkResult::advance();
+  });
+  return result.wasInterrupted();
+}
+
 } // namespace xilinx::aievec
 // end namespace xilinx
 
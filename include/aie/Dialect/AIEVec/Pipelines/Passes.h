@@ -63,6 +63,12 @@ struct LowerVectorToAIEVecOptions
                      "will determine the aievec operations used to convert "
                      "from vector dialect."),
       llvm::cl::init("cpp")};
+  PassOptions::Option<unsigned> expLUTLanes{
+      *this, "exp-lut-lanes",
+      llvm::cl::desc("Number of lanes of the LUT-based exponential of bf16 "
+                     "vectors: 16, or 32 to also lower 32-lane exponentials "
+                     "to the variant looking up 32 lanes at once"),
+      llvm::cl::init(16)};
 };
 
 /// Options for the "optimize-aievec" pipeline.
@@ -83,6 +89,12 @@ struct OptimizeAIEVecOptions
       *this, "shift",
       llvm::cl::desc("Shift parameter for rounding and saturation"),
       llvm::cl::init(0)};
+  PassOptions::Option<bool> fuseSRSIntoUPS{
+      *this, "fuse-srs-into-ups",
+      llvm::cl::desc("Keep the float accumulator of an srs op moved back by an "
+                     "ups op, skipping the rounding of the intermediate value "
+                     "(changes the numerics)"),
+      llvm::cl::init(false)};
 };
 
 /// Options for the "convert-vector-to-aievec" pipeline.
@@ -115,17 +127,31 @@ struct ConvertVectorToAIEVecOptions
                      "will determine the aievec operations used to convert "
                      "from vector dialect."),
       llvm::cl::init("cpp")};
+  PassOptions::Option<unsigned> expLUTLanes{
+      *this, "exp-lut-lanes",
+      llvm::cl::desc("Number of lanes of the LUT-based exponential of bf16 "
+                     "vectors: 16, or 32 to also lower 32-lane exponentials "
+                     "to the variant looking up 32 lanes at once"),
+      llvm::cl::init(16)};
+  PassOptions::Option<bool> fuseSRSIntoUPS{
+      *this, "fuse-srs-into-ups",
+      llvm::cl::desc("Keep the float accumulator of an srs op moved back by an "
+                     "ups op, skipping the rounding of the intermediate value "
+                     "(changes the numerics)"),
+      llvm::cl::init(false)};
 
   mlir::LogicalResult parseFromString(mlir::StringRef options) {
     auto res = PassPipelineOptions::parseFromString(options);
     if (!failed(res)) {
       lowerOptions.aieTarget = aieTarget;
       lowerOptions.targetBackend = targetBackend;
+      lowerOptions.expLUTLanes = expLUTLanes;
       canonicalizeOptions.aieTarget = aieTarget;
       canonicalizeOptions.targetBackend = targetBackend;
       optimizeOptions.aieTarget = aieTarget;
       optimizeOptions.targetBackend = targetBackend;
       optimizeOptions.shiftParam = shiftParam;
+      optimizeOptions.fuseSRSIntoUPS = fuseSRSIntoUPS;
     }
     return res;
   }
@@ -149,6 +175,35 @@ private:
   OptimizeAIEVecOptions optimizeOptions;
 };
 
+/// Options for the "convert-tosa-to-aievec" pipeline.
+struct ConvertTosaToAIEVecOptions
+    : public mlir::PassPipelineOptions<ConvertTosaToAIEVecOptions> {
+  PassOptions::Option<std::string> aieTarget{
+      *this, "aie-target",
+      llvm::cl::desc("Select AIE version: \"aie\" or \"aieml\". This will "
+                     "determine the vector size and available operations."),
+      llvm::cl::init("aieml")};
+  PassOptions::Option<std::string> targetBackend{
+      *this, "target-backend",
+      llvm::cl::desc("Select translation backend: \"cpp\" or \"llvmir\". This "
+                     "will determine the aievec operations used to convert "
+                     "from vector dialect."),
+      llvm::cl::init("cpp")};
+  PassOptions::Option<unsigned> vectorSize{
+      *this, "vector-size",
+      llvm::cl::desc("Number of lanes the innermost loops are vectorized to"),
+      llvm::cl::init(16)};
+  PassOptions::Option<unsigned> tileSize{
+      *this, "tile-size",
+      llvm::cl::desc("Size of the tiles the loop nests are split into, each "
+                     "tile being the work of one core (0 to not tile)"),
+      llvm::cl::init(0)};
+  PassOptions::Option<unsigned> shiftParam{
+      *this, "shift",
+      llvm::cl::desc("Shift parameter for rounding and saturation"),
+      llvm::cl::init(0)};
+};
+
 //===----------------------------------------------------------------------===//
 // Building and Registering.
 //===----------------------------------------------------------------------===//
@@ -160,6 +215,14 @@ private:
 void buildConvertVectorToAIEVec(mlir::OpPassManager &pm,
                                 const ConvertVectorToAIEVecOptions &options);
 
+/// Adds the "convert-tosa-to-aievec" pipeline to the `OpPassManager`. This
+/// pipeline takes a graph of `TOSA` or `Linalg` operations on tensors, lowers
+/// it to affine loop nests on memrefs, splits them into the tiles of work of
+/// the cores, vectorizes the innermost loops and converts the result to
+/// `AIEVec` code with the "convert-vector-to-aievec" pipeline.
+void buildConvertTosaToAIEVec(mlir::OpPassManager &pm,
+                              const ConvertTosaToAIEVecOptions &options);
+
 void buildCanonicalizeVectorForAIEVec(
     mlir::OpPassManager &pm, const CanonicalizeVectorForAIEVecOptions &options);
 
@@ -12,10 +12,15 @@
 namespace mlir {
 namespace linalg {
 class GenericOp;
+class LinalgOp;
 } // namespace linalg
+namespace scf {
+class ForOp;
+} // namespace scf
 } // namespace mlir
 
 #include "mlir/Dialect/Transform/IR/TransformInterfaces.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
 
 #define GET_OP_CLASSES
 #include "aie/Dialect/AIEVec/TransformOps/AIEVecTransformOps.h.inc"
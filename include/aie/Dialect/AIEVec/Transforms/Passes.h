@@ -65,6 +65,9 @@ namespace aievec {
 #include "aie/Dialect/AIEVec/Transforms/Passes.h.inc"
 
 std::unique_ptr<mlir::Pass> createAIEVectorizePass();
+std::unique_ptr<mlir::Pass> createAIEAffineVectorizePass();
+std::unique_ptr<mlir::Pass> createAIEVecSoftwarePipelinePass();
+std::unique_ptr<mlir::Pass> createAIEVecCrossIterationReusePass();
 
 /// Generate the code for registering passes.
 #define GEN_PASS_REGISTRATION
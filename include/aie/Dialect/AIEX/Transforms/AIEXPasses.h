@@ -23,12 +23,20 @@ namespace xilinx::AIEX {
 std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>> createAIECreateCoresPass();
 std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>> createAIECreateLocksPass();
 std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>> createAIEHerdRoutingPass();
+std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>> createAIELowerHerdsPass();
 std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>> createAIELowerMemcpyPass();
 std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>>
 createAIELowerMulticastPass();
 std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>>
 createAIEBroadcastPacketPass();
 std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>> createAIEDmaToIpuPass();
+std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>>
+createAIEPipelineIpuSequencePass();
+std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>>
+createAIEElideRedundantBdWritesPass();
+std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>>
+createAIEAnalyzeShimBurstsPass();
+std::unique_ptr<mlir::OperationPass<AIE::DeviceOp>> createAIEInsertTracePass();
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createAIEXToStandardPass();
 
 /// Generate the code for registering passes.
@@ -0,0 +1,259 @@
+//===- XCLBinKernel.h -------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// The XRT runtime of a design compiled to an xclbin, shared by the XCLBin of
+// the Python bindings and by the C runtime API.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_RUNTIME_XCLBINKERNEL_H
+#define AIE_RUNTIME_XCLBINKERNEL_H
+
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace xilinx::AIE {
+
+// group_id 0 is for ipu instructions
+// group_id 1 is for number of ipu instructions
+// host side buffers/args follow starting from position 2
+// see aiecc.main.emit_design_kernel_json
+constexpr size_t HOST_BUFFERS_START_IDX = 2;
+
+inline bool isInFlight(ert_cmd_state state) {
+  switch (state) {
+  case ERT_CMD_STATE_QUEUED:
+  case ERT_CMD_STATE_SUBMITTED:
+  case ERT_CMD_STATE_RUNNING:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Host memory backed by huge pages, for the buffers of large tensors, which
+// then take a few TLB entries on the host instead of one per 4 KiB page. The
+// huge pages reserved by the system are used when some are free, otherwise
+// the memory is aligned to them and advised to be backed by transparent huge
+// pages.
+class HugePageMemory {
+public:
+  static constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+
+  explicit HugePageMemory(size_t bytes)
+      : size((bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE) {
+    data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED) {
+      mapped = true;
+      return;
+    }
+    data = std::aligned_alloc(HUGE_PAGE_SIZE, size);
+    if (!data)
+      throw std::bad_alloc();
+    madvise(data, size, MADV_HUGEPAGE);
+  }
+  HugePageMemory(const HugePageMemory &) = delete;
+  HugePageMemory &operator=(const HugePageMemory &) = delete;
+  ~HugePageMemory() {
+    if (mapped)
+      munmap(data, size);
+    else
+      std::free(data);
+  }
+
+  void *data;
+  size_t size;
+  bool mapped = false;
+};
+
+// An xclbin loaded on a device in a hw_context of its own, with the kernels
+// opened in it. Creating the hw_context loads the xclbin on the NPU, which
+// takes much longer than a run: the XCLBinKernels of the designs served in
+// turn share a preloaded context each, so that switching from one design to
+// the other costs nothing.
+class XCLBinContext {
+public:
+  XCLBinContext(const std::string &xclBinPath, int deviceIndex)
+      : xclBin(xclBinPath), device(deviceIndex) {
+    assert(device.get_info<xrt::info::device::name>().rfind("RyzenAI-", 0) ==
+               0 &&
+           "only RyzenAI NPUs supported by the xrt runtime");
+    device.register_xclbin(xclBin);
+    context = xrt::hw_context(device, xclBin.get_uuid());
+  }
+  XCLBinContext(const XCLBinContext &) = delete;
+  XCLBinContext &operator=(const XCLBinContext &) = delete;
+
+  // Return the kernel of the given name, opened once per context.
+  xrt::kernel &getKernel(const std::string &kernelName) {
+    auto it = kernels.find(kernelName);
+    if (it == kernels.end())
+      it = kernels.emplace(kernelName, xrt::kernel(context, kernelName)).first;
+    return it->second;
+  }
+
+  xrt::xclbin xclBin;
+  xrt::device device;
+  xrt::hw_context context;
+  std::map<std::string, xrt::kernel> kernels;
+};
+
+// The kernel of an xclbin with its IPU instructions and the host buffers of
+// its buffer sets. The run of each buffer set is prepared once, with its
+// arguments bound to the instructions and the buffers of the set, and
+// restarted by each startRun, so that several runs on different sets can be
+// in flight on the same hw_context.
+class XCLBinKernel {
+public:
+  XCLBinKernel(const std::string &xclBinPath, const std::string &kernelName,
+               int deviceIndex)
+      : XCLBinKernel(std::make_shared<XCLBinContext>(xclBinPath, deviceIndex),
+                     kernelName) {}
+
+  // Use the kernel of a preloaded context, shared with other XCLBinKernels.
+  XCLBinKernel(std::shared_ptr<XCLBinContext> xclBinContext,
+               const std::string &kernelName)
+      : xclBinContext(std::move(xclBinContext)),
+        device(&this->xclBinContext->device),
+        kernel(&this->xclBinContext->getKernel(kernelName)) {}
+
+  // Load the instructions, reusing the instruction BO, and the runs bound to
+  // it, when the new instructions have the same size. The next run is again
+  // a first run, moving the persistent data of the design.
+  void loadInstructions(const uint32_t *insts, size_t count) {
+    loadInstructionBO(ipuInstructions, insts, count);
+    firstRunStarted = false;
+  }
+
+  // Load the instructions of the runs after the first one, which skip the
+  // persistent transfers of the data that stays resident in the array, as
+  // generated by aiecc.py --ipu-resident-insts-name.
+  void loadResidentInstructions(const uint32_t *insts, size_t count) {
+    loadInstructionBO(residentInstructions, insts, count);
+  }
+
+  uint32_t *instructions() { return ipuInstructions->map<uint32_t *>(); }
+
+  void syncInstructions() { ipuInstructions->sync(XCL_BO_SYNC_BO_TO_DEVICE); }
+
+  // Allocate a zeroed host buffer of the given size as the next argument of
+  // the kernel in the buffer set, in huge pages if requested.
+  xrt::bo &addBuffer(size_t bufferSet, size_t bytes, bool hugePages = false) {
+    if (bufferSets.size() <= bufferSet)
+      bufferSets.resize(bufferSet + 1);
+    if (bufferSet < preparedRuns.size())
+      preparedRuns[bufferSet].reset();
+    auto &buffers = bufferSets[bufferSet];
+    auto group = kernel->group_id(HOST_BUFFERS_START_IDX + buffers.size());
+    std::unique_ptr<xrt::bo> bo;
+    if (hugePages) {
+      hostMemory.push_back(std::make_unique<HugePageMemory>(bytes));
+      bo = std::make_unique<xrt::bo>(*device, hostMemory.back()->data, bytes,
+                                     group);
+    } else {
+      bo = std::make_unique<xrt::bo>(*device, bytes, XRT_BO_FLAGS_HOST_ONLY,
+                                     group);
+    }
+    std::memset(bo->map(), 0, bytes);
+    buffers.push_back(std::move(bo));
+    return *buffers.back();
+  }
+
+  std::vector<std::unique_ptr<xrt::bo>> &getBufferSet(size_t bufferSet) {
+    if (bufferSet >= bufferSets.size())
+      throw std::runtime_error("no buffer set " + std::to_string(bufferSet));
+    return bufferSets[bufferSet];
+  }
+
+  void syncBuffers(size_t bufferSet, xclBOSyncDirection direction) {
+    for (auto &buf : getBufferSet(bufferSet))
+      buf->sync(direction);
+  }
+
+  xrt::run &getPreparedRun(size_t bufferSet) {
+    if (preparedRuns.size() <= bufferSet)
+      preparedRuns.resize(bufferSet + 1);
+    auto &run = preparedRuns[bufferSet];
+    if (run)
+      return *run;
+    if (!ipuInstructions)
+      throw std::runtime_error("no IPU instructions loaded");
+    auto &buffers = getBufferSet(bufferSet);
+    run = std::make_unique<xrt::run>(*kernel);
+    run->set_arg(0, *ipuInstructions);
+    run->set_arg(1, ipuInstructions->size());
+    for (size_t i = 0; i < buffers.size(); ++i)
+      run->set_arg(HOST_BUFFERS_START_IDX + i, *buffers[i]);
+    return *run;
+  }
+
+  // Start a run on the buffer set. A run can only be restarted once the
+  // previous one has finished, so this waits for the run in flight on the
+  // set, if any. The runs after the first one use the resident instructions,
+  // when loaded.
+  xrt::run &startRun(size_t bufferSet) {
+    xrt::run &run = getPreparedRun(bufferSet);
+    if (isInFlight(run.state()))
+      run.wait();
+    xrt::bo &insts = firstRunStarted && residentInstructions
+                         ? *residentInstructions
+                         : *ipuInstructions;
+    run.set_arg(0, insts);
+    run.set_arg(1, insts.size());
+    run.start();
+    firstRunStarted = true;
+    return run;
+  }
+
+  std::shared_ptr<XCLBinContext> xclBinContext;
+  xrt::device *device;
+  xrt::kernel *kernel;
+  std::unique_ptr<xrt::bo> ipuInstructions;
+  std::unique_ptr<xrt::bo> residentInstructions;
+  bool firstRunStarted = false;
+
+  // The memory of the buffers allocated in huge pages, which outlives them.
+  std::vector<std::unique_ptr<HugePageMemory>> hostMemory;
+  std::vector<std::vector<std::unique_ptr<xrt::bo>>> bufferSets;
+
+  std::vector<std::unique_ptr<xrt::run>> preparedRuns;
+
+private:
+  void loadInstructionBO(std::unique_ptr<xrt::bo> &bo, const uint32_t *insts,
+                         size_t count) {
+    size_t size = count * sizeof(uint32_t);
+    if (!bo || bo->size() != size) {
+      bo = std::make_unique<xrt::bo>(*device, size, XCL_BO_FLAGS_CACHEABLE,
+                                     kernel->group_id(0));
+      preparedRuns.clear();
+    }
+    std::copy(insts, insts + count, bo->map<uint32_t *>());
+    bo->sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  }
+};
+
+} // namespace xilinx::AIE
+
+#endif // AIE_RUNTIME_XCLBINKERNEL_H
@@ -32,6 +32,68 @@ mlir::LogicalResult AIETranslateGraphXPE(mlir::ModuleOp module,
 mlir::LogicalResult AIETranslateToIPU(mlir::ModuleOp module,
                                       llvm::raw_ostream &output);
 std::vector<uint32_t> AIETranslateToIPU(mlir::ModuleOp);
+/// A runtime parameter of a sequence, patched into the instructions generated
+/// by AIETranslateToIPU: the word at the given index is increased by the value
+/// of the argument times the coefficient.
+struct IPUInstructionPatch {
+  uint32_t word;
+  uint32_t argument;
+  int64_t coefficient;
+};
+mlir::LogicalResult AIETranslateToIPUPatches(mlir::ModuleOp module,
+                                             llvm::raw_ostream &output);
+std::vector<IPUInstructionPatch> AIETranslateToIPUPatches(mlir::ModuleOp);
+/// The fields of the shim tile BD written by an IPU instruction.
+struct IPUShimTileBD {
+  uint32_t column = 0;
+  uint32_t columnNum = 1;
+  uint32_t ddrId = 0;
+  uint32_t bdId = 0;
+  uint32_t bufferLength = 0;
+  uint32_t bufferOffset = 0;
+  uint32_t enablePacket = 0;
+  uint32_t outOfOrderId = 0;
+  uint32_t packetId = 0;
+  uint32_t packetType = 0;
+  uint32_t d0Size = 0;
+  uint32_t d0Stride = 0;
+  uint32_t d1Size = 0;
+  uint32_t d1Stride = 0;
+  uint32_t d2Stride = 0;
+  uint32_t iterationCurrent = 0;
+  uint32_t iterationSize = 0;
+  uint32_t iterationStride = 0;
+  uint32_t nextBd = 0;
+  uint32_t useNextBd = 0;
+  uint32_t validBd = 1;
+  uint32_t lockRelVal = 0;
+  uint32_t lockRelId = 0;
+  uint32_t lockAcqEnable = 0;
+  uint32_t lockAcqVal = 0;
+  uint32_t lockAcqId = 0;
+  // The AXI settings of the BD: bursts of 64, 128 or 256 bytes, the latter
+  // for any other value, and the AxCACHE and AxQoS bits.
+  uint32_t burstLength = 256;
+  uint32_t axCache = 0;
+  uint32_t axQos = 0;
+};
+/// Append the words of an IPU instruction to the instructions. These are the
+/// encoders used by AIETranslateToIPU, exposed so that host code can generate
+/// or patch instructions without building a sequence.
+void appendIPUSync(std::vector<uint32_t> &instructions, uint32_t column,
+                   uint32_t row, uint32_t direction, uint32_t channel,
+                   uint32_t columnNum, uint32_t rowNum);
+void appendIPUWrite32(std::vector<uint32_t> &instructions, uint32_t column,
+                      uint32_t row, uint32_t address, uint32_t value);
+void appendIPUWriteBdShimTile(std::vector<uint32_t> &instructions,
+                              const IPUShimTileBD &bd);
+mlir::LogicalResult AIETranslateToDMAReport(mlir::ModuleOp module,
+                                            llvm::raw_ostream &output);
+mlir::LogicalResult AIETranslateToUtilizationReport(mlir::ModuleOp module,
+                                                    llvm::raw_ostream &output);
+mlir::LogicalResult AIETranslateToSimulation(mlir::ModuleOp module,
+                                             llvm::raw_ostream &output,
+                                             int64_t maxCycles);
 mlir::LogicalResult AIETranslateToLdScript(mlir::ModuleOp module,
                                            llvm::raw_ostream &output,
                                            int tileCol, int tileRow);
@@ -42,13 +104,20 @@ mlir::LogicalResult
 AIELLVMLink(llvm::raw_ostream &output, std::vector<std::string> Files,
             bool DisableDITypeMap = false, bool NoVerify = false,
             bool Internalize = false, bool OnlyNeeded = false,
-            bool PreserveAssemblyUseListOrder = false, bool Verbose = false);
+            bool PreserveAssemblyUseListOrder = false, bool Verbose = false,
+            unsigned OptLevel = 0);
 
 mlir::LogicalResult
 AIETranslateToCDODirect(mlir::ModuleOp m, llvm::StringRef workDirPath,
                         bool bigEndian = false, bool emitUnified = false,
                         bool axiDebug = false, bool aieSim = false,
-                        size_t partitionStartCol = 1);
+                        size_t partitionStartCol = 1,
+                        bool optimizeWrites = false,
+                        mlir::ModuleOp deltaBase = {},
+                        llvm::StringRef deltaBaseWorkDirPath = "");
+mlir::LogicalResult
+AIETranslateToControlPackets(mlir::ModuleOp m, llvm::raw_ostream &output,
+                             mlir::ModuleOp base, size_t partitionStartCol = 1);
 #ifdef AIE_ENABLE_AIRBIN
 mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
                                          const std::string &outputFilename,
@@ -13,9 +13,11 @@
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
 #include "aie/Dialect/AIEVec/Analysis/Passes.h"
 #include "aie/Dialect/AIEVec/Pipelines/Passes.h"
+#include "aie/Dialect/AIEVec/TransformOps/DialectExtension.h"
 #include "aie/Dialect/AIEVec/Transforms/Passes.h"
 #include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
 
+#include "mlir/CAPI/IR.h"
 #include "mlir/IR/Dialect.h"
 #include "mlir/InitAllDialects.h"
 #include "mlir/InitAllExtensions.h"
@@ -41,3 +43,7 @@ void aieRegisterAllPasses() {
   registry.insert<DLTIDialect>();
   registerAllToLLVMIRTranslations(registry);
 }
+
+void aieRegisterAllDialectExtensions(MlirDialectRegistry registry) {
+  xilinx::aievec::registerTransformDialectExtension(*unwrap(registry));
+}
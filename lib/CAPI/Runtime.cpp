@@ -0,0 +1,101 @@
+//===- Runtime.cpp ----------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: MIT
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie-c/Runtime.h"
+#include "aie/Runtime/XCLBinKernel.h"
+
+#include <exception>
+#include <memory>
+#include <string>
+
+using namespace xilinx::AIE;
+
+struct AieXCLBin {
+  AieXCLBin(const char *xclBinPath, const char *kernelName, int deviceIndex)
+      : kernel(xclBinPath, kernelName, deviceIndex) {}
+
+  XCLBinKernel kernel;
+};
+
+static thread_local std::string lastError;
+
+// Runs f, turning the exceptions of XRT into a failure and the last error.
+template <typename F>
+static MlirLogicalResult guard(F &&f) {
+  try {
+    f();
+    return mlirLogicalResultSuccess();
+  } catch (const std::exception &e) {
+    lastError = e.what();
+    return mlirLogicalResultFailure();
+  }
+}
+
+const char *aieRuntimeGetLastError() { return lastError.c_str(); }
+
+AieXCLBin *aieXCLBinCreate(const char *xclBinPath, const char *kernelName,
+                           int deviceIndex) {
+  std::unique_ptr<AieXCLBin> xclBin;
+  if (mlirLogicalResultIsFailure(guard([&] {
+        xclBin =
+            std::make_unique<AieXCLBin>(xclBinPath, kernelName, deviceIndex);
+      })))
+    return nullptr;
+  return xclBin.release();
+}
+
+void aieXCLBinDestroy(AieXCLBin *xclBin) { delete xclBin; }
+
+MlirLogicalResult aieXCLBinLoadInstructions(AieXCLBin *xclBin,
+                                            const uint32_t *insts,
+                                            size_t count) {
+  return guard([&] { xclBin->kernel.loadInstructions(insts, count); });
+}
+
+MlirLogicalResult aieXCLBinLoadResidentInstructions(AieXCLBin *xclBin,
+                                                    const uint32_t *insts,
+                                                    size_t count) {
+  return guard(
+      [&] { xclBin->kernel.loadResidentInstructions(insts, count); });
+}
+
+void *aieXCLBinAddBuffer(AieXCLBin *xclBin, size_t bufferSet, size_t bytes) {
+  void *host = nullptr;
+  guard([&] { host = xclBin->kernel.addBuffer(bufferSet, bytes).map(); });
+  return host;
+}
+
+MlirLogicalResult aieXCLBinSubmit(AieXCLBin *xclBin, size_t bufferSet) {
+  return guard([&] {
+    xclBin->kernel.syncBuffers(bufferSet, XCL_BO_SYNC_BO_TO_DEVICE);
+    xclBin->kernel.startRun(bufferSet);
+  });
+}
+
+bool aieXCLBinIsDone(AieXCLBin *xclBin, size_t bufferSet) {
+  auto &runs = xclBin->kernel.preparedRuns;
+  if (bufferSet >= runs.size() || !runs[bufferSet])
+    return true;
+  ert_cmd_state state = runs[bufferSet]->state();
+  return state != ERT_CMD_STATE_NEW && !isInFlight(state);
+}
+
+MlirLogicalResult aieXCLBinWait(AieXCLBin *xclBin, size_t bufferSet,
+                                unsigned timeoutMs) {
+  return guard([&] {
+    auto &runs = xclBin->kernel.preparedRuns;
+    if (bufferSet >= runs.size() || !runs[bufferSet])
+      throw std::runtime_error("no run submitted on buffer set " +
+                               std::to_string(bufferSet));
+    ert_cmd_state state = runs[bufferSet]->wait(timeoutMs);
+    if (state == ERT_CMD_STATE_TIMEOUT)
+      throw std::runtime_error("kernel timed out");
+    if (state != ERT_CMD_STATE_COMPLETED)
+      throw std::runtime_error("kernel failed");
+    xclBin->kernel.syncBuffers(bufferSet, XCL_BO_SYNC_BO_FROM_DEVICE);
+  });
+}
@@ -21,6 +21,7 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <string>
@@ -87,6 +88,72 @@ MlirStringRef aieTranslateToIPU(MlirOperation moduleOp) {
   return mlirStringRefCreate(cStr, ipu.size());
 }
 
+MlirStringRef aieTranslateToIPUPatches(MlirOperation moduleOp) {
+  std::string patches;
+  llvm::raw_string_ostream os(patches);
+  ModuleOp mod = llvm::cast<ModuleOp>(unwrap(moduleOp));
+  if (failed(AIETranslateToIPUPatches(mod, os)))
+    return mlirStringRefCreate(nullptr, 0);
+  char *cStr = static_cast<char *>(malloc(patches.size()));
+  patches.copy(cStr, patches.size());
+  return mlirStringRefCreate(cStr, patches.size());
+}
+
+static void copyWords(uint32_t *words, const std::vector<uint32_t> &encoded) {
+  std::copy(encoded.begin(), encoded.end(), words);
+}
+
+void aieIPUEncodeSync(uint32_t *words, uint32_t column, uint32_t row,
+                      uint32_t direction, uint32_t channel, uint32_t columnNum,
+                      uint32_t rowNum) {
+  std::vector<uint32_t> encoded;
+  appendIPUSync(encoded, column, row, direction, channel, columnNum, rowNum);
+  copyWords(words, encoded);
+}
+
+void aieIPUEncodeWrite32(uint32_t *words, uint32_t column, uint32_t row,
+                         uint32_t address, uint32_t value) {
+  std::vector<uint32_t> encoded;
+  appendIPUWrite32(encoded, column, row, address, value);
+  copyWords(words, encoded);
+}
+
+void aieIPUEncodeWriteBdShimTile(uint32_t *words, const AieIPUShimTileBD *bd) {
+  IPUShimTileBD fields;
+  fields.column = bd->column;
+  fields.columnNum = bd->columnNum;
+  fields.ddrId = bd->ddrId;
+  fields.bdId = bd->bdId;
+  fields.bufferLength = bd->bufferLength;
+  fields.bufferOffset = bd->bufferOffset;
+  fields.enablePacket = bd->enablePacket;
+  fields.outOfOrderId = bd->outOfOrderId;
+  fields.packetId = bd->packetId;
+  fields.packetType = bd->packetType;
+  fields.d0Size = bd->d0Size;
+  fields.d0Stride = bd->d0Stride;
+  fields.d1Size = bd->d1Size;
+  fields.d1Stride = bd->d1Stride;
+  fields.d2Stride = bd->d2Stride;
+  fields.iterationCurrent = bd->iterationCurrent;
+  fields.iterationSize = bd->iterationSize;
+  fields.iterationStride = bd->iterationStride;
+  fields.nextBd = bd->nextBd;
+  fields.useNextBd = bd->useNextBd;
+  fields.validBd = bd->validBd;
+  fields.lockRelVal = bd->lockRelVal;
+  fields.lockRelId = bd->lockRelId;
+  fields.lockAcqEnable = bd->lockAcqEnable;
+  fields.lockAcqVal = bd->lockAcqVal;
+  fields.lockAcqId = bd->lockAcqId;
+  fields.burstLength = bd->burstLength;
+  fields.axCache = bd->axCache;
+  fields.axQos = bd->axQos;
+  std::vector<uint32_t> encoded;
+  appendIPUWriteBdShimTile(encoded, fields);
+  copyWords(words, encoded);
+}
+
 MlirStringRef aieTranslateToXAIEV2(MlirOperation moduleOp) {
   std::string xaie;
   llvm::raw_string_ostream os(xaie);
@@ -109,14 +176,31 @@ MlirStringRef aieTranslateToBCF(MlirOperation moduleOp, int col, int row) {
   return mlirStringRefCreate(cStr, bcf.size());
 }
 
-MlirStringRef aieLLVMLink(MlirStringRef *modules, int nModules) {
+MlirStringRef aieTranslateToLdScript(MlirOperation moduleOp, int col,
+                                     int row) {
+  std::string ldscript;
+  llvm::raw_string_ostream os(ldscript);
+  ModuleOp mod = llvm::cast<ModuleOp>(unwrap(moduleOp));
+  if (failed(AIETranslateToLdScript(mod, os, col, row)))
+    return mlirStringRefCreate(nullptr, 0);
+  char *cStr = static_cast<char *>(malloc(ldscript.size()));
+  ldscript.copy(cStr, ldscript.size());
+  return mlirStringRefCreate(cStr, ldscript.size());
+}
+
+MlirStringRef aieLLVMLink(MlirStringRef *modules, int nModules,
+                          int optLevel) {
   std::string ll;
   llvm::raw_string_ostream os(ll);
   std::vector<std::string> files;
   files.reserve(nModules);
   for (int i = 0; i < nModules; ++i)
     files.emplace_back(modules[i].data, modules[i].length);
-  if (failed(AIELLVMLink(os, files)))
+  if (failed(AIELLVMLink(os, files, /*DisableDITypeMap=*/false,
+                         /*NoVerify=*/false, /*Internalize=*/optLevel > 0,
+                         /*OnlyNeeded=*/false,
+                         /*PreserveAssemblyUseListOrder=*/false,
+                         /*Verbose=*/false, optLevel)))
     return mlirStringRefCreate(nullptr, 0);
   char *cStr = static_cast<char *>(malloc(ll.size()));
   ll.copy(cStr, ll.size());
@@ -108,6 +108,42 @@ static SmallVector<Value> forceCastOperandsToSignature(OpBuilder &builder,
       }));
 }
 
+// This function emits the AIE2 intrinsic that broadcasts the scalar `src` to
+// all the lanes of a 512b vector of type `resTy`. The integer scalars are
+// passed to the intrinsics as i32. It returns a null value if there is no
+// such intrinsic for `resTy`.
+static Value createAIE2BroadcastIntr(OpBuilder &builder, Location loc,
+                                     Value src, VectorType resTy) {
+  if (getVectorSizeInBits(resTy) != 512)
+    return nullptr;
+  Type elTy = resTy.getElementType();
+  Type i32Ty = builder.getI32Type();
+  if (auto intTy = dyn_cast<IntegerType>(elTy)) {
+    if (intTy.getWidth() < 32)
+      src = builder.create<LLVM::SExtOp>(loc, i32Ty, src);
+    switch (intTy.getWidth()) {
+    case 8:
+      return builder.create<aievec::VectorBroadcast8I512IntrOp>(loc, resTy,
+                                                                src);
+    case 16:
+      return builder.create<aievec::VectorBroadcast16I512IntrOp>(loc, resTy,
+                                                                 src);
+    case 32:
+      return builder.create<aievec::VectorBroadcast32I512IntrOp>(loc, resTy,
+                                                                 src);
+    default:
+      return nullptr;
+    }
+  }
+  if (elTy.isBF16())
+    return builder.create<aievec::VectorBroadcast16BF512IntrOp>(loc, resTy,
+                                                                src);
+  if (elTy.isF32())
+    return builder.create<aievec::VectorBroadcastfloatI512IntrOp>(loc, resTy,
+                                                                  src);
+  return nullptr;
+}
+
 struct BufferParams {
   uint32_t start;
   uint32_t offsets;
@@ -175,30 +211,99 @@ void encodeConf(uint32_t conf[2], const BufferParams &x, const BufferParams &z,
   conf[1] |= sub << 17;
 }
 
-class AddOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::AddOp> {
+// Lowers the AIE1 lane-selecting add and sub ops to the `llvm.aie.add<N>` and
+// `llvm.aie.sub<N>` intrinsics. The lane selection of both operands is passed
+// as in the mul and mac intrinsics, with the squares in the configuration.
+template <typename SrcOpTy>
+class AddSubOpConversion : public mlir::ConvertOpToLLVMPattern<SrcOpTy> {
 public:
-  using ConvertOpToLLVMPattern<aievec::AddOp>::ConvertOpToLLVMPattern;
+  using mlir::ConvertOpToLLVMPattern<SrcOpTy>::ConvertOpToLLVMPattern;
+  using OpAdaptor = typename SrcOpTy::Adaptor;
 
-  LogicalResult
-  matchAndRewrite(aievec::AddOp op, OpAdaptor adaptor,
-                  ConversionPatternRewriter &rewriter) const override {
-    op.emitWarning() << "aie.add conversion is not implemented\n";
-    return failure();
+  static std::string getIntrinsicName(SrcOpTy op) {
+    auto resultType = cast<VectorType>(op.getResult().getType());
+    std::stringstream ss;
+    ss << "llvm.aie.";
+    if (isa<FloatType>(resultType.getElementType()))
+      ss << "vfp";
+    ss << (std::is_same_v<SrcOpTy, aievec::AddOp> ? "add" : "sub");
+    if (isa<IntegerType>(resultType.getElementType()))
+      ss << getVectorLaneSize(resultType) << "."
+         << getVectorTypeString(cast<VectorType>(op.getLhs().getType()));
+    return ss.str();
   }
-};
-
-class SubOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::SubOp> {
-public:
-  using ConvertOpToLLVMPattern<aievec::SubOp>::ConvertOpToLLVMPattern;
 
   LogicalResult
-  matchAndRewrite(aievec::SubOp op, OpAdaptor adaptor,
+  matchAndRewrite(SrcOpTy op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
-    op.emitWarning() << "aie.sub conversion is not implemented\n";
-    return failure();
+    auto module = op->template getParentOfType<ModuleOp>();
+    MLIRContext *context = rewriter.getContext();
+
+    auto startType = IntegerType::get(context, 32);
+    auto offsetsType = VectorType::get({2}, IntegerType::get(context, 32));
+    auto confType = VectorType::get({2}, IntegerType::get(context, 32));
+
+    // If the intrinsic declaration doesn't exist, create it
+    std::string intrinsicName = getIntrinsicName(op);
+    auto func = module.template lookupSymbol<LLVM::LLVMFuncOp>(
+        StringAttr::get(context, intrinsicName));
+
+    if (!func) {
+      OpBuilder::InsertionGuard guard(rewriter);
+      rewriter.setInsertionPointToStart(module.getBody());
+      func = rewriter.create<LLVM::LLVMFuncOp>(
+          rewriter.getUnknownLoc(), intrinsicName,
+          LLVM::LLVMFunctionType::get(op.getResult().getType(),
+                                      {op.getLhs().getType(),
+                                       op.getRhs().getType(),
+                                       startType,   /* xstart */
+                                       startType,   /* zstart */
+                                       offsetsType, /* xoffsets */
+                                       offsetsType, /* zoffsets */
+                                       confType}));
+    }
+
+    // Parse the string attribute values
+    BufferParams x = {};
+    BufferParams z = {};
+    op.getXstart().getAsInteger(0, x.start);
+    op.getXoffsets().getAsInteger(0, x.offsets);
+    op.getXoffsetsHi().getAsInteger(0, x.offsets_hi);
+    op.getXsquare().getAsInteger(0, x.square);
+    op.getZstart().getAsInteger(0, z.start);
+    op.getZoffsets().getAsInteger(0, z.offsets);
+    op.getZoffsetsHi().getAsInteger(0, z.offsets_hi);
+    op.getZsquare().getAsInteger(0, z.square);
+
+    // Encode the configuration register
+    uint32_t conf[2] = {0, 0};
+    encodeConf(conf, x, z, false);
+
+    // Create the constants and replace the op
+    auto xstartVal = rewriter.create<LLVM::ConstantOp>(
+        op->getLoc(), startType, rewriter.getI32IntegerAttr(x.start));
+    auto zstartVal = rewriter.create<LLVM::ConstantOp>(
+        op->getLoc(), startType, rewriter.getI32IntegerAttr(z.start));
+    auto xoffsetsVal = rewriter.create<LLVM::ConstantOp>(
+        op->getLoc(), offsetsType,
+        rewriter.getI32VectorAttr({(int32_t)x.offsets, (int32_t)x.offsets_hi}));
+    auto zoffsetsVal = rewriter.create<LLVM::ConstantOp>(
+        op->getLoc(), offsetsType,
+        rewriter.getI32VectorAttr({(int32_t)z.offsets, (int32_t)z.offsets_hi}));
+    auto confVal = rewriter.create<LLVM::ConstantOp>(
+        op->getLoc(), confType,
+        rewriter.getI32VectorAttr({(int32_t)conf[0], (int32_t)conf[1]}));
+    rewriter.replaceOpWithNewOp<LLVM::CallOp>(
+        op, func,
+        ValueRange{op.getLhs(), op.getRhs(), xstartVal, zstartVal, xoffsetsVal,
+                   zoffsetsVal, confVal});
+    return success();
   }
 };
 
+using AddOpConversion = AddSubOpConversion<aievec::AddOp>;
+using SubOpConversion = AddSubOpConversion<aievec::SubOp>;
+
 class FMAOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::FMAOp> {
 public:
   using ConvertOpToLLVMPattern<aievec::FMAOp>::ConvertOpToLLVMPattern;
@@ -357,11 +462,62 @@ class UPSOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::UPSOp> {
 public:
   using ConvertOpToLLVMPattern<aievec::UPSOp>::ConvertOpToLLVMPattern;
 
+  // The counterpart of the SRS intrinsic names, e.g. `llvm.aie.ups.v16acc48.
+  // v16i16` or `llvm.aie.lups.v8acc80.v8i64`.
+  static std::string getIntrinsicName(aievec::UPSOp op) {
+    std::stringstream ss;
+    ss << "llvm.aie.";
+
+    // Determine the prefix
+    auto sourceType = cast<VectorType>(op.getSource().getType());
+    auto resultType = cast<VectorType>(op.getResult().getType());
+    auto sourceElType = cast<IntegerType>(sourceType.getElementType());
+    auto resultElType = cast<IntegerType>(resultType.getElementType());
+
+    auto sourceElWidth = sourceElType.getWidth();
+    auto resultElWidth = resultElType.getWidth();
+
+    if (sourceElWidth == 8 && resultElWidth == 48) {
+      ss << (sourceElType.getSignedness() == IntegerType::Unsigned ? 'u' : 'b');
+    } else if ((sourceElWidth == 32 && resultElWidth == 48) ||
+               (sourceElWidth == 64 && resultElWidth == 80)) {
+      ss << 'l';
+    }
+    ss << "ups." << getVectorTypeString(resultType, false, true) << "."
+       << getVectorTypeString(sourceType, true);
+
+    return ss.str();
+  }
+
   LogicalResult
   matchAndRewrite(aievec::UPSOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
-    op.emitWarning() << "aie.ups conversion is not implemented\n";
-    return failure();
+    if (!isa<IntegerType>(getElementTypeOrSelf(op.getResult().getType())))
+      return failure();
+
+    // If the intrinsic declaration doesn't exist, create it
+    std::string intrinsicName = getIntrinsicName(op);
+    auto module = op->getParentOfType<ModuleOp>();
+    MLIRContext *context = rewriter.getContext();
+    auto func = module.lookupSymbol<LLVM::LLVMFuncOp>(
+        StringAttr::get(context, intrinsicName));
+    auto shiftType = IntegerType::get(context, 32);
+
+    if (!func) {
+      OpBuilder::InsertionGuard guard(rewriter);
+      rewriter.setInsertionPointToStart(module.getBody());
+      func = rewriter.create<LLVM::LLVMFuncOp>(
+          rewriter.getUnknownLoc(), intrinsicName,
+          LLVM::LLVMFunctionType::get(op.getResult().getType(),
+                                      {op.getSource().getType(), shiftType}));
+    }
+
+    // Create a constant for the shift value
+    auto shiftVal = rewriter.create<LLVM::ConstantOp>(
+        op->getLoc(), shiftType, rewriter.getI32IntegerAttr(op.getShift()));
+    rewriter.replaceOpWithNewOp<LLVM::CallOp>(
+        op, func, ValueRange{op.getSource(), shiftVal});
+    return success();
   }
 };
 
@@ -777,8 +933,42 @@ public:
   LogicalResult
   matchAndRewrite(aievec::BroadcastOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
-    op.emitWarning() << "aie.broadcast conversion is not implemented\n";
-    return failure();
+    Location loc = op.getLoc();
+    auto idx = rewriter.create<LLVM::ConstantOp>(
+        loc, rewriter.getI32Type(), rewriter.getI32IntegerAttr(op.getIdx()));
+    Value elem =
+        rewriter.create<LLVM::ExtractElementOp>(loc, adaptor.getSource(), idx);
+    Value result = createAIE2BroadcastIntr(rewriter, loc, elem,
+                                           cast<VectorType>(op.getType()));
+    if (!result) {
+      op.emitWarning() << "aie.broadcast conversion is not implemented for "
+                       << op.getType() << "\n";
+      return failure();
+    }
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
+class BroadcastScalarOpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::BroadcastScalarOp> {
+public:
+  using ConvertOpToLLVMPattern<
+      aievec::BroadcastScalarOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::BroadcastScalarOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Value result = createAIE2BroadcastIntr(rewriter, op.getLoc(),
+                                           adaptor.getSource(),
+                                           cast<VectorType>(op.getType()));
+    if (!result) {
+      op.emitWarning() << "aie.broadcast_scalar conversion is not implemented "
+                       << "for " << op.getType() << "\n";
+      return failure();
+    }
+    rewriter.replaceOp(op, result);
+    return success();
   }
 };
 
@@ -976,6 +1166,200 @@ class MatMulOpConversion
   }
 };
 
+class MatMulSparseOpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::MatMulSparseOp> {
+  using ConvertOpToLLVMPattern<aievec::MatMulSparseOp>::ConvertOpToLLVMPattern;
+
+  static VectorType getFlattenedVectorType(VectorType vecTy) {
+    auto shape = vecTy.getShape();
+    return VectorType::get(
+        {std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<>())},
+        vecTy.getElementType());
+  }
+
+  LogicalResult
+  matchAndRewrite(aievec::MatMulSparseOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    // Flatten the inputs
+    SmallVector<Value> operands;
+    for (Value operand : {adaptor.getLhs(), adaptor.getRhs(), adaptor.getMask(),
+                          adaptor.getAcc()}) {
+      auto vecTy = cast<VectorType>(operand.getType());
+      if (vecTy.getRank() > 1)
+        operand = rewriter.create<vector::ShapeCastOp>(
+            loc, getFlattenedVectorType(vecTy), operand);
+      operands.push_back(operand);
+    }
+    auto accFlattenedVecTy = cast<VectorType>(operands.back().getType());
+
+    // <4x16xi8> x <16x8xi8> + <4x8xi32>, the dense rhs being expanded from
+    // its 8x8 non-zero elements by the mask. The mode is the one of the
+    // dense <4x8xi8> x <8x8xi8> matmul, both operands signed.
+    Type i32ty = rewriter.getI32Type();
+    operands.push_back(rewriter.create<LLVM::ConstantOp>(
+        loc, i32ty, rewriter.getI32IntegerAttr((1 << 9) | (1 << 8) | 8)));
+    VectorType v16xi64ty = VectorType::get({16}, rewriter.getI64Type());
+    Value matMulResVal =
+        rewriter
+            .create<aievec::MacConfSparseAcc32IntrOp>(
+                loc, v16xi64ty,
+                forceCastOperandsToSignature(
+                    rewriter, loc, operands,
+                    {VectorType::get({64}, rewriter.getI8Type()),
+                     VectorType::get({16}, i32ty), VectorType::get({4}, i32ty),
+                     v16xi64ty, i32ty}))
+            .getResult();
+
+    auto castFromAcc =
+        bitcastValueToType(rewriter, loc, matMulResVal, accFlattenedVecTy);
+
+    rewriter.replaceOpWithNewOp<vector::ShapeCastOp>(op, op.getType(),
+                                                     castFromAcc);
+
+    return success();
+  }
+};
+
+class ShuffleOpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::ShuffleOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::ShuffleOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::ShuffleOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto resultType = cast<VectorType>(op.getType());
+    if (getVectorSizeInBits(resultType) != 512) {
+      op.emitWarning() << "aie.shuffle conversion is only implemented for "
+                          "512b vectors\n";
+      return failure();
+    }
+
+    // The shuffle modes of a single vector only read the lanes of the first
+    // operand of the intrinsic.
+    Location loc = op.getLoc();
+    auto v16xi32Ty = VectorType::get({16}, rewriter.getI32Type());
+    Value lhs = bitcastValueToType(rewriter, loc, adaptor.getSource(),
+                                   v16xi32Ty);
+    Value rhs = rewriter.create<LLVM::UndefOp>(loc, v16xi32Ty);
+    auto mode = rewriter.create<LLVM::ConstantOp>(
+        loc, rewriter.getI32Type(), rewriter.getI32IntegerAttr(op.getMode()));
+    auto shuffleOp =
+        rewriter.create<aievec::VectorShuffleIntrOp>(loc, v16xi32Ty, lhs,
+                                                     rhs, mode);
+    rewriter.replaceOp(op, bitcastValueToType(rewriter, loc,
+                                              shuffleOp.getResult(),
+                                              resultType));
+    return success();
+  }
+};
+
+class ShiftOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::ShiftOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::ShiftOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::ShiftOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto resultType = cast<VectorType>(op.getType());
+    if (op.getIsAcc() || getVectorSizeInBits(resultType) != 512) {
+      op.emitWarning() << "aie.shift conversion is only implemented for "
+                          "512b vectors\n";
+      return failure();
+    }
+
+    Location loc = op.getLoc();
+    auto v16xi32Ty = VectorType::get({16}, rewriter.getI32Type());
+    auto step = rewriter.create<LLVM::ConstantOp>(
+        loc, rewriter.getI32Type(), rewriter.getI32IntegerAttr(0));
+    auto shiftOp = rewriter.create<aievec::VectorShiftI512I512IntrOp>(
+        loc, v16xi32Ty,
+        bitcastValueToType(rewriter, loc, adaptor.getLhs(), v16xi32Ty),
+        bitcastValueToType(rewriter, loc, adaptor.getRhs(), v16xi32Ty), step,
+        adaptor.getShift());
+    rewriter.replaceOp(op, bitcastValueToType(rewriter, loc,
+                                              shiftOp.getResult(), resultType));
+    return success();
+  }
+};
+
+// The max and min ops map to the same intrinsics, with `lt` and `ge`
+// comparisons for max and min respectively.
+template <typename SrcOpTy, typename Int8IntrOpTy, typename Int16IntrOpTy,
+          typename Int32IntrOpTy, typename BF16IntrOpTy>
+class MaxMinOpConversion : public mlir::ConvertOpToLLVMPattern<SrcOpTy> {
+public:
+  using mlir::ConvertOpToLLVMPattern<SrcOpTy>::ConvertOpToLLVMPattern;
+  using OpAdaptor = typename SrcOpTy::Adaptor;
+
+  LogicalResult
+  matchAndRewrite(SrcOpTy op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto resultType = cast<VectorType>(op.getType());
+    Type elTy = resultType.getElementType();
+    if (getVectorSizeInBits(resultType) != 512) {
+      op.emitWarning() << op->getName()
+                       << " conversion is only implemented for 512b vectors\n";
+      return failure();
+    }
+
+    Location loc = op.getLoc();
+    MLIRContext *context = rewriter.getContext();
+    Type i32Ty = rewriter.getI32Type();
+    Value lhs = adaptor.getLhs();
+    Value rhs = adaptor.getRhs();
+    Value res;
+    if (elTy.isBF16()) {
+      auto structTy = LLVM::LLVMStructType::getLiteral(context,
+                                                       {resultType, i32Ty});
+      res = rewriter.create<BF16IntrOpTy>(loc, structTy, lhs, rhs);
+    } else if (auto intTy = dyn_cast<IntegerType>(elTy)) {
+      // The last operand selects a signed comparison.
+      auto cmp = rewriter.create<LLVM::ConstantOp>(
+          loc, i32Ty, rewriter.getI32IntegerAttr(!intTy.isUnsigned()));
+      switch (intTy.getWidth()) {
+      case 8: {
+        auto structTy = LLVM::LLVMStructType::getLiteral(
+            context, {resultType, VectorType::get({2}, i32Ty)});
+        res = rewriter.create<Int8IntrOpTy>(loc, structTy, lhs, rhs, cmp);
+        break;
+      }
+      case 16:
+      case 32: {
+        auto structTy =
+            LLVM::LLVMStructType::getLiteral(context, {resultType, i32Ty});
+        if (intTy.getWidth() == 16)
+          res = rewriter.create<Int16IntrOpTy>(loc, structTy, lhs, rhs, cmp);
+        else
+          res = rewriter.create<Int32IntrOpTy>(loc, structTy, lhs, rhs, cmp);
+        break;
+      }
+      default:
+        break;
+      }
+    }
+    if (!res) {
+      op.emitWarning() << op->getName() << " conversion is not implemented for "
+                       << resultType << "\n";
+      return failure();
+    }
+
+    rewriter.replaceOpWithNewOp<LLVM::ExtractValueOp>(op, res,
+                                                      ArrayRef<int64_t>{0});
+    return success();
+  }
+};
+
+using MaxOpConversion =
+    MaxMinOpConversion<aievec::MaxOp, aievec::VectorMaxLt8IntrOp,
+                       aievec::VectorMaxLt16IntrOp, aievec::VectorMaxLt32IntrOp,
+                       aievec::VectorMaxLtBf16IntrOp>;
+using MinOpConversion =
+    MaxMinOpConversion<aievec::MinOp, aievec::VectorMinGe8IntrOp,
+                       aievec::VectorMinGe16IntrOp, aievec::VectorMinGe32IntrOp,
+                       aievec::VectorMinGeBf16IntrOp>;
+
 void populateAIEVecToLLVMConversionPatterns(mlir::LLVMTypeConverter &converter,
                                             mlir::RewritePatternSet &patterns) {
   // clang-format off
@@ -992,8 +1376,14 @@ void populateAIEVecToLLVMConversionPatterns(mlir::LLVMTypeConverter &converter,
                PackOpConversion,
                UnpackOpConversion,
                BroadcastOpConversion,
+               BroadcastScalarOpConversion,
                FMAElemOpConversion,
-               MatMulOpConversion>(converter);
+               MatMulOpConversion,
+               MatMulSparseOpConversion,
+               ShuffleOpConversion,
+               ShiftOpConversion,
+               MaxOpConversion,
+               MinOpConversion>(converter);
   // clang-format on
 }
 
@@ -1013,10 +1403,19 @@ struct ConvertAIEVecToLLVMPass
     LLVMConversionTarget target(getContext());
     target.addIllegalDialect<AIEVecDialect>();
     target.addLegalDialect<arith::ArithDialect, vector::VectorDialect>();
-    target
-        .addLegalOp<aievec::MacConfAcc32IntrOp, aievec::MacConfAcc64IntrOp,
-                    aievec::MacConfBF16IntrOp, aievec::VectorSetI512I128IntrOp,
-                    aievec::VectorSetI512I256IntrOp>();
+    target.addLegalOp<
+        aievec::MacConfAcc32IntrOp, aievec::MacConfAcc64IntrOp,
+        aievec::MacConfSparseAcc32IntrOp, aievec::MacConfBF16IntrOp,
+        aievec::VectorSetI512I128IntrOp, aievec::VectorSetI512I256IntrOp,
+        aievec::VectorShuffleIntrOp, aievec::VectorShiftI512I512IntrOp,
+        aievec::VectorMaxLt8IntrOp, aievec::VectorMaxLt16IntrOp,
+        aievec::VectorMaxLt32IntrOp, aievec::VectorMaxLtBf16IntrOp,
+        aievec::VectorMinGe8IntrOp, aievec::VectorMinGe16IntrOp,
+        aievec::VectorMinGe32IntrOp, aievec::VectorMinGeBf16IntrOp,
+        aievec::VectorBroadcast8I512IntrOp, aievec::VectorBroadcast16I512IntrOp,
+        aievec::VectorBroadcast32I512IntrOp,
+        aievec::VectorBroadcast16BF512IntrOp,
+        aievec::VectorBroadcastfloatI512IntrOp>();
     if (failed(applyPartialConversion(getOperation(), target,
                                       std::move(patterns))))
       signalPassFailure();
@@ -0,0 +1,81 @@
+//===- AIEDeviceIndex.cpp ---------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
+
+#include "mlir/IR/SymbolTable.h"
+
+#include "llvm/ADT/TypeSwitch.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+DeviceIndex::DeviceIndex(Operation *op) {
+  auto device = cast<DeviceOp>(op);
+  for (Operation &child : device.getBody()->without_terminator()) {
+    if (auto name = child.getAttrOfType<StringAttr>(
+            SymbolTable::getSymbolAttrName()))
+      symbols.try_emplace(name.getValue(), &child);
+    TypeSwitch<Operation *>(&child)
+        .Case([&](TileOp tile) { addTile(tile); })
+        .Case([&](BufferOp buffer) { addBuffer(buffer); })
+        .Case([&](LockOp lock) { addLock(lock); })
+        .Case<MemOp, MemTileDMAOp, ShimDMAOp>([&](auto dma) {
+          dmas[dma.getTileOp()].push_back(dma);
+        })
+        .Case([&](ShimDMAAllocationOp alloc) {
+          shimDMAAllocations.try_emplace(alloc.getSymName(), alloc);
+        });
+  }
+}
+
+ArrayRef<BufferOp> DeviceIndex::getBuffers(TileOp tile) const {
+  auto it = buffers.find(tile);
+  if (it == buffers.end())
+    return {};
+  return it->second;
+}
+
+ArrayRef<LockOp> DeviceIndex::getLocks(TileOp tile) const {
+  auto it = locks.find(tile);
+  if (it == locks.end())
+    return {};
+  return it->second;
+}
+
+ArrayRef<Operation *> DeviceIndex::getDMAs(TileOp tile) const {
+  auto it = dmas.find(tile);
+  if (it == dmas.end())
+    return {};
+  return it->second;
+}
+
+std::optional<ShimDMAAllocationOp>
+DeviceIndex::getShimDMAAllocation(StringRef symName) const {
+  auto it = shimDMAAllocations.find(symName);
+  if (it == shimDMAAllocations.end())
+    return std::nullopt;
+  return it->second;
+}
+
+void DeviceIndex::addTile(TileOp tile) {
+  tiles[tile.getTileID()] = tile;
+  if (!lastTile || lastTile->isBeforeInBlock(tile))
+    lastTile = tile;
+}
+
+void DeviceIndex::addBuffer(BufferOp buffer) {
+  buffers[buffer.getTileOp()].push_back(buffer);
+}
+
+void DeviceIndex::addLock(LockOp lock) {
+  locks[lock.getTileOp()].push_back(lock);
+}
@@ -14,13 +14,18 @@
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/IR/DialectImplementation.h"
 #include "mlir/IR/OpDefinition.h"
+#include "mlir/IR/TypeUtilities.h"
 #include "mlir/Interfaces/FoldInterfaces.h"
 #include "mlir/Transforms/InliningUtils.h"
 
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/TypeSwitch.h"
 
+#include <map>
+#include <mutex>
+
 using namespace mlir;
 using namespace xilinx::AIE;
 
@@ -129,8 +134,18 @@ static TileElement getParentTileElement(Operation *op) {
   return llvm::dyn_cast<TileElement>(parent);
 }
 
+bool xilinx::AIE::isHerdElement(Operation *op) {
+  if (isa<TileOp>(op) || op->getNumOperands() == 0)
+    return false;
+  Operation *tile = op->getOperand(0).getDefiningOp();
+  return tile && !isa<TileOp>(tile);
+}
+
 struct UsesAreAccessable {
   static LogicalResult verifyTrait(Operation *op) {
+    // The accesses of the elements of a herd are checked once it is lowered.
+    if (isHerdElement(op))
+      return success();
     auto thisElement = cast<TileElement>(op);
     auto thisID = thisElement.getTileID();
     auto users = op->getResult(0).getUsers();
@@ -141,6 +156,8 @@ struct UsesAreAccessable {
       if (llvm::isa_and_nonnull<DeviceOp, ModuleOp>(user->getParentOp()))
         return success();
       if (auto element = getParentTileElement(user)) {
+        if (isHerdElement(element))
+          continue;
 
         auto tileID = element.getTileID();
         if (!targetModel.isLegalMemAffinity(tileID.col, tileID.row, thisID.col,
@@ -452,6 +469,57 @@ LogicalResult ObjectFifoCreateOp::verify() {
                      "on shim tile producers");
   }
 
+  if (auto pads = getPadDimensions()) {
+    if (!getProducerTileOp().isMemTile())
+      return emitError("padding is only supported on memtile producers");
+    if (pads->size() != getDimensionsToStream().size())
+      return emitError("padding requires one `padDimensions` entry per "
+                       "dimension of the `toStream` transformation");
+  }
+
+  if (getCompression()) {
+    if (getTargetModel(*this).getTargetArch() != AIEArch::AIE2)
+      return emitError("compression is only supported on AIE-ML devices");
+    if (getProducerTileOp().isShimTile() ||
+        llvm::any_of(getConsumerTiles(), [](Value tile) {
+          return tile.getDefiningOp<TileOp>().isShimTile();
+        }))
+      return emitError("compression is not supported on shim tiles");
+  }
+
+  if (getRepeatCount()) {
+    if (getTargetModel(*this).getTargetArch() != AIEArch::AIE2)
+      return emitError("repeat_count is only supported on AIE-ML devices");
+    if (!getProducerTileOp().isMemTile())
+      return emitError("repeat_count is only supported on memtile producers");
+  }
+
+  if (getStream()) {
+    auto isCore = [](Value tile) {
+      auto tileOp = tile.getDefiningOp<TileOp>();
+      return !tileOp.isShimTile() && !tileOp.isMemTile();
+    };
+    if (!isCore(getProducerTile()) ||
+        !llvm::all_of(getConsumerTiles(), isCore))
+      return emitError("stream objectFifos must be between core tiles");
+    ArrayRef<BDDimLayoutArrayAttr> fromStream =
+        getDimensionsFromStreamPerConsumer();
+    if (!getDimensionsToStream().empty() || getPadDimensions() ||
+        getCompression() ||
+        llvm::any_of(fromStream,
+                     [](BDDimLayoutArrayAttr dims) { return !dims.empty(); }))
+      return emitError("stream objectFifos don't use DMAs and cannot "
+                       "transform, pad or compress their elements");
+    Type elemType = getElemType()
+                        .cast<AIEObjectFifoType>()
+                        .getElementType()
+                        .getElementType();
+    if (!elemType.isF32() && !elemType.isInteger(32) &&
+        !elemType.isInteger(128))
+      return emitError("stream objectFifos must have i32, f32 or i128 "
+                       "elements");
+  }
+
   return success();
 }
 
@@ -549,106 +617,163 @@ void printObjectFifoConsumerTiles(OpAsmPrinter &printer, Operation *op,
 // ObjectFifoLinkOp
 //===----------------------------------------------------------------------===//
 
-LogicalResult ObjectFifoLinkOp::verify() {
-  if (isJoin() && isDistribute())
-    return emitError("ObjectFifoLinkOp does not support 'join' and "
-                     "'distribute' at the same time");
+// Return the tile shared by the objectFifos of a link, given the objectFifos
+// its symbols refer to.
+static std::optional<Value>
+getLinkSharedTile(ObjectFifoLinkOp link, ArrayRef<ObjectFifoCreateOp> fifoIns,
+                  ArrayRef<ObjectFifoCreateOp> fifoOuts) {
+  if (link.isJoin()) {
+    auto fifoOut = fifoOuts[0];
+    for (auto fifoIn : fifoIns)
+      if (fifoOut.getProducerTile() != fifoIn.getConsumerTiles()[0])
+        return {};
+    return {fifoOut.getProducerTile()};
+  }
 
-  if (auto sharedTile = getOptionalSharedTile(); !sharedTile)
-    return emitError("ObjectFifoLinkOp must have a link point, i.e., a "
-                     "shared tile between objectFifos");
+  if (link.isDistribute()) {
+    auto fifoIn = fifoIns[0];
+    for (auto fifoOut : fifoOuts)
+      if (fifoIn.getConsumerTiles()[0] != fifoOut.getProducerTile())
+        return {};
+    return {fifoIn.getConsumerTiles()[0]};
+  }
 
-  if (isJoin()) {
-    ObjectFifoCreateOp fifoOut = getOutputObjectFifos()[0];
-    auto elemType =
-        fifoOut.getElemType().cast<AIEObjectFifoType>().getElementType();
-    int64_t outputSize = 1;
-    for (auto dim : elemType.getShape())
-      outputSize *= dim;
-
-    int inputSize = 0;
-    for (auto fifoIn : getInputObjectFifos()) {
-      auto elemType =
-          fifoIn.getElemType().cast<AIEObjectFifoType>().getElementType();
-      int64_t nextInputSize = 1;
-      for (int64_t dim : elemType.getShape())
-        nextInputSize *= dim;
-      inputSize += nextInputSize;
-    }
-    if (inputSize != outputSize)
-      return emitError("Total size of input objFifos in ObjectFifoLinkOp must "
-                       "be equal to size of output objFifo");
-
-  } else if (isDistribute()) {
-    ObjectFifoCreateOp fifoIn = getInputObjectFifos()[0];
-    if (!fifoIn.getDimensionsToStream().empty()) {
-      return emitOpError("currently does not support objectFifos with "
-                         "dimensionsToStream.");
-    }
-    for (auto dims : fifoIn.getDimensionsFromStreamPerConsumer()) {
-      if (!dims.empty())
-        return emitOpError("currently does not support objectFifos with "
-                           "dimensionsFromStreamPerConsumer.");
-    }
+  if (!fifoIns.empty() && !fifoOuts.empty())
+    for (auto consumerIn : fifoIns[0].getConsumerTiles())
+      if (consumerIn == fifoOuts[0].getProducerTile())
+        return {fifoOuts[0].getProducerTile()};
+  return {};
+}
 
+// Verify a link, given the objectFifos its symbols refer to.
+static LogicalResult
+verifyObjectFifoLink(ObjectFifoLinkOp link, ArrayRef<ObjectFifoCreateOp> fifoIns,
+                     ArrayRef<ObjectFifoCreateOp> fifoOuts) {
+  if (link.isJoin() && link.isDistribute())
+    return link.emitError("ObjectFifoLinkOp does not support 'join' and "
+                          "'distribute' at the same time");
+
+  auto isStream = [](ObjectFifoCreateOp fifo) { return fifo.getStream(); };
+  if (llvm::any_of(fifoIns, isStream) || llvm::any_of(fifoOuts, isStream))
+    return link.emitError("ObjectFifoLinkOp cannot link stream objectFifos");
+
+  // The memtile repeats the elements of a single buffer, which the other
+  // objectFifos of a join or a distribute share.
+  if ((link.isJoin() || link.isDistribute()) &&
+      llvm::any_of(fifoOuts, [](ObjectFifoCreateOp fifo) {
+        return fifo.getRepeatCount().has_value();
+      }))
+    return link.emitError("ObjectFifoLinkOp only supports repeat_count on the "
+                          "output of a one-to-one link");
+
+  if (auto sharedTile = getLinkSharedTile(link, fifoIns, fifoOuts);
+      !sharedTile)
+    return link.emitError("ObjectFifoLinkOp must have a link point, i.e., a "
+                          "shared tile between objectFifos");
+
+  auto getSize = [](ObjectFifoCreateOp fifo) {
     auto elemType =
-        fifoIn.getElemType().cast<AIEObjectFifoType>().getElementType();
-    int64_t inputSize = 1;
-    for (auto dim : elemType.getShape())
-      inputSize *= dim;
-
-    int outputSize = 0;
-    for (auto fifoOut : getOutputObjectFifos()) {
-      if (!fifoOut.getDimensionsToStream().empty() &&
-          fifoOut.getConsumerTiles().size() > 1) {
-        return emitOpError("currently does not support objectFifos with "
-                           "dimensionsToStream and multiple consumers.");
-      }
-      for (auto dims : fifoOut.getDimensionsFromStreamPerConsumer()) {
-        if (!dims.empty())
-          return emitOpError("currently does not support objectFifos with "
-                             "dimensionsFromStreamPerConsumer.");
-      }
+        fifo.getElemType().cast<AIEObjectFifoType>().getElementType();
+    int64_t size = 1;
+    for (int64_t dim : elemType.getShape())
+      size *= dim;
+    return size;
+  };
+
+  if (link.isDistribute())
+    // The outputs are read from the buffers of the input with their own sizes.
+    for (auto fifoOut : fifoOuts)
+      if (fifoOut.getPadDimensions())
+        return link.emitError("ObjectFifoLinkOp does not support padding on "
+                              "the outputs of a distribute");
+
+  if (!link.isJoin() && !link.isDistribute()) {
+    if (link.getOffsets())
+      return link.emitError("ObjectFifoLinkOp only supports offsets on a "
+                            "'join' or a 'distribute'");
+    return success();
+  }
+
+  // The parts of a join or a distribute, and the objectFifo they are taken
+  // from or gathered into.
+  ArrayRef<ObjectFifoCreateOp> parts = link.isJoin() ? fifoIns : fifoOuts;
+  int64_t wholeSize = getSize(link.isJoin() ? fifoOuts[0] : fifoIns[0]);
+
+  std::optional<ArrayRef<int64_t>> offsets = link.getOffsets();
+  if (!offsets) {
+    int64_t partsSize = 0;
+    for (auto part : parts)
+      partsSize += getSize(part);
+    if (partsSize != wholeSize)
+      return link.emitError(
+          link.isJoin() ? "Total size of input objFifos in ObjectFifoLinkOp "
+                          "must be equal to size of output objFifo"
+                        : "Total size of output objFifos in ObjectFifoLinkOp "
+                          "must be equal to size of input objFifo");
+    return success();
+  }
+
+  if (offsets->size() != parts.size())
+    return link.emitError("ObjectFifoLinkOp expects ")
+           << parts.size() << " offsets, one per "
+           << (link.isJoin() ? "input" : "output") << " objFifo, but got "
+           << offsets->size();
+
+  SmallVector<std::pair<int64_t, int64_t>> ranges;
+  for (auto [part, offset] : llvm::zip(parts, *offsets)) {
+    int64_t size = getSize(part);
+    if (offset < 0 || offset + size > wholeSize)
+      return link.emitError("the part of objFifo @")
+             << part.name() << " at offset " << offset << " of size " << size
+             << " is out of the " << wholeSize << " elements of objFifo @"
+             << (link.isJoin() ? fifoOuts[0] : fifoIns[0]).name();
+    ranges.push_back({offset, offset + size});
+  }
 
-      auto elemType =
-          fifoOut.getElemType().cast<AIEObjectFifoType>().getElementType();
-      int64_t nextOutputSize = 1;
-      for (int64_t dim : elemType.getShape())
-        nextOutputSize *= dim;
-      outputSize += nextOutputSize;
+  // The inputs of a join each fill their own part of the output, and
+  // together the whole of it.
+  if (link.isJoin()) {
+    llvm::sort(ranges);
+    bool contiguous = true;
+    int64_t end = 0;
+    for (auto [begin, rangeEnd] : ranges) {
+      contiguous &= begin == end;
+      end = rangeEnd;
     }
-    if (outputSize != inputSize)
-      return emitError("Total size of output objFifos in ObjectFifoLinkOp must "
-                       "be equal to size of input objFifo");
+    if (!contiguous || end != wholeSize)
+      return link.emitError("the parts of the input objFifos of a join must "
+                            "cover each element of the output objFifo "
+                            "exactly once");
   }
 
   return success();
 }
 
-std::optional<Value> ObjectFifoLinkOp::getOptionalSharedTile() {
-  if (isJoin()) {
-    auto fifoOut = getOutputObjectFifos()[0];
-    for (auto fifoIn : getInputObjectFifos())
-      if (fifoOut.getProducerTile() != fifoIn.getConsumerTiles()[0])
-        return {};
-    return {fifoOut.getProducerTile()};
-  }
+LogicalResult ObjectFifoLinkOp::verify() {
+  // Inside a device, the objectFifos of the links are resolved and checked by
+  // DeviceOp::verifyRegions.
+  if ((*this)->getParentOfType<DeviceOp>())
+    return success();
+  return verifyObjectFifoLink(*this, getInputObjectFifos(),
+                              getOutputObjectFifos());
+}
 
-  if (isDistribute()) {
-    auto fifoIn = getInputObjectFifos()[0];
-    for (auto fifoOut : getOutputObjectFifos())
-      if (fifoIn.getConsumerTiles()[0] != fifoOut.getProducerTile())
-        return {};
-    return {fifoIn.getConsumerTiles()[0]};
+int64_t ObjectFifoLinkOp::getPartOffset(size_t i) {
+  if (auto offsets = getOffsets())
+    return (*offsets)[i];
+  auto parts = isJoin() ? getInputObjectFifos() : getOutputObjectFifos();
+  int64_t offset = 0;
+  for (size_t j = 0; j < i; j++) {
+    auto elemType =
+        parts[j].getElemType().cast<AIEObjectFifoType>().getElementType();
+    offset += elemType.getNumElements();
   }
+  return offset;
+}
 
-  auto fifoIn = getInputObjectFifos();
-  if (auto fifoOut = getOutputObjectFifos();
-      !fifoIn.empty() && !fifoOut.empty())
-    for (auto consumerIn : fifoIn[0].getConsumerTiles())
-      if (consumerIn == fifoOut[0].getProducerTile())
-        return {fifoOut[0].getProducerTile()};
-  return {};
+std::optional<Value> ObjectFifoLinkOp::getOptionalSharedTile() {
+  return getLinkSharedTile(*this, getInputObjectFifos(),
+                           getOutputObjectFifos());
 }
 
 std::vector<ObjectFifoCreateOp> ObjectFifoLinkOp::getInputObjectFifos() {
@@ -714,46 +839,66 @@ ObjectFifoCreateOp ObjectFifoRegisterExternalBuffersOp::getObjectFifo() {
 // ObjectFifoAcquireOp
 //===----------------------------------------------------------------------===//
 
-LogicalResult ObjectFifoAcquireOp::verify() {
-  if (acqNumber() < 1)
-    return emitOpError("must acquire at least one element");
-
-  auto parent = getOperation()->getParentOfType<CoreOp>();
-  if (parent == nullptr)
-    return emitOpError("must be called from inside a CoreOp");
+// Verify that the core accessing a port of an objectFifo runs on a tile of
+// that port.
+static LogicalResult verifyObjectFifoPort(Operation *op, ObjectFifoPort port,
+                                          ObjectFifoCreateOp objFifo) {
+  if (!objFifo)
+    return op->emitOpError("does not refer to an objectFifo");
 
+  auto parent = op->getParentOfType<CoreOp>();
   auto coreTile = parent.getTile();
-  auto objFifo = getObjectFifo();
-  if (getPort() == ObjectFifoPort::Produce) {
+  if (port == ObjectFifoPort::Produce) {
     if (coreTile != objFifo.getProducerTile())
       return parent.emitOpError(
           "producer port of objectFifo accessed by core running "
           "on non-producer tile");
-  } else if (getPort() == ObjectFifoPort::Consume) {
-    bool found = false;
-    for (auto consumerTile : objFifo.getConsumerTiles()) {
-      if (coreTile == consumerTile) {
-        found = true;
-        break;
-      }
-    }
-    if (!found)
+  } else if (port == ObjectFifoPort::Consume) {
+    if (!llvm::is_contained(objFifo.getConsumerTiles(), coreTile))
       return parent.emitOpError(
           "consumer port of objectFifo accessed by core running "
           "on non-consumer tile");
   }
+  return success();
+}
+
+// Verify an acquire, given the objectFifo its symbol refers to.
+static LogicalResult verifyObjectFifoAcquire(ObjectFifoAcquireOp acquire,
+                                             ObjectFifoCreateOp objFifo) {
+  if (failed(verifyObjectFifoPort(acquire, acquire.getPort(), objFifo)))
+    return failure();
+  if (objFifo.getStream())
+    return acquire.emitOpError("cannot acquire elements of a stream "
+                               "objectFifo, use aie.objectfifo.get or put");
 
   auto objFifoElem =
-      getObjectFifo().getElemType().cast<AIEObjectFifoType>().getElementType();
-  auto objFifoSubviewElem =
-      getResult().getType().cast<AIEObjectFifoSubviewType>().getElementType();
+      objFifo.getElemType().cast<AIEObjectFifoType>().getElementType();
+  auto objFifoSubviewElem = acquire.getResult()
+                                .getType()
+                                .cast<AIEObjectFifoSubviewType>()
+                                .getElementType();
   if (objFifoElem != objFifoSubviewElem)
-    return emitOpError(
+    return acquire.emitOpError(
         "ObjectFifo element and ObjectFifoSubview element must match.\n");
 
   return success();
 }
 
+LogicalResult ObjectFifoAcquireOp::verify() {
+  if (acqNumber() < 1)
+    return emitOpError("must acquire at least one element");
+
+  auto parent = getOperation()->getParentOfType<CoreOp>();
+  if (parent == nullptr)
+    return emitOpError("must be called from inside a CoreOp");
+
+  // Inside a device, the objectFifo is resolved and checked by
+  // DeviceOp::verifyRegions.
+  if ((*this)->getParentOfType<DeviceOp>())
+    return success();
+  return verifyObjectFifoAcquire(*this, getObjectFifo());
+}
+
 ObjectFifoCreateOp ObjectFifoAcquireOp::getObjectFifo() {
   Operation *parent = getOperation();
   while ((parent = parent->getParentOp())) {
@@ -770,6 +915,17 @@ ObjectFifoCreateOp ObjectFifoAcquireOp::getObjectFifo() {
 // ObjectFifoReleaseOp
 //===----------------------------------------------------------------------===//
 
+// Verify a release, given the objectFifo its symbol refers to.
+static LogicalResult verifyObjectFifoRelease(ObjectFifoReleaseOp release,
+                                             ObjectFifoCreateOp objFifo) {
+  if (failed(verifyObjectFifoPort(release, release.getPort(), objFifo)))
+    return failure();
+  if (objFifo.getStream())
+    return release.emitOpError("cannot release elements of a stream "
+                               "objectFifo");
+  return success();
+}
+
 LogicalResult ObjectFifoReleaseOp::verify() {
   if (relNumber() < 1)
     return emitOpError("must release at least one element");
@@ -778,35 +934,57 @@ LogicalResult ObjectFifoReleaseOp::verify() {
   if (parent == nullptr)
     return emitOpError("must be called from inside a CoreOp");
 
-  auto coreTile = parent.getTile();
-  auto objFifo = getObjectFifo();
-  if (getPort() == ObjectFifoPort::Produce) {
-    if (coreTile != objFifo.getProducerTile())
-      return parent.emitOpError(
-          "producer port of objectFifo accessed by core running "
-          "on non-producer tile");
-  } else if (getPort() == ObjectFifoPort::Consume) {
-    bool found = false;
-    for (auto consumerTile : objFifo.getConsumerTiles()) {
-      if (coreTile == consumerTile) {
-        found = true;
-        break;
-      }
+  // Inside a device, the objectFifo is resolved and checked by
+  // DeviceOp::verifyRegions.
+  if ((*this)->getParentOfType<DeviceOp>())
+    return success();
+  return verifyObjectFifoRelease(*this, getObjectFifo());
+}
+
+ObjectFifoCreateOp ObjectFifoReleaseOp::getObjectFifo() {
+  Operation *parent = getOperation();
+  while ((parent = parent->getParentOp())) {
+    if (parent->hasTrait<OpTrait::SymbolTable>()) {
+      if (auto *st = SymbolTable::lookupSymbolIn(parent, getObjFifoName());
+          isa_and_nonnull<ObjectFifoCreateOp>(st))
+        return dyn_cast<ObjectFifoCreateOp>(st);
     }
-    if (!found)
-      return parent.emitOpError(
-          "consumer port of objectFifo accessed by core running "
-          "on non-consumer tile");
   }
+  return {};
+}
 
+//===----------------------------------------------------------------------===//
+// ObjectFifoPutOp and ObjectFifoGetOp
+//===----------------------------------------------------------------------===//
+
+// Verify a put or get of a value of the given type, given the objectFifo its
+// symbol refers to.
+static LogicalResult verifyObjectFifoStreamAccess(Operation *op,
+                                                  ObjectFifoPort port,
+                                                  Type valueType,
+                                                  ObjectFifoCreateOp objFifo) {
+  if (failed(verifyObjectFifoPort(op, port, objFifo)))
+    return failure();
+  if (!objFifo.getStream())
+    return op->emitOpError("requires an objectFifo with the `stream` "
+                           "attribute");
+  if (Type elemType = objFifo.getElemType()
+                          .cast<AIEObjectFifoType>()
+                          .getElementType()
+                          .getElementType();
+      elemType != valueType)
+    return op->emitOpError("value type ")
+           << valueType << " doesn't match the objectFifo element type "
+           << elemType;
   return success();
 }
 
-ObjectFifoCreateOp ObjectFifoReleaseOp::getObjectFifo() {
-  Operation *parent = getOperation();
+template <typename StreamAccessOp>
+static ObjectFifoCreateOp lookupStreamObjectFifo(StreamAccessOp op) {
+  Operation *parent = op.getOperation();
   while ((parent = parent->getParentOp())) {
     if (parent->hasTrait<OpTrait::SymbolTable>()) {
-      if (auto *st = SymbolTable::lookupSymbolIn(parent, getObjFifoName());
+      if (auto *st = SymbolTable::lookupSymbolIn(parent, op.getObjFifoName());
           isa_and_nonnull<ObjectFifoCreateOp>(st))
         return dyn_cast<ObjectFifoCreateOp>(st);
     }
@@ -814,6 +992,32 @@ ObjectFifoCreateOp ObjectFifoReleaseOp::getObjectFifo() {
   return {};
 }
 
+LogicalResult ObjectFifoPutOp::verify() {
+  if (!getOperation()->getParentOfType<CoreOp>())
+    return emitOpError("must be called from inside a CoreOp");
+  if ((*this)->getParentOfType<DeviceOp>())
+    return success();
+  return verifyObjectFifoStreamAccess(*this, ObjectFifoPort::Produce,
+                                      getValue().getType(), getObjectFifo());
+}
+
+ObjectFifoCreateOp ObjectFifoPutOp::getObjectFifo() {
+  return lookupStreamObjectFifo(*this);
+}
+
+LogicalResult ObjectFifoGetOp::verify() {
+  if (!getOperation()->getParentOfType<CoreOp>())
+    return emitOpError("must be called from inside a CoreOp");
+  if ((*this)->getParentOfType<DeviceOp>())
+    return success();
+  return verifyObjectFifoStreamAccess(*this, ObjectFifoPort::Consume,
+                                      getValue().getType(), getObjectFifo());
+}
+
+ObjectFifoCreateOp ObjectFifoGetOp::getObjectFifo() {
+  return lookupStreamObjectFifo(*this);
+}
+
 //===----------------------------------------------------------------------===//
 // ObjectFifoSubviewAccessOp
 //===----------------------------------------------------------------------===//
@@ -971,10 +1175,120 @@ LogicalResult GetCascadeOp::verify() {
   return success();
 }
 
+//===----------------------------------------------------------------------===//
+// CascadeReduceOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult CascadeReduceOp::verify() {
+  const auto &targetModel = getTargetModel(*this);
+  int64_t cascadeBits;
+  if (targetModel.getTargetArch() == AIEArch::AIE1)
+    cascadeBits = 384;
+  else if (targetModel.getTargetArch() == AIEArch::AIE2)
+    cascadeBits = 512;
+  else
+    return emitOpError("cascade not supported in ")
+           << stringifyAIEArch(targetModel.getTargetArch());
+
+  Type type = getPartial().getType();
+  Type elementType = getElementTypeOrSelf(type);
+  if (!isa<IntegerType, FloatType>(elementType))
+    return emitOpError("must reduce integers or floats");
+  DataLayout dataLayout = DataLayout::closest(*this);
+  int64_t bits = dataLayout.getTypeSizeInBits(type);
+  if (bits == 0 || bits % cascadeBits)
+    return emitOpError("must reduce a multiple of the ")
+           << cascadeBits << "-bit cascade";
+  if (bits != cascadeBits) {
+    auto vectorType = dyn_cast<VectorType>(type);
+    if (!vectorType || vectorType.getRank() != 1 ||
+        cascadeBits % dataLayout.getTypeSizeInBits(elementType))
+      return emitOpError("wider than the cascade must be a vector of a whole "
+                         "number of elements per cascade word");
+  }
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // DeviceOp
 //===----------------------------------------------------------------------===//
 
+// Read the geometry of an npu device from its description, on top of the
+// defaults.
+static LogicalResult
+parseNPUGeometry(DictionaryAttr description, NPUGeometry &geometry,
+                 function_ref<InFlightDiagnostic()> emitError) {
+  for (NamedAttribute entry : description) {
+    StringRef name = entry.getName().getValue();
+    if (name == "noc_columns") {
+      auto columns = dyn_cast<ArrayAttr>(entry.getValue());
+      if (!columns || !llvm::all_of(columns, [](Attribute column) {
+            return isa<IntegerAttr>(column);
+          }))
+        return emitError() << "geometry entry 'noc_columns' must be an array "
+                              "of integers";
+      geometry.nocColumns.clear();
+      for (auto column : columns.getAsRange<IntegerAttr>())
+        geometry.nocColumns.push_back(column.getInt());
+      continue;
+    }
+
+    auto value = dyn_cast<IntegerAttr>(entry.getValue());
+    if (!value)
+      return emitError() << "geometry entry '" << name
+                         << "' must be an integer";
+    int64_t minimum = name == "mem_tile_rows" ? 0 : 1;
+    if (value.getInt() < minimum || value.getInt() > 255)
+      return emitError() << "geometry entry '" << name << "' must be in ["
+                         << minimum << ", 255]";
+    if (name == "columns")
+      geometry.columns = value.getInt();
+    else if (name == "mem_tile_rows")
+      geometry.memTileRows = value.getInt();
+    else if (name == "core_rows")
+      geometry.coreRows = value.getInt();
+    else if (name == "shim_bds")
+      geometry.shimBDs = value.getInt();
+    else if (name == "mem_tile_bds")
+      geometry.memTileBDs = value.getInt();
+    else if (name == "core_bds")
+      geometry.coreBDs = value.getInt();
+    else
+      return emitError() << "unknown geometry entry '" << name << "'";
+  }
+
+  for (unsigned column : geometry.nocColumns)
+    if (column >= static_cast<unsigned>(geometry.columns))
+      return emitError() << "NOC column " << column
+                         << " is outside of the " << geometry.columns
+                         << " columns of the device";
+  if (1 + geometry.memTileRows + geometry.coreRows > 255)
+    return emitError() << "the device cannot have more than 255 rows";
+  return success();
+}
+
+// The models of the npu devices, one per geometry, shared by all the devices
+// with the same geometry.
+static const NPUTargetModel &getNPUTargetModel(const NPUGeometry &geometry) {
+  static std::mutex mutex;
+  static std::map<NPUGeometry, std::unique_ptr<NPUTargetModel>> models;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &model = models[geometry];
+  if (!model)
+    model = std::make_unique<NPUTargetModel>(geometry);
+  return *model;
+}
+
+LogicalResult DeviceOp::verify() {
+  if (!getGeometry())
+    return success();
+  if (getDevice() != AIEDevice::npu)
+    return emitOpError("only the npu device can describe its geometry");
+  NPUGeometry geometry;
+  return parseNPUGeometry(*getGeometry(), geometry,
+                          [&] { return emitOpError(); });
+}
+
 const AIETargetModel &DeviceOp::getTargetModel() {
   switch (getDevice()) {
   case AIEDevice::xcvc1902:
@@ -985,12 +1299,21 @@ const AIETargetModel &DeviceOp::getTargetModel() {
     return VE2802model;
   case AIEDevice::ipu:
     return IPUmodel;
+  case AIEDevice::npu: {
+    // The description is checked by the verifier, so its errors are not
+    // reported again here.
+    NPUGeometry geometry;
+    if (auto description = getGeometry();
+        description &&
+        failed(parseNPUGeometry(*description, geometry,
+                                [] { return InFlightDiagnostic(); })))
+      geometry = NPUGeometry();
+    return getNPUTargetModel(geometry);
+  }
   }
   return VC1902model;
 }
 
-LogicalResult DeviceOp::verify() { return success(); }
-
 //===----------------------------------------------------------------------===//
 // TileOp
 //===----------------------------------------------------------------------===//
@@ -1010,6 +1333,11 @@ LogicalResult TileOp::verify() {
            << ") must be less than the number of rows in the device (" << rows
            << ")";
 
+  // Inside a device, the switchboxes of all the tiles are checked by
+  // DeviceOp::verifyRegions.
+  if ((*this)->getParentOfType<DeviceOp>())
+    return success();
+
   auto users = getResult().getUsers();
   bool found = false;
   for (auto *user : users) {
@@ -1224,10 +1552,26 @@ LogicalResult PacketFlowOp::verify() {
 LogicalResult CoreOp::verify() {
   if (getBody().empty())
     return emitOpError("should have non-empty body");
+  if (isHerdElement(*this))
+    return success();
   if (getTileOp().isShimTile())
     return emitOpError("CoreOp cannot be created on shim tile, i.e. row == 0");
   if (getTileOp().isMemTile())
     return emitOpError("CoreOp cannot be created on mem tile");
+  if (getOverlays().has_value() != getOverlaySize().has_value())
+    return emitOpError("overlays and overlay_size must be given together");
+  if (auto overlays = getOverlays()) {
+    if (overlays->empty())
+      return emitOpError("should have at least one overlay");
+    // The overlays are loaded by whole instruction words, and leave room for
+    // the resident code starting the core.
+    int64_t size = *getOverlaySize();
+    int64_t programMemorySize = getTargetModel(*this).getProgramMemorySize();
+    if (size <= 0 || size % 16 || size >= programMemorySize)
+      return emitOpError("overlay_size must be a positive multiple of 16 "
+                         "bytes, smaller than the program memory of ")
+             << programMemorySize << " bytes";
+  }
   return success();
 }
 
@@ -1237,6 +1581,44 @@ int CoreOp::rowIndex() { return getTileOp().rowIndex(); }
 
 TileOp CoreOp::getTileOp() { return cast<TileOp>(getTile().getDefiningOp()); }
 
+//===----------------------------------------------------------------------===//
+// PhasesOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult PhasesOp::verify() {
+  if (!(*this)->getParentOfType<CoreOp>())
+    return emitOpError("must be in a core");
+  if (getPhases().empty())
+    return emitOpError("should have at least one phase");
+
+  // The objectFifos of a phase are not shared with the others, whose accesses
+  // would otherwise be assigned the same buffers.
+  llvm::StringMap<unsigned> phaseOfFifo;
+  for (unsigned index = 0; index < getPhases().size(); index++) {
+    Region &phase = getPhases()[index];
+    if (phase.empty())
+      return emitOpError("phase ") << index << " should have a body";
+    WalkResult result = phase.walk([&](Operation *op) {
+      StringRef fifo;
+      if (auto acquire = dyn_cast<ObjectFifoAcquireOp>(op))
+        fifo = acquire.getObjFifoName();
+      else if (auto release = dyn_cast<ObjectFifoReleaseOp>(op))
+        fifo = release.getObjFifoName();
+      else
+        return WalkResult::advance();
+      auto [it, inserted] = phaseOfFifo.try_emplace(fifo, index);
+      if (inserted || it->second == index)
+        return WalkResult::advance();
+      emitOpError("objectFifo @")
+          << fifo << " is used by phases " << it->second << " and " << index;
+      return WalkResult::interrupt();
+    });
+    if (result.wasInterrupted())
+      return failure();
+  }
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // BufferOp
 //===----------------------------------------------------------------------===//
@@ -1267,6 +1649,19 @@ int32_t xilinx::AIE::getBufferBaseAddress(Operation *bufOp) {
   llvm::report_fatal_error("unknown buffer type");
 }
 
+LogicalResult xilinx::AIE::verifyShimAxiSettings(
+    Operation *op, std::optional<int64_t> burstLength,
+    std::optional<int64_t> axCache, std::optional<int64_t> axQos) {
+  if (burstLength && *burstLength != 64 && *burstLength != 128 &&
+      *burstLength != 256)
+    return op->emitOpError("burst_length must be 64, 128 or 256 bytes");
+  if (axCache && (*axCache < 0 || *axCache > 0xF))
+    return op->emitOpError("ax_cache exceeds the [0:15] range");
+  if (axQos && (*axQos < 0 || *axQos > 0xF))
+    return op->emitOpError("ax_qos exceeds the [0:15] range");
+  return success();
+}
+
 void xilinx::AIE::collectTiles(DeviceOp &device,
                                DenseMap<TileID, Operation *> &tiles) {
   for (auto tile : device.getOps<TileOp>()) {
@@ -1460,6 +1855,28 @@ BufferOp DMABDOp::getBufferOp() {
   return cast<BufferOp>(getBuffer().getDefiningOp());
 }
 
+// Return the direction of the channel that runs the BD of op, if a channel
+// reaches it.
+static std::optional<DMAChannelDir> getBDChannelDir(DMABDOp op) {
+  if (auto dmaOp = op->getParentOfType<DMAOp>())
+    return dmaOp.getChannelDir();
+  Block *bd = op->getBlock();
+  for (auto startOp : bd->getParent()->getOps<DMAStartOp>()) {
+    SmallVector<Block *> worklist = {startOp.getDest()};
+    llvm::SmallPtrSet<Block *, 8> visited;
+    while (!worklist.empty()) {
+      Block *block = worklist.pop_back_val();
+      if (block == bd)
+        return startOp.getChannelDir();
+      if (!visited.insert(block).second || block->empty())
+        continue;
+      if (auto nextBdOp = dyn_cast<NextBDOp>(block->back()))
+        worklist.push_back(nextBdOp.getDest());
+    }
+  }
+  return std::nullopt;
+}
+
 LogicalResult DMABDOp::verify() {
   if (!isa<BufferOp, ExternalBufferOp>(getBuffer().getDefiningOp()))
     return emitOpError(
@@ -1523,6 +1940,58 @@ LogicalResult DMABDOp::verify() {
   if (!getLen() && !getBuffer().getType().hasStaticShape())
     return emitOpError() << "buffer with dynamic shape requires static length.";
 
+  if (getPadDimensions()) {
+    if (!getOperation()->getParentOfType<MemTileDMAOp>() ||
+        getBDChannelDir(*this) != DMAChannelDir::MM2S)
+      return emitOpError()
+             << "padding is only supported on the MM2S channels of memtiles.";
+    if (!getDimensions())
+      return emitOpError() << "padding requires strides and sizes.";
+
+    ArrayRef<BDDimLayoutAttr> dims = *getDimensions();
+    ArrayRef<BDPadLayoutAttr> pads = *getPadDimensions();
+    if (pads.size() != dims.size())
+      return emitOpError() << "expected one padding per dimension ("
+                           << dims.size() << "), got " << pads.size() << ".";
+
+    // The lowest dimension is given last; the fourth dimension of a memtile
+    // BD cannot be padded.
+    const uint16_t maxPads[] = {63, 31, 15, 0};
+    uint64_t paddedWords = 1;
+    for (size_t i = 0; i < dims.size(); i++) {
+      size_t dim = dims.size() - i - 1;
+      if (pads[i].getConstPadBefore() > maxPads[dim] ||
+          pads[i].getConstPadAfter() > maxPads[dim])
+        return emitOpError() << "padding of dimension " << dim
+                             << " may not exceed " << maxPads[dim] << ".";
+      paddedWords *= pads[i].getConstPadBefore() + dims[i].getSize() +
+                     pads[i].getConstPadAfter();
+    }
+
+    int bytes = getBuffer().getType().getElementTypeBitWidth() / 8;
+    if (4 * paddedWords > static_cast<uint64_t>(getLenValue()) * bytes)
+      return emitOpError() << "padded data (" << 4 * paddedWords
+                           << " bytes) exceeds the length of the BD ("
+                           << getLenValue() * bytes << " bytes).";
+  }
+
+  if (getCompression()) {
+    if (getTargetModel(*this).getTargetArch() != AIEArch::AIE2)
+      return emitOpError() << "compression is only supported on AIE-ML "
+                              "devices.";
+    if (getOperation()->getParentOfType<ShimDMAOp>())
+      return emitOpError() << "compression is not supported on shim tiles.";
+  }
+
+  if (getBurstLength() || getAxCache() || getAxQos()) {
+    if (!getOperation()->getParentOfType<ShimDMAOp>())
+      return emitOpError() << "AXI settings are only supported on the BDs of "
+                              "shim DMAs.";
+    if (failed(verifyShimAxiSettings(*this, getBurstLength(), getAxCache(),
+                                     getAxQos())))
+      return failure();
+  }
+
   return success();
 }
 
@@ -1547,10 +2016,12 @@ LogicalResult SwitchboxOp::verify() {
   Region &body = getConnections();
   DenseSet<Port> sourceset;
   DenseSet<Port> destset;
-  auto tile = getTileOp();
-  const auto &targetModel = getTargetModel(tile);
   if (body.empty())
     return emitOpError("should have non-empty body");
+  if (isHerdElement(*this))
+    return success();
+  auto tile = getTileOp();
+  const auto &targetModel = getTargetModel(tile);
   for (auto &ops : body.front()) {
     // Would be simpler if this could be templatized.
     auto checkBound = [&ops](StringRef dir, WireBundle bundle, int index,
@@ -1718,7 +2189,7 @@ LogicalResult LockOp::verify() {
   if (auto result = UsesAreAccessable::verifyTrait(*this); result.failed())
     return result;
 
-  if (getLockID().has_value()) {
+  if (getLockID().has_value() && !isHerdElement(*this)) {
     const auto &targetModel = getTargetModel(getTileOp());
     auto tileOp = getTileOp();
     if (int numLocks =
@@ -1781,6 +2252,21 @@ struct AccessesLocalLocks {
   }
 };
 
+// Verify the uses of locks in the DMA block of the given use_lock, reporting
+// the errors on it.
+static LogicalResult verifyDMABlockLocks(UseLockOp useLock,
+                                         const AIETargetModel &targetModel) {
+  if (targetModel.getTargetArch() == AIEArch::AIE1 &&
+      UsesOneLockInDMABlock::verifyTrait(useLock).failed())
+    return useLock.emitOpError("used in a DMA block that have multiple locks.");
+
+  if (AcquireReleaseOneStateInDMABlock::verifyTrait(useLock).failed())
+    return useLock.emitOpError(
+        "acquires/releases the lock in a DMA block from/to multiple states.");
+
+  return success();
+}
+
 LogicalResult UseLockOp::verify() {
   // AIE.useLock cannot be used at the top level
   if (llvm::isa_and_nonnull<DeviceOp, ModuleOp>((*this)->getParentOp()))
@@ -1797,14 +2283,11 @@ LogicalResult UseLockOp::verify() {
     if (!(*this)->getBlock())
       return (*this)->emitOpError("is not in a block.");
 
-    if (targetModel.getTargetArch() == AIEArch::AIE1 &&
-        UsesOneLockInDMABlock::verifyTrait(*this).failed())
-      return (*this)->emitOpError(
-          "used in a DMA block that have multiple locks.");
-
-    if (AcquireReleaseOneStateInDMABlock::verifyTrait(*this).failed())
-      return (*this)->emitOpError(
-          "acquires/releases the lock in a DMA block from/to multiple states.");
+    // Inside a device, each DMA block is checked once for all its locks by
+    // DeviceOp::verifyRegions.
+    if (!(*this)->getParentOfType<DeviceOp>() &&
+        failed(verifyDMABlockLocks(*this, targetModel)))
+      return failure();
 
     if (HasSomeParent<MemOp>::verifyTrait(*this).succeeded() &&
         AccessesLocalLocks::verifyTrait(*this).failed())
@@ -1821,6 +2304,67 @@ LogicalResult UseLockOp::verify() {
          << "AIE::device, AIE::core, func::func, AIE::mem, or AIE::shimDMA";
 }
 
+//===----------------------------------------------------------------------===//
+// DeviceOp
+//===----------------------------------------------------------------------===//
+
+// The checks that relate ops across the device are done here, once all its
+// ops are verified, so that the symbols and the blocks they need are
+// looked up or scanned once for the whole device instead of once per op.
+LogicalResult DeviceOp::verifyRegions() {
+  const auto &targetModel = getTargetModel();
+
+  DenseSet<Value> switchboxTiles;
+  for (auto switchbox : getOps<SwitchboxOp>())
+    if (!switchboxTiles.insert(switchbox.getTile()).second)
+      return switchbox.getTileOp().emitOpError("can only have one switchbox");
+
+  SymbolTable symbolTable(*this);
+  auto lookupObjectFifo = [&](StringRef name) {
+    return symbolTable.lookup<ObjectFifoCreateOp>(name);
+  };
+  auto lookupObjectFifos = [&](ArrayAttr names) {
+    std::vector<ObjectFifoCreateOp> objFifos;
+    for (auto name : names)
+      if (auto objFifo =
+              lookupObjectFifo(cast<SymbolRefAttr>(name).getLeafReference()))
+        objFifos.push_back(objFifo);
+    return objFifos;
+  };
+
+  DenseSet<Block *> dmaBlocks;
+  WalkResult result = walk([&](Operation *op) {
+    LogicalResult verified = success();
+    if (auto link = dyn_cast<ObjectFifoLinkOp>(op))
+      verified =
+          verifyObjectFifoLink(link, lookupObjectFifos(link.getFifoIns()),
+                               lookupObjectFifos(link.getFifoOuts()));
+    else if (auto acquire = dyn_cast<ObjectFifoAcquireOp>(op))
+      verified = verifyObjectFifoAcquire(
+          acquire, lookupObjectFifo(acquire.getObjFifoName()));
+    else if (auto release = dyn_cast<ObjectFifoReleaseOp>(op))
+      verified = verifyObjectFifoRelease(
+          release, lookupObjectFifo(release.getObjFifoName()));
+    else if (auto put = dyn_cast<ObjectFifoPutOp>(op))
+      verified = verifyObjectFifoStreamAccess(
+          put, ObjectFifoPort::Produce, put.getValue().getType(),
+          lookupObjectFifo(put.getObjFifoName()));
+    else if (auto get = dyn_cast<ObjectFifoGetOp>(op))
+      verified = verifyObjectFifoStreamAccess(
+          get, ObjectFifoPort::Consume, get.getValue().getType(),
+          lookupObjectFifo(get.getObjFifoName()));
+    else if (auto useLock = dyn_cast<UseLockOp>(op);
+             useLock &&
+             HasSomeParent<MemOp, MemTileDMAOp, ShimDMAOp>::verifyTrait(op)
+                 .succeeded() &&
+             dmaBlocks.insert(useLock->getBlock()).second)
+      // The first use_lock of each DMA block reports the errors of the block.
+      verified = verifyDMABlockLocks(useLock, targetModel);
+    return failed(verified) ? WalkResult::interrupt() : WalkResult::advance();
+  });
+  return failure(result.wasInterrupted());
+}
+
 #include "aie/Dialect/AIE/IR/AIEEnums.cpp.inc"
 #include "aie/Dialect/AIE/IR/AIEInterfaces.cpp.inc"
 
@@ -18,6 +18,31 @@ namespace xilinx {
 namespace AIE {
 AIETargetModel::~AIETargetModel() = default;
 
+void AIETargetModel::buildTables() {
+  // The tile types are needed to compute the connections, so they are
+  // published before the connections are computed.
+  std::vector<AIETileType> types(columns() * rows());
+  for (int col = 0; col < columns(); col++)
+    for (int row = 0; row < rows(); row++)
+      types[col * rows() + row] = computeTileType(col, row);
+  tileTypes = std::move(types);
+  tableColumns = columns();
+  tableRows = rows();
+
+  destSwitchboxConnections.assign(tileTypes.size() * numBundles, 0);
+  sourceSwitchboxConnections.assign(tileTypes.size() * numBundles, 0);
+  for (int col = 0; col < columns(); col++)
+    for (int row = 0; row < rows(); row++)
+      for (unsigned bundle = 0; bundle < numBundles; bundle++) {
+        auto wireBundle = static_cast<WireBundle>(bundle);
+        size_t index = getTableIndex(col, row, wireBundle);
+        destSwitchboxConnections[index] =
+            computeNumDestSwitchboxConnections(col, row, wireBundle);
+        sourceSwitchboxConnections[index] =
+            computeNumSourceSwitchboxConnections(col, row, wireBundle);
+      }
+}
+
 ///
 /// AIE1 TargetModel
 ///
@@ -107,8 +132,8 @@ bool AIE1TargetModel::isLegalMemAffinity(int coreCol, int coreRow, int memCol,
 }
 
 uint32_t
-AIE1TargetModel::getNumDestSwitchboxConnections(int col, int row,
-                                                WireBundle bundle) const {
+AIE1TargetModel::computeNumDestSwitchboxConnections(
+    int col, int row, WireBundle bundle) const {
   if (isShimNOCTile(col, row) || isShimPLTile(col, row))
     switch (bundle) {
     case WireBundle::FIFO:
@@ -159,8 +184,8 @@ AIE1TargetModel::getNumDestSwitchboxConnections(int col, int row,
 }
 
 uint32_t
-AIE1TargetModel::getNumSourceSwitchboxConnections(int col, int row,
-                                                  WireBundle bundle) const {
+AIE1TargetModel::computeNumSourceSwitchboxConnections(
+    int col, int row, WireBundle bundle) const {
   if (isShimNOCTile(col, row) || isShimPLTile(col, row))
     switch (bundle) {
     case WireBundle::FIFO:
@@ -334,8 +359,8 @@ bool AIE2TargetModel::isLegalMemAffinity(int coreCol, int coreRow, int memCol,
 }
 
 uint32_t
-AIE2TargetModel::getNumDestSwitchboxConnections(int col, int row,
-                                                WireBundle bundle) const {
+AIE2TargetModel::computeNumDestSwitchboxConnections(
+    int col, int row, WireBundle bundle) const {
   if (isMemTile(col, row))
     switch (bundle) {
     case WireBundle::DMA:
@@ -343,6 +368,8 @@ AIE2TargetModel::getNumDestSwitchboxConnections(int col, int row,
       return 6;
     case WireBundle::South:
       return 4;
+    case WireBundle::Ctrl:
+      return 1;
     default:
       return 0;
     }
@@ -365,6 +392,8 @@ AIE2TargetModel::getNumDestSwitchboxConnections(int col, int row,
         return 0;
       return 4;
     }
+    case WireBundle::Ctrl:
+      return 1;
     default:
       return 0;
     }
@@ -393,14 +422,16 @@ AIE2TargetModel::getNumDestSwitchboxConnections(int col, int row,
       return 0;
     return 4;
   }
+  case WireBundle::Ctrl:
+    return 1;
   default:
     return 0;
   }
 }
 
 uint32_t
-AIE2TargetModel::getNumSourceSwitchboxConnections(int col, int row,
-                                                  WireBundle bundle) const {
+AIE2TargetModel::computeNumSourceSwitchboxConnections(
+    int col, int row, WireBundle bundle) const {
   if (isMemTile(col, row))
     switch (bundle) {
     case WireBundle::DMA:
@@ -410,6 +441,7 @@ AIE2TargetModel::getNumSourceSwitchboxConnections(int col, int row,
     case WireBundle::South:
       return 6;
     case WireBundle::Trace:
+    case WireBundle::Ctrl:
       return 1;
     default:
       return 0;
@@ -434,6 +466,7 @@ AIE2TargetModel::getNumSourceSwitchboxConnections(int col, int row,
       return 4;
     }
     case WireBundle::Trace:
+    case WireBundle::Ctrl:
       return 1;
     default:
       return 0;
@@ -467,6 +500,8 @@ AIE2TargetModel::getNumSourceSwitchboxConnections(int col, int row,
   case WireBundle::Trace:
     // Port 0: core trace. Port 1: memory trace.
     return 2;
+  case WireBundle::Ctrl:
+    return 1;
   default:
     return 0;
   }
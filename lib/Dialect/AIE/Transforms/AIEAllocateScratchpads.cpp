@@ -0,0 +1,178 @@
+//===- AIEAllocateScratchpads.cpp -------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass places the temporaries that the kernels of a core allocate with
+// memref.alloc and memref.alloca in a scratchpad, an aie.buffer of the tile of
+// the core. They would otherwise be allocated on the stack or the heap of the
+// core, which are sized for the worst case and can't be shared with the
+// buffers placed by aie-assign-buffer-addresses.
+//
+// The live range of an allocation is computed like in aie-reuse-buffers: it
+// spans the operations of the core from the allocation to its last access,
+// and all the operations of any loop containing one of them. Allocations
+// whose live ranges don't intersect share the same bytes of the scratchpad,
+// each one becoming a memref.view of it at a fixed offset.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIELiveRanges.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "aie-allocate-scratchpads"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Return the size in bytes of an allocation which can become a view of the
+// scratchpad, or nothing: its type must be static with an identity layout
+// and whole bytes per element.
+static std::optional<int64_t> getScratchSize(Operation *alloc) {
+  auto type = cast<MemRefType>(alloc->getResult(0).getType());
+  if (!type.hasStaticShape() || !type.getLayout().isIdentity() ||
+      type.getMemorySpace() || !type.getElementType().isIntOrFloat() ||
+      type.getElementTypeBitWidth() % 8)
+    return {};
+  return type.getNumElements() * type.getElementTypeBitWidth() / 8;
+}
+
+struct AIEAllocateScratchpadsPass
+    : AIEAllocateScratchpadsBase<AIEAllocateScratchpadsPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    if (clAlignment == 0 || (clAlignment & (clAlignment - 1))) {
+      device.emitError("alignment must be a power of two");
+      return signalPassFailure();
+    }
+
+    struct Allocation {
+      Operation *alloc;
+      int64_t size;
+      int64_t alignment;
+      int start;
+      int end;
+      int64_t offset = 0;
+    };
+
+    for (auto core : device.getOps<CoreOp>()) {
+      CoreLiveRanges liveRanges(core);
+      if (!liveRanges.isStructured())
+        continue;
+
+      SmallVector<Allocation> allocations;
+      core.walk([&](Operation *alloc) {
+        if (!isa<memref::AllocOp, memref::AllocaOp>(alloc))
+          return;
+        std::optional<int64_t> size = getScratchSize(alloc);
+        if (!size) {
+          if (clReport)
+            alloc->emitRemark("not placed in the scratchpad: its type isn't "
+                              "static or has a layout");
+          return;
+        }
+        SmallVector<Operation *> accesses = {alloc};
+        if (!liveRanges.collectAccesses(alloc->getResult(0), accesses)) {
+          if (clReport)
+            alloc->emitRemark("not placed in the scratchpad: its accesses "
+                              "can't be tracked");
+          return;
+        }
+
+        int64_t alignment = clAlignment;
+        if (auto attr = alloc->getAttrOfType<IntegerAttr>("alignment"))
+          alignment = std::max<int64_t>(alignment, attr.getInt());
+        auto [start, end] = liveRanges.getLiveRange(accesses);
+        Allocation allocation = {alloc, *size, alignment, start, end};
+        allocations.push_back(allocation);
+      });
+      if (allocations.empty())
+        continue;
+
+      // Place the largest allocations first, each one at the lowest offset
+      // not overlapping those already placed which are live at the same
+      // time.
+      SmallVector<Allocation *> order;
+      for (Allocation &allocation : allocations)
+        order.push_back(&allocation);
+      llvm::stable_sort(order, [](Allocation *a, Allocation *b) {
+        return a->size > b->size;
+      });
+      int64_t scratchSize = 0;
+      SmallVector<Allocation *> placed;
+      for (Allocation *allocation : order) {
+        SmallVector<Allocation *> live;
+        for (Allocation *other : placed)
+          if (other->start <= allocation->end &&
+              allocation->start <= other->end)
+            live.push_back(other);
+        llvm::sort(live, [](Allocation *a, Allocation *b) {
+          return a->offset < b->offset;
+        });
+        int64_t offset = 0;
+        for (Allocation *other : live) {
+          if (offset + allocation->size <= other->offset)
+            break;
+          offset = std::max<int64_t>(
+              offset, llvm::alignTo(other->offset + other->size,
+                                    allocation->alignment));
+        }
+        allocation->offset = offset;
+        scratchSize = std::max(scratchSize, offset + allocation->size);
+        placed.push_back(allocation);
+      }
+
+      if (clReport) {
+        int64_t totalSize = 0;
+        for (Allocation &allocation : allocations)
+          totalSize += allocation.size;
+        core.emitRemark("scratchpad of ")
+            << scratchSize << " bytes for " << allocations.size()
+            << " allocation(s) of " << totalSize << " bytes";
+      }
+
+      OpBuilder builder(core);
+      std::string name = "core_" + std::to_string(core.getTileID().col) +
+                         "_" + std::to_string(core.getTileID().row) +
+                         "_scratch";
+      auto scratch = builder.create<BufferOp>(
+          core.getLoc(),
+          MemRefType::get({scratchSize}, builder.getIntegerType(8)),
+          core.getTile(),
+          SymbolTable::lookupSymbolIn(device, name)
+              ? nullptr
+              : builder.getStringAttr(name),
+          /*address*/ nullptr, /*initial_value*/ nullptr);
+
+      for (Allocation &allocation : allocations) {
+        Operation *alloc = allocation.alloc;
+        builder.setInsertionPoint(alloc);
+        Value offset = builder.create<arith::ConstantIndexOp>(
+            alloc->getLoc(), allocation.offset);
+        Value view = builder.create<memref::ViewOp>(
+            alloc->getLoc(), alloc->getResult(0).getType(), scratch, offset,
+            ValueRange());
+        for (Operation *user :
+             llvm::make_early_inc_range(alloc->getResult(0).getUsers()))
+          if (isa<memref::DeallocOp>(user))
+            user->erase();
+        alloc->getResult(0).replaceAllUsesWith(view);
+        alloc->erase();
+      }
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIEAllocateScratchpadsPass() {
+  return std::make_unique<AIEAllocateScratchpadsPass>();
+}
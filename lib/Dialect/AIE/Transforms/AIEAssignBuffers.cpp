@@ -12,8 +12,11 @@
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
 
 #include "mlir/IR/Attributes.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Pass/Pass.h"
 
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/Twine.h"
 
 #define DEBUG_TYPE "aie-assign-buffers"
@@ -22,6 +25,283 @@ using namespace mlir;
 using namespace xilinx;
 using namespace xilinx::AIE;
 
+// Emit an error listing the memory map of a tile whose buffers exceed its
+// memory.
+static void emitMemoryMapError(TileOp tile, ArrayRef<BufferOp> buffers,
+                               int stacksize) {
+  InFlightDiagnostic error =
+      tile.emitOpError("allocated buffers exceeded available memory\n");
+  auto &note = error.attachNote() << "MemoryMap:\n";
+  auto printbuffer = [&](StringRef name, int address, int size) {
+    note << "\t" << name << " \t"
+         << ": 0x" << llvm::utohexstr(address) << "-0x"
+         << llvm::utohexstr(address + size - 1) << " \t(" << size
+         << " bytes)\n";
+  };
+  if (stacksize > 0)
+    printbuffer(tile.getCoreOp() ? "(stack)" : "(west neighbour buffers)", 0,
+                stacksize);
+  else
+    error << "(no stack allocated)\n";
+
+  for (auto buffer : buffers) {
+    assert(buffer.getAddress().has_value() &&
+           "buffer must have address assigned");
+    printbuffer(buffer.name(), buffer.getAddress().value(),
+                buffer.getAllocationSize());
+  }
+}
+
+// Place the buffers one after the other, starting after the stack. Returns
+// the first address past the allocated buffers.
+static int basicSequentialAllocation(ArrayRef<BufferOp> buffers,
+                                     int stacksize) {
+  int address = stacksize;
+  for (auto buffer : buffers) {
+    if (buffer.getAddress())
+      buffer->emitWarning("Overriding existing address");
+    buffer.setAddress(address);
+    address += buffer.getAllocationSize();
+  }
+  return address;
+}
+
+// Return the cores and DMAs accessing a buffer.
+static SmallPtrSet<Operation *, 4> getAccessors(BufferOp buffer) {
+  SmallPtrSet<Operation *, 4> accessors;
+  for (Operation *user : buffer->getUsers()) {
+    Operation *ancestor = user;
+    while (ancestor->getParentOp() && !isa<DeviceOp>(ancestor->getParentOp()))
+      ancestor = ancestor->getParentOp();
+    if (isa<CoreOp, MemOp, MemTileDMAOp>(ancestor))
+      accessors.insert(ancestor);
+  }
+  return accessors;
+}
+
+// Place every buffer in one of the memory banks of the tile, so that buffers
+// accessed by the same core or DMA land in different banks where possible.
+// Each buffer goes to the bank holding the fewest buffers with a common
+// accessor, then to the least used bank. Buffers of equal size, such as the
+// elements of an objectFifo, are visited in turn and so are spread over
+// different banks. Returns false, leaving the addresses unchanged, if some
+// buffer doesn't fit in the free space of any single bank.
+static bool bankAwareAllocation(TileOp tile, ArrayRef<BufferOp> buffers,
+                                int stacksize, int maxDataMemorySize) {
+  const auto &targetModel = getTargetModel(tile);
+  int numBanks = targetModel.getNumBanks(tile.getCol(), tile.getRow());
+  if (numBanks <= 0)
+    return false;
+  int bankSize = maxDataMemorySize / numBanks;
+
+  // The stack is at the bottom of the memory, possibly covering several banks.
+  SmallVector<int> nextAddress(numBanks);
+  for (int bank = 0; bank < numBanks; bank++)
+    nextAddress[bank] = std::max(bank * bankSize, stacksize);
+  SmallVector<SmallVector<SmallPtrSet<Operation *, 4>>> bankAccessors(
+      numBanks);
+
+  SmallVector<int> addresses;
+  for (auto buffer : buffers) {
+    int size = buffer.getAllocationSize();
+    SmallPtrSet<Operation *, 4> accessors = getAccessors(buffer);
+    std::optional<int> bestBank;
+    std::pair<int, int> bestCost;
+    for (int bank = 0; bank < numBanks; bank++) {
+      if (nextAddress[bank] + size > (bank + 1) * bankSize)
+        continue;
+      int conflicts = llvm::count_if(bankAccessors[bank], [&](auto &other) {
+        return llvm::any_of(accessors,
+                            [&](Operation *op) { return other.contains(op); });
+      });
+      int used = nextAddress[bank] - bank * bankSize;
+      std::pair<int, int> cost = {conflicts, used};
+      if (!bestBank || cost < bestCost) {
+        bestBank = bank;
+        bestCost = cost;
+      }
+    }
+    if (!bestBank) {
+      LLVM_DEBUG(llvm::dbgs() << "Buffer " << buffer.name()
+                              << " doesn't fit in any bank of " << tile
+                              << "\n");
+      return false;
+    }
+    addresses.push_back(nextAddress[*bestBank]);
+    nextAddress[*bestBank] += size;
+    bankAccessors[*bestBank].push_back(std::move(accessors));
+  }
+
+  for (auto [i, address] : llvm::enumerate(addresses)) {
+    BufferOp buffer = buffers[i];
+    if (buffer.getAddress())
+      buffer->emitWarning("Overriding existing address");
+    buffer.setAddress(address);
+  }
+  return true;
+}
+
+// Return the size of the memory available for buffers in a tile.
+static int getDataMemorySize(TileOp tile) {
+  const auto &targetModel = getTargetModel(tile);
+  if (tile.isMemTile())
+    return targetModel.getMemTileSize();
+  return targetModel.getLocalMemorySize();
+}
+
+// Move buffers out of tiles whose memory is full into the memory of a
+// neighbouring tile. Only buffers accessed by cores alone can move, since a
+// DMA can only reach the memory of its own tile, and the new tile must be
+// accessible from every one of these cores. Among the candidate tiles, the
+// one with the fewest buffers accessed by a DMA is preferred, to avoid
+// contention with DMA transfers, and then the one with the most free memory.
+// Larger buffers are moved first, so that few buffers leave their tile.
+static void placeInNeighborMemory(DeviceOp device) {
+  const auto &targetModel = device.getTargetModel();
+  DenseMap<TileID, TileOp> tiles;
+  DenseMap<Operation *, SmallVector<BufferOp>> tileBuffers;
+  DenseMap<Operation *, int> usedMemory;
+  DenseMap<Operation *, int> dmaBuffers;
+  for (auto tile : device.getOps<TileOp>()) {
+    tiles[tile.getTileID()] = tile;
+    if (auto core = tile.getCoreOp())
+      usedMemory[tile] = core.getStackSize();
+  }
+  device.walk([&](BufferOp buffer) {
+    Operation *tile = buffer.getTileOp();
+    tileBuffers[tile].push_back(buffer);
+    usedMemory[tile] += buffer.getAllocationSize();
+    if (llvm::any_of(getAccessors(buffer),
+                     [](Operation *op) { return !isa<CoreOp>(op); }))
+      dmaBuffers[tile]++;
+  });
+
+  for (auto tile : device.getOps<TileOp>()) {
+    if (usedMemory[tile] <= getDataMemorySize(tile))
+      continue;
+    SmallVector<BufferOp> buffers = tileBuffers[tile];
+    std::stable_sort(buffers.begin(), buffers.end(),
+                     [](BufferOp a, BufferOp b) {
+                       return a.getAllocationSize() > b.getAllocationSize();
+                     });
+    for (auto buffer : buffers) {
+      if (usedMemory[tile] <= getDataMemorySize(tile))
+        break;
+      SmallPtrSet<Operation *, 4> accessors = getAccessors(buffer);
+      if (accessors.empty() || llvm::any_of(accessors, [](Operation *op) {
+            return !isa<CoreOp>(op);
+          }))
+        continue;
+
+      int size = buffer.getAllocationSize();
+      TileOp bestTile;
+      for (auto maybeMem :
+           {targetModel.getMemWest(tile.getTileID()),
+            targetModel.getMemEast(tile.getTileID()),
+            targetModel.getMemNorth(tile.getTileID()),
+            targetModel.getMemSouth(tile.getTileID())}) {
+        if (!maybeMem || !tiles.count(*maybeMem))
+          continue;
+        TileOp mem = tiles[*maybeMem];
+        if (mem == tile || mem.isShimTile() ||
+            usedMemory[mem] + size > getDataMemorySize(mem) ||
+            llvm::any_of(accessors, [&](Operation *op) {
+              TileOp core = cast<CoreOp>(op).getTileOp();
+              return !targetModel.isLegalMemAffinity(
+                  core.getCol(), core.getRow(), mem.getCol(), mem.getRow());
+            }))
+          continue;
+        auto rank = [&](TileOp t) {
+          return std::make_pair(dmaBuffers[t], usedMemory[t]);
+        };
+        if (!bestTile || rank(mem) < rank(bestTile))
+          bestTile = mem;
+      }
+      if (!bestTile)
+        continue;
+
+      LLVM_DEBUG(llvm::dbgs() << "Moving buffer " << buffer.name() << " from "
+                              << tile.getTileID() << " to "
+                              << bestTile.getTileID() << "\n");
+      buffer->setOperand(0, bestTile.getResult());
+      usedMemory[tile] -= size;
+      usedMemory[bestTile] += size;
+    }
+  }
+}
+
+// The range of memory available to the buffers of a tile: from the first
+// address past the end of the buffers of the west neighbour spanning into its
+// memory, up to the end of its memory, or further into the memory of its east
+// neighbour when its buffers span into it.
+struct MemoryRange {
+  int base = 0;
+  int limit = 0;
+};
+
+// Let the buffers of full memtiles span into the memory of their east
+// neighbour, which the memtile DMAs address right after their own memory.
+// The buffers of a memtile are then placed one after the other, and the
+// neighbour places its own buffers after the end of the last one. A memtile
+// holding the end of the buffers of its west neighbour doesn't span into its
+// own east neighbour. The buffers must only be accessed by the DMAs of the
+// two memtiles, since the DMA of the west neighbour of the memtile would
+// address their end past its east neighbour.
+static void planMemTileSpans(DeviceOp device, ArrayRef<TileOp> tiles,
+                             ArrayRef<SmallVector<BufferOp, 4>> tileBuffers,
+                             DenseMap<Operation *, MemoryRange> &ranges) {
+  const auto &targetModel = device.getTargetModel();
+  int size = targetModel.getMemTileSize();
+  DenseMap<TileID, unsigned> tileIndices;
+  for (auto [i, tile] : llvm::enumerate(tiles))
+    tileIndices[tile.getTileID()] = i;
+  auto usedMemory = [&](unsigned i) {
+    int used = 0;
+    for (BufferOp buffer : tileBuffers[i])
+      used += buffer.getAllocationSize();
+    return used;
+  };
+
+  SmallVector<unsigned> memTiles;
+  for (auto [i, tile] : llvm::enumerate(tiles))
+    if (tile.isMemTile())
+      memTiles.push_back(i);
+  llvm::sort(memTiles, [&](unsigned a, unsigned b) {
+    return std::make_pair(tiles[a].getRow(), tiles[a].getCol()) <
+           std::make_pair(tiles[b].getRow(), tiles[b].getCol());
+  });
+  for (unsigned i : memTiles) {
+    TileOp tile = tiles[i];
+    MemoryRange &range = ranges[tile];
+    range.limit = size;
+    int end = range.base + usedMemory(i);
+    if (range.base > 0 || end <= size ||
+        !targetModel.isMemTile(tile.getCol() + 1, tile.getRow()))
+      continue;
+    TileID east = {tile.getCol() + 1, tile.getRow()};
+    bool accessible = llvm::all_of(tileBuffers[i], [&](BufferOp buffer) {
+      return llvm::all_of(getAccessors(buffer), [&](Operation *op) {
+        auto dma = dyn_cast<MemTileDMAOp>(op);
+        return dma && (dma.getTileID() == tile.getTileID() ||
+                       dma.getTileID() == east);
+      });
+    });
+    if (!accessible)
+      continue;
+    int eastUsed = 0;
+    auto eastIndex = tileIndices.find(east);
+    if (eastIndex != tileIndices.end())
+      eastUsed = usedMemory(eastIndex->second);
+    if (end > 2 * size - eastUsed)
+      continue;
+    range.limit = 2 * size - eastUsed;
+    LLVM_DEBUG(llvm::dbgs() << "Buffers of " << tile.getTileID() << " span "
+                            << end - size << " bytes of " << east << "\n");
+    if (eastIndex != tileIndices.end())
+      ranges[tiles[eastIndex->second]].base = end - size;
+  }
+}
+
 struct AIEAssignBufferAddressesPass
     : AIEAssignBufferAddressesBase<AIEAssignBufferAddressesPass> {
   void getDependentDialects(DialectRegistry &registry) const override {
@@ -31,6 +311,15 @@ struct AIEAssignBufferAddressesPass
   void runOnOperation() override {
     DeviceOp device = getOperation();
     OpBuilder builder = OpBuilder::atBlockEnd(device.getBody());
+
+    if (clAllocScheme != "basic-sequential" && clAllocScheme != "bank-aware") {
+      device.emitError("unknown allocation scheme: ") << clAllocScheme;
+      return signalPassFailure();
+    }
+
+    if (clUseNeighborMemory)
+      placeInNeighborMemory(device);
+
     // Make sure all the buffers have a name
     int counter = 0;
     device.walk<WalkOrder::PreOrder>([&](BufferOp buffer) {
@@ -42,65 +331,69 @@ struct AIEAssignBufferAddressesPass
       }
     });
 
-    for (auto tile : device.getOps<TileOp>()) {
-      const auto &targetModel = getTargetModel(tile);
-      int maxDataMemorySize = 0;
-      if (tile.isMemTile())
-        maxDataMemorySize = targetModel.getMemTileSize();
-      else
-        maxDataMemorySize = targetModel.getLocalMemorySize();
-      SmallVector<BufferOp, 4> buffers;
-      // Collect all the buffers for this tile.
-      device.walk<WalkOrder::PreOrder>([&](BufferOp buffer) {
-        if (buffer.getTileOp() == tile)
-          buffers.push_back(buffer);
-      });
-      // Sort by allocation size.
-      std::sort(buffers.begin(), buffers.end(), [](BufferOp a, BufferOp b) {
-        return a.getAllocationSize() > b.getAllocationSize();
-      });
+    // Collect the buffers of every tile in a single walk.
+    SmallVector<TileOp> tiles(device.getOps<TileOp>());
+    DenseMap<Operation *, unsigned> tileIndices;
+    for (auto [i, tile] : llvm::enumerate(tiles))
+      tileIndices[tile] = i;
+    SmallVector<SmallVector<BufferOp, 4>> tileBuffers(tiles.size());
+    device.walk<WalkOrder::PreOrder>([&](BufferOp buffer) {
+      tileBuffers[tileIndices.lookup(buffer.getTileOp())].push_back(buffer);
+    });
 
-      // Address range owned by the MemTile is 0x80000.
-      // Address range owned by the tile is 0x8000,
-      // but we need room at the bottom for stack.
-      int stacksize = 0;
-      int address = 0;
-      if (auto core = tile.getCoreOp()) {
-        stacksize = core.getStackSize();
-        address += stacksize;
-      }
+    DenseMap<Operation *, MemoryRange> ranges;
+    if (clSpanMemTiles)
+      planMemTileSpans(device, tiles, tileBuffers, ranges);
 
-      for (auto buffer : buffers) {
-        if (buffer.getAddress())
-          buffer->emitWarning("Overriding existing address");
-        buffer.setAddress(address);
-        address += buffer.getAllocationSize();
-      }
+    // The tiles are allocated independently of each other, in parallel. The
+    // diagnostics are reported in the order of the tiles.
+    MLIRContext *context = &getContext();
+    ParallelDiagnosticHandler diagHandler(context);
+    LogicalResult result = failableParallelForEachN(
+        context, 0, tiles.size(), [&](size_t i) {
+          diagHandler.setOrderIDForThread(i);
+          auto clearOrderID = llvm::make_scope_exit(
+              [&] { diagHandler.eraseOrderIDForThread(); });
+          MemoryRange range = {0, getDataMemorySize(tiles[i])};
+          if (auto it = ranges.find(tiles[i]); it != ranges.end())
+            range = it->second;
+          return allocateTile(tiles[i], tileBuffers[i], range);
+        });
+    if (failed(result))
+      signalPassFailure();
+  }
 
-      if (address > maxDataMemorySize) {
-        InFlightDiagnostic error =
-            tile.emitOpError("allocated buffers exceeded available memory\n");
-        auto &note = error.attachNote() << "MemoryMap:\n";
-        auto printbuffer = [&](StringRef name, int address, int size) {
-          note << "\t" << name << " \t"
-               << ": 0x" << llvm::utohexstr(address) << "-0x"
-               << llvm::utohexstr(address + size - 1) << " \t(" << size
-               << " bytes)\n";
-        };
-        if (stacksize > 0)
-          printbuffer("(stack)", 0, stacksize);
-        else
-          error << "(no stack allocated)\n";
-
-        for (auto buffer : buffers) {
-          assert(buffer.getAddress().has_value() &&
-                 "buffer must have address assigned");
-          printbuffer(buffer.name(), buffer.getAddress().value(),
-                      buffer.getAllocationSize());
-        }
-        return signalPassFailure();
-      }
+private:
+  // Assign the addresses of the buffers of a tile in the given range of
+  // memory.
+  LogicalResult allocateTile(TileOp tile, SmallVectorImpl<BufferOp> &buffers,
+                             MemoryRange range) {
+    int maxDataMemorySize = range.limit;
+    // Sort by allocation size.
+    std::sort(buffers.begin(), buffers.end(), [](BufferOp a, BufferOp b) {
+      return a.getAllocationSize() > b.getAllocationSize();
+    });
+
+    // Address range owned by the MemTile is 0x80000.
+    // Address range owned by the tile is 0x8000,
+    // but we need room at the bottom for stack.
+    int stacksize = range.base;
+    if (auto core = tile.getCoreOp())
+      stacksize = core.getStackSize();
+
+    // Fall back to sequential allocation if the buffers can't be placed in
+    // separate banks. Buffers spanning into the memory of the east
+    // neighbour are placed sequentially, as planned by planMemTileSpans.
+    if (clAllocScheme == "bank-aware" &&
+        maxDataMemorySize <= getDataMemorySize(tile) &&
+        bankAwareAllocation(tile, buffers, stacksize, maxDataMemorySize))
+      return success();
+
+    if (basicSequentialAllocation(buffers, stacksize) > maxDataMemorySize) {
+      emitMemoryMapError(tile, buffers, stacksize);
+      return failure();
     }
+    return success();
   }
 };
 
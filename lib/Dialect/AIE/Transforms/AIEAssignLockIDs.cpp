@@ -13,7 +13,9 @@
 // exceeds the number of locks on the tile, the pass generates an error and
 // terminates. AIE.lock operations for different tiles are numbered
 // independently. If there are existing lock IDs, this pass is idempotent
-// and only assigns lock IDs to locks without an ID.
+// and only assigns lock IDs to locks without an ID. With spill-to-neighbours,
+// locks which don't fit on their tile and are only used by cores are moved to
+// a neighbouring memory those cores can also access.
 
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
@@ -28,6 +30,13 @@ using namespace xilinx;
 using namespace xilinx::AIE;
 
 struct AIEAssignLockIDsPass : AIEAssignLockIDsBase<AIEAssignLockIDsPass> {
+  // All of the lock ops on a tile, separated into ops which have been
+  // assigned to a lock, and ops which have not.
+  struct TileLockOps {
+    DenseSet<int> assigned;
+    SmallVector<LockOp> unassigned;
+  };
+
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<func::FuncDialect>();
     registry.insert<AIEDialect>();
@@ -37,13 +46,6 @@ struct AIEAssignLockIDsPass : AIEAssignLockIDsBase<AIEAssignLockIDsPass> {
     DeviceOp device = getOperation();
     OpBuilder rewriter = OpBuilder::atBlockEnd(device.getBody());
 
-    // All of the lock ops on a tile, separated into ops which have been
-    // assigned to a lock, and ops which have not.
-    struct TileLockOps {
-      DenseSet<int> assigned;
-      SmallVector<LockOp> unassigned;
-    };
-
     DenseMap<TileOp, TileLockOps> tileToLocks;
 
     // Construct data structure storing locks by tile.
@@ -75,7 +77,7 @@ struct AIEAssignLockIDsPass : AIEAssignLockIDsBase<AIEAssignLockIDsPass> {
     });
 
     // IR mutation: assign locks to all unassigned lock ops.
-    for (auto [tileOp, locks] : tileToLocks) {
+    for (auto &[tileOp, locks] : tileToLocks) {
       const auto locksPerTile =
           getTargetModel(tileOp).getNumLocks(tileOp.getCol(), tileOp.getRow());
       uint32_t nextID = 0;
@@ -85,6 +87,8 @@ struct AIEAssignLockIDsPass : AIEAssignLockIDsBase<AIEAssignLockIDsPass> {
           ++nextID;
         }
         if (nextID == locksPerTile) {
+          if (clSpillToNeighbours)
+            break;
           mlir::InFlightDiagnostic diag =
               lockOp->emitOpError("not allocated a lock.");
           diag.attachNote(tileOp.getLoc()) << "because only " << locksPerTile
@@ -92,9 +96,77 @@ struct AIEAssignLockIDsPass : AIEAssignLockIDsBase<AIEAssignLockIDsPass> {
           return signalPassFailure();
         }
         lockOp.setLockIDAttr(rewriter.getI32IntegerAttr(nextID));
+        locks.assigned.insert(nextID);
         ++nextID;
       }
     }
+
+    if (!clSpillToNeighbours)
+      return;
+
+    // Move the locks left without an ID, in program order, to the first tile
+    // with a free lock whose memory all the cores using them can access.
+    SmallVector<LockOp> spilled;
+    device.walk([&](LockOp lockOp) {
+      if (!lockOp.getLockID().has_value())
+        spilled.push_back(lockOp);
+    });
+    for (auto lockOp : spilled) {
+      TileOp tileOp = lockOp.getTileOp();
+      TileOp neighbour = findNeighbourWithFreeLock(device, lockOp, tileToLocks);
+      if (!neighbour) {
+        mlir::InFlightDiagnostic diag =
+            lockOp->emitOpError("not allocated a lock.");
+        diag.attachNote(tileOp.getLoc())
+            << "because only "
+            << getTargetModel(tileOp).getNumLocks(tileOp.getCol(),
+                                                  tileOp.getRow())
+            << " locks available in this tile and its neighbours.";
+        return signalPassFailure();
+      }
+      auto &assigned = tileToLocks[neighbour].assigned;
+      uint32_t lockID = 0;
+      while (assigned.contains(lockID))
+        ++lockID;
+      lockOp->setOperand(0, neighbour.getResult());
+      lockOp.setLockIDAttr(rewriter.getI32IntegerAttr(lockID));
+      assigned.insert(lockID);
+    }
+  }
+
+  /// Return a tile declared before lockOp with a free lock, other than the
+  /// tile of lockOp, whose memory is accessible from all the cores using
+  /// lockOp, or nullptr if there is none. Locks used by DMAs, or outside of
+  /// cores, stay on their tile.
+  TileOp
+  findNeighbourWithFreeLock(DeviceOp device, LockOp lockOp,
+                            DenseMap<TileOp, TileLockOps> &tileToLocks) {
+    SmallVector<TileOp> cores;
+    for (Operation *user : lockOp->getUsers()) {
+      auto coreOp = user->getParentOfType<CoreOp>();
+      if (!coreOp)
+        return nullptr;
+      cores.push_back(coreOp.getTileOp());
+    }
+    if (cores.empty())
+      return nullptr;
+
+    const auto &targetModel = device.getTargetModel();
+    for (auto tileOp : device.getOps<TileOp>()) {
+      if (tileOp == lockOp.getTileOp() || !tileOp->isBeforeInBlock(lockOp))
+        continue;
+      if (tileOp.isShimTile() ||
+          tileToLocks[tileOp].assigned.size() >=
+              targetModel.getNumLocks(tileOp.getCol(), tileOp.getRow()))
+        continue;
+      if (llvm::all_of(cores, [&](TileOp core) {
+            return targetModel.isLegalMemAffinity(
+                core.getCol(), core.getRow(), tileOp.getCol(),
+                tileOp.getRow());
+          }))
+        return tileOp;
+    }
+    return nullptr;
   }
 };
 
@@ -0,0 +1,183 @@
+//===- AIECascadeReductions.cpp ---------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass lowers the aie.cascade_reduce operations of each chain to a
+// running sum passed along the cascade.
+//
+// The cascade only connects a core to its neighbour to the South or to the
+// East, so the cores of a chain are ordered along a path of such steps
+// through all of their tiles, found by a depth-first search. The consecutive
+// cores of the path are connected by aie.cascade_flow operations, lowered by
+// aie-lower-cascade-flows. Each core but the first adds its partial value to
+// the sum received from the previous core, and each core but the last sends
+// its sum to the next one, in pieces of the size of the cascade.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/Interfaces/DataLayoutInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/MapVector.h"
+
+#define DEBUG_TYPE "aie-cascade-reductions"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Whether the cascade of the core on tile `a` can feed the core on tile `b`.
+static bool isCascadeStep(const AIETargetModel &targetModel, TileOp a,
+                          TileOp b) {
+  return targetModel.isSouth(a.getCol(), a.getRow(), b.getCol(), b.getRow()) ||
+         targetModel.isEast(a.getCol(), a.getRow(), b.getCol(), b.getRow());
+}
+
+// Extend the path through the given reductions to visit all of them, if
+// possible.
+static bool findChain(const AIETargetModel &targetModel,
+                      ArrayRef<CascadeReduceOp> reductions,
+                      SmallVectorImpl<CascadeReduceOp> &path,
+                      DenseSet<Operation *> &visited) {
+  if (path.size() == reductions.size())
+    return true;
+  TileOp last = cast<CoreOp>(path.back()->getParentOp()).getTileOp();
+  for (CascadeReduceOp next : reductions) {
+    if (visited.contains(next))
+      continue;
+    if (!isCascadeStep(targetModel, last,
+                       cast<CoreOp>(next->getParentOp()).getTileOp()))
+      continue;
+    path.push_back(next);
+    visited.insert(next);
+    if (findChain(targetModel, reductions, path, visited))
+      return true;
+    visited.erase(next);
+    path.pop_back();
+  }
+  return false;
+}
+
+struct AIECascadeReductionsPass
+    : AIECascadeReductionsBase<AIECascadeReductionsPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    const auto &targetModel = device.getTargetModel();
+    int64_t cascadeBits =
+        targetModel.getTargetArch() == AIEArch::AIE1 ? 384 : 512;
+
+    llvm::MapVector<StringRef, SmallVector<CascadeReduceOp>> chains;
+    device.walk([&](CascadeReduceOp reduce) {
+      chains[reduce.getChain()].push_back(reduce);
+    });
+
+    DenseSet<Operation *> cascadeTiles;
+    for (auto flow : device.getOps<CascadeFlowOp>()) {
+      cascadeTiles.insert(flow.getSourceTileOp());
+      cascadeTiles.insert(flow.getDestTileOp());
+    }
+
+    OpBuilder builder(device.getContext());
+    for (auto &[name, reductions] : chains) {
+      DenseSet<Operation *> cores;
+      for (CascadeReduceOp reduce : reductions) {
+        auto core = cast<CoreOp>(reduce->getParentOp());
+        if (!cores.insert(core).second) {
+          reduce.emitOpError("is not the only reduction of chain '")
+              << name << "' in its core";
+          return signalPassFailure();
+        }
+        if (reductions.size() > 1 && cascadeTiles.contains(core.getTileOp())) {
+          reduce.emitOpError("is on a tile whose cascade is already used");
+          return signalPassFailure();
+        }
+      }
+
+      SmallVector<CascadeReduceOp> path;
+      DenseSet<Operation *> visited;
+      bool found = false;
+      for (CascadeReduceOp first : reductions) {
+        path = {first};
+        visited.clear();
+        visited.insert(first);
+        if ((found = findChain(targetModel, reductions, path, visited)))
+          break;
+      }
+      if (!found) {
+        reductions.front().emitOpError("chain '")
+            << name << "' cannot be ordered along the cascade: each core "
+            << "must be followed by a core to its South or East";
+        return signalPassFailure();
+      }
+
+      builder.setInsertionPoint(device.getBody()->getTerminator());
+      for (size_t i = 0; i + 1 < path.size(); i++) {
+        TileOp source = cast<CoreOp>(path[i]->getParentOp()).getTileOp();
+        TileOp dest = cast<CoreOp>(path[i + 1]->getParentOp()).getTileOp();
+        builder.create<CascadeFlowOp>(builder.getUnknownLoc(), source, dest);
+        cascadeTiles.insert(source);
+        cascadeTiles.insert(dest);
+      }
+
+      for (auto [index, reduce] : llvm::enumerate(path)) {
+        builder.setInsertionPoint(reduce);
+        Location loc = reduce.getLoc();
+        Value sum = reduce.getPartial();
+        Type type = sum.getType();
+        DataLayout dataLayout = DataLayout::closest(reduce);
+        int64_t pieces = dataLayout.getTypeSizeInBits(type) / cascadeBits;
+        auto vectorType = dyn_cast<VectorType>(type);
+        int64_t pieceElements =
+            pieces > 1 ? vectorType.getNumElements() / pieces : 0;
+        Type pieceType =
+            pieces > 1
+                ? VectorType::get({pieceElements}, vectorType.getElementType())
+                : type;
+
+        if (index > 0) {
+          Value received = sum;
+          for (int64_t piece = 0; piece < pieces; piece++) {
+            Value value = builder.create<GetCascadeOp>(loc, pieceType);
+            if (pieces == 1)
+              received = value;
+            else
+              received = builder.create<vector::InsertStridedSliceOp>(
+                  loc, value, received,
+                  ArrayRef<int64_t>{piece * pieceElements},
+                  ArrayRef<int64_t>{1});
+          }
+          if (isa<FloatType>(getElementTypeOrSelf(type)))
+            sum = builder.create<arith::AddFOp>(loc, received, sum);
+          else
+            sum = builder.create<arith::AddIOp>(loc, received, sum);
+        }
+        if (index + 1 < path.size()) {
+          for (int64_t piece = 0; piece < pieces; piece++) {
+            Value value = sum;
+            if (pieces > 1)
+              value = builder.create<vector::ExtractStridedSliceOp>(
+                  loc, sum, ArrayRef<int64_t>{piece * pieceElements},
+                  ArrayRef<int64_t>{pieceElements}, ArrayRef<int64_t>{1});
+            builder.create<PutCascadeOp>(loc, value);
+          }
+        }
+        reduce.replaceAllUsesWith(sum);
+        reduce.erase();
+      }
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIECascadeReductionsPass() {
+  return std::make_unique<AIECascadeReductionsPass>();
+}
@@ -0,0 +1,167 @@
+//===- AIECompactBDChains.cpp -----------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass reduces the number of buffer descriptors used by the DMAs of a
+// device. The BD chain started by each aie.dma_start is followed through its
+// aie.next_bd terminators. When the chain is a repetition of a shorter
+// sequence of identical blocks, only one period of it is kept:
+//
+// - a chain looping back to its first block is closed after the first
+//   period;
+// - on AIE2, a chain ending in a block without BDs (usually the aie.end
+//   block) is cut after the first period, and the repeat_count of the
+//   aie.dma_start is multiplied by the number of periods, so that the
+//   channel runs the shortened chain the same number of times.
+//
+// Optionally, the number of BDs used by each DMA is reported against the
+// number available on its tile.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/IR/OperationSupport.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "aie-compact-bd-chains"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// The largest repeat_count supported by the DMA channel queues of AIE2.
+static constexpr int64_t maxRepeatCount = 256;
+
+// Two BD blocks are identical if they perform the same operations on the
+// same values, ignoring their aie.next_bd terminators.
+static bool areIdenticalBlocks(Block *a, Block *b) {
+  auto aOps = a->without_terminator();
+  auto bOps = b->without_terminator();
+  if (std::distance(aOps.begin(), aOps.end()) !=
+      std::distance(bOps.begin(), bOps.end()))
+    return false;
+  for (auto [aOp, bOp] : llvm::zip(aOps, bOps))
+    if (!OperationEquivalence::isEquivalentTo(
+            &aOp, &bOp, OperationEquivalence::exactValueMatch,
+            /*markEquivalent=*/nullptr,
+            OperationEquivalence::IgnoreLocations))
+      return false;
+  return true;
+}
+
+// Returns the smallest period of the chain, i.e. the smallest p dividing its
+// length such that each block is identical to the block p positions before.
+static size_t getChainPeriod(ArrayRef<Block *> chain) {
+  for (size_t period = 1; period < chain.size(); period++) {
+    if (chain.size() % period != 0)
+      continue;
+    bool periodic = true;
+    for (size_t i = period; i < chain.size() && periodic; i++)
+      periodic = areIdenticalBlocks(chain[i], chain[i % period]);
+    if (periodic)
+      return period;
+  }
+  return chain.size();
+}
+
+static void eraseBlocks(ArrayRef<Block *> blocks) {
+  for (Block *block : blocks)
+    block->dropAllReferences();
+  for (Block *block : blocks)
+    block->erase();
+}
+
+// Compacts the chain started by the given aie.dma_start.
+static void compactChain(DMAStartOp start, bool canRepeat) {
+  SmallVector<Block *> chain;
+  Block *block = start.getDest();
+  Block *end = nullptr;
+  bool cyclic = false;
+  while (true) {
+    if (block->getOps<DMABDOp>().empty() || block->getNumArguments() != 0) {
+      end = block;
+      break;
+    }
+    // Blocks other than the first may only be reached through the chain,
+    // otherwise removing them would change other chains.
+    if (!chain.empty() && !block->getSinglePredecessor())
+      return;
+    chain.push_back(block);
+    auto next = dyn_cast<NextBDOp>(block->getTerminator());
+    if (!next)
+      return;
+    block = next.getDest();
+    if (block == chain.front()) {
+      cyclic = true;
+      break;
+    }
+    if (llvm::is_contained(chain, block))
+      return;
+  }
+  if (chain.size() < 2)
+    return;
+
+  size_t period = getChainPeriod(chain);
+  if (period == chain.size())
+    return;
+
+  if (!cyclic) {
+    int64_t repeatCount = start.getRepeatCount() * (chain.size() / period);
+    if (!canRepeat || repeatCount > maxRepeatCount)
+      return;
+    start.setRepeatCount(repeatCount);
+  }
+
+  LLVM_DEBUG(llvm::dbgs() << "Compacting a chain of " << chain.size()
+                          << " BDs to " << period << " in " << start << "\n");
+  auto last = cast<NextBDOp>(chain[period - 1]->getTerminator());
+  last->setSuccessor(cyclic ? chain.front() : end, 0);
+  eraseBlocks(ArrayRef<Block *>(chain).drop_front(period));
+}
+
+struct AIECompactBDChainsPass
+    : AIECompactBDChainsBase<AIECompactBDChainsPass> {
+  template <typename DMAOpTy>
+  void compactDMA(DMAOpTy dma) {
+    const auto &targetModel = getTargetModel(dma);
+    bool canRepeat = targetModel.getTargetArch() != AIEArch::AIE1;
+
+    SmallVector<DMAStartOp> starts;
+    for (Block &block : dma.getBody())
+      for (auto start : block.template getOps<DMAStartOp>())
+        starts.push_back(start);
+    for (DMAStartOp start : starts)
+      compactChain(start, canRepeat);
+
+    if (!clReportBDUsage)
+      return;
+    int numBDs = 0;
+    for (Block &block : dma.getBody())
+      if (!block.template getOps<DMABDOp>().empty())
+        numBDs++;
+    TileID tile = dma.getTileID();
+    dma.emitRemark("uses ")
+        << numBDs << " of " << targetModel.getNumBDs(tile.col, tile.row)
+        << " buffer descriptors";
+  }
+
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    for (auto mem : device.getOps<MemOp>())
+      compactDMA(mem);
+    for (auto memTile : device.getOps<MemTileDMAOp>())
+      compactDMA(memTile);
+    for (auto shim : device.getOps<ShimDMAOp>())
+      compactDMA(shim);
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>> AIE::createAIECompactBDChainsPass() {
+  return std::make_unique<AIECompactBDChainsPass>();
+}
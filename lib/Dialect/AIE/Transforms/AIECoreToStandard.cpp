@@ -17,6 +17,7 @@
 #include "mlir/Dialect/ControlFlow/IR/ControlFlow.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/IRMapping.h"
@@ -87,6 +88,7 @@ static auto getAIE2Intrinsics(OpBuilder &builder) {
   Type accType = VectorType::get({16}, int32Type);
   IntrinsicDecls functions = {
       {"debug_i32", {int32Type}, {}},
+      {"llvm.aie2.event", {int32Type}, {}}, //(%event) -> ()
       {"llvm.aie2.put.ms", {int32Type, int32Type}, {}}, //(%value, %tlast) -> ()
       {"llvm.aie2.get.ss", {}, {int32Type, int32Type}}, //() -> (%value, %tlast)
       {"llvm.aie2.mcd.write.vec",
@@ -366,9 +368,17 @@ struct AIEUseLockToStdLowering : OpConversionPattern<UseLockOp> {
       if (useLock.acquireGE()) {
         lockValue = -lockValue;
       }
-      args.push_back(rewriter.create<arith::IndexCastOp>(
-          useLock.getLoc(), IntegerType::get(rewriter.getContext(), 32),
-          useLock.getLock()));
+      // Locks localized to a core are constants, which are passed to the
+      // intrinsic as immediates.
+      if (std::optional<int64_t> lockID =
+              getConstantIntValue(useLock.getLock()))
+        args.push_back(rewriter.create<arith::ConstantOp>(
+            useLock.getLoc(), IntegerType::get(rewriter.getContext(), 32),
+            rewriter.getI32IntegerAttr(*lockID)));
+      else
+        args.push_back(rewriter.create<arith::IndexCastOp>(
+            useLock.getLoc(), IntegerType::get(rewriter.getContext(), 32),
+            useLock.getLock()));
       args.push_back(rewriter.create<arith::ConstantOp>(
           useLock.getLoc(), IntegerType::get(rewriter.getContext(), 32),
           rewriter.getI32IntegerAttr(lockValue)));
@@ -381,7 +391,47 @@ struct AIEUseLockToStdLowering : OpConversionPattern<UseLockOp> {
   }
 };
 
+// Lower aie.phases to a cf.switch on the phase between the inlined regions of
+// the phases, which branch to the operations following it when they end.
+struct AIEPhasesToStdLowering : OpConversionPattern<PhasesOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(PhasesOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Block *block = op->getBlock();
+    Block *continueBlock =
+        rewriter.splitBlock(block, std::next(op->getIterator()));
+
+    SmallVector<int32_t> caseValues;
+    SmallVector<Block *> caseDestinations;
+    for (auto [index, phase] : llvm::enumerate(op.getPhases())) {
+      for (Block &phaseBlock : phase)
+        if (auto end = dyn_cast<EndOp>(phaseBlock.getTerminator())) {
+          rewriter.setInsertionPoint(end);
+          rewriter.create<cf::BranchOp>(end.getLoc(), continueBlock);
+          rewriter.eraseOp(end);
+        }
+      caseValues.push_back(index);
+      caseDestinations.push_back(&phase.front());
+      rewriter.inlineRegionBefore(phase, continueBlock);
+    }
+
+    // A phase out of range runs none of them.
+    rewriter.setInsertionPointToEnd(block);
+    rewriter.create<cf::SwitchOp>(
+        op.getLoc(), adaptor.getPhase(), continueBlock, ValueRange{},
+        caseValues, caseDestinations,
+        SmallVector<ValueRange>(caseDestinations.size(), ValueRange{}));
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
 struct AIEBufferToStandard : OpConversionPattern<BufferOp> {
+  // The largest alignment assumed for a buffer, e.g. for one at address 0.
+  static constexpr uint32_t maxBufferAlignment = 1024;
+
   using OpConversionPattern::OpConversionPattern;
   ModuleOp &module;
   int tileCol = 0;
@@ -409,14 +459,24 @@ struct AIEBufferToStandard : OpConversionPattern<BufferOp> {
         buffer.getType(), initValue, /*constant*/ false,
         /*alignment*/ nullptr);
 
+    // Assume that buffers are aligned so they can be vectorized. Once the
+    // buffer has an address, its alignment is known, and is the same from
+    // every core: the memories of the neighbours are mapped at multiples of
+    // their size.
+    uint32_t alignment = 32;
+    if (std::optional<int32_t> address = buffer.getAddress()) {
+      auto offset = static_cast<uint32_t>(*address);
+      alignment = offset ? std::min(offset & (~offset + 1), maxBufferAlignment)
+                         : maxBufferAlignment;
+    }
+
     for (auto &use : make_early_inc_range(buffer.getResult().getUses())) {
       Operation *user = use.getOwner();
       rewriter.setInsertionPoint(user);
       auto allocated = rewriter.create<memref::GetGlobalOp>(
           rewriter.getUnknownLoc(), t, symName);
-      // Assume that buffers are aligned so they can be vectorized.
       rewriter.create<memref::AssumeAlignmentOp>(rewriter.getUnknownLoc(),
-                                                 allocated, 32);
+                                                 allocated, alignment);
 
       use.set(allocated.getResult());
     }
@@ -494,7 +554,8 @@ void outlineOps(DeviceOp device) {
     op->moveBefore(device);
 }
 
-// Lower AIE.event to llvm.aie.event intrinsic
+// Lower AIE.event to the llvm.aie.event0/1 intrinsics on AIE1, and to the
+// llvm.aie2.event intrinsic taking the event on AIE2.
 struct AIEEventOpToStdLowering : OpConversionPattern<EventOp> {
   using OpConversionPattern::OpConversionPattern;
   ModuleOp &module;
@@ -506,6 +567,14 @@ struct AIEEventOpToStdLowering : OpConversionPattern<EventOp> {
   LogicalResult
   matchAndRewrite(EventOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
+    if (auto eventFunc = module.lookupSymbol<func::FuncOp>("llvm.aie2.event")) {
+      auto event = rewriter.create<arith::ConstantOp>(
+          op.getLoc(), rewriter.getI32IntegerAttr(op.getVal()));
+      rewriter.create<func::CallOp>(rewriter.getUnknownLoc(), eventFunc,
+                                    ValueRange{event});
+      rewriter.eraseOp(op);
+      return success();
+    }
     std::string funcName = "llvm.aie.event" + std::to_string(op.getVal());
     auto eventFunc = module.lookupSymbol<func::FuncOp>(funcName);
     if (!eventFunc)
@@ -546,6 +615,19 @@ struct AIECoreToStandardPass : AIECoreToStandardBase<AIECoreToStandardPass> {
     builder.setInsertionPointToStart(m.getBody());
     declareAIEIntrinsics(targetModel.getTargetArch(), builder);
 
+    // Bracket the operations of the cores marked as profiled, usually the
+    // calls of their kernels, with the instruction events timed by the
+    // performance counters programmed by the CDO.
+    for (auto core : device.getOps<CoreOp>())
+      core.walk([&](Operation *op) {
+        if (!op->removeAttr("aie.profile"))
+          return;
+        OpBuilder eventBuilder(op);
+        eventBuilder.create<EventOp>(op->getLoc(), 0);
+        eventBuilder.setInsertionPointAfter(op);
+        eventBuilder.create<EventOp>(op->getLoc(), 1);
+      });
+
     IRMapping mapper;
     ConversionTarget target(getContext());
     target.addLegalDialect<func::FuncDialect>();
@@ -561,6 +643,7 @@ struct AIECoreToStandardPass : AIECoreToStandardBase<AIECoreToStandardPass> {
                  AIEPutCascadeToStdLowering, AIEGetCascadeToStdLowering,
                  AIEDebugOpToStdLowering, AIEUseLockToStdLowering,
                  AIEEventOpToStdLowering>(m.getContext(), m);
+    patterns.add<AIEPhasesToStdLowering>(m.getContext());
 
     patterns.add<AIEBufferToStandard>(m.getContext(), m, /*benefit*/ 1, tileCol,
                                       tileRow);
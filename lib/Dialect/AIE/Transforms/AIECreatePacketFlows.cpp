@@ -10,6 +10,7 @@
 
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+#include "aie/Dialect/AIE/Transforms/AIEPathFinder.h"
 
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/PatternMatch.h"
@@ -17,8 +18,11 @@
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 #include "mlir/Transforms/DialectConversion.h"
 
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/Twine.h"
 
+#include <map>
+
 #define DEBUG_TYPE "aie-create-packet-flows"
 
 using namespace mlir;
@@ -53,15 +57,7 @@ getAvailableDestChannel(SmallVector<std::pair<Connect, int>, 8> &connects,
   if (connects.empty())
     return {0};
 
-  int numChannels;
-
-  if (destBundle == WireBundle::North)
-    numChannels = 6;
-  else if (destBundle == WireBundle::South || destBundle == WireBundle::East ||
-           destBundle == WireBundle::West)
-    numChannels = 4;
-  else
-    numChannels = 2;
+  int numChannels = getLogicalNumDestChannels(destBundle);
 
   // look for existing connect that has a matching destination
   for (int i = 0; i < numChannels; i++) {
@@ -100,15 +96,7 @@ getAvailableDestChannel(SmallVector<std::pair<Connect, int>, 8> &connects,
 std::optional<int> getAvailableDestChannelReverseOrder(
     SmallVector<std::pair<Connect, int>, 8> &connects, WireBundle destBundle) {
 
-  int numChannels;
-
-  if (destBundle == WireBundle::North)
-    numChannels = 6;
-  else if (destBundle == WireBundle::South || destBundle == WireBundle::East ||
-           destBundle == WireBundle::West)
-    numChannels = 4;
-  else
-    numChannels = 2;
+  int numChannels = getLogicalNumDestChannels(destBundle);
 
   if (connects.empty()) {
     assert(numChannels > 0 && "numChannels <= 0");
@@ -154,105 +142,32 @@ void updateCoordinates(int &xCur, int &yCur, WireBundle move) {
   }
 }
 
+// The logical model of the switchboxes, ordered by tile so that the ops
+// created from it do not depend on hashing.
+using SwitchboxConnects =
+    std::map<TileID, SmallVector<std::pair<Connect, int>, 8>>;
+
 // Build a packet-switched route from the sourse to the destination with the
 // given ID. The route is recorded in the given map of switchboxes.
-void buildPSRoute(
-    int xSrc, int ySrc, Port sourcePort, int xDest, int yDest, Port destPort,
-    int flowID,
-    DenseMap<TileID, SmallVector<std::pair<Connect, int>, 8>> &switchboxes,
-    bool reverseOrder = false) {
-  int xCur = xSrc;
-  int yCur = ySrc;
-  WireBundle curBundle = {};
-  int curChannel = 0;
-  WireBundle lastBundle = {};
-  Port lastPort = sourcePort;
-
-  SmallVector<TileID, 4> congestion;
-
+LogicalResult buildPSRoute(int xSrc, int ySrc, Port sourcePort, int xDest,
+                           int yDest, Port destPort, int flowID,
+                           SwitchboxConnects &switchboxes,
+                           bool reverseOrder = false) {
   LLVM_DEBUG(llvm::dbgs() << "Build route ID " << flowID << ": " << xSrc << " "
                           << ySrc << " --> " << xDest << " " << yDest << '\n');
-  // traverse horizontally, then vertically
-  while (!(xCur == xDest && yCur == yDest)) {
-    LLVM_DEBUG(llvm::dbgs() << "Tile " << xCur << " " << yCur << " ");
-
-    TileID curCoord = {xCur, yCur};
-    SmallVector<WireBundle, 4> moves;
-
-    if (xCur < xDest)
-      moves.push_back(WireBundle::East);
-    if (xCur > xDest)
-      moves.push_back(WireBundle::West);
-    if (yCur < yDest)
-      moves.push_back(WireBundle::North);
-    if (yCur > yDest)
-      moves.push_back(WireBundle::South);
-
-    if (std::find(moves.begin(), moves.end(), WireBundle::East) == moves.end())
-      moves.push_back(WireBundle::East);
-    if (std::find(moves.begin(), moves.end(), WireBundle::West) == moves.end())
-      moves.push_back(WireBundle::West);
-    if (std::find(moves.begin(), moves.end(), WireBundle::North) == moves.end())
-      moves.push_back(WireBundle::North);
-    if (std::find(moves.begin(), moves.end(), WireBundle::South) == moves.end())
-      moves.push_back(WireBundle::South);
-
-    for (auto move : moves) {
-      if (reverseOrder) {
-        if (auto maybeDestChannel = getAvailableDestChannelReverseOrder(
-                switchboxes[curCoord], move))
-          curChannel = maybeDestChannel.value();
-        else
-          continue;
-      } else if (auto maybeDestChannel =
-                     getAvailableDestChannel(switchboxes[curCoord], move))
-        curChannel = maybeDestChannel.value();
-      else
-        continue;
-
-      if (move == lastBundle)
-        continue;
-
-      updateCoordinates(xCur, yCur, move);
-
-      if (std::find(congestion.begin(), congestion.end(), TileID{xCur, yCur}) !=
-          congestion.end())
-        continue;
-
-      curBundle = move;
-      lastBundle = move == WireBundle::East    ? WireBundle::West
-                   : move == WireBundle::West  ? WireBundle::East
-                   : move == WireBundle::North ? WireBundle::South
-                   : move == WireBundle::South ? WireBundle::North
-                                               : lastBundle;
-      break;
-    }
-
-    assert(curChannel >= 0 && "Could not find available destination port!");
-
-    LLVM_DEBUG(llvm::dbgs()
-               << stringifyWireBundle(lastPort.bundle) << " "
-               << lastPort.channel << " -> " << stringifyWireBundle(curBundle)
-               << " " << curChannel << "\n");
-
-    Port curPort = {curBundle, curChannel};
-    // If there is no connection with this ID going where we want to go.
-    if (Connect connect = {lastPort, curPort};
-        std::find(switchboxes[curCoord].begin(), switchboxes[curCoord].end(),
-                  std::pair{connect, flowID}) == switchboxes[curCoord].end())
-      // then add one.
-      switchboxes[curCoord].push_back({connect, flowID});
-    lastPort = {lastBundle, curChannel};
-  }
-
-  LLVM_DEBUG(llvm::dbgs() << "Tile " << xCur << " " << yCur << " ");
-  LLVM_DEBUG(llvm::dbgs() << stringifyWireBundle(lastPort.bundle) << " "
-                          << lastPort.channel << " -> "
-                          << stringifyWireBundle(curBundle) << " " << curChannel
-                          << "\n");
-
-  switchboxes[{xCur, yCur}].push_back(
-      std::make_pair(Connect{lastPort, destPort}, flowID));
+  return buildDimensionOrderedRoute(
+      {xSrc, ySrc}, sourcePort, {xDest, yDest}, destPort,
+      [&](TileID tile, Port, WireBundle bundle) {
+        return reverseOrder ? getAvailableDestChannelReverseOrder(
+                                  switchboxes[tile], bundle)
+                            : getAvailableDestChannel(switchboxes[tile], bundle);
+      },
+      [&](TileID tile, Connect connect) {
+        // If there is no connection with this ID going where we want to go,
+        // then add one.
+        if (!llvm::is_contained(switchboxes[tile], std::pair{connect, flowID}))
+          switchboxes[tile].push_back({connect, flowID});
+      });
 }
 
 SwitchboxOp getOrCreateSwitchbox(OpBuilder &builder, TileOp tile) {
@@ -266,7 +181,7 @@ SwitchboxOp getOrCreateSwitchbox(OpBuilder &builder, TileOp tile) {
 struct AIERoutePacketFlowsPass
     : AIERoutePacketFlowsBase<AIERoutePacketFlowsPass> {
   // Map from tile coordinates to TileOp
-  DenseMap<TileID, Operation *> tiles;
+  std::map<TileID, Operation *> tiles;
   Operation *getOrCreateTile(OpBuilder &builder, int col, int row) {
     TileID index = {col, row};
     Operation *tileOp = tiles[index];
@@ -301,8 +216,12 @@ struct AIERoutePacketFlowsPass
     // to the dest swboxes, and only use packet-switch to route at the dest
     // swboxes
 
-    // Map from a port and flowID to
-    DenseMap<std::pair<PhysPort, int>, SmallVector<PhysPort, 4>> packetFlows;
+    // Map from a port and flowID to the ports it is routed to. The maps which
+    // are iterated over to assign arbiters and create ops keep their
+    // insertion order, so that the output is the same from run to run rather
+    // than following the addresses of the tile ops.
+    llvm::MapVector<std::pair<PhysPort, int>, SmallVector<PhysPort, 4>>
+        packetFlows;
     SmallVector<std::pair<PhysPort, int>, 4> slavePorts;
     DenseMap<std::pair<PhysPort, int>, int> slaveAMSels;
     // Map from a port to
@@ -314,8 +233,18 @@ struct AIERoutePacketFlowsPass
       tiles[{col, row}] = tileOp;
     }
 
+    // With use-pathfinder, route the circuit-switched flows on the switchbox
+    // graph first, so that the packet flows leave room for them.
+    std::shared_ptr<PacketPathfinder> packetRouter;
+    if (clUsePathfinder) {
+      packetRouter = std::make_shared<PacketPathfinder>();
+      DynamicTileAnalysis analyzer(packetRouter);
+      if (failed(analyzer.runAnalysis(device)))
+        return signalPassFailure();
+    }
+
     // The logical model of all the switchboxes.
-    DenseMap<TileID, SmallVector<std::pair<Connect, int>, 8>> switchboxes;
+    SwitchboxConnects switchboxes;
     for (auto pktflow : device.getOps<PacketFlowOp>()) {
       Region &r = pktflow.getPorts();
       Block &b = r.front();
@@ -335,8 +264,15 @@ struct AIERoutePacketFlowsPass
           int yDest = destTile.rowIndex();
           Port destPort = pktDest.port();
 
-          buildPSRoute(xSrc, ySrc, sourcePort, xDest, yDest, destPort, flowID,
-                       switchboxes, true);
+          if (packetRouter)
+            packetRouter->addPacketFlow(flowID, {xSrc, ySrc}, sourcePort,
+                                        {xDest, yDest}, destPort);
+          else if (failed(buildPSRoute(xSrc, ySrc, sourcePort, xDest, yDest,
+                                       destPort, flowID, switchboxes, true))) {
+            pktflow.emitOpError("could not find a route to tile (")
+                << xDest << ", " << yDest << ")";
+            return signalPassFailure();
+          }
 
           // Assign "keep_pkt_header flag"
           if (pktflow->hasAttr("keep_pkt_header"))
@@ -346,6 +282,16 @@ struct AIERoutePacketFlowsPass
       }
     }
 
+    if (packetRouter) {
+      auto maybeRouting = packetRouter->findPacketPaths();
+      if (!maybeRouting) {
+        device.emitError("Unable to find a legal routing for packet flows");
+        return signalPassFailure();
+      }
+      for (const auto &[tileId, connects] : *maybeRouting)
+        switchboxes[tileId].append(connects.begin(), connects.end());
+    }
+
     LLVM_DEBUG(llvm::dbgs() << "Check switchboxes\n");
 
     for (const auto &[tileId, connects] : switchboxes) {
@@ -385,7 +331,8 @@ struct AIERoutePacketFlowsPass
 
     // A map from Tile and master selectValue to the ports targetted by that
     // master select.
-    DenseMap<std::pair<Operation *, int>, SmallVector<Port, 4>> masterAMSels;
+    llvm::MapVector<std::pair<Operation *, int>, SmallVector<Port, 4>>
+        masterAMSels;
 
     // Count of currently used logical arbiters for each tile.
     DenseMap<Operation *, int> amselValues;
@@ -457,6 +404,10 @@ struct AIERoutePacketFlowsPass
           if (foundAMSelValue)
             break;
         }
+        if (!foundAMSelValue) {
+          tileOp->emitOpError("ran out of arbiters for packet flows");
+          return signalPassFailure();
+        }
 
         for (auto dest : packetFlow.second) {
           Port port = dest.second;
@@ -470,7 +421,7 @@ struct AIERoutePacketFlowsPass
 
     // Compute the master set IDs
     // A map from a switchbox output port to the number of that port.
-    DenseMap<PhysPort, SmallVector<int, 4>> mastersets;
+    llvm::MapVector<PhysPort, SmallVector<int, 4>> mastersets;
     for (const auto &[physPort, ports] : masterAMSels) {
       Operation *tileOp = physPort.first;
       assert(tileOp);
@@ -18,6 +18,7 @@
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FormatVariadic.h"
 
 using namespace mlir;
 using namespace xilinx;
@@ -196,6 +197,26 @@ void AIEPathfinderPass::runOnOperation() {
   LLVM_DEBUG(llvm::dbgs() << "---Begin AIEPathfinderPass---\n");
 
   DeviceOp d = getOperation();
+  if (!customRouter) {
+    if (clBandwidthAware && clLinkBandwidth <= 0) {
+      d.emitError("link-bandwidth must be positive");
+      return signalPassFailure();
+    }
+    PathfinderOptions options;
+    options.incremental = clIncremental;
+    options.parallel = clParallel;
+    options.context = &getContext();
+    options.bandwidthAware = clBandwidthAware;
+    options.linkBandwidth = clLinkBandwidth;
+    analyzer.pathfinder = std::make_shared<Pathfinder>(options);
+    analyzer.cacheDir = clCacheDir;
+    analyzer.routerDescription =
+        llvm::formatv("pathfinder incremental={0} parallel={1} "
+                      "bandwidth-aware={2} link-bandwidth={3}",
+                      clIncremental, clParallel, clBandwidthAware,
+                      clLinkBandwidth)
+            .str();
+  }
   if (failed(analyzer.runAnalysis(d)))
     return signalPassFailure();
   OpBuilder builder = OpBuilder::atBlockEnd(d.getBody());
@@ -0,0 +1,362 @@
+//===- AIEEstimateCoreCycles.cpp --------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass estimates the number of cycles taken by the program of each core.
+//
+// The operations of a block are issued in VLIW bundles: each bundle holds at
+// most one vector operation, two loads, one store and one scalar operation,
+// so a block takes as many cycles as its busiest slot needs, as it would
+// once software pipelined. Lock operations, loops and calls are not
+// overlapped with the rest of the block and add their cycles to it. Cores
+// connected by objectFifos form pipelines, which run at the speed of the
+// core taking the most cycles.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Support/FileUtilities.h"
+
+#include "llvm/ADT/EquivalenceClasses.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/ToolOutputFile.h"
+
+#include <cmath>
+
+#define DEBUG_TYPE "aie-estimate-core-cycles"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Return the number of iterations of a loop with constant bounds, or
+// nothing for other loops.
+static std::optional<int64_t> getTripCount(Operation *op) {
+  if (auto forOp = dyn_cast<scf::ForOp>(op)) {
+    auto lb = getConstantIntValue(forOp.getLowerBound());
+    auto ub = getConstantIntValue(forOp.getUpperBound());
+    auto step = getConstantIntValue(forOp.getStep());
+    if (!lb || !ub || !step || *step <= 0)
+      return {};
+    return std::max<int64_t>(0, (*ub - *lb + *step - 1) / *step);
+  }
+  if (auto forOp = dyn_cast<affine::AffineForOp>(op)) {
+    if (!forOp.hasConstantBounds())
+      return {};
+    int64_t step = forOp.getStepAsInt();
+    return std::max<int64_t>(0, (forOp.getConstantUpperBound() -
+                                 forOp.getConstantLowerBound() + step - 1) /
+                                    step);
+  }
+  return {};
+}
+
+namespace {
+// The issue slots used by the operations of a block.
+struct Bundle {
+  double vector = 0;
+  double load = 0;
+  double store = 0;
+  double scalar = 0;
+  // Cycles which aren't overlapped with the other operations.
+  double serial = 0;
+
+  double cycles() const {
+    return std::max({vector, std::ceil(load / 2), store, scalar}) + serial;
+  }
+
+  // The slot limiting the block, for the report.
+  StringRef bound() const {
+    double issue = std::max({vector, std::ceil(load / 2), store, scalar});
+    if (serial >= issue)
+      return "serial";
+    if (vector == issue)
+      return "vector";
+    if (std::ceil(load / 2) == issue)
+      return "load";
+    if (store == issue)
+      return "store";
+    return "scalar";
+  }
+};
+
+struct LoopEstimate {
+  Operation *loop;
+  std::optional<int64_t> tripCount;
+  Bundle body;
+};
+
+struct Estimator {
+  unsigned lockCycles;
+  unsigned unknownTripCount;
+  // The innermost loops met, for the report.
+  SmallVector<LoopEstimate> loops;
+  // Calls to functions without a body or aie.cycles attribute, counted as
+  // one cycle.
+  SmallVector<StringRef> unknownCalls;
+  SmallVector<Operation *> callStack;
+
+  double estimateRegion(Region &region) {
+    double cycles = 0;
+    for (Block &block : region)
+      cycles += estimateBlock(block).cycles();
+    return cycles;
+  }
+
+  Bundle estimateBlock(Block &block) {
+    Bundle bundle;
+    for (Operation &op : block)
+      estimateOp(&op, bundle);
+    return bundle;
+  }
+
+  void estimateOp(Operation *op, Bundle &bundle) {
+    if (auto cycles = op->getAttrOfType<IntegerAttr>("aie.cycles")) {
+      bundle.serial += cycles.getInt();
+      return;
+    }
+    if (isa<UseLockOp, ObjectFifoAcquireOp, ObjectFifoReleaseOp>(op)) {
+      bundle.serial += lockCycles;
+      return;
+    }
+    if (op->hasTrait<OpTrait::ConstantLike>() ||
+        op->hasTrait<OpTrait::IsTerminator>() ||
+        isa<ObjectFifoSubviewAccessOp, memref::SubViewOp, memref::CastOp,
+            memref::ReinterpretCastOp>(op))
+      return;
+
+    if (isa<scf::ForOp, affine::AffineForOp>(op)) {
+      Bundle body = estimateBlock(op->getRegion(0).front());
+      auto tripCount = getTripCount(op);
+      bool innermost = true;
+      op->getRegion(0).walk([&](Operation *nested) {
+        if (nested != op && isa<scf::ForOp, affine::AffineForOp>(nested))
+          innermost = false;
+      });
+      if (innermost)
+        loops.push_back({op, tripCount, body});
+      bundle.serial += tripCount.value_or(unknownTripCount) *
+                       std::max(1.0, body.cycles());
+      return;
+    }
+    if (op->getNumRegions()) {
+      // Branches and other region operations take the cycles of their
+      // longest region.
+      double longest = 0;
+      for (Region &region : op->getRegions())
+        longest = std::max(longest, estimateRegion(region));
+      bundle.serial += longest;
+      return;
+    }
+    if (auto call = dyn_cast<func::CallOp>(op)) {
+      auto callee = SymbolTable::lookupNearestSymbolFrom<func::FuncOp>(
+          call, call.getCalleeAttr());
+      if (callee)
+        if (auto cycles = callee->getAttrOfType<IntegerAttr>("aie.cycles")) {
+          bundle.serial += cycles.getInt();
+          return;
+        }
+      if (!callee || callee.isExternal() ||
+          llvm::is_contained(callStack, callee)) {
+        unknownCalls.push_back(call.getCallee());
+        bundle.serial += 1;
+        return;
+      }
+      callStack.push_back(callee);
+      bundle.serial += estimateRegion(callee.getBody());
+      callStack.pop_back();
+      return;
+    }
+
+    StringRef dialect = op->getDialect()->getNamespace();
+    StringRef name = op->getName().getStringRef();
+    if (isa<memref::LoadOp, affine::AffineLoadOp>(op) ||
+        name == "vector.load" || name == "vector.transfer_read" ||
+        name == "aievec.upd") {
+      bundle.load++;
+      return;
+    }
+    if (isa<memref::StoreOp, affine::AffineStoreOp>(op) ||
+        name == "vector.store" || name == "vector.transfer_write") {
+      bundle.store++;
+      return;
+    }
+    // Casts between vector types only rename registers.
+    if (name == "aievec.cast")
+      return;
+    bool vector = dialect.starts_with("aievec") || dialect == "vector" ||
+                  llvm::any_of(op->getResultTypes(),
+                               [](Type t) { return isa<VectorType>(t); });
+    if (vector)
+      bundle.vector++;
+    else
+      bundle.scalar++;
+  }
+};
+
+struct CoreEstimate {
+  CoreOp core;
+  double cycles;
+  SmallVector<LoopEstimate> loops;
+  SmallVector<StringRef> unknownCalls;
+};
+} // namespace
+
+static std::string describeLoc(Location loc) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  loc.print(os);
+  return os.str();
+}
+
+struct AIEEstimateCoreCyclesPass
+    : AIEEstimateCoreCyclesBase<AIEEstimateCoreCyclesPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    std::vector<CoreEstimate> estimates;
+    DenseMap<Operation *, size_t> coreOfTile;
+    for (auto core : device.getOps<CoreOp>()) {
+      Estimator estimator{clLockCycles, clUnknownTripCount};
+      double cycles = estimator.estimateRegion(core.getBody());
+      coreOfTile[core.getTileOp()] = estimates.size();
+      estimates.push_back({core, cycles, std::move(estimator.loops),
+                           std::move(estimator.unknownCalls)});
+    }
+
+    // Cores exchanging elements through objectFifos, directly or through
+    // a link, belong to the same pipeline.
+    llvm::EquivalenceClasses<size_t> pipelines;
+    for (size_t i = 0; i < estimates.size(); i++)
+      pipelines.insert(i);
+    llvm::MapVector<Operation *, SmallVector<Operation *>> fifoTiles;
+    for (auto fifo : device.getOps<ObjectFifoCreateOp>()) {
+      auto &tiles = fifoTiles[fifo];
+      tiles.push_back(fifo.getProducerTile().getDefiningOp());
+      for (Value consumer : fifo.getConsumerTiles())
+        tiles.push_back(consumer.getDefiningOp());
+    }
+    for (auto link : device.getOps<ObjectFifoLinkOp>()) {
+      SmallVector<Operation *> tiles;
+      for (auto in : link.getInputObjectFifos())
+        llvm::append_range(tiles, fifoTiles[in]);
+      for (auto out : link.getOutputObjectFifos())
+        llvm::append_range(tiles, fifoTiles[out]);
+      for (auto out : link.getOutputObjectFifos())
+        fifoTiles[out] = tiles;
+    }
+    for (auto &[fifo, tiles] : fifoTiles) {
+      std::optional<size_t> first;
+      for (Operation *tile : tiles) {
+        auto it = coreOfTile.find(tile);
+        if (it == coreOfTile.end())
+          continue;
+        if (first)
+          pipelines.unionSets(*first, it->second);
+        else
+          first = it->second;
+      }
+    }
+
+    for (auto &estimate : estimates) {
+      auto diag = estimate.core.emitRemark("estimated ")
+                  << int64_t(std::ceil(estimate.cycles)) << " cycles";
+      for (auto &loop : estimate.loops)
+        diag.attachNote(loop.loop->getLoc())
+            << "innermost loop: " << int64_t(std::ceil(loop.body.cycles()))
+            << " cycles per iteration, bound by " << loop.body.bound();
+      for (StringRef callee : estimate.unknownCalls)
+        diag.attachNote() << "call to @" << callee
+                          << " counted as 1 cycle; set aie.cycles on it";
+    }
+
+    SmallVector<size_t> bottlenecks;
+    for (auto it = pipelines.begin(); it != pipelines.end(); ++it) {
+      if (!it->isLeader())
+        continue;
+      SmallVector<size_t> members(pipelines.member_begin(it),
+                                  pipelines.member_end());
+      if (members.size() < 2)
+        continue;
+      size_t slowest = *llvm::max_element(members, [&](size_t a, size_t b) {
+        return estimates[a].cycles < estimates[b].cycles;
+      });
+      bottlenecks.push_back(slowest);
+      estimates[slowest].core.emitRemark("bottleneck of a pipeline of ")
+          << members.size() << " cores";
+    }
+
+    if (clJsonFile.empty())
+      return;
+    std::string error;
+    auto output = openOutputFile(clJsonFile, &error);
+    if (!output) {
+      device.emitError(error);
+      return signalPassFailure();
+    }
+    llvm::json::OStream json(output->os(), 2);
+    json.object([&] {
+      json.attributeArray("cores", [&] {
+        for (auto &estimate : estimates) {
+          TileOp tile = estimate.core.getTileOp();
+          json.object([&] {
+            json.attribute("col", tile.colIndex());
+            json.attribute("row", tile.rowIndex());
+            json.attribute("cycles", std::ceil(estimate.cycles));
+            json.attribute("pipeline",
+                           int64_t(*pipelines.findLeader(
+                               &estimate - estimates.data())));
+            json.attributeArray("loops", [&] {
+              for (auto &loop : estimate.loops)
+                json.object([&] {
+                  json.attribute("loc", describeLoc(loop.loop->getLoc()));
+                  if (loop.tripCount)
+                    json.attribute("trip_count", *loop.tripCount);
+                  json.attribute("cycles_per_iteration",
+                                 std::ceil(loop.body.cycles()));
+                  json.attribute("bound", loop.body.bound());
+                  json.attribute("vector", loop.body.vector);
+                  json.attribute("load", loop.body.load);
+                  json.attribute("store", loop.body.store);
+                  json.attribute("scalar", loop.body.scalar);
+                });
+            });
+            json.attributeArray("unknown_calls", [&] {
+              for (StringRef callee : estimate.unknownCalls)
+                json.value(callee);
+            });
+          });
+        }
+      });
+      json.attributeArray("bottlenecks", [&] {
+        for (size_t index : bottlenecks) {
+          TileOp tile = estimates[index].core.getTileOp();
+          json.object([&] {
+            json.attribute("col", tile.colIndex());
+            json.attribute("row", tile.rowIndex());
+            json.attribute("cycles", std::ceil(estimates[index].cycles));
+          });
+        }
+      });
+    });
+    output->os() << "\n";
+    output->keep();
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIEEstimateCoreCyclesPass() {
+  return std::make_unique<AIEEstimateCoreCyclesPass>();
+}
@@ -0,0 +1,75 @@
+//===- AIELiveRanges.cpp ----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/Transforms/AIELiveRanges.h"
+
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+CoreLiveRanges::CoreLiveRanges(CoreOp core) : core(core) {
+  core.walk([&](Operation *op) {
+    for (Region &region : op->getRegions())
+      if (!region.empty() && !region.hasOneBlock())
+        structured = false;
+  });
+  if (!structured)
+    return;
+
+  // Record the position of the last operation nested in each one.
+  int position = 0;
+  core.walk<WalkOrder::PreOrder>(
+      [&](Operation *op) { first[op] = position++; });
+  core.walk<WalkOrder::PostOrder>([&](Operation *op) {
+    last[op] = first[op];
+    for (Region &region : op->getRegions())
+      for (Operation &nested : region.getOps())
+        last[op] = std::max(last[op], last[&nested]);
+  });
+}
+
+bool CoreLiveRanges::collectAccesses(Value memref,
+                                     SmallVectorImpl<Operation *> &accesses) {
+  for (Operation *user : memref.getUsers()) {
+    if (!core->isProperAncestor(user) ||
+        user->hasTrait<OpTrait::IsTerminator>() ||
+        isa<LoopLikeOpInterface>(user))
+      return false;
+    if (isa<memref::DeallocOp>(user)) {
+      if (!isa_and_nonnull<memref::AllocOp>(memref.getDefiningOp()))
+        return false;
+      continue;
+    }
+    accesses.push_back(user);
+    for (Value result : user->getResults())
+      if (isa<MemRefType>(result.getType()) &&
+          !collectAccesses(result, accesses))
+        return false;
+  }
+  return true;
+}
+
+std::pair<int, int>
+CoreLiveRanges::getLiveRange(ArrayRef<Operation *> accesses) {
+  int start = std::numeric_limits<int>::max(), end = 0;
+  for (Operation *access : accesses) {
+    Operation *scope = access;
+    for (Operation *parent = access->getParentOp(); parent != core;
+         parent = parent->getParentOp())
+      if (isa<LoopLikeOpInterface>(parent))
+        scope = parent;
+    start = std::min(start, first[scope]);
+    end = std::max(end, last[scope]);
+  }
+  return {start, end};
+}
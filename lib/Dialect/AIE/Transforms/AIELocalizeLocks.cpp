@@ -9,6 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
 
@@ -29,6 +30,10 @@ struct AIELocalizeLocksPass : AIELocalizeLocksBase<AIELocalizeLocksPass> {
 
     DeviceOp deviceOp = getOperation();
 
+    // The neighbors of a core are looked up by their coordinates, without
+    // going through all the tiles of the device.
+    const auto &index = getAnalysis<DeviceIndex>();
+
     for (auto coreOp : deviceOp.getOps<CoreOp>()) {
       // Collect the locks used in this core.
       const auto &targetModel = getTargetModel(coreOp);
@@ -37,12 +42,17 @@ struct AIELocalizeLocksPass : AIELocalizeLocksBase<AIELocalizeLocksPass> {
       int col = thisTile.colIndex();
       int row = thisTile.rowIndex();
 
-      // Find the neighboring tiles
+      // Find the neighboring tiles, in the order of the device.
       SmallVector<TileOp, 4> accessibleTiles;
-      for (auto tile : deviceOp.getOps<TileOp>())
-        if (int dstRow = tile.rowIndex();
-            targetModel.isLegalMemAffinity(col, row, tile.colIndex(), dstRow))
-          accessibleTiles.push_back(tile);
+      for (int dstCol = col - 1; dstCol <= col + 1; dstCol++)
+        for (int dstRow = row - 1; dstRow <= row + 1; dstRow++) {
+          if (TileOp tile = index.getTile(dstCol, dstRow);
+              tile && targetModel.isLegalMemAffinity(col, row, dstCol, dstRow))
+            accessibleTiles.push_back(tile);
+        }
+      llvm::sort(accessibleTiles, [](TileOp a, TileOp b) {
+        return a->isBeforeInBlock(b);
+      });
 
       for (auto tile : accessibleTiles) {
         int dstCol = tile.colIndex();
@@ -78,6 +88,8 @@ struct AIELocalizeLocksPass : AIELocalizeLocksBase<AIELocalizeLocksPass> {
           }
       }
     }
+    // Only the bodies of the cores are changed.
+    markAnalysesPreserved<DeviceIndex>();
   }
 };
 
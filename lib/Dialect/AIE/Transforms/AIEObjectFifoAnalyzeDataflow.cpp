@@ -0,0 +1,725 @@
+//===- AIEObjectFifoAnalyzeDataflow.cpp -------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass models the objectFifos of a device as a synchronous dataflow
+// graph to find deadlocks and the throughput of the design before it runs.
+//
+// The actors of the graph are the cores and the DMAs moving the elements of
+// the objectFifos, and its channels hold the elements of an objectFifo
+// between two of them, up to the depth of the endpoint receiving them. A
+// core runs its program as a sequence of acquires, releases and
+// computations, and a DMA moves one element at a time. The rates of a core
+// are the elements it releases in an iteration of its core loop, the first
+// loop of its body accessing objectFifos; the balance equations of the
+// channels give how many iterations each actor runs in an iteration of the
+// graph, which they must have for the design to neither deadlock nor
+// accumulate elements.
+//
+// The actors are then simulated for a few graph iterations, with the time at
+// which each element or free slot becomes available: the actors waiting for
+// one which never comes are deadlocked, and the steady-state period of a
+// graph iteration is the iteration bound of the design. It is limited by the
+// objectFifo whose deeper buffers shorten the period the most, or else by
+// the busiest core.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/SetVector.h"
+
+#include <cmath>
+#include <deque>
+#include <numeric>
+
+#define DEBUG_TYPE "aie-objectFifo-analyze-dataflow"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Return the size in bytes of the elements of an objectFifo.
+static int64_t getElementSize(ObjectFifoCreateOp fifo) {
+  MemRefType type =
+      fifo.getElemType().cast<AIEObjectFifoType>().getElementType();
+  return type.getNumElements() * type.getElementTypeBitWidth() / 8;
+}
+
+// Return whether an objectFifo is lowered to shared memory rather than DMAs.
+// This mirrors requiresDMAs() in aie-objectFifo-stateful-transform.
+static bool usesSharedMemory(ObjectFifoCreateOp fifo) {
+  if (fifo.getConsumerTiles().size() != 1 ||
+      !fifo.getDimensionsToStream().empty() || fifo.getCompression())
+    return false;
+  for (BDDimLayoutArrayAttr dims : fifo.getDimensionsFromStreamPerConsumer())
+    if (!dims.empty())
+      return false;
+
+  TileOp producer = fifo.getProducerTileOp();
+  auto consumer = fifo.getConsumerTiles()[0].getDefiningOp<TileOp>();
+  if (producer.isShimTile() || consumer.isShimTile() ||
+      producer.isMemTile() != consumer.isMemTile())
+    return false;
+  const auto &targetModel = getTargetModel(fifo);
+  if (targetModel.isLegalMemAffinity(consumer.colIndex(), consumer.rowIndex(),
+                                     producer.colIndex(), producer.rowIndex()))
+    return true;
+  return targetModel.isLegalMemAffinity(
+      producer.colIndex(), producer.rowIndex(), consumer.colIndex(),
+      consumer.rowIndex());
+}
+
+namespace {
+// A channel holding the elements of an objectFifo between two actors. The
+// elements released by the producer wait in `ready` for the consumer, and the
+// slots released by the consumer in `free` for the producer, each with the
+// time it becomes available.
+struct Channel {
+  ObjectFifoCreateOp fifo;
+  int capacity;
+  // The cycles between the release of an element by the producer and its
+  // arrival to the consumer.
+  double latency;
+  int producer;
+  int consumer;
+  std::deque<double> ready;
+  std::deque<double> free;
+};
+
+// The channels an actor acquires and releases elements of together, like
+// those to all the consumers of a broadcast objectFifo.
+struct Port {
+  ObjectFifoCreateOp fifo;
+  bool produce;
+  SmallVector<int> channels;
+  // The number of elements currently acquired.
+  int held = 0;
+};
+
+struct Instr {
+  enum Kind { Compute, Acquire, Release, LoopBegin, LoopEnd } kind;
+  double cycles = 0;
+  int port = 0;
+  int count = 0;
+  // The iterations of a loop, or -1 if its bounds aren't constant.
+  int64_t tripCount = 0;
+  // The index of the matching LoopEnd or LoopBegin.
+  size_t match = 0;
+  Operation *op = nullptr;
+};
+
+// A core or a DMA, with its program and the state of its simulation.
+struct Actor {
+  std::string name;
+  // The core, or nothing for a DMA.
+  CoreOp core;
+  SmallVector<Port> ports;
+  std::vector<Instr> program;
+  // The LoopBegin of the core loop, or nothing if the whole program is a
+  // single iteration.
+  std::optional<size_t> coreLoop;
+  // The iterations of the actor in an iteration of the graph, and in the
+  // simulation: those of the graph iterations analyzed plus one, for the
+  // elements held from an iteration to the next.
+  int64_t repetitions = 0;
+  int64_t target = 0;
+  int component = -1;
+
+  size_t pc = 0;
+  SmallVector<int64_t> counters;
+  double time = 0;
+  double busy = 0;
+  // The time and the busy cycles at the end of each iteration.
+  SmallVector<std::pair<double, double>> iterations;
+
+  bool finished() const { return pc == program.size(); }
+  bool done() const {
+    return finished() || int64_t(iterations.size()) >= target;
+  }
+  // Whether the simulation runs the whole program of the actor.
+  bool runsToEnd() const {
+    return !coreLoop || program[*coreLoop].tripCount <= target;
+  }
+};
+
+struct Graph {
+  std::vector<Actor> actors;
+  std::vector<Channel> channels;
+};
+} // namespace
+
+static int getPort(Actor &actor, ObjectFifoCreateOp fifo, bool produce) {
+  for (auto [index, port] : llvm::enumerate(actor.ports))
+    if (port.fifo == fifo && port.produce == produce)
+      return index;
+  actor.ports.push_back({fifo, produce, {}});
+  return actor.ports.size() - 1;
+}
+
+static void addChannel(Graph &graph, ObjectFifoCreateOp fifo, int capacity,
+                       double latency, int producer, int consumer) {
+  int index = graph.channels.size();
+  graph.channels.push_back({fifo, capacity, latency, producer, consumer});
+  Actor &from = graph.actors[producer];
+  from.ports[getPort(from, fifo, true)].channels.push_back(index);
+  Actor &to = graph.actors[consumer];
+  to.ports[getPort(to, fifo, false)].channels.push_back(index);
+}
+
+static void addCompute(Actor &actor, double cycles) {
+  if (!actor.program.empty() &&
+      actor.program.back().kind == Instr::Compute) {
+    actor.program.back().cycles += cycles;
+    return;
+  }
+  Instr instr{Instr::Compute};
+  instr.cycles = cycles;
+  actor.program.push_back(instr);
+}
+
+// Append the operations of a block to the program of a core: one cycle for
+// each operation, unless an `aie.cycles` integer attribute gives its cycles.
+// Of the operations with regions other than loops, like scf.if, only the
+// first region is taken.
+static void buildProgram(Actor &actor, Block &block) {
+  for (Operation &op : block) {
+    if (auto acquire = dyn_cast<ObjectFifoAcquireOp>(op)) {
+      if (ObjectFifoCreateOp fifo = acquire.getObjectFifo()) {
+        Instr instr{Instr::Acquire};
+        instr.port = getPort(actor, fifo,
+                             acquire.getPort() == ObjectFifoPort::Produce);
+        instr.count = acquire.acqNumber();
+        instr.op = acquire;
+        actor.program.push_back(instr);
+      }
+    } else if (auto release = dyn_cast<ObjectFifoReleaseOp>(op)) {
+      if (ObjectFifoCreateOp fifo = release.getObjectFifo()) {
+        Instr instr{Instr::Release};
+        instr.port = getPort(actor, fifo,
+                             release.getPort() == ObjectFifoPort::Produce);
+        instr.count = release.relNumber();
+        instr.op = release;
+        actor.program.push_back(instr);
+      }
+    } else if (auto cycles = op.getAttrOfType<IntegerAttr>("aie.cycles")) {
+      addCompute(actor, cycles.getInt());
+    } else if (auto forOp = dyn_cast<scf::ForOp>(op)) {
+      Instr begin{Instr::LoopBegin};
+      begin.tripCount = -1;
+      auto lb = getConstantIntValue(forOp.getLowerBound());
+      auto ub = getConstantIntValue(forOp.getUpperBound());
+      auto step = getConstantIntValue(forOp.getStep());
+      if (lb && ub && step && *step > 0)
+        begin.tripCount = std::max<int64_t>(0, (*ub - *lb + *step - 1) / *step);
+      size_t beginIndex = actor.program.size();
+      actor.program.push_back(begin);
+      buildProgram(actor, *forOp.getBody());
+      Instr end{Instr::LoopEnd};
+      end.match = beginIndex;
+      actor.program[beginIndex].match = actor.program.size();
+      actor.program.push_back(end);
+    } else if (op.getNumRegions() && !op.getRegion(0).empty()) {
+      addCompute(actor, 1);
+      buildProgram(actor, op.getRegion(0).front());
+    } else if (!op.hasTrait<OpTrait::ConstantLike>() &&
+               !op.hasTrait<OpTrait::IsTerminator>()) {
+      addCompute(actor, 1);
+    }
+  }
+}
+
+// Set the core loop of a core, the first loop of its body accessing
+// objectFifos, which runs until the simulation stops if its bounds aren't
+// constant. The other such loops run once.
+static void setCoreLoop(Actor &actor) {
+  for (size_t i = 0; i < actor.program.size(); i++) {
+    Instr &instr = actor.program[i];
+    if (instr.kind != Instr::LoopBegin)
+      continue;
+    auto body = ArrayRef<Instr>(actor.program).slice(i, instr.match - i);
+    bool accesses = llvm::any_of(body, [](const Instr &x) {
+      return x.kind == Instr::Acquire || x.kind == Instr::Release;
+    });
+    if (!accesses) {
+      i = instr.match;
+      continue;
+    }
+    actor.coreLoop = i;
+    break;
+  }
+  for (auto [i, instr] : llvm::enumerate(actor.program))
+    if (instr.kind == Instr::LoopBegin && instr.tripCount < 0)
+      instr.tripCount =
+          actor.coreLoop == i ? std::numeric_limits<int64_t>::max() : 1;
+}
+
+// Build the graph of the cores accessing objectFifos and of the DMAs of the
+// objectFifos which aren't in shared memory. The two sides of an
+// aie.objectfifo.link share the elements on the link tile: the DMA of each
+// output of a distribution reads from a channel of the input, and the DMA of
+// each input of a join writes to a channel of the output.
+static Graph buildGraph(DeviceOp device, unsigned dmaBytesPerCycle,
+                        unsigned dmaLatency) {
+  Graph graph;
+  DenseMap<Operation *, int> coreActors;
+  for (CoreOp core : device.getOps<CoreOp>()) {
+    bool accesses =
+        core.walk([](Operation *op) {
+              return isa<ObjectFifoAcquireOp, ObjectFifoReleaseOp>(op)
+                         ? WalkResult::interrupt()
+                         : WalkResult::advance();
+            })
+            .wasInterrupted();
+    if (!accesses)
+      continue;
+    coreActors[core.getTileOp()] = graph.actors.size();
+    Actor actor;
+    actor.name = "core (" + std::to_string(core.getTileID().col) + ", " +
+                 std::to_string(core.getTileID().row) + ")";
+    actor.core = core;
+    buildProgram(actor, core.getBody().front());
+    setCoreLoop(actor);
+    graph.actors.push_back(std::move(actor));
+  }
+  auto coreActor = [&](Value tile) -> std::optional<int> {
+    auto it = coreActors.find(tile.getDefiningOp());
+    if (it == coreActors.end())
+      return {};
+    return it->second;
+  };
+
+  DenseMap<Operation *, ObjectFifoLinkOp> inputLinks, outputLinks;
+  for (auto link : device.getOps<ObjectFifoLinkOp>()) {
+    for (auto in : link.getInputObjectFifos())
+      inputLinks[in] = link;
+    for (auto out : link.getOutputObjectFifos())
+      outputLinks[out] = link;
+  }
+
+  SmallVector<ObjectFifoCreateOp> dmaFifos;
+  DenseMap<Operation *, int> dmaActors;
+  for (auto fifo : device.getOps<ObjectFifoCreateOp>()) {
+    if (fifo.getStream())
+      continue;
+    auto producer = coreActor(fifo.getProducerTile());
+    auto consumer = coreActor(fifo.getConsumerTiles()[0]);
+    if (!inputLinks.count(fifo) && !outputLinks.count(fifo) && producer &&
+        consumer && usesSharedMemory(fifo)) {
+      addChannel(graph, fifo, fifo.size(), 0, *producer, *consumer);
+      continue;
+    }
+    dmaFifos.push_back(fifo);
+    dmaActors[fifo] = graph.actors.size();
+    Actor actor;
+    actor.name = "the DMA of objectFifo @" + fifo.name().str();
+    graph.actors.push_back(std::move(actor));
+  }
+
+  for (auto fifo : dmaFifos) {
+    int dma = dmaActors[fifo];
+    if (auto link = outputLinks.lookup(fifo)) {
+      if (link.isJoin()) {
+        for (auto in : link.getInputObjectFifos())
+          if (dmaActors.count(in))
+            addChannel(graph, fifo, fifo.size(0), dmaLatency, dmaActors[in],
+                       dma);
+      } else if (auto in = link.getInputObjectFifos()[0];
+                 dmaActors.count(in)) {
+        auto consumers = in.getConsumerTiles();
+        auto index = llvm::find(consumers, *link.getOptionalSharedTile()) -
+                     consumers.begin();
+        addChannel(graph, in, in.size(index + 1), dmaLatency, dmaActors[in],
+                   dma);
+      }
+    } else if (auto producer = coreActor(fifo.getProducerTile())) {
+      addChannel(graph, fifo, fifo.size(0), 0, *producer, dma);
+    }
+
+    auto link = inputLinks.lookup(fifo);
+    for (auto [index, tile] : llvm::enumerate(fifo.getConsumerTiles())) {
+      // The consumer of the input of a link is the DMA of its outputs.
+      if (link && tile == *link.getOptionalSharedTile())
+        continue;
+      if (auto consumer = coreActor(tile))
+        addChannel(graph, fifo, fifo.size(index + 1), dmaLatency, dma,
+                   *consumer);
+    }
+  }
+
+  // Each iteration of a DMA acquires an element on each of its inputs and
+  // outputs, transfers it and releases them. An output with a repeat_count
+  // sends the element of its input that many times.
+  for (auto fifo : dmaFifos) {
+    Actor &actor = graph.actors[dmaActors[fifo]];
+    int64_t repeatCount = fifo.getRepeatCount().value_or(1);
+    auto addLoop = [&](int64_t tripCount) {
+      Instr begin{Instr::LoopBegin};
+      begin.tripCount = tripCount;
+      actor.program.push_back(begin);
+      return actor.program.size() - 1;
+    };
+    auto endLoop = [&](size_t begin) {
+      Instr end{Instr::LoopEnd};
+      end.match = begin;
+      actor.program[begin].match = actor.program.size();
+      actor.program.push_back(end);
+    };
+    auto addAccesses = [&](Instr::Kind kind, bool produce) {
+      for (auto [index, port] : llvm::enumerate(actor.ports))
+        if (port.produce == produce) {
+          Instr instr{kind};
+          instr.port = index;
+          instr.count = 1;
+          actor.program.push_back(instr);
+        }
+    };
+    size_t coreLoop = addLoop(std::numeric_limits<int64_t>::max());
+    addAccesses(Instr::Acquire, false);
+    size_t repeatLoop = addLoop(repeatCount);
+    addAccesses(Instr::Acquire, true);
+    addCompute(actor, std::ceil(double(getElementSize(fifo)) /
+                                dmaBytesPerCycle));
+    addAccesses(Instr::Release, true);
+    endLoop(repeatLoop);
+    addAccesses(Instr::Release, false);
+    endLoop(coreLoop);
+    actor.coreLoop = coreLoop;
+  }
+  return graph;
+}
+
+// Return the elements released on each port of an actor in an iteration of
+// its core loop.
+static SmallVector<int64_t> getRates(const Actor &actor) {
+  SmallVector<int64_t> rates(actor.ports.size(), 0);
+  size_t begin = actor.coreLoop ? *actor.coreLoop + 1 : 0;
+  size_t end = actor.coreLoop ? actor.program[*actor.coreLoop].match
+                              : actor.program.size();
+  SmallVector<int64_t> multipliers = {1};
+  for (size_t i = begin; i < end; i++) {
+    const Instr &instr = actor.program[i];
+    if (instr.kind == Instr::LoopBegin)
+      multipliers.push_back(multipliers.back() * instr.tripCount);
+    else if (instr.kind == Instr::LoopEnd)
+      multipliers.pop_back();
+    else if (instr.kind == Instr::Release)
+      rates[instr.port] += instr.count * multipliers.back();
+  }
+  return rates;
+}
+
+static int getChannelPort(const Actor &actor, int channel) {
+  for (auto [index, port] : llvm::enumerate(actor.ports))
+    if (llvm::is_contained(port.channels, channel))
+      return index;
+  llvm_unreachable("channel not connected to the actor");
+}
+
+// Solve the balance equations of the graph: in a graph iteration, the
+// elements produced in each channel are all consumed. Set the repetitions of
+// the actors, the smallest integers satisfying them in each connected
+// component, or report the objectFifo whose rates contradict the others.
+static LogicalResult solveBalanceEquations(Graph &graph) {
+  SmallVector<SmallVector<int64_t>> rates;
+  SmallVector<SmallVector<int>> adjacent(graph.actors.size());
+  for (const Actor &actor : graph.actors)
+    rates.push_back(getRates(actor));
+  for (auto [index, channel] : llvm::enumerate(graph.channels)) {
+    adjacent[channel.producer].push_back(index);
+    adjacent[channel.consumer].push_back(index);
+  }
+
+  // The repetitions as fractions, numerator and denominator.
+  SmallVector<std::pair<int64_t, int64_t>> repetitions(graph.actors.size(),
+                                                       {0, 1});
+  int components = 0;
+  for (size_t start = 0; start < graph.actors.size(); start++) {
+    if (graph.actors[start].component >= 0)
+      continue;
+    int component = components++;
+    SmallVector<int> members = {int(start)};
+    graph.actors[start].component = component;
+    repetitions[start] = {1, 1};
+    for (size_t next = 0; next < members.size(); next++) {
+      for (int c : adjacent[members[next]]) {
+        Channel &channel = graph.channels[c];
+        Actor &producer = graph.actors[channel.producer];
+        Actor &consumer = graph.actors[channel.consumer];
+        int64_t produced =
+            rates[channel.producer][getChannelPort(producer, c)];
+        int64_t consumed =
+            rates[channel.consumer][getChannelPort(consumer, c)];
+        auto unbalanced = [&] {
+          channel.fifo.emitWarning()
+              << "the rates of objectFifo @" << channel.fifo.name()
+              << " don't balance with the rest of the graph: " << produced
+              << " element(s) released per iteration of " << producer.name
+              << ", " << consumed << " per iteration of " << consumer.name
+              << "; the design deadlocks or accumulates elements";
+          return failure();
+        };
+        if (produced == 0 && consumed == 0)
+          continue;
+        if (produced == 0 || consumed == 0)
+          return unbalanced();
+        // repetitions[producer] * produced == repetitions[consumer] * consumed
+        auto [pNum, pDen] = repetitions[channel.producer];
+        auto [cNum, cDen] = repetitions[channel.consumer];
+        if (producer.component < 0 || consumer.component < 0) {
+          int other = producer.component < 0 ? channel.producer
+                                             : channel.consumer;
+          int64_t num = other == channel.consumer ? pNum * produced
+                                                  : cNum * consumed;
+          int64_t den = other == channel.consumer ? pDen * consumed
+                                                  : cDen * produced;
+          int64_t gcd = std::gcd(num, den);
+          repetitions[other] = {num / gcd, den / gcd};
+          graph.actors[other].component = component;
+          members.push_back(other);
+        } else if (pNum * produced * cDen != cNum * consumed * pDen) {
+          return unbalanced();
+        }
+      }
+    }
+
+    int64_t lcm = 1;
+    for (int member : members)
+      lcm = std::lcm(lcm, repetitions[member].second);
+    int64_t gcd = 0;
+    for (int member : members)
+      gcd = std::gcd(gcd, repetitions[member].first * lcm /
+                              repetitions[member].second);
+    for (int member : members)
+      graph.actors[member].repetitions =
+          repetitions[member].first * lcm / repetitions[member].second / gcd;
+  }
+  return success();
+}
+
+// Execute the next instruction of an actor, unless it waits for elements or
+// free slots. Return whether it was executed.
+static bool step(Graph &graph, Actor &actor) {
+  Instr &instr = actor.program[actor.pc];
+  switch (instr.kind) {
+  case Instr::Compute:
+    actor.time += instr.cycles;
+    actor.busy += instr.cycles;
+    break;
+  case Instr::Acquire: {
+    Port &port = actor.ports[instr.port];
+    int needed = instr.count - port.held;
+    if (needed <= 0)
+      break;
+    auto queue = [&](int c) -> std::deque<double> & {
+      return port.produce ? graph.channels[c].free : graph.channels[c].ready;
+    };
+    for (int c : port.channels)
+      if (int(queue(c).size()) < needed)
+        return false;
+    for (int c : port.channels)
+      for (int i = 0; i < needed; i++) {
+        actor.time = std::max(actor.time, queue(c).front());
+        queue(c).pop_front();
+      }
+    port.held = instr.count;
+    break;
+  }
+  case Instr::Release: {
+    Port &port = actor.ports[instr.port];
+    int released = std::min(instr.count, port.held);
+    port.held -= released;
+    for (int c : port.channels) {
+      Channel &channel = graph.channels[c];
+      for (int i = 0; i < released; i++)
+        if (port.produce)
+          channel.ready.push_back(actor.time + channel.latency);
+        else
+          channel.free.push_back(actor.time);
+    }
+    break;
+  }
+  case Instr::LoopBegin:
+    if (instr.tripCount == 0) {
+      actor.pc = instr.match + 1;
+      return true;
+    }
+    actor.counters.push_back(instr.tripCount);
+    break;
+  case Instr::LoopEnd:
+    if (actor.coreLoop == instr.match)
+      actor.iterations.push_back({actor.time, actor.busy});
+    if (--actor.counters.back() > 0) {
+      actor.pc = instr.match + 1;
+      return true;
+    }
+    actor.counters.pop_back();
+    break;
+  }
+  if (++actor.pc == actor.program.size() && !actor.coreLoop)
+    actor.iterations.push_back({actor.time, actor.busy});
+  return true;
+}
+
+// Run the actors until each one is done or waits, or maxSteps instructions
+// were executed. Return false in the latter case.
+static bool simulate(Graph &graph, int64_t maxSteps) {
+  for (Channel &channel : graph.channels)
+    channel.free.assign(channel.capacity, 0);
+  int64_t steps = 0;
+  for (bool progress = true; progress;) {
+    progress = false;
+    for (Actor &actor : graph.actors)
+      while (!actor.done() && step(graph, actor)) {
+        progress = true;
+        if (++steps == maxSteps)
+          return false;
+      }
+  }
+  return true;
+}
+
+// Return the cycles of a graph iteration of a component in the steady state,
+// over the second half of the graph iterations completed by its cores.
+static std::optional<double> getPeriod(const Graph &graph, int component) {
+  int64_t completed = std::numeric_limits<int64_t>::max();
+  for (const Actor &actor : graph.actors)
+    if (actor.core && actor.component == component)
+      completed = std::min<int64_t>(completed, actor.iterations.size() /
+                                                   actor.repetitions);
+  if (completed == std::numeric_limits<int64_t>::max() || completed < 2)
+    return {};
+  int64_t warmup = completed / 2;
+  auto endTime = [&](int64_t iteration) {
+    double time = 0;
+    for (const Actor &actor : graph.actors)
+      if (actor.core && actor.component == component)
+        time = std::max(
+            time, actor.iterations[iteration * actor.repetitions - 1].first);
+    return time;
+  };
+  return (endTime(completed) - endTime(warmup)) / (completed - warmup);
+}
+
+struct AIEObjectFifoAnalyzeDataflowPass
+    : AIEObjectFifoAnalyzeDataflowBase<AIEObjectFifoAnalyzeDataflowPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    if (clDMABytesPerCycle == 0) {
+      device.emitError("dma-bytes-per-cycle must be positive");
+      return signalPassFailure();
+    }
+
+    Graph graph = buildGraph(device, clDMABytesPerCycle, clDMALatency);
+    if (graph.actors.empty() || failed(solveBalanceEquations(graph)))
+      return;
+    for (Actor &actor : graph.actors)
+      actor.target = actor.repetitions * (clIterations + 1);
+
+    Graph result = graph;
+    if (!simulate(result, clMaxSteps)) {
+      device.emitRemark("stopped the simulation of the objectFifos after ")
+          << clMaxSteps << " steps";
+      return;
+    }
+
+    // A core waiting forever before the end of the graph iterations analyzed
+    // is deadlocked, unless the program of another core ended before the
+    // simulation would stop it: the design then stops when that program does.
+    bool ended = llvm::any_of(result.actors, [](const Actor &actor) {
+      return actor.core && actor.finished();
+    });
+    bool deadlock = false;
+    for (Actor &actor : result.actors) {
+      if (!actor.core || actor.finished() ||
+          int64_t(actor.iterations.size()) >=
+              actor.repetitions * clIterations ||
+          (ended && !actor.runsToEnd()))
+        continue;
+      const Instr &instr = actor.program[actor.pc];
+      instr.op->emitWarning("deadlock: ")
+          << actor.name << " waits forever to acquire " << instr.count
+          << " element(s) of objectFifo @"
+          << actor.ports[instr.port].fifo.name();
+      deadlock = true;
+    }
+    if (deadlock)
+      return;
+
+    int components = 0;
+    for (const Actor &actor : graph.actors)
+      components = std::max(components, actor.component + 1);
+    for (int component = 0; component < components; component++) {
+      std::optional<double> period = getPeriod(result, component);
+      if (!period)
+        continue;
+
+      // Deepen the channels of each objectFifo of the component by an
+      // element, and keep the one shortening the period the most.
+      ObjectFifoCreateOp limiting;
+      double best = *period;
+      llvm::SetVector<Operation *> fifos;
+      for (const Channel &channel : graph.channels)
+        if (graph.actors[channel.producer].component == component)
+          fifos.insert(channel.fifo);
+      for (Operation *fifo : fifos) {
+        Graph trial = graph;
+        for (Channel &channel : trial.channels)
+          if (channel.fifo == fifo)
+            channel.capacity++;
+        if (!simulate(trial, clMaxSteps))
+          continue;
+        std::optional<double> trialPeriod = getPeriod(trial, component);
+        if (trialPeriod && *trialPeriod < best - 0.5) {
+          best = *trialPeriod;
+          limiting = cast<ObjectFifoCreateOp>(fifo);
+        }
+      }
+
+      const Actor *busiest = nullptr;
+      double busiestLoad = 0;
+      for (Actor &actor : result.actors) {
+        if (!actor.core || actor.component != component)
+          continue;
+        int64_t completed = actor.iterations.size() / actor.repetitions;
+        int64_t warmup = completed / 2;
+        auto [endTime, endBusy] =
+            actor.iterations[completed * actor.repetitions - 1];
+        auto [startTime, startBusy] =
+            actor.iterations[warmup * actor.repetitions - 1];
+        double load =
+            endTime > startTime ? (endBusy - startBusy) / (endTime - startTime)
+                                : 0;
+        actor.core.emitRemark()
+            << actor.repetitions
+            << " core loop iteration(s) per graph iteration, busy "
+            << int64_t(std::round(100 * load)) << "% of the time";
+        if (!busiest || load > busiestLoad) {
+          busiest = &actor;
+          busiestLoad = load;
+        }
+      }
+
+      auto remark = device.emitRemark("steady-state iteration bound of ")
+                    << int64_t(std::round(*period)) << " cycles, limited by ";
+      if (limiting)
+        remark << "objectFifo @" << limiting.name();
+      else
+        remark << busiest->name;
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIEObjectFifoAnalyzeDataflowPass() {
+  return std::make_unique<AIEObjectFifoAnalyzeDataflowPass>();
+}
@@ -0,0 +1,184 @@
+//===- AIEObjectFifoPropagateLayouts.cpp ------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass moves the transposes of the elements of objectFifos from the
+// cores consuming them into the DMAs filling them.
+//
+// A core reading the elements of an objectFifo transposed, e.g. the rhs of a
+// matmul, spends vector shuffles on it on the critical path of its kernel.
+// When the elements already reach the core through a DMA, the buffer
+// descriptor of the DMA can write them transposed instead, for free: the
+// transposing reads of the core then become contiguous reads and its scalar
+// accesses swap their indices.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "aie-objectFifo-propagate-layouts"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Return true if `map` swaps the two dimensions of a 2D access.
+static bool isTransposeMap(AffineMap map) {
+  return map.getNumDims() == 2 && map.isPermutation() && !map.isIdentity();
+}
+
+// Return true if `readOp` is a contiguous 2D read whose only user transposes
+// it.
+static bool isReadOfTranspose(vector::TransferReadOp readOp) {
+  if (!readOp.getPermutationMap().isIdentity() || !readOp->hasOneUse())
+    return false;
+  auto transposeOp = dyn_cast<vector::TransposeOp>(*readOp->user_begin());
+  return transposeOp &&
+         transposeOp.getPermutation() == ArrayRef<int64_t>({1, 0});
+}
+
+// Return true if the access `user` of a 2D element can read it transposed,
+// and set `transposes` if it would then save a transpose.
+static bool canAccessTransposed(Operation *user, bool &transposes) {
+  if (isa<memref::LoadOp, memref::StoreOp>(user))
+    return true;
+  auto readOp = dyn_cast<vector::TransferReadOp>(user);
+  if (!readOp || readOp.getMask() || readOp.getVectorType().getRank() != 2)
+    return false;
+  if (!isTransposeMap(readOp.getPermutationMap()) && !isReadOfTranspose(readOp))
+    return false;
+  transposes = true;
+  return true;
+}
+
+// Rewrite the access `user` of a 2D element for the element to be stored
+// transposed.
+static void accessTransposed(Operation *user) {
+  OpBuilder builder(user);
+  if (auto loadOp = dyn_cast<memref::LoadOp>(user)) {
+    SmallVector<Value> indices(llvm::reverse(loadOp.getIndices()));
+    loadOp.getIndicesMutable().assign(indices);
+    return;
+  }
+  if (auto storeOp = dyn_cast<memref::StoreOp>(user)) {
+    SmallVector<Value> indices(llvm::reverse(storeOp.getIndices()));
+    storeOp.getIndicesMutable().assign(indices);
+    return;
+  }
+
+  auto readOp = cast<vector::TransferReadOp>(user);
+  SmallVector<Value> indices(llvm::reverse(readOp.getIndices()));
+  auto identity = AffineMapAttr::get(builder.getMultiDimIdentityMap(2));
+  if (isTransposeMap(readOp.getPermutationMap())) {
+    auto newReadOp = builder.create<vector::TransferReadOp>(
+        readOp.getLoc(), readOp.getVectorType(), readOp.getSource(), indices,
+        identity, readOp.getPadding(), Value(), readOp.getInBoundsAttr());
+    readOp.replaceAllUsesWith(newReadOp.getResult());
+    readOp.erase();
+    return;
+  }
+
+  // The transpose of a contiguous read is a contiguous read of the transposed
+  // element.
+  auto transposeOp = cast<vector::TransposeOp>(*readOp->user_begin());
+  ArrayAttr inBounds = readOp.getInBoundsAttr();
+  if (inBounds)
+    inBounds = builder.getArrayAttr(
+        llvm::to_vector(llvm::reverse(inBounds.getValue())));
+  auto newReadOp = builder.create<vector::TransferReadOp>(
+      readOp.getLoc(), transposeOp.getResultVectorType(), readOp.getSource(),
+      indices, identity, readOp.getPadding(), Value(), inBounds);
+  transposeOp.replaceAllUsesWith(newReadOp.getResult());
+  transposeOp.erase();
+  readOp.erase();
+}
+
+struct AIEObjectFifoPropagateLayoutsPass
+    : AIEObjectFifoPropagateLayoutsBase<AIEObjectFifoPropagateLayoutsPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    if (device.getTargetModel().getTargetArch() == AIEArch::AIE1)
+      return;
+
+    for (auto createOp : device.getOps<ObjectFifoCreateOp>()) {
+      SmallVector<Operation *> accesses;
+      if (!canTransposeInDMA(device, createOp, accesses))
+        continue;
+
+      for (Operation *access : accesses)
+        accessTransposed(access);
+
+      // The DMA of the consumer writes the element stored row by row in the
+      // stream column by column in its buffer.
+      auto memrefTy = cast<MemRefType>(
+          createOp.getElemType().cast<AIEObjectFifoType>().getElementType());
+      int64_t n = memrefTy.getDimSize(0);
+      MLIRContext *ctx = createOp.getContext();
+      SmallVector<BDDimLayoutAttr> dims = {BDDimLayoutAttr::get(ctx, n, 1),
+                                           BDDimLayoutAttr::get(ctx, n, n)};
+      auto consumerDims = BDDimLayoutArrayAttr::get(ctx, dims);
+      createOp.setDimensionsFromStreamPerConsumerAttr(
+          BDDimLayoutArrayArrayAttr::get(ctx, {consumerDims}));
+    }
+  }
+
+  // Return true if the elements of the objectFifo created by `createOp` can
+  // be transposed by the DMA of its consumer, and it saves transposes in the
+  // core of the consumer. Sets `accesses` to the accesses of the core to the
+  // elements.
+  bool canTransposeInDMA(DeviceOp device, ObjectFifoCreateOp createOp,
+                         SmallVectorImpl<Operation *> &accesses) {
+    // The elements must be square matrices of 32-bit words, which the DMA
+    // moves one at a time.
+    auto memrefTy = dyn_cast<MemRefType>(
+        createOp.getElemType().cast<AIEObjectFifoType>().getElementType());
+    if (!memrefTy || memrefTy.getRank() != 2 || !memrefTy.hasStaticShape() ||
+        memrefTy.getDimSize(0) != memrefTy.getDimSize(1) ||
+        memrefTy.getElementTypeBitWidth() != 32)
+      return false;
+
+    // The elements must already go through a DMA, from a shim or memtile to
+    // a single core, without a layout of their own.
+    TileOp producer = createOp.getProducerTileOp();
+    if (createOp.getConsumerTiles().size() != 1 || createOp.getStream() ||
+        createOp.getCompression() ||
+        !(producer.isShimTile() || producer.isMemTile()) ||
+        !createOp.getDimensionsFromStreamPerConsumer()[0].empty())
+      return false;
+    auto consumer = createOp.getConsumerTiles()[0].getDefiningOp<TileOp>();
+    if (consumer.isShimTile() || consumer.isMemTile())
+      return false;
+
+    bool transposes = false;
+    WalkResult result = device.walk([&](ObjectFifoAcquireOp acquireOp) {
+      if (acquireOp.getObjectFifo() != createOp)
+        return WalkResult::advance();
+      for (Operation *subviewUser : acquireOp->getUsers()) {
+        auto accessOp = dyn_cast<ObjectFifoSubviewAccessOp>(subviewUser);
+        if (!accessOp)
+          return WalkResult::interrupt();
+        for (Operation *user : accessOp->getUsers()) {
+          if (!canAccessTransposed(user, transposes))
+            return WalkResult::interrupt();
+          accesses.push_back(user);
+        }
+      }
+      return WalkResult::advance();
+    });
+    return !result.wasInterrupted() && transposes;
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIEObjectFifoPropagateLayoutsPass() {
+  return std::make_unique<AIEObjectFifoPropagateLayoutsPass>();
+}
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
 
@@ -17,14 +18,19 @@
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/Iterators.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
+#include "mlir/Support/FileUtilities.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 #include "mlir/Transforms/DialectConversion.h"
 
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/ToolOutputFile.h"
+
 #include <numeric>
 #include <set>
 
@@ -36,6 +42,10 @@ using namespace xilinx::AIE;
 
 #define LOOP_VAR_DEPENDENCY (-2)
 
+// Performance counter of the core module timing the profiled acquires, from
+// INSTR_EVENT_0 to INSTR_EVENT_1.
+static constexpr int profileCounter = 0;
+
 //===----------------------------------------------------------------------===//
 // Lock Analysis
 //===----------------------------------------------------------------------===//
@@ -149,6 +159,11 @@ struct AIEObjectFifoStatefulTransformPass
   DenseMap<ObjectFifoLinkOp, ObjectFifoCreateOp>
       objFifoLinks; // maps each ObjectFifoLinkOp to objFifo whose elements
   // have been created and should be used
+  DenseSet<Operation *> rotatedLoops; // loops kept rolled by unrollForLoops,
+  // whose accesses select their element with a rotating index
+  llvm::MapVector<Operation *, std::set<std::string>>
+      profiledFifos; // maps each core to the objectFifos whose acquires it
+  // times when profiling
 
   /// Function that returns true if two tiles in the AIE array share a memory
   /// module. share_direction is equal to:
@@ -196,7 +211,8 @@ struct AIEObjectFifoStatefulTransformPass
     bool atLeastOneConsumerWantsTransform = false;
 
     if (createOp.getConsumerTiles().size() == 1 &&
-        createOp.getDimensionsToStream().empty()) {
+        createOp.getDimensionsToStream().empty() &&
+        !createOp.getCompression()) {
 
       // Test for shared memory
       for (auto consumerTile : createOp.getConsumerTiles()) {
@@ -247,6 +263,16 @@ struct AIEObjectFifoStatefulTransformPass
     return {};
   }
 
+  /// Returns how many times the memtile sends each element of the link of op,
+  /// as given by the repeat_count of its output, or 1 if op is not linked.
+  int getRepeatCount(ObjectFifoCreateOp op) {
+    if (auto linkOp = getOptionalLinkOp(op))
+      if (auto repeatCount =
+              linkOp->getOutputObjectFifos()[0].getRepeatCount())
+        return *repeatCount;
+    return 1;
+  }
+
   ObjectFifoCreateOp
   createObjectFifo(OpBuilder &builder, AIEObjectFifoType datatype,
                    std::string name, Value prodTile, Value consTile,
@@ -352,7 +378,9 @@ struct AIEObjectFifoStatefulTransformPass
                                .cast<AIEObjectFifoType>();
         auto elemOutType = fifoOutType.getElementType().cast<MemRefType>();
 
-        if (int outSize = getMemrefTypeSize(elemOutType); inSize >= outSize) {
+        // the buffers of a padded output hold the data before padding
+        if (int outSize = getMemrefTypeSize(elemOutType);
+            inSize >= outSize || fifoOut.getPadDimensions()) {
           if (op.name() != fifoIn.name())
             return;
         } else {
@@ -372,12 +400,7 @@ struct AIEObjectFifoStatefulTransformPass
     }
 
     // Reset opbuilder location to after the last tile declaration
-    Operation *t = nullptr;
-    auto dev = op->getParentOfType<DeviceOp>();
-    for (auto tile_op : dev.getBody()->getOps<TileOp>()) {
-      t = tile_op.getOperation();
-    }
-    builder.setInsertionPointAfter(t);
+    builder.setInsertionPointAfter(getAnalysis<DeviceIndex>().getLastTile());
     for (int i = 0; i < numElem; i++) {
       // if shimTile external buffers are collected from input code
       // create as many locks as there are external buffers
@@ -397,6 +420,8 @@ struct AIEObjectFifoStatefulTransformPass
       else if (linkOp->isJoin())
         numElem *= linkOp->getFifoIns().size();
       objFifoLinks[*linkOp] = op;
+      // the lock values of a repeated element count its sends
+      numElem *= getRepeatCount(op);
     }
     std::vector<LockOp> locks = createObjectFifoLocks(builder, lockAnalysis, op,
                                                       numElem, creation_tile);
@@ -419,13 +444,22 @@ struct AIEObjectFifoStatefulTransformPass
   void createBd(OpBuilder &builder, LockOp acqLock, int acqMode,
                 LockAction acqLockAction, LockOp relLock, int relMode,
                 MyOp buff, int offset, int len, Block *succ,
-                BDDimLayoutArrayAttr dims) {
+                BDDimLayoutArrayAttr dims, BDPadLayoutArrayAttr pads = {},
+                bool compression = false) {
     builder.create<UseLockOp>(builder.getUnknownLoc(), acqLock, acqLockAction,
                               acqMode);
-    if (!dims.getValue().empty())
-      builder.create<DMABDOp>(builder.getUnknownLoc(), buff, offset, len, dims);
-    else
-      builder.create<DMABDOp>(builder.getUnknownLoc(), buff, offset, len);
+    DMABDOp bdOp;
+    if (!dims.getValue().empty()) {
+      bdOp = builder.create<DMABDOp>(builder.getUnknownLoc(), buff, offset,
+                                     len, dims);
+      if (pads)
+        bdOp.setPadDimensionsAttr(pads);
+    } else {
+      bdOp =
+          builder.create<DMABDOp>(builder.getUnknownLoc(), buff, offset, len);
+    }
+    if (compression)
+      bdOp.setCompressionAttr(builder.getUnitAttr());
 
     builder.create<UseLockOp>(builder.getUnknownLoc(), relLock,
                               LockAction::Release, relMode);
@@ -439,7 +473,9 @@ struct AIEObjectFifoStatefulTransformPass
   void createBdBlock(OpBuilder &builder, ObjectFifoCreateOp op, int lockMode,
                      int acqNum, int relNum, MyOp buff, int offset, int len,
                      DMAChannelDir channelDir, size_t blockIndex, Block *succ,
-                     BDDimLayoutArrayAttr dims) {
+                     BDDimLayoutArrayAttr dims,
+                     BDPadLayoutArrayAttr pads = {},
+                     bool compression = false) {
     LockOp acqLock;
     LockOp relLock;
     int acqMode = 1;
@@ -462,7 +498,7 @@ struct AIEObjectFifoStatefulTransformPass
                                                   : locksPerFifo[op][0];
     }
     createBd(builder, acqLock, acqMode, acqLockAction, relLock, relMode, buff,
-             offset, len, succ, dims);
+             offset, len, succ, dims, pads, compression);
   }
 
   /// Function that either calls createAIETileDMA(), createShimDMA() or
@@ -560,7 +596,8 @@ struct AIEObjectFifoStatefulTransformPass
       builder.setInsertionPointToStart(curr);
       createBdBlock<BufferOp>(builder, target, lockMode, acqNum, relNum,
                               buffersPerFifo[target][blockIndex], offset, len,
-                              channelDir, blockIndex, succ, dims);
+                              channelDir, blockIndex, succ, dims,
+                              /*pads*/ {}, op.getCompression());
       curr = succ;
       blockIndex++;
     }
@@ -672,34 +709,26 @@ struct AIEObjectFifoStatefulTransformPass
         target = objFifoLinks[*linkOp];
 
         if (linkOp->isJoin()) {
-          // find offset based on order of this op in join list
+          // find offset of this op's part in the output buffers
           isJoin = true;
           if (target == op) {
             acqNum = linkOp->getFifoIns().size();
             relNum = linkOp->getFifoIns().size();
           } else {
-            for (auto fifoIn : linkOp->getInputObjectFifos()) {
-              auto fifoType = fifoIn.getElemType().cast<AIEObjectFifoType>();
-              auto elemType = fifoType.getElementType().cast<MemRefType>();
-              if (fifoIn.name() == op.name())
-                break;
-              extraOffset += getMemrefTypeSize(elemType);
-            }
+            auto fifoIns = linkOp->getInputObjectFifos();
+            extraOffset = linkOp->getPartOffset(
+                llvm::find(fifoIns, op) - fifoIns.begin());
           }
         } else if (linkOp->isDistribute()) {
-          // find offset based on order of this op in distribute list
+          // find offset of this op's part in the input buffers
           isDistribute = true;
           if (target == op) {
             acqNum = linkOp->getFifoOuts().size();
             relNum = linkOp->getFifoOuts().size();
           } else {
-            for (auto fifoOut : linkOp->getOutputObjectFifos()) {
-              auto fifoType = fifoOut.getElemType().cast<AIEObjectFifoType>();
-              auto elemType = fifoType.getElementType().cast<MemRefType>();
-              if (fifoOut.name() == op.name())
-                break;
-              extraOffset += getMemrefTypeSize(elemType);
-            }
+            auto fifoOuts = linkOp->getOutputObjectFifos();
+            extraOffset = linkOp->getPartOffset(
+                llvm::find(fifoOuts, op) - fifoOuts.begin());
           }
         } else {
           if (target != op) {
@@ -716,6 +745,28 @@ struct AIEObjectFifoStatefulTransformPass
       }
     }
 
+    // An element sent repeat_count times is only refilled once all of its
+    // sends are done, so the lock values count sends: the S2MM acquires and
+    // releases all of them at once. With several buffers the MM2S needs one
+    // BD per send to stay on the same buffer; a single buffer has a BD that
+    // loops on itself, and its locks alone repeat it.
+    int repeatCount = getRepeatCount(op);
+    int bdsPerBuffer = 1;
+    if (channelDir == DMAChannelDir::S2MM) {
+      acqNum *= repeatCount;
+      relNum *= repeatCount;
+    } else if (numBlocks > 1) {
+      bdsPerBuffer = repeatCount;
+    }
+
+    // The padding is added to the data sent by the producer, whose elements
+    // have the padded size.
+    BDPadLayoutArrayAttr pads;
+    if (channelDir == DMAChannelDir::MM2S && op.getPadDimensions()) {
+      pads = op.getPadDimensionsAttr();
+      lenOut = getMemrefTypeSize(elemType);
+    }
+
     // search for MemTileDMAOp
     Operation *producerDMA = nullptr;
     for (auto dmaOp : device.getOps<MemTileDMAOp>()) {
@@ -758,11 +809,12 @@ struct AIEObjectFifoStatefulTransformPass
     // create Bd blocks
     Block *succ;
     Block *curr = bdBlock;
-    size_t blockIndex = 0;
-    for (size_t i = 0; i < numBlocks; i++) {
+    size_t numBds = numBlocks * bdsPerBuffer;
+    for (size_t i = 0; i < numBds; i++) {
+      size_t blockIndex = i / bdsPerBuffer;
       if (blockIndex >= buffersPerFifo[target].size())
         break;
-      if (i == numBlocks - 1)
+      if (i == numBds - 1)
         succ = bdBlock;
       else
         succ = builder.createBlock(endBlock);
@@ -772,9 +824,9 @@ struct AIEObjectFifoStatefulTransformPass
         offset = extraOffset * bytes;
       createBdBlock<BufferOp>(builder, target, lockMode, acqNum, relNum,
                               buffersPerFifo[target][blockIndex], offset,
-                              lenOut, channelDir, blockIndex, succ, dims);
+                              lenOut, channelDir, blockIndex, succ, dims, pads,
+                              op.getCompression());
       curr = succ;
-      blockIndex++;
     }
   }
 
@@ -904,12 +956,114 @@ struct AIEObjectFifoStatefulTransformPass
     }
   }
 
+  // Function that returns true if a for-loop can be kept rolled, its
+  // accesses to objectFifo elements selecting the element with a rotating
+  // index. This is the case on AIE2, where the locks of an objectFifo don't
+  // depend on its elements, if each iteration acquires and releases all the
+  // elements it uses, and if the objectFifos are not accessed elsewhere in
+  // the core. The loops around it must not be unrolled, which would
+  // duplicate it.
+  bool canRotateIndices(CoreOp coreOp, scf::ForOp forLoop) {
+    if (getTargetModel(coreOp).getTargetArch() == AIEArch::AIE1)
+      return false;
+    for (Operation *parent = forLoop->getParentOp(); parent != coreOp;
+         parent = parent->getParentOp())
+      if (auto parentLoop = dyn_cast<scf::ForOp>(parent);
+          parentLoop &&
+          !parentLoop.getBody()->getOps<ObjectFifoAcquireOp>().empty())
+        return false;
+
+    auto key = [](auto op) {
+      return std::make_pair(op.getObjectFifo(),
+                            op.getPort() == ObjectFifoPort::Produce ? 0 : 1);
+    };
+    DenseMap<std::pair<ObjectFifoCreateOp, int>, int> held;
+    for (Operation &op : forLoop.getBody()->getOperations()) {
+      if (auto acqOp = dyn_cast<ObjectFifoAcquireOp>(op)) {
+        int &count = held[key(acqOp)];
+        count = std::max(count, acqOp.acqNumber());
+      } else if (auto relOp = dyn_cast<ObjectFifoReleaseOp>(op)) {
+        if ((held[key(relOp)] -= relOp.relNumber()) < 0)
+          return false;
+      }
+    }
+    for (auto &[fifo, count] : held)
+      if (count != 0)
+        return false;
+
+    WalkResult result = coreOp.walk([&](Operation *op) {
+      std::pair<ObjectFifoCreateOp, int> fifo;
+      if (auto acqOp = dyn_cast<ObjectFifoAcquireOp>(op))
+        fifo = key(acqOp);
+      else if (auto relOp = dyn_cast<ObjectFifoReleaseOp>(op))
+        fifo = key(relOp);
+      else
+        return WalkResult::advance();
+      if (op->getParentOp() != forLoop && held.count(fifo))
+        return WalkResult::interrupt();
+      return WalkResult::advance();
+    });
+    return !result.wasInterrupted();
+  }
+
+  // Function that returns, in an iteration of a loop kept rolled by
+  // unrollForLoops, the element of an objectFifo which is the one at the
+  // given index in the first iteration. Each iteration advances the index
+  // by the number of elements it releases.
+  Value createRotatingAccess(OpBuilder &builder, scf::ForOp forLoop,
+                             ObjectFifoCreateOp op, ObjectFifoPort port,
+                             int index) {
+    int size = op.size();
+    int advance = 0;
+    for (auto relOp : forLoop.getBody()->getOps<ObjectFifoReleaseOp>())
+      if (relOp.getObjectFifo() == op && relOp.getPort() == port)
+        advance += relOp.relNumber();
+    std::vector<BufferOp> &buffers = buffersPerFifo[op];
+    if (advance % size == 0)
+      return buffers[index].getBuffer();
+
+    Location loc = forLoop.getLoc();
+    auto constant = [&](int64_t value) -> Value {
+      return builder.create<arith::ConstantIndexOp>(loc, value);
+    };
+    Value distance = builder.create<arith::SubIOp>(
+        loc, forLoop.getInductionVar(), forLoop.getLowerBound());
+    Value iteration =
+        builder.create<arith::DivUIOp>(loc, distance, forLoop.getStep());
+    Value offset = builder.create<arith::MulIOp>(loc, iteration,
+                                                 constant(advance % size));
+    Value position =
+        builder.create<arith::AddIOp>(loc, offset, constant(index));
+    Value selector =
+        builder.create<arith::RemUIOp>(loc, position, constant(size));
+
+    SmallVector<int64_t> cases(size);
+    std::iota(cases.begin(), cases.end(), 0);
+    auto switchOp = builder.create<scf::IndexSwitchOp>(
+        loc, TypeRange{buffers[index].getType()}, selector, cases, size);
+    {
+      OpBuilder::InsertionGuard guard(builder);
+      for (int i = 0; i < size; i++) {
+        builder.createBlock(&switchOp.getCaseRegions()[i]);
+        builder.create<scf::YieldOp>(loc, buffers[i].getBuffer());
+      }
+      // not reachable: the selector is always one of the cases
+      builder.createBlock(&switchOp.getDefaultRegion());
+      builder.create<scf::YieldOp>(loc, buffers[index].getBuffer());
+    }
+    return switchOp.getResult(0);
+  }
+
   // Function that unrolls for-loops that contain objectFifo operations.
-  void unrollForLoops(DeviceOp &device, OpBuilder &builder,
-                      std::set<TileOp> objectFifoTiles) {
+  // The bounds of a loop may be runtime values, e.g. a number of iterations
+  // read from a buffer of runtime parameters, in which case the number of
+  // iterations must be a multiple of the unrolling factor: the remainder
+  // can't be unrolled after the loop.
+  LogicalResult unrollForLoops(DeviceOp &device, OpBuilder &builder,
+                               std::set<TileOp> objectFifoTiles) {
     for (auto coreOp : device.getOps<CoreOp>()) {
       if (objectFifoTiles.count(coreOp.getTileOp()) > 0) {
-        coreOp.walk([&](scf::ForOp forLoop) {
+        WalkResult result = coreOp.walk([&](scf::ForOp forLoop) {
           // look for operations on objectFifos
           // when multiple fifos in same loop, must use the smallest
           // common multiplier as the unroll factor
@@ -928,6 +1082,11 @@ struct AIEObjectFifoStatefulTransformPass
           int unrollFactor =
               computeLCM(objFifoSizes); // also counts original loop body
 
+          if (found && clRotatingIndex && canRotateIndices(coreOp, forLoop)) {
+            rotatedLoops.insert(forLoop);
+            return WalkResult::advance();
+          }
+
           if (found) {
             std::vector<Operation *>
                 operations; // operations in original loop body, without
@@ -948,22 +1107,18 @@ struct AIEObjectFifoStatefulTransformPass
             //    with that index in original loop body
 
             // find new loop size and step
-            auto old_upper_bound = forLoop.getUpperBound()
-                                       .getDefiningOp<arith::ConstantOp>()
-                                       .getValue();
-            int64_t old_upper_value =
-                llvm::dyn_cast<IntegerAttr>(old_upper_bound).getInt();
-            auto old_lower_bound = forLoop.getLowerBound()
-                                       .getDefiningOp<arith::ConstantOp>()
-                                       .getValue();
-            int64_t old_lower_value =
-                llvm::dyn_cast<IntegerAttr>(old_lower_bound).getInt();
-            auto old_step =
-                forLoop.getStep().getDefiningOp<arith::ConstantOp>().getValue();
-            int64_t old_step_value =
-                llvm::dyn_cast<IntegerAttr>(old_step).getInt();
-            int64_t num_iter =
-                (old_upper_value - old_lower_value) / old_step_value;
+            std::optional<int64_t> old_step =
+                getConstantIntValue(forLoop.getStep());
+            if (!old_step) {
+              forLoop.emitOpError("accesses objectFifos, its step must be a "
+                                  "constant to be unrolled");
+              return WalkResult::interrupt();
+            }
+            int64_t old_step_value = *old_step;
+            std::optional<int64_t> old_lower_value =
+                getConstantIntValue(forLoop.getLowerBound());
+            std::optional<int64_t> old_upper_value =
+                getConstantIntValue(forLoop.getUpperBound());
 
             int64_t num_unrolls; // number of times to unroll loop, not counting
                                  // original body
@@ -971,6 +1126,35 @@ struct AIEObjectFifoStatefulTransformPass
             identifyDependencies(forLoop, forLoop, operations, opIndex,
                                  dependencies, 0);
 
+            int64_t new_step_value =
+                static_cast<int64_t>(unrollFactor) * old_step_value;
+            if (!old_lower_value || !old_upper_value) {
+              // The number of iterations is only known at runtime: the loop
+              // runs the multiples of the unrolling factor it contains.
+              num_unrolls = unrollFactor - 1;
+              builder.setInsertionPoint(forLoop);
+              Location loc = forLoop.getLoc();
+              Value new_step = builder.create<arith::ConstantIndexOp>(
+                  loc, new_step_value);
+              Value distance = builder.create<arith::SubIOp>(
+                  loc, forLoop.getUpperBound(), forLoop.getLowerBound());
+              Value unrolled = builder.create<arith::MulIOp>(
+                  loc,
+                  builder.create<arith::DivUIOp>(loc, distance, new_step),
+                  new_step);
+              forLoop.setUpperBound(builder.create<arith::AddIOp>(
+                  loc, forLoop.getLowerBound(), unrolled));
+              forLoop.setStep(new_step);
+
+              builder.setInsertionPoint(&body->back());
+              duplicateBlock(builder, num_unrolls, operations, dependencies,
+                             forLoop.getInductionVar(), old_step_value, true);
+              return WalkResult::advance();
+            }
+
+            int64_t num_iter =
+                (*old_upper_value - *old_lower_value) / old_step_value;
+
             if (num_iter <= unrollFactor) {
               // duplicate loop body and remove loop
               num_unrolls = num_iter;
@@ -983,14 +1167,13 @@ struct AIEObjectFifoStatefulTransformPass
               num_unrolls = unrollFactor - 1; // -1 without original loop body
 
               // create new upper bound and step
-              int64_t new_step_value =
-                  static_cast<int64_t>(unrollFactor) * old_step_value;
-              int64_t remainder = (old_upper_value - old_lower_value) %
+              int64_t remainder = (*old_upper_value - *old_lower_value) %
                                   new_step_value / old_step_value;
               builder.setInsertionPoint(forLoop);
               if (remainder > 0) {
-                int64_t new_upper_bound = (old_upper_value - old_lower_value) /
-                                          new_step_value * new_step_value;
+                int64_t new_upper_bound =
+                    (*old_upper_value - *old_lower_value) / new_step_value *
+                    new_step_value;
                 auto uBound = builder.create<arith::ConstantOp>(
                     builder.getUnknownLoc(),
                     builder.getIndexAttr(new_upper_bound));
@@ -1011,9 +1194,13 @@ struct AIEObjectFifoStatefulTransformPass
                              forLoop.getUpperBound(), old_step_value, false);
             }
           }
+          return WalkResult::advance();
         });
+        if (result.wasInterrupted())
+          return failure();
       }
     }
+    return success();
   }
 
   /// Function used to create a UseLockOp based on input parameters.
@@ -1172,6 +1359,334 @@ struct AIEObjectFifoStatefulTransformPass
                                         builder.getI64IntegerAttr(colIndex));
   }
 
+  /// Function used to lower the objectFifos with the `stream` attribute to
+  /// a flow between the stream ports of their cores, without buffers or
+  /// locks. Their puts and gets become put_stream and get_stream operations
+  /// on the first core channels not used by other flows.
+  LogicalResult lowerStreamFifos(DeviceOp &device) {
+    const auto &targetModel = device.getTargetModel();
+    DenseMap<TileOp, DenseSet<int>> usedMasters, usedSlaves;
+    for (auto flow : device.getOps<FlowOp>()) {
+      if (flow.getSourceBundle() == WireBundle::Core)
+        usedMasters[cast<TileOp>(flow.getSource().getDefiningOp())].insert(
+            flow.getSourceChannel());
+      if (flow.getDestBundle() == WireBundle::Core)
+        usedSlaves[cast<TileOp>(flow.getDest().getDefiningOp())].insert(
+            flow.getDestChannel());
+    }
+    auto allocate = [&](DenseMap<TileOp, DenseSet<int>> &used, TileOp tile,
+                        int numChannels) -> std::optional<int> {
+      for (int channel = 0; channel < numChannels; channel++)
+        if (used[tile].insert(channel).second)
+          return channel;
+      return std::nullopt;
+    };
+
+    SmallVector<ObjectFifoCreateOp> streamFifos;
+    for (auto createOp : device.getOps<ObjectFifoCreateOp>())
+      if (createOp.getStream())
+        streamFifos.push_back(createOp);
+
+    OpBuilder builder(device.getContext());
+    for (auto createOp : streamFifos) {
+      TileOp producer = createOp.getProducerTileOp();
+      auto masterChannel =
+          allocate(usedMasters, producer,
+                   targetModel.getNumSourceSwitchboxConnections(
+                       producer.getCol(), producer.getRow(), WireBundle::Core));
+      if (!masterChannel)
+        return createOp.emitOpError("has no free stream port on its producer "
+                                    "core");
+
+      // Each consumer reads the broadcast of the producer on its own channel.
+      DenseMap<Value, int> slaveChannels;
+      builder.setInsertionPointAfter(createOp);
+      for (auto consumerTile : createOp.getConsumerTiles()) {
+        TileOp consumer = consumerTile.getDefiningOp<TileOp>();
+        auto slaveChannel =
+            allocate(usedSlaves, consumer,
+                     targetModel.getNumDestSwitchboxConnections(
+                         consumer.getCol(), consumer.getRow(),
+                         WireBundle::Core));
+        if (!slaveChannel)
+          return createOp.emitOpError("has no free stream port on its "
+                                      "consumer core (")
+                 << consumer.getCol() << ", " << consumer.getRow() << ")";
+        slaveChannels[consumerTile] = *slaveChannel;
+        builder.create<FlowOp>(builder.getUnknownLoc(),
+                               createOp.getProducerTile(), WireBundle::Core,
+                               *masterChannel, consumerTile, WireBundle::Core,
+                               *slaveChannel);
+      }
+
+      auto createChannel = [&](Operation *op, int channel) {
+        builder.setInsertionPoint(op);
+        return builder.create<arith::ConstantOp>(
+            op->getLoc(), builder.getI32IntegerAttr(channel));
+      };
+      device.walk([&](ObjectFifoPutOp putOp) {
+        if (putOp.getObjFifoName() != createOp.getSymName())
+          return;
+        builder.create<PutStreamOp>(putOp.getLoc(),
+                                    createChannel(putOp, *masterChannel),
+                                    putOp.getValue());
+        putOp.erase();
+      });
+      device.walk([&](ObjectFifoGetOp getOp) {
+        if (getOp.getObjFifoName() != createOp.getSymName())
+          return;
+        auto core = getOp->getParentOfType<CoreOp>();
+        auto getStream = builder.create<GetStreamOp>(
+            getOp.getLoc(), getOp.getValue().getType(),
+            createChannel(getOp, slaveChannels[core.getTile()]));
+        getOp.getValue().replaceAllUsesWith(getStream.getStreamValue());
+        getOp.erase();
+      });
+      createOp.erase();
+    }
+    return success();
+  }
+
+  /// Function used to remove the memtile hop of 1:1 links which only
+  /// forward the elements of an objectFifo to another one: the output
+  /// objectFifo takes over the producer of the input one, whose uses are
+  /// redirected to it, and the elements flow directly between the tiles.
+  void bypassPassThroughLinks(DeviceOp &device) {
+    SmallVector<ObjectFifoLinkOp> linkOps(device.getOps<ObjectFifoLinkOp>());
+    for (auto linkOp : linkOps) {
+      if (linkOp.isJoin() || linkOp.isDistribute())
+        continue;
+      ObjectFifoCreateOp fifoIn = linkOp.getInputObjectFifos()[0];
+      ObjectFifoCreateOp fifoOut = linkOp.getOutputObjectFifos()[0];
+      auto linkTile = linkOp.getOptionalSharedTile()->getDefiningOp<TileOp>();
+      // The memtile must not hold elements for other consumers, nor change
+      // their layout.
+      if (!linkTile.isMemTile() || fifoIn.getConsumerTiles().size() != 1 ||
+          !fifoIn.getDimensionsFromStreamPerConsumer()[0].empty() ||
+          !fifoOut.getDimensionsToStream().empty() ||
+          fifoIn.getElemType() != fifoOut.getElemType())
+        continue;
+
+      // the producer keeps its depth; a single depth for both objectFifos
+      // still lets the depths of both ends be computed from the cores
+      OpBuilder builder(fifoOut);
+      if (isa<ArrayAttr>(fifoIn.getElemNumber()) ||
+          isa<ArrayAttr>(fifoOut.getElemNumber()) ||
+          fifoIn.size() != fifoOut.size()) {
+        SmallVector<Attribute> depths = {
+            builder.getI64IntegerAttr(fifoIn.size())};
+        for (size_t i = 0; i < fifoOut.getConsumerTiles().size(); i++)
+          depths.push_back(builder.getI64IntegerAttr(
+              fifoOut.size(isa<ArrayAttr>(fifoOut.getElemNumber()) ? i + 1
+                                                                   : 0)));
+        fifoOut.setElemNumberAttr(builder.getArrayAttr(depths));
+      }
+      fifoOut->setOperand(0, fifoIn.getProducerTile());
+      fifoOut.setDimensionsToStreamAttr(fifoIn.getDimensionsToStreamAttr());
+
+      linkOp->erase();
+      if (failed(SymbolTable::replaceAllSymbolUses(fifoIn, fifoOut.name(),
+                                                   device)))
+        llvm::report_fatal_error("unable to update all symbol uses");
+      fifoIn->erase();
+    }
+  }
+
+  /// Return true if the objectFifo created by createOp would be lowered to
+  /// shared memory if its tiles were adjacent: it connects two core tiles,
+  /// without a broadcast, a link or a data layout transformation.
+  bool couldShareMemory(ObjectFifoCreateOp createOp) {
+    if (createOp.getConsumerTiles().size() != 1 ||
+        !createOp.getDimensionsToStream().empty() ||
+        createOp.getCompression() || getOptionalLinkOp(createOp))
+      return false;
+    for (BDDimLayoutArrayAttr dims :
+         createOp.getDimensionsFromStreamPerConsumer())
+      if (!dims.empty())
+        return false;
+    auto isCore = [](TileOp tile) {
+      return !tile.isShimTile() && !tile.isMemTile();
+    };
+    return isCore(createOp.getProducerTileOp()) &&
+           isCore(createOp.getConsumerTiles()[0].getDefiningOp<TileOp>());
+  }
+
+  /// Return true if the position of a tile can't change: it has a switchbox,
+  /// or its core and memory are accessed from other tiles.
+  bool isPinned(TileOp tile) {
+    auto usedElsewhere = [&](Operation *op) {
+      auto core = op->getParentOfType<CoreOp>();
+      return core && core.getTileOp() != tile;
+    };
+    for (Operation *user : tile->getUsers()) {
+      if (isa<SwitchboxOp, ShimMuxOp>(user))
+        return true;
+      if (isa<BufferOp, LockOp>(user) &&
+          llvm::any_of(user->getUsers(), usedElsewhere))
+        return true;
+    }
+    CoreOp core = tile.getCoreOp();
+    return core && core.walk([&](Operation *op) {
+                         for (Value operand : op->getOperands()) {
+                           Operation *def = operand.getDefiningOp();
+                           if (auto buffer = dyn_cast_or_null<BufferOp>(def);
+                               buffer && buffer.getTileOp() != tile)
+                             return WalkResult::interrupt();
+                           if (auto lock = dyn_cast_or_null<LockOp>(def);
+                               lock && lock.getTileOp() != tile)
+                             return WalkResult::interrupt();
+                         }
+                         return WalkResult::advance();
+                       })
+                       .wasInterrupted();
+  }
+
+  /// Function used to move the consumer tile of each objectFifo which only
+  /// uses DMAs because its tiles aren't adjacent next to its producer, on a
+  /// free core tile where the objectFifos of the consumer which already use
+  /// shared memory keep doing so.
+  void placeForSharedMemory(DeviceOp &device) {
+    const auto &targetModel = device.getTargetModel();
+    DenseSet<TileID> occupied;
+    for (auto tile : device.getOps<TileOp>())
+      occupied.insert(tile.getTileID());
+
+    for (auto createOp : device.getOps<ObjectFifoCreateOp>()) {
+      int share_direction = 0;
+      if (!couldShareMemory(createOp) ||
+          !requiresDMAs(createOp, share_direction))
+        continue;
+      TileOp producer = createOp.getProducerTileOp();
+      auto consumer = createOp.getConsumerTiles()[0].getDefiningOp<TileOp>();
+      if (isPinned(consumer))
+        continue;
+
+      SmallVector<ObjectFifoCreateOp> sharedFifos;
+      for (auto other : device.getOps<ObjectFifoCreateOp>())
+        if (other != createOp &&
+            (other.getProducerTileOp() == consumer ||
+             llvm::is_contained(other.getConsumerTiles(), consumer)) &&
+            !requiresDMAs(other, share_direction))
+          sharedFifos.push_back(other);
+
+      TileID from = consumer.getTileID();
+      OpBuilder builder(device.getContext());
+      auto moveConsumer = [&](TileID to) {
+        consumer.setColAttr(builder.getI32IntegerAttr(to.col));
+        consumer.setRowAttr(builder.getI32IntegerAttr(to.row));
+      };
+      TileID neighbours[] = {{producer.colIndex(), producer.rowIndex() + 1},
+                             {producer.colIndex(), producer.rowIndex() - 1},
+                             {producer.colIndex() - 1, producer.rowIndex()},
+                             {producer.colIndex() + 1, producer.rowIndex()}};
+      for (TileID to : neighbours) {
+        if (to.col < 0 || to.col >= targetModel.columns() || to.row < 0 ||
+            to.row >= targetModel.rows() ||
+            !targetModel.isCoreTile(to.col, to.row) || occupied.contains(to))
+          continue;
+        moveConsumer(to);
+        if (!requiresDMAs(createOp, share_direction) &&
+            llvm::none_of(sharedFifos, [&](ObjectFifoCreateOp other) {
+              return requiresDMAs(other, share_direction);
+            })) {
+          occupied.erase(from);
+          occupied.insert(to);
+          createOp.emitRemark("moved the consumer tile from (")
+              << from.col << ", " << from.row << ") to (" << to.col << ", "
+              << to.row << ") to use shared memory";
+          break;
+        }
+        moveConsumer(from);
+      }
+    }
+  }
+
+  /// Function used to spread the shim tile endpoints of objectFifos over the
+  /// shim NOC tiles declared in the device. The endpoints are placed from the
+  /// largest element to the smallest, each one on the shim tile moving the
+  /// fewest bytes in its direction among those with a free DMA channel. Ties
+  /// keep the endpoint on its own tile, or else on the closest one.
+  void balanceShimDMAs(DeviceOp &device) {
+    const auto &targetModel = device.getTargetModel();
+    SmallVector<TileOp> shimTiles;
+    for (auto tile : device.getOps<TileOp>())
+      if (targetModel.isShimNOCTile(tile.colIndex(), tile.rowIndex()))
+        shimTiles.push_back(tile);
+    if (shimTiles.size() < 2)
+      return;
+
+    // Bytes moved and channels used on each shim tile and direction,
+    // starting with the channels of existing shim DMAs.
+    DenseMap<std::pair<Operation *, DMAChannelDir>, int64_t> load;
+    DenseMap<std::pair<Operation *, DMAChannelDir>, int> channels;
+    for (auto shimDMA : device.getOps<ShimDMAOp>())
+      for (auto &block : shimDMA.getBody())
+        for (auto start : block.getOps<DMAStartOp>())
+          channels[{shimDMA.getTileOp(), start.getChannelDir()}]++;
+
+    struct Endpoint {
+      ObjectFifoCreateOp fifo;
+      unsigned operand;
+      DMAChannelDir direction;
+      int64_t bytes;
+    };
+    SmallVector<Endpoint> endpoints;
+    for (auto createOp : device.getOps<ObjectFifoCreateOp>()) {
+      auto elemType = llvm::cast<MemRefType>(
+          createOp.getElemType().cast<AIEObjectFifoType>().getElementType());
+      int64_t bytes =
+          elemType.getNumElements() * elemType.getElementTypeBitWidth() / 8;
+      for (OpOperand &operand : createOp->getOpOperands())
+        if (auto tile = operand.get().getDefiningOp<TileOp>();
+            tile && llvm::is_contained(shimTiles, tile))
+          endpoints.push_back(
+              {createOp, operand.getOperandNumber(),
+               operand.getOperandNumber() == 0 ? DMAChannelDir::MM2S
+                                               : DMAChannelDir::S2MM,
+               bytes});
+    }
+    llvm::stable_sort(endpoints, [](const Endpoint &a, const Endpoint &b) {
+      return a.bytes > b.bytes;
+    });
+
+    for (Endpoint &endpoint : endpoints) {
+      Value original = endpoint.fifo->getOperand(endpoint.operand);
+      auto originalTile = original.getDefiningOp<TileOp>();
+      TileOp best;
+      std::pair<int64_t, int> bestCost;
+      for (TileOp tile : shimTiles) {
+        int numChannels = endpoint.direction == DMAChannelDir::MM2S
+                              ? tile.getNumSourceConnections(WireBundle::DMA)
+                              : tile.getNumDestConnections(WireBundle::DMA);
+        if (channels[{tile, endpoint.direction}] >= numChannels ||
+            !tile->isBeforeInBlock(endpoint.fifo))
+          continue;
+        std::pair<int64_t, int> cost = {
+            load[{tile, endpoint.direction}],
+            std::abs(tile.colIndex() - originalTile.colIndex())};
+        if (!best || cost < bestCost) {
+          best = tile;
+          bestCost = cost;
+        }
+      }
+      if (!best)
+        best = originalTile;
+      load[{best, endpoint.direction}] += endpoint.bytes;
+      channels[{best, endpoint.direction}]++;
+      if (best == originalTile)
+        continue;
+
+      LLVM_DEBUG(llvm::dbgs()
+                 << "Moving an endpoint of " << endpoint.fifo.name()
+                 << " to shim tile " << best.colIndex() << "\n");
+      endpoint.fifo->setOperand(endpoint.operand, best.getResult());
+      for (auto regOp : device.getOps<ObjectFifoRegisterExternalBuffersOp>())
+        if (regOp.getObjectFifo() == endpoint.fifo &&
+            regOp.getTile() == original)
+          regOp->setOperand(0, best.getResult());
+    }
+  }
+
   void runOnOperation() override {
     DeviceOp device = getOperation();
     LockAnalysis lockAnalysis(device);
@@ -1181,6 +1696,18 @@ struct AIEObjectFifoStatefulTransformPass
     std::set<TileOp>
         objectFifoTiles; // track cores to check for loops during unrolling
 
+    if (failed(lowerStreamFifos(device)))
+      return signalPassFailure();
+
+    if (clBypassPassThroughLinks)
+      bypassPassThroughLinks(device);
+
+    if (clBalanceShimDMAs)
+      balanceShimDMAs(device);
+
+    if (clPlaceForSharedMemory)
+      placeForSharedMemory(device);
+
     //===------------------------------------------------------------------===//
     // Split objectFifos into a consumer end and producer end if needed
     //===------------------------------------------------------------------===//
@@ -1202,6 +1729,15 @@ struct AIEObjectFifoStatefulTransformPass
       if (int share_direction = 0; !requiresDMAs(createOp, share_direction))
         continue;
 
+      if (clDiagnoseDMAFifos && couldShareMemory(createOp)) {
+        TileOp producer = createOp.getProducerTileOp();
+        auto consumer = createOp.getConsumerTiles()[0].getDefiningOp<TileOp>();
+        createOp.emitWarning("uses DMAs because its producer tile (")
+            << producer.colIndex() << ", " << producer.rowIndex()
+            << ") and consumer tile (" << consumer.colIndex() << ", "
+            << consumer.rowIndex() << ") don't share memory";
+      }
+
       for (auto consumerTile : createOp.getConsumerTiles()) {
         auto consumerTileOp = dyn_cast<TileOp>(consumerTile.getDefiningOp());
 
@@ -1237,6 +1773,9 @@ struct AIEObjectFifoStatefulTransformPass
         ObjectFifoCreateOp consumerFifo = createObjectFifo(
             builder, datatype, consumerFifoName, consumerTile, consumerTile,
             consumerObjFifoSize, emptyDims, fromStreamDims);
+        // the consumer DMA decompresses what the producer DMA compressed
+        if (createOp.getCompression())
+          consumerFifo.setCompressionAttr(builder.getUnitAttr());
         replaceSplitFifo(createOp, consumerFifo, consumerTileOp);
 
         // identify external buffers that were registered to the consumer fifo
@@ -1351,7 +1890,8 @@ struct AIEObjectFifoStatefulTransformPass
     //===------------------------------------------------------------------===//
     // Unroll for loops
     //===------------------------------------------------------------------===//
-    unrollForLoops(device, builder, objectFifoTiles);
+    if (failed(unrollForLoops(device, builder, objectFifoTiles)))
+      return signalPassFailure();
 
     //===------------------------------------------------------------------===//
     // Replace ops
@@ -1360,6 +1900,8 @@ struct AIEObjectFifoStatefulTransformPass
       DenseMap<ObjectFifoAcquireOp, std::vector<BufferOp *>>
           subviews; // maps each "subview" to its buffer references (subviews
       // are created by AcquireOps)
+      DenseMap<ObjectFifoAcquireOp, std::vector<int>>
+          subviewIndices; // maps each "subview" to the indices of its buffers
       DenseMap<std::pair<ObjectFifoCreateOp, int>, std::vector<int>>
           acquiresPerFifo; // maps each objFifo to indices of buffers acquired
       // in latest subview of that objFifo (useful to
@@ -1529,6 +2071,16 @@ struct AIEObjectFifoStatefulTransformPass
         else
           numCreate = 0;
 
+        // When profiling, the acquires which take locks are bracketed by the
+        // two instruction events, timed by a performance counter of the core.
+        bool profiled = clProfile && numCreate > 0 &&
+                        (clProfileFifo.empty() || op.name() == clProfileFifo ||
+                         op.name() == clProfileFifo + "_cons");
+        if (profiled) {
+          builder.create<EventOp>(acquireOp.getLoc(), 0);
+          profiledFifos[core].insert(op.name().str());
+        }
+
         auto dev = op->getParentOfType<DeviceOp>();
         if (auto &targetArch = dev.getTargetModel();
             targetArch.getTargetArch() == AIEArch::AIE1)
@@ -1538,6 +2090,9 @@ struct AIEObjectFifoStatefulTransformPass
           createUseLocks(builder, op, port, acqPerFifo, numCreate,
                          LockAction::AcquireGreaterEqual);
 
+        if (profiled)
+          builder.create<EventOp>(acquireOp.getLoc(), 1);
+
         // if objFifo was linked with others, find which objFifos
         // elements to use
         ObjectFifoCreateOp target = op;
@@ -1556,6 +2111,7 @@ struct AIEObjectFifoStatefulTransformPass
           subviewRefs.push_back(&buffersPerFifo[target][index]);
 
         subviews[acquireOp] = subviewRefs;
+        subviewIndices[acquireOp] = acquiredIndices;
         acquiresPerFifo[{op, portNum}] = acquiredIndices;
       });
 
@@ -1570,6 +2126,14 @@ struct AIEObjectFifoStatefulTransformPass
                                 "ObjectFifoLinkOp");
           return;
         }
+        if (auto forLoop = dyn_cast<scf::ForOp>(acqOp->getParentOp());
+            forLoop && rotatedLoops.contains(forLoop)) {
+          builder.setInsertionPoint(accessOp);
+          accessOp.getOutput().replaceAllUsesWith(createRotatingAccess(
+              builder, forLoop, acqOp.getObjectFifo(), acqOp.getPort(),
+              subviewIndices[acqOp][accessOp.getIndex()]));
+          return;
+        }
         accessOp.getOutput().replaceAllUsesWith(
             subviews[acqOp][accessOp.getIndex()]->getBuffer());
       });
@@ -1602,6 +2166,59 @@ struct AIEObjectFifoStatefulTransformPass
     IRRewriter rewriter(&getContext());
     for (auto it = opsToErase.rbegin(); it != opsToErase.rend(); ++it)
       (*it)->erase();
+
+    if (clCoalesceLocks &&
+        device.getTargetModel().getTargetArch() != AIEArch::AIE1)
+      for (auto coreOp : device.getOps<CoreOp>())
+        coalesceUseLocks(coreOp);
+
+    if (clProfile && !clProfileMap.empty() && failed(writeProfileMap(device)))
+      return signalPassFailure();
+  }
+
+  /// Merge the semaphore use_lock operations directly following each other
+  /// in the blocks of coreOp which act on the same lock with the same
+  /// action, summing their values. Operations are never moved, so the order
+  /// of the acquires and releases of different locks is kept.
+  void coalesceUseLocks(CoreOp coreOp) {
+    coreOp.walk([&](Block *block) {
+      UseLockOp previous;
+      for (auto &op : llvm::make_early_inc_range(*block)) {
+        auto useLock = dyn_cast<UseLockOp>(op);
+        if (!useLock || useLock.acquire()) {
+          previous = useLock;
+          continue;
+        }
+        if (previous && previous.getLock() == useLock.getLock() &&
+            previous.getAction() == useLock.getAction() &&
+            previous.getBlocking() == useLock.getBlocking()) {
+          OpBuilder builder(previous);
+          previous.setValueAttr(builder.getI32IntegerAttr(
+              previous.getLockValue() + useLock.getLockValue()));
+          useLock.erase();
+          continue;
+        }
+        previous = useLock;
+      }
+    });
+  }
+
+  /// Write the mapping of the performance counters timing the acquires of
+  /// each core to the objectFifos acquired, one core per line:
+  ///   <col> <row> <counter> <objectFifo>[,<objectFifo>...]
+  LogicalResult writeProfileMap(DeviceOp device) {
+    std::string error;
+    auto output = openOutputFile(clProfileMap, &error);
+    if (!output)
+      return device.emitError(error);
+    for (auto &[core, fifos] : profiledFifos) {
+      TileOp tile = cast<CoreOp>(core).getTileOp();
+      output->os() << tile.colIndex() << " " << tile.rowIndex() << " "
+                   << profileCounter << " "
+                   << llvm::join(fifos.begin(), fifos.end(), ",") << "\n";
+    }
+    output->keep();
+    return success();
   }
 };
 
@@ -0,0 +1,333 @@
+//===- AIEObjectFifoTuneDepths.cpp ------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass chooses the depths of objectFifos from a static throughput model.
+//
+// Each endpoint of an objectFifo consumes or produces elements at some
+// period. On a core, this is the estimated number of cycles of the core
+// divided by the number of elements it releases; elsewhere elements are
+// moved by a DMA, at the rate of the transfer of an element. ObjectFifos
+// linked through a tile form a chain which runs at the period of its slowest
+// endpoint. An endpoint holding at most N elements at a time needs N more
+// elements to cover the time until the next one is ready: one in shared
+// memory, and enough to hide the latency of the transfer behind the period
+// of the chain when a DMA is involved. The depths are then reduced where
+// they don't fit in the memory of their tile.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/EquivalenceClasses.h"
+#include "llvm/ADT/MapVector.h"
+
+#include <cmath>
+
+#define DEBUG_TYPE "aie-objectFifo-tune-depths"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Return the number of iterations of a loop with constant bounds, or 1.
+static double getTripCount(Operation *op) {
+  auto forOp = dyn_cast<scf::ForOp>(op);
+  if (!forOp)
+    return 1;
+  auto lb = getConstantIntValue(forOp.getLowerBound());
+  auto ub = getConstantIntValue(forOp.getUpperBound());
+  auto step = getConstantIntValue(forOp.getStep());
+  if (!lb || !ub || !step || *step <= 0)
+    return 1;
+  return std::max<int64_t>(0, (*ub - *lb + *step - 1) / *step);
+}
+
+// Estimate the number of cycles taken by an operation: one for each nested
+// operation that isn't a constant, times the trip count of the loops around
+// it. An `aie.cycles` integer attribute, e.g. on the call of a kernel,
+// overrides the estimate.
+static double estimateCycles(Operation *op) {
+  if (auto cycles = op->getAttrOfType<IntegerAttr>("aie.cycles"))
+    return cycles.getInt();
+  if (op->getNumRegions() == 0)
+    return op->hasTrait<OpTrait::ConstantLike>() ? 0 : 1;
+  double cycles = 0;
+  for (Region &region : op->getRegions())
+    for (Block &block : region)
+      for (Operation &nested : block)
+        cycles += estimateCycles(&nested);
+  return cycles * getTripCount(op);
+}
+
+// Return the size in bytes of the elements of an objectFifo.
+static int64_t getElementSize(ObjectFifoCreateOp fifo) {
+  MemRefType type =
+      fifo.getElemType().cast<AIEObjectFifoType>().getElementType();
+  return type.getNumElements() * type.getElementTypeBitWidth() / 8;
+}
+
+// Return the core running on a tile, if any.
+static CoreOp getCore(TileOp tile) {
+  for (Operation *user : tile->getUsers())
+    if (auto core = dyn_cast<CoreOp>(user))
+      return core;
+  return nullptr;
+}
+
+// Return the number of cycles between two elements released by a core on the
+// given port of an objectFifo, or nothing if the core doesn't release any.
+static std::optional<double> getCorePeriod(CoreOp core,
+                                           ObjectFifoCreateOp fifo,
+                                           ObjectFifoPort port) {
+  double elements = 0;
+  core.walk([&](ObjectFifoReleaseOp release) {
+    if (release.getObjectFifo() != fifo || release.getPort() != port)
+      return;
+    double count = release.relNumber();
+    for (Operation *parent = release->getParentOp(); parent != core;
+         parent = parent->getParentOp())
+      count *= getTripCount(parent);
+    elements += count;
+  });
+  if (elements == 0)
+    return {};
+  return estimateCycles(core) / elements;
+}
+
+// Return the largest number of elements acquired at once by a core on the
+// given port of an objectFifo.
+static int getMaxAcquire(CoreOp core, ObjectFifoCreateOp fifo,
+                         ObjectFifoPort port) {
+  int maxAcquire = 0;
+  core.walk([&](ObjectFifoAcquireOp acquire) {
+    if (acquire.getObjectFifo() == fifo && acquire.getPort() == port)
+      maxAcquire = std::max(maxAcquire, acquire.acqNumber());
+  });
+  return maxAcquire;
+}
+
+// Return the tile whose memory holds the elements of an objectFifo lowered to
+// shared memory, or nothing if the objectFifo is lowered to DMAs.  This
+// mirrors requiresDMAs() in aie-objectFifo-stateful-transform.
+static std::optional<TileOp> getSharedMemoryTile(ObjectFifoCreateOp fifo) {
+  if (fifo.getConsumerTiles().size() != 1 ||
+      !fifo.getDimensionsToStream().empty() || fifo.getCompression())
+    return {};
+  for (BDDimLayoutArrayAttr dims : fifo.getDimensionsFromStreamPerConsumer())
+    if (!dims.empty())
+      return {};
+
+  TileOp producer = fifo.getProducerTileOp();
+  auto consumer = fifo.getConsumerTiles()[0].getDefiningOp<TileOp>();
+  if (producer.isShimTile() || consumer.isShimTile() ||
+      producer.isMemTile() != consumer.isMemTile())
+    return {};
+  const auto &targetModel = getTargetModel(fifo);
+  if (targetModel.isLegalMemAffinity(consumer.colIndex(), consumer.rowIndex(),
+                                     producer.colIndex(), producer.rowIndex()))
+    return producer;
+  if (targetModel.isLegalMemAffinity(producer.colIndex(), producer.rowIndex(),
+                                     consumer.colIndex(), consumer.rowIndex()))
+    return consumer;
+  return {};
+}
+
+namespace {
+// The elements of an objectFifo allocated on one of its endpoints: the
+// producer for index 0, or consumer index - 1.
+struct Endpoint {
+  ObjectFifoCreateOp fifo;
+  int index;
+  // The tile charged for the memory of the elements, if any.
+  TileOp tile;
+  int64_t elementSize;
+  int minDepth;
+  int depth;
+};
+} // namespace
+
+struct AIEObjectFifoTuneDepthsPass
+    : AIEObjectFifoTuneDepthsBase<AIEObjectFifoTuneDepthsPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    const auto &targetModel = device.getTargetModel();
+
+    if (clDMABytesPerCycle == 0) {
+      device.emitError("dma-bytes-per-cycle must be positive");
+      return signalPassFailure();
+    }
+
+    SmallVector<ObjectFifoCreateOp> fifos(device.getOps<ObjectFifoCreateOp>());
+
+    // ObjectFifos linked together form a chain. At the link point, the
+    // elements of one side of the link are shared by the other: record the
+    // endpoints which don't allocate their own.
+    llvm::EquivalenceClasses<Operation *> chains;
+    DenseSet<std::pair<Operation *, Operation *>> linkShared;
+    for (auto fifo : fifos)
+      chains.insert(fifo);
+    for (auto link : device.getOps<ObjectFifoLinkOp>()) {
+      for (auto in : link.getInputObjectFifos())
+        for (auto out : link.getOutputObjectFifos())
+          chains.unionSets(in, out);
+      Operation *linkTile = link.getOptionalSharedTile()->getDefiningOp();
+      if (link.isJoin())
+        for (auto in : link.getInputObjectFifos())
+          linkShared.insert({in, linkTile});
+      else
+        for (auto out : link.getOutputObjectFifos())
+          linkShared.insert({out, linkTile});
+    }
+
+    // Compute the period of each endpoint, and of each chain.
+    DenseMap<Operation *, double> transferCycles;
+    DenseMap<Operation *, double> chainPeriods;
+    for (auto fifo : fifos) {
+      double transfer =
+          std::ceil(double(getElementSize(fifo)) / clDMABytesPerCycle);
+      transferCycles[fifo] = transfer;
+
+      double period = getSharedMemoryTile(fifo) ? 1 : transfer;
+      auto endpointPeriod = [&](Value tile, ObjectFifoPort port) {
+        if (CoreOp core = getCore(tile.getDefiningOp<TileOp>()))
+          if (auto corePeriod = getCorePeriod(core, fifo, port))
+            period = std::max(period, *corePeriod);
+      };
+      endpointPeriod(fifo.getProducerTile(), ObjectFifoPort::Produce);
+      for (Value consumer : fifo.getConsumerTiles())
+        endpointPeriod(consumer, ObjectFifoPort::Consume);
+
+      Operation *leader = chains.getLeaderValue(fifo);
+      chainPeriods[leader] = std::max(chainPeriods[leader], period);
+    }
+
+    // Compute the depth of each endpoint.
+    std::vector<Endpoint> endpoints;
+    for (auto fifo : fifos) {
+      int64_t elementSize = getElementSize(fifo);
+      double period =
+          std::max(1.0, chainPeriods[chains.getLeaderValue(fifo)]);
+      // An endpoint whose depths were given explicitly keeps them.
+      bool fixed = isa<ArrayAttr>(fifo.getElemNumber()) || fifo.size() == 0;
+
+      auto acquired = [&](Value tile, ObjectFifoPort port) {
+        CoreOp core = getCore(tile.getDefiningOp<TileOp>());
+        int maxAcquire = core ? getMaxAcquire(core, fifo, port) : 0;
+        // A DMA holds a single element at a time.
+        return maxAcquire > 0 ? maxAcquire : 1;
+      };
+
+      if (auto sharedTile = getSharedMemoryTile(fifo)) {
+        int produced =
+            acquired(fifo.getProducerTile(), ObjectFifoPort::Produce);
+        int consumed =
+            acquired(fifo.getConsumerTiles()[0], ObjectFifoPort::Consume);
+        int depth = fixed ? fifo.size() : produced + consumed;
+        endpoints.push_back({fifo, 0, *sharedTile, elementSize,
+                             fixed ? depth : std::max(produced, consumed),
+                             depth});
+        continue;
+      }
+
+      double latency = transferCycles[fifo] + clDMALatency;
+      int extra = std::max(1, int(std::ceil(latency / period)));
+      SmallVector<Value> tiles = {fifo.getProducerTile()};
+      tiles.append(fifo.getConsumerTiles().begin(),
+                   fifo.getConsumerTiles().end());
+      for (auto [index, tile] : llvm::enumerate(tiles)) {
+        auto tileOp = tile.getDefiningOp<TileOp>();
+        int held = acquired(tile, index == 0 ? ObjectFifoPort::Produce
+                                             : ObjectFifoPort::Consume);
+        int depth = fixed ? fifo.size(index) : held + extra;
+        // Shim tiles use external memory, and the two sides of a link share
+        // their elements.
+        bool charged =
+            !tileOp.isShimTile() && !linkShared.contains({fifo, tileOp});
+        endpoints.push_back({fifo, int(index), charged ? tileOp : TileOp(),
+                             elementSize, fixed ? depth : held, depth});
+      }
+    }
+
+    // Reduce the depths where the elements don't fit in the memory of their
+    // tile, taking an element from the largest ones first.
+    llvm::MapVector<Operation *, int64_t> usedMemory;
+    for (auto &endpoint : endpoints)
+      if (endpoint.tile)
+        usedMemory[endpoint.tile] += endpoint.depth * endpoint.elementSize;
+    for (auto &[tileOp, used] : usedMemory) {
+      auto tile = cast<TileOp>(tileOp);
+      int64_t available = tile.isMemTile()
+                              ? targetModel.getMemTileSize()
+                              : targetModel.getLocalMemorySize();
+      if (CoreOp core = getCore(tile))
+        used += core.getStackSize();
+      device.walk([&](BufferOp buffer) {
+        if (buffer.getTileOp() == tile)
+          used += buffer.getAllocationSize();
+      });
+
+      while (used > available) {
+        Endpoint *largest = nullptr;
+        for (auto &endpoint : endpoints)
+          if (endpoint.tile == tile && endpoint.depth > endpoint.minDepth &&
+              (!largest || endpoint.elementSize > largest->elementSize))
+            largest = &endpoint;
+        if (!largest) {
+          tile.emitWarning("objectFifo elements don't fit in the memory of "
+                           "the tile, even at their minimum depths");
+          break;
+        }
+        largest->depth--;
+        used -= largest->elementSize;
+      }
+    }
+
+    OpBuilder builder(device.getContext());
+    for (auto fifo : fifos) {
+      SmallVector<int> depths;
+      for (auto &endpoint : endpoints)
+        if (endpoint.fifo == fifo)
+          depths.push_back(endpoint.depth);
+      double period = chainPeriods[chains.getLeaderValue(fifo)];
+      LLVM_DEBUG(llvm::dbgs() << fifo.name() << ": period " << period
+                              << " cycles\n");
+
+      if (!clApply) {
+        std::string list;
+        llvm::raw_string_ostream os(list);
+        if (depths.size() > 1)
+          os << "[";
+        llvm::interleaveComma(depths, os);
+        if (depths.size() > 1)
+          os << "]";
+        fifo.emitRemark("suggested depth ")
+            << os.str() << " for an estimated period of "
+            << int64_t(std::ceil(period)) << " cycles";
+        continue;
+      }
+      if (depths.size() == 1) {
+        fifo.setElemNumberAttr(builder.getI32IntegerAttr(depths[0]));
+        continue;
+      }
+      SmallVector<Attribute> attrs;
+      for (int depth : depths)
+        attrs.push_back(builder.getI64IntegerAttr(depth));
+      fifo.setElemNumberAttr(builder.getArrayAttr(attrs));
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIEObjectFifoTuneDepthsPass() {
+  return std::make_unique<AIEObjectFifoTuneDepthsPass>();
+}
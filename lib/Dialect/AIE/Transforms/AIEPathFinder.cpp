@@ -11,9 +11,20 @@
 #include "aie/Dialect/AIE/Transforms/AIEPathFinder.h"
 #include "d_ary_heap.h"
 
+#include "mlir/IR/Threading.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
 #include "llvm/Support/raw_os_ostream.h"
 
+#include <numeric>
+#include <queue>
+
 using namespace mlir;
 using namespace xilinx;
 using namespace xilinx::AIE;
@@ -22,6 +33,118 @@ using namespace xilinx::AIE;
 #define OVER_CAPACITY_COEFF 0.02
 #define USED_CAPACITY_COEFF 0.02
 #define DEMAND_COEFF 1.1
+#define BANDWIDTH_COEFF 1.0
+#define NEW_PACKET_CONNECTION_COST 1.0
+#define MAX_PACKET_IDS_PER_PORT 32
+
+static std::string portToString(WireBundle bundle, int channel) {
+  return (stringifyWireBundle(bundle) + ":" + Twine(channel)).str();
+}
+
+static llvm::json::Array portToJSON(Port port) {
+  return {stringifyWireBundle(port.bundle), port.channel};
+}
+
+static std::optional<Port> portFromJSON(const llvm::json::Value *value) {
+  const llvm::json::Array *array = value ? value->getAsArray() : nullptr;
+  if (!array || array->size() != 2)
+    return std::nullopt;
+  std::optional<StringRef> bundle = (*array)[0].getAsString();
+  std::optional<int64_t> channel = (*array)[1].getAsInteger();
+  if (!bundle || !channel)
+    return std::nullopt;
+  std::optional<WireBundle> wireBundle = symbolizeWireBundle(*bundle);
+  if (!wireBundle)
+    return std::nullopt;
+  return Port{*wireBundle, static_cast<int>(*channel)};
+}
+
+// Read the routing solution cached for the given problem, if any. The file
+// also holds the whole description of the problem, so that a collision of
+// the hashes can't return the solution of another problem.
+static std::optional<std::map<PathEndPoint, SwitchSettings>>
+readCachedRouting(StringRef path, StringRef problem) {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer)
+    return std::nullopt;
+  auto json = llvm::json::parse((*buffer)->getBuffer());
+  if (!json) {
+    llvm::consumeError(json.takeError());
+    return std::nullopt;
+  }
+  const llvm::json::Object *root = json->getAsObject();
+  if (!root || root->getString("problem") != problem)
+    return std::nullopt;
+  const llvm::json::Array *flows = root->getArray("flows");
+  if (!flows)
+    return std::nullopt;
+
+  std::map<PathEndPoint, SwitchSettings> solution;
+  for (const llvm::json::Value &flow : *flows) {
+    const llvm::json::Object *flowObject = flow.getAsObject();
+    if (!flowObject)
+      return std::nullopt;
+    std::optional<int64_t> col = flowObject->getInteger("col");
+    std::optional<int64_t> row = flowObject->getInteger("row");
+    std::optional<Port> port = portFromJSON(flowObject->get("port"));
+    const llvm::json::Array *settings = flowObject->getArray("settings");
+    if (!col || !row || !port || !settings)
+      return std::nullopt;
+    SwitchSettings &switchSettings =
+        solution[{Switchbox(*col, *row), *port}];
+    for (const llvm::json::Value &setting : *settings) {
+      const llvm::json::Object *settingObject = setting.getAsObject();
+      if (!settingObject)
+        return std::nullopt;
+      std::optional<int64_t> sbCol = settingObject->getInteger("col");
+      std::optional<int64_t> sbRow = settingObject->getInteger("row");
+      std::optional<Port> src = portFromJSON(settingObject->get("src"));
+      const llvm::json::Array *dsts = settingObject->getArray("dsts");
+      if (!sbCol || !sbRow || !src || !dsts)
+        return std::nullopt;
+      SwitchSetting &switchSetting = switchSettings[Switchbox(*sbCol, *sbRow)];
+      switchSetting.src = *src;
+      for (const llvm::json::Value &dst : *dsts) {
+        std::optional<Port> dstPort = portFromJSON(&dst);
+        if (!dstPort)
+          return std::nullopt;
+        switchSetting.dsts.insert(*dstPort);
+      }
+    }
+  }
+  return solution;
+}
+
+static LogicalResult
+writeCachedRouting(StringRef path, StringRef problem,
+                   const std::map<PathEndPoint, SwitchSettings> &solution) {
+  llvm::json::Array flows;
+  for (const auto &[endPoint, switchSettings] : solution) {
+    llvm::json::Array settings;
+    for (const auto &[sb, setting] : switchSettings) {
+      llvm::json::Array dsts;
+      for (Port dst : setting.dsts)
+        dsts.push_back(portToJSON(dst));
+      settings.push_back(llvm::json::Object{{"col", sb.col},
+                                            {"row", sb.row},
+                                            {"src", portToJSON(setting.src)},
+                                            {"dsts", std::move(dsts)}});
+    }
+    flows.push_back(llvm::json::Object{{"col", endPoint.sb.col},
+                                       {"row", endPoint.sb.row},
+                                       {"port", portToJSON(endPoint.port)},
+                                       {"settings", std::move(settings)}});
+  }
+  llvm::json::Value root =
+      llvm::json::Object{{"problem", problem}, {"flows", std::move(flows)}};
+  // writeToOutput renames a temporary file, so that concurrent compilations
+  // never read a partial solution.
+  return success(!llvm::errorToBool(
+      llvm::writeToOutput(path, [&](raw_ostream &os) {
+        os << llvm::formatv("{0:2}", root);
+        return llvm::Error::success();
+      })));
+}
 
 LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
   LLVM_DEBUG(llvm::dbgs() << "\t---Begin DynamicTileAnalysis Constructor---\n");
@@ -35,6 +158,17 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
 
   pathfinder->initialize(maxCol, maxRow, device.getTargetModel());
 
+  // The description of the routing problem, which keys the cached solutions.
+  std::string problem;
+  llvm::raw_string_ostream problemStream(problem);
+  problemStream << stringifyAIEDevice(device.getDevice());
+  if (auto geometry = device.getGeometryAttr())
+    problemStream << ' ' << geometry;
+  problemStream << '\n' << routerDescription << '\n';
+  for (TileOp tileOp : device.getOps<TileOp>())
+    problemStream << "tile " << tileOp.colIndex() << ' ' << tileOp.rowIndex()
+                  << '\n';
+
   // for each flow in the device, add it to pathfinder
   // each source can map to multiple different destinations (fanout)
   for (FlowOp flowOp : device.getOps<FlowOp>()) {
@@ -44,31 +178,83 @@ LogicalResult DynamicTileAnalysis::runAnalysis(DeviceOp &device) {
     TileID dstCoords = {dstTile.colIndex(), dstTile.rowIndex()};
     Port srcPort = {flowOp.getSourceBundle(), flowOp.getSourceChannel()};
     Port dstPort = {flowOp.getDestBundle(), flowOp.getDestChannel()};
+    double bandwidth = flowOp.getBandwidth().value_or(0);
+    problemStream << "flow " << srcCoords << ' '
+                  << portToString(srcPort.bundle, srcPort.channel) << ' '
+                  << dstCoords << ' '
+                  << portToString(dstPort.bundle, dstPort.channel) << ' '
+                  << bandwidth << '\n';
     LLVM_DEBUG(llvm::dbgs()
                << "\tAdding Flow: (" << srcCoords.col << ", " << srcCoords.row
                << ")" << stringifyWireBundle(srcPort.bundle) << srcPort.channel
                << " -> (" << dstCoords.col << ", " << dstCoords.row << ")"
                << stringifyWireBundle(dstPort.bundle) << dstPort.channel
                << "\n");
-    pathfinder->addFlow(srcCoords, srcPort, dstCoords, dstPort);
+    pathfinder->addFlow(srcCoords, srcPort, dstCoords, dstPort, bandwidth);
   }
 
   // add existing connections so Pathfinder knows which resources are
   // available search all existing SwitchBoxOps for exising connections
   for (SwitchboxOp switchboxOp : device.getOps<SwitchboxOp>()) {
+    TileID tile = switchboxOp.getTileID();
     for (ConnectOp connectOp : switchboxOp.getOps<ConnectOp>()) {
       if (!pathfinder->addFixedConnection(connectOp))
         return switchboxOp.emitOpError() << "Couldn't connect " << connectOp;
+      problemStream << "connect " << tile << ' '
+                    << portToString(connectOp.getSourceBundle(),
+                                    connectOp.getSourceChannel())
+                    << ' '
+                    << portToString(connectOp.getDestBundle(),
+                                    connectOp.getDestChannel())
+                    << '\n';
     }
+    // packet-switched routes created earlier occupy their ports as well
+    for (MasterSetOp masterSetOp : switchboxOp.getOps<MasterSetOp>()) {
+      pathfinder->addFixedPacketConnection(masterSetOp);
+      problemStream << "masterset " << tile << ' '
+                    << portToString(masterSetOp.getDestBundle(),
+                                    masterSetOp.getDestChannel())
+                    << '\n';
+    }
+    for (PacketRulesOp packetRulesOp : switchboxOp.getOps<PacketRulesOp>()) {
+      pathfinder->addFixedPacketConnection(packetRulesOp);
+      problemStream << "packet_rules " << tile << ' '
+                    << portToString(packetRulesOp.getSourceBundle(),
+                                    packetRulesOp.getSourceChannel())
+                    << '\n';
+    }
+  }
+
+  problemStream.flush();
+
+  SmallString<128> cacheFile;
+  std::optional<std::map<PathEndPoint, SwitchSettings>> cached;
+  if (!cacheDir.empty()) {
+    cacheFile = cacheDir;
+    llvm::sys::path::append(
+        cacheFile,
+        llvm::toHex(llvm::SHA256::hash(llvm::arrayRefFromStringRef(problem)),
+                    /*LowerCase=*/true) +
+            ".json");
+    cached = readCachedRouting(cacheFile, problem);
   }
 
-  // all flows are now populated, call the congestion-aware pathfinder
-  // algorithm
-  // check whether the pathfinder algorithm creates a legal routing
-  if (auto maybeFlowSolutions = pathfinder->findPaths(maxIterations))
-    flowSolutions = maybeFlowSolutions.value();
-  else
-    return device.emitError("Unable to find a legal routing");
+  if (cached) {
+    LLVM_DEBUG(llvm::dbgs() << "Reusing the routing in " << cacheFile << "\n");
+    flowSolutions = std::move(*cached);
+  } else {
+    // all flows are now populated, call the congestion-aware pathfinder
+    // algorithm
+    // check whether the pathfinder algorithm creates a legal routing
+    if (auto maybeFlowSolutions = pathfinder->findPaths(maxIterations))
+      flowSolutions = maybeFlowSolutions.value();
+    else
+      return device.emitError("Unable to find a legal routing");
+    if (!cacheDir.empty() &&
+        (llvm::sys::fs::create_directories(cacheDir) ||
+         failed(writeCachedRouting(cacheFile, problem, flowSolutions))))
+      device.emitWarning("could not write the routing cache ") << cacheFile;
+  }
 
   // initialize all flows as unprocessed to prep for rewrite
   for (const auto &[pathEndPoint, switchSetting] : flowSolutions) {
@@ -198,14 +384,34 @@ void Pathfinder::initialize(int maxCol, int maxRow,
       }
     }
   }
+
+  csr.nodes.assign(id, nullptr);
+  for (auto &[coords, sb] : grid)
+    csr.nodes[sb.id] = &sb;
+  csr.offsets = {0};
+  csr.targets.clear();
+  csr.channels.clear();
+  for (SwitchboxNode *sb : csr.nodes) {
+    size_t begin = csr.channels.size();
+    csr.channels.insert(csr.channels.end(), sb->getEdges().begin(),
+                        sb->getEdges().end());
+    std::sort(csr.channels.begin() + begin, csr.channels.end(),
+              [](const ChannelEdge *c1, const ChannelEdge *c2) {
+                return c1->getTargetNode().id < c2->getTargetNode().id;
+              });
+    for (size_t e = begin; e < csr.channels.size(); e++)
+      csr.targets.push_back(csr.channels[e]->getTargetNode().id);
+    csr.offsets.push_back(csr.channels.size());
+  }
 }
 
 // Add a flow from src to dst can have an arbitrary number of dst locations due
-// to fanout.
+// to fanout. All destinations of a fanout share the stream, so the bandwidth
+// of the flow is the largest bandwidth requested for any of them.
 void Pathfinder::addFlow(TileID srcCoords, Port srcPort, TileID dstCoords,
-                         Port dstPort) {
+                         Port dstPort, double bandwidth) {
   // check if a flow with this source already exists
-  for (auto &[src, dsts] : flows) {
+  for (auto &[src, dsts, flowBandwidth] : flows) {
     SwitchboxNode *existingSrc = src.sb;
     assert(existingSrc && "nullptr flow source");
     if (Port existingPort = src.port; existingSrc->col == srcCoords.col &&
@@ -218,6 +424,7 @@ void Pathfinder::addFlow(TileID srcCoords, Port srcPort, TileID dstCoords,
           });
       assert(matchingSb != graph.end() && "didn't find flow dest");
       dsts.emplace_back(*matchingSb, dstPort);
+      flowBandwidth = std::max(flowBandwidth, bandwidth);
       return;
     }
   }
@@ -234,7 +441,8 @@ void Pathfinder::addFlow(TileID srcCoords, Port srcPort, TileID dstCoords,
       });
   assert(matchingDstSb != graph.end() && "didn't add flow destinations");
   flows.push_back({PathEndPointNode{*matchingSrcSb, srcPort},
-                   std::vector<PathEndPointNode>{{*matchingDstSb, dstPort}}});
+                   std::vector<PathEndPointNode>{{*matchingDstSb, dstPort}},
+                   bandwidth});
 }
 
 // Keep track of connections already used in the AIE; Pathfinder algorithm will
@@ -273,64 +481,324 @@ bool Pathfinder::addFixedConnection(ConnectOp connectOp) {
   return false;
 }
 
+// The master port of a masterset drives the outgoing channel on its bundle.
+void Pathfinder::addFixedPacketConnection(MasterSetOp masterSetOp) {
+  auto sb = masterSetOp->getParentOfType<SwitchboxOp>();
+  if (sb.getTileOp().isShimNOCTile())
+    return;
+
+  TileID sbTile = sb.getTileID();
+  WireBundle destBundle = masterSetOp.getDestBundle();
+  auto matchingCh =
+      std::find_if(edges.begin(), edges.end(), [&](ChannelEdge &ch) {
+        return static_cast<TileID>(ch.src) == sbTile && ch.bundle == destBundle;
+      });
+  if (matchingCh != edges.end())
+    matchingCh->fixedCapacity.insert(masterSetOp.getDestChannel());
+}
+
+// The slave port of a packet_rules is fed by the incoming channel on its
+// bundle.
+void Pathfinder::addFixedPacketConnection(PacketRulesOp packetRulesOp) {
+  auto sb = packetRulesOp->getParentOfType<SwitchboxOp>();
+  if (!sb || sb.getTileOp().isShimNOCTile())
+    return;
+
+  TileID sbTile = sb.getTileID();
+  WireBundle sourceBundle = packetRulesOp.getSourceBundle();
+  auto matchingCh =
+      std::find_if(edges.begin(), edges.end(), [&](ChannelEdge &ch) {
+        return static_cast<TileID>(ch.target) == sbTile &&
+               ch.bundle == getConnectingBundle(sourceBundle);
+      });
+  if (matchingCh != edges.end())
+    matchingCh->fixedCapacity.insert(packetRulesOp.getSourceChannel());
+}
+
 static constexpr double INF = std::numeric_limits<double>::max();
 
-std::map<SwitchboxNode *, SwitchboxNode *>
-dijkstraShortestPaths(const SwitchboxGraph &graph, SwitchboxNode *src) {
-  // Use std::map instead of DenseMap because DenseMap doesn't let you overwrite
-  // tombstones.
-  auto distance = std::map<SwitchboxNode *, double>();
-  auto preds = std::map<SwitchboxNode *, SwitchboxNode *>();
-  std::map<SwitchboxNode *, uint64_t> indexInHeap;
+// Compute the routing cost of a channel from its congestion history and its
+// current usage. In bandwidth-aware mode the estimated utilisation of the
+// channel, relative to the combined throughput of its connections, is added
+// on top of the connection count.
+static double channelDemand(const ChannelEdge &ch,
+                            const PathfinderOptions &options) {
+  if (ch.fixedCapacity.size() >=
+      static_cast<std::set<int>::size_type>(ch.maxCapacity))
+    return INF;
+  double history = 1.0 + OVER_CAPACITY_COEFF * ch.overCapacityCount;
+  double congestion = 1.0 + USED_CAPACITY_COEFF * ch.usedCapacity;
+  if (options.bandwidthAware)
+    congestion += BANDWIDTH_COEFF * ch.bandwidthUsage /
+                  (ch.maxCapacity * options.linkBandwidth);
+  return history * congestion;
+}
+
+// Account for a flow being routed over a channel, bumping the demand of the
+// channel to discourage further flows from using it.
+static void useChannel(ChannelEdge &ch, const FlowNode &flow,
+                       const PathfinderOptions &options) {
+  ch.bandwidthUsage += flow.bandwidth;
+  if (options.bandwidthAware && flow.bandwidth > 0)
+    ch.demand *= 1.0 + BANDWIDTH_COEFF * flow.bandwidth /
+                           (ch.maxCapacity * options.linkBandwidth);
+}
+
+// Find the shortest paths from src, with the demand of the channels as
+// weights. Returns the incoming channel of every switchbox on the
+// shortest-path tree, indexed by switchbox id, and nullptr for the source and
+// the unreachable switchboxes.
+static std::vector<ChannelEdge *>
+dijkstraShortestPaths(const SwitchboxCSR &csr, const SwitchboxNode *src) {
+  size_t numNodes = csr.nodes.size();
+  std::vector<double> distance(numNodes, INF);
+  std::vector<ChannelEdge *> preds(numNodes, nullptr);
+  std::vector<uint64_t> indexInHeap(numNodes, -1);
   typedef d_ary_heap_indirect<
-      /*Value=*/SwitchboxNode *, /*Arity=*/4,
-      /*IndexInHeapPropertyMap=*/std::map<SwitchboxNode *, uint64_t>,
-      /*DistanceMap=*/std::map<SwitchboxNode *, double> &,
+      /*Value=*/int, /*Arity=*/4,
+      /*IndexInHeapPropertyMap=*/std::vector<uint64_t> &,
+      /*DistanceMap=*/std::vector<double> &,
       /*Compare=*/std::less<>>
       MutableQueue;
   MutableQueue Q(distance, indexInHeap);
 
-  for (SwitchboxNode *sb : graph)
-    distance.emplace(sb, INF);
-  distance[src] = 0.0;
+  distance[src->id] = 0.0;
 
-  std::map<SwitchboxNode *, std::vector<ChannelEdge *>> edges;
+  enum Color : uint8_t { WHITE, GRAY, BLACK };
+  std::vector<Color> colors(numNodes, WHITE);
 
-  enum Color { WHITE, GRAY, BLACK };
-  std::map<SwitchboxNode *, Color> colors;
-  for (SwitchboxNode *sb : graph) {
-    colors[sb] = WHITE;
-    edges[sb] = {sb->getEdges().begin(), sb->getEdges().end()};
-    std::sort(edges[sb].begin(), edges[sb].end(),
-              [](const ChannelEdge *c1, ChannelEdge *c2) {
-                return c1->getTargetNode().id < c2->getTargetNode().id;
-              });
-  }
-
-  Q.push(src);
+  Q.push(src->id);
   while (!Q.empty()) {
-    src = Q.top();
+    int node = Q.top();
     Q.pop();
-    for (ChannelEdge *e : edges[src]) {
-      SwitchboxNode *dest = &e->getTargetNode();
-      bool relax = distance[src] + e->demand < distance[dest];
+    for (size_t e = csr.offsets[node]; e < csr.offsets[node + 1]; e++) {
+      int dest = csr.targets[e];
+      double newDistance = distance[node] + csr.channels[e]->demand;
+      bool relax = newDistance < distance[dest];
       if (colors[dest] == WHITE) {
         if (relax) {
-          distance[dest] = distance[src] + e->demand;
-          preds[dest] = src;
+          distance[dest] = newDistance;
+          preds[dest] = csr.channels[e];
           colors[dest] = GRAY;
         }
         Q.push(dest);
       } else if (colors[dest] == GRAY && relax) {
-        distance[dest] = distance[src] + e->demand;
-        preds[dest] = src;
+        distance[dest] = newDistance;
+        preds[dest] = csr.channels[e];
       }
     }
-    colors[src] = BLACK;
+    colors[node] = BLACK;
   }
   return preds;
 }
 
+// The incoming channel of every switchbox on the routing tree of a flow,
+// ordered by switchbox id rather than by address, so that the channels of a
+// tree are visited in the same order from run to run.
+namespace {
+struct SwitchboxNodeIdLess {
+  bool operator()(const SwitchboxNode *a, const SwitchboxNode *b) const {
+    return a->id < b->id;
+  }
+};
+} // namespace
+using RoutingTree =
+    std::map<SwitchboxNode *, ChannelEdge *, SwitchboxNodeIdLess>;
+
+// Connect every destination of a flow to its routing tree with an A* search
+// over the switchbox grid. The search for each destination starts from all
+// switchboxes already on the tree, so that fanout shares channels. Channel
+// demand is never below 1.0 and every channel joins grid neighbours, so the
+// Manhattan distance to the destination is an admissible heuristic.
+// Returns the incoming channel of every switchbox on the tree other than the
+// source, or std::nullopt if a destination is unreachable.
+static std::optional<RoutingTree> aStarRouteFlow(const SwitchboxCSR &csr,
+                                                 const FlowNode &flow) {
+  RoutingTree tree;
+  std::set<SwitchboxNode *> onTree = {flow.src.sb};
+  for (const PathEndPointNode &endPoint : flow.dsts) {
+    SwitchboxNode *target = endPoint.sb;
+    if (onTree.count(target))
+      continue;
+    auto heuristic = [&](const SwitchboxNode *sb) {
+      return static_cast<double>(std::abs(sb->col - target->col) +
+                                 std::abs(sb->row - target->row));
+    };
+
+    std::vector<double> cost(csr.nodes.size(), INF);
+    std::vector<ChannelEdge *> preds(csr.nodes.size(), nullptr);
+    // Ordered by estimated total cost; ties are broken by node id so that the
+    // result is deterministic.
+    using QueueEntry = std::tuple<double, int, SwitchboxNode *>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<>>
+        open;
+    for (SwitchboxNode *sb : onTree) {
+      cost[sb->id] = 0.0;
+      open.emplace(heuristic(sb), sb->id, sb);
+    }
+
+    bool found = false;
+    while (!open.empty()) {
+      auto [estimate, id, sb] = open.top();
+      open.pop();
+      if (sb == target) {
+        found = true;
+        break;
+      }
+      double sbCost = cost[sb->id];
+      // Skip entries superseded by a cheaper path.
+      if (estimate > sbCost + heuristic(sb))
+        continue;
+      for (ChannelEdge *e : sb->getEdges()) {
+        if (e->demand >= INF)
+          continue;
+        SwitchboxNode *next = &e->getTargetNode();
+        double nextCost = sbCost + e->demand;
+        if (cost[next->id] <= nextCost)
+          continue;
+        cost[next->id] = nextCost;
+        preds[next->id] = e;
+        open.emplace(nextCost + heuristic(next), next->id, next);
+      }
+    }
+    if (!found)
+      return std::nullopt;
+
+    for (SwitchboxNode *curr = target; !onTree.count(curr);
+         curr = &preds[curr->id]->src) {
+      tree[curr] = preds[curr->id];
+      onTree.insert(curr);
+    }
+  }
+  return tree;
+}
+
+// Negotiated-congestion routing which, after routing all flows once, only rips
+// up and reroutes the flows crossing an overused channel.  Channels are counted
+// as overused when the flows using them together with the fixed connections
+// exceed their capacity.  Channel indices are assigned once a legal routing is
+// found, in flow order, exactly as in the full rip-up mode.
+std::optional<std::map<PathEndPoint, SwitchSettings>>
+Pathfinder::findPathsIncremental(const int maxIterations) {
+  LLVM_DEBUG(llvm::dbgs() << "Begin Pathfinder::findPathsIncremental\n");
+  std::vector<RoutingTree> trees(flows.size());
+  std::vector<size_t> toRoute(flows.size());
+  std::iota(toRoute.begin(), toRoute.end(), 0);
+
+  for (auto &ch : edges) {
+    ch.overCapacityCount = 0;
+    ch.usedCapacity = 0;
+    ch.bandwidthUsage = 0.0;
+  }
+
+  auto isOverused = [](const ChannelEdge &ch) {
+    return ch.usedCapacity + static_cast<int>(ch.fixedCapacity.size()) >
+           ch.maxCapacity;
+  };
+
+  int iterationCount = 0;
+  int searchCount = 0;
+  while (!toRoute.empty()) {
+    if (++iterationCount > maxIterations) {
+      LLVM_DEBUG(llvm::dbgs()
+                 << "Pathfinder: maxIterations has been exceeded ("
+                 << maxIterations
+                 << " iterations)...unable to find routing for flows.\n");
+      return std::nullopt;
+    }
+    LLVM_DEBUG(llvm::dbgs() << "Begin findPathsIncremental iteration #"
+                            << iterationCount << ", rerouting "
+                            << toRoute.size() << " flows\n");
+
+    // rip up the flows to reroute
+    for (size_t i : toRoute) {
+      for (auto &[sb, ch] : trees[i]) {
+        ch->usedCapacity--;
+        ch->bandwidthUsage -= flows[i].bandwidth;
+      }
+      trees[i].clear();
+    }
+
+    // update demand on all channels from the flows that remain in place
+    for (auto &ch : edges)
+      ch.demand = channelDemand(ch, options);
+
+    std::vector<std::optional<RoutingTree>> newTrees;
+    if (options.parallel) {
+      newTrees.resize(toRoute.size());
+      mlir::parallelFor(options.context, 0, toRoute.size(), [&](size_t j) {
+        newTrees[j] = aStarRouteFlow(csr, flows[toRoute[j]]);
+      });
+    }
+
+    for (auto [j, i] : llvm::enumerate(toRoute)) {
+      auto tree = options.parallel ? std::move(newTrees[j])
+                                   : aStarRouteFlow(csr, flows[i]);
+      searchCount += flows[i].dsts.size();
+      if (!tree) {
+        LLVM_DEBUG(llvm::dbgs() << "Pathfinder: no path for flow from "
+                                << flows[i].src << "\n");
+        return std::nullopt;
+      }
+      trees[i] = std::move(*tree);
+      for (auto &[sb, ch] : trees[i]) {
+        ch->usedCapacity++;
+        // if at capacity, bump demand to discourage using this Channel
+        if (ch->usedCapacity + static_cast<int>(ch->fixedCapacity.size()) >=
+            ch->maxCapacity)
+          ch->demand *= DEMAND_COEFF;
+        useChannel(*ch, flows[i], options);
+      }
+    }
+
+    // collect the flows crossing an overused channel
+    std::set<ChannelEdge *> overused;
+    for (auto &ch : edges) {
+      if (isOverused(ch)) {
+        ch.overCapacityCount++;
+        overused.insert(&ch);
+      }
+    }
+    toRoute.clear();
+    for (size_t i = 0; i < flows.size(); i++)
+      if (llvm::any_of(trees[i], [&](const auto &entry) {
+            return overused.count(entry.second);
+          }))
+        toRoute.push_back(i);
+  }
+  LLVM_DEBUG(llvm::dbgs() << "Pathfinder: legal routing after "
+                          << iterationCount << " iterations and "
+                          << searchCount << " searches\n");
+
+  // assign channel indices along the routing trees, skipping fixed channels
+  std::map<PathEndPoint, SwitchSettings> routingSolution;
+  for (auto &ch : edges)
+    ch.usedCapacity = 0;
+  for (size_t i = 0; i < flows.size(); i++) {
+    const auto &[src, dsts, bandwidth] = flows[i];
+    SwitchSettings switchSettings;
+    switchSettings[*src.sb].src = src.port;
+    std::set<SwitchboxNode *> processed = {src.sb};
+    for (const PathEndPointNode &endPoint : dsts) {
+      SwitchboxNode *curr = endPoint.sb;
+      switchSettings[*curr].dsts.insert(endPoint.port);
+      while (!processed.count(curr)) {
+        ChannelEdge *ch = trees[i].at(curr);
+        while (ch->fixedCapacity.count(ch->usedCapacity))
+          ch->usedCapacity++;
+        switchSettings[*curr].src = {getConnectingBundle(ch->bundle),
+                                     ch->usedCapacity};
+        switchSettings[ch->src].dsts.insert({ch->bundle, ch->usedCapacity});
+        ch->usedCapacity++;
+        processed.insert(curr);
+        curr = &ch->src;
+      }
+    }
+    routingSolution[src] = switchSettings;
+  }
+  return routingSolution;
+}
+
 // Perform congestion-aware routing for all flows which have been added.
 // Use Dijkstra's shortest path to find routes, and use "demand" as the weights.
 // If the routing finds too much congestion, update the demand weights
@@ -339,6 +807,11 @@ dijkstraShortestPaths(const SwitchboxGraph &graph, SwitchboxNode *src) {
 // If no legal routing can be found after maxIterations, returns empty vector.
 std::optional<std::map<PathEndPoint, SwitchSettings>>
 Pathfinder::findPaths(const int maxIterations) {
+  assert((!options.parallel || options.context) &&
+         "parallel routing requires a context");
+  if (options.incremental)
+    return findPathsIncremental(maxIterations);
+
   LLVM_DEBUG(llvm::dbgs() << "Begin Pathfinder::findPaths\n");
   int iterationCount = 0;
   std::map<PathEndPoint, SwitchSettings> routingSolution;
@@ -372,16 +845,8 @@ Pathfinder::findPaths(const int maxIterations) {
     LLVM_DEBUG(llvm::dbgs()
                << "Begin findPaths iteration #" << iterationCount << "\n");
     // update demand on all channels
-    for (auto &ch : edges) {
-      if (ch.fixedCapacity.size() >=
-          static_cast<std::set<int>::size_type>(ch.maxCapacity)) {
-        ch.demand = INF;
-      } else {
-        double history = 1.0 + OVER_CAPACITY_COEFF * ch.overCapacityCount;
-        double congestion = 1.0 + USED_CAPACITY_COEFF * ch.usedCapacity;
-        ch.demand = history * congestion;
-      }
-    }
+    for (auto &ch : edges)
+      ch.demand = channelDemand(ch, options);
     // if reach maxIterations, throw an error since no routing can be found
     if (++iterationCount > maxIterations) {
       LLVM_DEBUG(llvm::dbgs()
@@ -393,20 +858,33 @@ Pathfinder::findPaths(const int maxIterations) {
 
     // "rip up" all routes, i.e. set used capacity in each Channel to 0
     routingSolution.clear();
-    for (auto &ch : edges)
+    for (auto &ch : edges) {
       ch.usedCapacity = 0;
+      ch.bandwidthUsage = 0.0;
+    }
+
+    // in parallel mode, search from all sources against the current demand
+    std::vector<std::vector<ChannelEdge *>> allPreds;
+    if (options.parallel) {
+      allPreds.resize(flows.size());
+      mlir::parallelFor(options.context, 0, flows.size(), [&](size_t i) {
+        allPreds[i] = dijkstraShortestPaths(csr, flows[i].src.sb);
+      });
+    }
 
     // for each flow, find the shortest path from source to destination
     // update used_capacity for the path between them
-    for (const auto &[src, dsts] : flows) {
+    for (auto [flowIndex, flow] : llvm::enumerate(flows)) {
+      const auto &[src, dsts, bandwidth] = flow;
       // Use dijkstra to find path given current demand from the start
       // switchbox; find the shortest paths to each other switchbox. Output is
       // in the predecessor map, which must then be processed to get individual
       // switchbox settings
       assert(src.sb && "nonexistent flow source");
       std::set<SwitchboxNode *> processed;
-      std::map<SwitchboxNode *, SwitchboxNode *> preds =
-          dijkstraShortestPaths(graph, src.sb);
+      std::vector<ChannelEdge *> preds =
+          options.parallel ? std::move(allPreds[flowIndex])
+                           : dijkstraShortestPaths(csr, src.sb);
 
       // trace the path of the flow backwards via predecessors
       // increment used_capacity for the associated channels
@@ -422,15 +900,9 @@ Pathfinder::findPaths(const int maxIterations) {
 
         // trace backwards until a vertex already processed is reached
         while (!processed.count(curr)) {
-          // find the edge from the pred to curr by searching incident edges
-          SmallVector<ChannelEdge *, 10> channels;
-          graph.findIncomingEdgesToNode(*curr, channels);
-          auto *matchingCh = std::find_if(
-              channels.begin(), channels.end(),
-              [&](ChannelEdge *ch) { return ch->src == *preds[curr]; });
-          assert(matchingCh != channels.end() && "couldn't find ch");
           // incoming edge
-          ChannelEdge *ch = *matchingCh;
+          ChannelEdge *ch = preds[curr->id];
+          assert(ch && "couldn't find ch");
 
           // don't use fixed channels
           while (ch->fixedCapacity.count(ch->usedCapacity))
@@ -440,8 +912,7 @@ Pathfinder::findPaths(const int maxIterations) {
           switchSettings[*curr].src = {getConnectingBundle(ch->bundle),
                                        ch->usedCapacity};
           // add the current Switchbox to the map of the predecessor
-          switchSettings[*preds[curr]].dsts.insert(
-              {ch->bundle, ch->usedCapacity});
+          switchSettings[ch->src].dsts.insert({ch->bundle, ch->usedCapacity});
 
           ch->usedCapacity++;
           // if at capacity, bump demand to discourage using this Channel
@@ -450,9 +921,10 @@ Pathfinder::findPaths(const int maxIterations) {
             // this means the order matters!
             ch->demand *= DEMAND_COEFF;
           }
+          useChannel(*ch, flow, options);
 
           processed.insert(curr);
-          curr = preds[curr];
+          curr = &ch->src;
         }
       }
       // add this flow to the proposed solution
@@ -462,3 +934,212 @@ Pathfinder::findPaths(const int maxIterations) {
 
   return routingSolution;
 }
+
+// Add a packet flow with the given ID. Destinations of packets with the same
+// ID from the same source port are merged into a single broadcast flow.
+void PacketPathfinder::addPacketFlow(int id, TileID srcCoords, Port srcPort,
+                                     TileID dstCoords, Port dstPort) {
+  assert(grid.count(srcCoords) && "didn't find packet flow source");
+  assert(grid.count(dstCoords) && "didn't find packet flow dest");
+  SwitchboxNode *srcSb = &grid.at(srcCoords);
+  SwitchboxNode *dstSb = &grid.at(dstCoords);
+  for (auto &[flow, flowID] : packetFlows) {
+    if (flowID == id && flow.src.sb == srcSb && flow.src.port == srcPort) {
+      flow.dsts.emplace_back(dstSb, dstPort);
+      return;
+    }
+  }
+  packetFlows.push_back(
+      {FlowNode{PathEndPointNode{srcSb, srcPort},
+                std::vector<PathEndPointNode>{{dstSb, dstPort}}},
+       id});
+}
+
+// Route all packet flows, one at a time, on top of the circuit-switched
+// routing found by findPaths. A connection of a channel can carry packets of
+// several flows as long as their IDs differ; opening a new connection costs
+// NEW_PACKET_CONNECTION_COST on top of the distance, so that routes are
+// merged where it doesn't make them longer. New connections take the highest
+// free channel index, leaving the lower ones to circuit-switched flows.
+std::optional<std::map<TileID, PacketConnections>>
+PacketPathfinder::findPacketPaths() {
+  LLVM_DEBUG(llvm::dbgs() << "Begin PacketPathfinder::findPacketPaths\n");
+  // A connection of a channel used by packet-switched routes.
+  struct PacketConnection {
+    int channel;
+    std::set<int> ids;
+  };
+  std::map<ChannelEdge *, std::vector<PacketConnection>> connections;
+  // the number of connections of a channel claimed by circuit-switched flows
+  std::map<ChannelEdge *, int> circuitUse;
+  for (auto &ch : edges) {
+    auto fixedEnd = ch.fixedCapacity.lower_bound(ch.usedCapacity);
+    int fixedBelow = std::distance(ch.fixedCapacity.begin(), fixedEnd);
+    circuitUse[&ch] = ch.usedCapacity - fixedBelow;
+  }
+
+  auto findSharedConnection = [&](ChannelEdge *ch, int id) {
+    auto &chConnections = connections[ch];
+    return std::find_if(chConnections.begin(), chConnections.end(),
+                        [&](const PacketConnection &conn) {
+                          return !conn.ids.count(id) &&
+                                 conn.ids.size() < MAX_PACKET_IDS_PER_PORT;
+                        });
+  };
+  auto hasFreeConnection = [&](ChannelEdge *ch) {
+    return static_cast<int>(ch->fixedCapacity.size() + connections[ch].size()) +
+               circuitUse[ch] <
+           ch->maxCapacity;
+  };
+
+  std::map<TileID, PacketConnections> routing;
+  for (const auto &[flow, id] : packetFlows) {
+    for (auto &ch : edges) {
+      if (findSharedConnection(&ch, id) != connections[&ch].end())
+        ch.demand = 1.0;
+      else if (hasFreeConnection(&ch))
+        ch.demand = 1.0 + NEW_PACKET_CONNECTION_COST;
+      else
+        ch.demand = INF;
+    }
+
+    auto tree = aStarRouteFlow(flow);
+    if (!tree) {
+      LLVM_DEBUG(llvm::dbgs() << "PacketPathfinder: no path for packet flow "
+                              << id << " from " << flow.src << "\n");
+      return std::nullopt;
+    }
+
+    // pick the connection of every channel on the routing tree
+    std::map<ChannelEdge *, int> channelIndex;
+    for (auto &[sb, ch] : *tree) {
+      auto shared = findSharedConnection(ch, id);
+      if (shared == connections[ch].end()) {
+        int channel = ch->maxCapacity - 1;
+        while (ch->fixedCapacity.count(channel) ||
+               llvm::any_of(connections[ch], [&](const PacketConnection &c) {
+                 return c.channel == channel;
+               }))
+          channel--;
+        assert(channel >= 0 && "no free connection on channel");
+        connections[ch].push_back({channel, {}});
+        shared = std::prev(connections[ch].end());
+      }
+      shared->ids.insert(id);
+      channelIndex[ch] = shared->channel;
+    }
+
+    // Emit the connections of every switchbox on the tree, visiting the
+    // switchboxes and their outgoing channels in a deterministic order.
+    std::vector<SwitchboxNode *> nodes = {flow.src.sb};
+    for (auto &[sb, ch] : *tree)
+      nodes.push_back(sb);
+    llvm::sort(nodes, [](const SwitchboxNode *a, const SwitchboxNode *b) {
+      return a->id < b->id;
+    });
+    for (SwitchboxNode *sb : nodes) {
+      Port in = sb == flow.src.sb
+                    ? flow.src.port
+                    : Port{getConnectingBundle(tree->at(sb)->bundle),
+                           channelIndex[tree->at(sb)]};
+      std::vector<Port> outs;
+      for (const PathEndPointNode &endPoint : flow.dsts)
+        if (endPoint.sb == sb)
+          outs.push_back(endPoint.port);
+      std::vector<ChannelEdge *> outChannels;
+      for (auto &[next, ch] : *tree)
+        if (&ch->src == sb)
+          outChannels.push_back(ch);
+      llvm::sort(outChannels, [](const ChannelEdge *a, const ChannelEdge *b) {
+        return a->getTargetNode().id < b->getTargetNode().id;
+      });
+      for (ChannelEdge *ch : outChannels)
+        outs.push_back({ch->bundle, channelIndex[ch]});
+
+      PacketConnections &sbConnections = routing[*sb];
+      for (Port out : outs) {
+        std::pair<Connect, int> connection = {{in, out}, id};
+        if (llvm::find(sbConnections, connection) == sbConnections.end())
+          sbConnections.push_back(connection);
+      }
+    }
+  }
+  return routing;
+}
+
+int xilinx::AIE::getLogicalNumDestChannels(WireBundle bundle) {
+  switch (bundle) {
+  case WireBundle::North:
+    return 6;
+  case WireBundle::South:
+  case WireBundle::East:
+  case WireBundle::West:
+    return 4;
+  default:
+    return 2;
+  }
+}
+
+LogicalResult xilinx::AIE::buildDimensionOrderedRoute(
+    TileID src, Port srcPort, TileID dst, Port dstPort,
+    llvm::function_ref<std::optional<int>(TileID, Port, WireBundle)>
+        findChannel,
+    llvm::function_ref<void(TileID, Connect)> addConnect) {
+  TileID cur = src;
+  Port lastPort = srcPort;
+  // The side by which the route entered the current switchbox.
+  std::optional<WireBundle> lastBundle;
+  // traverse horizontally, then vertically
+  while (cur != dst) {
+    SmallVector<WireBundle, 4> moves;
+    if (cur.col < dst.col)
+      moves.push_back(WireBundle::East);
+    if (cur.col > dst.col)
+      moves.push_back(WireBundle::West);
+    if (cur.row < dst.row)
+      moves.push_back(WireBundle::North);
+    if (cur.row > dst.row)
+      moves.push_back(WireBundle::South);
+    for (WireBundle move : {WireBundle::East, WireBundle::West,
+                            WireBundle::North, WireBundle::South})
+      if (!llvm::is_contained(moves, move))
+        moves.push_back(move);
+
+    std::optional<Port> out;
+    for (WireBundle move : moves) {
+      if (move == lastBundle)
+        continue;
+      if (std::optional<int> channel = findChannel(cur, lastPort, move)) {
+        out = Port{move, *channel};
+        break;
+      }
+    }
+    if (!out)
+      return failure();
+
+    LLVM_DEBUG(llvm::dbgs() << "Tile " << cur.col << " " << cur.row << " "
+                            << stringifyWireBundle(lastPort.bundle) << " "
+                            << lastPort.channel << " -> "
+                            << stringifyWireBundle(out->bundle) << " "
+                            << out->channel << "\n");
+    addConnect(cur, {lastPort, *out});
+    switch (out->bundle) {
+    case WireBundle::East:
+      cur.col++;
+      break;
+    case WireBundle::West:
+      cur.col--;
+      break;
+    case WireBundle::North:
+      cur.row++;
+      break;
+    default:
+      cur.row--;
+      break;
+    }
+    lastBundle = getConnectingBundle(out->bundle);
+    lastPort = {*lastBundle, out->channel};
+  }
+  addConnect(cur, {lastPort, dstPort});
+  return success();
+}
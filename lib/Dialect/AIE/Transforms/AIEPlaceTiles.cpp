@@ -0,0 +1,281 @@
+//===- AIEPlaceTiles.cpp ----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass assigns the coordinates of logical core tiles.
+//
+// The tiles with the `aie.place` attribute are logical: their coordinates are
+// placeholders, and they are placed on the core tiles left free by the other
+// tiles of the device. Each objectFifo connects its producer to each of its
+// consumers, and each flow its source to its destination, with the weight
+// given by an `aie.bandwidth` integer attribute, or 1. A connection costs its
+// weight times the length of its route, one plus the Manhattan distance
+// between its tiles, except for an objectFifo whose tiles share memory,
+// which is lowered without DMAs and costs nothing. The routes crossing each
+// boundary between two columns beyond the east-west channels of the column
+// are penalized by the square of the overflow, to spread them out.
+//
+// The tiles are placed greedily, the most heavily connected first, each on
+// the free position of least cost to the tiles placed before it. The
+// placement is then improved by moving each tile to a free position, or
+// swapping it with another logical tile, while this decreases the cost.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/SetVector.h"
+
+#include <set>
+
+#define DEBUG_TYPE "aie-place-tiles"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Bound on the rounds of improvement of the greedy placement.
+static constexpr int maxRounds = 100;
+
+namespace {
+
+// A connection between two tiles, given by their index in the placement.
+struct Connection {
+  int from;
+  int to;
+  int64_t weight;
+  // Whether the connection needs no route when its tiles share memory.
+  bool sharable;
+};
+
+struct Placement {
+  const AIETargetModel &targetModel;
+  std::vector<TileID> positions;
+  std::vector<bool> placed;
+  std::vector<Connection> connections;
+  // The connections of each tile.
+  std::vector<SmallVector<int>> tileConnections;
+  // The weight of the routes crossing from each column to the next, and the
+  // channels available for them.
+  std::vector<int64_t> demand;
+  std::vector<int64_t> capacity;
+  int64_t length = 0;
+
+  Placement(const AIETargetModel &targetModel, size_t numTiles)
+      : targetModel(targetModel), positions(numTiles), placed(numTiles),
+        tileConnections(numTiles), demand(targetModel.columns()),
+        capacity(targetModel.columns()) {
+    for (int col = 0; col < targetModel.columns(); col++)
+      for (int row = 0; row < targetModel.rows(); row++)
+        capacity[col] += targetModel.getNumDestSwitchboxConnections(
+            col, row, WireBundle::East);
+  }
+
+  void connect(int from, int to, int64_t weight, bool sharable) {
+    if (from == to)
+      return;
+    tileConnections[from].push_back(connections.size());
+    tileConnections[to].push_back(connections.size());
+    connections.push_back({from, to, weight, sharable});
+  }
+
+  bool sharesMemory(TileID a, TileID b) const {
+    return targetModel.isCoreTile(a.col, a.row) &&
+           targetModel.isCoreTile(b.col, b.row) &&
+           (targetModel.isLegalMemAffinity(a.col, a.row, b.col, b.row) ||
+            targetModel.isLegalMemAffinity(b.col, b.row, a.col, a.row));
+  }
+
+  // Add or remove the contribution of a connection to the cost, if both its
+  // tiles are placed.
+  void account(const Connection &conn, int sign) {
+    if (!placed[conn.from] || !placed[conn.to])
+      return;
+    TileID a = positions[conn.from], b = positions[conn.to];
+    if (conn.sharable && sharesMemory(a, b))
+      return;
+    length += sign * conn.weight *
+              (1 + std::abs(a.col - b.col) + std::abs(a.row - b.row));
+    for (int col = std::min(a.col, b.col); col < std::max(a.col, b.col); col++)
+      demand[col] += sign * conn.weight;
+  }
+
+  int64_t cost() const {
+    int64_t congestion = 0;
+    for (auto [used, available] : llvm::zip(demand, capacity))
+      if (used > available)
+        congestion += (used - available) * (used - available);
+    return length + congestion;
+  }
+
+  // Move the given tiles to new positions, updating the cost.
+  void move(ArrayRef<std::pair<int, TileID>> moves) {
+    llvm::SmallSetVector<int, 16> affected;
+    for (auto [tile, position] : moves)
+      affected.insert(tileConnections[tile].begin(),
+                      tileConnections[tile].end());
+    for (int conn : affected)
+      account(connections[conn], -1);
+    for (auto [tile, position] : moves) {
+      positions[tile] = position;
+      placed[tile] = true;
+    }
+    for (int conn : affected)
+      account(connections[conn], +1);
+  }
+};
+
+} // namespace
+
+struct AIEPlaceTilesPass : AIEPlaceTilesBase<AIEPlaceTilesPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    const auto &targetModel = device.getTargetModel();
+
+    SmallVector<TileOp> tiles;
+    SmallVector<int> logical;
+    DenseMap<Value, int> tileIndex;
+    DenseSet<TileID> occupied;
+    for (auto tile : device.getOps<TileOp>()) {
+      tileIndex[tile] = tiles.size();
+      if (tile->hasAttr("aie.place")) {
+        if (!targetModel.isCoreTile(tile.colIndex(), tile.rowIndex())) {
+          tile.emitOpError("only core tiles can be placed");
+          return signalPassFailure();
+        }
+        logical.push_back(tiles.size());
+      } else {
+        occupied.insert(tile.getTileID());
+      }
+      tiles.push_back(tile);
+    }
+    if (logical.empty())
+      return;
+
+    std::vector<TileID> freePositions;
+    for (int col = 0; col < targetModel.columns(); col++)
+      for (int row = 0; row < targetModel.rows(); row++)
+        if (targetModel.isCoreTile(col, row) &&
+            !occupied.contains({col, row}))
+          freePositions.push_back({col, row});
+    if (freePositions.size() < logical.size()) {
+      device.emitError("cannot place ")
+          << logical.size() << " tiles on the " << freePositions.size()
+          << " free core tiles of the device";
+      return signalPassFailure();
+    }
+
+    Placement placement(targetModel, tiles.size());
+    for (auto [index, tile] : llvm::enumerate(tiles))
+      placement.positions[index] = tile.getTileID();
+    for (auto [index, tile] : llvm::enumerate(tiles))
+      placement.placed[index] = !tile->hasAttr("aie.place");
+
+    auto getWeight = [](Operation *op) -> int64_t {
+      if (auto weight = op->getAttrOfType<IntegerAttr>("aie.bandwidth"))
+        return std::max<int64_t>(1, weight.getInt());
+      return 1;
+    };
+    for (auto fifo : device.getOps<ObjectFifoCreateOp>()) {
+      // As in aie-objectFifo-stateful-transform, only objectFifos with a
+      // single consumer and no data layout transformation use shared memory.
+      bool sharable = fifo.getConsumerTiles().size() == 1 &&
+                      fifo.getDimensionsToStream().empty() &&
+                      llvm::all_of(fifo.getDimensionsFromStreamPerConsumer(),
+                                   [](BDDimLayoutArrayAttr dims) {
+                                     return dims.empty();
+                                   });
+      for (Value consumer : fifo.getConsumerTiles())
+        placement.connect(tileIndex[fifo.getProducerTile()],
+                          tileIndex[consumer], getWeight(fifo), sharable);
+    }
+    for (auto flow : device.getOps<FlowOp>())
+      placement.connect(tileIndex[flow.getSource()], tileIndex[flow.getDest()],
+                        getWeight(flow), /*sharable=*/false);
+    for (const Connection &conn : placement.connections)
+      placement.account(conn, +1);
+
+    // Place the most heavily connected tiles first.
+    auto connectedWeight = [&](int tile) {
+      int64_t weight = 0;
+      for (int conn : placement.tileConnections[tile])
+        weight += placement.connections[conn].weight;
+      return weight;
+    };
+    llvm::stable_sort(logical, [&](int a, int b) {
+      return connectedWeight(a) > connectedWeight(b);
+    });
+
+    std::set<TileID> available(freePositions.begin(), freePositions.end());
+    for (int tile : logical) {
+      std::optional<TileID> best;
+      int64_t bestCost = 0;
+      for (TileID position : available) {
+        placement.move({{tile, position}});
+        int64_t cost = placement.cost();
+        if (!best || cost < bestCost) {
+          best = position;
+          bestCost = cost;
+        }
+      }
+      placement.move({{tile, *best}});
+      available.erase(*best);
+    }
+
+    // Improve the placement by moving and swapping tiles.
+    for (int round = 0; round < maxRounds; round++) {
+      bool improved = false;
+      for (int tile : logical) {
+        TileID from = placement.positions[tile];
+        int64_t cost = placement.cost();
+        for (TileID position : available) {
+          placement.move({{tile, position}});
+          if (placement.cost() < cost) {
+            available.erase(position);
+            available.insert(from);
+            improved = true;
+            break;
+          }
+          placement.move({{tile, from}});
+        }
+        from = placement.positions[tile];
+        cost = placement.cost();
+        for (int other : logical) {
+          if (other == tile)
+            continue;
+          TileID to = placement.positions[other];
+          placement.move({{tile, to}, {other, from}});
+          if (placement.cost() < cost) {
+            improved = true;
+            break;
+          }
+          placement.move({{tile, from}, {other, to}});
+        }
+      }
+      LLVM_DEBUG(llvm::dbgs() << "round " << round << ": cost "
+                              << placement.cost() << "\n");
+      if (!improved)
+        break;
+    }
+
+    OpBuilder builder(device.getContext());
+    for (int tile : logical) {
+      TileOp tileOp = tiles[tile];
+      TileID position = placement.positions[tile];
+      tileOp.setColAttr(builder.getI32IntegerAttr(position.col));
+      tileOp.setRowAttr(builder.getI32IntegerAttr(position.row));
+      tileOp->removeAttr("aie.place");
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>> AIE::createAIEPlaceTilesPass() {
+  return std::make_unique<AIEPlaceTilesPass>();
+}
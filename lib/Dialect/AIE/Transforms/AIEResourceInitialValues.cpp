@@ -0,0 +1,63 @@
+//===- AIEResourceInitialValues.cpp -----------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass moves the large initial values of buffers into dense resources.
+//
+// A dense elements attribute is uniqued by its contents, which are hashed
+// when it is parsed, and printed as text. A dense resource only references a
+// blob of the module, stored as is in the resource section of the bytecode,
+// so that passing the design between the stages of the compiler as bytecode
+// neither hashes nor converts the initial values.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/IR/AsmState.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "aie-resource-initial-values"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+struct AIEResourceInitialValuesPass
+    : AIEResourceInitialValuesBase<AIEResourceInitialValuesPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    device.walk([&](BufferOp buffer) {
+      auto value =
+          dyn_cast_or_null<DenseElementsAttr>(buffer.getInitialValueAttr());
+      if (!value || value.isSplat())
+        return;
+      // The raw data of i1 elements is packed, unlike the data of a blob.
+      Type elementType = value.getElementType();
+      if (!elementType.isIntOrFloat() ||
+          elementType.getIntOrFloatBitWidth() % 8 != 0)
+        return;
+      ArrayRef<char> data = value.getRawData();
+      if (data.size() < clMinBytes)
+        return;
+
+      AsmResourceBlob blob = HeapAsmResourceBlob::allocateAndCopyWithAlign(
+          data, alignof(uint64_t));
+      StringRef name = buffer.hasName() ? buffer.name().getValue() : "buffer";
+      buffer.setInitialValueAttr(DenseResourceElementsAttr::get(
+          value.getType(), name, std::move(blob)));
+    });
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIEResourceInitialValuesPass() {
+  return std::make_unique<AIEResourceInitialValuesPass>();
+}
@@ -0,0 +1,106 @@
+//===- AIEReuseBuffers.cpp --------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass lets buffers which are never live at the same time share memory.
+// Only buffers accessed by a single core are considered, since the accesses
+// of DMAs and other cores are not ordered with respect to the program of the
+// core. After aie-objectFifo-stateful-transform, this covers the elements of
+// objectFifos whose producer and consumer are the same core: their accesses,
+// between the acquire and release of each element, have become direct
+// accesses to the buffers.
+//
+// The live range of a buffer spans the operations of the core from its first
+// to its last access, and all the operations of any loop containing one of
+// its accesses. Buffers of the same tile and type whose live ranges don't
+// intersect are merged into a single buffer.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIELiveRanges.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/MapVector.h"
+
+#define DEBUG_TYPE "aie-reuse-buffers"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+struct AIEReuseBuffersPass : AIEReuseBuffersBase<AIEReuseBuffersPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+
+    struct LiveRange {
+      BufferOp buffer;
+      int start;
+      int end;
+    };
+
+    for (auto core : device.getOps<CoreOp>()) {
+      CoreLiveRanges liveRanges(core);
+      if (!liveRanges.isStructured())
+        continue;
+
+      // Candidate buffers, grouped by tile and type.
+      llvm::MapVector<std::pair<Operation *, Type>, SmallVector<LiveRange>>
+          candidates;
+      device.walk([&](BufferOp buffer) {
+        if (buffer.getInitialValue() ||
+            (buffer.hasName() &&
+             !SymbolTable::symbolKnownUseEmpty(buffer.name(), device)))
+          return;
+        SmallVector<Operation *> accesses;
+        if (buffer->use_empty() ||
+            !liveRanges.collectAccesses(buffer.getResult(), accesses))
+          return;
+
+        auto [start, end] = liveRanges.getLiveRange(accesses);
+        LiveRange range = {buffer, start, end};
+        auto key = std::make_pair(buffer.getTileOp().getOperation(),
+                                  buffer.getType());
+        candidates[key].push_back(range);
+      });
+
+      for (auto &[key, ranges] : candidates) {
+        llvm::stable_sort(ranges, [](const LiveRange &a, const LiveRange &b) {
+          return a.start < b.start;
+        });
+        // Each slot holds the buffer kept for a set of merged buffers and
+        // the end of their live ranges.
+        SmallVector<LiveRange> slots;
+        for (LiveRange &range : ranges) {
+          auto *slot = llvm::find_if(slots, [&](const LiveRange &s) {
+            return s.end < range.start;
+          });
+          if (slot == slots.end()) {
+            slots.push_back(range);
+            continue;
+          }
+          LLVM_DEBUG(llvm::dbgs()
+                     << "Reusing the memory of " << slot->buffer << " for "
+                     << range.buffer << "\n");
+          // The kept buffer must dominate the accesses of the merged one.
+          if (range.buffer->isBeforeInBlock(slot->buffer))
+            slot->buffer->moveBefore(range.buffer);
+          range.buffer.getResult().replaceAllUsesWith(
+              slot->buffer.getResult());
+          range.buffer.erase();
+          slot->end = range.end;
+        }
+      }
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>> AIE::createAIEReuseBuffersPass() {
+  return std::make_unique<AIEReuseBuffersPass>();
+}
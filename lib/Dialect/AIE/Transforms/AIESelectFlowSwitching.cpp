@@ -0,0 +1,265 @@
+//===- AIESelectFlowSwitching.cpp -------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass chooses between circuit and packet switching for each aie.flow
+// from its bandwidth annotation.
+//
+// A circuit-switched flow reserves a stream connection on each switchbox of
+// its route, while packet-switched flows share them. Low-bandwidth flows
+// leaving a DMA are therefore turned into packet flows, as long as the sum of
+// their bandwidths fits in a single connection. The flows from the same
+// source port share the same stream, so they are switched together. The DMA
+// of the source adds the packet headers, so each BD of its chain gets an
+// aie.dma_bd_packet with the id of the new packet flow.
+//
+// Optionally, the packet flows selected from the DMA channels of the same
+// tile are then sent through a single channel: their BD chains are woven
+// into one, whose BDs carry the headers of their own flows, freeing the
+// other channels of the tile.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/MapVector.h"
+
+#define DEBUG_TYPE "aie-select-flow-switching"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Packet ids are 5 bits wide.
+static constexpr int maxPacketId = 31;
+
+namespace {
+// The flows sharing a source port.
+struct FlowGroup {
+  SmallVector<FlowOp> flows;
+  double bandwidth = 0;
+  // The source tile, the aie.dma_start of its DMA channel and the BD blocks
+  // of its chain.
+  TileOp tile;
+  DMAStartOp start;
+  SmallVector<Block *> bds;
+  PacketFlowOp packetFlow;
+};
+} // namespace
+
+// Returns the MM2S aie.dma_start of the given channel of the tile, or a null
+// op if there is none.
+static DMAStartOp getSourceDMAStart(DeviceOp device, TileOp tile,
+                                    int channel) {
+  DMAStartOp found;
+  auto findStart = [&](Operation *dma) {
+    for (Block &block : dma->getRegion(0))
+      for (auto start : block.getOps<DMAStartOp>())
+        if (start.getChannelDir() == DMAChannelDir::MM2S &&
+            start.getChannelIndex() == channel)
+          found = start;
+  };
+  for (auto mem : device.getOps<MemOp>())
+    if (mem.getTileOp() == tile)
+      findStart(mem);
+  for (auto mem : device.getOps<MemTileDMAOp>())
+    if (mem.getTileOp() == tile)
+      findStart(mem);
+  for (auto shim : device.getOps<ShimDMAOp>())
+    if (shim.getTileOp() == tile)
+      findStart(shim);
+  return found;
+}
+
+// Returns the BD blocks of the chain started by the aie.dma_start.
+static SmallVector<Block *> getChainBDs(DMAStartOp start) {
+  SmallVector<Block *> bds;
+  Block *bd = start.getDest();
+  while (bd && !bd->getOps<DMABDOp>().empty() && !llvm::is_contained(bds, bd)) {
+    bds.push_back(bd);
+    auto next = dyn_cast<NextBDOp>(bd->getTerminator());
+    bd = next ? next.getDest() : nullptr;
+  }
+  return bds;
+}
+
+// Returns true if the last BD of the chain loops back to its first one.
+static bool isCyclic(ArrayRef<Block *> bds) {
+  auto next = dyn_cast<NextBDOp>(bds.back()->getTerminator());
+  return next && next.getDest() == bds.front();
+}
+
+// Sends the packet flows of the groups, all from DMA channels of the same
+// tile, through the channel of the first of them in the DMA region. The BDs
+// of their chains are interleaved, so that the channel sends one BD of each
+// flow in turn; only cyclic chains as long as that of the first channel are
+// merged, so that every flow keeps its rate. The aie.dma_start of the other
+// channels are removed.
+static void shareChannel(ArrayRef<FlowGroup *> groups) {
+  SmallVector<FlowGroup *> sorted;
+  for (Block &block : *groups.front()->start->getParentRegion())
+    for (FlowGroup *group : groups)
+      if (group->start->getBlock() == &block)
+        sorted.push_back(group);
+  FlowGroup *kept = sorted.front();
+  if (!isCyclic(kept->bds))
+    return;
+  SmallVector<FlowGroup *> merged = {kept};
+  for (FlowGroup *group : ArrayRef(sorted).drop_front())
+    if (group->bds.size() == kept->bds.size() && isCyclic(group->bds) &&
+        group->start.getRepeatCount() == kept->start.getRepeatCount() &&
+        group->start->use_empty() &&
+        !group->start->getBlock()->hasNoPredecessors())
+      merged.push_back(group);
+  if (merged.size() < 2)
+    return;
+
+  SmallVector<Block *> chain;
+  for (size_t i = 0; i < kept->bds.size(); i++)
+    for (FlowGroup *group : merged)
+      chain.push_back(group->bds[i]);
+  for (size_t i = 0; i < chain.size(); i++)
+    chain[i]->getTerminator()->setSuccessor(chain[(i + 1) % chain.size()], 0);
+
+  int channel = kept->start.getChannelIndex();
+  for (FlowGroup *group : ArrayRef(merged).drop_front()) {
+    group->packetFlow.emitRemark()
+        << "sharing DMA channel " << channel << " of its source";
+    for (auto source : group->packetFlow.getOps<PacketSourceOp>())
+      source.setChannel(channel);
+    // Unlink the aie.dma_start from the chain of starts of the region.
+    Block *block = group->start->getBlock();
+    Block *chained = group->start.getChain();
+    for (Block *pred : llvm::to_vector(block->getPredecessors()))
+      for (auto &operand : pred->getTerminator()->getBlockOperands())
+        if (operand.get() == block)
+          operand.set(chained);
+    block->erase();
+  }
+}
+
+struct AIESelectFlowSwitchingPass
+    : AIESelectFlowSwitchingBase<AIESelectFlowSwitchingPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    if (clLinkBandwidth <= 0) {
+      device.emitError("link-bandwidth must be positive");
+      return signalPassFailure();
+    }
+    double maxBandwidth = clPacketThreshold * clLinkBandwidth;
+
+    llvm::MapVector<std::tuple<Operation *, int, int>, FlowGroup> groups;
+    for (auto flow : device.getOps<FlowOp>())
+      groups[{flow.getSource().getDefiningOp(),
+              static_cast<int>(flow.getSourceBundle()),
+              flow.getSourceChannel()}]
+          .flows.push_back(flow);
+
+    SmallVector<FlowGroup *> candidates;
+    for (auto &[source, group] : groups) {
+      auto [sourceOp, bundle, channel] = source;
+      auto tile = dyn_cast_or_null<TileOp>(sourceOp);
+      if (!tile || static_cast<WireBundle>(bundle) != WireBundle::DMA)
+        continue;
+      bool annotated = true;
+      for (FlowOp flow : group.flows) {
+        if (!flow.getBandwidth()) {
+          annotated = false;
+          break;
+        }
+        group.bandwidth =
+            std::max(group.bandwidth, double(*flow.getBandwidth()));
+      }
+      if (!annotated || group.bandwidth > maxBandwidth)
+        continue;
+      group.tile = tile;
+      group.start = getSourceDMAStart(device, tile, channel);
+      if (group.start)
+        group.bds = getChainBDs(group.start);
+      if (group.bds.empty() ||
+          llvm::any_of(group.bds, [](Block *bd) {
+            return !bd->getOps<DMABDPACKETOp>().empty();
+          }))
+        continue;
+      candidates.push_back(&group);
+    }
+
+    llvm::stable_sort(candidates, [](FlowGroup *a, FlowGroup *b) {
+      return a->bandwidth < b->bandwidth;
+    });
+    int packetId = -1;
+    for (auto flow : device.getOps<PacketFlowOp>())
+      packetId = std::max(packetId, flow.IDInt());
+    SmallVector<FlowGroup *> selected;
+    double totalBandwidth = 0;
+    for (FlowGroup *group : candidates) {
+      if (totalBandwidth + group->bandwidth > clLinkBandwidth ||
+          packetId + 1 + static_cast<int>(selected.size()) > maxPacketId)
+        break;
+      totalBandwidth += group->bandwidth;
+      selected.push_back(group);
+    }
+    if (selected.size() < 2)
+      return markAllAnalysesPreserved();
+
+    OpBuilder builder(device.getContext());
+    for (FlowGroup *group : selected) {
+      packetId++;
+      FlowOp first = group->flows.front();
+      first.emitRemark() << "packet switching " << group->flows.size()
+                         << " flow(s) of " << group->bandwidth
+                         << " MB/s with id " << packetId;
+      if (!clApply)
+        continue;
+
+      Location loc = first.getLoc();
+      builder.setInsertionPoint(first);
+      auto packetFlow = builder.create<PacketFlowOp>(loc, packetId);
+      packetFlow.setBandwidth(static_cast<uint32_t>(group->bandwidth));
+      {
+        OpBuilder::InsertionGuard guard(builder);
+        builder.setInsertionPointToStart(
+            builder.createBlock(&packetFlow.getPorts()));
+        builder.create<PacketSourceOp>(loc, first.getSource(),
+                                       first.getSourceBundle(),
+                                       first.getSourceChannel());
+        for (FlowOp flow : group->flows)
+          builder.create<PacketDestOp>(loc, flow.getDest(),
+                                       flow.getDestBundle(),
+                                       flow.getDestChannel());
+        builder.create<EndOp>(loc);
+      }
+      for (Block *bd : group->bds) {
+        builder.setInsertionPoint(*bd->getOps<DMABDOp>().begin());
+        builder.create<DMABDPACKETOp>(loc, 0, packetId);
+      }
+      for (FlowOp flow : group->flows)
+        flow.erase();
+      group->packetFlow = packetFlow;
+    }
+
+    if (!clApply || !clShareChannels)
+      return;
+    // Shim channels are also programmed by the host, through their
+    // aie.shim_dma_allocation, so they are left alone.
+    llvm::MapVector<Operation *, SmallVector<FlowGroup *>> groupsPerTile;
+    for (FlowGroup *group : selected)
+      if (!group->tile.isShimTile())
+        groupsPerTile[group->tile].push_back(group);
+    for (auto &[tile, groups] : groupsPerTile)
+      if (groups.size() > 1)
+        shareChannel(groups);
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+AIE::createAIESelectFlowSwitchingPass() {
+  return std::make_unique<AIESelectFlowSwitchingPass>();
+}
@@ -0,0 +1,139 @@
+//===- AIESplitCores.cpp ----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass splits a device into one module per core, so that the code of
+// each core can be lowered separately without carrying the configuration of
+// the whole device. Lowering the device once per core with
+// aie-standard-lowering="tilecol=X tilerow=Y" costs O(cores x design size);
+// the modules built here only hold what their core depends on, and are built
+// in a single traversal of the device.
+//
+// The module of a core holds a copy of the device with:
+//
+// - the aie.core and the operations of the device defining the values it
+//   uses, such as its tile and the buffers and locks it accesses, together
+//   with their own dependencies;
+// - the operations of the device referenced by symbol from these;
+// - the operations of the device which are not part of the AIE dialects,
+//   such as the declarations and definitions of kernels.
+//
+// The operations outside the device are copied into every module.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/SetVector.h"
+
+#define DEBUG_TYPE "aie-split-cores"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+static bool isAIEOp(Operation *op) {
+  StringRef ns = op->getDialect() ? op->getDialect()->getNamespace() : "";
+  return ns == "aie" || ns == "aiex";
+}
+
+// Adds to deps the operations of the device body needed by the given roots:
+// the operations defining the values they use from outside of them and the
+// operations they reference by symbol, transitively.
+static void collectDependencies(DeviceOp device, SymbolTable &symbols,
+                                ArrayRef<Operation *> roots,
+                                llvm::SetVector<Operation *> &deps) {
+  Block *body = device.getBody();
+  SmallVector<Operation *> worklist;
+  auto add = [&](Operation *op) {
+    if (op && deps.insert(op))
+      worklist.push_back(op);
+  };
+  for (Operation *root : roots)
+    add(root);
+  while (!worklist.empty()) {
+    Operation *op = worklist.pop_back_val();
+    op->walk([&](Operation *nested) {
+      for (Value operand : nested->getOperands())
+        if (Operation *def = operand.getDefiningOp())
+          add(body->findAncestorOpInBlock(*def));
+      nested->getAttrDictionary().walk([&](SymbolRefAttr ref) {
+        add(symbols.lookup(ref.getRootReference()));
+      });
+    });
+  }
+}
+
+struct AIESplitCoresPass : AIESplitCoresBase<AIESplitCoresPass> {
+  void runOnOperation() override {
+    ModuleOp m = getOperation();
+    if (m.getOps<DeviceOp>().empty()) {
+      m.emitOpError("expected AIE.device operation at toplevel");
+      return signalPassFailure();
+    }
+    DeviceOp device = *m.getOps<DeviceOp>().begin();
+    SymbolTable symbols(device);
+
+    // The operations shared by all the cores.
+    SmallVector<Operation *> shared;
+    for (Operation &op : device.getOps())
+      if (!isAIEOp(&op))
+        shared.push_back(&op);
+    llvm::SetVector<Operation *> sharedDeps;
+    collectDependencies(device, symbols, shared, sharedDeps);
+
+    SmallVector<Operation *> outside;
+    for (Operation &op : m.getOps())
+      if (&op != device.getOperation())
+        outside.push_back(&op);
+
+    SmallVector<ModuleOp> coreModules;
+    for (auto core : device.getOps<CoreOp>()) {
+      llvm::SetVector<Operation *> deps = sharedDeps;
+      collectDependencies(device, symbols, {core.getOperation()}, deps);
+      SmallVector<Operation *> ops = deps.takeVector();
+      llvm::sort(ops, [](Operation *a, Operation *b) {
+        return a->isBeforeInBlock(b);
+      });
+
+      std::string name = "core_" + std::to_string(core.colIndex()) + "_" +
+                         std::to_string(core.rowIndex());
+      auto coreModule = ModuleOp::create(m.getLoc(), StringRef(name));
+      coreModule->setAttrs(m->getDiscardableAttrDictionary());
+      coreModules.push_back(coreModule);
+
+      IRMapping mapper;
+      OpBuilder coreBuilder = OpBuilder::atBlockEnd(coreModule.getBody());
+      for (Operation *op : outside)
+        coreBuilder.clone(*op, mapper);
+      Operation *coreDevice =
+          coreBuilder.insert(device->cloneWithoutRegions(mapper));
+      coreDevice->getRegion(0).emplaceBlock();
+      OpBuilder deviceBuilder =
+          OpBuilder::atBlockEnd(&coreDevice->getRegion(0).front());
+      for (Operation *op : ops)
+        deviceBuilder.clone(*op, mapper);
+      LLVM_DEBUG(llvm::dbgs() << "Module " << name << " holds " << ops.size()
+                              << " operations of the device\n");
+    }
+
+    // Replace the contents of the module with the modules of the cores.
+    m.getBody()->clear();
+    OpBuilder builder = OpBuilder::atBlockEnd(m.getBody());
+    for (ModuleOp coreModule : coreModules)
+      builder.insert(coreModule);
+  }
+};
+
+std::unique_ptr<OperationPass<ModuleOp>> AIE::createAIESplitCoresPass() {
+  return std::make_unique<AIESplitCoresPass>();
+}
@@ -11,11 +11,14 @@
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
 
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/Dialect/Vector/Transforms/LoweringPatterns.h"
 #include "mlir/Dialect/Vector/Transforms/VectorTransforms.h"
 #include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
 
@@ -25,6 +28,115 @@ using namespace mlir;
 using namespace xilinx;
 using namespace xilinx::AIE;
 
+// Width of the widest vector load of the cores.
+static constexpr int64_t maxLoadBits = 512;
+
+// Return the offset from `base` of `index`, if it is `base` plus a constant
+// or both are constants.
+static std::optional<int64_t> getIndexOffset(Value base, Value index) {
+  if (base == index)
+    return 0;
+  if (auto add = index.getDefiningOp<arith::AddIOp>()) {
+    for (auto [lhs, rhs] :
+         {std::pair(add.getLhs(), add.getRhs()),
+          std::pair(add.getRhs(), add.getLhs())})
+      if (lhs == base)
+        if (auto cst = getConstantIntValue(rhs))
+          return *cst;
+  }
+  auto baseCst = getConstantIntValue(base);
+  auto indexCst = getConstantIntValue(index);
+  if (baseCst && indexCst)
+    return *indexCst - *baseCst;
+  return std::nullopt;
+}
+
+// Return true if `read` is an unmasked, in bounds 1-D read along the
+// innermost dimension of its source memref.
+static bool isCoalescableRead(vector::TransferReadOp read) {
+  return isa<MemRefType>(read.getSource().getType()) && !read.getMask() &&
+         read.getVectorType().getRank() == 1 &&
+         read.getPermutationMap().isMinorIdentity() &&
+         !read.hasOutOfBoundsDim();
+}
+
+// Return true if `second` reads the elements of the same memref directly
+// following those read by `first`, with no write to memory in between.
+static bool readsNextElements(vector::TransferReadOp first,
+                              vector::TransferReadOp second) {
+  if (first.getSource() != second.getSource() ||
+      first.getPadding() != second.getPadding() ||
+      first.getVectorType().getElementType() !=
+          second.getVectorType().getElementType())
+    return false;
+  auto firstIndices = first.getIndices();
+  auto secondIndices = second.getIndices();
+  for (unsigned i = 0; i + 1 < firstIndices.size(); i++)
+    if (firstIndices[i] != secondIndices[i])
+      return false;
+  if (getIndexOffset(firstIndices.back(), secondIndices.back()) !=
+      first.getVectorType().getNumElements())
+    return false;
+  for (Operation *op = first->getNextNode(); op != second;
+       op = op->getNextNode()) {
+    auto effects = dyn_cast<MemoryEffectOpInterface>(op);
+    if (!effects || effects.hasEffect<MemoryEffects::Write>())
+      return false;
+  }
+  return true;
+}
+
+// Merge the pairs of 1-D vector.transfer_read operations of a block which
+// read consecutive elements of a memref into a single wider read, up to the
+// widest load of the cores, followed by vector.extract_strided_slice
+// operations for the original vectors.
+static void coalesceTransferReads(func::FuncOp f) {
+  OpBuilder builder(f.getContext());
+  f.walk([&](Block *block) {
+    bool merged = true;
+    while (merged) {
+      merged = false;
+      SmallVector<vector::TransferReadOp> reads;
+      for (auto read : block->getOps<vector::TransferReadOp>())
+        if (isCoalescableRead(read))
+          reads.push_back(read);
+      for (auto first : reads) {
+        auto second = llvm::find_if(reads, [&](vector::TransferReadOp read) {
+          return first->isBeforeInBlock(read) && readsNextElements(first, read);
+        });
+        if (second == reads.end())
+          continue;
+        VectorType firstType = first.getVectorType();
+        VectorType secondType = second->getVectorType();
+        int64_t numElements =
+            firstType.getNumElements() + secondType.getNumElements();
+        if (numElements * firstType.getElementTypeBitWidth() > maxLoadBits)
+          continue;
+
+        builder.setInsertionPoint(first);
+        auto wide = builder.create<vector::TransferReadOp>(
+            first.getLoc(),
+            VectorType::get({numElements}, firstType.getElementType()),
+            first.getSource(), first.getIndices(),
+            first.getPermutationMapAttr(), first.getPadding(), /*mask=*/Value(),
+            builder.getBoolArrayAttr({true}));
+        auto extract = [&](VectorType type, int64_t offset) {
+          return builder.create<vector::ExtractStridedSliceOp>(
+              wide.getLoc(), wide.getResult(), ArrayRef<int64_t>{offset},
+              ArrayRef<int64_t>{type.getNumElements()}, ArrayRef<int64_t>{1});
+        };
+        first.getResult().replaceAllUsesWith(extract(firstType, 0));
+        second->getResult().replaceAllUsesWith(
+            extract(secondType, firstType.getNumElements()));
+        second->erase();
+        first.erase();
+        merged = true;
+        break;
+      }
+    }
+  });
+}
+
 struct AIEVectorOptPass : AIEVectorOptBase<AIEVectorOptPass> {
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<func::FuncDialect>();
@@ -37,6 +149,9 @@ struct AIEVectorOptPass : AIEVectorOptBase<AIEVectorOptPass> {
     IRRewriter rewriter(&getContext());
     vector::transferOpflowOpt(rewriter, f);
 
+    if (clCoalesceLoads)
+      coalesceTransferReads(f);
+
     ConversionTarget target(getContext());
     target.addLegalDialect<memref::MemRefDialect>();
     target.addLegalOp<vector::BroadcastOp>();
@@ -320,6 +320,19 @@ ParseResult SRSOp::parse(OpAsmParser &parser, OperationState &result) {
   return parser.addTypeToList(vectorType, result.types);
 }
 
+//===----------------------------------------------------------------------===//
+// RequantOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult RequantOp::verify() {
+  if (!llvm::is_contained({"floor", "ceil", "sym_floor", "sym_ceil", "neg_inf",
+                           "pos_inf", "sym_zero", "sym_inf", "conv_even",
+                           "conv_odd"},
+                          getRounding()))
+    return emitOpError("unknown rounding mode '") << getRounding() << "'";
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // UPSOp
 //===----------------------------------------------------------------------===//
@@ -1423,17 +1436,17 @@ LogicalResult verifyPackUnpackOp(T op) {
   Type rtype = resultType.getElementType();
   unsigned rtypeWidth = rtype.getIntOrFloatBitWidth();
 
-  if (isa<PackOp>(op)) {
-    // The datatype of source must be i16, and datatype of result must be i8
-    if (stypeWidth != 16)
-      return op.emitError("input must be an int16 vector");
-    if (rtypeWidth != 8)
-      return op.emitError("output must be an int8 vector");
-  } else {
-    if (stypeWidth != 8)
-      return op.emitError("input must be an int8 vector");
-    if (rtypeWidth != 16)
-      return op.emitError("output must be an int16 vector");
+  // Pack halves the width of the elements, unpack doubles it: i16 <-> i8,
+  // or i8 <-> i4 for the int4 weights of mixed precision matmuls.
+  unsigned narrowWidth = isa<PackOp>(op) ? rtypeWidth : stypeWidth;
+  unsigned wideWidth = isa<PackOp>(op) ? stypeWidth : rtypeWidth;
+  if ((narrowWidth != 8 || wideWidth != 16) &&
+      (narrowWidth != 4 || wideWidth != 8)) {
+    if (isa<PackOp>(op))
+      return op.emitError("must pack an int16 vector into an int8 vector, or "
+                          "an int8 vector into an int4 vector");
+    return op.emitError("must unpack an int8 vector into an int16 vector, or "
+                        "an int4 vector into an int8 vector");
   }
 
   return success();
@@ -5,11 +5,18 @@
 //===----------------------------------------------------------------------===//
 
 #include "aie/Dialect/AIEVec/TransformOps/AIEVecTransformOps.h"
+#include "aie/Dialect/AIEVec/AIEVecUtils.h"
+#include "aie/Dialect/AIEVec/IR/AIEVecOps.h"
 
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Bufferization/IR/Bufferization.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/IR/LinalgInterfaces.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Transform/IR/TransformInterfaces.h"
 #include "mlir/Dialect/Transform/IR/TransformTypes.h"
 #include "mlir/Dialect/Transform/Utils/Utils.h"
@@ -284,5 +291,242 @@ DiagnosedSilenceableFailure transform::VectorizeContractionOp::applyToOne(
   return DiagnosedSilenceableFailure::success();
 }
 
+//===----------------------------------------------------------------------===//
+// PackForMMulOp
+//===----------------------------------------------------------------------===//
+
+DiagnosedSilenceableFailure transform::PackForMMulOp::applyToOne(
+    TransformRewriter &rewriter, linalg::LinalgOp target,
+    ApplyToEachResultList &results, TransformState &state) {
+  FailureOr<linalg::ContractionDimensions> dims =
+      linalg::inferContractionDims(target);
+  if (failed(dims) || dims->m.size() != 1 || dims->n.size() != 1 ||
+      dims->k.size() != 1 || target.getNumDpsInputs() != 2 ||
+      target.getNumDpsInits() != 1)
+    return emitSilenceableError()
+           << "payload is not a contraction with one M, N and K dimension.";
+
+  auto lhsElemTy = getElementTypeOrSelf(target.getDpsInputs()[0].getType());
+  auto rhsElemTy = getElementTypeOrSelf(target.getDpsInputs()[1].getType());
+  auto accElemTy = getElementTypeOrSelf(target.getDpsInits()[0].getType());
+  auto mmulShape =
+      xilinx::aievec::getAIEMLMatMulShape(lhsElemTy, rhsElemTy, accElemTy);
+  if (!mmulShape)
+    return emitSilenceableError()
+           << "no aievec.matmul for the element types of the payload.";
+  auto [r, s, t] = *mmulShape;
+
+  // Pack the M, N and K dimensions into r x s, s x t and r x t tiles.
+  SmallVector<OpFoldResult> packedSizes(target.getNumLoops(),
+                                        rewriter.getIndexAttr(0));
+  packedSizes[dims->m.front()] = rewriter.getIndexAttr(r);
+  packedSizes[dims->n.front()] = rewriter.getIndexAttr(t);
+  packedSizes[dims->k.front()] = rewriter.getIndexAttr(s);
+  rewriter.setInsertionPoint(target);
+  FailureOr<linalg::PackResult> packed =
+      linalg::pack(rewriter, target, packedSizes);
+  if (failed(packed))
+    return emitSilenceableError() << "failed to pack the payload.";
+
+  // The packing puts the tiles of each operand in the order of the iteration
+  // dimensions, i.e., t x s for the rhs; `aievec.matmul` expects s x t.
+  linalg::LinalgOp packedOp = packed->packedLinalgOp;
+  if (dims->n.front() < dims->k.front()) {
+    Value rhs = packedOp.getDpsInputs()[1];
+    auto rhsPackOp = rhs.getDefiningOp<tensor::PackOp>();
+    if (!rhsPackOp)
+      return emitSilenceableError() << "failed to pack the rhs of the payload.";
+    FailureOr<linalg::PackTransposeResult> transposed =
+        linalg::packTranspose(rewriter, rhsPackOp, packedOp,
+                              /*maybeUnPackOp=*/nullptr,
+                              /*outerPerm=*/{}, /*innerPerm=*/{1, 0});
+    if (failed(transposed))
+      return emitSilenceableError()
+             << "failed to transpose the tiles of the rhs of the payload.";
+    packedOp = transposed->transposedLinalgOp;
+  }
+
+  results.push_back(packedOp);
+  return DiagnosedSilenceableFailure::success();
+}
+
+//===----------------------------------------------------------------------===//
+// SplitAccumulatorsOp
+//===----------------------------------------------------------------------===//
+
+// Return true if the iter_arg `arg` of a loop computes a sum: its only use is
+// the accumulator of a `vector.contract`, or an operand of an addition, whose
+// result is `yielded` and is not used otherwise.
+static bool isAdditiveReduction(BlockArgument arg, Value yielded) {
+  if (!arg.hasOneUse() || !yielded.hasOneUse())
+    return false;
+  Operation *user = *arg.getUsers().begin();
+  if (user->getNumResults() != 1 || user->getResult(0) != yielded)
+    return false;
+  if (auto contractOp = dyn_cast<vector::ContractionOp>(user))
+    return contractOp.getAcc() == arg &&
+           contractOp.getKind() == vector::CombiningKind::ADD;
+  return isa<arith::AddIOp, arith::AddFOp>(user);
+}
+
+static Value createAdd(OpBuilder &builder, Location loc, Value lhs,
+                       Value rhs) {
+  if (isa<FloatType>(getElementTypeOrSelf(lhs.getType())))
+    return builder.create<arith::AddFOp>(loc, lhs, rhs);
+  return builder.create<arith::AddIOp>(loc, lhs, rhs);
+}
+
+DiagnosedSilenceableFailure transform::SplitAccumulatorsOp::applyToOne(
+    TransformRewriter &rewriter, scf::ForOp target,
+    ApplyToEachResultList &results, TransformState &state) {
+  int64_t factor = getFactor();
+  std::optional<int64_t> lb = getConstantIntValue(target.getLowerBound());
+  std::optional<int64_t> ub = getConstantIntValue(target.getUpperBound());
+  std::optional<int64_t> step = getConstantIntValue(target.getStep());
+  if (!lb || !ub || !step || *step <= 0)
+    return emitSilenceableError() << "loop bounds are not static.";
+  int64_t tripCount = llvm::divideCeil(std::max<int64_t>(*ub - *lb, 0), *step);
+  if (tripCount % factor)
+    return emitSilenceableError()
+           << "trip count " << tripCount << " is not a multiple of " << factor
+           << ".";
+
+  // The position of each reduction among the reductions of the loop, -1 for
+  // the other iter_args.
+  auto yieldOp = cast<scf::YieldOp>(target.getBody()->getTerminator());
+  unsigned numIterArgs = target.getNumRegionIterArgs();
+  SmallVector<int64_t> reductionPos(numIterArgs, -1);
+  int64_t numReductions = 0;
+  for (auto [i, arg, yielded] : llvm::enumerate(target.getRegionIterArgs(),
+                                                yieldOp.getOperands()))
+    if (isAdditiveReduction(arg, yielded))
+      reductionPos[i] = numReductions++;
+  if (!numReductions)
+    return emitSilenceableError() << "loop has no additive reduction.";
+
+  // The iter_arg of the `u`-th accumulator, u > 0, of the reduction carried by
+  // the `i`-th iter_arg of `target`.
+  auto getAccumulatorPos = [&](unsigned i, int64_t u) {
+    return numIterArgs + reductionPos[i] * (factor - 1) + u - 1;
+  };
+
+  Location loc = target.getLoc();
+  rewriter.setInsertionPoint(target);
+  SmallVector<Value> inits(target.getInitArgs());
+  for (unsigned i = 0; i < numIterArgs; i++) {
+    if (reductionPos[i] < 0)
+      continue;
+    Type type = inits[i].getType();
+    Value zero = rewriter.create<arith::ConstantOp>(
+        loc, type, rewriter.getZeroAttr(type));
+    inits.append(factor - 1, zero);
+  }
+  Type ivType = target.getInductionVar().getType();
+  Value newStep = rewriter.create<arith::ConstantOp>(
+      loc, ivType, rewriter.getIntegerAttr(ivType, *step * factor));
+
+  // Clone the body once per accumulator. The other iter_args are chained
+  // through the copies.
+  auto newLoop = rewriter.create<scf::ForOp>(
+      loc, target.getLowerBound(), target.getUpperBound(), newStep, inits,
+      [&](OpBuilder &b, Location loc, Value iv, ValueRange args) {
+        SmallVector<Value> yielded(args.begin(), args.end());
+        for (int64_t u = 0; u < factor; u++) {
+          IRMapping mapping;
+          Value ivU = iv;
+          if (u > 0) {
+            Value offset = b.create<arith::ConstantOp>(
+                loc, ivType, b.getIntegerAttr(ivType, u * *step));
+            ivU = b.create<arith::AddIOp>(loc, iv, offset);
+          }
+          mapping.map(target.getInductionVar(), ivU);
+          for (auto [i, arg] : llvm::enumerate(target.getRegionIterArgs())) {
+            bool isCopy = reductionPos[i] >= 0 && u > 0;
+            mapping.map(arg, yielded[isCopy ? getAccumulatorPos(i, u) : i]);
+          }
+          for (Operation &op : target.getBody()->without_terminator())
+            b.clone(op, mapping);
+          for (auto [i, value] : llvm::enumerate(yieldOp.getOperands())) {
+            bool isCopy = reductionPos[i] >= 0 && u > 0;
+            yielded[isCopy ? getAccumulatorPos(i, u) : i] =
+                mapping.lookupOrDefault(value);
+          }
+        }
+        b.create<scf::YieldOp>(loc, yielded);
+      });
+
+  // Sum the accumulators of each reduction after the loop.
+  rewriter.setInsertionPointAfter(newLoop);
+  SmallVector<Value> replacements(
+      newLoop.getResults().take_front(numIterArgs));
+  for (unsigned i = 0; i < numIterArgs; i++) {
+    if (reductionPos[i] < 0)
+      continue;
+    for (int64_t u = 1; u < factor; u++)
+      replacements[i] = createAdd(rewriter, loc, replacements[i],
+                                  newLoop.getResult(getAccumulatorPos(i, u)));
+  }
+  rewriter.replaceOp(target, replacements);
+
+  results.push_back(newLoop);
+  return DiagnosedSilenceableFailure::success();
+}
+
+//===----------------------------------------------------------------------===//
+// HoistLoopInvariantLoadsOp
+//===----------------------------------------------------------------------===//
+
+// Return true if `op`, or any operation nested in it, may write to `buffer`.
+// Operations of unknown effects are assumed to write to every buffer.
+static bool mayWriteTo(Operation *op, Value buffer) {
+  auto result = op->walk([&](Operation *nested) {
+    auto effectOp = dyn_cast<MemoryEffectOpInterface>(nested);
+    if (!effectOp) {
+      if (nested->hasTrait<OpTrait::HasRecursiveMemoryEffects>())
+        return WalkResult::advance();
+      return WalkResult::interrupt();
+    }
+    SmallVector<MemoryEffects::EffectInstance> effects;
+    effectOp.getEffects<MemoryEffects::Write>(effects);
+    for (MemoryEffects::EffectInstance &effect : effects)
+      if (!effect.getValue() || effect.getValue() == buffer)
+        return WalkResult::interrupt();
+    return WalkResult::advance();
+  });
+  return result.wasInterrupted();
+}
+
+DiagnosedSilenceableFailure transform::HoistLoopInvariantLoadsOp::applyToOne(
+    TransformRewriter &rewriter, LoopLikeOpInterface target,
+    ApplyToEachResultList &results, TransformState &state) {
+  SmallVector<Operation *> loads;
+  for (Region *region : target.getLoopRegions())
+    for (Operation &op : region->getOps())
+      if (isa<xilinx::aievec::UPDOp, vector::TransferReadOp>(op))
+        loads.push_back(&op);
+
+  for (Operation *op : loads) {
+    Value buffer;
+    if (auto updOp = dyn_cast<xilinx::aievec::UPDOp>(op))
+      buffer = updOp.getSource();
+    else
+      buffer = cast<vector::TransferReadOp>(op).getSource();
+    if (!llvm::all_of(op->getOperands(), [&](Value operand) {
+          return target.isDefinedOutsideOfLoop(operand);
+        }))
+      continue;
+    if (mayWriteTo(target, buffer))
+      continue;
+    rewriter.moveOpBefore(op, target);
+  }
+  return DiagnosedSilenceableFailure::success();
+}
+
+void transform::HoistLoopInvariantLoadsOp::getEffects(
+    SmallVectorImpl<MemoryEffects::EffectInstance> &effects) {
+  onlyReadsHandle(getTarget(), effects);
+  modifiesPayload(effects);
+}
+
 #define GET_OP_CLASSES
 #include "aie/Dialect/AIEVec/TransformOps/AIEVecTransformOps.cpp.inc"
@@ -8,7 +8,9 @@
 #include "aie/Dialect/AIEVec/IR/AIEVecDialect.h"
 #include "aie/Dialect/AIEVec/TransformOps/AIEVecTransformOps.h"
 
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Transform/IR/TransformDialect.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
 
@@ -26,6 +28,8 @@ public:
   void init() {
     declareDependentDialect<linalg::LinalgDialect>();
     declareDependentDialect<vector::VectorDialect>();
+    declareGeneratedDialect<arith::ArithDialect>();
+    declareGeneratedDialect<tensor::TensorDialect>();
 
     registerTransformOps<
 #define GET_OP_LIST
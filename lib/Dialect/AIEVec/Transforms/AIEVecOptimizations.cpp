@@ -22,6 +22,7 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/DialectConversion.h"
@@ -120,9 +121,74 @@ static bool singleColumnFMAOpCanFold(aievec::FMAOp fmaOp) {
   if (!isSingleColumnInt16VectorTimesScalarMac(accFmaOp))
     return false;
   return fmaOp.getRhs() == accFmaOp.getRhs() &&
+         fmaOp.getFmsub() == accFmaOp.getFmsub() &&
          !singleColumnFMAOpCanFold(accFmaOp);
 }
 
+// Returns the single-column i16 FMA op accumulated into `fmaOp` if `fmaOp` is
+// its only user, so that both belong to the same accumulation chain.
+static aievec::FMAOp getSingleColumnAccChainFMAOp(aievec::FMAOp fmaOp) {
+  auto accFmaOp = fmaOp.getAcc().getDefiningOp<aievec::FMAOp>();
+  if (!accFmaOp || !accFmaOp->hasOneUse() ||
+      !isSingleColumnInt16VectorTimesScalarMac(accFmaOp))
+    return nullptr;
+  return accFmaOp;
+}
+
+// Reorder the chains of single-column i16 FMA ops so that the ops sharing the
+// same rhs vector are next to each other, e.g., the chain of a 2D convolution
+// alternates between the rows of its filter. This lets every pair of them be
+// merged into a two-column FMA op. The accumulation is exact on integers, so
+// its order doesn't change the result.
+static void groupSingleColumnFMAChainsByRhs(Operation *root) {
+  SmallVector<aievec::FMAOp> chainTops;
+  root->walk([&](aievec::FMAOp fmaOp) {
+    if (!isSingleColumnInt16VectorTimesScalarMac(fmaOp))
+      return;
+    if (fmaOp->hasOneUse())
+      if (auto userOp = dyn_cast<aievec::FMAOp>(*fmaOp->user_begin()))
+        if (getSingleColumnAccChainFMAOp(userOp) == fmaOp)
+          return;
+    chainTops.push_back(fmaOp);
+  });
+
+  for (auto topOp : chainTops) {
+    SmallVector<aievec::FMAOp> chain({topOp});
+    while (auto accFmaOp = getSingleColumnAccChainFMAOp(chain.back()))
+      chain.push_back(accFmaOp);
+    if (chain.size() < 3)
+      continue;
+    std::reverse(chain.begin(), chain.end());
+
+    // Group the ops that can be merged, in the order of the first op of each
+    // group.
+    SmallVector<aievec::FMAOp> grouped;
+    for (auto fmaOp : chain) {
+      if (llvm::is_contained(grouped, fmaOp))
+        continue;
+      for (auto otherOp : chain)
+        if (otherOp.getRhs() == fmaOp.getRhs() &&
+            otherOp.getFmsub() == fmaOp.getFmsub())
+          grouped.push_back(otherOp);
+    }
+    if (grouped == chain)
+      continue;
+
+    OpBuilder builder(topOp);
+    Value acc = chain.front().getAcc();
+    for (auto fmaOp : grouped)
+      acc = builder
+                .create<aievec::FMAOp>(
+                    fmaOp.getLoc(), TypeRange({fmaOp.getResult().getType()}),
+                    ValueRange({fmaOp.getLhs(), fmaOp.getRhs(), acc}),
+                    fmaOp->getAttrs())
+                .getResult();
+    topOp.getResult().replaceAllUsesWith(acc);
+    for (auto fmaOp : llvm::reverse(chain))
+      fmaOp->erase();
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // Lowering patterns
 //===----------------------------------------------------------------------===//
@@ -143,7 +209,8 @@ struct MergeSingleColumnI16FMAOpPattern
       return failure();
     if (!isSingleColumnInt16VectorTimesScalarMac(accFmaOp))
       return failure();
-    if (adaptor.getRhs() != accFmaOp.getRhs())
+    if (adaptor.getRhs() != accFmaOp.getRhs() ||
+        fmaOp.getFmsub() != accFmaOp.getFmsub())
       return failure();
     auto accConcatOp =
         cast<aievec::ConcatOp>(accFmaOp.getLhs().getDefiningOp());
@@ -205,6 +272,64 @@ struct FoldAIECastOps : public OpConversionPattern<aievec::CastOp> {
     return success();
   }
 };
+// Keep the float accumulator of an `aievec.srs` op in the accumulator for the
+// `aievec.ups` op that moves it back, e.g., the result of a LUT-based exp
+// added to another value:
+//   %1 = aievec.srs %0, %c0 : vector<16xf32>, i32, vector<16xbf16>
+//   %2 = aievec.ups %1 {shift = 0 : i8} : vector<16xbf16>, vector<16xf32>
+// This skips the rounding of the intermediate value to bf16.
+struct FuseSRSIntoUPSPattern : public OpRewritePattern<aievec::UPSOp> {
+  using OpRewritePattern<aievec::UPSOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(aievec::UPSOp upsOp,
+                                PatternRewriter &rewriter) const override {
+    auto srsOp = upsOp.getSource().getDefiningOp<aievec::SRSOp>();
+    if (!srsOp || upsOp.getShift() != 0 ||
+        !matchPattern(srsOp.getShift(), m_Zero()) ||
+        srsOp.getSource().getType() != upsOp.getResult().getType() ||
+        !isa<FloatType>(getElementTypeOrSelf(upsOp.getResult().getType())))
+      return failure();
+
+    rewriter.replaceOp(upsOp, srsOp.getSource());
+    return success();
+  }
+};
+
+// Fold the move of a vector to an accumulator and back to a vector of the same
+// type, which is exact.
+struct FoldUPSIntoSRSPattern : public OpRewritePattern<aievec::SRSOp> {
+  using OpRewritePattern<aievec::SRSOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(aievec::SRSOp srsOp,
+                                PatternRewriter &rewriter) const override {
+    auto upsOp = srsOp.getSource().getDefiningOp<aievec::UPSOp>();
+    if (!upsOp || upsOp.getShift() != 0 ||
+        !matchPattern(srsOp.getShift(), m_Zero()) ||
+        upsOp.getSource().getType() != srsOp.getResult().getType())
+      return failure();
+
+    rewriter.replaceOp(srsOp, upsOp.getSource());
+    return success();
+  }
+};
+
+// Fold the move of an accumulator to a vector register and back.
+struct FoldAccumulatorCastPairPattern
+    : public OpRewritePattern<aievec::CastOp> {
+  using OpRewritePattern<aievec::CastOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(aievec::CastOp castOp,
+                                PatternRewriter &rewriter) const override {
+    auto defOp = castOp.getSource().getDefiningOp<aievec::CastOp>();
+    if (!defOp || defOp.getIsResAcc() == castOp.getIsResAcc() ||
+        defOp.getSource().getType() != castOp.getResult().getType())
+      return failure();
+
+    rewriter.replaceOp(castOp, defOp.getSource());
+    return success();
+  }
+};
+
 //===----------------------------------------------------------------------===//
 // Pattern collection
 //===----------------------------------------------------------------------===//
@@ -340,6 +465,7 @@ struct AIEVecTransformationPass
     }
 
     if (aieVersion == AIEArch::AIE) {
+      groupSingleColumnFMAChainsByRhs(op);
       populateAIEVecV1TransformationPatterns(patterns, backend);
       configureAIEVecV1TransformationLegalizations(target, backend);
     } else {
@@ -458,6 +584,60 @@ createAIEVecConvOpTransformationPass(const OptimizeAIEVecOptions &options) {
   return std::make_unique<AIEVecConvOpTransformationPass>(options);
 }
 
+// Remove the moves between accumulator and vector registers that the lowering
+// of each op of a chain of elementwise ops inserts on its own, e.g., the
+// SRS/UPS pairs between the LUT-based functions and the bf16 additions and
+// multiplications of a GELU or a SiLU. Unlike the AIEVec transformation pass,
+// this also applies to the moves whose result has other uses.
+// The ups(srs(acc)) pairs of float accumulators are only removed with
+// `fuse-srs-into-ups`, since that skips the rounding of the intermediate value.
+struct AIEVecFuseElementwiseChainsPass
+    : public PassWrapper<AIEVecFuseElementwiseChainsPass, OperationPass<>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(AIEVecFuseElementwiseChainsPass)
+
+  AIEVecFuseElementwiseChainsPass() = default;
+  AIEVecFuseElementwiseChainsPass(const AIEVecFuseElementwiseChainsPass &pass)
+      : PassWrapper(pass) {}
+
+  AIEVecFuseElementwiseChainsPass(const OptimizeAIEVecOptions &options)
+      : AIEVecFuseElementwiseChainsPass() {
+    fuseSRSIntoUPS = options.fuseSRSIntoUPS;
+  }
+
+  StringRef getArgument() const final {
+    return "test-aievec-fuse-elementwise-chains";
+  }
+  StringRef getDescription() const final {
+    return "Remove the register moves between the ops of elementwise chains.";
+  }
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<xilinx::aievec::AIEVecDialect>();
+  }
+
+  Option<bool> fuseSRSIntoUPS{
+      *this, "fuse-srs-into-ups",
+      llvm::cl::desc("Keep the float accumulator of an srs op moved back by an "
+                     "ups op, skipping the rounding of the intermediate "
+                     "value."),
+      llvm::cl::init(false)};
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<FoldUPSIntoSRSPattern, FoldAccumulatorCastPairPattern>(
+        context);
+    // This changes the numerics of the chain, so it is only done on request.
+    if (fuseSRSIntoUPS)
+      patterns.add<FuseSRSIntoUPSPattern>(context);
+    (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
+  }
+};
+
+static std::unique_ptr<::mlir::Pass>
+createAIEVecFuseElementwiseChainsPass(const OptimizeAIEVecOptions &options) {
+  return std::make_unique<AIEVecFuseElementwiseChainsPass>(options);
+}
+
 //============================================================================//
 //=============== Main AIEVec2AIEVec Pipeline Configuration ==================//
 //============================================================================//
@@ -467,6 +647,10 @@ void xilinx::aievec::buildOptimizeAIEVec(OpPassManager &pm,
   // Add AIEVec transformation pass.
   pm.addPass(createAIEVecTransformationPass(options));
 
+  // Keep the intermediate values of elementwise chains in their registers.
+  if (options.aieTarget == "aieml")
+    pm.addPass(createAIEVecFuseElementwiseChainsPass(options));
+
   pm.addPass(createCSEPass());
   pm.addPass(createCanonicalizerPass());
 
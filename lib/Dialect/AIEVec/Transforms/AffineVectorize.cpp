@@ -0,0 +1,341 @@
+//===- AffineVectorize.cpp - Cost-model-driven affine vectorization -------===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This file implements the choice of the vectorization factor of the innermost
+// affine loops for the AIE vectorizer. Each candidate number of lanes and
+// unroll factor is given an estimated number of cycles per element from the
+// resources of the target, and the loop is vectorized by the affine
+// super-vectorizer, then unrolled, with the cheapest one.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIEVec/Transforms/Passes.h"
+
+#include "mlir/Dialect/Affine/Analysis/LoopAnalysis.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Affine/LoopUtils.h"
+#include "mlir/Dialect/Affine/Utils.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FormatVariadic.h"
+
+#include <algorithm>
+#include <map>
+
+#define DEBUG_TYPE "aie-affine-vectorize"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::aievec;
+
+// The cycles of an iteration of a loop not overlapped with its body.
+static constexpr unsigned kLoopOverheadCycles = 2;
+// The bits loaded per cycle by each of the two load units, stored per cycle by
+// the store unit, and processed per cycle by the vector ALU.
+static constexpr unsigned kLoadBitsPerCycle = 256;
+static constexpr unsigned kNumLoadUnits = 2;
+static constexpr unsigned kStoreBitsPerCycle = 256;
+static constexpr unsigned kALUBitsPerCycle = 512;
+
+namespace {
+
+// The operations of the body of an innermost loop that the cost model counts.
+struct LoopProfile {
+  // The element type of the multiplied operands, or the widest element type
+  // loaded or stored if there is no multiplication.
+  Type elementType;
+  unsigned numLoads = 0, numStores = 0, numMuls = 0, numALUOps = 0;
+  std::optional<uint64_t> tripCount;
+  // The memrefs accessed along the induction variable.
+  SmallVector<MemRefType> memRefTypes;
+};
+
+// A number of lanes and an unroll factor, with their estimated cost, or the
+// reason why they were discarded.
+struct Candidate {
+  unsigned lanes, unrollFactor;
+  double cyclesPerElement = 0;
+  StringRef discarded;
+};
+
+} // namespace
+
+static unsigned getBitWidth(Type type) {
+  return getElementTypeOrSelf(type).getIntOrFloatBitWidth();
+}
+
+// Return the type of the operand of a multiplication before its extension.
+static Type getMulOperandType(Value operand) {
+  if (auto extOp = operand.getDefiningOp<arith::ExtSIOp>())
+    return extOp.getIn().getType();
+  if (auto extOp = operand.getDefiningOp<arith::ExtFOp>())
+    return extOp.getIn().getType();
+  return operand.getType();
+}
+
+// Count the loads, stores and vectorizable arithmetic of the body of `forOp`.
+// Loads and stores whose indices do not depend on the induction variable are
+// hoisted or broadcast by the vectorizer and are not counted. Fail if the
+// loop is not an innermost unit-step loop of scalar integer or float
+// arithmetic.
+static FailureOr<LoopProfile> getLoopProfile(affine::AffineForOp forOp) {
+  if (forOp.getStepAsInt() != 1)
+    return failure();
+
+  LoopProfile profile;
+  profile.tripCount = affine::getConstantTripCount(forOp);
+  Value iv = forOp.getInductionVar();
+  unsigned widestBits = 0;
+  auto recordAccess = [&](MemRefType memRefType, ValueRange indices) {
+    if (!llvm::is_contained(indices, iv))
+      return false;
+    profile.memRefTypes.push_back(memRefType);
+    unsigned bits = memRefType.getElementTypeBitWidth();
+    if (bits > widestBits) {
+      widestBits = bits;
+      if (!profile.numMuls)
+        profile.elementType = memRefType.getElementType();
+    }
+    return true;
+  };
+
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    if (op.getNumRegions())
+      return failure();
+    if (auto loadOp = dyn_cast<affine::AffineLoadOp>(op)) {
+      if (recordAccess(loadOp.getMemRefType(), loadOp.getMapOperands()))
+        profile.numLoads++;
+      continue;
+    }
+    if (auto storeOp = dyn_cast<affine::AffineStoreOp>(op)) {
+      if (recordAccess(storeOp.getMemRefType(), storeOp.getMapOperands()))
+        profile.numStores++;
+      continue;
+    }
+    if (op.getNumResults() != 1 || !op.getResult(0).getType().isIntOrFloat() ||
+        isa<arith::ConstantOp, arith::ExtSIOp, arith::ExtFOp, arith::TruncIOp,
+            arith::TruncFOp, affine::AffineApplyOp>(op))
+      continue;
+    if (isa<arith::MulIOp, arith::MulFOp>(op)) {
+      if (!profile.numMuls++)
+        profile.elementType = getMulOperandType(op.getOperand(0));
+      continue;
+    }
+    profile.numALUOps++;
+  }
+  if (!profile.elementType)
+    return failure();
+  return profile;
+}
+
+// The numbers of lanes of the multiplication schemes of the target for
+// `elementType`, the numbers of lanes supported by `aie-vectorize`.
+static SmallVector<unsigned> getMulLanes(Type elementType, bool aieml) {
+  unsigned bits = elementType.getIntOrFloatBitWidth();
+  if (isa<FloatType>(elementType))
+    return {aieml ? 16u : 8u};
+  if (aieml) {
+    if (bits == 32)
+      return {16};
+    if (bits == 16)
+      return {16, 32};
+    return {32};
+  }
+  return {bits == 32 ? 8u : 16u};
+}
+
+// The size in bits of an accumulator lane for a multiplication of
+// `elementType` operands.
+static unsigned getAccumulatorLaneBits(Type elementType, bool aieml) {
+  if (isa<FloatType>(elementType))
+    return 32;
+  unsigned bits = elementType.getIntOrFloatBitWidth();
+  if (aieml)
+    return bits <= 16 ? 32 : 64;
+  return bits <= 16 ? 48 : 80;
+}
+
+// The candidate numbers of lanes of a loop of profile `profile`.
+static SmallVector<unsigned> getCandidateLanes(const LoopProfile &profile,
+                                               bool aieml) {
+  if (profile.numMuls)
+    return getMulLanes(profile.elementType, aieml);
+  unsigned bits = getBitWidth(profile.elementType);
+  SmallVector<unsigned> lanes;
+  for (unsigned vectorBits = 256; vectorBits <= (aieml ? 512u : 1024u);
+       vectorBits *= 2)
+    if (vectorBits / bits > 1)
+      lanes.push_back(vectorBits / bits);
+  return lanes;
+}
+
+namespace {
+
+struct AIEAffineVectorize : AIEAffineVectorizeBase<AIEAffineVectorize> {
+  AIEAffineVectorize() = default;
+  void runOnOperation() override;
+
+private:
+  // Return the cost of vectorizing a loop of profile `profile` by `lanes` and
+  // unrolling it by `unrollFactor`.
+  Candidate getCandidate(const LoopProfile &profile, unsigned lanes,
+                         unsigned unrollFactor);
+  // Return the cheapest candidate for `forOp`, if any.
+  std::optional<Candidate> chooseCandidate(affine::AffineForOp forOp);
+};
+
+} // namespace
+
+Candidate AIEAffineVectorize::getCandidate(const LoopProfile &profile,
+                                           unsigned lanes,
+                                           unsigned unrollFactor) {
+  Candidate candidate{lanes, unrollFactor};
+  uint64_t elements = lanes * unrollFactor;
+  if (unrollFactor > 1 &&
+      (!profile.tripCount || *profile.tripCount % elements)) {
+    candidate.discarded = "remainder";
+    return candidate;
+  }
+  if (unalignedLoadsCheck) {
+    bool aligned = !profile.tripCount || *profile.tripCount % lanes == 0;
+    for (MemRefType memRefType : profile.memRefTypes)
+      for (int64_t size : memRefType.getShape().drop_front())
+        aligned &= ShapedType::isDynamic(size) || size % lanes == 0;
+    if (!aligned) {
+      candidate.discarded = "unaligned";
+      return candidate;
+    }
+  }
+
+  unsigned bits = getBitWidth(profile.elementType);
+  unsigned vectorBits = lanes * bits;
+  unsigned maxVectorBits =
+      vectorRegisterBits ? vectorRegisterBits : (aieml ? 6144u : 4096u);
+  unsigned maxAccumulatorBits = accumulatorRegisterBits
+                                    ? accumulatorRegisterBits
+                                    : (aieml ? 4096u : 3072u);
+  unsigned liveVectorBits = unrollFactor * profile.numLoads * vectorBits;
+  unsigned liveAccumulatorBits =
+      profile.numMuls ? unrollFactor * lanes *
+                            getAccumulatorLaneBits(profile.elementType, aieml)
+                      : 0;
+  if (liveVectorBits > maxVectorBits ||
+      liveAccumulatorBits > maxAccumulatorBits) {
+    candidate.discarded = "spills";
+    return candidate;
+  }
+
+  unsigned peakMulLanes = getMulLanes(profile.elementType, aieml).back();
+  double loadCycles = profile.numLoads *
+                      llvm::divideCeil(vectorBits, kLoadBitsPerCycle) /
+                      double(kNumLoadUnits);
+  double storeCycles =
+      profile.numStores * llvm::divideCeil(vectorBits, kStoreBitsPerCycle);
+  double mulCycles = profile.numMuls * llvm::divideCeil(lanes, peakMulLanes);
+  double aluCycles =
+      profile.numALUOps * llvm::divideCeil(vectorBits, kALUBitsPerCycle);
+  double cycles =
+      unrollFactor * std::max({loadCycles, storeCycles, mulCycles, aluCycles}) +
+      kLoopOverheadCycles;
+  candidate.cyclesPerElement = cycles / elements;
+  return candidate;
+}
+
+std::optional<Candidate>
+AIEAffineVectorize::chooseCandidate(affine::AffineForOp forOp) {
+  FailureOr<LoopProfile> profile = getLoopProfile(forOp);
+  if (failed(profile))
+    return std::nullopt;
+
+  // Consider the smaller unroll factors first, for the cheapest candidate to
+  // be the one of the least code on ties.
+  SmallVector<Candidate> candidates;
+  std::optional<Candidate> best;
+  for (unsigned unrollFactor = 1; unrollFactor <= maxUnrollFactor;
+       unrollFactor *= 2) {
+    for (unsigned lanes : getCandidateLanes(*profile, aieml)) {
+      Candidate candidate = getCandidate(*profile, lanes, unrollFactor);
+      candidates.push_back(candidate);
+      if (candidate.discarded.empty() &&
+          (!best || candidate.cyclesPerElement < best->cyclesPerElement))
+        best = candidate;
+    }
+  }
+
+  if (emitRemarks) {
+    std::string message;
+    llvm::raw_string_ostream os(message);
+    if (best)
+      os << llvm::formatv("vectorized by {0} lanes, unrolled by {1}: {2:F3} "
+                          "cycles per element",
+                          best->lanes, best->unrollFactor,
+                          best->cyclesPerElement);
+    else
+      os << "not vectorized";
+    os << " (";
+    llvm::interleaveComma(candidates, os, [&](const Candidate &c) {
+      os << c.lanes << "x" << c.unrollFactor << ": ";
+      if (c.discarded.empty())
+        os << llvm::formatv("{0:F3}", c.cyclesPerElement);
+      else
+        os << c.discarded;
+    });
+    os << ")";
+    forOp.emitRemark(os.str());
+  }
+  return best;
+}
+
+void AIEAffineVectorize::runOnOperation() {
+  func::FuncOp func = getOperation();
+  auto getInnermostLoops = [&]() {
+    SmallVector<affine::AffineForOp> loops;
+    func.walk([&](affine::AffineForOp forOp) {
+      if (!forOp.getBody()->walk([](affine::AffineForOp) {
+            return WalkResult::interrupt();
+          }).wasInterrupted())
+        loops.push_back(forOp);
+    });
+    return loops;
+  };
+
+  // Vectorize the loops that have a candidate, by number of lanes.
+  SmallVector<affine::AffineForOp> loops = getInnermostLoops();
+  SmallVector<std::optional<Candidate>> choices;
+  std::map<unsigned, DenseSet<Operation *>> loopsByLanes;
+  for (affine::AffineForOp forOp : loops) {
+    choices.push_back(chooseCandidate(forOp));
+    if (choices.back())
+      loopsByLanes[choices.back()->lanes].insert(forOp);
+  }
+  for (auto &[lanes, lanesLoops] : loopsByLanes)
+    affine::vectorizeAffineLoops(func, lanesLoops, {lanes},
+                                 /*fastestVaryingPattern=*/{});
+
+  // The vectorizer replaces each loop in place, so the innermost loops are
+  // found in the same order after it.
+  SmallVector<affine::AffineForOp> vectorizedLoops = getInnermostLoops();
+  if (vectorizedLoops.size() != loops.size()) {
+    LLVM_DEBUG(llvm::dbgs() << "Lost track of the vectorized loops\n");
+    return;
+  }
+  for (auto [forOp, choice] : llvm::zip(vectorizedLoops, choices)) {
+    if (!choice || choice->unrollFactor == 1 ||
+        forOp.getStepAsInt() != choice->lanes)
+      continue;
+    if (failed(affine::loopUnrollByFactor(forOp, choice->unrollFactor)))
+      LLVM_DEBUG(llvm::dbgs() << "Failed to unroll " << forOp << "\n");
+  }
+}
+
+std::unique_ptr<Pass> aievec::createAIEAffineVectorizePass() {
+  return std::make_unique<AIEAffineVectorize>();
+}
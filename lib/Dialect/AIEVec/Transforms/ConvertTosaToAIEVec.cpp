@@ -0,0 +1,79 @@
+//===- ConvertTosaToAIEVec.cpp - Lower TOSA to AIE vector -------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This is the implementation of the end-to-end pipeline from TOSA or Linalg
+// on tensors to AIEVec: the flow of the TOSA integration tests, with the loop
+// nests tiled in the work of the cores before they are vectorized.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIEVec/Pipelines/Passes.h"
+
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Pass/PassRegistry.h"
+
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FormatVariadic.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::aievec;
+
+// Appends the passes of the textual pipeline to the pass manager. The
+// pipelines are only built from the options of the pipeline, so a failure to
+// parse them is a bug.
+static void addPipeline(OpPassManager &pm, StringRef pipeline) {
+  std::string errors;
+  llvm::raw_string_ostream os(errors);
+  if (failed(parsePassPipeline(pipeline, pm, os)))
+    llvm::report_fatal_error(llvm::Twine("invalid pipeline: ") + os.str());
+}
+
+void xilinx::aievec::buildConvertTosaToAIEVec(
+    OpPassManager &pm, const ConvertTosaToAIEVecOptions &options) {
+  // TOSA to Linalg on tensors. The Linalg operations of the input are left
+  // as they are.
+  addPipeline(pm, "func.func(tosa-to-linalg-named,tosa-to-linalg,"
+                  "tosa-to-tensor)");
+
+  // Linalg on tensors to affine loop nests on memrefs, the buffers of the
+  // results becoming out parameters of the functions.
+  addPipeline(
+      pm, "dynamic-size-no-implicit-broadcast,linalg-fuse-elementwise-ops,"
+          "linalg-fold-unit-extent-dims,eliminate-empty-tensors,"
+          "empty-tensor-to-alloc-tensor,"
+          "one-shot-bufferize{allow-return-allocs-from-loops "
+          "allow-unknown-ops bufferize-function-boundaries "
+          "function-boundary-type-conversion=identity-layout-map "
+          "unknown-type-conversion=identity-layout-map},"
+          "drop-equivalent-buffer-results,buffer-results-to-out-params,"
+          "func.func(buffer-deallocation),canonicalize,cse,"
+          "convert-linalg-to-affine-loops");
+
+  // Tile the loop nests, each tile being the work of a core, then vectorize
+  // the innermost loops of the tiles.
+  if (options.tileSize)
+    addPipeline(pm, llvm::formatv("func.func(affine-loop-tile{{tile-size={0}})",
+                                  options.tileSize.getValue())
+                        .str());
+  addPipeline(pm, llvm::formatv("func.func(affine-super-vectorize{{"
+                                "virtual-vector-size={0}})",
+                                options.vectorSize.getValue())
+                      .str());
+
+  // Vector to AIEVec.
+  ConvertVectorToAIEVecOptions vectorOptions;
+  std::string vectorOptionsStr = llvm::formatv(
+      "aie-target={0} target-backend={1} shift={2}",
+      options.aieTarget.getValue(), options.targetBackend.getValue(),
+      options.shiftParam.getValue());
+  if (failed(vectorOptions.parseFromString(vectorOptionsStr)))
+    llvm::report_fatal_error("invalid convert-vector-to-aievec options");
+  buildConvertVectorToAIEVec(pm, vectorOptions);
+  addPipeline(pm, "lower-affine");
+}
@@ -148,6 +148,13 @@ void xilinx::aievec::registerAIEVecPipelines() {
       "architecture.",
       buildConvertVectorToAIEVec);
 
+  PassPipelineRegistration<ConvertTosaToAIEVecOptions>(
+      "convert-tosa-to-aievec",
+      "This pass pipeline takes \"TOSA\" or \"Linalg\" code on tensors, "
+      "tiles it in the work of the cores and converts it to \"AIEVec\" code "
+      "targeting the selected Xilinx AIE vector architecture.",
+      buildConvertTosaToAIEVec);
+
   PassPipelineRegistration<CanonicalizeVectorForAIEVecOptions>(
       "canonicalize-vector-for-aievec",
       "This pass pipeline takes standard \"Vector\" code and converts it to "
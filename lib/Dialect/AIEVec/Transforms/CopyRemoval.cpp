@@ -8,6 +8,7 @@
 
 #include "aie/Dialect/AIEVec/Pipelines/Passes.h"
 
+#include "mlir/Interfaces/CallInterfaces.h"
 #include "mlir/Interfaces/CopyOpInterface.h"
 #include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Pass/Pass.h"
@@ -58,6 +59,7 @@ public:
     getOperation()->walk([&](CopyOpInterface copyOp) {
       reuseCopySourceAsTarget(copyOp);
       reuseCopyTargetAsSource(copyOp);
+      reuseCopyTargetAsCallResult(copyOp);
     });
     for (std::pair<Value, Value> &pair : replaceList)
       pair.first.replaceAllUsesWith(pair.second);
@@ -233,6 +235,77 @@ private:
     eraseList.insert(fromDefiningOp);
     eraseList.insert(fromFreeingOp);
   }
+
+  /// Input:
+  /// core(){
+  ///   %from = alloc()
+  ///   %to = objectfifo.subview.access
+  ///   call @kernel(%in, %from)
+  ///   copy(%from,%to)
+  ///   release
+  /// }
+  ///
+  /// Output:
+  /// core(){
+  ///   %to = objectfifo.subview.access
+  ///   call @kernel(%in, %to)
+  ///   release
+  /// }
+  /// This is the pattern left at the boundary of external kernels, whose
+  /// results are written to a temporary buffer and then copied into the
+  /// acquired objectFifo element. The callee writes directly into the element
+  /// instead.
+  /// Constraints:
+  /// 1) %from must be allocated in the block of the copy and its only users
+  /// must be calls before the copy, the copy and an optional deallocation.
+  /// 2) %to must be defined before the first call and have the same type as
+  /// %from.
+  /// 3) This transformation cannot be applied if there is a single user/alias
+  /// of `to` value between the first call and the copy operation, or if an
+  /// operation with memory effects lies between them.
+  void reuseCopyTargetAsCallResult(CopyOpInterface copyOp) {
+    if (eraseList.count(copyOp))
+      return;
+
+    Value from = copyOp.getSource();
+    Value to = copyOp.getTarget();
+    if (from.getType() != to.getType())
+      return;
+
+    Operation *copy = copyOp.getOperation();
+    Block *copyBlock = copy->getBlock();
+    Operation *fromDefiningOp = getAllocationOpInBlock(from, copyBlock);
+    if (!fromDefiningOp || eraseList.count(fromDefiningOp))
+      return;
+
+    Operation *fromFreeingOp = getDeallocationOpInBlock(from, copyBlock);
+    Operation *firstCall = nullptr;
+    for (Operation *user : from.getUsers()) {
+      if (user == copy || user == fromFreeingOp)
+        continue;
+      if (!isa<CallOpInterface>(user) || user->getBlock() != copyBlock ||
+          !user->isBeforeInBlock(copy))
+        return;
+      if (!firstCall || user->isBeforeInBlock(firstCall))
+        firstCall = user;
+    }
+    if (!firstCall || (fromFreeingOp && fromFreeingOp->isBeforeInBlock(copy)))
+      return;
+
+    Operation *toDefiningOp = to.getDefiningOp();
+    if ((toDefiningOp && toDefiningOp->getBlock() == copyBlock &&
+         !toDefiningOp->isBeforeInBlock(firstCall)) ||
+        llvm::is_contained(firstCall->getOperands(), to) ||
+        hasUsersBetween(to, firstCall, copy) ||
+        hasMemoryEffectOpBetween(firstCall, copy))
+      return;
+
+    replaceList.insert({from, to});
+    eraseList.insert(copy);
+    eraseList.insert(fromDefiningOp);
+    if (fromFreeingOp)
+      eraseList.insert(fromFreeingOp);
+  }
 };
 
 } // end anonymous namespace
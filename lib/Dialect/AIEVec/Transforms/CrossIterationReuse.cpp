@@ -0,0 +1,297 @@
+//===- CrossIterationReuse.cpp - Reuse of vector windows across iterations ===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This file implements the reuse of the vector windows loaded by an iteration
+// of an innermost loop in the next one. Where IntervalReuse shares the loads
+// of the overlapping windows of one loop body, this pass carries the windows
+// of a row through the iter_args of the loop, so that the windows a sliding
+// kernel loads again at `i + step` are the windows it loaded at `i`, or their
+// shift.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIEVec/AIEVecUtils.h"
+#include "aie/Dialect/AIEVec/IR/AIEVecOps.h"
+#include "aie/Dialect/AIEVec/Transforms/Passes.h"
+
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
+
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "aievec-cross-iteration-reuse"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::aievec;
+
+namespace {
+
+// A vector window loaded by `op` in the body of a loop, from the row of
+// `memref` at `outerIndices`. The innermost index of the load is the
+// induction variable plus `indexOffset`, and the window starts `offset`
+// elements after the induction variable.
+struct Window {
+  Operation *op;
+  Value memref;
+  SmallVector<Value> outerIndices;
+  int64_t indexOffset;
+  int64_t offset;
+  VectorType type;
+
+  Value getResult() const { return op->getResult(0); }
+};
+
+// The window of the next iteration of `window`, which is `lhs` of the current
+// iteration if `rhs` is null, and the shift of `lhs` and `rhs` by `shiftBytes`
+// otherwise.
+struct Carry {
+  Window *window;
+  Window *lhs;
+  Window *rhs = nullptr;
+  int64_t shiftBytes = 0;
+};
+
+} // namespace
+
+// Return the constant that `index` adds to the induction variable `iv`, if it
+// is the sum of `iv` and a constant.
+static std::optional<int64_t> getOffsetFromIV(Value index, Value iv) {
+  if (index == iv)
+    return 0;
+  if (auto addOp = index.getDefiningOp<arith::AddIOp>()) {
+    if (addOp.getLhs() == iv)
+      return getConstantIntValue(addOp.getRhs());
+    if (addOp.getRhs() == iv)
+      return getConstantIntValue(addOp.getLhs());
+    return std::nullopt;
+  }
+  if (auto applyOp = index.getDefiningOp<affine::AffineApplyOp>()) {
+    AffineMap map = applyOp.getAffineMap();
+    if (map.getNumDims() != 1 || map.getNumSymbols() ||
+        applyOp.getMapOperands().front() != iv)
+      return std::nullopt;
+    AffineExpr offset = simplifyAffineExpr(
+        map.getResult(0) - getAffineDimExpr(0, map.getContext()), 1, 0);
+    if (auto cst = dyn_cast<AffineConstantExpr>(offset))
+      return cst.getValue();
+  }
+  return std::nullopt;
+}
+
+// Return the window loaded by `op` in the body of `forOp`, if `op` loads a
+// whole 1-D vector at an index sliding with the induction variable.
+static std::optional<Window> getWindow(Operation *op, scf::ForOp forOp) {
+  Value memref;
+  ValueRange indices;
+  int64_t extraOffset = 0;
+  if (auto updOp = dyn_cast<aievec::UPDOp>(op)) {
+    // A upd that updates a vector, or whose vector is then updated, loads only
+    // a part of its result.
+    if (updOp.getVector())
+      return std::nullopt;
+    if (llvm::any_of(updOp->getUsers(), [&](Operation *user) {
+          auto userUpd = dyn_cast<aievec::UPDOp>(user);
+          return userUpd && userUpd.getVector() == updOp.getResult();
+        }))
+      return std::nullopt;
+    memref = updOp.getSource();
+    indices = updOp.getIndices();
+    extraOffset = updOp.getOffset();
+  } else if (auto readOp = dyn_cast<vector::TransferReadOp>(op)) {
+    if (readOp.getMask() || !readOp.getPermutationMap().isMinorIdentity())
+      return std::nullopt;
+    for (unsigned dim = 0; dim < readOp.getTransferRank(); ++dim)
+      if (!readOp.isDimInBounds(dim))
+        return std::nullopt;
+    memref = readOp.getSource();
+    indices = readOp.getIndices();
+  } else {
+    return std::nullopt;
+  }
+
+  auto type = dyn_cast<VectorType>(op->getResult(0).getType());
+  if (!type || type.getRank() != 1 || indices.empty() ||
+      !forOp.isDefinedOutsideOfLoop(memref))
+    return std::nullopt;
+  SmallVector<Value> outerIndices(indices.drop_back());
+  if (!llvm::all_of(outerIndices, [&](Value index) {
+        return forOp.isDefinedOutsideOfLoop(index);
+      }))
+    return std::nullopt;
+  std::optional<int64_t> indexOffset =
+      getOffsetFromIV(indices.back(), forOp.getInductionVar());
+  if (!indexOffset)
+    return std::nullopt;
+  return Window{op,           memref, outerIndices, *indexOffset,
+                *indexOffset + extraOffset, type};
+}
+
+// Return true if `a` and `b` are loaded the same way from the same row.
+static bool isSameRow(const Window &a, const Window &b) {
+  return a.op->getName() == b.op->getName() && a.memref == b.memref &&
+         a.outerIndices == b.outerIndices && a.type == b.type;
+}
+
+// Load `window` for the first iteration of `forOp`, before the loop.
+static Value loadFirstWindow(IRRewriter &rewriter, scf::ForOp forOp,
+                             const Window &window) {
+  Location loc = window.op->getLoc();
+  Value index = forOp.getLowerBound();
+  if (window.indexOffset) {
+    Value offset =
+        rewriter.create<arith::ConstantIndexOp>(loc, window.indexOffset);
+    index = rewriter.create<arith::AddIOp>(loc, index, offset);
+  }
+  // Both kinds of loads take the memref, then the indices, as operands.
+  IRMapping mapping;
+  mapping.map(window.op->getOperand(1 + window.outerIndices.size()), index);
+  return rewriter.clone(*window.op, mapping)->getResult(0);
+}
+
+namespace {
+
+struct AIEVecCrossIterationReuse
+    : AIEVecCrossIterationReuseBase<AIEVecCrossIterationReuse> {
+  AIEVecCrossIterationReuse() = default;
+  void runOnOperation() override;
+
+private:
+  // Find how the windows of a loop of step `step` are built from the windows
+  // of the previous iteration.
+  SmallVector<Carry> getCarries(SmallVectorImpl<Window> &windows,
+                                int64_t step);
+  // Carry the windows of `forOp` that can be built from those of the
+  // previous iteration through iter_args.
+  void reuseWindows(scf::ForOp forOp);
+};
+
+} // namespace
+
+SmallVector<Carry>
+AIEVecCrossIterationReuse::getCarries(SmallVectorImpl<Window> &windows,
+                                      int64_t step) {
+  SmallVector<Carry> carries;
+  for (Window &window : windows) {
+    // The window of the next iteration starts `step` elements later.
+    int64_t next = window.offset + step;
+    Window *lhs = nullptr, *rhs = nullptr;
+    for (Window &other : windows)
+      if (isSameRow(window, other) && other.offset == next)
+        lhs = &other;
+    if (lhs) {
+      carries.push_back({&window, lhs});
+      continue;
+    }
+
+    unsigned elWidth = window.type.getElementTypeBitWidth();
+    int64_t lanes = window.type.getNumElements();
+    if (!shiftWindows || lanes * elWidth != 512 || elWidth % 8)
+      continue;
+    // Otherwise, the next window may start in a window `lhs` of the current
+    // iteration followed by a window `rhs`.
+    for (Window &other : windows)
+      if (isSameRow(window, other) && other.offset < next &&
+          next < other.offset + lanes)
+        lhs = &other;
+    if (!lhs)
+      continue;
+    for (Window &other : windows)
+      if (isSameRow(window, other) && other.offset == lhs->offset + lanes)
+        rhs = &other;
+    if (!rhs)
+      continue;
+    carries.push_back(
+        {&window, lhs, rhs, (next - lhs->offset) * (elWidth / 8)});
+  }
+  // Each window is built from a window starting after it, so the window of
+  // a row starting last is always loaded, and the carries are not cyclic.
+  return carries;
+}
+
+void AIEVecCrossIterationReuse::reuseWindows(scf::ForOp forOp) {
+  std::optional<int64_t> lb = getConstantIntValue(forOp.getLowerBound());
+  std::optional<int64_t> ub = getConstantIntValue(forOp.getUpperBound());
+  std::optional<int64_t> step = getConstantIntValue(forOp.getStep());
+  if (!lb || !ub || !step || *step <= 0 || *ub <= *lb)
+    return;
+
+  SmallVector<Window> windows;
+  for (Operation &op : forOp.getBody()->without_terminator())
+    if (std::optional<Window> window = getWindow(&op, forOp))
+      if (!mayWriteTo(forOp, window->memref))
+        windows.push_back(*window);
+
+  SmallVector<Carry> carries = getCarries(windows, *step);
+  if (carries.empty())
+    return;
+  LLVM_DEBUG(llvm::dbgs() << "Carrying " << carries.size() << " windows of "
+                          << forOp << "\n");
+
+  IRRewriter rewriter(forOp.getContext());
+  rewriter.setInsertionPoint(forOp);
+  SmallVector<Value> inits;
+  for (Carry &carry : carries)
+    inits.push_back(loadFirstWindow(rewriter, forOp, *carry.window));
+
+  auto loopOp = cast<LoopLikeOpInterface>(forOp.getOperation());
+  FailureOr<LoopLikeOpInterface> newLoop = loopOp.replaceWithAdditionalYields(
+      rewriter, inits, /*replaceInitOperandUsesInLoop=*/false,
+      [&](OpBuilder &b, Location loc,
+          ArrayRef<BlockArgument> newBbArgs) -> SmallVector<Value> {
+        SmallVector<Value> yields;
+        for (Carry &carry : carries) {
+          if (!carry.rhs) {
+            yields.push_back(carry.lhs->getResult());
+            continue;
+          }
+          Value shift = b.create<arith::ConstantOp>(
+              loc, b.getI32IntegerAttr(carry.shiftBytes));
+          yields.push_back(b.create<aievec::ShiftOp>(
+              loc, carry.window->type, carry.lhs->getResult(),
+              carry.rhs->getResult(), shift));
+        }
+        return yields;
+      });
+  if (failed(newLoop))
+    return;
+
+  // The loads of the carried windows are replaced by the iter_args, including
+  // in the windows built for the next iteration.
+  ArrayRef<BlockArgument> newIterArgs =
+      newLoop->getRegionIterArgs().take_back(carries.size());
+  for (auto [carry, iterArg] : llvm::zip(carries, newIterArgs)) {
+    rewriter.replaceAllUsesWith(carry.window->getResult(), iterArg);
+    rewriter.eraseOp(carry.window->op);
+  }
+}
+
+void AIEVecCrossIterationReuse::runOnOperation() {
+  SmallVector<scf::ForOp> loops;
+  getOperation()->walk([&](scf::ForOp forOp) {
+    bool isInnermost = !forOp.getBody()
+                            ->walk([](LoopLikeOpInterface) {
+                              return WalkResult::interrupt();
+                            })
+                            .wasInterrupted();
+    if (isInnermost)
+      loops.push_back(forOp);
+  });
+  for (scf::ForOp forOp : loops)
+    reuseWindows(forOp);
+}
+
+std::unique_ptr<Pass> aievec::createAIEVecCrossIterationReusePass() {
+  return std::make_unique<AIEVecCrossIterationReuse>();
+}
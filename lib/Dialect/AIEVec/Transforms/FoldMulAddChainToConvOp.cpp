@@ -35,6 +35,12 @@ namespace xilinx::aievec {
 #include "aie/Dialect/AIEVec/Analysis/Passes.h.inc"
 } // namespace xilinx::aievec
 
+// Return the number of taps of the filter of the mul_conv/fma_conv ops of
+// AIE-ML for elements of `elemWidth` bits.
+static int32_t getConvFilterTaps(unsigned elemWidth) {
+  return elemWidth == 8 ? 8 : 4;
+}
+
 /// This analysis builds the longest possible chain of MAC operations whose
 /// operands are a vector that may or may not be shifted, and a broadcast.
 /// That is, these MACs represent `vector x scalar` ops, and are candidates to
@@ -149,10 +155,7 @@ struct LongestConvMACChainAnalysis {
     for (const auto &convMac : *convMacChain) {
       if (grpCurIdx > grpStartIdx) {
         if (curLhs != convMac->lhs || curRhs != convMac->rhs) {
-          groupsInChain.push_back({grpStartIdx, grpCurIdx,
-                                   getGroupSignalShift(grpStartIdx, grpCurIdx),
-                                   getGroupBcastShift(grpStartIdx, grpCurIdx),
-                                   getGroupBcastDist(grpStartIdx, grpCurIdx)});
+          addGroupsOfTaps(grpStartIdx, grpCurIdx);
           grpStartIdx = grpCurIdx;
           curLhs = convMac->lhs;
           curRhs = convMac->rhs;
@@ -161,13 +164,32 @@ struct LongestConvMACChainAnalysis {
       grpCurIdx++;
     }
     if (grpStartIdx < grpCurIdx)
-      groupsInChain.push_back({grpStartIdx, grpCurIdx,
-                               getGroupSignalShift(grpStartIdx, grpCurIdx),
-                               getGroupBcastShift(grpStartIdx, grpCurIdx),
-                               getGroupBcastDist(grpStartIdx, grpCurIdx)});
+      addGroupsOfTaps(grpStartIdx, grpCurIdx);
     return groupsInChain;
   }
 
+  // Add the MACs in [fromIdx, toIdx), which share their sources, to the list
+  // of groups, split in groups of at most the number of taps of a convolution
+  // op. E.g., the five MACs of a row of a 5x5 i16 filter become a group of
+  // four MACs, folded into a 4-tap convolution, and a group of one, whose
+  // convolution starts four elements further in the signal and the filter.
+  void addGroupsOfTaps(uint64_t fromIdx, uint64_t toIdx) {
+    auto signalVecTy =
+        cast<VectorType>((*convMacChain)[fromIdx]->lhs.getType());
+    uint64_t maxTaps = getConvFilterTaps(getElementSizeInBits(signalVecTy));
+    int64_t signalShift = getGroupSignalShift(fromIdx, toIdx);
+    int64_t bcastDist = getGroupBcastDist(fromIdx, toIdx);
+    for (uint64_t grpFromIdx = fromIdx; grpFromIdx < toIdx;
+         grpFromIdx += maxTaps) {
+      uint64_t grpToIdx = std::min(toIdx, grpFromIdx + maxTaps);
+      int64_t grpSignalShift =
+          signalShift == -1 ? -1 : signalShift + (grpFromIdx - fromIdx);
+      groupsInChain.push_back({grpFromIdx, grpToIdx, grpSignalShift,
+                               getGroupBcastShift(grpFromIdx, grpToIdx),
+                               bcastDist});
+    }
+  }
+
   // Return the signal shift for the group in the MAC chain in [fromIdx, toIdx)
   // the top. This method verifies that the elements of the signal are
   // contiguously accessed. If they do not, or the specified group doesn't
@@ -419,7 +441,7 @@ struct FoldMulAddChainToConvOpPattern
     unsigned elemWidth = cast<IntegerType>(vecTy.getElementType()).getWidth();
     unsigned accWidth = elemWidth <= 8 ? 32 : 64;
     int32_t M = elemWidth == 8 ? 32 : 16;
-    int32_t N = elemWidth == 8 ? 8 : 4;
+    int32_t N = getConvFilterTaps(elemWidth);
 
     Type wideElemTy = IntegerType::get(getContext(), accWidth);
     Type accVecTy = VectorType::get(vecTy.getShape(), wideElemTy);
@@ -0,0 +1,298 @@
+//===- SoftwarePipeline.cpp - Software pipelining of AIEVec loops ---------===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This file implements the software pipelining of the innermost loops of
+// AIEVec code. The vector loads and the computation of their indices form the
+// first stage of the pipeline, and the multiplications, MACs, SRS and stores
+// the second one, so that the loads of an iteration overlap with the compute
+// of the previous one. The rotation itself is done by the SCF loop pipeliner;
+// this pass builds the schedule and estimates the register pressure of the
+// pipelined loop.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIEVec/AIEVecUtils.h"
+#include "aie/Dialect/AIEVec/IR/AIEVecOps.h"
+#include "aie/Dialect/AIEVec/Transforms/Passes.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SCF/Transforms/Patterns.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "aievec-software-pipeline"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::aievec;
+
+namespace {
+
+// The two stages of the pipeline.
+enum : unsigned { LoadStage = 0, ComputeStage = 1 };
+
+// The number of bits of the registers live at the same time, for the vector
+// and the accumulator register files.
+struct RegisterPressure {
+  unsigned vectorBits = 0;
+  unsigned accumulatorBits = 0;
+};
+
+} // namespace
+
+// Return the memref loaded by `op` if it is a vector load, null otherwise.
+static Value getLoadedMemRef(Operation *op) {
+  if (auto updOp = dyn_cast<aievec::UPDOp>(op))
+    return updOp.getSource();
+  if (auto readOp = dyn_cast<vector::TransferReadOp>(op))
+    return readOp.getSource();
+  if (auto loadOp = dyn_cast<vector::LoadOp>(op))
+    return loadOp.getBase();
+  return nullptr;
+}
+
+// Return true if the result of `op` lives in an accumulator register.
+static bool isAccumulatorProducer(Operation *op) {
+  return isa<aievec::UPSOp, aievec::MulOp, aievec::FMAOp, aievec::MulElemOp,
+             aievec::FMAElemOp, aievec::MulConvOp, aievec::FMAConvOp>(op);
+}
+
+static unsigned getVectorBits(Type type) {
+  auto vecType = dyn_cast<VectorType>(type);
+  if (!vecType)
+    return 0;
+  return vecType.getNumElements() * vecType.getElementTypeBitWidth();
+}
+
+// Return the operations of the body of `forOp` that compute the operands of
+// `loadOp`, with `loadOp` itself, in the order of the body. Fail if any of them
+// depends on an iter_arg of the loop or is not free of memory effects, so that
+// the load cannot be issued an iteration ahead.
+static FailureOr<SmallVector<Operation *>>
+getLoadSlice(scf::ForOp forOp, Operation *loadOp) {
+  Block *body = forOp.getBody();
+  llvm::SetVector<Operation *> slice;
+  SmallVector<Operation *> worklist{loadOp};
+  while (!worklist.empty()) {
+    Operation *op = worklist.pop_back_val();
+    if (!slice.insert(op))
+      continue;
+    for (Value operand : op->getOperands()) {
+      if (auto arg = dyn_cast<BlockArgument>(operand)) {
+        if (arg.getOwner() == body && arg != forOp.getInductionVar())
+          return failure();
+        continue;
+      }
+      Operation *def = operand.getDefiningOp();
+      if (def->getBlock() != body)
+        continue;
+      if (!isMemoryEffectFree(def) || def->getNumRegions())
+        return failure();
+      worklist.push_back(def);
+    }
+  }
+  SmallVector<Operation *> ops(slice.begin(), slice.end());
+  llvm::sort(ops,
+             [](Operation *a, Operation *b) { return a->isBeforeInBlock(b); });
+  return ops;
+}
+
+// Assign each operation of the body of `forOp` to a stage: the vector loads of
+// buffers not written in the loop, and the operations computing their
+// indices, to the load stage, the rest to the compute stage. Fail if there is
+// no load to move.
+static FailureOr<DenseMap<Operation *, unsigned>> getStages(scf::ForOp forOp) {
+  Block *body = forOp.getBody();
+  DenseMap<Operation *, unsigned> stages;
+  for (Operation &op : body->without_terminator())
+    stages[&op] = ComputeStage;
+
+  bool hasLoad = false;
+  for (Operation &op : body->without_terminator()) {
+    Value memref = getLoadedMemRef(&op);
+    if (!memref || mayWriteTo(forOp, memref))
+      continue;
+    auto slice = getLoadSlice(forOp, &op);
+    if (failed(slice))
+      continue;
+    for (Operation *sliceOp : *slice)
+      stages[sliceOp] = LoadStage;
+    hasLoad = true;
+  }
+  if (!hasLoad)
+    return failure();
+  return stages;
+}
+
+// Estimate the register pressure of the body of `forOp` as the largest number
+// of vector and accumulator bits live at any of its operations.
+static RegisterPressure getMaxPressure(scf::ForOp forOp) {
+  Block *body = forOp.getBody();
+  DenseMap<Operation *, int> positions;
+  int position = 0;
+  for (Operation &op : *body)
+    positions[&op] = position++;
+
+  // The position of the last use of a value in the body. Uses nested in the
+  // regions of an operation are uses by that operation.
+  auto getLastUse = [&](Value value) {
+    int last = -1;
+    for (Operation *user : value.getUsers())
+      if (Operation *ancestor = body->findAncestorOpInBlock(*user))
+        last = std::max(last, positions[ancestor]);
+    return last;
+  };
+
+  // Each value live in the body: its definition, its last use and whether it
+  // lives in an accumulator. The iter_args are defined before the first
+  // operation, and live in an accumulator when their yielded value does.
+  struct LiveRange {
+    int def, lastUse;
+    unsigned bits;
+    bool accumulator;
+  };
+  SmallVector<LiveRange> ranges;
+  auto yieldOp = cast<scf::YieldOp>(body->getTerminator());
+  for (auto [arg, yielded] :
+       llvm::zip(forOp.getRegionIterArgs(), yieldOp.getOperands())) {
+    unsigned bits = getVectorBits(arg.getType());
+    if (!bits)
+      continue;
+    Operation *def = yielded.getDefiningOp();
+    ranges.push_back({-1, getLastUse(arg), bits,
+                      def && isAccumulatorProducer(def)});
+  }
+  for (Operation &op : body->without_terminator())
+    for (Value result : op.getResults())
+      if (unsigned bits = getVectorBits(result.getType()))
+        ranges.push_back({positions[&op], getLastUse(result), bits,
+                          isAccumulatorProducer(&op)});
+
+  RegisterPressure maxPressure;
+  for (int p = 0; p < position; p++) {
+    RegisterPressure pressure;
+    for (LiveRange &range : ranges) {
+      if (range.def >= p || range.lastUse < p)
+        continue;
+      if (range.accumulator)
+        pressure.accumulatorBits += range.bits;
+      else
+        pressure.vectorBits += range.bits;
+    }
+    maxPressure.vectorBits =
+        std::max(maxPressure.vectorBits, pressure.vectorBits);
+    maxPressure.accumulatorBits =
+        std::max(maxPressure.accumulatorBits, pressure.accumulatorBits);
+  }
+  return maxPressure;
+}
+
+// The number of bits of the vectors loaded in the load stage and used in the
+// compute stage, which the pipelined loop keeps live for two iterations.
+static unsigned
+getCrossStageBits(scf::ForOp forOp,
+                  const DenseMap<Operation *, unsigned> &stages) {
+  unsigned bits = 0;
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    if (stages.lookup(&op) != LoadStage)
+      continue;
+    for (Value result : op.getResults()) {
+      bool usedInCompute =
+          llvm::any_of(result.getUsers(), [&](Operation *user) {
+            Operation *ancestor =
+                forOp.getBody()->findAncestorOpInBlock(*user);
+            return !ancestor || isa<scf::YieldOp>(ancestor) ||
+                   stages.lookup(ancestor) == ComputeStage;
+          });
+      if (usedInCompute)
+        bits += getVectorBits(result.getType());
+    }
+  }
+  return bits;
+}
+
+// Return true if `forOp` is an innermost loop of AIEVec code.
+static bool isAIEVecInnermostLoop(scf::ForOp forOp) {
+  bool hasAIEVecOp = false;
+  auto result = forOp.getBody()->walk([&](Operation *op) {
+    if (isa<LoopLikeOpInterface>(op))
+      return WalkResult::interrupt();
+    if (isa_and_nonnull<AIEVecDialect>(op->getDialect()))
+      hasAIEVecOp = true;
+    return WalkResult::advance();
+  });
+  return hasAIEVecOp && !result.wasInterrupted();
+}
+
+namespace {
+
+struct AIEVecSoftwarePipeline
+    : AIEVecSoftwarePipelineBase<AIEVecSoftwarePipeline> {
+  AIEVecSoftwarePipeline() = default;
+  void runOnOperation() override;
+
+private:
+  // Pipeline `forOp` if it has loads to move and fits in the registers.
+  void pipelineLoop(scf::ForOp forOp);
+};
+
+} // namespace
+
+void AIEVecSoftwarePipeline::pipelineLoop(scf::ForOp forOp) {
+  auto stages = getStages(forOp);
+  if (failed(stages)) {
+    LLVM_DEBUG(llvm::dbgs() << "No load to pipeline in " << forOp << "\n");
+    return;
+  }
+
+  RegisterPressure pressure = getMaxPressure(forOp);
+  unsigned pipelinedVectorBits =
+      pressure.vectorBits + getCrossStageBits(forOp, *stages);
+  LLVM_DEBUG(llvm::dbgs() << "Pipelined loop needs " << pipelinedVectorBits
+                          << " vector bits and " << pressure.accumulatorBits
+                          << " accumulator bits\n");
+  if (pipelinedVectorBits > vectorRegisterBits ||
+      pressure.accumulatorBits > accumulatorRegisterBits)
+    return;
+
+  // The kernel of the pipelined loop issues the loads of the next iteration
+  // first, for the scheduler of the backend to overlap them with the compute.
+  scf::PipeliningOption options;
+  options.getScheduleFn =
+      [&](scf::ForOp loop,
+          std::vector<std::pair<Operation *, unsigned>> &schedule) {
+        for (unsigned stage : {LoadStage, ComputeStage})
+          for (Operation &op : loop.getBody()->without_terminator())
+            if (stages->lookup(&op) == stage)
+              schedule.emplace_back(&op, stage);
+      };
+
+  IRRewriter rewriter(forOp.getContext());
+  if (failed(scf::pipelineForLoop(rewriter, forOp, options)))
+    LLVM_DEBUG(llvm::dbgs() << "Failed to pipeline " << forOp << "\n");
+}
+
+void AIEVecSoftwarePipeline::runOnOperation() {
+  SmallVector<scf::ForOp> loops;
+  getOperation()->walk([&](scf::ForOp forOp) {
+    if (isAIEVecInnermostLoop(forOp))
+      loops.push_back(forOp);
+  });
+  for (scf::ForOp forOp : loops)
+    pipelineLoop(forOp);
+}
+
+std::unique_ptr<Pass> aievec::createAIEVecSoftwarePipelinePass() {
+  return std::make_unique<AIEVecSoftwarePipeline>();
+}
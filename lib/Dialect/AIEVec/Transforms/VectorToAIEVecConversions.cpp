@@ -155,6 +155,12 @@ convertValueToTargetTypeAieML(ConversionPatternRewriter &rewriter, Location loc,
       auto unpackOp = rewriter.create<aievec::UnpackOp>(loc, tgtType, inputVal);
       return unpackOp.getResult();
     }
+
+    if (srcBitWidth == 4 && tgtBitWidth == 8 && srcLaneSize == 64) {
+      // Case 4: vector<64xi4> to vector<64xi8> conversion by aievec.unpack
+      auto unpackOp = rewriter.create<aievec::UnpackOp>(loc, tgtType, inputVal);
+      return unpackOp.getResult();
+    }
   }
 
   return std::nullopt;
@@ -293,6 +299,12 @@ SmallVector<NamedAttribute> buildFMAOpSplatAttrForElemTy(aievec::FMAOp fmaOp,
 
 } // namespace xilinx::aievec
 
+// Return true if the bf16 exponentials of `laneSize` lanes are lowered to a
+// LUT-based function call when the "exp-lut-lanes" option is `lutLanes`.
+static bool isExpLUTLaneSize(unsigned laneSize, unsigned lutLanes) {
+  return laneSize == 16 || (laneSize == 32 && lutLanes == 32);
+}
+
 template <typename SrcOpTy, typename AIEv2ElemOp>
 static LogicalResult genAddElemAieML(ConversionPatternRewriter &rewriter,
                                      Value lval, Value rval, VectorType srcType,
@@ -1752,10 +1764,14 @@ struct FuseExtIntoUPDPattern : OpConversionPattern<aievec::ExtOp> {
   }
 };
 
-// Lower ExpOp to function call
+// Lower ExpOp to function call. The 16-lane exponentials are always lowered,
+// and the 32-lane ones when `lanes` is 32.
 struct ComputeExpOpByLUTPattern : OpConversionPattern<math::ExpOp> {
   using OpConversionPattern::OpConversionPattern;
 
+  ComputeExpOpByLUTPattern(MLIRContext *context, unsigned lanes)
+      : OpConversionPattern(context), lanes(lanes) {}
+
   LogicalResult
   matchAndRewrite(math::ExpOp expOp, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
@@ -1767,7 +1783,8 @@ struct ComputeExpOpByLUTPattern : OpConversionPattern<math::ExpOp> {
     Type scalarType = srcType.getElementType();
     unsigned elWidth = scalarType.getIntOrFloatBitWidth();
     unsigned laneSize = getVectorLaneSize(srcType);
-    if (!isa<FloatType>(scalarType) || laneSize != 16 || elWidth != 16)
+    if (!isa<FloatType>(scalarType) || !isExpLUTLaneSize(laneSize, lanes) ||
+        elWidth != 16)
       return failure();
 
     StringRef includeName = "lut_based_ops.h";
@@ -1790,6 +1807,8 @@ struct ComputeExpOpByLUTPattern : OpConversionPattern<math::ExpOp> {
 
     return success();
   }
+
+  unsigned lanes;
 };
 
 // Lower the inverse of a float to a function call
@@ -2049,6 +2068,28 @@ struct LowerExtOpPattern : OpConversionPattern<SrcOpTy> {
 using LowerExtFOpPattern = LowerExtOpPattern<arith::ExtFOp>;
 using LowerExtSIOpPattern = LowerExtOpPattern<arith::ExtSIOp>;
 
+// Sign extend a vector<64xi4> to a vector<64xi8> with aievec.unpack, e.g. the
+// int4 weights of an int8 matrix multiplication which can't use them packed.
+struct LowerExtSIOpToUnpackPattern : OpConversionPattern<arith::ExtSIOp> {
+  LowerExtSIOpToUnpackPattern(MLIRContext *context)
+      : OpConversionPattern(context, /*benefit=*/2) {}
+
+  LogicalResult
+  matchAndRewrite(arith::ExtSIOp extOp, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    VectorType srcType = dyn_cast<VectorType>(extOp.getIn().getType());
+    VectorType dstType = dyn_cast<VectorType>(extOp.getOut().getType());
+    if (!srcType || !dstType || !srcType.getElementType().isInteger(4) ||
+        !dstType.getElementType().isInteger(8) ||
+        getVectorLaneSize(srcType) != 64)
+      return failure();
+
+    rewriter.replaceOpWithNewOp<aievec::UnpackOp>(extOp, dstType,
+                                                  adaptor.getIn());
+    return success();
+  }
+};
+
 template <typename SrcOpTy>
 struct LowerTruncOpPattern : OpConversionPattern<SrcOpTy> {
   using OpConversionPattern<SrcOpTy>::OpConversionPattern;
@@ -2640,7 +2681,8 @@ static void populateAIEVecV1ConversionPatterns(RewritePatternSet &patterns,
 }
 
 static void populateAIEVecV2ConversionPatterns(RewritePatternSet &patterns,
-                                               TargetBackend backend) {
+                                               TargetBackend backend,
+                                               unsigned expLUTLanes) {
   if (backend == TargetBackend::CPP) {
     patterns.add<LowerVectorTransferReadToAIEUPD>(patterns.getContext(), 128,
                                                   1024, 256, 1024);
@@ -2650,7 +2692,6 @@ static void populateAIEVecV2ConversionPatterns(RewritePatternSet &patterns,
   patterns.add<
       LowerVectorAddIOpToAIEVecAddElemOp,
       LowerVectorSubIOpToAIEVecSubElemOp,
-      ComputeExpOpByLUTPattern,
       ComputeInvOpByLUTPattern,
       ComputeTanhOpByLUTPattern,
       ComputeSqrtOpPattern,
@@ -2690,6 +2731,7 @@ static void populateAIEVecV2ConversionPatterns(RewritePatternSet &patterns,
   patterns.add<LowerVectorContractionOpToAIEVecMatMulPattern
       >(patterns.getContext(), backend == TargetBackend::CPP);
   // clang-format on
+  patterns.add<ComputeExpOpByLUTPattern>(patterns.getContext(), expLUTLanes);
 }
 
 //===----------------------------------------------------------------------===//
@@ -2754,14 +2796,15 @@ static bool isInSigmoidOperationChain(math::ExpOp expOp) {
 }
 
 static void configureAIEVecCommonLegalizations(ConversionTarget &target,
-                                               TargetBackend backend) {
+                                               TargetBackend backend,
+                                               unsigned expLUTLanes) {
   target.addLegalDialect<xilinx::aievec::AIEVecDialect, arith::ArithDialect,
                          emitc::EmitCDialect>();
   if (backend == TargetBackend::CPP) {
     target.addIllegalOp<vector::TransferReadOp>();
   }
   target.addIllegalOp<vector::ExtractStridedSliceOp>();
-  target.addDynamicallyLegalOp<math::ExpOp>([](math::ExpOp expOp) {
+  target.addDynamicallyLegalOp<math::ExpOp>([=](math::ExpOp expOp) {
     auto srcType = dyn_cast<VectorType>(expOp.getOperand().getType());
     if (!srcType)
       return true;
@@ -2769,7 +2812,8 @@ static void configureAIEVecCommonLegalizations(ConversionTarget &target,
     Type scalarType = srcType.getElementType();
     unsigned elWidth = scalarType.getIntOrFloatBitWidth();
     unsigned laneSize = getVectorLaneSize(srcType);
-    if (!isa<FloatType>(scalarType) || laneSize != 16 || elWidth != 16)
+    if (!isa<FloatType>(scalarType) ||
+        !isExpLUTLaneSize(laneSize, expLUTLanes) || elWidth != 16)
       return true;
     if (expOp->hasOneUse() && isInSigmoidOperationChain(expOp))
       return true;
@@ -3290,6 +3334,7 @@ struct LowerVectorToAIEVec : PassWrapper<LowerVectorToAIEVec, OperationPass<>> {
       : LowerVectorToAIEVec() {
     aieTarget = options.aieTarget;
     targetBackend = options.targetBackend;
+    expLUTLanes = options.expLUTLanes;
   }
 
   // In case we want to register this pass as a standalone pass for test
@@ -3317,6 +3362,13 @@ struct LowerVectorToAIEVec : PassWrapper<LowerVectorToAIEVec, OperationPass<>> {
                      "from vector dialect."),
       llvm::cl::init("cpp")};
 
+  Option<unsigned> expLUTLanes{
+      *this, "exp-lut-lanes",
+      llvm::cl::desc("Number of lanes of the LUT-based exponential of bf16 "
+                     "vectors: 16, or 32 to also lower 32-lane exponentials "
+                     "to the variant looking up 32 lanes at once"),
+      llvm::cl::init(16)};
+
   void runOnOperation() override {
     auto op = getOperation();
     MLIRContext *context = &getContext();
@@ -3350,12 +3402,18 @@ struct LowerVectorToAIEVec : PassWrapper<LowerVectorToAIEVec, OperationPass<>> {
       }
     }
 
-    configureAIEVecCommonLegalizations(target, backend);
+    if (expLUTLanes != 16 && expLUTLanes != 32) {
+      op->emitError() << "unsupported number of LUT exp lanes '"
+                      << expLUTLanes << "'";
+      return signalPassFailure();
+    }
+
+    configureAIEVecCommonLegalizations(target, backend, expLUTLanes);
     if (aieVersion == AIEArch::AIE) {
       populateAIEVecV1ConversionPatterns(patterns, backend);
       configureAIEVecV1Legalizations(target, backend);
     } else {
-      populateAIEVecV2ConversionPatterns(patterns, backend);
+      populateAIEVecV2ConversionPatterns(patterns, backend, expLUTLanes);
       configureAIEVecV2Legalizations(target, backend);
     }
 
@@ -3380,7 +3438,8 @@ struct ProcessExtOpsPass : PassWrapper<ProcessExtOpsPass, OperationPass<>> {
     RewritePatternSet patterns(context);
     ConversionTarget target(*context);
     patterns.add<LowerExtFOpPattern, LowerExtSIOpPattern, LowerTruncFOpPattern,
-                 LowerTruncIOpPattern>(patterns.getContext());
+                 LowerTruncIOpPattern, LowerExtSIOpToUnpackPattern>(
+        patterns.getContext());
     target.addLegalDialect<aievec::AIEVecDialect, arith::ArithDialect>();
     target.addDynamicallyLegalOp<arith::ExtFOp>([](arith::ExtFOp extfOp) {
       auto srcType = dyn_cast<VectorType>(extfOp.getIn().getType());
@@ -3419,6 +3478,9 @@ struct ProcessExtOpsPass : PassWrapper<ProcessExtOpsPass, OperationPass<>> {
       unsigned dstLaneSize = getVectorLaneSize(dstType);
       unsigned srcElWidth = srcScalarType.getIntOrFloatBitWidth();
       unsigned dstElWidth = dstScalarType.getIntOrFloatBitWidth();
+      if (srcElWidth == 4 && dstElWidth == 8 && srcLaneSize == 64 &&
+          dstLaneSize == 64)
+        return false;
       if (!(srcLaneSize == 32 && (dstElWidth > srcElWidth) &&
             (dstLaneSize == srcLaneSize)))
         return true;
@@ -20,7 +20,9 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/Utils/ReshapeOpsUtils.h"
+#include "mlir/Dialect/Vector/Transforms/VectorRewritePatterns.h"
 #include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
@@ -253,6 +255,111 @@ struct HoistCastOpToDataSourcePattern : public RewritePattern {
   }
 };
 
+// Returns the reduction whose sum `next` adds to `acc`, if `next` is either
+// `acc + vector.reduction <add>, v` or `vector.reduction <add>, v, acc`.
+static vector::ReductionOp getAddReductionInto(Value acc, Value next) {
+  Operation *nextOp = next.getDefiningOp();
+  if (!nextOp)
+    return nullptr;
+  if (auto reductionOp = dyn_cast<vector::ReductionOp>(nextOp)) {
+    if (reductionOp.getKind() != vector::CombiningKind::ADD ||
+        reductionOp.getAcc() != acc)
+      return nullptr;
+    return reductionOp;
+  }
+  if (!isa<arith::AddIOp, arith::AddFOp>(nextOp))
+    return nullptr;
+  Value sum;
+  if (nextOp->getOperand(0) == acc)
+    sum = nextOp->getOperand(1);
+  else if (nextOp->getOperand(1) == acc)
+    sum = nextOp->getOperand(0);
+  if (!sum || !sum.hasOneUse())
+    return nullptr;
+  auto reductionOp = sum.getDefiningOp<vector::ReductionOp>();
+  if (!reductionOp || reductionOp.getKind() != vector::CombiningKind::ADD ||
+      reductionOp.getAcc())
+    return nullptr;
+  return reductionOp;
+}
+
+// This pattern moves the horizontal reduction of a sum accumulated by a loop
+// out of it. A loop carrying a scalar `acc` updated in each iteration as
+// `acc + vector.reduction <add>, v` instead carries a vector accumulating the
+// lanes of `v`, which are reduced once after the loop and added to the
+// initial value of `acc`. This trades a log2(lanes) deep shift and add tree in
+// each iteration for a single lane-wise add. As with the tree lowering of the
+// reductions themselves, floating point sums are reassociated.
+struct DeferAddReductionOutOfLoopPattern
+    : public OpInterfaceRewritePattern<LoopLikeOpInterface> {
+  using OpInterfaceRewritePattern::OpInterfaceRewritePattern;
+
+  LogicalResult matchAndRewrite(LoopLikeOpInterface loopOp,
+                                PatternRewriter &rewriter) const override {
+    std::optional<MutableArrayRef<OpOperand>> yieldedValues =
+        loopOp.getYieldedValuesMutable();
+    if (!yieldedValues || !loopOp.getLoopResults())
+      return failure();
+
+    for (auto [idx, acc] : llvm::enumerate(loopOp.getRegionIterArgs())) {
+      Value next = (*yieldedValues)[idx].get();
+      if (!acc.hasOneUse() || !next.hasOneUse())
+        continue;
+      vector::ReductionOp reductionOp = getAddReductionInto(acc, next);
+      if (!reductionOp)
+        continue;
+
+      Location loc = loopOp.getLoc();
+      Value vec = reductionOp.getVector();
+      auto vecType = cast<VectorType>(vec.getType());
+      bool isFloat = isa<FloatType>(vecType.getElementType());
+      Value init = loopOp.getInitsMutable()[idx].get();
+      Operation *nextOp = next.getDefiningOp();
+      bool addsReduction = nextOp != reductionOp.getOperation();
+
+      auto lanesInit = rewriter.create<arith::ConstantOp>(
+          loc, cast<TypedAttr>(rewriter.getZeroAttr(vecType)));
+      FailureOr<LoopLikeOpInterface> newLoop =
+          loopOp.replaceWithAdditionalYields(
+              rewriter, lanesInit.getResult(),
+              /*replaceInitOperandUsesInLoop=*/false,
+              [&](OpBuilder &b, Location yieldLoc,
+                  ArrayRef<BlockArgument> newBbArgs) -> SmallVector<Value> {
+                Value lanes =
+                    isFloat
+                        ? b.create<arith::AddFOp>(yieldLoc, newBbArgs[0], vec)
+                              .getResult()
+                        : b.create<arith::AddIOp>(yieldLoc, newBbArgs[0], vec)
+                              .getResult();
+                return {lanes};
+              });
+      if (failed(newLoop))
+        return failure();
+
+      // The scalar accumulator is now passed through unchanged, and its result
+      // is replaced below.
+      BlockArgument newAcc = newLoop->getRegionIterArgs()[idx];
+      OpOperand &newNext = (*newLoop->getYieldedValuesMutable())[idx];
+      rewriter.modifyOpInPlace(newNext.getOwner(),
+                               [&]() { newNext.set(newAcc); });
+      rewriter.eraseOp(nextOp);
+      if (addsReduction)
+        rewriter.eraseOp(reductionOp);
+
+      rewriter.setInsertionPointAfter(*newLoop);
+      ResultRange results = *newLoop->getLoopResults();
+      Value sum = rewriter.create<vector::ReductionOp>(
+          loc, vector::CombiningKind::ADD, results.back());
+      Value total =
+          isFloat ? rewriter.create<arith::AddFOp>(loc, init, sum).getResult()
+                  : rewriter.create<arith::AddIOp>(loc, init, sum).getResult();
+      rewriter.replaceAllUsesWith(results[idx], total);
+      return success();
+    }
+    return failure();
+  }
+};
+
 static SmallVector<Value> collapseInnerMostDimIndices(PatternRewriter &b,
                                                       Location loc, int numDims,
                                                       ValueRange indices,
@@ -415,6 +522,257 @@ struct FlattenMultDimTransferWritePattern
 //============ AIEML canonicalization conversion patterns ===============//
 //============================================================================//
 
+// Returns the mask of a 1D masked transfer of `vectorTy` as a comparison of
+// the lane indices against the bound of `vector.create_mask`, which AIEML can
+// lower to `aievec.cmp`. Other masks are returned as they are.
+static Value getLaneCompareMask(PatternRewriter &b, Location loc, Value mask,
+                                VectorType vectorTy) {
+  auto createMaskOp = mask.getDefiningOp<vector::CreateMaskOp>();
+  unsigned elWidth = vectorTy.getElementTypeBitWidth();
+  if (!createMaskOp || (elWidth != 8 && elWidth != 16 && elWidth != 32))
+    return mask;
+
+  // `vector.create_mask` clamps its bound to the number of lanes, which also
+  // keeps it within the range of the lane indices.
+  int64_t numLanes = vectorTy.getShape()[0];
+  Value bound = createMaskOp.getOperand(0);
+  bound = b.create<arith::MaxSIOp>(
+      loc, bound, b.create<arith::ConstantIndexOp>(loc, 0));
+  bound = b.create<arith::MinSIOp>(
+      loc, bound, b.create<arith::ConstantIndexOp>(loc, numLanes));
+
+  auto laneTy = b.getIntegerType(elWidth);
+  auto laneVecTy = VectorType::get({numLanes}, laneTy);
+  SmallVector<APInt> laneIdx;
+  for (int64_t lane = 0; lane < numLanes; ++lane)
+    laneIdx.push_back(APInt(elWidth, lane));
+  Value lanes = b.create<arith::ConstantOp>(
+      loc, DenseElementsAttr::get(laneVecTy, laneIdx));
+  Value bounds = b.create<vector::BroadcastOp>(
+      loc, laneVecTy, b.create<arith::IndexCastOp>(loc, laneTy, bound));
+  return b.create<arith::CmpIOp>(loc, CmpIPredicate::slt, lanes, bounds);
+}
+
+// This pattern converts a masked 1D `vector.transfer_read`, such as the tail
+// of a loop whose trip count isn't a multiple of the vector length, into an
+// unmasked `vector.transfer_read` followed by an `arith.select` of the padding
+// value on the masked-off lanes. Reading past the end of a buffer doesn't
+// fault on AIE, and those lanes are discarded.
+struct MaskedTransferReadToSelectPattern
+    : public OpConversionPattern<vector::TransferReadOp> {
+  using OpConversionPattern<vector::TransferReadOp>::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(vector::TransferReadOp readOp, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    VectorType vectorTy = readOp.getVectorType();
+    if (!adaptor.getMask() || vectorTy.getRank() != 1 ||
+        !adaptor.getPermutationMap().isMinorIdentity())
+      return failure();
+
+    auto loc = readOp.getLoc();
+    Value mask = getLaneCompareMask(rewriter, loc, adaptor.getMask(), vectorTy);
+    auto newReadOp = rewriter.create<vector::TransferReadOp>(
+        loc, vectorTy, adaptor.getSource(), adaptor.getIndices(),
+        adaptor.getPadding());
+    newReadOp.getProperties().setInBounds(rewriter.getBoolArrayAttr({true}));
+    Value padding = rewriter.create<vector::BroadcastOp>(loc, vectorTy,
+                                                         adaptor.getPadding());
+    rewriter.replaceOpWithNewOp<arith::SelectOp>(readOp, mask, newReadOp,
+                                                 padding);
+    return success();
+  }
+};
+
+// This pattern converts a masked 1D `vector.transfer_write` into a
+// read-modify-write: the destination is read, the masked-off lanes of the
+// written vector are replaced by what was read with an `arith.select`, and the
+// result is written with an unmasked `vector.transfer_write`. The lanes past
+// the end of the buffer are written back unchanged.
+struct MaskedTransferWriteToSelectPattern
+    : public OpConversionPattern<vector::TransferWriteOp> {
+  using OpConversionPattern<vector::TransferWriteOp>::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(vector::TransferWriteOp writeOp, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto vectorTy = cast<VectorType>(adaptor.getVector().getType());
+    if (!adaptor.getMask() || vectorTy.getRank() != 1 ||
+        !adaptor.getPermutationMap().isMinorIdentity() ||
+        !isa<MemRefType>(adaptor.getSource().getType()))
+      return failure();
+
+    auto loc = writeOp.getLoc();
+    Value mask = getLaneCompareMask(rewriter, loc, adaptor.getMask(), vectorTy);
+    Type elTy = vectorTy.getElementType();
+    Value zero = rewriter.create<arith::ConstantOp>(loc, elTy,
+                                                    rewriter.getZeroAttr(elTy));
+    auto oldReadOp = rewriter.create<vector::TransferReadOp>(
+        loc, vectorTy, adaptor.getSource(), adaptor.getIndices(), zero);
+    oldReadOp.getProperties().setInBounds(rewriter.getBoolArrayAttr({true}));
+    Value merged = rewriter.create<arith::SelectOp>(
+        loc, mask, adaptor.getVector(), oldReadOp);
+    auto newOp = rewriter.replaceOpWithNewOp<vector::TransferWriteOp>(
+        writeOp, merged, adaptor.getSource(), adaptor.getIndices());
+    newOp.getProperties().setInBounds(rewriter.getBoolArrayAttr({true}));
+    return success();
+  }
+};
+
+static bool isExtOp(Operation *op) {
+  return isa_and_nonnull<arith::ExtSIOp, arith::ExtUIOp, arith::ExtFOp>(op);
+}
+
+// Returns the element type of a contraction operand before any extension,
+// which is how `aievec.matmul` takes it.
+static Type getUnextendedElementType(Value operand) {
+  if (isExtOp(operand.getDefiningOp()))
+    operand = operand.getDefiningOp()->getOperand(0);
+  return getElementTypeOrSelf(operand);
+}
+
+// Returns the shape of the iteration space of the contractions a matmul-like
+// `vector.contract` is unrolled into: the `aievec.matmul` shape for its types
+// on the dimensions of the two innermost dimensions of its operands, and 1 on
+// every other dimension, e.g. on the blocks of a packed matmul. Returns
+// std::nullopt if the contraction cannot be tiled that way, or already has
+// that shape.
+static std::optional<SmallVector<int64_t>>
+getContractionNativeShape(vector::ContractionOp contractOp) {
+  if (contractOp.getKind() != vector::CombiningKind::ADD)
+    return std::nullopt;
+  auto accTy = dyn_cast<VectorType>(contractOp.getAccType());
+  if (!accTy || accTy.getRank() < 2)
+    return std::nullopt;
+
+  // The iteration dimensions of the two innermost dimensions of an operand.
+  auto getInnerDims =
+      [](AffineMap map) -> std::optional<std::pair<unsigned, unsigned>> {
+    if (map.getNumResults() < 2)
+      return std::nullopt;
+    unsigned numResults = map.getNumResults();
+    auto outer = dyn_cast<AffineDimExpr>(map.getResult(numResults - 2));
+    auto inner = dyn_cast<AffineDimExpr>(map.getResult(numResults - 1));
+    if (!outer || !inner)
+      return std::nullopt;
+    return std::make_pair(outer.getPosition(), inner.getPosition());
+  };
+  SmallVector<AffineMap, 3> maps = contractOp.getIndexingMapsArray();
+  auto lhsDims = getInnerDims(maps[0]);
+  auto rhsDims = getInnerDims(maps[1]);
+  auto accDims = getInnerDims(maps[2]);
+  if (!lhsDims || !rhsDims || !accDims)
+    return std::nullopt;
+  auto [mDim, kDim] = *lhsDims;
+  unsigned nDim = rhsDims->second;
+  if (rhsDims->first != kDim || *accDims != std::make_pair(mDim, nDim))
+    return std::nullopt;
+
+  auto matMulShape =
+      getAIEMLMatMulShape(getUnextendedElementType(contractOp.getLhs()),
+                          getUnextendedElementType(contractOp.getRhs()),
+                          accTy.getElementType());
+  if (!matMulShape)
+    return std::nullopt;
+  auto [r, s, t] = *matMulShape;
+
+  SmallVector<int64_t> bounds = contractOp.getIterationBounds();
+  if (bounds[mDim] % r || bounds[kDim] % s || bounds[nDim] % t)
+    return std::nullopt;
+  SmallVector<int64_t> nativeShape(bounds.size(), 1);
+  nativeShape[mDim] = r;
+  nativeShape[kDim] = s;
+  nativeShape[nDim] = t;
+  if (nativeShape == bounds)
+    return std::nullopt;
+  return nativeShape;
+}
+
+// Returns the shape of the tiles of the `operandIdx`-th operand of a
+// contraction unrolled to its native shape.
+static std::optional<SmallVector<int64_t>>
+getContractionOperandNativeShape(vector::ContractionOp contractOp,
+                                 unsigned operandIdx) {
+  auto nativeShape = getContractionNativeShape(contractOp);
+  if (!nativeShape)
+    return std::nullopt;
+  AffineMap map = contractOp.getIndexingMapsArray()[operandIdx];
+  SmallVector<int64_t> operandShape;
+  for (AffineExpr expr : map.getResults())
+    operandShape.push_back(
+        (*nativeShape)[cast<AffineDimExpr>(expr).getPosition()]);
+  return operandShape;
+}
+
+// Returns the shape the producer `op` of an operand of a tiled contraction,
+// a `vector.transfer_read` or an extension, is unrolled to: the shape of the
+// tiles the contraction, or its unrolling, extracts from it.
+static std::optional<SmallVector<int64_t>>
+getContractionProducerNativeShape(Operation *op) {
+  if (op->getNumResults() != 1)
+    return std::nullopt;
+  auto resultTy = dyn_cast<VectorType>(op->getResult(0).getType());
+  if (!resultTy)
+    return std::nullopt;
+  for (OpOperand &use : op->getResult(0).getUses()) {
+    Operation *user = use.getOwner();
+    if (auto contractOp = dyn_cast<vector::ContractionOp>(user))
+      if (auto shape = getContractionOperandNativeShape(
+              contractOp, use.getOperandNumber()))
+        return shape;
+    if (isExtOp(user))
+      if (auto shape = getContractionProducerNativeShape(user))
+        return shape;
+    // The tiles of a contraction unrolled first.
+    auto extractOp = dyn_cast<vector::ExtractStridedSliceOp>(user);
+    if (!extractOp || extractOp.getType().getRank() != resultTy.getRank() ||
+        extractOp.hasNonUnitStrides())
+      continue;
+    bool feedsContraction =
+        llvm::all_of(extractOp->getUsers(), [](Operation *u) {
+          return isa<vector::ContractionOp>(u) || isExtOp(u);
+        });
+    if (feedsContraction)
+      return llvm::to_vector(extractOp.getType().getShape());
+  }
+  return std::nullopt;
+}
+
+// Returns the shape a `vector.transfer_write` of the result of a tiled
+// contraction is unrolled to, that of the tiles of the accumulator.
+static std::optional<SmallVector<int64_t>>
+getContractionResultNativeShape(vector::TransferWriteOp writeOp) {
+  Operation *defOp = writeOp.getVector().getDefiningOp();
+  if (auto contractOp = dyn_cast_or_null<vector::ContractionOp>(defOp))
+    return getContractionOperandNativeShape(contractOp, 2);
+  // The tiles of a contraction unrolled first.
+  auto insertOp = dyn_cast_or_null<vector::InsertStridedSliceOp>(defOp);
+  if (!insertOp || insertOp.getSourceVectorType().getRank() !=
+                       insertOp.getDestVectorType().getRank())
+    return std::nullopt;
+  if (!insertOp.getSource().getDefiningOp<vector::ContractionOp>())
+    return std::nullopt;
+  return llvm::to_vector(insertOp.getSourceVectorType().getShape());
+}
+
+// The shapes matmul-like contractions, and the reads, extensions and writes of
+// their operands and results, are unrolled to by the vector unrolling
+// patterns, so that each contraction maps to one `aievec.matmul`. Unrolling a
+// contraction chains the tiles of each tile of the accumulator along the
+// reduction dimensions, which keeps the tile in an accumulator register for
+// the whole reduction. Unrolling the reads and writes with it loads and stores
+// the tiles directly.
+static std::optional<SmallVector<int64_t>>
+getAIEMLMatMulUnrollShape(Operation *op) {
+  if (auto contractOp = dyn_cast<vector::ContractionOp>(op))
+    return getContractionNativeShape(contractOp);
+  if (auto writeOp = dyn_cast<vector::TransferWriteOp>(op))
+    return getContractionResultNativeShape(writeOp);
+  if (isa<vector::TransferReadOp>(op) || isExtOp(op))
+    return getContractionProducerNativeShape(op);
+  return std::nullopt;
+}
+
 //============================================================================//
 //================ Common AIE canonicalization configuration =================//
 //============================================================================//
@@ -464,11 +822,12 @@ static void configureAIEMLCanonicalizeLegalizations(ConversionTarget &target,
         return !op.getPermutationMap().isConstant() &&
                getTransferReadAlignmentOffset(op, op.getVectorType(), 256)
                        .value_or(0) == 0 &&
-               op.getVector().getType().getRank() < 2;
+               op.getVector().getType().getRank() < 2 && !op.getMask();
       });
   target.addDynamicallyLegalOp<vector::TransferWriteOp>(
       [](vector::TransferWriteOp op) {
-        return cast<VectorType>(op.getVector().getType()).getRank() < 2;
+        return cast<VectorType>(op.getVector().getType()).getRank() < 2 &&
+               !op.getMask();
       });
 }
 
@@ -478,7 +837,9 @@ populateAIEMLCanonicalizeConversionPatterns(RewritePatternSet &patterns,
   patterns.add<SplitUnalignedTransferReadPattern>(patterns.getContext(), 1024,
                                                   256);
   patterns.add<FlattenMultDimTransferReadPattern,
-               FlattenMultDimTransferWritePattern>(patterns.getContext());
+               FlattenMultDimTransferWritePattern,
+               MaskedTransferReadToSelectPattern,
+               MaskedTransferWriteToSelectPattern>(patterns.getContext());
 }
 
 //============================================================================//
@@ -492,6 +853,7 @@ populateAIEMLCanonicalizeConversionPatterns(RewritePatternSet &patterns,
 //       by `extract` + `broadcast` operations.
 //    2) Split unaligned transfer reads into a wider aligned transfer read
 //       followed by a `vector.extract_strided_slice` operation.
+//    3) On AIEML, replace the masks of masked transfers with `arith.select`.
 struct CanonicalizeVectorForAIEVecPass
     : public PassWrapper<CanonicalizeVectorForAIEVecPass, OperationPass<>> {
   MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(CanonicalizeVectorForAIEVecPass)
@@ -609,6 +971,44 @@ static std::unique_ptr<::mlir::Pass> createHoistCastOpToDataSourcePass() {
   return std::make_unique<HoistCastOpToDataSourcePass>();
 }
 
+struct DeferReductionsOutOfLoopsPass
+    : public PassWrapper<DeferReductionsOutOfLoopsPass, OperationPass<>> {
+
+  void runOnOperation() override {
+    auto op = getOperation();
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+
+    patterns.add<DeferAddReductionOutOfLoopPattern>(patterns.getContext());
+
+    (void)applyPatternsAndFoldGreedily(op, std::move(patterns));
+  }
+};
+
+static std::unique_ptr<::mlir::Pass> createDeferReductionsOutOfLoopsPass() {
+  return std::make_unique<DeferReductionsOutOfLoopsPass>();
+}
+
+struct SplitContractionsForAIEMLPass
+    : public PassWrapper<SplitContractionsForAIEMLPass, OperationPass<>> {
+
+  void runOnOperation() override {
+    auto op = getOperation();
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+
+    vector::populateVectorUnrollPatterns(
+        patterns, vector::UnrollVectorOptions().setNativeShapeFn(
+                      getAIEMLMatMulUnrollShape));
+
+    (void)applyPatternsAndFoldGreedily(op, std::move(patterns));
+  }
+};
+
+static std::unique_ptr<::mlir::Pass> createSplitContractionsForAIEMLPass() {
+  return std::make_unique<SplitContractionsForAIEMLPass>();
+}
+
 //============================================================================//
 //=============== Main Vector2Vector Pipeline Configuration ==================//
 //============================================================================//
@@ -619,6 +1019,11 @@ void xilinx::aievec::buildCanonicalizeVectorForAIEVec(
   // TODO: Add passes to unroll vector with unsupported types
   // TODO: Add passes to split vectors that won't fit in registers
   pm.addPass(createCopyRemovalPass());
+  // Split the contractions before flattening the reads and writes of their
+  // tiles.
+  if (options.aieTarget == "aieml")
+    pm.addPass(createSplitContractionsForAIEMLPass());
   pm.addPass(createCanonicalizeVectorForAIEVecPass(options));
   pm.addPass(createHoistCastOpToDataSourcePass());
+  pm.addPass(createDeferReductionsOutOfLoopsPass());
 }
@@ -72,39 +72,111 @@ LogicalResult AIEX::IpuDmaMemcpyNdOp::verify() {
         return getConstantIntValue(s).has_value();
       }))
     llvm::report_fatal_error("Only constant strides currently supported.");
-  if (!llvm::all_of(getMixedSizes(), [](OpFoldResult s) {
-        return getConstantIntValue(s).has_value();
-      }))
-    llvm::report_fatal_error("Only constant sizes currently supported.");
-  if (!llvm::all_of(getMixedOffsets(), [](OpFoldResult s) {
-        return getConstantIntValue(s).has_value();
-      }))
-    llvm::report_fatal_error("Only constant offsets currently supported.");
+  // The offsets, and the size of the outermost of the three inner
+  // dimensions, may also be runtime parameters: integer arguments of the
+  // runtime sequence, patched into the instructions when it is run.
+  auto isConstantOrParameter = [](OpFoldResult ofr) {
+    if (getConstantIntValue(ofr))
+      return true;
+    Value value = llvm::dyn_cast_if_present<Value>(ofr);
+    auto arg = llvm::dyn_cast_if_present<BlockArgument>(value);
+    return arg && isa<func::FuncOp>(arg.getOwner()->getParentOp());
+  };
+  if (!llvm::all_of(getMixedSizes(), isConstantOrParameter))
+    return emitOpError("sizes must be constants or runtime parameters");
+  if (!llvm::all_of(getMixedOffsets(), isConstantOrParameter))
+    return emitOpError("offsets must be constants or runtime parameters");
 
   llvm::SmallVector<int64_t, 3> strides =
       llvm::map_to_vector(llvm::reverse(getMixedStrides()), [](OpFoldResult s) {
         return getConstantIntValue(s).value();
       });
-  llvm::SmallVector<int64_t, 4> sizes =
-      llvm::map_to_vector(llvm::reverse(getMixedSizes()), [](OpFoldResult s) {
-        return getConstantIntValue(s).value();
-      });
-
-  if (sizes[3] > 64)
-    return emitOpError("Size 3 exceeds the [1:64] range.");
-  if (strides[1] && sizes[1] > 0x3FF)
-    return emitOpError("Size 1 exceeds the [0:1023] range.");
-  if (strides[0] && sizes[0] > 0x3FF)
-    return emitOpError("Size 0 exceeds the [0:1023] range.");
-  if (strides[2] > 0x100000)
-    return emitOpError("Stride 3 exceeds the [1:1M] range.");
+  llvm::SmallVector<std::optional<int64_t>, 4> sizes =
+      llvm::map_to_vector(llvm::reverse(getMixedSizes()),
+                          [](OpFoldResult s) {
+                            return getConstantIntValue(s);
+                          });
+  // Only the length of the BD can change at runtime, i.e. the size of the
+  // outermost inner dimension when the dimensions above it are unused.
+  if (!sizes[3])
+    return emitOpError("the size of the fourth dimension can't be a runtime "
+                       "parameter");
+  for (int i = 0; i < 2; i++) {
+    if (sizes[i])
+      continue;
+    for (int j = i + 1; j < 3; j++)
+      if (sizes[j] != 1 || strides[j - 1] != 0)
+        return emitOpError("only the outermost of the three inner dimensions "
+                           "can have a runtime parameter size");
+  }
+
+  // Sizes beyond the wraps and repeat count of a BD, and strides of the
+  // outermost dimension beyond the iteration stride, are split by
+  // -aie-dma-to-ipu.
   if (strides[1] > 0x100000)
     return emitOpError("Stride 2 exceeds the [1:1M] range.");
   if (strides[0] > 0x100000)
     return emitOpError("Stride 1 exceeds the [1:1M] range.");
+
+  if (getPersistent() && getRingSlots())
+    return emitOpError("a ring transfer can't be persistent");
+  if (failed(AIE::verifyShimAxiSettings(*this, getBurstLength(), getAxCache(),
+                                        getAxQos())))
+    return failure();
+  if (getDoorbell() && !getRingSlots())
+    return emitOpError("a doorbell needs ring_slots");
+  if (auto slots = getRingSlots()) {
+    if (buffer.getNumElements() % *slots != 0)
+      return emitOpError("the memref can't be divided into ")
+             << *slots << " ring slots";
+    if (!llvm::all_of(getMixedSizes(), [](OpFoldResult s) {
+          return getConstantIntValue(s).has_value();
+        }) ||
+        !llvm::all_of(getMixedOffsets(), [](OpFoldResult s) {
+          return getConstantIntValue(s).has_value();
+        }))
+      return emitOpError("a ring transfer can't have runtime parameters");
+    if (sizes[3] != 1)
+      return emitOpError("a ring transfer can't repeat its slots, the size "
+                         "of the fourth dimension must be 1");
+  }
   return success();
 }
 
+LogicalResult AIEX::IpuWriteRTPOp::verify() {
+  auto isParameter = [](Value value) {
+    auto arg = llvm::dyn_cast_if_present<BlockArgument>(value);
+    return arg && isa<func::FuncOp>(arg.getOwner()->getParentOp());
+  };
+  if (getParameter() && !isParameter(getParameter()))
+    return emitOpError("param must be a runtime parameter of the sequence");
+  if (getSlot() && !isParameter(getSlot()))
+    return emitOpError("slot must be a runtime parameter of the sequence");
+  return success();
+}
+
+LogicalResult AIEX::IpuLoadOverlayOp::verify() {
+  auto device = (*this)->getParentOfType<AIE::DeviceOp>();
+  if (!device)
+    return success();
+  for (auto core : device.getOps<AIE::CoreOp>()) {
+    if (core.colIndex() != getColumn() || core.rowIndex() != getRow())
+      continue;
+    auto overlays = core.getOverlays();
+    if (!overlays)
+      return emitOpError("the core of tile (")
+             << getColumn() << ", " << getRow() << ") has no overlays";
+    if (getOverlay() < 0 ||
+        getOverlay() >= static_cast<int32_t>(overlays->size()))
+      return emitOpError("overlay ")
+             << getOverlay() << " is not one of the " << overlays->size()
+             << " overlays of the core";
+    return success();
+  }
+  return emitOpError("tile (") << getColumn() << ", " << getRow()
+                               << ") has no core";
+}
+
 LogicalResult AIEX::IpuShimTilePushQueueOp::verify() {
   const auto &targetModel = AIE::getTargetModel(*this);
   auto numBds = targetModel.getNumBDs(0, 0); // assume shim
@@ -134,5 +206,6 @@ LogicalResult AIEX::IpuWriteBdExShimTileOp::verify() {
     return emitOpError("Iteration Size exceeds the [0:63] range.");
   if (getIterationStride() > 0xFFFFF)
     return emitOpError("Iteration Stride exceeds the [0:1M-1] range.");
-  return success();
+  return AIE::verifyShimAxiSettings(*this, getBurstLength(), getAxCache(),
+                                    getAxQos());
 }
\ No newline at end of file
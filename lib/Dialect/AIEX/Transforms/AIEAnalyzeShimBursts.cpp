@@ -0,0 +1,274 @@
+//===- AIEAnalyzeShimBursts.cpp ---------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The shim DMA moves each contiguous run of the access pattern of an
+// aiex.ipu.dma_memcpy_nd with AXI bursts of at most `burst_length` bytes,
+// which don't cross a multiple of the burst length. Runs shorter than a
+// burst, or starting off a burst boundary, are split into partial bursts
+// which waste DDR bandwidth, while -aie-dma-to-ipu accepts any access
+// pattern.
+//
+// This pass computes the runs of each transfer: the innermost dimension,
+// merged with the outer dimensions whose stride is the extent of the
+// dimensions below them, and the alignment of their starts, from the offset
+// of the transfer and the strides of the dimensions which aren't merged.
+// Transfers whose worst case efficiency, the bytes moved over the bytes of
+// the bursts they are split into, is below the threshold are warned about,
+// with notes proposing a re-striding or a host layout reaching full bursts.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "aie-analyze-shim-bursts"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIEX;
+
+// The verifier only accepts 32-bit elements.
+static constexpr int64_t elementBytes = 4;
+
+namespace {
+// A dimension of the access pattern of a transfer, 0 being the innermost
+// one, whose stride is one element. The size of a dimension given by a
+// runtime parameter is unknown.
+struct Dim {
+  int index;
+  std::optional<int64_t> size;
+  int64_t stride;
+};
+
+// The contiguous runs of an ordering of the dimensions of a transfer: their
+// length in elements, and the outer dimensions stepping between them.
+struct Runs {
+  int64_t length;
+  SmallVector<Dim> merged;
+  SmallVector<Dim> rest;
+};
+} // namespace
+
+// The largest power of two dividing a byte offset, up to the burst length.
+static int64_t getAlignment(int64_t bytes, int64_t burst) {
+  if (bytes == 0)
+    return burst;
+  return std::min<int64_t>(bytes & -bytes, burst);
+}
+
+// The number of bursts a run is split into at worst, when it starts at the
+// last aligned offset before a burst boundary.
+static int64_t getNumBursts(int64_t bytes, int64_t alignment, int64_t burst) {
+  int64_t lead = alignment < burst ? burst - alignment : 0;
+  return llvm::divideCeil(bytes + lead, burst);
+}
+
+static int64_t getEfficiency(int64_t bytes, int64_t alignment, int64_t burst) {
+  return bytes * 100 / (getNumBursts(bytes, alignment, burst) * burst);
+}
+
+// Merge the outer dimensions, in the given order, into the runs of the
+// innermost one as long as their stride is the extent of the run.
+static Runs getRuns(const Dim &inner, ArrayRef<Dim> outer) {
+  Runs runs = {*inner.size, {inner}, {}};
+  for (const Dim &dim : outer) {
+    if (dim.size == 1)
+      continue;
+    if (runs.rest.empty() && dim.size && dim.stride == runs.length) {
+      runs.length *= *dim.size;
+      runs.merged.push_back(dim);
+    } else {
+      runs.rest.push_back(dim);
+    }
+  }
+  return runs;
+}
+
+// Merge the outer dimensions in any order, picking at each step the one
+// whose stride is the extent of the run.
+static Runs getReorderedRuns(const Dim &inner, ArrayRef<Dim> outer) {
+  SmallVector<Dim> pending;
+  for (const Dim &dim : outer)
+    if (dim.size != 1)
+      pending.push_back(dim);
+  Runs runs = {*inner.size, {inner}, {}};
+  for (;;) {
+    auto *next = llvm::find_if(pending, [&](const Dim &dim) {
+      return dim.size && dim.stride == runs.length;
+    });
+    if (next == pending.end())
+      break;
+    runs.length *= *next->size;
+    runs.merged.push_back(*next);
+    pending.erase(next);
+  }
+  runs.rest = pending;
+  return runs;
+}
+
+// Print the sizes and strides of an ordering of the dimensions like the
+// operands of aiex.ipu.dma_memcpy_nd, outermost first.
+static void printPattern(Diagnostic &diag, ArrayRef<Dim> dims) {
+  diag << "[";
+  for (int i = dims.size() - 1; i >= 0; i--)
+    diag << *dims[i].size << (i ? ", " : "");
+  diag << "][";
+  for (int i = dims.size() - 1; i > 0; i--)
+    diag << dims[i].stride << (i > 1 ? ", " : "");
+  diag << "]";
+}
+
+struct AIEAnalyzeShimBurstsPass
+    : AIEAnalyzeShimBurstsBase<AIEAnalyzeShimBurstsPass> {
+  void runOnOperation() override {
+    getOperation().walk([&](IpuDmaMemcpyNdOp op) { analyze(op); });
+    markAllAnalysesPreserved();
+  }
+
+  void analyze(IpuDmaMemcpyNdOp op) {
+    int64_t burst = op.getBurstLength().value_or(256);
+    SmallVector<OpFoldResult> sizes =
+        llvm::to_vector(llvm::reverse(op.getMixedSizes()));
+    SmallVector<OpFoldResult> offsets =
+        llvm::to_vector(llvm::reverse(op.getMixedOffsets()));
+    SmallVector<int64_t> strides = llvm::map_to_vector(
+        llvm::reverse(op.getMixedStrides()),
+        [](OpFoldResult s) { return getConstantIntValue(s).value(); });
+
+    // The runs of a transfer whose innermost size is a runtime parameter
+    // are unknown.
+    Dim inner = {0, getConstantIntValue(sizes[0]), 1};
+    if (!inner.size)
+      return;
+    SmallVector<Dim> outer;
+    for (int i = 1; i < 4; i++)
+      outer.push_back({i, getConstantIntValue(sizes[i]), strides[i - 1]});
+
+    // The alignment of the offset of the transfer, in bytes, like computed
+    // by -aie-dma-to-ipu. A runtime parameter may be any multiple of its
+    // coefficient.
+    ArrayRef<int64_t> shape = op.getMemref().getType().getShape();
+    int64_t offsetAlignment = burst;
+    int64_t offset = 0;
+    int64_t coefficient = elementBytes;
+    for (size_t i = 0; i < shape.size(); i++) {
+      if (auto value = getConstantIntValue(offsets[i]))
+        offset += *value * coefficient;
+      else
+        offsetAlignment =
+            std::min(offsetAlignment, getAlignment(coefficient, burst));
+      coefficient *= shape[shape.size() - i - 1];
+    }
+    offsetAlignment = std::min(offsetAlignment, getAlignment(offset, burst));
+    if (auto slots = op.getRingSlots())
+      offsetAlignment = std::min(
+          offsetAlignment,
+          getAlignment(op.getMemref().getType().getNumElements() / *slots *
+                           elementBytes,
+                       burst));
+
+    auto getRunsAlignment = [&](const Runs &runs) {
+      int64_t alignment = offsetAlignment;
+      for (const Dim &dim : runs.rest)
+        alignment = std::min(alignment,
+                             getAlignment(dim.stride * elementBytes, burst));
+      return alignment;
+    };
+
+    Runs runs = getRuns(inner, outer);
+    if (runs.length == 0)
+      return;
+    int64_t bytes = runs.length * elementBytes;
+    int64_t alignment = getRunsAlignment(runs);
+    int64_t efficiency = getEfficiency(bytes, alignment, burst);
+    int64_t effectiveBurst = bytes / getNumBursts(bytes, alignment, burst);
+    if (efficiency >= static_cast<int64_t>(clMinEfficiency)) {
+      if (clRemarks)
+        op.emitRemark("runs of ")
+            << bytes << " bytes aligned to " << alignment
+            << " bytes, effective bursts of " << effectiveBurst
+            << " bytes out of " << burst << " (" << efficiency
+            << "% efficiency)";
+      return;
+    }
+
+    InFlightDiagnostic diag =
+        op.emitWarning("runs of ")
+        << bytes << " bytes aligned to " << alignment
+        << " bytes, effective bursts of " << effectiveBurst << " bytes out of "
+        << burst << " (" << efficiency << "% efficiency)";
+
+    // Reorder the outer dimensions so that more of them merge into the runs.
+    // The sizes given by runtime parameters can't be moved.
+    bool hasParameters = llvm::any_of(outer, [](const Dim &dim) {
+      return !dim.size.has_value();
+    });
+    if (!hasParameters) {
+      Runs reordered = getReorderedRuns(inner, outer);
+      if (reordered.length > runs.length) {
+        SmallVector<Dim> dims = reordered.merged;
+        llvm::append_range(dims, reordered.rest);
+        for (const Dim &dim : outer)
+          if (dim.size == 1)
+            dims.push_back({dim.index, 1, 0});
+        int64_t reorderedBytes = reordered.length * elementBytes;
+        Diagnostic &note = diag.attachNote() << "re-striding as ";
+        printPattern(note, dims);
+        note << " gives runs of " << reorderedBytes << " bytes ("
+             << getEfficiency(reorderedBytes, getRunsAlignment(reordered),
+                              burst)
+             << "% efficiency)";
+        runs = reordered;
+      }
+    }
+
+    // Otherwise, the host buffer can store the rows stepped through by the
+    // first dimension which doesn't merge contiguously.
+    if (runs.length * elementBytes < burst) {
+      if (runs.rest.empty()) {
+        diag.attachNote() << "the whole transfer is a single run of "
+                          << runs.length * elementBytes
+                          << " bytes, only larger transfers fill the bursts";
+      } else if (const Dim &dim = runs.rest.front(); dim.size) {
+        int64_t packedBytes = runs.length * *dim.size * elementBytes;
+        diag.attachNote()
+            << "a host layout storing the " << *dim.size
+            << " rows of dimension " << dim.index
+            << " contiguously, with a stride of " << runs.length
+            << " elements instead of " << dim.stride << ", gives runs of "
+            << packedBytes << " bytes";
+      }
+    }
+
+    // Misaligned runs waste a burst at their start.
+    int64_t runsBytes = runs.length * elementBytes;
+    if (getEfficiency(runsBytes, burst, burst) <=
+        getEfficiency(runsBytes, getRunsAlignment(runs), burst))
+      return;
+    if (offsetAlignment < burst)
+      diag.attachNote() << "aligning the offset of the transfer to " << burst
+                        << " bytes in the host buffer aligns its runs";
+    for (const Dim &dim : runs.rest)
+      if (getAlignment(dim.stride * elementBytes, burst) < burst)
+        diag.attachNote()
+            << "padding the stride of dimension " << dim.index << " from "
+            << dim.stride << " to "
+            << llvm::alignTo(dim.stride * elementBytes, burst) / elementBytes
+            << " elements aligns its runs to " << burst << " bytes";
+  }
+};
+
+std::unique_ptr<OperationPass<AIE::DeviceOp>>
+AIEX::createAIEAnalyzeShimBurstsPass() {
+  return std::make_unique<AIEAnalyzeShimBurstsPass>();
+}
@@ -8,6 +8,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
 #include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
@@ -16,10 +17,50 @@
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
 
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+
+#include <cstring>
+
 using namespace mlir;
 using namespace xilinx;
 using namespace xilinx::AIEX;
 
+// Event_Generate register of the shim tiles, and the user events marking the
+// queue pushes of MM2S and S2MM transfers.
+static constexpr uint32_t shimEventGenerate = 0x34008;
+static constexpr uint32_t mm2sIssueEvent = 126;
+static constexpr uint32_t s2mmIssueEvent = 127;
+
+// Value registers of the first lock of the core and memory tiles, the
+// registers of the next locks following every 0x10 bytes.
+static constexpr uint32_t coreLockValue = 0x1F000;
+static constexpr uint32_t memTileLockValue = 0xC0000;
+
+// Program memory of the core tiles.
+static constexpr uint32_t coreProgramMemory = 0x20000;
+
+// Write 1 to the value register of the lock of tile (c, r), which the runtime
+// sequence hands to its core.
+static LogicalResult setLock(ConversionPatternRewriter &rewriter,
+                             Operation *op, AIE::DeviceOp device,
+                             FlatSymbolRefAttr lockName, int c, int r) {
+  auto lock = device.lookupSymbol<AIE::LockOp>(lockName);
+  if (!lock || lock.getTileOp().colIndex() != c ||
+      lock.getTileOp().rowIndex() != r)
+    return op->emitOpError("lock ")
+           << lockName << " is not a lock of tile (" << c << ", " << r << ")";
+  if (!lock.getLockID())
+    return op->emitOpError("lock ") << lockName << " has no id assigned";
+  const auto &targetModel = device.getTargetModel();
+  uint32_t lockValueBase =
+      targetModel.isMemTile(c, r) ? memTileLockValue : coreLockValue;
+  rewriter.create<IpuWrite32Op>(op->getLoc(), c, r,
+                                lockValueBase + *lock.getLockID() * 0x10, 1);
+  return success();
+}
+
 struct RtpToIpuPattern : OpConversionPattern<IpuWriteRTPOp> {
   using OpConversionPattern::OpConversionPattern;
 
@@ -36,6 +77,7 @@ struct RtpToIpuPattern : OpConversionPattern<IpuWriteRTPOp> {
     auto device = op->getParentOfType<AIE::DeviceOp>();
 
     uint32_t rtp_buffer_addr = UINT_MAX;
+    uint32_t rtp_buffer_size = 0;
     int c = op.getCol();
     int r = op.getRow();
     uint32_t v = op.getValue();
@@ -47,45 +89,121 @@ struct RtpToIpuPattern : OpConversionPattern<IpuWriteRTPOp> {
         assert(buffer.getAddress().has_value() &&
                "buffer must have address assigned");
         rtp_buffer_addr = static_cast<uint32_t>(buffer.getAddress().value());
+        rtp_buffer_size = buffer.getAllocationSize();
       }
 
     if (rtp_buffer_addr == UINT_MAX)
       return op.emitOpError("RTP buffer address cannot be found. Has an RTP "
                             "buffer been allocated?\n");
 
+    // A double-buffered RTP buffer holds two copies of the parameters, the
+    // slot selecting the one written.
+    SmallVector<int64_t> addressParams;
+    if (Value slot = op.getSlot()) {
+      if ((idx + 1) * sizeof(uint32_t) > rtp_buffer_size / 2)
+        return op.emitOpError("index is beyond the first copy of the "
+                              "double-buffered RTP buffer");
+      addressParams.append({cast<BlockArgument>(slot).getArgNumber(),
+                            rtp_buffer_size / 2});
+    }
+    SmallVector<int64_t> valueParams;
+    if (Value parameter = op.getParameter())
+      valueParams.append({cast<BlockArgument>(parameter).getArgNumber(), 1});
+
     rtp_buffer_addr += idx * sizeof(uint32_t);
 
     IntegerAttr column = IntegerAttr::get(i32ty, c);
     IntegerAttr row = IntegerAttr::get(i32ty, r);
     IntegerAttr address = IntegerAttr::get(ui32ty, rtp_buffer_addr);
     IntegerAttr value = IntegerAttr::get(i32ty, v);
-    rewriter.create<IpuWrite32Op>(op->getLoc(), column.getInt(), row.getInt(),
-                                  address.getUInt(), value.getInt());
+    rewriter.create<IpuWrite32Op>(
+        op->getLoc(), column.getInt(), row.getInt(), address.getUInt(),
+        value.getInt(),
+        addressParams.empty() ? DenseI64ArrayAttr()
+                              : rewriter.getDenseI64ArrayAttr(addressParams),
+        valueParams.empty() ? DenseI64ArrayAttr()
+                            : rewriter.getDenseI64ArrayAttr(valueParams));
+
+    // Hand the parameters over to the core by setting the value of its lock.
+    if (auto lockName = op.getLockAttr())
+      if (failed(setLock(rewriter, op, device, lockName, c, r)))
+        return failure();
 
     rewriter.eraseOp(op);
     return success();
   }
 };
 
-std::optional<AIE::ShimDMAAllocationOp>
-getAllocOpForSymbol(AIE::DeviceOp dev, StringRef sym_name) {
-  auto sym = dev.lookupSymbol(sym_name);
-  if (!sym)
-    return std::nullopt;
+struct LoadOverlayToIpuPattern : OpConversionPattern<IpuLoadOverlayOp> {
+  using OpConversionPattern::OpConversionPattern;
 
-  auto uses = SymbolTable::getSymbolUses(sym, dev);
-  for (auto use : *uses)
-    if (auto infoOp = dyn_cast<AIE::ShimDMAAllocationOp>(use.getUser()))
-      return infoOp;
+  LoadOverlayToIpuPattern(MLIRContext *context, StringRef overlayDir,
+                          PatternBenefit benefit = 1)
+      : OpConversionPattern(context, benefit), overlayDir(overlayDir) {}
 
-  return std::nullopt;
-}
+  LogicalResult
+  matchAndRewrite(IpuLoadOverlayOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto device = op->getParentOfType<AIE::DeviceOp>();
+    int c = op.getColumn();
+    int r = op.getRow();
+
+    if (overlayDir.empty())
+      return op.emitOpError("the overlays are only known once the cores are "
+                            "linked, lower with overlay-dir");
+    SmallString<128> path(overlayDir);
+    llvm::sys::path::append(path, "core_" + std::to_string(c) + "_" +
+                                      std::to_string(r) + ".overlay" +
+                                      std::to_string(op.getOverlay()) +
+                                      ".bin");
+    auto file = llvm::MemoryBuffer::getFile(path);
+    if (!file)
+      return op.emitOpError("cannot read the overlay ") << path.str();
+    StringRef code = (*file)->getBuffer();
+
+    AIE::CoreOp core;
+    for (auto coreOp : device.getOps<AIE::CoreOp>())
+      if (coreOp.colIndex() == c && coreOp.rowIndex() == r)
+        core = coreOp;
+    uint32_t overlaySize = *core.getOverlaySize();
+    if (code.size() > overlaySize)
+      return op.emitOpError("overlay ")
+             << op.getOverlay() << " has " << code.size()
+             << " bytes of code, more than the overlay_size of the core";
+
+    // The overlay region is at the end of the program memory, the words of
+    // the code being padded with zeros.
+    uint32_t address = coreProgramMemory +
+                       device.getTargetModel().getProgramMemorySize() -
+                       overlaySize;
+    for (size_t i = 0; i < code.size(); i += sizeof(uint32_t)) {
+      char bytes[sizeof(uint32_t)] = {0};
+      std::memcpy(bytes, code.data() + i,
+                  std::min(sizeof(uint32_t), code.size() - i));
+      rewriter.create<IpuWrite32Op>(op->getLoc(), c, r, address + i,
+                                    llvm::support::endian::read32le(bytes));
+    }
+
+    // Let the core call into the overlay.
+    if (auto lockName = op.getLockAttr())
+      if (failed(setLock(rewriter, op, device, lockName, c, r)))
+        return failure();
+
+    rewriter.eraseOp(op);
+    return success();
+  }
+
+private:
+  std::string overlayDir;
+};
 
 struct PushToIpuPattern : OpConversionPattern<IpuShimTilePushQueueOp> {
   using OpConversionPattern::OpConversionPattern;
 
-  PushToIpuPattern(MLIRContext *context, PatternBenefit benefit = 1)
-      : OpConversionPattern(context, benefit) {}
+  PushToIpuPattern(MLIRContext *context, const AIE::DeviceIndex &index,
+                   bool timestamps, PatternBenefit benefit = 1)
+      : OpConversionPattern(context, benefit), index(index),
+        timestamps(timestamps) {}
 
   LogicalResult
   matchAndRewrite(IpuShimTilePushQueueOp op, OpAdaptor adaptor,
@@ -99,11 +217,9 @@ struct PushToIpuPattern : OpConversionPattern<IpuShimTilePushQueueOp> {
     uint32_t channel_num = 0;
 
     // initialize fields to zero
-    auto dev = op->getParentOfType<AIE::DeviceOp>();
-    if (!dev)
-      return failure();
-
-    auto infoOp = getAllocOpForSymbol(dev, op.getMetadata());
+    std::optional<AIE::ShimDMAAllocationOp> infoOp;
+    if (index.lookupSymbol(op.getMetadata()))
+      infoOp = index.getShimDMAAllocation(op.getMetadata());
     if (!infoOp) {
       op.emitOpError("couldn't find shim_dma_allocation op");
       return failure();
@@ -134,19 +250,142 @@ struct PushToIpuPattern : OpConversionPattern<IpuShimTilePushQueueOp> {
       cmd |= 0x80000000;
     IntegerAttr value = IntegerAttr::get(ui32ty, cmd);
 
+    if (timestamps)
+      rewriter.create<IpuWrite32Op>(op->getLoc(), column.getInt(),
+                                    zero.getInt(), shimEventGenerate,
+                                    isMM2S ? mm2sIssueEvent : s2mmIssueEvent);
     rewriter.create<IpuWrite32Op>(op->getLoc(), column.getInt(), zero.getInt(),
                                   address.getUInt(), value.getUInt());
 
     rewriter.eraseOp(op);
     return success();
   }
+
+private:
+  const AIE::DeviceIndex &index;
+  bool timestamps;
 };
 
+// Limits of the shim tile BD fields.
+static constexpr int64_t maxWrap = 0x3FF;
+static constexpr int64_t maxStride = 0x100000;
+static constexpr int64_t maxIterations = 64;
+
+// Check that the three inner dimensions of a transfer, with sizes and strides
+// in the reversed order used by the lowering, fit in a single shim BD.
+static bool fitsShimBd(ArrayRef<int64_t> sizes, ArrayRef<int64_t> strides) {
+  if (strides[1] && sizes[1] > maxWrap)
+    return false;
+  if (strides[0] && sizes[0] > maxWrap)
+    return false;
+  return strides[1] <= maxStride && strides[0] <= maxStride;
+}
+
+// Rewrite the three inner dimensions of a transfer into an equivalent access
+// pattern fitting in a shim BD: dimensions of size one are dropped,
+// contiguous dimensions are merged and dimensions too large for their wrap
+// are split in two. Fails if the result still doesn't fit.
+static LogicalResult normalizeInnerDims(SmallVectorImpl<int64_t> &sizes,
+                                        SmallVectorImpl<int64_t> &strides) {
+  // (size, stride) pairs, innermost first.
+  using Dim = std::pair<int64_t, int64_t>;
+  SmallVector<Dim, 4> dims;
+  Dim original[] = {
+      {sizes[0], 1}, {sizes[1], strides[0]}, {sizes[2], strides[1]}};
+  for (auto [size, stride] : original) {
+    if (size == 1)
+      continue;
+    if (!dims.empty() && stride == dims.back().first * dims.back().second)
+      dims.back().first *= size;
+    else
+      dims.emplace_back(size, stride);
+  }
+  // The innermost dimension of a BD always has a unit stride.
+  if (dims.empty() || dims.front().second != 1)
+    dims.insert(dims.begin(), Dim(1, 1));
+
+  // The size of the outermost dimension is only bounded by the length.
+  for (size_t i = 0; i + 1 < dims.size(); i++) {
+    auto [size, stride] = dims[i];
+    if (size <= maxWrap)
+      continue;
+    int64_t inner = maxWrap;
+    while (inner > 1 && size % inner != 0)
+      inner--;
+    if (inner == 1)
+      return failure();
+    dims[i].first = inner;
+    dims.insert(dims.begin() + i + 1, Dim(size / inner, inner * stride));
+  }
+  if (dims.size() > 3)
+    return failure();
+
+  dims.resize(3, Dim(1, 0));
+  for (int i = 0; i < 3; i++)
+    sizes[i] = dims[i].first;
+  strides[0] = dims[1].second;
+  strides[1] = dims[2].second;
+  return success(fitsShimBd(sizes, strides));
+}
+
+// Returns the position of the runtime parameter in the arguments of the
+// sequence, if the value is one.
+static std::optional<int64_t> getRuntimeParameter(OpFoldResult ofr) {
+  Value value = llvm::dyn_cast_if_present<Value>(ofr);
+  if (auto arg = llvm::dyn_cast_if_present<BlockArgument>(value))
+    return arg.getArgNumber();
+  return std::nullopt;
+}
+
+// Returns the number of BD ids, starting at the id of the op, used once the
+// repetitions of the outermost dimension are split to fit in the repeat and
+// iteration limits.
+static int64_t getNumBdIds(IpuDmaMemcpyNdOp op) {
+  // A ring has one BD per slot.
+  if (auto slots = op.getRingSlots())
+    return *slots;
+  int64_t repeats = getConstantIntValue(op.getMixedSizes()[0]).value();
+  int64_t stride = getConstantIntValue(op.getMixedStrides()[0]).value();
+  if (stride == 0)
+    return 1;
+  int64_t chunk = stride > maxStride ? 1 : maxIterations;
+  return llvm::divideCeil(repeats, chunk);
+}
+
+// Check that the extra BD ids used by a split transfer are not used by
+// another transfer which may be in flight at the same time, i.e. which isn't
+// separated from it by a sync.
+static LogicalResult checkExtraBdIds(IpuDmaMemcpyNdOp op) {
+  int64_t firstBdId = op.getId();
+  int64_t numBdIds = getNumBdIds(op);
+  auto check = [&](Operation &other) -> LogicalResult {
+    auto transfer = dyn_cast<IpuDmaMemcpyNdOp>(other);
+    if (!transfer || &other == op.getOperation())
+      return success();
+    int64_t id = transfer.getId();
+    if (id <= firstBdId || id >= firstBdId + numBdIds)
+      return success();
+    return op.emitOpError("needs BD ids ")
+           << firstBdId << " to " << firstBdId + numBdIds - 1 << ", but id "
+           << id << " is used by another transfer before the next sync";
+  };
+  for (Operation *it = op->getNextNode(); it && !isa<IpuSyncOp>(it);
+       it = it->getNextNode())
+    if (failed(check(*it)))
+      return failure();
+  for (Operation *it = op->getPrevNode(); it && !isa<IpuSyncOp>(it);
+       it = it->getPrevNode())
+    if (failed(check(*it)))
+      return failure();
+  return success();
+}
+
 struct DmaToIpuPattern : OpConversionPattern<IpuDmaMemcpyNdOp> {
   using OpConversionPattern::OpConversionPattern;
 
-  DmaToIpuPattern(MLIRContext *context, PatternBenefit benefit = 1)
-      : OpConversionPattern(context, benefit) {}
+  DmaToIpuPattern(MLIRContext *context, const AIE::DeviceIndex &index,
+                   PatternBenefit benefit = 1)
+      : OpConversionPattern(context, benefit), index(index) {}
 
   LogicalResult
   matchAndRewrite(IpuDmaMemcpyNdOp op, OpAdaptor adaptor,
@@ -156,11 +395,9 @@ struct DmaToIpuPattern : OpConversionPattern<IpuDmaMemcpyNdOp> {
     auto zero = IntegerAttr::get(i32ty, 0);
     auto memref = adaptor.getMemref();
 
-    auto dev = op->getParentOfType<AIE::DeviceOp>();
-    if (!dev)
-      return failure();
-
-    auto infoOp = getAllocOpForSymbol(dev, op.getMetadata());
+    std::optional<AIE::ShimDMAAllocationOp> infoOp;
+    if (index.lookupSymbol(op.getMetadata()))
+      infoOp = index.getShimDMAAllocation(op.getMetadata());
     if (!infoOp) {
       op.emitOpError("couldn't find shim_dma_allocation op");
       return failure();
@@ -170,52 +407,58 @@ struct DmaToIpuPattern : OpConversionPattern<IpuDmaMemcpyNdOp> {
     bool isMM2S = channelDir == AIE::DMAChannelDir::MM2S;
     int col = infoOp->getCol();
 
-    // initialize fields to zero
-    auto column = zero;
-    auto column_num = zero;
-    auto ddr_id = zero;
-    auto bd_id = zero;
-    auto buffer_length = zero;
-    auto buffer_offset = zero;
-    auto enable_packet = zero;
-    auto out_of_order_id = zero;
-    auto packet_id = zero;
-    auto packet_type = zero;
-    auto d0_size = zero;
-    auto d0_stride = zero;
-    auto d1_size = zero;
-    auto d1_stride = zero;
-    auto d2_stride = zero;
-    auto iteration_current = zero;
-    auto iteration_size = zero;
-    auto iteration_stride = zero;
-    auto next_bd = zero;
-    auto use_next_bd = zero;
-    auto valid_bd = zero;
-    auto lock_rel_val = zero;
-    auto lock_rel_id = zero;
-    auto lock_acq_enable = zero;
-    auto lock_acq_val = zero;
-    auto lock_acq_id = zero;
-
-    auto issue_token = BoolAttr::get(ctx, false);
-    auto repeat_count = zero;
-
     llvm::SmallVector<int64_t, 3> strides = llvm::map_to_vector(
         llvm::reverse(op.getMixedStrides()),
         [](OpFoldResult s) { return getConstantIntValue(s).value(); });
-    llvm::SmallVector<int64_t, 4> sizes = llvm::map_to_vector(
-        llvm::reverse(op.getMixedSizes()),
-        [](OpFoldResult s) { return getConstantIntValue(s).value(); });
-    llvm::SmallVector<int64_t, 4> offsets = llvm::map_to_vector(
-        llvm::reverse(op.getMixedOffsets()),
-        [](OpFoldResult s) { return getConstantIntValue(s).value(); });
-
-    // column
-    column = IntegerAttr::get(i32ty, col);
-
-    // column_num
-    column_num = IntegerAttr::get(i32ty, 1);
+    // Runtime parameters are taken as zero in the fields written here.
+    llvm::SmallVector<OpFoldResult, 4> mixedSizes =
+        llvm::to_vector(llvm::reverse(op.getMixedSizes()));
+    llvm::SmallVector<OpFoldResult, 4> mixedOffsets =
+        llvm::to_vector(llvm::reverse(op.getMixedOffsets()));
+    llvm::SmallVector<int64_t, 4> sizes =
+        llvm::map_to_vector(mixedSizes, [](OpFoldResult s) {
+          return getConstantIntValue(s).value_or(0);
+        });
+    llvm::SmallVector<int64_t, 4> offsets =
+        llvm::map_to_vector(mixedOffsets, [](OpFoldResult s) {
+          return getConstantIntValue(s).value_or(0);
+        });
+    auto isParameter = [](OpFoldResult ofr) {
+      return getRuntimeParameter(ofr).has_value();
+    };
+    bool hasParameters = llvm::any_of(mixedSizes, isParameter) ||
+                         llvm::any_of(mixedOffsets, isParameter);
+
+    // The sizes can't be rearranged when one of them is only known at
+    // runtime.
+    if (!fitsShimBd(sizes, strides) &&
+        (hasParameters || failed(normalizeInnerDims(sizes, strides))))
+      return op.emitOpError("access pattern can't be split to fit in the "
+                            "wraps and strides of a shim BD");
+
+    // The repetitions of the outermost dimension are split into chunks within
+    // the repeat and iteration limits. Chunks stepping through memory use
+    // consecutive BD ids; without a stride they all share the same BD.
+    int64_t repeats = sizes[3];
+    int64_t chunk = strides[2] > maxStride ? 1 : maxIterations;
+    int64_t numChunks = llvm::divideCeil(repeats, chunk);
+    int64_t firstBdId = op.getId();
+    int64_t numBdIds = getNumBdIds(op);
+    const auto &targetModel = AIE::getTargetModel(op);
+    if (firstBdId + numBdIds > targetModel.getNumBDs(col, 0))
+      return op.emitOpError("needs ")
+             << numBdIds << " BDs starting at id " << firstBdId
+             << ", more than available on the shim tile";
+    // With a single repetition per chunk, the BDs are chained and only the
+    // first one is pushed to the queue.
+    bool chained = chunk == 1 && numChunks > 1;
+    // A ring cycles through one BD per slot, each chained to the next and the
+    // last one to the first, so it is also pushed once.
+    std::optional<int64_t> ringSlots = op.getRingSlots();
+    std::optional<int64_t> doorbell = op.getDoorbell();
+    int64_t numBds = ringSlots ? *ringSlots : numChunks;
+    if (ringSlots && numChunks > 1)
+      return op.emitOpError("a ring slot must fit in a single shim BD");
 
     // ddr_id
     Block &entryBB = op->getParentOfType<func::FuncOp>().getBody().front();
@@ -228,17 +471,19 @@ struct DmaToIpuPattern : OpConversionPattern<IpuDmaMemcpyNdOp> {
     }
     if (arg_idx < 0)
       return failure();
-    ddr_id = IntegerAttr::get(i32ty, arg_idx);
-
-    // bd_id
-    bd_id = IntegerAttr::get(i32ty, op.getId());
-
-    // buffer_length
-    int32_t repeat_length = 0;
-    for (int32_t index_3d = 0; index_3d < sizes[2]; index_3d++)
-      for (int32_t index_2d = 0; index_2d < sizes[1]; index_2d++)
-        repeat_length += sizes[0];
-    buffer_length = IntegerAttr::get(i32ty, repeat_length);
+    // The host buffers are passed to the kernel by their position in the
+    // arguments, which the runtime parameters must not shift.
+    if (hasParameters) {
+      auto args = entryBB.getArguments();
+      auto *firstParameter = llvm::find_if(args, [](BlockArgument arg) {
+        return isa<IntegerType>(arg.getType());
+      });
+      if (std::any_of(firstParameter, args.end(), [](BlockArgument arg) {
+            return isa<MemRefType>(arg.getType());
+          }))
+        return op.emitOpError("runtime parameters must follow the buffers "
+                              "in the arguments of the sequence");
+    }
 
     // buffer_offset
     size_t stride = 1;
@@ -250,92 +495,219 @@ struct DmaToIpuPattern : OpConversionPattern<IpuDmaMemcpyNdOp> {
     assert(el_bit_width % 8 == 0 &&
            "Expected Memref element bitwidth to be multiple of 8.");
     size_t S = el_bit_width / 8;
+    // (argument, coefficient) pairs of the runtime parameters of the offset.
+    SmallVector<int64_t> offsetParams;
     for (size_t i = 0; i < R; i++) {
       offset += offsets[i] * stride * S;
+      if (auto param = getRuntimeParameter(mixedOffsets[i]))
+        offsetParams.append({*param, static_cast<int64_t>(stride * S)});
       stride *= shape[R - i - 1];
     }
-    buffer_offset = IntegerAttr::get(i32ty, offset);
-
-    // enable_packet
-
-    // out_of_order_id
-
-    // packet_id
-
-    // packet_type
-
-    // d0_size
-    if (strides[0])
-      d0_size = IntegerAttr::get(i32ty, sizes[0]);
-
-    // d0_stride
-    d0_stride = IntegerAttr::get(i32ty, 0);
-
-    // d1_size
-    if (strides[1])
-      d1_size = IntegerAttr::get(i32ty, sizes[1]);
-
-    // d1_stride
-    if (strides[0])
-      d1_stride = IntegerAttr::get(i32ty, strides[0] - 1);
-
-    // d2_stride
-    if (strides[1])
-      d2_stride = IntegerAttr::get(i32ty, strides[1] - 1);
-
-    // iteration_current
-
-    // iteration_size
-    if (strides[2])
-      iteration_size = IntegerAttr::get(i32ty, sizes[3] - 1);
-
-    // iteration_stride
-    if (strides[2])
-      iteration_stride = IntegerAttr::get(i32ty, strides[2] - 1);
-
-    // next_bd
-
-    // use_next_bd
-
-    // valid_bd
-    valid_bd = IntegerAttr::get(i32ty, 1);
-
-    // lock_rel_val
-
-    // lock_rel_id
-
-    // lock_acq_enable
-
-    // lock_acq_val
-
-    // lock_acq_id
+    // The verifier ensures that a size given by a runtime parameter is the
+    // outermost inner one, so the length is its value times the sizes below.
+    SmallVector<int64_t> lengthParams;
+    for (int i = 0; i < 3; i++)
+      if (auto param = getRuntimeParameter(mixedSizes[i])) {
+        int64_t coefficient = 1;
+        for (int j = 0; j < i; j++)
+          coefficient *= sizes[j];
+        lengthParams.append({*param, coefficient});
+      }
 
-    // repeat_count
-    repeat_count = IntegerAttr::get(i32ty, sizes[3] - 1);
+    int64_t slotBytes =
+        ringSlots ? my_memref.getNumElements() / *ringSlots * S : 0;
+    for (int64_t c = 0; c < numBds; c++) {
+      int64_t chunkRepeats =
+          ringSlots ? repeats : std::min(chunk, repeats - c * chunk);
+      int64_t chunkBdId = firstBdId + (strides[2] || ringSlots ? c : 0);
+      bool last = c + 1 == numBds;
+
+      // initialize fields to zero
+      auto column = zero;
+      auto column_num = zero;
+      auto ddr_id = zero;
+      auto bd_id = zero;
+      auto buffer_length = zero;
+      auto buffer_offset = zero;
+      auto enable_packet = zero;
+      auto out_of_order_id = zero;
+      auto packet_id = zero;
+      auto packet_type = zero;
+      auto d0_size = zero;
+      auto d0_stride = zero;
+      auto d1_size = zero;
+      auto d1_stride = zero;
+      auto d2_stride = zero;
+      auto iteration_current = zero;
+      auto iteration_size = zero;
+      auto iteration_stride = zero;
+      auto next_bd = zero;
+      auto use_next_bd = zero;
+      auto valid_bd = zero;
+      auto lock_rel_val = zero;
+      auto lock_rel_id = zero;
+      auto lock_acq_enable = zero;
+      auto lock_acq_val = zero;
+      auto lock_acq_id = zero;
+
+      auto issue_token = BoolAttr::get(ctx, false);
+      auto repeat_count = zero;
+
+      // column
+      column = IntegerAttr::get(i32ty, col);
+
+      // column_num
+      column_num = IntegerAttr::get(i32ty, 1);
+
+      // ddr_id
+      ddr_id = IntegerAttr::get(i32ty, arg_idx);
+
+      // bd_id
+      bd_id = IntegerAttr::get(i32ty, chunkBdId);
+
+      // buffer_length
+      int32_t repeat_length = sizes[0] * sizes[1] * sizes[2];
+      buffer_length = IntegerAttr::get(i32ty, repeat_length);
+
+      // buffer_offset
+      if (ringSlots)
+        buffer_offset = IntegerAttr::get(i32ty, offset + c * slotBytes);
+      else
+        buffer_offset =
+            IntegerAttr::get(i32ty, offset + c * chunk * strides[2] * S);
+
+      // enable_packet
+
+      // out_of_order_id
+
+      // packet_id
+
+      // packet_type
+
+      // d0_size
+      if (strides[0])
+        d0_size = IntegerAttr::get(i32ty, sizes[0]);
+
+      // d0_stride
+      d0_stride = IntegerAttr::get(i32ty, 0);
+
+      // d1_size
+      if (strides[1])
+        d1_size = IntegerAttr::get(i32ty, sizes[1]);
+
+      // d1_stride
+      if (strides[0])
+        d1_stride = IntegerAttr::get(i32ty, strides[0] - 1);
+
+      // d2_stride
+      if (strides[1])
+        d2_stride = IntegerAttr::get(i32ty, strides[1] - 1);
+
+      // iteration_current
+
+      // iteration_size
+      if (strides[2] && chunk > 1)
+        iteration_size = IntegerAttr::get(i32ty, chunkRepeats - 1);
+
+      // iteration_stride
+      if (strides[2] && chunk > 1)
+        iteration_stride = IntegerAttr::get(i32ty, strides[2] - 1);
+
+      // next_bd
+      if (ringSlots)
+        next_bd = IntegerAttr::get(i32ty, firstBdId + (c + 1) % numBds);
+      else if (chained && !last)
+        next_bd = IntegerAttr::get(i32ty, chunkBdId + 1);
+
+      // use_next_bd
+      if (ringSlots || (chained && !last))
+        use_next_bd = IntegerAttr::get(i32ty, 1);
+
+      // valid_bd
+      valid_bd = IntegerAttr::get(i32ty, 1);
+
+      // lock_rel_val
+
+      // lock_rel_id
+
+      // lock_acq_enable
+      if (doorbell)
+        lock_acq_enable = IntegerAttr::get(i32ty, 1);
+
+      // lock_acq_val
+      if (doorbell)
+        lock_acq_val = IntegerAttr::get(i32ty, -1);
+
+      // lock_acq_id
+      if (doorbell)
+        lock_acq_id = IntegerAttr::get(i32ty, *doorbell);
+
+      // repeat_count
+      repeat_count = IntegerAttr::get(i32ty, chunkRepeats - 1);
 
-    // issue_token
-    if (!isMM2S)
-      issue_token = BoolAttr::get(ctx, true);
+      // issue_token
+      // The chunks complete in order, so only the last one needs to signal
+      // its completion. A ring never completes.
+      if (!isMM2S && !ringSlots && (last || chained))
+        issue_token = BoolAttr::get(ctx, true);
 
-    (void)rewriter.create<IpuWriteBdExShimTileOp>(
-        op->getLoc(), column, column_num, ddr_id, bd_id, buffer_length,
-        buffer_offset, enable_packet, out_of_order_id, packet_id, packet_type,
-        d0_size, d0_stride, d1_size, d1_stride, d2_stride, iteration_current,
-        iteration_size, iteration_stride, next_bd, use_next_bd, valid_bd,
-        lock_rel_val, lock_rel_id, lock_acq_enable, lock_acq_val, lock_acq_id);
+      if (strides[2] || ringSlots || c == 0)
+        (void)rewriter.create<IpuWriteBdExShimTileOp>(
+            op->getLoc(), column, column_num, ddr_id, bd_id, buffer_length,
+            buffer_offset, enable_packet, out_of_order_id, packet_id,
+            packet_type, d0_size, d0_stride, d1_size, d1_stride, d2_stride,
+            iteration_current, iteration_size, iteration_stride, next_bd,
+            use_next_bd, valid_bd, lock_rel_val, lock_rel_id, lock_acq_enable,
+            lock_acq_val, lock_acq_id,
+            lengthParams.empty() ? DenseI64ArrayAttr()
+                                 : rewriter.getDenseI64ArrayAttr(lengthParams),
+            offsetParams.empty() ? DenseI64ArrayAttr()
+                                 : rewriter.getDenseI64ArrayAttr(offsetParams),
+            op.getBurstLengthAttr(), op.getAxCacheAttr(), op.getAxQosAttr());
 
-    rewriter.create<IpuShimTilePushQueueOp>(op->getLoc(), op.getMetadataAttr(),
-                                            issue_token, repeat_count, bd_id);
+      if ((!chained && !ringSlots) || c == 0)
+        rewriter.create<IpuShimTilePushQueueOp>(
+            op->getLoc(), op.getMetadataAttr(), issue_token, repeat_count,
+            bd_id);
+    }
 
     rewriter.eraseOp(op);
     return success();
   }
+
+private:
+  const AIE::DeviceIndex &index;
 };
 
 struct AIEDmaToIpuPass : AIEDmaToIpuBase<AIEDmaToIpuPass> {
   void runOnOperation() override {
 
     AIE::DeviceOp device = getOperation();
+    auto &index = getAnalysis<AIE::DeviceIndex>();
+
+    // Only the data moved into the array can stay there between runs.
+    SmallVector<IpuDmaMemcpyNdOp> persistent;
+    WalkResult checked = device.walk([&](IpuDmaMemcpyNdOp op) {
+      if (getNumBdIds(op) > 1 && failed(checkExtraBdIds(op)))
+        return WalkResult::interrupt();
+      if (!op.getPersistent())
+        return WalkResult::advance();
+      std::optional<AIE::ShimDMAAllocationOp> infoOp;
+      if (index.lookupSymbol(op.getMetadata()))
+        infoOp = index.getShimDMAAllocation(op.getMetadata());
+      if (infoOp && infoOp->getChannelDir() == AIE::DMAChannelDir::S2MM) {
+        op.emitOpError("only MM2S transfers can be persistent");
+        return WalkResult::interrupt();
+      }
+      persistent.push_back(op);
+      return WalkResult::advance();
+    });
+    if (checked.wasInterrupted())
+      return signalPassFailure();
+
+    if (clSkipPersistent)
+      for (IpuDmaMemcpyNdOp op : persistent)
+        op.erase();
 
     ConversionTarget target(getContext());
     target.addLegalDialect<AIEXDialect>();
@@ -344,14 +716,19 @@ struct AIEDmaToIpuPass : AIEDmaToIpuBase<AIEDmaToIpuPass> {
     target.addIllegalOp<IpuWriteRTPOp>();
     target.addIllegalOp<IpuDmaMemcpyNdOp>();
     target.addIllegalOp<IpuShimTilePushQueueOp>();
+    target.addIllegalOp<IpuLoadOverlayOp>();
 
     RewritePatternSet patterns(&getContext());
-    patterns.insert<DmaToIpuPattern>(&getContext());
-    patterns.insert<PushToIpuPattern>(&getContext());
+    patterns.insert<DmaToIpuPattern>(&getContext(), index);
+    patterns.insert<PushToIpuPattern>(&getContext(), index, clTimestamps);
     patterns.insert<RtpToIpuPattern>(&getContext());
+    patterns.insert<LoadOverlayToIpuPattern>(&getContext(), clOverlayDir);
 
     if (failed(applyPartialConversion(device, target, std::move(patterns))))
-      signalPassFailure();
+      return signalPassFailure();
+
+    // Only the runtime sequence ops are rewritten.
+    markAnalysesPreserved<AIE::DeviceIndex>();
   }
 };
 
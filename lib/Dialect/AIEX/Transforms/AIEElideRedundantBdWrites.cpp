@@ -0,0 +1,88 @@
+//===- AIEElideRedundantBdWrites.cpp ----------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Each aiex.ipu.writebd_shimtile is emitted as a 10 word instruction by
+// AIETranslateToIPU. Runtime sequences processing many batches rewrite the
+// same BDs with the same contents over and over, so this pass removes the
+// BD writes which don't change the contents of the BD registers, i.e. which
+// are identical to the previous write of the same BD.
+//
+// The BD registers of a shim tile are only written by BD writes, or by raw
+// 32-bit writes in the BD region of the tile, which conservatively
+// invalidate all the BDs of the column.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "aie-elide-redundant-bd-writes"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIEX;
+
+// Address range of the BD registers of the shim tiles.
+static constexpr uint32_t shimBdBase = 0x1D000;
+static constexpr uint32_t shimBdEnd = 0x1D200;
+
+struct AIEElideRedundantBdWritesPass
+    : AIEElideRedundantBdWritesBase<AIEElideRedundantBdWritesPass> {
+  void runOnOperation() override {
+    AIE::DeviceOp device = getOperation();
+    for (auto func : device.getOps<func::FuncOp>()) {
+      if (func.isDeclaration())
+        continue;
+      // The contents of the BDs of each column, as the attributes of their
+      // last write.
+      DenseMap<int, DenseMap<int, DictionaryAttr>> contents;
+      SmallVector<Operation *> redundant;
+      for (Operation &op : func.getBody().front()) {
+        if (auto write = dyn_cast<IpuWriteBdExShimTileOp>(op)) {
+          DictionaryAttr attrs = write->getAttrDictionary();
+          bool same = true;
+          for (int col = write.getColumn(),
+                   end = write.getColumn() + write.getColumnNum();
+               col < end; col++) {
+            DictionaryAttr &last = contents[col][write.getBdId()];
+            same &= last == attrs;
+            last = attrs;
+          }
+          if (same && write.getColumnNum() > 0)
+            redundant.push_back(write);
+          continue;
+        }
+        if (auto write = dyn_cast<IpuWrite32Op>(op)) {
+          if (write.getRow() == 0 && write.getAddress() >= shimBdBase &&
+              write.getAddress() < shimBdEnd)
+            contents.erase(write.getColumn());
+          continue;
+        }
+        if (isa<IpuSyncOp>(op) || isMemoryEffectFree(&op))
+          continue;
+        // Anything else may reconfigure the shim DMAs.
+        contents.clear();
+      }
+      LLVM_DEBUG(llvm::dbgs() << "Removing " << redundant.size()
+                              << " redundant BD writes in " << func.getName()
+                              << "\n");
+      for (Operation *op : redundant)
+        op->erase();
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<AIE::DeviceOp>>
+AIEX::createAIEElideRedundantBdWritesPass() {
+  return std::make_unique<AIEElideRedundantBdWritesPass>();
+}
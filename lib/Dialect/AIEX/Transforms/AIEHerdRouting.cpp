@@ -9,6 +9,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPathFinder.h"
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
 #include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
 
@@ -17,6 +18,8 @@
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 #include "mlir/Transforms/DialectConversion.h"
 
+#include "llvm/ADT/MapVector.h"
+
 #define DEBUG_TYPE "aie-herd-routing"
 
 using namespace mlir;
@@ -48,15 +51,7 @@ std::optional<int> getAvailableDestChannel(SmallVector<Connect, 8> &connects,
   if (connects.empty())
     return {0};
 
-  int numChannels;
-
-  if (destBundle == WireBundle::North)
-    numChannels = 6;
-  else if (destBundle == WireBundle::South || destBundle == WireBundle::East ||
-           destBundle == WireBundle::West)
-    numChannels = 4;
-  else
-    numChannels = 2;
+  int numChannels = getLogicalNumDestChannels(destBundle);
 
   // look for existing connect
   for (int i = 0; i < numChannels; i++) {
@@ -80,107 +75,31 @@ std::optional<int> getAvailableDestChannel(SmallVector<Connect, 8> &connects,
   return std::nullopt;
 }
 
-void buildRoute(int xSrc, int ySrc, int xDest, int yDest,
-                WireBundle sourceBundle, int sourceChannel,
-                WireBundle destBundle, int destChannel, Operation *herdOp,
-                DenseMap<std::pair<Operation *, TileID>,
-                         SmallVector<Connect, 8>> &switchboxes) {
-
-  int xCur = xSrc;
-  int yCur = ySrc;
-  WireBundle curBundle = WireBundle::Core;
-  int curChannel = 0;
-  WireBundle lastBundle = WireBundle::Core;
-  Port lastPort = {sourceBundle, sourceChannel};
-
-  SmallVector<TileID, 4> congestion;
-
+// The connections of the switchbox of each tile of each herd, in the order in
+// which the routes first reach them. The herds are keyed by address, so a
+// hashed map would create the switchboxes in a different order from run to
+// run.
+using HerdSwitchboxes =
+    llvm::MapVector<std::pair<Operation *, TileID>, SmallVector<Connect, 8>>;
+
+LogicalResult buildRoute(int xSrc, int ySrc, int xDest, int yDest,
+                         WireBundle sourceBundle, int sourceChannel,
+                         WireBundle destBundle, int destChannel,
+                         Operation *herdOp, HerdSwitchboxes &switchboxes) {
   LLVM_DEBUG(llvm::dbgs() << "Build route: " << xSrc << " " << ySrc << " --> "
                           << xDest << " " << yDest << '\n');
-  // traverse horizontally, then vertically
-  while (!(xCur == xDest && yCur == yDest)) {
-    LLVM_DEBUG(llvm::dbgs() << "coord " << xCur << " " << yCur << '\n');
-    TileID curCoord = {xCur, yCur};
-    SmallVector<WireBundle, 4> moves;
-
-    if (xCur < xDest)
-      moves.push_back(WireBundle::East);
-    if (xCur > xDest)
-      moves.push_back(WireBundle::West);
-    if (yCur < yDest)
-      moves.push_back(WireBundle::North);
-    if (yCur > yDest)
-      moves.push_back(WireBundle::South);
-
-    if (std::find(moves.begin(), moves.end(), WireBundle::East) == moves.end())
-      moves.push_back(WireBundle::East);
-    if (std::find(moves.begin(), moves.end(), WireBundle::West) == moves.end())
-      moves.push_back(WireBundle::West);
-    if (std::find(moves.begin(), moves.end(), WireBundle::North) == moves.end())
-      moves.push_back(WireBundle::North);
-    if (std::find(moves.begin(), moves.end(), WireBundle::South) == moves.end())
-      moves.push_back(WireBundle::South);
-
-    for (auto move : moves) {
-      if (auto maybeDestChannel = getAvailableDestChannel(
-              switchboxes[std::make_pair(herdOp, curCoord)], lastPort, move))
-        curChannel = maybeDestChannel.value();
-      else
-        continue;
-
-      if (move == lastBundle)
-        continue;
-
-      if (move == WireBundle::East)
-        xCur = xCur + 1;
-      // yCur = yCur;
-      else if (move == WireBundle::West)
-        xCur = xCur - 1;
-      // yCur = yCur;
-      else if (move == WireBundle::North)
-        // xCur = xCur;
-        yCur = yCur + 1;
-      else if (move == WireBundle::South)
-        // xCur = xCur;
-        yCur = yCur - 1;
-
-      if (std::find(congestion.begin(), congestion.end(), TileID{xCur, yCur}) !=
-          congestion.end())
-        continue;
-
-      curBundle = move;
-      lastBundle = move == WireBundle::East    ? WireBundle::West
-                   : move == WireBundle::West  ? WireBundle::East
-                   : move == WireBundle::North ? WireBundle::South
-                   : move == WireBundle::South ? WireBundle::North
-                                               : lastBundle;
-      break;
-    }
-
-    assert(curChannel >= 0 && "Could not find available destination port!");
-    LLVM_DEBUG(llvm::dbgs()
-               << "[" << stringifyWireBundle(lastPort.bundle) << " : "
-               << lastPort.channel << "], [" << stringifyWireBundle(curBundle)
-               << " : " << curChannel << "]\n");
-
-    Port curPort = {curBundle, curChannel};
-    Connect connect = {lastPort, curPort};
-    if (std::find(switchboxes[std::make_pair(herdOp, curCoord)].begin(),
-                  switchboxes[std::make_pair(herdOp, curCoord)].end(),
-                  connect) ==
-        switchboxes[std::make_pair(herdOp, curCoord)].end())
-      switchboxes[std::make_pair(herdOp, curCoord)].push_back(connect);
-    lastPort = {lastBundle, curChannel};
-  }
-
-  LLVM_DEBUG(llvm::dbgs() << "coord " << xCur << " " << yCur << '\n');
-  LLVM_DEBUG(llvm::dbgs() << "[" << stringifyWireBundle(lastPort.bundle)
-                          << " : " << lastPort.channel << "], ["
-                          << stringifyWireBundle(destBundle) << " : "
-                          << destChannel << "]\n");
-
-  switchboxes[std::make_pair(herdOp, TileID{xCur, yCur})].push_back(
-      {lastPort, Port{destBundle, destChannel}});
+  return buildDimensionOrderedRoute(
+      {xSrc, ySrc}, {sourceBundle, sourceChannel}, {xDest, yDest},
+      {destBundle, destChannel},
+      [&](TileID tile, Port in, WireBundle bundle) {
+        return getAvailableDestChannel(switchboxes[{herdOp, tile}], in,
+                                       bundle);
+      },
+      [&](TileID tile, Connect connect) {
+        SmallVector<Connect, 8> &connects = switchboxes[{herdOp, tile}];
+        if (!llvm::is_contained(connects, connect))
+          connects.push_back(connect);
+      });
 }
 
 struct AIEHerdRoutingPass : AIEHerdRoutingBase<AIEHerdRoutingPass> {
@@ -195,8 +114,7 @@ struct AIEHerdRoutingPass : AIEHerdRoutingBase<AIEHerdRoutingPass> {
     DenseMap<std::pair<Operation *, Operation *>, std::pair<int, int>>
         distances;
     SmallVector<std::pair<std::pair<int, int>, std::pair<int, int>>, 4> routes;
-    DenseMap<std::pair<Operation *, TileID>, SmallVector<Connect, 8>>
-        switchboxes;
+    HerdSwitchboxes switchboxes;
 
     for (auto herd : device.getOps<HerdOp>())
       herds.push_back(herd);
@@ -280,9 +198,14 @@ struct AIEHerdRoutingPass : AIEHerdRoutingBase<AIEHerdRoutingPass> {
                   routes.end())
                 continue;
 
-              buildRoute(x0, y0, x1 + distX, y1 + distY, sourceBundle,
-                         sourceChannel, destBundle, destChannel, sourceHerd,
-                         switchboxes);
+              if (failed(buildRoute(x0, y0, x1 + distX, y1 + distY,
+                                    sourceBundle, sourceChannel, destBundle,
+                                    destChannel, sourceHerd, switchboxes))) {
+                routeOp.emitOpError("could not find a route from (")
+                    << x0 << ", " << y0 << ") to (" << x1 + distX << ", "
+                    << y1 + distY << ")";
+                return signalPassFailure();
+              }
 
               routes.push_back(route);
             }
@@ -0,0 +1,392 @@
+//===- AIEInsertTrace.cpp ---------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Set up event tracing of the cores of an IPU device. Each traced core (and,
+// optionally, its memory module) gets a packet flow from its trace port to a
+// single S2MM channel of a shim tile, so that all the trace streams share the
+// routes of one packet-switched network, and every runtime sequence of the
+// device is prefixed with the register writes which select the traced events,
+// start the trace units and point the shim channel at the trace buffer.
+//
+// The trace units are configured in event-time mode and start tracing as soon
+// as they are configured. The packets keep their headers, which identify the
+// tile and the module that produced them; python/trace.py decodes the buffer.
+// With the timestamps option, the shim tiles moving data are traced too, to
+// time the transfers issued by the runtime sequence. With sync-broadcast, the
+// timers of the traced modules are reset together by a broadcast event before
+// the trace units start, so that their timestamps are comparable.
+
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Pass/Pass.h"
+
+#include <set>
+
+#define DEBUG_TYPE "aie-insert-trace"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+using namespace xilinx::AIEX;
+
+// Trace registers of the core and memory modules of AIE2 compute tiles. The
+// PL module of the shim tiles has its trace registers at the same addresses
+// as the core module.
+static constexpr uint32_t coreTraceBase = 0x340D0;
+static constexpr uint32_t memTraceBase = 0x140D0;
+static constexpr uint32_t traceControl0 = 0x0;
+static constexpr uint32_t traceControl1 = 0x4;
+static constexpr uint32_t traceEvent0 = 0x10;
+static constexpr uint32_t traceEvent1 = 0x14;
+
+// Task queue of the first S2MM channel of a shim tile.
+static constexpr uint32_t shimS2MMQueue = 0x1D204;
+
+// Timer and event registers of the core module of AIE2 compute tiles, and
+// of the PL module of the shim tiles, the memory module having its timer
+// control at memTimerControl. The reset event of a timer is in bits 14:8 of
+// its control register.
+static constexpr uint32_t coreTimerControl = 0x34000;
+static constexpr uint32_t memTimerControl = 0x14000;
+static constexpr uint32_t eventGenerate = 0x34008;
+static constexpr uint32_t eventBroadcast0 = 0x34010;
+
+// The broadcast events of the core and memory modules, and the A broadcast
+// events of the shim PL module, of channel 0; the following channels have
+// the following ids.
+static constexpr int32_t coreBroadcast0Event = 107;
+static constexpr int32_t shimBroadcast0Event = 110;
+// USER_EVENT_1 of the shim PL module, sent on the broadcast channel.
+static constexpr int32_t shimUserEvent1 = 127;
+
+// Core events traced by default: INSTR_EVENT_0, INSTR_EVENT_1, INSTR_VECTOR,
+// MEMORY_STALL, STREAM_STALL, CASCADE_STALL, LOCK_STALL and ACTIVE.
+static constexpr int32_t defaultCoreEvents[] = {0x21, 0x22, 0x25, 0x17,
+                                                0x18, 0x19, 0x1A, 0x1C};
+
+// Shim events traced with timestamps: USER_EVENT_0 and USER_EVENT_1,
+// generated by -aie-dma-to-ipu before MM2S and S2MM queue pushes, the start
+// and end of the tasks of MM2S channels 0 and 1, and of S2MM channel 0, or 1
+// when channel 0 collects the traces. python/trace.py relies on this order.
+static constexpr int32_t shimEvents[] = {126, 127, 16, 24, 17, 25, 14, 22};
+static constexpr int32_t shimS2MM1Events[] = {15, 23};
+
+// Width of the packet ids of the stream switches.
+static constexpr int maxPacketId = 31;
+
+// Packet types of the trace packets, by the module which produced them.
+static constexpr int corePacketType = 0;
+static constexpr int memPacketType = 1;
+static constexpr int shimPacketType = 2;
+
+namespace {
+
+// A trace unit to set up: the tile, the trace port it streams to and the
+// events it records.
+struct TraceUnit {
+  TileOp tile;
+  int port;
+  int packetType;
+  SmallVector<int32_t, 8> events;
+  int packetId = 0;
+};
+
+} // namespace
+
+static IntegerAttr i32Attr(OpBuilder &builder, int64_t value) {
+  return builder.getI32IntegerAttr(value);
+}
+
+static void createWrite32(OpBuilder &builder, Location loc, int col, int row,
+                          uint32_t address, uint32_t value) {
+  builder.create<IpuWrite32Op>(loc, col, row, address, value);
+}
+
+struct AIEInsertTracePass : AIEInsertTraceBase<AIEInsertTracePass> {
+  // The events of a trace unit, from the attribute of the tile if it has one
+  // and from the options of the pass otherwise. At most 8 events are traced
+  // per unit; the unused slots record no event.
+  LogicalResult getEvents(TileOp tile, StringRef attrName,
+                          ArrayRef<int32_t> defaults,
+                          SmallVectorImpl<int32_t> &events) {
+    ArrayRef<int32_t> selected = defaults;
+    if (auto attr = tile->getAttrOfType<DenseI32ArrayAttr>(attrName))
+      selected = attr.asArrayRef();
+    else if (tile->hasAttr(attrName))
+      return tile.emitOpError() << "expected '" << attrName
+                                << "' to be an array of i32";
+    if (selected.size() > 8)
+      return tile.emitOpError() << "can trace at most 8 events, got "
+                                << selected.size();
+    for (int32_t event : selected)
+      if (event < 0 || event > 0x7F)
+        return tile.emitOpError() << "trace event " << event
+                                  << " is not in the [0:127] range";
+    events.assign(selected.begin(), selected.end());
+    return success();
+  }
+
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    const auto &targetModel = device.getTargetModel();
+    auto &index = getAnalysis<DeviceIndex>();
+
+    if (targetModel.getTargetArch() != AIEArch::AIE2) {
+      device.emitOpError("tracing is only supported on AIE2 devices");
+      return signalPassFailure();
+    }
+
+    // The trace units of the cores, in the order of the device.
+    SmallVector<TraceUnit> units;
+    SmallVector<int32_t> coreEvents(clEvents.begin(), clEvents.end());
+    if (coreEvents.empty())
+      coreEvents.assign(std::begin(defaultCoreEvents),
+                        std::end(defaultCoreEvents));
+    SmallVector<int32_t> memEvents(clMemEvents.begin(), clMemEvents.end());
+    for (auto core : device.getOps<CoreOp>()) {
+      TileOp tile = core.getTileOp();
+      TraceUnit coreUnit{tile, 0, corePacketType, {}};
+      TraceUnit memUnit{tile, 1, memPacketType, {}};
+      if (failed(getEvents(tile, "trace_events", coreEvents,
+                           coreUnit.events)) ||
+          failed(getEvents(tile, "trace_mem_events", memEvents,
+                           memUnit.events)))
+        return signalPassFailure();
+      for (auto &unit : {coreUnit, memUnit})
+        if (!unit.events.empty())
+          units.push_back(unit);
+    }
+    if (clTimestamps) {
+      std::set<int64_t> shimCols;
+      for (auto alloc : device.getOps<ShimDMAAllocationOp>())
+        shimCols.insert(alloc.getCol());
+      for (int64_t col : shimCols) {
+        TileOp tile = index.getTile(col, 0);
+        if (!tile) {
+          OpBuilder builder = OpBuilder::atBlockBegin(device.getBody());
+          tile = builder.create<TileOp>(device.getLoc(), col, 0);
+          index.addTile(tile);
+        }
+        units.push_back({tile, 0, shimPacketType,
+                         SmallVector<int32_t, 8>(std::begin(shimEvents),
+                                                 std::end(shimEvents))});
+      }
+    }
+    if (units.empty())
+      return markAllAnalysesPreserved();
+
+    // The trace packets get ids above the ones of the existing packet flows.
+    int packetId = 0;
+    for (auto flow : device.getOps<PacketFlowOp>())
+      packetId = std::max(packetId, flow.IDInt());
+    if (packetId + static_cast<int>(units.size()) > maxPacketId) {
+      device.emitOpError() << "not enough packet ids left to trace "
+                           << units.size() << " modules";
+      return signalPassFailure();
+    }
+    for (auto &unit : units)
+      unit.packetId = ++packetId;
+
+    // The shim tile and channel collecting the traces: by default the first
+    // free S2MM channel of the first shim NOC tile.
+    int shimCol = clShimCol;
+    if (shimCol < 0)
+      for (int col = 0; col < targetModel.columns() && shimCol < 0; col++)
+        if (targetModel.isShimNOCTile(col, 0))
+          shimCol = col;
+    if (shimCol < 0 || shimCol >= targetModel.columns() ||
+        !targetModel.isShimNOCTile(shimCol, 0)) {
+      device.emitOpError() << "no shim NOC tile to collect the traces";
+      return signalPassFailure();
+    }
+    int channel = clShimChannel;
+    if (channel < 0) {
+      SmallVector<bool, 2> used(2, false);
+      for (auto alloc : device.getOps<ShimDMAAllocationOp>())
+        if (alloc.getCol() == shimCol &&
+            alloc.getChannelDir() == DMAChannelDir::S2MM &&
+            alloc.getChannelIndex() < 2)
+          used[alloc.getChannelIndex()] = true;
+      // Prefer channel 1, which applications leave free more often.
+      channel = !used[1] ? 1 : !used[0] ? 0 : -1;
+      if (channel < 0) {
+        device.emitOpError() << "no free S2MM channel in shim tile ("
+                             << shimCol << ", 0) to collect the traces";
+        return signalPassFailure();
+      }
+    }
+    if (channel > 1) {
+      device.emitOpError() << "shim S2MM channel " << channel
+                           << " is not in the [0:1] range";
+      return signalPassFailure();
+    }
+    // The shim tile collecting the traces traces the tasks of its other
+    // S2MM channel.
+    for (auto &unit : units)
+      if (unit.packetType == shimPacketType && unit.tile.getCol() == shimCol &&
+          channel == 0)
+        std::copy(std::begin(shimS2MM1Events), std::end(shimS2MM1Events),
+                  unit.events.end() - 2);
+    int numBds = targetModel.getNumBDs(shimCol, 0);
+    if (clBdId < 0 || clBdId >= numBds) {
+      device.emitOpError() << "trace BD id " << clBdId
+                           << " is not in the [0:" << numBds - 1 << "] range";
+      return signalPassFailure();
+    }
+    if (clSyncBroadcast < -1 || clSyncBroadcast > 15) {
+      device.emitOpError() << "broadcast channel " << clSyncBroadcast
+                           << " is not in the [0:15] range";
+      return signalPassFailure();
+    }
+    if (clTraceSize <= 0 || clTraceSize % 4 || clTraceOffset % 4) {
+      device.emitOpError("the size and offset of the trace buffer must be "
+                         "multiples of 4 bytes");
+      return signalPassFailure();
+    }
+    if (index.lookupSymbol(clSymName) ||
+        index.getShimDMAAllocation(clSymName)) {
+      device.emitOpError() << "symbol '" << clSymName << "' already exists";
+      return signalPassFailure();
+    }
+
+    OpBuilder builder(device.getBody()->getTerminator());
+    Location loc = device.getLoc();
+    TileOp shim = index.getTile(shimCol, 0);
+    if (!shim) {
+      builder.setInsertionPointToStart(device.getBody());
+      shim = builder.create<TileOp>(loc, shimCol, 0);
+      builder.setInsertionPoint(device.getBody()->getTerminator());
+    }
+
+    // Route every trace port to the shim channel.
+    for (auto &unit : units) {
+      auto flow = builder.create<PacketFlowOp>(loc, unit.packetId);
+      flow->setAttr("keep_pkt_header", builder.getBoolAttr(true));
+      OpBuilder::InsertionGuard guard(builder);
+      builder.setInsertionPointToStart(builder.createBlock(&flow.getPorts()));
+      builder.create<PacketSourceOp>(loc, unit.tile, WireBundle::Trace,
+                                     unit.port);
+      builder.create<PacketDestOp>(loc, shim, WireBundle::DMA, channel);
+      builder.create<EndOp>(loc);
+    }
+    MLIRContext *ctx = device.getContext();
+    builder.create<ShimDMAAllocationOp>(
+        loc, FlatSymbolRefAttr::get(ctx, clSymName),
+        DMAChannelDirAttr::get(ctx, DMAChannelDir::S2MM),
+        builder.getI64IntegerAttr(channel), builder.getI64IntegerAttr(shimCol));
+
+    for (auto func : device.getOps<func::FuncOp>()) {
+      if (func.isDeclaration())
+        continue;
+      int arg = clTraceArg < 0 ? func.getNumArguments() + clTraceArg
+                               : static_cast<int>(clTraceArg);
+      if (arg < 0 || arg >= static_cast<int>(func.getNumArguments())) {
+        func.emitOpError() << "has no argument " << clTraceArg
+                           << " to hold the trace buffer";
+        return signalPassFailure();
+      }
+      bool bdUsed = false;
+      func.walk([&](IpuDmaMemcpyNdOp op) {
+        auto alloc = index.getShimDMAAllocation(op.getMetadata());
+        bdUsed |= op.getId() == clBdId && alloc && alloc->getCol() == shimCol;
+      });
+      func.walk([&](IpuWriteBdExShimTileOp op) {
+        bdUsed |= op.getBdId() == clBdId && op.getColumn() == shimCol;
+      });
+      if (bdUsed) {
+        func.emitOpError() << "already uses BD " << clBdId << " of column "
+                           << shimCol << ", pick another one with bd-id";
+        return signalPassFailure();
+      }
+
+      builder.setInsertionPointToStart(&func.getBody().front());
+      Location funcLoc = func.getLoc();
+      auto zero = i32Attr(builder, 0);
+      builder.create<IpuWriteBdExShimTileOp>(
+          funcLoc, /*column=*/i32Attr(builder, shimCol),
+          /*column_num=*/i32Attr(builder, 1), /*ddr_id=*/i32Attr(builder, arg),
+          /*bd_id=*/i32Attr(builder, clBdId),
+          /*buffer_length=*/i32Attr(builder, clTraceSize / 4),
+          /*buffer_offset=*/i32Attr(builder, clTraceOffset),
+          /*enable_packet=*/zero, /*out_of_order_id=*/zero,
+          /*packet_id=*/zero, /*packet_type=*/zero, /*d0_size=*/zero,
+          /*d0_stride=*/zero, /*d1_size=*/zero, /*d1_stride=*/zero,
+          /*d2_stride=*/zero, /*iteration_current=*/zero,
+          /*iteration_size=*/zero, /*iteration_stride=*/zero,
+          /*next_bd=*/zero, /*use_next_bd=*/zero,
+          /*valid_bd=*/i32Attr(builder, 1), /*lock_rel_val=*/zero,
+          /*lock_rel_id=*/zero, /*lock_acq_enable=*/zero,
+          /*lock_acq_val=*/zero, /*lock_acq_id=*/zero,
+          /*buffer_length_params=*/nullptr, /*buffer_offset_params=*/nullptr,
+          /*burst_length=*/nullptr, /*ax_cache=*/nullptr, /*ax_qos=*/nullptr);
+      createWrite32(builder, funcLoc, shimCol, 0, shimS2MMQueue + 8 * channel,
+                    clBdId);
+
+      // Reset the timers of the traced modules together, from a user event
+      // of the shim tile collecting the traces sent on the broadcast
+      // channel. The reset events and the broadcast are cleared right after,
+      // so that the user events generated by the runtime sequence don't
+      // reset the timers again; the broadcast crosses the array long before
+      // the next write of the sequence.
+      if (clSyncBroadcast >= 0) {
+        auto timerControl = [&](const TraceUnit &unit) {
+          return unit.packetType == memPacketType ? memTimerControl
+                                                  : coreTimerControl;
+        };
+        for (auto &unit : units) {
+          int32_t event = coreBroadcast0Event + clSyncBroadcast;
+          if (unit.packetType == shimPacketType)
+            event = unit.tile.getCol() == shimCol
+                        ? shimUserEvent1
+                        : shimBroadcast0Event + clSyncBroadcast;
+          createWrite32(builder, funcLoc, unit.tile.getCol(),
+                        unit.tile.getRow(), timerControl(unit),
+                        (event & 0x7F) << 8);
+        }
+        uint32_t broadcast = eventBroadcast0 + 4 * clSyncBroadcast;
+        createWrite32(builder, funcLoc, shimCol, 0, broadcast, shimUserEvent1);
+        createWrite32(builder, funcLoc, shimCol, 0, eventGenerate,
+                      shimUserEvent1);
+        createWrite32(builder, funcLoc, shimCol, 0, broadcast, 0);
+        for (auto &unit : units)
+          createWrite32(builder, funcLoc, unit.tile.getCol(),
+                        unit.tile.getRow(), timerControl(unit), 0);
+      }
+
+      // Select the events, the packets and then start the trace units.
+      for (auto &unit : units) {
+        int col = unit.tile.getCol();
+        int row = unit.tile.getRow();
+        uint32_t base = unit.packetType == memPacketType ? memTraceBase
+                                                         : coreTraceBase;
+        uint32_t slots[2] = {0, 0};
+        for (auto [i, event] : llvm::enumerate(unit.events))
+          slots[i / 4] |= static_cast<uint32_t>(event) << (8 * (i % 4));
+        createWrite32(builder, funcLoc, col, row, base + traceEvent0,
+                      slots[0]);
+        createWrite32(builder, funcLoc, col, row, base + traceEvent1,
+                      slots[1]);
+        createWrite32(builder, funcLoc, col, row, base + traceControl1,
+                      (unit.packetType << 12) | unit.packetId);
+        createWrite32(builder, funcLoc, col, row, base + traceControl0,
+                      ((clStopEvent & 0x7F) << 24) |
+                          ((clStartEvent & 0x7F) << 16));
+      }
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>> AIEX::createAIEInsertTracePass() {
+  return std::make_unique<AIEInsertTracePass>();
+}
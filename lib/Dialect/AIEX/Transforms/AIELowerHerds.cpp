@@ -0,0 +1,330 @@
+//===- AIELowerHerds.cpp ----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This pass lowers the cores, buffers, locks and flows declared on herds to
+// one copy on each tile of the herd.
+//
+// A herd is placed by the `aie.col` and `aie.row` attributes of its bottom-left
+// tile, or relatively to another placed herd by an aiex.place operation. Each
+// element declared on a herd is cloned once for each position of the herd, its
+// uses of the elements of herds replaced by their copies at the same position.
+// A flow between two herds of the same shape, or between a herd and a tile, is
+// replicated for each position of the herd. The switchboxes built by
+// aie-herd-routing on single tiles of a herd are moved to their tiles.
+//
+// The copies of a core run the same code. When they only access the buffers
+// and locks of their own herd, and the tiles of the herd hold nothing else,
+// the buffers and locks of every tile are laid out the same, and the cores
+// share one ELF file, compiled once by aiecc. On AIE1, the addresses of the
+// local memory differ between even and odd rows, so each parity of row gets
+// its own ELF file.
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/Support/FormatVariadic.h"
+
+#include <map>
+
+#define DEBUG_TYPE "aie-lower-herds"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+using namespace xilinx::AIEX;
+
+namespace {
+
+// The tiles of a placed herd, indexed by their position in the herd.
+struct HerdTiles {
+  int width;
+  int height;
+  SmallVector<TileOp> tiles;
+};
+
+} // namespace
+
+// Place the herds from their `aie.col` and `aie.row` attributes and the
+// aiex.place operations relating them.
+static LogicalResult placeHerds(DeviceOp device,
+                                DenseMap<Operation *, TileID> &origins) {
+  for (auto herd : device.getOps<HerdOp>()) {
+    auto col = herd->getAttrOfType<IntegerAttr>("aie.col");
+    auto row = herd->getAttrOfType<IntegerAttr>("aie.row");
+    if (col && row)
+      origins[herd] = {int(col.getInt()), int(row.getInt())};
+  }
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto place : device.getOps<PlaceOp>()) {
+      Operation *source = place.getSourceHerd().getDefiningOp();
+      Operation *dest = place.getDestHerd().getDefiningOp();
+      int distX = place.getDistXValue(), distY = place.getDistYValue();
+      auto sourceOrigin = origins.find(source);
+      auto destOrigin = origins.find(dest);
+      if (sourceOrigin != origins.end() && destOrigin != origins.end()) {
+        TileID expected = {sourceOrigin->second.col + distX,
+                           sourceOrigin->second.row + distY};
+        if (destOrigin->second != expected)
+          return place.emitOpError("conflicts with the placement of its herds");
+      } else if (sourceOrigin != origins.end()) {
+        origins[dest] = {sourceOrigin->second.col + distX,
+                         sourceOrigin->second.row + distY};
+        changed = true;
+      } else if (destOrigin != origins.end()) {
+        origins[source] = {destOrigin->second.col - distX,
+                           destOrigin->second.row - distY};
+        changed = true;
+      }
+    }
+  }
+  return success();
+}
+
+static std::string getHerdName(HerdOp herd, int index) {
+  if (auto name = herd->getAttrOfType<StringAttr>(
+          SymbolTable::getSymbolAttrName()))
+    return name.str();
+  return "herd" + std::to_string(index);
+}
+
+struct AIELowerHerdsPass : AIELowerHerdsBase<AIELowerHerdsPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    const auto &targetModel = device.getTargetModel();
+    OpBuilder builder(device.getContext());
+
+    SmallVector<HerdOp> herds(device.getOps<HerdOp>());
+    if (herds.empty())
+      return;
+
+    for (auto route : device.getOps<RouteOp>()) {
+      route.emitOpError("must be routed by aie-herd-routing before the herds "
+                        "are lowered");
+      return signalPassFailure();
+    }
+
+    DenseMap<Operation *, TileID> origins;
+    if (failed(placeHerds(device, origins)))
+      return signalPassFailure();
+
+    DenseMap<TileID, TileOp> tiles;
+    for (auto tile : device.getOps<TileOp>())
+      tiles[tile.getTileID()] = tile;
+    Operation *firstHerd = herds.front();
+    auto getTile = [&](TileID id) {
+      if (TileOp tile = tiles.lookup(id)) {
+        // The copies of the elements of the herds are built in place of the
+        // elements, after the herds: the tile must come before.
+        if (firstHerd->isBeforeInBlock(tile))
+          tile->moveBefore(firstHerd);
+        return tile;
+      }
+      builder.setInsertionPoint(firstHerd);
+      auto tile = builder.create<TileOp>(builder.getUnknownLoc(), id.col,
+                                         id.row);
+      tiles[id] = tile;
+      return tile;
+    };
+
+    // The tiles of each herd, and the mapping of the elements of all herds
+    // to their copies at each position.
+    DenseMap<Operation *, HerdTiles> herdTiles;
+    std::map<std::pair<int, int>, IRMapping> mappings;
+    for (auto herd : herds) {
+      auto origin = origins.find(herd);
+      if (origin == origins.end()) {
+        herd.emitOpError("is not placed: set its `aie.col` and `aie.row` "
+                         "attributes or place it relative to a placed herd");
+        return signalPassFailure();
+      }
+      HerdTiles &placed = herdTiles[herd];
+      placed.width = herd.getHerdWidth();
+      placed.height = herd.getHerdHeight();
+      for (int x = 0; x < placed.width; x++)
+        for (int y = 0; y < placed.height; y++) {
+          TileID id = {origin->second.col + x, origin->second.row + y};
+          if (!targetModel.isCoreTile(id.col, id.row)) {
+            herd.emitOpError("covers (")
+                << id.col << ", " << id.row << "), which is not a core tile";
+            return signalPassFailure();
+          }
+          TileOp tile = getTile(id);
+          placed.tiles.push_back(tile);
+          mappings[{x, y}].map(herd.getResult(), tile.getResult());
+        }
+    }
+
+    auto getHerd = [&](Value value) -> HerdOp {
+      return dyn_cast_or_null<HerdOp>(value.getDefiningOp());
+    };
+
+    SmallVector<Operation *> toErase;
+    // The herd of each lowered core, and the copies of the elements of each
+    // herd, to decide which cores can share code.
+    SmallVector<std::pair<CoreOp, HerdOp>> herdCores;
+    DenseMap<Operation *, DenseSet<Operation *>> herdElements;
+    for (Operation &op : llvm::make_early_inc_range(*device.getBody())) {
+      if (isa<MemOp>(op) && getHerd(op.getOperand(0))) {
+        op.emitOpError("on a herd is not supported");
+        return signalPassFailure();
+      }
+
+      if (auto flow = dyn_cast<FlowOp>(op)) {
+        HerdOp source = getHerd(flow.getSource());
+        HerdOp dest = getHerd(flow.getDest());
+        if (!source && !dest)
+          continue;
+        if (source && dest &&
+            (source.getHerdWidth() != dest.getHerdWidth() ||
+             source.getHerdHeight() != dest.getHerdHeight())) {
+          flow.emitOpError("connects herds of different shapes");
+          return signalPassFailure();
+        }
+        const HerdTiles &placed = herdTiles[source ? source : dest];
+        builder.setInsertionPoint(flow);
+        for (int x = 0; x < placed.width; x++)
+          for (int y = 0; y < placed.height; y++)
+            builder.clone(*flow, mappings[{x, y}]);
+        toErase.push_back(flow);
+        continue;
+      }
+
+      if (!isa<CoreOp, BufferOp, LockOp>(op))
+        continue;
+      HerdOp herd = getHerd(op.getOperand(0));
+      if (!herd)
+        continue;
+      const HerdTiles &placed = herdTiles[herd];
+      auto symName =
+          op.getAttrOfType<StringAttr>(SymbolTable::getSymbolAttrName());
+      builder.setInsertionPoint(&op);
+      for (int x = 0; x < placed.width; x++)
+        for (int y = 0; y < placed.height; y++) {
+          Operation *copy = builder.clone(op, mappings[{x, y}]);
+          if (symName)
+            copy->setAttr(SymbolTable::getSymbolAttrName(),
+                          builder.getStringAttr(llvm::formatv(
+                              "{0}_{1}_{2}", symName.getValue(), x, y)));
+          if (auto core = dyn_cast<CoreOp>(copy))
+            herdCores.push_back({core, herd});
+          else
+            herdElements[herd].insert(copy);
+        }
+      toErase.push_back(&op);
+    }
+
+    // Move the switchboxes built on single tiles of a herd to their tiles.
+    for (auto switchbox :
+         llvm::make_early_inc_range(device.getOps<SwitchboxOp>())) {
+      auto select =
+          dyn_cast_or_null<SelectOp>(switchbox.getTile().getDefiningOp());
+      if (!select)
+        continue;
+      HerdOp herd = getHerd(select.getStartHerd());
+      auto iterX = dyn_cast_or_null<IterOp>(select.getIterX().getDefiningOp());
+      auto iterY = dyn_cast_or_null<IterOp>(select.getIterY().getDefiningOp());
+      if (!herd || !iterX || !iterY) {
+        switchbox.emitOpError("must select tiles of a herd with aiex.iter");
+        return signalPassFailure();
+      }
+      TileID origin = origins[herd];
+      for (int x = iterX.getStartValue(); x < iterX.getEndValue();
+           x += iterX.getStrideValue())
+        for (int y = iterY.getStartValue(); y < iterY.getEndValue();
+             y += iterY.getStrideValue()) {
+          TileOp tile = getTile({origin.col + x, origin.row + y});
+          IRMapping mapping;
+          mapping.map(select.getResult(), tile.getResult());
+          builder.setInsertionPoint(switchbox);
+          builder.clone(*switchbox, mapping);
+        }
+      switchbox.erase();
+    }
+
+    // The copies of a core share code when it only uses the buffers and locks
+    // of its herd, and its tiles hold nothing else.
+    DenseSet<Operation *> sharesLayout;
+    for (auto herd : herds) {
+      const DenseSet<Operation *> &elements = herdElements[herd];
+      bool onlyHerdElements = true;
+      for (TileOp tile : herdTiles[herd].tiles)
+        for (Operation *user : tile->getUsers())
+          if (isa<BufferOp, LockOp>(user) && !elements.contains(user))
+            onlyHerdElements = false;
+      if (onlyHerdElements)
+        sharesLayout.insert(herd);
+    }
+    for (auto [index, herd] : llvm::enumerate(herds)) {
+      if (!sharesLayout.contains(herd))
+        continue;
+      const DenseSet<Operation *> &elements = herdElements[herd];
+      SmallVector<CoreOp> cores;
+      bool shared = true;
+      for (auto [core, coreHerd] : herdCores) {
+        if (coreHerd != herd)
+          continue;
+        cores.push_back(core);
+        core.walk([&](Operation *op) {
+          for (Value operand : op->getOperands()) {
+            Operation *def = operand.getDefiningOp();
+            if (isa_and_nonnull<BufferOp, LockOp>(def) &&
+                (!elements.contains(def) ||
+                 cast<TileElement>(def).getTileID() != core.getTileID()))
+              shared = false;
+          }
+        });
+      }
+      if (!shared)
+        continue;
+      std::string name = getHerdName(herd, index);
+      for (CoreOp core : cores) {
+        if (core.getElfFile())
+          continue;
+        std::string elfFile = name;
+        if (targetModel.getTargetArch() == AIEArch::AIE1)
+          elfFile += core.rowIndex() % 2 ? "_odd" : "_even";
+        core.setElfFileAttr(builder.getStringAttr(elfFile + ".elf"));
+      }
+    }
+
+    // The users of the elements of a herd come after them.
+    for (Operation *op : llvm::reverse(toErase)) {
+      if (!op->use_empty()) {
+        op->emitOpError("is used outside of its herd");
+        return signalPassFailure();
+      }
+      op->erase();
+    }
+    for (auto place : llvm::make_early_inc_range(device.getOps<PlaceOp>()))
+      place.erase();
+    for (Operation &op : llvm::make_early_inc_range(
+             llvm::reverse(device.getBody()->getOperations())))
+      if (isa<SelectOp, IterOp>(op) && op.use_empty())
+        op.erase();
+    for (auto herd : herds) {
+      if (!herd->use_empty()) {
+        herd.emitOpError("has uses which cannot be lowered");
+        return signalPassFailure();
+      }
+      herd.erase();
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>> AIEX::createAIELowerHerdsPass() {
+  return std::make_unique<AIELowerHerdsPass>();
+}
@@ -16,12 +16,10 @@
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/Attributes.h"
-#include "mlir/IR/IRMapping.h"
 #include "mlir/IR/Location.h"
-#include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
-#include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
-#include "mlir/Transforms/DialectConversion.h"
+
+#include "llvm/ADT/MapVector.h"
 
 using namespace mlir;
 using namespace xilinx;
@@ -35,108 +33,106 @@ static TileOp dstTileOp(xilinx::AIEX::MemcpyOp op) {
   return llvm::dyn_cast<xilinx::AIE::TileOp>(op.getDstTile().getDefiningOp());
 }
 
-struct LowerAIEMemcpy : public OpConversionPattern<MemcpyOp> {
-  using OpConversionPattern<MemcpyOp>::OpConversionPattern;
-
-  LowerAIEMemcpy(MLIRContext *context, PatternBenefit benefit = 1)
-      : OpConversionPattern<MemcpyOp>(context, benefit) {}
-
-  void createDMABlocksAndOps(MemOp &mem, StringRef tokenName, int acquireTknVal,
-                             int releaseTknVal, Value buf, int offset, int len,
-                             DMAChannelDir dmaDir, int channelIndex,
-                             ConversionPatternRewriter &rewriter) const {
-
-    Region &r = mem.getBody();
-    Block &endBlock = r.back();
-    Block *dmaBlock = rewriter.createBlock(&endBlock);
-    Block *bdBlock = rewriter.createBlock(&endBlock);
-
-    rewriter.setInsertionPointToStart(dmaBlock);
-    rewriter.create<DMAStartOp>(rewriter.getUnknownLoc(), dmaDir, channelIndex,
-                                /*repeatCount*/ 1, bdBlock, &endBlock);
-
-    // Setup bd Block
-    // It should contain locking operations (lock or token) as well as DMABD op
-    // for specifying DMA Block description (which buffer type (A/B), transfer
-    // length/address, etc.)
-    rewriter.setInsertionPointToStart(bdBlock);
-    rewriter.create<UseTokenOp>(rewriter.getUnknownLoc(), tokenName,
-                                acquireTknVal, LockAction::Acquire);
-    rewriter.create<DMABDOp>(rewriter.getUnknownLoc(), buf, offset, len);
-    rewriter.create<UseTokenOp>(rewriter.getUnknownLoc(), tokenName,
-                                releaseTknVal, LockAction::Release);
-    rewriter.create<NextBDOp>(rewriter.getUnknownLoc(), &endBlock);
-  }
-
-  LogicalResult
-  matchAndRewrite(MemcpyOp op, OpAdaptor adaptor,
-                  ConversionPatternRewriter &rewriter) const override {
-    Value srcBuf = op.getSrcBuf();
-    Value dstBuf = op.getDstBuf();
-
-    StringRef tokenName = op.getTokenName();
-    int acquireTknVal = op.getAcquireTokenValue();
-    int releaseTknVal = op.getReleaseTokenValue();
-    int srcOffset = op.getSrcOffsetValue();
-    int dstOffset = op.getDstOffsetValue();
-    int srcLen = op.getSrcLenValue();
-    int dstLen = op.getDstLenValue();
-
-    MemOp srcMem = srcTileOp(op).getMemOp();
-    MemOp dstMem = dstTileOp(op).getMemOp();
-
-    createDMABlocksAndOps(srcMem, tokenName, acquireTknVal, releaseTknVal,
-                          srcBuf, srcOffset, srcLen, DMAChannelDir::MM2S, 0,
-                          rewriter);
-    createDMABlocksAndOps(dstMem, tokenName, acquireTknVal, releaseTknVal,
-                          dstBuf, dstOffset, dstLen, DMAChannelDir::S2MM, 0,
-                          rewriter);
-
-    rewriter.eraseOp(op);
-    return success();
+// Start a DMA channel of the given memory module on a chain of BDs, one for
+// each copy. The DMA moves on to the next copy as soon as its token is
+// acquired, without waiting for the core to restart the channel, so that the
+// copies overlap with the computations of the cores.
+static void createDMAChain(OpBuilder &builder, MemOp mem,
+                           ArrayRef<MemcpyOp> copies, DMAChannelDir dmaDir,
+                           int channelIndex) {
+  Region &r = mem.getBody();
+  Block &endBlock = r.back();
+  DMAStartOp lastStart;
+  for (Block &block : r)
+    if (auto start = dyn_cast<DMAStartOp>(block.getTerminator()))
+      if (start.getChain() == &endBlock)
+        lastStart = start;
+
+  Block *dmaBlock = builder.createBlock(&endBlock);
+  SmallVector<Block *> bdBlocks;
+  for (size_t i = 0; i < copies.size(); i++)
+    bdBlocks.push_back(builder.createBlock(&endBlock));
+  if (lastStart)
+    lastStart->setSuccessor(dmaBlock, 1);
+
+  builder.setInsertionPointToStart(dmaBlock);
+  builder.create<DMAStartOp>(builder.getUnknownLoc(), dmaDir, channelIndex,
+                             /*repeatCount*/ 1, bdBlocks.front(), &endBlock);
+
+  // Each bd Block contains locking operations (lock or token) as well as the
+  // DMABD op specifying the transfer (buffer, offset and length).
+  for (auto [index, copy] : llvm::enumerate(copies)) {
+    bool send = dmaDir == DMAChannelDir::MM2S;
+    Value buf = send ? copy.getSrcBuf() : copy.getDstBuf();
+    int offset = send ? copy.getSrcOffsetValue() : copy.getDstOffsetValue();
+    int len = send ? copy.getSrcLenValue() : copy.getDstLenValue();
+    builder.setInsertionPointToStart(bdBlocks[index]);
+    builder.create<UseTokenOp>(builder.getUnknownLoc(), copy.getTokenName(),
+                               copy.getAcquireTokenValue(),
+                               LockAction::Acquire);
+    builder.create<DMABDOp>(builder.getUnknownLoc(), buf, offset, len);
+    builder.create<UseTokenOp>(builder.getUnknownLoc(), copy.getTokenName(),
+                               copy.getReleaseTokenValue(),
+                               LockAction::Release);
+    Block *next =
+        index + 1 < bdBlocks.size() ? bdBlocks[index + 1] : &endBlock;
+    builder.create<NextBDOp>(builder.getUnknownLoc(), next);
   }
-};
+}
 
 struct AIELowerMemcpyPass : public AIELowerMemcpyBase<AIELowerMemcpyPass> {
   void runOnOperation() override {
 
     DeviceOp device = getOperation();
+    const auto &targetModel = device.getTargetModel();
     OpBuilder builder = OpBuilder::atBlockEnd(device.getBody());
 
+    // The copies between the same two tiles share one stream, and one DMA
+    // channel on each side, which processes them in order as a BD chain.
+    llvm::MapVector<std::pair<Operation *, Operation *>,
+                    SmallVector<MemcpyOp>>
+        streams;
+    for (auto op : device.getOps<MemcpyOp>())
+      streams[{srcTileOp(op), dstTileOp(op)}].push_back(op);
+
     // Setup FlowOps
     // Since memcpy moves data from one memory module to another, we use
-    // WireBundle::DMA for both the source and the destination In addition, we
-    // only have two DMA ports per each direction (MM2S/S2MM), and in a
-    // circuit-switch mode, dest port/channel sharing is not possible.
-    // Therefore, we will generate error if the number of logical flows
-    // (streams) targeting the same destination (S2MM) is more than 2
-    DenseMap<Value, int> destChannel;
-    for (auto op : device.getOps<MemcpyOp>()) {
-      builder.setInsertionPoint(op);
-      TileOp srcTile = dyn_cast<TileOp>(op.getSrcTile().getDefiningOp());
-      TileOp dstTile = dyn_cast<TileOp>(op.getDstTile().getDefiningOp());
-      // TODO: perhaps a better approach is to not assert here, but rather have
-      // a subsequent pass that legally relocates the ports
-      assert(destChannel[op.getDstTile()] <= 2 &&
-             "Could not allocate more than two dest. channel when creating "
-             "FlowOp");
+    // WireBundle::DMA for both the source and the destination. In a
+    // circuit-switch mode, port/channel sharing is not possible: each stream
+    // needs its own MM2S channel on its source and S2MM channel on its
+    // destination, and we generate an error when a tile runs out of them.
+    DenseMap<Operation *, unsigned> sourceChannel;
+    DenseMap<Operation *, unsigned> destChannel;
+    for (auto &[tiles, copies] : streams) {
+      TileOp srcTile = cast<TileOp>(tiles.first);
+      TileOp dstTile = cast<TileOp>(tiles.second);
+      unsigned mm2s = sourceChannel[srcTile]++;
+      unsigned s2mm = destChannel[dstTile]++;
+      if (mm2s >= targetModel.getNumSourceSwitchboxConnections(
+                      srcTile.colIndex(), srcTile.rowIndex(),
+                      WireBundle::DMA)) {
+        copies.front().emitOpError("needs more MM2S DMA channels than tile (")
+            << srcTile.colIndex() << ", " << srcTile.rowIndex() << ") has";
+        return signalPassFailure();
+      }
+      if (s2mm >= targetModel.getNumDestSwitchboxConnections(
+                      dstTile.colIndex(), dstTile.rowIndex(),
+                      WireBundle::DMA)) {
+        copies.front().emitOpError("needs more S2MM DMA channels than tile (")
+            << dstTile.colIndex() << ", " << dstTile.rowIndex() << ") has";
+        return signalPassFailure();
+      }
+
+      builder.setInsertionPoint(copies.front());
       builder.create<FlowOp>(builder.getUnknownLoc(), srcTile, WireBundle::DMA,
-                             0, dstTile, WireBundle::DMA,
-                             destChannel[op.getDstTile()]);
-      destChannel[op.getDstTile()]++;
+                             mm2s, dstTile, WireBundle::DMA, s2mm);
+      createDMAChain(builder, srcTile.getMemOp(), copies, DMAChannelDir::MM2S,
+                     mm2s);
+      createDMAChain(builder, dstTile.getMemOp(), copies, DMAChannelDir::S2MM,
+                     s2mm);
+      for (MemcpyOp copy : copies)
+        copy.erase();
     }
-
-    ConversionTarget target(getContext());
-    RewritePatternSet patterns(&getContext());
-    target.addLegalOp<DMAStartOp>();
-    target.addLegalOp<DMABDOp>();
-    target.addLegalOp<UseTokenOp>();
-    target.addLegalOp<NextBDOp>();
-
-    patterns.insert<LowerAIEMemcpy>(&getContext());
-
-    if (failed(applyPartialConversion(device, target, std::move(patterns))))
-      signalPassFailure();
   }
 };
 
@@ -20,6 +20,8 @@
 
 #include "llvm/ADT/Twine.h"
 
+#include <map>
+
 #define DEBUG_TYPE "aie-lower-multicast"
 
 using namespace mlir;
@@ -45,27 +47,233 @@ struct AIEOpRemoval : public OpConversionPattern<MyOp> {
   }
 };
 
+namespace {
+
+// The streams from one source port to several destination ports.
+struct FanOut {
+  TileOp source;
+  Port sourcePort;
+  SmallVector<std::pair<TileOp, Port>> dests;
+};
+
+} // namespace
+
 struct AIELowerMulticastPass : public AIEMulticastBase<AIELowerMulticastPass> {
+  DenseMap<TileID, TileOp> tiles;
+  int nextPacketID = 0;
+  int numRelays = 0;
+
+  TileOp getTile(OpBuilder &builder, DeviceOp device, TileID id) {
+    if (TileOp tile = tiles.lookup(id))
+      return tile;
+    OpBuilder::InsertionGuard guard(builder);
+    builder.setInsertionPointToStart(device.getBody());
+    auto tile = builder.create<TileOp>(builder.getUnknownLoc(), id.col, id.row);
+    tiles[id] = tile;
+    return tile;
+  }
+
+  // Lower a fan-out to circuit flows, or to a packet flow beyond
+  // packet-threshold destinations.
+  void lowerFanOut(OpBuilder &builder, const FanOut &fanOut) {
+    if (clPacketThreshold == 0 || fanOut.dests.size() <= clPacketThreshold) {
+      for (auto [destTile, destPort] : fanOut.dests)
+        builder.create<FlowOp>(builder.getUnknownLoc(), fanOut.source,
+                               fanOut.sourcePort.bundle,
+                               fanOut.sourcePort.channel, destTile,
+                               destPort.bundle, destPort.channel);
+      return;
+    }
+    PacketFlowOp pkFlow =
+        builder.create<PacketFlowOp>(builder.getUnknownLoc(), nextPacketID++);
+    OpBuilder::InsertionGuard guard(builder);
+    builder.createBlock(&pkFlow.getPorts());
+    builder.create<PacketSourceOp>(builder.getUnknownLoc(), fanOut.source,
+                                   fanOut.sourcePort.bundle,
+                                   fanOut.sourcePort.channel);
+    for (auto [destTile, destPort] : fanOut.dests)
+      builder.create<PacketDestOp>(builder.getUnknownLoc(), destTile,
+                                   destPort.bundle, destPort.channel);
+    builder.create<EndOp>(builder.getUnknownLoc());
+  }
+
+  // The first DMA channel of the given direction of a tile which is neither
+  // started by its DMA nor the end of a flow, if any.
+  std::optional<int> getFreeDMAChannel(DeviceOp device, TileOp tile,
+                                       DMAChannelDir dir) {
+    const auto &targetModel = device.getTargetModel();
+    int numChannels =
+        dir == DMAChannelDir::S2MM
+            ? targetModel.getNumDestSwitchboxConnections(
+                  tile.colIndex(), tile.rowIndex(), WireBundle::DMA)
+            : targetModel.getNumSourceSwitchboxConnections(
+                  tile.colIndex(), tile.rowIndex(), WireBundle::DMA);
+    DenseSet<int> used;
+    for (auto dma : device.getOps<MemTileDMAOp>())
+      if (dma.getTile() == tile)
+        dma.walk([&](DMAStartOp start) {
+          if (start.getChannelDir() == dir)
+            used.insert(start.getChannelIndex());
+        });
+    for (auto flow : device.getOps<FlowOp>()) {
+      if (dir == DMAChannelDir::S2MM && flow.getDest() == tile &&
+          flow.getDestBundle() == WireBundle::DMA)
+        used.insert(flow.getDestChannel());
+      if (dir == DMAChannelDir::MM2S && flow.getSource() == tile &&
+          flow.getSourceBundle() == WireBundle::DMA)
+        used.insert(flow.getSourceChannel());
+    }
+    for (int channel = 0; channel < numChannels; channel++)
+      if (!used.contains(channel))
+        return channel;
+    return std::nullopt;
+  }
+
+  // Forward the data received on an S2MM channel of a memtile to one of its
+  // MM2S channels through two buffers of the given type.
+  void createRelay(OpBuilder &builder, DeviceOp device, TileOp memTile,
+                   MemRefType bufferType, int s2mm, int mm2s) {
+    OpBuilder::InsertionGuard guard(builder);
+    std::string name = "relay" + std::to_string(numRelays++);
+    builder.setInsertionPointAfter(memTile);
+    SmallVector<BufferOp, 2> buffers;
+    for (int i = 0; i < 2; i++)
+      buffers.push_back(builder.create<BufferOp>(
+          builder.getUnknownLoc(), bufferType, memTile,
+          builder.getStringAttr(name + "_buff_" + std::to_string(i)),
+          /*address*/ nullptr, /*initial_value*/ nullptr));
+    auto prodLock = builder.create<LockOp>(builder.getUnknownLoc(), memTile,
+                                           IntegerAttr(),
+                                           builder.getI32IntegerAttr(2),
+                                           builder.getStringAttr(name +
+                                                                 "_prod_lock"));
+    auto consLock = builder.create<LockOp>(builder.getUnknownLoc(), memTile,
+                                           IntegerAttr(),
+                                           builder.getI32IntegerAttr(0),
+                                           builder.getStringAttr(name +
+                                                                 "_cons_lock"));
+
+    MemTileDMAOp dmaOp;
+    for (auto dma : device.getOps<MemTileDMAOp>())
+      if (dma.getTile() == memTile)
+        dmaOp = dma;
+    if (!dmaOp) {
+      builder.setInsertionPointToEnd(device.getBody());
+      dmaOp = builder.create<MemTileDMAOp>(builder.getUnknownLoc(), memTile);
+      builder.setInsertionPointToStart(&dmaOp.getRegion().emplaceBlock());
+      builder.create<EndOp>(builder.getUnknownLoc());
+    }
+
+    Block *endBlock = nullptr;
+    for (Block &block : dmaOp.getRegion())
+      if (!block.getOps<EndOp>().empty())
+        endBlock = &block;
+    int len = bufferType.getNumElements();
+    auto addChannel = [&](DMAChannelDir dir, int channel, LockOp acqLock,
+                          LockOp relLock) {
+      Block *lastDmaBlock = endBlock->getSinglePredecessor();
+      Block *dmaBlock = builder.createBlock(endBlock);
+      Block *bdBlocks[2] = {builder.createBlock(endBlock),
+                            builder.createBlock(endBlock)};
+      builder.setInsertionPointToStart(dmaBlock);
+      builder.create<DMAStartOp>(builder.getUnknownLoc(), dir, channel,
+                                 /*repeatCount*/ 1, bdBlocks[0], endBlock);
+      if (lastDmaBlock != nullptr)
+        lastDmaBlock->getTerminator()->setSuccessor(dmaBlock, 1);
+      for (int i = 0; i < 2; i++) {
+        builder.setInsertionPointToStart(bdBlocks[i]);
+        builder.create<UseLockOp>(builder.getUnknownLoc(), acqLock,
+                                  LockAction::AcquireGreaterEqual, 1);
+        builder.create<DMABDOp>(builder.getUnknownLoc(), buffers[i], 0, len);
+        builder.create<UseLockOp>(builder.getUnknownLoc(), relLock,
+                                  LockAction::Release, 1);
+        builder.create<NextBDOp>(builder.getUnknownLoc(), bdBlocks[1 - i]);
+      }
+    };
+    addChannel(DMAChannelDir::S2MM, s2mm, prodLock, consLock);
+    addChannel(DMAChannelDir::MM2S, mm2s, consLock, prodLock);
+  }
+
+  // Split the multicast into a fan-out from its source to a memtile in each
+  // column with several destinations, and from each memtile to the
+  // destinations of its column.
+  SmallVector<FanOut> relayThroughMemTiles(OpBuilder &builder,
+                                           DeviceOp device, MulticastOp op,
+                                           const FanOut &fanOut) {
+    auto relayType = op->getAttrOfType<TypeAttr>("aie.relay_buffer");
+    auto bufferType =
+        relayType ? dyn_cast<MemRefType>(relayType.getValue()) : MemRefType();
+    if (!bufferType) {
+      op.emitWarning("is not relayed through memtiles without a memref type "
+                     "for its `aie.relay_buffer` attribute");
+      return {fanOut};
+    }
+
+    const auto &targetModel = device.getTargetModel();
+    std::map<int, SmallVector<std::pair<TileOp, Port>>> columns;
+    for (auto dest : fanOut.dests)
+      columns[dest.first.colIndex()].push_back(dest);
+
+    FanOut root{fanOut.source, fanOut.sourcePort, {}};
+    SmallVector<FanOut> fanOuts;
+    for (auto &[col, dests] : columns) {
+      std::optional<int> memTileRow;
+      for (int row = 0; row < targetModel.rows(); row++)
+        if (targetModel.isMemTile(col, row))
+          memTileRow = row;
+      if (dests.size() < 2 || !memTileRow) {
+        root.dests.append(dests);
+        continue;
+      }
+      TileOp memTile = getTile(builder, device, {col, *memTileRow});
+      std::optional<int> s2mm =
+          getFreeDMAChannel(device, memTile, DMAChannelDir::S2MM);
+      std::optional<int> mm2s =
+          getFreeDMAChannel(device, memTile, DMAChannelDir::MM2S);
+      if (memTile == fanOut.source || !s2mm || !mm2s) {
+        root.dests.append(dests);
+        continue;
+      }
+      createRelay(builder, device, memTile, bufferType, *s2mm, *mm2s);
+      root.dests.push_back({memTile, {WireBundle::DMA, *s2mm}});
+      fanOuts.push_back({memTile, {WireBundle::DMA, *mm2s}, dests});
+    }
+    fanOuts.insert(fanOuts.begin(), root);
+    return fanOuts;
+  }
+
   void runOnOperation() override {
 
     DeviceOp device = getOperation();
     OpBuilder builder = OpBuilder::atBlockEnd(device.getBody());
 
-    for (auto multicast : device.getOps<MulticastOp>()) {
+    for (auto tile : device.getOps<TileOp>())
+      tiles[tile.getTileID()] = tile;
+    device.walk([&](PacketFlowOp pkFlow) {
+      nextPacketID = std::max(nextPacketID, int(pkFlow.IDInt()) + 1);
+    });
+
+    for (auto multicast :
+         llvm::make_early_inc_range(device.getOps<MulticastOp>())) {
       Region &r = multicast.getPorts();
       Block &b = r.front();
-      Port sourcePort = multicast.port();
-      TileOp srcTile = dyn_cast<TileOp>(multicast.getTile().getDefiningOp());
+      FanOut fanOut;
+      fanOut.sourcePort = multicast.port();
+      fanOut.source = dyn_cast<TileOp>(multicast.getTile().getDefiningOp());
       for (Operation &Op : b.getOperations()) {
         if (MultiDestOp multiDest = dyn_cast<MultiDestOp>(Op)) {
           TileOp destTile =
               dyn_cast<TileOp>(multiDest.getTile().getDefiningOp());
-          Port destPort = multiDest.port();
-          builder.create<FlowOp>(builder.getUnknownLoc(), srcTile,
-                                 sourcePort.bundle, sourcePort.channel,
-                                 destTile, destPort.bundle, destPort.channel);
+          fanOut.dests.push_back({destTile, multiDest.port()});
         }
       }
+
+      SmallVector<FanOut> fanOuts = {fanOut};
+      if (clRelayThreshold > 0 && fanOut.dests.size() >= clRelayThreshold)
+        fanOuts = relayThroughMemTiles(builder, device, multicast, fanOut);
+      builder.setInsertionPointToEnd(device.getBody());
+      for (const FanOut &tree : fanOuts)
+        lowerFanOut(builder, tree);
     }
 
     ConversionTarget target(getContext());
@@ -0,0 +1,149 @@
+//===- AIEPipelineIpuSequence.cpp -------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Runtime sequences usually process a stream of batches, each one issuing its
+// transfers and then waiting for its outputs with aiex.ipu.sync. The input
+// transfers of a batch therefore only start once the outputs of the previous
+// batch have drained. This pass software-pipelines such sequences: the input
+// (MM2S) transfers at the start of a batch are hoisted above the syncs ending
+// the previous batch, so that they overlap with its compute and drain.
+//
+// A hoisted transfer runs while the transfers of the previous batch may still
+// be in flight, so it is moved to a BD id which isn't used by any transfer
+// until the syncs ending its own batch. Consecutive batches then alternate
+// between two sets of BDs, double buffering the inputs on the shim.
+
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/SmallBitVector.h"
+
+#define DEBUG_TYPE "aie-pipeline-ipu-sequence"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIEX;
+
+struct AIEPipelineIpuSequencePass
+    : AIEPipelineIpuSequenceBase<AIEPipelineIpuSequencePass> {
+  void pipelineBlock(AIE::DeviceOp device, const AIE::DeviceIndex &index,
+                     Block &block) {
+    auto getChannelDir =
+        [&](IpuDmaMemcpyNdOp op) -> std::optional<AIE::DMAChannelDir> {
+      if (auto alloc = index.getShimDMAAllocation(op.getMetadata()))
+        return alloc->getChannelDir();
+      return std::nullopt;
+    };
+    const auto &targetModel = device.getTargetModel();
+    // Split the block into batches, each one ending with a group of
+    // consecutive syncs.
+    struct Batch {
+      SmallVector<Operation *> ops;
+      SmallVector<IpuSyncOp> syncs;
+    };
+    SmallVector<Batch> batches(1);
+    for (Operation &op : block) {
+      if (auto sync = dyn_cast<IpuSyncOp>(op)) {
+        batches.back().syncs.push_back(sync);
+        continue;
+      }
+      if (!batches.back().syncs.empty())
+        batches.emplace_back();
+      batches.back().ops.push_back(&op);
+    }
+
+    for (size_t i = 0; i + 1 < batches.size(); i++) {
+      Batch &current = batches[i];
+      Batch &next = batches[i + 1];
+      if (current.syncs.empty())
+        break;
+      Operation *insertionPoint = current.syncs.front();
+
+      // The host buffers written by the current batch.
+      DenseSet<Value> outputs;
+      for (Operation *op : current.ops)
+        if (auto transfer = dyn_cast<IpuDmaMemcpyNdOp>(op);
+            transfer && getChannelDir(transfer) == AIE::DMAChannelDir::S2MM)
+          outputs.insert(transfer.getMemref());
+
+      // Hoist the input transfers at the start of the next batch, stepping
+      // over operations without side effects.
+      SmallVector<IpuDmaMemcpyNdOp> hoisted;
+      for (Operation *op : next.ops) {
+        auto transfer = dyn_cast<IpuDmaMemcpyNdOp>(op);
+        if (!transfer) {
+          if (isMemoryEffectFree(op))
+            continue;
+          break;
+        }
+        // A ring uses one BD id per slot and streams until the end of the
+        // design, so it is left in place.
+        if (getChannelDir(transfer) != AIE::DMAChannelDir::MM2S ||
+            outputs.contains(transfer.getMemref()) || transfer.getRingSlots())
+          break;
+        if (llvm::any_of(transfer->getOperands(), [&](Value operand) {
+              Operation *def = operand.getDefiningOp();
+              return def && def->getBlock() == &block &&
+                     !def->isBeforeInBlock(insertionPoint);
+            }))
+          break;
+        hoisted.push_back(transfer);
+      }
+      if (hoisted.empty())
+        continue;
+
+      // BD ids used from the current batch until the end of the next one.
+      // The batches keep the transfers hoisted out of them, since these run
+      // until the syncs ending their own batch.
+      llvm::SmallBitVector used(targetModel.getNumBDs(0, 0));
+      for (Batch *batch : {&current, &next})
+        for (Operation *op : batch->ops)
+          if (auto transfer = dyn_cast<IpuDmaMemcpyNdOp>(op);
+              transfer && !llvm::is_contained(hoisted, transfer) &&
+              transfer.getId() < used.size())
+            used.set(transfer.getId());
+
+      for (IpuDmaMemcpyNdOp transfer : hoisted) {
+        int id = used.find_first_unset();
+        if (id < 0) {
+          transfer.emitWarning("no free BD id to overlap this transfer with "
+                               "the previous batch");
+          break;
+        }
+        used.set(id);
+        LLVM_DEBUG(llvm::dbgs() << "Hoisting " << transfer << " to BD " << id
+                                << "\n");
+        transfer->moveBefore(insertionPoint);
+        transfer.setId(id);
+      }
+    }
+  }
+
+  void runOnOperation() override {
+    AIE::DeviceOp device = getOperation();
+    auto &index = getAnalysis<AIE::DeviceIndex>();
+    for (auto func : device.getOps<func::FuncOp>())
+      for (Block &block : func.getBody())
+        pipelineBlock(device, index, block);
+    // Only the runtime sequence ops are reordered.
+    markAnalysesPreserved<AIE::DeviceIndex>();
+  }
+};
+
+std::unique_ptr<OperationPass<AIE::DeviceOp>>
+AIEX::createAIEPipelineIpuSequencePass() {
+  return std::make_unique<AIEPipelineIpuSequencePass>();
+}
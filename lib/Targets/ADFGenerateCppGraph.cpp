@@ -19,6 +19,7 @@
 #include "mlir/Pass/Pass.h"
 
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
 
 #include <unordered_map>
 #include <vector>
@@ -184,7 +185,7 @@ struct GraphWriter {
     output << "#endif\n\n";
   }
 
-  void writeClass(GraphOp graph) {
+  LogicalResult writeClass(GraphOp graph) {
     output << "#include <adf.h>\n";
     output << "using namespace adf;\n";
     output << "class " << graph.getName() << " : public graph {\n";
@@ -247,14 +248,59 @@ struct GraphWriter {
           for (auto kernel : block.getOps<KernelOp>()) {
             output << indent << "source(" << kernelOp2VarName[kernel] << ") = "
                    << "\"kernels.cc\";\n";
-            output << indent << "runtime<ratio>(" << kernelOp2VarName[kernel]
-                   << ") = "
-                   << "0.1;\n";
+            if (failed(writeConstraints(kernel, indent)))
+              return failure();
           }
     }
 
     output << indent << "}\n";
     output << "};\n\n";
+    return success();
+  }
+
+  // Write the placement and performance constraints of the kernel given by its
+  // optional attributes.
+  LogicalResult writeConstraints(KernelOp kernel, const Indent &indent) {
+    const std::string &varName = kernelOp2VarName[kernel];
+
+    double ratio = kernel.getRuntimeRatio().value_or(0.1);
+    if (ratio <= 0.0 || ratio > 1.0)
+      return kernel.emitOpError("runtime_ratio must be in (0, 1], got ")
+             << ratio;
+    output << indent << "runtime<ratio>(" << varName << ") = "
+           << llvm::format("%g", ratio) << ";\n";
+
+    if (auto location = kernel.getLocation()) {
+      if (location->size() != 2)
+        return kernel.emitOpError("location must be [col, row]");
+      output << indent << "location<kernel>(" << varName << ") = tile("
+             << (*location)[0] << ", " << (*location)[1] << ");\n";
+    }
+
+    if (auto stackSize = kernel.getStackSize()) {
+      if (*stackSize == 0)
+        return kernel.emitOpError("stack_size must be positive");
+      output << indent << "stack_size(" << varName << ") = " << *stackSize
+             << ";\n";
+    }
+
+    if (auto bufferLocations = kernel.getBufferLocations()) {
+      if (bufferLocations->size() != kernel.getKernelInputs().size())
+        return kernel.emitOpError(
+            "buffer_locations must have one entry per kernel input");
+      for (auto [index, attr] : llvm::enumerate(*bufferLocations)) {
+        auto bank = llvm::dyn_cast<DenseI32ArrayAttr>(attr);
+        if (!bank || (bank.size() != 0 && bank.size() != 3))
+          return kernel.emitOpError("buffer_locations entry ")
+                 << index << " must be empty or [col, row, bank]";
+        if (bank.empty())
+          continue;
+        output << indent << "location<buffer>(" << varName << ".in[" << index
+               << "]) = bank(" << bank[0] << ", " << bank[1] << ", " << bank[2]
+               << ");\n";
+      }
+    }
+    return success();
   }
 };
 
@@ -266,6 +312,7 @@ LogicalResult AIE::ADFGenerateCPPGraph(ModuleOp module, raw_ostream &output) {
 
   for (Block &block : module.getBodyRegion())
     for (auto graphOp : block.getOps<GraphOp>())
-      writer.writeClass(graphOp);
+      if (failed(writer.writeClass(graphOp)))
+        return failure();
   return success();
 }
\ No newline at end of file
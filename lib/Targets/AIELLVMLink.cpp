@@ -27,6 +27,7 @@
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/Linker/Linker.h"
 #include "llvm/Object/Archive.h"
+#include "llvm/Passes/PassBuilder.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/WithColor.h"
@@ -119,11 +120,37 @@ mlir::LogicalResult linkFiles(std::vector<std::string> Files,
   return mlir::success();
 }
 
+// Run the default pipeline of OptLevel over the linked module, so that the code
+// of all the files, e.g. the kernels and the cores calling them, is inlined and
+// optimized together rather than file by file.
+static void optimizeModule(Module &M, unsigned OptLevel, bool Verbose) {
+  if (Verbose)
+    errs() << "Optimizing the linked module at -O" << OptLevel << "\n";
+
+  LoopAnalysisManager LAM;
+  FunctionAnalysisManager FAM;
+  CGSCCAnalysisManager CGAM;
+  ModuleAnalysisManager MAM;
+  PassBuilder PB;
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  OptimizationLevel Level = OptLevel == 1   ? OptimizationLevel::O1
+                            : OptLevel == 2 ? OptimizationLevel::O2
+                                            : OptimizationLevel::O3;
+  ModulePassManager MPM = PB.buildPerModuleDefaultPipeline(Level);
+  MPM.run(M, MAM);
+}
+
 mlir::LogicalResult
 xilinx::AIE::AIELLVMLink(llvm::raw_ostream &output,
                          std::vector<std::string> Files, bool DisableDITypeMap,
                          bool NoVerify, bool Internalize, bool OnlyNeeded,
-                         bool PreserveAssemblyUseListOrder, bool Verbose) {
+                         bool PreserveAssemblyUseListOrder, bool Verbose,
+                         unsigned OptLevel) {
   LLVMContext Context;
 
   if (!DisableDITypeMap)
@@ -141,6 +168,14 @@ xilinx::AIE::AIELLVMLink(llvm::raw_ostream &output,
                        Internalize, Verbose)))
     return mlir::failure();
 
+  if (OptLevel) {
+    optimizeModule(*Composite, OptLevel, Verbose);
+    if (!NoVerify && verifyModule(*Composite, &errs())) {
+      WithColor::error() << "optimized module is broken!\n";
+      return mlir::failure();
+    }
+  }
+
   Composite->print(output, nullptr, PreserveAssemblyUseListOrder);
   return mlir::success();
 }
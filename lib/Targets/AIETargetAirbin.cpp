@@ -12,19 +12,21 @@
 #include "aie/Dialect/AIE/IR/AIETargetModel.h"
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
 
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileOutputBuffer.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 
-#include <fcntl.h> // open
 #include <gelf.h>
 #include <iostream>
 #include <libelf.h>
 #include <set>
-#include <sys/stat.h>
-#include <unistd.h> // read
-#include <utility>  // pair
+#include <utility> // pair
 #include <vector>
 
 #define DEBUG_TYPE "aie-generate-airbin"
@@ -289,15 +291,27 @@ static const char *secNameStr[SEC_IDX_MAX] = {
     ".sdma.bd", ".shmmux",   ".sdma.ctl",  ".prgm.mem",
     ".tdma.bd", ".tdma.ctl", "deprecated", ".data.mem"};
 
-static size_t stridx;
-
 /*
-   Holds a sorted list of all writes made to device memory
+   Holds a sorted list of all writes made to device registers
    All recorded writes are time/order invariant. This allows sorting to
    compact the airbin.
 */
 static std::map<uint64_t, uint32_t> memWrites;
 
+/*
+   The contents of the program and data memories, by start address. A chunk
+   points into the mapped core ELF it is loaded from, or is zeros when its
+   data is null. The ELFs are kept mapped until the airbin is written, so
+   that their contents are only copied once, into the output.
+*/
+struct MemoryChunk {
+  uint32_t length;
+  const char *data;
+};
+
+static std::map<uint64_t, MemoryChunk> memChunks;
+static std::vector<std::unique_ptr<llvm::MemoryBuffer>> elfInputs;
+
 /*
  * Tile address format:
  * --------------------------------------------
@@ -360,17 +374,45 @@ private:
 
 using Write = std::pair<uint64_t, uint32_t>;
 
+/*
+   A contiguous range of the device written by the airbin. Its contents are
+   not copied: they are referenced from the register writes and the memory
+   chunks, and copied to the output when it is written.
+*/
 class Section {
 public:
   Section(uint64_t addr) : address(addr){};
   uint64_t getAddr() const { return address; }
-  size_t getLength() const { return data.size() * sizeof(uint32_t); }
-  void addData(uint32_t value) { data.push_back(value); }
-  const uint32_t *getData() const { return data.data(); }
+  uint64_t getEnd() const { return address + length; }
+  size_t getLength() const { return length; }
+  void addWrite(const Write &write) { addPiece(&write.second, 4); }
+  void addChunk(const MemoryChunk &chunk) {
+    addPiece(chunk.data, chunk.length);
+  }
+  void writeTo(char *buf) const {
+    for (const Piece &piece : pieces) {
+      if (piece.data)
+        memcpy(buf, piece.data, piece.length);
+      else
+        memset(buf, 0, piece.length);
+      buf += piece.length;
+    }
+  }
 
 private:
-  uint64_t address;           // start address of this section
-  std::vector<uint32_t> data; // data to be written starting at 'address'
+  struct Piece {
+    const void *data;
+    uint32_t length;
+  };
+
+  void addPiece(const void *data, uint32_t length) {
+    pieces.push_back({data, length});
+    this->length += length;
+  }
+
+  uint64_t address;          // start address of this section
+  uint64_t length = 0;       // length in bytes of the section
+  std::vector<Piece> pieces; // data to be written starting at 'address'
 };
 
 // This template can be instantiated to represent a bitfield in a register.
@@ -441,19 +483,64 @@ void TileAddress::clearRange(uint32_t start, uint32_t length) {
 }
 
 /*
-   Read the ELF produced by the AIE compiler and include its loadable
-   output in the airbin ELF
+   Fill a memory of the tile with the given segments, and with zeros between
+   them. Each segment is a destination offset in the tile and the bytes
+   loaded there.
 */
-static void loadElf(TileAddress tile, const std::string &filename) {
-  LLVM_DEBUG(llvm::dbgs() << "Reading ELF file " << filename << " for tile "
-                          << tile << '\n');
+static void
+loadMemory(TileAddress tile, uint32_t base, uint32_t size,
+           std::vector<std::pair<uint32_t, llvm::StringRef>> segments) {
+  llvm::sort(segments, llvm::less_first());
+  uint32_t offset = base;
+  auto addChunk = [&](uint32_t length, const char *data) {
+    if (length == 0)
+      return;
+    LLVM_DEBUG(llvm::dbgs() << "tile " << tile
+                            << llvm::format(" 0x%x - 0x%x (%s)\n", offset,
+                                            offset + length,
+                                            data ? "elf" : "zeros"));
+    memChunks[Address{tile, offset}] = {length, data};
+    offset += length;
+  };
+  for (auto [dest, bytes] : segments) {
+    if (dest >= base + size || dest + bytes.size() <= offset)
+      continue;
+    // Segments overlapping the previous one or the end of the memory are
+    // clipped.
+    if (dest < offset) {
+      bytes = bytes.drop_front(offset - dest);
+      dest = offset;
+    }
+    bytes = bytes.take_front(base + size - dest);
+    addChunk(dest - offset, nullptr);
+    addChunk(bytes.size(), bytes.data());
+  }
+  addChunk(base + size - offset, nullptr);
+}
 
-  int elfFd = open(filename.c_str(), O_RDONLY);
-  if (elfFd < 0)
+/*
+   Read the ELF produced by the AIE compiler and include its loadable
+   output in the airbin ELF. The ELF is mapped rather than read, and the
+   loadable segments are referenced from the memory chunks, not copied.
+*/
+static void loadElf(
+    const std::string &filename,
+    std::vector<std::pair<uint32_t, llvm::StringRef>> &progSegments,
+    std::vector<std::pair<uint32_t, llvm::StringRef>> &dataSegments) {
+  LLVM_DEBUG(llvm::dbgs() << "Reading ELF file " << filename << '\n');
+
+  auto file = llvm::MemoryBuffer::getFile(filename, /*IsText=*/false,
+                                          /*RequiresNullTerminator=*/false);
+  if (!file)
     llvm::report_fatal_error(llvm::Twine("Can't open elf file ") + filename);
+  llvm::StringRef raw = (*file)->getBuffer();
+  elfInputs.push_back(std::move(*file));
 
   elf_version(EV_CURRENT);
-  Elf *inElf = elf_begin(elfFd, ELF_C_READ, nullptr);
+  Elf *inElf = elf_memory(const_cast<char *>(raw.data()), raw.size());
+  if (!inElf)
+    llvm::report_fatal_error(llvm::Twine("cannot read ELF file ") + filename +
+                             ": " + elf_errmsg(-1));
 
   // check the characteristics
   GElf_Ehdr *ehdr;
@@ -485,35 +572,27 @@ static void loadElf(TileAddress tile, const std::string &filename) {
     // for each loadable program header
     if (phdr->p_type != PT_LOAD)
       continue;
+    if (phdr->p_offset + phdr->p_filesz > raw.size())
+      llvm::report_fatal_error(llvm::Twine("truncated segment in ELF file ") +
+                               filename);
+    llvm::StringRef bytes = raw.substr(phdr->p_offset, phdr->p_filesz);
 
     // decide destination address based on header attributes
     uint32_t dest;
-    if (phdr->p_flags & PF_X)
+    if (phdr->p_flags & PF_X) {
       dest = ME_PROG_MEM_BASE + phdr->p_vaddr;
-    else
+      progSegments.push_back({dest, bytes});
+    } else {
       dest = ME_DATA_MEM_BASE + (phdr->p_vaddr & (DATA_MEM_SIZE - 1));
+      dataSegments.push_back({dest, bytes});
+    }
 
     LLVM_DEBUG(llvm::dbgs()
                << llvm::format("ELF flags=0x%x vaddr=0x%lx dest=0x%x\r\n",
                                phdr->p_flags, phdr->p_vaddr, dest));
-    // read data one word at a time and write it to the output list
-    // TODO since we know these are data and not registers, we could likely
-    // bypass the output list and write a section directly into the AIRBIN
-    size_t elfSize;
-    uint32_t offset;
-    char *raw = elf_rawfile(inElf, &elfSize);
-
-    for (offset = phdr->p_offset; offset < phdr->p_offset + phdr->p_filesz;
-         offset += 4) {
-      Address destAddr{tile, dest};
-      uint32_t data = *reinterpret_cast<uint32_t *>(raw + offset);
-      write32(destAddr, data);
-      dest += 4;
-    }
   }
 
   elf_end(inElf);
-  close(elfFd);
 }
 
 /*
@@ -541,9 +620,6 @@ static void configMETile(TileOp tileOp, const std::string &coreFilesDir) {
   TileAddress tileAddress{tileOp};
   // Reset configuration
 
-  // clear program and data memory
-  tileAddress.clearRange(ME_PROG_MEM_BASE, PROG_MEM_SIZE);
-  tileAddress.clearRange(ME_DATA_MEM_BASE, DATA_MEM_SIZE);
 
   // TileDMA
   tileAddress.clearRange(ME_DMA_BD_BASE, sizeof(DMABDRegBlock));
@@ -558,7 +634,10 @@ static void configMETile(TileOp tileOp, const std::string &coreFilesDir) {
   // NOTE: Here is usually where locking is done.
   // However, the runtime will handle that when loading the airbin.
 
-  // read the AIE executable and copy the loadable parts
+  // read the AIE executable and load the loadable parts into the program
+  // and data memory, clearing the rest
+  std::vector<std::pair<uint32_t, llvm::StringRef>> progSegments;
+  std::vector<std::pair<uint32_t, llvm::StringRef>> dataSegments;
   if (auto coreOp = tileOp.getCoreOp()) {
     std::string fileName;
     if (auto fileAttr = coreOp->getAttrOfType<StringAttr>("elf_file"))
@@ -566,8 +645,12 @@ static void configMETile(TileOp tileOp, const std::string &coreFilesDir) {
     else
       fileName = llvm::formatv("{0}/core_{1}_{2}.elf", coreFilesDir,
                                tileOp.colIndex(), tileOp.rowIndex());
-    loadElf(tileAddress, fileName);
+    loadElf(fileName, progSegments, dataSegments);
   }
+  loadMemory(tileAddress, ME_PROG_MEM_BASE, PROG_MEM_SIZE,
+             std::move(progSegments));
+  loadMemory(tileAddress, ME_DATA_MEM_BASE, DATA_MEM_SIZE,
+             std::move(dataSegments));
 }
 
 struct BDInfo {
@@ -1119,80 +1202,37 @@ static uint8_t secAddr2Index(uint64_t in) {
 }
 
 /*
-        Group the writes into contiguous sections
+        Group the register writes and the memory chunks into contiguous
+        sections
 */
-static void groupSections(std::vector<Section *> &sections) {
-  uint64_t lastAddr = 0;
-  Section *section = nullptr;
-
-  for (auto write : memWrites) {
-    if (write.first != lastAddr + 4) {
-      if (section)
-        sections.push_back(section);
-      section = new Section(write.first);
+static void groupSections(std::vector<Section> &sections) {
+  auto write = memWrites.begin();
+  auto chunk = memChunks.begin();
+  while (write != memWrites.end() || chunk != memChunks.end()) {
+    bool isChunk = write == memWrites.end() ||
+                   (chunk != memChunks.end() && chunk->first < write->first);
+    uint64_t addr = isChunk ? chunk->first : write->first;
+    if (!sections.empty() && addr < sections.back().getEnd())
+      llvm::report_fatal_error(
+          llvm::Twine("overlapping writes to the device at ") +
+          llvm::utohexstr(addr));
+    if (sections.empty() || addr != sections.back().getEnd()) {
       LLVM_DEBUG(llvm::dbgs() << "Starting new section @ "
-                              << llvm::format("0x%lx (last=0x%lx)\n",
-                                              write.first, lastAddr));
+                              << llvm::format("0x%lx\n", addr));
+      sections.emplace_back(addr);
     }
-    assert(section && "section is null");
-    section->addData(write.second);
-    lastAddr = write.first;
+    if (isChunk)
+      sections.back().addChunk((chunk++)->second);
+    else
+      sections.back().addWrite(*write++);
   }
-
-  sections.push_back(section);
-}
-
-/*
-   Add a string to the section header string table and return the offset of
-   the start of the string
-*/
-static size_t addString(Elf_Scn *scn, const char *str) {
-  size_t lastidx = stridx;
-  size_t size = strlen(str) + 1;
-
-  Elf_Data *data = elf_newdata(scn);
-  data->d_buf = (void *)str;
-  data->d_type = ELF_T_BYTE;
-  data->d_size = size;
-  data->d_align = 1;
-  data->d_version = EV_CURRENT;
-
-  stridx += size;
-  return lastidx;
-}
-
-Elf_Data *sectionAddData(Elf_Scn *scn, const Section *section) {
-  size_t size = section->getLength();
-  auto *buf = static_cast<uint32_t *>(malloc(size));
-
-  // create a data object for the section
-  Elf_Data *data = elf_newdata(scn);
-  data->d_buf = buf;
-  data->d_type = ELF_T_BYTE;
-  data->d_size = size;
-  data->d_off = 0;
-  data->d_align = 1;
-  data->d_version = EV_CURRENT;
-
-  // fill the data
-  memcpy(buf, section->getData(), size);
-
-  return data;
 }
 
 mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
                                          const std::string &outputFilename,
                                          const std::string &coreFilesDir,
                                          bool testAirBin) {
-  int tmpElfFD;
-  Elf *outElf;
-  GElf_Ehdr ehdrMem;
-  GElf_Ehdr *ehdr;
-  GElf_Shdr *shdr;
-  GElf_Shdr shdrMem;
-  char emptyStr[] = "";
-  char strTabName[] = ".shstrtab";
-  std::vector<Section *> sections;
+  std::vector<Section> sections;
 
   if (module.getOps<DeviceOp>().empty()) {
     LLVM_DEBUG(llvm::dbgs() << "no device ops found");
@@ -1218,111 +1258,111 @@ mlir::LogicalResult AIETranslateToAirbin(mlir::ModuleOp module,
   LLVM_DEBUG(llvm::dbgs() << llvm::format("mem_writes: %lu in %lu sections\n",
                                           memWrites.size(), sections.size()));
 
-  elf_version(EV_CURRENT);
-  tmpElfFD =
-      open(outputFilename.c_str(), O_RDWR | O_CREAT | O_TRUNC, DEFFILEMODE);
-  outElf = elf_begin(tmpElfFD, ELF_C_WRITE, nullptr);
-
-  if (!gelf_newehdr(outElf, ELFCLASS64))
-    llvm::report_fatal_error(llvm::Twine("Error creating ELF64 header: ") +
-                             elf_errmsg(-1));
-
-  ehdr = gelf_getehdr(outElf, &ehdrMem);
-  if (!ehdr)
-    llvm::report_fatal_error(llvm::Twine("cannot get ELF header: ") +
-                             elf_errmsg(-1));
-
-  // Initialize header.
-  ehdr->e_ident[EI_DATA] = ELFDATA2LSB;
-  ehdr->e_ident[EI_OSABI] = ELFOSABI_GNU;
-  ehdr->e_type = ET_NONE;
-  ehdr->e_machine = EM_AMDAIR;
-  ehdr->e_version = EV_CURRENT;
-  if (gelf_update_ehdr(outElf, ehdr) == 0)
-    llvm::report_fatal_error(llvm::Twine("cannot update ELF header: ") +
-                             elf_errmsg(-1));
-
-  // Create new section for the 'section header string table'
-  Elf_Scn *shStrTabScn = elf_newscn(outElf);
-  if (!shStrTabScn)
-    llvm::report_fatal_error(
-        llvm::Twine("cannot create new shstrtab section: ") + elf_errmsg(-1));
-
-  // the first entry in the string table must be a NULL string
-  addString(shStrTabScn, emptyStr);
-
-  shdr = gelf_getshdr(shStrTabScn, &shdrMem);
-  if (!shdr)
-    llvm::report_fatal_error(
-        llvm::Twine("cannot get header for sh_strings section: ") +
-        elf_errmsg(-1));
-
-  shdr->sh_type = SHT_STRTAB;
-  shdr->sh_flags = 0;
-  shdr->sh_addr = 0;
-  shdr->sh_link = SHN_UNDEF;
-  shdr->sh_info = SHN_UNDEF;
-  shdr->sh_addralign = 1;
-  shdr->sh_entsize = 0;
-  shdr->sh_name = addString(shStrTabScn, strTabName);
-
+  // Lay out the airbin: the ELF header, the section header string table and
+  // the sections, followed by the section headers.
+  std::string shStrTab(1, '\0'); // the first entry must be a NULL string
+  auto addString = [&](const char *str) {
+    size_t offset = shStrTab.size();
+    shStrTab += str;
+    shStrTab += '\0';
+    return offset;
+  };
+  size_t strTabNameOffset = addString(".shstrtab");
   // add all the AIRBIN-specific section names up front and index them
   for (uint8_t secIdx = SEC_IDX_SSMAST; secIdx < SEC_IDX_MAX; secIdx++)
-    secNameOffset[secIdx] = addString(shStrTabScn, secNameStr[secIdx]);
+    secNameOffset[secIdx] = addString(secNameStr[secIdx]);
   secNameOffset[SEC_IDX_NULL] = 0;
 
+  // The program memory images that are the same in several tiles, like those
+  // of the cores running the same ELF, are only stored once, and the section
+  // of each tile points to the same offset of the file.
+  uint64_t offset = sizeof(Elf64_Ehdr);
+  uint64_t shStrTabOffset = offset;
+  offset += shStrTab.size();
+  std::vector<uint64_t> sectionOffsets;
+  std::vector<bool> isSectionShared;
+  llvm::StringMap<uint64_t> progMemOffsets;
+  for (const Section &section : sections) {
+    if (secAddr2Index(section.getAddr()) == SEC_IDX_PRGM_MEM) {
+      std::string contents(section.getLength(), '\0');
+      section.writeTo(contents.data());
+      auto [it, inserted] = progMemOffsets.try_emplace(contents, offset);
+      if (!inserted) {
+        LLVM_DEBUG(llvm::dbgs()
+                   << llvm::format("Sharing the program memory of 0x%lx\n",
+                                   section.getAddr()));
+        sectionOffsets.push_back(it->second);
+        isSectionShared.push_back(true);
+        continue;
+      }
+    }
+    sectionOffsets.push_back(offset);
+    isSectionShared.push_back(false);
+    offset += section.getLength();
+  }
+  uint64_t shOffset = llvm::alignTo(offset, alignof(Elf64_Shdr));
+  size_t numSections = sections.size() + 2;
+  uint64_t fileSize = shOffset + numSections * sizeof(Elf64_Shdr);
+
+  // The output is mapped, and each section is copied from where its
+  // contents come from straight into it.
+  auto output = llvm::FileOutputBuffer::create(outputFilename, fileSize);
+  if (!output)
+    llvm::report_fatal_error(llvm::Twine("cannot create ") + outputFilename +
+                             ": " + llvm::toString(output.takeError()));
+  char *buf = reinterpret_cast<char *>((*output)->getBufferStart());
+
+  // Initialize header.
+  Elf64_Ehdr ehdr = {};
+  memcpy(ehdr.e_ident, ELFMAG, SELFMAG);
+  ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+  ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+  ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+  ehdr.e_ident[EI_OSABI] = ELFOSABI_GNU;
+  ehdr.e_type = ET_NONE;
+  ehdr.e_machine = EM_AMDAIR;
+  ehdr.e_version = EV_CURRENT;
+  ehdr.e_shoff = shOffset;
+  ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+  ehdr.e_shentsize = sizeof(Elf64_Shdr);
+  ehdr.e_shnum = numSections;
   // We have to store the section strtab index in the ELF header so sections
   // have actual names.
-  int ndx = elf_ndxscn(shStrTabScn);
-  ehdr->e_shstrndx = ndx;
-
-  if (!gelf_update_ehdr(outElf, ehdr))
-    llvm::report_fatal_error(llvm::Twine("cannot update ELF header: ") +
-                             elf_errmsg(-1));
-
-  // Finished new shstrtab section, update the header.
-  if (!gelf_update_shdr(shStrTabScn, shdr))
-    llvm::report_fatal_error(
-        llvm::Twine("cannot update new shstrtab section header: ") +
-        elf_errmsg(-1));
+  ehdr.e_shstrndx = 1;
+  memcpy(buf, &ehdr, sizeof(ehdr));
+
+  memcpy(buf + shStrTabOffset, shStrTab.data(), shStrTab.size());
+  auto *shdrs = reinterpret_cast<Elf64_Shdr *>(buf + shOffset);
+  shdrs[0] = {};
+  shdrs[1] = {};
+  shdrs[1].sh_name = strTabNameOffset;
+  shdrs[1].sh_type = SHT_STRTAB;
+  shdrs[1].sh_offset = shStrTabOffset;
+  shdrs[1].sh_size = shStrTab.size();
+  shdrs[1].sh_addralign = 1;
 
   // output the rest of the sections
-  for (const Section *section : sections) {
-    uint64_t addr = section->getAddr();
-    Elf_Scn *scn = elf_newscn(outElf);
-    if (!scn)
-      llvm::report_fatal_error(llvm::Twine("cannot create new ") +
-                               secNameStr[secAddr2Index(addr)] +
-                               "section: " + elf_errmsg(-1));
-
-    shdr = gelf_getshdr(scn, &shdrMem);
-    if (!shdr)
-      llvm::report_fatal_error(llvm::Twine("cannot get header for ") +
-                               secNameStr[secAddr2Index(addr)] +
-                               "section: " + elf_errmsg(-1));
-
-    Elf_Data *data = sectionAddData(scn, section);
-
-    shdr->sh_type = SHT_PROGBITS;
-    shdr->sh_flags = SHF_ALLOC;
-    shdr->sh_addr = section->getAddr();
-    shdr->sh_link = SHN_UNDEF;
-    shdr->sh_info = SHN_UNDEF;
-    shdr->sh_addralign = 1;
-    shdr->sh_entsize = 0;
-    shdr->sh_size = data->d_size;
-    shdr->sh_name = secNameOffset[secAddr2Index(addr)];
-
-    if (!gelf_update_shdr(scn, shdr))
-      llvm::report_fatal_error(llvm::Twine("cannot update section header: ") +
-                               elf_errmsg(-1));
+  for (auto [i, section] : llvm::enumerate(sections)) {
+    if (!isSectionShared[i])
+      section.writeTo(buf + sectionOffsets[i]);
+    Elf64_Shdr &shdr = shdrs[i + 2];
+    shdr = {};
+    shdr.sh_name = secNameOffset[secAddr2Index(section.getAddr())];
+    shdr.sh_type = SHT_PROGBITS;
+    shdr.sh_flags = SHF_ALLOC;
+    shdr.sh_addr = section.getAddr();
+    shdr.sh_offset = sectionOffsets[i];
+    shdr.sh_size = section.getLength();
+    shdr.sh_link = SHN_UNDEF;
+    shdr.sh_info = SHN_UNDEF;
+    shdr.sh_addralign = 1;
   }
 
-  if (elf_update(outElf, ELF_C_WRITE) < 0)
-    llvm::report_fatal_error(llvm::Twine("failure in elf_update: ") +
-                             elf_errmsg(-1));
-  elf_end(outElf);
-  close(tmpElfFD);
+  if (auto err = (*output)->commit())
+    llvm::report_fatal_error(llvm::Twine("cannot write ") + outputFilename +
+                             ": " + llvm::toString(std::move(err)));
+  memChunks.clear();
+  elfInputs.clear();
 
   return success();
 }
@@ -9,6 +9,8 @@
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
 #include "aie/Targets/AIETargets.h"
 
+#include "AIETargetShared.h"
+
 #include "mlir/IR/IRMapping.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
@@ -54,6 +56,11 @@ LogicalResult AIETranslateToBCF(ModuleOp module, raw_ostream &output,
       const auto &targetModel = getTargetModel(tile);
       TileID srcCoord = {tile.colIndex(), tile.rowIndex()};
 
+      // The chess linker has no overlays of program memory.
+      if (auto core = tile.getCoreOp(); core && core.getOverlays())
+        return core.emitOpError("overlays are only linked with the GNU "
+                                "linker script, not with a BCF");
+
       std::string corefunc = std::string("core_") +
                              std::to_string(tile.getCol()) + "_" +
                              std::to_string(tile.getRow());
@@ -69,6 +76,11 @@ LogicalResult AIETranslateToBCF(ModuleOp module, raw_ostream &output,
       int stacksize = 0;
       if (auto core = tile.getCoreOp())
         stacksize = core.getStackSize();
+      // Only the buffers of the neighbors this core uses need a symbol; the
+      // others are covered by the reservation of the whole neighbor memory.
+      SmallPtrSet<Operation *, 16> coreBuffers;
+      bool allBuffers = !collectCoreBuffers(tile.getCoreOp(), coreBuffers);
+
       output << "_stack DM_stack "
              << utohexstr(targetModel.getMemInternalBaseAddress(srcCoord))
              << " " << utohexstr(stacksize) << " // stack for core\n";
@@ -88,6 +100,9 @@ LogicalResult AIETranslateToBCF(ModuleOp module, raw_ostream &output,
           // remaining buffer)
           if (tiles.count(*tile)) {
             for (auto buf : buffers[tiles[*tile]]) {
+              if (tile != srcCoord && !allBuffers &&
+                  !coreBuffers.contains(buf))
+                continue;
               std::string bufName(buf.name().getValue());
               int bufferBaseAddr = getBufferBaseAddress(buf);
               int numBytes = buf.getAllocationSize();
@@ -5,6 +5,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "AIETargetShared.h"
+
 #include "aie/Dialect/AIE/IR/AIETargetModel.h"
 #include "aie/Targets/AIETargets.h"
 extern "C" {
@@ -14,19 +16,30 @@ extern "C" {
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIE/IR/AIEEnums.h"
 
+#include "mlir/IR/AsmState.h"
 #include "mlir/IR/Block.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/BuiltinTypeInterfaces.h"
 #include "mlir/IR/Operation.h"
 #include "mlir/IR/Region.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/LogicalResult.h"
 
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/Twine.h"
+#include "llvm/ADT/bit.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SHA256.h"
 
 #include <algorithm>
 #include <cassert>
@@ -35,6 +48,7 @@ extern "C" {
 #include <cstdlib> // calloc
 #include <filesystem>
 #include <functional>
+#include <limits>
 #include <map>
 #include <optional>
 #include <string>
@@ -47,10 +61,12 @@ extern "C" {
 #include "xaiengine/xaie_core.h"
 #include "xaiengine/xaie_dma.h"
 #include "xaiengine/xaie_elfloader.h"
+#include "xaiengine/xaie_events.h"
 #include "xaiengine/xaie_interrupt.h"
 #include "xaiengine/xaie_locks.h"
 #include "xaiengine/xaie_plif.h"
 #include "xaiengine/xaie_ss.h"
+#include "xaiengine/xaie_timer.h"
 #include "xaiengine/xaiegbl.h"
 #include "xaiengine/xaiegbl_defs.h"
 }
@@ -96,7 +112,7 @@ static const std::map<WireBundle, StrmSwPortType>
     WIRE_BUNDLE_TO_STRM_SW_PORT_TYPE = {
         {WireBundle::Core, StrmSwPortType::CORE},
         {WireBundle::DMA, StrmSwPortType::DMA},
-        // missing control from StrmSwPortType
+        {WireBundle::Ctrl, StrmSwPortType::CTRL},
         {WireBundle::FIFO, StrmSwPortType::FIFO},
         {WireBundle::South, StrmSwPortType::SOUTH},
         {WireBundle::West, StrmSwPortType::WEST},
@@ -191,6 +207,8 @@ auto ps = std::filesystem::path::preferred_separator;
 #define ODD_BD_NUM_START 24
 #define MEM_TILE_LOCK_ID_INCR 64
 #define BASE_ADDR_A_INCR 0x80000
+#define KERNEL_CYCLES_COUNTER 0
+#define KERNEL_CALLS_COUNTER 1
 
 namespace xilinx::AIE {
 
@@ -271,9 +289,15 @@ LogicalResult configureBdInBlock(XAie_DevInst &devInst, XAie_DmaDesc &dmaTileBd,
   auto bufferOp = cast<AIE::BufferOp>(bdOp.getBuffer().getDefiningOp());
   assert(bufferOp.getAddress().has_value() && "buffer must have address");
 
+  // A memtile DMA addresses the memory of its west neighbour, its own memory
+  // and the memory of its east neighbour one after the other, so that the
+  // buffers spanning into the east neighbour are contiguous.
   int baseAddrA = bufferOp.getAddress().value();
-  if (targetModel.isMemTile(tileLoc.Col, tileLoc.Row))
-    baseAddrA += BASE_ADDR_A_INCR;
+  if (targetModel.isMemTile(tileLoc.Col, tileLoc.Row)) {
+    int dmaCol = bdOp->getParentOfType<MemTileDMAOp>().getTileID().col;
+    baseAddrA +=
+        BASE_ADDR_A_INCR * (1 + bufferOp.getTileOp().getCol() - dmaCol);
+  }
 
   std::optional<llvm::ArrayRef<BDDimLayoutAttr>> dims = bdOp.getDimensions();
   if (!dims) {
@@ -305,6 +329,35 @@ LogicalResult configureBdInBlock(XAie_DevInst &devInst, XAie_DmaDesc &dmaTileBd,
                             bdOp.getLenValue() * bytesA);
   }
 
+  if (std::optional<llvm::ArrayRef<BDPadLayoutAttr>> pads =
+          bdOp.getPadDimensions()) {
+    // The verifier guarantees a memtile MM2S BD with one padding per
+    // dimension, passed down in the same reverse order as the dimensions.
+    SmallVector<XAie_PaddingDesc> padDescs(pads->size());
+    for (size_t i = 0; i < pads->size(); i++)
+      padDescs[pads->size() - i - 1] = {
+          static_cast<u8>(pads.value()[i].getConstPadBefore()),
+          static_cast<u8>(pads.value()[i].getConstPadAfter())};
+    XAie_DmaPadTensor dmaTileBdPadTensor = {};
+    dmaTileBdPadTensor.NumDim = padDescs.size();
+    dmaTileBdPadTensor.PadDesc = padDescs.data();
+    TRY_XAIE_API_EMIT_ERROR(bdOp, XAie_DmaSetPadding, &dmaTileBd,
+                            &dmaTileBdPadTensor);
+  }
+
+  if (bdOp.getCompression())
+    TRY_XAIE_API_EMIT_ERROR(bdOp, XAie_DmaEnableCompression, &dmaTileBd);
+
+  // The burst length is given to aie-rt in 16-byte beats; the SMID and the
+  // secure access of the BD keep their defaults.
+  if (bdOp.getBurstLength() || bdOp.getAxCache() || bdOp.getAxQos())
+    TRY_XAIE_API_EMIT_ERROR(bdOp, XAie_DmaSetAxi, &dmaTileBd,
+                            dmaTileBd.AxiDesc.SMID,
+                            bdOp.getBurstLength().value_or(256) / 16,
+                            bdOp.getAxQos().value_or(0),
+                            bdOp.getAxCache().value_or(0),
+                            dmaTileBd.AxiDesc.SecureAccess);
+
   if (nextBdNum) {
     auto enableNextBd = 1;
     TRY_XAIE_API_EMIT_ERROR(bdOp, XAie_DmaSetNextBd, &dmaTileBd,
@@ -327,12 +380,47 @@ LogicalResult configureBdInBlock(XAie_DevInst &devInst, XAie_DmaDesc &dmaTileBd,
   return success();
 };
 
+// Returns the path of the ELF file loaded on a core.
+static std::string getCoreElfPath(CoreOp coreOp, const StringRef workDirPath) {
+  TileID tile = coreOp.getTileID();
+  std::string fileName;
+  if (auto fileAttr = coreOp.getElfFile())
+    fileName = fileAttr->str();
+  else
+    fileName = std::string("core_") + std::to_string(tile.col) + "_" +
+               std::to_string(tile.row) + ".elf";
+  return workDirPath.str() + ps + fileName;
+}
+
+// A register write emitted when optimizing the writes of a CDO: a write, a
+// block write of consecutive registers or a masked write.
+struct RegisterWrite {
+  uint64_t regOff;
+  SmallVector<uint32_t> values;
+  std::optional<uint32_t> mask;
+};
+
 struct AIEControl {
   XAie_Config configPtr;
   XAie_DevInst devInst;
+  const AIETargetModel &targetModel;
+  // Record the register writes of each CDO and rewrite them before they are
+  // emitted, see emitRecordedWrites.
+  bool optimizeWrites;
+  // The column of the design configured as column 0.
+  int colOffset = 0;
+  // When generating a delta CDO, the program memory words loaded by the
+  // design running before it, see collectBaseProgramMemory.
+  bool delta = false;
+  llvm::DenseMap<uint64_t, uint32_t> baseProgramMemory;
+  // The ELFs of the cores read by loadElfImages: the hash of the contents of
+  // each path, and the contents of each hash, shared by identical images.
+  llvm::StringMap<std::string> elfHashes;
+  std::map<std::string, std::unique_ptr<llvm::MemoryBuffer>> elfImages;
 
   AIEControl(size_t partitionStartCol, size_t partitionNumCols, bool aieSim,
-             const AIETargetModel &tm) {
+             const AIETargetModel &tm, bool optimizeWrites = false)
+      : targetModel(tm), optimizeWrites(optimizeWrites) {
     configPtr = XAie_Config{
         .AieGen = XAIE_DEV_GEN_AIEML,
         .BaseAddr = XAIE_BASE_ADDR,
@@ -370,46 +458,333 @@ struct AIEControl {
     TRY_XAIE_API_FATAL_ERROR(XAie_UpdateNpiAddr, &devInst, NPI_ADDR);
   }
 
+  /// The location of the tile at the given column of the design, relative
+  /// to the column offset of the device, see getColumnOffset.
+  XAie_LocType getTileLoc(int col, int row) {
+    return XAie_TileLoc(col - colOffset, row);
+  }
+
+  /// Splits a register address into the tile and the offset in the tile.
+  std::tuple<int, int, uint64_t> decodeAddress(uint64_t regOff) {
+    int col = (regOff >> configPtr.ColShift) + colOffset;
+    int row = (regOff >> configPtr.RowShift) &
+              ((1 << (configPtr.ColShift - configPtr.RowShift)) - 1);
+    return {col, row, regOff & ((1ULL << configPtr.RowShift) - 1)};
+  }
+
+  /// Returns true if the register at the given offset only holds state, i.e.
+  /// is a lock value or a buffer descriptor word. These registers are zero
+  /// after a partition reset, and writing them has no side effect.
+  bool isStateRegister(uint64_t regOff) {
+    auto [col, row, offset] = decodeAddress(regOff);
+    auto inRange = [&, offset = offset](uint64_t begin, uint64_t end) {
+      return offset >= begin && offset < end;
+    };
+    if (targetModel.isMemTile(col, row))
+      return inRange(0xA0000, 0xA0600) || inRange(0xC0000, 0xC0400);
+    if (targetModel.isShimNOCorPLTile(col, row))
+      return inRange(0x1D000, 0x1D200) || inRange(0x14000, 0x14100);
+    return inRange(0x1D000, 0x1D200) || inRange(0x1F000, 0x1F100);
+  }
+
+  /// Returns true if the address is a word of the program memory of a core.
+  bool isProgramMemory(uint64_t regOff) {
+    auto [col, row, offset] = decodeAddress(regOff);
+    return targetModel.isCoreTile(col, row) && offset >= 0x20000 &&
+           offset < 0x24000;
+  }
+
+  bool recordsWrites() { return optimizeWrites || delta; }
+
+  void startRecordingWrites() {
+    TRY_XAIE_API_FATAL_ERROR(XAie_StartTransaction, &devInst,
+                             XAIE_TRANSACTION_DISABLE_AUTO_FLUSH);
+  }
+
+  /// Ends the transaction started by startRecordingWrites, so that the
+  /// writes reach the CDO again, and returns a copy of the commands it
+  /// recorded, to free with XAie_FreeTransactionInstance.
+  XAie_TxnInst *stopRecordingWrites() {
+    XAie_TxnInst *txn = XAie_ExportTransactionInstance(&devInst);
+    TRY_XAIE_API_FATAL_ERROR(XAie_ClearTransaction, &devInst);
+    if (!txn)
+      llvm::report_fatal_error("couldn't export the libxaie transaction");
+    return txn;
+  }
+
+  /// Ends the transaction started by startRecordingWrites and emits the
+  /// register writes it recorded, after rewriting them. When generating a
+  /// delta CDO, writes to the program memory which leave the word loaded by
+  /// the base design unchanged are dropped. When optimizing the writes:
+  /// - runs of writes to state registers are sorted by address, keeping only
+  ///   the last write to each register, and writes of zero to registers not
+  ///   written before in the CDO are dropped, assuming the partition is reset
+  ///   before the CDO is loaded;
+  /// - writes to consecutive registers are merged into block writes.
+  /// Writes to other registers keep their order, since they may have side
+  /// effects, e.g. on the DMA queues or the core control. Transactions with
+  /// other commands, such as polls, are emitted unchanged.
+  LogicalResult emitRecordedWrites() {
+    XAie_TxnInst *txn = stopRecordingWrites();
+    auto freeTxn =
+        llvm::make_scope_exit([&] { XAie_FreeTransactionInstance(txn); });
+    ArrayRef<XAie_TxnCmd> cmds(txn->CmdBuf, txn->NumCmds);
+    if (!llvm::all_of(cmds, [](const XAie_TxnCmd &cmd) {
+          return cmd.Opcode == XAIE_IO_WRITE ||
+                 cmd.Opcode == XAIE_IO_BLOCKWRITE ||
+                 cmd.Opcode == XAIE_IO_BLOCKSET ||
+                 cmd.Opcode == XAIE_IO_MASKWRITE;
+        })) {
+      TRY_XAIE_API_LOGICAL_RESULT(XAie_SubmitTransaction, &devInst, txn);
+      return success();
+    }
+
+    SmallVector<RegisterWrite> writes;
+    auto append = [&](uint64_t regOff, uint32_t value) {
+      if (!writes.empty() && !writes.back().mask &&
+          writes.back().regOff + 4 * writes.back().values.size() == regOff)
+        writes.back().values.push_back(value);
+      else
+        writes.push_back({regOff, {value}, std::nullopt});
+    };
+    llvm::DenseSet<uint64_t> written;
+    SmallVector<std::pair<uint64_t, uint32_t>> run;
+    auto flushRun = [&] {
+      llvm::stable_sort(run, llvm::less_first());
+      for (size_t i = 0; i < run.size(); i++) {
+        auto [regOff, value] = run[i];
+        if (i + 1 < run.size() && run[i + 1].first == regOff)
+          continue;
+        if (written.insert(regOff).second && value == 0)
+          continue;
+        append(regOff, value);
+      }
+      run.clear();
+    };
+    auto write = [&](uint64_t regOff, ArrayRef<uint32_t> values) {
+      bool state =
+          optimizeWrites && llvm::all_of(llvm::seq<size_t>(0, values.size()),
+                                         [&](size_t i) {
+                                           return isStateRegister(regOff +
+                                                                  4 * i);
+                                         });
+      if (!state)
+        flushRun();
+      for (auto [i, value] : llvm::enumerate(values)) {
+        uint64_t wordOff = regOff + 4 * i;
+        if (state) {
+          run.push_back({wordOff, value});
+          continue;
+        }
+        if (delta && isProgramMemory(wordOff)) {
+          auto base = baseProgramMemory.find(wordOff);
+          if (base != baseProgramMemory.end() && base->second == value)
+            continue;
+        }
+        written.insert(wordOff);
+        append(wordOff, value);
+      }
+    };
+
+    for (const XAie_TxnCmd &cmd : cmds) {
+      switch (cmd.Opcode) {
+      case XAIE_IO_WRITE:
+        write(cmd.RegOff, {cmd.Value});
+        break;
+      case XAIE_IO_BLOCKWRITE:
+        write(cmd.RegOff,
+              ArrayRef(reinterpret_cast<const uint32_t *>(cmd.DataPtr),
+                       cmd.Size));
+        break;
+      case XAIE_IO_BLOCKSET:
+        write(cmd.RegOff, SmallVector<uint32_t>(cmd.Size, cmd.Value));
+        break;
+      default:
+        flushRun();
+        written.insert(cmd.RegOff);
+        writes.push_back({cmd.RegOff, {cmd.Value}, cmd.Mask});
+        break;
+      }
+    }
+    flushRun();
+    LLVM_DEBUG(llvm::dbgs() << "Emitting " << writes.size()
+                            << " register writes for " << cmds.size()
+                            << " recorded commands\n");
+
+    for (RegisterWrite &w : writes) {
+      if (w.mask)
+        TRY_XAIE_API_LOGICAL_RESULT(XAie_MaskWrite32, &devInst, w.regOff,
+                                    *w.mask, w.values.front());
+      else if (w.values.size() == 1)
+        TRY_XAIE_API_LOGICAL_RESULT(XAie_Write32, &devInst, w.regOff,
+                                    w.values.front());
+      else
+        TRY_XAIE_API_LOGICAL_RESULT(XAie_BlockWrite32, &devInst, w.regOff,
+                                    w.values.data(), w.values.size());
+    }
+    return success();
+  }
+
+  /// Records the program memory loaded by the ELFs of the base design of a
+  /// delta CDO, which are read from its own work directory.
+  LogicalResult collectBaseProgramMemory(DeviceOp &baseOp,
+                                         const StringRef baseWorkDirPath,
+                                         bool aieSim) {
+    // The writes of the base design are only recorded, never emitted.
+    startRecordingWrites();
+    LogicalResult loaded = addAieElfsToCDO(baseOp, baseWorkDirPath, aieSim);
+    XAie_TxnInst *txn = stopRecordingWrites();
+    auto freeTxn =
+        llvm::make_scope_exit([&] { XAie_FreeTransactionInstance(txn); });
+    if (failed(loaded))
+      return failure();
+    auto record = [&](uint64_t regOff, uint32_t value) {
+      if (isProgramMemory(regOff))
+        baseProgramMemory[regOff] = value;
+    };
+    for (const XAie_TxnCmd &cmd : ArrayRef(txn->CmdBuf, txn->NumCmds)) {
+      if (cmd.Opcode == XAIE_IO_WRITE)
+        record(cmd.RegOff, cmd.Value);
+      else if (cmd.Opcode == XAIE_IO_BLOCKWRITE)
+        for (uint32_t i = 0; i < cmd.Size; i++)
+          record(cmd.RegOff + 4 * i,
+                 reinterpret_cast<const uint32_t *>(cmd.DataPtr)[i]);
+      else if (cmd.Opcode == XAIE_IO_BLOCKSET)
+        for (uint32_t i = 0; i < cmd.Size; i++)
+          record(cmd.RegOff + 4 * i, cmd.Value);
+    }
+    delta = true;
+    LLVM_DEBUG(llvm::dbgs() << "Recorded " << baseProgramMemory.size()
+                            << " program memory words of the base design\n");
+    return success();
+  }
+
+  /// Records the configuration of a device, without its ELFs and the enabling
+  /// of its cores, as the value each register is left with, in the order the
+  /// registers are first written. The masked writes apply to the reset value,
+  /// zero, of the registers not written before.
+  LogicalResult
+  recordConfiguration(DeviceOp &targetOp, SmallVectorImpl<uint64_t> &order,
+                      llvm::DenseMap<uint64_t, uint32_t> &values) {
+    startRecordingWrites();
+    LogicalResult configured = addInitConfigToCDO(targetOp);
+    XAie_TxnInst *txn = stopRecordingWrites();
+    auto freeTxn =
+        llvm::make_scope_exit([&] { XAie_FreeTransactionInstance(txn); });
+    if (failed(configured))
+      return failure();
+    auto record = [&](uint64_t regOff, uint32_t value, uint32_t mask) {
+      auto [it, inserted] = values.try_emplace(regOff, 0);
+      if (inserted)
+        order.push_back(regOff);
+      it->second = (it->second & ~mask) | (value & mask);
+    };
+    for (const XAie_TxnCmd &cmd : ArrayRef(txn->CmdBuf, txn->NumCmds)) {
+      switch (cmd.Opcode) {
+      case XAIE_IO_WRITE:
+        record(cmd.RegOff, cmd.Value, ~0u);
+        break;
+      case XAIE_IO_BLOCKWRITE:
+        for (uint32_t i = 0; i < cmd.Size; i++)
+          record(cmd.RegOff + 4 * i,
+                 reinterpret_cast<const uint32_t *>(cmd.DataPtr)[i], ~0u);
+        break;
+      case XAIE_IO_BLOCKSET:
+        for (uint32_t i = 0; i < cmd.Size; i++)
+          record(cmd.RegOff + 4 * i, cmd.Value, ~0u);
+        break;
+      case XAIE_IO_MASKWRITE:
+        record(cmd.RegOff, cmd.Value, cmd.Mask);
+        break;
+      default:
+        return targetOp.emitOpError("configuration doesn't only write "
+                                    "registers, e.g. it polls them");
+      }
+    }
+    return success();
+  }
+
   LogicalResult addErrorHandlingToCDO() {
     TRY_XAIE_API_LOGICAL_RESULT(XAie_ErrorHandlingInit, &devInst);
     return success();
   }
 
+  /// Reads the ELFs of the cores of the device in parallel, ahead of the
+  /// emission of the CDOs, so that the files are read once and the images
+  /// shared by several cores are only kept once. The files that can't be read
+  /// are left to XAie_LoadElf to report.
+  void loadElfImages(DeviceOp &targetOp, const StringRef workDirPath) {
+    SmallVector<std::string> paths;
+    for (auto coreOp : targetOp.getOps<CoreOp>()) {
+      std::string path = getCoreElfPath(coreOp, workDirPath);
+      if (!elfHashes.count(path) && !llvm::is_contained(paths, path))
+        paths.push_back(path);
+    }
+    SmallVector<std::unique_ptr<llvm::MemoryBuffer>> buffers(paths.size());
+    SmallVector<std::string> hashes(paths.size());
+    parallelFor(targetOp.getContext(), 0, paths.size(), [&](size_t i) {
+      auto buffer = llvm::MemoryBuffer::getFile(paths[i]);
+      if (!buffer)
+        return;
+      hashes[i] = llvm::toHex(llvm::SHA256::hash(
+          llvm::arrayRefFromStringRef((*buffer)->getBuffer())));
+      buffers[i] = std::move(*buffer);
+    });
+    for (size_t i = 0; i < paths.size(); i++)
+      if (buffers[i]) {
+        elfHashes[paths[i]] = hashes[i];
+        elfImages.try_emplace(hashes[i], std::move(buffers[i]));
+      }
+    LLVM_DEBUG(llvm::dbgs() << "Read " << elfHashes.size() << " ELFs, "
+                            << elfImages.size() << " distinct images\n");
+  }
+
+  /// The image of the ELF at the given path read by loadElfImages, if any.
+  const llvm::MemoryBuffer *getElfImage(const StringRef elfPath) {
+    auto it = elfHashes.find(elfPath);
+    if (it == elfHashes.end())
+      return nullptr;
+    return elfImages.at(it->second).get();
+  }
+
   LogicalResult addAieElfToCDO(uint8_t col, uint8_t row,
                                const StringRef elfPath, bool aieSim) {
+    // The symbols of the .map file are only loaded from the file.
+    if (const llvm::MemoryBuffer *elf = getElfImage(elfPath); elf && !aieSim) {
+      TRY_XAIE_API_LOGICAL_RESULT(
+          XAie_LoadElfMem, &devInst, getTileLoc(col, row),
+          reinterpret_cast<const unsigned char *>(elf->getBufferStart()));
+      return success();
+    }
     // loadSym: Load symbols from .map file. This argument is not used when
     // __AIESIM__ is not defined.
-    TRY_XAIE_API_LOGICAL_RESULT(XAie_LoadElf, &devInst, XAie_TileLoc(col, row),
+    TRY_XAIE_API_LOGICAL_RESULT(XAie_LoadElf, &devInst, getTileLoc(col, row),
                                 elfPath.str().c_str(), /*loadSym*/ aieSim);
     return success();
   }
 
   LogicalResult addAieElfsToCDO(DeviceOp &targetOp, const StringRef workDirPath,
-                                bool aieSim) {
+                                bool aieSim,
+                                std::optional<int> column = std::nullopt) {
     for (auto tileOp : targetOp.getOps<TileOp>())
-      if (tileOp.isShimNOCorPLTile()) {
+      if (tileOp.isShimNOCorPLTile() ||
+          (column && tileOp.colIndex() != *column)) {
         // Resets no needed with V2 kernel driver
       } else {
         int col = tileOp.colIndex();
         int row = tileOp.rowIndex();
-        if (auto coreOp = tileOp.getCoreOp()) {
-          std::string fileName;
-          if (auto fileAttr = coreOp.getElfFile())
-            fileName = fileAttr->str();
-          else
-            fileName = std::string("core_") + std::to_string(col) + "_" +
-                       std::to_string(row) + ".elf";
-          if (failed(addAieElfToCDO(col, row, workDirPath.str() + ps + fileName,
+        if (auto coreOp = tileOp.getCoreOp())
+          if (failed(addAieElfToCDO(col, row,
+                                    getCoreElfPath(coreOp, workDirPath),
                                     aieSim)))
             return failure();
-        }
       }
     return success();
   }
 
   LogicalResult addInitConfigToCDO(DeviceOp &targetOp) {
     for (auto tileOp : targetOp.getOps<TileOp>()) {
-      auto tileLoc = XAie_TileLoc(tileOp.colIndex(), tileOp.rowIndex());
+      auto tileLoc = getTileLoc(tileOp.colIndex(), tileOp.rowIndex());
       if (!tileOp.isShimTile() && tileOp.getCoreOp()) {
         TRY_XAIE_API_EMIT_ERROR(tileOp, XAie_CoreReset, &devInst, tileLoc);
         TRY_XAIE_API_EMIT_ERROR(tileOp, XAie_CoreUnreset, &devInst, tileLoc);
@@ -419,13 +794,33 @@ struct AIEControl {
           TRY_XAIE_API_EMIT_ERROR(tileOp, XAie_LockSetValue, &devInst, tileLoc,
                                   locInit);
         }
+        // Time the operations marked as profiled, which the core brackets by
+        // its instruction events: one counter adds up their cycles, the
+        // other counts how many times they ran.
+        bool profiled =
+            tileOp.getCoreOp()
+                .walk([](Operation *op) {
+                  return op->hasAttr("aie.profile") ? WalkResult::interrupt()
+                                                    : WalkResult::advance();
+                })
+                .wasInterrupted();
+        if (profiled) {
+          TRY_XAIE_API_EMIT_ERROR(
+              tileOp, XAie_PerfCounterControlSet, &devInst, tileLoc,
+              XAIE_CORE_MOD, KERNEL_CYCLES_COUNTER,
+              XAIE_EVENT_INSTR_EVENT_0_CORE, XAIE_EVENT_INSTR_EVENT_1_CORE);
+          TRY_XAIE_API_EMIT_ERROR(
+              tileOp, XAie_PerfCounterControlSet, &devInst, tileLoc,
+              XAIE_CORE_MOD, KERNEL_CALLS_COUNTER,
+              XAIE_EVENT_INSTR_EVENT_0_CORE, XAIE_EVENT_INSTR_EVENT_0_CORE);
+        }
       }
     }
 
     // Set locks with explicit initializers
     targetOp.walk<WalkOrder::PreOrder>([&](LockOp lockOp) {
       if (lockOp.getLockID() && lockOp.getInit()) {
-        auto tileLoc = XAie_TileLoc(lockOp.getTileOp().colIndex(),
+        auto tileLoc = getTileLoc(lockOp.getTileOp().colIndex(),
                                     lockOp.getTileOp().rowIndex());
         auto locInit = XAie_LockInit(*lockOp.getLockID(), *lockOp.getInit());
         TRY_XAIE_API_FATAL_ERROR(XAie_LockSetValue, &devInst, tileLoc, locInit);
@@ -458,7 +853,7 @@ struct AIEControl {
     for (TileElement memOp : memOps) {
       int col = memOp.getTileID().col;
       int row = memOp.getTileID().row;
-      auto tileLoc = XAie_TileLoc(col, row);
+      auto tileLoc = getTileLoc(col, row);
       DenseMap<Block *, int> blockBdNumMap;
 
       // handle DMA ops separately
@@ -593,9 +988,10 @@ struct AIEControl {
     for (auto switchboxOp : targetOp.getOps<SwitchboxOp>()) {
       int32_t col = switchboxOp.colIndex();
       int32_t row = switchboxOp.rowIndex();
-      XAie_LocType tileLoc = XAie_TileLoc(col, row);
-      assert(targetOp.getDevice() == AIEDevice::ipu &&
-             "Only IPU currently supported");
+      XAie_LocType tileLoc = getTileLoc(col, row);
+      assert((targetOp.getDevice() == AIEDevice::ipu ||
+              targetOp.getDevice() == AIEDevice::npu) &&
+             "Only IPU and NPU currently supported");
       if (row == 0) {
         // FIXME hack for TCT routing
         // TODO Support both channels
@@ -667,7 +1063,7 @@ struct AIEControl {
       // NOTE ShimMux always connects from the south as directions are
       // defined relative to the tile stream switch.
       auto tileLoc =
-          XAie_TileLoc(muxOp.getTileOp().getCol(), muxOp.getTileOp().getRow());
+          getTileLoc(muxOp.getTileOp().getCol(), muxOp.getTileOp().getRow());
       Block &b = muxOp.getConnections().front();
       for (auto connectOp : b.getOps<ConnectOp>()) {
         // demux!
@@ -683,7 +1079,7 @@ struct AIEControl {
 
     for (auto switchboxOp : targetOp.getOps<ShimSwitchboxOp>()) {
       Block &b = switchboxOp.getConnections().front();
-      auto tileLoc = XAie_TileLoc(switchboxOp.getCol(), 0);
+      auto tileLoc = getTileLoc(switchboxOp.getCol(), 0);
       for (auto connectOp : b.getOps<ConnectOp>())
         TRY_XAIE_API_EMIT_ERROR(
             switchboxOp, XAie_StrmConnCctEnable, &devInst, tileLoc,
@@ -698,7 +1094,7 @@ struct AIEControl {
     if (target_model.getTargetArch() == AIEArch::AIE2) {
       for (auto configOp : targetOp.getOps<ConfigureCascadeOp>()) {
         TileOp tile = cast<TileOp>(configOp.getTile().getDefiningOp());
-        auto tileLoc = XAie_TileLoc(tile.getCol(), tile.getRow());
+        auto tileLoc = getTileLoc(tile.getCol(), tile.getRow());
         TRY_XAIE_API_EMIT_ERROR(
             targetOp, XAie_CoreConfigAccumulatorControl, &devInst, tileLoc,
             WIRE_BUNDLE_TO_STRM_SW_PORT_TYPE.at(
@@ -712,12 +1108,41 @@ struct AIEControl {
   }
 
   LogicalResult addCoreEnableToCDO(DeviceOp &targetOp) {
-    // Start execution of all the cores.
+    std::optional<int32_t> channel = targetOp.getCoreStartBroadcast();
+    if (!channel) {
+      // Start execution of all the cores.
+      for (auto tileOp : targetOp.getOps<TileOp>()) {
+        auto tileLoc = getTileLoc(tileOp.colIndex(), tileOp.rowIndex());
+        if (!tileOp.isShimTile() && tileOp.getCoreOp())
+          TRY_XAIE_API_EMIT_ERROR(targetOp, XAie_CoreEnable, &devInst,
+                                  tileLoc);
+      }
+      return success();
+    }
+
+    // Arm all the cores, and the reset of their timers, on the broadcast
+    // event, then fire it once from the shim tile of the leftmost core
+    // column, so that the cores start in lockstep.
+    auto coreEvent =
+        static_cast<XAie_Events>(XAIE_EVENT_BROADCAST_0_CORE + *channel);
+    int firstCol = std::numeric_limits<int>::max();
     for (auto tileOp : targetOp.getOps<TileOp>()) {
-      auto tileLoc = XAie_TileLoc(tileOp.colIndex(), tileOp.rowIndex());
-      if (!tileOp.isShimTile() && tileOp.getCoreOp())
-        TRY_XAIE_API_EMIT_ERROR(targetOp, XAie_CoreEnable, &devInst, tileLoc);
+      if (tileOp.isShimTile() || !tileOp.getCoreOp())
+        continue;
+      auto tileLoc = getTileLoc(tileOp.colIndex(), tileOp.rowIndex());
+      TRY_XAIE_API_EMIT_ERROR(targetOp, XAie_CoreConfigureEnableEvent,
+                              &devInst, tileLoc, coreEvent);
+      TRY_XAIE_API_EMIT_ERROR(targetOp, XAie_SetTimerResetEvent, &devInst,
+                              tileLoc, XAIE_CORE_MOD, coreEvent,
+                              XAIE_RESETDISABLE);
+      firstCol = std::min(firstCol, tileOp.colIndex());
     }
+    auto shimLoc = getTileLoc(firstCol, 0);
+    TRY_XAIE_API_EMIT_ERROR(targetOp, XAie_EventBroadcast, &devInst, shimLoc,
+                            XAIE_PL_MOD, *channel,
+                            XAIE_EVENT_USER_EVENT_0_PL);
+    TRY_XAIE_API_EMIT_ERROR(targetOp, XAie_EventGenerate, &devInst, shimLoc,
+                            XAIE_PL_MOD, XAIE_EVENT_USER_EVENT_0_PL);
     return success();
   }
 };
@@ -731,41 +1156,109 @@ void initializeCDOGenerator(byte_ordering endianness, bool axiDebug) {
   setEndianness(endianness);
 };
 
-LogicalResult generateCDOBinary(const StringRef outputPath,
+LogicalResult generateCDOBinary(AIEControl &ctl, const StringRef outputPath,
                                 const std::function<LogicalResult()> &cb) {
   startCDOFileStream(outputPath.str().c_str());
   FileHeader();
-  if (failed(cb()))
+  if (ctl.recordsWrites())
+    ctl.startRecordingWrites();
+  if (failed(cb())) {
+    if (ctl.recordsWrites())
+      XAie_FreeTransactionInstance(ctl.stopRecordingWrites());
+    return failure();
+  }
+  if (ctl.recordsWrites() && failed(ctl.emitRecordedWrites()))
     return failure();
   configureHeader();
   endCurrentCDOFileStream();
   return success();
 }
 
+// Generates a CDO unless its inputs, summarized by the given key, are the
+// same as when it was last generated in the work directory. The hash of the
+// key is kept next to the CDO to compare with.
+static LogicalResult
+generateCDOBinaryIfChanged(AIEControl &ctl, const StringRef outputPath,
+                           const StringRef key,
+                           const std::function<LogicalResult()> &cb) {
+  std::string hash =
+      llvm::toHex(llvm::SHA256::hash(llvm::arrayRefFromStringRef(key)));
+  std::string hashPath = outputPath.str() + ".hash";
+  if (auto previous = llvm::MemoryBuffer::getFile(hashPath);
+      previous && (*previous)->getBuffer() == hash &&
+      llvm::sys::fs::exists(outputPath)) {
+    LLVM_DEBUG(llvm::dbgs() << "Reusing " << outputPath << "\n");
+    return success();
+  }
+  // Don't leave a stale hash behind if the generation fails.
+  llvm::sys::fs::remove(hashPath);
+  if (failed(generateCDOBinary(ctl, outputPath, cb)))
+    return failure();
+  std::error_code ec;
+  llvm::raw_fd_ostream hashFile(hashPath, ec);
+  if (!ec)
+    hashFile << hash;
+  return success();
+}
+
+// The ELFs of the cores are loaded by one CDO per column, so that editing a
+// kernel only regenerates the CDO of its column. The configuration CDO only
+// depends on the device outside of the bodies of the cores.
 LogicalResult generateCDOBinariesSeparately(AIEControl &ctl,
                                             const StringRef workDirPath,
-                                            DeviceOp &targetOp, bool aieSim) {
+                                            DeviceOp &targetOp, bool aieSim,
+                                            const StringRef configKey) {
   if (failed(generateCDOBinary(
-          workDirPath.str() + ps + "aie_cdo_error_handling.bin",
-          std::bind(&AIEControl::addErrorHandlingToCDO, ctl))))
-    return failure();
-
-  if (!targetOp.getOps<CoreOp>().empty() &&
-      failed(generateCDOBinary(workDirPath.str() + ps + "aie_cdo_elfs.bin",
-                               [&ctl, &targetOp, &workDirPath, &aieSim] {
-                                 return ctl.addAieElfsToCDO(
-                                     targetOp, workDirPath, aieSim);
-                               })))
+          ctl, workDirPath.str() + ps + "aie_cdo_error_handling.bin",
+          [&ctl] { return ctl.addErrorHandlingToCDO(); })))
     return failure();
 
-  if (failed(generateCDOBinary(
-          workDirPath.str() + ps + "aie_cdo_init.bin",
+  std::map<int, std::string> elfKeys;
+  for (auto coreOp : targetOp.getOps<CoreOp>()) {
+    TileID tile = coreOp.getTileID();
+    std::string &key = elfKeys[tile.col];
+    if (key.empty())
+      key = configKey.str();
+    key += "core " + std::to_string(tile.col) + " " +
+           std::to_string(tile.row) + "\n";
+    std::string elfPath = getCoreElfPath(coreOp, workDirPath);
+    if (auto hash = ctl.elfHashes.find(elfPath); hash != ctl.elfHashes.end())
+      key += hash->second + "\n";
+    if (auto contents = llvm::MemoryBuffer::getFile(elfPath + ".map"))
+      key += (*contents)->getBuffer();
+  }
+  for (auto &[col, key] : elfKeys)
+    if (failed(generateCDOBinaryIfChanged(
+            ctl,
+            workDirPath.str() + ps + "aie_cdo_elfs_" + std::to_string(col) +
+                ".bin",
+            key, [&ctl, &targetOp, &workDirPath, &aieSim, col = col] {
+              return ctl.addAieElfsToCDO(targetOp, workDirPath, aieSim, col);
+            })))
+      return failure();
+
+  std::string initKey = configKey.str();
+  {
+    llvm::raw_string_ostream os(initKey);
+    AsmState state(targetOp);
+    for (Operation &op : targetOp.getBody()->without_terminator()) {
+      if (auto coreOp = dyn_cast<CoreOp>(&op)) {
+        os << "core " << coreOp.getTileID().col << " "
+           << coreOp.getTileID().row << "\n";
+        continue;
+      }
+      op.print(os, state);
+      os << "\n";
+    }
+  }
+  if (failed(generateCDOBinaryIfChanged(
+          ctl, workDirPath.str() + ps + "aie_cdo_init.bin", initKey,
           [&ctl, &targetOp] { return ctl.addInitConfigToCDO(targetOp); })))
     return failure();
 
   if (!targetOp.getOps<CoreOp>().empty() &&
       failed(generateCDOBinary(
-          workDirPath.str() + ps + "aie_cdo_enable.bin",
+          ctl, workDirPath.str() + ps + "aie_cdo_enable.bin",
           [&ctl, &targetOp] { return ctl.addCoreEnableToCDO(targetOp); })))
     return failure();
 
@@ -775,7 +1268,7 @@ LogicalResult generateCDOBinariesSeparately(AIEControl &ctl,
 LogicalResult generateCDOUnified(AIEControl &ctl, const StringRef workDirPath,
                                  DeviceOp &targetOp, bool aieSim) {
   return generateCDOBinary(
-      workDirPath.str() + ps + "aie_cdo.bin",
+      ctl, workDirPath.str() + ps + "aie_cdo.bin",
       [&ctl, &targetOp, &workDirPath, &aieSim] {
         if (failed(ctl.addErrorHandlingToCDO()))
           return failure();
@@ -794,27 +1287,68 @@ LogicalResult generateCDOUnified(AIEControl &ctl, const StringRef workDirPath,
 LogicalResult AIETranslateToCDODirect(ModuleOp m, llvm::StringRef workDirPath,
                                       byte_ordering endianness,
                                       bool emitUnified, bool axiDebug,
-                                      bool aieSim, size_t partitionStartCol) {
+                                      bool aieSim, size_t partitionStartCol,
+                                      bool optimizeWrites, ModuleOp deltaBase,
+                                      llvm::StringRef deltaBaseWorkDirPath) {
   auto devOps = m.getOps<DeviceOp>();
   assert(llvm::range_size(devOps) == 1 &&
          "only exactly 1 device op supported.");
   DeviceOp targetOp = *devOps.begin();
   // things like XAIE_MEM_TILE_ROW_START and the missing
-  // shim dma on tile (0,0) are hard-coded assumptions about IPU...
-  assert(targetOp.getDevice() == AIEDevice::ipu &&
-         "Only IPU currently supported");
-  int maxCol = 0, minCol = 0;
-  for (auto tileOp : targetOp.getOps<TileOp>()) {
-    minCol = std::min(tileOp.getCol(), minCol);
+  // shim dma on tile (0,0) are hard-coded assumptions about the NPU family...
+  assert((targetOp.getDevice() == AIEDevice::ipu ||
+          targetOp.getDevice() == AIEDevice::npu) &&
+         "Only IPU and NPU currently supported");
+  int colOffset = getColumnOffset(targetOp);
+  int maxCol = colOffset;
+  for (auto tileOp : targetOp.getOps<TileOp>())
     maxCol = std::max(tileOp.getCol(), maxCol);
-  }
-  size_t partitionNumCols = maxCol - minCol + 1;
+  size_t partitionNumCols = maxCol - colOffset + 1;
   AIEControl ctl(partitionStartCol, partitionNumCols, aieSim,
-                 targetOp.getTargetModel());
+                 targetOp.getTargetModel(), optimizeWrites);
+  ctl.colOffset = colOffset;
   initializeCDOGenerator(endianness, axiDebug);
+  ctl.loadElfImages(targetOp, workDirPath);
+  // A delta CDO only loads the program memory words differing from the
+  // design running before it in the partition: the rest of the
+  // configuration is rewritten, since it is reset with the partition or
+  // changed at run time, like the locks and the data memories.
+  std::optional<DeviceOp> baseOp;
+  if (deltaBase) {
+    auto baseDevOps = deltaBase.getOps<DeviceOp>();
+    if (llvm::range_size(baseDevOps) != 1)
+      return deltaBase.emitOpError(
+          "expected exactly 1 AIE.device operation in the base design");
+    baseOp = *baseDevOps.begin();
+    if (baseOp->getDevice() != targetOp.getDevice())
+      return baseOp->emitOpError(
+          "base design is for a different device than the design");
+    ctl.loadElfImages(*baseOp, deltaBaseWorkDirPath);
+    if (failed(ctl.collectBaseProgramMemory(*baseOp, deltaBaseWorkDirPath,
+                                            aieSim)))
+      return failure();
+  }
   if (emitUnified)
     return generateCDOUnified(ctl, workDirPath, targetOp, aieSim);
-  return generateCDOBinariesSeparately(ctl, workDirPath, targetOp, aieSim);
+  // The settings changing the contents of all the CDOs.
+  std::string configKey;
+  llvm::raw_string_ostream configOS(configKey);
+  configOS << "endianness " << int(endianness) << " axi-debug " << axiDebug
+           << " aiesim " << aieSim << " partition " << partitionStartCol << " "
+           << partitionNumCols << " column-offset " << colOffset
+           << " optimize-writes " << optimizeWrites
+           << "\n";
+  if (baseOp)
+    for (auto coreOp : baseOp->getOps<CoreOp>())
+      if (auto hash = ctl.elfHashes.find(
+              getCoreElfPath(coreOp, deltaBaseWorkDirPath));
+          hash != ctl.elfHashes.end())
+        configOS << "delta-base " << coreOp.getTileID().col << " "
+                 << coreOp.getTileID().row << "\n"
+                 << hash->second << "\n";
+  configOS.flush();
+  return generateCDOBinariesSeparately(ctl, workDirPath, targetOp, aieSim,
+                                       configKey);
 }
 // Not sure why but defining this with xilinx::AIE will create a duplicate
 // symbol in libAIETargets.a that then doesn't actually match the header?
@@ -822,10 +1356,145 @@ namespace xilinx::AIE {
 LogicalResult AIETranslateToCDODirect(ModuleOp m, llvm::StringRef workDirPath,
                                       bool bigEndian, bool emitUnified,
                                       bool axiDebug, bool aieSim,
-                                      size_t partitionStartCol) {
+                                      size_t partitionStartCol,
+                                      bool optimizeWrites, ModuleOp deltaBase,
+                                      llvm::StringRef deltaBaseWorkDirPath) {
   byte_ordering endianness =
       bigEndian ? byte_ordering::Big_Endian : byte_ordering::Little_Endian;
   return AIETranslateToCDODirect(m, workDirPath, endianness, emitUnified,
-                                 axiDebug, aieSim, partitionStartCol);
+                                 axiDebug, aieSim, partitionStartCol,
+                                 optimizeWrites, deltaBase,
+                                 deltaBaseWorkDirPath);
+}
+} // namespace xilinx::AIE
+
+// Sets the odd parity bit of a packet header word, its most significant bit.
+static uint32_t withOddParity(uint32_t word) {
+  return llvm::popcount(word) % 2 ? word : word | (1u << 31);
+}
+
+// The packet ID which the packet rules of the switchbox of a tile route to
+// its control port, if any.
+static std::optional<int> getCtrlPacketID(DeviceOp &device, int col, int row) {
+  for (auto switchboxOp : device.getOps<SwitchboxOp>()) {
+    if (switchboxOp.colIndex() != col || switchboxOp.rowIndex() != row)
+      continue;
+    Block &b = switchboxOp.getConnections().front();
+    for (auto masterSetOp : b.getOps<MasterSetOp>()) {
+      if (masterSetOp.getDestBundle() != WireBundle::Ctrl)
+        continue;
+      for (auto rulesOp : b.getOps<PacketRulesOp>())
+        for (auto ruleOp : rulesOp.getRules().front().getOps<PacketRuleOp>())
+          if (llvm::is_contained(masterSetOp.getAmsels(), ruleOp.getAmsel()))
+            return ruleOp.valueInt();
+    }
+  }
+  return std::nullopt;
+}
+
+namespace xilinx::AIE {
+/// Emits the configuration differing between a design and the base design
+/// running before it in the partition as control packets, to be pushed by a
+/// shim DMA on the packet routes of the base design to the control ports of
+/// the tiles. The tiles not reconfigured keep running meanwhile. The ELFs
+/// and the enabling of the cores aren't part of the packets: a reconfigured
+/// design is meant to change the BDs, the switch settings and the lock
+/// values of the same cores, and its BDs must not be in use by the running
+/// DMAs.
+///
+/// The registers written by the design to a value other than the one left
+/// by the base design are written first, in the order the design writes
+/// them; the registers only written by the base design are then reset to
+/// zero, which tears down its routes and BDs. A packet writes up to 4
+/// consecutive registers of a tile, after a header with the packet ID of
+/// the route to the control port of the tile and a control header with the
+/// address of the first register and the number of registers written.
+LogicalResult AIETranslateToControlPackets(ModuleOp m, raw_ostream &output,
+                                           ModuleOp base,
+                                           size_t partitionStartCol) {
+  auto devOps = m.getOps<DeviceOp>();
+  if (llvm::range_size(devOps) != 1)
+    return m.emitOpError("expected exactly 1 AIE.device operation");
+  DeviceOp targetOp = *devOps.begin();
+  auto baseDevOps = base.getOps<DeviceOp>();
+  if (llvm::range_size(baseDevOps) != 1)
+    return base.emitOpError(
+        "expected exactly 1 AIE.device operation in the base design");
+  DeviceOp baseOp = *baseDevOps.begin();
+  if (baseOp.getDevice() != targetOp.getDevice())
+    return baseOp.emitOpError(
+        "base design is for a different device than the design");
+  if (targetOp.getDevice() != AIEDevice::ipu &&
+      targetOp.getDevice() != AIEDevice::npu)
+    return targetOp.emitOpError(
+        "control packets are only generated for IPU and NPU devices");
+  int colOffset = getColumnOffset(targetOp);
+  if (getColumnOffset(baseOp) != colOffset)
+    return baseOp.emitOpError(
+        "base design is placed at a different column than the design");
+
+  // The configuration of each design, recorded from the first column of the
+  // partition.
+  struct Configuration {
+    SmallVector<uint64_t> order;
+    llvm::DenseMap<uint64_t, uint32_t> values;
+  } config, baseConfig;
+  auto record = [&](DeviceOp device, Configuration &recorded) {
+    int maxCol = colOffset;
+    for (auto tileOp : device.getOps<TileOp>())
+      maxCol = std::max(tileOp.getCol(), maxCol);
+    AIEControl ctl(partitionStartCol, maxCol - colOffset + 1,
+                   /*aieSim*/ false, device.getTargetModel());
+    ctl.colOffset = colOffset;
+    return ctl.recordConfiguration(device, recorded.order, recorded.values);
+  };
+  if (failed(record(targetOp, config)) || failed(record(baseOp, baseConfig)))
+    return failure();
+
+  SmallVector<std::pair<uint64_t, uint32_t>> writes;
+  for (uint64_t regOff : config.order) {
+    uint32_t value = config.values.at(regOff);
+    auto baseValue = baseConfig.values.find(regOff);
+    if (baseValue == baseConfig.values.end() || baseValue->second != value)
+      writes.push_back({regOff, value});
+  }
+  for (uint64_t regOff : baseConfig.order)
+    if (!config.values.contains(regOff) && baseConfig.values.at(regOff))
+      writes.push_back({regOff, 0});
+
+  AIEControl ctl(partitionStartCol, 1, /*aieSim*/ false,
+                 targetOp.getTargetModel());
+  ctl.colOffset = colOffset;
+  std::map<std::pair<int, int>, int> packetIDs;
+  size_t numPackets = 0;
+  for (size_t i = 0; i < writes.size();) {
+    auto [col, row, offset] = ctl.decodeAddress(writes[i].first);
+    auto [packetID, inserted] = packetIDs.try_emplace({col, row}, 0);
+    if (inserted) {
+      std::optional<int> id = getCtrlPacketID(baseOp, col, row);
+      if (!id)
+        return targetOp.emitOpError("tile (")
+               << col << ", " << row
+               << ") is reconfigured, but the base design routes no packet "
+                  "to its control port";
+      packetID->second = *id;
+    }
+    size_t beats = 1;
+    while (beats < 4 && i + beats < writes.size() &&
+           writes[i + beats].first == writes[i].first + 4 * beats)
+      beats++;
+    output << llvm::format("%08X\n", withOddParity(packetID->second));
+    // The operation, bits 22 and 23 of the control header, is 0 for a write.
+    output << llvm::format("%08X\n",
+                           withOddParity(offset | (beats - 1) << 20));
+    for (size_t j = 0; j < beats; j++)
+      output << llvm::format("%08X\n", writes[i + j].second);
+    i += beats;
+    numPackets++;
+  }
+  LLVM_DEBUG(llvm::dbgs() << "Emitting " << writes.size()
+                          << " register writes in " << numPackets
+                          << " control packets\n");
+  return success();
 }
 } // namespace xilinx::AIE
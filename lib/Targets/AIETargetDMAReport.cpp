@@ -0,0 +1,231 @@
+//===- AIETargetDMAReport.cpp -----------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Statically estimates the traffic of the DMA channels of a design, to find
+// DMA bottlenecks before running on the board. For each channel started in
+// an aie.mem, aie.memtile_dma or aie.shim_dma, the BD chain is followed
+// through its aie.next_bd terminators for one iteration of the design: one
+// pass of a looping chain, or repeat_count passes of a chain ending in a
+// block without BDs.
+//
+// The report gives, for each channel, the bytes moved in one iteration and
+// the cycles needed to move them, assuming the stream interface of the
+// channel moves one 32-bit word per cycle. The locks acquired by the BDs,
+// usually the locks of objectFifos after aie-objectFifo-stateful-transform,
+// are matched with the cores and channels releasing them. A channel waiting
+// on slower channels is stalled for at least the difference in cycles;
+// waiting on cores is only reported, since their run time is unknown here.
+// The occupancy of a channel is its busy time relative to the estimated
+// length of an iteration, the slowest chain of channels in the design.
+
+#include "aie/Targets/AIETargets.h"
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// The stream interface of a DMA channel moves one 32-bit word per cycle.
+static constexpr int64_t bytesPerCycle = 4;
+
+namespace {
+
+struct DMAChannel {
+  TileID tile;
+  StringRef kind;
+  DMAChannelDir dir;
+  int index;
+  SmallVector<Block *> bds;
+  int64_t passes;
+  int64_t bytes = 0;
+  int64_t cycles = 0;
+  // The cores releasing the locks acquired by the BDs.
+  llvm::SetVector<Operation *> waitsOn;
+  int64_t stallCycles = 0;
+};
+
+} // namespace
+
+static std::string describeTile(TileID tile) {
+  return llvm::formatv("({0}, {1})", tile.col, tile.row).str();
+}
+
+static std::string describeChannel(const DMAChannel &channel) {
+  return llvm::formatv("{0} {1} {2}{3}", channel.kind,
+                       describeTile(channel.tile),
+                       stringifyDMAChannelDir(channel.dir), channel.index)
+      .str();
+}
+
+static std::string describeLock(LockOp lock) {
+  if (lock.hasName())
+    return lock.name().str();
+  TileID tile = lock.getTileOp().getTileID();
+  if (lock.getLockID())
+    return llvm::formatv("lock {0} of {1}", lock.getLockIDValue(),
+                         describeTile(tile))
+        .str();
+  return "lock of " + describeTile(tile);
+}
+
+static int64_t getBytes(Block *block) {
+  int64_t bytes = 0;
+  for (auto bd : block->getOps<DMABDOp>()) {
+    auto type = cast<MemRefType>(bd.getBuffer().getType());
+    bytes += int64_t(bd.getLenValue()) * type.getElementTypeBitWidth() / 8;
+  }
+  return bytes;
+}
+
+// Follows the chain of BDs started by an aie.dma_start.
+static void collectChain(DMAStartOp start, DMAChannel &channel) {
+  Block *block = start.getDest();
+  while (block && !block->getOps<DMABDOp>().empty() &&
+         !llvm::is_contained(channel.bds, block)) {
+    channel.bds.push_back(block);
+    auto next = dyn_cast<NextBDOp>(block->getTerminator());
+    block = next ? next.getDest() : nullptr;
+  }
+  // A chain looping back runs once per iteration, whatever its repeat count.
+  bool loops = block && llvm::is_contained(channel.bds, block);
+  channel.passes = loops ? 1 : start.getRepeatCount();
+}
+
+static void collectChannels(Operation *dma, StringRef kind,
+                            std::vector<DMAChannel> &channels) {
+  TileID tile = cast<TileElement>(dma).getTileID();
+  for (Block &block : dma->getRegion(0)) {
+    for (auto start : block.getOps<DMAStartOp>()) {
+      DMAChannel channel{tile, kind, start.getChannelDir(),
+                         int(start.getChannelIndex()), {}, 1};
+      collectChain(start, channel);
+      channels.push_back(std::move(channel));
+    }
+    for (auto dmaOp : block.getOps<DMAOp>()) {
+      DMAChannel channel{tile, kind, dmaOp.getChannelDir(),
+                         int(dmaOp.getChannelIndex()), {}, 1};
+      for (Region &bd : dmaOp.getBds())
+        channel.bds.push_back(&bd.front());
+      channel.passes = dmaOp.getLoop() ? 1 : dmaOp.getRepeatCount();
+      channels.push_back(std::move(channel));
+    }
+  }
+}
+
+static void reportDevice(DeviceOp device, raw_ostream &output) {
+  std::vector<DMAChannel> channels;
+  for (auto mem : device.getOps<MemOp>())
+    collectChannels(mem, "mem", channels);
+  for (auto memTile : device.getOps<MemTileDMAOp>())
+    collectChannels(memTile, "memtile", channels);
+  for (auto shim : device.getOps<ShimDMAOp>())
+    collectChannels(shim, "shim", channels);
+
+  // The cores and channels releasing each lock.
+  DenseMap<Operation *, llvm::SetVector<Operation *>> coreReleasers;
+  device.walk([&](CoreOp core) {
+    core.walk([&](UseLockOp useLock) {
+      if (useLock.release())
+        coreReleasers[useLock.getLockOp()].insert(core);
+    });
+  });
+  DenseMap<Operation *, SmallVector<size_t>> channelReleasers;
+  for (auto [i, channel] : llvm::enumerate(channels))
+    for (Block *block : channel.bds)
+      for (auto useLock : block->getOps<UseLockOp>())
+        if (useLock.release())
+          channelReleasers[useLock.getLockOp()].push_back(i);
+
+  SmallVector<SmallVector<size_t>> producers(channels.size());
+  for (auto [i, channel] : llvm::enumerate(channels)) {
+    for (Block *block : channel.bds) {
+      channel.bytes += getBytes(block);
+      for (auto useLock : block->getOps<UseLockOp>()) {
+        if (useLock.release())
+          continue;
+        LockOp lock = useLock.getLockOp();
+        if (!coreReleasers.contains(lock) && !channelReleasers.contains(lock) &&
+            lock.getInit().value_or(0) < useLock.getLockValue())
+          useLock.emitWarning("waits on ")
+              << describeLock(lock) << ", which is never released";
+        channel.waitsOn.insert(coreReleasers[lock].begin(),
+                               coreReleasers[lock].end());
+        for (size_t producer : channelReleasers.lookup(lock))
+          if (producer != i && !llvm::is_contained(producers[i], producer))
+            producers[i].push_back(producer);
+      }
+    }
+    channel.bytes *= channel.passes;
+    channel.cycles = llvm::divideCeil(channel.bytes, bytesPerCycle);
+  }
+
+  // A channel can't finish before the channels it waits on, so the cycles of
+  // the slowest producer are propagated along the waits.
+  SmallVector<int64_t> bound =
+      llvm::map_to_vector(channels, [](const DMAChannel &c) {
+        return c.cycles;
+      });
+  for (size_t round = 0; round < channels.size(); round++) {
+    bool changed = false;
+    for (size_t i = 0; i < channels.size(); i++)
+      for (size_t producer : producers[i])
+        if (bound[producer] > bound[i]) {
+          bound[i] = bound[producer];
+          changed = true;
+        }
+    if (!changed)
+      break;
+  }
+  int64_t iterationCycles = 0;
+  for (auto [i, channel] : llvm::enumerate(channels)) {
+    channel.stallCycles = bound[i] - channel.cycles;
+    iterationCycles = std::max(iterationCycles, bound[i]);
+  }
+
+  llvm::json::Array channelsJSON;
+  for (auto [i, channel] : llvm::enumerate(channels)) {
+    llvm::json::Array waitsOn;
+    for (Operation *core : channel.waitsOn)
+      waitsOn.push_back(
+          "core " + describeTile(cast<CoreOp>(core).getTileID()));
+    for (size_t producer : producers[i])
+      waitsOn.push_back(describeChannel(channels[producer]));
+    channelsJSON.push_back(llvm::json::Object{
+        {"channel", describeChannel(channel)},
+        {"bds", int64_t(channel.bds.size())},
+        {"bytes", channel.bytes},
+        {"cycles", channel.cycles},
+        {"stall_cycles", channel.stallCycles},
+        {"occupancy_percent",
+         iterationCycles ? channel.cycles * 100 / iterationCycles : 0},
+        {"waits_on", std::move(waitsOn)},
+    });
+  }
+  llvm::json::Object deviceJSON{
+      {"iteration_cycles", iterationCycles},
+      {"channels", std::move(channelsJSON)},
+  };
+  output << llvm::formatv("{0:2}", llvm::json::Value(std::move(deviceJSON)))
+         << "\n";
+}
+
+LogicalResult xilinx::AIE::AIETranslateToDMAReport(ModuleOp module,
+                                                   raw_ostream &output) {
+  if (module.getOps<DeviceOp>().empty())
+    return module.emitOpError("expected AIE.device operation at toplevel");
+  for (auto device : module.getOps<DeviceOp>())
+    reportDevice(device, output);
+  return success();
+}
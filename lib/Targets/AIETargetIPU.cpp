@@ -8,6 +8,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "AIETargetShared.h"
+
 #include "aie/Targets/AIETargets.h"
 
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
@@ -50,107 +52,212 @@ reserveAndGetTail(std::vector<uint32_t> &instructions, uint64_t tailSize) {
                                          tailSize);
 }
 
-void appendSync(std::vector<uint32_t> &instructions, IpuSyncOp op) {
+void appendSync(std::vector<uint32_t> &instructions, IpuSyncOp op,
+                int colOffset) {
+  appendIPUSync(instructions, op.getColumn() - colOffset, op.getRow(),
+                op.getDirection(), op.getChannel(), op.getColumnNum(),
+                op.getRowNum());
+}
+
+void appendWrite32(std::vector<uint32_t> &instructions, IpuWrite32Op op,
+                   int colOffset) {
+  appendIPUWrite32(instructions, op.getColumn() - colOffset, op.getRow(),
+                   op.getAddress(), op.getValue());
+}
+
+void appendWriteBdShimTile(std::vector<uint32_t> &instructions,
+                           IpuWriteBdExShimTileOp op, int colOffset) {
+  IPUShimTileBD bd;
+  bd.column = op.getColumn() - colOffset;
+  bd.columnNum = op.getColumnNum();
+  bd.ddrId = op.getDdrId();
+  bd.bdId = op.getBdId();
+  bd.bufferLength = op.getBufferLength();
+  bd.bufferOffset = op.getBufferOffset();
+  bd.enablePacket = op.getEnablePacket();
+  bd.outOfOrderId = op.getOutOfOrderId();
+  bd.packetId = op.getPacketId();
+  bd.packetType = op.getPacketType();
+  bd.d0Size = op.getD0Size();
+  bd.d0Stride = op.getD0Stride();
+  bd.d1Size = op.getD1Size();
+  bd.d1Stride = op.getD1Stride();
+  bd.d2Stride = op.getD2Stride();
+  bd.iterationCurrent = op.getIterationCurrent();
+  bd.iterationSize = op.getIterationSize();
+  bd.iterationStride = op.getIterationStride();
+  bd.nextBd = op.getNextBd();
+  bd.useNextBd = op.getUseNextBd();
+  bd.validBd = op.getValidBd();
+  bd.lockRelVal = op.getLockRelVal();
+  bd.lockRelId = op.getLockRelId();
+  bd.lockAcqEnable = op.getLockAcqEnable();
+  bd.lockAcqVal = op.getLockAcqVal();
+  bd.lockAcqId = op.getLockAcqId();
+  bd.burstLength = op.getBurstLength().value_or(bd.burstLength);
+  bd.axCache = op.getAxCache().value_or(bd.axCache);
+  bd.axQos = op.getAxQos().value_or(bd.axQos);
+  appendIPUWriteBdShimTile(instructions, bd);
+}
+
+// Record the runtime parameters of an instruction word, listed in the op as
+// (argument, coefficient) pairs.
+void addPatches(std::vector<IPUInstructionPatch> &patches, uint32_t word,
+                std::optional<ArrayRef<int64_t>> params) {
+  if (!params)
+    return;
+  for (size_t i = 0; i + 1 < params->size(); i += 2)
+    patches.push_back(
+        {word, static_cast<uint32_t>((*params)[i]), (*params)[i + 1]});
+}
+
+// Record the runtime parameters of a BD whose instruction starts at the given
+// word.
+void appendWriteBdShimTilePatches(std::vector<IPUInstructionPatch> &patches,
+                                  uint32_t bdWord, IpuWriteBdExShimTileOp op) {
+  addPatches(patches, bdWord + 2, op.getBufferLengthParams());
+  addPatches(patches, bdWord + 3, op.getBufferOffsetParams());
+}
+
+// Record the runtime parameters of a write32 whose instruction starts at the
+// given word.
+void appendWrite32Patches(std::vector<IPUInstructionPatch> &patches,
+                          uint32_t writeWord, IpuWrite32Op op) {
+  addPatches(patches, writeWord + 1, op.getAddressParams());
+  addPatches(patches, writeWord + 2, op.getValueParams());
+}
+
+std::vector<uint32_t>
+generateIPU(ModuleOp module, std::vector<IPUInstructionPatch> *patches) {
+
+  std::vector<uint32_t> instructions = getProlog();
+
+  DeviceOp deviceOp = *module.getOps<DeviceOp>().begin();
+  int colOffset = getColumnOffset(deviceOp);
+  auto funcOps = deviceOp.getOps<func::FuncOp>();
+  for (auto f : funcOps) {
+    if (f.isDeclaration())
+      continue;
+    Block &entry = f.getRegion().front();
+    for (auto &o : entry) {
+      llvm::TypeSwitch<Operation *>(&o)
+          .Case<IpuSyncOp>(
+              [&](auto op) { appendSync(instructions, op, colOffset); })
+          .Case<IpuWrite32Op>([&](auto op) {
+            if (patches)
+              appendWrite32Patches(*patches, instructions.size(), op);
+            appendWrite32(instructions, op, colOffset);
+          })
+          .Case<IpuWriteBdExShimTileOp>([&](auto op) {
+            if (patches)
+              appendWriteBdShimTilePatches(*patches, instructions.size(), op);
+            appendWriteBdShimTile(instructions, op, colOffset);
+          });
+    }
+  }
+
+  return instructions;
+}
+
+} // namespace
 
+void xilinx::AIE::appendIPUSync(std::vector<uint32_t> &instructions,
+                                uint32_t column, uint32_t row,
+                                uint32_t direction, uint32_t channel,
+                                uint32_t columnNum, uint32_t rowNum) {
   auto words = reserveAndGetTail(instructions, 2);
 
   uint32_t opCode = 3;
   words[0] |= (opCode & 0xff) << 24;
-  words[0] |= (op.getColumn() & 0xff) << 16;
-  words[0] |= (op.getRow() & 0xff) << 8;
-  words[0] |= op.getDirection() & 0x1;
+  words[0] |= (column & 0xff) << 16;
+  words[0] |= (row & 0xff) << 8;
+  words[0] |= direction & 0x1;
 
-  words[1] |= (op.getChannel() & 0xff) << 24;
-  words[1] |= (op.getColumnNum() & 0xff) << 16;
-  words[1] |= (op.getRowNum() & 0xff) << 8;
+  words[1] |= (channel & 0xff) << 24;
+  words[1] |= (columnNum & 0xff) << 16;
+  words[1] |= (rowNum & 0xff) << 8;
 }
 
-void appendWrite32(std::vector<uint32_t> &instructions, IpuWrite32Op op) {
-
+void xilinx::AIE::appendIPUWrite32(std::vector<uint32_t> &instructions,
+                                   uint32_t column, uint32_t row,
+                                   uint32_t address, uint32_t value) {
   auto words = reserveAndGetTail(instructions, 3);
 
   uint32_t opCode = 2;
   words[0] |= (opCode & 0xff) << 24;
-  words[0] |= (op.getColumn() & 0xff) << 16;
-  words[0] |= (op.getRow() & 0xff) << 8;
+  words[0] |= (column & 0xff) << 16;
+  words[0] |= (row & 0xff) << 8;
 
-  words[1] = op.getAddress();
+  words[1] = address;
 
-  words[2] = op.getValue();
+  words[2] = value;
 }
 
-void appendWriteBdShimTile(std::vector<uint32_t> &instructions,
-                           IpuWriteBdExShimTileOp op) {
-
+void xilinx::AIE::appendIPUWriteBdShimTile(std::vector<uint32_t> &instructions,
+                                           const IPUShimTileBD &bd) {
   auto words = reserveAndGetTail(instructions, 10);
 
   uint32_t opCode = 6;
   words[0] |= (opCode & 0xff) << 24;
-  words[0] |= (op.getColumn() & 0xff) << 16;
-  words[0] |= (op.getColumnNum() & 0xff) << 8;
-  words[0] |= (op.getDdrId() & 0xf) << 4;
-  words[0] |= (op.getBdId() & 0xf);
+  words[0] |= (bd.column & 0xff) << 16;
+  words[0] |= (bd.columnNum & 0xff) << 8;
+  words[0] |= (bd.ddrId & 0xf) << 4;
+  words[0] |= (bd.bdId & 0xf);
 
   // TODO: Address Incr
   // words[1] = ...
 
-  words[2] = op.getBufferLength();
-  words[3] = op.getBufferOffset();
+  words[2] = bd.bufferLength;
+  words[3] = bd.bufferOffset;
 
   // En Packet , OoO BD ID , Packet ID , Packet Type
-  words[4] |= (op.getEnablePacket() & 0x1) << 30;
-  words[4] |= (op.getOutOfOrderId() & 0x3f) << 24;
-  words[4] |= (op.getPacketId() & 0x1f) << 19;
-  words[4] |= (op.getPacketType() & 0x7) << 16;
+  words[4] |= (bd.enablePacket & 0x1) << 30;
+  words[4] |= (bd.outOfOrderId & 0x3f) << 24;
+  words[4] |= (bd.packetId & 0x1f) << 19;
+  words[4] |= (bd.packetType & 0x7) << 16;
 
   // TODO: Secure Access
-  words[5] |= (op.getD0Size() & 0x3ff) << 20;
-  words[5] |= op.getD0Stride() & 0xfffff;
-
-  words[6] = 0x80000000; // burst length;
-  words[6] |= (op.getD1Size() & 0x3ff) << 20;
-  words[6] |= op.getD1Stride() & 0xfffff;
-
-  // TODO: SIMID, AxCache, AXQoS
-  words[7] = op.getD2Stride() & 0xfffff;
-
-  words[8] |= (op.getIterationCurrent() & 0x3f) << 26;
-  words[8] |= (op.getIterationSize() & 0x3f) << 20;
-  words[8] |= op.getIterationStride() & 0xfffff;
+  words[5] |= (bd.d0Size & 0x3ff) << 20;
+  words[5] |= bd.d0Stride & 0xfffff;
+
+  uint32_t burstLength = 2; // 256 bytes
+  if (bd.burstLength == 64)
+    burstLength = 0;
+  else if (bd.burstLength == 128)
+    burstLength = 1;
+  words[6] |= burstLength << 30;
+  words[6] |= (bd.d1Size & 0x3ff) << 20;
+  words[6] |= bd.d1Stride & 0xfffff;
+
+  // TODO: SMID
+  words[7] |= (bd.axCache & 0xf) << 24;
+  words[7] |= (bd.axQos & 0xf) << 20;
+  words[7] |= bd.d2Stride & 0xfffff;
+
+  words[8] |= (bd.iterationCurrent & 0x3f) << 26;
+  words[8] |= (bd.iterationSize & 0x3f) << 20;
+  words[8] |= bd.iterationStride & 0xfffff;
 
   // TODO: TLAST Suppress
-  words[9] |= (op.getNextBd() & 0xf) << 27;
-  words[9] |= (op.getUseNextBd() & 0x1) << 26;
-  words[9] |= (op.getValidBd() & 0x1) << 25;
-  words[9] |= (op.getLockRelVal() & 0xef) << 18;
-  words[9] |= (op.getLockRelId() & 0xf) << 13;
-  words[9] |= (op.getLockAcqEnable() & 0x1) << 12;
-  words[9] |= (op.getLockAcqVal() & 0xef) << 5;
-  words[9] |= op.getLockAcqId() & 0xf;
+  words[9] |= (bd.nextBd & 0xf) << 27;
+  words[9] |= (bd.useNextBd & 0x1) << 26;
+  words[9] |= (bd.validBd & 0x1) << 25;
+  words[9] |= (bd.lockRelVal & 0x7f) << 18;
+  words[9] |= (bd.lockRelId & 0xf) << 13;
+  words[9] |= (bd.lockAcqEnable & 0x1) << 12;
+  words[9] |= (bd.lockAcqVal & 0x7f) << 5;
+  words[9] |= bd.lockAcqId & 0xf;
 }
 
-} // namespace
-
 std::vector<uint32_t> xilinx::AIE::AIETranslateToIPU(ModuleOp module) {
+  return generateIPU(module, nullptr);
+}
 
-  std::vector<uint32_t> instructions = getProlog();
-
-  DeviceOp deviceOp = *module.getOps<DeviceOp>().begin();
-  auto funcOps = deviceOp.getOps<func::FuncOp>();
-  for (auto f : funcOps) {
-    if (f.isDeclaration())
-      continue;
-    Block &entry = f.getRegion().front();
-    for (auto &o : entry) {
-      llvm::TypeSwitch<Operation *>(&o)
-          .Case<IpuSyncOp>([&](auto op) { appendSync(instructions, op); })
-          .Case<IpuWrite32Op>([&](auto op) { appendWrite32(instructions, op); })
-          .Case<IpuWriteBdExShimTileOp>(
-              [&](auto op) { appendWriteBdShimTile(instructions, op); });
-    }
-  }
-
-  return instructions;
+std::vector<IPUInstructionPatch>
+xilinx::AIE::AIETranslateToIPUPatches(ModuleOp module) {
+  std::vector<IPUInstructionPatch> patches;
+  generateIPU(module, &patches);
+  return patches;
 }
 
 LogicalResult xilinx::AIE::AIETranslateToIPU(ModuleOp module,
@@ -160,3 +267,11 @@ LogicalResult xilinx::AIE::AIETranslateToIPU(ModuleOp module,
     output << llvm::format("%08X\n", w);
   return success();
 }
+
+LogicalResult xilinx::AIE::AIETranslateToIPUPatches(ModuleOp module,
+                                                    raw_ostream &output) {
+  for (const IPUInstructionPatch &patch : AIETranslateToIPUPatches(module))
+    output << patch.word << " " << patch.argument << " " << patch.coefficient
+           << "\n";
+  return success();
+}
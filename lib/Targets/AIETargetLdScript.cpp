@@ -11,10 +11,16 @@
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Targets/AIETargets.h"
 
+#include "AIETargetShared.h"
+
 using namespace mlir;
 using namespace xilinx;
 using namespace xilinx::AIE;
 
+// Load address of the code of the overlays in the elf, out of the address
+// space of the tiles so that it is not loaded with the resident code.
+static constexpr uint32_t overlayLoadBase = 0x100000;
+
 // Output the memorymap in gnu linker format for the given buffer operations,
 // with the given offset. The offset is different depending on where the buffers
 // are accessed from.
@@ -89,11 +95,23 @@ LogicalResult xilinx::AIE::AIETranslateToLdScript(ModuleOp module,
       }
       int origin = targetModel.getMemInternalBaseAddress(srcCoord) + max;
       int length = targetModel.getLocalMemorySize() - max;
+
+      // The overlays share the region at the end of the program memory, the
+      // resident code keeping the rest.
+      auto overlays = core.getOverlays();
+      uint32_t overlayBase = 0;
+      if (overlays)
+        overlayBase =
+            targetModel.getProgramMemorySize() - *core.getOverlaySize();
       output << R"THESCRIPT(
 MEMORY
 {
-   program (RX) : ORIGIN = 0, LENGTH = 0x0020000
 )THESCRIPT";
+      if (overlays)
+        output << "   program (RX) : ORIGIN = 0, LENGTH = 0x"
+               << llvm::utohexstr(overlayBase) << "\n";
+      else
+        output << "   program (RX) : ORIGIN = 0, LENGTH = 0x0020000\n";
       output << "   data (!RX) : ORIGIN = 0x" << llvm::utohexstr(origin)
              << ", LENGTH = 0x" << llvm::utohexstr(length);
       output << R"THESCRIPT(
@@ -113,19 +131,53 @@ SECTIONS
      _init_array_end = .;
      _dtors_start = .;
      _dtors_end = .;
-     *(.text)
-  } > program
-  .data : {
+)THESCRIPT";
+      if (overlays) {
+        std::string excluded = "EXCLUDE_FILE(";
+        for (auto [i, file] :
+             llvm::enumerate(overlays->getAsValueRange<StringAttr>()))
+          excluded += (i ? " *" : "*") + file.str();
+        excluded += ")";
+        output << "     *(" << excluded << " .text " << excluded
+               << " .text.*)\n";
+      } else {
+        output << "     *(.text)\n";
+      }
+      output << "  } > program\n";
+      // The code of the overlays is linked at the address of the overlay
+      // region and loaded out of the tile address space, from where aiecc.py
+      // extracts it for the runtime sequence.
+      if (overlays) {
+        output << "  OVERLAY 0x" << llvm::utohexstr(overlayBase)
+               << " : NOCROSSREFS AT (0x" << llvm::utohexstr(overlayLoadBase)
+               << ") {\n";
+        for (auto [i, file] :
+             llvm::enumerate(overlays->getAsValueRange<StringAttr>()))
+          output << "    .overlay" << i << " { *" << file
+                 << "(.text .text.*) }\n";
+        output << "  }\n";
+        for (size_t i = 0; i < overlays->size(); i++)
+          output << "  ASSERT(SIZEOF(.overlay" << i << ") <= 0x"
+                 << llvm::utohexstr(*core.getOverlaySize()) << ", \"overlay "
+                 << i << " is larger than the overlay_size of the core\")\n";
+      }
+      output << R"THESCRIPT(  .data : {
      *(.data*);
      *(.rodata*)
   } > data
 )THESCRIPT";
+      // Only map the buffers of the neighbors this core uses.
+      SmallPtrSet<Operation *, 16> coreBuffers;
+      bool allBuffers = !collectCoreBuffers(core, coreBuffers);
+
       auto doBuffer = [&](std::optional<TileID> tile, int offset,
                           std::string dir) {
         if (tile) {
           if (tiles.count(*tile))
             for (auto buf : buffers[tiles[*tile]])
-              writeLDScriptMap(output, buf, offset);
+              if (*tile == srcCoord || allBuffers ||
+                  coreBuffers.contains(buf))
+                writeLDScriptMap(output, buf, offset);
         } else {
           output << "/* No tile with memory exists to the " << dir << ". */\n";
           output << ". = 0x" << llvm::utohexstr(offset) << ";\n";
@@ -161,6 +213,9 @@ SECTIONS
       if (auto coreOp = tile.getCoreOp()) {
         if (auto fileAttr = coreOp.getLinkWith())
           output << "INPUT(" << fileAttr.value().str() << ")\n";
+        if (auto overlays = coreOp.getOverlays())
+          for (auto file : overlays->getAsValueRange<StringAttr>())
+            output << "INPUT(" << file << ")\n";
 
         output << "PROVIDE(_main = core_" << tile.getCol() << "_"
                << tile.getRow() << ");\n";
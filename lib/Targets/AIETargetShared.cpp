@@ -24,6 +24,15 @@ using namespace xilinx::AIEX;
 
 namespace xilinx::AIE {
 
+int getColumnOffset(DeviceOp device) {
+  if (!device->hasAttr("aie.relocatable"))
+    return 0;
+  int offset = device.getTargetModel().columns();
+  for (auto tile : device.getOps<TileOp>())
+    offset = std::min(offset, tile.colIndex());
+  return offset == device.getTargetModel().columns() ? 0 : offset;
+}
+
 std::string tileLocStr(StringRef col, StringRef row) {
   std::string str;
   llvm::raw_string_ostream rss(str);
@@ -86,18 +95,15 @@ static std::string tileDMATensorStr(int col, int row, int bdNum) {
 void generateXAieDmaSetMultiDimAddr(raw_ostream &output, int ndims,
                                     ArrayRef<BDDimLayoutAttr> dims, int col,
                                     int row, int bdNum, int baseAddrA,
-                                    int offsetA, int lenA, int bytesA,
-                                    const char *errorRetval) {
+                                    int offsetA, int lenA, int bytesA) {
   std::string tensor = tileDMATensorStr(col, row, bdNum);
+  // The dimensions are copied into the BD by XAie_DmaSetMultiDimAddr, so they
+  // can live on the stack.
+  output << "XAie_DmaDimDesc " << tensor << "_dims[" << std::to_string(ndims)
+         << "] = {};\n";
   output << "XAie_DmaTensor " << tensor << " = {};\n";
   output << tensor << ".NumDim = " << std::to_string(ndims) << ";\n";
-  output << tensor
-         << ".Dim ="
-            "__mlir_aie_alloc_dim_desc("
-         << std::to_string(ndims) << ");\n";
-  output << "if(NULL == " << tensor << ".Dim){\n"
-         << "  return " << errorRetval << ";\n"
-         << "}\n";
+  output << tensor << ".Dim = " << tensor << "_dims;\n";
   for (int i = 0; i < ndims; i++) {
     // Pass down dimensions in reverse order; in the MLIR, this allows us
     // to specify strides/sizes in the same order as we would access a
@@ -117,4 +123,38 @@ void generateXAieDmaSetMultiDimAddr(raw_ostream &output, int ndims,
   // TODO: Might need to adjust strides / sizes by -1
 }
 
+void generateXAieDmaSetPadding(raw_ostream &output,
+                               ArrayRef<BDPadLayoutAttr> pads, int col, int row,
+                               int bdNum) {
+  std::string tensor = tileDMATensorStr(col, row, bdNum) + "_pad";
+  int ndims = pads.size();
+  output << "XAie_PaddingDesc " << tensor << "_dims[" << std::to_string(ndims)
+         << "] = {};\n";
+  output << "XAie_DmaPadTensor " << tensor << " = {};\n";
+  output << tensor << ".NumDim = " << std::to_string(ndims) << ";\n";
+  output << tensor << ".PadDesc = " << tensor << "_dims;\n";
+  for (int i = 0; i < ndims; i++) {
+    // Same reverse order as the dimensions.
+    int j = ndims - i - 1;
+    output << tensor << ".PadDesc[" << std::to_string(j) << "]"
+           << " = { /* Before */ "
+           << std::to_string(pads[i].getConstPadBefore()) << ", /* After */ "
+           << std::to_string(pads[i].getConstPadAfter()) << "};\n";
+  }
+  output << "__mlir_aie_try(XAie_DmaSetPadding("
+         << tileDMAInstRefStr(col, row, bdNum) << ", "
+         << "&" << tensor << "));\n";
+}
+
+bool collectCoreBuffers(CoreOp core, SmallPtrSetImpl<Operation *> &buffers) {
+  if (!core || core.getLinkWith() || core.getElfFile())
+    return false;
+  core.walk([&](Operation *op) {
+    for (Value operand : op->getOperands())
+      if (auto buf = operand.getDefiningOp<BufferOp>())
+        buffers.insert(buf);
+  });
+  return true;
+}
+
 } // namespace xilinx::AIE
@@ -13,6 +13,12 @@
 namespace xilinx {
 namespace AIE {
 
+/// The column emitted as column 0 in the configuration of the device. A
+/// device with the `aie.relocatable` attribute is configured relative to the
+/// first column of its tiles, so that the runtime can load it at any start
+/// column of the partition; other devices use absolute columns.
+int getColumnOffset(DeviceOp device);
+
 std::string tileLocStr(llvm::StringRef col, llvm::StringRef row);
 
 std::string tileLocStr(int col, int row);
@@ -34,8 +40,18 @@ std::string packetStr(int id, int type);
 void generateXAieDmaSetMultiDimAddr(llvm::raw_ostream &output, int ndims,
                                     llvm::ArrayRef<BDDimLayoutAttr> dims,
                                     int col, int row, int bdNum, int baseAddrA,
-                                    int offsetA, int lenA, int bytesA,
-                                    const char *errorRet);
+                                    int offsetA, int lenA, int bytesA);
+
+void generateXAieDmaSetPadding(llvm::raw_ostream &output,
+                               llvm::ArrayRef<BDPadLayoutAttr> pads, int col,
+                               int row, int bdNum);
+
+/// Collects the buffers named in the body of `core`. Returns false if the
+/// core may access other buffers as well: when there is no core, or when it
+/// runs a given elf or links an object file, either of which can refer to any
+/// buffer by its symbol.
+bool collectCoreBuffers(CoreOp core,
+                        llvm::SmallPtrSetImpl<mlir::Operation *> &buffers);
 
 } // namespace AIE
 } // namespace xilinx
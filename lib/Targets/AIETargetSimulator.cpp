@@ -0,0 +1,647 @@
+//===- AIETargetSimulator.cpp -----------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// A cycle-approximate simulator of the dataflow of a design, to evaluate
+// changes to it in seconds, without the aiesimulator. It runs on the design
+// after aie-objectFifo-stateful-transform, before routing: objectFifos are
+// simulated through the locks and BDs they are lowered to, and the streams
+// between DMA channels are the aie.flow and aie.packet_flow operations.
+//
+// The simulation is at the level of transactions:
+// - a core interprets its body, following scf.for loops with constant
+//   bounds, the then branch of scf.if operations and the bodies of called
+//   functions. A use_lock takes lockCycles cycles, an operation with an
+//   aie.cycles attribute, or calling a function with one, takes that many
+//   cycles and any other operation takes one cycle;
+// - a DMA channel follows its BD chain, acquiring and releasing the locks of
+//   each BD and moving its words when the channels at the other end of its
+//   stream are ready to move theirs, one 32-bit word per cycle. The words
+//   reach a destination hopCycles cycles per switchbox crossed later;
+// - a shim DMA channel without an aie.shim_dma is external memory, always
+//   ready, moving the words of the aiex.ipu.dma_memcpy_nd operations using
+//   it, or without end when no runtime sequence uses it.
+// The simulation ends when the runtime sequence completes or every core
+// finishes, when nothing can move anymore, or after a cycle limit.
+
+#include "aie/Targets/AIETargets.h"
+
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+
+#include <map>
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// The cycles taken by a use_lock in a core.
+static constexpr int64_t lockCycles = 4;
+// The cycles taken by the words of a stream to cross a switchbox.
+static constexpr int64_t hopCycles = 2;
+// The calls followed in a core before counting them as one cycle.
+static constexpr size_t maxCallDepth = 16;
+// The words moved by an external channel without a runtime sequence.
+static constexpr int64_t unbounded = std::numeric_limits<int64_t>::max();
+
+namespace {
+
+struct Agent {
+  std::string name;
+  // The cycle from which the agent can take its next step.
+  int64_t time = 0;
+  int64_t busyCycles = 0;
+  int64_t stallCycles = 0;
+  bool done = false;
+  // The operation the agent waits on, when it can't take its next step.
+  Operation *blockedOn = nullptr;
+};
+
+struct Stream;
+
+struct Channel : Agent {
+  // The BDs of an aie.dma, or the first block of the chain of an
+  // aie.dma_start, followed through its aie.next_bd terminators.
+  SmallVector<Block *> bds;
+  bool followNextBD = false;
+  bool loops = false;
+  int64_t passes = 1;
+  size_t bdIndex = 0;
+  Block::iterator it;
+  Operation *bd = nullptr;
+  // The words left to move in the current BD, or in the transfers of an
+  // external channel.
+  int64_t remaining = 0;
+  bool transferring = false;
+  bool external = false;
+  // The runtime sequence moving the words of an external channel.
+  Operation *sequence = nullptr;
+  int64_t sequenceWords = 0;
+  int64_t words = 0;
+  SmallVector<Stream *> streams;
+};
+
+struct Stream {
+  Channel *source;
+  SmallVector<Channel *> dests;
+  SmallVector<int64_t> latencies;
+};
+
+struct Frame {
+  Block *block;
+  Block::iterator it;
+  int64_t tripsLeft;
+};
+
+struct Core : Agent {
+  SmallVector<Frame> frames;
+};
+
+struct LockState {
+  int64_t value = 0;
+  // AIE1 locks are held by their acquirer until released.
+  bool held = false;
+};
+
+// A DMA channel: column, row, direction and index.
+using ChannelKey = std::tuple<int, int, int, int>;
+
+class Simulator {
+public:
+  Simulator(DeviceOp device)
+      : device(device), index(device),
+        aie2(device.getTargetModel().getTargetArch() != AIEArch::AIE1) {}
+
+  void build();
+  void run(int64_t maxCycles);
+  void report(raw_ostream &output);
+
+private:
+  void addChannels(Operation *dma, StringRef kind);
+  Channel *getChannel(Value tile, DMAChannelDir dir, int channelIndex);
+  void addStream(Channel *source, Channel *dest, Value sourceTile,
+                 Value destTile);
+
+  bool acquire(UseLockOp useLock);
+  void release(UseLockOp useLock);
+  void spend(Agent &agent, int64_t cycles);
+
+  bool step(Core &core);
+  bool step(Channel &channel);
+  bool transfer(Stream &stream);
+  void enter(Channel &channel, Block *block);
+  void endPass(Channel &channel);
+
+  DeviceOp device;
+  DeviceIndex index;
+  bool aie2;
+
+  std::vector<std::unique_ptr<Core>> cores;
+  std::vector<std::unique_ptr<Channel>> channels;
+  std::vector<std::unique_ptr<Stream>> streams;
+  std::map<ChannelKey, Channel *> channelsByKey;
+  DenseMap<Operation *, LockState> locks;
+
+  int64_t now = 0;
+  int64_t lastCycle = 0;
+  bool cycleLimit = false;
+};
+
+} // namespace
+
+static std::string describeTile(TileID tile) {
+  return llvm::formatv("({0}, {1})", tile.col, tile.row).str();
+}
+
+static std::string describeLock(LockOp lock) {
+  if (lock.hasName())
+    return lock.name().str();
+  TileID tile = lock.getTileOp().getTileID();
+  if (lock.getLockID())
+    return llvm::formatv("lock {0} of {1}", lock.getLockIDValue(),
+                         describeTile(tile))
+        .str();
+  return "lock of " + describeTile(tile);
+}
+
+static ChannelKey getKey(TileID tile, DMAChannelDir dir, int channelIndex) {
+  return {tile.col, tile.row, int(dir), channelIndex};
+}
+
+static int64_t getTripCount(scf::ForOp forOp) {
+  auto lb = getConstantIntValue(forOp.getLowerBound());
+  auto ub = getConstantIntValue(forOp.getUpperBound());
+  auto step = getConstantIntValue(forOp.getStep());
+  if (!lb || !ub || !step || *step <= 0)
+    return 1;
+  return *ub > *lb ? llvm::divideCeil(*ub - *lb, *step) : 0;
+}
+
+void Simulator::addChannels(Operation *dma, StringRef kind) {
+  TileID tile = cast<TileElement>(dma).getTileID();
+  auto add = [&](DMAChannelDir dir, int channelIndex) {
+    auto channel = std::make_unique<Channel>();
+    channel->name = llvm::formatv("{0} {1} {2}{3}", kind, describeTile(tile),
+                                  stringifyDMAChannelDir(dir), channelIndex);
+    channelsByKey[getKey(tile, dir, channelIndex)] = channel.get();
+    channels.push_back(std::move(channel));
+    return channels.back().get();
+  };
+  for (Block &block : dma->getRegion(0)) {
+    for (auto start : block.getOps<DMAStartOp>()) {
+      if (start.getDest()->getOps<DMABDOp>().empty())
+        continue;
+      Channel *channel =
+          add(start.getChannelDir(), int(start.getChannelIndex()));
+      channel->bds.push_back(start.getDest());
+      channel->followNextBD = true;
+      channel->passes = start.getRepeatCount();
+    }
+    for (auto dmaOp : block.getOps<DMAOp>()) {
+      if (dmaOp.getBds().empty())
+        continue;
+      Channel *channel =
+          add(dmaOp.getChannelDir(), int(dmaOp.getChannelIndex()));
+      for (Region &bd : dmaOp.getBds())
+        channel->bds.push_back(&bd.front());
+      channel->loops = dmaOp.getLoop();
+      channel->passes = dmaOp.getRepeatCount();
+    }
+  }
+}
+
+// The channel of a flow endpoint. A shim channel without BDs is external
+// memory; other channels without BDs are left out of the simulation.
+Channel *Simulator::getChannel(Value tile, DMAChannelDir dir,
+                               int channelIndex) {
+  auto tileOp = cast<TileOp>(tile.getDefiningOp());
+  ChannelKey key = getKey(tileOp.getTileID(), dir, channelIndex);
+  if (Channel *channel = channelsByKey[key])
+    return channel;
+  if (!tileOp.isShimTile())
+    return nullptr;
+  auto channel = std::make_unique<Channel>();
+  channel->name =
+      llvm::formatv("external {0} {1}{2}", describeTile(tileOp.getTileID()),
+                    stringifyDMAChannelDir(dir), channelIndex);
+  channel->external = true;
+  channel->transferring = true;
+  channel->remaining = unbounded;
+  channelsByKey[key] = channel.get();
+  channels.push_back(std::move(channel));
+  return channels.back().get();
+}
+
+void Simulator::addStream(Channel *source, Channel *dest, Value sourceTile,
+                          Value destTile) {
+  if (!source || !dest || (source->external && dest->external))
+    return;
+  Stream *stream = nullptr;
+  for (Stream *s : source->streams)
+    if (s->source == source)
+      stream = s;
+  if (!stream) {
+    streams.push_back(std::make_unique<Stream>());
+    stream = streams.back().get();
+    stream->source = source;
+    source->streams.push_back(stream);
+  }
+  if (llvm::is_contained(stream->dests, dest))
+    return;
+  TileID from = cast<TileOp>(sourceTile.getDefiningOp()).getTileID();
+  TileID to = cast<TileOp>(destTile.getDefiningOp()).getTileID();
+  int64_t hops = std::abs(from.col - to.col) + std::abs(from.row - to.row) + 1;
+  stream->dests.push_back(dest);
+  stream->latencies.push_back(hops * hopCycles);
+  dest->streams.push_back(stream);
+}
+
+void Simulator::build() {
+  for (auto lock : device.getOps<LockOp>())
+    locks[lock].value = lock.getInit().value_or(0);
+
+  for (auto core : device.getOps<CoreOp>()) {
+    auto agent = std::make_unique<Core>();
+    agent->name = "core " + describeTile(core.getTileID());
+    Block &body = core.getBody().front();
+    agent->frames.push_back({&body, body.begin(), 0});
+    cores.push_back(std::move(agent));
+  }
+
+  for (auto mem : device.getOps<MemOp>())
+    addChannels(mem, "mem");
+  for (auto memTile : device.getOps<MemTileDMAOp>())
+    addChannels(memTile, "memtile");
+  for (auto shim : device.getOps<ShimDMAOp>())
+    addChannels(shim, "shim");
+  for (auto &channel : channels)
+    enter(*channel, channel->bds.front());
+
+  for (auto flow : device.getOps<FlowOp>()) {
+    if (flow.getSourceBundle() != WireBundle::DMA ||
+        flow.getDestBundle() != WireBundle::DMA)
+      continue;
+    addStream(getChannel(flow.getSource(), DMAChannelDir::MM2S,
+                         flow.getSourceChannel()),
+              getChannel(flow.getDest(), DMAChannelDir::S2MM,
+                         flow.getDestChannel()),
+              flow.getSource(), flow.getDest());
+  }
+  for (auto packetFlow : device.getOps<PacketFlowOp>()) {
+    auto sources = packetFlow.getPorts().getOps<PacketSourceOp>();
+    if (sources.empty() || (*sources.begin()).getBundle() != WireBundle::DMA)
+      continue;
+    PacketSourceOp source = *sources.begin();
+    for (auto dest : packetFlow.getPorts().getOps<PacketDestOp>())
+      if (dest.getBundle() == WireBundle::DMA)
+        addStream(getChannel(source.getTile(), DMAChannelDir::MM2S,
+                             source.channelIndex()),
+                  getChannel(dest.getTile(), DMAChannelDir::S2MM,
+                             dest.channelIndex()),
+                  source.getTile(), dest.getTile());
+  }
+
+  // The words moved by the runtime sequence through each external channel.
+  device.walk([&](AIEX::IpuDmaMemcpyNdOp dmaMemcpy) {
+    auto allocation = index.getShimDMAAllocation(dmaMemcpy.getMetadata());
+    if (!allocation)
+      return;
+    ChannelKey key = getKey({int(allocation->getCol()), 0},
+                            allocation->getChannelDir(),
+                            int(allocation->getChannelIndex()));
+    Channel *channel = channelsByKey[key];
+    if (!channel || !channel->external)
+      return;
+    int64_t elements = 1;
+    for (OpFoldResult size : dmaMemcpy.getMixedSizes())
+      elements *= getConstantIntValue(size).value_or(1);
+    int64_t bits =
+        elements * dmaMemcpy.getMemref().getType().getElementTypeBitWidth();
+    channel->sequence = *allocation;
+    channel->sequenceWords += llvm::divideCeil(bits, 32);
+    channel->remaining = channel->sequenceWords;
+  });
+}
+
+// AIE1 locks are acquired and released with a value; AIE2 locks are
+// semaphores, decremented by acquires and incremented by releases.
+bool Simulator::acquire(UseLockOp useLock) {
+  LockState &lock = locks[useLock.getLockOp()];
+  int64_t value = useLock.getLockValue();
+  if (!aie2) {
+    if (lock.held || lock.value != value)
+      return false;
+    lock.held = true;
+    return true;
+  }
+  if (useLock.acquireGE() ? lock.value < value : lock.value != value)
+    return false;
+  lock.value -= value;
+  return true;
+}
+
+void Simulator::release(UseLockOp useLock) {
+  LockState &lock = locks[useLock.getLockOp()];
+  if (!aie2) {
+    lock.held = false;
+    lock.value = useLock.getLockValue();
+    return;
+  }
+  lock.value += useLock.getLockValue();
+}
+
+// Starts the next step of an agent, taking the given cycles. The cycles
+// since the agent could have taken it are stalls.
+void Simulator::spend(Agent &agent, int64_t cycles) {
+  agent.stallCycles += now - agent.time;
+  agent.time = now + cycles;
+  agent.busyCycles += cycles;
+  agent.blockedOn = nullptr;
+  lastCycle = std::max(lastCycle, agent.time);
+}
+
+bool Simulator::step(Core &core) {
+  bool progress = false;
+  while (!core.done && core.time <= now) {
+    Frame &frame = core.frames.back();
+    Operation &op = *frame.it;
+    if (auto useLock = dyn_cast<UseLockOp>(op)) {
+      if (useLock.release()) {
+        release(useLock);
+      } else if (!acquire(useLock)) {
+        core.blockedOn = &op;
+        return progress;
+      }
+      ++frame.it;
+      spend(core, lockCycles);
+      progress = true;
+      continue;
+    }
+
+    progress = true;
+    if (op.hasTrait<OpTrait::IsTerminator>()) {
+      if (frame.tripsLeft > 0) {
+        frame.tripsLeft--;
+        frame.it = frame.block->begin();
+        continue;
+      }
+      core.frames.pop_back();
+      core.done = core.frames.empty();
+      continue;
+    }
+
+    ++frame.it;
+    if (auto cycles = op.getAttrOfType<IntegerAttr>("aie.cycles")) {
+      spend(core, cycles.getInt());
+    } else if (auto forOp = dyn_cast<scf::ForOp>(op)) {
+      if (int64_t trips = getTripCount(forOp))
+        core.frames.push_back(
+            {forOp.getBody(), forOp.getBody()->begin(), trips - 1});
+    } else if (auto ifOp = dyn_cast<scf::IfOp>(op)) {
+      Block *then = ifOp.thenBlock();
+      core.frames.push_back({then, then->begin(), 0});
+    } else if (auto call = dyn_cast<func::CallOp>(op)) {
+      auto callee = SymbolTable::lookupNearestSymbolFrom<func::FuncOp>(
+          call, call.getCalleeAttr());
+      IntegerAttr cycles;
+      if (callee)
+        cycles = callee->getAttrOfType<IntegerAttr>("aie.cycles");
+      if (cycles)
+        spend(core, cycles.getInt());
+      else if (callee && !callee.isExternal() &&
+               core.frames.size() < maxCallDepth)
+        core.frames.push_back({&callee.front(), callee.front().begin(), 0});
+      else
+        spend(core, 1);
+    } else if (!isa<arith::ConstantOp>(op)) {
+      spend(core, 1);
+    }
+  }
+  return progress;
+}
+
+void Simulator::enter(Channel &channel, Block *block) {
+  if (!block || block->getOps<DMABDOp>().empty())
+    return endPass(channel);
+  channel.it = block->begin();
+}
+
+void Simulator::endPass(Channel &channel) {
+  if (!channel.loops && --channel.passes <= 0) {
+    channel.done = true;
+    return;
+  }
+  channel.bdIndex = 0;
+  enter(channel, channel.bds.front());
+}
+
+// Moves the words of a stream, if its source and all its destinations are
+// ready, up to the end of the first BD to complete.
+bool Simulator::transfer(Stream &stream) {
+  SmallVector<Channel *> ends{stream.source};
+  ends.append(stream.dests);
+  int64_t words = unbounded;
+  for (Channel *end : ends) {
+    if (end->done || !end->transferring || end->time > now)
+      return false;
+    words = std::min(words, end->remaining);
+  }
+  for (auto [i, end] : llvm::enumerate(ends)) {
+    spend(*end, words + (i ? stream.latencies[i - 1] : 0));
+    end->words += words;
+    if (end->remaining == unbounded)
+      continue;
+    end->remaining -= words;
+    if (end->remaining)
+      continue;
+    end->transferring = false;
+    end->done = end->external;
+  }
+  return true;
+}
+
+bool Simulator::step(Channel &channel) {
+  if (channel.external)
+    return false;
+  bool progress = false;
+  while (!channel.done && channel.time <= now) {
+    if (channel.transferring) {
+      // A channel without a stream moves its words on its own.
+      if (channel.streams.empty()) {
+        spend(channel, channel.remaining);
+        channel.words += channel.remaining;
+        channel.remaining = 0;
+        channel.transferring = false;
+      } else if (!llvm::any_of(channel.streams,
+                               [&](Stream *s) { return transfer(*s); })) {
+        channel.blockedOn = channel.bd;
+        return progress;
+      }
+      progress = true;
+      continue;
+    }
+
+    Operation &op = *channel.it;
+    if (auto useLock = dyn_cast<UseLockOp>(op)) {
+      if (useLock.release()) {
+        release(useLock);
+      } else if (!acquire(useLock)) {
+        channel.blockedOn = &op;
+        return progress;
+      }
+      ++channel.it;
+      spend(channel, 0);
+    } else if (auto bd = dyn_cast<DMABDOp>(op)) {
+      auto type = cast<MemRefType>(bd.getBuffer().getType());
+      channel.remaining = llvm::divideCeil(
+          int64_t(bd.getLenValue()) * type.getElementTypeBitWidth(), 32);
+      channel.transferring = channel.remaining > 0;
+      channel.bd = bd;
+      ++channel.it;
+      spend(channel, 0);
+    } else if (auto next = dyn_cast<NextBDOp>(op); next && channel.followNextBD) {
+      enter(channel, next.getDest());
+    } else if (op.hasTrait<OpTrait::IsTerminator>()) {
+      if (channel.followNextBD || ++channel.bdIndex == channel.bds.size())
+        endPass(channel);
+      else
+        enter(channel, channel.bds[channel.bdIndex]);
+    } else {
+      ++channel.it;
+    }
+    progress = true;
+  }
+  return progress;
+}
+
+void Simulator::run(int64_t maxCycles) {
+  while (true) {
+    bool progress = true;
+    while (progress) {
+      progress = false;
+      for (auto &core : cores)
+        progress |= step(*core);
+      for (auto &channel : channels)
+        progress |= step(*channel);
+    }
+
+    // Move to the next cycle at which an agent completes a step.
+    std::optional<int64_t> next;
+    auto visit = [&](Agent &agent) {
+      if (!agent.done && agent.time > now)
+        next = std::min(next.value_or(agent.time), agent.time);
+    };
+    llvm::for_each(cores, [&](auto &core) { visit(*core); });
+    llvm::for_each(channels, [&](auto &channel) { visit(*channel); });
+    if (!next)
+      break;
+    if (*next > maxCycles) {
+      now = maxCycles;
+      cycleLimit = true;
+      break;
+    }
+    now = *next;
+  }
+
+  // Agents waiting at the end stall until then.
+  auto finish = [&](Agent &agent) {
+    if (!agent.done && agent.time < now)
+      agent.stallCycles += now - agent.time;
+  };
+  llvm::for_each(cores, [&](auto &core) { finish(*core); });
+  llvm::for_each(channels, [&](auto &channel) { finish(*channel); });
+}
+
+void Simulator::report(raw_ostream &output) {
+  // The runtime sequence completes when its external channels are done.
+  bool hasSequence = false, sequenceDone = true;
+  for (auto &channel : channels)
+    if (channel->sequence) {
+      hasSequence = true;
+      sequenceDone &= channel->done;
+    }
+  bool coresDone =
+      llvm::all_of(cores, [](auto &core) { return core->done; });
+  StringRef status = "finished";
+  if (cycleLimit)
+    status = "cycle_limit";
+  else if (hasSequence ? !sequenceDone : !coresDone)
+    status = "deadlock";
+
+  if (status == "deadlock") {
+    auto warn = [&](Agent &agent) {
+      if (agent.done || !agent.blockedOn)
+        return;
+      InFlightDiagnostic diag = agent.blockedOn->emitWarning()
+                                << agent.name << " waits forever on ";
+      if (auto useLock = dyn_cast<UseLockOp>(agent.blockedOn))
+        diag << describeLock(useLock.getLockOp());
+      else
+        diag << "its stream";
+    };
+    llvm::for_each(cores, [&](auto &core) { warn(*core); });
+    for (auto &channel : channels) {
+      warn(*channel);
+      if (channel->sequence && !channel->done)
+        channel->sequence->emitWarning()
+            << channel->name << " moved "
+            << channel->sequenceWords - channel->remaining << " of the "
+            << channel->sequenceWords << " words of the runtime sequence";
+    }
+  }
+
+  auto toJSON = [](Agent &agent) {
+    return llvm::json::Object{
+        {"name", agent.name},
+        {"busy_cycles", agent.busyCycles},
+        {"stall_cycles", agent.stallCycles},
+        {"finished", agent.done},
+    };
+  };
+  llvm::json::Array coresJSON;
+  for (auto &core : cores)
+    coresJSON.push_back(toJSON(*core));
+  llvm::json::Array channelsJSON;
+  for (auto &channel : channels) {
+    llvm::json::Object channelJSON = toJSON(*channel);
+    channelJSON["words"] = channel->words;
+    channelsJSON.push_back(std::move(channelJSON));
+  }
+  llvm::json::Object deviceJSON{
+      {"status", status},
+      {"cycles", cycleLimit ? now : lastCycle},
+      {"cores", std::move(coresJSON)},
+      {"channels", std::move(channelsJSON)},
+  };
+  output << llvm::formatv("{0:2}", llvm::json::Value(std::move(deviceJSON)))
+         << "\n";
+}
+
+LogicalResult xilinx::AIE::AIETranslateToSimulation(ModuleOp module,
+                                                    raw_ostream &output,
+                                                    int64_t maxCycles) {
+  if (module.getOps<DeviceOp>().empty())
+    return module.emitOpError("expected AIE.device operation at toplevel");
+  for (auto device : module.getOps<DeviceOp>()) {
+    Simulator simulator(device);
+    simulator.build();
+    simulator.run(maxCycles);
+    simulator.report(output);
+  }
+  return success();
+}
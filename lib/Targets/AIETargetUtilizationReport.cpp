@@ -0,0 +1,225 @@
+//===- AIETargetUtilizationReport.cpp ---------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Reports how much of the resources of each tile a design uses, to see the
+// headroom left when a design stops fitting or routing. For each tile used by
+// the design, the report gives its data memory (buffers and the stack of its
+// core), locks, BDs and DMA channels, and the ports of its switchbox used by
+// the aie.connect and aie.masterset operations of a routed design, against
+// what the target model provides. The stream channels between neighbouring
+// switchboxes are then ranked by occupancy, the most congested first.
+
+#include "aie/Targets/AIETargets.h"
+
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Number of stream channels listed as the most congested.
+static constexpr size_t congestedChannels = 10;
+
+namespace {
+
+struct Usage {
+  int64_t used = 0;
+  int64_t available = 0;
+
+  llvm::json::Object toJSON() const {
+    return llvm::json::Object{
+        {"used", used},
+        {"available", available},
+        {"percent", available ? used * 100 / available : 0},
+    };
+  }
+};
+
+struct StreamChannel {
+  TileID tile;
+  WireBundle dir;
+  Usage usage;
+};
+
+} // namespace
+
+static std::string describeTile(TileID tile) {
+  return llvm::formatv("({0}, {1})", tile.col, tile.row).str();
+}
+
+static StringRef describeKind(TileOp tile) {
+  if (tile.isShimTile())
+    return "shim";
+  if (tile.isMemTile())
+    return "memtile";
+  return "core";
+}
+
+static void reportDevice(DeviceOp device, raw_ostream &output) {
+  const auto &targetModel = device.getTargetModel();
+  DeviceIndex index(device);
+
+  DenseMap<Operation *, CoreOp> cores;
+  for (auto core : device.getOps<CoreOp>())
+    cores[core.getTileOp()] = core;
+
+  // The source and destination ports used in each switchbox.
+  DenseMap<Operation *, llvm::SmallDenseSet<Port, 16>> usedDests;
+  DenseMap<Operation *, llvm::SmallDenseSet<Port, 16>> usedSources;
+  for (auto switchbox : device.getOps<SwitchboxOp>()) {
+    Operation *tile = switchbox.getTileOp();
+    for (auto connect : switchbox.getOps<ConnectOp>()) {
+      usedSources[tile].insert(
+          {connect.getSourceBundle(), int(connect.getSourceChannel())});
+      usedDests[tile].insert(
+          {connect.getDestBundle(), int(connect.getDestChannel())});
+    }
+    for (auto masterSet : switchbox.getOps<MasterSetOp>())
+      usedDests[tile].insert(
+          {masterSet.getDestBundle(), int(masterSet.getDestChannel())});
+    for (auto rules : switchbox.getOps<PacketRulesOp>())
+      usedSources[tile].insert(rules.sourcePort());
+  }
+
+  auto countPorts = [](const llvm::SmallDenseSet<Port, 16> &ports,
+                       WireBundle bundle) {
+    return int64_t(llvm::count_if(
+        ports, [&](const Port &port) { return port.bundle == bundle; }));
+  };
+
+  llvm::json::Array tilesJSON;
+  std::vector<StreamChannel> streams;
+  for (auto tile : device.getOps<TileOp>()) {
+    int col = tile.colIndex(), row = tile.rowIndex();
+
+    Usage memory;
+    if (!tile.isShimTile()) {
+      memory.available = tile.isMemTile() ? targetModel.getMemTileSize()
+                                          : targetModel.getLocalMemorySize();
+      for (auto buffer : index.getBuffers(tile))
+        memory.used += buffer.getAllocationSize();
+      if (CoreOp core = cores.lookup(tile))
+        memory.used += core.getStackSize();
+    }
+
+    Usage locks{int64_t(index.getLocks(tile).size()),
+                targetModel.getNumLocks(col, row)};
+
+    Usage bds{0, targetModel.getNumBDs(col, row)};
+    Usage s2mm, mm2s;
+    for (Operation *dma : index.getDMAs(tile)) {
+      dma->walk([&](DMABDOp) { bds.used++; });
+      dma->walk([&](Operation *op) {
+        std::optional<DMAChannelDir> dir;
+        if (auto start = dyn_cast<DMAStartOp>(op))
+          dir = start.getChannelDir();
+        else if (auto dmaOp = dyn_cast<DMAOp>(op))
+          dir = dmaOp.getChannelDir();
+        if (dir)
+          (*dir == DMAChannelDir::S2MM ? s2mm : mm2s).used++;
+      });
+    }
+    if (tile.isShimNOCTile()) {
+      s2mm.available =
+          targetModel.getNumDestShimMuxConnections(col, row, WireBundle::DMA);
+      mm2s.available = targetModel.getNumSourceShimMuxConnections(
+          col, row, WireBundle::DMA);
+    } else {
+      s2mm.available =
+          targetModel.getNumDestSwitchboxConnections(col, row, WireBundle::DMA);
+      mm2s.available = targetModel.getNumSourceSwitchboxConnections(
+          col, row, WireBundle::DMA);
+    }
+
+    const auto &dests = usedDests[tile];
+    const auto &sources = usedSources[tile];
+    Usage destPorts{int64_t(dests.size()), 0};
+    Usage sourcePorts{int64_t(sources.size()), 0};
+    for (WireBundle bundle :
+         {WireBundle::Core, WireBundle::DMA, WireBundle::FIFO,
+          WireBundle::South, WireBundle::West, WireBundle::North,
+          WireBundle::East, WireBundle::Trace}) {
+      destPorts.available +=
+          targetModel.getNumDestSwitchboxConnections(col, row, bundle);
+      sourcePorts.available +=
+          targetModel.getNumSourceSwitchboxConnections(col, row, bundle);
+    }
+    for (WireBundle dir : {WireBundle::South, WireBundle::West,
+                           WireBundle::North, WireBundle::East}) {
+      int64_t available =
+          targetModel.getNumDestSwitchboxConnections(col, row, dir);
+      if (available)
+        streams.push_back(
+            {tile.getTileID(), dir, {countPorts(dests, dir), available}});
+    }
+
+    llvm::json::Object tileJSON{
+        {"tile", describeTile(tile.getTileID())},
+        {"kind", describeKind(tile)},
+        {"core", cores.contains(tile)},
+        {"locks", locks.toJSON()},
+        {"bds", bds.toJSON()},
+        {"s2mm_channels", s2mm.toJSON()},
+        {"mm2s_channels", mm2s.toJSON()},
+        {"switchbox_sources", sourcePorts.toJSON()},
+        {"switchbox_dests", destPorts.toJSON()},
+    };
+    if (!tile.isShimTile())
+      tileJSON["memory_bytes"] = memory.toJSON();
+    tilesJSON.push_back(std::move(tileJSON));
+
+    std::pair<StringRef, Usage> checks[] = {{"bytes of memory", memory},
+                                            {"locks", locks},
+                                            {"BDs", bds},
+                                            {"S2MM channels", s2mm},
+                                            {"MM2S channels", mm2s}};
+    for (auto [name, usage] : checks)
+      if (usage.available && usage.used > usage.available)
+        tile.emitWarning() << "uses " << usage.used << " " << name
+                           << ", more than the " << usage.available
+                           << " of the tile";
+  }
+
+  // The most used channels first, then by tile for a stable order.
+  llvm::stable_sort(streams, [](const StreamChannel &a,
+                                const StreamChannel &b) {
+    return a.usage.used * b.usage.available > b.usage.used * a.usage.available;
+  });
+  llvm::json::Array congestedJSON;
+  for (auto &stream : ArrayRef(streams).take_front(congestedChannels)) {
+    if (!stream.usage.used)
+      break;
+    llvm::json::Object streamJSON = stream.usage.toJSON();
+    streamJSON["tile"] = describeTile(stream.tile);
+    streamJSON["direction"] = stringifyWireBundle(stream.dir);
+    congestedJSON.push_back(std::move(streamJSON));
+  }
+
+  llvm::json::Object deviceJSON{
+      {"tiles", std::move(tilesJSON)},
+      {"cores", int64_t(cores.size())},
+      {"congested_channels", std::move(congestedJSON)},
+  };
+  output << llvm::formatv("{0:2}", llvm::json::Value(std::move(deviceJSON)))
+         << "\n";
+}
+
+LogicalResult xilinx::AIE::AIETranslateToUtilizationReport(ModuleOp module,
+                                                           raw_ostream &output) {
+  if (module.getOps<DeviceOp>().empty())
+    return module.emitOpError("expected AIE.device operation at toplevel");
+  for (auto device : module.getOps<DeviceOp>())
+    reportDevice(device, output);
+  return success();
+}
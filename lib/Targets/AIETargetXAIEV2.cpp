@@ -50,14 +50,20 @@ const char *xaie_cpp_file_header = R"code(
   } \
 } while(0)
 
-static XAie_DmaDimDesc *__mlir_aie_alloc_dim_desc(size_t ndims) {
-  XAie_DmaDimDesc *ret = NULL;
-  ret = (XAie_DmaDimDesc *)calloc(sizeof(XAie_DmaDimDesc), ndims);
-  if(NULL == ret) {
-    __mlir_aie_verbose(fprintf(stderr, "Allocating DmaDimDesc failed.\n"));
-  }
-  return ret;
-}
+// The circuit-switched connections of the stream switches and the initial
+// values of the locks are emitted as static tables, applied by a single loop.
+struct __mlir_aie_circuit {
+  u8 Col, Row;
+  StrmSwPortType Slave;
+  u8 SlaveCh;
+  StrmSwPortType Master;
+  u8 MasterCh;
+};
+
+struct __mlir_aie_lock_init {
+  XAie_LocType Loc;
+  XAie_Lock Lock;
+};
 
 )code";
 
@@ -98,6 +104,12 @@ mlir::LogicalResult generateDMAConfig(OpType memOp, raw_ostream &output,
     bool hasB = false;
     int ndims = 0;
     ArrayRef<BDDimLayoutAttr> dims;
+    ArrayRef<BDPadLayoutAttr> pads;
+    bool compression = false;
+    // The AXI settings of shim DMA BDs, 4 beats of 16 bytes by default.
+    int burstLength = 64;
+    int axCache = 0;
+    int axQos = 0;
     //      StringRef FifoMode = disable; // FIXME: when to enable FIFO mode?
     for (auto op : block.template getOps<DMABDOp>()) {
       foundBd = true;
@@ -130,6 +142,12 @@ mlir::LogicalResult generateDMAConfig(OpType memOp, raw_ostream &output,
         dims = *op.getDimensions();
         ndims = dims.size();
       }
+      if (op.getPadDimensions())
+        pads = *op.getPadDimensions();
+      compression = op.getCompression();
+      burstLength = op.getBurstLength().value_or(64);
+      axCache = op.getAxCache().value_or(0);
+      axQos = op.getAxQos().value_or(0);
     }
 
     if (0 != ndims && AIEArch::AIE2 != targetModel.getTargetArch())
@@ -218,9 +236,9 @@ mlir::LogicalResult generateDMAConfig(OpType memOp, raw_ostream &output,
           output << "__mlir_aie_try(XAie_DmaSetAxi("
                  << tileDMAInstRefStr(col, row, bdNum) << ", "
                  << "/* smid */ 0, "
-                 << "/* burstlen */ 4, "
-                 << "/* QoS */ 0, "
-                 << "/* Cache */ 0, "
+                 << "/* burstlen */ " << burstLength / 16 << ", "
+                 << "/* QoS */ " << axQos << ", "
+                 << "/* Cache */ " << axCache << ", "
                  << "/* Secure */ " << enable << "));\n";
         } else
           output << "__mlir_aie_try(XAie_DmaSetAddrLen("
@@ -229,7 +247,14 @@ mlir::LogicalResult generateDMAConfig(OpType memOp, raw_ostream &output,
                  << " /* len */ " << lenA << " * " << bytesA << "));\n";
       } else
         generateXAieDmaSetMultiDimAddr(output, ndims, dims, col, row, bdNum,
-                                       BaseAddrA, offsetA, lenA, bytesA, "1");
+                                       BaseAddrA, offsetA, lenA, bytesA);
+
+      if (!pads.empty())
+        generateXAieDmaSetPadding(output, pads, col, row, bdNum);
+
+      if (compression)
+        output << "__mlir_aie_try(XAie_DmaEnableCompression("
+               << tileDMAInstRefStr(col, row, bdNum) << "));\n";
 
       if (block.getNumSuccessors() > 0) {
         Block *nextBlock = block.getSuccessors()[0]; // should have only one
@@ -416,20 +441,79 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
   // mlir_aie_start_cores
   //---------------------------------------------------------------------------
   output << "int mlir_aie_start_cores(" << ctx_p << ") {\n";
-  // Start execution of all the cores.
-  for (auto tileOp : targetOp.getOps<TileOp>()) {
-    int col = tileOp.colIndex();
-    int row = tileOp.rowIndex();
-    if (!tileOp.isShimTile() && !tileOp.isMemTile()) {
-      output << "__mlir_aie_try(XAie_CoreUnreset(" << deviceInstRef << ", "
-             << tileLocStr(col, row) << "));\n";
-      output << "__mlir_aie_try(XAie_CoreEnable(" << deviceInstRef << ", "
-             << tileLocStr(col, row) << "));\n";
+  // Start execution of all the cores. All of them are taken out of reset
+  // before the first is enabled, so that the enables, a single register write
+  // each, follow each other as closely as possible.
+  SmallVector<TileOp> coreTiles;
+  for (auto tileOp : targetOp.getOps<TileOp>())
+    if (!tileOp.isShimTile() && !tileOp.isMemTile())
+      coreTiles.push_back(tileOp);
+  if (!coreTiles.empty()) {
+    output << "static const XAie_LocType __mlir_aie_cores[] = {\n";
+    for (TileOp tileOp : coreTiles)
+      output << "  " << tileLocStr(tileOp.colIndex(), tileOp.rowIndex())
+             << ",\n";
+    output << "};\n";
+    output << "for (const XAie_LocType &Loc : __mlir_aie_cores)\n"
+           << "  __mlir_aie_try(XAie_CoreUnreset(" << deviceInstRef
+           << ", Loc));\n";
+    if (auto channel = targetOp.getCoreStartBroadcast()) {
+      // Arm all the cores, and the reset of their timers, on the broadcast
+      // event, then fire it once from the shim tile of the leftmost core
+      // column, so that the cores start in lockstep.
+      std::string event =
+          "XAIE_EVENT_BROADCAST_" + std::to_string(*channel) + "_CORE";
+      int firstCol = coreTiles.front().colIndex();
+      for (TileOp tileOp : coreTiles)
+        firstCol = std::min(firstCol, tileOp.colIndex());
+      output << "for (const XAie_LocType &Loc : __mlir_aie_cores) {\n"
+             << "  __mlir_aie_try(XAie_CoreConfigureEnableEvent("
+             << deviceInstRef << ", Loc, " << event << "));\n"
+             << "  __mlir_aie_try(XAie_SetTimerResetEvent(" << deviceInstRef
+             << ", Loc, XAIE_CORE_MOD, " << event
+             << ", XAIE_RESETDISABLE));\n"
+             << "}\n";
+      output << "__mlir_aie_try(XAie_EventBroadcast(" << deviceInstRef << ", "
+             << tileLocStr(firstCol, 0) << ", XAIE_PL_MOD, " << *channel
+             << ", XAIE_EVENT_USER_EVENT_0_PL));\n";
+      output << "__mlir_aie_try(XAie_EventGenerate(" << deviceInstRef << ", "
+             << tileLocStr(firstCol, 0)
+             << ", XAIE_PL_MOD, XAIE_EVENT_USER_EVENT_0_PL));\n";
+    } else {
+      output << "for (const XAie_LocType &Loc : __mlir_aie_cores)\n"
+             << "  __mlir_aie_try(XAie_CoreEnable(" << deviceInstRef
+             << ", Loc));\n";
     }
   }
   output << "return XAIE_OK;\n";
   output << "} // mlir_aie_start_cores\n\n";
 
+  //---------------------------------------------------------------------------
+  // mlir_aie_clear_tiles
+  //---------------------------------------------------------------------------
+  output << "int mlir_aie_clear_tiles(" << ctx_p << ") {\n";
+  // Clear the configuration of the tiles this design uses, column by column,
+  // so that the array can be reused by the next design without clearing every
+  // tile. The register map of the clear functions is the one of AIE1.
+  if (arch == AIEArch::AIE1) {
+    auto usedTiles = llvm::to_vector(targetOp.getOps<TileOp>());
+    llvm::sort(usedTiles, [](TileOp a, TileOp b) {
+      return a.getTileID() < b.getTileID();
+    });
+    for (TileOp tileOp : usedTiles) {
+      int col = tileOp.colIndex();
+      int row = tileOp.rowIndex();
+      if (tileOp.isShimTile())
+        output << "mlir_aie_clear_shim_config(ctx, " << col << ", " << row
+               << ");\n";
+      else
+        output << "mlir_aie_clear_config(ctx, " << col << ", " << row
+               << ");\n";
+    }
+  }
+  output << "return XAIE_OK;\n";
+  output << "} // mlir_aie_clear_tiles\n\n";
+
   //---------------------------------------------------------------------------
   // mlir_aie_configure_dmas
   //---------------------------------------------------------------------------
@@ -590,17 +674,24 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
   //---------------------------------------------------------------------------
   output << "int mlir_aie_initialize_locks(" << ctx_p << ") {\n";
   // Lock configuration
+  SmallVector<LockOp> initializedLocks;
   targetOp.walk<WalkOrder::PreOrder>([&](LockOp lock) {
-    TileOp tile = lock.getTileOp();
-    int col = tile.colIndex();
-    int row = tile.rowIndex();
-    int lockID = lock.getLockIDValue();
-    auto init = lock.getInit();
-    if (init)
-      output << "__mlir_aie_try(XAie_LockSetValue(" << deviceInstRef << ", "
-             << tileLocStr(col, row) << ", "
-             << "XAie_LockInit(" << lockID << ", " << *init << ")));\n";
+    if (lock.getInit())
+      initializedLocks.push_back(lock);
   });
+  if (!initializedLocks.empty()) {
+    output << "static const __mlir_aie_lock_init __mlir_aie_locks[] = {\n";
+    for (LockOp lock : initializedLocks) {
+      TileOp tile = lock.getTileOp();
+      output << "  {" << tileLocStr(tile.colIndex(), tile.rowIndex()) << ", "
+             << "XAie_LockInit(" << lock.getLockIDValue() << ", "
+             << *lock.getInit() << ")},\n";
+    }
+    output << "};\n";
+    output << "for (const __mlir_aie_lock_init &L : __mlir_aie_locks)\n"
+           << "  __mlir_aie_try(XAie_LockSetValue(" << deviceInstRef
+           << ", L.Loc, L.Lock));\n";
+  }
   output << "return XAIE_OK;\n";
   output << "} // mlir_aie_initialize_locks\n";
 
@@ -610,18 +701,44 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
   output << "int mlir_aie_configure_switchboxes(" << ctx_p << ") {\n";
   output << "  int x, y;\n";
 
+  // The circuit-switched connections of the switchboxes of fixed tiles.
+  std::string circuits;
+  llvm::raw_string_ostream circuitsStream(circuits);
+  auto addCircuits = [&](Block &b, int col, int row) {
+    for (auto connectOp : b.getOps<ConnectOp>())
+      circuitsStream << "  {" << col << ", " << row << ", "
+                     << stringifyWireBundle(connectOp.getSourceBundle()).upper()
+                     << ", " << connectOp.sourceIndex() << ", "
+                     << stringifyWireBundle(connectOp.getDestBundle()).upper()
+                     << ", " << connectOp.destIndex() << "},\n";
+  };
+  for (auto switchboxOp : targetOp.getOps<SwitchboxOp>())
+    if (isa<TileOp>(switchboxOp.getTile().getDefiningOp()))
+      addCircuits(switchboxOp.getConnections().front(), switchboxOp.colIndex(),
+                  switchboxOp.rowIndex());
+  for (auto switchboxOp : targetOp.getOps<ShimSwitchboxOp>())
+    addCircuits(switchboxOp.getConnections().front(), switchboxOp.getCol(), 0);
+  if (!circuitsStream.str().empty()) {
+    output << "static const __mlir_aie_circuit __mlir_aie_circuits[] = {\n"
+           << circuits << "};\n";
+    output << "for (const __mlir_aie_circuit &C : __mlir_aie_circuits)\n"
+           << "  __mlir_aie_try(XAie_StrmConnCctEnable(" << deviceInstRef
+           << ", XAie_TileLoc(C.Col, C.Row), C.Slave, C.SlaveCh, C.Master, "
+              "C.MasterCh));\n";
+  }
+
   // StreamSwitch (switchbox) configuration
   for (auto switchboxOp : targetOp.getOps<SwitchboxOp>()) {
     Region &r = switchboxOp.getConnections();
     Block &b = r.front();
-    bool isEmpty = b.getOps<ConnectOp>().empty() &&
-                   b.getOps<MasterSetOp>().empty() &&
-                   b.getOps<PacketRulesOp>().empty();
     bool isParam = false;
 
     if (isa<TileOp>(switchboxOp.getTile().getDefiningOp())) {
       int col = switchboxOp.colIndex();
       int row = switchboxOp.rowIndex();
+      // The circuits of the switchboxes of fixed tiles are in the table.
+      bool isEmpty = b.getOps<MasterSetOp>().empty() &&
+                     b.getOps<PacketRulesOp>().empty();
       if (!isEmpty) {
         output << "// Core Stream Switch column " << col << " row " << row
                << "\n";
@@ -657,13 +774,14 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
              << "; y += " << strideYValue << ") {\n";
     }
 
-    for (auto connectOp : b.getOps<ConnectOp>())
-      output << "__mlir_aie_try(XAie_StrmConnCctEnable(" << deviceInstRef
-             << ", " << tileLocStr("x", "y") << ", "
-             << stringifyWireBundle(connectOp.getSourceBundle()).upper() << ", "
-             << connectOp.sourceIndex() << ", "
-             << stringifyWireBundle(connectOp.getDestBundle()).upper() << ", "
-             << connectOp.destIndex() << "));\n";
+    if (isParam)
+      for (auto connectOp : b.getOps<ConnectOp>())
+        output << "__mlir_aie_try(XAie_StrmConnCctEnable(" << deviceInstRef
+               << ", " << tileLocStr("x", "y") << ", "
+               << stringifyWireBundle(connectOp.getSourceBundle()).upper()
+               << ", " << connectOp.sourceIndex() << ", "
+               << stringifyWireBundle(connectOp.getDestBundle()).upper() << ", "
+               << connectOp.destIndex() << "));\n";
 
     for (auto connectOp : b.getOps<MasterSetOp>()) {
       int mask = 0;
@@ -761,21 +879,6 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
             << connectOp.destIndex() << "));\n";
     }
   }
-  for (auto switchboxOp : targetOp.getOps<ShimSwitchboxOp>()) {
-    Region &r = switchboxOp.getConnections();
-    Block &b = r.front();
-    bool isEmpty = b.getOps<ConnectOp>().empty();
-    int col = switchboxOp.getCol();
-    if (!isEmpty)
-      output << "// Shim Switch column " << col << "\n";
-    for (auto connectOp : b.getOps<ConnectOp>())
-      output << "__mlir_aie_try(XAie_StrmConnCctEnable(" << deviceInstRef
-             << ", " << tileLocStr(col, 0) << ", "
-             << stringifyWireBundle(connectOp.getSourceBundle()).upper() << ", "
-             << connectOp.sourceIndex() << ", "
-             << stringifyWireBundle(connectOp.getDestBundle()).upper() << ", "
-             << connectOp.destIndex() << "));\n";
-  }
 
   output << "return XAIE_OK;\n";
   output << "} // mlir_aie_configure_switchboxes\n\n";
@@ -859,6 +962,25 @@ mlir::LogicalResult AIETranslateToXAIEV2(ModuleOp module, raw_ostream &output) {
              << loc << ", " << bufName << "_offset + (index*4), int_value);\n";
       output << "return rc;\n";
       output << "}\n";
+      // Reading or writing a whole buffer one word at a time is slow, so
+      // block accessors move count elements from the given index at once,
+      // through the block transfers of the test library, which are also
+      // batched in the simulator.
+      output << "int mlir_aie_read_buffer_" << bufName << "_block(" << ctx_p
+             << ", int index, " << typestr << " *values, int count) {\n";
+      output << "  return mlir_aie_data_mem_rd_block(ctx, " << col << ", "
+             << row << ", " << bufName
+             << "_offset + (index*4), (u32 *)values, count) ? XAIE_OK : "
+                "XAIE_ERR;\n";
+      output << "}\n";
+      output << "int mlir_aie_write_buffer_" << bufName << "_block(" << ctx_p
+             << ", int index, const " << typestr
+             << " *values, int count) {\n";
+      output << "  return mlir_aie_data_mem_wr_block(ctx, " << col << ", "
+             << row << ", " << bufName
+             << "_offset + (index*4), (const u32 *)values, count) ? XAIE_OK "
+                ": XAIE_ERR;\n";
+      output << "}\n";
     };
 
     // if(tiles.count(tile.getValue()))
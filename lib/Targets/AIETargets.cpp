@@ -22,6 +22,7 @@
 #include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/IR/Attributes.h"
+#include "mlir/Parser/Parser.h"
 #include "mlir/Target/LLVMIR/Export.h"
 #include "mlir/Target/LLVMIR/Import.h"
 #include "mlir/Tools/mlir-translate/Translation.h"
@@ -145,6 +146,28 @@ void registerAIETranslations() {
   static llvm::cl::opt<size_t> cdoPartitionStartCol(
       "cdo-partition-start-col", llvm::cl::init(1),
       llvm::cl::desc("Partition starting column for CDO generation"));
+  static llvm::cl::opt<bool> cdoOptimizeWrites(
+      "cdo-optimize-writes", llvm::cl::init(false),
+      llvm::cl::desc("Merge consecutive register writes and drop writes of "
+                     "reset values (assumes a reset partition)"));
+  static llvm::cl::opt<std::string> cdoDeltaBase(
+      "cdo-delta-base", llvm::cl::Optional,
+      llvm::cl::desc("Design running before this one in the partition, only "
+                     "load the program memory differing from it"),
+      llvm::cl::value_desc("filename"));
+  static llvm::cl::opt<std::string> cdoDeltaBaseWorkDirPath(
+      "cdo-delta-base-work-dir-path", llvm::cl::Optional,
+      llvm::cl::desc("Working directory holding the core ELFs of the design "
+                     "given by --cdo-delta-base"));
+  static llvm::cl::opt<std::string> ctrlPktBase(
+      "ctrlpkt-base", llvm::cl::Optional,
+      llvm::cl::desc("Design running before this one in the partition, "
+                     "whose routes carry the control packets"),
+      llvm::cl::value_desc("filename"));
+  static llvm::cl::opt<int64_t> simulateMaxCycles(
+      "aie-simulate-max-cycles", llvm::cl::init(10000000),
+      llvm::cl::desc("Stop the simulation of --aie-simulate after this many "
+                     "cycles"));
 
   TranslateFromMLIRRegistration registrationMMap(
       "aie-generate-mmap", "Generate AIE memory map",
@@ -303,9 +326,52 @@ void registerAIETranslations() {
         } else
           workDirPath_ = workDirPath.getValue();
         LLVM_DEBUG(llvm::dbgs() << "work-dir-path: " << workDirPath_ << "\n");
-        return AIETranslateToCDODirect(module, workDirPath_.c_str(), bigEndian,
-                                       cdoUnified, axiDebug, cdoAieSim,
-                                       cdoPartitionStartCol);
+        OwningOpRef<ModuleOp> deltaBase;
+        if (cdoDeltaBase.getNumOccurrences()) {
+          if (!cdoDeltaBaseWorkDirPath.getNumOccurrences())
+            return module.emitOpError("--cdo-delta-base needs "
+                                      "--cdo-delta-base-work-dir-path");
+          deltaBase =
+              parseSourceFile<ModuleOp>(cdoDeltaBase, module.getContext());
+          if (!deltaBase)
+            return failure();
+        }
+        return AIETranslateToCDODirect(
+            module, workDirPath_.c_str(), bigEndian, cdoUnified, axiDebug,
+            cdoAieSim, cdoPartitionStartCol, cdoOptimizeWrites,
+            deltaBase ? *deltaBase : ModuleOp(), cdoDeltaBaseWorkDirPath);
+      },
+      registerDialects);
+  TranslateFromMLIRRegistration registrationCtrlPkt(
+      "aie-generate-ctrlpkt",
+      "Generate the control packets reconfiguring the base design into this "
+      "one",
+      [](ModuleOp module, raw_ostream &output) {
+        if (!ctrlPktBase.getNumOccurrences())
+          return module.emitOpError("--aie-generate-ctrlpkt needs "
+                                    "--ctrlpkt-base");
+        OwningOpRef<ModuleOp> base =
+            parseSourceFile<ModuleOp>(ctrlPktBase, module.getContext());
+        if (!base)
+          return failure();
+        return AIETranslateToControlPackets(module, output, *base,
+                                            cdoPartitionStartCol);
+      },
+      registerDialects);
+  TranslateFromMLIRRegistration registrationDMAReport(
+      "aie-dma-report",
+      "Estimate the bytes, cycles and lock stalls of the DMA channels",
+      AIETranslateToDMAReport, registerDialects);
+  TranslateFromMLIRRegistration registrationUtilizationReport(
+      "aie-utilization-report",
+      "Report the resources used in each tile and the congested channels",
+      AIETranslateToUtilizationReport, registerDialects);
+  TranslateFromMLIRRegistration registrationSimulate(
+      "aie-simulate",
+      "Simulate the locks, DMAs and streams of a design at the level of "
+      "transactions",
+      [](ModuleOp module, raw_ostream &output) {
+        return AIETranslateToSimulation(module, output, simulateMaxCycles);
       },
       registerDialects);
   TranslateFromMLIRRegistration registrationIPU(
@@ -314,5 +380,13 @@ void registerAIETranslations() {
         return AIETranslateToIPU(module, output);
       },
       registerDialects);
+  TranslateFromMLIRRegistration registrationIPUPatches(
+      "aie-ipu-patchgen",
+      "Generate the locations of the runtime parameters in the IPU "
+      "instructions",
+      [](ModuleOp module, raw_ostream &output) {
+        return AIETranslateToIPUPatches(module, output);
+      },
+      registerDialects);
 }
 } // namespace xilinx::AIE
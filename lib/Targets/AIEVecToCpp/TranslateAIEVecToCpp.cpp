@@ -463,6 +463,21 @@ static std::pair<bool, int64_t> getTripCount(scf::ForOp forOp) {
     return std::make_pair(true,
                           ubValue.getSExtValue() - lbValue.getSExtValue());
   }
+  // If the upper bound is the lower bound plus a constant, e.g. in the loops
+  // over the elements of a tile, return the constant.
+  if (auto addOp = forOp.getUpperBound().getDefiningOp<arith::AddIOp>()) {
+    Value lowerBound = forOp.getLowerBound();
+    Value offset;
+    if (addOp.getLhs() == lowerBound)
+      offset = addOp.getRhs();
+    else if (addOp.getRhs() == lowerBound)
+      offset = addOp.getLhs();
+    if (auto cst =
+            offset ? offset.getDefiningOp<arith::ConstantOp>() : nullptr) {
+      APInt offsetValue = cst.getValue().cast<IntegerAttr>().getValue();
+      return std::make_pair(true, offsetValue.getSExtValue());
+    }
+  }
   return std::make_pair(false, 0);
 }
 
@@ -793,6 +808,41 @@ static LogicalResult printOperation(CppEmitter &emitter,
   return success();
 }
 
+// Generate the per-channel requantization: a 32b x 32b elementwise multiply
+// into an accumulator, shifted, rounded and saturated by srs with the
+// rounding mode of the op.
+static LogicalResult printOperation(CppEmitter &emitter,
+                                    aievec::RequantOp requantOp) {
+  Value source = requantOp.getSource();
+  Value scale = requantOp.getScale();
+  Value shift = requantOp.getShift();
+
+  // The sources should have already been emitted
+  if (!emitter.hasValueInScope(source) || !emitter.hasValueInScope(scale) ||
+      !emitter.hasValueInScope(shift))
+    return failure();
+
+  auto resType = cast<VectorType>(requantOp.getResult().getType());
+  raw_indented_ostream &os = emitter.ostream();
+
+  os << "set_rnd(rnd_" << requantOp.getRounding() << ");\n";
+  os << "set_sat();\n";
+
+  if (failed(emitter.emitAssignPrefix(*requantOp)))
+    return failure();
+
+  os << "srs_to_v" << getVectorLaneSize(resType) << "int"
+     << getElementSizeInBits(resType) << "(mul_elem_16_2(";
+  os << emitter.getOrCreateName(scale) << ", broadcast_zero_s32(), ";
+  os << emitter.getOrCreateName(source) << ", undef_v16int32()), ";
+  if (cast<IntegerType>(shift.getType()).getWidth() != 32)
+    os << "(int32_t)";
+  os << emitter.getOrCreateName(shift);
+  os << ")";
+
+  return success();
+}
+
 // Generate the srs intrinsic
 static LogicalResult printOperation(CppEmitter &emitter, aievec::SRSOp srsOp) {
   Value source = srsOp.getSource();
@@ -2096,6 +2146,32 @@ static LogicalResult printOperation(CppEmitter &emitter,
   return success();
 }
 
+// Generate the memref assume_alignment op, as an assumption on the alignment
+// of the pointer to the buffer that the backend compiler can use to schedule
+// its vector loads and stores
+static LogicalResult printOperation(CppEmitter &emitter,
+                                    memref::AssumeAlignmentOp assumeOp) {
+  Value memref = assumeOp.getMemref();
+
+  // If the memref is not already emitted, error out
+  if (!emitter.hasValueInScope(memref))
+    return failure();
+
+  raw_indented_ostream &os = emitter.ostream();
+
+  os << emitter.getOrCreateName(memref);
+  os << " = (";
+  if (failed(emitter.emitType(assumeOp->getLoc(), memref.getType())))
+    return failure();
+  os << ")__builtin_assume_aligned(";
+  os << emitter.getOrCreateName(memref);
+  os << ", ";
+  os << std::to_string(assumeOp.getAlignment());
+  os << ")";
+
+  return success();
+}
+
 // Generate the memref store op
 static LogicalResult printOperation(CppEmitter &emitter,
                                     memref::StoreOp storeOp) {
@@ -3214,13 +3290,14 @@ LogicalResult CppEmitter::emitOperation(Operation &op, bool trailingSemicolon) {
               [&](auto op) { return printOperation(*this, op); })
           // Memref ops.
           .Case<memref::StoreOp, memref::ExpandShapeOp,
-                memref::CollapseShapeOp>(
+                memref::CollapseShapeOp, memref::AssumeAlignmentOp>(
               [&](auto op) { return printOperation(*this, op); })
           .Case<AddOp, AddElemOp, ConcatOp, ExtOp, FMAOp, MulOp, PackOp,
                 SelectOp, SRSOp, SubOp, SubElemOp, UPDOp, UPSOp, FMAElemOp,
                 MulElemOp, BroadcastOp, BroadcastScalarOp, MulConvOp, FMAConvOp,
                 ShiftOp, ShuffleOp, CastOp, MinOp, MaxOp, NegOp, CmpOp, SelOp,
-                ExtElemOp, BxorOp, BnegOp, BandOp, BorOp, UnpackOp, MatMulOp>(
+                ExtElemOp, BxorOp, BnegOp, BandOp, BorOp, UnpackOp, MatMulOp,
+                RequantOp>(
               [&](auto op) { return printOperation(*this, op); })
           .Default([&](Operation *) {
             return op.emitOpError("unable to find printer for op");
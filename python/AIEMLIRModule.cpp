@@ -16,6 +16,7 @@
 #include <pybind11/cast.h>
 #include <pybind11/detail/common.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 
 #include <cstdlib>
 #include <stdexcept>
@@ -40,6 +41,7 @@ PYBIND11_MODULE(_aie, m) {
         mlirDialectHandleInsertDialect(aieHandle, registry);
         mlirDialectHandleInsertDialect(aiexHandle, registry);
         mlirDialectHandleInsertDialect(aievecHandle, registry);
+        aieRegisterAllDialectExtensions(registry);
       },
       "registry"_a);
 
@@ -113,6 +115,80 @@ PYBIND11_MODULE(_aie, m) {
       },
       "module"_a);
 
+  m.def(
+      "ipu_patchgen",
+      [&stealCStr](MlirOperation op) {
+        py::list result;
+        MlirStringRef patches = aieTranslateToIPUPatches(op);
+        // A sequence without runtime parameters has no patches.
+        if (patches.length == 0) {
+          free((void *)patches.data);
+          return result;
+        }
+        auto lines = stealCStr(patches).attr("splitlines")().cast<py::list>();
+        for (auto line : lines) {
+          auto fields = line.attr("split")().cast<py::list>();
+          result.append(py::make_tuple(py::int_(fields[0]), py::int_(fields[1]),
+                                       py::int_(fields[2])));
+        }
+        return result;
+      },
+      "module"_a);
+
+  // Encoders of the IPU instructions, shared with aieTranslateToIPU.
+  m.def(
+      "ipu_encode_sync",
+      [](uint32_t column, uint32_t row, uint32_t direction, uint32_t channel,
+         uint32_t columnNum, uint32_t rowNum) {
+        std::vector<uint32_t> words(2);
+        aieIPUEncodeSync(words.data(), column, row, direction, channel,
+                         columnNum, rowNum);
+        return words;
+      },
+      "column"_a, "row"_a = 0, "direction"_a = 0, "channel"_a = 0,
+      "column_num"_a = 1, "row_num"_a = 1);
+
+  m.def(
+      "ipu_encode_write32",
+      [](uint32_t column, uint32_t row, uint32_t address, uint32_t value) {
+        std::vector<uint32_t> words(3);
+        aieIPUEncodeWrite32(words.data(), column, row, address, value);
+        return words;
+      },
+      "column"_a, "row"_a, "address"_a, "value"_a);
+
+  m.def(
+      "ipu_encode_writebd_shimtile",
+      [](uint32_t column, uint32_t columnNum, uint32_t ddrId, uint32_t bdId,
+         uint32_t bufferLength, uint32_t bufferOffset, uint32_t enablePacket,
+         uint32_t outOfOrderId, uint32_t packetId, uint32_t packetType,
+         uint32_t d0Size, uint32_t d0Stride, uint32_t d1Size,
+         uint32_t d1Stride, uint32_t d2Stride, uint32_t iterationCurrent,
+         uint32_t iterationSize, uint32_t iterationStride, uint32_t nextBd,
+         uint32_t useNextBd, uint32_t validBd, uint32_t lockRelVal,
+         uint32_t lockRelId, uint32_t lockAcqEnable, uint32_t lockAcqVal,
+         uint32_t lockAcqId, uint32_t burstLength, uint32_t axCache,
+         uint32_t axQos) {
+        AieIPUShimTileBD bd{
+            column, columnNum, ddrId, bdId, bufferLength, bufferOffset,
+            enablePacket, outOfOrderId, packetId, packetType, d0Size, d0Stride,
+            d1Size, d1Stride, d2Stride, iterationCurrent, iterationSize,
+            iterationStride, nextBd, useNextBd, validBd, lockRelVal, lockRelId,
+            lockAcqEnable, lockAcqVal, lockAcqId, burstLength, axCache, axQos};
+        std::vector<uint32_t> words(10);
+        aieIPUEncodeWriteBdShimTile(words.data(), &bd);
+        return words;
+      },
+      "column"_a = 0, "column_num"_a = 1, "ddr_id"_a = 0, "bd_id"_a = 0,
+      "buffer_length"_a = 0, "buffer_offset"_a = 0, "enable_packet"_a = 0,
+      "out_of_order_id"_a = 0, "packet_id"_a = 0, "packet_type"_a = 0,
+      "d0_size"_a = 0, "d0_stride"_a = 0, "d1_size"_a = 0, "d1_stride"_a = 0,
+      "d2_stride"_a = 0, "iteration_current"_a = 0, "iteration_size"_a = 0,
+      "iteration_stride"_a = 0, "next_bd"_a = 0, "use_next_bd"_a = 0,
+      "valid_bd"_a = 1, "lock_rel_val"_a = 0, "lock_rel_id"_a = 0,
+      "lock_acq_enable"_a = 0, "lock_acq_val"_a = 0, "lock_acq_id"_a = 0,
+      "burst_length"_a = 256, "ax_cache"_a = 0, "ax_qos"_a = 0);
+
   m.def(
       "generate_xaie",
       [&stealCStr](MlirOperation op) {
@@ -127,15 +203,23 @@ PYBIND11_MODULE(_aie, m) {
       },
       "module"_a, "col"_a, "row"_a);
 
+  m.def(
+      "generate_ldscript",
+      [&stealCStr](MlirOperation op, int col, int row) {
+        return stealCStr(aieTranslateToLdScript(op, col, row));
+      },
+      "module"_a, "col"_a, "row"_a);
+
   m.def(
       "aie_llvm_link",
-      [&stealCStr](std::vector<std::string> moduleStrs) {
+      [&stealCStr](std::vector<std::string> moduleStrs, int optLevel) {
         std::vector<MlirStringRef> modules;
         modules.reserve(moduleStrs.size());
         for (auto &moduleStr : moduleStrs)
           modules.push_back({moduleStr.data(), moduleStr.length()});
 
-        return stealCStr(aieLLVMLink(modules.data(), modules.size()));
+        return stealCStr(
+            aieLLVMLink(modules.data(), modules.size(), optLevel));
       },
-      "modules"_a);
+      "modules"_a, "opt_level"_a = 0);
 }
@@ -72,6 +72,7 @@ void xilinx::AIE::bindTypes(py::module_ &m) {
       .value("PLIO", WireBundle::PLIO)
       .value("NOC", WireBundle::NOC)
       .value("Trace", WireBundle::Trace)
+      .value("Ctrl", WireBundle::Ctrl)
       .export_values();
 
   py::class_<Port>(m, "Port")
@@ -36,6 +36,13 @@ PYBIND11_MODULE(_aie_python_passes, m) {
     return capsule;
   });
 
+  m.def("create_python_batch_router_pass", [](const py::object &solver) {
+    MlirPass pass = mlircreatePythonBatchRouterPass(solver);
+    auto capsule =
+        py::reinterpret_steal<py::object>(mlirPassToPythonCapsule(pass));
+    return capsule;
+  });
+
   m.def("pass_manager_add_owned_pass",
         [](MlirPassManager passManager, py::handle passHandle) {
           py::object passCapsule = mlirApiObjectToCapsule(passHandle);
@@ -16,6 +16,8 @@
 #include "mlir/CAPI/Pass.h"
 #include "mlir/Pass/Pass.h"
 
+#include <pybind11/numpy.h>
+
 using namespace mlir;
 using namespace mlir::python;
 using namespace mlir::python::adaptors;
@@ -44,7 +46,7 @@ public:
   }
 
   void addFlow(TileID srcCoords, const Port srcPort, TileID dstCoords,
-               const Port dstPort) override {
+               const Port dstPort, double bandwidth) override {
     router.attr("add_flow")(
         PathEndPoint{{srcCoords.col, srcCoords.row}, srcPort},
         PathEndPoint{{dstCoords.col, dstCoords.row}, dstPort});
@@ -65,6 +67,160 @@ public:
   py::object router;
 };
 
+static py::array_t<int32_t> makeArray(size_t rows, size_t cols) {
+  return py::array_t<int32_t>(std::vector<py::ssize_t>{
+      static_cast<py::ssize_t>(rows), static_cast<py::ssize_t>(cols)});
+}
+
+// PythonBatchRouter builds the switchbox graph and collects the flows and the
+// fixed connections natively, as Pathfinder does, and hands the whole routing
+// problem to the solver in a single call to `solver.solve(problem)`, where
+// `problem` is a dict of NumPy arrays:
+//
+//   switchboxes        (S, 2) int32: col, row of each switchbox
+//   channels           (C, 3) int32: source switchbox, target switchbox and
+//                      outgoing bundle of each channel
+//   capacity           (C,)   int32: connections of each channel left free
+//                      by the fixed connections
+//   flow_sources       (F, 3) int32: switchbox, bundle, channel of the source
+//                      of each flow
+//   flow_destinations  (D, 4) int32: flow, switchbox, bundle, channel of each
+//                      destination of a flow
+//   flow_bandwidth     (F,)   float64: bandwidth of each flow in MB/s, or 0
+//
+// The solver returns an integer array of shape (K, 2) whose rows are the
+// (flow, channel) pairs used by the routes: the channels of a flow must form
+// a tree from its source switchbox to the switchboxes of its destinations.
+// The connections of the channels are then assigned as in Pathfinder.
+class PythonBatchRouter : public Pathfinder {
+public:
+  explicit PythonBatchRouter(py::object solver) : solver(std::move(solver)) {}
+
+  std::optional<std::map<PathEndPoint, SwitchSettings>>
+  findPaths(const int maxIterations) override {
+    std::vector<SwitchboxNode *> switchboxes(graph.size());
+    for (SwitchboxNode *sb : graph)
+      switchboxes[sb->id] = sb;
+    std::vector<ChannelEdge *> channels;
+    for (ChannelEdge &ch : edges)
+      channels.push_back(&ch);
+    size_t numDsts = 0;
+    for (const FlowNode &flow : flows)
+      numDsts += flow.dsts.size();
+
+    py::array_t<int32_t> switchboxArray = makeArray(switchboxes.size(), 2);
+    auto sbs = switchboxArray.mutable_unchecked<2>();
+    for (auto [index, sb] : llvm::enumerate(switchboxes)) {
+      sbs(index, 0) = sb->col;
+      sbs(index, 1) = sb->row;
+    }
+
+    py::array_t<int32_t> channelArray = makeArray(channels.size(), 3);
+    py::array_t<int32_t> capacityArray(channels.size());
+    auto chs = channelArray.mutable_unchecked<2>();
+    auto capacity = capacityArray.mutable_unchecked<1>();
+    for (auto [index, ch] : llvm::enumerate(channels)) {
+      chs(index, 0) = ch->src.id;
+      chs(index, 1) = ch->getTargetNode().id;
+      chs(index, 2) = static_cast<int32_t>(ch->bundle);
+      capacity(index) =
+          ch->maxCapacity - static_cast<int>(ch->fixedCapacity.size());
+    }
+
+    py::array_t<int32_t> srcArray = makeArray(flows.size(), 3);
+    py::array_t<int32_t> dstArray = makeArray(numDsts, 4);
+    py::array_t<double> bandwidthArray(flows.size());
+    auto srcs = srcArray.mutable_unchecked<2>();
+    auto dsts = dstArray.mutable_unchecked<2>();
+    auto bandwidth = bandwidthArray.mutable_unchecked<1>();
+    size_t dstIndex = 0;
+    for (auto [index, flow] : llvm::enumerate(flows)) {
+      srcs(index, 0) = flow.src.sb->id;
+      srcs(index, 1) = static_cast<int32_t>(flow.src.port.bundle);
+      srcs(index, 2) = flow.src.port.channel;
+      bandwidth(index) = flow.bandwidth;
+      for (const PathEndPointNode &dst : flow.dsts) {
+        dsts(dstIndex, 0) = index;
+        dsts(dstIndex, 1) = dst.sb->id;
+        dsts(dstIndex, 2) = static_cast<int32_t>(dst.port.bundle);
+        dsts(dstIndex, 3) = dst.port.channel;
+        dstIndex++;
+      }
+    }
+
+    py::dict problem;
+    problem["switchboxes"] = switchboxArray;
+    problem["channels"] = channelArray;
+    problem["capacity"] = capacityArray;
+    problem["flow_sources"] = srcArray;
+    problem["flow_destinations"] = dstArray;
+    problem["flow_bandwidth"] = bandwidthArray;
+    auto used = py::array_t<int64_t, py::array::c_style |
+                                         py::array::forcecast>::ensure(
+        solver.attr("solve")(problem));
+    if (!used || used.ndim() != 2 || used.shape(1) != 2)
+      return std::nullopt;
+
+    // The channel entering each switchbox of the route of each flow.
+    std::vector<std::map<SwitchboxNode *, ChannelEdge *>> incoming(
+        flows.size());
+    auto pairs = used.unchecked<2>();
+    for (py::ssize_t i = 0; i < pairs.shape(0); i++) {
+      int64_t flow = pairs(i, 0), channel = pairs(i, 1);
+      if (flow < 0 || flow >= static_cast<int64_t>(flows.size()) ||
+          channel < 0 || channel >= static_cast<int64_t>(channels.size()))
+        return std::nullopt;
+      ChannelEdge *ch = channels[channel];
+      auto [it, inserted] =
+          incoming[flow].insert({&ch->getTargetNode(), ch});
+      if (!inserted && it->second != ch)
+        return std::nullopt;
+    }
+
+    for (ChannelEdge &ch : edges)
+      ch.usedCapacity = 0;
+    std::map<PathEndPoint, SwitchSettings> routingSolution;
+    for (auto [index, flow] : llvm::enumerate(flows)) {
+      // Check that each destination is reached from the source.
+      for (const PathEndPointNode &dst : flow.dsts) {
+        SwitchboxNode *curr = dst.sb;
+        for (size_t steps = 0; curr != flow.src.sb; steps++) {
+          auto it = incoming[index].find(curr);
+          if (it == incoming[index].end() || steps == switchboxes.size())
+            return std::nullopt;
+          curr = &it->second->src;
+        }
+      }
+
+      SwitchSettings switchSettings;
+      switchSettings[*flow.src.sb].src = flow.src.port;
+      std::set<SwitchboxNode *> processed{flow.src.sb};
+      for (const PathEndPointNode &dst : flow.dsts) {
+        SwitchboxNode *curr = dst.sb;
+        switchSettings[*curr].dsts.insert(dst.port);
+        while (!processed.count(curr)) {
+          ChannelEdge *ch = incoming[index][curr];
+          // don't use fixed channels
+          while (ch->fixedCapacity.count(ch->usedCapacity))
+            ch->usedCapacity++;
+          if (ch->usedCapacity >= ch->maxCapacity)
+            return std::nullopt;
+          switchSettings[*curr].src = {getConnectingBundle(ch->bundle),
+                                       ch->usedCapacity};
+          switchSettings[ch->src].dsts.insert({ch->bundle, ch->usedCapacity});
+          ch->usedCapacity++;
+          processed.insert(curr);
+          curr = &ch->src;
+        }
+      }
+      routingSolution[flow.src] = switchSettings;
+    }
+    return routingSolution;
+  }
+
+  py::object solver;
+};
+
 struct PythonRouterPass : AIEPathfinderPass {
   using AIEPathfinderPass::AIEPathfinderPass;
 
@@ -80,3 +236,10 @@ createPythonRouterPass(py::object router) {
 MlirPass mlircreatePythonRouterPass(py::object router) {
   return wrap(createPythonRouterPass(std::move(router)).release());
 }
+
+MlirPass mlircreatePythonBatchRouterPass(py::object solver) {
+  return wrap(std::make_unique<PythonRouterPass>(
+                  DynamicTileAnalysis(std::make_shared<PythonBatchRouter>(
+                      std::move(solver))))
+                  .release());
+}
@@ -14,4 +14,8 @@
 
 MlirPass mlircreatePythonRouterPass(pybind11::object router);
 
+// Route with a solver which receives the whole routing problem as NumPy
+// arrays in one call; see PythonBatchRouter.
+MlirPass mlircreatePythonBatchRouterPass(pybind11::object solver);
+
 #endif // AIE_ROUTERPASS_H
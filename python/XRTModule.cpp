@@ -9,9 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "xrt/xrt_bo.h"
-#include "xrt/xrt_device.h"
-#include "xrt/xrt_kernel.h"
+#include "aie/Runtime/XCLBinKernel.h"
 
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
@@ -19,62 +17,155 @@
 #include <pybind11/stl.h>
 
 #include <algorithm>
+#include <map>
+#include <optional>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace py = pybind11;
 using namespace py::literals;
+using xilinx::AIE::isInFlight;
+using xilinx::AIE::XCLBinContext;
+using xilinx::AIE::XCLBinKernel;
 
-// group_id 0 is for ipu instructions
-// group_id 1 is for number of ipu instructions
-// host side buffers/args follow starting from position 2
-// see aiecc.main.emit_design_kernel_json
-constexpr size_t HOST_BUFFERS_START_IDX = 2;
+// (word, argument, coefficient), as returned by aie.dialects.aie.ipu_patchgen.
+using InstructionPatch = std::tuple<uint32_t, uint32_t, int64_t>;
+
+// A run of the kernel started by PyXCLBin::submit on one of its buffer sets.
+// Several runs can be in flight on the same hw_context; waiting on a run
+// syncs the buffers of its set back from the device. The xrt::run of a
+// buffer set is reused by the next submit on that set, after which the
+// handle refers to the new run.
+class PyRun {
+public:
+  PyRun(xrt::run run, std::vector<xrt::bo *> buffers)
+      : run(std::move(run)), buffers(std::move(buffers)) {}
+
+  bool done() {
+    ert_cmd_state state = run.state();
+    return state != ERT_CMD_STATE_NEW && !isInFlight(state);
+  }
+
+  void wait(const std::optional<int> timeout) {
+    py::gil_scoped_release release;
+    ert_cmd_state state = timeout ? run.wait(timeout.value() * 1000)
+                                  : run.wait();
+    if (state == ERT_CMD_STATE_TIMEOUT)
+      throw std::runtime_error("kernel timed out");
+    if (state != ERT_CMD_STATE_COMPLETED)
+      throw std::runtime_error("kernel failed");
+    if (synced)
+      return;
+    for (xrt::bo *buf : buffers)
+      buf->sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+    synced = true;
+  }
+
+  xrt::run run;
+  std::vector<xrt::bo *> buffers;
+  bool synced = false;
+};
+
+// A host buffer of a buffer set, owned by the XCLBinKernel, with the layout of
+// its NumPy views.
+struct HostBuffer {
+  xrt::bo *bo;
+  std::string format;
+  size_t itemSize;
+  std::vector<py::ssize_t> shape;
+};
 
 class PyXCLBin {
 public:
   PyXCLBin(const std::string &xclBinPath, const std::string &kernelName,
            int deviceIndex)
-      : xclBin(std::make_unique<xrt::xclbin>(xclBinPath)),
-        device(std::make_unique<xrt::device>(deviceIndex)) {
-    assert(device->get_info<xrt::info::device::name>() == "RyzenAI-Phoenix" &&
-           "only Phoenix supported by xrt python bindings");
-    device->register_xclbin(*xclBin);
-    context = std::make_unique<xrt::hw_context>(*device, xclBin->get_uuid());
-    kernel = std::make_unique<xrt::kernel>(*context, kernelName);
+      : xclBinKernel(xclBinPath, kernelName, deviceIndex) {}
+
+  // Run the kernel in a preloaded context, shared with the other XCLBins
+  // created from it.
+  PyXCLBin(std::shared_ptr<XCLBinContext> context,
+           const std::string &kernelName)
+      : xclBinKernel(std::move(context), kernelName) {}
+
+  void loadIPUInstructions(const std::vector<uint32_t> &insts,
+                           const std::vector<InstructionPatch> &patches) {
+    xclBinKernel.loadInstructions(insts.data(), insts.size());
+    baseInstructions = insts;
+    instructionPatches = patches;
+    parameterValues.clear();
+  }
+
+  // Load the instructions of the runs after the first one, which skip the
+  // persistent transfers. The runtime parameters only patch the instructions
+  // of the first run, so they can't be used with resident instructions.
+  void loadResidentIPUInstructions(const std::vector<uint32_t> &insts) {
+    if (!instructionPatches.empty())
+      throw std::runtime_error(
+          "resident instructions don't support runtime parameters");
+    xclBinKernel.loadResidentInstructions(insts.data(), insts.size());
+  }
+
+  // Bind the runtime parameters of the sequence, given by their argument
+  // index, by patching the instructions in place: each patched word is its
+  // loaded value plus the value of each parameter times its coefficient.
+  void setRuntimeParameters(const std::map<uint32_t, int64_t> &values) {
+    parameterValues = values;
+    patchInstructions();
+  }
+
+  // Change the values of some runtime parameters, keeping the values of the
+  // others. This is the fast path to change RTPs written with a parameter
+  // between batches, e.g. alternating the slot of a double-buffered RTP
+  // buffer and setting its new values, without loading the instructions
+  // again.
+  void updateRuntimeParameters(const std::map<uint32_t, int64_t> &values) {
+    for (auto [argument, value] : values)
+      parameterValues[argument] = value;
+    patchInstructions();
   }
 
-  void loadIPUInstructions(const std::vector<uint32_t> &insts) {
-    ipuInstructions =
-        std::make_unique<xrt::bo>(*device, insts.size() * sizeof(uint32_t),
-                                  XCL_BO_FLAGS_CACHEABLE, kernel->group_id(0));
-    uint32_t *bufInstr = ipuInstructions->map<uint32_t *>();
-    for (size_t i = 0; i < insts.size(); ++i)
-      bufInstr[i] = insts.at(i);
-    ipuInstructions->sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  void patchInstructions() {
+    uint32_t *bufInstr = xclBinKernel.instructions();
+    for (auto [word, argument, coefficient] : instructionPatches)
+      bufInstr[word] = baseInstructions.at(word);
+    for (auto [word, argument, coefficient] : instructionPatches) {
+      auto value = parameterValues.find(argument);
+      if (value == parameterValues.end())
+        throw std::runtime_error("no value for runtime parameter " +
+                                 std::to_string(argument));
+      bufInstr[word] += static_cast<uint32_t>(coefficient * value->second);
+    }
+    xclBinKernel.syncInstructions();
   }
 
+  // Map the host buffers into the given buffer set, the default set 0 being
+  // the one used by run and the sync_buffers methods. Large tensors can be
+  // allocated in huge pages.
   template <typename ElementT>
   std::vector<py::memoryview>
-  mmapBuffers(std::vector<std::vector<int>> shapes) {
-    this->buffers.reserve(shapes.size());
+  mmapBuffers(std::vector<std::vector<int>> shapes, size_t bufferSet = 0,
+              bool hugePages = false) {
+    if (bufferSets.size() <= bufferSet)
+      bufferSets.resize(bufferSet + 1);
+    auto &buffers = bufferSets[bufferSet];
+    buffers.reserve(shapes.size());
     std::vector<py::memoryview> views;
     views.reserve(shapes.size());
 
-    auto initAndViewBuffer = [this](
-                                 std::vector<int> shape, int groupId,
-                                 std::vector<std::unique_ptr<xrt::bo>> &buffers,
+    auto initAndViewBuffer = [this, bufferSet, hugePages](
+                                 std::vector<int> shape,
+                                 std::vector<HostBuffer> &buffers,
                                  std::vector<py::memoryview> &views) {
       int nElements =
           std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<>());
       int nBytes = nElements * sizeof(ElementT);
-      xrt::bo xrtBuf(*device, nBytes, XRT_BO_FLAGS_HOST_ONLY,
-                     kernel->group_id(groupId));
-      buffers.push_back(std::make_unique<xrt::bo>(xrtBuf));
+      xrt::bo &xrtBuf = xclBinKernel.addBuffer(bufferSet, nBytes, hugePages);
+      buffers.push_back({&xrtBuf, py::format_descriptor<ElementT>::format(),
+                         sizeof(ElementT),
+                         {shape.begin(), shape.end()}});
 
       ElementT *buf = xrtBuf.map<ElementT *>();
-      for (int i = 0; i < nElements; ++i)
-        buf[i] = static_cast<ElementT>(0);
 
       std::vector strides_{1};
       for (int i = shape.size() - 1; i > 0; i--)
@@ -87,37 +178,94 @@ public:
       views.push_back(py::memoryview::from_buffer(buf, shape, strides));
     };
 
-    for (size_t i = 0; i < shapes.size(); ++i)
-      initAndViewBuffer(shapes[i], HOST_BUFFERS_START_IDX + i, this->buffers,
-                        views);
+    for (const std::vector<int> &shape : shapes)
+      initAndViewBuffer(shape, buffers, views);
     return views;
   }
 
-  uint64_t getBufferHostAddress(size_t idx) { return buffers[idx]->address(); }
+  // Allocate a new buffer set, so that runs on different sets can be in
+  // flight at the same time.
+  template <typename ElementT>
+  std::tuple<size_t, std::vector<py::memoryview>>
+  mmapBufferSet(std::vector<std::vector<int>> shapes, bool hugePages) {
+    size_t bufferSet = std::max<size_t>(bufferSets.size(), 1);
+    return {bufferSet, mmapBuffers<ElementT>(shapes, bufferSet, hugePages)};
+  }
 
-  void syncBuffersToDevice() {
-    for (auto &buf : this->buffers)
-      buf->sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  std::vector<HostBuffer> &getBufferSet(size_t bufferSet) {
+    if (bufferSet >= bufferSets.size())
+      throw std::runtime_error("no buffer set " + std::to_string(bufferSet));
+    return bufferSets[bufferSet];
   }
 
-  void syncBuffersFromDevice() {
-    for (auto &buf : this->buffers)
-      buf->sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+  HostBuffer &getBuffer(size_t idx, size_t bufferSet) {
+    auto &buffers = getBufferSet(bufferSet);
+    if (idx >= buffers.size())
+      throw std::runtime_error("no buffer " + std::to_string(idx) +
+                               " in buffer set " + std::to_string(bufferSet));
+    return buffers[idx];
   }
 
-  void run() {
-    run_ = std::make_unique<xrt::run>(*kernel);
-    run_->set_arg(0, *ipuInstructions);
-    run_->set_arg(1, ipuInstructions->size());
-    for (size_t i = 0; i < buffers.size(); ++i)
-      run_->set_arg(HOST_BUFFERS_START_IDX + i, *buffers[i]);
-    run_->start();
+  uint64_t getBufferHostAddress(size_t idx) {
+    return getBuffer(idx, 0).bo->address();
+  }
+
+  // A NumPy array over the mapped memory of a buffer, without copy. The array
+  // keeps the XCLBin alive.
+  py::array getBufferArray(const py::object &self, size_t idx,
+                           size_t bufferSet) {
+    HostBuffer &buf = getBuffer(idx, bufferSet);
+    return py::array(py::dtype(buf.format), buf.shape, buf.bo->map(), self);
+  }
+
+  // Sync count elements of a buffer starting at the element offset, or all
+  // the elements from offset by default.
+  void syncBuffer(size_t idx, xclBOSyncDirection direction, size_t offset,
+                  std::optional<size_t> count, size_t bufferSet) {
+    HostBuffer &buf = getBuffer(idx, bufferSet);
+    size_t size = buf.bo->size();
+    size_t begin = offset * buf.itemSize;
+    size_t bytes = count ? count.value() * buf.itemSize : size - begin;
+    if (begin > size || bytes > size - begin)
+      throw std::runtime_error("range out of bounds of buffer " +
+                               std::to_string(idx));
+    py::gil_scoped_release release;
+    buf.bo->sync(direction, bytes, begin);
+  }
+
+  void syncBuffersToDevice(size_t bufferSet) {
+    py::gil_scoped_release release;
+    xclBinKernel.syncBuffers(bufferSet, XCL_BO_SYNC_BO_TO_DEVICE);
+  }
+
+  void syncBuffersFromDevice(size_t bufferSet) {
+    py::gil_scoped_release release;
+    xclBinKernel.syncBuffers(bufferSet, XCL_BO_SYNC_BO_FROM_DEVICE);
+  }
+
+  xrt::run startRun(size_t bufferSet) {
+    py::gil_scoped_release release;
+    return xclBinKernel.startRun(bufferSet);
+  }
+
+  void run() { run_ = std::make_unique<xrt::run>(startRun(0)); }
+
+  // Sync the buffers of the set to the device and start a run on them,
+  // without waiting for the runs already in flight. The instructions are
+  // shared by all the runs, so the runtime parameters must not be changed
+  // while runs are in flight.
+  PyRun submit(size_t bufferSet) {
+    syncBuffersToDevice(bufferSet);
+    std::vector<xrt::bo *> buffers;
+    for (auto &buf : getBufferSet(bufferSet))
+      buffers.push_back(buf.bo);
+    return PyRun(startRun(bufferSet), std::move(buffers));
   }
 
   void _runOnlyIpuInstructions() {
-    run_ = std::make_unique<xrt::run>(*kernel);
-    run_->set_arg(0, *ipuInstructions);
-    run_->set_arg(1, ipuInstructions->size());
+    run_ = std::make_unique<xrt::run>(*xclBinKernel.kernel);
+    run_->set_arg(0, *xclBinKernel.ipuInstructions);
+    run_->set_arg(1, xclBinKernel.ipuInstructions->size());
     run_->start();
   }
 
@@ -129,47 +277,112 @@ public:
       (void)run_->wait();
   }
 
-  std::unique_ptr<xrt::xclbin> xclBin;
-  std::unique_ptr<xrt::device> device;
-  std::unique_ptr<xrt::hw_context> context;
-  std::unique_ptr<xrt::kernel> kernel;
-  std::unique_ptr<xrt::bo> ipuInstructions;
+  XCLBinKernel xclBinKernel;
+  std::vector<uint32_t> baseInstructions;
+  std::vector<InstructionPatch> instructionPatches;
+  std::map<uint32_t, int64_t> parameterValues;
 
-  std::vector<std::unique_ptr<xrt::bo>> buffers;
+  std::vector<std::vector<HostBuffer>> bufferSets;
 
   std::unique_ptr<xrt::run> run_;
 };
 
+template <typename F>
+static auto dispatchNpFormat(const py::object &npFormat, F &&f) {
+  auto npy = py::module_::import("numpy");
+  if (npFormat.is(npy.attr("int16")))
+    return f(int16_t{});
+  if (npFormat.is(npy.attr("int32")))
+    return f(int32_t{});
+  if (npFormat.is(npy.attr("float32")))
+    return f(float{});
+  if (npFormat.is(npy.attr("int64")))
+    return f(int64_t{});
+  if (npFormat.is(npy.attr("float64")))
+    return f(double{});
+  throw std::runtime_error("unsupported np format: " +
+                           py::repr(npFormat).cast<std::string>());
+}
+
 PYBIND11_MODULE(_xrt, m) {
 
+  py::class_<PyRun>(m, "Run", py::module_local())
+      .def("done", &PyRun::done)
+      .def("wait", &PyRun::wait, "timeout"_a = py::none());
+
+  // Loading the xclbin in a new hw_context takes long, and doesn't need the
+  // GIL: designs can be preloaded from several threads.
+  py::class_<XCLBinContext, std::shared_ptr<XCLBinContext>>(
+      m, "XCLBinContext", py::module_local())
+      .def(py::init([](const std::string &xclBinPath, int deviceIndex) {
+             py::gil_scoped_release release;
+             return std::make_shared<XCLBinContext>(xclBinPath, deviceIndex);
+           }),
+           "xclbin_path"_a, "device_index"_a = 0);
+
   py::class_<PyXCLBin>(m, "XCLBin", py::module_local())
       .def(py::init<const std::string &, const std::string &, int>(),
            "xclbin_path"_a, "kernel_name"_a, "device_index"_a = 0)
-      .def("load_ipu_instructions", &PyXCLBin::loadIPUInstructions, "insts"_a)
-      .def("sync_buffers_to_device", &PyXCLBin::syncBuffersToDevice)
-      .def("sync_buffers_from_device", &PyXCLBin::syncBuffersFromDevice)
+      .def(py::init<std::shared_ptr<XCLBinContext>, const std::string &>(),
+           "context"_a, "kernel_name"_a)
+      .def("load_ipu_instructions", &PyXCLBin::loadIPUInstructions, "insts"_a,
+           "patches"_a = std::vector<InstructionPatch>{})
+      .def("load_resident_ipu_instructions",
+           &PyXCLBin::loadResidentIPUInstructions, "insts"_a)
+      .def("set_runtime_parameters", &PyXCLBin::setRuntimeParameters,
+           "values"_a)
+      .def("update_runtime_parameters", &PyXCLBin::updateRuntimeParameters,
+           "values"_a)
+      .def("sync_buffers_to_device", &PyXCLBin::syncBuffersToDevice,
+           "buffer_set"_a = 0)
+      .def("sync_buffers_from_device", &PyXCLBin::syncBuffersFromDevice,
+           "buffer_set"_a = 0)
+      .def(
+          "sync_buffer_to_device",
+          [](PyXCLBin &self, size_t idx, size_t offset,
+             std::optional<size_t> count, size_t bufferSet) {
+            self.syncBuffer(idx, XCL_BO_SYNC_BO_TO_DEVICE, offset, count,
+                            bufferSet);
+          },
+          "idx"_a, "offset"_a = 0, "count"_a = py::none(), "buffer_set"_a = 0)
+      .def(
+          "sync_buffer_from_device",
+          [](PyXCLBin &self, size_t idx, size_t offset,
+             std::optional<size_t> count, size_t bufferSet) {
+            self.syncBuffer(idx, XCL_BO_SYNC_BO_FROM_DEVICE, offset, count,
+                            bufferSet);
+          },
+          "idx"_a, "offset"_a = 0, "count"_a = py::none(), "buffer_set"_a = 0)
+      .def(
+          "buffer_array",
+          [](const py::object &self, size_t idx, size_t bufferSet) {
+            return self.cast<PyXCLBin &>().getBufferArray(self, idx,
+                                                          bufferSet);
+          },
+          "idx"_a, "buffer_set"_a = 0)
       .def("run", &PyXCLBin::run)
+      .def("submit", &PyXCLBin::submit, "buffer_set"_a = 0,
+           py::keep_alive<0, 1>())
       .def("_run_only_ipu_instructions", &PyXCLBin::_runOnlyIpuInstructions)
       .def("wait", &PyXCLBin::wait, "timeout"_a = py::none())
       .def(
           "mmap_buffers",
           [](PyXCLBin &self, const std::vector<std::vector<int>> &shapes,
-             const py::object &npFormat) {
-            auto npy = py::module_::import("numpy");
-            if (npFormat.is(npy.attr("int16")))
-              return self.mmapBuffers<int16_t>(shapes);
-            if (npFormat.is(npy.attr("int32")))
-              return self.mmapBuffers<int32_t>(shapes);
-            if (npFormat.is(npy.attr("float32")))
-              return self.mmapBuffers<float>(shapes);
-            if (npFormat.is(npy.attr("int64")))
-              return self.mmapBuffers<int64_t>(shapes);
-            if (npFormat.is(npy.attr("float64")))
-              return self.mmapBuffers<double>(shapes);
-            throw std::runtime_error("unsupported np format: " +
-                                     py::repr(npFormat).cast<std::string>());
+             const py::object &npFormat, bool hugePages) {
+            return dispatchNpFormat(npFormat, [&](auto element) {
+              return self.mmapBuffers<decltype(element)>(shapes, 0, hugePages);
+            });
+          },
+          "shapes"_a, "np_format"_a, "huge_pages"_a = false)
+      .def(
+          "mmap_buffer_set",
+          [](PyXCLBin &self, const std::vector<std::vector<int>> &shapes,
+             const py::object &npFormat, bool hugePages) {
+            return dispatchNpFormat(npFormat, [&](auto element) {
+              return self.mmapBufferSet<decltype(element)>(shapes, hugePages);
+            });
           },
-          "shapes"_a, "np_format"_a)
+          "shapes"_a, "np_format"_a, "huge_pages"_a = false)
       .def("_get_buffer_host_address", [](PyXCLBin &self, size_t idx) {
         return self.getBufferHostAddress(idx);
       });
@@ -0,0 +1,243 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Search the parameter space of a design for its fastest configuration.
+
+The space is declared in a JSON file:
+
+    {
+      "design": "aie2.py",
+      "shapes": [{"M": 256, "K": 256, "N": 256}],
+      "params": {"m": [32, 64], "k": [32, 64], "n": [32, 64]},
+      "constraints": ["M % m == 0", "K % k == 0", "N % n == 0"],
+      "build": ["xchesscc_wrapper aie2 -DDIM_M={m} ... -c {src}/mm.cc"],
+      "harness": "{src}/test.exe -x final.xclbin -i insts.txt -k MLIR_AIE"
+    }
+
+Each shape, with one value of each parameter satisfying the constraints, is
+a candidate. The design is run as `python3 design --name value` for each
+dimension of the shape and each parameter, and its MLIR is first pruned
+statically: the candidates using more memory, locks, BDs or DMA channels than
+a tile has, in the -aie-utilization-report of their lowered objectFifos, are
+dropped, and the others are ranked by the cycles of their slowest core in
+-aie-estimate-core-cycles, only the --keep best being built. The build
+commands, then aiecc.py, run in parallel in a directory per candidate, after
+which the candidates are benchmarked one at a time on the NPU by the harness
+with --warmup and --iters, reading the JSON line printed by
+ipu_host::print_benchmark_json. The commands are formatted with the values of
+the candidate and {src}, the directory of the space file.
+
+The fastest configuration of each shape is stored in the database given with
+--db, a JSON file keyed by the shapes, and only replaced by a faster one:
+
+    python3 -m aie.autotune space.json --db tuned.json
+"""
+
+import argparse
+import concurrent.futures
+import itertools
+import json
+import os
+import subprocess
+import sys
+
+# Resources of a tile in the utilization report.
+RESOURCES = [
+    "memory_bytes",
+    "locks",
+    "bds",
+    "s2mm_channels",
+    "mm2s_channels",
+]
+
+
+def shape_key(shape):
+    """The key of a shape in the database, as "M=256,K=256,N=256"."""
+    return ",".join(f"{name}={value}" for name, value in shape.items())
+
+
+def candidates(space):
+    """The values of each candidate of the space: the dimensions of a shape
+    and one value of each parameter, satisfying all the constraints."""
+    params = space.get("params", {})
+    constraints = space.get("constraints", [])
+    for shape in space.get("shapes", [{}]):
+        for values in itertools.product(*params.values()):
+            candidate = dict(shape)
+            candidate.update(zip(params.keys(), values))
+            if all(eval(c, {}, dict(candidate)) for c in constraints):
+                yield candidate
+
+
+def over_resources(report):
+    """The resources of the tiles that a utilization report shows as
+    overused, as "memory_bytes of (0, 2)"."""
+    return [
+        f"{resource} of {tile['tile']}"
+        for tile in report.get("tiles", [])
+        for resource in RESOURCES
+        if resource in tile
+        and tile[resource]["available"]
+        and tile[resource]["used"] > tile[resource]["available"]
+    ]
+
+
+def estimated_cycles(estimates):
+    """The cycles of the slowest core of a report of
+    -aie-estimate-core-cycles, which bounds the throughput of the design."""
+    return max((core["cycles"] for core in estimates.get("cores", [])), default=0)
+
+
+def update_db(db, shape, candidate, result, metric):
+    """Record the result of a candidate in the database if it is the best of
+    its shape, the lowest value of the metric. Returns whether it is."""
+    key = shape_key(shape)
+    best = db.get(key)
+    if best is not None and best["result"][metric] <= result[metric]:
+        return False
+    params = {k: v for k, v in candidate.items() if k not in shape}
+    db[key] = {"params": params, "result": result}
+    return True
+
+
+def run(cmd, cwd, **kwargs):
+    return subprocess.run(cmd, cwd=cwd, shell=True, text=True, **kwargs)
+
+
+def generate(space, src, cwd, candidate):
+    design = os.path.join(src, space["design"])
+    args = " ".join(f"--{name} {value}" for name, value in candidate.items())
+    with open(os.path.join(cwd, "aie.mlir"), "w") as f:
+        return run(f"{sys.executable} {design} {args}", cwd, stdout=f).returncode == 0
+
+
+def static_check(cwd):
+    """Returns the reason to prune the candidate, or its estimated cycles."""
+    lowered = run(
+        "aie-opt --aie-objectFifo-stateful-transform aie.mlir"
+        " | aie-translate --aie-utilization-report",
+        cwd,
+        capture_output=True,
+    )
+    if lowered.returncode:
+        return "does not lower", None
+    overused = over_resources(json.loads(lowered.stdout))
+    if overused:
+        return "uses too many " + ", ".join(overused), None
+    estimate = run(
+        "aie-opt --aie-estimate-core-cycles=json-file=cycles.json aie.mlir"
+        " -o /dev/null",
+        cwd,
+        capture_output=True,
+    )
+    if estimate.returncode:
+        return "cannot be estimated", None
+    with open(os.path.join(cwd, "cycles.json")) as f:
+        return None, estimated_cycles(json.load(f))
+
+
+def build(space, values, cwd):
+    for cmd in space.get("build", []):
+        if run(cmd.format(**values), cwd, capture_output=True).returncode:
+            return False
+    aiecc = run(
+        "aiecc.py --aie-generate-cdo --no-compile-host"
+        " --xclbin-name=final.xclbin --aie-generate-ipu"
+        " --ipu-insts-name=insts.txt aie.mlir",
+        cwd,
+        capture_output=True,
+    )
+    return aiecc.returncode == 0
+
+
+def benchmark(space, values, cwd, warmup, iters):
+    cmd = space["harness"].format(**values)
+    out = run(f"{cmd} --warmup {warmup} --iters {iters}", cwd, capture_output=True)
+    if "PASS!" not in out.stdout:
+        return None
+    for line in out.stdout.splitlines():
+        if line.startswith("{"):
+            return json.loads(line)
+    return None
+
+
+def name_of(candidate):
+    return "_".join(f"{name}{value}" for name, value in candidate.items())
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+    )
+    parser.add_argument("space", help="the JSON file declaring the space")
+    parser.add_argument("--db", default="tuned.json")
+    parser.add_argument("--build-dir", default="build/autotune")
+    parser.add_argument(
+        "--keep", type=int, default=0, help="the candidates built, 0 for all"
+    )
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count())
+    parser.add_argument("--warmup", type=int, default=10)
+    parser.add_argument("--iters", type=int, default=100)
+    parser.add_argument(
+        "--metric", default="mean_us", help="the result minimized by the search"
+    )
+    args = parser.parse_args()
+
+    with open(args.space) as f:
+        space = json.load(f)
+    src = os.path.dirname(os.path.abspath(args.space))
+    shape_names = set().union(*space.get("shapes", [{}]))
+
+    ranked = []
+    for candidate in candidates(space):
+        cwd = os.path.abspath(os.path.join(args.build_dir, name_of(candidate)))
+        os.makedirs(cwd, exist_ok=True)
+        if not generate(space, src, cwd, candidate):
+            print(f"{name_of(candidate)}: design failed", file=sys.stderr)
+            continue
+        reason, cycles = static_check(cwd)
+        if reason:
+            print(f"{name_of(candidate)}: {reason}", file=sys.stderr)
+            continue
+        ranked.append((cycles, candidate, cwd))
+    ranked.sort(key=lambda c: c[0])
+    if args.keep:
+        ranked = ranked[: args.keep]
+
+    with concurrent.futures.ThreadPoolExecutor(args.jobs) as pool:
+        built = list(
+            pool.map(
+                lambda c: build(space, dict(c[1], src=src), c[2]),
+                ranked,
+            )
+        )
+
+    db = {}
+    if os.path.exists(args.db):
+        with open(args.db) as f:
+            db = json.load(f)
+    for (cycles, candidate, cwd), ok in zip(ranked, built):
+        if not ok:
+            print(f"{name_of(candidate)}: build failed", file=sys.stderr)
+            continue
+        result = benchmark(
+            space, dict(candidate, src=src), cwd, args.warmup, args.iters
+        )
+        if result is None or args.metric not in result:
+            print(f"{name_of(candidate)}: run failed", file=sys.stderr)
+            continue
+        result["estimated_cycles"] = cycles
+        shape = {k: v for k, v in candidate.items() if k in shape_names}
+        best = update_db(db, shape, candidate, result, args.metric)
+        print(
+            f"{name_of(candidate)}: {args.metric} {result[args.metric]}"
+            + (" (best)" if best else ""),
+            file=sys.stderr,
+        )
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.db)), exist_ok=True)
+    with open(args.db, "w") as f:
+        json.dump(db, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -158,6 +158,26 @@ def parse_args(args=None):
         action="store",
         help="Compile with max n-threads in the machine (default is 4).  An argument of zero corresponds to the maximum number of threads on the machine.",
     )
+    parser.add_argument(
+        "--cache-dir",
+        dest="cache_dir",
+        default=None,
+        help="Directory used to cache compiled core objects and ELF files across builds (default is no caching)",
+    )
+    parser.add_argument(
+        "--incremental",
+        dest="incremental",
+        default=False,
+        action="store_true",
+        help="Skip the stages whose inputs did not change since the last build in the same project directory, and reuse their outputs",
+    )
+    parser.add_argument(
+        "--bytecode",
+        dest="bytecode",
+        default=False,
+        action="store_true",
+        help="Pass the design between the compilation stages as MLIR bytecode instead of text, with the large buffer initial values as resources",
+    )
     parser.add_argument(
         "--profile",
         dest="profiling",
@@ -165,6 +185,13 @@ def parse_args(args=None):
         action="store_true",
         help="Profile commands to find the most expensive executions.",
     )
+    parser.add_argument(
+        "--time-trace",
+        dest="time_trace",
+        default=None,
+        metavar="FILE",
+        help="Write a timeline of the passes and commands of the build, with its critical path, to FILE in the Chrome trace event format",
+    )
     parser.add_argument(
         "--unified",
         dest="unified",
@@ -215,6 +242,13 @@ def parse_args(args=None):
         default="ipu_insts.txt",
         help="Output instructions filename for IPU target",
     )
+    parser.add_argument(
+        "--ipu-resident-insts-name",
+        dest="resident_insts_name",
+        default=None,
+        help="Output instructions filename for the runs after the first one, "
+        "which skip the persistent transfers of data resident in the array",
+    )
     parser.add_argument(
         "--aie-generate-cdo",
         dest="cdo",
@@ -263,6 +297,55 @@ def parse_args(args=None):
         default="0x901",
         help="Kernel id in xclbin file",
     )
+    parser.add_argument(
+        "--select-flow-switching",
+        dest="select_flow_switching",
+        default=False,
+        action="store_true",
+        help="Route the low-bandwidth flows leaving DMAs as packet flows, "
+        "from their bandwidth annotations",
+    )
+    parser.add_argument(
+        "--allocate-scratchpads",
+        dest="allocate_scratchpads",
+        default=False,
+        action="store_true",
+        help="Place the memref allocations of the cores in buffers of their "
+        "tiles, sharing memory between those not live at the same time",
+    )
+    parser.add_argument(
+        "--span-memtiles",
+        dest="span_memtiles",
+        default=False,
+        action="store_true",
+        help="Let the buffers of full memtiles continue into the memory of "
+        "their east neighbour",
+    )
+    parser.add_argument(
+        "--kernel-lib",
+        dest="kernel_libs",
+        default=[],
+        action="append",
+        help="Precompiled kernel library linked with the cores calling the "
+        "functions it defines, given by path or by name as lib<name>.a in the "
+        "kernel library directories",
+    )
+    parser.add_argument(
+        "--kernel-lib-dir",
+        dest="kernel_lib_dirs",
+        default=[],
+        action="append",
+        help="Directory searched for the kernel libraries given by name, "
+        "before the kernels installed in aie_runtime_lib/<target>/kernels",
+    )
+    parser.add_argument(
+        "--start-columns",
+        dest="start_columns",
+        default=None,
+        type=_column_list,
+        help="Comma-separated columns at which the partition of the design "
+        "can be loaded in the xclbin (default: each column it fits at)",
+    )
 
     opts = parser.parse_args(args)
     return opts
@@ -284,6 +367,10 @@ def _non_negative_int(arg):
     return _int(arg, "non-negative", lambda i: i >= 0)
 
 
+def _column_list(arg):
+    return [_non_negative_int(col) for col in arg.split(",")]
+
+
 def _int(arg, kind, pred):
     desc = "requires {} integer, but found '{}'"
     try:
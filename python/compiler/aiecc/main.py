@@ -9,7 +9,10 @@ aiecc - AIE compiler driver for MLIR tools
 """
 
 import asyncio
+import contextlib
 import glob
+import hashlib
+import io
 import json
 import os
 import random
@@ -30,7 +33,7 @@ import rich.progress as progress
 import aie.compiler.aiecc.cl_arguments
 import aie.compiler.aiecc.configure
 from aie.dialects import aie as aiedialect
-from aie.ir import Context, Location, Module
+from aie.ir import Context, FlatSymbolRefAttr, Location, Module, StringAttr
 from aie.passmanager import PassManager
 
 INPUT_WITH_ADDRESSES_PIPELINE = (
@@ -41,9 +44,11 @@ INPUT_WITH_ADDRESSES_PIPELINE = (
     .Nested(
         "aie.device",
         Pipeline()
+        .add_pass("aie-place-tiles")
         .add_pass("aie-assign-lock-ids")
         .add_pass("aie-register-objectFifos")
         .add_pass("aie-objectFifo-stateful-transform")
+        .add_pass("aie-cascade-reductions")
         .add_pass("aie-lower-cascade-flows")
         .add_pass("aie-lower-broadcast-packet")
         .add_pass("aie-create-packet-flows")
@@ -90,8 +95,8 @@ CREATE_PATH_FINDER_FLOWS = Pipeline().Nested(
 DMA_TO_IPU = Pipeline().Nested("aie.device", Pipeline().add_pass("aie-dma-to-ipu"))
 
 
-async def read_file_async(file_path: str) -> str:
-    async with aiofiles.open(file_path, mode="r") as f:
+async def read_file_async(file_path: str, binary=False):
+    async with aiofiles.open(file_path, mode="rb" if binary else "r") as f:
         contents = await f.read()
     return contents
 
@@ -181,6 +186,9 @@ mem_topology = {
 
 
 def emit_partition(mlir_module_str, kernel_id="0x901", start_columns=None):
+    # The partition spans the columns of the tiles of the design, and can be
+    # loaded at each of the start columns, so that the partitions of several
+    # hardware contexts can run the design at the same time.
     with Context(), Location.unknown():
         module = Module.parse(mlir_module_str)
         tiles = find_ops(
@@ -240,9 +248,110 @@ def generate_cores_list(mlir_module_str):
         ]
 
 
-def emit_design_bif(root_path, has_cores=True):
-    elf_file = f"file={root_path}/aie_cdo_elfs.bin" if has_cores else ""
-    enable_file = f"file={root_path}/aie_cdo_enable.bin" if has_cores else ""
+def generate_overlays_list(mlir_module_str):
+    # The number of program memory overlays of each core which has some.
+    with Context(), Location.unknown():
+        module = Module.parse(mlir_module_str)
+        return {
+            (c.tile.owner.opview.col.value, c.tile.owner.opview.row.value): len(
+                c.overlays
+            )
+            for c in find_ops(
+                module.operation,
+                lambda o: isinstance(o.operation.opview, aiedialect.CoreOp),
+            )
+            if c.overlays is not None
+        }
+
+
+def generate_external_calls(mlir_module_str):
+    # The functions declared without a body which each core calls, defined by
+    # the objects and kernel libraries it is linked with.
+    with Context(), Location.unknown():
+        module = Module.parse(mlir_module_str)
+        declared = {
+            StringAttr(f.operation.attributes["sym_name"]).value
+            for f in find_ops(
+                module.operation,
+                lambda o: o.operation.name == "func.func"
+                and len(o.operation.regions[0].blocks) == 0,
+            )
+        }
+        calls = {}
+        for c in find_ops(
+            module.operation,
+            lambda o: isinstance(o.operation.opview, aiedialect.CoreOp),
+        ):
+            tile = (c.tile.owner.opview.col.value, c.tile.owner.opview.row.value)
+            calls[tile] = declared & {
+                FlatSymbolRefAttr(call.operation.attributes["callee"]).value
+                for call in find_ops(
+                    c.operation, lambda o: o.operation.name == "func.call"
+                )
+            }
+        return calls
+
+
+def find_kernel_libs(names, dirs):
+    """The paths of the kernel libraries given by path, or by name as
+    lib<name>.a in the first of the directories which has it."""
+    paths = []
+    for name in names:
+        if os.path.isfile(name):
+            paths.append(os.path.abspath(name))
+            continue
+        for d in dirs:
+            path = os.path.join(d, f"lib{name}.a")
+            if os.path.isfile(path):
+                paths.append(path)
+                break
+        else:
+            sys.exit(f"Kernel library {name} not found in: {', '.join(dirs)}")
+    return paths
+
+
+def archive_symbols(path):
+    """The symbols defined by the objects of an archive, read from its GNU
+    symbol table, or None when it has none or an empty one, as ar builds for
+    objects of a machine it doesn't know."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if not data.startswith(b"!<arch>\n"):
+        return None
+    # The symbol table is the first member: a count, the offsets of the
+    # members defining each symbol, and their null-terminated names.
+    name = data[8:24].rstrip()
+    if name not in (b"/", b"/SYM64/"):
+        return None
+    size = int(data[56:66])
+    table = data[68 : 68 + size]
+    width = 8 if name == b"/SYM64/" else 4
+    count = int.from_bytes(table[:width], "big")
+    names = table[width * (count + 1) :].split(b"\0")[:count]
+    return {n.decode() for n in names} or None
+
+
+def unique_elf_cores(cores):
+    # The cores sharing an elf_file, such as the cores of a herd lowered by
+    # aie-lower-herds, run the same code: compile it for the first of them.
+    seen = set()
+    unique = []
+    for core in cores:
+        elf_file = core[2]
+        if elf_file is not None:
+            if elf_file in seen:
+                continue
+            seen.add(elf_file)
+        unique.append(core)
+    return unique
+
+
+def emit_design_bif(root_path, core_columns=()):
+    # The ELFs of the cores are loaded by one CDO per column.
+    elf_file = "\n               ".join(
+        f"file={root_path}/aie_cdo_elfs_{col}.bin" for col in core_columns
+    )
+    enable_file = f"file={root_path}/aie_cdo_enable.bin" if core_columns else ""
     return dedent(
         f"""\
         all:
@@ -280,15 +389,69 @@ def do_run(command, verbose=False):
     return ret
 
 
-def run_passes(pass_pipeline, mlir_module_str, outputfile=None, verbose=False):
+def split_pass_pipeline(pass_pipeline):
+    """Splits a textual pass pipeline into pipelines of one pass each, which
+    keep the nesting of their pass, e.g. builtin.module(aie.device(a,b)) into
+    builtin.module(aie.device(a)) and builtin.module(aie.device(b))."""
+
+    def split_top_level(s):
+        parts, depth, start = [], 0, 0
+        for i, c in enumerate(s):
+            if c in "({":
+                depth += 1
+            elif c in ")}":
+                depth -= 1
+            elif c == "," and depth == 0:
+                parts.append(s[start:i])
+                start = i + 1
+        parts.append(s[start:])
+        return [p.strip() for p in parts if p.strip()]
+
+    def expand(p):
+        m = re.fullmatch(r"([\w.]+)\((.*)\)", p, re.DOTALL)
+        if not m:
+            return [p]
+        anchor, nested = m.groups()
+        return [f"{anchor}({q})" for part in split_top_level(nested) for q in expand(part)]
+
+    return expand(str(pass_pipeline).strip())
+
+
+def run_pass_pipeline(pass_pipeline, op, trace=None):
+    """Runs a pass pipeline on op. With a trace, the passes are run and
+    recorded one at a time."""
+    if trace is None:
+        PassManager.parse(str(pass_pipeline)).run(op)
+        return
+    for single_pass in split_pass_pipeline(pass_pipeline):
+        name = re.sub(r"^([\w.]+\()+|\)+$", "", single_pass)
+        with trace.span(name, "pass", {"pipeline": single_pass}):
+            PassManager.parse(single_pass).run(op)
+
+
+def run_passes(
+    pass_pipeline,
+    mlir_module_str,
+    outputfile=None,
+    verbose=False,
+    trace=None,
+    bytecode=False,
+):
+    """Runs a pass pipeline on a module and returns the result, as bytecode
+    if requested. Module.parse reads both forms."""
     if verbose:
         print("Running:", pass_pipeline)
     with Context() as ctx, Location.unknown():
         module = Module.parse(mlir_module_str)
-        PassManager.parse(pass_pipeline).run(module.operation)
-        mlir_module_str = str(module)
+        run_pass_pipeline(pass_pipeline, module.operation, trace)
+        if bytecode:
+            buffer = io.BytesIO()
+            module.operation.write_bytecode(buffer)
+            mlir_module_str = buffer.getvalue()
+        else:
+            mlir_module_str = str(module)
         if outputfile:
-            with open(outputfile, "w") as g:
+            with open(outputfile, "wb" if bytecode else "w") as g:
                 g.write(mlir_module_str)
     return mlir_module_str
 
@@ -298,6 +461,258 @@ def corefile(dirname, core, ext):
     return os.path.join(dirname, f"core_{col}_{row}.{ext}")
 
 
+def content_hash(flags, files, tmpdirname):
+    """Hash of the flags and of the contents of the files, which doesn't
+    depend on where the project directory is."""
+    h = hashlib.sha256()
+    for f in flags:
+        # Paths into the project directory must not affect the key.
+        h.update(str(f).replace(tmpdirname, "").encode())
+        h.update(b"\0")
+    for f in files:
+        with open(f, "rb") as fd:
+            h.update(fd.read())
+        h.update(b"\0")
+    return h.hexdigest()
+
+
+class StageStamps:
+    """Hashes of the inputs of the stages of the last build in the project
+    directory.
+
+    A stage whose inputs hash to its stamp, and whose outputs are still in
+    place, is up to date and is skipped. The stamps are only written once a
+    stage succeeded, so that an interrupted build redoes it.
+    """
+
+    def __init__(self, tmpdirname):
+        self.tmpdirname = tmpdirname
+        self.path = os.path.join(tmpdirname, "stages.json")
+        try:
+            with open(self.path) as f:
+                self.stamps = json.load(f)
+        except (OSError, ValueError):
+            self.stamps = {}
+
+    def key(self, flags, files):
+        return content_hash(flags, files, self.tmpdirname)
+
+    def up_to_date(self, stage, key, outputs):
+        return self.stamps.get(stage) == key and all(
+            os.path.isfile(o) for o in outputs
+        )
+
+    def update(self, stage, key):
+        self.stamps[stage] = key
+        fd, tmp = tempfile.mkstemp(dir=self.tmpdirname, suffix=".tmp")
+        with os.fdopen(fd, "w") as f:
+            json.dump(self.stamps, f, indent=2, sort_keys=True)
+        os.replace(tmp, self.path)
+
+
+class CompileCache:
+    """Persistent, content-addressed cache of compiled core objects.
+
+    Entries are keyed by a hash of the tool flags and the contents of the
+    inputs (LLVM IR or object, linker script) so that identical cores and
+    unchanged rebuilds reuse earlier results.
+    """
+
+    def __init__(self, cache_dir, tmpdirname):
+        self.cache_dir = os.path.abspath(cache_dir)
+        self.tmpdirname = tmpdirname
+        os.makedirs(self.cache_dir, exist_ok=True)
+
+    def key(self, flags, files):
+        return content_hash(flags, files, self.tmpdirname)
+
+    def fetch(self, key, dest):
+        cached = os.path.join(self.cache_dir, key)
+        if not os.path.isfile(cached):
+            return False
+        shutil.copyfile(cached, dest)
+        return True
+
+    def store(self, key, src):
+        # Write to a unique file and rename, so that concurrent builds sharing
+        # the cache never observe a partial entry.
+        fd, tmp = tempfile.mkstemp(dir=self.cache_dir, suffix=".tmp")
+        os.close(fd)
+        shutil.copyfile(src, tmp)
+        os.replace(tmp, os.path.join(self.cache_dir, key))
+
+
+def design_key(mlir_module, args):
+    """Hash of a design and of the aiecc arguments compiling it."""
+    h = hashlib.sha256()
+    for a in args:
+        h.update(str(a).encode())
+        h.update(b"\0")
+    h.update(str(mlir_module).encode())
+    return h.hexdigest()
+
+
+def cached_design(cache_dir, key):
+    """The paths of the xclbin and IPU instructions of a design in the
+    artifact cache, or None if it wasn't compiled yet."""
+    entry = os.path.join(os.path.abspath(cache_dir), "designs", key)
+    paths = (os.path.join(entry, "final.xclbin"), os.path.join(entry, "insts.txt"))
+    if all(os.path.isfile(p) for p in paths):
+        return paths
+    return None
+
+
+def compile_cached(mlir_module, args, cache_dir):
+    """Compile a design into an xclbin and its IPU instructions, unless an
+    earlier compilation of the design with the same arguments left them in
+    the artifact cache, and return their paths in the cache.
+
+    The cores are cached as well, so that designs sharing cores only compile
+    them once. An entry is built in a staging directory and renamed into
+    place, so that concurrent compilations never observe a partial entry.
+    """
+    key = design_key(mlir_module, args)
+    paths = cached_design(cache_dir, key)
+    if paths:
+        return paths
+    designs = os.path.join(os.path.abspath(cache_dir), "designs")
+    os.makedirs(designs, exist_ok=True)
+    staging = tempfile.mkdtemp(dir=designs, suffix=".tmp")
+    try:
+        run(
+            mlir_module,
+            list(args)
+            + [
+                "--tmpdir",
+                os.path.join(staging, "prj"),
+                "--cache-dir",
+                os.path.abspath(cache_dir),
+                "--aie-generate-cdo",
+                "--aie-generate-ipu",
+                "--no-compile-host",
+                "--xclbin-name",
+                os.path.join(staging, "final.xclbin"),
+                "--ipu-insts-name",
+                os.path.join(staging, "insts.txt"),
+            ],
+        )
+    except SystemExit as e:
+        shutil.rmtree(staging, ignore_errors=True)
+        raise RuntimeError(f"aiecc failed to compile the design: {e.code}") from None
+    shutil.rmtree(os.path.join(staging, "prj"), ignore_errors=True)
+    try:
+        os.rename(staging, os.path.join(designs, key))
+    except OSError:
+        # Another compilation of the design published it first.
+        shutil.rmtree(staging, ignore_errors=True)
+    return cached_design(cache_dir, key)
+
+
+class TimeTrace:
+    """Timeline of the build in the Chrome trace event format, viewable in
+    chrome://tracing or Perfetto.
+
+    Each asyncio task, e.g. the compilation of one core, gets its own track.
+    The events on the critical path of the build, the chain of events which
+    determined its end time, are marked and repeated on a separate track.
+    """
+
+    CRITICAL_PATH_TID = 0
+
+    def __init__(self):
+        self.origin = time.time()
+        self.events = []
+        self.tracks = {}
+
+    def track(self):
+        try:
+            task = asyncio.current_task()
+        except RuntimeError:
+            task = None
+        key = id(task) if task else None
+        if key not in self.tracks:
+            name = task.get_name() if task else "aiecc"
+            self.tracks[key] = (len(self.tracks) + 1, name)
+        return self.tracks[key][0]
+
+    def add(self, name, cat, start, end, args=None):
+        self.events.append(
+            {
+                "name": name,
+                "cat": cat,
+                "ph": "X",
+                "ts": (start - self.origin) * 1e6,
+                "dur": (end - start) * 1e6,
+                "pid": 1,
+                "tid": self.track(),
+                "args": dict(args or {}),
+            }
+        )
+
+    @contextlib.contextmanager
+    def span(self, name, cat, args=None):
+        start = time.time()
+        try:
+            yield
+        finally:
+            self.add(name, cat, start, time.time(), args)
+
+    def critical_path(self):
+        """Walks back from the last event to finish, each time to the event
+        which finished last before the current one started, preferring the
+        same track when it is within the clock resolution."""
+        events = sorted(self.events, key=lambda e: e["ts"] + e["dur"])
+        if not events:
+            return []
+        path = [events[-1]]
+        while True:
+            current = path[-1]
+            before = [
+                e
+                for e in events
+                if e["ts"] + e["dur"] <= current["ts"] + 1 and e is not current
+            ]
+            if not before:
+                break
+            latest = before[-1]["ts"] + before[-1]["dur"]
+            same_track = [
+                e
+                for e in before
+                if e["tid"] == current["tid"] and e["ts"] + e["dur"] >= latest - 1e3
+            ]
+            path.append(same_track[-1] if same_track else before[-1])
+        return path[::-1]
+
+    def write(self, path):
+        critical = self.critical_path()
+        for e in critical:
+            e["args"]["critical_path"] = True
+        events = [
+            {
+                "name": "thread_name",
+                "ph": "M",
+                "pid": 1,
+                "tid": tid,
+                "args": {"name": name},
+            }
+            for tid, name in self.tracks.values()
+        ]
+        events.append(
+            {
+                "name": "thread_name",
+                "ph": "M",
+                "pid": 1,
+                "tid": self.CRITICAL_PATH_TID,
+                "args": {"name": "critical path"},
+            }
+        )
+        events += self.events
+        events += [dict(e, tid=self.CRITICAL_PATH_TID) for e in critical]
+        with open(path, "w") as f:
+            json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, f)
+        return critical
+
+
 def aie_target_defines(aie_target):
     if aie_target == "AIE2":
         return ["-D__AIEARCH__=20"]
@@ -343,6 +758,31 @@ class FlowRunner:
         self.peano_clang_path = os.path.join(opts.peano_install_dir, "bin", "clang")
         self.peano_opt_path = os.path.join(opts.peano_install_dir, "bin", "opt")
         self.peano_llc_path = os.path.join(opts.peano_install_dir, "bin", "llc")
+        self.time_trace = TimeTrace() if opts.time_trace else None
+        self.compile_cache = None
+        if opts.cache_dir and opts.execute:
+            self.compile_cache = CompileCache(opts.cache_dir, tmpdirname)
+        self.stages = None
+        if opts.incremental and opts.execute:
+            self.stages = StageStamps(tmpdirname)
+
+    def tool_flags(self, aie_target, kind):
+        return [
+            kind,
+            aie_target,
+            self.opts.xchesscc,
+            self.opts.xbridge,
+            self.opts.peano_install_dir,
+            self.opts.aietools_path,
+        ]
+
+    def cache_key(self, aie_target, kind, files):
+        return self.compile_cache.key(self.tool_flags(aie_target, kind), files)
+
+    def emit_bytecode_flags(self):
+        """The flags of aie-opt writing its output in the format passed
+        between the stages."""
+        return ["--emit-bytecode"] if self.opts.bytecode else []
 
     def prepend_tmp(self, x):
         return os.path.join(self.tmpdirname, x)
@@ -367,6 +807,10 @@ class FlowRunner:
         if self.opts.verbose:
             print(f"Done in {end - start:.3f} sec: {commandstr}")
         self.runtimes[commandstr] = end - start
+        if self.time_trace:
+            name = os.path.basename(command[0])
+            args = {"command": commandstr}
+            self.time_trace.add(name, "subprocess", start, end, args)
         if task:
             self.progress_bar.update(task, advance=1, command="")
             self.maxtasks = max(self.progress_bar._tasks[task].completed, self.maxtasks)
@@ -378,6 +822,109 @@ class FlowRunner:
             print("Error encountered while running: " + commandstr, file=sys.stderr)
             sys.exit(ret)
 
+    async def do_in_process(self, task, description, fn):
+        """Runs a compilation stage through the Python bindings, with the same
+        progress, timing and error reporting as do_call."""
+        if self.stopall:
+            return
+
+        if task:
+            self.progress_bar.update(task, advance=0, command=description[0:30])
+        start = time.time()
+        if self.opts.verbose:
+            print(description)
+        ret = 0
+        if self.opts.execute:
+            try:
+                fn()
+            except Exception as e:
+                print(e, file=sys.stderr)
+                ret = 1
+        end = time.time()
+        if self.opts.verbose:
+            print(f"Done in {end - start:.3f} sec: {description}")
+        self.runtimes[description] = end - start
+        if self.time_trace:
+            self.time_trace.add(description, "in-process", start, end)
+        if task:
+            self.progress_bar.update(task, advance=1, command="")
+            self.maxtasks = max(self.progress_bar._tasks[task].completed, self.maxtasks)
+            self.progress_bar._tasks[task].total = self.maxtasks
+
+        if ret != 0:
+            if task:
+                self.progress_bar._tasks[task].description = "[red] Error"
+            print("Error encountered while running: " + description, file=sys.stderr)
+            sys.exit(ret)
+
+    def split_cores(self):
+        """Splits a clone of the module with addresses into one module per
+        core, in a single traversal of the device."""
+        with self.mlir_context, Location.unknown():
+            split = self.module_with_addresses.operation.clone()
+            run_pass_pipeline(
+                "builtin.module(aie-split-cores)", split.operation, self.time_trace
+            )
+            self.core_modules = {
+                StringAttr(op.operation.attributes["sym_name"]).value: op
+                for op in split.regions[0].blocks[0].operations
+            }
+            # The core modules are owned by the split module.
+            self.split_module = split
+
+    def lower_core(self, core, file_opt_core, file_core_llvmir):
+        """Lowers the module of one core to LLVM IR, unless the module is the
+        same as in the last incremental build."""
+        corecol, corerow, _ = core
+        with self.mlir_context, Location.unknown():
+            core_module = self.core_modules[f"core_{corecol}_{corerow}"]
+            stage_key = None
+            if self.stages:
+                stage = f"lower {file_core_llvmir}"
+                pipeline = AIE_LOWER_TO_LLVM(corecol, corerow)
+                stage_key = self.stages.key([pipeline, str(core_module)], [])
+                if self.stages.up_to_date(stage, stage_key, [file_core_llvmir]):
+                    if self.opts.verbose:
+                        print(f"Keeping {file_core_llvmir}")
+                    return
+            run_pass_pipeline(
+                AIE_LOWER_TO_LLVM(corecol, corerow),
+                core_module.operation,
+                self.time_trace,
+            )
+            if self.opts.verbose:
+                with open(file_opt_core, "w") as f:
+                    f.write(str(core_module))
+            llvmir = aiedialect.translate_mlir_to_llvmir(core_module.operation)
+        with open(file_core_llvmir, "w") as f:
+            f.write(llvmir)
+        if stage_key:
+            self.stages.update(stage, stage_key)
+
+    def core_kernel_libs(self, core):
+        """The kernel libraries defining functions called by a core, whose
+        objects defining them are pulled by the link.  A library without a
+        symbol table is linked with every core."""
+        calls = self.external_calls.get(core[0:2], set())
+        return [
+            path
+            for path, symbols in self.kernel_libs
+            if symbols is None or symbols & calls
+        ]
+
+    def generate_core_script(self, core, file_core_script):
+        """Writes the bcf or linker script of one core."""
+        corecol, corerow, _ = core
+        generate = (
+            aiedialect.generate_bcf
+            if self.opts.xbridge
+            else aiedialect.generate_ldscript
+        )
+        with self.mlir_context, Location.unknown():
+            script = generate(self.module_with_addresses.operation, corecol, corerow)
+        with open(file_core_script, "w") as f:
+            f.write(script)
+
     # In order to run xchesscc on modern ll code, we need a bunch of hacks.
     async def chesshack(self, task, llvmir, chess_intrinsic_wrapper_ll_path):
         llvmir_chesshack = llvmir + "chesshack.ll"
@@ -436,6 +983,81 @@ class FlowRunner:
             )
             return chess_intrinsic_wrapper_ll_path
 
+    async def process_ipu(self, file_with_addresses):
+        def dma_to_ipu(*options):
+            if self.overlays:
+                options += ("overlay-dir=" + self.tmpdirname,)
+            return "--aie-dma-to-ipu" + ("=" + " ".join(options) if options else "")
+
+        generated_insts_mlir = self.prepend_tmp("generated_ipu_insts.mlir")
+        await self.do_call(
+            self.progress_bar.task,
+            [
+                "aie-opt",
+                dma_to_ipu(),
+                file_with_addresses,
+                "-o",
+                generated_insts_mlir,
+            ]
+            + self.emit_bytecode_flags(),
+        )
+        await self.do_call(
+            self.progress_bar.task,
+            [
+                "aie-translate",
+                "--aie-ipu-instgen",
+                generated_insts_mlir,
+                "-o",
+                opts.insts_name,
+            ],
+        )
+        if opts.resident_insts_name:
+            resident_insts_mlir = self.prepend_tmp("generated_ipu_resident_insts.mlir")
+            await self.do_call(
+                self.progress_bar.task,
+                [
+                    "aie-opt",
+                    dma_to_ipu("skip-persistent=true"),
+                    file_with_addresses,
+                    "-o",
+                    resident_insts_mlir,
+                ]
+                + self.emit_bytecode_flags(),
+            )
+            await self.do_call(
+                self.progress_bar.task,
+                [
+                    "aie-translate",
+                    "--aie-ipu-instgen",
+                    resident_insts_mlir,
+                    "-o",
+                    opts.resident_insts_name,
+                ],
+            )
+
+    async def extract_overlays(self, task, core, file_core_elf, overlays):
+        # The code of the overlays is moved out of the elf, whose code is
+        # loaded with the configuration of the array, into the binaries
+        # loaded by the runtime sequence at the phases of the core.
+        objcopy = os.path.join(opts.peano_install_dir, "bin", "llvm-objcopy")
+        for i in range(overlays):
+            file_overlay = corefile(self.tmpdirname, core, f"overlay{i}.bin")
+            await self.do_call(
+                task,
+                [
+                    objcopy,
+                    "-O",
+                    "binary",
+                    f"--only-section=.overlay{i}",
+                    file_core_elf,
+                    file_overlay,
+                ],
+            )
+        await self.do_call(
+            task,
+            [objcopy, "--wildcard", "--remove-section=.overlay*", file_core_elf],
+        )
+
     async def process_core(
         self,
         core,
@@ -444,6 +1066,7 @@ class FlowRunner:
         chess_intrinsic_wrapper_ll_path,
         file_with_addresses,
     ):
+        asyncio.current_task().set_name("core (%d, %d)" % core[0:2])
         async with self.limit:
             if self.stopall:
                 return
@@ -476,7 +1099,8 @@ class FlowRunner:
             else:
                 libc = llvmlibc_install_lib_path
 
-            clang_link_args = [me_basic_o, libc, "-Wl,--gc-sections"]
+            kernel_libs = self.core_kernel_libs(core)
+            clang_link_args = [me_basic_o, *kernel_libs, libc, "-Wl,--gc-sections"]
 
             if opts.progress:
                 task = self.progress_bar.add_task(
@@ -489,30 +1113,56 @@ class FlowRunner:
 
             # fmt: off
             corecol, corerow, elf_file = core
+            # The lowering and the translations run in-process, on the module of
+            # the core split off the module with addresses.
             if not opts.unified:
-                file_core = corefile(self.tmpdirname, core, "mlir")
-                await self.do_call(task, ["aie-opt", "--aie-localize-locks", "--aie-normalize-address-spaces", "--aie-standard-lowering=tilecol=%d tilerow=%d" % core[0:2], "--aiex-standard-lowering", file_with_addresses, "-o", file_core])
                 file_opt_core = corefile(self.tmpdirname, core, "opt.mlir")
-                await self.do_call(task, ["aie-opt", f"--pass-pipeline={LOWER_TO_LLVM_PIPELINE}", file_core, "-o", file_opt_core])
+                file_core_llvmir = corefile(self.tmpdirname, core, "ll")
+                await self.do_in_process(task, f"lower core ({corecol}, {corerow}) to {file_core_llvmir}", lambda: self.lower_core(core, file_opt_core, file_core_llvmir))
+                file_core_obj = corefile(self.tmpdirname, core, "o")
             if self.opts.xbridge:
                 file_core_bcf = corefile(self.tmpdirname, core, "bcf")
-                await self.do_call(task, ["aie-translate", file_with_addresses, "--aie-generate-bcf", "--tilecol=%d" % corecol, "--tilerow=%d" % corerow, "-o", file_core_bcf])
+                await self.do_in_process(task, f"generate {file_core_bcf}", lambda: self.generate_core_script(core, file_core_bcf))
             else:
                 file_core_ldscript = corefile(self.tmpdirname, core, "ld.script")
-                await self.do_call(task, ["aie-translate", file_with_addresses, "--aie-generate-ldscript", "--tilecol=%d" % corecol, "--tilerow=%d" % corerow, "-o", file_core_ldscript])
-            if not self.opts.unified:
-                file_core_llvmir = corefile(self.tmpdirname, core, "ll")
-                await self.do_call(task, ["aie-translate", "--mlir-to-llvmir", file_opt_core, "-o", file_core_llvmir])
-                file_core_obj = corefile(self.tmpdirname, core, "o")
+                await self.do_in_process(task, f"generate {file_core_ldscript}", lambda: self.generate_core_script(core, file_core_ldscript))
 
             file_core_elf = elf_file if elf_file else corefile(".", core, "elf")
 
+            file_core_script = file_core_bcf if self.opts.xbridge else file_core_ldscript
+            file_core_input = self.unified_file_core_obj if opts.unified else file_core_llvmir
+            # The overlay binaries are outputs of the link too, so the elf of a
+            # core with overlays is always linked again.
+            overlays = self.overlays.get((corecol, corerow), 0)
+            stage_key = None
+            if self.stages and opts.compile and opts.link and not overlays:
+                stage = f"link {os.path.abspath(file_core_elf)}"
+                stage_key = self.stages.key(self.tool_flags(aie_target, "core-elf"), [file_core_input, file_core_script, *kernel_libs])
+                if self.stages.up_to_date(stage, stage_key, [file_core_elf]):
+                    if self.opts.verbose:
+                        print(f"Keeping {file_core_elf}")
+                    self.progress_bar.update(self.progress_bar.task_completed, advance=1)
+                    if task:
+                        self.progress_bar.update(task, advance=0, visible=False)
+                    return
+
+            cache_key = None
+            if self.compile_cache and opts.compile and opts.link and not overlays:
+                cache_key = self.cache_key(aie_target, "core-elf", [file_core_input, file_core_script, *kernel_libs])
+                if self.compile_cache.fetch(cache_key, file_core_elf):
+                    if self.opts.verbose:
+                        print(f"Using cached {file_core_elf}")
+                    self.progress_bar.update(self.progress_bar.task_completed, advance=1)
+                    if task:
+                        self.progress_bar.update(task, advance=0, visible=False)
+                    return
+
             if opts.compile and opts.xchesscc:
                 if not opts.unified:
                     file_core_llvmir_chesslinked = await self.chesshack(task, file_core_llvmir, chess_intrinsic_wrapper_ll_path)
                     if self.opts.link and self.opts.xbridge:
                         link_with_obj = await extract_input_files(file_core_bcf)
-                        await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", "+P", "4", file_core_llvmir_chesslinked, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
+                        await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", "+P", "4", file_core_llvmir_chesslinked, link_with_obj, *kernel_libs, "+l", file_core_bcf, "-o", file_core_elf])
                     elif self.opts.link:
                         await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-c", "-d", "-f", "+P", "4", file_core_llvmir_chesslinked, "-o", file_core_obj])
                         await self.do_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
@@ -520,7 +1170,7 @@ class FlowRunner:
                     file_core_obj = self.unified_file_core_obj
                     if opts.link and opts.xbridge:
                         link_with_obj = await extract_input_files(file_core_bcf)
-                        await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
+                        await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, *kernel_libs, "+l", file_core_bcf, "-o", file_core_elf])
                     elif opts.link:
                         await self.do_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
 
@@ -534,10 +1184,18 @@ class FlowRunner:
 
                 if opts.link and opts.xbridge:
                     link_with_obj = await extract_input_files(file_core_bcf)
-                    await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, "+l", file_core_bcf, "-o", file_core_elf])
+                    await self.do_call(task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-d", "-f", file_core_obj, link_with_obj, *kernel_libs, "+l", file_core_bcf, "-o", file_core_elf])
                 elif opts.link:
                     await self.do_call(task, [self.peano_clang_path, "-O2", "--target=" + aie_peano_target, file_core_obj, *clang_link_args, "-Wl,-T," + file_core_ldscript, "-o", file_core_elf])
 
+            if overlays and opts.compile and opts.link:
+                await self.extract_overlays(task, core, file_core_elf, overlays)
+
+            if cache_key:
+                self.compile_cache.store(cache_key, file_core_elf)
+            if stage_key and not self.stopall:
+                self.stages.update(stage, stage_key)
+
             self.progress_bar.update(self.progress_bar.task_completed, advance=1)
             if task:
                 self.progress_bar.update(task, advance=0, visible=False)
@@ -558,11 +1216,14 @@ class FlowRunner:
                 except shutil.SameFileError:
                     pass
             input_physical = Module.parse(
-                await read_file_async(self.prepend_tmp("input_physical.mlir"))
+                await read_file_async(
+                    self.prepend_tmp("input_physical.mlir"),
+                    binary=self.opts.bytecode,
+                )
             )
             generate_cdo(input_physical.operation, self.tmpdirname)
 
-    async def process_xclbin_gen(self, has_cores):
+    async def process_xclbin_gen(self, core_columns):
         if opts.progress:
             task = self.progress_bar.add_task(
                 "[yellow] XCLBIN generation ", total=10, command="starting"
@@ -576,7 +1237,12 @@ class FlowRunner:
         )
 
         await write_file_async(
-            json.dumps(emit_partition(self.mlir_module_str, opts.kernel_id), indent=2),
+            json.dumps(
+                emit_partition(
+                    self.mlir_module_str, opts.kernel_id, opts.start_columns
+                ),
+                indent=2,
+            ),
             self.prepend_tmp("aie_partition.json"),
         )
 
@@ -595,16 +1261,40 @@ class FlowRunner:
         )
 
         await write_file_async(
-            emit_design_bif(self.tmpdirname, has_cores),
+            emit_design_bif(self.tmpdirname, core_columns),
             self.prepend_tmp("design.bif"),
         )
 
+        # The xclbin is only packaged again if its metadata or its CDOs
+        # changed.
+        stage = f"xclbin {os.path.abspath(opts.xclbin_name)}"
+        stage_key = None
+        if self.stages:
+            inputs = [
+                "mem_topology.json",
+                "aie_partition.json",
+                "kernels.json",
+                "design.bif",
+            ]
+            inputs += sorted(
+                os.path.basename(f)
+                for f in glob.glob(self.prepend_tmp("aie_cdo*.bin"))
+            )
+            stage_key = self.stages.key(inputs, [self.prepend_tmp(f) for f in inputs])
+            if self.stages.up_to_date(stage, stage_key, [opts.xclbin_name]):
+                if self.opts.verbose:
+                    print(f"Keeping {opts.xclbin_name}")
+                return
+
         # fmt: off
         await self.do_call(task, ["bootgen", "-arch", "versal", "-image", self.prepend_tmp("design.bif"), "-o", self.prepend_tmp("design.pdi"), "-w"])
         await self.do_call(task, ["xclbinutil", "--add-replace-section", "MEM_TOPOLOGY:JSON:" + self.prepend_tmp("mem_topology.json"), "--add-kernel", self.prepend_tmp("kernels.json"), "--add-replace-section", "AIE_PARTITION:JSON:" + self.prepend_tmp("aie_partition.json"), "--force", "--output", opts.xclbin_name])
         # fmt: on
+        if stage_key and not self.stopall:
+            self.stages.update(stage, stage_key)
 
     async def process_host_cgen(self, aie_target, file_with_addresses):
+        asyncio.current_task().set_name("host")
         async with self.limit:
             if self.stopall:
                 return
@@ -629,7 +1319,8 @@ class FlowRunner:
                     file_with_addresses,
                     "-o",
                     file_physical,
-                ],
+                ]
+                + self.emit_bytecode_flags(),
             )
 
             if opts.airbin:
@@ -732,6 +1423,7 @@ class FlowRunner:
                 "-I" + self.tmpdirname,
                 "-fuse-ld=lld",
                 "-lm",
+                "-lpthread",
                 "-lxaiengine",
             ]
             # Linking against HSA
@@ -750,6 +1442,7 @@ class FlowRunner:
                 self.progress_bar.update(task, advance=0, visible=False)
 
     async def gen_sim(self, task, aie_target):
+        asyncio.current_task().set_name("aiesim")
         # For simulation, we need to additionally parse the 'remaining' options to avoid things
         # which conflict with the options below (e.g. -o)
         print(opts.host_args)
@@ -939,6 +1632,7 @@ class FlowRunner:
         print("To run simulation: " + sim_script)
 
     async def run_flow(self):
+        asyncio.current_task().set_name("aiecc")
         nworkers = int(opts.nthreads)
         if nworkers == 0:
             nworkers = os.cpu_count()
@@ -962,25 +1656,71 @@ class FlowRunner:
                 [
                     "lower-affine",
                     "aie-canonicalize-device",
-                    "aie.device(" + "aie-assign-lock-ids",
+                    "aie.device(" + "aie-place-tiles",
+                    "aie-assign-lock-ids",
                     "aie-register-objectFifos",
                     "aie-objectFifo-stateful-transform",
+                ]
+                + (
+                    ["aie-select-flow-switching{apply=true}"]
+                    if self.opts.select_flow_switching
+                    else []
+                )
+                + [
+                    "aie-cascade-reductions",
                     "aie-lower-cascade-flows",
                     "aie-lower-broadcast-packet",
                     "aie-create-packet-flows",
                     "aie-lower-multicast",
-                    "aie-assign-buffer-addresses)",
-                    "convert-scf-to-cf",
                 ]
+                + (
+                    ["aie-allocate-scratchpads"]
+                    if self.opts.allocate_scratchpads
+                    else []
+                )
+                + [
+                    "aie-assign-buffer-addresses{span-memtiles=true}"
+                    if self.opts.span_memtiles
+                    else "aie-assign-buffer-addresses"
+                ]
+                + (["aie-resource-initial-values"] if self.opts.bytecode else [])
             )
-            run_passes(
-                "builtin.module(" + pass_pipeline + ")",
-                self.mlir_module_str,
-                file_with_addresses,
-                self.opts.verbose,
+            pass_pipeline += "),convert-scf-to-cf"
+            # The placement and routing are redone only if the input or the
+            # pipeline changed.
+            stage_key = None
+            if self.stages:
+                stage_key = self.stages.key([self.mlir_module_str, pass_pipeline], [])
+            if stage_key and self.stages.up_to_date(
+                "physical", stage_key, [file_with_addresses]
+            ):
+                if self.opts.verbose:
+                    print(f"Keeping {file_with_addresses}")
+                mlir_module_with_addresses = await read_file_async(
+                    file_with_addresses, binary=self.opts.bytecode
+                )
+            else:
+                mlir_module_with_addresses = run_passes(
+                    "builtin.module(" + pass_pipeline + ")",
+                    self.mlir_module_str,
+                    file_with_addresses,
+                    self.opts.verbose,
+                    self.time_trace,
+                    self.opts.bytecode,
+                )
+                if stage_key:
+                    self.stages.update("physical", stage_key)
+            self.mlir_context = Context()
+            self.module_with_addresses = Module.parse(
+                mlir_module_with_addresses, context=self.mlir_context
             )
 
-            cores = generate_cores_list(await read_file_async(file_with_addresses))
+            cores = generate_cores_list(mlir_module_with_addresses)
+            compiled_cores = unique_elf_cores(cores)
+            if not opts.unified and cores:
+                await self.do_in_process(
+                    progress_bar.task, "split cores", self.split_cores
+                )
             t = do_run(
                 [
                     "aie-translate",
@@ -998,29 +1738,25 @@ class FlowRunner:
                 exit(-3)
             aie_peano_target = aie_target.lower() + "-none-elf"
 
-            # Optionally generate insts.txt for IPU instruction stream
-            if opts.ipu or opts.only_ipu:
-                generated_insts_mlir = self.prepend_tmp("generated_ipu_insts.mlir")
-                await self.do_call(
-                    progress_bar.task,
-                    [
-                        "aie-opt",
-                        "--aie-dma-to-ipu",
-                        file_with_addresses,
-                        "-o",
-                        generated_insts_mlir,
-                    ],
-                )
-                await self.do_call(
-                    progress_bar.task,
-                    [
-                        "aie-translate",
-                        "--aie-ipu-instgen",
-                        generated_insts_mlir,
-                        "-o",
-                        opts.insts_name,
-                    ],
+            # Optionally generate insts.txt for IPU instruction stream. The
+            # overlays of the cores are only known once they are linked, the
+            # instructions loading them being generated after the cores.
+            self.overlays = generate_overlays_list(mlir_module_with_addresses)
+            self.external_calls = generate_external_calls(mlir_module_with_addresses)
+            kernel_lib_dirs = self.opts.kernel_lib_dirs + [
+                os.path.join(
+                    aie.compiler.aiecc.configure.install_path(),
+                    "aie_runtime_lib",
+                    aie_target.upper(),
+                    "kernels",
                 )
+            ]
+            self.kernel_libs = [
+                (path, archive_symbols(path))
+                for path in find_kernel_libs(self.opts.kernel_libs, kernel_lib_dirs)
+            ]
+            if opts.only_ipu or (opts.ipu and not self.overlays):
+                await self.process_ipu(file_with_addresses)
                 if opts.only_ipu:
                     return
 
@@ -1031,25 +1767,44 @@ class FlowRunner:
             # fmt: off
             if opts.unified:
                 file_opt_with_addresses = self.prepend_tmp("input_opt_with_addresses.mlir")
-                await self.do_call(progress_bar.task, ["aie-opt", f"--pass-pipeline={AIE_LOWER_TO_LLVM()}", file_with_addresses, "-o", file_opt_with_addresses])
+                await self.do_call(progress_bar.task, ["aie-opt", f"--pass-pipeline={AIE_LOWER_TO_LLVM()}", file_with_addresses, "-o", file_opt_with_addresses] + self.emit_bytecode_flags())
 
                 file_llvmir = self.prepend_tmp("input.ll")
                 await self.do_call(progress_bar.task, ["aie-translate", "--mlir-to-llvmir", file_opt_with_addresses, "-o", file_llvmir])
 
                 self.unified_file_core_obj = self.prepend_tmp("input.o")
-                if opts.compile and opts.xchesscc:
+                stage_key = None
+                if self.stages and opts.compile:
+                    stage_key = self.stages.key(self.tool_flags(aie_target, "unified-object"), [file_llvmir])
+                cache_key = None
+                if self.compile_cache and opts.compile:
+                    cache_key = self.cache_key(aie_target, "unified-object", [file_llvmir])
+                if stage_key and self.stages.up_to_date("unified-object", stage_key, [self.unified_file_core_obj]):
+                    if self.opts.verbose:
+                        print(f"Keeping {self.unified_file_core_obj}")
+                    stage_key = None
+                    cache_key = None
+                elif cache_key and self.compile_cache.fetch(cache_key, self.unified_file_core_obj):
+                    if self.opts.verbose:
+                        print(f"Using cached {self.unified_file_core_obj}")
+                    cache_key = None
+                elif opts.compile and opts.xchesscc:
                     file_llvmir_hacked = await self.chesshack(progress_bar.task, file_llvmir, chess_intrinsic_wrapper_ll_path)
                     await self.do_call(progress_bar.task, ["xchesscc_wrapper", aie_target.lower(), "+w", self.prepend_tmp("work"), "-c", "-d", "-f", "+P", "4", file_llvmir_hacked, "-o", self.unified_file_core_obj])
                 elif opts.compile:
                     file_llvmir_opt = self.prepend_tmp("input.opt.ll")
                     await self.do_call(progress_bar.task, [self.peano_opt_path, "--passes=default<O2>", "-inline-threshold=10", "-S", file_llvmir, "-o", file_llvmir_opt])
                     await self.do_call(progress_bar.task, [self.peano_llc_path, file_llvmir_opt, "-O2", "--march=" + aie_target.lower(), "--function-sections", "--filetype=obj", "-o", self.unified_file_core_obj])
+                if cache_key:
+                    self.compile_cache.store(cache_key, self.unified_file_core_obj)
+                if stage_key and not self.stopall:
+                    self.stages.update("unified-object", stage_key)
             # fmt: on
 
             progress_bar.update(progress_bar.task, advance=0, visible=False)
             progress_bar.task_completed = progress_bar.add_task(
                 "[green] AIE Compilation:",
-                total=len(cores) + 1,
+                total=len(compiled_cores) + 1,
                 command="%d Workers" % nworkers,
             )
 
@@ -1060,7 +1815,7 @@ class FlowRunner:
             processes = []
             if opts.aiesim:
                 processes.append(self.gen_sim(progress_bar.task, aie_target))
-            for core in cores:
+            for core in compiled_cores:
                 processes.append(
                     self.process_core(
                         core,
@@ -1072,11 +1827,18 @@ class FlowRunner:
                 )
             await asyncio.gather(*processes)
 
+            if opts.ipu and self.overlays and not self.stopall:
+                await self.process_ipu(file_with_addresses)
+
             # Must have elfs, before we build the final binary assembly
             if opts.cdo and opts.execute:
-                await self.process_cdo()
+                if self.time_trace:
+                    with self.time_trace.span("generate_cdo", "in-process"):
+                        await self.process_cdo()
+                else:
+                    await self.process_cdo()
             if opts.cdo or opts.xcl:
-                await self.process_xclbin_gen(bool(len(cores)))
+                await self.process_xclbin_gen(sorted({c[0] for c in cores}))
 
     def dumpprofile(self):
         sortedruntimes = sorted(
@@ -1155,6 +1917,13 @@ def run(mlir_module, args=None):
     if opts.profiling:
         runner.dumpprofile()
 
+    if opts.time_trace:
+        critical = runner.time_trace.write(opts.time_trace)
+        if opts.verbose:
+            print("Critical path:")
+            for e in critical:
+                print(f"{e['dur'] / 1e6:.4f} sec: {e['name']}")
+
 
 def main():
     global opts
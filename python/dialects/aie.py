@@ -23,7 +23,6 @@ from ..extras.meta import region_op
 from ..extras.util import (
     Successor,
     _get_sym_name,
-    find_ops,
     find_parent_of_type,
     get_user_code_loc,
     region_adder,
@@ -81,6 +80,24 @@ class Call(CallOp):
             )
 
 
+# Call a chain of kernels one after the other in the current core.
+#
+# Each stage is a pair of an external function and a function building the
+# arguments of its call from the line it reads and the line it writes. The
+# first stage reads `source`, the last one writes `sink`, and each stage hands
+# its output to the next through a buffer of `scratch`, local to the core:
+# unlike an objectFifo from the core to itself, this needs no locks.
+def call_chain(stages, source, sink, scratch=()):
+    if len(scratch) != len(stages) - 1:
+        raise ValueError(
+            f"a chain of {len(stages)} stages needs {len(stages) - 1} "
+            f"scratch buffers, got {len(scratch)}"
+        )
+    lines = [source, *scratch, sink]
+    for (func, args), src, dst in zip(stages, lines, lines[1:]):
+        Call(func, args(src, dst))
+
+
 def bd_dim_layout(size, stride):
     return Attribute.parse(f"#aie.bd_dim_layout<{size=}, {stride=}>")
 
@@ -143,8 +160,14 @@ Device = DeviceOp
 
 class Core(CoreOp):
     # Until https://github.com/llvm/llvm-project/pull/73620 gets figured out.
-    def __init__(self, tile, link_with=None):
-        super().__init__(result=T.index(), tile=tile, link_with=link_with)
+    def __init__(self, tile, link_with=None, overlays=None, overlay_size=None):
+        super().__init__(
+            result=T.index(),
+            tile=tile,
+            link_with=link_with,
+            overlays=overlays,
+            overlay_size=overlay_size,
+        )
 
 
 # Create an aie buffer of (shape x datatype) on given tile.
@@ -194,6 +217,10 @@ class OrderedObjectBuffer(ObjectFifoCreateOp):
         datatype,
         dimensionsToStream=None,
         dimensionsFromStreamPerConsumer=None,
+        padDimensions=None,
+        compression=None,
+        stream=None,
+        repeat_count=None,
     ):
         if dimensionsFromStreamPerConsumer is None:
             dimensionsFromStreamPerConsumer = []
@@ -216,6 +243,10 @@ class OrderedObjectBuffer(ObjectFifoCreateOp):
             elem_type=TypeAttr.get(of_Ty),
             dimensionsToStream=dimensionsToStream,
             dimensionsFromStreamPerConsumer=dimensionsFromStreamPerConsumer,
+            padDimensions=padDimensions,
+            compression=compression,
+            stream=stream,
+            repeat_count=repeat_count,
         )
 
 
@@ -447,6 +478,7 @@ def flow(
     dest=None,
     dest_bundle=None,
     dest_channel=None,
+    bandwidth=None,
 ):
     assert dest is not None
     if source_bundle is None:
@@ -458,10 +490,95 @@ def flow(
     if dest_channel is None:
         dest_channel = 0
     return FlowOp(
-        source, source_bundle, source_channel, dest, dest_bundle, dest_channel
+        source,
+        source_bundle,
+        source_channel,
+        dest,
+        dest_bundle,
+        dest_channel,
+        bandwidth=bandwidth,
     )
 
 
+# The tiles, flows, locks and buffers of a device by tile, so that the find_*
+# helpers look up the ops of the tiles they are given instead of walking the
+# whole device on every call. The index is brought up to date when the ops of
+# the device change: the ops appended at the end of the device since the last
+# lookup are added to it, and it is rebuilt after any other change.
+class _DeviceIndex:
+    def __init__(self, device):
+        self.device = device.operation
+        self.ops = device.regions[0].blocks[0].operations
+        self.size = 0
+        self.last = None
+        self._clear()
+
+    def _clear(self):
+        self.tiles = {}
+        self.flows_from = {}
+        self.flows_to = {}
+        self.locks = {}
+        self.buffers = {}
+
+    def _add(self, op):
+        if isinstance(op, TileOp):
+            self.tiles[int(op.col), int(op.row)] = op
+        elif isinstance(op, FlowOp):
+            _add_to(self.flows_from, op.source, op)
+            _add_to(self.flows_to, op.dest, op)
+        elif isinstance(op, LockOp):
+            _add_to(self.locks, op.tile, op)
+        elif isinstance(op, BufferOp):
+            _add_to(self.buffers, op.tile, op)
+
+    def update(self):
+        size = len(self.ops)
+        last = self.ops[size - 1].operation if size else None
+        if size == self.size and last == self.last:
+            return self
+        appended = size > self.size and (
+            self.size and self.ops[self.size - 1].operation == self.last
+        )
+        if appended:
+            new_ops = [self.ops[i] for i in range(self.size, size)]
+        else:
+            self._clear()
+            new_ops = self.ops
+        for op in new_ops:
+            self._add(op)
+        self.size, self.last = size, last
+        return self
+
+
+_device_index = None
+
+
+def _get_device_index(device):
+    global _device_index
+    if _device_index is None or _device_index.device != device.operation:
+        _device_index = _DeviceIndex(device)
+    return _device_index.update()
+
+
+def _tile_key(tile):
+    return int(tile.col), int(tile.row)
+
+
+def _add_to(ops_by_tile, tile, op):
+    ops_by_tile.setdefault(_tile_key(tile.owner.opview), []).append(op)
+
+
+def _tile_keys(tiles):
+    # The tiles may also be given as a TileArray.
+    if hasattr(tiles, "df"):
+        tiles = np.asarray(tiles.df).flatten()
+    return {_tile_key(t) for t in tiles if t is not None}
+
+
+def _unique_ops(ops):
+    return list({op.operation: op for op in ops}.values())
+
+
 def find_matching_flows(
     tiles,
     filter_source=False,
@@ -502,8 +619,12 @@ def find_matching_flows(
                 )
             )
 
+    index = _get_device_index(device)
+    candidates = []
+    for key in _tile_keys(tiles):
+        candidates += index.flows_from.get(key, []) + index.flows_to.get(key, [])
     return sorted(
-        find_ops(device, _cb),
+        filter(_cb, _unique_ops(candidates)),
         key=lambda a: (
             int(a.source.owner.opview.col),
             int(a.source.owner.opview.row),
@@ -533,8 +654,10 @@ def find_matching_locks(tiles, sym_name=None, annot=None, device=None):
                 )
             )
 
+    index = _get_device_index(device)
+    candidates = [op for key in _tile_keys(tiles) for op in index.locks.get(key, [])]
     return sorted(
-        [o.result for o in find_ops(device, _cb)],
+        [o.result for o in filter(_cb, candidates)],
         key=lambda a: (
             int(a.owner.opview.tile.owner.opview.col),
             int(a.owner.opview.tile.owner.opview.row),
@@ -559,8 +682,10 @@ def find_matching_buffers(tiles, sym_name=None, annot=None, device=None):
                 )
             )
 
+    index = _get_device_index(device)
+    candidates = [op for key in _tile_keys(tiles) for op in index.buffers.get(key, [])]
     return sorted(
-        [o.result for o in find_ops(device, _cb)],
+        [o.result for o in filter(_cb, candidates)],
         key=lambda a: (
             int(a.owner.opview.tile.owner.opview.col),
             int(a.owner.opview.tile.owner.opview.row),
@@ -580,7 +705,10 @@ def find_neighbors(tile, device=None, logical=True):
     if device is None:
         device = find_parent_of_type(lambda op: isinstance(op, DeviceOp))
 
-    assert int(device.device) == int(AIEDevice.ipu), "only ipu supported"
+    assert int(device.device) in (
+        int(AIEDevice.ipu),
+        int(AIEDevice.npu),
+    ), "only ipu and npu supported"
 
     neighbors = {}
     col, row = map(int, (tile.col, tile.row))
@@ -602,11 +730,10 @@ def find_neighbors(tile, device=None, logical=True):
 
     neighbors_ = {"north": None, "west": None, "south": None}
 
-    for n in find_ops(
-        device,
-        lambda op: isinstance(op, TileOp) and (int(op.col), int(op.row)) in neighbors,
-    ):
-        neighbors_[neighbors[int(n.col), int(n.row)]] = n
+    index = _get_device_index(device)
+    for key, direction in neighbors.items():
+        if key in index.tiles:
+            neighbors_[direction] = index.tiles[key]
 
     return Neighbors(**neighbors_)
 
@@ -651,3 +778,30 @@ class TileOp(TileOp):
 
 def tile(col, row, *, loc=None, ip=None):
     return TileOp(col=col, row=row, loc=loc, ip=ip)
+
+
+# Create the tiles of the given columns and rows, indexed by column then row.
+# cols and rows are either counts, starting from 0, or lists of indices.
+def tiles(cols, rows, *, loc=None, ip=None):
+    if isinstance(cols, int):
+        cols = range(cols)
+    if isinstance(rows, int):
+        rows = range(rows)
+    return [[TileOp(col=c, row=r, loc=loc, ip=ip) for r in rows] for c in cols]
+
+
+# Create an objectFifo from each producer to its consumers, named
+# <name>_<i>. Each element of consumers is a tile or a list of tiles.
+def object_fifos(name, producers, consumers, depth, datatype, **kwargs):
+    assert len(producers) == len(consumers), "one set of consumers per producer"
+    return [
+        OrderedObjectBuffer(
+            f"{name}_{i}",
+            producer,
+            consumer if isinstance(consumer, (list, tuple)) else [consumer],
+            depth,
+            datatype,
+            **kwargs,
+        )
+        for i, (producer, consumer) in enumerate(zip(producers, consumers))
+    ]
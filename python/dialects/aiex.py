@@ -46,6 +46,12 @@ class IpuDmaMemcpyNd(IpuDmaMemcpyNdOp):
         offsets: MixedValues = None,
         sizes: MixedValues = None,
         strides: MixedValues = None,
+        ring_slots=None,
+        doorbell=None,
+        persistent=None,
+        burst_length=None,
+        ax_cache=None,
+        ax_qos=None,
     ):
         x = 0
         y = 0
@@ -74,6 +80,12 @@ class IpuDmaMemcpyNd(IpuDmaMemcpyNdOp):
             static_strides,
             metadata,
             bd_id,
+            ring_slots=ring_slots,
+            doorbell=doorbell,
+            persistent=persistent,
+            burst_length=burst_length,
+            ax_cache=ax_cache,
+            ax_qos=ax_qos,
         )
 
 
@@ -118,34 +130,15 @@ def _get_prolog():
     return _PROLOG[:]
 
 
-# based on https://github.com/Xilinx/mlir-aie/blob/cb232a43383ef3b8efd8b408545c9b74885578ad/lib/Targets/AIETargetIPU.cpp
+# The instructions are encoded by the encoders of AIETargetIPU.cpp.
 def _ipu_sync(column, row=0, direction=0, channel=0, column_num=1, row_num=1):
     if isinstance(channel, IntegerAttr):
         channel = int(channel)
-    words = [None] * 2
-    op_code = 3
-    words[0] = (op_code & 0xFF) << 24
-    words[0] |= (column & 0xFF) << 16
-    words[0] |= (row & 0xFF) << 8
-    words[0] |= direction & 0x1
-
-    words[1] = (channel & 0xFF) << 24
-    words[1] |= (column_num & 0xFF) << 16
-    words[1] |= (row_num & 0xFF) << 8
-    assert not any(w is None for w in words)
-    return words
+    return ipu_encode_sync(column, row, direction, channel, column_num, row_num)
 
 
 def _ipu_write32(column, row, address, value):
-    words = [None] * 3
-    op_code = 2
-    words[0] = (op_code & 0xFF) << 24
-    words[0] |= (column & 0xFF) << 16
-    words[0] |= (row & 0xFF) << 8
-    words[1] = address
-    words[2] = value
-    assert not any(w is None for w in words)
-    return words
+    return ipu_encode_write32(column, row, address, value)
 
 
 def _ipu_shimtile_push_queue(channel_dir, channel_index, column, bd_id, repeats=0):
@@ -219,6 +212,9 @@ def _ipu_writebd_shimtile(
     next_bd=0,
     use_next_bd=0,
     data_width=32,
+    burst_length=256,
+    ax_cache=0,
+    ax_qos=0,
 ):
     d2_stride -= 1
     d1_stride -= 1
@@ -233,61 +229,31 @@ def _ipu_writebd_shimtile(
     if d0_size is None:
         d0_size = 0
 
-    column_num = 1
-    enable_packet = 0
-    out_of_order_id = 0
-    packet_id = 0
-    packet_type = 0
-    valid_bd = 1
-
-    words = [None] * 10
-    op_code = 6
-    words[0] = (op_code & 0xFF) << 24
-    words[0] |= (column & 0xFF) << 16
-    words[0] |= (column_num & 0xFF) << 8
-    words[0] |= (ddr_id & 0xF) << 4
-    words[0] |= bd_id & 0xF
-
-    # TODO: Address Incr
-    words[1] = 0
-    words[2] = buffer_length
-    words[3] = buffer_offset
-
-    # En Packet , OoO BD ID , Packet ID , Packet Type
-    words[4] = (enable_packet & 0x1) << 30
-    words[4] |= (out_of_order_id & 0x3F) << 24
-    words[4] |= (packet_id & 0x1F) << 19
-    words[4] |= (packet_type & 0x7) << 16
-
-    # TODO: Secure Access
-    words[5] = (d0_size & 0x3FF) << 20
-    words[5] |= d0_stride & 0xFFFFF
-
-    # burst length;
-    words[6] = 0x80000000
-    words[6] |= (d1_size & 0x3FF) << 20
-    words[6] |= d1_stride & 0xFFFFF
-
-    # TODO: SIMID, AxCache, AXQoS
-    words[7] = d2_stride & 0xFFFFF
-
-    words[8] = (iteration_current & 0x3F) << 26
-    words[8] |= (iteration_size & 0x3F) << 20
-    words[8] |= iteration_stride & 0xFFFFF
-
-    # TODO: TLAST Suppress
-    words[9] = (next_bd & 0xF) << 27
-    words[9] |= (use_next_bd & 0x1) << 26
-    words[9] |= (valid_bd & 0x1) << 25
-    words[9] |= (lock_rel_val & 0xEF) << 18
-    words[9] |= (lock_rel_id & 0xF) << 13
-    words[9] |= (lock_acq_enable & 0x1) << 12
-    words[9] |= (lock_acq_val & 0xEF) << 5
-    words[9] |= lock_acq_id & 0xF
-
-    assert not any(w is None for w in words)
-
-    return words
+    return ipu_encode_writebd_shimtile(
+        column=column,
+        ddr_id=ddr_id,
+        bd_id=bd_id,
+        buffer_length=buffer_length,
+        buffer_offset=buffer_offset,
+        d0_size=d0_size,
+        d0_stride=d0_stride,
+        d1_size=d1_size,
+        d1_stride=d1_stride,
+        d2_stride=d2_stride,
+        iteration_current=iteration_current,
+        iteration_size=iteration_size,
+        iteration_stride=iteration_stride,
+        next_bd=next_bd,
+        use_next_bd=use_next_bd,
+        lock_rel_val=lock_rel_val,
+        lock_rel_id=lock_rel_id,
+        lock_acq_enable=lock_acq_enable,
+        lock_acq_val=lock_acq_val,
+        lock_acq_id=lock_acq_id,
+        burst_length=burst_length,
+        ax_cache=ax_cache,
+        ax_qos=ax_qos,
+    )
 
 
 class ipu:
@@ -528,7 +494,7 @@ class TileArray:
             if isinstance(rows, int):
                 rows = list(range(rows))
             assert isinstance(cols, (list, tuple)) and isinstance(rows, (list, tuple))
-            df = np.array([[aie.tile(c, r) for r in rows] for c in cols])
+            df = np.array(aie.tiles(cols, rows))
         self.df = df
         self.channels = np.empty_like(df, dtype=object)
 
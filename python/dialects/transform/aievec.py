@@ -0,0 +1,92 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# The AIEVec transform ops, and schedules built from them and from the upstream
+# transform ops, for tuning AIE kernels from Python.
+#
+# E.g., to tile a matmul into 64x64x64 blocks and vectorize each block with
+# aievec.matmul:
+#
+#   @sequence([], transform.FailurePropagationMode.Propagate, [])
+#   def schedule(module):
+#       matmul = structured.MatchOp.match_op_names(module, ["linalg.matmul"])
+#       schedule_matmul(matmul, [64, 64, 64])
+
+from typing import Optional, Sequence
+
+# noinspection PyUnresolvedReferences
+from .._aievec_transform_ops_gen import *
+from . import AnyOpType, loop, structured
+from ...ir import IntegerType, FloatType, Type, Value
+
+# The width of the vector registers of AIE2, in bits.
+AIEML_VECTOR_BITS = 512
+
+
+def lane_count(element_type: Type, vector_bits: int = AIEML_VECTOR_BITS) -> int:
+    """The number of lanes of a vector register of `element_type` elements."""
+    if IntegerType.isinstance(element_type):
+        width = IntegerType(element_type).width
+    elif FloatType.isinstance(element_type):
+        width = FloatType(element_type).width
+    else:
+        raise ValueError(f"no vector of {element_type}")
+    return vector_bits // width
+
+
+def tile(target: Value, tile_sizes: Sequence[int]) -> structured.TileUsingForOp:
+    """Tile `target` into `tile_sizes` with scf.for loops.
+
+    The tiled op is `.tiled_linalg_op` and the loops `.loops` of the result.
+    """
+    return structured.TileUsingForOp(target, sizes=tile_sizes)
+
+
+def vectorize(target: Value, vector_sizes: Optional[Sequence[int]] = None):
+    """Vectorize `target`, with `vector_sizes` if its shape is dynamic.
+
+    Choose the innermost size with `lane_count` for the op to map to full
+    vector registers.
+    """
+    structured.VectorizeOp(target, vector_sizes=vector_sizes)
+
+
+def pack_for_mmul(target: Value) -> Value:
+    """Pack the matmul `target` into tiles of the shape of aievec.matmul."""
+    return PackForMMulOp(AnyOpType.get(), target).packed_op
+
+
+def vectorize_contraction(target: Value) -> Value:
+    """Vectorize the packed contraction `target` into vector.contract ops."""
+    return VectorizeContractionOp(AnyOpType.get(), target).result
+
+
+def split_accumulators(target: Value, factor: int = 2) -> Value:
+    """Unroll the loop `target` by `factor`, with `factor` accumulators for each
+    of its additive reductions."""
+    return SplitAccumulatorsOp(AnyOpType.get(), target, factor=factor).transformed
+
+
+def hoist_loads(target: Value):
+    """Hoist the loads of the loop `target` of buffers it does not write."""
+    HoistLoopInvariantLoadsOp(target)
+
+
+def unroll(target: Value, factor: int):
+    """Unroll the loop `target` by `factor`."""
+    loop.LoopUnrollOp(target, factor=factor)
+
+
+def schedule_matmul(target: Value, tile_sizes: Sequence[int]) -> Value:
+    """Tile the matmul `target` into `tile_sizes` blocks, pack each block for
+    aievec.matmul and vectorize it. Return the vectorized block."""
+    tiled = tile(target, tile_sizes)
+    return vectorize_contraction(pack_for_mmul(tiled.tiled_linalg_op))
+
+
+def schedule_vector_loop(target: Value, accumulators: int = 2) -> Value:
+    """Hoist the loads of the vectorized loop `target` that do not change
+    between its iterations, and split its accumulators in `accumulators` for
+    consecutive MACs not to wait on each other. Return the new loop."""
+    hoist_loads(target)
+    return split_accumulators(target, accumulators)
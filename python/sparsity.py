@@ -0,0 +1,108 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Prune and pack weights for the sparse matmul of AIE2.
+
+The sparse MACs of AIE2 multiply a 4x16 block of A by a 16x8 block of B
+keeping at most two of every four consecutive elements of each column of B,
+along K.  The blocks of B are stored compressed: a 128-bit mask with bit
+k * 8 + n set when element (k, n) is kept, in little-endian 32-bit words,
+followed by the 8x8 kept elements, row 2 * g + j holding the j-th kept
+element of group g of each column, padded with zeros.  That's 80 bytes per
+block instead of 128.
+
+matmul_sparse_i8_i32 of the matmul kernels takes a k x n submatrix of B as
+the packed blocks of its columns of blocks in turn, each from the top:
+
+    b = prune(weights)
+    packed = pack(b)
+    assert (unpack(packed, *b.shape) == b).all()
+"""
+
+import numpy as np
+
+# The shape of the blocks of B and the sparsity of their columns.
+BLOCK_K = 16
+BLOCK_N = 8
+GROUP = 4
+KEPT = 2
+
+MASK_BYTES = BLOCK_K * BLOCK_N // 8
+BLOCK_BYTES = MASK_BYTES + BLOCK_K * KEPT // GROUP * BLOCK_N
+
+
+def prune(b):
+    """Zero all but the KEPT largest magnitudes of each group of GROUP
+    consecutive elements along K of each column of b."""
+    k, n = b.shape
+    if k % GROUP:
+        raise ValueError(f"K = {k} isn't a multiple of {GROUP}")
+    groups = b.reshape(k // GROUP, GROUP, n)
+    # Stable sort, so that ties keep the first elements of the group.
+    order = np.argsort(-np.abs(groups.astype(np.int64)), axis=1, kind="stable")
+    keep = np.zeros(groups.shape, dtype=bool)
+    np.put_along_axis(keep, order[:, :KEPT, :], True, axis=1)
+    return np.where(keep, groups, 0).reshape(k, n).astype(b.dtype)
+
+
+def is_sparse(b):
+    """Whether each group of GROUP elements along K of each column of b has at
+    most KEPT non-zero elements."""
+    k, n = b.shape
+    if k % GROUP:
+        return False
+    return bool(((b.reshape(k // GROUP, GROUP, n) != 0).sum(axis=1) <= KEPT).all())
+
+
+def pack_block(block):
+    """The mask and the compressed elements of a BLOCK_K x BLOCK_N block."""
+    if not is_sparse(block):
+        raise ValueError("more than 2 of 4 elements along K are non-zero")
+    mask = (block != 0).reshape(-1)
+    values = np.zeros((BLOCK_K * KEPT // GROUP, BLOCK_N), dtype=block.dtype)
+    for g in range(BLOCK_K // GROUP):
+        for col in range(BLOCK_N):
+            group = block[g * GROUP : (g + 1) * GROUP, col]
+            kept = group[group != 0]
+            values[g * KEPT : g * KEPT + len(kept), col] = kept
+    words = np.packbits(mask, bitorder="little").view("<u4")
+    return words, values
+
+
+def pack(b):
+    """The packed bytes of a k x n int8 matrix with 2:4 sparsity, its blocks
+    in the order matmul_sparse_i8_i32 reads them."""
+    k, n = b.shape
+    if k % BLOCK_K or n % BLOCK_N:
+        raise ValueError(f"{k}x{n} isn't made of {BLOCK_K}x{BLOCK_N} blocks")
+    out = bytearray()
+    for j in range(n // BLOCK_N):
+        for i in range(k // BLOCK_K):
+            block = b[i * BLOCK_K : (i + 1) * BLOCK_K, j * BLOCK_N : (j + 1) * BLOCK_N]
+            words, values = pack_block(block.astype(np.int8))
+            out += words.tobytes()
+            out += values.tobytes()
+    return np.frombuffer(bytes(out), dtype=np.int8)
+
+
+def unpack(packed, k, n):
+    """The dense k x n matrix of packed bytes."""
+    packed = np.asarray(packed, dtype=np.int8)
+    if packed.size != (k // BLOCK_K) * (n // BLOCK_N) * BLOCK_BYTES:
+        raise ValueError(f"{packed.size} bytes don't pack a {k}x{n} matrix")
+    b = np.zeros((k, n), dtype=np.int8)
+    blocks = packed.reshape(-1, BLOCK_BYTES)
+    index = 0
+    for j in range(n // BLOCK_N):
+        for i in range(k // BLOCK_K):
+            data = blocks[index].view(np.uint8)
+            index += 1
+            mask = np.unpackbits(data[:MASK_BYTES], bitorder="little")
+            mask = mask.reshape(BLOCK_K, BLOCK_N).astype(bool)
+            values = data[MASK_BYTES:].view(np.int8).reshape(-1, BLOCK_N)
+            block = b[i * BLOCK_K : (i + 1) * BLOCK_K, j * BLOCK_N : (j + 1) * BLOCK_N]
+            for g in range(BLOCK_K // GROUP):
+                for col in range(BLOCK_N):
+                    rows = np.nonzero(mask[g * GROUP : (g + 1) * GROUP, col])[0]
+                    for r, row in enumerate(rows):
+                        block[g * GROUP + row, col] = values[g * KEPT + r, col]
+    return b
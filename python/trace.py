@@ -0,0 +1,354 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Decode the trace buffers written by the -aie-insert-trace pass.
+
+The buffer is a sequence of 8 word packets: a header identifying the tile and
+the module that produced the packet, followed by 7 words of trace frames.
+The frames of each module are decoded into the cycles at which each event
+slot fired, and consecutive cycles are merged into slices, which are written
+as a Chrome trace event file that Perfetto (ui.perfetto.dev) opens as a
+timeline, with a track per traced event of each module. Timestamps are in
+cycles of the tiles.
+
+    python3 -m aie.trace trace.txt -o trace.json
+
+With -aie-insert-trace="timestamps=true" and -aie-dma-to-ipu="timestamps=true",
+the shim tiles trace when each transfer of the runtime sequence is issued,
+starts and finishes, which --latencies lists instead:
+
+    python3 -m aie.trace --latencies trace.txt
+
+The timers of the tiles are only comparable when -aie-insert-trace reset
+them together, with its sync-broadcast option; --synced-timers records it in
+the metadata of the timeline.
+"""
+
+import argparse
+import json
+import sys
+from collections import defaultdict
+
+# Core events selected by default by -aie-insert-trace, by slot.
+DEFAULT_CORE_EVENTS = [0x21, 0x22, 0x25, 0x17, 0x18, 0x19, 0x1A, 0x1C]
+
+# Names of the AIE2 core module events.
+CORE_EVENT_NAMES = {
+    0x01: "TRUE",
+    0x17: "MEMORY_STALL",
+    0x18: "STREAM_STALL",
+    0x19: "CASCADE_STALL",
+    0x1A: "LOCK_STALL",
+    0x1C: "ACTIVE",
+    0x1D: "DISABLED",
+    0x21: "INSTR_EVENT_0",
+    0x22: "INSTR_EVENT_1",
+    0x23: "INSTR_CALL",
+    0x24: "INSTR_RETURN",
+    0x25: "INSTR_VECTOR",
+    0x26: "INSTR_LOAD",
+    0x27: "INSTR_STORE",
+    0x28: "INSTR_STREAM_GET",
+    0x29: "INSTR_STREAM_PUT",
+    0x2A: "INSTR_CASCADE_GET",
+    0x2B: "INSTR_CASCADE_PUT",
+    0x2C: "INSTR_LOCK_ACQUIRE_REQ",
+    0x2D: "INSTR_LOCK_RELEASE_REQ",
+    0x4B: "PORT_RUNNING_0",
+}
+
+# Shim events traced by -aie-insert-trace="timestamps=true", by slot.
+DEFAULT_SHIM_EVENTS = [126, 127, 16, 24, 17, 25, 14, 22]
+
+# Names of the AIE2 shim PL module events.
+SHIM_EVENT_NAMES = {
+    14: "DMA_S2MM_0_START_TASK",
+    15: "DMA_S2MM_1_START_TASK",
+    16: "DMA_MM2S_0_START_TASK",
+    17: "DMA_MM2S_1_START_TASK",
+    22: "DMA_S2MM_0_FINISHED_TASK",
+    23: "DMA_S2MM_1_FINISHED_TASK",
+    24: "DMA_MM2S_0_FINISHED_TASK",
+    25: "DMA_MM2S_1_FINISHED_TASK",
+    126: "USER_EVENT_0",
+    127: "USER_EVENT_1",
+}
+
+# The slots of the shim events marking the issue of the transfers of each
+# direction, and the start and end of their tasks.
+SHIM_TRANSFER_SLOTS = {
+    "MM2S": ([0], [2, 4], [3, 5]),
+    "S2MM": ([1], [6], [7]),
+}
+
+PACKET_WORDS = 8
+SHIM_PACKET_TYPE = 2
+MODULES = {0: "core", 1: "memory", SHIM_PACKET_TYPE: "shim"}
+
+
+def split_packets(words):
+    """Group the payload words of the packets by (col, row, packet type)."""
+    streams = defaultdict(list)
+    for i in range(0, len(words) - PACKET_WORDS + 1, PACKET_WORDS):
+        header = words[i]
+        if header == 0:
+            # The rest of the buffer wasn't written.
+            break
+        col = (header >> 21) & 0x7F
+        row = (header >> 16) & 0x1F
+        pkt_type = (header >> 12) & 0x7
+        streams[(col, row, pkt_type)].extend(words[i + 1 : i + PACKET_WORDS])
+    return streams
+
+
+def _bits(byte_stream, pos, count):
+    value = 0
+    for b in range(pos, pos + count):
+        value = (value << 1) | ((byte_stream[b // 8] >> (7 - b % 8)) & 1)
+    return value
+
+
+# Event trace frames, matched by prefix: (prefix, prefix bits, frame bits,
+# event bits, kind). The remaining bits of Single and Multiple frames count
+# the cycles since the previous frame; the ones of Repeat frames count the
+# repetitions of the previous frame.
+FRAMES = [
+    (0b0, 1, 8, 3, "single"),
+    (0b1000, 4, 16, 3, "single"),
+    (0b1001, 4, 24, 3, "single"),
+    (0b1010, 4, 16, 8, "multiple"),
+    (0b1011, 4, 24, 8, "multiple"),
+    (0b1100, 4, 32, 8, "multiple"),
+    (0b1101, 4, 8, 0, "repeat"),
+    (0b1110, 4, 16, 0, "repeat"),
+]
+
+
+def decode_frames(payload):
+    """Return the (cycle, event slot mask) of the frames of a module.
+
+    The frames are a bit stream, read from the most significant bit of each
+    payload word. A Start frame (0xF0) carries the 56-bit timer of the tile,
+    which the cycles of the following frames are counted from.
+    """
+    data = b"".join(w.to_bytes(4, "big") for w in payload)
+    nbits = 8 * len(data)
+    pos = 0
+    cycle = None
+    last_mask = 0
+    samples = []
+    while pos + 8 <= nbits:
+        byte = _bits(data, pos, 8)
+        if byte == 0xF0:
+            if pos + 64 > nbits:
+                break
+            cycle = _bits(data, pos + 8, 56)
+            pos += 64
+            continue
+        if byte >> 4 == 0xF:
+            # Filler and control frames.
+            pos += 8
+            continue
+        for prefix, prefix_bits, frame_bits, event_bits, kind in FRAMES:
+            if _bits(data, pos, prefix_bits) == prefix:
+                break
+        if pos + frame_bits > nbits:
+            break
+        field = _bits(
+            data, pos + prefix_bits + event_bits, frame_bits - prefix_bits - event_bits
+        )
+        events = _bits(data, pos + prefix_bits, event_bits)
+        pos += frame_bits
+        if cycle is None:
+            # Frames before the first Start frame have no time reference.
+            continue
+        if kind == "repeat":
+            for _ in range(field):
+                cycle += 1
+                samples.append((cycle, last_mask))
+            continue
+        cycle += field
+        last_mask = 1 << events if kind == "single" else events
+        samples.append((cycle, last_mask))
+    return samples
+
+
+def to_slices(samples):
+    """Merge the consecutive cycles at which each slot fired into slices."""
+    slices = defaultdict(list)
+    for cycle, mask in samples:
+        for slot in range(8):
+            if not mask & (1 << slot):
+                continue
+            ranges = slices[slot]
+            if ranges and ranges[-1][1] >= cycle:
+                ranges[-1][1] = cycle + 1
+            else:
+                ranges.append([cycle, cycle + 1])
+    return slices
+
+
+def to_perfetto(words, core_events=None, mem_events=None, synced_timers=False):
+    """Return the Chrome trace events of a trace buffer.
+
+    Its metadata tells whether the timers of the tiles were reset together,
+    in which case the timelines of all the modules share their time origin.
+    """
+    core_events = core_events or DEFAULT_CORE_EVENTS
+    mem_events = mem_events or []
+    trace = []
+    for pid, ((col, row, pkt_type), payload) in enumerate(
+        sorted(split_packets(words).items())
+    ):
+        module = MODULES.get(pkt_type, f"type {pkt_type}")
+        selected = {0: core_events, 1: mem_events}.get(
+            pkt_type, DEFAULT_SHIM_EVENTS
+        )
+        names = {0: CORE_EVENT_NAMES, SHIM_PACKET_TYPE: SHIM_EVENT_NAMES}.get(
+            pkt_type, {}
+        )
+        trace.append(
+            {
+                "name": "process_name",
+                "ph": "M",
+                "pid": pid,
+                "args": {"name": f"{module} ({col}, {row})"},
+            }
+        )
+        for slot, ranges in sorted(to_slices(decode_frames(payload)).items()):
+            if slot < len(selected):
+                event = selected[slot]
+                name = names.get(event, f"event 0x{event:x}")
+            else:
+                name = f"slot {slot}"
+            trace.append(
+                {
+                    "name": "thread_name",
+                    "ph": "M",
+                    "pid": pid,
+                    "tid": slot,
+                    "args": {"name": name},
+                }
+            )
+            for start, end in ranges:
+                trace.append(
+                    {
+                        "name": name,
+                        "ph": "X",
+                        "pid": pid,
+                        "tid": slot,
+                        "ts": start,
+                        "dur": end - start,
+                    }
+                )
+    return {
+        "traceEvents": trace,
+        "displayTimeUnit": "ns",
+        "otherData": {"timers": "synchronized" if synced_timers else "per-tile"},
+    }
+
+
+def transfer_latencies(words):
+    """Return the transfers timed by the shim traces, in the order they were
+    issued, with the cycles they waited in the task queue and the cycles from
+    their issue to the end of their task.
+
+    The n-th transfer issued in a direction of a shim tile is matched with the
+    n-th task started and finished by its traced channels in that direction,
+    so transfers overlapping on both MM2S channels may be matched out of
+    order.
+    """
+    transfers = []
+    for (col, row, pkt_type), payload in sorted(split_packets(words).items()):
+        if pkt_type != SHIM_PACKET_TYPE:
+            continue
+        slices = to_slices(decode_frames(payload))
+
+        def starts(slots):
+            return sorted(start for slot in slots for start, _ in slices[slot])
+
+        for direction, (issue, start, finish) in SHIM_TRANSFER_SLOTS.items():
+            for issued, started, finished in zip(
+                starts(issue), starts(start), starts(finish)
+            ):
+                transfers.append(
+                    {
+                        "col": col,
+                        "direction": direction,
+                        "issued": issued,
+                        "started": started,
+                        "finished": finished,
+                        "queue_cycles": started - issued,
+                        "latency_cycles": finished - issued,
+                    }
+                )
+    transfers.sort(key=lambda t: t["issued"])
+    return transfers
+
+
+def read_words(path, binary=False):
+    """Read a trace buffer from a binary file of little-endian words, or from
+    a text file with one hexadecimal word per line."""
+    if binary:
+        with open(path, "rb") as f:
+            data = f.read()
+        return [
+            int.from_bytes(data[i : i + 4], "little")
+            for i in range(0, len(data) - 3, 4)
+        ]
+    with open(path) as f:
+        return [int(line, 16) for line in f if line.strip()]
+
+
+def _events(value):
+    return [int(e, 0) for e in value.split(",") if e]
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(
+        prog="aie.trace", description="Convert an AIE trace buffer to Perfetto"
+    )
+    parser.add_argument("input", help="trace buffer")
+    parser.add_argument("-o", "--output", help="output file (default: stdout)")
+    parser.add_argument(
+        "--binary",
+        action="store_true",
+        help="the input is a binary file of little-endian words",
+    )
+    parser.add_argument(
+        "--events",
+        type=_events,
+        default=DEFAULT_CORE_EVENTS,
+        help="comma separated core events, as given to -aie-insert-trace",
+    )
+    parser.add_argument(
+        "--mem-events",
+        type=_events,
+        default=[],
+        help="comma separated memory events, as given to -aie-insert-trace",
+    )
+    parser.add_argument(
+        "--synced-timers",
+        action="store_true",
+        help="the timers of the tiles were reset together, by "
+        "-aie-insert-trace with sync-broadcast",
+    )
+    parser.add_argument(
+        "--latencies",
+        action="store_true",
+        help="list the latencies of the transfers timed by the shim traces",
+    )
+    opts = parser.parse_args(argv)
+    words = read_words(opts.input, opts.binary)
+    if opts.latencies:
+        trace = transfer_latencies(words)
+    else:
+        trace = to_perfetto(words, opts.events, opts.mem_events, opts.synced_timers)
+    if opts.output:
+        with open(opts.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,4 +1,419 @@
 # Copyright (C) 2022, Advanced Micro Devices, Inc.
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+from collections import namedtuple
+import concurrent.futures
+import multiprocessing
+import threading
+
 from ._mlir_libs._xrt import *
+
+
+class PartitionPool:
+    """Run batches of the same design on several partitions of the NPUs.
+
+    Each partition is a hardware context of its own XCLBin, which XRT loads at
+    one of the start columns of the xclbin left free, on the device of the
+    given indices in turn.  The batches are dispatched round-robin, or with
+    the "least_loaded" policy to the first partition done with its previous
+    batch, so that faster partitions take more of them:
+
+        pool = PartitionPool("final.xclbin", "MLIR_AIE", partitions=2)
+        pool.load_ipu_instructions(insts)
+        pool.mmap_buffers([(1024,), (1024,)], np.int32)
+        outputs = pool.run_batches(
+            inputs,
+            write=lambda views, batch: np.copyto(np.asarray(views[0]), batch),
+            read=lambda views: np.array(views[1]),
+        )
+    """
+
+    POLICIES = ("round_robin", "least_loaded")
+
+    def __init__(
+        self,
+        xclbin_path,
+        kernel_name,
+        partitions,
+        device_indices=(0,),
+        policy="round_robin",
+    ):
+        if policy not in self.POLICIES:
+            raise ValueError(f"unknown dispatch policy: {policy}")
+        self.xclbins = [
+            XCLBin(xclbin_path, kernel_name, device_indices[i % len(device_indices)])
+            for i in range(partitions)
+        ]
+        self.policy = policy
+        self.views = None
+        self._next = 0
+
+    def load_ipu_instructions(self, insts, patches=(), resident_insts=None):
+        for xclbin in self.xclbins:
+            xclbin.load_ipu_instructions(insts, list(patches))
+            if resident_insts is not None:
+                xclbin.load_resident_ipu_instructions(resident_insts)
+
+    def mmap_buffers(self, shapes, np_format, huge_pages=False):
+        """Map the host buffers of each partition, and return their views."""
+        self.views = [
+            xclbin.mmap_buffers(shapes, np_format, huge_pages)
+            for xclbin in self.xclbins
+        ]
+        return self.views
+
+    def _pick(self, pending):
+        n = len(self.xclbins)
+        if self.policy == "least_loaded":
+            for i in range(n):
+                p = (self._next + i) % n
+                if pending[p] is None or pending[p][1].done():
+                    self._next = (p + 1) % n
+                    return p
+        p = self._next
+        self._next = (p + 1) % n
+        return p
+
+    def run_batches(self, batches, write, read, timeout=None):
+        """Run each batch on a partition, and return the results in order.
+
+        write(views, batch) fills the input buffers of the partition for the
+        batch, and read(views) returns the result of its run from the output
+        buffers.  The partitions run concurrently: a partition only waits for
+        its own previous run before taking the next batch.
+        """
+        if self.views is None:
+            raise RuntimeError("mmap_buffers must be called before run_batches")
+        results = [None] * len(batches)
+        pending = [None] * len(self.xclbins)
+
+        def finish(p):
+            index, run = pending[p]
+            run.wait(timeout)
+            results[index] = read(self.views[p])
+            pending[p] = None
+
+        for index, batch in enumerate(batches):
+            p = self._pick(pending)
+            if pending[p] is not None:
+                finish(p)
+            write(self.views[p], batch)
+            pending[p] = (index, self.xclbins[p].submit())
+        for p in range(len(self.xclbins)):
+            if pending[p] is not None:
+                finish(p)
+        return results
+
+
+class BufferRing:
+    """Cycle the runs of a design through a ring of host buffer sets.
+
+    Each slot of the ring is a buffer set of the XCLBin, so that the host
+    fills the inputs of the next slot while the array runs on the previous
+    ones, and reads the outputs of a slot in place, without copies between
+    the slots.  The producer cursor is the slot handed to the host to fill
+    and submit next, and the consumer cursor the oldest slot submitted,
+    whose run is waited for and read next:
+
+        ring = BufferRing(xclbin, [(1024,), (1024,)], np.int32, slots=3)
+        for batch in batches:
+            if ring.full():
+                results.append(np.array(ring.consume()[1]))
+                ring.release()
+            np.copyto(np.asarray(ring.produce()[0]), batch)
+            ring.submit()
+        while not ring.empty():
+            results.append(np.array(ring.consume()[1]))
+            ring.release()
+
+    The ring maps all the buffers of the XCLBin, its first slot being the
+    default buffer set.  The instructions are shared by all the runs, so the
+    runtime parameters must not be changed while the ring isn't empty.
+    """
+
+    def __init__(self, xclbin, shapes, np_format, slots=2, huge_pages=False):
+        if slots < 1:
+            raise ValueError("a ring needs at least one slot")
+        self.xclbin = xclbin
+        self.slots = slots
+        self.buffer_sets = [0]
+        self.views = [xclbin.mmap_buffers(shapes, np_format, huge_pages)]
+        for _ in range(slots - 1):
+            buffer_set, views = xclbin.mmap_buffer_set(shapes, np_format, huge_pages)
+            self.buffer_sets.append(buffer_set)
+            self.views.append(views)
+        # The number of slots submitted and released since the start: the
+        # cursors are these counts modulo the number of slots.
+        self.produced = 0
+        self.released = 0
+        self._runs = [None] * slots
+
+    @property
+    def producer(self):
+        return self.produced % self.slots
+
+    @property
+    def consumer(self):
+        return self.released % self.slots
+
+    def full(self):
+        return self.produced - self.released == self.slots
+
+    def empty(self):
+        return self.produced == self.released
+
+    def produce(self):
+        """The views of the buffers of the slot to fill next."""
+        if self.full():
+            raise RuntimeError("the ring is full, a slot must be released first")
+        return self.views[self.producer]
+
+    def submit(self):
+        """Start a run on the slot filled, and advance the producer cursor."""
+        if self.full():
+            raise RuntimeError("the ring is full, a slot must be released first")
+        slot = self.producer
+        self._runs[slot] = self.xclbin.submit(self.buffer_sets[slot])
+        self.produced += 1
+
+    def consume(self, timeout=None):
+        """Wait for the run of the oldest slot submitted, and return the views
+        of its buffers, which stay valid until the slot is released."""
+        if self.empty():
+            raise RuntimeError("the ring is empty, no slot was submitted")
+        self._runs[self.consumer].wait(timeout)
+        return self.views[self.consumer]
+
+    def release(self, timeout=None):
+        """Hand the oldest slot back to the producer, once its run is done."""
+        if self.empty():
+            raise RuntimeError("the ring is empty, no slot was submitted")
+        self._runs[self.consumer].wait(timeout)
+        self._runs[self.consumer] = None
+        self.released += 1
+
+
+class DesignManager:
+    """Serve several designs on the NPUs, each preloaded in a hardware
+    context, and switch between them without loading anything.
+
+    Loading an xclbin in a hardware context takes much longer than a run.
+    The manager keeps the XCLBin of each design preloaded, with its
+    instructions loaded and its buffers mapped, so switching to a design
+    only returns it.  Designs of the same xclbin and device share its
+    context and the kernels opened in it.  The NPU only holds a few
+    contexts, so at most max_contexts are kept loaded.  The least recently
+    used one is unloaded to make room for another, with its designs.  Those
+    designs are loaded again when they are next switched to:
+
+        designs = DesignManager(max_contexts=4)
+        designs.preload("a", "a.xclbin", "MLIR_AIE", insts_a, shapes_a, np.int32)
+        designs.preload("b", "b.xclbin", "MLIR_AIE", insts_b, shapes_b, np.int8)
+        xclbin = designs.switch("b")
+        np.copyto(np.asarray(designs.views("b")[0]), batch)
+        xclbin.sync_buffers_to_device()
+        xclbin.run()
+
+    A context is only released once the XCLBins created from it are no longer
+    referenced, so the XCLBins and views of a design should not be kept
+    across switches.
+    """
+
+    def __init__(self, max_contexts=None):
+        if max_contexts is not None and max_contexts < 1:
+            raise ValueError("at least one context must be kept loaded")
+        self.max_contexts = max_contexts
+        self._specs = {}
+        # The loaded contexts by (xclbin path, device index), least recently
+        # used first, and the (XCLBin, views) of the loaded designs.
+        self._contexts = {}
+        self._designs = {}
+
+    def preload(
+        self,
+        name,
+        xclbin_path,
+        kernel_name,
+        insts,
+        shapes,
+        np_format,
+        patches=(),
+        resident_insts=None,
+        device_index=0,
+        huge_pages=False,
+    ):
+        """Declare a design and load it, replacing a design of the same
+        name."""
+        self.unload(name)
+        self._specs[name] = dict(
+            xclbin_path=xclbin_path,
+            kernel_name=kernel_name,
+            insts=insts,
+            shapes=shapes,
+            np_format=np_format,
+            patches=list(patches),
+            resident_insts=resident_insts,
+            device_index=device_index,
+            huge_pages=huge_pages,
+        )
+        self._load(name)
+
+    def switch(self, name):
+        """The XCLBin of a design, loaded again if it was unloaded."""
+        if name not in self._specs:
+            raise KeyError(f"unknown design: {name}")
+        if name not in self._designs:
+            self._load(name)
+        else:
+            self._context(*self._key(name))
+        return self._designs[name][0]
+
+    def views(self, name):
+        """The views of the host buffers of a design, as it is loaded."""
+        self.switch(name)
+        return self._designs[name][1]
+
+    def loaded(self):
+        """The names of the designs currently loaded."""
+        return list(self._designs)
+
+    def unload(self, name):
+        """Drop the XCLBin of a design, and its context if no other loaded
+        design uses it."""
+        if self._designs.pop(name, None) is None:
+            return
+        key = self._key(name)
+        if not any(self._key(other) == key for other in self._designs):
+            self._contexts.pop(key, None)
+
+    def _key(self, name):
+        spec = self._specs[name]
+        return (spec["xclbin_path"], spec["device_index"])
+
+    def _context(self, xclbin_path, device_index):
+        key = (xclbin_path, device_index)
+        context = self._contexts.pop(key, None)
+        if context is None:
+            while self.max_contexts and len(self._contexts) >= self.max_contexts:
+                evicted = next(iter(self._contexts))
+                del self._contexts[evicted]
+                for other in [n for n in self._designs if self._key(n) == evicted]:
+                    del self._designs[other]
+            context = XCLBinContext(xclbin_path, device_index)
+        self._contexts[key] = context
+        return context
+
+    def _load(self, name):
+        spec = self._specs[name]
+        context = self._context(*self._key(name))
+        xclbin = XCLBin(context, spec["kernel_name"])
+        xclbin.load_ipu_instructions(spec["insts"], spec["patches"])
+        if spec["resident_insts"] is not None:
+            xclbin.load_resident_ipu_instructions(spec["resident_insts"])
+        views = xclbin.mmap_buffers(
+            spec["shapes"], spec["np_format"], spec["huge_pages"]
+        )
+        self._designs[name] = (xclbin, views)
+
+
+# A design compiled by a CompileService: its XCLBin, with its instructions
+# loaded, and the instructions.
+CompiledDesign = namedtuple("CompiledDesign", ["xclbin", "insts"])
+
+
+def read_ipu_instructions(insts_path):
+    """The IPU instructions written by aiecc, one hex word per line."""
+    with open(insts_path) as f:
+        return [int(line, 16) for line in f if line.strip()]
+
+
+class CompileService:
+    """Compile designs in the background while the caller keeps running.
+
+    aiecc takes a minute or more to compile a design, so a design needed for
+    a new shape is submitted to the service, which compiles it with aiecc in
+    a pool of worker processes, and the caller keeps running a fallback
+    design meanwhile.  submit() returns a future resolving to the
+    CompiledDesign, or to the error aiecc failed with.  The xclbins and
+    instructions are kept in the artifact cache of the cache directory,
+    along with the cores compiled, so a design compiled before with the same
+    arguments, by any process, resolves without running aiecc, and a design
+    submitted again while it compiles shares the future of the first
+    submission:
+
+        service = CompileService("/var/cache/aie", workers=2)
+        future = service.submit(str(module), ["--no-xchesscc", "--no-xbridge"])
+        while not future.done():
+            run(fallback)
+        xclbin = future.result().xclbin
+
+    The workers are spawned rather than forked, so they don't inherit the
+    contexts and device handles of the caller.
+    """
+
+    def __init__(self, cache_dir, kernel_name="MLIR_AIE", device_index=0, workers=2):
+        import aie.compiler.aiecc.main as aiecc
+
+        self._aiecc = aiecc
+        self.cache_dir = cache_dir
+        self.kernel_name = kernel_name
+        self.device_index = device_index
+        self._executor = concurrent.futures.ProcessPoolExecutor(
+            workers, mp_context=multiprocessing.get_context("spawn")
+        )
+        self._lock = threading.Lock()
+        # The futures of the designs being compiled, by design key.
+        self._pending = {}
+
+    def submit(self, mlir_module, args=()):
+        """Compile a design with the given aiecc arguments, and return the
+        future of its CompiledDesign."""
+        args = list(args)
+        key = self._aiecc.design_key(mlir_module, args)
+        with self._lock:
+            if key in self._pending:
+                return self._pending[key]
+            future = concurrent.futures.Future()
+            paths = self._aiecc.cached_design(self.cache_dir, key)
+            if not paths:
+                self._pending[key] = future
+        if paths:
+            self._load(future, *paths)
+            return future
+        compiled = self._executor.submit(
+            self._aiecc.compile_cached, str(mlir_module), args, self.cache_dir
+        )
+        compiled.add_done_callback(lambda c: self._done(key, future, c))
+        return future
+
+    def shutdown(self, wait=True, cancel_futures=False):
+        self._executor.shutdown(wait=wait, cancel_futures=cancel_futures)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.shutdown()
+
+    def _done(self, key, future, compiled):
+        with self._lock:
+            del self._pending[key]
+        # The caller may have given up on the design.
+        if future.cancelled():
+            return
+        if compiled.cancelled():
+            future.cancel()
+        elif compiled.exception() is not None:
+            future.set_exception(compiled.exception())
+        else:
+            self._load(future, *compiled.result())
+
+    def _load(self, future, xclbin_path, insts_path):
+        try:
+            insts = read_ipu_instructions(insts_path)
+            xclbin = XCLBin(xclbin_path, self.kernel_name, self.device_index)
+            xclbin.load_ipu_instructions(insts)
+        except Exception as e:
+            future.set_exception(e)
+        else:
+            future.set_result(CompiledDesign(xclbin, insts))
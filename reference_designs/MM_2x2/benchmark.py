@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 Advanced Micro Devices, Inc.
+
+# Compares the circuit-switched, objectFifo and packet-switched versions of
+# MM_2x2: the stream routes each of them uses once placed and routed and,
+# with --run, the time each of them takes on the board.
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+VARIANTS = [
+    "circuit_switched_version",
+    "objectFifo_circuit_switched_version",
+    "packet_switched_version",
+]
+
+# The passes aiecc.py runs to route a design.
+ROUTING_PASSES = (
+    "builtin.module(aie-canonicalize-device,aie.device("
+    "aie-objectFifo-stateful-transform,aie-lower-broadcast-packet,"
+    "aie-create-packet-flows,aie-lower-multicast,aie-create-pathfinder-flows))"
+)
+
+# Data moved by a run: six 32x32 input tiles of LHS and RHS and two 32x32
+# output tiles of int32.
+BYTES_MOVED = (6 + 2) * 32 * 32 * 4
+
+
+def route_usage(design):
+    routed = subprocess.run(
+        ["aie-opt", f"--pass-pipeline={ROUTING_PASSES}", design],
+        check=True,
+        capture_output=True,
+        text=True,
+    ).stdout
+    report = json.loads(
+        subprocess.run(
+            ["aie-translate", "--aie-utilization-report"],
+            input=routed,
+            check=True,
+            capture_output=True,
+            text=True,
+        ).stdout
+    )
+    tiles = report["tiles"]
+    channels = report["congested_channels"]
+    return {
+        "switchboxes": sum(1 for t in tiles if t["switchbox_dests"]["used"]),
+        "master_ports": sum(t["switchbox_dests"]["used"] for t in tiles),
+        "busiest_channel_percent": channels[0]["percent"] if channels else 0,
+    }
+
+
+def run_on_board(directory):
+    subprocess.run(["make", "-C", directory], check=True)
+    start = time.perf_counter()
+    result = subprocess.run(["./test.elf"], cwd=directory)
+    seconds = time.perf_counter() - start
+    return {
+        "passed": result.returncode == 0,
+        "seconds": seconds,
+        "mb_per_second": BYTES_MOVED / seconds / 1e6,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare the routing and speed of the MM_2x2 versions"
+    )
+    parser.add_argument(
+        "--run",
+        action="store_true",
+        help="also build each version and time it on the board",
+    )
+    parser.add_argument("--json", metavar="FILE", help="write the results to FILE")
+    args = parser.parse_args()
+
+    here = os.path.dirname(os.path.abspath(__file__))
+    results = {}
+    for variant in VARIANTS:
+        directory = os.path.join(here, variant)
+        results[variant] = route_usage(os.path.join(directory, "aie.mlir"))
+        if args.run:
+            results[variant].update(run_on_board(directory))
+
+    header = f"{'version':40} {'switchboxes':>11} {'masters':>7} {'busiest':>7}"
+    if args.run:
+        header += f" {'seconds':>8} {'MB/s':>8}"
+    print(header)
+    for variant, result in results.items():
+        line = (
+            f"{variant:40} {result['switchboxes']:11} {result['master_ports']:7}"
+            f" {result['busiest_channel_percent']:6}%"
+        )
+        if args.run:
+            line += f" {result['seconds']:8.3f} {result['mb_per_second']:8.2f}"
+            if not result["passed"]:
+                line += " FAILED"
+        print(line)
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+    return 0 if all(r.get("passed", True) for r in results.values()) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,105 @@
+//===- aie.mlir ------------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// REQUIRES: valid_xchess_license
+// RUN: aiecc.py %VitisSysrootFlag% --host-target=%aieHostTargetTriplet% %s -I%host_runtime_lib%/test_lib/include %extraAieCcFlags% -L%host_runtime_lib%/test_lib/lib -ltest_lib %S/test.cpp -o test.elf
+// RUN: %run_on_board ./test.elf
+
+// Autocorrelation of 1024 samples for lags 0 to 63, reduced along the
+// cascade. Each core multiplies a quarter of the samples x[i] by the 64
+// samples x[i..i+63] following them, accumulating the 64 lags at once in a
+// vector. The partial sums then go down the cascade of column 2 with
+// aie.cascade_reduce, which aie-cascade-reductions lowers to aie.put_cascade
+// and aie.get_cascade in pieces of 512 bits, so that the core of tile (2, 3)
+// at the end of the chain gets the whole sum. The input is padded with 64
+// zeros so that the last samples read past the end of the signal.
+
+module @autocorrelation_cascade {
+  aie.device(xcve2802) {
+    %tile2_0 = aie.tile(2, 0)
+    %tile2_3 = aie.tile(2, 3)
+    %tile2_4 = aie.tile(2, 4)
+    %tile2_5 = aie.tile(2, 5)
+    %tile2_6 = aie.tile(2, 6)
+
+    %inputExt = aie.external_buffer {sym_name = "input"} : memref<1088xi32>
+    %outputExt = aie.external_buffer {sym_name = "output"} : memref<64xi32>
+
+    aie.objectfifo @of_in (%tile2_0, {%tile2_3, %tile2_4, %tile2_5, %tile2_6}, 1 : i32) : !aie.objectfifo<memref<1088xi32>>
+    aie.objectfifo @of_out (%tile2_3, {%tile2_0}, 1 : i32) : !aie.objectfifo<memref<64xi32>>
+
+    aie.objectfifo.register_external_buffers @of_in (%tile2_0, {%inputExt}) : (memref<1088xi32>)
+    aie.objectfifo.register_external_buffers @of_out (%tile2_0, {%outputExt}) : (memref<64xi32>)
+
+    // Sums x[i] * x[i + lag] for i in [start, start + 256) and the 64 lags.
+    func.func @autocorrelate_partial(%in: memref<1088xi32>, %start: index) -> vector<64xi32> {
+      %c1 = arith.constant 1 : index
+      %c256 = arith.constant 256 : index
+      %zero = arith.constant dense<0> : vector<64xi32>
+      %end = arith.addi %start, %c256 : index
+      %acc = scf.for %i = %start to %end step %c1
+          iter_args(%acc_iter = %zero) -> (vector<64xi32>) {
+        %x = memref.load %in[%i] : memref<1088xi32>
+        %xs = vector.broadcast %x : i32 to vector<64xi32>
+        %window = vector.load %in[%i] : memref<1088xi32>, vector<64xi32>
+        %product = arith.muli %xs, %window : vector<64xi32>
+        %sum = arith.addi %acc_iter, %product : vector<64xi32>
+        scf.yield %sum : vector<64xi32>
+      }
+      return %acc : vector<64xi32>
+    }
+
+    aie.core(%tile2_6) {
+      %subviewIn = aie.objectfifo.acquire @of_in (Consume, 1) : !aie.objectfifosubview<memref<1088xi32>>
+      %input = aie.objectfifo.subview.access %subviewIn[0] : !aie.objectfifosubview<memref<1088xi32>> -> memref<1088xi32>
+      %start = arith.constant 0 : index
+      %partial = func.call @autocorrelate_partial(%input, %start) : (memref<1088xi32>, index) -> vector<64xi32>
+      aie.objectfifo.release @of_in (Consume, 1)
+      %sum = aie.cascade_reduce "autocorrelation" (%partial) : vector<64xi32>
+      aie.end
+    }
+
+    aie.core(%tile2_5) {
+      %subviewIn = aie.objectfifo.acquire @of_in (Consume, 1) : !aie.objectfifosubview<memref<1088xi32>>
+      %input = aie.objectfifo.subview.access %subviewIn[0] : !aie.objectfifosubview<memref<1088xi32>> -> memref<1088xi32>
+      %start = arith.constant 256 : index
+      %partial = func.call @autocorrelate_partial(%input, %start) : (memref<1088xi32>, index) -> vector<64xi32>
+      aie.objectfifo.release @of_in (Consume, 1)
+      %sum = aie.cascade_reduce "autocorrelation" (%partial) : vector<64xi32>
+      aie.end
+    }
+
+    aie.core(%tile2_4) {
+      %subviewIn = aie.objectfifo.acquire @of_in (Consume, 1) : !aie.objectfifosubview<memref<1088xi32>>
+      %input = aie.objectfifo.subview.access %subviewIn[0] : !aie.objectfifosubview<memref<1088xi32>> -> memref<1088xi32>
+      %start = arith.constant 512 : index
+      %partial = func.call @autocorrelate_partial(%input, %start) : (memref<1088xi32>, index) -> vector<64xi32>
+      aie.objectfifo.release @of_in (Consume, 1)
+      %sum = aie.cascade_reduce "autocorrelation" (%partial) : vector<64xi32>
+      aie.end
+    }
+
+    aie.core(%tile2_3) {
+      %subviewIn = aie.objectfifo.acquire @of_in (Consume, 1) : !aie.objectfifosubview<memref<1088xi32>>
+      %input = aie.objectfifo.subview.access %subviewIn[0] : !aie.objectfifosubview<memref<1088xi32>> -> memref<1088xi32>
+      %start = arith.constant 768 : index
+      %partial = func.call @autocorrelate_partial(%input, %start) : (memref<1088xi32>, index) -> vector<64xi32>
+      aie.objectfifo.release @of_in (Consume, 1)
+      %sum = aie.cascade_reduce "autocorrelation" (%partial) : vector<64xi32>
+
+      %subviewOut = aie.objectfifo.acquire @of_out (Produce, 1) : !aie.objectfifosubview<memref<64xi32>>
+      %output = aie.objectfifo.subview.access %subviewOut[0] : !aie.objectfifosubview<memref<64xi32>> -> memref<64xi32>
+      %c0 = arith.constant 0 : index
+      vector.store %sum, %output[%c0] : memref<64xi32>, vector<64xi32>
+      aie.objectfifo.release @of_out (Produce, 1)
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,90 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "memory_allocator.h"
+#include "test_library.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include <xaiengine.h>
+
+#include "aie_inc.cpp"
+
+#define SAMPLES 1024
+#define LAGS 64
+
+int main(int argc, char *argv[]) {
+  printf("test start.\n");
+
+  aie_libxaie_ctx_t *_xaie = mlir_aie_init_libxaie();
+  mlir_aie_init_device(_xaie);
+
+  mlir_aie_configure_cores(_xaie);
+  mlir_aie_configure_switchboxes(_xaie);
+  mlir_aie_initialize_locks(_xaie);
+  mlir_aie_configure_dmas(_xaie);
+
+  int errors = 0;
+
+  ext_mem_model_t buf0, buf1;
+  int *input = mlir_aie_mem_alloc(_xaie, buf0, SAMPLES + LAGS);
+  int *output = mlir_aie_mem_alloc(_xaie, buf1, LAGS);
+
+  mlir_aie_external_set_addr_input(_xaie, (u64)input);
+  mlir_aie_external_set_addr_output(_xaie, (u64)output);
+
+  mlir_aie_configure_shimdma_20(_xaie);
+  mlir_aie_start_cores(_xaie);
+
+  // The samples are followed by LAGS zeros, read by the last samples.
+  for (int i = 0; i < SAMPLES + LAGS; i++)
+    input[i] = i < SAMPLES ? rand() & 0xFF : 0;
+  for (int i = 0; i < LAGS; i++)
+    output[i] = 0;
+
+  mlir_aie_sync_mem_dev(buf0); // only used in libaiev2
+  mlir_aie_sync_mem_dev(buf1); // only used in libaiev2
+
+  mlir_aie_release_of_in_cons_lock(_xaie, 1, 10000);
+
+  printf("Waiting for the result ...\n");
+  if (mlir_aie_acquire_of_out_cons_cons_lock(_xaie, 1, 100000)) {
+    printf("ERROR: timeout hit!\n");
+  }
+
+  mlir_aie_sync_mem_cpu(buf1); // only used in libaiev2
+
+  for (int lag = 0; lag < LAGS; lag++) {
+    int expected = 0;
+    for (int i = 0; i < SAMPLES; i++)
+      expected += input[i] * input[i + lag];
+    mlir_aie_check("output", output[lag], expected, errors);
+  }
+
+  int res = 0;
+  if (!errors) {
+    printf("PASS!\n");
+    res = 0;
+  } else {
+    printf("Fail!\n");
+    res = -1;
+  }
+  mlir_aie_deinit_libxaie(_xaie);
+
+  printf("test done.\n");
+  return res;
+}
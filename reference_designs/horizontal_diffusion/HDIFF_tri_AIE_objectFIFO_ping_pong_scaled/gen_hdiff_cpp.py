@@ -6,14 +6,12 @@
 # SPDX-License-Identifier: MIT
 #
 
+from hdiff_layout import file_header, hdiff_col, parse_blocks, shim_columns
 
-noc_columns = [2, 3, 6, 7, 10, 11, 18, 19, 26, 27, 34, 35, 42, 43, 46, 47]
-
-total_b_block = 8  # only 1
+total_b_block = 8  # default, set from the command line
 b_block_depth = 4  # set how many rows
 input_rows = 9  # data input per block row
 
-hdiff_col = 3  # columns
 arraycols = 0  # must be even until 32
 broadcast_cores = 0  # only 1-2
 arrayrows = 0  # one for processing and one for shimDMA
@@ -46,9 +44,9 @@ def main():
     cols = arraycols
 
     f = open("test_%d.cpp" % (total_b_block), "w+")
+    f.write(file_header("test_%d.cpp" % (total_b_block), "C++"))
     f.write(
-        """//===- hdiff.cc -------------------------------------------------*- C++ -*-===//  
-//  
+        """//
 // (c) 2023 SAFARI Research Group at ETH Zurich, Gagandeep Singh, D-ITET
 //
 // This file is licensed under the MIT License.
@@ -58,42 +56,10 @@ def main():
 //===----------------------------------------------------------------------===//\n\n\n"""
     )
 
+    shim_place_of_block = shim_columns(total_b_block)
+
     def noc_div_two_channel(block):
-        # print(block)
-        seg = 2
-        if block < seg:
-            val = noc_columns[0]
-        elif block >= seg and block < 2 * seg:
-            val = noc_columns[1]
-        elif block >= 2 * seg and block < 3 * seg:
-            val = noc_columns[2]
-        elif block >= 3 * seg and block < 4 * seg:
-            val = noc_columns[3]
-        elif block >= 4 * seg and block < 5 * seg:
-            val = noc_columns[4]
-        elif block >= 5 * seg and block < 6 * seg:
-            val = noc_columns[5]
-        elif block >= 6 * seg and block < 7 * seg:
-            val = noc_columns[6]
-        elif block >= 7 * seg and block < 8 * seg:
-            val = noc_columns[7]
-        elif block >= 8 * seg and block < 9 * seg:
-            val = noc_columns[8]
-        elif block >= 9 * seg and block < 10 * seg:
-            val = noc_columns[9]
-        elif block >= 10 * seg and block < 11 * seg:
-            val = noc_columns[10]
-        elif block >= 11 * seg and block < 12 * seg:
-            val = noc_columns[11]
-        elif block >= 12 * seg and block < 13 * seg:
-            val = noc_columns[12]
-        elif block >= 13 * seg and block < 14 * seg:
-            val = noc_columns[13]
-        elif block >= 14 * seg and block < 15 * seg:
-            val = noc_columns[14]
-        elif block >= 15 * seg:
-            val = noc_columns[15]
-        return val
+        return shim_place_of_block[block]
 
     f.write(
         """#include "test_library.h"
@@ -363,4 +329,5 @@ int main(int argc, char *argv[]) {
 
 
 if __name__ == "__main__":
+    total_b_block = parse_blocks(total_b_block)
     main()
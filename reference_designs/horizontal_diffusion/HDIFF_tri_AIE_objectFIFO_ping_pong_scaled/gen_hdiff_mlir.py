@@ -6,13 +6,13 @@
 # SPDX-License-Identifier: MIT
 #
 
-noc_columns = [2, 3, 6, 7, 10, 11, 18, 19, 26, 27, 34, 35, 42, 43, 46, 47]
 
-total_b_block = 5  # only 1
+from hdiff_layout import file_header, hdiff_col, parse_blocks, shim_columns
+
+total_b_block = 5  # default, set from the command line
 b_block_depth = 4  # set how many rows
 input_rows = 9  # data input per block row
 
-hdiff_col = 3  # columns
 arraycols = 0  # must be even until 32
 broadcast_cores = 0  # only 1-2
 arrayrows = 0  # one for processing and one for shimDMA
@@ -47,9 +47,9 @@ def main():
     f = open("aie_%d.mlir" % (total_b_block), "w+")
     # declare tile, column by row
 
+    f.write(file_header("aie_%d.mlir" % (total_b_block), "MLIR"))
     f.write(
-        """//===- aie.mlir ------------------------------------------------*- MLIR -*-===//  
-//  
+        """//
 // (c) 2023 SAFARI Research Group at ETH Zurich, Gagandeep Singh, D-ITET
 //
 // This file is licensed under the MIT License.
@@ -61,42 +61,10 @@ def main():
 
     f.write("module @hdiff_bundle_%d {\n" % (total_b_block))
 
+    shim_place_of_block = shim_columns(total_b_block)
+
     def noc_div_two_channel(block):
-        # print(block)
-        seg = 2
-        if block < seg:
-            val = noc_columns[0]
-        elif block >= seg and block < 2 * seg:
-            val = noc_columns[1]
-        elif block >= 2 * seg and block < 3 * seg:
-            val = noc_columns[2]
-        elif block >= 3 * seg and block < 4 * seg:
-            val = noc_columns[3]
-        elif block >= 4 * seg and block < 5 * seg:
-            val = noc_columns[4]
-        elif block >= 5 * seg and block < 6 * seg:
-            val = noc_columns[5]
-        elif block >= 6 * seg and block < 7 * seg:
-            val = noc_columns[6]
-        elif block >= 7 * seg and block < 8 * seg:
-            val = noc_columns[7]
-        elif block >= 8 * seg and block < 9 * seg:
-            val = noc_columns[8]
-        elif block >= 9 * seg and block < 10 * seg:
-            val = noc_columns[9]
-        elif block >= 10 * seg and block < 11 * seg:
-            val = noc_columns[10]
-        elif block >= 11 * seg and block < 12 * seg:
-            val = noc_columns[11]
-        elif block >= 12 * seg and block < 13 * seg:
-            val = noc_columns[12]
-        elif block >= 13 * seg and block < 14 * seg:
-            val = noc_columns[13]
-        elif block >= 14 * seg and block < 15 * seg:
-            val = noc_columns[14]
-        elif block >= 15 * seg:
-            val = noc_columns[15]
-        return val
+        return shim_place_of_block[block]
 
     # setting core tiles
     b_col_shift = 0
@@ -111,13 +79,13 @@ def main():
             for row in range(startrow, startrow + b_block_depth):  #
                 if b % 2 == 0:
                     f.write(
-                        "  %%tile%d_%d = AIE.tile(%d, %d)\n"
+                        "  %%tile%d_%d = aie.tile(%d, %d)\n"
                         % (col + b_col_shift * 3, row, col + b_col_shift * 3, row)
                     )
 
                 else:
                     f.write(
-                        "  %%tile%d_%d = AIE.tile(%d, %d)\n"
+                        "  %%tile%d_%d = aie.tile(%d, %d)\n"
                         % (
                             col + b_col_shift * 3,
                             row + b_row_shift * 4,
@@ -140,7 +108,7 @@ def main():
             shim_place = noc_div_two_channel(block)
             f.write("//---NOC Tile %d---*-\n" % shim_place)
             f.write(
-                "  %%tile%d_%d = AIE.tile(%d, %d)\n" % (shim_place, 0, shim_place, 0)
+                "  %%tile%d_%d = aie.tile(%d, %d)\n" % (shim_place, 0, shim_place, 0)
             )
         # noc_count=noc_count+1
 
@@ -156,7 +124,7 @@ def main():
         for col in range(startcol, startcol + hdiff_col):  # col 0 is reserved in aie
             if col == 0 or col == (startcol + hdiff_col - 1):
                 f.write(
-                    '  %%lock%d%d_14 = AIE.lock(%%tile%d_%d, 14) { sym_name = "lock%d%d_14" }\n'
+                    '  %%lock%d%d_14 = aie.lock(%%tile%d_%d, 14) { sym_name = "lock%d%d_14" }\n'
                     % (
                         col + b_col_shift * 3,
                         startrow + b_row_shift * 4 + 1,
@@ -235,7 +203,7 @@ def main():
         bb_sym = broad_in[:-1]
         # print(broad_in)
         f.write(
-            '  %%block_%d_buf_in_shim_%d = AIE.objectfifo.createObjectFifo(%%tile%d_0,{%s},%d) { sym_name = "%s" } : !AIE.objectfifo<memref<%dxi32>> //B block input\n'
+            '  %%block_%d_buf_in_shim_%d = aie.objectfifo.createObjectFifo(%%tile%d_0,{%s},%d) { sym_name = "%s" } : !aie.objectfifo<memref<%dxi32>> //B block input\n'
             % (block, shim_place, shim_place, bb_sym, input_rows, symbol_in, bufsize)
         )
 
@@ -244,20 +212,20 @@ def main():
                 col = 0 + b_col_shift * 3
                 # broad_in= broad_in+("%%tile%d_%d," % (col,row))
                 f.write(
-                    '  %%block_%d_buf_row_%d_inter_lap= AIE.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},5){ sym_name ="block_%d_buf_row_%d_inter_lap"} : !AIE.objectfifo<memref<%dxi32>>\n'
+                    '  %%block_%d_buf_row_%d_inter_lap= aie.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},5){ sym_name ="block_%d_buf_row_%d_inter_lap"} : !aie.objectfifo<memref<%dxi32>>\n'
                     % (block, row, col, row, col + 1, row, block, row, bufsize)
                 )
 
                 col = 1 + b_col_shift * 3
                 f.write(
-                    '  %%block_%d_buf_row_%d_inter_flx1= AIE.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},6) { sym_name ="block_%d_buf_row_%d_inter_flx1"} : !AIE.objectfifo<memref<%dxi32>>\n'
+                    '  %%block_%d_buf_row_%d_inter_flx1= aie.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},6) { sym_name ="block_%d_buf_row_%d_inter_flx1"} : !aie.objectfifo<memref<%dxi32>>\n'
                     % (block, row, col, row, col + 1, row, block, row, bufsize_flx1)
                 )
                 col = 2 + b_col_shift * 3
 
                 if row == startrow + b_block_depth - 3:
                     f.write(
-                        '  %%block_%d_buf_out_shim_%d= AIE.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},5){ sym_name ="block_%d_buf_out_shim_%d"} : !AIE.objectfifo<memref<%dxi32>> //B block output\n'
+                        '  %%block_%d_buf_out_shim_%d= aie.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},5){ sym_name ="block_%d_buf_out_shim_%d"} : !aie.objectfifo<memref<%dxi32>> //B block output\n'
                         % (
                             block,
                             shim_place,
@@ -273,7 +241,7 @@ def main():
 
                 else:
                     f.write(
-                        '  %%block_%d_buf_row_%d_out_flx2= AIE.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},2) { sym_name ="block_%d_buf_row_%d_out_flx2"} : !AIE.objectfifo<memref<%dxi32>>\n'
+                        '  %%block_%d_buf_row_%d_out_flx2= aie.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},2) { sym_name ="block_%d_buf_row_%d_out_flx2"} : !aie.objectfifo<memref<%dxi32>>\n'
                         % (
                             block,
                             row,
@@ -290,7 +258,7 @@ def main():
                 col = 0 + b_col_shift * 3
                 # broad_in= broad_in+("%%tile%d_%d," % (col,row))
                 f.write(
-                    '  %%block_%d_buf_row_%d_inter_lap= AIE.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},5){ sym_name ="block_%d_buf_row_%d_inter_lap"} : !AIE.objectfifo<memref<%dxi32>>\n'
+                    '  %%block_%d_buf_row_%d_inter_lap= aie.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},5){ sym_name ="block_%d_buf_row_%d_inter_lap"} : !aie.objectfifo<memref<%dxi32>>\n'
                     % (
                         block,
                         row + b_row_shift * 4,
@@ -306,7 +274,7 @@ def main():
 
                 col = 1 + b_col_shift * 3
                 f.write(
-                    '  %%block_%d_buf_row_%d_inter_flx1= AIE.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},6) { sym_name ="block_%d_buf_row_%d_inter_flx1"} : !AIE.objectfifo<memref<%dxi32>>\n'
+                    '  %%block_%d_buf_row_%d_inter_flx1= aie.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},6) { sym_name ="block_%d_buf_row_%d_inter_flx1"} : !aie.objectfifo<memref<%dxi32>>\n'
                     % (
                         block,
                         row + b_row_shift * 4,
@@ -323,7 +291,7 @@ def main():
 
                 if row == startrow + b_block_depth - 3:
                     f.write(
-                        '  %%block_%d_buf_out_shim_%d= AIE.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},5){ sym_name ="block_%d_buf_out_shim_%d"} : !AIE.objectfifo<memref<%dxi32>> //B block output\n'
+                        '  %%block_%d_buf_out_shim_%d= aie.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},5){ sym_name ="block_%d_buf_out_shim_%d"} : !aie.objectfifo<memref<%dxi32>> //B block output\n'
                         % (
                             block,
                             shim_place,
@@ -339,7 +307,7 @@ def main():
 
                 else:
                     f.write(
-                        '  %%block_%d_buf_row_%d_out_flx2= AIE.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},2) { sym_name ="block_%d_buf_row_%d_out_flx2"} : !AIE.objectfifo<memref<%dxi32>>\n'
+                        '  %%block_%d_buf_row_%d_out_flx2= aie.objectfifo.createObjectFifo(%%tile%d_%d,{%%tile%d_%d},2) { sym_name ="block_%d_buf_row_%d_out_flx2"} : !aie.objectfifo<memref<%dxi32>>\n'
                         % (
                             block,
                             row + b_row_shift * 4,
@@ -356,12 +324,12 @@ def main():
     def gagan_gen_ddr(block):
         # print(bb)
         f.write(
-            '  %%ext_buffer_in_%d = AIE.external_buffer  {sym_name = "ddr_buffer_in_%d"}: memref<%d x i32>\n'
+            '  %%ext_buffer_in_%d = aie.external_buffer  {sym_name = "ddr_buffer_in_%d"}: memref<%d x i32>\n'
             % (block, block, dram_bufsize_in)
         )
 
         f.write(
-            '  %%ext_buffer_out_%d = AIE.external_buffer  {sym_name = "ddr_buffer_out_%d"}: memref<%d x i32>\n'
+            '  %%ext_buffer_out_%d = aie.external_buffer  {sym_name = "ddr_buffer_out_%d"}: memref<%d x i32>\n'
             % (block, block, dram_bufsize_out)
         )
         f.write("\n")
@@ -380,12 +348,12 @@ def main():
         shim_place = noc_div_two_channel(block)
         # print(shim_place)
         f.write(
-            "  AIE.objectfifo.register_external_buffers(%%tile%d_0, %%block_%d_buf_in_shim_%d : !AIE.objectfifo<memref<%dxi32>>, {%%ext_buffer_in_%d}) : (memref<%dxi32>)\n"
+            "  aie.objectfifo.register_external_buffers(%%tile%d_0, %%block_%d_buf_in_shim_%d : !aie.objectfifo<memref<%dxi32>>, {%%ext_buffer_in_%d}) : (memref<%dxi32>)\n"
             % (shim_place, block, shim_place, bufsize, block, dram_bufsize_in)
         )
 
         f.write(
-            "  AIE.objectfifo.register_external_buffers(%%tile%d_0, %%block_%d_buf_out_shim_%d : !AIE.objectfifo<memref<%dxi32>>, {%%ext_buffer_out_%d}) : (memref<%dxi32>)\n"
+            "  aie.objectfifo.register_external_buffers(%%tile%d_0, %%block_%d_buf_out_shim_%d : !aie.objectfifo<memref<%dxi32>>, {%%ext_buffer_out_%d}) : (memref<%dxi32>)\n"
             % (shim_place, block, shim_place, bufsize, block, dram_bufsize_out)
         )
 
@@ -412,7 +380,7 @@ def main():
         block_row = (row - startrow) % (b_block_depth)
         # print("******************%d when row is %d\n"%(block_row,row))
         f.write(
-            "  %%block_%d_core%d_%d = AIE.core(%%tile%d_%d) {\n"
+            "  %%block_%d_core%d_%d = aie.core(%%tile%d_%d) {\n"
             % (block, col, row, col, row)
         )
         f.write("    %lb = arith.constant 0 : index\n")
@@ -422,78 +390,78 @@ def main():
             row == startrow + 1 or row == startrow + b_block_depth + 1
         ):
             f.write(
-                '    AIE.useLock(%%lock%d%d_14, "Acquire", 0) // start the timer\n'
+                '    aie.use_lock(%%lock%d%d_14, "Acquire", 0) // start the timer\n'
                 % (col, row)
             )
         f.write("    scf.for %iv = %lb to %ub step %step {  \n")
         f.write(
-            "      %%obj_in_subview = AIE.objectfifo.acquire<Consume>(%%block_%d_buf_in_shim_%d: !AIE.objectfifo<memref<%dxi32>>, %d) : !AIE.objectfifosubview<memref<%dxi32>>\n"
+            "      %%obj_in_subview = aie.objectfifo.acquire<Consume>(%%block_%d_buf_in_shim_%d: !aie.objectfifo<memref<%dxi32>>, %d) : !aie.objectfifosubview<memref<%dxi32>>\n"
             % (block, shim_place, bufsize, input_rows - 1, bufsize)
         )
         f.write(
-            "      %%row0 = AIE.objectfifo.subview.access %%obj_in_subview[%d] : !AIE.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n"
+            "      %%row0 = aie.objectfifo.subview.access %%obj_in_subview[%d] : !aie.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n"
             % (block_row, bufsize, bufsize)
         )
         f.write(
-            "      %%row1 = AIE.objectfifo.subview.access %%obj_in_subview[%d] : !AIE.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n"
+            "      %%row1 = aie.objectfifo.subview.access %%obj_in_subview[%d] : !aie.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n"
             % (block_row + 1, bufsize, bufsize)
         )
         f.write(
-            "      %%row2 = AIE.objectfifo.subview.access %%obj_in_subview[%d] : !AIE.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n"
+            "      %%row2 = aie.objectfifo.subview.access %%obj_in_subview[%d] : !aie.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n"
             % (block_row + 2, bufsize, bufsize)
         )
         f.write(
-            "      %%row3 = AIE.objectfifo.subview.access %%obj_in_subview[%d] : !AIE.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n"
+            "      %%row3 = aie.objectfifo.subview.access %%obj_in_subview[%d] : !aie.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n"
             % (block_row + 3, bufsize, bufsize)
         )
         f.write(
-            "      %%row4 = AIE.objectfifo.subview.access %%obj_in_subview[%d] : !AIE.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n\n"
+            "      %%row4 = aie.objectfifo.subview.access %%obj_in_subview[%d] : !aie.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n\n"
             % (block_row + 4, bufsize, bufsize)
         )
 
         f.write(
-            "      %%obj_out_subview_lap = AIE.objectfifo.acquire<Produce>(%%block_%d_buf_row_%d_inter_lap: !AIE.objectfifo<memref<%dxi32>>, 4): !AIE.objectfifosubview<memref<%dxi32>>\n"
+            "      %%obj_out_subview_lap = aie.objectfifo.acquire<Produce>(%%block_%d_buf_row_%d_inter_lap: !aie.objectfifo<memref<%dxi32>>, 4): !aie.objectfifosubview<memref<%dxi32>>\n"
             % (block, row, bufsize, bufsize)
         )
         f.write(
-            "      %obj_out_lap1 = AIE.objectfifo.subview.access %obj_out_subview_lap[0] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
+            "      %obj_out_lap1 = aie.objectfifo.subview.access %obj_out_subview_lap[0] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
         )
         f.write(
-            "      %obj_out_lap2 = AIE.objectfifo.subview.access %obj_out_subview_lap[1] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
+            "      %obj_out_lap2 = aie.objectfifo.subview.access %obj_out_subview_lap[1] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
         )
         f.write(
-            "      %obj_out_lap3 = AIE.objectfifo.subview.access %obj_out_subview_lap[2] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
+            "      %obj_out_lap3 = aie.objectfifo.subview.access %obj_out_subview_lap[2] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
         )
         f.write(
-            "      %obj_out_lap4 = AIE.objectfifo.subview.access %obj_out_subview_lap[3] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n\n"
+            "      %obj_out_lap4 = aie.objectfifo.subview.access %obj_out_subview_lap[3] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n\n"
         )
 
         f.write(
             "      func.call @hdiff_lap(%row0,%row1,%row2,%row3,%row4,%obj_out_lap1,%obj_out_lap2,%obj_out_lap3,%obj_out_lap4) : (memref<256xi32>,memref<256xi32>, memref<256xi32>, memref<256xi32>, memref<256xi32>,  memref<256xi32>,  memref<256xi32>,  memref<256xi32>,  memref<256xi32>) -> ()\n\n"
         )
         f.write(
-            "      AIE.objectfifo.release<Consume>(%%block_%d_buf_in_shim_%d: !AIE.objectfifo<memref<%dxi32>>, 1)\n"
+            "      aie.objectfifo.release<Consume>(%%block_%d_buf_in_shim_%d: !aie.objectfifo<memref<%dxi32>>, 1)\n"
             % (block, shim_place, bufsize)
         )
         f.write(
-            "      AIE.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_lap: !AIE.objectfifo<memref<%dxi32>>, 4)\n"
+            "      aie.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_lap: !aie.objectfifo<memref<%dxi32>>, 4)\n"
             % (block, row, bufsize)
         )
-        # f.write("      AIE.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_lap: !AIE.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize))
-        # f.write("      AIE.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_lap: !AIE.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize))
-        # f.write("      AIE.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_lap: !AIE.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize))
+        # f.write("      aie.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_lap: !aie.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize))
+        # f.write("      aie.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_lap: !aie.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize))
+        # f.write("      aie.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_lap: !aie.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize))
         f.write("    }\n")
         f.write(
-            "    AIE.objectfifo.release<Consume>(%%block_%d_buf_in_shim_%d: !AIE.objectfifo<memref<%dxi32>>, 4)\n"
+            "    aie.objectfifo.release<Consume>(%%block_%d_buf_in_shim_%d: !aie.objectfifo<memref<%dxi32>>, 4)\n"
             % (block, shim_place, bufsize)
         )
-        f.write("    AIE.end\n")
+        f.write("    aie.end\n")
         f.write('  } { link_with="hdiff_lap.o" }\n\n')
 
     def gagan_gen_flx1_core(block, col, row, shim_place):
         block_row = (row - startrow) % (b_block_depth)
         f.write(
-            "  %%block_%d_core%d_%d = AIE.core(%%tile%d_%d) {\n"
+            "  %%block_%d_core%d_%d = aie.core(%%tile%d_%d) {\n"
             % (block, col, row, col, row)
         )
         f.write("    %lb = arith.constant 0 : index\n")
@@ -501,96 +469,96 @@ def main():
         f.write("    %step = arith.constant 1 : index\n")
         f.write("    scf.for %iv = %lb to %ub step %step {  \n")
         f.write(
-            "      %%obj_in_subview = AIE.objectfifo.acquire<Consume>(%%block_%d_buf_in_shim_%d: !AIE.objectfifo<memref<%dxi32>>, %d) : !AIE.objectfifosubview<memref<%dxi32>>\n"
+            "      %%obj_in_subview = aie.objectfifo.acquire<Consume>(%%block_%d_buf_in_shim_%d: !aie.objectfifo<memref<%dxi32>>, %d) : !aie.objectfifosubview<memref<%dxi32>>\n"
             % (block, shim_place, bufsize, input_rows - 1, bufsize)
         )
-        # f.write("      %%row0 = AIE.objectfifo.subview.access %%obj_in_subview[0] : !AIE.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n" %(bufsize,bufsize))
+        # f.write("      %%row0 = aie.objectfifo.subview.access %%obj_in_subview[0] : !aie.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n" %(bufsize,bufsize))
         f.write(
-            "      %%row1 = AIE.objectfifo.subview.access %%obj_in_subview[%d] : !AIE.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n"
+            "      %%row1 = aie.objectfifo.subview.access %%obj_in_subview[%d] : !aie.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n"
             % (block_row + 1, bufsize, bufsize)
         )
         f.write(
-            "      %%row2 = AIE.objectfifo.subview.access %%obj_in_subview[%d] : !AIE.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n"
+            "      %%row2 = aie.objectfifo.subview.access %%obj_in_subview[%d] : !aie.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n"
             % (block_row + 2, bufsize, bufsize)
         )
         f.write(
-            "      %%row3 = AIE.objectfifo.subview.access %%obj_in_subview[%d] : !AIE.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n\n"
+            "      %%row3 = aie.objectfifo.subview.access %%obj_in_subview[%d] : !aie.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n\n"
             % (block_row + 3, bufsize, bufsize)
         )
-        # f.write("      %%row4 = AIE.objectfifo.subview.access %%obj_in_subview[4] : !AIE.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n" %(bufsize,bufsize))
+        # f.write("      %%row4 = aie.objectfifo.subview.access %%obj_in_subview[4] : !aie.objectfifosubview<memref<%dxi32>> -> memref<%dxi32>\n" %(bufsize,bufsize))
 
         f.write(
-            "      %%obj_out_subview_lap = AIE.objectfifo.acquire<Consume>(%%block_%d_buf_row_%d_inter_lap: !AIE.objectfifo<memref<%dxi32>>, 4): !AIE.objectfifosubview<memref<%dxi32>>\n"
+            "      %%obj_out_subview_lap = aie.objectfifo.acquire<Consume>(%%block_%d_buf_row_%d_inter_lap: !aie.objectfifo<memref<%dxi32>>, 4): !aie.objectfifosubview<memref<%dxi32>>\n"
             % (block, row, bufsize, bufsize)
         )
         f.write(
-            "      %obj_out_lap1 = AIE.objectfifo.subview.access %obj_out_subview_lap[0] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
+            "      %obj_out_lap1 = aie.objectfifo.subview.access %obj_out_subview_lap[0] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
         )
         f.write(
-            "      %obj_out_lap2 = AIE.objectfifo.subview.access %obj_out_subview_lap[1] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
+            "      %obj_out_lap2 = aie.objectfifo.subview.access %obj_out_subview_lap[1] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
         )
         f.write(
-            "      %obj_out_lap3 = AIE.objectfifo.subview.access %obj_out_subview_lap[2] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
+            "      %obj_out_lap3 = aie.objectfifo.subview.access %obj_out_subview_lap[2] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
         )
         f.write(
-            "      %obj_out_lap4 = AIE.objectfifo.subview.access %obj_out_subview_lap[3] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n\n"
+            "      %obj_out_lap4 = aie.objectfifo.subview.access %obj_out_subview_lap[3] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n\n"
         )
 
         f.write(
-            "      %%obj_out_subview_flux1 = AIE.objectfifo.acquire<Produce>(%%block_%d_buf_row_%d_inter_flx1: !AIE.objectfifo<memref<%dxi32>>, 5): !AIE.objectfifosubview<memref<%dxi32>>\n"
+            "      %%obj_out_subview_flux1 = aie.objectfifo.acquire<Produce>(%%block_%d_buf_row_%d_inter_flx1: !aie.objectfifo<memref<%dxi32>>, 5): !aie.objectfifosubview<memref<%dxi32>>\n"
             % (block, row, bufsize_flx1, bufsize_flx1)
         )
         f.write(
-            "      %obj_out_flux_inter1 = AIE.objectfifo.subview.access %obj_out_subview_flux1[0] : !AIE.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
+            "      %obj_out_flux_inter1 = aie.objectfifo.subview.access %obj_out_subview_flux1[0] : !aie.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
         )
         f.write(
-            "      %obj_out_flux_inter2 = AIE.objectfifo.subview.access %obj_out_subview_flux1[1] : !AIE.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
+            "      %obj_out_flux_inter2 = aie.objectfifo.subview.access %obj_out_subview_flux1[1] : !aie.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
         )
         f.write(
-            "      %obj_out_flux_inter3 = AIE.objectfifo.subview.access %obj_out_subview_flux1[2] : !AIE.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
+            "      %obj_out_flux_inter3 = aie.objectfifo.subview.access %obj_out_subview_flux1[2] : !aie.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
         )
         f.write(
-            "      %obj_out_flux_inter4 = AIE.objectfifo.subview.access %obj_out_subview_flux1[3] : !AIE.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
+            "      %obj_out_flux_inter4 = aie.objectfifo.subview.access %obj_out_subview_flux1[3] : !aie.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
         )
         f.write(
-            "      %obj_out_flux_inter5 = AIE.objectfifo.subview.access %obj_out_subview_flux1[4] : !AIE.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n\n"
+            "      %obj_out_flux_inter5 = aie.objectfifo.subview.access %obj_out_subview_flux1[4] : !aie.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n\n"
         )
 
         f.write(
             "      func.call @hdiff_flux1(%row1,%row2,%row3,%obj_out_lap1,%obj_out_lap2,%obj_out_lap3,%obj_out_lap4, %obj_out_flux_inter1 , %obj_out_flux_inter2, %obj_out_flux_inter3, %obj_out_flux_inter4, %obj_out_flux_inter5) : (memref<256xi32>,memref<256xi32>, memref<256xi32>, memref<256xi32>, memref<256xi32>, memref<256xi32>,  memref<256xi32>,  memref<512xi32>,  memref<512xi32>,  memref<512xi32>,  memref<512xi32>,  memref<512xi32>) -> ()\n\n"
         )
-        # f.write("      AIE.objectfifo.release<Consume>(%%block_%d_buf_in_shim_%d: !AIE.objectfifo<memref<%dxi32>>, 1)\n" %(block, shim_place,bufsize))
+        # f.write("      aie.objectfifo.release<Consume>(%%block_%d_buf_in_shim_%d: !aie.objectfifo<memref<%dxi32>>, 1)\n" %(block, shim_place,bufsize))
 
         f.write(
-            "      AIE.objectfifo.release<Consume>(%%block_%d_buf_row_%d_inter_lap: !AIE.objectfifo<memref<%dxi32>>, 4)\n"
+            "      aie.objectfifo.release<Consume>(%%block_%d_buf_row_%d_inter_lap: !aie.objectfifo<memref<%dxi32>>, 4)\n"
             % (block, row, bufsize)
         )
 
         f.write(
-            "      AIE.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_flx1: !AIE.objectfifo<memref<%dxi32>>, 5)\n"
+            "      aie.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_flx1: !aie.objectfifo<memref<%dxi32>>, 5)\n"
             % (block, row, bufsize_flx1)
         )
-        # f.write("      AIE.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_flx1: !AIE.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize_flx1))
-        # f.write("      AIE.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_flx1: !AIE.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize_flx1))
-        # f.write("      AIE.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_flx1: !AIE.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize_flx1))
-        # f.write("      AIE.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_flx1: !AIE.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize_flx1))
+        # f.write("      aie.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_flx1: !aie.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize_flx1))
+        # f.write("      aie.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_flx1: !aie.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize_flx1))
+        # f.write("      aie.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_flx1: !aie.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize_flx1))
+        # f.write("      aie.objectfifo.release<Produce>(%%block_%d_buf_row_%d_inter_flx1: !aie.objectfifo<memref<%dxi32>>, 1)\n" %(block, row,bufsize_flx1))
         f.write(
-            "      AIE.objectfifo.release<Consume>(%%block_%d_buf_in_shim_%d: !AIE.objectfifo<memref<%dxi32>>, 1)\n"
+            "      aie.objectfifo.release<Consume>(%%block_%d_buf_in_shim_%d: !aie.objectfifo<memref<%dxi32>>, 1)\n"
             % (block, shim_place, bufsize)
         )
         f.write("    }\n")
         f.write(
-            "    AIE.objectfifo.release<Consume>(%%block_%d_buf_in_shim_%d: !AIE.objectfifo<memref<%dxi32>>, 7)\n"
+            "    aie.objectfifo.release<Consume>(%%block_%d_buf_in_shim_%d: !aie.objectfifo<memref<%dxi32>>, 7)\n"
             % (block, shim_place, bufsize)
         )
-        f.write("    AIE.end\n")
+        f.write("    aie.end\n")
         f.write('  } { link_with="hdiff_flux1.o" }\n\n')
 
     def gagan_gen_flx2_core(block, col, row, shim_place):
         if row == 2 or row == 6:
             f.write("  // Gathering Tile\n")
         f.write(
-            "  %%block_%d_core%d_%d = AIE.core(%%tile%d_%d) {\n"
+            "  %%block_%d_core%d_%d = aie.core(%%tile%d_%d) {\n"
             % (block, col, row, col, row)
         )
         f.write("    %lb = arith.constant 0 : index\n")
@@ -600,42 +568,42 @@ def main():
         f.write("    scf.for %iv = %lb to %ub step %step {  \n")
 
         f.write(
-            "      %%obj_out_subview_flux_inter1 = AIE.objectfifo.acquire<Consume>(%%block_%d_buf_row_%d_inter_flx1: !AIE.objectfifo<memref<%dxi32>>, 5): !AIE.objectfifosubview<memref<%dxi32>>\n"
+            "      %%obj_out_subview_flux_inter1 = aie.objectfifo.acquire<Consume>(%%block_%d_buf_row_%d_inter_flx1: !aie.objectfifo<memref<%dxi32>>, 5): !aie.objectfifosubview<memref<%dxi32>>\n"
             % (block, row, bufsize_flx1, bufsize_flx1)
         )
         f.write(
-            "      %obj_flux_inter_element1 = AIE.objectfifo.subview.access %obj_out_subview_flux_inter1[0] : !AIE.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
+            "      %obj_flux_inter_element1 = aie.objectfifo.subview.access %obj_out_subview_flux_inter1[0] : !aie.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
         )
         f.write(
-            "      %obj_flux_inter_element2 = AIE.objectfifo.subview.access %obj_out_subview_flux_inter1[1] : !AIE.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
+            "      %obj_flux_inter_element2 = aie.objectfifo.subview.access %obj_out_subview_flux_inter1[1] : !aie.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
         )
         f.write(
-            "      %obj_flux_inter_element3 = AIE.objectfifo.subview.access %obj_out_subview_flux_inter1[2] : !AIE.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
+            "      %obj_flux_inter_element3 = aie.objectfifo.subview.access %obj_out_subview_flux_inter1[2] : !aie.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
         )
         f.write(
-            "      %obj_flux_inter_element4 = AIE.objectfifo.subview.access %obj_out_subview_flux_inter1[3] : !AIE.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
+            "      %obj_flux_inter_element4 = aie.objectfifo.subview.access %obj_out_subview_flux_inter1[3] : !aie.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n"
         )
         f.write(
-            "      %obj_flux_inter_element5 = AIE.objectfifo.subview.access %obj_out_subview_flux_inter1[4] : !AIE.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n\n"
+            "      %obj_flux_inter_element5 = aie.objectfifo.subview.access %obj_out_subview_flux_inter1[4] : !aie.objectfifosubview<memref<512xi32>> -> memref<512xi32>\n\n"
         )
         if row == 2 or row == 6:
             f.write(
-                "      %%obj_out_subview_flux = AIE.objectfifo.acquire<Produce>(%%block_%d_buf_out_shim_%d: !AIE.objectfifo<memref<%dxi32>>, 4): !AIE.objectfifosubview<memref<%dxi32>>\n"
+                "      %%obj_out_subview_flux = aie.objectfifo.acquire<Produce>(%%block_%d_buf_out_shim_%d: !aie.objectfifo<memref<%dxi32>>, 4): !aie.objectfifosubview<memref<%dxi32>>\n"
                 % (block, shim_place, 256, 256)
             )
 
             f.write("  // Acquire all elements and add in order\n")
             f.write(
-                "      %obj_out_flux_element0 = AIE.objectfifo.subview.access %obj_out_subview_flux[0] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
+                "      %obj_out_flux_element0 = aie.objectfifo.subview.access %obj_out_subview_flux[0] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
             )
             f.write(
-                "      %obj_out_flux_element1 = AIE.objectfifo.subview.access %obj_out_subview_flux[1] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
+                "      %obj_out_flux_element1 = aie.objectfifo.subview.access %obj_out_subview_flux[1] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
             )
             f.write(
-                "      %obj_out_flux_element2 = AIE.objectfifo.subview.access %obj_out_subview_flux[2] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
+                "      %obj_out_flux_element2 = aie.objectfifo.subview.access %obj_out_subview_flux[2] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
             )
             f.write(
-                "      %obj_out_flux_element3 = AIE.objectfifo.subview.access %obj_out_subview_flux[3] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
+                "      %obj_out_flux_element3 = aie.objectfifo.subview.access %obj_out_subview_flux[3] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n"
             )
 
             f.write("  // Acquiring outputs from other flux\n")
@@ -645,11 +613,11 @@ def main():
             for order in range(startrow, startrow + broadcast_cores + b_block_depth):
                 if order != 2:
                     f.write(
-                        "      %%obj_out_subview_flux%d = AIE.objectfifo.acquire<Consume>(%%block_%d_buf_row_%d_out_flx2: !AIE.objectfifo<memref<%dxi32>>, 1): !AIE.objectfifosubview<memref<%dxi32>>\n"
+                        "      %%obj_out_subview_flux%d = aie.objectfifo.acquire<Consume>(%%block_%d_buf_row_%d_out_flx2: !aie.objectfifo<memref<%dxi32>>, 1): !aie.objectfifosubview<memref<%dxi32>>\n"
                         % (order, block, order + b_row_shift * 4, 256, 256)
                     )
                     f.write(
-                        "      %%final_out_from%d = AIE.objectfifo.subview.access %%obj_out_subview_flux%d[0] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n\n"
+                        "      %%final_out_from%d = aie.objectfifo.subview.access %%obj_out_subview_flux%d[0] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n\n"
                         % (order, order)
                     )
 
@@ -666,11 +634,11 @@ def main():
             ###############
         else:
             f.write(
-                "      %%obj_out_subview_flux = AIE.objectfifo.acquire<Produce>(%%block_%d_buf_row_%d_out_flx2: !AIE.objectfifo<memref<%dxi32>>, 1): !AIE.objectfifosubview<memref<%dxi32>>\n"
+                "      %%obj_out_subview_flux = aie.objectfifo.acquire<Produce>(%%block_%d_buf_row_%d_out_flx2: !aie.objectfifo<memref<%dxi32>>, 1): !aie.objectfifosubview<memref<%dxi32>>\n"
                 % (block, row, 256, 256)
             )
             f.write(
-                "      %obj_out_flux_element1 = AIE.objectfifo.subview.access %obj_out_subview_flux[0] : !AIE.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n\n"
+                "      %obj_out_flux_element1 = aie.objectfifo.subview.access %obj_out_subview_flux[0] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>\n\n"
             )
 
         f.write(
@@ -678,7 +646,7 @@ def main():
         )
 
         f.write(
-            "      AIE.objectfifo.release<Consume>(%%block_%d_buf_row_%d_inter_flx1 :!AIE.objectfifo<memref<%dxi32>>, 5)\n"
+            "      aie.objectfifo.release<Consume>(%%block_%d_buf_row_%d_inter_flx1 :!aie.objectfifo<memref<%dxi32>>, 5)\n"
             % (block, row, bufsize_flx1)
         )
 
@@ -692,16 +660,16 @@ def main():
             for order in range(startrow, startrow + broadcast_cores + b_block_depth):
                 if order != 2:
                     f.write(
-                        "      AIE.objectfifo.release<Consume>(%%block_%d_buf_row_%d_out_flx2:!AIE.objectfifo<memref<%dxi32>>, 1)\n"
+                        "      aie.objectfifo.release<Consume>(%%block_%d_buf_row_%d_out_flx2:!aie.objectfifo<memref<%dxi32>>, 1)\n"
                         % (block, order + b_row_shift * 4, 256)
                     )
             f.write(
-                "      AIE.objectfifo.release<Produce>(%%block_%d_buf_out_shim_%d:!AIE.objectfifo<memref<%dxi32>>, 4)\n"
+                "      aie.objectfifo.release<Produce>(%%block_%d_buf_out_shim_%d:!aie.objectfifo<memref<%dxi32>>, 4)\n"
                 % (block, shim_place, 256)
             )
         else:
             f.write(
-                "      AIE.objectfifo.release<Produce>(%%block_%d_buf_row_%d_out_flx2 :!AIE.objectfifo<memref<%dxi32>>, 1)\n"
+                "      aie.objectfifo.release<Produce>(%%block_%d_buf_row_%d_out_flx2 :!aie.objectfifo<memref<%dxi32>>, 1)\n"
                 % (block, row, 256)
             )
 
@@ -710,10 +678,10 @@ def main():
             row == startrow + 1 or row == startrow + b_block_depth + 1
         ):
             f.write(
-                '    AIE.useLock(%%lock%d%d_14, "Acquire", 0) // stop the timer\n'
+                '    aie.use_lock(%%lock%d%d_14, "Acquire", 0) // stop the timer\n'
                 % (col, row)
             )
-        f.write("    AIE.end\n")
+        f.write("    aie.end\n")
         f.write('  } { link_with="hdiff_flux2.o" }\n\n')
 
     b_col_shift = 0
@@ -747,4 +715,5 @@ def main():
 
 
 if __name__ == "__main__":
+    total_b_block = parse_blocks(total_b_block)
     main()
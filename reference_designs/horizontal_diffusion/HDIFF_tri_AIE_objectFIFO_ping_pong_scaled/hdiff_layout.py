@@ -0,0 +1,82 @@
+# hdiff_layout.py -*- Python -*-
+#
+# (c) 2023 SAFARI Research Group at ETH Zurich, Gagandeep Singh, D-ITET
+#
+# This file is licensed under the MIT License.
+# SPDX-License-Identifier: MIT
+#
+
+# Layout of the B-blocks of the scaled tri_AIE design, shared by the MLIR and
+# host code generators.
+#
+# A B-block is 3 columns (lap, flux1, flux2) by 4 rows of cores. Two B-blocks
+# are stacked in each group of 3 columns, rows 1-4 and 5-8, and share the
+# shim_dma of a NOC column, one channel each. Groups are placed from column 0
+# up, so the 16 NOC columns of the VC1902 serve at most 32 B-blocks, 384 of its
+# 400 cores.
+
+import argparse
+
+noc_columns = [2, 3, 6, 7, 10, 11, 18, 19, 26, 27, 34, 35, 42, 43, 46, 47]
+array_columns = 50
+hdiff_col = 3
+blocks_per_shim = 2
+max_blocks = min(
+    len(noc_columns) * blocks_per_shim,
+    array_columns // hdiff_col * blocks_per_shim,
+)
+
+
+def shim_columns(total_b_block):
+    """The NOC column of the shim_dma serving each B-block.
+
+    Each group of 3 columns gets its own NOC column, chosen to minimize the
+    total distance from the groups to their shim_dma: with the groups and the
+    NOC columns both in increasing order, an optimal assignment keeps that
+    order, so it is found by dynamic programming over the two lists.
+    """
+    groups = (total_b_block + blocks_per_shim - 1) // blocks_per_shim
+    centers = [g * hdiff_col + hdiff_col // 2 for g in range(groups)]
+    nocs = len(noc_columns)
+    inf = float("inf")
+    # cost[g][n]: best cost of placing the first g groups on the first n NOCs
+    cost = [[inf] * (nocs + 1) for _ in range(groups + 1)]
+    cost[0] = [0] * (nocs + 1)
+    for g in range(1, groups + 1):
+        for n in range(g, nocs + 1):
+            cost[g][n] = min(
+                cost[g][n - 1],
+                cost[g - 1][n - 1] + abs(centers[g - 1] - noc_columns[n - 1]),
+            )
+    placement = []
+    n = nocs
+    for g in range(groups, 0, -1):
+        while cost[g][n] == cost[g][n - 1]:
+            n -= 1
+        placement.append(noc_columns[n - 1])
+        n -= 1
+    placement.reverse()
+    return [placement[b // blocks_per_shim] for b in range(total_b_block)]
+
+
+def parse_blocks(default):
+    """The number of B-blocks to generate, from the command line."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "blocks",
+        type=int,
+        nargs="?",
+        default=default,
+        help=f"number of B-blocks, between 1 and {max_blocks}",
+    )
+    blocks = parser.parse_args().blocks
+    if blocks < 1 or blocks > max_blocks:
+        parser.error(f"the number of B-blocks must be between 1 and {max_blocks}")
+    return blocks
+
+
+def file_header(name, language):
+    """The first line of the header of a generated file."""
+    head = "//===- %s " % name
+    tail = "*- %s -*-===//" % language
+    return head + "-" * (80 - len(head) - len(tail)) + tail + "\n"
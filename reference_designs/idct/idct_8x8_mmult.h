@@ -19,7 +19,11 @@
 
 #define DCT8x8_BLOCK_WIDTH (8)
 #define DCT8x8_BLOCK_HEIGHT (8)
+// Number of 8x8 blocks processed by each kernel call, can be overridden on
+// the command line to batch many blocks per call.
+#ifndef NUM_DCT8x8_BLOCKS_PER_ITERATION
 #define NUM_DCT8x8_BLOCKS_PER_ITERATION (1)
+#endif
 #define NUM_ITERATION (1)
 #define BYTES_PER_DATA (2)
 
@@ -0,0 +1,332 @@
+//===- aie.mlir ------------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Scaled IDCT: the dequant -> horizontal -> vertical chain is replicated in
+// four columns fed by their own shim DMA, and every kernel call processes
+// eight 8x8 blocks.
+
+// REQUIRES: valid_xchess_license && jackl
+// RUN: xchesscc -p me -P %aietools/data/versal_prod/lib -DNUM_DCT8x8_BLOCKS_PER_ITERATION=8 -I%S/.. -c %S/../dequant.cc %S/../idct_horizontal.cc %S/../idct_vertical.cc
+// RUN: aiecc.py %VitisSysrootFlag% --host-target=%aieHostTargetTriplet% %s -I%host_runtime_lib%/test_lib/include %extraAieCcFlags% -L%host_runtime_lib%/test_lib/lib -ltest_lib %S/test.cpp -o test.elf
+// RUN: %run_on_board ./test.elf
+
+module @idct_scaled {
+  func.func private @dequant_8x8(%A: memref<512xi16>, %B: memref<512xi16>) -> ()
+  func.func private @idct_8x8_mmult_h(%A: memref<512xi16>, %B: memref<512xi16>) -> ()
+  func.func private @idct_8x8_mmult_v(%A: memref<512xi16>, %B: memref<512xi16>) -> ()
+
+  // Column 6
+  %t6_0 = aie.tile(6, 0)
+  %t6_3 = aie.tile(6, 3)
+  %t6_4 = aie.tile(6, 4)
+  %t6_5 = aie.tile(6, 5)
+
+  aie.objectfifo @of_in_c6 (%t6_0, {%t6_3}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+  aie.objectfifo @of_dequant_horizontal_c6 (%t6_3, {%t6_4}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+  aie.objectfifo @of_horizontal_vertical_c6 (%t6_4, {%t6_5}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+  aie.objectfifo @of_out_c6 (%t6_5, {%t6_0}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+
+  %buffer_in_c6 = aie.external_buffer { sym_name = "buffer_in_c6" } : memref<2048xi16>
+  %buffer_out_c6 = aie.external_buffer { sym_name = "buffer_out_c6" } : memref<2048xi16>
+
+  aie.objectfifo.register_external_buffers @of_in_c6 (%t6_0, {%buffer_in_c6}) : (memref<2048xi16>)
+  aie.objectfifo.register_external_buffers @of_out_c6 (%t6_0, {%buffer_out_c6}) : (memref<2048xi16>)
+
+  %c63 = aie.core(%t6_3) {
+    %lb = arith.constant 0 : index
+    %ub = arith.constant 4 : index
+    %step = arith.constant 1 : index
+
+    scf.for %iv = %lb to %ub step %step {
+      %inputSubview = aie.objectfifo.acquire @of_in_c6 (Consume, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %input = aie.objectfifo.subview.access %inputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+      %outputSubview = aie.objectfifo.acquire @of_dequant_horizontal_c6 (Produce, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %output = aie.objectfifo.subview.access %outputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+
+      func.call @dequant_8x8(%input, %output) : (memref<512xi16>, memref<512xi16>) -> ()
+
+      aie.objectfifo.release @of_in_c6 (Consume, 1)
+      aie.objectfifo.release @of_dequant_horizontal_c6 (Produce, 1)
+    }
+
+    aie.end
+  } { link_with="dequant.o" }
+
+  %c64 = aie.core(%t6_4) {
+    %lb = arith.constant 0 : index
+    %ub = arith.constant 4 : index
+    %step = arith.constant 1 : index
+
+    scf.for %iv = %lb to %ub step %step {
+      %inputSubview = aie.objectfifo.acquire @of_dequant_horizontal_c6 (Consume, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %input = aie.objectfifo.subview.access %inputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+      %outputSubview = aie.objectfifo.acquire @of_horizontal_vertical_c6 (Produce, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %output = aie.objectfifo.subview.access %outputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+
+      func.call @idct_8x8_mmult_h(%input, %output) : (memref<512xi16>, memref<512xi16>) -> ()
+
+      aie.objectfifo.release @of_dequant_horizontal_c6 (Consume, 1)
+      aie.objectfifo.release @of_horizontal_vertical_c6 (Produce, 1)
+    }
+
+    aie.end
+  } { link_with="idct_horizontal.o" }
+
+  %c65 = aie.core(%t6_5) {
+    %lb = arith.constant 0 : index
+    %ub = arith.constant 4 : index
+    %step = arith.constant 1 : index
+
+    scf.for %iv = %lb to %ub step %step {
+      %inputSubview = aie.objectfifo.acquire @of_horizontal_vertical_c6 (Consume, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %input = aie.objectfifo.subview.access %inputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+      %outputSubview = aie.objectfifo.acquire @of_out_c6 (Produce, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %output = aie.objectfifo.subview.access %outputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+
+      func.call @idct_8x8_mmult_v(%input, %output) : (memref<512xi16>, memref<512xi16>) -> ()
+
+      aie.objectfifo.release @of_horizontal_vertical_c6 (Consume, 1)
+      aie.objectfifo.release @of_out_c6 (Produce, 1)
+    }
+
+    aie.end
+  } { link_with="idct_vertical.o" }
+
+  // Column 7
+  %t7_0 = aie.tile(7, 0)
+  %t7_3 = aie.tile(7, 3)
+  %t7_4 = aie.tile(7, 4)
+  %t7_5 = aie.tile(7, 5)
+
+  aie.objectfifo @of_in_c7 (%t7_0, {%t7_3}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+  aie.objectfifo @of_dequant_horizontal_c7 (%t7_3, {%t7_4}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+  aie.objectfifo @of_horizontal_vertical_c7 (%t7_4, {%t7_5}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+  aie.objectfifo @of_out_c7 (%t7_5, {%t7_0}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+
+  %buffer_in_c7 = aie.external_buffer { sym_name = "buffer_in_c7" } : memref<2048xi16>
+  %buffer_out_c7 = aie.external_buffer { sym_name = "buffer_out_c7" } : memref<2048xi16>
+
+  aie.objectfifo.register_external_buffers @of_in_c7 (%t7_0, {%buffer_in_c7}) : (memref<2048xi16>)
+  aie.objectfifo.register_external_buffers @of_out_c7 (%t7_0, {%buffer_out_c7}) : (memref<2048xi16>)
+
+  %c73 = aie.core(%t7_3) {
+    %lb = arith.constant 0 : index
+    %ub = arith.constant 4 : index
+    %step = arith.constant 1 : index
+
+    scf.for %iv = %lb to %ub step %step {
+      %inputSubview = aie.objectfifo.acquire @of_in_c7 (Consume, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %input = aie.objectfifo.subview.access %inputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+      %outputSubview = aie.objectfifo.acquire @of_dequant_horizontal_c7 (Produce, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %output = aie.objectfifo.subview.access %outputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+
+      func.call @dequant_8x8(%input, %output) : (memref<512xi16>, memref<512xi16>) -> ()
+
+      aie.objectfifo.release @of_in_c7 (Consume, 1)
+      aie.objectfifo.release @of_dequant_horizontal_c7 (Produce, 1)
+    }
+
+    aie.end
+  } { link_with="dequant.o" }
+
+  %c74 = aie.core(%t7_4) {
+    %lb = arith.constant 0 : index
+    %ub = arith.constant 4 : index
+    %step = arith.constant 1 : index
+
+    scf.for %iv = %lb to %ub step %step {
+      %inputSubview = aie.objectfifo.acquire @of_dequant_horizontal_c7 (Consume, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %input = aie.objectfifo.subview.access %inputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+      %outputSubview = aie.objectfifo.acquire @of_horizontal_vertical_c7 (Produce, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %output = aie.objectfifo.subview.access %outputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+
+      func.call @idct_8x8_mmult_h(%input, %output) : (memref<512xi16>, memref<512xi16>) -> ()
+
+      aie.objectfifo.release @of_dequant_horizontal_c7 (Consume, 1)
+      aie.objectfifo.release @of_horizontal_vertical_c7 (Produce, 1)
+    }
+
+    aie.end
+  } { link_with="idct_horizontal.o" }
+
+  %c75 = aie.core(%t7_5) {
+    %lb = arith.constant 0 : index
+    %ub = arith.constant 4 : index
+    %step = arith.constant 1 : index
+
+    scf.for %iv = %lb to %ub step %step {
+      %inputSubview = aie.objectfifo.acquire @of_horizontal_vertical_c7 (Consume, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %input = aie.objectfifo.subview.access %inputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+      %outputSubview = aie.objectfifo.acquire @of_out_c7 (Produce, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %output = aie.objectfifo.subview.access %outputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+
+      func.call @idct_8x8_mmult_v(%input, %output) : (memref<512xi16>, memref<512xi16>) -> ()
+
+      aie.objectfifo.release @of_horizontal_vertical_c7 (Consume, 1)
+      aie.objectfifo.release @of_out_c7 (Produce, 1)
+    }
+
+    aie.end
+  } { link_with="idct_vertical.o" }
+
+  // Column 10
+  %t10_0 = aie.tile(10, 0)
+  %t10_3 = aie.tile(10, 3)
+  %t10_4 = aie.tile(10, 4)
+  %t10_5 = aie.tile(10, 5)
+
+  aie.objectfifo @of_in_c10 (%t10_0, {%t10_3}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+  aie.objectfifo @of_dequant_horizontal_c10 (%t10_3, {%t10_4}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+  aie.objectfifo @of_horizontal_vertical_c10 (%t10_4, {%t10_5}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+  aie.objectfifo @of_out_c10 (%t10_5, {%t10_0}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+
+  %buffer_in_c10 = aie.external_buffer { sym_name = "buffer_in_c10" } : memref<2048xi16>
+  %buffer_out_c10 = aie.external_buffer { sym_name = "buffer_out_c10" } : memref<2048xi16>
+
+  aie.objectfifo.register_external_buffers @of_in_c10 (%t10_0, {%buffer_in_c10}) : (memref<2048xi16>)
+  aie.objectfifo.register_external_buffers @of_out_c10 (%t10_0, {%buffer_out_c10}) : (memref<2048xi16>)
+
+  %c103 = aie.core(%t10_3) {
+    %lb = arith.constant 0 : index
+    %ub = arith.constant 4 : index
+    %step = arith.constant 1 : index
+
+    scf.for %iv = %lb to %ub step %step {
+      %inputSubview = aie.objectfifo.acquire @of_in_c10 (Consume, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %input = aie.objectfifo.subview.access %inputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+      %outputSubview = aie.objectfifo.acquire @of_dequant_horizontal_c10 (Produce, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %output = aie.objectfifo.subview.access %outputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+
+      func.call @dequant_8x8(%input, %output) : (memref<512xi16>, memref<512xi16>) -> ()
+
+      aie.objectfifo.release @of_in_c10 (Consume, 1)
+      aie.objectfifo.release @of_dequant_horizontal_c10 (Produce, 1)
+    }
+
+    aie.end
+  } { link_with="dequant.o" }
+
+  %c104 = aie.core(%t10_4) {
+    %lb = arith.constant 0 : index
+    %ub = arith.constant 4 : index
+    %step = arith.constant 1 : index
+
+    scf.for %iv = %lb to %ub step %step {
+      %inputSubview = aie.objectfifo.acquire @of_dequant_horizontal_c10 (Consume, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %input = aie.objectfifo.subview.access %inputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+      %outputSubview = aie.objectfifo.acquire @of_horizontal_vertical_c10 (Produce, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %output = aie.objectfifo.subview.access %outputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+
+      func.call @idct_8x8_mmult_h(%input, %output) : (memref<512xi16>, memref<512xi16>) -> ()
+
+      aie.objectfifo.release @of_dequant_horizontal_c10 (Consume, 1)
+      aie.objectfifo.release @of_horizontal_vertical_c10 (Produce, 1)
+    }
+
+    aie.end
+  } { link_with="idct_horizontal.o" }
+
+  %c105 = aie.core(%t10_5) {
+    %lb = arith.constant 0 : index
+    %ub = arith.constant 4 : index
+    %step = arith.constant 1 : index
+
+    scf.for %iv = %lb to %ub step %step {
+      %inputSubview = aie.objectfifo.acquire @of_horizontal_vertical_c10 (Consume, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %input = aie.objectfifo.subview.access %inputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+      %outputSubview = aie.objectfifo.acquire @of_out_c10 (Produce, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %output = aie.objectfifo.subview.access %outputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+
+      func.call @idct_8x8_mmult_v(%input, %output) : (memref<512xi16>, memref<512xi16>) -> ()
+
+      aie.objectfifo.release @of_horizontal_vertical_c10 (Consume, 1)
+      aie.objectfifo.release @of_out_c10 (Produce, 1)
+    }
+
+    aie.end
+  } { link_with="idct_vertical.o" }
+
+  // Column 11
+  %t11_0 = aie.tile(11, 0)
+  %t11_3 = aie.tile(11, 3)
+  %t11_4 = aie.tile(11, 4)
+  %t11_5 = aie.tile(11, 5)
+
+  aie.objectfifo @of_in_c11 (%t11_0, {%t11_3}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+  aie.objectfifo @of_dequant_horizontal_c11 (%t11_3, {%t11_4}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+  aie.objectfifo @of_horizontal_vertical_c11 (%t11_4, {%t11_5}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+  aie.objectfifo @of_out_c11 (%t11_5, {%t11_0}, 2 : i32) : !aie.objectfifo<memref<512xi16>>
+
+  %buffer_in_c11 = aie.external_buffer { sym_name = "buffer_in_c11" } : memref<2048xi16>
+  %buffer_out_c11 = aie.external_buffer { sym_name = "buffer_out_c11" } : memref<2048xi16>
+
+  aie.objectfifo.register_external_buffers @of_in_c11 (%t11_0, {%buffer_in_c11}) : (memref<2048xi16>)
+  aie.objectfifo.register_external_buffers @of_out_c11 (%t11_0, {%buffer_out_c11}) : (memref<2048xi16>)
+
+  %c113 = aie.core(%t11_3) {
+    %lb = arith.constant 0 : index
+    %ub = arith.constant 4 : index
+    %step = arith.constant 1 : index
+
+    scf.for %iv = %lb to %ub step %step {
+      %inputSubview = aie.objectfifo.acquire @of_in_c11 (Consume, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %input = aie.objectfifo.subview.access %inputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+      %outputSubview = aie.objectfifo.acquire @of_dequant_horizontal_c11 (Produce, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %output = aie.objectfifo.subview.access %outputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+
+      func.call @dequant_8x8(%input, %output) : (memref<512xi16>, memref<512xi16>) -> ()
+
+      aie.objectfifo.release @of_in_c11 (Consume, 1)
+      aie.objectfifo.release @of_dequant_horizontal_c11 (Produce, 1)
+    }
+
+    aie.end
+  } { link_with="dequant.o" }
+
+  %c114 = aie.core(%t11_4) {
+    %lb = arith.constant 0 : index
+    %ub = arith.constant 4 : index
+    %step = arith.constant 1 : index
+
+    scf.for %iv = %lb to %ub step %step {
+      %inputSubview = aie.objectfifo.acquire @of_dequant_horizontal_c11 (Consume, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %input = aie.objectfifo.subview.access %inputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+      %outputSubview = aie.objectfifo.acquire @of_horizontal_vertical_c11 (Produce, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %output = aie.objectfifo.subview.access %outputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+
+      func.call @idct_8x8_mmult_h(%input, %output) : (memref<512xi16>, memref<512xi16>) -> ()
+
+      aie.objectfifo.release @of_dequant_horizontal_c11 (Consume, 1)
+      aie.objectfifo.release @of_horizontal_vertical_c11 (Produce, 1)
+    }
+
+    aie.end
+  } { link_with="idct_horizontal.o" }
+
+  %c115 = aie.core(%t11_5) {
+    %lb = arith.constant 0 : index
+    %ub = arith.constant 4 : index
+    %step = arith.constant 1 : index
+
+    scf.for %iv = %lb to %ub step %step {
+      %inputSubview = aie.objectfifo.acquire @of_horizontal_vertical_c11 (Consume, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %input = aie.objectfifo.subview.access %inputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+      %outputSubview = aie.objectfifo.acquire @of_out_c11 (Produce, 1) : !aie.objectfifosubview<memref<512xi16>>
+      %output = aie.objectfifo.subview.access %outputSubview[0] : !aie.objectfifosubview<memref<512xi16>> -> memref<512xi16>
+
+      func.call @idct_8x8_mmult_v(%input, %output) : (memref<512xi16>, memref<512xi16>) -> ()
+
+      aie.objectfifo.release @of_horizontal_vertical_c11 (Consume, 1)
+      aie.objectfifo.release @of_out_c11 (Produce, 1)
+    }
+
+    aie.end
+  } { link_with="idct_vertical.o" }
+}
@@ -0,0 +1,135 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "test_library.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include <xaiengine.h>
+
+#include "aie_inc.cpp"
+
+#define NUM_COLUMNS 4
+#define IMAGE_COUNT 512
+// Each column processes 4 objects of 8 blocks of 8x8 samples.
+#define DMA_COUNT 2048
+
+int main(int argc, char *argv[]) {
+  printf("test start.\n");
+
+  const int columns[NUM_COLUMNS] = {6, 7, 10, 11};
+
+  aie_libxaie_ctx_t *_xaie = mlir_aie_init_libxaie();
+  mlir_aie_init_device(_xaie);
+
+  for (int c = 0; c < NUM_COLUMNS; c++)
+    for (int row = 3; row <= 5; row++)
+      mlir_aie_clear_tile_memory(_xaie, columns[c], row);
+
+  mlir_aie_configure_cores(_xaie);
+  mlir_aie_configure_switchboxes(_xaie);
+  mlir_aie_initialize_locks(_xaie);
+  mlir_aie_configure_dmas(_xaie);
+
+  int errors = 0;
+
+  // Load IDCT Data
+  FILE *file = fopen("image.txt", "r");
+  if (file == NULL) {
+    perror("Error opening file: ");
+    return 1;
+  }
+  int image[IMAGE_COUNT];
+  int num;
+  int i = 0;
+  while (fscanf(file, "%d\n", &num) > 0 && i < IMAGE_COUNT) {
+    image[i] = num;
+    i++;
+  }
+  fclose(file);
+  printf("IDCT data loaded.\n");
+
+  // Every column decodes the image repeated over its whole input.
+  mlir_aie_init_mems(_xaie, 2 * NUM_COLUMNS);
+  int16_t *ddr_ptr_in[NUM_COLUMNS];
+  int16_t *ddr_ptr_out[NUM_COLUMNS];
+  for (int c = 0; c < NUM_COLUMNS; c++) {
+    ddr_ptr_in[c] = (int16_t *)mlir_aie_mem_alloc(_xaie, 2 * c, DMA_COUNT);
+    ddr_ptr_out[c] =
+        (int16_t *)mlir_aie_mem_alloc(_xaie, 2 * c + 1, DMA_COUNT);
+    for (int i = 0; i < DMA_COUNT; i++) {
+      ddr_ptr_in[c][i] = image[i % IMAGE_COUNT];
+      ddr_ptr_out[c][i] = 0;
+    }
+    mlir_aie_sync_mem_dev(_xaie, 2 * c);
+    mlir_aie_sync_mem_dev(_xaie, 2 * c + 1);
+  }
+
+  mlir_aie_external_set_addr_buffer_in_c6((u64)ddr_ptr_in[0]);
+  mlir_aie_external_set_addr_buffer_out_c6((u64)ddr_ptr_out[0]);
+  mlir_aie_external_set_addr_buffer_in_c7((u64)ddr_ptr_in[1]);
+  mlir_aie_external_set_addr_buffer_out_c7((u64)ddr_ptr_out[1]);
+  mlir_aie_external_set_addr_buffer_in_c10((u64)ddr_ptr_in[2]);
+  mlir_aie_external_set_addr_buffer_out_c10((u64)ddr_ptr_out[2]);
+  mlir_aie_external_set_addr_buffer_in_c11((u64)ddr_ptr_in[3]);
+  mlir_aie_external_set_addr_buffer_out_c11((u64)ddr_ptr_out[3]);
+  mlir_aie_configure_shimdma_60(_xaie);
+  mlir_aie_configure_shimdma_70(_xaie);
+  mlir_aie_configure_shimdma_100(_xaie);
+  mlir_aie_configure_shimdma_110(_xaie);
+
+  printf("Release lock for accessing DDR.\n");
+  mlir_aie_release_of_in_c6_lock_0(_xaie, 1, 0);
+  mlir_aie_release_of_out_c6_cons_lock_0(_xaie, 0, 0);
+  mlir_aie_release_of_in_c7_lock_0(_xaie, 1, 0);
+  mlir_aie_release_of_out_c7_cons_lock_0(_xaie, 0, 0);
+  mlir_aie_release_of_in_c10_lock_0(_xaie, 1, 0);
+  mlir_aie_release_of_out_c10_cons_lock_0(_xaie, 0, 0);
+  mlir_aie_release_of_in_c11_lock_0(_xaie, 1, 0);
+  mlir_aie_release_of_out_c11_cons_lock_0(_xaie, 0, 0);
+
+  printf("Start cores\n");
+  mlir_aie_start_cores(_xaie);
+
+  mlir_aie_acquire_of_out_c6_cons_lock_0(_xaie, 1, 0);
+  mlir_aie_acquire_of_out_c7_cons_lock_0(_xaie, 1, 0);
+  mlir_aie_acquire_of_out_c10_cons_lock_0(_xaie, 1, 0);
+  mlir_aie_acquire_of_out_c11_cons_lock_0(_xaie, 1, 0);
+  for (int c = 0; c < NUM_COLUMNS; c++)
+    mlir_aie_sync_mem_cpu(_xaie, 2 * c + 1);
+
+  // All the columns decode the same blocks, so every repetition of the image
+  // in every column must match the first one decoded by the first column.
+  for (int c = 0; c < NUM_COLUMNS; c++)
+    for (int i = 0; i < DMA_COUNT; i++)
+      mlir_aie_check("DDR out", ddr_ptr_out[c][i],
+                     ddr_ptr_out[0][i % IMAGE_COUNT], errors);
+
+  int res = 0;
+
+  if (!errors) {
+    printf("PASS!\n");
+    res = 0;
+  } else {
+    printf("Fail!\n");
+    res = -1;
+  }
+
+  mlir_aie_deinit_libxaie(_xaie);
+  printf("test done.\n");
+  return res;
+}
@@ -0,0 +1,245 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 AMD Inc.
+
+# Elementwise generator for bandwidth-bound ops: C = f(A[, B]) on tensors of N
+# elements, with any vectorized kernel f. The tensors are split into
+# contiguous chunks, one per stream, and every column runs as many streams as
+# its shim has MM2S channels for the inputs of the kernel: two streams of a
+# unary op, or one stream of a binary op, so that all the shim channels of the
+# array move data. Each stream is double-buffered through the memtile of its
+# column, on its way to and back from a compute tile of its own, which calls
+# the kernel on each tile of n elements:
+#
+#     kernel(in0, [in1,] out, n)
+#
+# elementwise() places the design in the device being built and
+# elementwise_sequence() its transfers in the runtime sequence, so that larger
+# designs embed bandwidth-bound ops the same way.
+
+import argparse
+import sys
+
+from aie.extras.context import mlir_mod_ctx
+
+from aie.dialects.aie import *
+from aie.dialects.aiex import *
+from aie.dialects.scf import *
+
+# The columns of the IPU array, and the MM2S and S2MM channels of its shims.
+MAX_COLS = 4
+SHIM_CHANNELS = 2
+
+# The element types of the kernels, and their size in bytes.
+DTYPES = {
+    "i8": (T.i8, 1),
+    "i16": (T.i16, 2),
+    "i32": (T.i32, 4),
+    "bf16": (T.bf16, 2),
+    "f32": (T.f32, 4),
+}
+
+
+def streams_per_col(n_inputs):
+    return SHIM_CHANNELS // n_inputs
+
+
+def check_config(N, n, n_inputs, n_cols, dtype):
+    if not 1 <= n_inputs <= SHIM_CHANNELS:
+        return f"the kernel must take between 1 and {SHIM_CHANNELS} inputs"
+    if not 1 <= n_cols <= MAX_COLS:
+        return f"the number of columns must be between 1 and {MAX_COLS}"
+    if n * DTYPES[dtype][1] % 4:
+        return "the tiles must be a multiple of 4 bytes"
+    streams = n_cols * streams_per_col(n_inputs)
+    if N % (n * streams):
+        return (
+            f"{N} is not a multiple of the {n * streams} elements processed by"
+            f" the {streams} streams at once"
+        )
+    return None
+
+
+def auto_cols(N, n, n_inputs, dtype):
+    # The most columns, and so shim channels, the tensors can be spread over.
+    for n_cols in range(MAX_COLS, 0, -1):
+        if not check_config(N, n, n_inputs, n_cols, dtype):
+            return n_cols
+    return 1
+
+
+class Elementwise:
+    """An elementwise design placed by elementwise(): the column, the input
+    object fifos and the output object fifo of each stream, in the order of
+    their chunks of the tensors."""
+
+    def __init__(self, N, n, word_size):
+        self.N = N
+        self.n = n
+        self.word_size = word_size
+        self.streams = []
+
+    def chunk_in_i32s(self):
+        return self.N // len(self.streams) * self.word_size // 4
+
+    def tile_in_i32s(self):
+        return self.n * self.word_size // 4
+
+
+def elementwise(
+    N,
+    n,
+    kernel,
+    obj,
+    n_inputs=1,
+    n_cols=MAX_COLS,
+    dtype="i32",
+    first_col=0,
+    name="ew",
+):
+    """Place C = kernel(A[, B]) in the device being built, on the n_cols
+    columns from first_col, with the compute tiles from row 2."""
+    error = check_config(N, n, n_inputs, n_cols, dtype)
+    if error:
+        raise ValueError(error)
+    elem_ty, word_size = DTYPES[dtype]
+    design = Elementwise(N, n, word_size)
+    tiles = N // (n * n_cols * streams_per_col(n_inputs))
+
+    memRef_ty = T.memref(n, elem_ty())
+    ofifo_memRef_ty = TypeAttr.get(ObjectFifoType.get(memRef_ty))
+
+    # AIE Core Function declarations
+    kernel_func = external_func(kernel, inputs=[memRef_ty] * (n_inputs + 1) + [T.i32()])
+
+    for col in range(first_col, first_col + n_cols):
+        shim = tile(col, 0)
+        mem = tile(col, 1)
+        for s in range(streams_per_col(n_inputs)):
+            compute = tile(col, 2 + s)
+            prefix = f"{name}{col}{s}"
+            in_fifos = [f"{prefix}in{i}" for i in range(n_inputs)]
+            mem_fifos = [f"{prefix}mem{i}" for i in range(n_inputs)]
+            out_fifo = f"{prefix}out"
+            memout_fifo = f"{prefix}memout"
+
+            # AIE-array data movement with object fifos, double-buffered in
+            # the memtile both ways
+            for in_fifo, mem_fifo in zip(in_fifos, mem_fifos):
+                objectfifo(in_fifo, shim, [mem], 2, ofifo_memRef_ty, [], [])
+                objectfifo(mem_fifo, mem, [compute], 2, ofifo_memRef_ty, [], [])
+                objectfifo_link([in_fifo], [mem_fifo])
+            objectfifo(memout_fifo, compute, [mem], 2, ofifo_memRef_ty, [], [])
+            objectfifo(out_fifo, mem, [shim], 2, ofifo_memRef_ty, [], [])
+            objectfifo_link([memout_fifo], [out_fifo])
+            design.streams.append((col, in_fifos, out_fifo))
+
+            elementwise_core(
+                compute, obj, kernel_func, memRef_ty, n, mem_fifos, memout_fifo, tiles
+            )
+
+    return design
+
+
+def elementwise_core(
+    compute, obj, kernel_func, memRef_ty, n, in_fifos, out_fifo, tiles
+):
+    @core(compute, obj)
+    def core_body():
+        # Effective while(1)
+        for _ in for_(sys.maxsize):
+            for _ in for_(tiles):
+                elem_out = acquire(
+                    ObjectFifoPort.Produce, out_fifo, 1, memRef_ty
+                ).acquired_elem()
+                elems_in = [
+                    acquire(
+                        ObjectFifoPort.Consume, in_fifo, 1, memRef_ty
+                    ).acquired_elem()
+                    for in_fifo in in_fifos
+                ]
+                Call(kernel_func, elems_in + [elem_out, n])
+                for in_fifo in in_fifos:
+                    objectfifo_release(ObjectFifoPort.Consume, in_fifo, 1)
+                objectfifo_release(ObjectFifoPort.Produce, out_fifo, 1)
+                yield_([])
+            yield_([])
+
+
+def elementwise_sequence(design, inputs, output, first_bd_id=0):
+    """Move the chunk of each stream of an elementwise design between the
+    host buffers, of 32-bit words, and the array, and wait for the outputs.
+    Returns the next free buffer descriptor id of the shims."""
+    chunk = design.chunk_in_i32s()
+    tile_sz = design.tile_in_i32s()
+    bd_ids = {}
+    for index, (col, in_fifos, out_fifo) in enumerate(design.streams):
+        bd_id = bd_ids.get(col, first_bd_id)
+        offset = index * chunk
+        for fifo, mem in [(out_fifo, output)] + list(zip(in_fifos, inputs)):
+            ipu_dma_memcpy_nd(
+                metadata=fifo,
+                bd_id=bd_id,
+                mem=mem,
+                offsets=[0, 0, 0, offset],
+                sizes=[1, 1, chunk // tile_sz, tile_sz],
+                strides=[0, 0, tile_sz],
+            )
+            bd_id += 1
+        bd_ids[col] = bd_id
+    # The output object fifos of a column are on its S2MM channels in order.
+    for col in sorted(bd_ids):
+        for channel in range(sum(1 for c, _, _ in design.streams if c == col)):
+            ipu_sync(column=col, row=0, direction=0, channel=channel)
+    return max(bd_ids.values())
+
+
+def my_elementwise(N, n, kernel, obj, n_inputs, n_cols, dtype):
+    word_size = DTYPES[dtype][1]
+
+    with mlir_mod_ctx() as ctx:
+
+        @device(AIEDevice.ipu)
+        def device_body():
+            design = elementwise(N, n, kernel, obj, n_inputs, n_cols, dtype)
+
+            # To/from AIE-array data movement
+            tensor_ty = T.memref(N * word_size // 4, T.i32())
+
+            @FuncOp.from_py_func(tensor_ty, tensor_ty, tensor_ty)
+            def sequence(A, B, C):
+                elementwise_sequence(design, [A, B][:n_inputs], C)
+
+    print(ctx.module)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("-N", type=int, default=1048576)
+    parser.add_argument("-n", type=int, default=1024, help="the kernel tile size")
+    parser.add_argument("--kernel", default="scale_i32")
+    parser.add_argument("--obj", default="elementwise.o")
+    parser.add_argument("--inputs", type=int, default=1)
+    parser.add_argument("--dtype", choices=DTYPES, default="i32")
+    parser.add_argument(
+        "--n-cols",
+        type=int,
+        default=0,
+        help="the number of columns to use, 0 to use as many as the sizes allow",
+    )
+    args = parser.parse_args()
+
+    n_cols = args.n_cols or auto_cols(args.N, args.n, args.inputs, args.dtype)
+    error = check_config(args.N, args.n, args.inputs, n_cols, args.dtype)
+    if error:
+        parser.error(error)
+    my_elementwise(
+        args.N, args.n, args.kernel, args.obj, args.inputs, n_cols, args.dtype
+    )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,79 @@
+//===- elementwise.cc -------------------------------------000---*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Vectorized kernels for the elementwise design of aie2.py, called on each
+// tile of n elements as kernel(in0, [in1,] out, n):
+//
+//   scale_<type>: C = 3 * A
+//   add_<type>:   C = A + B
+
+#define __AIENGINE__ 2
+#define NOCPP
+#define __AIEARCH__ 20
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <type_traits>
+
+#define REL_WRITE 0
+#define REL_READ 1
+
+#include <aie_api/aie.hpp>
+
+// The number of elements of a 512-bit vector.
+template <typename T> constexpr unsigned vector_size = 64 / sizeof(T);
+
+template <typename T>
+void scale_vectorized(const T *__restrict a, T *__restrict c, T factor,
+                      int32_t n) {
+  constexpr unsigned r = vector_size<T>;
+  event0();
+  for (int i = 0; i < n; i += r)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      aie::vector<T, r> A = aie::load_v<r>(a + i);
+      aie::store_v(c + i, aie::mul(A, factor).template to_vector<T>());
+    }
+  event1();
+}
+
+template <typename T>
+void add_vectorized(const T *__restrict a, const T *__restrict b,
+                    T *__restrict c, int32_t n) {
+  constexpr unsigned r = vector_size<T>;
+  event0();
+  for (int i = 0; i < n; i += r)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      aie::vector<T, r> A = aie::load_v<r>(a + i);
+      aie::vector<T, r> B = aie::load_v<r>(b + i);
+      aie::store_v(c + i, aie::add(A, B));
+    }
+  event1();
+}
+
+extern "C" {
+
+void scale_i32(int32_t *a_in, int32_t *c_out, int32_t n) {
+  scale_vectorized<int32_t>(a_in, c_out, 3, n);
+}
+
+void scale_i16(int16_t *a_in, int16_t *c_out, int32_t n) {
+  scale_vectorized<int16_t>(a_in, c_out, 3, n);
+}
+
+void add_i32(int32_t *a_in, int32_t *b_in, int32_t *c_out, int32_t n) {
+  add_vectorized<int32_t>(a_in, b_in, c_out, n);
+}
+
+void add_i16(int16_t *a_in, int16_t *b_in, int16_t *c_out, int32_t n) {
+  add_vectorized<int16_t>(a_in, b_in, c_out, n);
+}
+
+} // extern "C"
@@ -0,0 +1,180 @@
+//===- test.cpp -------------------------------------------000---*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include <boost/program_options.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#include "ipu_host.h"
+
+// The size of the tensors, given to aie2.py with -N.
+#ifndef EW_N
+#define EW_N 1048576
+#endif
+
+constexpr int N = EW_N;
+
+using DATATYPE = int32_t;
+
+constexpr int size = N * sizeof(DATATYPE);
+
+namespace po = boost::program_options;
+
+void checkArgFileExists(po::variables_map &vmIn, std::string name) {
+  if (!vmIn.count(name)) {
+    throw std::runtime_error("Error: no " + name + " file was provided\n");
+  }
+  std::ifstream test(vmIn[name].as<std::string>());
+  if (!test) {
+    throw std::runtime_error("The " + name + " file " +
+                             vmIn[name].as<std::string>() +
+                             " does not exist.\n");
+  }
+}
+
+int main(int argc, const char *argv[]) {
+
+  // Program arguments parsing
+  po::options_description desc("Allowed options");
+  desc.add_options()("help,h", "produce help message")(
+      "xclbin,x", po::value<std::string>()->required(),
+      "the input xclbin path")(
+      "kernel,k", po::value<std::string>()->required(),
+      "the kernel name in the XCLBIN (for instance PP_PRE_FD)")(
+      "verbosity,v", po::value<int>()->default_value(0),
+      "the verbosity of the output")(
+      "op", po::value<std::string>()->default_value("scale"),
+      "the op of the kernel given to aie2.py, scale or add")(
+      "warmup", po::value<int>()->default_value(0),
+      "the number of untimed runs before the benchmark")(
+      "iters", po::value<int>()->default_value(0),
+      "the number of timed runs of the benchmark, 0 to skip it")(
+      "ddr-peak", po::value<double>()->default_value(0),
+      "the DDR bandwidth in GB/s measured by passthrough_hardware, to report "
+      "the bandwidth of the design against")(
+      "instr,i", po::value<std::string>()->required(),
+      "path of file containing userspace instructions to be sent to the LX6");
+  po::variables_map vm;
+
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+      std::cout << desc << "\n";
+      return 1;
+    }
+  } catch (const std::exception &ex) {
+    std::cerr << ex.what() << "\n\n";
+    std::cerr << "Usage:\n" << desc << "\n";
+    return 1;
+  }
+
+  checkArgFileExists(vm, "xclbin");
+  checkArgFileExists(vm, "instr");
+
+  std::string op = vm["op"].as<std::string>();
+  if (op != "scale" && op != "add") {
+    std::cerr << "Unknown op " << op << "\n";
+    return 1;
+  }
+  bool binary = op == "add";
+
+  std::vector<uint32_t> instrV =
+      ipu_host::load_instr_sequence(vm["instr"].as<std::string>());
+
+  int verbosity = vm["verbosity"].as<int>();
+  if (verbosity >= 1)
+    std::cout << "Sequence instr count: " << instrV.size() << "\n";
+
+  // Load the xclbin, register it on the device and get the kernel
+  if (verbosity >= 1)
+    std::cout << "Loading xclbin: " << vm["xclbin"].as<std::string>() << "\n";
+  ipu_host::kernel kernel(vm["xclbin"].as<std::string>(),
+                          vm["kernel"].as<std::string>(), instrV);
+
+  auto boA = kernel.allocate(size, 0, true);
+  auto boB = kernel.allocate(size, 1, true);
+  auto boC = kernel.allocate(size, 2, true);
+
+  if (verbosity >= 1)
+    std::cout << "Writing data into buffer objects.\n";
+  DATATYPE *bufA = boA.map<DATATYPE *>();
+  DATATYPE *bufB = boB.map<DATATYPE *>();
+  for (int i = 0; i < N; i++) {
+    bufA[i] = i + 1;
+    bufB[i] = 2 * i;
+  }
+  memset(boC.map<DATATYPE *>(), 0, size);
+
+  if (verbosity >= 1)
+    std::cout << "Running Kernel.\n";
+  if (kernel.call({boA, boB, boC}) != ERT_CMD_STATE_COMPLETED) {
+    std::cout << "Kernel failed.\n";
+    return 1;
+  }
+
+  DATATYPE *bufOut = boC.map<DATATYPE *>();
+
+  int errors = 0;
+  int maxErrors = 100;
+  for (int i = 0; i < N; i++) {
+    DATATYPE ref = binary ? bufA[i] + bufB[i] : 3 * bufA[i];
+    if (bufOut[i] != ref) {
+      errors++;
+      if (errors < maxErrors)
+        std::cout << "\nerror, id " << i << " expected " << ref << ", got "
+                  << bufOut[i] << "\n";
+    }
+  }
+
+  // Each timed run only includes the kernel, without the syncs of the
+  // buffers. The design is bound by the bandwidth of the shims, reported
+  // against the DDR peak measured by the same kernel only runs of
+  // passthrough_hardware.
+  int iters = vm["iters"].as<int>();
+  if (iters > 0) {
+    int tensors = binary ? 3 : 2;
+    ipu_host::benchmark_result result = ipu_host::benchmark(
+        [&]() {
+          auto run = kernel.xrtKernel(kernel.instructions,
+                                      kernel.numInstructions, boA, boB, boC);
+          run.wait();
+        },
+        vm["warmup"].as<int>(), iters);
+    ipu_host::print_benchmark_json(std::cout, "elementwise_" + op, result,
+                                   N, double(tensors) * size);
+
+    double gbps = double(tensors) * size / result.mean_us() / 1e3;
+    std::cout << "Bandwidth: " << gbps << " GB/s";
+    double ddrPeak = vm["ddr-peak"].as<double>();
+    if (ddrPeak > 0)
+      std::cout << ", " << 100 * gbps / ddrPeak << "% of the " << ddrPeak
+                << " GB/s DDR peak";
+    std::cout << "\n";
+  }
+
+  if (!errors) {
+    std::cout << "\nPASS!\n\n";
+    return 0;
+  }
+  std::cout << "\nerror count: " << errors << "\n\n";
+  std::cout << "\nfailed.\n\n";
+  return 1;
+}
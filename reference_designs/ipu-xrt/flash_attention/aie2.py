@@ -0,0 +1,330 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 AMD Inc.
+
+# Flash attention: O = softmax(Q * K^T / sqrt(D)) * V for `heads` heads of
+# seq_len queries, keys and values of D bfloat16s, one head per column. The
+# memtile of a column distributes the tiles of Br queries of its head over the
+# n_rows cores of the column, round-robin, and broadcasts to all of them the
+# tiles of Bc keys and values, which each core folds into the output of its
+# queries with attention.cc. The whole K and V of the head stream through the
+# memtile once per round of query tiles, so that the seq_len x seq_len scores
+# never leave the cores. The memtile joins the output tiles of the cores.
+#
+# The host packs K and V by tiles of Bc keys: the D x Bc tile of K^T, then the
+# Bc x D tile of V. The DMAs of the memtile lay the tiles out in the blocks of
+# the mmuls, which for both halves of a K/V tile is the same pattern since
+# Bc = D.
+
+import argparse
+
+from aie.extras.context import mlir_mod_ctx
+
+from aie.dialects.aie import *
+from aie.dialects.aiex import *
+from aie.dialects.scf import *
+
+# The columns of the IPU array and the compute tiles in each of them.
+MAX_COLS = 4
+MAX_ROWS = 4
+
+# The sizes attention.cc is compiled for: the head dimension, and the queries
+# and keys of a tile.
+D = 64
+Br = 16
+Bc = 64
+
+# The (r, s, t) shape of the mmuls of attention.cc.
+r, s, t = 4, 8, 4
+
+word_size = 2
+
+
+def check_config(seq_len, heads, n_rows):
+    if not 1 <= heads <= MAX_COLS:
+        return f"the number of heads must be between 1 and {MAX_COLS}"
+    if not 1 <= n_rows <= MAX_ROWS:
+        return f"the number of rows must be between 1 and {MAX_ROWS}"
+    if seq_len % (Br * n_rows) or seq_len % Bc:
+        return (
+            f"the sequence length must be a multiple of {Br * n_rows} queries"
+            f" and of {Bc} keys"
+        )
+    return None
+
+
+def flash_attention(seq_len, heads, n_rows):
+    rounds = seq_len // (Br * n_rows)
+    kv_tiles = seq_len // Bc
+
+    D_in_i32s = D * word_size // 4
+    head_in_i32s = seq_len * D_in_i32s
+
+    with mlir_mod_ctx() as ctx:
+
+        @device(AIEDevice.ipu)
+        def device_body():
+            memRef_inQ_ty = T.memref(Br * D * n_rows, T.bf16())
+            memRef_outO_ty = T.memref(Br * D * n_rows, T.bf16())
+            memRef_Q_ty = T.memref(Br * D, T.bf16())
+            memRef_KV_ty = T.memref(2 * Bc * D, T.bf16())
+            memRef_O_ty = T.memref(Br * D, T.bf16())
+            memRef_acc_ty = T.memref(Br * D, T.f32())
+            memRef_stats_ty = T.memref(3 * Br, T.f32())
+            memRef_scores_ty = T.memref(Br * Bc, T.f32())
+            memRef_P_ty = T.memref(Br * Bc, T.bf16())
+
+            ofifo_memRef_inQ_ty = TypeAttr.get(ObjectFifoType.get(memRef_inQ_ty))
+            ofifo_memRef_outO_ty = TypeAttr.get(ObjectFifoType.get(memRef_outO_ty))
+            ofifo_memRef_Q_ty = TypeAttr.get(ObjectFifoType.get(memRef_Q_ty))
+            ofifo_memRef_KV_ty = TypeAttr.get(ObjectFifoType.get(memRef_KV_ty))
+            ofifo_memRef_O_ty = TypeAttr.get(ObjectFifoType.get(memRef_O_ty))
+
+            # AIE Core Function declarations
+            attn_init = external_func(
+                "attn_init_bf16", inputs=[memRef_acc_ty, memRef_stats_ty]
+            )
+            attn_step = external_func(
+                "attn_step_bf16",
+                inputs=[
+                    memRef_Q_ty,
+                    memRef_KV_ty,
+                    memRef_acc_ty,
+                    memRef_stats_ty,
+                    memRef_scores_ty,
+                    memRef_P_ty,
+                ],
+            )
+            attn_finish = external_func(
+                "attn_finish_bf16",
+                inputs=[memRef_acc_ty, memRef_stats_ty, memRef_O_ty],
+            )
+
+            # Tile declarations
+            shims = []
+            mems = []
+            cores = []
+            for col in range(heads):
+                shims.append(tile(col, 0))
+                mems.append(tile(col, 1))
+                cores.append([tile(col, 2 + row) for row in range(n_rows)])
+
+            inQ_fifos = [f"inQ{col}" for col in range(heads)]
+            inKV_fifos = [f"inKV{col}" for col in range(heads)]
+            memQ_fifos = [
+                [f"memQ{col}{row}" for row in range(n_rows)] for col in range(heads)
+            ]
+            memKV_fifos = [f"memKV{col}" for col in range(heads)]
+            memO_fifos = [
+                [f"memO{col}{row}" for row in range(n_rows)] for col in range(heads)
+            ]
+            outO_fifos = [f"outO{col}" for col in range(heads)]
+
+            # AIE-array data movement with object fifos
+            for col in range(heads):
+                # Q, distributed over the cores of the column in r x s blocks
+                objectfifo(
+                    inQ_fifos[col],
+                    shims[col],
+                    [mems[col]],
+                    2,
+                    ofifo_memRef_inQ_ty,
+                    [],
+                    [],
+                )
+                for row in range(n_rows):
+                    objectfifo(
+                        memQ_fifos[col][row],
+                        mems[col],
+                        [cores[col][row]],
+                        2,
+                        ofifo_memRef_Q_ty,
+                        [
+                            (Br // r, r * D * word_size // 4),
+                            (D // s, s * word_size // 4),
+                            (r, D * word_size // 4),
+                            (s * word_size // 4, 1),
+                        ],
+                        [],
+                    )
+                objectfifo_link([inQ_fifos[col]], memQ_fifos[col])
+
+                # K^T and V, broadcast to the cores of the column in s x t
+                # blocks
+                objectfifo(
+                    inKV_fifos[col],
+                    shims[col],
+                    [mems[col]],
+                    2,
+                    ofifo_memRef_KV_ty,
+                    [],
+                    [],
+                )
+                objectfifo(
+                    memKV_fifos[col],
+                    mems[col],
+                    cores[col],
+                    2,
+                    ofifo_memRef_KV_ty,
+                    [
+                        (D // s, s * Bc * word_size // 4),
+                        (Bc // t, t * word_size // 4),
+                        (s, Bc * word_size // 4),
+                        (t * word_size // 4, 1),
+                    ],
+                    [],
+                )
+                objectfifo_link([inKV_fifos[col]], [memKV_fifos[col]])
+
+                # O, joined from the r x t blocks of the cores
+                for row in range(n_rows):
+                    objectfifo(
+                        memO_fifos[col][row],
+                        cores[col][row],
+                        [mems[col]],
+                        2,
+                        ofifo_memRef_O_ty,
+                        [],
+                        [],
+                    )
+                objectfifo(
+                    outO_fifos[col],
+                    mems[col],
+                    shims[col],
+                    2,
+                    ofifo_memRef_outO_ty,
+                    [
+                        (Br // r, r * D * word_size // 4),
+                        (r, t * word_size // 4),
+                        (D // t, r * t * word_size // 4),
+                        (t * word_size // 4, 1),
+                    ],
+                    [],
+                )
+                objectfifo_link(memO_fifos[col], [outO_fifos[col]])
+
+            # Set up compute tiles
+            for col in range(heads):
+                for row in range(n_rows):
+                    acc = buffer(
+                        cores[col][row], [Br * D], T.f32(), name=f"acc{col}{row}"
+                    )
+                    stats = buffer(
+                        cores[col][row], [3 * Br], T.f32(), name=f"stats{col}{row}"
+                    )
+                    scores = buffer(
+                        cores[col][row], [Br * Bc], T.f32(), name=f"scores{col}{row}"
+                    )
+                    p = buffer(
+                        cores[col][row], [Br * Bc], T.bf16(), name=f"p{col}{row}"
+                    )
+
+                    @core(cores[col][row], "attention.a")
+                    def core_body():
+                        for _ in for_(0xFFFFFFFF):
+                            for _ in for_(rounds):
+                                elem_q = acquire(
+                                    ObjectFifoPort.Consume,
+                                    memQ_fifos[col][row],
+                                    1,
+                                    memRef_Q_ty,
+                                ).acquired_elem()
+                                Call(attn_init, [acc, stats])
+
+                                for _ in for_(kv_tiles):
+                                    elem_kv = acquire(
+                                        ObjectFifoPort.Consume,
+                                        memKV_fifos[col],
+                                        1,
+                                        memRef_KV_ty,
+                                    ).acquired_elem()
+                                    Call(
+                                        attn_step,
+                                        [elem_q, elem_kv, acc, stats, scores, p],
+                                    )
+                                    objectfifo_release(
+                                        ObjectFifoPort.Consume, memKV_fifos[col], 1
+                                    )
+                                    yield_([])
+
+                                elem_out = acquire(
+                                    ObjectFifoPort.Produce,
+                                    memO_fifos[col][row],
+                                    1,
+                                    memRef_O_ty,
+                                ).acquired_elem()
+                                Call(attn_finish, [acc, stats, elem_out])
+                                objectfifo_release(
+                                    ObjectFifoPort.Produce, memO_fifos[col][row], 1
+                                )
+                                objectfifo_release(
+                                    ObjectFifoPort.Consume, memQ_fifos[col][row], 1
+                                )
+                                yield_([])
+                            yield_([])
+
+            # To/from AIE-array data movement
+
+            @FuncOp.from_py_func(
+                T.memref(heads * head_in_i32s, T.i32()),
+                T.memref(2 * heads * head_in_i32s, T.i32()),
+                T.memref(heads * head_in_i32s, T.i32()),
+            )
+            def sequence(Q, KV, O):
+                for col in range(heads):
+                    ipu_dma_memcpy_nd(
+                        metadata=outO_fifos[col],
+                        bd_id=0,
+                        mem=O,
+                        offsets=[0, 0, 0, col * head_in_i32s],
+                        sizes=[1, 1, seq_len, D_in_i32s],
+                        strides=[0, 0, D_in_i32s],
+                    )
+                    ipu_dma_memcpy_nd(
+                        metadata=inQ_fifos[col],
+                        bd_id=1,
+                        mem=Q,
+                        offsets=[0, 0, 0, col * head_in_i32s],
+                        sizes=[1, 1, seq_len, D_in_i32s],
+                        strides=[0, 0, D_in_i32s],
+                    )
+                    # The whole K and V of the head, once per round.
+                    ipu_dma_memcpy_nd(
+                        metadata=inKV_fifos[col],
+                        bd_id=2,
+                        mem=KV,
+                        offsets=[0, 0, 0, 2 * col * head_in_i32s],
+                        sizes=[rounds, kv_tiles, 2 * Bc, D_in_i32s],
+                        strides=[0, 2 * Bc * D_in_i32s, D_in_i32s],
+                    )
+                for col in range(heads):
+                    ipu_sync(column=col, row=0, direction=0, channel=0)
+
+    print(ctx.module)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--seq-len", type=int, default=256)
+    parser.add_argument(
+        "--heads", type=int, default=MAX_COLS, help="the heads, one per column"
+    )
+    parser.add_argument(
+        "--n-rows",
+        type=int,
+        default=MAX_ROWS,
+        help="the cores of a column sharing the queries of its head",
+    )
+    args = parser.parse_args()
+
+    error = check_config(args.seq_len, args.heads, args.n_rows)
+    if error:
+        parser.error(error)
+    flash_attention(args.seq_len, args.heads, args.n_rows)
+
+
+if __name__ == "__main__":
+    main()
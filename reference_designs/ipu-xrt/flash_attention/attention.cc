@@ -0,0 +1,235 @@
+//===- attention.cc ---------------------------------------000---*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Flash attention kernels for AIE2, computing softmax(Q * K^T / sqrt(D)) * V
+// for a tile of Br queries as the tiles of Bc keys and values stream through
+// the core. The softmax is computed online: the running max m and sum l of the
+// exponentials of each query row rescale the output accumulated so far when a
+// new tile raises the max, so that the scores of a query are never stored
+// whole.
+//
+// The operands of the mmuls are in the blocked layouts of
+// ../matmul_kernels/mm.h, made by the DMAs of the memtile: Q in r x s blocks,
+// K^T and V in s x t blocks, and the output in r x t blocks. The scores are
+// stored row-major for the softmax of each row, and their exponentials P are
+// read back in r x s blocks as the A operand of P * V.
+//
+//   attn_init_bf16:   O = 0, m = -inf, l = 0
+//   attn_step_bf16:   fold a tile of keys and values into O, m and l
+//   attn_finish_bf16: out = O / l
+
+#define __AIENGINE__ 2
+#define NOCPP
+#define __AIEARCH__ 20
+
+#include <aie_api/aie.hpp>
+
+#include "lut_based_ops.h"
+
+#ifndef DIM_BR
+#define DIM_BR 16
+#endif
+#ifndef DIM_BC
+#define DIM_BC 64
+#endif
+#ifndef DIM_D
+#define DIM_D 64
+#endif
+
+constexpr unsigned Br = DIM_BR;
+constexpr unsigned Bc = DIM_BC;
+constexpr unsigned D = DIM_D;
+
+constexpr unsigned r = 4, s = 8, t = 4;
+using MMUL = aie::mmul<r, s, t, bfloat16, bfloat16, accfloat>;
+
+static_assert(Br % 16 == 0 && Bc % 16 == 0 && D % 16 == 0,
+              "the rows are processed by vectors of 16 lanes");
+static_assert(Bc % s == 0 && D % s == 0 && D % t == 0,
+              "the tiles are evenly divisible into blocks");
+
+// The square root of x, computed at compile time by Newton's method.
+constexpr float sqrtNewton(float x, float guess, int iterations) {
+  return iterations == 0
+             ? guess
+             : sqrtNewton(x, 0.5f * (guess + x / guess), iterations - 1);
+}
+
+constexpr float SCALE = 1.0f / sqrtNewton(D, D, 20);
+
+// The running max of the rows before their first tile: low enough for its
+// exponential to be 0, without the infinities of -inf.
+constexpr float MIN_MAX = -1e30f;
+
+inline __attribute__((always_inline)) aie::vector<bfloat16, 16>
+toBf16(aie::vector<float, 16> x) {
+  aie::accum<accfloat, 16> acc;
+  acc.from_vector(x);
+  return acc.to_vector<bfloat16>();
+}
+
+// The vector of the r x t block of rows bi * r to bi * r + r - 1 with, in each
+// row, the factor of the row.
+inline __attribute__((always_inline)) aie::vector<float, MMUL::size_C>
+rowFactors(const float *__restrict factors, unsigned bi) {
+  aie::vector<float, MMUL::size_C> vec;
+  for (unsigned ii = 0; ii < r; ii++)
+    for (unsigned jj = 0; jj < t; jj++)
+      vec.set(factors[bi * r + ii], ii * t + jj);
+  return vec;
+}
+
+// S = Q * K^T / sqrt(D), with S stored row-major.
+static void scores(const bfloat16 *__restrict q, const bfloat16 *__restrict kt,
+                   float *__restrict sc) {
+  for (unsigned bi = 0; bi < Br / r; bi++)
+    for (unsigned bj = 0; bj < Bc / t; bj++)
+      chess_prepare_for_pipelining chess_loop_range(1, ) {
+        const bfloat16 *__restrict pA = q + bi * (D / s) * MMUL::size_A;
+        const bfloat16 *__restrict pB = kt + bj * MMUL::size_B;
+        MMUL acc;
+        acc.mul(aie::load_v<MMUL::size_A>(pA), aie::load_v<MMUL::size_B>(pB));
+        for (unsigned bk = 1; bk < D / s; bk++)
+          chess_flatten_loop {
+            pA += MMUL::size_A;
+            pB += MMUL::size_B * (Bc / t);
+            acc.mac(aie::load_v<MMUL::size_A>(pA),
+                    aie::load_v<MMUL::size_B>(pB));
+          }
+        aie::vector<float, MMUL::size_C> block =
+            aie::mul(acc.to_vector<float>(), SCALE).to_vector<float>();
+        float *__restrict pS = sc + bi * r * Bc + bj * t;
+        for (unsigned ii = 0; ii < r; ii++)
+          aie::store_v(pS + ii * Bc, block.extract<t>(ii));
+      }
+}
+
+// Fold the scores of a tile into the running max m and sum l of each row,
+// storing P = exp(S - m) and, in corr, exp(m_old - m) by which what was
+// accumulated with the old max is rescaled.
+static void onlineSoftmax(const float *__restrict sc, bfloat16 *__restrict p,
+                          float *__restrict stats) {
+  float *__restrict m = stats;
+  float *__restrict l = stats + Br;
+  float *__restrict corr = stats + 2 * Br;
+
+  for (unsigned i = 0; i < Br; i++) {
+    const float *__restrict row = sc + i * Bc;
+    aie::vector<float, 16> maxVec = aie::load_v<16>(row);
+    for (unsigned j = 16; j < Bc; j += 16)
+      chess_prepare_for_pipelining chess_loop_range(1, ) {
+        maxVec = aie::max(maxVec, aie::load_v<16>(row + j));
+      }
+    float rowMax = aie::reduce_max(maxVec);
+    float newMax = m[i] > rowMax ? m[i] : rowMax;
+    corr[i] = m[i] - newMax;
+    m[i] = newMax;
+  }
+
+  for (unsigned i = 0; i < Br; i += 16)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      aie::accum<accfloat, 16> expAcc =
+          getExpBf16(toBf16(aie::load_v<16>(corr + i)));
+      aie::store_v(corr + i, expAcc.to_vector<float>());
+    }
+
+  for (unsigned i = 0; i < Br; i++) {
+    const float *__restrict row = sc + i * Bc;
+    bfloat16 *__restrict pRow = p + i * Bc;
+    aie::accum<accfloat, 16> sumAcc;
+    sumAcc.from_vector(aie::zeros<bfloat16, 16>());
+    for (unsigned j = 0; j < Bc; j += 16)
+      chess_prepare_for_pipelining chess_loop_range(1, ) {
+        aie::vector<float, 16> x = aie::sub(aie::load_v<16>(row + j), m[i]);
+        aie::accum<accfloat, 16> expAcc = getExpBf16(toBf16(x));
+        aie::vector<bfloat16, 16> expVec = expAcc.to_vector<bfloat16>();
+        aie::store_v(pRow + j, expVec);
+        sumAcc = aie::add(sumAcc, expVec);
+      }
+    l[i] = l[i] * corr[i] + aie::reduce_add(sumAcc.to_vector<float>());
+  }
+}
+
+// O = O * corr + P * V, with O in r x t blocks.
+static void accumulate(const bfloat16 *__restrict p,
+                       const bfloat16 *__restrict v, float *__restrict o,
+                       const float *__restrict corr) {
+  static_assert(r == 4, "a block of P is read from 4 rows");
+  for (unsigned bi = 0; bi < Br / r; bi++) {
+    const aie::vector<float, MMUL::size_C> factors = rowFactors(corr, bi);
+    for (unsigned bj = 0; bj < D / t; bj++)
+      chess_prepare_for_pipelining chess_loop_range(1, ) {
+        float *__restrict pO = o + (bi * (D / t) + bj) * MMUL::size_C;
+        MMUL acc(aie::mul(aie::load_v<MMUL::size_C>(pO), factors)
+                     .to_vector<float>());
+        for (unsigned bk = 0; bk < Bc / s; bk++)
+          chess_flatten_loop {
+            const bfloat16 *__restrict pP = p + bi * r * Bc + bk * s;
+            aie::vector<bfloat16, MMUL::size_A> A = aie::concat(
+                aie::load_v<s>(pP), aie::load_v<s>(pP + Bc),
+                aie::load_v<s>(pP + 2 * Bc), aie::load_v<s>(pP + 3 * Bc));
+            acc.mac(A, aie::load_v<MMUL::size_B>(
+                           v + (bk * (D / t) + bj) * MMUL::size_B));
+          }
+        aie::store_v(pO, acc.to_vector<float>());
+      }
+  }
+}
+
+extern "C" {
+
+// o: the Br x D output accumulated in float, in r x t blocks.
+// stats: the running max m, the running sum l and the correction of the Br
+// rows, one after the other.
+void attn_init_bf16(float *__restrict o, float *__restrict stats) {
+  const aie::vector<float, 16> zeros = aie::zeros<float, 16>();
+  for (unsigned i = 0; i < Br * D; i += 16)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      aie::store_v(o + i, zeros);
+    }
+  for (unsigned i = 0; i < Br; i += 16) {
+    aie::store_v(stats + i, aie::broadcast<float, 16>(MIN_MAX));
+    aie::store_v(stats + Br + i, zeros);
+  }
+}
+
+// kv: the D x Bc tile of K^T followed by the Bc x D tile of V.
+// sc, p: scratch buffers of Br x Bc floats and bfloat16s.
+void attn_step_bf16(const bfloat16 *__restrict q,
+                    const bfloat16 *__restrict kv, float *__restrict o,
+                    float *__restrict stats, float *__restrict sc,
+                    bfloat16 *__restrict p) {
+  event0();
+  scores(q, kv, sc);
+  onlineSoftmax(sc, p, stats);
+  accumulate(p, kv + D * Bc, o, stats + 2 * Br);
+  event1();
+}
+
+// out: the Br x D output in bfloat16, in r x t blocks.
+void attn_finish_bf16(const float *__restrict o, const float *__restrict stats,
+                      bfloat16 *__restrict out) {
+  const float *__restrict l = stats + Br;
+  float invL[Br];
+  for (unsigned i = 0; i < Br; i++)
+    invL[i] = getInvBf16(l[i]);
+  for (unsigned bi = 0; bi < Br / r; bi++) {
+    const aie::vector<float, MMUL::size_C> factors = rowFactors(invL, bi);
+    for (unsigned bj = 0; bj < D / t; bj++)
+      chess_prepare_for_pipelining chess_loop_range(1, ) {
+        unsigned offset = (bi * (D / t) + bj) * MMUL::size_C;
+        aie::store_v(out + offset,
+                     aie::mul(aie::load_v<MMUL::size_C>(o + offset), factors)
+                         .to_vector<bfloat16>());
+      }
+  }
+}
+
+} // extern "C"
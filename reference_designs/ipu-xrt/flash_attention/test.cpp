@@ -0,0 +1,218 @@
+//===- test.cpp -------------------------------------------000---*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include <boost/program_options.hpp>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdfloat>
+#include <string>
+#include <vector>
+
+#include "ipu_host.h"
+
+// The sizes generated by aie2.py, passed by the Makefile and CMakeLists.txt;
+// the defaults match those of aie2.py.
+#ifndef ATTN_SEQ_LEN
+#define ATTN_SEQ_LEN 256
+#endif
+#ifndef ATTN_HEADS
+#define ATTN_HEADS 4
+#endif
+
+constexpr int S = ATTN_SEQ_LEN;
+constexpr int H = ATTN_HEADS;
+// Keep in sync with attention.cc.
+constexpr int D = 64;
+constexpr int Bc = 64;
+
+using DATATYPE = std::bfloat16_t;
+
+constexpr int HEAD_VOLUME = S * D;
+constexpr int QO_SIZE = H * HEAD_VOLUME * sizeof(DATATYPE);
+constexpr int KV_SIZE = 2 * H * HEAD_VOLUME * sizeof(DATATYPE);
+
+namespace po = boost::program_options;
+
+void check_arg_file_exists(po::variables_map &vm_in, std::string name) {
+  if (!vm_in.count(name)) {
+    throw std::runtime_error("Error: no " + name + " file was provided\n");
+  } else {
+    std::ifstream test(vm_in[name].as<std::string>());
+    if (!test) {
+      throw std::runtime_error("The " + name + " file " +
+                               vm_in[name].as<std::string>() +
+                               " does not exist.\n");
+    }
+  }
+}
+
+// Pack the K and V of each head as aie2.py streams them, by tiles of Bc keys:
+// the D x Bc tile of K^T, then the Bc x D tile of V.
+void pack_kv(const std::vector<DATATYPE> &k, const std::vector<DATATYPE> &v,
+             DATATYPE *kv) {
+  for (int h = 0; h < H; h++) {
+    const DATATYPE *kHead = k.data() + h * HEAD_VOLUME;
+    const DATATYPE *vHead = v.data() + h * HEAD_VOLUME;
+    DATATYPE *kvHead = kv + 2 * h * HEAD_VOLUME;
+    for (int j = 0; j < S / Bc; j++) {
+      DATATYPE *kt = kvHead + 2 * j * Bc * D;
+      DATATYPE *vt = kt + Bc * D;
+      for (int c = 0; c < Bc; c++)
+        for (int d = 0; d < D; d++) {
+          kt[d * Bc + c] = kHead[(j * Bc + c) * D + d];
+          vt[c * D + d] = vHead[(j * Bc + c) * D + d];
+        }
+    }
+  }
+}
+
+// softmax(Q * K^T / sqrt(D)) * V for each head, in float.
+void attention(const std::vector<DATATYPE> &q, const std::vector<DATATYPE> &k,
+               const std::vector<DATATYPE> &v, std::vector<float> &o) {
+  const float scale = 1.0f / std::sqrt(float(D));
+  std::vector<float> scores(S);
+  for (int h = 0; h < H; h++) {
+    int head = h * HEAD_VOLUME;
+    for (int i = 0; i < S; i++) {
+      float max = -INFINITY;
+      for (int j = 0; j < S; j++) {
+        float dot = 0;
+        for (int d = 0; d < D; d++)
+          dot += float(q[head + i * D + d]) * float(k[head + j * D + d]);
+        scores[j] = dot * scale;
+        max = std::max(max, scores[j]);
+      }
+      float sum = 0;
+      for (int j = 0; j < S; j++) {
+        scores[j] = std::exp(scores[j] - max);
+        sum += scores[j];
+      }
+      for (int d = 0; d < D; d++) {
+        float acc = 0;
+        for (int j = 0; j < S; j++)
+          acc += scores[j] * float(v[head + j * D + d]);
+        o[head + i * D + d] = acc / sum;
+      }
+    }
+  }
+}
+
+int main(int argc, const char *argv[]) {
+
+  // Program arguments parsing
+  po::options_description desc("Allowed options");
+  desc.add_options()("help,h", "produce help message")(
+      "xclbin,x", po::value<std::string>()->required(),
+      "the input xclbin path")(
+      "kernel,k", po::value<std::string>()->required(),
+      "the kernel name in the XCLBIN (for instance PP_PRE_FD)")(
+      "verbosity,v", po::value<int>()->default_value(0),
+      "the verbosity of the output")(
+      "warmup", po::value<int>()->default_value(0),
+      "the number of untimed runs before the benchmark")(
+      "iters", po::value<int>()->default_value(0),
+      "the number of timed runs of the benchmark, 0 to skip it")(
+      "instr,i", po::value<std::string>()->required(),
+      "path of file containing userspace instructions to be sent to the LX6");
+  po::variables_map vm;
+
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+      std::cout << desc << "\n";
+      return 1;
+    }
+  } catch (const std::exception &ex) {
+    std::cerr << ex.what() << "\n\n";
+    std::cerr << "Usage:\n" << desc << "\n";
+    return 1;
+  }
+
+  check_arg_file_exists(vm, "xclbin");
+  check_arg_file_exists(vm, "instr");
+
+  std::vector<uint32_t> instr_v =
+      ipu_host::load_instr_sequence(vm["instr"].as<std::string>());
+
+  int verbosity = vm["verbosity"].as<int>();
+  if (verbosity >= 1)
+    std::cout << "Sequence instr count: " << instr_v.size() << "\n";
+
+  ipu_host::kernel kernel(vm["xclbin"].as<std::string>(),
+                          vm["kernel"].as<std::string>(), instr_v);
+
+  auto bo_q = kernel.allocate(QO_SIZE, 0);
+  auto bo_kv = kernel.allocate(KV_SIZE, 1);
+  auto bo_o = kernel.allocate(QO_SIZE, 2);
+
+  if (verbosity >= 1)
+    std::cout << "Writing data into buffer objects.\n";
+  std::default_random_engine gen;
+  std::uniform_real_distribution<float> distribution(-1.0, 1.0);
+  std::vector<DATATYPE> QVec, KVec, VVec;
+  for (int i = 0; i < H * HEAD_VOLUME; i++) {
+    QVec.push_back(DATATYPE(distribution(gen)));
+    KVec.push_back(DATATYPE(distribution(gen)));
+    VVec.push_back(DATATYPE(distribution(gen)));
+  }
+  std::copy(QVec.begin(), QVec.end(), bo_q.map<DATATYPE *>());
+  pack_kv(KVec, VVec, bo_kv.map<DATATYPE *>());
+
+  if (verbosity >= 1)
+    std::cout << "Running Kernel.\n";
+  if (kernel.call({bo_q, bo_kv, bo_o}) != ERT_CMD_STATE_COMPLETED) {
+    std::cout << "Kernel failed.\n";
+    return 1;
+  }
+
+  std::vector<float> ref(H * HEAD_VOLUME);
+  attention(QVec, KVec, VVec, ref);
+
+  DATATYPE *bufOut = bo_o.map<DATATYPE *>();
+  int errors = 0;
+  int max_errors = 100;
+  // The scores, P and the output are rounded to bfloat16 on the cores.
+  const float absTol = 0.05;
+  for (int i = 0; i < H * HEAD_VOLUME; i++) {
+    if (std::abs(float(bufOut[i]) - ref[i]) > absTol) {
+      errors++;
+      if (errors < max_errors) {
+        std::cout << "\nerror, id " << i << " expected "
+                  << std::to_string(ref[i]) << ", got "
+                  << std::to_string(float(bufOut[i])) << "\n";
+      }
+    }
+  }
+
+  // Each timed run includes the syncs of the inputs and of the output. The
+  // operations are the multiply-adds of Q * K^T and of P * V.
+  int iters = vm["iters"].as<int>();
+  if (iters > 0) {
+    ipu_host::benchmark_result result = ipu_host::benchmark(
+        kernel, {bo_q, bo_kv, bo_o}, vm["warmup"].as<int>(), iters);
+    ipu_host::print_benchmark_json(std::cout, "flash_attention", result,
+                                   4.0 * H * S * S * D,
+                                   2.0 * QO_SIZE + KV_SIZE);
+  }
+
+  if (!errors) {
+    std::cout << "\nPASS!\n\n";
+    return 0;
+  } else {
+    std::cout << "\nerror count: " << errors << "\n\n";
+    std::cout << "\nfailed.\n\n";
+    return 1;
+  }
+}
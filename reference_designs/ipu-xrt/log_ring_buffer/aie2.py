@@ -0,0 +1,99 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 AMD Inc.
+
+# A core adds one to ITERS elements of N int32s, logging through the
+# IPURingLogger of ipuringlog.h into the slots of the "log" objectFifo. The
+# DMA of the tile drains each slot to the host while the core fills the next.
+
+import sys
+
+from aie.dialects.aie import *
+from aie.dialects.aiex import *
+from aie.dialects.scf import *
+from aie.extras.context import mlir_mod_ctx
+
+# Keep in sync with kernel.cc and test.cpp.
+N = 256
+ITERS = 8
+LOG_SLOT_WORDS = 64
+# The slots of the ring in the memory of the tile.
+LOG_DEPTH = 2
+
+
+def log_ring_buffer():
+    with mlir_mod_ctx() as ctx:
+
+        @device(AIEDevice.ipu)
+        def device_body():
+            memRef_ty = T.memref(N, T.i32())
+            ofifo_memRef_ty = TypeAttr.get(ObjectFifoType.get(memRef_ty))
+            log_ty = T.memref(LOG_SLOT_WORDS, T.i32())
+            ofifo_log_ty = TypeAttr.get(ObjectFifoType.get(log_ty))
+
+            # AIE Core Function declarations
+            add_one_logged = external_func(
+                "add_one_logged", inputs=[memRef_ty, memRef_ty, log_ty]
+            )
+
+            # Tile declarations
+            ShimTile = tile(0, 0)
+            ComputeTile2 = tile(0, 2)
+
+            # AIE-array data movement with object fifos
+            objectfifo("in", ShimTile, [ComputeTile2], 2, ofifo_memRef_ty, [], [])
+            objectfifo("out", ComputeTile2, [ShimTile], 2, ofifo_memRef_ty, [], [])
+            objectfifo("log", ComputeTile2, [ShimTile], LOG_DEPTH, ofifo_log_ty, [], [])
+
+            # Set up compute tiles
+
+            # Compute tile 2
+            @core(ComputeTile2, "kernel.o")
+            def core_body():
+                # Effective while(1)
+                for _ in for_(sys.maxsize):
+                    for _ in for_(ITERS):
+                        elem_out = acquire(
+                            ObjectFifoPort.Produce, "out", 1, memRef_ty
+                        ).acquired_elem()
+                        elem_in = acquire(
+                            ObjectFifoPort.Consume, "in", 1, memRef_ty
+                        ).acquired_elem()
+                        elem_log = acquire(
+                            ObjectFifoPort.Produce, "log", 1, log_ty
+                        ).acquired_elem()
+                        Call(add_one_logged, [elem_in, elem_out, elem_log])
+                        objectfifo_release(ObjectFifoPort.Consume, "in", 1)
+                        objectfifo_release(ObjectFifoPort.Produce, "out", 1)
+                        objectfifo_release(ObjectFifoPort.Produce, "log", 1)
+                        yield_([])
+                    yield_([])
+
+            # To/from AIE-array data movement
+            tensor_ty = T.memref(N * ITERS, T.i32())
+            log_ring_ty = T.memref(LOG_SLOT_WORDS * ITERS, T.i32())
+
+            @FuncOp.from_py_func(tensor_ty, tensor_ty, log_ring_ty)
+            def sequence(A, C, L):
+                ipu_dma_memcpy_nd(
+                    metadata="out", bd_id=0, mem=C, sizes=[1, 1, 1, N * ITERS]
+                )
+                ipu_dma_memcpy_nd(
+                    metadata="in", bd_id=1, mem=A, sizes=[1, 1, 1, N * ITERS]
+                )
+                ipu_dma_memcpy_nd(
+                    metadata="log",
+                    bd_id=2,
+                    mem=L,
+                    sizes=[1, 1, 1, LOG_SLOT_WORDS * ITERS],
+                )
+                ipu_sync(column=0, row=0, direction=0, channel=0)
+                ipu_sync(column=0, row=0, direction=0, channel=1)
+
+    print(ctx.module)
+
+
+log_ring_buffer()
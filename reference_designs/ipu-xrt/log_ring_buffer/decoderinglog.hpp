@@ -0,0 +1,142 @@
+//===- decoderinglog.hpp ----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Host decoder of the log rings written by ipuringlog.h, rendering the
+// messages from the format strings extracted by elfStringParser.py.
+
+#ifndef DECODE_RING_LOG_HPP
+#define DECODE_RING_LOG_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// The words of the header of a slot, see ipuringlog.h.
+constexpr size_t RING_LOG_HEADER_WORDS = 2;
+
+class IPURingLogDecoder {
+private:
+  std::map<uint32_t, std::string> _str_map;
+  uint64_t _dropped = 0;
+
+  // Each line is the address of a format string, a comma and the string,
+  // which may itself contain commas.
+  void parse_str_map(const std::string &elfstrings_file) {
+    std::ifstream file(elfstrings_file);
+    if (!file.is_open())
+      throw std::runtime_error("unable to open the elfstrings file " +
+                               elfstrings_file);
+    std::string line;
+    while (std::getline(file, line)) {
+      size_t comma = line.find(',');
+      if (comma == std::string::npos)
+        continue;
+      uint32_t address;
+      if (!(std::istringstream(line.substr(0, comma)) >> address))
+        continue;
+      _str_map[address & 0xFFFFFF] = line.substr(comma + 1);
+    }
+  }
+
+  static std::string render(const std::string &frmt, const uint32_t *args,
+                            uint32_t nargs) {
+    std::string out;
+    uint32_t arg = 0;
+    for (std::string::size_type i = 0; i < frmt.size(); ++i) {
+      if (frmt[i] != '%' || i + 1 == frmt.size()) {
+        out += frmt[i];
+        continue;
+      }
+      char conv = frmt[++i];
+      if (conv == '%') {
+        out += '%';
+        continue;
+      }
+      if (arg == nargs) {
+        out += "<missing>";
+        continue;
+      }
+      uint32_t word = args[arg++];
+      switch (conv) {
+      case 'd':
+        out += std::to_string((int32_t)word);
+        break;
+      case 'u':
+        out += std::to_string(word);
+        break;
+      case 'x': {
+        std::stringstream stream;
+        stream << std::hex << word;
+        out += stream.str();
+        break;
+      }
+      case 'f': {
+        float f;
+        std::memcpy(&f, &word, sizeof(f));
+        out += std::to_string(f);
+        break;
+      }
+      default:
+        out += '%';
+        out += conv;
+      }
+    }
+    return out;
+  }
+
+public:
+  IPURingLogDecoder(const std::string &elfstrings_file) {
+    parse_str_map(elfstrings_file);
+  }
+
+  // Decode the messages of the slots of the ring, of slotWords words each, in
+  // the order the core wrote them. Messages with an unknown format string are
+  // rendered with their address.
+  std::vector<std::string> decode(const uint32_t *ring, size_t slots,
+                                  size_t slotWords) {
+    std::vector<std::string> log;
+    for (size_t s = 0; s < slots; ++s) {
+      const uint32_t *slot = ring + s * slotWords;
+      size_t used = slot[0];
+      _dropped += slot[1];
+      if (used > slotWords - RING_LOG_HEADER_WORDS)
+        used = slotWords - RING_LOG_HEADER_WORDS;
+      const uint32_t *rec = slot + RING_LOG_HEADER_WORDS;
+      const uint32_t *end = rec + used;
+      while (rec < end) {
+        uint32_t nargs = *rec >> 24;
+        uint32_t address = *rec & 0xFFFFFF;
+        ++rec;
+        if (nargs > (uint32_t)(end - rec))
+          nargs = end - rec;
+        auto it = _str_map.find(address);
+        if (it != _str_map.end()) {
+          log.emplace_back(render(it->second, rec, nargs));
+        } else {
+          std::stringstream stream;
+          stream << "<unknown message 0x" << std::hex << address << ">";
+          log.emplace_back(stream.str());
+        }
+        rec += nargs;
+      }
+    }
+    return log;
+  }
+
+  // The number of messages dropped by the cores in the slots decoded so far.
+  uint64_t dropped() const { return _dropped; }
+};
+
+#endif // DECODE_RING_LOG_HPP
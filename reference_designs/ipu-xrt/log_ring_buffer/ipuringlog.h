@@ -0,0 +1,89 @@
+//===- ipuringlog.h ---------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Binary logging into the slots of a log ring, the elements of an objectFifo
+// from the core to the shim. The core fills a slot while the DMA of the tile
+// drains the previous ones to the host, so logging never waits on the host.
+//
+// Only the address of the format string and the raw 32-bit arguments are
+// written, the format strings staying in the elf, from which
+// elfStringParser.py extracts them for the host decoder. A slot holds:
+//
+//   word 0: the number of words of records that follow the slot header
+//   word 1: the number of messages dropped because the slot was full
+//   records: a header word, with the number of arguments in its top 8 bits
+//            and the address of the format string in the low 24, then one
+//            word per argument
+//
+// The header of the slot is written when the logger goes out of scope, so a
+// message costs a bound check and one store per word.
+
+#ifndef IPU_RING_LOG_H
+#define IPU_RING_LOG_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define IPU_RING_LOG_HEADER_WORDS 2
+
+class IPURingLogger {
+private:
+  uint32_t *_slot;
+  uint32_t *_cur;
+  uint32_t *_end;
+  uint32_t _dropped;
+
+  static uint32_t to_word(float f) {
+    uint32_t w;
+    memcpy(&w, &f, sizeof(w));
+    return w;
+  }
+
+  // Integers and pointers are truncated to 32 bits.
+  template <typename T>
+  static uint32_t to_word(const T &v) {
+    return (uint32_t)v;
+  }
+
+  void store() {}
+
+  template <typename P, typename... Param>
+  void store(const P &p, const Param &...param) {
+    *_cur++ = to_word(p);
+    store(param...);
+  }
+
+public:
+  // words is the size of the slot, header included.
+  IPURingLogger(uint32_t *slot, uint32_t words)
+      : _slot(slot), _cur(slot + IPU_RING_LOG_HEADER_WORDS),
+        _end(slot + words), _dropped(0) {}
+
+  ~IPURingLogger() { flush(); }
+
+  template <typename... Param>
+  void write(const char *fmt, const Param &...param) {
+    const uint32_t nargs = sizeof...(Param);
+    if ((uint32_t)(_end - _cur) < nargs + 1) {
+      _dropped++;
+      return;
+    }
+    *_cur++ = (nargs << 24) | ((uint32_t)(uintptr_t)fmt & 0xFFFFFF);
+    store(param...);
+  }
+
+  // Write the header of the slot, before the element is released to the DMA.
+  void flush() {
+    _slot[0] = _cur - _slot - IPU_RING_LOG_HEADER_WORDS;
+    _slot[1] = _dropped;
+  }
+};
+
+#endif // IPU_RING_LOG_H
@@ -0,0 +1,50 @@
+//===- kernel.cc ------------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#define NOCPP
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <aie_api/aie.hpp>
+
+#include "ipuringlog.h"
+
+// Keep in sync with aie2.py.
+#ifndef N
+#define N 256
+#endif
+#ifndef LOG_SLOT_WORDS
+#define LOG_SLOT_WORDS 64
+#endif
+
+extern "C" {
+
+// Adds one to each of the N int32s of the element, logging a sample of them
+// from the inner loop.
+void add_one_logged(int32_t *in, int32_t *out, uint32_t *log_slot) {
+  static uint32_t iteration = 0;
+  IPURingLogger log(log_slot, LOG_SLOT_WORDS);
+
+  aie::tile tile = aie::tile::current();
+  uint64_t start = tile.cycles();
+  log.write("iteration %u: start", iteration);
+
+  for (int i = 0; i < N; i++) {
+    out[i] = in[i] + 1;
+    if ((i & 63) == 0)
+      log.write("iteration %u: in[%u]=%d", iteration, i, in[i]);
+  }
+
+  log.write("iteration %u: done in %u cycles", iteration,
+            (uint32_t)(tile.cycles() - start));
+  iteration++;
+}
+}
@@ -0,0 +1,126 @@
+//===- test.cpp -------------------------------------------000---*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include <boost/program_options.hpp>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "decoderinglog.hpp"
+#include "ipu_host.h"
+
+// Keep in sync with aie2.py.
+constexpr int N = 256;
+constexpr int ITERS = 8;
+constexpr int LOG_SLOT_WORDS = 64;
+
+namespace po = boost::program_options;
+
+void check_arg_file_exists(po::variables_map &vm_in, std::string name) {
+  if (!vm_in.count(name)) {
+    throw std::runtime_error("Error: no " + name + " file was provided\n");
+  } else {
+    std::ifstream test(vm_in[name].as<std::string>());
+    if (!test) {
+      throw std::runtime_error("The " + name + " file " +
+                               vm_in[name].as<std::string>() +
+                               " does not exist.\n");
+    }
+  }
+}
+
+int main(int argc, const char *argv[]) {
+
+  // Program arguments parsing
+  po::options_description desc("Allowed options");
+  desc.add_options()("help,h", "produce help message")(
+      "xclbin,x", po::value<std::string>()->required(),
+      "the input xclbin path")(
+      "kernel,k", po::value<std::string>()->required(),
+      "the kernel name in the XCLBIN (for instance PP_PRE_FD)")(
+      "verbosity,v", po::value<int>()->default_value(0),
+      "the verbosity of the output")(
+      "elfstrings,e", po::value<std::string>()->required(),
+      "CSV file of format strings and addresses")(
+      "instr,i", po::value<std::string>()->required(),
+      "path of file containing userspace instructions to be sent to the LX6");
+  po::variables_map vm;
+
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+      std::cout << desc << "\n";
+      return 1;
+    }
+  } catch (const std::exception &ex) {
+    std::cerr << ex.what() << "\n\n";
+    std::cerr << "Usage:\n" << desc << "\n";
+    return 1;
+  }
+
+  check_arg_file_exists(vm, "xclbin");
+  check_arg_file_exists(vm, "instr");
+  check_arg_file_exists(vm, "elfstrings");
+
+  std::vector<uint32_t> instr_v =
+      ipu_host::load_instr_sequence(vm["instr"].as<std::string>());
+
+  int verbosity = vm["verbosity"].as<int>();
+  if (verbosity >= 1)
+    std::cout << "Sequence instr count: " << instr_v.size() << "\n";
+
+  ipu_host::kernel kernel(vm["xclbin"].as<std::string>(),
+                          vm["kernel"].as<std::string>(), instr_v);
+
+  auto bo_in = kernel.allocate(N * ITERS * sizeof(int32_t), 0);
+  auto bo_out = kernel.allocate(N * ITERS * sizeof(int32_t), 1);
+  auto bo_log = kernel.allocate(LOG_SLOT_WORDS * ITERS * sizeof(uint32_t), 2);
+
+  int32_t *bufIn = bo_in.map<int32_t *>();
+  for (int i = 0; i < N * ITERS; i++)
+    bufIn[i] = i + 1;
+
+  if (verbosity >= 1)
+    std::cout << "Running Kernel.\n";
+  if (kernel.call({bo_in, bo_out, bo_log}) != ERT_CMD_STATE_COMPLETED) {
+    std::cout << "Kernel failed.\n";
+    return 1;
+  }
+
+  IPURingLogDecoder decoder(vm["elfstrings"].as<std::string>());
+  for (const std::string &str :
+       decoder.decode(bo_log.map<uint32_t *>(), ITERS, LOG_SLOT_WORDS))
+    std::cout << str << "\n";
+  if (decoder.dropped())
+    std::cout << "Dropped messages: " << decoder.dropped() << "\n";
+
+  int32_t *bufOut = bo_out.map<int32_t *>();
+  int errors = 0;
+  for (int i = 0; i < N * ITERS; i++) {
+    if (bufOut[i] != bufIn[i] + 1) {
+      if (verbosity >= 1)
+        std::cout << "Error in output " << bufOut[i] << " != " << bufIn[i] + 1
+                  << "\n";
+      errors++;
+    }
+  }
+
+  if (!errors) {
+    std::cout << "\nPASS!\n\n";
+    return 0;
+  } else {
+    std::cout << "\nfailed.\n\n";
+    return 1;
+  }
+}
@@ -0,0 +1,83 @@
+//===- mm.cc ----------------------------------------------000---*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The C entry points of the kernels of mm.h, for the m x k x n submatrices
+// given by DIM_M, DIM_K and DIM_N at compile time, 64x64x64 by default:
+//
+//   matmul_<in>_<out>, matmul_scalar_<in>_<out>: C += A * B
+//   matmul_sparse_i8_i32:                        C += A * B, B packed 2:4
+//   zero_<out>, zero_scalar_<out>:               C = 0
+
+#define __AIENGINE__ 2
+#define NOCPP
+#define __AIEARCH__ 20
+
+#define REL_WRITE 0
+#define REL_READ 1
+
+#include "mm.h"
+
+#ifndef DIM_M
+#define DIM_M 64
+#endif
+#ifndef DIM_K
+#define DIM_K 64
+#endif
+#ifndef DIM_N
+#define DIM_N 64
+#endif
+
+extern "C" {
+
+#define combos(X)                                                              \
+  X(int8, i8, int32, i32)                                                      \
+  X(int16, i16, int16, i16)                                                    \
+  X(int16, i16, int32, i32)                                                    \
+  X(bfloat16, bf16, bfloat16, bf16)                                            \
+  X(bfloat16, bf16, float, f32)
+
+#define zero_combos(X)                                                         \
+  X(int16, i16)                                                                \
+  X(int32, i32)                                                                \
+  X(bfloat16, bf16)                                                            \
+  X(float, f32)
+
+#define matmul_vectorized_c_func(ctype_in, mlir_type_in, ctype_out,            \
+                                 mlir_type_out)                                \
+  void matmul_##mlir_type_in##_##mlir_type_out(ctype_in *a_in, ctype_in *b_in, \
+                                               ctype_out *c_out) {             \
+    matmul_tiled<ctype_in, ctype_out, DIM_M, DIM_K, DIM_N>(a_in, b_in, c_out); \
+  }
+
+#define matmul_scalar_c_func(ctype_in, mlir_type_in, ctype_out, mlir_type_out) \
+  void matmul_scalar_##mlir_type_in##_##mlir_type_out(                         \
+      ctype_in *a_in, ctype_in *b_in, ctype_out *c_out) {                      \
+    matmul_scalar<ctype_in, ctype_out, DIM_M, DIM_K, DIM_N>(a_in, b_in,        \
+                                                            c_out);            \
+  }
+
+#define zero_vectorized_c_func(ctype_out, mlir_type_out)                       \
+  void zero_##mlir_type_out(ctype_out *c_out) {                                \
+    zero_vectorized<ctype_out, DIM_M, DIM_N, 32>(c_out);                       \
+  }
+
+#define zero_scalar_c_func(ctype_out, mlir_type_out)                           \
+  void zero_scalar_##mlir_type_out(ctype_out *c_out) {                         \
+    zero_scalar<ctype_out, DIM_M, DIM_N>(c_out);                               \
+  }
+
+combos(matmul_vectorized_c_func) combos(matmul_scalar_c_func)
+    zero_combos(zero_vectorized_c_func) zero_combos(zero_scalar_c_func)
+
+void matmul_sparse_i8_i32(int8 *a_in, int8 *b_in, int32 *c_out) {
+  matmul_sparse_tiled<DIM_M, DIM_K, DIM_N>(a_in, b_in, c_out);
+}
+
+} // extern "C"
@@ -0,0 +1,266 @@
+//===- mm.h -----------------------------------------------000---*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Matrix multiplication microkernels for AIE2, computing C += A * B on an
+// m x k submatrix of A and a k x n submatrix of B. The vectorized kernels are
+// built on aie::mmul, with the shape of the mmul instruction and the
+// accumulator selected for each pair of input and output types; m, k and n
+// are template parameters, so that the design generator picks the tile
+// shapes.
+
+#ifndef MATMUL_KERNELS_MM_H
+#define MATMUL_KERNELS_MM_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <type_traits>
+
+#include <aie_api/aie.hpp>
+
+// The accumulator of the products for an output type: 32-bit integer for the
+// integer types, float for the floating point ones.
+template <typename T_out> struct mmul_acc {
+  using type = acc32;
+};
+template <> struct mmul_acc<float> {
+  using type = accfloat;
+};
+template <> struct mmul_acc<bfloat16> {
+  using type = accfloat;
+};
+
+// The r x s x t shape of the mmul instruction for each pair of input and
+// output types, chosen for the highest number of MACs per cycle of AIE2.
+template <typename T_in, typename T_out> struct mmul_shape;
+template <> struct mmul_shape<int8, int32> {
+  static constexpr unsigned r = 4, s = 8, t = 8;
+};
+template <> struct mmul_shape<int16, int16> {
+  static constexpr unsigned r = 4, s = 4, t = 4;
+};
+template <> struct mmul_shape<int16, int32> {
+  static constexpr unsigned r = 4, s = 4, t = 4;
+};
+template <> struct mmul_shape<bfloat16, bfloat16> {
+  static constexpr unsigned r = 4, s = 8, t = 4;
+};
+template <> struct mmul_shape<bfloat16, float> {
+  static constexpr unsigned r = 4, s = 8, t = 4;
+};
+
+template <typename T, int M, int N>
+void zero_scalar(T *__restrict c) {
+  for (int i = 0; i < M * N; i++) {
+    c[i] = 0;
+  }
+}
+
+template <typename T, int M, int N, int r>
+void zero_vectorized(T *__restrict c) {
+  const aie::vector<T, r> zeros = aie::zeros<T, r>();
+  const T *__restrict c_end = c + M * N;
+  for (; c + r < c_end; c += r) {
+    aie::store_v(c, zeros);
+  }
+  // Do a scalar write for any remainder not divisible by vector instruction
+  // size r
+  for (; c < c_end; c++) {
+    *c = 0;
+  }
+}
+
+template <typename T_in, typename T_out, int M, int K, int N>
+void matmul_scalar(T_in *a, T_in *b, T_out *c) {
+  event0();
+  for (int row = 0; row < M; row++) {
+    for (int col = 0; col < N; col++) {
+      T_out running_sum = 0;
+      for (int i = 0; i < K; i++) {
+        running_sum += a[row * K + i] * b[i * N + col];
+      }
+      c[row * N + col] += running_sum;
+    }
+  }
+  event1();
+}
+
+// C += A * B on rowA x colA blocks of r x s elements of A and colA x colB
+// blocks of s x t elements of B. Each block is laid out contiguously in
+// row-major order, and the blocks themselves are in row-major order: for 4x4
+// blocks, the element in row 1, column 0 is at offset 4 and the element in
+// row 0, column 4 is at offset 16.
+//
+// Each iteration computes 2x2 blocks of C in four accumulators, so that each
+// block of A and B loaded feeds two mmuls. The loop over K is fully unrolled,
+// its trip count colA = k / s being a compile time constant, and the loop over
+// the columns of blocks of C is software pipelined.
+template <typename T_in, typename T_out, unsigned rowA, unsigned colA,
+          unsigned colB, unsigned r, unsigned s, unsigned t>
+void matmul_vectorized(const T_in *__restrict pA, const T_in *__restrict pB,
+                       T_out *__restrict pC) {
+  using MMUL = aie::mmul<r, s, t, T_in, T_in, typename mmul_acc<T_out>::type>;
+  static_assert(rowA % 2 == 0 && colB % 2 == 0,
+                "the kernel computes 2x2 blocks of C at a time");
+
+  event0();
+
+  for (unsigned z = 0; z < rowA; z += 2)
+    chess_loop_range(1, ) {
+      T_out *__restrict pC1 = pC + (z * colB + 0) * MMUL::size_C;
+      T_out *__restrict pC2 = pC + ((z + 1) * colB + 0) * MMUL::size_C;
+
+      for (unsigned j = 0; j < colB; j += 2)
+        chess_prepare_for_pipelining chess_loop_range(1, ) {
+          const T_in *__restrict pA1 = pA + (z * colA + 0) * MMUL::size_A;
+          const T_in *__restrict pA2 = pA + ((z + 1) * colA + 0) * MMUL::size_A;
+          const T_in *__restrict pB1 = pB + (0 * colB + j) * MMUL::size_B;
+          const T_in *__restrict pB2 = pB + (0 * colB + (j + 1)) * MMUL::size_B;
+
+          // Accumulate onto C, since the kernel is called once per k x n
+          // block of B as the input is tiled further at a higher level.
+          MMUL C00(aie::load_v<MMUL::size_C>(pC1));
+          MMUL C01(aie::load_v<MMUL::size_C>(pC1 + MMUL::size_C));
+          MMUL C10(aie::load_v<MMUL::size_C>(pC2));
+          MMUL C11(aie::load_v<MMUL::size_C>(pC2 + MMUL::size_C));
+
+          for (unsigned i = 0; i < colA; ++i)
+            chess_flatten_loop {
+              aie::vector<T_in, MMUL::size_A> A0 =
+                  aie::load_v<MMUL::size_A>(pA1);
+              pA1 += MMUL::size_A;
+              aie::vector<T_in, MMUL::size_A> A1 =
+                  aie::load_v<MMUL::size_A>(pA2);
+              pA2 += MMUL::size_A;
+              aie::vector<T_in, MMUL::size_B> B0 =
+                  aie::load_v<MMUL::size_B>(pB1);
+              pB1 += MMUL::size_B * colB;
+              aie::vector<T_in, MMUL::size_B> B1 =
+                  aie::load_v<MMUL::size_B>(pB2);
+              pB2 += MMUL::size_B * colB;
+
+              C00.mac(A0, B0);
+              C01.mac(A0, B1);
+              C10.mac(A1, B0);
+              C11.mac(A1, B1);
+            }
+
+          aie::store_v(pC1, C00.template to_vector<T_out>());
+          pC1 += MMUL::size_C;
+          aie::store_v(pC1, C01.template to_vector<T_out>());
+          pC1 += MMUL::size_C;
+          aie::store_v(pC2, C10.template to_vector<T_out>());
+          pC2 += MMUL::size_C;
+          aie::store_v(pC2, C11.template to_vector<T_out>());
+          pC2 += MMUL::size_C;
+        }
+    }
+
+  event1();
+}
+
+// C += A * B on an m x k submatrix of A and a k x n submatrix of B, in the
+// blocked layout of matmul_vectorized for the mmul shape of the types.
+template <typename T_in, typename T_out, unsigned m, unsigned k, unsigned n>
+void matmul_tiled(const T_in *__restrict pA, const T_in *__restrict pB,
+                  T_out *__restrict pC) {
+  constexpr unsigned r = mmul_shape<T_in, T_out>::r;
+  constexpr unsigned s = mmul_shape<T_in, T_out>::s;
+  constexpr unsigned t = mmul_shape<T_in, T_out>::t;
+  // At least 2 blocks of A in rows and of B in columns, and submatrices
+  // evenly divisible into blocks.
+  static_assert(m % (2 * r) == 0 && m / (2 * r) > 0);
+  static_assert(k % s == 0 && k / s > 0);
+  static_assert(n % (2 * t) == 0 && n / (2 * t) > 0);
+  return matmul_vectorized<T_in, T_out, m / r, k / s, n / t, r, s, t>(pA, pB,
+                                                                      pC);
+}
+
+// C += A * B with the 2:4 sparse B of the sparse MACs of AIE2, on rowA x colA
+// blocks of 4 x 16 int8 elements of A, laid out like for matmul_vectorized,
+// and colA x colB blocks of 16 x 8 int8 elements of B, packed by
+// aie.sparsity.pack: the 80 bytes of the mask and the kept elements of each
+// block, the blocks of each column of blocks in turn. The kept elements are
+// half of the elements of B, so the sparse MACs compute 4x16x8 products in
+// the cycles of the 4x8x8 ones of the dense kernel.
+template <unsigned rowA, unsigned colA, unsigned colB>
+void matmul_sparse_vectorized(const int8 *__restrict pA,
+                              const int8 *__restrict pB,
+                              int32 *__restrict pC) {
+  using MMUL = aie::mmul<4, 16, 8, int8, int8, acc32>;
+  // The 128-bit mask and the 64 kept elements of a block of B.
+  constexpr unsigned size_B_packed = MMUL::size_B / 8 + MMUL::size_B / 2;
+  static_assert(rowA % 2 == 0 && colB % 2 == 0,
+                "the kernel computes 2x2 blocks of C at a time");
+
+  event0();
+
+  for (unsigned z = 0; z < rowA; z += 2)
+    chess_loop_range(1, ) {
+      int32 *__restrict pC1 = pC + (z * colB + 0) * MMUL::size_C;
+      int32 *__restrict pC2 = pC + ((z + 1) * colB + 0) * MMUL::size_C;
+
+      for (unsigned j = 0; j < colB; j += 2)
+        chess_prepare_for_pipelining chess_loop_range(1, ) {
+          const int8 *__restrict pA1 = pA + (z * colA + 0) * MMUL::size_A;
+          const int8 *__restrict pA2 = pA + ((z + 1) * colA + 0) * MMUL::size_A;
+          aie::sparse_vector_input_buffer_stream<int8, MMUL::size_B> sB1(
+              pB + j * colA * size_B_packed);
+          aie::sparse_vector_input_buffer_stream<int8, MMUL::size_B> sB2(
+              pB + (j + 1) * colA * size_B_packed);
+
+          MMUL C00(aie::load_v<MMUL::size_C>(pC1));
+          MMUL C01(aie::load_v<MMUL::size_C>(pC1 + MMUL::size_C));
+          MMUL C10(aie::load_v<MMUL::size_C>(pC2));
+          MMUL C11(aie::load_v<MMUL::size_C>(pC2 + MMUL::size_C));
+
+          for (unsigned i = 0; i < colA; ++i)
+            chess_flatten_loop {
+              aie::vector<int8, MMUL::size_A> A0 =
+                  aie::load_v<MMUL::size_A>(pA1);
+              pA1 += MMUL::size_A;
+              aie::vector<int8, MMUL::size_A> A1 =
+                  aie::load_v<MMUL::size_A>(pA2);
+              pA2 += MMUL::size_A;
+              aie::sparse_vector<int8, MMUL::size_B> B0 = sB1.pop();
+              aie::sparse_vector<int8, MMUL::size_B> B1 = sB2.pop();
+
+              C00.mac(A0, B0);
+              C01.mac(A0, B1);
+              C10.mac(A1, B0);
+              C11.mac(A1, B1);
+            }
+
+          aie::store_v(pC1, C00.template to_vector<int32>());
+          pC1 += MMUL::size_C;
+          aie::store_v(pC1, C01.template to_vector<int32>());
+          pC1 += MMUL::size_C;
+          aie::store_v(pC2, C10.template to_vector<int32>());
+          pC2 += MMUL::size_C;
+          aie::store_v(pC2, C11.template to_vector<int32>());
+          pC2 += MMUL::size_C;
+        }
+    }
+
+  event1();
+}
+
+// C += A * B on an m x k submatrix of A and a k x n submatrix of B packed for
+// matmul_sparse_vectorized.
+template <unsigned m, unsigned k, unsigned n>
+void matmul_sparse_tiled(const int8 *__restrict pA, const int8 *__restrict pB,
+                         int32 *__restrict pC) {
+  static_assert(m % 8 == 0 && m / 8 > 0);
+  static_assert(k % 16 == 0 && k / 16 > 0);
+  static_assert(n % 16 == 0 && n / 16 > 0);
+  return matmul_sparse_vectorized<m / 4, k / 16, n / 8>(pA, pB, pC);
+}
+
+#endif
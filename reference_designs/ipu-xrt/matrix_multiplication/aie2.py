@@ -5,19 +5,15 @@
 #
 # (c) Copyright 2023 AMD Inc.
 
+import argparse
+
 from aie.dialects.aie import *
 from aie.dialects.aiex import *
 from aie.dialects.scf import *
 from aie.extras.context import mlir_mod_ctx
 
 
-def my_matmul():
-    M = 256
-    K = 256
-    N = 256
-    m = 64
-    k = 32
-    n = 64
+def my_matmul(M, K, N, m, k, n):
     r = 4
     s = 8
     t = 4
@@ -311,4 +307,17 @@ def my_matmul():
     print(ctx.module)
 
 
-my_matmul()
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--M", type=int, default=256)
+    parser.add_argument("--K", type=int, default=256)
+    parser.add_argument("--N", type=int, default=256)
+    parser.add_argument("--m", type=int, default=64, help="the rows of a tile of A")
+    parser.add_argument("--k", type=int, default=32, help="the columns of a tile of A")
+    parser.add_argument("--n", type=int, default=64, help="the columns of a tile of B")
+    args = parser.parse_args()
+    my_matmul(args.M, args.K, args.N, args.m, args.k, args.n)
+
+
+if __name__ == "__main__":
+    main()
@@ -16,13 +16,14 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <sstream>
 #include <stdfloat>
 
 #include "xrt/xrt_bo.h"
 #include "xrt/xrt_device.h"
 #include "xrt/xrt_kernel.h"
 
+#include "ipu_host.h"
+
 constexpr int M = 256;
 constexpr int K = 256;
 constexpr int N = 256;
@@ -60,42 +61,6 @@ void check_arg_file_exists(po::variables_map &vm_in, std::string name) {
   }
 }
 
-std::vector<uint32_t> load_instr_sequence(std::string instr_path) {
-  std::ifstream instr_file(instr_path);
-  std::string line;
-  std::vector<uint32_t> instr_v;
-  while (std::getline(instr_file, line)) {
-    std::istringstream iss(line);
-    uint32_t a;
-    if (!(iss >> std::hex >> a)) {
-      throw std::runtime_error("Unable to parse instruction file\n");
-    }
-    instr_v.push_back(a);
-  }
-  return instr_v;
-}
-
-static inline std::int16_t random_int16_t() {
-  return ((std::int16_t)rand() % 0x10000);
-}
-
-static inline std::bfloat16_t random_bfloat16_t() {
-  return ((std::bfloat16_t)rand() / (std::bfloat16_t)INT_MAX);
-}
-
-template <typename Tin, typename Tout>
-void matmul(std::vector<Tin> a, std::vector<Tin> b, std::vector<Tout> &c) {
-  for (int row = 0; row < M; row++) {
-    for (int col = 0; col < N; col++) {
-      Tout running_sum = 0;
-      for (int i = 0; i < K; i++) {
-        running_sum += Tout(a[row * K + i] * b[i * N + col]);
-      }
-      c[row * N + col] += running_sum;
-    }
-  }
-}
-
 void write_out_trace(char *bufOut, std::string path) {
   std::ofstream fout(path);
   uint32_t *traceOut =
@@ -117,6 +82,10 @@ int main(int argc, const char *argv[]) {
       "the kernel name in the XCLBIN (for instance PP_PRE_FD)")(
       "verbosity,v", po::value<int>()->default_value(0),
       "the verbosity of the output")(
+      "warmup", po::value<int>()->default_value(0),
+      "the number of untimed runs before the benchmark")(
+      "iters", po::value<int>()->default_value(0),
+      "the number of timed runs of the benchmark, 0 to skip it")(
       "instr,i", po::value<std::string>()->required(),
       "path of file containing userspace instructions to be sent to the LX6");
   if (ENABLE_TRACING) {
@@ -144,7 +113,7 @@ int main(int argc, const char *argv[]) {
   check_arg_file_exists(vm, "instr");
 
   std::vector<uint32_t> instr_v =
-      load_instr_sequence(vm["instr"].as<std::string>());
+      ipu_host::load_instr_sequence(vm["instr"].as<std::string>());
 
   int verbosity = vm["verbosity"].as<int>();
   if (verbosity >= 1)
@@ -276,6 +245,22 @@ int main(int argc, const char *argv[]) {
                    .count()
             << "ms." << std::endl;
 
+  // Each timed run includes the syncs of the inputs and of the output.
+  int iters = vm["iters"].as<int>();
+  if (iters > 0) {
+    ipu_host::benchmark_result result = ipu_host::benchmark(
+        [&]() {
+          bo_a.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+          bo_b.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+          auto run = kernel(bo_instr, instr_v.size(), bo_a, bo_b, bo_out);
+          run.wait();
+          bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+        },
+        vm["warmup"].as<int>(), iters);
+    ipu_host::print_benchmark_json(std::cout, "matrix_multiplication", result,
+                                   2.0 * M * K * N, A_SIZE + B_SIZE + C_SIZE);
+  }
+
   if (!errors) {
     std::cout << "\nPASS!\n\n";
     return 0;
@@ -5,46 +5,77 @@
 #
 # (c) Copyright 2023 AMD Inc.
 
+# GEMM generator: C = A * B with A of MxK and B of KxN, on n_rows x n_cols
+# compute tiles. Core (col, row) computes the mxn tiles of C in row `row` modulo
+# n_rows and column `col` modulo n_cols of the tile grid of C. A is
+# distributed by the memtiles of the first columns, each handling
+# n_rows / n_cols rows of cores, and broadcast along the rows of cores; B is
+# broadcast along the columns of cores by the memtile of each column, which
+# also joins the tiles of C of its cores.
+
+import argparse
+
 from aie.extras.context import mlir_mod_ctx
 
 from aie.dialects.aie import *
 from aie.dialects.aiex import *
 from aie.dialects.scf import *
 
+# The columns of the IPU array and the compute tiles in each of them.
+MAX_COLS = 4
+MAX_ROWS = 4
+
+# The (r, s, t) shape of the mmul instruction used by mm.cc for each type.
+MMUL_SHAPES = {"bf16": (4, 8, 4), "i16": (4, 4, 4)}
+
+
+def check_config(M, K, N, m, k, n, n_rows, n_cols):
+    if not 1 <= n_rows <= MAX_ROWS:
+        return f"the number of rows must be between 1 and {MAX_ROWS}"
+    if not 1 <= n_cols <= MAX_COLS:
+        return f"the number of columns must be between 1 and {MAX_COLS}"
+    if n_rows % min(n_rows, n_cols):
+        return "the number of rows must be a multiple of the number of columns"
+    if M % (m * n_rows) or K % k or N % (n * n_cols):
+        return (
+            f"{M}x{K}x{N} is not a multiple of the {m * n_rows}x{k}x{n * n_cols}"
+            " computed by the array at once"
+        )
+    return None
+
 
-def my_matmul():
-    M = 256
-    K = 256
-    N = 256
-    m = 64
-    k = 64
-    n = 64
-    r = 4
-    s = 8
-    t = 4
+def auto_cols(M, K, N, m, k, n, n_rows):
+    # The most columns the problem can be spread over.
+    for n_cols in range(MAX_COLS, 0, -1):
+        if not check_config(M, K, N, m, k, n, n_rows, n_cols):
+            return n_cols
+    return 1
+
+
+def my_matmul(M, K, N, m, k, n, dtype, n_rows, n_cols):
+    r, s, t = MMUL_SHAPES[dtype]
     word_size_in = 2
     word_size_out = 2
 
-    n_rows = 4
-    n_cols = 4
-    n_cores = n_rows * n_cols
-
     A_sz_in_i32s = M * K * word_size_in // 4
     B_sz_in_i32s = K * N * word_size_in // 4
     C_sz_in_bytes = M * N * word_size_out
     C_sz_in_i32s = C_sz_in_bytes // 4
 
-    M_div_m = M // m
     M_div_m_div_n_rows = M // (m * n_rows)
     K_div_k = K // k
-    N_div_n = N // n
-    tiles = M_div_m * N_div_n // n_rows
-    N_div_n_div_n_cols = N_div_n // n_cols
+    N_div_n_div_n_cols = N // (n * n_cols)
+    tiles = M_div_m_div_n_rows * N_div_n_div_n_cols
+
+    # A is sent through the first a_cols columns, each carrying the
+    # submatrices of rows_per_col rows of cores.
+    a_cols = min(n_rows, n_cols)
+    rows_per_col = n_rows // a_cols
 
     # Matrix A: MxK, submatrices a: mxk
     k_in_i32s = k * word_size_in // 4
     K_in_i32s = K * word_size_in // 4
-    m_x_n_rows = m * n_rows
+    m_x_rows_per_col = m * rows_per_col
 
     # Matrix B: KxN, submatrices b: kxn
     n_in_i32s = n * word_size_in // 4
@@ -55,21 +86,21 @@ def my_matmul():
     # Output Matrix C: MxN
     n_in_i32s_out = n * word_size_out // 4
     N_in_i32s_out = N * word_size_out // 4
-    m_x_n_rows_x_N_in_i32s_out = m * n_cores * N_in_i32s_out
+    m_x_n_rows = m * n_rows
+    m_x_n_rows_x_N_in_i32s_out = m * n_rows * N_in_i32s_out
     n_x_n_cols_in_i32s_out = n_in_i32s_out * n_cols
 
-    vectorized = True
-
     with mlir_mod_ctx() as ctx:
 
         @device(AIEDevice.ipu)
         def device_body():
-            memRef_inA_ty = T.memref(m * k * n_rows, T.bf16())
-            memRef_inB_ty = T.memref(k * n * 1, T.bf16())
-            memRef_outC_ty = T.memref(m * n * n_rows, T.bf16())
-            memRef_A_ty = T.memref(m, k, T.bf16())
-            memRef_B_ty = T.memref(k, n, T.bf16())
-            memRef_C_ty = T.memref(m, n, T.bf16())
+            dtype_ty = T.bf16() if dtype == "bf16" else T.i16()
+            memRef_inA_ty = T.memref(m * k * rows_per_col, dtype_ty)
+            memRef_inB_ty = T.memref(k * n * 1, dtype_ty)
+            memRef_outC_ty = T.memref(m * n * n_rows, dtype_ty)
+            memRef_A_ty = T.memref(m, k, dtype_ty)
+            memRef_B_ty = T.memref(k, n, dtype_ty)
+            memRef_C_ty = T.memref(m, n, dtype_ty)
 
             ofifo_memRef_inA_ty = TypeAttr.get(ObjectFifoType.get(memRef_inA_ty))
             ofifo_memRef_inB_ty = TypeAttr.get(ObjectFifoType.get(memRef_inB_ty))
@@ -79,118 +110,75 @@ def my_matmul():
             ofifo_memRef_C_ty = TypeAttr.get(ObjectFifoType.get(memRef_C_ty))
 
             # AIE Core Function declarations
-            zero_scalar = external_func("zero_scalar_bf16", inputs=[memRef_C_ty])
-            zero = external_func("zero_bf16", inputs=[memRef_C_ty])
-            matmul_scalar = external_func(
-                "matmul_scalar_bf16_bf16",
-                inputs=[memRef_A_ty, memRef_B_ty, memRef_C_ty],
-            )
+            zero = external_func(f"zero_{dtype}", inputs=[memRef_C_ty])
             matmul = external_func(
-                "matmul_bf16_bf16", inputs=[memRef_A_ty, memRef_B_ty, memRef_C_ty]
+                f"matmul_{dtype}_{dtype}",
+                inputs=[memRef_A_ty, memRef_B_ty, memRef_C_ty],
             )
 
             # Tile declarations
-            _0_ShimTile = tile(0, 0)
-            _0_MemTile = tile(0, 1)
-            _0_ComputeTile2 = tile(0, 2)
-            _0_ComputeTile3 = tile(0, 3)
-            _0_ComputeTile4 = tile(0, 4)
-            _0_ComputeTile5 = tile(0, 5)
-            _0_cores = [
-                _0_ComputeTile2,
-                _0_ComputeTile3,
-                _0_ComputeTile4,
-                _0_ComputeTile5,
-            ]
-            _1_ShimTile = tile(1, 0)
-            _1_MemTile = tile(1, 1)
-            _1_ComputeTile2 = tile(1, 2)
-            _1_ComputeTile3 = tile(1, 3)
-            _1_ComputeTile4 = tile(1, 4)
-            _1_ComputeTile5 = tile(1, 5)
-            _1_cores = [
-                _1_ComputeTile2,
-                _1_ComputeTile3,
-                _1_ComputeTile4,
-                _1_ComputeTile5,
-            ]
-            _2_ShimTile = tile(2, 0)
-            _2_MemTile = tile(2, 1)
-            _2_ComputeTile2 = tile(2, 2)
-            _2_ComputeTile3 = tile(2, 3)
-            _2_ComputeTile4 = tile(2, 4)
-            _2_ComputeTile5 = tile(2, 5)
-            _2_cores = [
-                _2_ComputeTile2,
-                _2_ComputeTile3,
-                _2_ComputeTile4,
-                _2_ComputeTile5,
-            ]
-            _3_ShimTile = tile(3, 0)
-            _3_MemTile = tile(3, 1)
-            _3_ComputeTile2 = tile(3, 2)
-            _3_ComputeTile3 = tile(3, 3)
-            _3_ComputeTile4 = tile(3, 4)
-            _3_ComputeTile5 = tile(3, 5)
-            _3_cores = [
-                _3_ComputeTile2,
-                _3_ComputeTile3,
-                _3_ComputeTile4,
-                _3_ComputeTile5,
-            ]
-            shims = [_0_ShimTile, _1_ShimTile, _2_ShimTile, _3_ShimTile]
-            mems = [_0_MemTile, _1_MemTile, _2_MemTile, _3_MemTile]
-            cores = [
-                [_0_ComputeTile2, _0_ComputeTile3, _0_ComputeTile4, _0_ComputeTile5],
-                [_1_ComputeTile2, _1_ComputeTile3, _1_ComputeTile4, _1_ComputeTile5],
-                [_2_ComputeTile2, _2_ComputeTile3, _2_ComputeTile4, _2_ComputeTile5],
-                [_3_ComputeTile2, _3_ComputeTile3, _3_ComputeTile4, _3_ComputeTile5],
-            ]
-            t_cores = [
-                [cores[j][i] for j in range(len(cores))] for i in range(len(cores[0]))
+            shims = []
+            mems = []
+            cores = []
+            for col in range(n_cols):
+                shims.append(tile(col, 0))
+                mems.append(tile(col, 1))
+                cores.append([tile(col, 2 + row) for row in range(n_rows)])
+
+            inA_fifos = [f"inA{col}" for col in range(a_cols)]
+            inB_fifos = [f"inB{col}" for col in range(n_cols)]
+            memA_fifos = [f"memA{row}" for row in range(n_rows)]
+            memB_fifos = [f"memB{col}" for col in range(n_cols)]
+            memC_fifos = [
+                [f"memC{row}{col}" for row in range(n_rows)] for col in range(n_cols)
             ]
-            inA_fifos = ["inA0", "inA1", "inA2", "inA3"]
-            inB_fifos = ["inB0", "inB1", "inB2", "inB3"]
-            memA_fifos = ["memA0", "memA1", "memA2", "memA3"]
-            memB_fifos = ["memB0", "memB1", "memB2", "memB3"]
-            _0_outC_fifos = ["memC00", "memC10", "memC20", "memC30"]
-            _1_outC_fifos = ["memC01", "memC11", "memC21", "memC31"]
-            _2_outC_fifos = ["memC02", "memC12", "memC22", "memC32"]
-            _3_outC_fifos = ["memC03", "memC13", "memC23", "memC33"]
-            memC_fifos = [_0_outC_fifos, _1_outC_fifos, _2_outC_fifos, _3_outC_fifos]
-            outC_fifos = ["outC0", "outC1", "outC2", "outC3"]
+            outC_fifos = [f"outC{col}" for col in range(n_cols)]
 
             # AIE-array data movement with object fifos
             # Input A
-            for i in range(n_cols):
+            for col in range(a_cols):
+                rows = range(col * rows_per_col, (col + 1) * rows_per_col)
                 objectfifo(
-                    inA_fifos[i], shims[i], [mems[i]], 2, ofifo_memRef_inA_ty, [], []
-                )
-                objectfifo(
-                    memA_fifos[i],
-                    mems[i],
-                    t_cores[i][0:n_cols],
+                    inA_fifos[col],
+                    shims[col],
+                    [mems[col]],
                     2,
-                    ofifo_memRef_A_ty,
-                    [
-                        (m // r, r * k * word_size_in // 4),
-                        (k // s, s * word_size_in // 4),
-                        (r, k * word_size_in // 4),
-                        (s * word_size_in // 4, 1),
-                    ],
+                    ofifo_memRef_inA_ty,
+                    [],
                     [],
                 )
-                objectfifo_link([inA_fifos[i]], [memA_fifos[i]])
+                for row in rows:
+                    objectfifo(
+                        memA_fifos[row],
+                        mems[col],
+                        [cores[c][row] for c in range(n_cols)],
+                        2,
+                        ofifo_memRef_A_ty,
+                        [
+                            (m // r, r * k * word_size_in // 4),
+                            (k // s, s * word_size_in // 4),
+                            (r, k * word_size_in // 4),
+                            (s * word_size_in // 4, 1),
+                        ],
+                        [],
+                    )
+                objectfifo_link([inA_fifos[col]], [memA_fifos[row] for row in rows])
 
             # Input B
-            for i in range(n_cols):
+            for col in range(n_cols):
                 objectfifo(
-                    inB_fifos[i], shims[i], [mems[i]], 2, ofifo_memRef_inB_ty, [], []
+                    inB_fifos[col],
+                    shims[col],
+                    [mems[col]],
+                    2,
+                    ofifo_memRef_inB_ty,
+                    [],
+                    [],
                 )
                 objectfifo(
-                    memB_fifos[i],
-                    mems[i],
-                    cores[i][0:n_rows],
+                    memB_fifos[col],
+                    mems[col],
+                    cores[col],
                     2,
                     ofifo_memRef_B_ty,
                     [
@@ -201,24 +189,24 @@ def my_matmul():
                     ],
                     [],
                 )
-                objectfifo_link([inB_fifos[i]], [memB_fifos[i]])
+                objectfifo_link([inB_fifos[col]], [memB_fifos[col]])
 
             # Output C
-            for i in range(n_cols):
-                for j in range(n_rows):
+            for col in range(n_cols):
+                for row in range(n_rows):
                     objectfifo(
-                        memC_fifos[i][j],
-                        cores[i][j],
-                        [mems[i]],
+                        memC_fifos[col][row],
+                        cores[col][row],
+                        [mems[col]],
                         2,
                         ofifo_memRef_C_ty,
                         [],
                         [],
                     )
                 objectfifo(
-                    outC_fifos[i],
-                    mems[i],
-                    shims[i],
+                    outC_fifos[col],
+                    mems[col],
+                    shims[col],
                     2,
                     ofifo_memRef_outC_ty,
                     [
@@ -229,19 +217,19 @@ def my_matmul():
                     ],
                     [],
                 )
-                objectfifo_link(memC_fifos[i], [outC_fifos[i]])
+                objectfifo_link(memC_fifos[col], [outC_fifos[col]])
 
             # Set up compute tiles
-            for j in range(n_cols):
-                for i in range(n_rows):
-                    # Compute tile i
-                    @core(cores[j][i], "mm.o")
+            for col in range(n_cols):
+                for row in range(n_rows):
+
+                    @core(cores[col][row], "mm.o")
                     def core_body():
                         for _ in for_(0xFFFFFFFF):
                             for _ in for_(tiles):
                                 elem_out = acquire(
                                     ObjectFifoPort.Produce,
-                                    memC_fifos[j][i],
+                                    memC_fifos[col][row],
                                     1,
                                     memRef_C_ty,
                                 ).acquired_elem()
@@ -250,27 +238,27 @@ def my_matmul():
                                 for _ in for_(K_div_k):
                                     elem_in_a = acquire(
                                         ObjectFifoPort.Consume,
-                                        memA_fifos[i],
+                                        memA_fifos[row],
                                         1,
                                         memRef_A_ty,
                                     ).acquired_elem()
                                     elem_in_b = acquire(
                                         ObjectFifoPort.Consume,
-                                        memB_fifos[j],
+                                        memB_fifos[col],
                                         1,
                                         memRef_B_ty,
                                     ).acquired_elem()
                                     Call(matmul, [elem_in_a, elem_in_b, elem_out])
                                     objectfifo_release(
-                                        ObjectFifoPort.Consume, memA_fifos[i], 1
+                                        ObjectFifoPort.Consume, memA_fifos[row], 1
                                     )
                                     objectfifo_release(
-                                        ObjectFifoPort.Consume, memB_fifos[j], 1
+                                        ObjectFifoPort.Consume, memB_fifos[col], 1
                                     )
                                     yield_([])
 
                                 objectfifo_release(
-                                    ObjectFifoPort.Produce, memC_fifos[j][i], 1
+                                    ObjectFifoPort.Produce, memC_fifos[col][row], 1
                                 )
                                 yield_([])
                             yield_([])
@@ -297,11 +285,11 @@ def my_matmul():
                     C_row_offset = (
                         tile_row_block * rows_per_block * m * n_rows * N * word_size_out
                     )
-                    for i in range(n_cols):
-                        C_col_offset = i * n * word_size_out
+                    for col in range(n_cols):
+                        C_col_offset = col * n * word_size_out
                         C_offset_in_i32s = (C_col_offset + C_row_offset) // 4
                         ipu_dma_memcpy_nd(
-                            metadata=outC_fifos[i],
+                            metadata=outC_fifos[col],
                             bd_id=0,
                             mem=C,
                             offsets=[0, 0, 0, C_offset_in_i32s],
@@ -318,41 +306,91 @@ def my_matmul():
                             ],
                         )
                         for tile_row in range(num_tile_rows):
-                            A_row_offset_in_i32s = (
-                                ((tile_row_block * rows_per_block) + tile_row)
-                                * m
-                                * K
-                                * word_size_in
-                                // 4
-                            )
-                            A_col_offset_in_i32s = i * m * K * word_size_in // 4
-                            B_col_offset_in_i32s = i * n * word_size_in // 4
-                            ipu_dma_memcpy_nd(
-                                metadata=inA_fifos[i],
-                                bd_id=2 * tile_row + 1,
-                                mem=A,
-                                offsets=[
-                                    0,
-                                    0,
-                                    0,
-                                    A_col_offset_in_i32s + A_row_offset_in_i32s,
-                                ],
-                                sizes=[N_div_n_div_n_cols, K_div_k, m, k_in_i32s],
-                                strides=[0, k_in_i32s, K_in_i32s],
-                            )
+                            if col < a_cols:
+                                A_row_offset_in_i32s = (
+                                    ((tile_row_block * rows_per_block) + tile_row)
+                                    * m
+                                    * n_rows
+                                    * K
+                                    * word_size_in
+                                    // 4
+                                )
+                                A_col_offset_in_i32s = (
+                                    col * m_x_rows_per_col * K * word_size_in // 4
+                                )
+                                ipu_dma_memcpy_nd(
+                                    metadata=inA_fifos[col],
+                                    bd_id=2 * tile_row + 1,
+                                    mem=A,
+                                    offsets=[
+                                        0,
+                                        0,
+                                        0,
+                                        A_col_offset_in_i32s + A_row_offset_in_i32s,
+                                    ],
+                                    sizes=[
+                                        N_div_n_div_n_cols,
+                                        K_div_k,
+                                        m_x_rows_per_col,
+                                        k_in_i32s,
+                                    ],
+                                    strides=[0, k_in_i32s, K_in_i32s],
+                                )
+                            B_col_offset_in_i32s = col * n * word_size_in // 4
                             ipu_dma_memcpy_nd(
-                                metadata=inB_fifos[i],
+                                metadata=inB_fifos[col],
                                 bd_id=2 * tile_row + 2,
                                 mem=B,
                                 offsets=[0, 0, 0, B_col_offset_in_i32s],
                                 sizes=[N_div_n_div_n_cols, K_div_k, k, n_in_i32s],
                                 strides=[n_x_n_cols_in_i32s, k_x_N_in_i32s, N_in_i32s],
                             )
-                    for i in range(n_cols):
-                        ipu_sync(column=i, row=0, direction=0, channel=0)
+                    for col in range(n_cols):
+                        ipu_sync(column=col, row=0, direction=0, channel=0)
 
     # print(ctx.module.operation.verify())
     print(ctx.module)
 
 
-my_matmul()
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("-M", type=int, default=256)
+    parser.add_argument("-K", type=int, default=256)
+    parser.add_argument("-N", type=int, default=256)
+    # The size of the submatrices, which ../matmul_kernels/mm.cc is compiled
+    # for with -DDIM_M, -DDIM_K and -DDIM_N.
+    parser.add_argument("-m", type=int, default=64)
+    parser.add_argument("-k", type=int, default=64)
+    parser.add_argument("-n", type=int, default=64)
+    parser.add_argument("--dtype", choices=sorted(MMUL_SHAPES), default="bf16")
+    parser.add_argument("--n-rows", type=int, default=MAX_ROWS)
+    parser.add_argument(
+        "--n-cols",
+        type=int,
+        default=0,
+        help="the number of columns to use, 0 to use as many as the sizes allow",
+    )
+    args = parser.parse_args()
+
+    n_cols = args.n_cols or auto_cols(
+        args.M, args.K, args.N, args.m, args.k, args.n, args.n_rows
+    )
+    error = check_config(
+        args.M, args.K, args.N, args.m, args.k, args.n, args.n_rows, n_cols
+    )
+    if error:
+        parser.error(error)
+    my_matmul(
+        args.M,
+        args.K,
+        args.N,
+        args.m,
+        args.k,
+        args.n,
+        args.dtype,
+        args.n_rows,
+        n_cols,
+    )
+
+
+main()
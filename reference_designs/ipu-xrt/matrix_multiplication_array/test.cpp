@@ -24,17 +24,35 @@
 #include "xrt/xrt_device.h"
 #include "xrt/xrt_kernel.h"
 
-constexpr int M = 256;
-constexpr int K = 256;
-constexpr int N = 256;
+// The sizes and type generated by aie2.py, passed by the Makefile and
+// CMakeLists.txt; the defaults match those of aie2.py.
+#ifndef MATMUL_M
+#define MATMUL_M 256
+#endif
+#ifndef MATMUL_K
+#define MATMUL_K 256
+#endif
+#ifndef MATMUL_N
+#define MATMUL_N 256
+#endif
+
+constexpr int M = MATMUL_M;
+constexpr int K = MATMUL_K;
+constexpr int N = MATMUL_N;
 
 constexpr int A_VOLUME = M * K;
 constexpr int B_VOLUME = N * K;
 constexpr int C_VOLUME = M * N;
 
+#ifdef MATMUL_I16
+using A_DATATYPE = std::int16_t;
+using B_DATATYPE = std::int16_t;
+using C_DATATYPE = std::int16_t;
+#else
 using A_DATATYPE = std::bfloat16_t;
 using B_DATATYPE = std::bfloat16_t;
 using C_DATATYPE = std::bfloat16_t;
+#endif
 
 constexpr int A_SIZE = (A_VOLUME * sizeof(A_DATATYPE));
 constexpr int B_SIZE = (B_VOLUME * sizeof(B_DATATYPE));
@@ -82,6 +100,15 @@ static inline std::bfloat16_t random_bfloat16_t() {
   return std::bfloat16_t(distribution(gen));
 }
 
+static inline A_DATATYPE random_value() {
+#ifdef MATMUL_I16
+  // Small values, so that the sums of K products do not overflow.
+  return std::int16_t(rand() % 4);
+#else
+  return random_bfloat16_t();
+#endif
+}
+
 template <typename Tin, typename Tout>
 void matmul(std::vector<Tin> a, std::vector<Tin> b, std::vector<Tout> &c) {
   for (int row = 0; row < M; row++) {
@@ -189,12 +216,12 @@ int main(int argc, const char *argv[]) {
   A_DATATYPE *bufA = bo_a.map<A_DATATYPE *>();
   std::vector<A_DATATYPE> AVec;
   for (int i = 0; i < A_VOLUME; i++)
-    AVec.push_back(random_bfloat16_t());
+    AVec.push_back(random_value());
   memcpy(bufA, AVec.data(), (AVec.size() * sizeof(A_DATATYPE)));
   B_DATATYPE *bufB = bo_b.map<B_DATATYPE *>();
   std::vector<B_DATATYPE> BVec;
   for (int i = 0; i < B_VOLUME; i++)
-    BVec.push_back(random_bfloat16_t());
+    BVec.push_back(random_value());
   memcpy(bufB, BVec.data(), (BVec.size() * sizeof(B_DATATYPE)));
   C_DATATYPE *bufC = bo_c.map<C_DATATYPE *>();
   std::vector<C_DATATYPE> CVec;
@@ -131,6 +131,20 @@ void matvecVectorized(T_in *__restrict a, T_in *__restrict b,
   event1();
 }
 
+// Add the m partial sums of a to those of c.
+template <typename T, unsigned m, unsigned r>
+void addVectorized(T *__restrict a, T *__restrict c) {
+  static_assert(m % r == 0);
+  event0();
+  for (int i = 0; i < m; i += r)
+    chess_prepare_for_pipelining chess_loop_range(m / r, ) {
+      aie::vector<T, r> sum =
+          aie::add(aie::load_v<r>(a + i), aie::load_v<r>(c + i));
+      aie::store_v(c + i, sum);
+    }
+  event1();
+}
+
 extern "C" {
 
 #define combos(X)                                                              \
@@ -152,6 +166,22 @@ extern "C" {
         a_in, b_in, c_out);                                                    \
   }
 
+// The slice of b used by the kernel starts b_offset elements into b_in, so
+// that the cores of a column can share the broadcast of b.
+#define matvec_vectorized_slice_c_func(ctype_in, mlir_type_in, ctype_out,      \
+                                       mlir_type_out, ctype_acc)               \
+  void matvec_vectorized_slice_##mlir_type_in##_##mlir_type_out(               \
+      ctype_in *a_in, ctype_in *b_in, ctype_out *c_out, int32_t b_offset) {    \
+    matvecVectorized<ctype_in, ctype_out, ctype_acc, 32, 32, 16, 8>(           \
+        a_in, b_in + b_offset, c_out);                                         \
+  }
+
+#define add_vectorized_c_func(ctype_in, mlir_type_in, ctype_out,               \
+                              mlir_type_out, ctype_acc)                        \
+  void add_vectorized_##mlir_type_out(ctype_out *a_in, ctype_out *c_out) {     \
+    addVectorized<ctype_out, 32, 16>(a_in, c_out);                             \
+  }
+
 #define zero_vectorized_c_func(ctype_in, mlir_type_in, ctype_out,              \
                                mlir_type_out, ctype_acc)                       \
   void zero_vectorized_##mlir_type_out(ctype_out *c_out) {                     \
@@ -165,6 +195,7 @@ extern "C" {
   }
 
 combos(matvec_scalar_c_func) combos(matvec_vectorized_c_func)
-    combos(zero_vectorized_c_func) combos(zero_scalar_c_func)
+    combos(matvec_vectorized_slice_c_func) combos(add_vectorized_c_func)
+        combos(zero_vectorized_c_func) combos(zero_scalar_c_func)
 
 } // extern "C"
@@ -0,0 +1,292 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 AMD Inc.
+
+# GEMV generator for memory-bound decode: C = A * B with A of MxK in bf16 and
+# B a vector of K, on n_rows x n_cols compute tiles. Column col computes the
+# M / n_cols rows of C starting at col * M / n_cols. The weights A are
+# streamed through the shim of every column and distributed by its memtile
+# to the cores of the column, which each multiply a different mxk submatrix
+# of every group of n_rows along K. B is broadcast from the same shim to the
+# cores of the column, and the partial sums of C are reduced up the column,
+# each core adding those of the core below it through their shared memory.
+
+import argparse
+
+from aie.extras.context import mlir_mod_ctx
+
+from aie.dialects.aie import *
+from aie.dialects.aiex import *
+from aie.dialects.scf import *
+
+# The columns of the IPU array and the compute tiles in each of them.
+MAX_COLS = 4
+MAX_ROWS = 4
+
+# The size of the submatrices computed by the kernels of mv.cc.
+m = 32
+k = 32
+
+
+def check_config(M, K, n_rows, n_cols):
+    if not 1 <= n_rows <= MAX_ROWS:
+        return f"the number of rows must be between 1 and {MAX_ROWS}"
+    if not 1 <= n_cols <= MAX_COLS:
+        return f"the number of columns must be between 1 and {MAX_COLS}"
+    if M % (m * n_cols) or K % (k * n_rows):
+        return (
+            f"{M}x{K} is not a multiple of the {m * n_cols}x{k * n_rows}"
+            " computed by the array at once"
+        )
+    return None
+
+
+def auto_cols(M, K, n_rows):
+    # The most columns, and so shim channels, the weights can be spread over.
+    for n_cols in range(MAX_COLS, 0, -1):
+        if not check_config(M, K, n_rows, n_cols):
+            return n_cols
+    return 1
+
+
+def my_matvec(M, K, n_rows, n_cols):
+    word_size_in = 2
+    word_size_out = 4
+
+    A_sz_in_i32s = M * K * word_size_in // 4
+    B_sz_in_i32s = K * word_size_in // 4
+    C_sz_in_i32s = M * word_size_out // 4
+
+    # The rows of C computed by each column, in blocks of m rows.
+    M_div_n_cols = M // n_cols
+    blocks = M_div_n_cols // m
+    # The submatrices of a block row multiplied by each core.
+    steps = K // (k * n_rows)
+    K_div_k = K // k
+
+    K_in_i32s = K * word_size_in // 4
+    k_in_i32s = k * word_size_in // 4
+    m_x_K_in_i32s = m * K * word_size_in // 4
+
+    with mlir_mod_ctx() as ctx:
+
+        @device(AIEDevice.ipu)
+        def device_body():
+            memRef_inA_ty = T.memref(m * k * n_rows, T.bf16())
+            memRef_inB_ty = T.memref(k * n_rows, T.bf16())
+            memRef_outC_ty = T.memref(m, T.f32())
+            memRef_A_ty = T.memref(m, k, T.bf16())
+
+            ofifo_memRef_inA_ty = TypeAttr.get(ObjectFifoType.get(memRef_inA_ty))
+            ofifo_memRef_inB_ty = TypeAttr.get(ObjectFifoType.get(memRef_inB_ty))
+            ofifo_memRef_outC_ty = TypeAttr.get(ObjectFifoType.get(memRef_outC_ty))
+            ofifo_memRef_A_ty = TypeAttr.get(ObjectFifoType.get(memRef_A_ty))
+
+            # AIE Core Function declarations
+            zero = external_func("zero_vectorized_f32", inputs=[memRef_outC_ty])
+            matvec = external_func(
+                "matvec_vectorized_slice_bf16_f32",
+                inputs=[memRef_A_ty, memRef_inB_ty, memRef_outC_ty, T.i32()],
+            )
+            add = external_func(
+                "add_vectorized_f32", inputs=[memRef_outC_ty, memRef_outC_ty]
+            )
+
+            # Tile declarations
+            shims = []
+            mems = []
+            cores = []
+            for col in range(n_cols):
+                shims.append(tile(col, 0))
+                mems.append(tile(col, 1))
+                cores.append([tile(col, 2 + row) for row in range(n_rows)])
+
+            inA_fifos = [f"inA{col}" for col in range(n_cols)]
+            inB_fifos = [f"inB{col}" for col in range(n_cols)]
+            memA_fifos = [
+                [f"memA{col}{row}" for row in range(n_rows)] for col in range(n_cols)
+            ]
+            # The partial sums of each core, the last ones of a column being
+            # its output.
+            sum_fifos = [
+                [f"partial{col}{row}" for row in range(n_rows - 1)] + [f"outC{col}"]
+                for col in range(n_cols)
+            ]
+
+            # AIE-array data movement with object fifos
+            for col in range(n_cols):
+                # Input A
+                objectfifo(
+                    inA_fifos[col],
+                    shims[col],
+                    [mems[col]],
+                    2,
+                    ofifo_memRef_inA_ty,
+                    [],
+                    [],
+                )
+                for row in range(n_rows):
+                    objectfifo(
+                        memA_fifos[col][row],
+                        mems[col],
+                        [cores[col][row]],
+                        2,
+                        ofifo_memRef_A_ty,
+                        [
+                            (k_in_i32s, 1),
+                            (m, k_in_i32s),
+                            (1, 1),
+                        ],
+                        [],
+                    )
+                objectfifo_link([inA_fifos[col]], memA_fifos[col])
+
+                # Input B
+                objectfifo(
+                    inB_fifos[col],
+                    shims[col],
+                    cores[col],
+                    2,
+                    ofifo_memRef_inB_ty,
+                    [],
+                    [],
+                )
+
+                # Partial sums and output C
+                for row in range(n_rows):
+                    objectfifo(
+                        sum_fifos[col][row],
+                        cores[col][row],
+                        [cores[col][row + 1] if row + 1 < n_rows else shims[col]],
+                        2,
+                        ofifo_memRef_outC_ty,
+                        [],
+                        [],
+                    )
+
+            # Set up compute tiles
+            for col in range(n_cols):
+                for row in range(n_rows):
+
+                    @core(cores[col][row], "mv.o")
+                    def core_body():
+                        for _ in for_(0xFFFFFFFF):
+                            for _ in for_(blocks):
+                                elem_out = acquire(
+                                    ObjectFifoPort.Produce,
+                                    sum_fifos[col][row],
+                                    1,
+                                    memRef_outC_ty,
+                                ).acquired_elem()
+                                Call(zero, [elem_out])
+
+                                for _ in for_(steps):
+                                    elem_in_a = acquire(
+                                        ObjectFifoPort.Consume,
+                                        memA_fifos[col][row],
+                                        1,
+                                        memRef_A_ty,
+                                    ).acquired_elem()
+                                    elem_in_b = acquire(
+                                        ObjectFifoPort.Consume,
+                                        inB_fifos[col],
+                                        1,
+                                        memRef_inB_ty,
+                                    ).acquired_elem()
+                                    Call(
+                                        matvec,
+                                        [elem_in_a, elem_in_b, elem_out, row * k],
+                                    )
+                                    objectfifo_release(
+                                        ObjectFifoPort.Consume, memA_fifos[col][row], 1
+                                    )
+                                    objectfifo_release(
+                                        ObjectFifoPort.Consume, inB_fifos[col], 1
+                                    )
+                                    yield_([])
+
+                                if row > 0:
+                                    elem_in_sum = acquire(
+                                        ObjectFifoPort.Consume,
+                                        sum_fifos[col][row - 1],
+                                        1,
+                                        memRef_outC_ty,
+                                    ).acquired_elem()
+                                    Call(add, [elem_in_sum, elem_out])
+                                    objectfifo_release(
+                                        ObjectFifoPort.Consume,
+                                        sum_fifos[col][row - 1],
+                                        1,
+                                    )
+
+                                objectfifo_release(
+                                    ObjectFifoPort.Produce, sum_fifos[col][row], 1
+                                )
+                                yield_([])
+                            yield_([])
+
+            # To/from AIE-array data movement
+
+            @FuncOp.from_py_func(
+                T.memref(A_sz_in_i32s, T.i32()),
+                T.memref(B_sz_in_i32s, T.i32()),
+                T.memref(C_sz_in_i32s, T.i32()),
+            )
+            def sequence(A, B, C):
+                for col in range(n_cols):
+                    A_offset = col * M_div_n_cols * K_in_i32s
+                    C_offset = col * M_div_n_cols * word_size_out // 4
+                    ipu_dma_memcpy_nd(
+                        metadata=sum_fifos[col][-1],
+                        bd_id=0,
+                        mem=C,
+                        offsets=[0, 0, 0, C_offset],
+                        sizes=[1, 1, blocks, m * word_size_out // 4],
+                        strides=[0, 0, m * word_size_out // 4],
+                    )
+                    # B is sent again for every block of rows of C.
+                    ipu_dma_memcpy_nd(
+                        metadata=inB_fifos[col],
+                        bd_id=1,
+                        mem=B,
+                        sizes=[blocks, 1, K_div_k, k_in_i32s],
+                        strides=[0, 0, k_in_i32s],
+                    )
+                    ipu_dma_memcpy_nd(
+                        metadata=inA_fifos[col],
+                        bd_id=2,
+                        mem=A,
+                        offsets=[0, 0, 0, A_offset],
+                        sizes=[blocks, K_div_k, m, k_in_i32s],
+                        strides=[m_x_K_in_i32s, k_in_i32s, K_in_i32s],
+                    )
+                for col in range(n_cols):
+                    ipu_sync(column=col, row=0, direction=0, channel=0)
+
+    print(ctx.module)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("-M", type=int, default=2048)
+    parser.add_argument("-K", type=int, default=2048)
+    parser.add_argument("--n-rows", type=int, default=MAX_ROWS)
+    parser.add_argument(
+        "--n-cols",
+        type=int,
+        default=0,
+        help="the number of columns to use, 0 to use as many as the sizes allow",
+    )
+    args = parser.parse_args()
+
+    n_cols = args.n_cols or auto_cols(args.M, args.K, args.n_rows)
+    error = check_config(args.M, args.K, args.n_rows, n_cols)
+    if error:
+        parser.error(error)
+    my_matvec(args.M, args.K, args.n_rows, n_cols)
+
+
+main()
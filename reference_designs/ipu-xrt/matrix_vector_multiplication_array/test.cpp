@@ -0,0 +1,256 @@
+//===- test.cpp -------------------------------------------000---*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <boost/program_options.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdfloat>
+#include <string>
+#include <vector>
+
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#include "ipu_host.h"
+
+// The sizes of the design, given to aie2.py with -M and -K.
+#ifndef MV_M
+#define MV_M 2048
+#endif
+#ifndef MV_K
+#define MV_K 2048
+#endif
+
+constexpr int M = MV_M;
+constexpr int K = MV_K;
+
+constexpr int aVolume = M * K;
+constexpr int bVolume = K;
+constexpr int cVolume = M;
+
+using A_DATATYPE = std::bfloat16_t;
+using B_DATATYPE = std::bfloat16_t;
+using C_DATATYPE = float;
+
+constexpr int aSize = (aVolume * sizeof(A_DATATYPE));
+constexpr int bSize = (bVolume * sizeof(B_DATATYPE));
+constexpr int cSize = (cVolume * sizeof(C_DATATYPE));
+
+namespace po = boost::program_options;
+
+void checkArgFileExists(po::variables_map &vmIn, std::string name) {
+  if (!vmIn.count(name)) {
+    throw std::runtime_error("Error: no " + name + " file was provided\n");
+  }
+  std::ifstream test(vmIn[name].as<std::string>());
+  if (!test) {
+    throw std::runtime_error("The " + name + " file " +
+                             vmIn[name].as<std::string>() +
+                             " does not exist.\n");
+  }
+}
+
+static std::bfloat16_t randomBfloat16(std::default_random_engine &gen) {
+  std::uniform_real_distribution<float> distribution(0.0, 1.0);
+  return std::bfloat16_t(distribution(gen));
+}
+
+void matvec(const std::vector<A_DATATYPE> &a, const std::vector<B_DATATYPE> &b,
+            std::vector<C_DATATYPE> &c) {
+  for (int row = 0; row < M; row++) {
+    C_DATATYPE runningSum = 0;
+    for (int i = 0; i < K; i++)
+      runningSum += (C_DATATYPE)a[row * K + i] * (C_DATATYPE)b[i];
+    c[row] = runningSum;
+  }
+}
+
+int main(int argc, const char *argv[]) {
+
+  // Program arguments parsing
+  po::options_description desc("Allowed options");
+  desc.add_options()("help,h", "produce help message")(
+      "xclbin,x", po::value<std::string>()->required(),
+      "the input xclbin path")(
+      "kernel,k", po::value<std::string>()->required(),
+      "the kernel name in the XCLBIN (for instance PP_PRE_FD)")(
+      "verbosity,v", po::value<int>()->default_value(0),
+      "the verbosity of the output")(
+      "warmup", po::value<int>()->default_value(0),
+      "the number of untimed runs before the benchmark")(
+      "iters", po::value<int>()->default_value(0),
+      "the number of timed runs of the benchmark, 0 to skip it")(
+      "ddr-peak", po::value<double>()->default_value(0),
+      "the DDR bandwidth in GB/s measured by passthrough_hardware, to report "
+      "the bandwidth of the weights against")(
+      "instr,i", po::value<std::string>()->required(),
+      "path of file containing userspace instructions to be sent to the LX6");
+  po::variables_map vm;
+
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+      std::cout << desc << "\n";
+      return 1;
+    }
+  } catch (const std::exception &ex) {
+    std::cerr << ex.what() << "\n\n";
+    std::cerr << "Usage:\n" << desc << "\n";
+    return 1;
+  }
+
+  checkArgFileExists(vm, "xclbin");
+  checkArgFileExists(vm, "instr");
+
+  std::vector<uint32_t> instrV =
+      ipu_host::load_instr_sequence(vm["instr"].as<std::string>());
+
+  int verbosity = vm["verbosity"].as<int>();
+  if (verbosity >= 1)
+    std::cout << "Sequence instr count: " << instrV.size() << "\n";
+
+  // Start the XRT test code
+  // Get a device handle
+  unsigned int deviceIndex = 0;
+  auto device = xrt::device(deviceIndex);
+
+  // Load the xclbin
+  if (verbosity >= 1)
+    std::cout << "Loading xclbin: " << vm["xclbin"].as<std::string>() << "\n";
+  auto xclbin = xrt::xclbin(vm["xclbin"].as<std::string>());
+
+  if (verbosity >= 1)
+    std::cout << "Kernel opcode: " << vm["kernel"].as<std::string>() << "\n";
+  std::string node = vm["kernel"].as<std::string>();
+
+  // Get the kernel from the xclbin
+  auto xkernels = xclbin.get_kernels();
+  auto xkernel = *std::find_if(xkernels.begin(), xkernels.end(),
+                               [node](xrt::xclbin::kernel &k) {
+                                 auto name = k.get_name();
+                                 std::cout << "Name: " << name << std::endl;
+                                 return name.rfind(node, 0) == 0;
+                               });
+  auto kernelName = xkernel.get_name();
+
+  if (verbosity >= 1)
+    std::cout << "Registering xclbin: " << vm["xclbin"].as<std::string>()
+              << "\n";
+
+  device.register_xclbin(xclbin);
+
+  // get a hardware context
+  if (verbosity >= 1)
+    std::cout << "Getting hardware context.\n";
+  xrt::hw_context context(device, xclbin.get_uuid());
+
+  // get a kernel handle
+  if (verbosity >= 1)
+    std::cout << "Getting handle to kernel:" << kernelName << "\n";
+  auto kernel = xrt::kernel(context, kernelName);
+
+  auto boInstr = xrt::bo(device, instrV.size() * sizeof(int),
+                         XCL_BO_FLAGS_CACHEABLE, kernel.group_id(0));
+  auto boA = xrt::bo(device, aSize, XRT_BO_FLAGS_HOST_ONLY, kernel.group_id(2));
+  auto boB = xrt::bo(device, bSize, XRT_BO_FLAGS_HOST_ONLY, kernel.group_id(3));
+  auto boC = xrt::bo(device, cSize, XRT_BO_FLAGS_HOST_ONLY, kernel.group_id(4));
+
+  if (verbosity >= 1)
+    std::cout << "Writing data into buffer objects.\n";
+  std::default_random_engine gen;
+  std::vector<A_DATATYPE> aVec;
+  for (int i = 0; i < aVolume; i++)
+    aVec.push_back(randomBfloat16(gen));
+  memcpy(boA.map<A_DATATYPE *>(), aVec.data(), aSize);
+  std::vector<B_DATATYPE> bVec;
+  for (int i = 0; i < bVolume; i++)
+    bVec.push_back(randomBfloat16(gen));
+  memcpy(boB.map<B_DATATYPE *>(), bVec.data(), bSize);
+  memset(boC.map<C_DATATYPE *>(), 0, cSize);
+
+  memcpy(boInstr.map<void *>(), instrV.data(), instrV.size() * sizeof(int));
+
+  boInstr.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  boA.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  boB.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  boC.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+  if (verbosity >= 1)
+    std::cout << "Running Kernel.\n";
+  auto run = kernel(boInstr, instrV.size(), boA, boB, boC);
+  run.wait();
+
+  boC.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+
+  C_DATATYPE *bufOut = boC.map<C_DATATYPE *>();
+
+  int errors = 0;
+  int maxErrors = 100;
+
+  std::vector<C_DATATYPE> outputRef0(cVolume);
+  matvec(aVec, bVec, outputRef0);
+
+  // The partial sums are added in a different order than the reference, so
+  // the tolerance grows with the magnitude of the result.
+  const float relTol = 1e-3;
+  const float absTol = 0.1;
+  for (uint32_t i = 0; i < cVolume; i++) {
+    float diff = std::abs(bufOut[i] - outputRef0[i]);
+    if (diff > absTol + relTol * std::abs(outputRef0[i])) {
+      errors++;
+      if (errors < maxErrors) {
+        std::cout << "\nerror, id " << i << " expected "
+                  << std::to_string(outputRef0[i]) << ", got "
+                  << std::to_string(bufOut[i]) << "\n";
+      }
+    }
+  }
+
+  // Each timed run only includes the kernel, as the weights of a decode stay
+  // in DDR from one token to the next. The GEMV is bound by the bandwidth of
+  // the weights, reported against the DDR peak measured by the same kernel
+  // only runs of passthrough_hardware.
+  int iters = vm["iters"].as<int>();
+  if (iters > 0) {
+    ipu_host::benchmark_result result = ipu_host::benchmark(
+        [&]() {
+          auto run = kernel(boInstr, instrV.size(), boA, boB, boC);
+          run.wait();
+        },
+        vm["warmup"].as<int>(), iters);
+    ipu_host::print_benchmark_json(std::cout, "matrix_vector_multiplication",
+                                   result, 2.0 * M * K, aSize + bSize + cSize);
+
+    double weightGBps = aSize / result.mean_us() / 1e3;
+    std::cout << "Weight bandwidth: " << weightGBps << " GB/s";
+    double ddrPeak = vm["ddr-peak"].as<double>();
+    if (ddrPeak > 0)
+      std::cout << ", " << 100 * weightGBps / ddrPeak << "% of the "
+                << ddrPeak << " GB/s DDR peak";
+    std::cout << "\n";
+  }
+
+  if (!errors) {
+    std::cout << "\nPASS!\n\n";
+    return 0;
+  }
+  std::cout << "\nerror count: " << errors << "\n\n";
+  std::cout << "\nfailed.\n\n";
+  return 1;
+}
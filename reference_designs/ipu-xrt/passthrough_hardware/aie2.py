@@ -5,7 +5,14 @@
 #
 # (c) Copyright 2023 AMD Inc.
 
-import sys
+# Passthrough of a buffer of N int32s, from A to C, through the shim DMAs.
+# The buffer is split evenly over the channels, channel c using the MM2S and
+# S2MM channel c % 2 of the shim of column c // 2. Each channel moves its
+# slice through a compute tile of its column (the direct route) or through
+# the memtile of its column, with the same access pattern in and out, so that
+# C is a copy of A whatever the pattern.
+
+import argparse
 
 from aie.dialects.aie import *
 from aie.dialects.aiex import *
@@ -13,49 +20,139 @@ from aie.dialects.scf import *
 from aie.extras.dialects.ext import memref, arith
 from aie.extras.context import mlir_mod_ctx
 
-N = 4096
-N_in_bytes = N * 4
+MAX_CHANNELS = 8
+
+# The largest objectFifo element, in int32s.
+MAX_ELEM = 1024
+
+ROUTES = ["direct", "memtile"]
+# linear: the slice of a channel in a single contiguous transfer.
+# strided: the slice seen as `rows` rows of bursts of `burst` int32s, read a
+# column of bursts at a time, one burst from each row.
+PATTERNS = ["linear", "strided"]
+
+
+def elem_size(N, channels):
+    return min(MAX_ELEM, N // channels)
+
+
+def check_config(N, channels, pattern, burst, rows):
+    if not 1 <= channels <= MAX_CHANNELS:
+        return f"the number of channels must be between 1 and {MAX_CHANNELS}"
+    if N % channels or N < channels:
+        return f"{N} int32s can't be split over {channels} channels"
+    if (N // channels) % elem_size(N, channels):
+        return f"the slice of a channel isn't a multiple of {MAX_ELEM} int32s"
+    if pattern == "strided" and (N // channels) % (burst * rows):
+        return f"the slice of a channel isn't a multiple of {rows} rows of {burst}"
+    return None
+
 
-if len(sys.argv) == 2:
-    N = int(sys.argv[1])
+def my_passthrough(N, channels, route, pattern, burst, rows):
+    slice_len = N // channels
+    elem = elem_size(N, channels)
 
+    if pattern == "linear":
+        sizes = [1, 1, 1, slice_len]
+        strides = [0, 0, 0]
+    else:
+        cols = slice_len // (burst * rows)
+        sizes = [1, cols, rows, burst]
+        strides = [0, burst, cols * burst]
 
-def my_passthrough():
     with mlir_mod_ctx() as ctx:
 
         @device(AIEDevice.ipu)
         def device_body():
-            memRef_ty = T.memref(1024, T.i32())
+            memRef_ty = T.memref(elem, T.i32())
             ofifo_memRef_ty = TypeAttr.get(ObjectFifoType.get(memRef_ty))
 
             # Tile declarations
-            ShimTile = tile(0, 0)
-            ComputeTile2 = tile(0, 2)
+            shims = [tile(col, 0) for col in range((channels + 1) // 2)]
+            hops = []
+            for c in range(channels):
+                if route == "memtile":
+                    hops.append(tile(c // 2, 1))
+                else:
+                    hops.append(tile(c // 2, 2 + c % 2))
 
             # AIE-array data movement with object fifos
-            objectfifo("in", ShimTile, [ComputeTile2], 2, ofifo_memRef_ty, [], [])
-            objectfifo("out", ComputeTile2, [ShimTile], 2, ofifo_memRef_ty, [], [])
-            objectfifo_link(["in"], ["out"])
+            for c in range(channels):
+                objectfifo(
+                    f"in{c}", shims[c // 2], [hops[c]], 2, ofifo_memRef_ty, [], []
+                )
+                objectfifo(
+                    f"out{c}", hops[c], [shims[c // 2]], 2, ofifo_memRef_ty, [], []
+                )
+                objectfifo_link([f"in{c}"], [f"out{c}"])
 
             # Set up compute tiles
+            for c in range(channels):
+                if route == "memtile":
+                    continue
 
-            # Compute tile 2
-            @core(ComputeTile2)
-            def core_body():
-                tmp = memref.alloc(1, T.i32())
-                v0 = arith.constant(0, T.i32())
-                memref.store(v0, tmp, [0])
+                @core(hops[c])
+                def core_body():
+                    tmp = memref.alloc(1, T.i32())
+                    v0 = arith.constant(0, T.i32())
+                    memref.store(v0, tmp, [0])
 
             # To/from AIE-array data movement
             tensor_ty = T.memref(N, T.i32())
 
             @FuncOp.from_py_func(tensor_ty, tensor_ty, tensor_ty)
             def sequence(A, B, C):
-                ipu_dma_memcpy_nd(metadata="out", bd_id=0, mem=C, sizes=[1, 1, 1, N])
-                ipu_dma_memcpy_nd(metadata="in", bd_id=1, mem=A, sizes=[1, 1, 1, N])
-                ipu_sync(column=0, row=0, direction=0, channel=0)
+                for c in range(channels):
+                    offsets = [0, 0, 0, c * slice_len]
+                    ipu_dma_memcpy_nd(
+                        metadata=f"out{c}",
+                        bd_id=2 * (c % 2),
+                        mem=C,
+                        offsets=offsets,
+                        sizes=sizes,
+                        strides=strides,
+                    )
+                    ipu_dma_memcpy_nd(
+                        metadata=f"in{c}",
+                        bd_id=2 * (c % 2) + 1,
+                        mem=A,
+                        offsets=offsets,
+                        sizes=sizes,
+                        strides=strides,
+                    )
+                for c in range(channels):
+                    ipu_sync(column=c // 2, row=0, direction=0, channel=c % 2)
 
     print(ctx.module)
 
 
-my_passthrough()
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("N", type=int, nargs="?", default=4096)
+    parser.add_argument("--channels", type=int, default=1)
+    parser.add_argument("--route", choices=ROUTES, default="direct")
+    parser.add_argument("--pattern", choices=PATTERNS, default="linear")
+    parser.add_argument(
+        "--burst",
+        type=int,
+        default=16,
+        help="the int32s read contiguously by the strided pattern",
+    )
+    parser.add_argument(
+        "--rows",
+        type=int,
+        default=16,
+        help="the rows of bursts the strided pattern reads across",
+    )
+    args = parser.parse_args()
+
+    error = check_config(args.N, args.channels, args.pattern, args.burst, args.rows)
+    if error:
+        parser.error(error)
+    my_passthrough(
+        args.N, args.channels, args.route, args.pattern, args.burst, args.rows
+    )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,154 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 AMD Inc.
+
+# Bandwidth sweep of the shim DMAs: runs the passthrough of aie2.py over
+# transfer sizes, numbers of channels, routes and access patterns, and writes
+# the bandwidth curve of each configuration as JSON. The xclbin only depends
+# on the channels, the route and the objectFifo element size, so it is built
+# once for all the transfer sizes and patterns that share them, each point
+# only generating its IPU instructions.
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+from aie2 import PATTERNS, ROUTES, check_config, elem_size
+
+DESIGN = os.path.join(os.path.dirname(os.path.abspath(__file__)), "aie2.py")
+
+
+def sizes_in_bytes(lo, hi, factor):
+    size = lo
+    while size <= hi:
+        yield size
+        size *= factor
+
+
+def generate(path, N, channels, route, pattern, burst, rows):
+    with open(path, "w") as f:
+        subprocess.run(
+            [sys.executable, DESIGN, str(N), "--channels", str(channels)]
+            + ["--route", route, "--pattern", pattern]
+            + ["--burst", str(burst), "--rows", str(rows)],
+            stdout=f,
+            check=True,
+        )
+
+
+def aiecc(cwd, *args):
+    subprocess.run(
+        ["aiecc.py", "--ipu-insts-name=insts.txt", *args, "aie.mlir"],
+        cwd=cwd,
+        check=True,
+        stdout=subprocess.DEVNULL,
+    )
+
+
+def measure(exe, xclbin, insts, N, warmup, iters):
+    cmd = [exe, "-x", xclbin, "-i", insts, "-k", "MLIR_AIE", "-l", str(N)]
+    cmd += ["--warmup", str(warmup), "--iters", str(iters)]
+    out = subprocess.run(cmd, capture_output=True, text=True).stdout
+    if "PASS!" not in out:
+        return None
+    for line in out.splitlines():
+        if line.startswith("{"):
+            return json.loads(line)
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--exe", default="./passThroughHardware.exe")
+    parser.add_argument("--build-dir", default="build/sweep")
+    parser.add_argument("-o", "--output", default="build/sweep.json")
+    parser.add_argument("--min-bytes", type=int, default=64)
+    parser.add_argument("--max-bytes", type=int, default=64 * 1024 * 1024)
+    parser.add_argument(
+        "--factor", type=int, default=4, help="the ratio of consecutive sizes"
+    )
+    parser.add_argument("--channels", type=int, nargs="+", default=[1, 2, 4, 8])
+    parser.add_argument("--routes", choices=ROUTES, nargs="+", default=ROUTES)
+    parser.add_argument("--patterns", choices=PATTERNS, nargs="+", default=PATTERNS)
+    parser.add_argument("--burst", type=int, default=16)
+    parser.add_argument("--rows", type=int, default=16)
+    parser.add_argument("--warmup", type=int, default=10)
+    parser.add_argument("--iters", type=int, default=100)
+    args = parser.parse_args()
+
+    exe = os.path.abspath(args.exe)
+    xclbins = {}
+    curves = []
+    for channels in args.channels:
+        for route in args.routes:
+            for pattern in args.patterns:
+                curve = {
+                    "channels": channels,
+                    "route": route,
+                    "pattern": pattern,
+                    "points": [],
+                }
+                if pattern == "strided":
+                    curve["burst_bytes"] = args.burst * 4
+                    curve["rows"] = args.rows
+                for size in sizes_in_bytes(args.min_bytes, args.max_bytes, args.factor):
+                    N = size // 4
+                    if check_config(N, channels, pattern, args.burst, args.rows):
+                        continue
+                    name = f"{channels}ch_{route}_{pattern}_{size}B"
+                    cwd = os.path.join(args.build_dir, name)
+                    os.makedirs(cwd, exist_ok=True)
+                    generate(
+                        os.path.join(cwd, "aie.mlir"),
+                        N,
+                        channels,
+                        route,
+                        pattern,
+                        args.burst,
+                        args.rows,
+                    )
+                    key = (channels, route, elem_size(N, channels))
+                    if key in xclbins:
+                        aiecc(cwd, "--aie-only-generate-ipu")
+                    else:
+                        aiecc(
+                            cwd,
+                            "--aie-generate-cdo",
+                            "--no-compile-host",
+                            "--xclbin-name=final.xclbin",
+                            "--aie-generate-ipu",
+                        )
+                        xclbins[key] = os.path.abspath(
+                            os.path.join(cwd, "final.xclbin")
+                        )
+                    result = measure(
+                        exe,
+                        xclbins[key],
+                        os.path.abspath(os.path.join(cwd, "insts.txt")),
+                        N,
+                        args.warmup,
+                        args.iters,
+                    )
+                    if result is None:
+                        print(f"{name}: failed", file=sys.stderr)
+                        continue
+                    result["bytes"] = size
+                    curve["points"].append(result)
+                    print(
+                        f"{name}: {result.get('bytes_per_second', 0) / 1e9:.2f} GB/s",
+                        file=sys.stderr,
+                    )
+                curves.append(curve)
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, "w") as f:
+        json.dump({"name": "dma_bandwidth_sweep", "curves": curves}, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
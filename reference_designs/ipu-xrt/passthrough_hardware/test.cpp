@@ -21,6 +21,8 @@
 #include "xrt/xrt_device.h"
 #include "xrt/xrt_kernel.h"
 
+#include "ipu_host.h"
+
 namespace po = boost::program_options;
 
 void check_arg_file_exists(po::variables_map &vm_in, std::string name) {
@@ -64,7 +66,11 @@ int main(int argc, const char *argv[]) {
       "instr,i", po::value<std::string>()->required(),
       "path of file containing userspace instructions to be sent to the LX6")(
       "length,l", po::value<int>()->default_value(4096),
-      "the length of the transfer in int32_t");
+      "the length of the transfer in int32_t")(
+      "warmup", po::value<int>()->default_value(0),
+      "the number of untimed runs before the benchmark")(
+      "iters", po::value<int>()->default_value(0),
+      "the number of timed runs of the benchmark, 0 to skip it");
   po::variables_map vm;
 
   try {
@@ -92,8 +98,8 @@ int main(int argc, const char *argv[]) {
     std::cout << "Sequence instr count: " << instr_v.size() << std::endl;
 
   int N = vm["length"].as<int>();
-  if ((N % 1024)) {
-    std::cerr << "Length must be a multiple of 1024." << std::endl;
+  if (N <= 0) {
+    std::cerr << "Length must be positive." << std::endl;
     return 1;
   }
 
@@ -181,6 +187,21 @@ int main(int argc, const char *argv[]) {
     }
   }
 
+  // Each timed run only includes the kernel, so that the bytes_per_second of
+  // the report is the bandwidth of the DDR through the shim DMAs, against
+  // which the memory-bound designs measure their efficiency.
+  int iters = vm["iters"].as<int>();
+  if (iters > 0) {
+    ipu_host::benchmark_result result = ipu_host::benchmark(
+        [&]() {
+          auto run = kernel(bo_instr, instr_v.size(), bo_inA, bo_inB, bo_out);
+          run.wait();
+        },
+        vm["warmup"].as<int>(), iters);
+    ipu_host::print_benchmark_json(std::cout, "passthrough_hardware", result,
+                                   0, 2.0 * N * sizeof(int32_t));
+  }
+
   if (!errors) {
     std::cout << std::endl << "PASS!" << std::endl << std::endl;
     return 0;
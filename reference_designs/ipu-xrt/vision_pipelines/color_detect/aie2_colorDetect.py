@@ -16,9 +16,18 @@ from aie.ir import MemRefType, TypeAttr
 
 width = 64
 height = 36
-if len(sys.argv) == 3:
+# The frame is split into horizontal stripes, one per column of the array.
+columns = 1
+if len(sys.argv) >= 3:
     width = int(sys.argv[1])
     height = int(sys.argv[2])
+if len(sys.argv) == 4:
+    columns = int(sys.argv[3])
+
+if columns < 1 or columns > 4:
+    sys.exit("color_detect: columns must be between 1 and 4")
+if height < columns:
+    sys.exit("color_detect: each stripe needs at least 1 line")
 
 lineWidth = width
 lineWidthInBytes = width * 4
@@ -29,6 +38,18 @@ traceSizeInBytes = 8192
 traceSizeInInt32s = traceSizeInBytes // 4
 
 
+# The first and number of lines of the stripe of each column. Every kernel of
+# the pipeline works on one line at a time, so the stripes don't overlap.
+def stripes():
+    result = []
+    start = 0
+    for col in range(columns):
+        lines = height // columns + (1 if col < height % columns else 0)
+        result.append((start, lines))
+        start += lines
+    return result
+
+
 def color_detect():
     with mlir_mod_ctx() as ctx:
 
@@ -59,295 +80,275 @@ def color_detect():
                 inputs=[line_bytes_ty, line_bytes_ty, line_bytes_ty, T.i32()],
             )
 
-            # Tile declarations
-            ShimTile = tile(0, 0)
-            MemTile = tile(0, 1)
-            ComputeTile2 = tile(0, 2)
-            ComputeTile3 = tile(0, 3)
-            ComputeTile4 = tile(0, 4)
-            ComputeTile5 = tile(0, 5)
+            for col in range(columns):
+                inOF_L3L2 = f"inOF_L3L2_{col}"
+                inOF_L2L1 = f"inOF_L2L1_{col}"
+                outOF_L2L3 = f"outOF_L2L3_{col}"
+                outOF_L1L2 = f"outOF_L1L2_{col}"
+                OF_2to34 = f"OF_2to34_{col}"
+                OF_3to5 = f"OF_3to5_{col}"
+                OF_4to5 = f"OF_4to5_{col}"
 
-            # AIE-array data movement with object fifos
+                # Tile declarations
+                ShimTile = tile(col, 0)
+                MemTile = tile(col, 1)
+                ComputeTile2 = tile(col, 2)
+                ComputeTile3 = tile(col, 3)
+                ComputeTile4 = tile(col, 4)
+                ComputeTile5 = tile(col, 5)
 
-            # Input
-            objectfifo(
-                "inOF_L3L2",
-                ShimTile,
-                [ComputeTile2, MemTile],
-                [2, 2, 6],
-                ofifo_line_bytes_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "inOF_L2L1",
-                MemTile,
-                [ComputeTile5],
-                6,
-                ofifo_line_bytes_ty,
-                [],
-                [],
-            )
-            objectfifo_link(["inOF_L3L2"], ["inOF_L2L1"])
+                # AIE-array data movement with object fifos
 
-            # Output
-            objectfifo(
-                "outOF_L2L3",
-                MemTile,
-                [ShimTile],
-                2,
-                ofifo_line_bytes_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "outOF_L1L2",
-                ComputeTile5,
-                [MemTile],
-                2,
-                ofifo_line_bytes_ty,
-                [],
-                [],
-            )
-            objectfifo_link(["outOF_L1L2"], ["outOF_L2L3"])
+                # Input
+                objectfifo(
+                    inOF_L3L2,
+                    ShimTile,
+                    [ComputeTile2, MemTile],
+                    [2, 2, 6],
+                    ofifo_line_bytes_ty,
+                    [],
+                    [],
+                )
+                objectfifo(
+                    inOF_L2L1,
+                    MemTile,
+                    [ComputeTile5],
+                    6,
+                    ofifo_line_bytes_ty,
+                    [],
+                    [],
+                )
+                objectfifo_link([inOF_L3L2], [inOF_L2L1])
 
-            # Intermediate
-            objectfifo(
-                "OF_2to34",
-                ComputeTile2,
-                [ComputeTile3, ComputeTile4],
-                2,
-                ofifo_line_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "OF_3to3",
-                ComputeTile3,
-                [ComputeTile3],
-                1,
-                ofifo_line_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "OF_3to5",
-                ComputeTile3,
-                [ComputeTile5],
-                2,
-                ofifo_line_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "OF_4to4",
-                ComputeTile4,
-                [ComputeTile4],
-                1,
-                ofifo_line_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "OF_4to5",
-                ComputeTile4,
-                [ComputeTile5],
-                2,
-                ofifo_line_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "OF_5to5a",
-                ComputeTile5,
-                [ComputeTile5],
-                1,
-                ofifo_line_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "OF_5to5b",
-                ComputeTile5,
-                [ComputeTile5],
-                1,
-                ofifo_line_bytes_ty,
-                [],
-                [],
-            )
+                # Output
+                objectfifo(
+                    outOF_L2L3,
+                    MemTile,
+                    [ShimTile],
+                    2,
+                    ofifo_line_bytes_ty,
+                    [],
+                    [],
+                )
+                objectfifo(
+                    outOF_L1L2,
+                    ComputeTile5,
+                    [MemTile],
+                    2,
+                    ofifo_line_bytes_ty,
+                    [],
+                    [],
+                )
+                objectfifo_link([outOF_L1L2], [outOF_L2L3])
 
-            # Set up compute tiles
+                # Intermediate
+                objectfifo(
+                    OF_2to34,
+                    ComputeTile2,
+                    [ComputeTile3, ComputeTile4],
+                    2,
+                    ofifo_line_ty,
+                    [],
+                    [],
+                )
+                objectfifo(
+                    OF_3to5,
+                    ComputeTile3,
+                    [ComputeTile5],
+                    2,
+                    ofifo_line_ty,
+                    [],
+                    [],
+                )
+                objectfifo(
+                    OF_4to5,
+                    ComputeTile4,
+                    [ComputeTile5],
+                    2,
+                    ofifo_line_ty,
+                    [],
+                    [],
+                )
+
+                # The kernels chained on one compute tile hand their lines to
+                # each other through buffers of the tile, without locks
+                tmp3 = buffer(ComputeTile3, (lineWidth,), T.ui8(), name=f"tmp3_{col}")
+                tmp4 = buffer(ComputeTile4, (lineWidth,), T.ui8(), name=f"tmp4_{col}")
+                tmp5a = buffer(ComputeTile5, (lineWidth,), T.ui8(), name=f"tmp5a_{col}")
+                tmp5b = buffer(
+                    ComputeTile5, (lineWidthInBytes,), T.ui8(), name=f"tmp5b_{col}"
+                )
 
-            # Compute tile 2
-            @core(ComputeTile2, "rgba2hue.cc.o")
-            def coreBody():
-                for _ in range_(sys.maxsize):
-                    elemIn = acquire(
-                        ObjectFifoPort.Consume, "inOF_L3L2", 1, line_bytes_ty
-                    ).acquired_elem()
-                    elemOut = acquire(
-                        ObjectFifoPort.Produce, "OF_2to34", 1, line_ty
-                    ).acquired_elem()
-                    Call(rgba2hueLine, [elemIn, elemOut, arith.constant(lineWidth)])
-                    objectfifo_release(ObjectFifoPort.Consume, "inOF_L3L2", 1)
-                    objectfifo_release(ObjectFifoPort.Produce, "OF_2to34", 1)
-                    yield_([])
+                # Set up compute tiles
 
-            # Compute tile 3
-            @core(ComputeTile3, "threshold.cc.o")
-            def coreBody():
-                thresholdValueUpper1 = arith.constant(40, T.i16())
-                thresholdValueLower1 = arith.constant(30, T.i16())
-                thresholdMaxvalue = arith.constant(255, T.i16())
-                thresholdModeToZeroInv = arith.constant(4, T.i8())
-                thresholdModeBinary = arith.constant(0, T.i8())
-                for _ in range_(sys.maxsize):
-                    elemIn = acquire(
-                        ObjectFifoPort.Consume, "OF_2to34", 1, line_ty
-                    ).acquired_elem()
-                    elemOutTmp = acquire(
-                        ObjectFifoPort.Produce, "OF_3to3", 1, line_ty
-                    ).acquired_elem()
-                    Call(
-                        thresholdLine,
-                        [
+                # Compute tile 2
+                @core(ComputeTile2, "rgba2hue.cc.o")
+                def coreBody():
+                    for _ in range_(sys.maxsize):
+                        elemIn = acquire(
+                            ObjectFifoPort.Consume, inOF_L3L2, 1, line_bytes_ty
+                        ).acquired_elem()
+                        elemOut = acquire(
+                            ObjectFifoPort.Produce, OF_2to34, 1, line_ty
+                        ).acquired_elem()
+                        Call(rgba2hueLine, [elemIn, elemOut, arith.constant(lineWidth)])
+                        objectfifo_release(ObjectFifoPort.Consume, inOF_L3L2, 1)
+                        objectfifo_release(ObjectFifoPort.Produce, OF_2to34, 1)
+                        yield_([])
+
+                # Compute tile 3
+                @core(ComputeTile3, "threshold.cc.o")
+                def coreBody():
+                    thresholdValueUpper1 = arith.constant(40, T.i16())
+                    thresholdValueLower1 = arith.constant(30, T.i16())
+                    thresholdMaxvalue = arith.constant(255, T.i16())
+                    thresholdModeToZeroInv = arith.constant(4, T.i8())
+                    thresholdModeBinary = arith.constant(0, T.i8())
+                    for _ in range_(sys.maxsize):
+                        elemIn = acquire(
+                            ObjectFifoPort.Consume, OF_2to34, 1, line_ty
+                        ).acquired_elem()
+                        elemOut = acquire(
+                            ObjectFifoPort.Produce, OF_3to5, 1, line_ty
+                        ).acquired_elem()
+                        call_chain(
+                            [
+                                (
+                                    thresholdLine,
+                                    lambda src, dst: [
+                                        src,
+                                        dst,
+                                        arith.constant(lineWidth),
+                                        thresholdValueUpper1,
+                                        thresholdMaxvalue,
+                                        thresholdModeToZeroInv,
+                                    ],
+                                ),
+                                (
+                                    thresholdLine,
+                                    lambda src, dst: [
+                                        src,
+                                        dst,
+                                        arith.constant(lineWidth),
+                                        thresholdValueLower1,
+                                        thresholdMaxvalue,
+                                        thresholdModeBinary,
+                                    ],
+                                ),
+                            ],
                             elemIn,
-                            elemOutTmp,
-                            arith.constant(lineWidth),
-                            thresholdValueUpper1,
-                            thresholdMaxvalue,
-                            thresholdModeToZeroInv,
-                        ],
-                    )
-                    objectfifo_release(ObjectFifoPort.Consume, "OF_2to34", 1)
-                    objectfifo_release(ObjectFifoPort.Produce, "OF_3to3", 1)
-                    elemInTmp = acquire(
-                        ObjectFifoPort.Consume, "OF_3to3", 1, line_ty
-                    ).acquired_elem()
-                    elemOut = acquire(
-                        ObjectFifoPort.Produce, "OF_3to5", 1, line_ty
-                    ).acquired_elem()
-                    Call(
-                        thresholdLine,
-                        [
-                            elemInTmp,
                             elemOut,
-                            arith.constant(lineWidth),
-                            thresholdValueLower1,
-                            thresholdMaxvalue,
-                            thresholdModeBinary,
-                        ],
-                    )
-                    objectfifo_release(ObjectFifoPort.Consume, "OF_3to3", 1)
-                    objectfifo_release(ObjectFifoPort.Produce, "OF_3to5", 1)
-                    yield_([])
+                            [tmp3],
+                        )
+                        objectfifo_release(ObjectFifoPort.Consume, OF_2to34, 1)
+                        objectfifo_release(ObjectFifoPort.Produce, OF_3to5, 1)
+                        yield_([])
 
-            # Compute tile 4
-            @core(ComputeTile4, "threshold.cc.o")
-            def coreBody():
-                thresholdValueUpper1 = arith.constant(160, T.i16())
-                thresholdValueLower1 = arith.constant(90, T.i16())
-                thresholdMaxvalue = arith.constant(255, T.i16())
-                thresholdModeToZeroInv = arith.constant(4, T.i8())
-                thresholdModeBinary = arith.constant(0, T.i8())
-                for _ in range_(sys.maxsize):
-                    elemIn = acquire(
-                        ObjectFifoPort.Consume, "OF_2to34", 1, line_ty
-                    ).acquired_elem()
-                    elemOutTmp = acquire(
-                        ObjectFifoPort.Produce, "OF_4to4", 1, line_ty
-                    ).acquired_elem()
-                    Call(
-                        thresholdLine,
-                        [
+                # Compute tile 4
+                @core(ComputeTile4, "threshold.cc.o")
+                def coreBody():
+                    thresholdValueUpper1 = arith.constant(160, T.i16())
+                    thresholdValueLower1 = arith.constant(90, T.i16())
+                    thresholdMaxvalue = arith.constant(255, T.i16())
+                    thresholdModeToZeroInv = arith.constant(4, T.i8())
+                    thresholdModeBinary = arith.constant(0, T.i8())
+                    for _ in range_(sys.maxsize):
+                        elemIn = acquire(
+                            ObjectFifoPort.Consume, OF_2to34, 1, line_ty
+                        ).acquired_elem()
+                        elemOut = acquire(
+                            ObjectFifoPort.Produce, OF_4to5, 1, line_ty
+                        ).acquired_elem()
+                        call_chain(
+                            [
+                                (
+                                    thresholdLine,
+                                    lambda src, dst: [
+                                        src,
+                                        dst,
+                                        arith.constant(lineWidth),
+                                        thresholdValueUpper1,
+                                        thresholdMaxvalue,
+                                        thresholdModeToZeroInv,
+                                    ],
+                                ),
+                                (
+                                    thresholdLine,
+                                    lambda src, dst: [
+                                        src,
+                                        dst,
+                                        arith.constant(lineWidth),
+                                        thresholdValueLower1,
+                                        thresholdMaxvalue,
+                                        thresholdModeBinary,
+                                    ],
+                                ),
+                            ],
                             elemIn,
-                            elemOutTmp,
-                            arith.constant(lineWidth),
-                            thresholdValueUpper1,
-                            thresholdMaxvalue,
-                            thresholdModeToZeroInv,
-                        ],
-                    )
-                    objectfifo_release(ObjectFifoPort.Consume, "OF_2to34", 1)
-                    objectfifo_release(ObjectFifoPort.Produce, "OF_4to4", 1)
-                    elemInTmp = acquire(
-                        ObjectFifoPort.Consume, "OF_4to4", 1, line_ty
-                    ).acquired_elem()
-                    elemOut = acquire(
-                        ObjectFifoPort.Produce, "OF_4to5", 1, line_ty
-                    ).acquired_elem()
-                    Call(
-                        thresholdLine,
-                        [
-                            elemInTmp,
                             elemOut,
-                            arith.constant(lineWidth),
-                            thresholdValueLower1,
-                            thresholdMaxvalue,
-                            thresholdModeBinary,
-                        ],
-                    )
-                    objectfifo_release(ObjectFifoPort.Consume, "OF_4to4", 1)
-                    objectfifo_release(ObjectFifoPort.Produce, "OF_4to5", 1)
-                    yield_([])
+                            [tmp4],
+                        )
+                        objectfifo_release(ObjectFifoPort.Consume, OF_2to34, 1)
+                        objectfifo_release(ObjectFifoPort.Produce, OF_4to5, 1)
+                        yield_([])
 
-            # Compute tile 5
-            @core(ComputeTile5, "combined_bitwiseOR_gray2rgba_bitwiseAND.a")
-            def coreBody():
-                for _ in range_(sys.maxsize):
-                    # bitwise OR
-                    elemIn1 = acquire(
-                        ObjectFifoPort.Consume, "OF_3to5", 1, line_ty
-                    ).acquired_elem()
-                    elemIn2 = acquire(
-                        ObjectFifoPort.Consume, "OF_4to5", 1, line_ty
-                    ).acquired_elem()
-                    elemOutTmpA = acquire(
-                        ObjectFifoPort.Produce, "OF_5to5a", 1, line_ty
-                    ).acquired_elem()
-                    Call(
-                        bitwiseORLine,
-                        [elemIn1, elemIn2, elemOutTmpA, arith.constant(lineWidth)],
-                    )
-                    objectfifo_release(ObjectFifoPort.Consume, "OF_3to5", 1)
-                    objectfifo_release(ObjectFifoPort.Consume, "OF_4to5", 1)
-                    objectfifo_release(ObjectFifoPort.Produce, "OF_5to5a", 1)
-                    # gray2rgba
-                    elemInTmpA = acquire(
-                        ObjectFifoPort.Consume, "OF_5to5a", 1, line_ty
-                    ).acquired_elem()
-                    elemOutTmpB = acquire(
-                        ObjectFifoPort.Produce, "OF_5to5b", 1, line_bytes_ty
-                    ).acquired_elem()
-                    Call(
-                        gray2rgbaLine,
-                        [elemInTmpA, elemOutTmpB, arith.constant(lineWidth)],
-                    )
-                    objectfifo_release(ObjectFifoPort.Consume, "OF_5to5a", 1)
-                    objectfifo_release(ObjectFifoPort.Produce, "OF_5to5b", 1)
-                    # bitwise AND
-                    elemInTmpB1 = acquire(
-                        ObjectFifoPort.Consume, "OF_5to5b", 1, line_bytes_ty
-                    ).acquired_elem()
-                    elemInTmpB2 = acquire(
-                        ObjectFifoPort.Consume, "inOF_L2L1", 1, line_bytes_ty
-                    ).acquired_elem()
-                    elemOut = acquire(
-                        ObjectFifoPort.Produce, "outOF_L1L2", 1, line_bytes_ty
-                    ).acquired_elem()
-                    Call(
-                        bitwiseANDLine,
-                        [
-                            elemInTmpB1,
-                            elemInTmpB2,
+                # Compute tile 5
+                @core(ComputeTile5, "combined_bitwiseOR_gray2rgba_bitwiseAND.a")
+                def coreBody():
+                    for _ in range_(sys.maxsize):
+                        elemIn1 = acquire(
+                            ObjectFifoPort.Consume, OF_3to5, 1, line_ty
+                        ).acquired_elem()
+                        elemIn2 = acquire(
+                            ObjectFifoPort.Consume, OF_4to5, 1, line_ty
+                        ).acquired_elem()
+                        elemInRgba = acquire(
+                            ObjectFifoPort.Consume, inOF_L2L1, 1, line_bytes_ty
+                        ).acquired_elem()
+                        elemOut = acquire(
+                            ObjectFifoPort.Produce, outOF_L1L2, 1, line_bytes_ty
+                        ).acquired_elem()
+                        call_chain(
+                            [
+                                # bitwise OR
+                                (
+                                    bitwiseORLine,
+                                    lambda src, dst: [
+                                        src,
+                                        elemIn2,
+                                        dst,
+                                        arith.constant(lineWidth),
+                                    ],
+                                ),
+                                # gray2rgba
+                                (
+                                    gray2rgbaLine,
+                                    lambda src, dst: [
+                                        src,
+                                        dst,
+                                        arith.constant(lineWidth),
+                                    ],
+                                ),
+                                # bitwise AND
+                                (
+                                    bitwiseANDLine,
+                                    lambda src, dst: [
+                                        src,
+                                        elemInRgba,
+                                        dst,
+                                        arith.constant(lineWidthInBytes),
+                                    ],
+                                ),
+                            ],
+                            elemIn1,
                             elemOut,
-                            arith.constant(lineWidthInBytes),
-                        ],
-                    )
-                    objectfifo_release(ObjectFifoPort.Consume, "OF_5to5b", 1)
-                    objectfifo_release(ObjectFifoPort.Consume, "inOF_L2L1", 1)
-                    objectfifo_release(ObjectFifoPort.Produce, "outOF_L1L2", 1)
-                    yield_([])
+                            [tmp5a, tmp5b],
+                        )
+                        objectfifo_release(ObjectFifoPort.Consume, OF_3to5, 1)
+                        objectfifo_release(ObjectFifoPort.Consume, OF_4to5, 1)
+                        objectfifo_release(ObjectFifoPort.Consume, inOF_L2L1, 1)
+                        objectfifo_release(ObjectFifoPort.Produce, outOF_L1L2, 1)
+                        yield_([])
 
             # To/from AIE-array data movement
 
@@ -364,19 +365,23 @@ def color_detect():
 
             @FuncOp.from_py_func(tensor_ty, memRef_16x16_ty, tensor_ty)
             def sequence(I, B, O):
-                ipu_dma_memcpy_nd(
-                    metadata="inOF_L3L2",
-                    bd_id=1,
-                    mem=I,
-                    sizes=[1, 1, 1, height * lineWidthInInt32s],
-                )
-                ipu_dma_memcpy_nd(
-                    metadata="outOF_L2L3",
-                    bd_id=0,
-                    mem=O,
-                    sizes=[1, 1, 1, height * lineWidthInInt32s],
-                )
-                ipu_sync(column=0, row=0, direction=0, channel=0)
+                for col, (stripeStart, stripeLines) in enumerate(stripes()):
+                    ipu_dma_memcpy_nd(
+                        metadata=f"inOF_L3L2_{col}",
+                        bd_id=1,
+                        mem=I,
+                        offsets=[0, 0, 0, stripeStart * lineWidthInInt32s],
+                        sizes=[1, 1, 1, stripeLines * lineWidthInInt32s],
+                    )
+                    ipu_dma_memcpy_nd(
+                        metadata=f"outOF_L2L3_{col}",
+                        bd_id=0,
+                        mem=O,
+                        offsets=[0, 0, 0, stripeStart * lineWidthInInt32s],
+                        sizes=[1, 1, 1, stripeLines * lineWidthInInt32s],
+                    )
+                for col in range(columns):
+                    ipu_sync(column=col, row=0, direction=0, channel=0)
 
     print(ctx.module)
 
@@ -15,11 +15,19 @@ from aie.extras.context import mlir_mod_ctx
 
 width = 64
 height = 36
-if len(sys.argv) == 3:
+# The frame is split into horizontal stripes, one per column of the array.
+columns = 1
+if len(sys.argv) >= 3:
     width = int(sys.argv[1])
     height = int(sys.argv[2])
+if len(sys.argv) == 4:
+    columns = int(sys.argv[3])
+
+if columns < 1 or columns > 4:
+    sys.exit("edge_detect: columns must be between 1 and 4")
+if height < 2 * columns:
+    sys.exit("edge_detect: each stripe needs at least 2 lines")
 
-heightMinus1 = height - 1
 lineWidth = width
 lineWidthInBytes = width * 4
 lineWidthInInt32s = lineWidthInBytes // 4
@@ -29,6 +37,21 @@ traceSizeInBytes = 8192
 traceSizeInInt32s = traceSizeInBytes // 4
 
 
+# The first and number of lines of the stripe of each column. The filter2d of
+# a stripe needs the line above and the line below it, the halo, except at the
+# borders of the frame: these lines are read from memory by the neighbouring
+# stripes too, and are only consumed by the filter and dropped by the final
+# kernel, which blends with the lines of the stripe itself.
+def stripes():
+    result = []
+    start = 0
+    for col in range(columns):
+        lines = height // columns + (1 if col < height % columns else 0)
+        result.append((start, lines))
+        start += lines
+    return result
+
+
 def edge_detect():
     with mlir_mod_ctx() as ctx:
 
@@ -49,296 +72,265 @@ def edge_detect():
                 "filter2dLine",
                 inputs=[line_ty, line_ty, line_ty, line_ty, T.i32(), memRef_3x3_ty],
             )
-            threshold_line = external_func(
-                "thresholdLine",
-                inputs=[line_ty, line_ty, T.i32(), T.i16(), T.i16(), T.i8()],
-            )
-            gray2rgba_line = external_func(
-                "gray2rgbaLine", inputs=[line_ty, line_bytes_ty, T.i32()]
-            )
-            add_weighted_line = external_func(
-                "addWeightedLine",
+            # threshold, gray2rgba and addWeighted fused into one pass
+            threshold_gray2rgba_add_weighted_line = external_func(
+                "thresholdGray2rgbaAddWeightedLine",
                 inputs=[
-                    line_bytes_ty,
+                    line_ty,
                     line_bytes_ty,
                     line_bytes_ty,
                     T.i32(),
+                    T.i8(),
+                    T.i8(),
                     T.i16(),
                     T.i16(),
                     T.i8(),
                 ],
             )
 
-            # Tile declarations
-            ShimTile = tile(0, 0)
-            MemTile = tile(0, 1)
-            ComputeTile2 = tile(0, 2)
-            ComputeTile3 = tile(0, 3)
-            ComputeTile4 = tile(0, 4)
-            ComputeTile5 = tile(0, 5)
-
-            # AIE-array data movement with object fifos
-            # Input
-            objectfifo(
-                "inOF_L3L2",
-                ShimTile,
-                [ComputeTile2, MemTile],
-                [2, 2, 7],
-                ofifo_line_bytes_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "inOF_L2L1",
-                MemTile,
-                [ComputeTile5],
-                7,
-                ofifo_line_bytes_ty,
-                [],
-                [],
-            )
-            objectfifo_link(["inOF_L3L2"], ["inOF_L2L1"])
-
-            # Output
-            objectfifo(
-                "outOF_L2L3",
-                MemTile,
-                [ShimTile],
-                2,
-                ofifo_line_bytes_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "outOF_L1L2",
-                ComputeTile5,
-                [MemTile],
-                2,
-                ofifo_line_bytes_ty,
-                [],
-                [],
-            )
-            objectfifo_link(["outOF_L1L2"], ["outOF_L2L3"])
-
-            # Intermediate
-            objectfifo(
-                "OF_2to3",
-                ComputeTile2,
-                [ComputeTile3],
-                4,
-                ofifo_line_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "OF_3to4",
-                ComputeTile3,
-                [ComputeTile4],
-                2,
-                ofifo_line_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "OF_4to5",
-                ComputeTile4,
-                [ComputeTile5],
-                2,
-                ofifo_line_ty,
-                [],
-                [],
-            )
-            objectfifo(
-                "OF_5to5",
-                ComputeTile5,
-                [ComputeTile5],
-                1,
-                ofifo_line_bytes_ty,
-                [],
-                [],
-            )
+            for col, (stripeStart, stripeLines) in enumerate(stripes()):
+                haloTop = 1 if stripeStart > 0 else 0
+                haloBottom = 1 if stripeStart + stripeLines < height else 0
+                # The lines filtered with the line above and below them
+                steadyLines = stripeLines - (1 - haloTop) - (1 - haloBottom)
+                inOF_L3L2 = f"inOF_L3L2_{col}"
+                inOF_L2L1 = f"inOF_L2L1_{col}"
+                outOF_L2L3 = f"outOF_L2L3_{col}"
+                outOF_L1L2 = f"outOF_L1L2_{col}"
+                OF_2to3 = f"OF_2to3_{col}"
+                OF_3to4 = f"OF_3to4_{col}"
+
+                # Tile declarations
+                ShimTile = tile(col, 0)
+                MemTile = tile(col, 1)
+                ComputeTile2 = tile(col, 2)
+                ComputeTile3 = tile(col, 3)
+                ComputeTile4 = tile(col, 4)
+
+                # AIE-array data movement with object fifos
+                # Input
+                objectfifo(
+                    inOF_L3L2,
+                    ShimTile,
+                    [ComputeTile2, MemTile],
+                    [2, 2, 7],
+                    ofifo_line_bytes_ty,
+                    [],
+                    [],
+                )
+                objectfifo(
+                    inOF_L2L1,
+                    MemTile,
+                    [ComputeTile4],
+                    7,
+                    ofifo_line_bytes_ty,
+                    [],
+                    [],
+                )
+                objectfifo_link([inOF_L3L2], [inOF_L2L1])
+
+                # Output
+                objectfifo(
+                    outOF_L2L3,
+                    MemTile,
+                    [ShimTile],
+                    2,
+                    ofifo_line_bytes_ty,
+                    [],
+                    [],
+                )
+                objectfifo(
+                    outOF_L1L2,
+                    ComputeTile4,
+                    [MemTile],
+                    2,
+                    ofifo_line_bytes_ty,
+                    [],
+                    [],
+                )
+                objectfifo_link([outOF_L1L2], [outOF_L2L3])
+
+                # Intermediate
+                objectfifo(
+                    OF_2to3,
+                    ComputeTile2,
+                    [ComputeTile3],
+                    4,
+                    ofifo_line_ty,
+                    [],
+                    [],
+                )
+                objectfifo(
+                    OF_3to4,
+                    ComputeTile3,
+                    [ComputeTile4],
+                    2,
+                    ofifo_line_ty,
+                    [],
+                    [],
+                )
 
-            # Set up compute tiles
-
-            # Compute tile 2
-            @core(ComputeTile2, "rgba2gray.cc.o")
-            def core_body():
-                for _ in for_(4294967295):
-                    # for _ in for_(36):
-                    elem_in = acquire(
-                        ObjectFifoPort.Consume, "inOF_L3L2", 1, line_bytes_ty
-                    ).acquired_elem()
-                    elem_out = acquire(
-                        ObjectFifoPort.Produce, "OF_2to3", 1, line_ty
-                    ).acquired_elem()
-
-                    Call(rgba2gray_line, [elem_in, elem_out, arith.constant(lineWidth)])
-
-                    objectfifo_release(ObjectFifoPort.Consume, "inOF_L3L2", 1)
-                    objectfifo_release(ObjectFifoPort.Produce, "OF_2to3", 1)
-                    yield_([])
-
-            # Compute tile 3
-            @core(ComputeTile3, "filter2d.cc.o")
-            def core_body():
-                kernel = memref.alloc(3, 3, T.i16())
-                v0 = arith.constant(0, T.i16())
-                v1 = arith.constant(4096, T.i16())
-                v_minus4 = arith.constant(-16384, T.i16())
-                memref.store(v0, kernel, [0, 0])
-                memref.store(v1, kernel, [0, 1])
-                memref.store(v0, kernel, [0, 2])
-                memref.store(v1, kernel, [1, 0])
-                memref.store(v_minus4, kernel, [1, 1])
-                memref.store(v1, kernel, [1, 2])
-                memref.store(v0, kernel, [2, 0])
-                memref.store(v1, kernel, [2, 1])
-                memref.store(v0, kernel, [2, 2])
-
-                for _ in for_(4294967295):
-                    # Preamble : Top Border
-                    elems_in_pre = acquire(
-                        ObjectFifoPort.Consume, "OF_2to3", 2, line_ty
-                    ).acquired_elem()
-                    elem_pre_out = acquire(
-                        ObjectFifoPort.Produce, "OF_3to4", 1, line_ty
-                    ).acquired_elem()
-                    Call(
-                        filter2d_line,
-                        [
-                            elems_in_pre[0],
-                            elems_in_pre[0],
-                            elems_in_pre[1],
-                            elem_pre_out,
-                            arith.constant(lineWidth),
-                            kernel,
-                        ],
-                    )
-                    objectfifo_release(ObjectFifoPort.Produce, "OF_3to4", 1)
+                # Set up compute tiles
 
-                    # Steady State : Middle
-                    for _ in for_(1, heightMinus1):
-                        elems_in = acquire(
-                            ObjectFifoPort.Consume, "OF_2to3", 3, line_ty
+                # Compute tile 2
+                @core(ComputeTile2, "rgba2gray.cc.o")
+                def core_body():
+                    for _ in for_(4294967295):
+                        # for _ in for_(36):
+                        elem_in = acquire(
+                            ObjectFifoPort.Consume, inOF_L3L2, 1, line_bytes_ty
                         ).acquired_elem()
                         elem_out = acquire(
-                            ObjectFifoPort.Produce, "OF_3to4", 1, line_ty
+                            ObjectFifoPort.Produce, OF_2to3, 1, line_ty
                         ).acquired_elem()
+
                         Call(
-                            filter2d_line,
-                            [
-                                elems_in[0],
-                                elems_in[1],
-                                elems_in[2],
-                                elem_out,
-                                arith.constant(lineWidth),
-                                kernel,
-                            ],
+                            rgba2gray_line,
+                            [elem_in, elem_out, arith.constant(lineWidth)],
                         )
-                        objectfifo_release(ObjectFifoPort.Consume, "OF_2to3", 1)
-                        objectfifo_release(ObjectFifoPort.Produce, "OF_3to4", 1)
-                        yield_([])
 
-                    # Postamble : Bottom Border
-                    elems_in_post = acquire(
-                        ObjectFifoPort.Consume, "OF_2to3", 2, line_ty
-                    ).acquired_elem()
-                    elem_post_out = acquire(
-                        ObjectFifoPort.Produce, "OF_3to4", 1, line_ty
-                    ).acquired_elem()
-                    Call(
-                        filter2d_line,
-                        [
-                            elems_in_post[0],
-                            elems_in_post[1],
-                            elems_in_post[1],
-                            elem_post_out,
-                            arith.constant(lineWidth),
-                            kernel,
-                        ],
-                    )
-                    objectfifo_release(ObjectFifoPort.Consume, "OF_2to3", 2)
-                    objectfifo_release(ObjectFifoPort.Produce, "OF_3to4", 1)
-                    yield_([])
-
-            # Compute tile 4
-            @core(ComputeTile4, "threshold.cc.o")
-            def core_body():
-                v_thr = arith.constant(10, T.i16())
-                v_max = arith.constant(255, T.i16())
-                v_typ = arith.constant(0, T.i8())
-
-                for _ in for_(4294967295):
-                    elem_in = acquire(
-                        ObjectFifoPort.Consume, "OF_3to4", 1, line_ty
-                    ).acquired_elem()
-                    elem_out = acquire(
-                        ObjectFifoPort.Produce, "OF_4to5", 1, line_ty
-                    ).acquired_elem()
-
-                    Call(
-                        threshold_line,
-                        [
-                            elem_in,
-                            elem_out,
-                            arith.constant(lineWidth),
-                            v_thr,
-                            v_max,
-                            v_typ,
-                        ],
-                    )
+                        objectfifo_release(ObjectFifoPort.Consume, inOF_L3L2, 1)
+                        objectfifo_release(ObjectFifoPort.Produce, OF_2to3, 1)
+                        yield_([])
 
-                    objectfifo_release(ObjectFifoPort.Consume, "OF_3to4", 1)
-                    objectfifo_release(ObjectFifoPort.Produce, "OF_4to5", 1)
-                    yield_([])
-
-            # Compute tile 5
-            @core(ComputeTile5, "combined_gray2rgba_addWeighted.a")
-            def core_body():
-                for _ in for_(4294967295):
-                    elem_in = acquire(
-                        ObjectFifoPort.Consume, "OF_4to5", 1, line_ty
-                    ).acquired_elem()
-                    elem_out = acquire(
-                        ObjectFifoPort.Produce, "OF_5to5", 1, line_bytes_ty
-                    ).acquired_elem()
-
-                    Call(gray2rgba_line, [elem_in, elem_out, arith.constant(lineWidth)])
-
-                    objectfifo_release(ObjectFifoPort.Consume, "OF_4to5", 1)
-                    objectfifo_release(ObjectFifoPort.Produce, "OF_5to5", 1)
-
-                    elem_in1 = acquire(
-                        ObjectFifoPort.Consume, "OF_5to5", 1, line_bytes_ty
-                    ).acquired_elem()
-                    elem_in2 = acquire(
-                        ObjectFifoPort.Consume, "inOF_L2L1", 1, line_bytes_ty
-                    ).acquired_elem()
-                    elem_out2 = acquire(
-                        ObjectFifoPort.Produce, "outOF_L1L2", 1, line_bytes_ty
-                    ).acquired_elem()
+                # Compute tile 3
+                @core(ComputeTile3, "filter2d.cc.o")
+                def core_body():
+                    kernel = memref.alloc(3, 3, T.i16())
+                    v0 = arith.constant(0, T.i16())
+                    v1 = arith.constant(4096, T.i16())
+                    v_minus4 = arith.constant(-16384, T.i16())
+                    memref.store(v0, kernel, [0, 0])
+                    memref.store(v1, kernel, [0, 1])
+                    memref.store(v0, kernel, [0, 2])
+                    memref.store(v1, kernel, [1, 0])
+                    memref.store(v_minus4, kernel, [1, 1])
+                    memref.store(v1, kernel, [1, 2])
+                    memref.store(v0, kernel, [2, 0])
+                    memref.store(v1, kernel, [2, 1])
+                    memref.store(v0, kernel, [2, 2])
+
+                    for _ in for_(4294967295):
+                        # Preamble : Top Border, unless the stripe has a halo
+                        if not haloTop:
+                            elems_in_pre = acquire(
+                                ObjectFifoPort.Consume, OF_2to3, 2, line_ty
+                            ).acquired_elem()
+                            elem_pre_out = acquire(
+                                ObjectFifoPort.Produce, OF_3to4, 1, line_ty
+                            ).acquired_elem()
+                            Call(
+                                filter2d_line,
+                                [
+                                    elems_in_pre[0],
+                                    elems_in_pre[0],
+                                    elems_in_pre[1],
+                                    elem_pre_out,
+                                    arith.constant(lineWidth),
+                                    kernel,
+                                ],
+                            )
+                            objectfifo_release(ObjectFifoPort.Produce, OF_3to4, 1)
+
+                        # Steady State : Middle
+                        for _ in for_(steadyLines):
+                            elems_in = acquire(
+                                ObjectFifoPort.Consume, OF_2to3, 3, line_ty
+                            ).acquired_elem()
+                            elem_out = acquire(
+                                ObjectFifoPort.Produce, OF_3to4, 1, line_ty
+                            ).acquired_elem()
+                            Call(
+                                filter2d_line,
+                                [
+                                    elems_in[0],
+                                    elems_in[1],
+                                    elems_in[2],
+                                    elem_out,
+                                    arith.constant(lineWidth),
+                                    kernel,
+                                ],
+                            )
+                            objectfifo_release(ObjectFifoPort.Consume, OF_2to3, 1)
+                            objectfifo_release(ObjectFifoPort.Produce, OF_3to4, 1)
+                            yield_([])
+
+                        # Postamble : Bottom Border, unless the stripe has a
+                        # halo
+                        if not haloBottom:
+                            elems_in_post = acquire(
+                                ObjectFifoPort.Consume, OF_2to3, 2, line_ty
+                            ).acquired_elem()
+                            elem_post_out = acquire(
+                                ObjectFifoPort.Produce, OF_3to4, 1, line_ty
+                            ).acquired_elem()
+                            Call(
+                                filter2d_line,
+                                [
+                                    elems_in_post[0],
+                                    elems_in_post[1],
+                                    elems_in_post[1],
+                                    elem_post_out,
+                                    arith.constant(lineWidth),
+                                    kernel,
+                                ],
+                            )
+                            objectfifo_release(ObjectFifoPort.Produce, OF_3to4, 1)
+                        objectfifo_release(ObjectFifoPort.Consume, OF_2to3, 2)
+                        yield_([])
 
+                # Compute tile 4
+                @core(ComputeTile4, "thresholdGray2rgbaAddWeighted.cc.o")
+                def core_body():
+                    v_thr = arith.constant(10, T.i8())
+                    v_max = arith.constant(255, T.i8())
                     alpha = arith.constant(16384, T.i16())
                     beta = arith.constant(16384, T.i16())
                     gamma = arith.constant(0, T.i8())
 
-                    Call(
-                        add_weighted_line,
-                        [
-                            elem_in1,
-                            elem_in2,
-                            elem_out2,
-                            arith.constant(lineWidthInBytes),
-                            alpha,
-                            beta,
-                            gamma,
-                        ],
-                    )
-
-                    objectfifo_release(ObjectFifoPort.Consume, "OF_5to5", 1)
-                    objectfifo_release(ObjectFifoPort.Consume, "inOF_L2L1", 1)
-                    objectfifo_release(ObjectFifoPort.Produce, "outOF_L1L2", 1)
-                    yield_([])
+                    for _ in for_(4294967295):
+                        # The halo lines of the input are not blended.
+                        if haloTop:
+                            acquire(
+                                ObjectFifoPort.Consume, inOF_L2L1, 1, line_bytes_ty
+                            )
+                            objectfifo_release(ObjectFifoPort.Consume, inOF_L2L1, 1)
+                        for _ in for_(stripeLines):
+                            elem_in = acquire(
+                                ObjectFifoPort.Consume, OF_3to4, 1, line_ty
+                            ).acquired_elem()
+                            elem_in_rgba = acquire(
+                                ObjectFifoPort.Consume, inOF_L2L1, 1, line_bytes_ty
+                            ).acquired_elem()
+                            elem_out = acquire(
+                                ObjectFifoPort.Produce, outOF_L1L2, 1, line_bytes_ty
+                            ).acquired_elem()
+
+                            Call(
+                                threshold_gray2rgba_add_weighted_line,
+                                [
+                                    elem_in,
+                                    elem_in_rgba,
+                                    elem_out,
+                                    arith.constant(lineWidth),
+                                    v_thr,
+                                    v_max,
+                                    alpha,
+                                    beta,
+                                    gamma,
+                                ],
+                            )
+
+                            objectfifo_release(ObjectFifoPort.Consume, OF_3to4, 1)
+                            objectfifo_release(ObjectFifoPort.Consume, inOF_L2L1, 1)
+                            objectfifo_release(ObjectFifoPort.Produce, outOF_L1L2, 1)
+                            yield_([])
+                        if haloBottom:
+                            acquire(
+                                ObjectFifoPort.Consume, inOF_L2L1, 1, line_bytes_ty
+                            )
+                            objectfifo_release(ObjectFifoPort.Consume, inOF_L2L1, 1)
+                        yield_([])
 
             # To/from AIE-array data movement
 
@@ -349,19 +341,32 @@ def edge_detect():
 
             @FuncOp.from_py_func(tensor_ty, memRef_16x16_ty, tensor_ty)
             def sequence(I, B, O):
-                ipu_dma_memcpy_nd(
-                    metadata="outOF_L2L3",
-                    bd_id=0,
-                    mem=O,
-                    sizes=[1, 1, 1, tensorSizeInInt32s],
-                )
-                ipu_dma_memcpy_nd(
-                    metadata="inOF_L3L2",
-                    bd_id=1,
-                    mem=I,
-                    sizes=[1, 1, 1, tensorSizeInInt32s],
-                )
-                ipu_sync(column=0, row=0, direction=0, channel=0)
+                for col, (stripeStart, stripeLines) in enumerate(stripes()):
+                    haloTop = 1 if stripeStart > 0 else 0
+                    haloBottom = 1 if stripeStart + stripeLines < height else 0
+                    ipu_dma_memcpy_nd(
+                        metadata=f"outOF_L2L3_{col}",
+                        bd_id=0,
+                        mem=O,
+                        offsets=[0, 0, 0, stripeStart * lineWidthInInt32s],
+                        sizes=[1, 1, 1, stripeLines * lineWidthInInt32s],
+                    )
+                    # The halo lines overlap the stripes of the neighbours.
+                    inLines = haloTop + stripeLines + haloBottom
+                    ipu_dma_memcpy_nd(
+                        metadata=f"inOF_L3L2_{col}",
+                        bd_id=1,
+                        mem=I,
+                        offsets=[
+                            0,
+                            0,
+                            0,
+                            (stripeStart - haloTop) * lineWidthInInt32s,
+                        ],
+                        sizes=[1, 1, 1, inLines * lineWidthInInt32s],
+                    )
+                for col in range(columns):
+                    ipu_sync(column=col, row=0, direction=0, channel=0)
 
     #    print(ctx.module.operation.verify())
     print(ctx.module)
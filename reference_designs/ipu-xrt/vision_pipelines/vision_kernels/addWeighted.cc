@@ -41,6 +41,8 @@ void addweighted_aie_scalar(const T *in1, const T *in2, T *out,
     }
 }
 
+// Each iteration loads 2 * N samples of each input, and accumulates them in
+// two halves of N lanes, the widest accumulation of T with 16-bit weights.
 template <typename T, int N, int MAX>
 void addweighted_aie(const T *src1, const T *src2, T *dst, const int32_t width,
                      const int32_t height, const int16_t alphaFixedPoint,
@@ -50,26 +52,31 @@ void addweighted_aie(const T *src1, const T *src2, T *dst, const int32_t width,
       aie::saturation_mode::saturate); // Needed to saturate properly to uint8
 
   ::aie::vector<int16_t, N> coeff(alphaFixedPoint, betaFixedPoint);
-  ::aie::vector<T, N> gamma_coeff;
+  ::aie::vector<T, N> gamma_coeff = ::aie::broadcast<T, N>(gamma);
   ::aie::accum<acc32, N> gamma_acc;
-  for (int i = 0; i < N; i++) {
-    gamma_coeff[i] = gamma;
-  }
   gamma_acc.template from_vector(gamma_coeff, 0);
-  for (int j = 0; j < width * height; j += N) // 16 samples per loop
+  event0();
+  for (int j = 0; j < width * height; j += 2 * N) // 2 * N samples per loop
     chess_prepare_for_pipelining chess_loop_range(
         14, ) // loop_range(14) - loop : 1 cycle
     {
-      ::aie::vector<T, N> data_buf1 = ::aie::load_v<N>(src1);
-      src1 += N;
-      ::aie::vector<T, N> data_buf2 = ::aie::load_v<N>(src2);
-      src2 += N;
-      ::aie::accum<acc32, N> acc = ::aie::accumulate<N>(
-          gamma_acc, coeff, 0, data_buf1,
-          data_buf2); // weight[0] * data_buf1 + weight[1] * data_buf2
-      ::aie::store_v(dst, acc.template to_vector<T>(SRS_SHIFT));
-      dst += N;
+      ::aie::vector<T, 2 * N> data_buf1 = ::aie::load_v<2 * N>(src1);
+      src1 += 2 * N;
+      ::aie::vector<T, 2 * N> data_buf2 = ::aie::load_v<2 * N>(src2);
+      src2 += 2 * N;
+      // weight[0] * data_buf1 + weight[1] * data_buf2
+      ::aie::accum<acc32, N> acc_lo = ::aie::accumulate<N>(
+          gamma_acc, coeff, 0, data_buf1.template extract<N>(0),
+          data_buf2.template extract<N>(0));
+      ::aie::accum<acc32, N> acc_hi = ::aie::accumulate<N>(
+          gamma_acc, coeff, 0, data_buf1.template extract<N>(1),
+          data_buf2.template extract<N>(1));
+      ::aie::store_v(dst,
+                     ::aie::concat(acc_lo.template to_vector<T>(SRS_SHIFT),
+                                   acc_hi.template to_vector<T>(SRS_SHIFT)));
+      dst += 2 * N;
     }
+  event1();
 }
 
 extern "C" {
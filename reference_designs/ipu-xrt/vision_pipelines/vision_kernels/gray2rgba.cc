@@ -19,38 +19,33 @@
 
 #include <aie_api/aie.hpp>
 
-::aie::vector<uint8, 64> vector_broadcast(::aie::vector<uint8, 16> e) {
-  v64uint8 lli = e.template grow<64>();
-  lli = shuffle(lli, lli, T8_2x64_lo);
-  lli = shuffle(lli, lli, T8_2x64_lo);
-  return ::aie::vector<uint8, 64>(lli);
-}
-
 void gray2rgba_aie(uint8_t *y_in, uint8_t *rgba_out, const int32_t height,
                    const int32_t width) {
-  // Initialize alpha vector
-  ::aie::vector<uint8, 64> alpha255 = ::aie::zeros<uint8, 64>();
-  for (int i = 0; i < 16; i++) {
-    alpha255[i * 4 + 3] = 255;
-  }
-
-  for (int i = 0; i < height; i++)
-    for (int j = 0; j < width; j += 16) {
-      ::aie::vector<uint8, 16> data_buf = ::aie::load_v<16>(y_in);
-      y_in += 16;
-
-      // vector shuffle
-      ::aie::vector<uint8, 64> out = vector_broadcast(data_buf);
-
-      // bitwise OR with alpha value
-      v64uint8 fout = bor(out, alpha255);
-
-      ::aie::store_v(rgba_out, ::aie::vector<uint8, 64>(fout));
+  ::aie::vector<uint8, 64> alpha255 = ::aie::broadcast<uint8, 64>(255);
+
+  event0();
+  for (int j = 0; j < width * height; j += 64)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      ::aie::vector<uint8, 64> data_buf = ::aie::load_v<64>(y_in);
+      y_in += 64;
+
+      // Zip the gray values with themselves and with the alpha value into
+      // pairs, then the two sets of pairs into pixels
+      auto [gg_lo, gg_hi] = ::aie::interleave_zip(data_buf, data_buf, 1);
+      auto [ga_lo, ga_hi] = ::aie::interleave_zip(data_buf, alpha255, 1);
+      auto [out0, out1] = ::aie::interleave_zip(gg_lo, ga_lo, 2);
+      auto [out2, out3] = ::aie::interleave_zip(gg_hi, ga_hi, 2);
+
+      ::aie::store_v(rgba_out, out0);
+      rgba_out += 64;
+      ::aie::store_v(rgba_out, out1);
+      rgba_out += 64;
+      ::aie::store_v(rgba_out, out2);
+      rgba_out += 64;
+      ::aie::store_v(rgba_out, out3);
       rgba_out += 64;
     }
-
-  return;
-  ;
+  event1();
 }
 
 void gray2rgba_aie_scalar(uint8_t *y_in, uint8_t *rgba_out,
@@ -20,28 +20,33 @@
 #include <aie_api/aie.hpp>
 
 const int32_t SRS_SHIFT = 15;
+// Deinterleave the channels of 64 RGBA pixels.
 __attribute__((inline)) void xf_extract_rgb(uint8_t *ptr_rgba,
-                                            ::aie::vector<uint8_t, 32> &r,
-                                            ::aie::vector<uint8_t, 32> &g,
-                                            ::aie::vector<uint8_t, 32> &b) {
-  ::aie::vector<uint8_t, 32> rgba_channel0, rgba_channel1, rgba_channel3,
+                                            ::aie::vector<uint8_t, 64> &r,
+                                            ::aie::vector<uint8_t, 64> &g,
+                                            ::aie::vector<uint8_t, 64> &b) {
+  ::aie::vector<uint8_t, 64> rgba_channel0, rgba_channel1, rgba_channel3,
       rgba_channel2;
-  rgba_channel0 = ::aie::load_v<32>(ptr_rgba);
-  ptr_rgba += 32;
-  rgba_channel1 = ::aie::load_v<32>(ptr_rgba);
-  ptr_rgba += 32;
-  rgba_channel2 = ::aie::load_v<32>(ptr_rgba);
-  ptr_rgba += 32;
-  rgba_channel3 = ::aie::load_v<32>(ptr_rgba);
-  ptr_rgba += 32;
-
-  // Unzip the interleaved channels
-  auto [rg_temp, ba_temp] =
-      ::aie::interleave_unzip(::aie::concat(rgba_channel0, rgba_channel1),
-                              ::aie::concat(rgba_channel2, rgba_channel3), 2);
-  r = ::aie::filter_even(rg_temp, 1);
-  g = ::aie::filter_odd(rg_temp, 1);
-  b = ::aie::filter_even(ba_temp, 1);
+  rgba_channel0 = ::aie::load_v<64>(ptr_rgba);
+  ptr_rgba += 64;
+  rgba_channel1 = ::aie::load_v<64>(ptr_rgba);
+  ptr_rgba += 64;
+  rgba_channel2 = ::aie::load_v<64>(ptr_rgba);
+  ptr_rgba += 64;
+  rgba_channel3 = ::aie::load_v<64>(ptr_rgba);
+  ptr_rgba += 64;
+
+  // Unzip the interleaved channels, first into RG and BA pairs and then into
+  // single channels
+  auto [rg_lo, ba_lo] =
+      ::aie::interleave_unzip(rgba_channel0, rgba_channel1, 2);
+  auto [rg_hi, ba_hi] =
+      ::aie::interleave_unzip(rgba_channel2, rgba_channel3, 2);
+  auto [r_tmp, g_tmp] = ::aie::interleave_unzip(rg_lo, rg_hi, 1);
+  auto [b_tmp, a_tmp] = ::aie::interleave_unzip(ba_lo, ba_hi, 1);
+  r = r_tmp;
+  g = g_tmp;
+  b = b_tmp;
 }
 
 __attribute__((noinline)) void rgba2gray_aie(uint8_t *rgba_in, uint8_t *y_out,
@@ -56,21 +61,28 @@ __attribute__((noinline)) void rgba2gray_aie(uint8_t *rgba_in, uint8_t *y_out,
       (int16_t)round(0.114 * (1 << SRS_SHIFT)),
       (1 << (SRS_SHIFT - 1))); // Y=0.299*R + 0.587*G + 0.114*B (BT.470)
   ::aie::vector<uint8_t, 32> c1 = ::aie::broadcast<uint8_t, 32>(1);
-  ::aie::vector<uint8_t, 32> r, g, b;
-  ::aie::vector<uint8_t, 32> y;
+  ::aie::vector<uint8_t, 64> r, g, b;
+  ::aie::vector<uint8_t, 64> y;
 
-  for (int j = 0; (j < (width * height) / 32); j += 1)
+  event0();
+  for (int j = 0; (j < (width * height) / 64); j += 1)
     chess_prepare_for_pipelining {
       xf_extract_rgb(rgba_in, r, g, b);
 
-      ::aie::accum<acc32, 32> acc;
-      acc = ::aie::accumulate<32>(WT, 0, r, g, b, c1);
-      y = acc.template to_vector<uint8_t>(SRS_SHIFT);
+      // The uint8 * int16 multiply produces 32 lanes
+      ::aie::accum<acc32, 32> acc_lo, acc_hi;
+      acc_lo = ::aie::accumulate<32>(WT, 0, r.extract<32>(0), g.extract<32>(0),
+                                     b.extract<32>(0), c1);
+      acc_hi = ::aie::accumulate<32>(WT, 0, r.extract<32>(1), g.extract<32>(1),
+                                     b.extract<32>(1), c1);
+      y = ::aie::concat(acc_lo.template to_vector<uint8_t>(SRS_SHIFT),
+                        acc_hi.template to_vector<uint8_t>(SRS_SHIFT));
 
       ::aie::store_v(y_out, y);
-      rgba_in += 128;
-      y_out += 32;
+      rgba_in += 256;
+      y_out += 64;
     }
+  event1();
 }
 
 void rgba2gray_aie_scalar(uint8_t *rgba_in, uint8_t *y_out,
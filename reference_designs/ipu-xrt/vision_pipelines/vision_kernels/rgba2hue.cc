@@ -24,33 +24,38 @@
 
 const int32_t SRS_SHIFT = 12;
 
+// Deinterleave the channels of 64 RGBA pixels.
 __attribute__((inline)) void xf_extract_rgb(uint8_t *ptr_rgba,
-                                            ::aie::vector<uint8_t, 32> &r,
-                                            ::aie::vector<uint8_t, 32> &g,
-                                            ::aie::vector<uint8_t, 32> &b) {
-  ::aie::vector<uint8_t, 32> rgba_channel0, rgba_channel1, rgba_channel3,
+                                            ::aie::vector<uint8_t, 64> &r,
+                                            ::aie::vector<uint8_t, 64> &g,
+                                            ::aie::vector<uint8_t, 64> &b) {
+  ::aie::vector<uint8_t, 64> rgba_channel0, rgba_channel1, rgba_channel3,
       rgba_channel2;
-  rgba_channel0 = ::aie::load_v<32>(ptr_rgba);
-  ptr_rgba += 32;
-  rgba_channel1 = ::aie::load_v<32>(ptr_rgba);
-  ptr_rgba += 32;
-  rgba_channel2 = ::aie::load_v<32>(ptr_rgba);
-  ptr_rgba += 32;
-  rgba_channel3 = ::aie::load_v<32>(ptr_rgba);
-  ptr_rgba += 32;
-
-  // Unzip the interleaved channels
-  auto [rg_temp, ba_temp] =
-      ::aie::interleave_unzip(::aie::concat(rgba_channel0, rgba_channel1),
-                              ::aie::concat(rgba_channel2, rgba_channel3), 2);
-  r = ::aie::filter_even(rg_temp, 1);
-  g = ::aie::filter_odd(rg_temp, 1);
-  b = ::aie::filter_even(ba_temp, 1);
+  rgba_channel0 = ::aie::load_v<64>(ptr_rgba);
+  ptr_rgba += 64;
+  rgba_channel1 = ::aie::load_v<64>(ptr_rgba);
+  ptr_rgba += 64;
+  rgba_channel2 = ::aie::load_v<64>(ptr_rgba);
+  ptr_rgba += 64;
+  rgba_channel3 = ::aie::load_v<64>(ptr_rgba);
+  ptr_rgba += 64;
+
+  // Unzip the interleaved channels, first into RG and BA pairs and then into
+  // single channels
+  auto [rg_lo, ba_lo] =
+      ::aie::interleave_unzip(rgba_channel0, rgba_channel1, 2);
+  auto [rg_hi, ba_hi] =
+      ::aie::interleave_unzip(rgba_channel2, rgba_channel3, 2);
+  auto [r_tmp, g_tmp] = ::aie::interleave_unzip(rg_lo, rg_hi, 1);
+  auto [b_tmp, a_tmp] = ::aie::interleave_unzip(ba_lo, ba_hi, 1);
+  r = r_tmp;
+  g = g_tmp;
+  b = b_tmp;
 }
 
 __attribute__((inline)) void
-comp_divisor_16b(::aie::vector<uint8_t, 32> divisor,
-                 ::aie::vector<uint16_t, 32> &divisor_select) {
+comp_divisor_16b(::aie::vector<uint8_t, 64> divisor,
+                 ::aie::vector<uint16_t, 64> &divisor_select) {
   const int step = 0;
   using lut_type_uint16 = aie::lut<4, uint16, uint16>;
   lut_type_uint16 inv_lut_16b(num_entries_lut_inv_16b, lut_inv_16b_ab,
@@ -58,35 +63,52 @@ comp_divisor_16b(::aie::vector<uint8_t, 32> divisor,
   aie::parallel_lookup<uint8, lut_type_uint16, aie::lut_oor_policy::truncate>
       lookup_inv_16b(inv_lut_16b, step);
 
-  aie::vector<uint8, 16> input1, input2;
-  aie::vector<uint16, 16> res1, res2;
-  input1 = divisor.extract<16>(0);
-  input2 = divisor.extract<16>(1);
-  res1 = lookup_inv_16b.fetch(input1.cast_to<uint8>());
-  res2 = lookup_inv_16b.fetch(input2.cast_to<uint8>());
-  divisor_select = aie::concat(res1, res2);
+  aie::vector<uint16, 16> res0, res1, res2, res3;
+  res0 = lookup_inv_16b.fetch(divisor.extract<16>(0).cast_to<uint8>());
+  res1 = lookup_inv_16b.fetch(divisor.extract<16>(1).cast_to<uint8>());
+  res2 = lookup_inv_16b.fetch(divisor.extract<16>(2).cast_to<uint8>());
+  res3 = lookup_inv_16b.fetch(divisor.extract<16>(3).cast_to<uint8>());
+  divisor_select = aie::concat(res0, res1, res2, res3);
+}
+
+// Compute offset + (x - y) / divisor for 64 pixels, as two halves of 32 since
+// the uint8 * uint16 multiply produces 32 lanes.
+__attribute__((inline)) ::aie::vector<uint8_t, 64>
+hue_partial(::aie::vector<int16_t, 32> offset, ::aie::vector<uint8_t, 64> x,
+            ::aie::vector<uint8_t, 64> y,
+            ::aie::vector<uint16_t, 64> divisor_sel) {
+  // Initialize accum with value since 340 is larger than uint8
+  aie::accum<acc32, 32> lo(offset, 9);
+  aie::accum<acc32, 32> hi(offset, 9);
+
+  // Performa uin8*int16 vector multiply
+  lo = aie::mac(lo, x.extract<32>(0), divisor_sel.extract<32>(0));
+  hi = aie::mac(hi, x.extract<32>(1), divisor_sel.extract<32>(1));
+  lo = aie::msc(lo, y.extract<32>(0), divisor_sel.extract<32>(0));
+  hi = aie::msc(hi, y.extract<32>(1), divisor_sel.extract<32>(1));
+
+  // Q7.9 shift + 1 (div 2)
+  return aie::concat(lo.to_vector<uint8>(10), hi.to_vector<uint8>(10));
 }
 
 __attribute__((noinline)) void rgba2hue_aie(uint8_t *rgba_in, uint8_t *hue_out,
                                             const int32_t height,
                                             const int32_t width) {
-  ::aie::vector<uint8_t, 32> r, g, b;
-  ::aie::vector<uint8_t, 32> hue;
+  ::aie::vector<uint8_t, 64> r, g, b;
+  ::aie::vector<uint8_t, 64> hue;
 
-  ::aie::vector<uint8_t, 32> rgbMin, rgbMax;
+  ::aie::vector<uint8_t, 64> rgbMin, rgbMax;
 
-  ::aie::vector<uint8_t, 32> zero32 = aie::zeros<uint8_t, 32>();
+  ::aie::vector<uint8_t, 64> zero64 = aie::zeros<uint8_t, 64>();
 
-  ::aie::vector<int16_t, 32> eightFive = aie::zeros<int16_t, 32>();
-  eightFive[0] = 85;
-  eightFive[1] = -85;
   ::aie::vector<int16_t, 32> one = aie::broadcast<int16_t, 32>(1);
   ::aie::vector<int16_t, 32> twoEightFive =
       aie::broadcast<int16_t, 32>(171); // 170 + 1
   ::aie::vector<int16_t, 32> fourEightFive =
       aie::broadcast<int16_t, 32>(341); // 340 + 1
 
-  for (int j = 0; (j < (width * height) / 32); j += 1)
+  event0();
+  for (int j = 0; (j < (width * height) / 64); j += 1)
     chess_prepare_for_pipelining {
       xf_extract_rgb(rgba_in, r, g, b);
 
@@ -96,38 +118,25 @@ __attribute__((noinline)) void rgba2hue_aie(uint8_t *rgba_in, uint8_t *hue_out,
 
       // Get divisor and select the fixed point divisor to multiply by
       auto divisor = ::aie::sub(rgbMax, rgbMin);
-      ::aie::vector<uint16, 32> divisor_sel;
+      ::aie::vector<uint16, 64> divisor_sel;
       comp_divisor_16b(divisor, divisor_sel);
 
-      // Initialize accum with value since 340 is larger than uint8
-      aie::accum<acc32, 32> hr_partial(one, 9);
-      aie::accum<acc32, 32> hg_partial(twoEightFive, 9);
-      aie::accum<acc32, 32> hb_partial(fourEightFive, 9);
-
-      // Performa uin8*int16 vector multiply
-      hr_partial = aie::mac(hr_partial, g, divisor_sel);
-      hg_partial = aie::mac(hg_partial, b, divisor_sel);
-      hb_partial = aie::mac(hb_partial, r, divisor_sel);
-
-      hr_partial = aie::msc(hr_partial, b, divisor_sel);
-      hg_partial = aie::msc(hg_partial, r, divisor_sel);
-      hb_partial = aie::msc(hb_partial, g, divisor_sel);
-
-      auto hr = hr_partial.to_vector<uint8>(10); // Q7.9 shift + 1 (div 2)
-      auto hg = hg_partial.to_vector<uint8>(10); // Q7.9 shift + 1 (div 2)
-      auto hb = hb_partial.to_vector<uint8>(10); // Q7.9 shift + 1 (div 2)
+      auto hr = hue_partial(one, g, b, divisor_sel);
+      auto hg = hue_partial(twoEightFive, b, r, divisor_sel);
+      auto hb = hue_partial(fourEightFive, r, g, divisor_sel);
 
-      aie::mask<32> sel1 = aie::eq(rgbMax, r);
+      aie::mask<64> sel1 = aie::eq(rgbMax, r);
       auto tmp1 = aie::select(hb, hr, sel1);
-      aie::mask<32> sel2 = aie::eq(rgbMax, g);
+      aie::mask<64> sel2 = aie::eq(rgbMax, g);
       auto tmp2 = aie::select(tmp1, hg, sel2);
-      aie::mask<32> sel3 = aie::eq(divisor, zero32);
-      hue = aie::select(tmp2, zero32, sel3);
+      aie::mask<64> sel3 = aie::eq(divisor, zero64);
+      hue = aie::select(tmp2, zero64, sel3);
 
       ::aie::store_v(hue_out, hue);
-      rgba_in += 128;
-      hue_out += 32;
+      rgba_in += 256;
+      hue_out += 64;
     }
+  event1();
 }
 
 void rgba2hue_aie_scalar(uint8_t *rgba_in, uint8_t *hue_out,
@@ -175,7 +184,7 @@ void rgba2hueLine(uint8_t *in, uint8_t *out, int32_t lineWidth) {
 
 void rgba2hueTile(uint8_t *in, uint8_t *out, int32_t tileHeight,
                   int32_t tileWidth) {
-  rgba2hue_aie_scalar(in, out, tileHeight, tileWidth);
+  rgba2hue_aie(in, out, tileHeight, tileWidth);
 }
 
 } // extern "C"
@@ -43,6 +43,7 @@ threshold_aie(T *img_in, T *img_out, const int32_t img_width,
   constants[1] = thresh_val; // updating constant threshold value
   constants[2] = max_val;    // updating constant max_val value
 
+  event0();
   switch (thresholdType) {
   case XF_THRESHOLD_TYPE_TRUNC:
     for (int j = 0; j < (img_height * img_width);
@@ -120,6 +121,7 @@ threshold_aie(T *img_in, T *img_out, const int32_t img_width,
         img_out += N;
       }
   }
+  event1();
 }
 
 template <typename T, int N>
@@ -149,6 +151,7 @@ __attribute__((noinline)) void threshold4Ch_aie(
     mask_max[i * 4 + 3] = max_val4;
   }
 
+  event0();
   switch (thresholdType) {
   case XF_THRESHOLD_TYPE_TRUNC:
     for (int j = 0; j < (img_height * img_width);
@@ -226,6 +229,7 @@ __attribute__((noinline)) void threshold4Ch_aie(
         img_out += N;
       }
   }
+  event1();
 }
 
 extern "C" {
@@ -0,0 +1,109 @@
+//===- thresholdGray2rgbaAddWeighted.cc -------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The threshold -> gray2rgba -> addWeighted tail of the edge detect pipeline,
+// fused into one pass over the line: the thresholded gray and RGBA pixels stay
+// in vector registers instead of going through two intermediate lines.
+
+#define NOCPP
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define REL_WRITE 0
+#define REL_READ 1
+
+#include <aie_api/aie.hpp>
+
+const int32_t SRS_SHIFT = 14;
+
+// Blend 64 RGBA pixels, in two halves of 32 since the uint8 * int16 multiply
+// produces 32 lanes.
+__attribute__((inline)) ::aie::vector<uint8_t, 64>
+add_weighted(::aie::vector<uint8_t, 64> in1, ::aie::vector<uint8_t, 64> in2,
+             ::aie::vector<int16_t, 32> coeff,
+             ::aie::accum<acc32, 32> gamma_acc) {
+  ::aie::accum<acc32, 32> acc_lo = ::aie::accumulate<32>(
+      gamma_acc, coeff, 0, in1.extract<32>(0), in2.extract<32>(0));
+  ::aie::accum<acc32, 32> acc_hi = ::aie::accumulate<32>(
+      gamma_acc, coeff, 0, in1.extract<32>(1), in2.extract<32>(1));
+  return ::aie::concat(acc_lo.template to_vector<uint8_t>(SRS_SHIFT),
+                       acc_hi.template to_vector<uint8_t>(SRS_SHIFT));
+}
+
+// Binary threshold of the gray line, expanded to RGBA and blended with the
+// RGBA line: rgba_out = alpha * rgba(gray_in > thresh ? max : 0) +
+// beta * rgba_in + gamma.
+__attribute__((noinline)) void threshold_gray2rgba_addweighted_aie(
+    const uint8_t *gray_in, const uint8_t *rgba_in, uint8_t *rgba_out,
+    const int32_t width, const int32_t height, const uint8_t thresh_val,
+    const uint8_t max_val, const int16_t alphaFixedPoint,
+    const int16_t betaFixedPoint, const uint8_t gamma) {
+  ::aie::set_saturation(
+      aie::saturation_mode::saturate); // Needed to saturate properly to uint8
+
+  ::aie::vector<uint8_t, 64> zeros = ::aie::zeros<uint8_t, 64>();
+  ::aie::vector<uint8_t, 64> max = ::aie::broadcast<uint8_t, 64>(max_val);
+  ::aie::vector<uint8_t, 64> alpha255 = ::aie::broadcast<uint8_t, 64>(255);
+  ::aie::vector<int16_t, 32> coeff(alphaFixedPoint, betaFixedPoint);
+  ::aie::accum<acc32, 32> gamma_acc;
+  gamma_acc.from_vector(::aie::broadcast<uint8_t, 32>(gamma), 0);
+
+  event0();
+  for (int j = 0; j < width * height; j += 64)
+    chess_prepare_for_pipelining chess_loop_range(1, ) {
+      ::aie::vector<uint8_t, 64> gray = ::aie::load_v<64>(gray_in);
+      gray_in += 64;
+
+      // threshold
+      ::aie::mask<64> above = ::aie::lt(thresh_val, gray);
+      ::aie::vector<uint8_t, 64> binary = ::aie::select(zeros, max, above);
+
+      // gray2rgba
+      auto [gg_lo, gg_hi] = ::aie::interleave_zip(binary, binary, 1);
+      auto [ga_lo, ga_hi] = ::aie::interleave_zip(binary, alpha255, 1);
+      auto [rgba0, rgba1] = ::aie::interleave_zip(gg_lo, ga_lo, 2);
+      auto [rgba2, rgba3] = ::aie::interleave_zip(gg_hi, ga_hi, 2);
+
+      // addWeighted
+      ::aie::store_v(rgba_out, add_weighted(rgba0, ::aie::load_v<64>(rgba_in),
+                                            coeff, gamma_acc));
+      rgba_in += 64;
+      rgba_out += 64;
+      ::aie::store_v(rgba_out, add_weighted(rgba1, ::aie::load_v<64>(rgba_in),
+                                            coeff, gamma_acc));
+      rgba_in += 64;
+      rgba_out += 64;
+      ::aie::store_v(rgba_out, add_weighted(rgba2, ::aie::load_v<64>(rgba_in),
+                                            coeff, gamma_acc));
+      rgba_in += 64;
+      rgba_out += 64;
+      ::aie::store_v(rgba_out, add_weighted(rgba3, ::aie::load_v<64>(rgba_in),
+                                            coeff, gamma_acc));
+      rgba_in += 64;
+      rgba_out += 64;
+    }
+  event1();
+}
+
+extern "C" {
+
+void thresholdGray2rgbaAddWeightedLine(uint8_t *grayIn, uint8_t *rgbaIn,
+                                       uint8_t *rgbaOut, int32_t lineWidth,
+                                       uint8_t thresholdValue, uint8_t maxValue,
+                                       int16_t alpha, int16_t beta,
+                                       uint8_t gamma) {
+  threshold_gray2rgba_addweighted_aie(grayIn, rgbaIn, rgbaOut, lineWidth, 1,
+                                      thresholdValue, maxValue, alpha, beta,
+                                      gamma);
+}
+
+} // extern "C"
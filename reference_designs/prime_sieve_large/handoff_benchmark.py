@@ -0,0 +1,227 @@
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 Advanced Micro Devices, Inc.
+
+# Generates the lock handoff latency benchmark: the chain of cores of the prime
+# sieve, each passing a token to the next one through their shared memory as
+# soon as it gets it. It writes aie.mlir and chain.h, the tiles of the chain
+# read by handoff_test.cpp to report the cycles of each handoff.
+
+import argparse
+import os
+
+# The rows of cores of each device, and its lock semantics.
+DEVICES = {
+    "binary": ("xcvc1902", range(1, 9)),
+    "semaphore": ("xcve2802", range(3, 11)),
+}
+MAX_COLUMNS = 50 - 1
+
+
+def chain_tiles(length, startcol, rows):
+    # Snake up and down the columns like the prime sieve, so that each core
+    # shares a memory with the next one.
+    tiles = []
+    col = startcol
+    while len(tiles) < length:
+        column = rows if (col - startcol) % 2 == 0 else reversed(rows)
+        tiles += [(col, row) for row in column]
+        col += 1
+    return tiles[:length]
+
+
+def shared_tile(src, dst, locks):
+    # The tile of the memory both cores of a hop can access. Going up or down a
+    # column, the cores access each other's memory. Going east, the memory of
+    # the west core is shared on AIE2 and on the odd rows of AIE1, that of the
+    # east core on the even rows of AIE1.
+    if src[0] == dst[0]:
+        return src
+    if locks == "binary" and src[1] % 2 == 0:
+        return dst
+    return src
+
+
+class Handoff:
+    # Emits the declarations, acquires and releases of the handoff of a token
+    # between two cores, either with raw locks or with a depth 1 objectFifo.
+    def __init__(self, f, name, locks, objectfifo):
+        self.f = f
+        self.name = name
+        self.locks = locks
+        self.objectfifo = objectfifo
+
+    def declare(self, src, dst):
+        col, row = shared_tile(src, dst, self.locks)
+        if self.objectfifo:
+            self.f.write(
+                "    aie.objectfifo @%s (%%tile_%d_%d, {%%tile_%d_%d}, 1 : i32)"
+                " : !aie.objectfifo<memref<1xi32>>\n" % ((self.name,) + src + dst)
+            )
+            return
+        self.f.write(
+            '    %%%s = aie.buffer(%%tile_%d_%d) { sym_name = "%s" }'
+            " : memref<1xi32>\n" % (self.name, col, row, self.name)
+        )
+        self.declare_lock(col, row, "prod", 1)
+        self.declare_lock(col, row, "cons", 0)
+
+    def declare_lock(self, col, row, kind, init):
+        if self.locks == "binary" and kind == "prod":
+            return
+        name = "%s_%s_lock" % (self.name, kind)
+        init = "init = %d : i32, " % init if self.locks == "semaphore" else ""
+        self.f.write(
+            '    %%%s = aie.lock(%%tile_%d_%d) { %ssym_name = "%s" }\n'
+            % (name, col, row, init, name)
+        )
+
+    def use(self, port, action):
+        # Returns the memref of the token on an acquire.
+        if self.objectfifo:
+            return self.use_objectfifo(port, action)
+        if self.locks == "binary":
+            # A single lock per hop, set while it holds the token.
+            value = 1 if (port == "Consume") == (action == "Acquire") else 0
+            self.f.write(
+                "      aie.use_lock(%%%s_cons_lock, %s, %d)\n"
+                % (self.name, action, value)
+            )
+        else:
+            mine = "prod" if port == "Produce" else "cons"
+            theirs = "cons" if port == "Produce" else "prod"
+            if action == "Acquire":
+                self.f.write(
+                    "      aie.use_lock(%%%s_%s_lock, AcquireGreaterEqual, 1)\n"
+                    % (self.name, mine)
+                )
+            else:
+                self.f.write(
+                    "      aie.use_lock(%%%s_%s_lock, Release, 1)\n"
+                    % (self.name, theirs)
+                )
+        return "%" + self.name
+
+    def use_objectfifo(self, port, action):
+        subview = "!aie.objectfifosubview<memref<1xi32>>"
+        if action == "Release":
+            self.f.write(
+                "      aie.objectfifo.release @%s (%s, 1)\n" % (self.name, port)
+            )
+            return None
+        view = "%%%s_%s" % (self.name, port.lower())
+        self.f.write(
+            "      %s_view = aie.objectfifo.acquire @%s (%s, 1) : %s\n"
+            % (view, self.name, port, subview)
+        )
+        self.f.write(
+            "      %s = aie.objectfifo.subview.access %s_view[0] : %s"
+            " -> memref<1xi32>\n" % (view, view, subview)
+        )
+        return view
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Generate the lock handoff latency benchmark"
+    )
+    parser.add_argument(
+        "--length", type=int, default=16, help="number of cores of the chain"
+    )
+    parser.add_argument(
+        "--locks",
+        choices=DEVICES.keys(),
+        default="binary",
+        help="binary locks of AIE1 (xcvc1902) or semaphore locks of AIE2 "
+        "(xcve2802)",
+    )
+    parser.add_argument(
+        "--objectfifo",
+        action="store_true",
+        help="hand the tokens off through objectFifos instead of raw locks",
+    )
+    parser.add_argument("--startcol", type=int, default=1)
+    parser.add_argument("-o", "--output", default=".", help="output directory")
+    args = parser.parse_args()
+
+    device, rows = DEVICES[args.locks]
+    columns = MAX_COLUMNS - args.startcol + 1
+    if not 2 <= args.length <= columns * len(rows):
+        parser.error("the chain must have 2 to %d cores" % (columns * len(rows)))
+    tiles = chain_tiles(args.length, args.startcol, rows)
+
+    with open(os.path.join(args.output, "chain.h"), "w") as f:
+        f.write("// Generated by handoff_benchmark.py.\n")
+        f.write("#define CHAIN_LENGTH %d\n" % len(tiles))
+        f.write(
+            "static const int chain[CHAIN_LENGTH][2] = {%s};\n"
+            % ", ".join("{%d, %d}" % tile for tile in tiles)
+        )
+
+    f = open(os.path.join(args.output, "aie.mlir"), "w")
+    f.write(
+        "// Generated by handoff_benchmark.py --length %d --locks %s%s\n\n"
+        % (args.length, args.locks, " --objectfifo" if args.objectfifo else "")
+    )
+    f.write("module @handoff_benchmark {\n")
+    f.write("  aie.device(%s) {\n" % device)
+    for col, row in tiles:
+        f.write("    %%tile_%d_%d = aie.tile(%d, %d)\n" % (col, row, col, row))
+    f.write("\n")
+
+    # The host starts the chain with start_cons_lock and waits on
+    # result_cons_lock for the token, so that both ends of the chain use raw
+    # locks in every variant.
+    first, last = tiles[0], tiles[-1]
+    start = Handoff(f, "start", args.locks, False)
+    start.declare_lock(first[0], first[1], "cons", 0)
+    done = Handoff(f, "result", args.locks, False)
+    f.write(
+        '    %%result = aie.buffer(%%tile_%d_%d) { sym_name = "result" }'
+        " : memref<1xi32>\n" % last
+    )
+    done.declare_lock(last[0], last[1], "prod", 1)
+    done.declare_lock(last[0], last[1], "cons", 0)
+    hops = [
+        Handoff(f, "hop%d" % i, args.locks, args.objectfifo)
+        for i in range(len(tiles) - 1)
+    ]
+    for i, hop in enumerate(hops):
+        hop.declare(tiles[i], tiles[i + 1])
+    f.write("\n")
+
+    for i, (col, row) in enumerate(tiles):
+        into = hops[i - 1] if i > 0 else None
+        out = hops[i] if i < len(hops) else done
+        f.write("    %%core_%d_%d = aie.core(%%tile_%d_%d) {\n" % ((col, row) * 2))
+        f.write("      %c0 = arith.constant 0 : index\n")
+        f.write("      %one = arith.constant 1 : i32\n")
+        token = "%one"
+        if into:
+            buf = into.use("Consume", "Acquire")
+            f.write("      %%token = memref.load %s[%%c0] : memref<1xi32>\n" % buf)
+            f.write("      %next = arith.addi %token, %one : i32\n")
+            token = "%next"
+        else:
+            # The broadcast of this event starts the counters of all the cores.
+            start.use("Consume", "Acquire")
+            f.write("      aie.event(0)\n")
+        buf = out.use("Produce", "Acquire")
+        f.write("      memref.store %s, %s[%%c0] : memref<1xi32>\n" % (token, buf))
+        if into:
+            into.use("Consume", "Release")
+        out.use("Produce", "Release")
+        # Stops the counter of the core once it has handed the token off.
+        f.write("      aie.event(1)\n")
+        f.write("      aie.end\n")
+        f.write("    }\n")
+    f.write("  }\n")
+    f.write("}\n")
+    f.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,103 @@
+//===- handoff_test.cpp -----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Host of the lock handoff benchmark generated by handoff_benchmark.py. The
+// first core of the chain broadcasts an event when the host starts it, which
+// starts a performance counter in every core. Each core stops its counter
+// once it has handed the token to the next one, so the difference between
+// the counters of two neighbours is the latency of their handoff.
+
+#include "test_library.h"
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <xaiengine.h>
+
+#include "aie_inc.cpp"
+#include "chain.h"
+
+int main(int argc, char *argv[]) {
+  int n = argc > 1 ? atoi(argv[1]) : 100;
+  static u32 hop_times[CHAIN_LENGTH][1000];
+  u32 chain_times[1000];
+  if (n < 1 || n > 1000) {
+    printf("usage: %s [runs from 1 to 1000]\n", argv[0]);
+    return -1;
+  }
+
+  printf("Lock handoff benchmark: %d cores, %d runs\n", CHAIN_LENGTH, n);
+
+  int errors = 0;
+  for (int iters = 0; iters < n; iters++) {
+    aie_libxaie_ctx_t *_xaie = mlir_aie_init_libxaie();
+    mlir_aie_init_device(_xaie);
+    mlir_aie_configure_cores(_xaie);
+    mlir_aie_configure_switchboxes(_xaie);
+    mlir_aie_initialize_locks(_xaie);
+    mlir_aie_configure_dmas(_xaie);
+
+    XAie_EventBroadcast(&(_xaie->DevInst),
+                        XAie_TileLoc(chain[0][0], chain[0][1]), XAIE_CORE_MOD,
+                        2, XAIE_EVENT_INSTR_EVENT_0_CORE);
+    EventMonitor *pcs[CHAIN_LENGTH];
+    for (int i = 0; i < CHAIN_LENGTH; i++) {
+      pcs[i] = new EventMonitor(_xaie, chain[i][0], chain[i][1], 0,
+                                XAIE_EVENT_BROADCAST_2_CORE,
+                                XAIE_EVENT_INSTR_EVENT_1_CORE,
+                                XAIE_EVENT_NONE_CORE, XAIE_CORE_MOD);
+      pcs[i]->set();
+    }
+
+    mlir_aie_start_cores(_xaie);
+    mlir_aie_release_start_cons_lock(_xaie, 1, 0);
+    if (mlir_aie_acquire_result_cons_lock(_xaie, 1, 100000) != XAIE_OK) {
+      printf("ERROR: timeout hit!\n");
+      errors++;
+    }
+    // The token is incremented by each core.
+    if (mlir_aie_read_buffer_result(_xaie, 0) != CHAIN_LENGTH) {
+      printf("ERROR: token %d != %d\n", mlir_aie_read_buffer_result(_xaie, 0),
+             CHAIN_LENGTH);
+      errors++;
+    }
+
+    u32 previous = 0;
+    for (int i = 0; i < CHAIN_LENGTH; i++) {
+      u32 done = pcs[i]->diff();
+      hop_times[i][iters] = done - previous;
+      previous = done;
+      delete pcs[i];
+    }
+    chain_times[iters] = previous;
+    mlir_aie_deinit_libxaie(_xaie);
+  }
+
+  // The first entry is the handoff of the first core from the broadcast, the
+  // others from the handoff of the previous core.
+  for (int i = 0; i < CHAIN_LENGTH; i++) {
+    printf("Core (%d, %d) ", chain[i][0], chain[i][1]);
+    computeStats(hop_times[i], n);
+  }
+  printf("Chain ");
+  computeStats(chain_times, n);
+
+  u64 total = 0;
+  for (int iters = 0; iters < n; iters++)
+    total += chain_times[iters] - hop_times[0][iters];
+  printf("Mean cycles per hop: %.1f\n",
+         (double)total / n / (CHAIN_LENGTH - 1));
+
+  if (!errors) {
+    printf("PASS!\n");
+    return 0;
+  }
+  printf("Fail!\n");
+  return -1;
+}
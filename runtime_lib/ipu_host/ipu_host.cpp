@@ -0,0 +1,263 @@
+//===- ipu_host.cpp ---------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ipu_host.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+
+namespace ipu_host {
+
+static std::vector<char> read_file(const std::string &path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file)
+    throw std::runtime_error("Unable to open instruction file " + path);
+  std::vector<char> contents(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  if (!file.read(contents.data(), contents.size()))
+    throw std::runtime_error("Unable to read instruction file " + path);
+  return contents;
+}
+
+std::vector<uint32_t> load_instr_binary(const std::string &path) {
+  std::vector<char> contents = read_file(path);
+  if (contents.size() % sizeof(uint32_t))
+    throw std::runtime_error("Instruction file " + path +
+                             " is not a sequence of 32-bit words");
+  std::vector<uint32_t> instr_v(contents.size() / sizeof(uint32_t));
+  std::memcpy(instr_v.data(), contents.data(), contents.size());
+  return instr_v;
+}
+
+std::vector<uint32_t> load_instr_text(const std::string &path) {
+  std::vector<char> contents = read_file(path);
+  contents.push_back('\0');
+  std::vector<uint32_t> instr_v;
+  // Each line holds 8 hexadecimal digits and a newline.
+  instr_v.reserve(contents.size() / 9);
+  const char *p = contents.data();
+  while (true) {
+    while (std::isspace(static_cast<unsigned char>(*p)))
+      p++;
+    if (!*p)
+      break;
+    char *end;
+    unsigned long word = std::strtoul(p, &end, 16);
+    if (end == p)
+      throw std::runtime_error("Unable to parse instruction file " + path);
+    instr_v.push_back(static_cast<uint32_t>(word));
+    p = end;
+  }
+  return instr_v;
+}
+
+std::vector<uint32_t> load_instr_sequence(const std::string &path) {
+  const std::string ext = ".bin";
+  if (path.size() >= ext.size() &&
+      path.compare(path.size() - ext.size(), ext.size(), ext) == 0)
+    return load_instr_binary(path);
+  return load_instr_text(path);
+}
+
+void run_stats::add(double us) {
+  min_us = runs ? std::min(min_us, us) : us;
+  max_us = runs ? std::max(max_us, us) : us;
+  total_us += us;
+  runs++;
+}
+
+ert_cmd_state run::wait(std::chrono::milliseconds timeout) {
+  ert_cmd_state state = xrtRun.wait(timeout);
+  if (state == ERT_CMD_STATE_TIMEOUT || finished)
+    return state;
+  auto end = std::chrono::steady_clock::now();
+  elapsed = std::chrono::duration<double, std::micro>(end - start).count();
+  finished = true;
+  if (state == ERT_CMD_STATE_COMPLETED) {
+    owner->runStats.add(elapsed);
+    for (xrt::bo &bo : buffers)
+      bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+  }
+  return state;
+}
+
+static xrt::uuid register_xclbin(xrt::device &device, xrt::xclbin &xclbin) {
+  device.register_xclbin(xclbin);
+  return xclbin.get_uuid();
+}
+
+static std::string find_kernel_name(xrt::xclbin &xclbin,
+                                    const std::string &prefix) {
+  for (xrt::xclbin::kernel &k : xclbin.get_kernels())
+    if (k.get_name().rfind(prefix, 0) == 0)
+      return k.get_name();
+  throw std::runtime_error("No kernel named " + prefix + " in the xclbin");
+}
+
+kernel::kernel(const std::string &xclbinPath, const std::string &kernelName,
+               const std::vector<uint32_t> &instrs, unsigned int deviceIndex)
+    : device(deviceIndex), xclbin(xclbinPath),
+      context(device, register_xclbin(device, xclbin)),
+      xrtKernel(context, find_kernel_name(xclbin, kernelName)),
+      instructions(device, instrs.size() * sizeof(uint32_t),
+                   XCL_BO_FLAGS_CACHEABLE, xrtKernel.group_id(0)),
+      numInstructions(instrs.size()) {
+  std::memcpy(instructions.map<void *>(), instrs.data(),
+              instrs.size() * sizeof(uint32_t));
+  instructions.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+}
+
+// Host memory in huge pages: the pages reserved by the system when some are
+// free, otherwise memory aligned to them and advised to be backed by
+// transparent huge pages.
+struct kernel::huge_page_memory {
+  static constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+
+  explicit huge_page_memory(size_t bytes)
+      : size((bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE) {
+    data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED) {
+      mapped = true;
+      return;
+    }
+    data = std::aligned_alloc(HUGE_PAGE_SIZE, size);
+    if (!data)
+      throw std::bad_alloc();
+    madvise(data, size, MADV_HUGEPAGE);
+  }
+  huge_page_memory(const huge_page_memory &) = delete;
+  huge_page_memory &operator=(const huge_page_memory &) = delete;
+  ~huge_page_memory() {
+    if (mapped)
+      munmap(data, size);
+    else
+      std::free(data);
+  }
+
+  void *data;
+  size_t size;
+  bool mapped = false;
+};
+
+// The buffers are released before the memory they map.
+kernel::~kernel() { freeBuffers.clear(); }
+
+xrt::bo kernel::allocate(size_t bytes, int arg, bool hugePages) {
+  auto &free = freeBuffers[std::make_tuple(bytes, arg, hugePages)];
+  if (!free.empty()) {
+    xrt::bo bo = free.back();
+    free.pop_back();
+    return bo;
+  }
+  auto group = xrtKernel.group_id(HOST_BUFFERS_START_IDX + arg);
+  if (!hugePages)
+    return xrt::bo(device, bytes, XRT_BO_FLAGS_HOST_ONLY, group);
+  auto memory = std::make_unique<huge_page_memory>(bytes);
+  xrt::bo bo(device, memory->data, bytes, group);
+  hugePageMemory[memory->data] = std::move(memory);
+  return bo;
+}
+
+void kernel::release(xrt::bo bo, int arg) {
+  bool hugePages = hugePageMemory.count(bo.map());
+  freeBuffers[std::make_tuple(bo.size(), arg, hugePages)].push_back(
+      std::move(bo));
+}
+
+run kernel::submit(std::vector<xrt::bo> buffers) {
+  for (xrt::bo &bo : buffers)
+    bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  xrt::run r(xrtKernel);
+  r.set_arg(0, instructions);
+  r.set_arg(1, numInstructions);
+  for (size_t i = 0; i < buffers.size(); i++)
+    r.set_arg(HOST_BUFFERS_START_IDX + i, buffers[i]);
+  r.start();
+  return run(*this, r, std::move(buffers));
+}
+
+ert_cmd_state kernel::call(std::vector<xrt::bo> buffers,
+                           std::chrono::milliseconds timeout) {
+  return submit(std::move(buffers)).wait(timeout);
+}
+
+double benchmark_result::percentile_us(double p) const {
+  if (latencies_us.empty())
+    return 0;
+  size_t rank = static_cast<size_t>(std::ceil(p / 100 * latencies_us.size()));
+  return latencies_us[std::min(std::max<size_t>(rank, 1),
+                               latencies_us.size()) -
+                      1];
+}
+
+double benchmark_result::mean_us() const {
+  if (latencies_us.empty())
+    return 0;
+  return std::accumulate(latencies_us.begin(), latencies_us.end(), 0.0) /
+         latencies_us.size();
+}
+
+benchmark_result benchmark(const std::function<void()> &fn, int warmup,
+                           int iterations) {
+  benchmark_result result;
+  result.warmup = warmup;
+  for (int i = 0; i < warmup; i++)
+    fn();
+  result.latencies_us.reserve(iterations);
+  for (int i = 0; i < iterations; i++) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    result.latencies_us.push_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
+  }
+  std::sort(result.latencies_us.begin(), result.latencies_us.end());
+  return result;
+}
+
+benchmark_result benchmark(kernel &k, const std::vector<xrt::bo> &buffers,
+                           int warmup, int iterations) {
+  return benchmark(
+      [&]() {
+        if (k.call(buffers) != ERT_CMD_STATE_COMPLETED)
+          throw std::runtime_error("Kernel failed during the benchmark");
+      },
+      warmup, iterations);
+}
+
+void print_benchmark_json(std::ostream &os, const std::string &name,
+                          const benchmark_result &result, double ops,
+                          double bytes) {
+  double mean = result.mean_us();
+  os << "{\"name\": \"" << name << "\", \"warmup\": " << result.warmup
+     << ", \"iterations\": " << result.latencies_us.size()
+     << ", \"min_us\": " << result.percentile_us(0)
+     << ", \"p50_us\": " << result.percentile_us(50)
+     << ", \"p99_us\": " << result.percentile_us(99)
+     << ", \"max_us\": " << result.percentile_us(100)
+     << ", \"mean_us\": " << mean;
+  if (ops && mean)
+    os << ", \"gops\": " << ops / mean / 1e3;
+  if (bytes && mean)
+    os << ", \"bytes_per_second\": " << bytes / mean * 1e6;
+  os << "}\n";
+}
+
+} // namespace ipu_host
@@ -0,0 +1,160 @@
+//===- ipu_host.h -----------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Host runtime for IPU designs built with aiecc.py --aie-generate-ipu. It
+// wraps the XRT setup shared by the hosts of the reference designs: loading
+// the xclbin and the instruction stream, allocating the buffer objects of the
+// kernel arguments, and running the kernel, with the time of each run
+// recorded.
+
+#ifndef IPU_HOST_H
+#define IPU_HOST_H
+
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ipu_host {
+
+// group_id 0 is for the ipu instructions and group_id 1 for their number; the
+// host buffers follow starting from position 2, see
+// aiecc.main.emit_design_kernel_json.
+constexpr int HOST_BUFFERS_START_IDX = 2;
+
+// Load an instruction stream: the binary stream of 32-bit little-endian
+// words for files ending in .bin, otherwise the text written by
+// aiecc.py --ipu-insts-name, with one hexadecimal word per line.
+std::vector<uint32_t> load_instr_sequence(const std::string &path);
+std::vector<uint32_t> load_instr_binary(const std::string &path);
+std::vector<uint32_t> load_instr_text(const std::string &path);
+
+// Statistics of the run times of a kernel, in microseconds.
+struct run_stats {
+  size_t runs = 0;
+  double total_us = 0;
+  double min_us = 0;
+  double max_us = 0;
+
+  double average_us() const { return runs ? total_us / runs : 0; }
+  void add(double us);
+};
+
+class kernel;
+
+// A run of the kernel started by kernel::submit. Waiting on it syncs its
+// buffers back from the device, and records its time, from its start until
+// the wait returns, in the statistics of the kernel.
+class run {
+public:
+  // Returns the state of the run, ERT_CMD_STATE_COMPLETED on success.
+  // A timeout of 0 waits forever.
+  ert_cmd_state wait(std::chrono::milliseconds timeout =
+                         std::chrono::milliseconds(0));
+  double elapsed_us() const { return elapsed; }
+
+private:
+  friend class kernel;
+  run(kernel &k, xrt::run r, std::vector<xrt::bo> buffers)
+      : owner(&k), xrtRun(std::move(r)), buffers(std::move(buffers)),
+        start(std::chrono::steady_clock::now()) {}
+
+  kernel *owner;
+  xrt::run xrtRun;
+  std::vector<xrt::bo> buffers;
+  std::chrono::steady_clock::time_point start;
+  double elapsed = 0;
+  bool finished = false;
+};
+
+class kernel {
+public:
+  // Register the xclbin on the device and open the first kernel whose name
+  // starts with kernelName, then load the instructions into their BO.
+  kernel(const std::string &xclbinPath, const std::string &kernelName,
+         const std::vector<uint32_t> &instructions,
+         unsigned int deviceIndex = 0);
+  ~kernel();
+
+  // A host buffer for the given host argument of the kernel (0 for the first
+  // buffer after the instructions), taken from the pool of released buffers
+  // when one of the same size and argument is free. The buffers of large
+  // tensors can be allocated in huge pages, taking fewer TLB entries on the
+  // host; their memory belongs to the kernel, which they must not outlive.
+  xrt::bo allocate(size_t bytes, int arg, bool hugePages = false);
+  // Return a buffer to the pool, to be reused by a later allocate.
+  void release(xrt::bo bo, int arg);
+
+  // Sync the buffers to the device and start a run on them, without waiting
+  // for the runs in flight.
+  run submit(std::vector<xrt::bo> buffers);
+  // Submit a run and wait for it.
+  ert_cmd_state call(std::vector<xrt::bo> buffers,
+                     std::chrono::milliseconds timeout =
+                         std::chrono::milliseconds(0));
+
+  const run_stats &stats() const { return runStats; }
+
+  xrt::device device;
+  xrt::xclbin xclbin;
+  xrt::hw_context context;
+  xrt::kernel xrtKernel;
+  xrt::bo instructions;
+  size_t numInstructions;
+
+private:
+  friend class run;
+  struct huge_page_memory;
+  // The free buffers by size, argument and whether they are in huge pages.
+  std::map<std::tuple<size_t, int, bool>, std::vector<xrt::bo>> freeBuffers;
+  // The memory of the buffers in huge pages, by address.
+  std::map<const void *, std::unique_ptr<huge_page_memory>> hugePageMemory;
+  run_stats runStats;
+};
+
+// The latencies of the timed runs of a benchmark, in microseconds.
+struct benchmark_result {
+  int warmup = 0;
+  // Sorted in increasing order.
+  std::vector<double> latencies_us;
+
+  // The nearest-rank percentile, for p in [0, 100].
+  double percentile_us(double p) const;
+  double mean_us() const;
+};
+
+// Run fn warmup times, to warm up the caches, the clocks and the XRT
+// command queues, then time each of iterations runs of it.
+benchmark_result benchmark(const std::function<void()> &fn, int warmup,
+                           int iterations);
+// Benchmark the calls of the kernel on the buffers, including their syncs.
+benchmark_result benchmark(kernel &k, const std::vector<xrt::bo> &buffers,
+                           int warmup, int iterations);
+
+// Print the result as a single-line JSON object. The throughput is reported
+// in GOPS and bytes/s, from the mean latency, when the number of operations
+// and bytes moved by a run are given.
+void print_benchmark_json(std::ostream &os, const std::string &name,
+                          const benchmark_result &result, double ops = 0,
+                          double bytes = 0);
+
+} // namespace ipu_host
+
+#endif // IPU_HOST_H
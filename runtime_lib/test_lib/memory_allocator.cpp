@@ -16,7 +16,9 @@
 
 int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle,
                         int size) {
-  int size_bytes = size * sizeof(int);
+  size_t size_bytes = mlir_aie_mem_size_class(size * sizeof(int));
+  if (mlir_aie_mem_pool_pop(_xaie, size_bytes, handle))
+    return (int *)handle.virtualAddr;
   handle.virtualAddr = std::malloc(size_bytes);
   if (handle.virtualAddr) {
     handle.size = size_bytes;
@@ -28,7 +30,7 @@ int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle,
     if (gapToAligned > 0)
       nextAlignedAddr += (16 - gapToAligned);
   } else {
-    printf("ExtMemModel: Failed to allocate %d memory.\n", size_bytes);
+    printf("ExtMemModel: Failed to allocate %zu memory.\n", size_bytes);
   }
 
   _xaie->allocations.push_back(handle);
@@ -40,12 +42,30 @@ int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle,
   return (int *)handle.virtualAddr;
 }
 
+void mlir_aie_mem_free(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle) {
+  mlir_aie_mem_pool_push(_xaie, handle);
+}
+
 void mlir_aie_sync_mem_cpu(ext_mem_model_t &handle) {
-  aiesim_ReadGM(handle.physicalAddr, handle.virtualAddr, handle.size);
+  mlir_aie_sync_mem_cpu_range(handle, 0, handle.size);
+}
+
+void mlir_aie_sync_mem_cpu_range(ext_mem_model_t &handle, size_t offset,
+                                 size_t size) {
+  aiesim_ReadGM(handle.physicalAddr + offset,
+                static_cast<char *>(handle.virtualAddr) + offset, size);
 }
 
 void mlir_aie_sync_mem_dev(ext_mem_model_t &handle) {
-  aiesim_WriteGM(handle.physicalAddr, handle.virtualAddr, handle.size);
+  size_t offset, size;
+  if (mlir_aie_mem_take_dirty(handle, offset, size))
+    mlir_aie_sync_mem_dev_range(handle, offset, size);
+}
+
+void mlir_aie_sync_mem_dev_range(ext_mem_model_t &handle, size_t offset,
+                                 size_t size) {
+  aiesim_WriteGM(handle.physicalAddr + offset,
+                 static_cast<char *>(handle.virtualAddr) + offset, size);
 }
 
 u64 mlir_aie_get_device_address(aie_libxaie_ctx_t *_xaie, void *VA) {
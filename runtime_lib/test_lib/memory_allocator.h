@@ -14,6 +14,7 @@
 
 #include "target.h"
 
+#include <algorithm>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -39,9 +40,12 @@ extern "C" {
 /// between efficiency of host data access vs. efficiency of accelerator access.
 
 // static variable for tracking current DDR physical addr during AIESIM
-static uint16_t nextAlignedAddr;
+static uint64_t nextAlignedAddr;
 
 /// @brief Allocate a buffer in device memory
+/// Buffers are allocated in power of two size classes, and buffers released
+/// with mlir_aie_mem_free are reused by later allocations of the same class,
+/// without going through the device memory allocator again.
 /// @param bufIdx The index of the buffer to allocate.
 /// @param size The number of 32-bit words to allocate
 /// @return A host-side pointer that can write into the given buffer.
@@ -49,6 +53,11 @@ static uint16_t nextAlignedAddr;
 int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle,
                         int size);
 
+/// @brief Release a buffer allocated with mlir_aie_mem_alloc.
+/// The buffer stays allocated and mapped, and is kept for reuse by the
+/// allocations of the same context.
+void mlir_aie_mem_free(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle);
+
 /// @brief Synchronize the buffer from the device to the host CPU.
 /// This is expected to be called after the device writes data into
 /// device memory, so that the data can be read by the CPU.  In
@@ -57,18 +66,105 @@ int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle,
 /// @param bufIdx The buffer index.
 void mlir_aie_sync_mem_cpu(ext_mem_model_t &handle);
 
+/// @brief Synchronize a range of the buffer from the device to the host CPU,
+/// when the host only reads that range.
+/// @param offset The offset in bytes of the range in the buffer.
+/// @param size The size in bytes of the range.
+void mlir_aie_sync_mem_cpu_range(ext_mem_model_t &handle, size_t offset,
+                                 size_t size);
+
 /// @brief Synchronize the buffer from the host CPU to the device.
 /// This is expected to be called after the host writes data into
 /// device memory, so that the data can be read by the device.  In
 /// a non-cache coherent system, this implies flushing the
 /// processor cache associated with the buffer.
+/// If the host marked the ranges it wrote with mlir_aie_mem_mark_dirty, only
+/// these ranges are synchronized, and nothing is done if there are none.
 /// @param bufIdx The buffer index.
 void mlir_aie_sync_mem_dev(ext_mem_model_t &handle);
 
+/// @brief Synchronize a range of the buffer from the host CPU to the device.
+/// @param offset The offset in bytes of the range in the buffer.
+/// @param size The size in bytes of the range.
+void mlir_aie_sync_mem_dev_range(ext_mem_model_t &handle, size_t offset,
+                                 size_t size);
+
 /// @brief Return a device address corresponding to the given host address.
 /// @param host_address A host-side pointer returned from mlir_aie_mem_alloc
 u64 mlir_aie_get_device_address(aie_libxaie_ctx_t *_xaie, void *host_address);
 
 } // extern "C"
 
+// The smallest size class of the buffers, a page.
+static constexpr size_t minMemSizeClass = 4096;
+
+/// Return the size in bytes of the buffers allocated for the given number of
+/// bytes.
+static inline size_t mlir_aie_mem_size_class(size_t size_bytes) {
+  size_t sizeClass = minMemSizeClass;
+  while (sizeClass < size_bytes)
+    sizeClass *= 2;
+  return sizeClass;
+}
+
+/// Take a released buffer of the given size class from the pool of the
+/// context, if there is one.
+static inline bool mlir_aie_mem_pool_pop(aie_libxaie_ctx_t *_xaie,
+                                         size_t sizeClass,
+                                         ext_mem_model_t &handle) {
+  std::lock_guard<std::mutex> guard(_xaie->memPool.mutex);
+  auto &buffers = _xaie->memPool.freeBuffers[sizeClass];
+  if (buffers.empty())
+    return false;
+  handle = buffers.back();
+  buffers.pop_back();
+  return true;
+}
+
+/// @brief Record that the host wrote the given range of the buffer, so that
+/// mlir_aie_sync_mem_dev only synchronizes the ranges written since the last
+/// synchronization.
+/// @param offset The offset in bytes of the range in the buffer.
+/// @param size The size in bytes of the range.
+static inline void mlir_aie_mem_mark_dirty(ext_mem_model_t &handle,
+                                           size_t offset, size_t size) {
+  size_t end = std::min(offset + size, handle.size);
+  if (offset >= end)
+    return;
+  if (!handle.trackDirty || handle.dirtyBegin == handle.dirtyEnd) {
+    handle.dirtyBegin = offset;
+    handle.dirtyEnd = end;
+  } else {
+    handle.dirtyBegin = std::min(handle.dirtyBegin, offset);
+    handle.dirtyEnd = std::max(handle.dirtyEnd, end);
+  }
+  handle.trackDirty = true;
+}
+
+/// Return the range of the buffer to synchronize to the device, the whole
+/// buffer unless the host marks the ranges it writes, and clear it. Returns
+/// false if there is nothing to synchronize.
+static inline bool mlir_aie_mem_take_dirty(ext_mem_model_t &handle,
+                                           size_t &offset, size_t &size) {
+  if (!handle.trackDirty) {
+    offset = 0;
+    size = handle.size;
+    return true;
+  }
+  offset = handle.dirtyBegin;
+  size = handle.dirtyEnd - handle.dirtyBegin;
+  handle.dirtyBegin = handle.dirtyEnd = 0;
+  return size != 0;
+}
+
+/// Return a buffer to the pool of the context.
+static inline void mlir_aie_mem_pool_push(aie_libxaie_ctx_t *_xaie,
+                                          const ext_mem_model_t &handle) {
+  std::lock_guard<std::mutex> guard(_xaie->memPool.mutex);
+  ext_mem_model_t &buffer =
+      _xaie->memPool.freeBuffers[handle.size].emplace_back(handle);
+  buffer.trackDirty = false;
+  buffer.dirtyBegin = buffer.dirtyEnd = 0;
+}
+
 #endif
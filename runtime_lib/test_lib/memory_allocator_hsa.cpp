@@ -19,14 +19,16 @@
 //
 int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle,
                         int size) {
-  int size_bytes = size * sizeof(int);
+  size_t size_bytes = mlir_aie_mem_size_class(size * sizeof(int));
+  if (mlir_aie_mem_pool_pop(_xaie, size_bytes, handle))
+    return (int *)handle.virtualAddr;
   hsa_amd_memory_pool_allocate(_xaie->global_mem_pool, size_bytes, 0,
                                (void **)&(handle.virtualAddr));
 
   if (handle.virtualAddr) {
     handle.size = size_bytes;
   } else {
-    printf("ExtMemModel: Failed to allocate %d memory.\n", size_bytes);
+    printf("ExtMemModel: Failed to allocate %zu memory.\n", size_bytes);
   }
 
   std::cout << "ExtMemModel constructor: virtual address " << std::hex
@@ -36,6 +38,10 @@ int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle,
   return (int *)handle.virtualAddr;
 }
 
+void mlir_aie_mem_free(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle) {
+  mlir_aie_mem_pool_push(_xaie, handle);
+}
+
 /*
   The device memory allocator directly maps device memory over
   PCIe MMIO. These accesses are uncached and thus don't require
@@ -43,8 +49,14 @@ int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle,
 */
 void mlir_aie_sync_mem_cpu(ext_mem_model_t &handle) {}
 
+void mlir_aie_sync_mem_cpu_range(ext_mem_model_t &handle, size_t offset,
+                                 size_t size) {}
+
 void mlir_aie_sync_mem_dev(ext_mem_model_t &handle) {}
 
+void mlir_aie_sync_mem_dev_range(ext_mem_model_t &handle, size_t offset,
+                                 size_t size) {}
+
 /*
   The only component that knows the proper translation from
   VA->PA is the command processor. Sending a request to the
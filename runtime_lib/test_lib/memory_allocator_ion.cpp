@@ -38,7 +38,7 @@
  * This is the memory function to allocate a memory
  *
  * @param	handle: Device Instance
- * @param	size: Size of the memory
+ * @param	size: Size of the memory, in 32-bit words
  *
  * @return	Pointer to the allocated memory instance.
  *******************************************************************************/
@@ -52,6 +52,10 @@ int *mlir_aie_mem_alloc(struct aie_libxaie_ctx_t *ctx, ext_mem_model_t &handle,
   struct ion_heap_query Query;
   struct ion_heap_data *Heaps;
   u64 DevAddr = 0;
+  size_t SizeBytes = mlir_aie_mem_size_class(size * sizeof(int));
+
+  if (mlir_aie_mem_pool_pop(ctx, SizeBytes, handle))
+    return (int *)handle.virtualAddr;
 
   Fd = open("/dev/ion", O_RDONLY);
   if (Fd < 0) {
@@ -97,7 +101,7 @@ int *mlir_aie_mem_alloc(struct aie_libxaie_ctx_t *ctx, ext_mem_model_t &handle,
   }
 
   memset(&AllocArgs, 0, sizeof(AllocArgs));
-  AllocArgs.len = size;
+  AllocArgs.len = SizeBytes;
   AllocArgs.heap_id_mask = 1 << Heaps[HeapNum].heap_id;
   free(Heaps);
   // if(Cache == XAIE_MEM_CACHEABLE) {
@@ -110,7 +114,8 @@ int *mlir_aie_mem_alloc(struct aie_libxaie_ctx_t *ctx, ext_mem_model_t &handle,
     goto error_ion;
   }
 
-  VAddr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, AllocArgs.fd, 0);
+  VAddr = mmap(NULL, SizeBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+               AllocArgs.fd, 0);
   if (VAddr == NULL) {
     XAIE_ERROR("Failed to mmap\n");
     goto error_alloc_fd;
@@ -118,11 +123,11 @@ int *mlir_aie_mem_alloc(struct aie_libxaie_ctx_t *ctx, ext_mem_model_t &handle,
 
   handle.fd = AllocArgs.fd;
   handle.virtualAddr = VAddr;
-  handle.size = size;
+  handle.size = SizeBytes;
 
   // Map the memory
   if (XAie_MemAttach(&(ctx->DevInst), &(handle.MemInst), DevAddr, (u64)VAddr,
-                     size, XAIE_MEM_NONCACHEABLE, handle.fd) != XAIE_OK) {
+                     SizeBytes, XAIE_MEM_NONCACHEABLE, handle.fd) != XAIE_OK) {
     XAIE_ERROR("dmabuf map failed\n");
     goto error_map;
   }
@@ -131,7 +136,7 @@ int *mlir_aie_mem_alloc(struct aie_libxaie_ctx_t *ctx, ext_mem_model_t &handle,
   return (int *)VAddr;
 
 error_map:
-  munmap(VAddr, size);
+  munmap(VAddr, SizeBytes);
 error_alloc_fd:
   close(handle.fd);
 error_ion:
@@ -139,6 +144,17 @@ error_ion:
   return NULL;
 }
 
+/**
+ * This is the memory function to release a memory. The memory stays mapped
+ * and attached, and is kept for reuse by the allocations of the context.
+ *
+ * @param	ctx: Device Instance
+ * @param	handle: The memory allocated by mlir_aie_mem_alloc
+ *******************************************************************************/
+void mlir_aie_mem_free(struct aie_libxaie_ctx_t *ctx, ext_mem_model_t &handle) {
+  mlir_aie_mem_pool_push(ctx, handle);
+}
+
 /*****************************************************************************/
 /**
  *
@@ -225,6 +241,14 @@ void mlir_aie_sync_mem_cpu(ext_mem_model_t &handle) {
   // return XAIE_OK;
 }
 
+/**
+ * The dma-buf sync ioctl has no ranges, so the whole memory is synchronized.
+ *******************************************************************************/
+void mlir_aie_sync_mem_cpu_range(ext_mem_model_t &handle, size_t offset,
+                                 size_t size) {
+  mlir_aie_sync_mem_cpu(handle);
+}
+
 /*****************************************************************************/
 /**
  *
@@ -238,6 +262,16 @@ void mlir_aie_sync_mem_cpu(ext_mem_model_t &handle) {
  *
  *******************************************************************************/
 void mlir_aie_sync_mem_dev(ext_mem_model_t &handle) {
+  size_t Offset, Size;
+  if (mlir_aie_mem_take_dirty(handle, Offset, Size))
+    mlir_aie_sync_mem_dev_range(handle, Offset, Size);
+}
+
+/**
+ * The dma-buf sync ioctl has no ranges, so the whole memory is synchronized.
+ *******************************************************************************/
+void mlir_aie_sync_mem_dev_range(ext_mem_model_t &handle, size_t offset,
+                                 size_t size) {
   struct dma_buf_sync Sync;
   int Ret;
 
@@ -12,6 +12,8 @@
 #define AIE_TARGET_H
 
 #include <list>
+#include <map>
+#include <mutex>
 #include <vector>
 #include <xaiengine.h>
 
@@ -26,6 +28,18 @@ struct ext_mem_model_t {
   size_t size;
   int fd;               // The file descriptor used during allocation
   XAie_MemInst MemInst; // LibXAIE handle if necessary.  This should go away.
+  // The range written by the host since the buffer was last synchronized to
+  // the device, once the host marks the ranges it writes.
+  bool trackDirty = false;
+  size_t dirtyBegin = 0;
+  size_t dirtyEnd = 0;
+};
+
+// Device buffers released by mlir_aie_mem_free, by size class, which are
+// reused by mlir_aie_mem_alloc instead of allocating new ones.
+struct ext_mem_pool_t {
+  std::mutex mutex;
+  std::map<size_t, std::vector<ext_mem_model_t>> freeBuffers;
 };
 
 struct aie_libxaie_ctx_t {
@@ -33,6 +47,10 @@ struct aie_libxaie_ctx_t {
   XAie_DevInst DevInst;
   // Some device memory allocators need this to keep track of VA->PA mappings
   std::list<ext_mem_model_t> allocations;
+  ext_mem_pool_t memPool;
+  // Serializes the libxaie accesses of host threads sharing the context, see
+  // mlir_aie_run_stream.
+  std::mutex xaieMutex;
 #ifdef HSA_RUNTIME
   hsa_queue_t *cmd_queue;
   std::vector<hsa_agent_t> agents;
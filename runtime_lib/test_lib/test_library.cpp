@@ -16,14 +16,27 @@
 
 #include "test_library.h"
 #include "math.h"
+#include <algorithm>
 #include <assert.h>
+#include <chrono>
 #include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/mman.h>
+#include <thread>
 #include <vector>
 
 #define SYSFS_PATH_MAX 63
 
+#ifdef __AIESIM__
+// The block transfers of the PS wrapper of the simulator, which move the words
+// in bursts rather than with a transaction for each of them as libXAIE does.
+extern "C" {
+void ess_WriteBlock(uint64_t addr, const uint32_t *data, uint64_t count);
+void ess_ReadBlock(uint64_t addr, uint32_t *data, uint64_t count);
+}
+#endif
+
 #ifdef HSA_RUNTIME
 hsa_status_t air_packet_req_translation(hsa_agent_dispatch_packet_t *pkt,
                                         uint64_t va) {
@@ -99,7 +112,7 @@ hsa_status_t air_queue_dispatch_and_wait(hsa_agent_t *agent, hsa_queue_t *q,
   // wait for packet completion
   while (hsa_signal_wait_scacquire(pkt->completion_signal,
                                    HSA_SIGNAL_CONDITION_EQ, 0, 0x80000,
-                                   HSA_WAIT_STATE_ACTIVE) != 0)
+                                   HSA_WAIT_STATE_BLOCKED) != 0)
     ;
 
   // Optionally destroying the signal
@@ -297,6 +310,96 @@ int mlir_aie_release_lock(aie_libxaie_ctx_t *ctx, int col, int row, int lockid,
                            XAie_LockInit(lockid, lockval), timeout) == XAIE_OK);
 }
 
+/// @brief Wait until one of the given locks can be acquired, and acquire it.
+/// The locks are tried in turn without waiting, and the calling thread sleeps
+/// between the attempts, doubling the sleep up to a millisecond, so that long
+/// waits don't keep a host core busy.
+/// @param locks The locks to wait on
+/// @param count The number of locks
+/// @param timeout The number of microseconds to wait, or a negative value to
+/// wait forever
+/// @return The index of the lock acquired, or -1 if the wait timed out.
+int mlir_aie_acquire_locks(aie_libxaie_ctx_t *ctx, const mlir_aie_lock_t *locks,
+                           int count, int timeout) {
+  auto start = std::chrono::steady_clock::now();
+  std::chrono::microseconds backoff(1);
+  while (true) {
+    for (int i = 0; i < count; i++) {
+      std::lock_guard<std::mutex> guard(ctx->xaieMutex);
+      if (mlir_aie_acquire_lock(ctx, locks[i].col, locks[i].row, locks[i].id,
+                                locks[i].value, 0))
+        return i;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    if (timeout >= 0 && elapsed >= std::chrono::microseconds(timeout))
+      return -1;
+    std::this_thread::sleep_for(backoff);
+    backoff = std::min(backoff * 2, std::chrono::microseconds(1000));
+  }
+}
+
+/// @brief Wait until a lock can be acquired, sleeping instead of polling
+/// continuously, see mlir_aie_acquire_locks.
+/// @param timeout The number of microseconds to wait, or a negative value to
+/// wait forever
+/// @return Return non-zero on success, i.e. the operation did not timeout.
+int mlir_aie_wait_lock(aie_libxaie_ctx_t *ctx, int col, int row, int lockid,
+                       int lockval, int timeout) {
+  mlir_aie_lock_t lock = {col, row, lockid, lockval};
+  return mlir_aie_acquire_locks(ctx, &lock, 1, timeout) == 0;
+}
+
+/// @brief Run a stage of a streaming design, see mlir_aie_run_stream.
+/// @return Return non-zero on success, i.e. no lock operation timed out.
+static int run_stream_stage(aie_libxaie_ctx_t *ctx,
+                            const mlir_aie_stream_stage_t &stage,
+                            int iterations, int timeout) {
+  for (int i = 0; i < iterations; i++) {
+    if (mlir_aie_acquire_locks(ctx, &stage.acquire, 1, timeout) != 0) {
+      printf("Stream stage timed out acquiring lock %d of tile (%d, %d) in "
+             "iteration %d\n",
+             stage.acquire.id, stage.acquire.col, stage.acquire.row, i);
+      return 0;
+    }
+    if (stage.callback)
+      stage.callback(i);
+    std::lock_guard<std::mutex> guard(ctx->xaieMutex);
+    if (!mlir_aie_release_lock(ctx, stage.release.col, stage.release.row,
+                               stage.release.id, stage.release.value, 0)) {
+      printf("Stream stage failed to release lock %d of tile (%d, %d) in "
+             "iteration %d\n",
+             stage.release.id, stage.release.col, stage.release.row, i);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/// @brief Run the producer and consumer of a streaming design on their own
+/// threads, so that the host fills and drains buffers while the array runs.
+/// The calling thread runs the control callback, then waits for both stages.
+/// @param iterations The number of iterations of each stage
+/// @param timeout The number of microseconds to wait on each lock, or a
+/// negative value to wait forever
+/// @return 0 on success, or -1 if a stage timed out on a lock.
+int mlir_aie_run_stream(aie_libxaie_ctx_t *ctx,
+                        const mlir_aie_stream_stage_t &producer,
+                        const mlir_aie_stream_stage_t &consumer, int iterations,
+                        const std::function<void()> &control, int timeout) {
+  int producerOk = 0, consumerOk = 0;
+  std::thread producerThread([&] {
+    producerOk = run_stream_stage(ctx, producer, iterations, timeout);
+  });
+  std::thread consumerThread([&] {
+    consumerOk = run_stream_stage(ctx, consumer, iterations, timeout);
+  });
+  if (control)
+    control();
+  producerThread.join();
+  consumerThread.join();
+  return producerOk && consumerOk ? 0 : -1;
+}
+
 /// @brief Read the AIE configuration memory at the given physical address.
 u32 mlir_aie_read32(aie_libxaie_ctx_t *ctx, u64 addr) {
   u32 val;
@@ -329,6 +432,42 @@ void mlir_aie_data_mem_wr_word(aie_libxaie_ctx_t *ctx, int col, int row,
   XAie_DataMemWrWord(&(ctx->DevInst), XAie_TileLoc(col, row), addr, data);
 }
 
+/// @brief Read consecutive words from the data memory of a particular tile
+/// memory. This is much faster than reading the words one at a time.
+/// @param addr The address in the given tile.
+/// @param data The buffer receiving the words
+/// @param count The number of words to read
+/// @return Return non-zero on success.
+int mlir_aie_data_mem_rd_block(aie_libxaie_ctx_t *ctx, int col, int row,
+                               u64 addr, u32 *data, size_t count) {
+#ifdef __AIESIM__
+  u64 tileAddr = _XAie_GetTileAddr(&(ctx->DevInst), row, col);
+  ess_ReadBlock(ctx->DevInst.BaseAddr + tileAddr + addr, data, count);
+  return 1;
+#else
+  return XAie_DataMemBlockRead(&(ctx->DevInst), XAie_TileLoc(col, row), addr,
+                               data, count * sizeof(u32)) == XAIE_OK;
+#endif
+}
+
+/// @brief Write consecutive words to the data memory of a particular tile
+/// memory. This is much faster than writing the words one at a time.
+/// @param addr The address in the given tile.
+/// @param data The words to write
+/// @param count The number of words to write
+/// @return Return non-zero on success.
+int mlir_aie_data_mem_wr_block(aie_libxaie_ctx_t *ctx, int col, int row,
+                               u64 addr, const u32 *data, size_t count) {
+#ifdef __AIESIM__
+  u64 tileAddr = _XAie_GetTileAddr(&(ctx->DevInst), row, col);
+  ess_WriteBlock(ctx->DevInst.BaseAddr + tileAddr + addr, data, count);
+  return 1;
+#else
+  return XAie_DataMemBlockWrite(&(ctx->DevInst), XAie_TileLoc(col, row), addr,
+                                data, count * sizeof(u32)) == XAIE_OK;
+#endif
+}
+
 /// @brief Return the base address of the given tile.
 /// The configuration address space of most tiles is very similar,
 /// relative to this base address.
@@ -339,21 +478,20 @@ u64 mlir_aie_get_tile_addr(aie_libxaie_ctx_t *ctx, int col, int row) {
 /// @brief Dump the tile memory of the given tile
 /// Values that are zero are not shown
 void mlir_aie_dump_tile_memory(aie_libxaie_ctx_t *ctx, int col, int row) {
+  std::vector<u32> mem(0x2000);
+  if (!mlir_aie_data_mem_rd_block(ctx, col, row, 0, mem.data(), mem.size()))
+    return;
   for (int i = 0; i < 0x2000; i++) {
-    uint32_t d;
-    AieRC rc = XAie_DataMemRdWord(&(ctx->DevInst), XAie_TileLoc(col, row),
-                                  (i * 4), &d);
-    if (rc == XAIE_OK && d != 0)
-      printf("Tile[%d][%d]: mem[%d] = %d\n", col, row, i, d);
+    if (mem[i] != 0)
+      printf("Tile[%d][%d]: mem[%d] = %d\n", col, row, i, mem[i]);
   }
 }
 
 /// @brief Fill the tile memory of the given tile with zeros.
 /// Values that are zero are not shown
 void mlir_aie_clear_tile_memory(aie_libxaie_ctx_t *ctx, int col, int row) {
-  for (int i = 0; i < 0x2000; i++) {
-    XAie_DataMemWrWord(&(ctx->DevInst), XAie_TileLoc(col, row), (i * 4), 0);
-  }
+  std::vector<u32> zeros(0x2000, 0);
+  mlir_aie_data_mem_wr_block(ctx, col, row, 0, zeros.data(), zeros.size());
 }
 
 static void print_aie1_dmachannel_status(aie_libxaie_ctx_t *ctx, int col,
@@ -621,12 +759,10 @@ void mlir_aie_print_dma_status(aie_libxaie_ctx_t *ctx, int col, int row) {
                words_to_transfer, base_address * 4);
 
         printf("   ");
-        for (int w = 0; w < 7; w++) {
-          u32 tmpd;
-          XAie_DataMemRdWord(&(ctx->DevInst), XAie_TileLoc(col, row),
-                             (base_address + w) * 4, &tmpd);
-          printf("%08X ", tmpd);
-        }
+        u32 words[7];
+        mlir_aie_data_mem_rd_block(ctx, col, row, base_address * 4, words, 7);
+        for (int w = 0; w < 7; w++)
+          printf("%08X ", words[w]);
         printf("\n");
         int hasAcquire = (dma_bd_addr_a >> 18) & 0x1;
         int hasRelease = (dma_bd_addr_a >> 21) & 0x1;
@@ -1003,16 +1139,11 @@ void mlir_aie_print_tile_status(aie_libxaie_ctx_t *ctx, int col, int row) {
   printf("\n");
 }
 
+// Zero the registers from low to high, both included. A single block set lets
+// the backend clear the range in one transaction rather than word by word.
 static void clear_range(XAie_DevInst *devInst, u64 tileAddr, u64 low,
                         u64 high) {
-  for (int i = low; i <= high; i += 4) {
-    XAie_Write32(devInst, tileAddr + i, 0);
-    // int x = XAie_Read32(ctx->DevInst,tileAddr+i);
-    // if(x != 0) {
-    //   printf("@%x = %x\n", i, x);
-    //   XAie_Write32(ctx->DevInst,tileAddr+i, 0);
-    // }
-  }
+  XAie_BlockSet32(devInst, tileAddr + low, 0, (high - low) / 4 + 1);
 }
 
 /// @brief Clear the configuration of the given (non-shim) tile.
@@ -1096,3 +1227,347 @@ void computeStats(u32 performance_counter[], int n) {
 
   printf("Mean and Standard Devation: %f, %f \n", mean_0, sdev_0);
 }
+
+namespace {
+struct perf_event_info_t {
+  const char *name;
+  XAie_ModuleType module;
+  XAie_Events startEvent;
+  XAie_Events stopEvent;
+};
+} // namespace
+
+// The counters of the core and stall events count the cycles the event is
+// asserted, by starting and stopping on the event. The DMA counters count the
+// cycles from the start of a BD to its end.
+static const perf_event_info_t perf_events[] = {
+    {"core_active", XAIE_CORE_MOD, XAIE_EVENT_ACTIVE_CORE,
+     XAIE_EVENT_ACTIVE_CORE},
+    {"core_memory_stall", XAIE_CORE_MOD, XAIE_EVENT_MEMORY_STALL_CORE,
+     XAIE_EVENT_MEMORY_STALL_CORE},
+    {"core_stream_stall", XAIE_CORE_MOD, XAIE_EVENT_STREAM_STALL_CORE,
+     XAIE_EVENT_STREAM_STALL_CORE},
+    {"core_lock_stall", XAIE_CORE_MOD, XAIE_EVENT_LOCK_STALL_CORE,
+     XAIE_EVENT_LOCK_STALL_CORE},
+    {"core_cascade_stall", XAIE_CORE_MOD, XAIE_EVENT_CASCADE_STALL_CORE,
+     XAIE_EVENT_CASCADE_STALL_CORE},
+    {"dma_s2mm_0_active", XAIE_MEM_MOD, XAIE_EVENT_DMA_S2MM_0_START_BD_MEM,
+     XAIE_EVENT_DMA_S2MM_0_FINISHED_BD_MEM},
+    {"dma_mm2s_0_active", XAIE_MEM_MOD, XAIE_EVENT_DMA_MM2S_0_START_BD_MEM,
+     XAIE_EVENT_DMA_MM2S_0_FINISHED_BD_MEM},
+    {"core_acquire", XAIE_CORE_MOD, XAIE_EVENT_INSTR_EVENT_0_CORE,
+     XAIE_EVENT_INSTR_EVENT_1_CORE},
+};
+
+const char *mlir_aie_perf_event_name(mlir_aie_perf_event_t event) {
+  return perf_events[event].name;
+}
+
+/// @brief Program a performance counter to measure an event.
+/// @param counter The counter to initialize
+/// @param event The event to measure
+/// @param hwCounter The index of the hardware counter in the module of the
+/// tile measuring the event
+/// @return Return non-zero on success.
+int mlir_aie_perf_counter_config(aie_libxaie_ctx_t *ctx,
+                                 mlir_aie_perf_counter_t &counter, int col,
+                                 int row, mlir_aie_perf_event_t event,
+                                 u8 hwCounter) {
+  const perf_event_info_t &info = perf_events[event];
+  counter = {col, row, event, hwCounter, 0, 0};
+  return XAie_PerfCounterControlSet(&(ctx->DevInst), XAie_TileLoc(col, row),
+                                    info.module, hwCounter, info.startEvent,
+                                    info.stopEvent) == XAIE_OK;
+}
+
+void mlir_aie_perf_counters_start(aie_libxaie_ctx_t *ctx,
+                                  mlir_aie_perf_counter_t *counters, int n) {
+  for (int i = 0; i < n; i++)
+    XAie_PerfCounterGet(&(ctx->DevInst),
+                        XAie_TileLoc(counters[i].col, counters[i].row),
+                        perf_events[counters[i].event].module,
+                        counters[i].counter, &counters[i].start);
+}
+
+void mlir_aie_perf_counters_stop(aie_libxaie_ctx_t *ctx,
+                                 mlir_aie_perf_counter_t *counters, int n) {
+  for (int i = 0; i < n; i++) {
+    u32 end;
+    XAie_PerfCounterGet(&(ctx->DevInst),
+                        XAie_TileLoc(counters[i].col, counters[i].row),
+                        perf_events[counters[i].event].module,
+                        counters[i].counter, &end);
+    // The difference is modulo 2^32, so a single wrap of the counter during
+    // the measurement is handled.
+    counters[i].total += u32(end - counters[i].start);
+  }
+}
+
+void mlir_aie_perf_counters_report(const mlir_aie_perf_counter_t *counters,
+                                   int n) {
+  for (int i = 0; i < n; i++)
+    printf("Tile[%d][%d] %s: %llu\n", counters[i].col, counters[i].row,
+           mlir_aie_perf_event_name(counters[i].event),
+           (unsigned long long)counters[i].total);
+  for (size_t e = 0; e < sizeof(perf_events) / sizeof(perf_events[0]); e++) {
+    u64 sum = 0, min = UINT64_MAX, max = 0;
+    int tiles = 0;
+    for (int i = 0; i < n; i++) {
+      if (counters[i].event != (mlir_aie_perf_event_t)e)
+        continue;
+      sum += counters[i].total;
+      min = std::min(min, counters[i].total);
+      max = std::max(max, counters[i].total);
+      tiles++;
+    }
+    if (tiles)
+      printf("%s over %d tiles: sum %llu, min %llu, max %llu, mean %f\n",
+             perf_events[e].name, tiles, (unsigned long long)sum,
+             (unsigned long long)min, (unsigned long long)max,
+             (double)sum / tiles);
+  }
+}
+
+int mlir_aie_fifo_profile_config(aie_libxaie_ctx_t *ctx, const char *path,
+                                 mlir_aie_fifo_profile_t *profiles, int max) {
+  FILE *map = fopen(path, "r");
+  if (!map) {
+    printf("ERROR: can't read the profile map %s\n", path);
+    return -1;
+  }
+  int n = 0, col, row, hwCounter;
+  char fifos[sizeof(profiles->fifos)];
+  while (n < max &&
+         fscanf(map, "%d %d %d %255s", &col, &row, &hwCounter, fifos) == 4) {
+    if (!mlir_aie_perf_counter_config(ctx, profiles[n].counter, col, row,
+                                      MLIR_AIE_PERF_CORE_ACQUIRE, hwCounter)) {
+      fclose(map);
+      return -1;
+    }
+    strcpy(profiles[n].fifos, fifos);
+    n++;
+  }
+  fclose(map);
+  return n;
+}
+
+void mlir_aie_fifo_profile_start(aie_libxaie_ctx_t *ctx,
+                                 mlir_aie_fifo_profile_t *profiles, int n) {
+  for (int i = 0; i < n; i++)
+    mlir_aie_perf_counters_start(ctx, &profiles[i].counter, 1);
+}
+
+void mlir_aie_fifo_profile_stop(aie_libxaie_ctx_t *ctx,
+                                mlir_aie_fifo_profile_t *profiles, int n) {
+  for (int i = 0; i < n; i++)
+    mlir_aie_perf_counters_stop(ctx, &profiles[i].counter, 1);
+}
+
+void mlir_aie_fifo_profile_report(const mlir_aie_fifo_profile_t *profiles,
+                                  int n) {
+  for (int i = 0; i < n; i++)
+    printf("Tile[%d][%d] blocked acquiring %s: %llu cycles\n",
+           profiles[i].counter.col, profiles[i].counter.row, profiles[i].fifos,
+           (unsigned long long)profiles[i].counter.total);
+}
+
+// The counters programmed by the CDO for the operations marked with
+// aie.profile.
+static constexpr u8 kernelCyclesCounter = 0;
+static constexpr u8 kernelCallsCounter = 1;
+
+void mlir_aie_kernel_profile_init(aie_libxaie_ctx_t *ctx,
+                                  mlir_aie_kernel_profile_t &profile, int col,
+                                  int row) {
+  profile = {col, row, 0, 0, 0, 0, UINT64_MAX, 0};
+  XAie_PerfCounterGet(&(ctx->DevInst), XAie_TileLoc(col, row), XAIE_CORE_MOD,
+                      kernelCyclesCounter, &profile.cycles);
+  XAie_PerfCounterGet(&(ctx->DevInst), XAie_TileLoc(col, row), XAIE_CORE_MOD,
+                      kernelCallsCounter, &profile.calls);
+}
+
+void mlir_aie_kernel_profile_sample(aie_libxaie_ctx_t *ctx,
+                                    mlir_aie_kernel_profile_t &profile) {
+  u32 cycles, calls;
+  XAie_LocType tileLoc = XAie_TileLoc(profile.col, profile.row);
+  XAie_PerfCounterGet(&(ctx->DevInst), tileLoc, XAIE_CORE_MOD,
+                      kernelCyclesCounter, &cycles);
+  XAie_PerfCounterGet(&(ctx->DevInst), tileLoc, XAIE_CORE_MOD,
+                      kernelCallsCounter, &calls);
+  // Unsigned differences stay right when the counters wrap around.
+  u32 newCycles = cycles - profile.cycles;
+  u32 newCalls = calls - profile.calls;
+  profile.cycles = cycles;
+  profile.calls = calls;
+  if (!newCalls)
+    return;
+  profile.totalCycles += newCycles;
+  profile.totalCalls += newCalls;
+  profile.minCycles = std::min<u64>(profile.minCycles, newCycles / newCalls);
+  profile.maxCycles = std::max<u64>(profile.maxCycles, newCycles / newCalls);
+}
+
+u64 mlir_aie_kernel_profile_avg(const mlir_aie_kernel_profile_t &profile) {
+  return profile.totalCalls ? profile.totalCycles / profile.totalCalls : 0;
+}
+
+void mlir_aie_kernel_profile_report(const mlir_aie_kernel_profile_t *profiles,
+                                    int n) {
+  for (int i = 0; i < n; i++) {
+    const mlir_aie_kernel_profile_t &profile = profiles[i];
+    if (!profile.totalCalls) {
+      printf("Tile[%d][%d] kernel: no calls\n", profile.col, profile.row);
+      continue;
+    }
+    printf("Tile[%d][%d] kernel: %llu calls, min %llu, avg %llu, max %llu "
+           "cycles\n",
+           profile.col, profile.row, (unsigned long long)profile.totalCalls,
+           (unsigned long long)profile.minCycles,
+           (unsigned long long)mlir_aie_kernel_profile_avg(profile),
+           (unsigned long long)profile.maxCycles);
+  }
+}
+
+// The names of the stream switch ports, as the wire bundles of the dialect.
+static const char *port_bundle_name(StrmSwPortType bundle) {
+  static const char *names[] = {"Core", "DMA",   "Ctrl", "FIFO",  "South",
+                                "West", "North", "East", "Trace"};
+  if (bundle < 0 || bundle >= (int)(sizeof(names) / sizeof(names[0])))
+    return "Unknown";
+  return names[bundle];
+}
+
+int mlir_aie_port_counters_config(aie_libxaie_ctx_t *ctx,
+                                  mlir_aie_port_counter_t *ports, int n) {
+  const XAie_DevInst &devInst = ctx->DevInst;
+  for (int i = 0; i < n; i++) {
+    mlir_aie_port_counter_t &port = ports[i];
+    // The stream switch events of a tile are in its core module, its PL
+    // module for a shim tile or its single module for a memtile.
+    XAie_Events running, stalled;
+    int maxPorts = 2;
+    if (port.row == 0) {
+      port.module = XAIE_PL_MOD;
+      running = XAIE_EVENT_PORT_RUNNING_0_PL;
+      stalled = XAIE_EVENT_PORT_STALLED_0_PL;
+      maxPorts = 1;
+    } else if (port.row >= devInst.MemTileRowStart &&
+               port.row < devInst.MemTileRowStart + devInst.MemTileNumRows) {
+      port.module = XAIE_MEM_MOD;
+      running = XAIE_EVENT_PORT_RUNNING_0_MEM_TILE;
+      stalled = XAIE_EVENT_PORT_STALLED_0_MEM_TILE;
+    } else {
+      port.module = XAIE_CORE_MOD;
+      running = XAIE_EVENT_PORT_RUNNING_0_CORE;
+      stalled = XAIE_EVENT_PORT_STALLED_0_CORE;
+    }
+    // Each port of a tile takes the next event port of its switch, and the
+    // next two counters of the module.
+    int slot = 0;
+    for (int j = 0; j < i; j++)
+      if (ports[j].col == port.col && ports[j].row == port.row)
+        slot++;
+    if (slot >= maxPorts) {
+      printf("ERROR: Tile[%d][%d] can't measure more than %d ports\n",
+             port.col, port.row, maxPorts);
+      return 0;
+    }
+    port.counter = 2 * slot;
+    port.cycles = port.running = port.stalled = 0;
+    // The events of the event ports are numbered 4 by 4: idle, running,
+    // stalled and tlast.
+    running = (XAie_Events)(running + 4 * slot);
+    stalled = (XAie_Events)(stalled + 4 * slot);
+    XAie_LocType tileLoc = XAie_TileLoc(port.col, port.row);
+    if (XAie_EventSelectStrmPort(&(ctx->DevInst), tileLoc, slot,
+                                 port.master ? XAIE_STRMSW_MASTER
+                                             : XAIE_STRMSW_SLAVE,
+                                 port.bundle, port.channel) != XAIE_OK ||
+        XAie_PerfCounterControlSet(&(ctx->DevInst), tileLoc, port.module,
+                                   port.counter, running,
+                                   running) != XAIE_OK ||
+        XAie_PerfCounterControlSet(&(ctx->DevInst), tileLoc, port.module,
+                                   port.counter + 1, stalled,
+                                   stalled) != XAIE_OK)
+      return 0;
+  }
+  return 1;
+}
+
+void mlir_aie_port_counters_start(aie_libxaie_ctx_t *ctx,
+                                  mlir_aie_port_counter_t *ports, int n) {
+  for (int i = 0; i < n; i++) {
+    mlir_aie_port_counter_t &port = ports[i];
+    XAie_LocType tileLoc = XAie_TileLoc(port.col, port.row);
+    XAie_ReadTimer(&(ctx->DevInst), tileLoc, port.module, &port.timerStart);
+    XAie_PerfCounterGet(&(ctx->DevInst), tileLoc, port.module, port.counter,
+                        &port.runningStart);
+    XAie_PerfCounterGet(&(ctx->DevInst), tileLoc, port.module,
+                        port.counter + 1, &port.stalledStart);
+  }
+}
+
+void mlir_aie_port_counters_stop(aie_libxaie_ctx_t *ctx,
+                                 mlir_aie_port_counter_t *ports, int n) {
+  for (int i = 0; i < n; i++) {
+    mlir_aie_port_counter_t &port = ports[i];
+    XAie_LocType tileLoc = XAie_TileLoc(port.col, port.row);
+    u64 timer;
+    u32 running, stalled;
+    XAie_ReadTimer(&(ctx->DevInst), tileLoc, port.module, &timer);
+    XAie_PerfCounterGet(&(ctx->DevInst), tileLoc, port.module, port.counter,
+                        &running);
+    XAie_PerfCounterGet(&(ctx->DevInst), tileLoc, port.module,
+                        port.counter + 1, &stalled);
+    port.cycles += timer - port.timerStart;
+    // Unsigned differences stay right when the counters wrap around.
+    port.running += u32(running - port.runningStart);
+    port.stalled += u32(stalled - port.stalledStart);
+  }
+}
+
+static double port_ratio(u64 cycles, u64 total) {
+  return total ? (double)cycles / total : 0;
+}
+
+void mlir_aie_port_counters_report(const mlir_aie_port_counter_t *ports,
+                                   int n) {
+  for (int i = 0; i < n; i++) {
+    const mlir_aie_port_counter_t &port = ports[i];
+    printf("Tile[%d][%d] %s %s:%d: utilisation %.3f, stall ratio %.3f over "
+           "%llu cycles\n",
+           port.col, port.row, port.master ? "master" : "slave",
+           port_bundle_name(port.bundle), port.channel,
+           port_ratio(port.running, port.cycles),
+           port_ratio(port.stalled, port.cycles),
+           (unsigned long long)port.cycles);
+  }
+}
+
+int mlir_aie_port_counters_write_json(const mlir_aie_port_counter_t *ports,
+                                      int n, const char *path) {
+  FILE *json = fopen(path, "w");
+  if (!json) {
+    printf("ERROR: can't write the port utilisation %s\n", path);
+    return 0;
+  }
+  fprintf(json, "{\n\"ports\": [");
+  for (int i = 0; i < n; i++) {
+    const mlir_aie_port_counter_t &port = ports[i];
+    fprintf(json,
+            "%s\n{\"col\": %d, \"row\": %d, \"master\": %s, "
+            "\"bundle\": \"%s\", \"channel\": %d, \"cycles\": %llu, "
+            "\"running\": %llu, \"stalled\": %llu, \"utilisation\": %f, "
+            "\"stall_ratio\": %f}",
+            i ? "," : "", port.col, port.row,
+            port.master ? "true" : "false", port_bundle_name(port.bundle),
+            port.channel, (unsigned long long)port.cycles,
+            (unsigned long long)port.running,
+            (unsigned long long)port.stalled,
+            port_ratio(port.running, port.cycles),
+            port_ratio(port.stalled, port.cycles));
+  }
+  fprintf(json, "\n]\n}\n");
+  fclose(json);
+  return 1;
+}
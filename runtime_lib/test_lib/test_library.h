@@ -11,6 +11,7 @@
 #define AIE_TEST_LIBRARY_H
 
 #include "target.h"
+#include <functional>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -132,12 +133,53 @@ int mlir_aie_acquire_lock(aie_libxaie_ctx_t *ctx, int col, int row, int lockid,
                           int lockval, int timeout);
 int mlir_aie_release_lock(aie_libxaie_ctx_t *ctx, int col, int row, int lockid,
                           int lockval, int timeout);
+
+/// A lock to acquire with the given value.
+struct mlir_aie_lock_t {
+  int col;
+  int row;
+  int id;
+  int value;
+};
+
+/// Acquire the first of the given locks to become available, without keeping
+/// the host thread busy. Returns the index of the lock, or -1 on timeout.
+int mlir_aie_acquire_locks(aie_libxaie_ctx_t *ctx, const mlir_aie_lock_t *locks,
+                           int count, int timeout);
+/// Acquire a lock without keeping the host thread busy.
+int mlir_aie_wait_lock(aie_libxaie_ctx_t *ctx, int col, int row, int lockid,
+                       int lockval, int timeout);
+
+/// A host thread exchanging data with the array through a lock handshake:
+/// each iteration acquires a lock, calls the callback with the iteration
+/// number, e.g. to fill an input buffer or drain an output buffer, and
+/// releases a lock.
+struct mlir_aie_stream_stage_t {
+  mlir_aie_lock_t acquire;
+  mlir_aie_lock_t release;
+  std::function<void(int)> callback;
+};
+
+/// Run the producer and consumer stages of a streaming design on their own
+/// threads for the given number of iterations, while the calling thread runs
+/// the control callback, e.g. to start the cores, and then waits for them.
+/// The stages share the context: their lock operations hold ctx->xaieMutex,
+/// which the control callback must also hold to access the context.
+/// Returns 0 on success, or -1 if a stage timed out on a lock.
+int mlir_aie_run_stream(aie_libxaie_ctx_t *ctx,
+                        const mlir_aie_stream_stage_t &producer,
+                        const mlir_aie_stream_stage_t &consumer, int iterations,
+                        const std::function<void()> &control, int timeout);
 u32 mlir_aie_read32(aie_libxaie_ctx_t *ctx, u64 addr);
 void mlir_aie_write32(aie_libxaie_ctx_t *ctx, u64 addr, u32 val);
 u32 mlir_aie_data_mem_rd_word(aie_libxaie_ctx_t *ctx, int col, int row,
                               u64 addr);
 void mlir_aie_data_mem_wr_word(aie_libxaie_ctx_t *ctx, int col, int row,
                                u64 addr, u32 data);
+int mlir_aie_data_mem_rd_block(aie_libxaie_ctx_t *ctx, int col, int row,
+                               u64 addr, u32 *data, size_t count);
+int mlir_aie_data_mem_wr_block(aie_libxaie_ctx_t *ctx, int col, int row,
+                               u64 addr, const u32 *data, size_t count);
 
 u64 mlir_aie_get_tile_addr(aie_libxaie_ctx_t *ctx, int col, int row);
 
@@ -167,6 +209,163 @@ void mlir_aie_clear_shim_config(aie_libxaie_ctx_t *ctx, int col, int row);
 
 void computeStats(u32 performance_counter[], int n);
 
+/// Events measured by the performance counters of the tiles, by name. The
+/// stall and activity events count the cycles the condition holds, the DMA
+/// events the cycles between the start and the end of the BDs of a channel.
+/// The acquire event counts the cycles between the two instruction events
+/// bracketing the objectFifo acquires of a profiled core.
+enum mlir_aie_perf_event_t {
+  MLIR_AIE_PERF_CORE_ACTIVE,
+  MLIR_AIE_PERF_CORE_MEMORY_STALL,
+  MLIR_AIE_PERF_CORE_STREAM_STALL,
+  MLIR_AIE_PERF_CORE_LOCK_STALL,
+  MLIR_AIE_PERF_CORE_CASCADE_STALL,
+  MLIR_AIE_PERF_DMA_S2MM_0_ACTIVE,
+  MLIR_AIE_PERF_DMA_MM2S_0_ACTIVE,
+  MLIR_AIE_PERF_CORE_ACQUIRE,
+};
+
+/// A performance counter of a tile measuring an event.
+struct mlir_aie_perf_counter_t {
+  int col;
+  int row;
+  mlir_aie_perf_event_t event;
+  u8 counter;
+  u32 start;
+  u64 total;
+};
+
+/// Return the name of the event.
+const char *mlir_aie_perf_event_name(mlir_aie_perf_event_t event);
+
+/// Program the given hardware counter of the module of the tile measuring the
+/// event. Returns non-zero on success.
+int mlir_aie_perf_counter_config(aie_libxaie_ctx_t *ctx,
+                                 mlir_aie_perf_counter_t &counter, int col,
+                                 int row, mlir_aie_perf_event_t event,
+                                 u8 hwCounter);
+
+/// Start a measurement of the counters.
+void mlir_aie_perf_counters_start(aie_libxaie_ctx_t *ctx,
+                                  mlir_aie_perf_counter_t *counters, int n);
+
+/// End a measurement of the counters started by mlir_aie_perf_counters_start,
+/// adding the cycles measured to their totals.
+void mlir_aie_perf_counters_stop(aie_libxaie_ctx_t *ctx,
+                                 mlir_aie_perf_counter_t *counters, int n);
+
+/// Print the totals of the counters, and their sum, minimum, maximum and mean
+/// over the tiles for each event.
+void mlir_aie_perf_counters_report(const mlir_aie_perf_counter_t *counters,
+                                   int n);
+
+/// The performance counter of a core timing its objectFifo acquires, as
+/// mapped by aie-objectFifo-stateful-transform="profile=true profile-map=...".
+struct mlir_aie_fifo_profile_t {
+  mlir_aie_perf_counter_t counter;
+  char fifos[256];
+};
+
+/// Program the counters listed in the profile map, filling at most max
+/// profiles. Returns the number of profiles, or -1 if the map can't be read
+/// or a counter can't be programmed.
+int mlir_aie_fifo_profile_config(aie_libxaie_ctx_t *ctx, const char *path,
+                                 mlir_aie_fifo_profile_t *profiles, int max);
+
+/// Start a measurement of the profile counters.
+void mlir_aie_fifo_profile_start(aie_libxaie_ctx_t *ctx,
+                                 mlir_aie_fifo_profile_t *profiles, int n);
+
+/// End a measurement started by mlir_aie_fifo_profile_start, adding the
+/// cycles measured to the totals.
+void mlir_aie_fifo_profile_stop(aie_libxaie_ctx_t *ctx,
+                                mlir_aie_fifo_profile_t *profiles, int n);
+
+/// Print the cycles each core spent blocked acquiring its objectFifos.
+void mlir_aie_fifo_profile_report(const mlir_aie_fifo_profile_t *profiles,
+                                  int n);
+
+/// The timings of the operations marked with aie.profile in a core, measured
+/// by the two performance counters the CDO of the design programs: counter 0
+/// adds up their cycles and counter 1 counts how many times they ran.
+struct mlir_aie_kernel_profile_t {
+  int col;
+  int row;
+  u32 cycles;
+  u32 calls;
+  u64 totalCycles;
+  u64 totalCalls;
+  u64 minCycles;
+  u64 maxCycles;
+};
+
+/// Start profiling the core of the tile from the current counter values.
+void mlir_aie_kernel_profile_init(aie_libxaie_ctx_t *ctx,
+                                  mlir_aie_kernel_profile_t &profile, int col,
+                                  int row);
+
+/// Read the counters of the core, adding the cycles and calls since the last
+/// sample to the totals. The minimum and maximum are those of the mean
+/// duration of a call over each sample, so they are exact when sampled after
+/// every call.
+void mlir_aie_kernel_profile_sample(aie_libxaie_ctx_t *ctx,
+                                    mlir_aie_kernel_profile_t &profile);
+
+/// Return the mean cycles of a call of the profiled operations.
+u64 mlir_aie_kernel_profile_avg(const mlir_aie_kernel_profile_t &profile);
+
+/// Print the minimum, mean and maximum cycles of the profiled operations of
+/// each core.
+void mlir_aie_kernel_profile_report(const mlir_aie_kernel_profile_t *profiles,
+                                    int n);
+
+/// A port of the stream switch of a tile whose activity is measured: an event
+/// port of the switch selects it, and two performance counters of the tile
+/// count the cycles it transfers data and the cycles it is stalled, over the
+/// cycles of the timer of the tile. The caller fills in the port, and
+/// mlir_aie_port_counters_config the rest.
+struct mlir_aie_port_counter_t {
+  int col;
+  int row;
+  bool master;
+  StrmSwPortType bundle;
+  u8 channel;
+  XAie_ModuleType module;
+  u8 counter;
+  u32 runningStart;
+  u32 stalledStart;
+  u64 timerStart;
+  u64 cycles;
+  u64 running;
+  u64 stalled;
+};
+
+/// Program the event ports and the counters of the tiles measuring the ports.
+/// A compute tile or a memtile measures up to 2 ports, with all of its
+/// performance counters, and a shim tile 1. Returns non-zero on success.
+int mlir_aie_port_counters_config(aie_libxaie_ctx_t *ctx,
+                                  mlir_aie_port_counter_t *ports, int n);
+
+/// Start a measurement of the ports.
+void mlir_aie_port_counters_start(aie_libxaie_ctx_t *ctx,
+                                  mlir_aie_port_counter_t *ports, int n);
+
+/// End a measurement started by mlir_aie_port_counters_start, adding the
+/// cycles measured to the totals.
+void mlir_aie_port_counters_stop(aie_libxaie_ctx_t *ctx,
+                                 mlir_aie_port_counter_t *ports, int n);
+
+/// Print the utilisation and the stall ratio of each port, the fractions of
+/// the cycles measured it was running and stalled.
+void mlir_aie_port_counters_report(const mlir_aie_port_counter_t *ports,
+                                   int n);
+
+/// Write the utilisation and the stall ratio of each port to a JSON file,
+/// which tools/aie-vis overlays on the switchboxes. Returns non-zero on
+/// success.
+int mlir_aie_port_counters_write_json(const mlir_aie_port_counter_t *ports,
+                                      int n, const char *path);
+
 } // extern "C"
 
 #endif
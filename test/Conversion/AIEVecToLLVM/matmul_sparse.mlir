@@ -0,0 +1,34 @@
+// RUN: aie-opt %s -convert-aievec-to-llvm | FileCheck %s
+
+func.func @matmul_sparse(%A : vector<4x16xi8>, %B : vector<8x8xi8>,
+                         %M : vector<4xi32>,
+                         %C : vector<4x8xi32>) -> vector<4x8xi32> {
+  %0 = aievec.matmul_sparse %A, %B, %M, %C : vector<4x16xi8>,
+                                             vector<8x8xi8>, vector<4xi32>
+                                             into vector<4x8xi32>
+  return %0 : vector<4x8xi32>
+}
+
+// CHECK-LABEL: @matmul_sparse
+// CHECK-SAME: %[[A:.*]]: vector<4x16xi8>
+// CHECK-SAME: %[[B:.*]]: vector<8x8xi8>
+// CHECK-SAME: %[[M:.*]]: vector<4xi32>
+// CHECK-SAME: %[[C:.*]]: vector<4x8xi32>
+// CHECK:      %[[FA:.*]] = vector.shape_cast %[[A]] :
+// CHECK-SAME:                      vector<4x16xi8> to vector<64xi8>
+// CHECK:      %[[FB:.*]] = vector.shape_cast %[[B]] :
+// CHECK-SAME:                      vector<8x8xi8> to vector<64xi8>
+// CHECK:      %[[FC:.*]] = vector.shape_cast %[[C]] :
+// CHECK-SAME:                      vector<4x8xi32> to vector<32xi32>
+// CHECK:      %[[CONF:.*]] = llvm.mlir.constant(776 : i32) : i32
+// CHECK:      %[[BCB:.*]] = llvm.bitcast %[[FB]] : vector<64xi8> to vector<16xi32>
+// CHECK:      %[[BCC:.*]] = llvm.bitcast %[[FC]] : vector<32xi32> to vector<16xi64>
+// CHECK:      %[[RACC:.*]] =
+// CHECK-SAME:         "aievec.intr.I512.I512.ACC1024.acc32.sparse.mac.conf"(
+// CHECK-SAME:           %[[FA]], %[[BCB]], %[[M]], %[[BCC]], %[[CONF]]) :
+// CHECK-SAME:           (vector<64xi8>, vector<16xi32>, vector<4xi32>,
+// CHECK-SAME:            vector<16xi64>, i32) -> vector<16xi64>
+// CHECK:      %[[BCR:.*]] = llvm.bitcast %[[RACC]] : vector<16xi64> to vector<32xi32>
+// CHECK:      %[[R:.*]] = vector.shape_cast %[[BCR]] :
+// CHECK-SAME:                      vector<32xi32> to vector<4x8xi32>
+// CHECK:      return %[[R]] : vector<4x8xi32>
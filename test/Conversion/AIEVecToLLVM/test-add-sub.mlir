@@ -0,0 +1,38 @@
+// RUN: aie-opt %s --convert-aievec-to-llvm | FileCheck %s
+module {
+  func.func @test(%arg0: vector<8xi32>, %arg1: vector<16xi16>, %arg2: vector<8xf32>) {
+    // check the parameters that go into separate constants
+    %0 = aievec.add %arg0, %arg0 {xoffsets = "0x76543210", xsquare = "0x0000", xstart = "0", zoffsets = "0x76543210", zsquare = "0x0000", zstart = "4"} : vector<8xi32>, vector<8xi32>, vector<8xi32>
+    %1 = aievec.sub %arg0, %arg0 {xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xsquare = "0x0000", xstart = "2", zoffsets = "0x76543210", zsquare = "0x0000", zstart = "7"} : vector<8xi32>, vector<8xi32>, vector<8xi32>
+    // check the squares that make up the configuration value
+    %2 = aievec.add %arg1, %arg1 {xoffsets = "0x03020100", xoffsets_hi = "0x07060504", xsquare = "0x3210", xstart = "0", zoffsets = "0x03020100", zoffsets_hi = "0x07060504", zsquare = "0x3210", zstart = "0"} : vector<16xi16>, vector<16xi16>, vector<16xi16>
+    // floats use the vfp intrinsics
+    %3 = aievec.sub %arg2, %arg2 {xoffsets = "0x76543210", xstart = "0", zoffsets = "0x76543210", zstart = "0"} : vector<8xf32>, vector<8xf32>, vector<8xf32>
+    return
+  }
+}
+
+// The function declarations are in reverse order of their declarations
+// CHECK: llvm.func @llvm.aie.vfpsub(vector<8xf32>, vector<8xf32>, i32, i32, vector<2xi32>, vector<2xi32>, vector<2xi32>) -> vector<8xf32>
+// CHECK: llvm.func @llvm.aie.add16.v16int16(vector<16xi16>, vector<16xi16>, i32, i32, vector<2xi32>, vector<2xi32>, vector<2xi32>) -> vector<16xi16>
+// CHECK: llvm.func @llvm.aie.sub8.v8int32(vector<8xi32>, vector<8xi32>, i32, i32, vector<2xi32>, vector<2xi32>, vector<2xi32>) -> vector<8xi32>
+// CHECK: llvm.func @llvm.aie.add8.v8int32(vector<8xi32>, vector<8xi32>, i32, i32, vector<2xi32>, vector<2xi32>, vector<2xi32>) -> vector<8xi32>
+
+// CHECK: [[XSTART:%.+]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK: [[ZSTART:%.+]] = llvm.mlir.constant(4 : i32) : i32
+// CHECK: [[XOFFS:%.+]] = llvm.mlir.constant(dense<[1985229328, 0]> : vector<2xi32>) : vector<2xi32>
+// CHECK: [[ZOFFS:%.+]] = llvm.mlir.constant(dense<[1985229328, 0]> : vector<2xi32>) : vector<2xi32>
+// CHECK: [[CONF:%.+]] = llvm.mlir.constant(dense<0> : vector<2xi32>) : vector<2xi32>
+// CHECK: {{.*}} = llvm.call @llvm.aie.add8.v8int32(%arg0, %arg0, [[XSTART]], [[ZSTART]], [[XOFFS]], [[ZOFFS]], [[CONF]]) : (vector<8xi32>, vector<8xi32>, i32, i32, vector<2xi32>, vector<2xi32>, vector<2xi32>) -> vector<8xi32>
+
+// CHECK: [[XSTART:%.+]] = llvm.mlir.constant(2 : i32) : i32
+// CHECK: [[ZSTART:%.+]] = llvm.mlir.constant(7 : i32) : i32
+// CHECK: [[XOFFS:%.+]] = llvm.mlir.constant(dense<[50462976, 117835012]> : vector<2xi32>) : vector<2xi32>
+// CHECK: [[ZOFFS:%.+]] = llvm.mlir.constant(dense<[1985229328, 0]> : vector<2xi32>) : vector<2xi32>
+// CHECK: [[CONF:%.+]] = llvm.mlir.constant(dense<0> : vector<2xi32>) : vector<2xi32>
+// CHECK: {{.*}} = llvm.call @llvm.aie.sub8.v8int32(%arg0, %arg0, [[XSTART]], [[ZSTART]], [[XOFFS]], [[ZOFFS]], [[CONF]]) : (vector<8xi32>, vector<8xi32>, i32, i32, vector<2xi32>, vector<2xi32>, vector<2xi32>) -> vector<8xi32>
+
+// CHECK: [[CONF:%.+]] = llvm.mlir.constant(dense<[0, 58596]> : vector<2xi32>) : vector<2xi32>
+// CHECK: {{.*}} = llvm.call @llvm.aie.add16.v16int16(%arg1, %arg1, {{.*}}, [[CONF]]) : (vector<16xi16>, vector<16xi16>, i32, i32, vector<2xi32>, vector<2xi32>, vector<2xi32>) -> vector<16xi16>
+
+// CHECK: {{.*}} = llvm.call @llvm.aie.vfpsub(%arg2, %arg2, {{.*}}) : (vector<8xf32>, vector<8xf32>, i32, i32, vector<2xi32>, vector<2xi32>, vector<2xi32>) -> vector<8xf32>
@@ -0,0 +1,110 @@
+// RUN: aie-opt %s -split-input-file -convert-aievec-to-llvm | FileCheck %s
+
+func.func @shuffle(%arg0 : vector<64xi8>) -> vector<64xi8> {
+  %0 = aievec.shuffle %arg0 {mode = 34 : i32} : vector<64xi8>, vector<64xi8>
+  return %0 : vector<64xi8>
+}
+
+// CHECK-LABEL: @shuffle
+// CHECK-SAME: %[[ARG0:.*]]: vector<64xi8>
+// CHECK:      %[[LHS:.*]] = llvm.bitcast %[[ARG0]] : vector<64xi8> to vector<16xi32>
+// CHECK:      %[[RHS:.*]] = llvm.mlir.undef : vector<16xi32>
+// CHECK:      %[[MODE:.*]] = llvm.mlir.constant(34 : i32) : i32
+// CHECK:      %[[R:.*]] = "aievec.intr.vshuffle"(%[[LHS]], %[[RHS]], %[[MODE]]) :
+// CHECK-SAME:         (vector<16xi32>, vector<16xi32>, i32) -> vector<16xi32>
+// CHECK:      %[[BCR:.*]] = llvm.bitcast %[[R]] : vector<16xi32> to vector<64xi8>
+// CHECK:      return %[[BCR]] : vector<64xi8>
+
+// -----
+
+func.func @shift(%arg0 : vector<32xbf16>, %arg1 : vector<32xbf16>,
+                 %arg2 : i32) -> vector<32xbf16> {
+  %0 = aievec.shift %arg0, %arg1, %arg2 {isAcc = false} : vector<32xbf16>, vector<32xbf16>, i32, vector<32xbf16>
+  return %0 : vector<32xbf16>
+}
+
+// CHECK-LABEL: @shift
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xbf16>, %[[ARG1:.*]]: vector<32xbf16>,
+// CHECK-SAME: %[[ARG2:.*]]: i32
+// CHECK:      %[[STEP:.*]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK:      %[[LHS:.*]] = llvm.bitcast %[[ARG0]] : vector<32xbf16> to vector<16xi32>
+// CHECK:      %[[RHS:.*]] = llvm.bitcast %[[ARG1]] : vector<32xbf16> to vector<16xi32>
+// CHECK:      %[[R:.*]] = "aievec.intr.vshift.I512.I512"(
+// CHECK-SAME:         %[[LHS]], %[[RHS]], %[[STEP]], %[[ARG2]]) :
+// CHECK-SAME:         (vector<16xi32>, vector<16xi32>, i32, i32) -> vector<16xi32>
+// CHECK:      %[[BCR:.*]] = llvm.bitcast %[[R]] : vector<16xi32> to vector<32xbf16>
+// CHECK:      return %[[BCR]] : vector<32xbf16>
+
+// -----
+
+func.func @max_i16(%arg0 : vector<32xi16>, %arg1 : vector<32xi16>) -> vector<32xi16> {
+  %0 = aievec.max %arg0, %arg1 : vector<32xi16>
+  return %0 : vector<32xi16>
+}
+
+// CHECK-LABEL: @max_i16
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xi16>, %[[ARG1:.*]]: vector<32xi16>
+// CHECK:      %[[CMP:.*]] = llvm.mlir.constant(1 : i32) : i32
+// CHECK:      %[[R:.*]] = "aievec.intr.vmax.lt16"(%[[ARG0]], %[[ARG1]], %[[CMP]]) :
+// CHECK-SAME:         (vector<32xi16>, vector<32xi16>, i32)
+// CHECK-SAME:         -> !llvm.struct<(vector<32xi16>, i32)>
+// CHECK:      %[[MAX:.*]] = llvm.extractvalue %[[R]][0] : !llvm.struct<(vector<32xi16>, i32)>
+// CHECK:      return %[[MAX]] : vector<32xi16>
+
+// -----
+
+func.func @min_i8(%arg0 : vector<64xi8>, %arg1 : vector<64xi8>) -> vector<64xi8> {
+  %0 = aievec.min %arg0, %arg1 : vector<64xi8>
+  return %0 : vector<64xi8>
+}
+
+// CHECK-LABEL: @min_i8
+// CHECK:      %[[R:.*]] = "aievec.intr.vmin.ge8"
+// CHECK-SAME:         -> !llvm.struct<(vector<64xi8>, vector<2xi32>)>
+// CHECK:      llvm.extractvalue %[[R]][0]
+
+// -----
+
+func.func @max_bf16(%arg0 : vector<32xbf16>, %arg1 : vector<32xbf16>) -> vector<32xbf16> {
+  %0 = aievec.max %arg0, %arg1 : vector<32xbf16>
+  return %0 : vector<32xbf16>
+}
+
+// CHECK-LABEL: @max_bf16
+// CHECK-SAME: %[[ARG0:.*]]: vector<32xbf16>, %[[ARG1:.*]]: vector<32xbf16>
+// CHECK:      %[[R:.*]] = "aievec.intr.vmax.ltbf16"(%[[ARG0]], %[[ARG1]]) :
+// CHECK-SAME:         (vector<32xbf16>, vector<32xbf16>)
+// CHECK-SAME:         -> !llvm.struct<(vector<32xbf16>, i32)>
+// CHECK:      llvm.extractvalue %[[R]][0]
+
+// -----
+
+func.func @broadcast_scalar(%arg0 : i16, %arg1 : bf16) -> (vector<32xi16>, vector<32xbf16>) {
+  %0 = aievec.broadcast_scalar %arg0 : i16, vector<32xi16>
+  %1 = aievec.broadcast_scalar %arg1 : bf16, vector<32xbf16>
+  return %0, %1 : vector<32xi16>, vector<32xbf16>
+}
+
+// CHECK-LABEL: @broadcast_scalar
+// CHECK-SAME: %[[ARG0:.*]]: i16, %[[ARG1:.*]]: bf16
+// CHECK:      %[[EXT:.*]] = llvm.sext %[[ARG0]] : i16 to i32
+// CHECK:      %[[B0:.*]] = "aievec.intr.vbroadcast16.I512"(%[[EXT]]) :
+// CHECK-SAME:         (i32) -> vector<32xi16>
+// CHECK:      %[[B1:.*]] = "aievec.intr.vbroadcast16.bf512"(%[[ARG1]]) :
+// CHECK-SAME:         (bf16) -> vector<32xbf16>
+// CHECK:      return %[[B0]], %[[B1]] : vector<32xi16>, vector<32xbf16>
+
+// -----
+
+func.func @broadcast(%arg0 : vector<16xi32>) -> vector<16xi32> {
+  %0 = aievec.broadcast %arg0 {idx = 3 : i8} : vector<16xi32>, vector<16xi32>
+  return %0 : vector<16xi32>
+}
+
+// CHECK-LABEL: @broadcast
+// CHECK-SAME: %[[ARG0:.*]]: vector<16xi32>
+// CHECK:      %[[IDX:.*]] = llvm.mlir.constant(3 : i32) : i32
+// CHECK:      %[[ELEM:.*]] = llvm.extractelement %[[ARG0]][%[[IDX]] : i32] : vector<16xi32>
+// CHECK:      %[[B:.*]] = "aievec.intr.vbroadcast32.I512"(%[[ELEM]]) :
+// CHECK-SAME:         (i32) -> vector<16xi32>
+// CHECK:      return %[[B]] : vector<16xi32>
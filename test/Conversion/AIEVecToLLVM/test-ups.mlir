@@ -0,0 +1,36 @@
+// RUN: aie-opt %s --convert-aievec-to-llvm | FileCheck %s
+module {
+  func.func @test(%v16i8: vector<16xi8>, %v16ui8: vector<16xui8>,
+                  %v16i16: vector<16xi16>, %v8i32: vector<8xi32>,
+                  %v8i32b: vector<8xi32>, %v8i64: vector<8xi64>) {
+    // sweep the variants of UPS and values of shift
+    %0 = aievec.ups %v16i8 {shift = 0 : i8} : vector<16xi8>, vector<16xi48>
+    %1 = aievec.ups %v16ui8 {shift = 1 : i8} : vector<16xui8>, vector<16xi48>
+    %2 = aievec.ups %v16i16 {shift = 2 : i8} : vector<16xi16>, vector<16xi48>
+    %3 = aievec.ups %v8i32 {shift = 3 : i8} : vector<8xi32>, vector<8xi48>
+    %4 = aievec.ups %v8i32b {shift = 4 : i8} : vector<8xi32>, vector<8xi80>
+    %5 = aievec.ups %v8i64 {shift = 5 : i8} : vector<8xi64>, vector<8xi80>
+    return
+  }
+}
+
+// The function declarations are in reverse order of their declarations
+// CHECK: llvm.func @llvm.aie.lups.v8acc80.v8i64(vector<8xi64>, i32) -> vector<8xi80>
+// CHECK: llvm.func @llvm.aie.ups.v8acc80.v8i32(vector<8xi32>, i32) -> vector<8xi80>
+// CHECK: llvm.func @llvm.aie.lups.v8acc48.v8i32(vector<8xi32>, i32) -> vector<8xi48>
+// CHECK: llvm.func @llvm.aie.ups.v16acc48.v16i16(vector<16xi16>, i32) -> vector<16xi48>
+// CHECK: llvm.func @llvm.aie.uups.v16acc48.v16i8(vector<16xui8>, i32) -> vector<16xi48>
+// CHECK: llvm.func @llvm.aie.bups.v16acc48.v16i8(vector<16xi8>, i32) -> vector<16xi48>
+
+// CHECK: [[SHIFT0:%.+]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK: llvm.call @llvm.aie.bups.v16acc48.v16i8(%arg0, [[SHIFT0]]) : (vector<16xi8>, i32) -> vector<16xi48>
+// CHECK: [[SHIFT1:%.+]] = llvm.mlir.constant(1 : i32) : i32
+// CHECK: llvm.call @llvm.aie.uups.v16acc48.v16i8(%arg1, [[SHIFT1]]) : (vector<16xui8>, i32) -> vector<16xi48>
+// CHECK: [[SHIFT2:%.+]] = llvm.mlir.constant(2 : i32) : i32
+// CHECK: llvm.call @llvm.aie.ups.v16acc48.v16i16(%arg2, [[SHIFT2]]) : (vector<16xi16>, i32) -> vector<16xi48>
+// CHECK: [[SHIFT3:%.+]] = llvm.mlir.constant(3 : i32) : i32
+// CHECK: llvm.call @llvm.aie.lups.v8acc48.v8i32(%arg3, [[SHIFT3]]) : (vector<8xi32>, i32) -> vector<8xi48>
+// CHECK: [[SHIFT4:%.+]] = llvm.mlir.constant(4 : i32) : i32
+// CHECK: llvm.call @llvm.aie.ups.v8acc80.v8i32(%arg4, [[SHIFT4]]) : (vector<8xi32>, i32) -> vector<8xi80>
+// CHECK: [[SHIFT5:%.+]] = llvm.mlir.constant(5 : i32) : i32
+// CHECK: llvm.call @llvm.aie.lups.v8acc80.v8i64(%arg5, [[SHIFT5]]) : (vector<8xi64>, i32) -> vector<8xi80>
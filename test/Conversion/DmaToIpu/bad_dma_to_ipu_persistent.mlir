@@ -0,0 +1,37 @@
+//===- bad_dma_to_ipu_persistent.mlir --------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -split-input-file -aie-dma-to-ipu -verify-diagnostics %s
+
+aie.device(ipu) {
+  func.func @sequence(%in : memref<1000xi32>) {
+    %c0 = arith.constant 0 : i64
+    %c1 = arith.constant 1 : i64
+    %c100 = arith.constant 100 : i64
+    // expected-error@+1 {{a ring transfer can't be persistent}}
+    aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c100][%c0,%c0,%c0]) { metadata = @of_fromMem, id = 0 : i64, ring_slots = 10 : i64, persistent } : memref<1000xi32>
+    return
+  }
+  aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+}
+
+// -----
+
+aie.device(ipu) {
+  func.func @sequence(%out : memref<1000xi32>) {
+    %c0 = arith.constant 0 : i64
+    %c1 = arith.constant 1 : i64
+    %c100 = arith.constant 100 : i64
+    // expected-error@+1 {{only MM2S transfers can be persistent}}
+    aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c100][%c0,%c0,%c0]) { metadata = @of_toMem, id = 0 : i64, persistent } : memref<1000xi32>
+    return
+  }
+  aie.shim_dma_allocation @of_toMem (S2MM, 0, 0)
+}
@@ -0,0 +1,52 @@
+//===- bad_dma_to_ipu_ring.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -split-input-file -verify-diagnostics %s
+
+aie.device(ipu) {
+  func.func @sequence(%in : memref<1000xi32>) {
+    %c0 = arith.constant 0 : i64
+    %c1 = arith.constant 1 : i64
+    %c100 = arith.constant 100 : i64
+    // expected-error@+1 {{the memref can't be divided into 3 ring slots}}
+    aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c100][%c0,%c0,%c0]) { metadata = @of_fromMem, id = 0 : i64, ring_slots = 3 : i64 } : memref<1000xi32>
+    return
+  }
+  aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+}
+
+// -----
+
+aie.device(ipu) {
+  func.func @sequence(%in : memref<1000xi32>) {
+    %c0 = arith.constant 0 : i64
+    %c1 = arith.constant 1 : i64
+    %c100 = arith.constant 100 : i64
+    // expected-error@+1 {{a doorbell needs ring_slots}}
+    aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c100][%c0,%c0,%c0]) { metadata = @of_fromMem, id = 0 : i64, doorbell = 0 : i64 } : memref<1000xi32>
+    return
+  }
+  aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+}
+
+// -----
+
+aie.device(ipu) {
+  func.func @sequence(%in : memref<1000xi32>) {
+    %c0 = arith.constant 0 : i64
+    %c1 = arith.constant 1 : i64
+    %c2 = arith.constant 2 : i64
+    %c100 = arith.constant 100 : i64
+    // expected-error@+1 {{a ring transfer can't repeat its slots, the size of the fourth dimension must be 1}}
+    aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c2,%c1,%c1,%c100][%c100,%c0,%c0]) { metadata = @of_fromMem, id = 0 : i64, ring_slots = 5 : i64 } : memref<1000xi32>
+    return
+  }
+  aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+}
@@ -0,0 +1,45 @@
+//===- bad_dma_to_ipu_split.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -aie-dma-to-ipu -split-input-file -verify-diagnostics %s
+
+// 1031 is prime, so the strided rows can't be split within the d0 wrap.
+aie.device(ipu) {
+  func.func @sequence(%in : memref<4x2048xi32>) {
+    %c0 = arith.constant 0 : i64
+    %c1 = arith.constant 1 : i64
+    %c4 = arith.constant 4 : i64
+    %c1031 = arith.constant 1031 : i64
+    %c2048 = arith.constant 2048 : i64
+    // expected-error@+2 {{access pattern can't be split to fit in the wraps and strides of a shim BD}}
+    // expected-error@+1 {{failed to legalize operation 'aiex.ipu.dma_memcpy_nd' that was explicitly marked illegal}}
+    aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c4,%c1031][%c0,%c0,%c2048]) { metadata = @of_fromMem, id = 0 : i64 } : memref<4x2048xi32>
+    return
+  }
+  aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+}
+
+// -----
+
+// The split transfer needs BD ids 0 and 1, but BD 1 is still in use.
+aie.device(ipu) {
+  func.func @sequence(%in : memref<1600xi32>, %out : memref<16xi32>) {
+    %c0 = arith.constant 0 : i64
+    %c1 = arith.constant 1 : i64
+    %c16 = arith.constant 16 : i64
+    %c100 = arith.constant 100 : i64
+    // expected-error@+1 {{needs BD ids 0 to 1, but id 1 is used by another transfer before the next sync}}
+    aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c100,%c1,%c1,%c16][%c16,%c0,%c0]) { metadata = @of_fromMem, id = 0 : i64 } : memref<1600xi32>
+    aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c16][%c0,%c0,%c0]) { metadata = @of_toMem, id = 1 : i64 } : memref<16xi32>
+    return
+  }
+  aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+  aie.shim_dma_allocation @of_toMem (S2MM, 0, 0)
+}
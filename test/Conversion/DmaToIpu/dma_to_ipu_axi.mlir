@@ -0,0 +1,38 @@
+//===- dma_to_ipu_axi.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -aie-dma-to-ipu %s | FileCheck %s
+
+// The AXI settings of a transfer end up on its BD, the other BDs keeping the
+// defaults of the shim DMAs.
+
+// CHECK-LABEL: func.func @sequence
+// CHECK:         aiex.ipu.writebd_shimtile
+// CHECK-SAME:      ax_cache = 2 : i32
+// CHECK-SAME:      ax_qos = 4 : i32
+// CHECK-SAME:      bd_id = 0 : i32
+// CHECK-SAME:      burst_length = 128 : i32
+// CHECK:         aiex.ipu.writebd_shimtile
+// CHECK-NOT:       ax_qos
+// CHECK-SAME:      bd_id = 1 : i32
+
+aie.device(ipu) {
+  func.func @sequence(%in : memref<4096xi32>, %out : memref<4096xi32>) {
+    %c0 = arith.constant 0 : i64
+    %c1 = arith.constant 1 : i64
+    %c4096 = arith.constant 4096 : i64
+    aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c4096][%c0,%c0,%c0]) { metadata = @in, id = 0 : i64, burst_length = 128 : i32, ax_cache = 2 : i32, ax_qos = 4 : i32 } : memref<4096xi32>
+    aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c4096][%c0,%c0,%c0]) { metadata = @out, id = 1 : i64 } : memref<4096xi32>
+    aiex.ipu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 0 : i32, row = 0 : i32, row_num = 1 : i32}
+    return
+  }
+  aie.shim_dma_allocation @in (MM2S, 0, 0)
+  aie.shim_dma_allocation @out (S2MM, 0, 0)
+}
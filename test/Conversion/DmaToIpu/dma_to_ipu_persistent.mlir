@@ -0,0 +1,48 @@
+//===- dma_to_ipu_persistent.mlir ------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -aie-dma-to-ipu %s | FileCheck %s --check-prefix=FIRST
+// RUN: aie-opt -aie-dma-to-ipu="skip-persistent=true" %s | FileCheck %s --check-prefix=RESIDENT
+
+// The first run moves the weights, the runs that follow only the inputs and
+// the outputs.
+
+// FIRST-LABEL: func.func @sequence
+// FIRST:         aiex.ipu.writebd_shimtile
+// FIRST-SAME:      bd_id = 0 : i32
+// FIRST:         aiex.ipu.writebd_shimtile
+// FIRST-SAME:      bd_id = 1 : i32
+// FIRST:         aiex.ipu.writebd_shimtile
+// FIRST-SAME:      bd_id = 2 : i32
+
+// RESIDENT-LABEL: func.func @sequence
+// RESIDENT-NOT:     bd_id = 0 : i32
+// RESIDENT:         aiex.ipu.writebd_shimtile
+// RESIDENT-SAME:      bd_id = 1 : i32
+// RESIDENT:         aiex.ipu.writebd_shimtile
+// RESIDENT-SAME:      bd_id = 2 : i32
+// RESIDENT-NOT:     aiex.ipu.writebd_shimtile
+
+aie.device(ipu) {
+  func.func @sequence(%weights : memref<4096xi32>, %in : memref<1024xi32>, %out : memref<1024xi32>) {
+    %c0 = arith.constant 0 : i64
+    %c1 = arith.constant 1 : i64
+    %c1024 = arith.constant 1024 : i64
+    %c4096 = arith.constant 4096 : i64
+    aiex.ipu.dma_memcpy_nd (0, 0, %weights[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c4096][%c0,%c0,%c0]) { metadata = @weights, id = 0 : i64, persistent } : memref<4096xi32>
+    aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c1024][%c0,%c0,%c0]) { metadata = @in, id = 1 : i64 } : memref<1024xi32>
+    aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c1024][%c0,%c0,%c0]) { metadata = @out, id = 2 : i64 } : memref<1024xi32>
+    aiex.ipu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 0 : i32, row = 0 : i32, row_num = 1 : i32}
+    return
+  }
+  aie.shim_dma_allocation @weights (MM2S, 1, 0)
+  aie.shim_dma_allocation @in (MM2S, 0, 0)
+  aie.shim_dma_allocation @out (S2MM, 0, 0)
+}
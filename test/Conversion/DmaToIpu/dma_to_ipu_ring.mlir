@@ -0,0 +1,57 @@
+//===- dma_to_ipu_ring.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -aie-dma-to-ipu %s | FileCheck %s
+
+// The input ring has four slots of 1024 words, each moved by a BD acquiring
+// the doorbell lock, chained in a cycle and pushed once.
+// CHECK-LABEL: func.func @stream
+// CHECK: aiex.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 0 : i32, buffer_length = 1024 : i32, buffer_offset = 0 : i32
+// CHECK-SAME: lock_acq_enable = 1 : i32, lock_acq_id = 1 : i32, lock_acq_val = -1 : i32
+// CHECK-SAME: next_bd = 1 : i32
+// CHECK-SAME: use_next_bd = 1 : i32
+// CHECK: aiex.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 1 : i32, buffer_length = 1024 : i32, buffer_offset = 4096 : i32
+// CHECK-SAME: next_bd = 2 : i32
+// CHECK: aiex.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 2 : i32, buffer_length = 1024 : i32, buffer_offset = 8192 : i32
+// CHECK-SAME: next_bd = 3 : i32
+// CHECK: aiex.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 3 : i32, buffer_length = 1024 : i32, buffer_offset = 12288 : i32
+// CHECK-SAME: next_bd = 0 : i32
+// CHECK-SAME: use_next_bd = 1 : i32
+// CHECK: aiex.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 0 : ui32}
+
+// The output ring has no doorbell, and never issues a token.
+// CHECK: aiex.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 4 : i32, buffer_length = 1024 : i32, buffer_offset = 0 : i32
+// CHECK-SAME: lock_acq_enable = 0 : i32
+// CHECK-SAME: next_bd = 5 : i32
+// CHECK: aiex.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 5 : i32, buffer_length = 1024 : i32, buffer_offset = 4096 : i32
+// CHECK-SAME: next_bd = 4 : i32
+// CHECK: aiex.ipu.write32 {address = 119300 : ui32, column = 0 : i32, row = 0 : i32, value = 4 : ui32}
+// CHECK-NOT: aiex.ipu.write32
+
+module {
+  aie.device(ipu) {
+    func.func @stream(%in : memref<4096xi32>, %out : memref<2048xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c1024 = arith.constant 1024 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c1024][%c0,%c0,%c0]) { metadata = @of_fromMem, id = 0 : i64, ring_slots = 4 : i64, doorbell = 1 : i64 } : memref<4096xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c1024][%c0,%c0,%c0]) { metadata = @of_toMem, id = 4 : i64, ring_slots = 2 : i64 } : memref<2048xi32>
+      return
+    }
+    aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+    aie.shim_dma_allocation @of_toMem (S2MM, 0, 0)
+  }
+}
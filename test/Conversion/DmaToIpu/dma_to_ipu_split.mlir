@@ -0,0 +1,94 @@
+//===- dma_to_ipu_split.mlir -----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -aie-dma-to-ipu %s | FileCheck %s
+
+// A contiguous 1920x1080 image is transferred as one linear BD.
+// CHECK-LABEL: func.func @linear
+// CHECK: aiex.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 0 : i32, buffer_length = 2073600 : i32
+// CHECK-SAME: d0_size = 0 : i32, d0_stride = 0 : i32, d1_size = 0 : i32, d1_stride = 0 : i32
+// CHECK: aiex.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 0 : ui32}
+
+// 128 repetitions of the same data reuse one BD, pushed twice.
+// CHECK-LABEL: func.func @repeat
+// CHECK: aiex.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 0 : i32, buffer_length = 32 : i32
+// CHECK-SAME: d0_size = 8 : i32, d0_stride = 0 : i32, d1_size = 2 : i32, d1_stride = 7 : i32, d2_stride = 15 : i32
+// CHECK-NOT: aiex.ipu.writebd_shimtile
+// CHECK: aiex.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 4128768 : ui32}
+// CHECK: aiex.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 4128768 : ui32}
+
+// 100 iterations stepping through memory are split into 64 and 36 iterations
+// on consecutive BDs.  Only the last one issues a token.
+// CHECK-LABEL: func.func @iterate
+// CHECK: aiex.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 2 : i32, buffer_length = 16 : i32, buffer_offset = 0 : i32
+// CHECK-SAME: iteration_size = 63 : i32, iteration_stride = 15 : i32
+// CHECK: aiex.ipu.write32 {address = 119300 : ui32, column = 0 : i32, row = 0 : i32, value = 4128770 : ui32}
+// CHECK: aiex.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 3 : i32, buffer_length = 16 : i32, buffer_offset = 4096 : i32
+// CHECK-SAME: iteration_size = 35 : i32, iteration_stride = 15 : i32
+// CHECK: aiex.ipu.write32 {address = 119300 : ui32, column = 0 : i32, row = 0 : i32, value = 2149777411 : ui32}
+
+// An outer stride beyond the iteration stride gives one BD per repetition,
+// chained together and pushed once.
+// CHECK-LABEL: func.func @chain
+// CHECK: aiex.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 4 : i32, buffer_length = 16 : i32, buffer_offset = 0 : i32
+// CHECK-SAME: next_bd = 5 : i32
+// CHECK-SAME: use_next_bd = 1 : i32
+// CHECK: aiex.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 5 : i32, buffer_length = 16 : i32, buffer_offset = 8388608 : i32
+// CHECK-SAME: next_bd = 0 : i32
+// CHECK-SAME: use_next_bd = 0 : i32
+// CHECK: aiex.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 4 : ui32}
+// CHECK-NOT: aiex.ipu.write32
+
+module {
+  aie.device(ipu) {
+    func.func @linear(%in : memref<1920x1080xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c1920 = arith.constant 1920 : i64
+      %c1080 = arith.constant 1080 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1080,%c1920][%c0,%c0,%c1920]) { metadata = @of_fromMem, id = 0 : i64 } : memref<1920x1080xi32>
+      return
+    }
+    func.func @repeat(%in : memref<128x4x2x8xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c2 = arith.constant 2 : i64
+      %c8 = arith.constant 8 : i64
+      %c16 = arith.constant 16 : i64
+      %c128 = arith.constant 128 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c128,%c2,%c2,%c8][%c0,%c16,%c8]) { metadata = @of_fromMem, id = 0 : i64 } : memref<128x4x2x8xi32>
+      return
+    }
+    func.func @iterate(%out : memref<1600xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c16 = arith.constant 16 : i64
+      %c100 = arith.constant 100 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c100,%c1,%c1,%c16][%c16,%c0,%c0]) { metadata = @of_toMem, id = 2 : i64 } : memref<1600xi32>
+      return
+    }
+    func.func @chain(%in : memref<4194304xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c2 = arith.constant 2 : i64
+      %c16 = arith.constant 16 : i64
+      %c2097152 = arith.constant 2097152 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c2,%c1,%c1,%c16][%c2097152,%c0,%c0]) { metadata = @of_fromMem, id = 4 : i64 } : memref<4194304xi32>
+      return
+    }
+    aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+    aie.shim_dma_allocation @of_toMem (S2MM, 0, 0)
+  }
+}
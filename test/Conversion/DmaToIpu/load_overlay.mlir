@@ -0,0 +1,39 @@
+//===- load_overlay.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %PYTHON -c "import sys; open(sys.argv[1], 'wb').write(bytes(range(1, 11)))" %t/core_0_2.overlay1.bin
+// RUN: aie-opt --aie-dma-to-ipu=overlay-dir=%t %s | FileCheck %s
+// RUN: aie-opt --aie-dma-to-ipu -verify-diagnostics %s
+
+// The 10 bytes of the overlay are written by words, the last one padded with
+// zeros, at the start of the last 8KB of the 16KB of program memory, at
+// 0x20000 in the tile. The lock is set once the code is loaded.
+// CHECK:      aiex.ipu.write32 {address = 139264 : ui32, column = 0 : i32, row = 2 : i32, value = 67305985 : ui32}
+// CHECK-NEXT: aiex.ipu.write32 {address = 139268 : ui32, column = 0 : i32, row = 2 : i32, value = 134678021 : ui32}
+// CHECK-NEXT: aiex.ipu.write32 {address = 139272 : ui32, column = 0 : i32, row = 2 : i32, value = 2569 : ui32}
+// CHECK-NEXT: aiex.ipu.write32 {address = 127024 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+// CHECK-NOT:  aiex.ipu.load_overlay
+
+module {
+  aie.device(ipu) {
+    %tile_0_2 = aie.tile(0, 2)
+    %lock_0_2 = aie.lock(%tile_0_2, 3) {init = 0 : i32, sym_name = "overlay_ready"}
+    %core_0_2 = aie.core(%tile_0_2) {
+      aie.end
+    } {overlays = ["conv.o", "pool.o"], overlay_size = 8192 : i32}
+    func.func @sequence() {
+      // expected-error@+2 {{'aiex.ipu.load_overlay' op the overlays are only known once the cores are linked, lower with overlay-dir}}
+      // expected-error@+1 {{failed to legalize operation 'aiex.ipu.load_overlay' that was explicitly marked illegal}}
+      aiex.ipu.load_overlay(0, 2, 1) {lock = @overlay_ready}
+      return
+    }
+  }
+}
@@ -0,0 +1,38 @@
+//===- rtp_double_buffer.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-dma-to-ipu %s | FileCheck %s --check-prefix=IR
+// RUN: aie-opt --aie-dma-to-ipu %s | aie-translate --aie-ipu-patchgen | FileCheck %s
+
+// The RTP buffer holds two copies of 64 bytes, selected by %slot. The
+// threshold is increased by %threshold, and the lock is set once the last
+// word is written.
+// IR: aiex.ipu.write32 {address = 1536 : ui32, address_params = array<i64: 0, 64>, column = 0 : i32, row = 2 : i32, value = 50 : ui32, value_params = array<i64: 1, 1>}
+// IR: aiex.ipu.write32 {address = 1540 : ui32, address_params = array<i64: 0, 64>, column = 0 : i32, row = 2 : i32, value = 255 : ui32}
+// IR: aiex.ipu.write32 {address = 127024 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+
+// The first write follows the 17 words of the prolog, and the second one the
+// 3 words of the first.
+// CHECK: 18 0 64
+// CHECK-NEXT: 19 1 1
+// CHECK-NEXT: 21 0 64
+
+module {
+  aie.device(ipu) {
+    %tile_0_2 = aie.tile(0, 2)
+    %rtp = aie.buffer(%tile_0_2) {address = 1536 : i32, sym_name = "rtp"} : memref<32xi32>
+    %rtp_lock = aie.lock(%tile_0_2, 3) {sym_name = "rtp_lock"}
+    func.func @sequence(%slot : i64, %threshold : i64) {
+      aiex.ipu.rtp_write(0, 2, 0, 50) param(%threshold) slot(%slot) { buffer_sym_name = "rtp" }
+      aiex.ipu.rtp_write(0, 2, 1, 255) slot(%slot) { buffer_sym_name = "rtp", lock = @rtp_lock }
+      return
+    }
+  }
+}
@@ -0,0 +1,22 @@
+// RUN: aie-opt %s --convert-tosa-to-aievec="aie-target=aieml vector-size=64" | FileCheck %s
+// RUN: aie-opt %s --convert-tosa-to-aievec="aie-target=aieml vector-size=64 tile-size=256" | FileCheck %s --check-prefix=TILED
+
+// CHECK-LABEL: func.func @dut(%arg0: memref<1024xi8>, %arg1: memref<1024xi8>, %arg2: memref<1024xi8>) {
+// CHECK-DAG:     %[[C0:.*]] = arith.constant 0 : index
+// CHECK-DAG:     %[[C1024:.*]] = arith.constant 1024 : index
+// CHECK-DAG:     %[[C64:.*]] = arith.constant 64 : index
+// CHECK:         scf.for %[[I:.*]] = %[[C0]] to %[[C1024]] step %[[C64]] {
+// CHECK:           %[[A:.*]] = aievec.upd %arg0[%[[I]]] {{.*}} : memref<1024xi8>, vector<64xi8>
+// CHECK:           %[[B:.*]] = aievec.upd %arg1[%[[I]]] {{.*}} : memref<1024xi8>, vector<64xi8>
+// CHECK:           %[[S:.*]] = aievec.add_elem %[[A]], %[[B]] : vector<64xi8>
+// CHECK:           vector.transfer_write %[[S]], %arg2[%[[I]]]
+
+// TILED-LABEL: func.func @dut(
+// TILED:         scf.for %[[T:.*]] = %{{.*}} to %{{.*}} step %{{.*}} {
+// TILED:           scf.for %[[I:.*]] = %[[T]] to %{{.*}} step %{{.*}} {
+// TILED:             aievec.upd %arg0[%[[I]]]
+// TILED:             aievec.add_elem {{.*}} : vector<64xi8>
+func.func @dut(%arg0: tensor<1024xi8>, %arg1: tensor<1024xi8>) -> (tensor<1024xi8>) {
+  %0 = "tosa.add"(%arg0, %arg1) : (tensor<1024xi8>, tensor<1024xi8>) -> (tensor<1024xi8>)
+  return %0 : tensor<1024xi8>
+}
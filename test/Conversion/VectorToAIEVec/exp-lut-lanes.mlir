@@ -0,0 +1,26 @@
+// RUN: aie-opt %s --convert-vector-to-aievec="aie-target=aieml" | FileCheck %s
+// RUN: aie-opt %s --convert-vector-to-aievec="aie-target=aieml exp-lut-lanes=32" | FileCheck %s --check-prefix=LANES32
+
+// CHECK-LABEL: func.func @exp_16
+// CHECK:         %[[E:.*]] = emitc.call_opaque "getExpBf16"(%{{.*}}) : (vector<16xbf16>) -> vector<16xf32>
+// CHECK:         aievec.srs %[[E]], %{{.*}} : vector<16xf32>, i32, vector<16xbf16>
+// LANES32-LABEL: func.func @exp_16
+// LANES32:         emitc.call_opaque "getExpBf16"(%{{.*}}) : (vector<16xbf16>) -> vector<16xf32>
+func.func @exp_16(%x: vector<16xbf16>) -> vector<16xbf16> {
+  %0 = math.exp %x : vector<16xbf16>
+  return %0 : vector<16xbf16>
+}
+
+// The 32-lane exponentials are only lowered to the 32-lane LUT variant when
+// it is selected.
+
+// CHECK-LABEL: func.func @exp_32
+// CHECK:         math.exp %{{.*}} : vector<32xbf16>
+// CHECK-NOT:     getExpBf16
+// LANES32-LABEL: func.func @exp_32
+// LANES32:         %[[E:.*]] = emitc.call_opaque "getExpBf16"(%{{.*}}) : (vector<32xbf16>) -> vector<32xf32>
+// LANES32:         aievec.srs %[[E]], %{{.*}} : vector<32xf32>, i32, vector<32xbf16>
+func.func @exp_32(%x: vector<32xbf16>) -> vector<32xbf16> {
+  %0 = math.exp %x : vector<32xbf16>
+  return %0 : vector<32xbf16>
+}
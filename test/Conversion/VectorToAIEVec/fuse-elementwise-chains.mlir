@@ -0,0 +1,41 @@
+// RUN: aie-opt %s --convert-vector-to-aievec="aie-target=aieml fuse-srs-into-ups" | FileCheck %s
+// RUN: aie-opt %s --convert-vector-to-aievec="aie-target=aieml" | FileCheck %s --check-prefix=ROUND
+
+// The accumulator of the LUT-based exp feeds the addition directly, without
+// going through a bf16 vector. By default, the exp is rounded to bf16 first.
+
+// ROUND-LABEL: func.func @exp_add
+// ROUND:         %[[E:.*]] = emitc.call_opaque "getExpBf16"
+// ROUND:         %[[S:.*]] = aievec.srs %[[E]]
+// ROUND:         %[[U:.*]] = aievec.ups %[[S]]
+// ROUND:         aievec.add_elem %[[U]]
+
+// CHECK-LABEL: func.func @exp_add
+// CHECK-SAME:      %[[X:[A-Za-z0-9]+]]: vector<16xbf16>, %[[B:[A-Za-z0-9]+]]: vector<16xbf16>
+// CHECK:         %[[E:.*]] = emitc.call_opaque "getExpBf16"(%[[X]]) : (vector<16xbf16>) -> vector<16xf32>
+// CHECK-NOT:     aievec.srs
+// CHECK:         %[[BUPS:.*]] = aievec.ups %[[B]] {shift = 0 : i8} : vector<16xbf16>, vector<16xf32>
+// CHECK:         %[[ADD:.*]] = aievec.add_elem %[[E]], %[[BUPS]] : vector<16xf32>
+// CHECK:         %[[R:.*]] = aievec.srs %[[ADD]], %{{.*}} : vector<16xf32>, i32, vector<16xbf16>
+// CHECK:         return %[[R]]
+func.func @exp_add(%x: vector<16xbf16>, %b: vector<16xbf16>) -> vector<16xbf16> {
+  %0 = math.exp %x : vector<16xbf16>
+  %1 = arith.addf %0, %b : vector<16xbf16>
+  return %1 : vector<16xbf16>
+}
+
+// When the rounded exp is also stored, the addition still takes the
+// accumulator.
+
+// CHECK-LABEL: func.func @exp_add_store
+// CHECK:         %[[E:.*]] = emitc.call_opaque "getExpBf16"
+// CHECK:         %[[S:.*]] = aievec.srs %[[E]]
+// CHECK:         aievec.add_elem %[[E]]
+// CHECK:         vector.transfer_write %[[S]]
+func.func @exp_add_store(%x: vector<16xbf16>, %b: vector<16xbf16>, %m: memref<16xbf16>) -> vector<16xbf16> {
+  %c0 = arith.constant 0 : index
+  %0 = math.exp %x : vector<16xbf16>
+  %1 = arith.addf %0, %b : vector<16xbf16>
+  vector.transfer_write %0, %m[%c0] {in_bounds = [true]} : vector<16xbf16>, memref<16xbf16>
+  return %1 : vector<16xbf16>
+}
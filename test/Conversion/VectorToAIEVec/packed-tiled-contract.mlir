@@ -0,0 +1,46 @@
+// RUN: aie-opt %s -canonicalize-vector-for-aievec=aie-target=aieml | FileCheck %s
+// RUN: aie-opt %s -convert-vector-to-aievec="aie-target=aieml target-backend=llvmir" | FileCheck %s --check-prefix=CHECK-LLVM
+
+#mapA = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d2, d3, d5)>
+#mapB = affine_map<(d0, d1, d2, d3, d4, d5) -> (d2, d1, d5, d4)>
+#mapC = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d1, d3, d4)>
+
+// A contraction of 2x2 blocks of 4x8 i8 by 2x2 blocks of 8x8 i8, in a packed
+// layout, is unrolled over the blocks, with its reads, extensions and writes,
+// into eight 4x8x8 matmuls.
+
+// CHECK-LABEL: func.func @contract_packed_i8(
+// CHECK-COUNT-8: vector.contract {{.*}} : vector<1x1x4x8xi32>, vector<1x1x8x8xi32> into vector<1x1x4x8xi32>
+// CHECK-NOT:     vector.contract
+// CHECK-COUNT-4: vector.transfer_write {{.*}} : vector<32xi32>, memref<128xi32>
+
+// CHECK-LLVM-LABEL: func.func @contract_packed_i8(
+// CHECK-LLVM-COUNT-8: aievec.matmul {{.*}} : vector<4x8xi8>, vector<8x8xi8> into vector<4x8xi32>
+// CHECK-LLVM-NOT:     vector.contract
+func.func @contract_packed_i8(%A : memref<2x2x4x8xi8>,
+                              %B : memref<2x2x8x8xi8>,
+                              %C : memref<2x2x4x8xi32>) {
+  %c0 = arith.constant 0 : index
+  %c0_i8 = arith.constant 0 : i8
+  %c0_i32 = arith.constant 0 : i32
+  %0 = vector.transfer_read %A[%c0, %c0, %c0, %c0], %c0_i8
+          {in_bounds = [true, true, true, true]}
+          : memref<2x2x4x8xi8>, vector<2x2x4x8xi8>
+  %1 = vector.transfer_read %B[%c0, %c0, %c0, %c0], %c0_i8
+          {in_bounds = [true, true, true, true]}
+          : memref<2x2x8x8xi8>, vector<2x2x8x8xi8>
+  %2 = vector.transfer_read %C[%c0, %c0, %c0, %c0], %c0_i32
+          {in_bounds = [true, true, true, true]}
+          : memref<2x2x4x8xi32>, vector<2x2x4x8xi32>
+  %3 = arith.extsi %0 : vector<2x2x4x8xi8> to vector<2x2x4x8xi32>
+  %4 = arith.extsi %1 : vector<2x2x8x8xi8> to vector<2x2x8x8xi32>
+  %5 = vector.contract {indexing_maps = [#mapA, #mapB, #mapC],
+                        iterator_types = ["parallel", "parallel", "reduction",
+                                          "parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %3, %4, %2
+          : vector<2x2x4x8xi32>, vector<2x2x8x8xi32> into vector<2x2x4x8xi32>
+  vector.transfer_write %5, %C[%c0, %c0, %c0, %c0]
+          {in_bounds = [true, true, true, true]}
+          : vector<2x2x4x8xi32>, memref<2x2x4x8xi32>
+  return
+}
@@ -175,3 +175,31 @@ func.func @contracti64i64i64(%A : vector<4x2xi32>,
   return %2 : vector<4x4xi64>
 }
 
+
+// CHECK-LABEL: func.func @contracti8i4i32(
+// CHECK-SAME: %[[A:[a-zA-Z0-9]+]]: vector<4x16xi8>,
+// CHECK-SAME: %[[B:[a-zA-Z0-9]+]]: vector<16x8xi4>,
+// CHECK-SAME: %[[C:[a-zA-Z0-9]+]]: vector<4x8xi32>) -> vector<4x8xi32> {
+// CHECK:        %[[ACC:.*]] = aievec.cast %[[C]] {isResAcc = true} : vector<4x8xi32>, vector<4x8xi32>
+// CHECK:        %[[MM:.*]] = aievec.matmul %[[A]], %[[B]], %[[ACC]] :
+// CHECK-SAME:   vector<4x16xi8>, vector<16x8xi4> into vector<4x8xi32>
+// CHECK:        %[[R:.*]] = aievec.cast %[[MM]] {isResAcc = false} : vector<4x8xi32>, vector<4x8xi32>
+// CHECK:        return %[[R]] : vector<4x8xi32>
+
+// CHECK-LLVM-LABEL: func.func @contracti8i4i32(
+// CHECK-LLVM-SAME: %[[A:[a-zA-Z0-9]+]]: vector<4x16xi8>,
+// CHECK-LLVM-SAME: %[[B:[a-zA-Z0-9]+]]: vector<16x8xi4>,
+// CHECK-LLVM-SAME: %[[C:[a-zA-Z0-9]+]]: vector<4x8xi32>) -> vector<4x8xi32> {
+// CHECK-LLVM:        %[[MM:.*]] = aievec.matmul %[[A]], %[[B]], %[[C]] :
+// CHECK-LLVM-SAME:   vector<4x16xi8>, vector<16x8xi4> into vector<4x8xi32>
+// CHECK-LLVM:        return %[[MM]] : vector<4x8xi32>
+func.func @contracti8i4i32(%A : vector<4x16xi8>,
+                           %B : vector<16x8xi4>,
+                           %C : vector<4x8xi32>) -> vector<4x8xi32> {
+  %0 = arith.extsi %B : vector<16x8xi4> to vector<16x8xi8>
+  %1 = vector.contract {indexing_maps = [#map1, #map2, #map3],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %A, %0, %C :
+                        vector<4x16xi8>, vector<16x8xi8> into vector<4x8xi32>
+  return %1 : vector<4x8xi32>
+}
@@ -0,0 +1,53 @@
+// RUN: aie-opt %s --convert-vector-to-aievec="aie-target=aieml shift=10" | FileCheck %s
+
+// The five taps of a row of a 5x5 filter do not fit in a 4-tap i16
+// convolution: the first four are folded into a mul_conv, and the fifth into
+// an fma_conv of the signal and the filter shifted by four elements.
+
+func.func @conv2d_5tap(%arg0: memref<16x288xi16>, %arg1: memref<16xi16>, %arg2: memref<16x256xi16>) {
+  %c0 = arith.constant 0 : index
+  %c2_i32 = arith.constant 2 : i32
+  %c4_i32 = arith.constant 4 : i32
+  %c6_i32 = arith.constant 6 : i32
+  %c8_i32 = arith.constant 8 : i32
+  affine.for %arg3 = 0 to 16 {
+    affine.for %arg4 = 0 to 256 step 16 {
+      %0 = aievec.upd %arg0[%arg3, %arg4] {index = 0 : i8, offset = 0 : i32} : memref<16x288xi16>, vector<32xi16>
+      %sbh = aievec.ext %0 {index = 0 : i8} : vector<32xi16>, vector<16xi16>
+      %sth = aievec.ext %0 {index = 1 : i8} : vector<32xi16>, vector<16xi16>
+      %1 = aievec.upd %arg1[%c0] {index = 0 : i8, offset = 0 : i32} : memref<16xi16>, vector<16xi16>
+      %2 = aievec.broadcast %1 {idx = 0 : i8} : vector<16xi16>, vector<16xi16>
+      %3 = arith.muli %sbh, %2 : vector<16xi16>
+      %s1 = aievec.shift %sbh, %sth, %c2_i32 {isAcc = false} : vector<16xi16>, vector<16xi16>, i32, vector<16xi16>
+      %b1 = aievec.broadcast %1 {idx = 1 : i8} : vector<16xi16>, vector<16xi16>
+      %m1 = arith.muli %s1, %b1 : vector<16xi16>
+      %a1 = arith.addi %3, %m1 : vector<16xi16>
+      %s2 = aievec.shift %sbh, %sth, %c4_i32 {isAcc = false} : vector<16xi16>, vector<16xi16>, i32, vector<16xi16>
+      %b2 = aievec.broadcast %1 {idx = 2 : i8} : vector<16xi16>, vector<16xi16>
+      %m2 = arith.muli %s2, %b2 : vector<16xi16>
+      %a2 = arith.addi %a1, %m2 : vector<16xi16>
+      %s3 = aievec.shift %sbh, %sth, %c6_i32 {isAcc = false} : vector<16xi16>, vector<16xi16>, i32, vector<16xi16>
+      %b3 = aievec.broadcast %1 {idx = 3 : i8} : vector<16xi16>, vector<16xi16>
+      %m3 = arith.muli %s3, %b3 : vector<16xi16>
+      %a3 = arith.addi %a2, %m3 : vector<16xi16>
+      %s4 = aievec.shift %sbh, %sth, %c8_i32 {isAcc = false} : vector<16xi16>, vector<16xi16>, i32, vector<16xi16>
+      %b4 = aievec.broadcast %1 {idx = 4 : i8} : vector<16xi16>, vector<16xi16>
+      %m4 = arith.muli %s4, %b4 : vector<16xi16>
+      %a4 = arith.addi %a3, %m4 : vector<16xi16>
+      vector.transfer_write %a4, %arg2[%arg3, %arg4] {in_bounds = [true]} : vector<16xi16>, memref<16x256xi16>
+    }
+  }
+  return
+}
+
+// CHECK-LABEL: func @conv2d_5tap
+//  CHECK-SAME: %[[A0:[A-Za-z0-9]+]]: memref<16x288xi16>
+//       CHECK:    %[[F:.*]] = aievec.concat %{{.*}}, %{{.*}} : vector<16xi16>, vector<32xi16>
+//       CHECK:    affine.for
+//       CHECK:      affine.for
+//       CHECK:        %[[S:.*]] = aievec.upd %[[A0]]
+//       CHECK:        %[[P:.*]] = aievec.mul_conv %[[S]], %[[F]] {M = 16 : i32, N = 4 : i32} : vector<32xi16>, vector<32xi16>, vector<16xi64>
+//       CHECK:        %[[S4:.*]] = aievec.shift %[[S]], %[[S]], %{{.*}} {isAcc = false} : vector<32xi16>, vector<32xi16>, i32, vector<32xi16>
+//       CHECK:        %[[R:.*]] = aievec.fma_conv %[[S4]], %{{.*}}, %[[P]] {M = 16 : i32, N = 4 : i32} : vector<32xi16>, vector<32xi16>, vector<16xi64>
+//   CHECK-NOT:        aievec.fma_conv
+//       CHECK:        aievec.srs %[[R]]
@@ -0,0 +1,10 @@
+// RUN: aie-opt %s -convert-vector-to-aievec=aie-target=aieml | FileCheck %s
+
+// CHECK-LABEL: func.func @extsi_i4_i8(
+// CHECK-SAME: %[[A:[a-zA-Z0-9]+]]: vector<64xi4>) -> vector<64xi8> {
+// CHECK:        %[[R:.*]] = aievec.unpack %[[A]] : vector<64xi4>, vector<64xi8>
+// CHECK:        return %[[R]] : vector<64xi8>
+func.func @extsi_i4_i8(%A : vector<64xi4>) -> vector<64xi8> {
+  %0 = arith.extsi %A : vector<64xi4> to vector<64xi8>
+  return %0 : vector<64xi8>
+}
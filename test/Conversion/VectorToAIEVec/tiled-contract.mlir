@@ -0,0 +1,25 @@
+// RUN: aie-opt %s -canonicalize-vector-for-aievec=aie-target=aieml | FileCheck %s
+
+#map1 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map3 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// An 8x16x8 bf16 contraction is split into 2x2 tiles of the accumulator, each
+// accumulated by two 4x8x4 contractions along K.
+
+// CHECK-LABEL: func.func @contract_bf16_8x16x8(
+// CHECK:         %[[P0:.*]] = vector.contract {{.*}} : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+// CHECK:         %[[P1:.*]] = vector.contract {{.*}}, %[[P0]] : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+// CHECK:         vector.insert_strided_slice %[[P1]]
+// CHECK-COUNT-6: vector.contract {{.*}} : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+// CHECK-NOT:     vector.contract
+// CHECK:         return
+func.func @contract_bf16_8x16x8(%A : vector<8x16xbf16>,
+                                %B : vector<16x8xbf16>,
+                                %C : vector<8x8xf32>) -> vector<8x8xf32> {
+  %0 = vector.contract {indexing_maps = [#map1, #map2, #map3],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %A, %B, %C :
+                        vector<8x16xbf16>, vector<16x8xbf16> into vector<8x8xf32>
+  return %0 : vector<8x8xf32>
+}
@@ -0,0 +1,51 @@
+//===- adf_bad_constraints.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --adf-generate-cpp-graph --split-input-file --verify-diagnostics %s -o /dev/null
+
+module {
+    func.func private @kfunc1(%in1 : !ADF.stream<!ADF.int32>)
+                             ->(!ADF.stream<!ADF.int32>)
+
+    ADF.graph("badRatio") {
+        %gi = ADF.input_port("gin") [1:i1, -1:i32] -> !ADF.interface<!ADF.int32>
+        // expected-error@+1 {{'ADF.kernel' op runtime_ratio must be in (0, 1]}}
+        %1 = ADF.kernel @kfunc1(%gi) {runtime_ratio = 1.5 : f64} : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+        %go = ADF.output_port("gout") %1 : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+    }
+}
+
+// -----
+
+module {
+    func.func private @kfunc1(%in1 : !ADF.stream<!ADF.int32>)
+                             ->(!ADF.stream<!ADF.int32>)
+
+    ADF.graph("badLocation") {
+        %gi = ADF.input_port("gin") [1:i1, -1:i32] -> !ADF.interface<!ADF.int32>
+        // expected-error@+1 {{'ADF.kernel' op location must be [col, row]}}
+        %1 = ADF.kernel @kfunc1(%gi) {location = array<i32: 2>} : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+        %go = ADF.output_port("gout") %1 : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+    }
+}
+
+// -----
+
+module {
+    func.func private @kfunc1(%in1 : !ADF.stream<!ADF.int32>)
+                             ->(!ADF.stream<!ADF.int32>)
+
+    ADF.graph("badBuffers") {
+        %gi = ADF.input_port("gin") [1:i1, -1:i32] -> !ADF.interface<!ADF.int32>
+        // expected-error@+1 {{'ADF.kernel' op buffer_locations must have one entry per kernel input}}
+        %1 = ADF.kernel @kfunc1(%gi) {buffer_locations = [array<i32>, array<i32>]} : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+        %go = ADF.output_port("gout") %1 : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+    }
+}
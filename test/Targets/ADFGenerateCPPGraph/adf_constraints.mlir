@@ -0,0 +1,37 @@
+//===- adf_constraints.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --adf-generate-cpp-graph %s | FileCheck %s
+
+// CHECK:       class constrained : public graph {
+// CHECK:           source(k1) = "kernels.cc";
+// CHECK-NEXT:      runtime<ratio>(k1) = 0.8;
+// CHECK-NEXT:      location<kernel>(k1) = tile(2, 3);
+// CHECK-NEXT:      stack_size(k1) = 2048;
+// CHECK-NEXT:      source(k2) = "kernels.cc";
+// CHECK-NEXT:      runtime<ratio>(k2) = 0.1;
+// CHECK-NEXT:      location<buffer>(k2.in[1]) = bank(2, 4, 1);
+// CHECK-NEXT:    }
+
+module {
+    func.func private @kfunc1(%in1 : !ADF.window<!ADF.int32, 128, 0>)
+                             ->(!ADF.window<!ADF.int32, 128, 0>)
+
+    func.func private @kfunc2(%in1 : !ADF.window<!ADF.int32, 128, 0>,
+                              %in2 : !ADF.window<!ADF.int32, 128, 0>)
+                             ->(!ADF.window<!ADF.int32, 128, 0>)
+
+    ADF.graph("constrained") {
+        %gi = ADF.input_port("gin") [1:i1, -1:i32] -> !ADF.interface<!ADF.int32>
+        %1 = ADF.kernel @kfunc1(%gi) {location = array<i32: 2, 3>, runtime_ratio = 0.8 : f64, stack_size = 2048 : i32} : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+        %2 = ADF.kernel @kfunc2(%gi, %1) {buffer_locations = [array<i32>, array<i32: 2, 4, 1>]} : (!ADF.interface<!ADF.int32>, !ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+        %go = ADF.output_port("gout") %2 : (!ADF.interface<!ADF.int32>) -> !ADF.interface<!ADF.int32>
+    }
+}
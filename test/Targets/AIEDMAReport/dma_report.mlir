@@ -0,0 +1,136 @@
+//===- dma_report.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-dma-report %s | FileCheck %s
+// RUN: aie-translate --aie-dma-report --verify-diagnostics %s -o /dev/null
+
+// The memtile sends twice as much as it receives, so its S2MM channel,
+// waiting on the locks released by its MM2S channel, stalls for the
+// difference.
+
+// CHECK:      "channels": [
+// CHECK:          "bds": 1,
+// CHECK-NEXT:     "bytes": 512,
+// CHECK-NEXT:     "channel": "mem (2, 2) S2MM0",
+// CHECK-NEXT:     "cycles": 128,
+// CHECK-NEXT:     "occupancy_percent": 6,
+// CHECK-NEXT:     "stall_cycles": 0,
+// CHECK-NEXT:     "waits_on": [
+// CHECK-NEXT:       "core (2, 2)"
+// CHECK-NEXT:     ]
+// CHECK:          "bds": 1,
+// CHECK-NEXT:     "bytes": 512,
+// CHECK-NEXT:     "channel": "mem (2, 2) MM2S0",
+// CHECK-NEXT:     "cycles": 128,
+// CHECK-NEXT:     "occupancy_percent": 6,
+// CHECK-NEXT:     "stall_cycles": 0,
+// CHECK-NEXT:     "waits_on": []
+// CHECK:          "bds": 1,
+// CHECK-NEXT:     "bytes": 4096,
+// CHECK-NEXT:     "channel": "memtile (2, 1) S2MM0",
+// CHECK-NEXT:     "cycles": 1024,
+// CHECK-NEXT:     "occupancy_percent": 50,
+// CHECK-NEXT:     "stall_cycles": 1024,
+// CHECK-NEXT:     "waits_on": [
+// CHECK-NEXT:       "memtile (2, 1) MM2S0"
+// CHECK-NEXT:     ]
+// CHECK:          "bds": 2,
+// CHECK-NEXT:     "bytes": 8192,
+// CHECK-NEXT:     "channel": "memtile (2, 1) MM2S0",
+// CHECK-NEXT:     "cycles": 2048,
+// CHECK-NEXT:     "occupancy_percent": 100,
+// CHECK-NEXT:     "stall_cycles": 0,
+// CHECK-NEXT:     "waits_on": [
+// CHECK-NEXT:       "memtile (2, 1) S2MM0"
+// CHECK-NEXT:     ]
+// CHECK:          "bds": 1,
+// CHECK-NEXT:     "bytes": 4096,
+// CHECK-NEXT:     "channel": "shim (2, 0) MM2S0",
+// CHECK-NEXT:     "cycles": 1024,
+// CHECK-NEXT:     "occupancy_percent": 50,
+// CHECK-NEXT:     "stall_cycles": 0,
+// CHECK-NEXT:     "waits_on": []
+// CHECK:      "iteration_cycles": 2048
+
+module {
+  aie.device(xcve2302) {
+    %t20 = aie.tile(2, 0)
+    %t21 = aie.tile(2, 1)
+    %t22 = aie.tile(2, 2)
+
+    %ext = aie.external_buffer : memref<1024xi32>
+    %mt_buf = aie.buffer(%t21) : memref<256xi32>
+    %in = aie.buffer(%t22) : memref<128xi32>
+    %out = aie.buffer(%t22) : memref<128xi32>
+
+    %shim_lock = aie.lock(%t20, 0) {init = 1 : i32}
+    %mt_prod = aie.lock(%t21, 0) {init = 1 : i32}
+    %mt_cons = aie.lock(%t21, 1) {init = 0 : i32}
+    %in_prod = aie.lock(%t22, 0) {init = 1 : i32}
+    %in_cons = aie.lock(%t22, 1) {init = 0 : i32}
+    %out_lock = aie.lock(%t22, 2) {init = 0 : i32, sym_name = "out_lock"}
+
+    aie.core(%t22) {
+      aie.use_lock(%in_cons, AcquireGreaterEqual, 1)
+      aie.use_lock(%in_prod, Release, 1)
+      aie.end
+    }
+
+    %mem22 = aie.mem(%t22) {
+      %0 = aie.dma_start(S2MM, 0, ^bd0, ^dma1)
+    ^bd0:
+      aie.use_lock(%in_prod, AcquireGreaterEqual, 1)
+      aie.dma_bd(%in : memref<128xi32>, 0, 128)
+      aie.use_lock(%in_cons, Release, 1)
+      aie.next_bd ^bd0
+    ^dma1:
+      %1 = aie.dma_start(MM2S, 0, ^bd1, ^end)
+    ^bd1:
+      // expected-warning@+1 {{waits on out_lock, which is never released}}
+      aie.use_lock(%out_lock, AcquireGreaterEqual, 1)
+      aie.dma_bd(%out : memref<128xi32>, 0, 128)
+      aie.next_bd ^bd1
+    ^end:
+      aie.end
+    }
+
+    %memtile = aie.memtile_dma(%t21) {
+      %0 = aie.dma_start(S2MM, 0, ^bd0, ^dma1, repeat_count = 4)
+    ^bd0:
+      aie.use_lock(%mt_prod, AcquireGreaterEqual, 1)
+      aie.dma_bd(%mt_buf : memref<256xi32>, 0, 256)
+      aie.use_lock(%mt_cons, Release, 1)
+      aie.next_bd ^end
+    ^dma1:
+      %1 = aie.dma_start(MM2S, 0, ^bd1, ^end, repeat_count = 4)
+    ^bd1:
+      aie.use_lock(%mt_cons, AcquireGreaterEqual, 1)
+      aie.dma_bd(%mt_buf : memref<256xi32>, 0, 256)
+      aie.next_bd ^bd2
+    ^bd2:
+      aie.dma_bd(%mt_buf : memref<256xi32>, 0, 256)
+      aie.use_lock(%mt_prod, Release, 1)
+      aie.next_bd ^end
+    ^end:
+      aie.end
+    }
+
+    %shim = aie.shim_dma(%t20) {
+      %0 = aie.dma_start(MM2S, 0, ^bd0, ^end)
+    ^bd0:
+      aie.use_lock(%shim_lock, AcquireGreaterEqual, 1)
+      aie.dma_bd(%ext : memref<1024xi32>, 0, 1024)
+      aie.use_lock(%shim_lock, Release, 1)
+      aie.next_bd ^bd0
+    ^end:
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,51 @@
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 Advanced Micro Devices, Inc.
+
+# Write a core ELF loading the given 32-bit words at the start of the program
+# memory, with a single executable segment:
+#
+#     make_elf.py core_0_2.elf 0x11111111 0x22222222
+
+import struct
+import sys
+
+EM_AIE = 264
+PT_LOAD = 1
+PF_X, PF_R = 1, 4
+
+path, words = sys.argv[1], [int(w, 0) for w in sys.argv[2:]]
+text = struct.pack(f"<{len(words)}I", *words)
+ehsize, phentsize = 52, 32
+ident = b"\x7fELF" + bytes([1, 1, 1]) + bytes(9)
+header = ident + struct.pack(
+    "<HHIIIIIHHHHHH",
+    2,  # ET_EXEC
+    EM_AIE,
+    1,  # EV_CURRENT
+    0,  # entry
+    ehsize,  # program headers
+    0,  # no section headers
+    0,
+    ehsize,
+    phentsize,
+    1,
+    0,
+    0,
+    0,
+)
+segment = struct.pack(
+    "<IIIIIIII",
+    PT_LOAD,
+    ehsize + phentsize,  # offset
+    0,  # vaddr
+    0,  # paddr
+    len(text),
+    len(text),
+    PF_R | PF_X,
+    4,
+)
+with open(path, "wb") as f:
+    f.write(header + segment + text)
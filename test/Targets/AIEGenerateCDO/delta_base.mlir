@@ -0,0 +1,37 @@
+//===- delta_base.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t/base %t/full %t/delta
+// RUN: %PYTHON %S/Inputs/make_elf.py %t/base/core_0_2.elf 0x11111111 0x22222222 0x33333333 0x44444444
+// RUN: %PYTHON %S/Inputs/make_elf.py %t/full/core_0_2.elf 0x11111111 0x22222222 0x99999999 0x44444444
+// RUN: cp %t/full/core_0_2.elf %t/delta/core_0_2.elf
+// RUN: aie-translate --aie-generate-cdo --cdo-axi-debug --work-dir-path=%t/full %s | FileCheck %s --check-prefix=FULL
+// RUN: aie-translate --aie-generate-cdo --cdo-axi-debug --work-dir-path=%t/delta --cdo-delta-base=%s --cdo-delta-base-work-dir-path=%t/base %s \
+// RUN:   | FileCheck %s --check-prefix=DELTA --implicit-check-not=0x11111111 --implicit-check-not=0x22222222 --implicit-check-not=0x33333333 --implicit-check-not=0x44444444
+
+// The design is reloaded over itself with one word of its program changed:
+// the delta CDO only writes that word, and none of the program memory loaded
+// by the base design, which is only recorded.
+
+// FULL-DAG: 0x11111111
+// FULL-DAG: 0x22222222
+// FULL-DAG: 0x99999999
+// FULL-DAG: 0x44444444
+
+// DELTA: {{[0-9A-F]*}}220008 {{ *}}Data:{{ *}}0x99999999
+
+module {
+  aie.device(npu) {
+    %t02 = aie.tile(0, 2)
+    %core = aie.core(%t02) {
+      aie.end
+    }
+  }
+}
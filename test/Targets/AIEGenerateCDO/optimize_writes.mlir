@@ -0,0 +1,41 @@
+//===- optimize_writes.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t/plain %t/opt
+// RUN: aie-translate --aie-generate-cdo --cdo-axi-debug --work-dir-path=%t/plain %s | FileCheck %s --check-prefix=PLAIN
+// RUN: aie-translate --aie-generate-cdo --cdo-axi-debug --cdo-optimize-writes --work-dir-path=%t/opt %s | FileCheck %s --check-prefix=OPT --implicit-check-not='{{21F000 *Data: *0x00000000}}'
+
+// Both CDOs initialize the lock 1, but only the plain one writes the reset
+// value of the lock 0. The rewritten writes reach the CDO once the recording
+// transaction ends.
+
+// PLAIN-DAG: {{[0-9A-F]*}}21F000 {{ *}}Data:{{ *}}0x00000000
+// PLAIN-DAG: {{[0-9A-F]*}}21F010 {{ *}}Data:{{ *}}0x00000001
+
+// OPT: {{[0-9A-F]*}}21F010 {{ *}}Data:{{ *}}0x00000001
+
+module {
+  aie.device(npu) {
+    %t02 = aie.tile(0, 2)
+    %buf = aie.buffer(%t02) {address = 1024 : i32, sym_name = "buf"} : memref<8xi32>
+    %l0 = aie.lock(%t02, 0) {init = 0 : i32}
+    %l1 = aie.lock(%t02, 1) {init = 1 : i32}
+    %mem = aie.mem(%t02) {
+      %0 = aie.dma_start(MM2S, 0, ^bb1, ^bb2)
+    ^bb1:
+      aie.use_lock(%l1, AcquireGreaterEqual, 1)
+      aie.dma_bd(%buf : memref<8xi32>, 0, 8)
+      aie.use_lock(%l0, Release, 1)
+      aie.next_bd ^bb1
+    ^bb2:
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,78 @@
+//===- per_column_elfs.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %PYTHON %S/Inputs/make_elf.py %t/core_1_2.elf 0x11111111
+// RUN: %PYTHON %S/Inputs/make_elf.py %t/core_2_2.elf 0x22222222
+// RUN: %PYTHON %S/Inputs/make_elf.py %t/core_2_3.elf 0x33333333
+// RUN: aie-translate --aie-generate-cdo --work-dir-path=%t %s
+// RUN: ls %t | FileCheck %s --check-prefix=FILES
+// RUN: od -An -v -tx4 %t/aie_cdo_elfs_1.bin | FileCheck %s --check-prefix=COL1
+// RUN: od -An -v -tx4 %t/aie_cdo_elfs_2.bin | FileCheck %s --check-prefix=COL2
+
+// The CDOs of the ELFs are replaced by markers, which an unchanged rerun
+// leaves alone.
+// RUN: echo stale > %t/aie_cdo_elfs_1.bin
+// RUN: echo stale > %t/aie_cdo_elfs_2.bin
+// RUN: aie-translate --aie-generate-cdo --work-dir-path=%t %s
+// RUN: cat %t/aie_cdo_elfs_1.bin %t/aie_cdo_elfs_2.bin | FileCheck %s --check-prefix=UNCHANGED
+
+// Editing the kernel of a core only regenerates the CDO of its column.
+// RUN: %PYTHON %S/Inputs/make_elf.py %t/core_2_3.elf 0x99999999
+// RUN: aie-translate --aie-generate-cdo --work-dir-path=%t %s
+// RUN: cat %t/aie_cdo_elfs_1.bin | FileCheck %s --check-prefix=UNCHANGED1
+// RUN: od -An -v -tx4 %t/aie_cdo_elfs_2.bin | FileCheck %s --check-prefix=CHANGED2
+
+// There is no CDO for column 0, which has no core.
+// FILES-NOT:  aie_cdo_elfs_0
+// FILES:      aie_cdo_elfs_1.bin
+// FILES-NEXT: aie_cdo_elfs_1.bin.hash
+// FILES-NEXT: aie_cdo_elfs_2.bin
+// FILES-NEXT: aie_cdo_elfs_2.bin.hash
+// FILES-NOT:  aie_cdo_elfs_
+
+// COL1-NOT: 22222222
+// COL1-NOT: 33333333
+// COL1:     11111111
+// COL1-NOT: 22222222
+// COL1-NOT: 33333333
+
+// COL2-NOT: 11111111
+// COL2-DAG: 22222222
+// COL2-DAG: 33333333
+// COL2-NOT: 11111111
+
+// UNCHANGED:      stale
+// UNCHANGED-NEXT: stale
+
+// UNCHANGED1: stale
+
+// CHANGED2-NOT: stale
+// CHANGED2-NOT: 33333333
+// CHANGED2-DAG: 22222222
+// CHANGED2-DAG: 99999999
+// CHANGED2-NOT: 33333333
+
+module {
+  aie.device(ipu) {
+    %t12 = aie.tile(1, 2)
+    %t22 = aie.tile(2, 2)
+    %t23 = aie.tile(2, 3)
+    %core12 = aie.core(%t12) {
+      aie.end
+    }
+    %core22 = aie.core(%t22) {
+      aie.end
+    }
+    %core23 = aie.core(%t23) {
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,16 @@
+// The design loaded in the partition by its CDOs, routing the packets of ID
+// 5 to the control port of the tile (0, 2).
+module {
+  aie.device(npu) {
+    %t02 = aie.tile(0, 2)
+    %l0 = aie.lock(%t02, 0) {init = 1 : i32}
+    %l1 = aie.lock(%t02, 1) {init = 1 : i32}
+    aie.switchbox(%t02) {
+      %a = aie.amsel<0> (0)
+      %m = aie.masterset(Ctrl : 0, %a)
+      aie.packet_rules(South : 0) {
+        aie.rule(31, 5, %a)
+      }
+    }
+  }
+}
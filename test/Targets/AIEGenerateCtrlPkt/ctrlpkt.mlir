@@ -0,0 +1,36 @@
+//===- ctrlpkt.mlir --------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-ctrlpkt --ctrlpkt-base %S/Inputs/base.mlir %s | FileCheck %s
+
+// The lock 0 changes its value, and the lock 1, only initialized by the base
+// design, is reset, each one by a packet of ID 5 writing one register. The
+// route to the control port is the same, so it isn't written.
+
+// CHECK:      80000005
+// CHECK-NEXT: 0001F000
+// CHECK-NEXT: 00000002
+// CHECK-NEXT: 80000005
+// CHECK-NEXT: 8001F010
+// CHECK-NEXT: 00000000
+// CHECK-NOT:  {{.}}
+module {
+  aie.device(npu) {
+    %t02 = aie.tile(0, 2)
+    %l0 = aie.lock(%t02, 0) {init = 2 : i32}
+    aie.switchbox(%t02) {
+      %a = aie.amsel<0> (0)
+      %m = aie.masterset(Ctrl : 0, %a)
+      aie.packet_rules(South : 0) {
+        aie.rule(31, 5, %a)
+      }
+    }
+  }
+}
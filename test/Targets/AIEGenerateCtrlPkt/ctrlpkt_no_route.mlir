@@ -0,0 +1,30 @@
+//===- ctrlpkt_no_route.mlir -----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-ctrlpkt --ctrlpkt-base %S/Inputs/base.mlir --verify-diagnostics %s -o /dev/null
+
+// The tile (0, 3) can't be reconfigured by control packets, since the base
+// design doesn't route any to it.
+
+module {
+  // expected-error@+1 {{tile (0, 3) is reconfigured, but the base design routes no packet to its control port}}
+  aie.device(npu) {
+    %t02 = aie.tile(0, 2)
+    %t03 = aie.tile(0, 3)
+    %l0 = aie.lock(%t03, 0) {init = 1 : i32}
+    aie.switchbox(%t02) {
+      %a = aie.amsel<0> (0)
+      %m = aie.masterset(Ctrl : 0, %a)
+      aie.packet_rules(South : 0) {
+        aie.rule(31, 5, %a)
+      }
+    }
+  }
+}
@@ -10,11 +10,10 @@
 
 // RUN: aie-translate --aie-generate-xaie %s | FileCheck %s
 
+// CHECK: XAie_DmaDimDesc dma_tile_2_1_bd_0_tensor_dims[4] = {};
+// CHECK: XAie_DmaTensor dma_tile_2_1_bd_0_tensor = {};
 // CHECK: dma_tile_2_1_bd_0_tensor.NumDim = 4;
-// CHECK: dma_tile_2_1_bd_0_tensor.Dim =__mlir_aie_alloc_dim_desc(4);
-// CHECK: if(NULL == dma_tile_2_1_bd_0_tensor.Dim){
-// CHECK:   return 1;
-// CHECK: }
+// CHECK: dma_tile_2_1_bd_0_tensor.Dim = dma_tile_2_1_bd_0_tensor_dims;
 // CHECK: dma_tile_2_1_bd_0_tensor.Dim[3].AieMlDimDesc = { /* StepSize */ 1, /* Size */ 2};
 // CHECK: dma_tile_2_1_bd_0_tensor.Dim[2].AieMlDimDesc = { /* StepSize */ 2, /* Size */ 3};
 // CHECK: dma_tile_2_1_bd_0_tensor.Dim[1].AieMlDimDesc = { /* StepSize */ 4, /* Size */ 2};
@@ -0,0 +1,42 @@
+//===- aie2_nd_DMA_padding.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-xaie %s | FileCheck %s
+
+// CHECK: __mlir_aie_try(XAie_DmaSetMultiDimAddr(&(dma_tile21_bd0), &dma_tile_2_1_bd_0_tensor, 0x82000,  /* len */ 65 * 4));
+// CHECK: XAie_PaddingDesc dma_tile_2_1_bd_0_tensor_pad_dims[2] = {};
+// CHECK: XAie_DmaPadTensor dma_tile_2_1_bd_0_tensor_pad = {};
+// CHECK: dma_tile_2_1_bd_0_tensor_pad.NumDim = 2;
+// CHECK: dma_tile_2_1_bd_0_tensor_pad.PadDesc = dma_tile_2_1_bd_0_tensor_pad_dims;
+// CHECK: dma_tile_2_1_bd_0_tensor_pad.PadDesc[1] = { /* Before */ 0, /* After */ 1};
+// CHECK: dma_tile_2_1_bd_0_tensor_pad.PadDesc[0] = { /* Before */ 2, /* After */ 3};
+// CHECK: __mlir_aie_try(XAie_DmaSetPadding(&(dma_tile21_bd0), &dma_tile_2_1_bd_0_tensor_pad));
+// CHECK: __mlir_aie_try(XAie_DmaEnableBd(&(dma_tile21_bd0)));
+
+module @aie_module  {
+ aie.device(xcve2302) {
+  %t01 = aie.tile(2, 1)
+  %buf01_0 = aie.buffer(%t01) { address = 8192 : i32, sym_name = "in" } : memref<32xi32>
+
+  %l01_0 = aie.lock(%t01, 0) { init = 1 : i32 }
+  %l01_1 = aie.lock(%t01, 1)
+
+  %m01 = aie.memtile_dma(%t01) {
+      %dstDma = aie.dma_start(MM2S, 0, ^bd0, ^end)
+    ^bd0:
+      aie.use_lock(%l01_1, "AcquireGreaterEqual", 1)
+      aie.dma_bd(%buf01_0 : memref<32xi32>, 0, 65, [<size = 4, stride = 8>, <size = 8, stride = 1>], [<const_pad_before = 0, const_pad_after = 1>, <const_pad_before = 2, const_pad_after = 3>])
+      aie.use_lock(%l01_0, "Release", 1)
+      aie.next_bd ^bd0
+    ^end:
+      aie.end
+  }
+ }
+}
@@ -0,0 +1,51 @@
+//===- aie2_tileDMA_compression.mlir ---------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-xaie %s | FileCheck %s
+
+// CHECK: XAie_DmaDesc [[bd0:.*]];
+// CHECK: __mlir_aie_try(XAie_DmaSetAddrLen(&([[bd0]]),  /* addrA */ 0x720,  /* len */ 256 * 4));
+// CHECK: __mlir_aie_try(XAie_DmaEnableCompression(&([[bd0]])));
+// CHECK: __mlir_aie_try(XAie_DmaEnableBd(&([[bd0]])));
+// CHECK: XAie_DmaDesc [[bd1:.*]];
+// CHECK: __mlir_aie_try(XAie_DmaSetAddrLen(&([[bd1]]),  /* addrA */ 0x1720,  /* len */ 256 * 4));
+// CHECK-NOT: XAie_DmaEnableCompression
+// CHECK: __mlir_aie_try(XAie_DmaEnableBd(&([[bd1]])));
+
+module @aie_module  {
+  aie.device(xcve2802) {
+    %t73 = aie.tile(7, 3)
+
+    %buf_a = aie.buffer(%t73) {address = 1824 : i32, sym_name = "a" } : memref<256xi32>
+    %buf_b = aie.buffer(%t73) {address = 5920 : i32, sym_name = "b" } : memref<256xi32>
+
+    %lock_a_write = aie.lock(%t73, 3) { init = 1 : i32 }
+    %lock_a_read = aie.lock(%t73, 4)
+
+    // Decompresses the sparse data it receives and sends it back uncompressed.
+    %m73 = aie.mem(%t73) {
+        %srcDma = aie.dma_start("S2MM", 0, ^bd0, ^dma1)
+      ^dma1:
+        %dstDma = aie.dma_start("MM2S", 0, ^bd1, ^end)
+      ^bd0:
+        aie.use_lock(%lock_a_write, AcquireGreaterEqual, 1)
+        aie.dma_bd(%buf_a : memref<256xi32>, 0, 256) {compression}
+        aie.use_lock(%lock_a_read, Release, 1)
+        aie.next_bd ^end
+      ^bd1:
+        aie.use_lock(%lock_a_read, AcquireGreaterEqual, 1)
+        aie.dma_bd(%buf_b : memref<256xi32>, 0, 256)
+        aie.use_lock(%lock_a_write, Release, 1)
+        aie.next_bd ^end
+      ^end:
+        aie.end
+    }
+ }
+}
@@ -0,0 +1,33 @@
+//===- clear_tiles.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-xaie %s | FileCheck %s
+
+// Only the tiles of the design are cleared, column by column.
+
+// CHECK-LABEL: int mlir_aie_clear_tiles(aie_libxaie_ctx_t* ctx) {
+// CHECK-NEXT: mlir_aie_clear_shim_config(ctx, 2, 0);
+// CHECK-NEXT: mlir_aie_clear_config(ctx, 2, 3);
+// CHECK-NEXT: mlir_aie_clear_config(ctx, 7, 2);
+// CHECK-NEXT: mlir_aie_clear_config(ctx, 7, 4);
+// CHECK-NEXT: return XAIE_OK;
+// CHECK-NEXT: } // mlir_aie_clear_tiles
+
+module @clear_tiles {
+ aie.device(xcvc1902) {
+  %t74 = aie.tile(7, 4)
+  %t23 = aie.tile(2, 3)
+  %t72 = aie.tile(7, 2)
+  %t20 = aie.tile(2, 0)
+  aie.core(%t74) {
+    aie.end
+  }
+ }
+}
@@ -0,0 +1,43 @@
+//===- core_start_broadcast.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-xaie %s | FileCheck %s
+
+// The cores are armed on broadcast 13, which is fired from the shim tile of
+// the leftmost core column instead of enabling the cores one by one.
+
+// CHECK: mlir_aie_start_cores
+// CHECK: static const XAie_LocType __mlir_aie_cores[] = {
+// CHECK:   XAie_TileLoc(3,3),
+// CHECK:   XAie_TileLoc(2,4),
+// CHECK: };
+// CHECK: for (const XAie_LocType &Loc : __mlir_aie_cores)
+// CHECK:   __mlir_aie_try(XAie_CoreUnreset(&(ctx->DevInst), Loc));
+// CHECK: for (const XAie_LocType &Loc : __mlir_aie_cores) {
+// CHECK:   __mlir_aie_try(XAie_CoreConfigureEnableEvent(&(ctx->DevInst), Loc, XAIE_EVENT_BROADCAST_13_CORE));
+// CHECK:   __mlir_aie_try(XAie_SetTimerResetEvent(&(ctx->DevInst), Loc, XAIE_CORE_MOD, XAIE_EVENT_BROADCAST_13_CORE, XAIE_RESETDISABLE));
+// CHECK: }
+// CHECK: __mlir_aie_try(XAie_EventBroadcast(&(ctx->DevInst), XAie_TileLoc(2,0), XAIE_PL_MOD, 13, XAIE_EVENT_USER_EVENT_0_PL));
+// CHECK: __mlir_aie_try(XAie_EventGenerate(&(ctx->DevInst), XAie_TileLoc(2,0), XAIE_PL_MOD, XAIE_EVENT_USER_EVENT_0_PL));
+// CHECK-NOT: XAie_CoreEnable
+// CHECK: } // mlir_aie_start_cores
+
+module @test_xaie0 {
+ aie.device(xcvc1902) {
+  %t33 = aie.tile(3, 3)
+  %t24 = aie.tile(2, 4)
+  aie.core(%t33) {
+    aie.end
+  } { elf_file = "test33.elf" }
+  aie.core(%t24) {
+    aie.end
+  } { elf_file = "test24.elf" }
+ } {core_start_broadcast = 13 : i32}
+}
@@ -17,14 +17,13 @@
 // RUN: aie-translate --aie-generate-xaie %s | FileCheck %s
 
 // CHECK: mlir_aie_configure_switchboxes
-// CHECK: x = 4;
-// CHECK: y = 0;
-// CHECK: __mlir_aie_try(XAie_StrmConnCctEnable(&(ctx->DevInst), XAie_TileLoc(x,y), SOUTH, 4, NORTH, 0));
-// CHECK: __mlir_aie_try(XAie_StrmConnCctEnable(&(ctx->DevInst), XAie_TileLoc(x,y), NORTH, 0, SOUTH, 2));
-// CHECK: x = 4;
-// CHECK: y = 1;
-// CHECK: __mlir_aie_try(XAie_StrmConnCctEnable(&(ctx->DevInst), XAie_TileLoc(x,y), SOUTH, 0, NORTH, 0));
-// CHECK: __mlir_aie_try(XAie_StrmConnCctEnable(&(ctx->DevInst), XAie_TileLoc(x,y), NORTH, 0, SOUTH, 0));
+// CHECK: {4, 0, SOUTH, 4, NORTH, 0},
+// CHECK: {4, 0, NORTH, 0, SOUTH, 2},
+// CHECK: {4, 1, SOUTH, 0, NORTH, 0},
+// CHECK: {4, 1, NORTH, 0, SOUTH, 0},
+// CHECK: };
+// CHECK: for (const __mlir_aie_circuit &C : __mlir_aie_circuits)
+// CHECK:   __mlir_aie_try(XAie_StrmConnCctEnable(&(ctx->DevInst), XAie_TileLoc(C.Col, C.Row), C.Slave, C.SlaveCh, C.Master, C.MasterCh));
 
 module {
  aie.device(xcvc1902) {
@@ -18,12 +18,8 @@
 // RUN: aie-translate --aie-generate-xaie %s | FileCheck %s
 
 // CHECK: mlir_aie_configure_switchboxes
-// CHECK: x = 2;
-// CHECK: y = 0;
-// CHECK: __mlir_aie_try(XAie_StrmConnCctEnable(&(ctx->DevInst), XAie_TileLoc(x,y), NORTH, 0, SOUTH, 2));
-// CHECK: x = 2;
-// CHECK: y = 1;
-// CHECK: __mlir_aie_try(XAie_StrmConnCctEnable(&(ctx->DevInst), XAie_TileLoc(x,y), NORTH, 0, SOUTH, 0));
+// CHECK: {2, 0, NORTH, 0, SOUTH, 2},
+// CHECK: {2, 1, NORTH, 0, SOUTH, 0},
 // CHECK: x = 2;
 // CHECK: y = 0;
 // CHECK: __mlir_aie_try(XAie_EnableAieToShimDmaStrmPort(&(ctx->DevInst), XAie_TileLoc(x,y), 2));
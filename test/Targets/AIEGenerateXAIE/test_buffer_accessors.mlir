@@ -0,0 +1,25 @@
+//===- test_buffer_accessors.mlir ------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-xaie %s | FileCheck %s
+// CHECK: const int a_offset = 4096;
+// CHECK: int32_t mlir_aie_read_buffer_a(aie_libxaie_ctx_t* ctx, int index) {
+// CHECK: int mlir_aie_write_buffer_a(aie_libxaie_ctx_t* ctx, int index, int32_t value) {
+// CHECK: int mlir_aie_read_buffer_a_block(aie_libxaie_ctx_t* ctx, int index, int32_t *values, int count) {
+// CHECK-NEXT: return mlir_aie_data_mem_rd_block(ctx, 3, 3, a_offset + (index*4), (u32 *)values, count) ? XAIE_OK : XAIE_ERR;
+// CHECK: int mlir_aie_write_buffer_a_block(aie_libxaie_ctx_t* ctx, int index, const int32_t *values, int count) {
+// CHECK-NEXT: return mlir_aie_data_mem_wr_block(ctx, 3, 3, a_offset + (index*4), (const u32 *)values, count) ? XAIE_OK : XAIE_ERR;
+
+module @test_buffer_accessors {
+ aie.device(xcvc1902) {
+  %t33 = aie.tile(3, 3)
+  %a = aie.buffer(%t33) { sym_name = "a", address = 4096 : i32 } : memref<256xi32>
+ }
+}
@@ -15,8 +15,13 @@
 // CHECK: __mlir_aie_try(XAie_CoreDisable(&(ctx->DevInst), XAie_TileLoc(3,3)));
 // CHECK: XAie_LoadElf(&(ctx->DevInst), XAie_TileLoc(3,3), (const char*)"test.elf",0);
 // CHECK: mlir_aie_start_cores
-// CHECK: __mlir_aie_try(XAie_CoreUnreset(&(ctx->DevInst), XAie_TileLoc(3,3)));
-// CHECK: __mlir_aie_try(XAie_CoreEnable(&(ctx->DevInst), XAie_TileLoc(3,3)));
+// CHECK: static const XAie_LocType __mlir_aie_cores[] = {
+// CHECK:   XAie_TileLoc(3,3),
+// CHECK: };
+// CHECK: for (const XAie_LocType &Loc : __mlir_aie_cores)
+// CHECK:   __mlir_aie_try(XAie_CoreUnreset(&(ctx->DevInst), Loc));
+// CHECK: for (const XAie_LocType &Loc : __mlir_aie_cores)
+// CHECK:   __mlir_aie_try(XAie_CoreEnable(&(ctx->DevInst), Loc));
 
 module @test_xaie0 {
  aie.device(xcvc1902) {
@@ -9,7 +9,9 @@
 //===----------------------------------------------------------------------===//
 
 // RUN: aie-translate --aie-generate-xaie %s | FileCheck %s
-// CHECK: __mlir_aie_try(XAie_LockSetValue(&(ctx->DevInst), XAie_TileLoc(3,3), XAie_LockInit(0, 1)));
+// CHECK: {XAie_TileLoc(3,3), XAie_LockInit(0, 1)},
+// CHECK: for (const __mlir_aie_lock_init &L : __mlir_aie_locks)
+// CHECK:   __mlir_aie_try(XAie_LockSetValue(&(ctx->DevInst), L.Loc, L.Lock));
 
 module @test_lock_init {
  aie.device(xcvc1902) {
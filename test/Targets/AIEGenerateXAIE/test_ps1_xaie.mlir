@@ -11,9 +11,7 @@
 // RUN: aie-translate --aie-generate-xaie %s | FileCheck %s
 
 // CHECK: mlir_aie_configure_switchboxes
-// CHECK: x = 0;
-// CHECK: y = 1;
-// CHECK: __mlir_aie_try(XAie_StrmConnCctEnable(&(ctx->DevInst), XAie_TileLoc(x,y), DMA, 0, EAST, 0));
+// CHECK: {0, 1, DMA, 0, EAST, 0},
 // CHECK: x = 1;
 // CHECK: y = 1;
 // CHECK: __mlir_aie_try(XAie_StrmPktSwMstrPortEnable(&(ctx->DevInst), XAie_TileLoc(x,y), CORE, 0, {{.*}} XAIE_SS_PKT_DONOT_DROP_HEADER, {{.*}} 0, {{.*}} 0x1));
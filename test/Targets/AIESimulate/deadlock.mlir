@@ -0,0 +1,64 @@
+//===- deadlock.mlir -------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-simulate %s | FileCheck %s
+// RUN: aie-translate --aie-simulate --verify-diagnostics %s -o /dev/null
+
+// The core waits on the words sent by the DMA channel of (0, 3), which waits
+// on a lock no core releases.
+
+// CHECK: "status": "deadlock"
+
+module {
+  aie.device(ipu) {
+    %t02 = aie.tile(0, 2)
+    %t03 = aie.tile(0, 3)
+
+    %in = aie.buffer(%t02) : memref<16xi32>
+    %out = aie.buffer(%t03) : memref<16xi32>
+    %in_prod = aie.lock(%t02, 0) {init = 1 : i32}
+    %in_cons = aie.lock(%t02, 1) {init = 0 : i32, sym_name = "in_cons"}
+    %out_prod = aie.lock(%t03, 0) {init = 1 : i32}
+    %out_cons = aie.lock(%t03, 1) {init = 0 : i32, sym_name = "out_cons"}
+
+    aie.flow(%t03, DMA : 0, %t02, DMA : 0)
+
+    aie.core(%t02) {
+      // expected-warning@+1 {{core (0, 2) waits forever on in_cons}}
+      aie.use_lock(%in_cons, AcquireGreaterEqual, 1)
+      aie.use_lock(%in_prod, Release, 1)
+      aie.end
+    }
+
+    %mem02 = aie.mem(%t02) {
+      %0 = aie.dma_start(S2MM, 0, ^bd0, ^end)
+    ^bd0:
+      aie.use_lock(%in_prod, AcquireGreaterEqual, 1)
+      // expected-warning@+1 {{mem (0, 2) S2MM0 waits forever on its stream}}
+      aie.dma_bd(%in : memref<16xi32>, 0, 16)
+      aie.use_lock(%in_cons, Release, 1)
+      aie.next_bd ^end
+    ^end:
+      aie.end
+    }
+
+    %mem03 = aie.mem(%t03) {
+      %0 = aie.dma_start(MM2S, 0, ^bd0, ^end)
+    ^bd0:
+      // expected-warning@+1 {{mem (0, 3) MM2S0 waits forever on out_cons}}
+      aie.use_lock(%out_cons, AcquireGreaterEqual, 1)
+      aie.dma_bd(%out : memref<16xi32>, 0, 16)
+      aie.use_lock(%out_prod, Release, 1)
+      aie.next_bd ^end
+    ^end:
+      aie.end
+    }
+  }
+}
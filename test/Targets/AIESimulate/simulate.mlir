@@ -0,0 +1,89 @@
+//===- simulate.mlir -------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-simulate %s | FileCheck %s
+
+// The runtime sequence sends 256 words to a core taking 108 cycles for each
+// block of 64 words, through a single buffer: the DMA channel of the core
+// waits on the core for each block but the first, and the core on the DMA.
+
+// CHECK:      "channels": [
+// CHECK-NEXT:   {
+// CHECK-NEXT:     "busy_cycles": 280,
+// CHECK-NEXT:     "finished": false,
+// CHECK-NEXT:     "name": "mem (0, 2) S2MM0",
+// CHECK-NEXT:     "stall_cycles": 420,
+// CHECK-NEXT:     "words": 256
+// CHECK-NEXT:   },
+// CHECK-NEXT:   {
+// CHECK-NEXT:     "busy_cycles": 256,
+// CHECK-NEXT:     "finished": true,
+// CHECK-NEXT:     "name": "external (0, 0) MM2S0",
+// CHECK-NEXT:     "stall_cycles": 330,
+// CHECK-NEXT:     "words": 256
+// CHECK-NEXT:   }
+// CHECK-NEXT: ],
+// CHECK-NEXT: "cores": [
+// CHECK-NEXT:   {
+// CHECK-NEXT:     "busy_cycles": 432,
+// CHECK-NEXT:     "finished": true,
+// CHECK-NEXT:     "name": "core (0, 2)",
+// CHECK-NEXT:     "stall_cycles": 268
+// CHECK-NEXT:   }
+// CHECK-NEXT: ],
+// CHECK-NEXT: "cycles": 700,
+// CHECK-NEXT: "status": "finished"
+
+module {
+  aie.device(ipu) {
+    %t00 = aie.tile(0, 0)
+    %t02 = aie.tile(0, 2)
+
+    %buf = aie.buffer(%t02) : memref<64xi32>
+    %prod = aie.lock(%t02, 0) {init = 1 : i32}
+    %cons = aie.lock(%t02, 1) {init = 0 : i32}
+
+    aie.flow(%t00, DMA : 0, %t02, DMA : 0)
+    aie.shim_dma_allocation @in (MM2S, 0, 0)
+
+    func.func private @kernel(memref<64xi32>) attributes {aie.cycles = 100 : i64}
+
+    aie.core(%t02) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c4 = arith.constant 4 : index
+      scf.for %i = %c0 to %c4 step %c1 {
+        aie.use_lock(%cons, AcquireGreaterEqual, 1)
+        func.call @kernel(%buf) : (memref<64xi32>) -> ()
+        aie.use_lock(%prod, Release, 1)
+      }
+      aie.end
+    }
+
+    %mem02 = aie.mem(%t02) {
+      %0 = aie.dma_start(S2MM, 0, ^bd0, ^end)
+    ^bd0:
+      aie.use_lock(%prod, AcquireGreaterEqual, 1)
+      aie.dma_bd(%buf : memref<64xi32>, 0, 64)
+      aie.use_lock(%cons, Release, 1)
+      aie.next_bd ^bd0
+    ^end:
+      aie.end
+    }
+
+    func.func @sequence(%in : memref<256xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c256 = arith.constant 256 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c256][%c0,%c0,%c0]) { metadata = @in, id = 0 : i64 } : memref<256xi32>
+      return
+    }
+  }
+}
@@ -0,0 +1,54 @@
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 Advanced Micro Devices, Inc.
+
+# Write a core ELF with the given loadable segments, each given as
+# <x|r>:<vaddr>:<hex bytes>, x for the program memory and r for the data
+# memory.  The segments are stored back to back in the file, so the bytes
+# following a segment are those of the next one:
+#
+#     make_core_elf.py core_6_2.elf x:0:112233445566 r:0:aabbccdd
+
+import struct
+import sys
+
+EM_AIE = 264
+PT_LOAD = 1
+PF_X, PF_R = 1, 4
+
+path, specs = sys.argv[1], sys.argv[2:]
+segments = []
+for spec in specs:
+    kind, vaddr, data = spec.split(":")
+    flags = PF_R | PF_X if kind == "x" else PF_R
+    segments.append((flags, int(vaddr, 0), bytes.fromhex(data)))
+
+ehsize, phentsize = 52, 32
+ident = b"\x7fELF" + bytes([1, 1, 1]) + bytes(9)
+header = ident + struct.pack(
+    "<HHIIIIIHHHHHH",
+    2,  # ET_EXEC
+    EM_AIE,
+    1,  # EV_CURRENT
+    0,  # entry
+    ehsize,  # program headers
+    0,  # no section headers
+    0,
+    ehsize,
+    phentsize,
+    len(segments),
+    0,
+    0,
+    0,
+)
+offset = ehsize + phentsize * len(segments)
+phdrs = b""
+for flags, vaddr, data in segments:
+    phdrs += struct.pack(
+        "<IIIIIIII", PT_LOAD, offset, vaddr, vaddr, len(data), len(data), flags, 4
+    )
+    offset += len(data)
+with open(path, "wb") as f:
+    f.write(header + phdrs + b"".join(data for _, _, data in segments))
@@ -0,0 +1,47 @@
+//===- segments.mlir -------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %PYTHON %S/Inputs/make_core_elf.py %t/core_6_2.elf x:0:112233445566 r:0:aabbccdd
+// RUN: aie-translate %s --aie-generate-airbin --airbin-output-filepath=%t/airbin.elf --airbin-aux-core-dir-path=%t
+// RUN: %LLVM_TOOLS_DIR/llvm-readelf --section-headers %t/airbin.elf | FileCheck %s --check-prefix=HEADERS
+// RUN: %LLVM_TOOLS_DIR/obj2yaml %t/airbin.elf | FileCheck %s --check-prefix=CONTENTS
+
+// The program and data memories of the core are each one section covering
+// the whole memory, with the segments of the ELF at their start and zeros
+// after them, like the writer clearing the memories before loading the ELF.
+// The 6 bytes of the program segment are padded with zeros, not with the
+// bytes of the data segment following them in the ELF.
+
+// HEADERS: .data.mem{{ +}}PROGBITS{{ +}}0000000003080000{{ +}}{{[0-9a-f]+}}{{ +}}008000
+// HEADERS: .sdma.bd{{ +}}PROGBITS{{ +}}000000000309d000
+// HEADERS: .prgm.mem{{ +}}PROGBITS{{ +}}00000000030a0000{{ +}}{{[0-9a-f]+}}{{ +}}004000
+
+// CONTENTS:      - Name:            .data.mem
+// CONTENTS-NEXT:   Type:            SHT_PROGBITS
+// CONTENTS-NEXT:   Flags:           [ SHF_ALLOC ]
+// CONTENTS-NEXT:   Address:         0x3080000
+// CONTENTS-NEXT:   AddressAlign:    0x1
+// CONTENTS-NEXT:   Content:         'AABBCCDD{{0+}}'
+// CONTENTS:      - Name:            .prgm.mem
+// CONTENTS-NEXT:   Type:            SHT_PROGBITS
+// CONTENTS-NEXT:   Flags:           [ SHF_ALLOC ]
+// CONTENTS-NEXT:   Address:         0x30A0000
+// CONTENTS-NEXT:   AddressAlign:    0x1
+// CONTENTS-NEXT:   Content:         '1122334455660000{{0+}}'
+
+module {
+  aie.device(xcvc1902) {
+    %tile_6_2 = aie.tile(6, 2)
+    %core_6_2 = aie.core(%tile_6_2) {
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,42 @@
+//===- shared_program_memory.mlir ------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %PYTHON %S/Inputs/make_core_elf.py %t/core_6_2.elf x:0:11223344
+// RUN: cp %t/core_6_2.elf %t/core_7_2.elf
+// RUN: %PYTHON %S/Inputs/make_core_elf.py %t/core_8_2.elf x:0:55667788
+// RUN: aie-translate %s --aie-generate-airbin --airbin-output-filepath=%t/airbin.elf --airbin-aux-core-dir-path=%t
+// RUN: %LLVM_TOOLS_DIR/llvm-readelf --section-headers %t/airbin.elf | FileCheck %s
+
+// The cores (6, 2) and (7, 2) run the same ELF: the program memory image is
+// stored once, and the sections of both tiles point at it. The core (8, 2)
+// runs another ELF, whose image is stored separately.
+
+// CHECK: .prgm.mem{{ +}}PROGBITS{{ +}}00000000030a0000{{ +}}[[OFF:[0-9a-f]+]]{{ +}}004000
+// CHECK: .prgm.mem{{ +}}PROGBITS{{ +}}00000000038a0000{{ +}}[[OFF]]{{ +}}004000
+// CHECK-NOT: 00000000040a0000{{ +}}[[OFF]]
+// CHECK: .prgm.mem{{ +}}PROGBITS{{ +}}00000000040a0000{{ +}}{{[0-9a-f]+}}{{ +}}004000
+
+module {
+  aie.device(xcvc1902) {
+    %tile_6_2 = aie.tile(6, 2)
+    %tile_7_2 = aie.tile(7, 2)
+    %tile_8_2 = aie.tile(8, 2)
+    %core_6_2 = aie.core(%tile_6_2) {
+      aie.end
+    }
+    %core_7_2 = aie.core(%tile_7_2) {
+      aie.end
+    }
+    %core_8_2 = aie.core(%tile_8_2) {
+      aie.end
+    }
+  }
+}
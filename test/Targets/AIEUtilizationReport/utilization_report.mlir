@@ -0,0 +1,121 @@
+//===- utilization_report.mlir ---------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-utilization-report %s | FileCheck %s
+// RUN: aie-translate --aie-utilization-report --verify-diagnostics %s -o /dev/null
+
+// The buffer of the core tile leaves no room for the stack of its core.
+
+// CHECK:      "congested_channels": [
+// CHECK-NEXT:   {
+// CHECK-NEXT:     "available": 6,
+// CHECK-NEXT:     "direction": "North",
+// CHECK-NEXT:     "percent": 16,
+// CHECK-NEXT:     "tile": "(2, 0)",
+// CHECK-NEXT:     "used": 1
+// CHECK-NEXT:   },
+// CHECK-NEXT:   {
+// CHECK-NEXT:     "available": 6,
+// CHECK-NEXT:     "direction": "North",
+// CHECK-NEXT:     "percent": 16,
+// CHECK-NEXT:     "tile": "(2, 1)",
+// CHECK-NEXT:     "used": 1
+// CHECK-NEXT:   }
+// CHECK-NEXT: ],
+// CHECK-NEXT: "cores": 1,
+// CHECK-NEXT: "tiles": [
+// CHECK:        "kind": "shim",
+// CHECK-NOT:    "memory_bytes"
+// CHECK:        "tile": "(2, 0)"
+// CHECK:        "kind": "memtile",
+// CHECK:        "memory_bytes": {
+// CHECK-NEXT:     "available": 524288,
+// CHECK-NEXT:     "percent": 0,
+// CHECK-NEXT:     "used": 0
+// CHECK-NEXT:   },
+// CHECK:        "tile": "(2, 1)"
+// CHECK:        "bds": {
+// CHECK-NEXT:     "available": 16,
+// CHECK-NEXT:     "percent": 6,
+// CHECK-NEXT:     "used": 1
+// CHECK-NEXT:   },
+// CHECK-NEXT:   "core": true,
+// CHECK-NEXT:   "kind": "core",
+// CHECK-NEXT:   "locks": {
+// CHECK-NEXT:     "available": 16,
+// CHECK-NEXT:     "percent": 12,
+// CHECK-NEXT:     "used": 2
+// CHECK-NEXT:   },
+// CHECK-NEXT:   "memory_bytes": {
+// CHECK-NEXT:     "available": 65536,
+// CHECK-NEXT:     "percent": 101,
+// CHECK-NEXT:     "used": 66560
+// CHECK-NEXT:   },
+// CHECK-NEXT:   "mm2s_channels": {
+// CHECK-NEXT:     "available": 2,
+// CHECK-NEXT:     "percent": 0,
+// CHECK-NEXT:     "used": 0
+// CHECK-NEXT:   },
+// CHECK-NEXT:   "s2mm_channels": {
+// CHECK-NEXT:     "available": 2,
+// CHECK-NEXT:     "percent": 50,
+// CHECK-NEXT:     "used": 1
+// CHECK-NEXT:   },
+// CHECK-NEXT:   "switchbox_dests": {
+// CHECK-NEXT:     "available": 22,
+// CHECK-NEXT:     "percent": 4,
+// CHECK-NEXT:     "used": 1
+// CHECK-NEXT:   },
+// CHECK-NEXT:   "switchbox_sources": {
+// CHECK-NEXT:     "available": 24,
+// CHECK-NEXT:     "percent": 4,
+// CHECK-NEXT:     "used": 1
+// CHECK-NEXT:   },
+// CHECK-NEXT:   "tile": "(2, 2)"
+
+module {
+  aie.device(xcve2302) {
+    %t20 = aie.tile(2, 0)
+    %t21 = aie.tile(2, 1)
+    // expected-warning@+1 {{uses 66560 bytes of memory, more than the 65536 of the tile}}
+    %t22 = aie.tile(2, 2)
+
+    %buf = aie.buffer(%t22) : memref<16384xi32>
+    %prod = aie.lock(%t22, 0) {init = 1 : i32}
+    %cons = aie.lock(%t22, 1) {init = 0 : i32}
+
+    aie.switchbox(%t20) {
+      aie.connect<South : 3, North : 0>
+    }
+    aie.switchbox(%t21) {
+      aie.connect<South : 0, North : 0>
+    }
+    aie.switchbox(%t22) {
+      aie.connect<South : 0, DMA : 0>
+    }
+
+    aie.core(%t22) {
+      aie.use_lock(%cons, AcquireGreaterEqual, 1)
+      aie.use_lock(%prod, Release, 1)
+      aie.end
+    }
+
+    %mem22 = aie.mem(%t22) {
+      %0 = aie.dma_start(S2MM, 0, ^bd0, ^end)
+    ^bd0:
+      aie.use_lock(%prod, AcquireGreaterEqual, 1)
+      aie.dma_bd(%buf : memref<16384xi32>, 0, 16384)
+      aie.use_lock(%cons, Release, 1)
+      aie.next_bd ^bd0
+    ^end:
+      aie.end
+    }
+  }
+}
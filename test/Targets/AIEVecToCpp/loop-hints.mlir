@@ -0,0 +1,20 @@
+// RUN: aie-translate %s -aievec-to-cpp | FileCheck %s
+
+// CHECK-LABEL: void tile_loop(int16_t * restrict
+// CHECK-SAME:                 [[IN:v[0-9]+]], size_t [[LB:v[0-9]+]], v32int16 [[V:v[0-9]+]]) {
+// CHECK:         [[IN]] = (int16_t * restrict)__builtin_assume_aligned([[IN]], 64);
+// CHECK:         for (size_t [[IV:v[0-9]+]] = [[LB]]; [[IV]] < [[UB:v[0-9]+]]; [[IV]] += [[STEP:v[0-9]+]])
+// CHECK-NEXT:    chess_prepare_for_pipelining
+// CHECK-NEXT:    chess_loop_range(8, 8)
+// CHECK:           *(v32int16 *)([[IN]] + [[IV]]) = [[V]];
+func.func @tile_loop(%in : memref<1024xi16>, %lb : index,
+                     %v : vector<32xi16>) {
+  memref.assume_alignment %in, 64 : memref<1024xi16>
+  %c256 = arith.constant 256 : index
+  %c32 = arith.constant 32 : index
+  %ub = arith.addi %lb, %c256 : index
+  scf.for %i = %lb to %ub step %c32 {
+    vector.transfer_write %v, %in[%i] : vector<32xi16>, memref<1024xi16>
+  }
+  return
+}
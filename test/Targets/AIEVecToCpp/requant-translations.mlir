@@ -0,0 +1,17 @@
+// RUN: aie-translate %s -aieml -aievec-to-cpp | FileCheck %s
+
+// CHECK-LABEL: v16int16 requant(
+// CHECK-SAME:             v16int32 [[A:[a-zA-Z0-9]+]],
+// CHECK-SAME:             v16int32 [[S:[a-zA-Z0-9]+]],
+// CHECK-SAME:             int32_t [[SH:[a-zA-Z0-9]+]]) {
+// CHECK:           set_rnd(rnd_sym_inf);
+// CHECK:           set_sat();
+// CHECK:           v16int16 [[R:.*]] = srs_to_v16int16(mul_elem_16_2([[S]], broadcast_zero_s32(), [[A]], undef_v16int32()), [[SH]]);
+// CHECK:           return [[R]];
+// CHECK:        }
+func.func @requant(%A : vector<16xi32>, %S : vector<16xi32>,
+                   %shift : i32) -> vector<16xi16> {
+  %0 = aievec.requant %A, %S, %shift {rounding = "sym_inf"}
+       : vector<16xi32>, i32, vector<16xi16>
+  return %0 : vector<16xi16>
+}
@@ -0,0 +1,59 @@
+//===- ipu_instgen_axi.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-ipu-instgen %s | FileCheck %s
+
+// The burst length is in the top bits of the 7th word of the BD, 1 for 128
+// bytes, and the AxCache and AxQoS under the SMID in the 8th.
+
+// CHECK:      060304A6
+// CHECK-NEXT: 00000000
+// CHECK-NEXT: 00000001
+// CHECK-NEXT: 00000002
+// CHECK-NEXT: 00000000
+// CHECK-NEXT: 00600005
+// CHECK-NEXT: 40800007
+// CHECK-NEXT: 02400009
+module {
+  aie.device(ipu) {
+    func.func @sequence(%arg0: memref<16xf32>) {
+      aiex.ipu.writebd_shimtile { bd_id = 6 : i32,
+                                  buffer_length = 1 : i32,
+                                  buffer_offset = 2 : i32,
+                                  enable_packet = 0 : i32,
+                                  out_of_order_id = 0 : i32,
+                                  packet_id = 0 : i32,
+                                  packet_type = 0 : i32,
+                                  column = 3 : i32,
+                                  column_num = 4 : i32,
+                                  d0_stride = 5 : i32,
+                                  d0_size = 6 : i32,
+                                  d1_stride = 7 : i32,
+                                  d1_size = 8 : i32,
+                                  d2_stride = 9 : i32,
+                                  ddr_id = 10 : i32,
+                                  iteration_current = 11 : i32,
+                                  iteration_stride = 12 : i32,
+                                  iteration_size = 13 : i32,
+                                  lock_acq_enable = 1 : i32,
+                                  lock_acq_id = 1 : i32,
+                                  lock_acq_val = 2 : i32,
+                                  lock_rel_id = 3 : i32,
+                                  lock_rel_val = 4 : i32,
+                                  next_bd = 5 : i32,
+                                  use_next_bd = 1 : i32,
+                                  valid_bd = 1 : i32,
+                                  burst_length = 128 : i32,
+                                  ax_cache = 2 : i32,
+                                  ax_qos = 4 : i32}
+      return
+    }
+  }
+}
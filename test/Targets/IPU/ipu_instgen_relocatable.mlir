@@ -0,0 +1,31 @@
+//===- ipu_instgen_relocatable.mlir ----------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-ipu-instgen %s | FileCheck %s
+
+// The columns of a relocatable device are relative to its first column, 2.
+
+module {
+  aie.device(ipu) {
+    %tile_2_0 = aie.tile(2, 0)
+    %tile_3_2 = aie.tile(3, 2)
+    func.func @sequence() {
+      // CHECK: 000055FF
+      // CHECK: 02010400
+      // CHECK: 0001D214
+      // CHECK: 00000042
+      aiex.ipu.write32 { column = 3 : i32, row = 4 : i32, address = 0x1d214 : ui32, value = 0x42 : ui32 }
+      // CHECK: 03000001
+      // CHECK: 00010100
+      aiex.ipu.sync { column = 2 : i32, row = 0 : i32, direction = 1 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+  } {aie.relocatable}
+}
@@ -0,0 +1,40 @@
+//===- ipu_patchgen.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -aie-dma-to-ipu %s | FileCheck %s --check-prefix=IR
+// RUN: aie-opt -aie-dma-to-ipu %s | aie-translate --aie-ipu-patchgen | FileCheck %s
+
+// The input reads %rows rows of 64 elements starting at row %row, and the
+// output writes %len elements.  The parameters are taken as zero in the BDs
+// and patched into their length and offset words.
+// IR: aiex.ipu.writebd_shimtile {bd_id = 1 : i32, buffer_length = 0 : i32, buffer_length_params = array<i64: 2, 64>, buffer_offset = 0 : i32, buffer_offset_params = array<i64: 3, 256>
+// IR: aiex.ipu.writebd_shimtile {bd_id = 0 : i32, buffer_length = 0 : i32, buffer_length_params = array<i64: 4, 1>, buffer_offset = 0 : i32, column
+
+// The first BD follows the 17 words of the prolog, and the second one the
+// 10 words of the first BD and the 3 words of its queue push.
+// CHECK: 19 2 64
+// CHECK-NEXT: 20 3 256
+// CHECK-NEXT: 32 4 1
+
+module {
+  aie.device(ipu) {
+    func.func @sequence(%in : memref<1024x64xi32>, %out : memref<4096xi32>, %rows : i64, %row : i64, %len : i64) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c64 = arith.constant 64 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%row,%c0][%c1,%c1,%rows,%c64][%c0,%c0,%c64]) { metadata = @in, id = 1 : i64 } : memref<1024x64xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%len][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<4096xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+    aie.shim_dma_allocation @in (MM2S, 0, 0)
+    aie.shim_dma_allocation @out (S2MM, 0, 0)
+  }
+}
@@ -0,0 +1,40 @@
+//===- compile_cache_xclbin.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t.cache
+// RUN: aie2xclbin -v --cache-dir=%t.cache --host-target=aarch64-linux-gnu --peano=%PEANO_INSTALL_DIR %s --tmpdir=%t.first --xclbin-name=test.xclbin | FileCheck %s --check-prefix=COLD
+// RUN: aie2xclbin -v --cache-dir=%t.cache --host-target=aarch64-linux-gnu --peano=%PEANO_INSTALL_DIR %s --tmpdir=%t.second --xclbin-name=test.xclbin | FileCheck %s --check-prefix=WARM
+// REQUIRES: peano
+
+// COLD-NOT: Using cached
+// COLD: llc
+// COLD: core_1_2.elf
+// COLD-NOT: Using cached
+
+// WARM-NOT: llc
+// WARM: Using cached {{.*}}input.o
+// WARM: Using cached {{.*}}core_1_2.elf
+// WARM-NOT: bootgen
+// WARM: Using cached {{.*}}design.pdi
+// WARM-NOT: xclbinutil
+// WARM: Using cached {{.*}}test.xclbin
+
+module {
+  aie.device(ipu) {
+    %12 = aie.tile(1, 2)
+    %buf = aie.buffer(%12) : memref<256xi32>
+    %4 = aie.core(%12)  {
+      %0 = arith.constant 0 : i32
+      %1 = arith.constant 0 : index
+      memref.store %0, %buf[%1] : memref<256xi32>
+      aie.end
+    }
+  }
+}
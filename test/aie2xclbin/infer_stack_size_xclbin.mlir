@@ -0,0 +1,38 @@
+//===- infer_stack_size_xclbin.mlir ----------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t.default %t.inferred
+// RUN: aie2xclbin -v --host-target=aarch64-linux-gnu --peano=%PEANO_INSTALL_DIR %s --tmpdir=%t.default --xclbin-name=test.xclbin | FileCheck %s --check-prefix=DEFAULT
+// RUN: FileCheck %s --input-file=%t.default/core_1_2.elf.ld --check-prefix=DEFAULT-LD
+// RUN: aie2xclbin -v --infer-stack-size --host-target=aarch64-linux-gnu --peano=%PEANO_INSTALL_DIR %s --tmpdir=%t.inferred --xclbin-name=test.xclbin | FileCheck %s --check-prefix=INFERRED
+// RUN: FileCheck %s --input-file=%t.inferred/core_1_2.elf.ld --check-prefix=INFERRED-LD
+// REQUIRES: peano
+
+// DEFAULT-NOT: Shrinking the stack
+// DEFAULT-LD: _sp_start_value_DM_stack = .;
+// DEFAULT-LD-NEXT: . += 0x1000; /* stack */
+
+// The core only stores a constant, so its calls fit in the first KiB.
+// INFERRED: Shrinking the stack of core_1_2 from 4096 to 1024 bytes
+// INFERRED-LD: _sp_start_value_DM_stack = .;
+// INFERRED-LD-NEXT: . += 0x400; /* stack */
+
+module {
+  aie.device(ipu) {
+    %12 = aie.tile(1, 2)
+    %buf12 = aie.buffer(%12) : memref<256xi32>
+    %c12 = aie.core(%12)  {
+      %0 = arith.constant 0 : i32
+      %1 = arith.constant 0 : index
+      memref.store %0, %buf12[%1] : memref<256xi32>
+      aie.end
+    } { stack_size = 4096 : i32 }
+  }
+}
@@ -0,0 +1,42 @@
+//===- kernel_lib_xclbin.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: echo 'int scale_kernel(int x) { return 3 * x; }' > %t/scale.c
+// RUN: echo 'int unused_kernel(int x) { return x + 1; }' > %t/unused.c
+// RUN: %PEANO_INSTALL_DIR/bin/clang --target=aie2-none-unknown-elf -O2 -c %t/scale.c -o %t/scale.o
+// RUN: %PEANO_INSTALL_DIR/bin/clang --target=aie2-none-unknown-elf -O2 -c %t/unused.c -o %t/unused.o
+// RUN: %PEANO_INSTALL_DIR/bin/llvm-ar rcs %t/libscale.a %t/scale.o
+// RUN: %PEANO_INSTALL_DIR/bin/llvm-ar rcs %t/libunused.a %t/unused.o
+// RUN: aie2xclbin -v --host-target=aarch64-linux-gnu --peano=%PEANO_INSTALL_DIR --kernel-lib-dir=%t --kernel-lib=scale --kernel-lib=%t/libunused.a %s --tmpdir=%t/prj --xclbin-name=test.xclbin | FileCheck %s --implicit-check-not=libunused.a
+// RUN: %PEANO_INSTALL_DIR/bin/llvm-nm %t/prj/core_1_2.elf | FileCheck %s --check-prefix=NM
+// REQUIRES: peano
+
+// Only the library defining the function called by the core is linked.
+// CHECK: {{.*}}/libscale.a {{.*}}core_1_2.elf
+// CHECK: bootgen
+
+// NM: T scale_kernel
+// NM-NOT: unused_kernel
+
+module {
+  aie.device(ipu) {
+    %12 = aie.tile(1, 2)
+    %buf12 = aie.buffer(%12) : memref<256xi32>
+    func.func private @scale_kernel(i32) -> i32
+    %c12 = aie.core(%12)  {
+      %0 = arith.constant 7 : i32
+      %1 = arith.constant 0 : index
+      %2 = func.call @scale_kernel(%0) : (i32) -> i32
+      memref.store %2, %buf12[%1] : memref<256xi32>
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,48 @@
+//===- parallel_elf_xclbin.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie2xclbin -v -j 4 --host-target=aarch64-linux-gnu --peano=%PEANO_INSTALL_DIR %s --xclbin-name=test.xclbin | FileCheck %s
+// REQUIRES: peano
+
+// Per-core links run concurrently but are reported in tile order.
+// CHECK: core_1_2.elf
+// CHECK: core_2_2.elf
+// CHECK: core_3_2.elf
+// CHECK: bootgen
+// CHECK: xclbinutil
+
+module {
+  aie.device(ipu) {
+    %12 = aie.tile(1, 2)
+    %22 = aie.tile(2, 2)
+    %32 = aie.tile(3, 2)
+    %buf12 = aie.buffer(%12) : memref<256xi32>
+    %buf22 = aie.buffer(%22) : memref<256xi32>
+    %buf32 = aie.buffer(%32) : memref<256xi32>
+    %c12 = aie.core(%12)  {
+      %0 = arith.constant 0 : i32
+      %1 = arith.constant 0 : index
+      memref.store %0, %buf12[%1] : memref<256xi32>
+      aie.end
+    }
+    %c22 = aie.core(%22)  {
+      %0 = arith.constant 1 : i32
+      %1 = arith.constant 0 : index
+      memref.store %0, %buf22[%1] : memref<256xi32>
+      aie.end
+    }
+    %c32 = aie.core(%32)  {
+      %0 = arith.constant 2 : i32
+      %1 = arith.constant 0 : index
+      memref.store %0, %buf32[%1] : memref<256xi32>
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,62 @@
+//===- partition_xclbin.mlir -----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t.default %t.columns
+// RUN: aie2xclbin --host-target=aarch64-linux-gnu --peano=%PEANO_INSTALL_DIR %s --tmpdir=%t.default --xclbin-name=test.xclbin
+// RUN: FileCheck %s --input-file=%t.default/aie_partition.json --check-prefix=DEFAULT
+// RUN: FileCheck %s --input-file=%t.default/design.bif --check-prefix=BIF
+// RUN: aie2xclbin --start-columns=1,3 --host-target=aarch64-linux-gnu --peano=%PEANO_INSTALL_DIR %s --tmpdir=%t.columns --xclbin-name=test.xclbin
+// RUN: FileCheck %s --input-file=%t.columns/aie_partition.json --check-prefix=COLUMNS
+// REQUIRES: peano
+
+// The design spans columns 1 and 2, so its partition fits at each column from
+// 1 to 3 of the 5 columns of the device.
+// DEFAULT:      "partition": {
+// DEFAULT-NEXT:   "column_width": 2,
+// DEFAULT-NEXT:   "start_columns": [
+// DEFAULT-NEXT:     1,
+// DEFAULT-NEXT:     2,
+// DEFAULT-NEXT:     3
+// DEFAULT-NEXT:   ]
+
+// The ELFs are loaded by one CDO for each of the columns of the cores.
+// BIF:      file={{.*}}aie_cdo_error_handling.bin
+// BIF-NEXT: file={{.*}}aie_cdo_elfs_1.bin
+// BIF-NEXT: file={{.*}}aie_cdo_elfs_2.bin
+// BIF-NEXT: file={{.*}}aie_cdo_init.bin
+// BIF-NEXT: file={{.*}}aie_cdo_enable.bin
+
+// COLUMNS:      "partition": {
+// COLUMNS-NEXT:   "column_width": 2,
+// COLUMNS-NEXT:   "start_columns": [
+// COLUMNS-NEXT:     1,
+// COLUMNS-NEXT:     3
+// COLUMNS-NEXT:   ]
+
+module {
+  aie.device(ipu) {
+    %12 = aie.tile(1, 2)
+    %22 = aie.tile(2, 2)
+    %buf12 = aie.buffer(%12) : memref<256xi32>
+    %buf22 = aie.buffer(%22) : memref<256xi32>
+    %c12 = aie.core(%12)  {
+      %0 = arith.constant 0 : i32
+      %1 = arith.constant 0 : index
+      memref.store %0, %buf12[%1] : memref<256xi32>
+      aie.end
+    }
+    %c22 = aie.core(%22)  {
+      %0 = arith.constant 1 : i32
+      %1 = arith.constant 0 : index
+      memref.store %0, %buf22[%1] : memref<256xi32>
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,40 @@
+//===- program_memory_xclbin.mlir ------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t.report %t.size
+// RUN: aie2xclbin --report-program-memory --host-target=aarch64-linux-gnu --peano=%PEANO_INSTALL_DIR %s --tmpdir=%t.report --xclbin-name=test.xclbin | FileCheck %s --check-prefix=REPORT
+// RUN: aie2xclbin -v --size-opt-threshold=1 --host-target=aarch64-linux-gnu --peano=%PEANO_INSTALL_DIR %s --tmpdir=%t.size --xclbin-name=test.xclbin | FileCheck %s --check-prefix=SIZE
+// REQUIRES: peano
+
+// The core is far below the default threshold, so it is compiled once.
+// REPORT: Program memory of core (1,2): {{[0-9]+}} of 16384 bytes ({{[0-9]+}}%)
+// REPORT-NOT: Program memory of core
+
+// With a threshold of 1%, the core is compiled again for size, and its
+// program memory checked again.
+// SIZE: Run: {{.*}}opt -O2
+// SIZE: Program memory of core (1,2): {{[0-9]+}} of 16384 bytes
+// SIZE: A core uses {{[0-9]+}}% of the program memory, compiling for size
+// SIZE: Run: {{.*}}opt -Os
+// SIZE: Program memory of core (1,2): {{[0-9]+}} of 16384 bytes
+// SIZE-NOT: compiling for size
+
+module {
+  aie.device(ipu) {
+    %12 = aie.tile(1, 2)
+    %buf12 = aie.buffer(%12) : memref<256xi32>
+    %c12 = aie.core(%12)  {
+      %0 = arith.constant 0 : i32
+      %1 = arith.constant 0 : index
+      memref.store %0, %buf12[%1] : memref<256xi32>
+      aie.end
+    }
+  }
+}
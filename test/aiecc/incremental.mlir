@@ -0,0 +1,50 @@
+//===- incremental.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// REQUIRES: peano
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: cd %t && %PYTHON aiecc.py --incremental --unified --no-xchesscc --no-xbridge --no-compile-host -v --tmpdir=%t/prj %s | FileCheck %s --check-prefix=FIRST
+// RUN: cd %t && %PYTHON aiecc.py --incremental --unified --no-xchesscc --no-xbridge --no-compile-host -v --tmpdir=%t/prj %s | FileCheck %s --check-prefix=SECOND
+// RUN: sed 's/arith.constant 0 : i32/arith.constant 1 : i32/' %s > %t/changed.mlir
+// RUN: cd %t && %PYTHON aiecc.py --incremental --unified --no-xchesscc --no-xbridge --no-compile-host -v --tmpdir=%t/prj %t/changed.mlir | FileCheck %s --check-prefix=CHANGED
+
+// The first build runs every stage.
+// FIRST-NOT: Keeping
+// FIRST: {{^[^ ]*}}llc
+// FIRST: clang {{.*}}-o ./core_1_2.elf
+// FIRST-NOT: Keeping
+
+// The second build of the same design keeps the outputs of the placement and
+// routing, of the unified object and of the link.
+// SECOND: Keeping {{.*}}/prj/input_with_addresses.mlir
+// SECOND-NOT: {{^[^ ]*}}llc
+// SECOND: Keeping {{.*}}/prj/input.o
+// SECOND: Keeping ./core_1_2.elf
+// SECOND-NOT: {{^[^ ]*}}clang
+
+// A change of the design runs the stages again.
+// CHANGED-NOT: Keeping
+// CHANGED: {{^[^ ]*}}llc
+// CHANGED: clang {{.*}}-o ./core_1_2.elf
+// CHANGED-NOT: Keeping
+
+module {
+  aie.device(ipu) {
+    %12 = aie.tile(1, 2)
+    %buf12 = aie.buffer(%12) : memref<256xi32>
+    %c12 = aie.core(%12)  {
+      %0 = arith.constant 0 : i32
+      %1 = arith.constant 0 : index
+      memref.store %0, %buf12[%1] : memref<256xi32>
+      aie.end
+    }
+  }
+}
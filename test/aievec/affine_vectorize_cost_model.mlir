@@ -0,0 +1,63 @@
+// RUN: aie-opt %s -split-input-file --aie-affine-vectorize="aieml=true emit-remarks=true" -verify-diagnostics | FileCheck %s
+// RUN: aie-opt %s -split-input-file --aie-affine-vectorize="aieml=true vector-register-bits=2048" | FileCheck %s --check-prefix=PRESSURE
+
+// The 512-bit vectors halve the loop overheads of the 256-bit ones, and
+// unrolling by 4 spreads them over 128 elements.
+
+// CHECK-LABEL: func.func @add_i16
+// CHECK:         affine.for %{{.*}} = 0 to 256 step 128 {
+// CHECK-COUNT-8:   vector.transfer_read {{.*}} : memref<256xi16>, vector<32xi16>
+// CHECK-COUNT-4:   vector.transfer_write {{.*}} : vector<32xi16>, memref<256xi16>
+
+// With 2048 bits of vector registers, two iterations of 512-bit vectors fit,
+// but not four.
+
+// PRESSURE-LABEL: func.func @add_i16
+// PRESSURE:         affine.for %{{.*}} = 0 to 256 step 64 {
+// PRESSURE-COUNT-4:   vector.transfer_read {{.*}} : memref<256xi16>, vector<32xi16>
+func.func @add_i16(%a: memref<256xi16>, %b: memref<256xi16>, %c: memref<256xi16>) {
+  // expected-remark @+1 {{vectorized by 32 lanes, unrolled by 4: 0.078 cycles per element (16x1: 0.188, 32x1: 0.125, 16x2: 0.125, 32x2: 0.094, 16x4: 0.094, 32x4: 0.078)}}
+  affine.for %i = 0 to 256 {
+    %0 = affine.load %a[%i] : memref<256xi16>
+    %1 = affine.load %b[%i] : memref<256xi16>
+    %2 = arith.addi %0, %1 : i16
+    affine.store %2, %c[%i] : memref<256xi16>
+  }
+  return
+}
+
+// -----
+
+// The 16 lanes of a 32-bit multiplication on AIE-ML.
+
+// CHECK-LABEL: func.func @mul_i32
+// CHECK:         affine.for %{{.*}} = 0 to 128 step 64 {
+// CHECK-COUNT-8:   vector.transfer_read {{.*}} : memref<128xi32>, vector<16xi32>
+func.func @mul_i32(%a: memref<128xi32>, %b: memref<128xi32>, %c: memref<128xi32>) {
+  // expected-remark @+1 {{vectorized by 16 lanes, unrolled by 4}}
+  affine.for %i = 0 to 128 {
+    %0 = affine.load %a[%i] : memref<128xi32>
+    %1 = affine.load %b[%i] : memref<128xi32>
+    %2 = arith.muli %0, %1 : i32
+    affine.store %2, %c[%i] : memref<128xi32>
+  }
+  return
+}
+
+// -----
+
+// No number of lanes divides the trip count: aie-vectorize would reject the
+// unaligned loads.
+
+// CHECK-LABEL: func.func @unaligned
+// CHECK:         affine.for %{{.*}} = 0 to 100 {
+// CHECK-NEXT:      affine.load
+func.func @unaligned(%a: memref<100xi16>, %b: memref<100xi16>) {
+  // expected-remark @+1 {{not vectorized (16x1: unaligned, 32x1: unaligned}}
+  affine.for %i = 0 to 100 {
+    %0 = affine.load %a[%i] : memref<100xi16>
+    %1 = arith.addi %0, %0 : i16
+    affine.store %1, %b[%i] : memref<100xi16>
+  }
+  return
+}
@@ -0,0 +1,66 @@
+//===- scratchpads.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-allocate-scratchpads=report=true --verify-diagnostics %s | FileCheck %s
+
+// %b is allocated after the last access to %a, so both start at offset 0.
+// %c and %d are live during the whole loop, so %d is placed after %c, at the
+// next multiple of 32 bytes. %e has a dynamic size and stays on the heap.
+// CHECK-LABEL: aie.device(xcvc1902)
+// CHECK: %[[T:.*]] = aie.tile(3, 3)
+// CHECK: %[[S:.*]] = aie.buffer(%[[T]]) {sym_name = "core_3_3_scratch"} : memref<256xi8>
+// CHECK: aie.core(%[[T]])
+// CHECK: %[[OA:.*]] = arith.constant 0 : index
+// CHECK: %[[A:.*]] = memref.view %[[S]][%[[OA]]][] : memref<256xi8> to memref<64xi32>
+// CHECK: memref.store %{{.*}}, %[[A]][%{{.*}}] : memref<64xi32>
+// CHECK-NOT: memref.dealloc %[[A]]
+// CHECK: %[[OB:.*]] = arith.constant 0 : index
+// CHECK: %[[B:.*]] = memref.view %[[S]][%[[OB]]][] : memref<256xi8> to memref<16xf32>
+// CHECK: scf.for
+// CHECK: %[[OC:.*]] = arith.constant 0 : index
+// CHECK: memref.view %[[S]][%[[OC]]][] : memref<256xi8> to memref<8xi16>
+// CHECK: %[[OD:.*]] = arith.constant 32 : index
+// CHECK: memref.view %[[S]][%[[OD]]][] : memref<256xi8> to memref<4xi8>
+// CHECK: memref.alloc(%{{.*}}) : memref<?xi32>
+
+module @test {
+ aie.device(xcvc1902) {
+  %t33 = aie.tile(3, 3)
+  // expected-remark @+1 {{scratchpad of 256 bytes for 4 allocation(s) of 340 bytes}}
+  %core = aie.core(%t33) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c4 = arith.constant 4 : index
+    %v = arith.constant 7 : i32
+    %f = arith.constant 1.0 : f32
+    %h = arith.constant 3 : i16
+    %q = arith.constant 5 : i8
+    %a = memref.alloc() : memref<64xi32>
+    memref.store %v, %a[%c0] : memref<64xi32>
+    %x = memref.load %a[%c0] : memref<64xi32>
+    memref.dealloc %a : memref<64xi32>
+    %b = memref.alloca() : memref<16xf32>
+    memref.store %f, %b[%c0] : memref<16xf32>
+    scf.for %i = %c0 to %c4 step %c1 {
+      %c = memref.alloc() : memref<8xi16>
+      %d = memref.alloc() : memref<4xi8>
+      memref.store %h, %c[%i] : memref<8xi16>
+      memref.store %q, %d[%i] : memref<4xi8>
+      memref.dealloc %d : memref<4xi8>
+      memref.dealloc %c : memref<8xi16>
+    }
+    // expected-remark @+1 {{not placed in the scratchpad: its type isn't static or has a layout}}
+    %e = memref.alloc(%c4) : memref<?xi32>
+    memref.store %x, %e[%c0] : memref<?xi32>
+    memref.dealloc %e : memref<?xi32>
+    aie.end
+  }
+ }
+}
@@ -0,0 +1,55 @@
+//===- bursts.mlir ---------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -aie-analyze-shim-bursts="remarks=true" --verify-diagnostics %s
+
+module {
+  aie.device(ipu) {
+    func.func @sequence(%in : memref<4096xi32>, %out : memref<256xi32>, %pad : memref<1024xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c4 = arith.constant 4 : i64
+      %c8 = arith.constant 8 : i64
+      %c16 = arith.constant 16 : i64
+      %c64 = arith.constant 64 : i64
+      %c100 = arith.constant 100 : i64
+      %c110 = arith.constant 110 : i64
+      %c128 = arith.constant 128 : i64
+
+      // expected-remark@+1 {{runs of 256 bytes aligned to 256 bytes, effective bursts of 256 bytes out of 256 (100% efficiency)}}
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<256xi32>
+
+      // A 16x16 tile of a 64 columns wide matrix.
+      // expected-warning@+2 {{runs of 64 bytes aligned to 256 bytes, effective bursts of 64 bytes out of 256 (25% efficiency)}}
+      // expected-note@+1 {{a host layout storing the 16 rows of dimension 1 contiguously, with a stride of 16 elements instead of 64, gives runs of 1024 bytes}}
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c16,%c16][%c0,%c0,%c64]) { metadata = @in, id = 1 : i64 } : memref<4096xi32>
+
+      // With bursts of 64 bytes, the rows of the tile fill them.
+      // expected-remark@+1 {{runs of 64 bytes aligned to 64 bytes, effective bursts of 64 bytes out of 64 (100% efficiency)}}
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c16,%c16][%c0,%c0,%c64]) { metadata = @in, id = 1 : i64, burst_length = 64 : i32 } : memref<4096xi32>
+
+      // The two outer dimensions are in the wrong order to merge.
+      // expected-warning@+2 {{runs of 64 bytes aligned to 64 bytes, effective bursts of 64 bytes out of 256 (25% efficiency)}}
+      // expected-note@+1 {{re-striding as [1, 4, 4, 16][0, 64, 16] gives runs of 1024 bytes (100% efficiency)}}
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c4,%c4,%c16][%c0,%c16,%c64]) { metadata = @in, id = 1 : i64 } : memref<4096xi32>
+
+      // expected-warning@+2 {{runs of 512 bytes aligned to 4 bytes, effective bursts of 170 bytes out of 256 (66% efficiency)}}
+      // expected-note@+1 {{aligning the offset of the transfer to 256 bytes in the host buffer aligns its runs}}
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c1][%c1,%c1,%c1,%c128][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<256xi32>
+
+      // expected-warning@+2 {{runs of 400 bytes aligned to 8 bytes, effective bursts of 133 bytes out of 256 (52% efficiency)}}
+      // expected-note@+1 {{padding the stride of dimension 1 from 110 to 128 elements aligns its runs to 256 bytes}}
+      aiex.ipu.dma_memcpy_nd (0, 0, %pad[%c0,%c0,%c0,%c0][%c1,%c1,%c8,%c100][%c0,%c0,%c110]) { metadata = @in, id = 1 : i64 } : memref<1024xi32>
+      return
+    }
+    aie.shim_dma_allocation @in (MM2S, 0, 0)
+    aie.shim_dma_allocation @out (S2MM, 0, 0)
+  }
+}
@@ -0,0 +1,43 @@
+//===- bank_aware.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-assign-buffer-addresses="alloc-scheme=bank-aware" %s | FileCheck %s
+
+// The buffers used by the core of (3, 3) each get their own 4KB bank, the
+// stack stays alone in bank 0.
+// CHECK:   {{.*}} aie.buffer({{.*}}) {address = 8192 : i32, sym_name = "a"} : memref<256xi32>
+// CHECK:   {{.*}} aie.buffer({{.*}}) {address = 12288 : i32, sym_name = "b"} : memref<128xi32>
+// CHECK:   {{.*}} aie.buffer({{.*}}) {address = 4096 : i32, sym_name = "c"} : memref<512xi32>
+// CHECK:   {{.*}} aie.buffer({{.*}}) {address = 16384 : i32, sym_name = "d"} : memref<64xi32>
+// A buffer larger than a bank falls back to sequential allocation.
+// CHECK:   {{.*}} aie.buffer({{.*}}) {address = 1024 : i32, sym_name = "e"} : memref<2048xi32>
+
+module @test {
+ aie.device(xcvc1902) {
+  %0 = aie.tile(3, 3)
+  %a = aie.buffer(%0) { sym_name = "a" } : memref<256xi32>
+  %b = aie.buffer(%0) { sym_name = "b" } : memref<128xi32>
+  %c = aie.buffer(%0) { sym_name = "c" } : memref<512xi32>
+  %d = aie.buffer(%0) { sym_name = "d" } : memref<64xi32>
+  %1 = aie.tile(4, 4)
+  %e = aie.buffer(%1) { sym_name = "e" } : memref<2048xi32>
+  aie.core(%0) {
+    %i = arith.constant 0 : index
+    %va = memref.load %a[%i] : memref<256xi32>
+    %vb = memref.load %b[%i] : memref<128xi32>
+    %sum = arith.addi %va, %vb : i32
+    memref.store %sum, %c[%i] : memref<512xi32>
+    aie.end
+  }
+  aie.core(%1) {
+    aie.end
+  }
+ }
+}
@@ -0,0 +1,46 @@
+//===- neighbor_memory.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-assign-buffer-addresses="use-neighbor-memory=true" %s | FileCheck %s
+
+// The buffers of the core in (3, 3) don't fit in its memory, so the largest
+// one moves to the memory of (3, 4) rather than (2, 3), which holds a DMA
+// buffer.
+// CHECK: %[[T23:.*]] = aie.tile(2, 3)
+// CHECK: %[[T33:.*]] = aie.tile(3, 3)
+// CHECK: %[[T34:.*]] = aie.tile(3, 4)
+// CHECK: aie.buffer(%[[T23]]) {address = 0 : i32, sym_name = "x"} : memref<256xi32>
+// CHECK: aie.buffer(%[[T34]]) {address = 0 : i32, sym_name = "a"} : memref<7168xi32>
+// CHECK: aie.buffer(%[[T33]]) {address = 1024 : i32, sym_name = "b"} : memref<1024xi32>
+
+module @test {
+ aie.device(xcvc1902) {
+  %t23 = aie.tile(2, 3)
+  %t33 = aie.tile(3, 3)
+  %t34 = aie.tile(3, 4)
+  %x = aie.buffer(%t23) { sym_name = "x" } : memref<256xi32>
+  %a = aie.buffer(%t33) { sym_name = "a" } : memref<7168xi32>
+  %b = aie.buffer(%t33) { sym_name = "b" } : memref<1024xi32>
+  %m23 = aie.mem(%t23) {
+    %dma = aie.dma_start(S2MM, 0, ^bd0, ^end)
+  ^bd0:
+    aie.dma_bd(%x : memref<256xi32>, 0, 256)
+    aie.next_bd ^bd0
+  ^end:
+    aie.end
+  }
+  aie.core(%t33) {
+    %i = arith.constant 0 : index
+    %va = memref.load %a[%i] : memref<7168xi32>
+    memref.store %va, %b[%i] : memref<1024xi32>
+    aie.end
+  }
+ }
+}
@@ -0,0 +1,46 @@
+//===- span_memtiles.mlir --------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-assign-buffer-addresses="span-memtiles=true" %s | FileCheck %s
+
+// The buffers of the memtile (3, 1) take 656000 bytes, so "b" continues for
+// 131712 bytes into the memory of (4, 1), whose own buffer comes after it.
+// CHECK: aie.buffer(%{{.*}}) {address = 0 : i32, sym_name = "a"} : memref<100000xi32>
+// CHECK: aie.buffer(%{{.*}}) {address = 400000 : i32, sym_name = "b"} : memref<64000xi32>
+// CHECK: aie.buffer(%{{.*}}) {address = 131712 : i32, sym_name = "c"} : memref<1024xi32>
+
+module @test {
+ aie.device(xcve2302) {
+  %t31 = aie.tile(3, 1)
+  %t41 = aie.tile(4, 1)
+  %a = aie.buffer(%t31) { sym_name = "a" } : memref<100000xi32>
+  %b = aie.buffer(%t31) { sym_name = "b" } : memref<64000xi32>
+  %c = aie.buffer(%t41) { sym_name = "c" } : memref<1024xi32>
+  aie.memtile_dma(%t31) {
+    %dma = aie.dma_start(MM2S, 0, ^bd0, ^end)
+  ^bd0:
+    aie.dma_bd(%a : memref<100000xi32>, 0, 100000)
+    aie.next_bd ^bd1
+  ^bd1:
+    aie.dma_bd(%b : memref<64000xi32>, 0, 64000)
+    aie.next_bd ^bd0
+  ^end:
+    aie.end
+  }
+  aie.memtile_dma(%t41) {
+    %dma = aie.dma_start(MM2S, 0, ^bd0, ^end)
+  ^bd0:
+    aie.dma_bd(%c : memref<1024xi32>, 0, 1024)
+    aie.next_bd ^bd0
+  ^end:
+    aie.end
+  }
+ }
+}
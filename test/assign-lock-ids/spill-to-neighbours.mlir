@@ -0,0 +1,105 @@
+//===- spill-to-neighbours.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-assign-lock-ids=spill-to-neighbours --split-input-file --verify-diagnostics %s | FileCheck %s
+
+// The 17th lock of tile (2, 3) is only used by its core, which can also access
+// the memory of tile (2, 4), so it moves there. Tile (1, 3) is west of the core,
+// whose memory it can't access on AIE2.
+
+// CHECK-LABEL: aie.device(xcve2802)
+// CHECK:   %[[T13:.*]] = aie.tile(1, 3)
+// CHECK:   %[[T23:.*]] = aie.tile(2, 3)
+// CHECK:   %[[T24:.*]] = aie.tile(2, 4)
+// CHECK:   aie.lock(%[[T24]], 1)
+// CHECK:   aie.lock(%[[T23]], 0)
+// CHECK:   aie.lock(%[[T23]], 15)
+// CHECK:   aie.lock(%[[T24]], 0) {init = 0 : i32}
+aie.device(xcve2802) {
+  %t13 = aie.tile(1, 3)
+  %t23 = aie.tile(2, 3)
+  %t24 = aie.tile(2, 4)
+  %l24 = aie.lock(%t24, 1)
+    %l0 = aie.lock(%t23) { init = 0 : i32 }
+    %l1 = aie.lock(%t23) { init = 0 : i32 }
+    %l2 = aie.lock(%t23) { init = 0 : i32 }
+    %l3 = aie.lock(%t23) { init = 0 : i32 }
+    %l4 = aie.lock(%t23) { init = 0 : i32 }
+    %l5 = aie.lock(%t23) { init = 0 : i32 }
+    %l6 = aie.lock(%t23) { init = 0 : i32 }
+    %l7 = aie.lock(%t23) { init = 0 : i32 }
+    %l8 = aie.lock(%t23) { init = 0 : i32 }
+    %l9 = aie.lock(%t23) { init = 0 : i32 }
+    %l10 = aie.lock(%t23) { init = 0 : i32 }
+    %l11 = aie.lock(%t23) { init = 0 : i32 }
+    %l12 = aie.lock(%t23) { init = 0 : i32 }
+    %l13 = aie.lock(%t23) { init = 0 : i32 }
+    %l14 = aie.lock(%t23) { init = 0 : i32 }
+    %l15 = aie.lock(%t23) { init = 0 : i32 }
+    %l16 = aie.lock(%t23) { init = 0 : i32 }
+  aie.core(%t23) {
+      aie.use_lock(%l0, Release, 1)
+      aie.use_lock(%l1, Release, 1)
+      aie.use_lock(%l2, Release, 1)
+      aie.use_lock(%l3, Release, 1)
+      aie.use_lock(%l4, Release, 1)
+      aie.use_lock(%l5, Release, 1)
+      aie.use_lock(%l6, Release, 1)
+      aie.use_lock(%l7, Release, 1)
+      aie.use_lock(%l8, Release, 1)
+      aie.use_lock(%l9, Release, 1)
+      aie.use_lock(%l10, Release, 1)
+      aie.use_lock(%l11, Release, 1)
+      aie.use_lock(%l12, Release, 1)
+      aie.use_lock(%l13, Release, 1)
+      aie.use_lock(%l14, Release, 1)
+      aie.use_lock(%l15, Release, 1)
+      aie.use_lock(%l16, Release, 1)
+    aie.end
+  }
+}
+
+// -----
+
+// A lock used by a DMA stays on its tile.
+
+aie.device(xcve2802) {
+  // expected-note @below {{because only 16 locks available in this tile and its neighbours}}
+  %t23 = aie.tile(2, 3)
+  %t24 = aie.tile(2, 4)
+  %l0 = aie.lock(%t23)
+  %l1 = aie.lock(%t23)
+  %l2 = aie.lock(%t23)
+  %l3 = aie.lock(%t23)
+  %l4 = aie.lock(%t23)
+  %l5 = aie.lock(%t23)
+  %l6 = aie.lock(%t23)
+  %l7 = aie.lock(%t23)
+  %l8 = aie.lock(%t23)
+  %l9 = aie.lock(%t23)
+  %l10 = aie.lock(%t23)
+  %l11 = aie.lock(%t23)
+  %l12 = aie.lock(%t23)
+  %l13 = aie.lock(%t23)
+  %l14 = aie.lock(%t23)
+  %l15 = aie.lock(%t23)
+  // expected-error @below {{not allocated a lock}}
+  %l16 = aie.lock(%t23)
+  %buf = aie.buffer(%t23) : memref<16xi32>
+  aie.mem(%t23) {
+    %dma = aie.dma_start(MM2S, 0, ^bd0, ^end)
+  ^bd0:
+    aie.use_lock(%l16, AcquireGreaterEqual, 1)
+    aie.dma_bd(%buf : memref<16xi32>, 0, 16)
+    aie.next_bd ^end
+  ^end:
+    aie.end
+  }
+}
@@ -0,0 +1,110 @@
+//===- compact.mlir --------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-compact-bd-chains %s | FileCheck %s
+// RUN: aie-opt --aie-compact-bd-chains="report-bd-usage=true" %s -verify-diagnostics -o /dev/null
+
+// The S2MM chain alternates between two BDs twice before looping back, so
+// one period of two BDs is kept.  The MM2S chain sends the same buffer
+// twice and stops: it becomes a single BD repeated twice.
+// CHECK-LABEL: aie.device(xcve2302)
+// CHECK: aie.memtile_dma
+// CHECK:   aie.dma_start(S2MM, 0, ^[[BD0:.*]], ^[[NEXT:.*]])
+// CHECK: ^[[BD0]]:
+// CHECK:   aie.dma_bd(%[[PING:.*]] : memref<16xi32>, 0, 16)
+// CHECK:   aie.next_bd ^[[BD1:.*]]
+// CHECK: ^[[BD1]]:
+// CHECK:   aie.dma_bd(%[[PONG:.*]] : memref<16xi32>, 0, 16)
+// CHECK:   aie.next_bd ^[[BD0]]
+// CHECK: ^[[NEXT]]:
+// CHECK:   aie.dma_start(MM2S, 0, ^[[BD2:.*]], ^[[END:.*]], repeat_count = 2)
+// CHECK: ^[[BD2]]:
+// CHECK:   aie.dma_bd(%[[PING]] : memref<16xi32>, 0, 16)
+// CHECK:   aie.next_bd ^[[END]]
+// CHECK-NOT: aie.dma_bd
+// CHECK: ^[[END]]:
+// CHECK:   aie.end
+
+// AIE1 channels have no repeat count, so the acyclic chain is left alone.
+// CHECK-LABEL: aie.device(xcvc1902)
+// CHECK: aie.mem
+// CHECK: aie.dma_start(MM2S, 0, ^{{.*}}, ^{{.*}})
+// CHECK: aie.dma_bd
+// CHECK: aie.dma_bd
+
+module @test {
+ aie.device(xcve2302) {
+  %t01 = aie.tile(0, 1)
+  %ping = aie.buffer(%t01) : memref<16xi32>
+  %pong = aie.buffer(%t01) : memref<16xi32>
+  %lock0 = aie.lock(%t01, 0) {init = 2 : i32}
+  %lock1 = aie.lock(%t01, 1) {init = 0 : i32}
+  // expected-remark@+1 {{uses 3 of 48 buffer descriptors}}
+  %m01 = aie.memtile_dma(%t01) {
+    %s0 = aie.dma_start(S2MM, 0, ^bd0, ^mm2s)
+  ^bd0:
+    aie.use_lock(%lock0, AcquireGreaterEqual, 1)
+    aie.dma_bd(%ping : memref<16xi32>, 0, 16)
+    aie.use_lock(%lock1, Release, 1)
+    aie.next_bd ^bd1
+  ^bd1:
+    aie.use_lock(%lock0, AcquireGreaterEqual, 1)
+    aie.dma_bd(%pong : memref<16xi32>, 0, 16)
+    aie.use_lock(%lock1, Release, 1)
+    aie.next_bd ^bd2
+  ^bd2:
+    aie.use_lock(%lock0, AcquireGreaterEqual, 1)
+    aie.dma_bd(%ping : memref<16xi32>, 0, 16)
+    aie.use_lock(%lock1, Release, 1)
+    aie.next_bd ^bd3
+  ^bd3:
+    aie.use_lock(%lock0, AcquireGreaterEqual, 1)
+    aie.dma_bd(%pong : memref<16xi32>, 0, 16)
+    aie.use_lock(%lock1, Release, 1)
+    aie.next_bd ^bd0
+  ^mm2s:
+    %s1 = aie.dma_start(MM2S, 0, ^bd4, ^end)
+  ^bd4:
+    aie.use_lock(%lock1, AcquireGreaterEqual, 1)
+    aie.dma_bd(%ping : memref<16xi32>, 0, 16)
+    aie.use_lock(%lock0, Release, 1)
+    aie.next_bd ^bd5
+  ^bd5:
+    aie.use_lock(%lock1, AcquireGreaterEqual, 1)
+    aie.dma_bd(%ping : memref<16xi32>, 0, 16)
+    aie.use_lock(%lock0, Release, 1)
+    aie.next_bd ^end
+  ^end:
+    aie.end
+  }
+ }
+
+ aie.device(xcvc1902) {
+  %t33 = aie.tile(3, 3)
+  %buf = aie.buffer(%t33) : memref<16xi32>
+  %lock = aie.lock(%t33, 0)
+  // expected-remark@+1 {{uses 2 of 16 buffer descriptors}}
+  %m33 = aie.mem(%t33) {
+    %s0 = aie.dma_start(MM2S, 0, ^bd0, ^end)
+  ^bd0:
+    aie.use_lock(%lock, Acquire, 1)
+    aie.dma_bd(%buf : memref<16xi32>, 0, 16)
+    aie.use_lock(%lock, Release, 0)
+    aie.next_bd ^bd1
+  ^bd1:
+    aie.use_lock(%lock, Acquire, 1)
+    aie.dma_bd(%buf : memref<16xi32>, 0, 16)
+    aie.use_lock(%lock, Release, 0)
+    aie.next_bd ^end
+  ^end:
+    aie.end
+  }
+ }
+}
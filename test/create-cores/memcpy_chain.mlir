@@ -0,0 +1,83 @@
+//===- memcpy_chain.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-create-cores --aie-lower-memcpy %s | FileCheck %s
+
+// The copies between the same two tiles share one flow and are chained on one
+// DMA channel of each tile, which alternates between the ping and pong
+// buffers as their tokens are released.
+
+// CHECK-LABEL: module @memcpy_chain {
+// CHECK:         %[[T11:.*]] = aie.tile(1, 1)
+// CHECK:         aie.mem(%[[T11]]) {
+// CHECK:           aie.dma_start(MM2S, 0, ^bb1, ^bb3)
+// CHECK:         ^bb1:
+// CHECK:           aiex.useToken @ping(Acquire, 1)
+// CHECK:           aie.dma_bd(%{{.*}} : memref<256xi32>, 0, 256)
+// CHECK:           aiex.useToken @ping(Release, 2)
+// CHECK:           aie.next_bd ^bb2
+// CHECK:         ^bb2:
+// CHECK:           aiex.useToken @pong(Acquire, 1)
+// CHECK:           aie.dma_bd(%{{.*}} : memref<256xi32>, 0, 256)
+// CHECK:           aiex.useToken @pong(Release, 2)
+// CHECK:           aie.next_bd ^bb3
+// CHECK:         ^bb3:
+// CHECK:           aie.end
+// CHECK:         %[[T22:.*]] = aie.tile(2, 2)
+// CHECK:         aie.mem(%[[T22]]) {
+// CHECK:           aie.dma_start(S2MM, 0, ^bb1, ^bb3)
+// CHECK:         ^bb1:
+// CHECK:           aiex.useToken @ping(Acquire, 1)
+// CHECK:           aiex.useToken @ping(Release, 2)
+// CHECK:           aie.next_bd ^bb2
+// CHECK:         ^bb2:
+// CHECK:           aiex.useToken @pong(Acquire, 1)
+// CHECK:           aiex.useToken @pong(Release, 2)
+// CHECK:           aie.next_bd ^bb3
+// CHECK:         ^bb3:
+// CHECK:           aie.end
+// CHECK:         aie.flow(%[[T11]], DMA : 0, %[[T22]], DMA : 0)
+// CHECK-NOT:     aie.flow
+
+module @memcpy_chain {
+ aie.device(xcvc1902) {
+  %t11 = aie.tile(1, 1)
+  %t22 = aie.tile(2, 2)
+
+  %buf0 = memref.alloc() : memref<256xi32>
+  %buf1 = memref.alloc() : memref<256xi32>
+  %buf2 = memref.alloc() : memref<256xi32>
+  %buf3 = memref.alloc() : memref<256xi32>
+
+  aiex.token(0) { sym_name="ping" }
+  aiex.token(0) { sym_name="pong" }
+
+  func.func @producer(%arg0: memref<256xi32>, %arg1: memref<256xi32>) -> () {
+    aiex.useToken @ping(Acquire, 0)
+    aiex.useToken @ping(Release, 1)
+    aiex.useToken @pong(Acquire, 0)
+    aiex.useToken @pong(Release, 1)
+    return
+  }
+
+  func.func @consumer(%arg0: memref<256xi32>, %arg1: memref<256xi32>) -> () {
+    aiex.useToken @ping(Acquire, 2)
+    aiex.useToken @ping(Release, 3)
+    aiex.useToken @pong(Acquire, 2)
+    aiex.useToken @pong(Release, 3)
+    return
+  }
+
+  func.call @producer(%buf0, %buf1) { aie.x = 1, aie.y = 1 } : (memref<256xi32>, memref<256xi32>) -> ()
+  aiex.memcpy @ping(1, 2) (%t11 : <%buf0, 0, 256>, %t22 : <%buf2, 0, 256>) : (memref<256xi32>, memref<256xi32>)
+  aiex.memcpy @pong(1, 2) (%t11 : <%buf1, 0, 256>, %t22 : <%buf3, 0, 256>) : (memref<256xi32>, memref<256xi32>)
+  func.call @consumer(%buf2, %buf3) { aie.x = 2, aie.y = 2 } : (memref<256xi32>, memref<256xi32>) -> ()
+ }
+}
@@ -11,20 +11,18 @@
 // RUN: aie-opt --aie-create-cores --aie-lower-memcpy %s | FileCheck %s
 // XFAIL: *
 
-// FIXCore : DMA ops have issues here: reuse of DMAs is bad, also should chain from one DMA op to the next.
-
 // CHECK-LABEL: module @test_dma1 {
 // CHECK:         %[[VAL_0:.*]] = aie.tile(1, 1)
 // CHECK:         %[[VAL_1:.*]] = aie.buffer(%[[VAL_0]]) : memref<256xi32>
 // CHECK:         %[[VAL_2:.*]] = aie.mem(%[[VAL_0]]) {
-// CHECK:           %[[VAL_3:.*]] = aie.dma_start(MM2S, 0, ^bb1, ^bb4)
+// CHECK:           %[[VAL_3:.*]] = aie.dma_start(MM2S, 0, ^bb1, ^bb2)
 // CHECK:         ^bb1:
 // CHECK:           aiex.useToken @token0(Acquire, 1)
 // CHECK:           aie.dma_bd(%[[VAL_1]] : memref<256xi32>, 0, 256)
 // CHECK:           aiex.useToken @token0(Release, 2)
 // CHECK:           aie.next_bd ^bb4
 // CHECK:         ^bb2:
-// CHECK:           %[[VAL_4:.*]] = aie.dma_start(MM2S, 0, ^bb3, ^bb4)
+// CHECK:           %[[VAL_4:.*]] = aie.dma_start(MM2S, 1, ^bb3, ^bb4)
 // CHECK:         ^bb3:
 // CHECK:           aiex.useToken @token1(Acquire, 1)
 // CHECK:           aie.dma_bd(%[[VAL_1]] : memref<256xi32>, 0, 256)
@@ -70,7 +68,7 @@
 // CHECK:           aie.end
 // CHECK:         }
 // CHECK:         aie.flow(%[[VAL_0]], DMA : 0, %[[VAL_5]], DMA : 0)
-// CHECK:         aie.flow(%[[VAL_0]], DMA : 0, %[[VAL_9]], DMA : 0)
+// CHECK:         aie.flow(%[[VAL_0]], DMA : 1, %[[VAL_9]], DMA : 0)
 // CHECK:         %[[VAL_17:.*]] = aie.core(%[[VAL_5]]) {
 // CHECK:           aiex.useToken @token0(Acquire, 2)
 // CHECK:           aiex.useToken @token0(Release, 3)
@@ -0,0 +1,42 @@
+//===- bandwidth_flows.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt %s | FileCheck %s --check-prefix=ROUNDTRIP
+// RUN: aie-opt --aie-create-pathfinder-flows="bandwidth-aware=true" %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="bandwidth-aware=true incremental=true" %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="bandwidth-aware=true" --aie-find-flows %s | FileCheck %s --check-prefix=FLOWS
+
+// ROUNDTRIP: aie.flow(%{{.*}}, Core : 0, %{{.*}}, Core : 0) {bandwidth = 3000 : i32}
+// ROUNDTRIP: aie.flow(%{{.*}}, DMA : 0, %{{.*}}, DMA : 0) {bandwidth = 3000 : i32}
+
+// Both streams are heavy enough that the second one takes the other of the two
+// shortest routes instead of sharing channels with the first.
+// CHECK: %[[T11:.*]] = aie.tile(1, 1)
+// CHECK: %[[T12:.*]] = aie.tile(1, 2)
+// CHECK: %[[T21:.*]] = aie.tile(2, 1)
+// CHECK: %[[T22:.*]] = aie.tile(2, 2)
+// CHECK-DAG: aie.switchbox(%[[T12]]) {
+// CHECK-DAG: aie.switchbox(%[[T21]]) {
+
+// FLOWS: %[[T11:.*]] = aie.tile(1, 1)
+// FLOWS: %[[T22:.*]] = aie.tile(2, 2)
+// FLOWS-DAG: aie.flow(%[[T11]], Core : 0, %[[T22]], Core : 0)
+// FLOWS-DAG: aie.flow(%[[T11]], DMA : 0, %[[T22]], DMA : 0)
+
+module {
+  aie.device(xcvc1902) {
+    %t11 = aie.tile(1, 1)
+    %t12 = aie.tile(1, 2)
+    %t21 = aie.tile(2, 1)
+    %t22 = aie.tile(2, 2)
+    aie.flow(%t11, Core : 0, %t22, Core : 0) {bandwidth = 3000 : i32}
+    aie.flow(%t11, DMA : 0, %t22, DMA : 0) {bandwidth = 3000 : i32}
+  }
+}
@@ -9,6 +9,9 @@
 //===----------------------------------------------------------------------===//
 
 // RUN: aie-opt --aie-create-pathfinder-flows --aie-find-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="incremental=true" --aie-find-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="parallel=true" --aie-find-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="incremental=true parallel=true" --aie-find-flows %s | FileCheck %s
 //CHECK: %[[t01:.*]] = aie.tile(0, 1)
 //CHECK: %[[t02:.*]] = aie.tile(0, 2)
 //CHECK: %[[t03:.*]] = aie.tile(0, 3)
@@ -9,6 +9,9 @@
 //===----------------------------------------------------------------------===//
 
 // RUN: aie-opt --aie-create-pathfinder-flows --aie-find-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="incremental=true" --aie-find-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="parallel=true" --aie-find-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="incremental=true parallel=true" --aie-find-flows %s | FileCheck %s
 // CHECK: %[[T02:.*]] = aie.tile(0, 2)
 // CHECK: %[[T03:.*]] = aie.tile(0, 3)
 // CHECK: %[[T11:.*]] = aie.tile(1, 1)
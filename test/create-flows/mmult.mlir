@@ -9,6 +9,7 @@
 //===----------------------------------------------------------------------===//
 
 // RUN: aie-opt --aie-create-pathfinder-flows --aie-find-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="incremental=true" --aie-find-flows %s | FileCheck %s
 
 // CHECK: %[[T1:.*]] = aie.tile(7, 0)
 // CHECK: %[[T3:.*]] = aie.tile(8, 3)
@@ -0,0 +1,39 @@
+//===- pathfinder_cache.mlir -----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The first run routes the flows and caches the routing, the second run reuses
+// it and must produce the same flows.
+
+// RUN: rm -rf %t
+// RUN: aie-opt --aie-create-pathfinder-flows="cache-dir=%t" --aie-find-flows %s | FileCheck %s
+// RUN: ls %t | FileCheck %s --check-prefix=CACHE
+// RUN: aie-opt --aie-create-pathfinder-flows="cache-dir=%t" --aie-find-flows %s | FileCheck %s
+// RUN: ls %t | FileCheck %s --check-prefix=CACHE
+
+// CHECK: %[[T23:.*]] = aie.tile(2, 3)
+// CHECK: %[[T22:.*]] = aie.tile(2, 2)
+// CHECK: %[[T33:.*]] = aie.tile(3, 3)
+// CHECK-DAG: aie.flow(%[[T23]], Core : 0, %[[T22]], Core : 1)
+// CHECK-DAG: aie.flow(%[[T22]], Core : 0, %[[T33]], DMA : 0)
+// CHECK-DAG: aie.flow(%[[T33]], DMA : 1, %[[T23]], Core : 1)
+
+// CACHE-COUNT-1: {{^[0-9a-f]+}}.json
+// CACHE-NOT: .json
+
+module {
+  aie.device(xcvc1902) {
+    %t23 = aie.tile(2, 3)
+    %t22 = aie.tile(2, 2)
+    %t33 = aie.tile(3, 3)
+    aie.flow(%t23, Core : 0, %t22, Core : 1)
+    aie.flow(%t22, Core : 0, %t33, DMA : 0)
+    aie.flow(%t33, DMA : 1, %t23, Core : 1)
+  }
+}
@@ -0,0 +1,86 @@
+//===- test_multicast_relay.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-lower-multicast="relay-threshold=4 packet-threshold=2" %s | FileCheck %s
+
+// The columns 1 and 2 hold several destinations and are reached through their
+// memtiles, the single destination of column 3 directly. The fan-outs to more
+// than two destinations are packet flows.
+
+// CHECK-DAG:   %[[M11:.*]] = aie.tile(1, 1)
+// CHECK-DAG:   %[[M21:.*]] = aie.tile(2, 1)
+// CHECK-DAG:   %[[T00:.*]] = aie.tile(0, 0)
+// CHECK-DAG:   %[[T12:.*]] = aie.tile(1, 2)
+// CHECK-DAG:   %[[T13:.*]] = aie.tile(1, 3)
+// CHECK-DAG:   %[[T14:.*]] = aie.tile(1, 4)
+// CHECK-DAG:   %[[T15:.*]] = aie.tile(1, 5)
+// CHECK-DAG:   %[[T22:.*]] = aie.tile(2, 2)
+// CHECK-DAG:   %[[T23:.*]] = aie.tile(2, 3)
+// CHECK-DAG:   %[[T32:.*]] = aie.tile(3, 2)
+// CHECK-DAG:   %[[B0:.*]] = aie.buffer(%[[M11]]) {sym_name = "relay0_buff_0"} : memref<256xi32>
+// CHECK-DAG:   %[[B1:.*]] = aie.buffer(%[[M11]]) {sym_name = "relay0_buff_1"} : memref<256xi32>
+// CHECK-DAG:   %[[PROD:.*]] = aie.lock(%[[M11]]) {init = 2 : i32, sym_name = "relay0_prod_lock"}
+// CHECK-DAG:   %[[CONS:.*]] = aie.lock(%[[M11]]) {init = 0 : i32, sym_name = "relay0_cons_lock"}
+// CHECK-DAG:   aie.buffer(%[[M21]]) {sym_name = "relay1_buff_0"} : memref<256xi32>
+// CHECK:       aie.memtile_dma(%[[M11]]) {
+// CHECK:         aie.dma_start(S2MM, 0, ^bb1, ^bb3)
+// CHECK:       ^bb1:
+// CHECK:         aie.use_lock(%[[PROD]], AcquireGreaterEqual, 1)
+// CHECK:         aie.dma_bd(%[[B0]] : memref<256xi32>, 0, 256)
+// CHECK:         aie.use_lock(%[[CONS]], Release, 1)
+// CHECK:         aie.next_bd ^bb2
+// CHECK:       ^bb2:
+// CHECK:         aie.dma_bd(%[[B1]] : memref<256xi32>, 0, 256)
+// CHECK:         aie.next_bd ^bb1
+// CHECK:       ^bb3:
+// CHECK:         aie.dma_start(MM2S, 0, ^bb4, ^bb6)
+// CHECK:       ^bb4:
+// CHECK:         aie.use_lock(%[[CONS]], AcquireGreaterEqual, 1)
+// CHECK:         aie.dma_bd(%[[B0]] : memref<256xi32>, 0, 256)
+// CHECK:         aie.use_lock(%[[PROD]], Release, 1)
+// CHECK:       ^bb6:
+// CHECK:         aie.end
+// CHECK:       aie.memtile_dma(%[[M21]])
+// CHECK:       aie.packet_flow(0) {
+// CHECK-NEXT:    aie.packet_source<%[[T00]], DMA : 0>
+// CHECK-NEXT:    aie.packet_dest<%[[M11]], DMA : 0>
+// CHECK-NEXT:    aie.packet_dest<%[[M21]], DMA : 0>
+// CHECK-NEXT:    aie.packet_dest<%[[T32]], DMA : 0>
+// CHECK:       aie.packet_flow(1) {
+// CHECK-NEXT:    aie.packet_source<%[[M11]], DMA : 0>
+// CHECK-NEXT:    aie.packet_dest<%[[T12]], DMA : 0>
+// CHECK-NEXT:    aie.packet_dest<%[[T13]], DMA : 0>
+// CHECK-NEXT:    aie.packet_dest<%[[T14]], DMA : 0>
+// CHECK-NEXT:    aie.packet_dest<%[[T15]], DMA : 0>
+// CHECK:       aie.flow(%[[M21]], DMA : 0, %[[T22]], DMA : 0)
+// CHECK:       aie.flow(%[[M21]], DMA : 0, %[[T23]], DMA : 0)
+// CHECK-NOT:   aiex.multicast
+
+module @test_multicast_relay {
+ aie.device(ipu) {
+  %00 = aie.tile(0, 0)
+  %12 = aie.tile(1, 2)
+  %13 = aie.tile(1, 3)
+  %14 = aie.tile(1, 4)
+  %15 = aie.tile(1, 5)
+  %22 = aie.tile(2, 2)
+  %23 = aie.tile(2, 3)
+  %32 = aie.tile(3, 2)
+  aiex.multicast(%00, "DMA" : 0){
+    aiex.multi_dest<%12, "DMA" : 0>
+    aiex.multi_dest<%13, "DMA" : 0>
+    aiex.multi_dest<%14, "DMA" : 0>
+    aiex.multi_dest<%15, "DMA" : 0>
+    aiex.multi_dest<%22, "DMA" : 0>
+    aiex.multi_dest<%23, "DMA" : 0>
+    aiex.multi_dest<%32, "DMA" : 0>
+  } {aie.relay_buffer = memref<256xi32>}
+ }
+}
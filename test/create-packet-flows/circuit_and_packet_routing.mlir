@@ -9,6 +9,7 @@
 //===----------------------------------------------------------------------===//
 
 // RUN: aie-opt --aie-create-packet-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-packet-flows="use-pathfinder=true" %s | FileCheck %s
 
 // CHECK-LABEL: module @aie_module {
 // CHECK:   %[[VAL_0:.*]] = aie.tile(7, 2)
@@ -0,0 +1,48 @@
+//===- pathfinder_packet_flows.mlir ----------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-create-packet-flows="use-pathfinder=true" %s | FileCheck %s
+
+// Two packet flows with different IDs share the connections from (1, 1) to
+// (1, 3), and so a single master port in each switchbox along the way.
+
+// CHECK:   %[[T11:.*]] = aie.tile(1, 1)
+// CHECK:   aie.switchbox(%[[T11]]) {
+// CHECK:     aie.masterset(North : 5, %{{.*}})
+// CHECK-NOT: aie.masterset
+// CHECK:   %[[T12:.*]] = aie.tile(1, 2)
+// CHECK:   aie.switchbox(%[[T12]]) {
+// CHECK:     aie.masterset(North : 5, %{{.*}})
+// CHECK:     aie.packet_rules(South : 5) {
+// CHECK-NEXT:  aie.rule(28, 0, %{{.*}})
+// CHECK-NEXT: }
+// CHECK:   %[[T13:.*]] = aie.tile(1, 3)
+// CHECK:   aie.switchbox(%[[T13]]) {
+// CHECK-DAG: aie.masterset(DMA : 0, %{{.*}})
+// CHECK-DAG: aie.masterset(DMA : 1, %{{.*}})
+// CHECK-DAG: aie.rule(31, 1, %{{.*}})
+// CHECK-DAG: aie.rule(31, 2, %{{.*}})
+
+module @pathfinder_packet_flows {
+ aie.device(xcvc1902) {
+  %t11 = aie.tile(1, 1)
+  %t12 = aie.tile(1, 2)
+  %t13 = aie.tile(1, 3)
+
+  aie.packet_flow(0x1) {
+    aie.packet_source<%t11, DMA : 0>
+    aie.packet_dest<%t13, DMA : 0>
+  }
+  aie.packet_flow(0x2) {
+    aie.packet_source<%t11, DMA : 1>
+    aie.packet_dest<%t13, DMA : 1>
+  }
+ }
+}
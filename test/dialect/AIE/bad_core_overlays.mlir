@@ -0,0 +1,39 @@
+//===- bad_core_overlays.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --verify-diagnostics --split-input-file %s
+
+aie.device(ipu) {
+  %tile_0_2 = aie.tile(0, 2)
+  // expected-error@+1 {{overlays and overlay_size must be given together}}
+  %core_0_2 = aie.core(%tile_0_2) {
+    aie.end
+  } {overlays = ["conv.o"]}
+}
+
+// -----
+
+aie.device(ipu) {
+  %tile_0_2 = aie.tile(0, 2)
+  // expected-error@+1 {{should have at least one overlay}}
+  %core_0_2 = aie.core(%tile_0_2) {
+    aie.end
+  } {overlays = [], overlay_size = 8192 : i32}
+}
+
+// -----
+
+aie.device(ipu) {
+  %tile_0_2 = aie.tile(0, 2)
+  // expected-error@+1 {{overlay_size must be a positive multiple of 16 bytes, smaller than the program memory of 16384 bytes}}
+  %core_0_2 = aie.core(%tile_0_2) {
+    aie.end
+  } {overlays = ["conv.o"], overlay_size = 16384 : i32}
+}
@@ -0,0 +1,89 @@
+//===- bad_device_verify.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Checks reported by the verifier of the device for all its ops at once.
+
+// RUN: aie-opt %s -split-input-file -verify-diagnostics
+
+aie.device(xcvc1902) {
+  %t = aie.tile(2, 2)
+  // expected-error@-1 {{'aie.tile' op can only have one switchbox}}
+  aie.switchbox(%t) {
+  }
+  aie.switchbox(%t) {
+  }
+}
+
+// -----
+
+aie.device(xcve2802) {
+  %t22 = aie.tile(2, 2)
+  %t23 = aie.tile(2, 3)
+  %t24 = aie.tile(2, 4)
+  aie.objectfifo @fifo (%t22, {%t23}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+  // expected-error@+1 {{'aie.core' op consumer port of objectFifo accessed by core running on non-consumer tile}}
+  aie.core(%t24) {
+    %subview = aie.objectfifo.acquire @fifo (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+    aie.end
+  }
+}
+
+// -----
+
+aie.device(xcve2802) {
+  %t22 = aie.tile(2, 2)
+  %t23 = aie.tile(2, 3)
+  %t24 = aie.tile(2, 4)
+  aie.objectfifo @fifo (%t22, {%t23}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+  // expected-error@+1 {{'aie.core' op producer port of objectFifo accessed by core running on non-producer tile}}
+  aie.core(%t24) {
+    aie.objectfifo.release @fifo (Produce, 1)
+    aie.end
+  }
+}
+
+// -----
+
+aie.device(xcvc1902) {
+  %t33 = aie.tile(3, 3)
+  %l0 = aie.lock(%t33, 0)
+  %l1 = aie.lock(%t33, 1)
+  aie.mem(%t33) {
+    aie.dma_start(MM2S, 0, ^bb1, ^end)
+  ^bb1:
+    // expected-error@+1 {{'aie.use_lock' op used in a DMA block that have multiple locks.}}
+    aie.use_lock(%l0, Acquire, 1)
+    aie.use_lock(%l1, Acquire, 1)
+    aie.use_lock(%l0, Release, 0)
+    aie.use_lock(%l1, Release, 0)
+    aie.next_bd ^end
+  ^end:
+    aie.end
+  }
+}
+
+// -----
+
+aie.device(xcve2802) {
+  %t22 = aie.tile(2, 2)
+  %t23 = aie.tile(2, 3)
+  %t24 = aie.tile(2, 4)
+  aie.objectfifo @in (%t22, {%t23}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+  aie.objectfifo @out (%t24, {%t22}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+  // expected-error@+1 {{ObjectFifoLinkOp must have a link point}}
+  aie.objectfifo.link [@in] -> [@out] ()
+}
+
+// -----
+
+// expected-error@+1 {{attribute 'core_start_broadcast' failed to satisfy constraint}}
+aie.device(ipu) {
+  %t02 = aie.tile(0, 2)
+} {core_start_broadcast = 16 : i32}
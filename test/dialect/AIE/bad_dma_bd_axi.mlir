@@ -0,0 +1,41 @@
+//===- bad_dma_bd_axi.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -split-input-file --verify-diagnostics %s
+
+aie.device(xcve2802) {
+  %t12 = aie.tile(1, 2)
+  %buf = aie.buffer(%t12) : memref<256xi32>
+  %mem12 = aie.mem(%t12) {
+    aie.dma_start(MM2S, 0, ^bd0, ^end)
+  ^bd0:
+    // expected-error@+1 {{AXI settings are only supported on the BDs of shim DMAs.}}
+    aie.dma_bd(%buf : memref<256xi32>, 0, 256) {burst_length = 128 : i32}
+    aie.next_bd ^end
+  ^end:
+    aie.end
+  }
+}
+
+// -----
+
+aie.device(xcve2802) {
+  %t10 = aie.tile(1, 0)
+  %ext = aie.external_buffer : memref<256xi32>
+  %dma = aie.shim_dma(%t10) {
+    aie.dma_start(MM2S, 0, ^bd0, ^end)
+  ^bd0:
+    // expected-error@+1 {{burst_length must be 64, 128 or 256 bytes}}
+    aie.dma_bd(%ext : memref<256xi32>, 0, 256) {burst_length = 512 : i32}
+    aie.next_bd ^end
+  ^end:
+    aie.end
+  }
+}
@@ -0,0 +1,40 @@
+//===- bad_npu_geometry.mlir -----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt %s -split-input-file -verify-diagnostics
+
+// expected-error@+1 {{'aie.device' op only the npu device can describe its geometry}}
+aie.device(ipu) geometry {columns = 8 : i32} {
+}
+
+// -----
+
+// expected-error@+1 {{'aie.device' op unknown geometry entry 'colums'}}
+aie.device(npu) geometry {colums = 8 : i32} {
+}
+
+// -----
+
+// expected-error@+1 {{'aie.device' op NOC column 4 is outside of the 4 columns of the device}}
+aie.device(npu) geometry {columns = 4 : i32, noc_columns = [0, 4]} {
+}
+
+// -----
+
+// expected-error@+1 {{'aie.device' op geometry entry 'core_bds' must be in [1, 255]}}
+aie.device(npu) geometry {core_bds = 0 : i32} {
+}
+
+// -----
+
+aie.device(npu) geometry {columns = 6 : i32, noc_columns = [0]} {
+  %t = aie.tile(6, 2)
+  // expected-error@-1 {{'aie.tile' op column index (6) must be less than the number of columns in the device (6)}}
+}
@@ -0,0 +1,53 @@
+//===- bad_phases.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --verify-diagnostics --split-input-file %s
+
+aie.device(ipu) {
+  %tile_0_1 = aie.tile(0, 1)
+  %tile_0_2 = aie.tile(0, 2)
+  aie.objectfifo @in0(%tile_0_1, {%tile_0_2}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+  %core_0_2 = aie.core(%tile_0_2) {
+    %phase = arith.constant 0 : i32
+    // expected-error@+1 {{objectFifo @in0 is used by phases 0 and 1}}
+    aie.phases(%phase) {
+      %0 = aie.objectfifo.acquire @in0(Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @in0(Consume, 1)
+      aie.end
+    }, {
+      aie.objectfifo.release @in0(Consume, 1)
+      aie.end
+    }
+    aie.end
+  }
+}
+
+// -----
+
+aie.device(ipu) {
+  %tile_0_2 = aie.tile(0, 2)
+  %phase = arith.constant 0 : i32
+  // expected-error@+1 {{must be in a core}}
+  aie.phases(%phase) {
+    aie.end
+  }
+}
+
+// -----
+
+aie.device(ipu) {
+  %tile_0_2 = aie.tile(0, 2)
+  %core_0_2 = aie.core(%tile_0_2) {
+    %phase = arith.constant 0 : i32
+    // expected-error@+1 {{should have at least one phase}}
+    aie.phases(%phase)
+    aie.end
+  }
+}
@@ -0,0 +1,34 @@
+//===- dma-compression-bad.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --verify-diagnostics --split-input-file %s
+
+aie.device(xcvc1902) {
+  %tile33 = aie.tile(3, 3)
+  %buf33 = aie.buffer(%tile33) : memref<256xi32>
+  %mem33 = aie.mem(%tile33) {
+    %srcDma = aie.dma_start("MM2S", 0, ^bd0, ^end)
+    ^bd0:
+      // expected-error@+1 {{compression is only supported on AIE-ML devices}}
+      aie.dma_bd(%buf33 : memref<256xi32>, 0, 256) {compression}
+      aie.next_bd ^end
+    ^end:
+      aie.end
+  }
+}
+
+// -----
+
+aie.device(xcve2802) {
+  %tile20 = aie.tile(2, 0)
+  %tile23 = aie.tile(2, 3)
+  // expected-error@+1 {{compression is not supported on shim tiles}}
+  aie.objectfifo @of0 (%tile20, {%tile23}, 2 : i32) {compression} : !aie.objectfifo<memref<256xi32>>
+}
@@ -0,0 +1,89 @@
+//===- nd-dma-padding-bad.mlir ---------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --verify-diagnostics --split-input-file %s
+
+aie.device(xcve2302) {
+  %tile33 = aie.tile(3, 3)
+  %buf33 = aie.buffer(%tile33) : memref<32xi32>
+  %mem33 = aie.mem(%tile33) {
+    %srcDma = aie.dma_start("MM2S", 0, ^bd0, ^end)
+    ^bd0:
+      // expected-error@+1 {{padding is only supported on the MM2S channels of memtiles}}
+      aie.dma_bd(%buf33 : memref<32xi32>, 0, 50, [<size = 4, stride = 8>, <size = 8, stride = 1>], [<const_pad_before = 0, const_pad_after = 1>, <const_pad_before = 1, const_pad_after = 1>])
+      aie.next_bd ^end
+    ^end:
+      aie.end
+  }
+}
+
+// -----
+
+aie.device(xcve2302) {
+  %tile31 = aie.tile(3, 1)
+  %buf31 = aie.buffer(%tile31) : memref<32xi32>
+  %mem31 = aie.memtile_dma(%tile31) {
+    %srcDma = aie.dma_start("S2MM", 0, ^bd0, ^end)
+    ^bd0:
+      // expected-error@+1 {{padding is only supported on the MM2S channels of memtiles}}
+      aie.dma_bd(%buf31 : memref<32xi32>, 0, 50, [<size = 4, stride = 8>, <size = 8, stride = 1>], [<const_pad_before = 0, const_pad_after = 1>, <const_pad_before = 1, const_pad_after = 1>])
+      aie.next_bd ^bd0
+    ^end:
+      aie.end
+  }
+}
+
+// -----
+
+aie.device(xcve2302) {
+  %tile31 = aie.tile(3, 1)
+  %buf31 = aie.buffer(%tile31) : memref<32xi32>
+  %mem31 = aie.memtile_dma(%tile31) {
+    %srcDma = aie.dma_start("MM2S", 0, ^bd0, ^end)
+    ^bd0:
+      // expected-error@+1 {{expected one padding per dimension (2), got 1}}
+      aie.dma_bd(%buf31 : memref<32xi32>, 0, 50, [<size = 4, stride = 8>, <size = 8, stride = 1>], [<const_pad_before = 1, const_pad_after = 1>])
+      aie.next_bd ^bd0
+    ^end:
+      aie.end
+  }
+}
+
+// -----
+
+aie.device(xcve2302) {
+  %tile31 = aie.tile(3, 1)
+  %buf31 = aie.buffer(%tile31) : memref<32xi32>
+  %mem31 = aie.memtile_dma(%tile31) {
+    %srcDma = aie.dma_start("MM2S", 0, ^bd0, ^end)
+    ^bd0:
+      // expected-error@+1 {{padding of dimension 1 may not exceed 31}}
+      aie.dma_bd(%buf31 : memref<32xi32>, 0, 512, [<size = 4, stride = 8>, <size = 8, stride = 1>], [<const_pad_before = 32, const_pad_after = 0>, <const_pad_before = 1, const_pad_after = 1>])
+      aie.next_bd ^bd0
+    ^end:
+      aie.end
+  }
+}
+
+// -----
+
+aie.device(xcve2302) {
+  %tile31 = aie.tile(3, 1)
+  %buf31 = aie.buffer(%tile31) : memref<32xi32>
+  %mem31 = aie.memtile_dma(%tile31) {
+    %srcDma = aie.dma_start("MM2S", 0, ^bd0, ^end)
+    ^bd0:
+      // expected-error@+1 {{padded data (200 bytes) exceeds the length of the BD (128 bytes)}}
+      aie.dma_bd(%buf31 : memref<32xi32>, 0, 32, [<size = 4, stride = 8>, <size = 8, stride = 1>], [<const_pad_before = 0, const_pad_after = 1>, <const_pad_before = 1, const_pad_after = 1>])
+      aie.next_bd ^bd0
+    ^end:
+      aie.end
+  }
+}
@@ -0,0 +1,26 @@
+//===- nd-dma-padding.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt %s | FileCheck %s
+
+// CHECK: aie.dma_bd(%{{.*}} : memref<32xi32>, 0, 50, [<size = 4, stride = 8>, <size = 8, stride = 1>], [<const_pad_before = 0, const_pad_after = 1>, <const_pad_before = 1, const_pad_after = 1>])
+
+aie.device(xcve2302) {
+  %tile31 = aie.tile(3, 1)
+  %buf31 = aie.buffer(%tile31) : memref<32xi32>
+  %mem31 = aie.memtile_dma(%tile31) {
+    %srcDma = aie.dma_start("MM2S", 0, ^bd0, ^end)
+    ^bd0:
+      aie.dma_bd(%buf31 : memref<32xi32>, 0, 50, [<size = 4, stride = 8>, <size = 8, stride = 1>], [<const_pad_before = 0, const_pad_after = 1>, <const_pad_before = 1, const_pad_after = 1>])
+      aie.next_bd ^bd0
+    ^end:
+      aie.end
+  }
+}
@@ -0,0 +1,27 @@
+//===- npu_geometry.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt %s | FileCheck %s
+
+// CHECK: aie.device(npu) geometry {columns = 8 : i32, core_rows = 6 : i32, noc_columns = [0, 1, 2, 3, 4, 5, 6, 7]}
+// CHECK: aie.tile(7, 7)
+// CHECK: aie.lock(%{{.*}}, 63)
+aie.device(npu) geometry {columns = 8 : i32, core_rows = 6 : i32, noc_columns = [0, 1, 2, 3, 4, 5, 6, 7]} {
+  %t70 = aie.tile(7, 0)
+  %t71 = aie.tile(7, 1)
+  %t77 = aie.tile(7, 7)
+  %l = aie.lock(%t71, 63)
+}
+
+// CHECK: aie.device(npu) {
+// CHECK: aie.tile(4, 5)
+aie.device(npu) {
+  %t45 = aie.tile(4, 5)
+}
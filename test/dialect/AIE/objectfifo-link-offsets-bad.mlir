@@ -0,0 +1,63 @@
+//===- objectfifo-link-offsets-bad.mlir ------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --verify-diagnostics --split-input-file %s
+
+aie.device(xcve2302) {
+  %tile20 = aie.tile(2, 0)
+  %tile21 = aie.tile(2, 1)
+  %tile22 = aie.tile(2, 2)
+  %tile23 = aie.tile(2, 3)
+  aie.objectfifo @of_in (%tile20, {%tile21}, 2 : i32) : !aie.objectfifo<memref<96xi32>>
+  aie.objectfifo @of_out0 (%tile21, {%tile22}, 2 : i32) : !aie.objectfifo<memref<40xi32>>
+  aie.objectfifo @of_out1 (%tile21, {%tile23}, 2 : i32) : !aie.objectfifo<memref<56xi32>>
+  // expected-error@+1 {{ObjectFifoLinkOp expects 2 offsets, one per output objFifo, but got 1}}
+  aie.objectfifo.link [@of_in] -> [@of_out0, @of_out1] (offsets [0])
+}
+
+// -----
+
+aie.device(xcve2302) {
+  %tile20 = aie.tile(2, 0)
+  %tile21 = aie.tile(2, 1)
+  %tile22 = aie.tile(2, 2)
+  %tile23 = aie.tile(2, 3)
+  aie.objectfifo @of_in (%tile20, {%tile21}, 2 : i32) : !aie.objectfifo<memref<96xi32>>
+  aie.objectfifo @of_out0 (%tile21, {%tile22}, 2 : i32) : !aie.objectfifo<memref<40xi32>>
+  aie.objectfifo @of_out1 (%tile21, {%tile23}, 2 : i32) : !aie.objectfifo<memref<56xi32>>
+  // expected-error@+1 {{the part of objFifo @of_out1 at offset 48 of size 56 is out of the 96 elements of objFifo @of_in}}
+  aie.objectfifo.link [@of_in] -> [@of_out0, @of_out1] (offsets [0, 48])
+}
+
+// -----
+
+aie.device(xcve2302) {
+  %tile20 = aie.tile(2, 0)
+  %tile21 = aie.tile(2, 1)
+  %tile22 = aie.tile(2, 2)
+  %tile23 = aie.tile(2, 3)
+  aie.objectfifo @of_in0 (%tile22, {%tile21}, 2 : i32) : !aie.objectfifo<memref<8xi32>>
+  aie.objectfifo @of_in1 (%tile23, {%tile21}, 2 : i32) : !aie.objectfifo<memref<24xi32>>
+  aie.objectfifo @of_out (%tile21, {%tile20}, 2 : i32) : !aie.objectfifo<memref<32xi32>>
+  // expected-error@+1 {{the parts of the input objFifos of a join must cover each element of the output objFifo exactly once}}
+  aie.objectfifo.link [@of_in0, @of_in1] -> [@of_out] (offsets [4, 8])
+}
+
+// -----
+
+aie.device(xcve2302) {
+  %tile20 = aie.tile(2, 0)
+  %tile21 = aie.tile(2, 1)
+  %tile22 = aie.tile(2, 2)
+  aie.objectfifo @of_in (%tile20, {%tile21}, 2 : i32) : !aie.objectfifo<memref<32xi32>>
+  aie.objectfifo @of_out (%tile21, {%tile22}, 2 : i32) : !aie.objectfifo<memref<32xi32>>
+  // expected-error@+1 {{ObjectFifoLinkOp only supports offsets on a 'join' or a 'distribute'}}
+  aie.objectfifo.link [@of_in] -> [@of_out] (offsets [0])
+}
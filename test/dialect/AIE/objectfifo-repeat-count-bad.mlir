@@ -0,0 +1,42 @@
+//===- objectfifo-repeat-count-bad.mlir ------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --verify-diagnostics --split-input-file %s
+
+aie.device(xcve2302) {
+  %tile20 = aie.tile(2, 0)
+  %tile22 = aie.tile(2, 2)
+  // expected-error@+1 {{repeat_count is only supported on memtile producers}}
+  aie.objectfifo @of0 (%tile20, {%tile22}, 2 : i32) {repeat_count = 2 : i32} : !aie.objectfifo<memref<256xi32>>
+}
+
+// -----
+
+aie.device(xcve2302) {
+  %tile20 = aie.tile(2, 0)
+  %tile21 = aie.tile(2, 1)
+  %tile22 = aie.tile(2, 2)
+  %tile23 = aie.tile(2, 3)
+  aie.objectfifo @of_in (%tile20, {%tile21}, 2 : i32) : !aie.objectfifo<memref<512xi32>>
+  aie.objectfifo @of_out0 (%tile21, {%tile22}, 2 : i32) {repeat_count = 2 : i32} : !aie.objectfifo<memref<256xi32>>
+  aie.objectfifo @of_out1 (%tile21, {%tile23}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+  // expected-error@+1 {{ObjectFifoLinkOp only supports repeat_count on the output of a one-to-one link}}
+  aie.objectfifo.link [@of_in] -> [@of_out0, @of_out1] ()
+}
+
+// -----
+
+aie.device(xcve2302) {
+  %tile20 = aie.tile(2, 0)
+  %tile21 = aie.tile(2, 1)
+  %tile22 = aie.tile(2, 2)
+  // expected-error@+1 {{'aie.objectfifo' op attribute 'repeat_count' failed to satisfy constraint}}
+  aie.objectfifo @of0 (%tile21, {%tile22}, 2 : i32) {repeat_count = 0 : i32} : !aie.objectfifo<memref<256xi32>>
+}
@@ -0,0 +1,36 @@
+// RUN: aie-opt %s -transform-interpreter -verify-diagnostics | FileCheck %s
+
+// The coefficients are loaded once, before the loop. The load of %b stays in
+// the loop, which writes %b.
+
+// CHECK-LABEL: func.func @hoist
+// CHECK-SAME:      %[[A:[A-Za-z0-9]+]]: memref<256xi16>, %[[B:[A-Za-z0-9]+]]: memref<256xi16>, %[[COEFF:[A-Za-z0-9]+]]: memref<32xi16>
+// CHECK:         %[[W:.*]] = aievec.upd %[[COEFF]]
+// CHECK:         scf.for
+// CHECK-NEXT:      aievec.upd %[[A]]
+// CHECK-NEXT:      aievec.upd %[[B]]
+// CHECK-NEXT:      aievec.mul_elem %{{.*}}, %[[W]]
+func.func @hoist(%a : memref<256xi16>, %b : memref<256xi16>, %coeff : memref<32xi16>) {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  %shift = arith.constant 0 : i32
+  scf.for %i = %c0 to %c256 step %c16 {
+    %va = aievec.upd %a[%i] {index = 0 : i8, offset = 0 : i32} : memref<256xi16>, vector<32xi16>
+    %vb = aievec.upd %b[%c0] {index = 0 : i8, offset = 0 : i32} : memref<256xi16>, vector<32xi16>
+    %w = aievec.upd %coeff[%c0] {index = 0 : i8, offset = 0 : i32} : memref<32xi16>, vector<32xi16>
+    %m = aievec.mul_elem %va, %w : vector<32xi16>, vector<32xi16>, vector<32xi32>
+    %s = aievec.srs %m, %shift : vector<32xi32>, i32, vector<32xi16>
+    %r = arith.addi %s, %vb : vector<32xi16>
+    vector.transfer_write %r, %b[%i] : vector<32xi16>, memref<256xi16>
+  }
+  return
+}
+
+module attributes {transform.with_named_sequence} {
+  transform.named_sequence @__transform_main(%arg1: !transform.any_op {transform.readonly}) {
+    %0 = transform.structured.match ops{["scf.for"]} in %arg1 : (!transform.any_op) -> !transform.any_op
+    transform.aievec.hoist_loop_invariant_loads %0 : !transform.any_op
+    transform.yield
+  }
+}
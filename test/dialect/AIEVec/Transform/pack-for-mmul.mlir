@@ -0,0 +1,69 @@
+// RUN: aie-opt %s -transform-interpreter -split-input-file -verify-diagnostics | FileCheck %s
+
+// The lhs is packed into 4x8 tiles, the rhs into 8x4 tiles and the
+// accumulator into 4x4 tiles, the shape of a bf16 aievec.matmul.
+
+// CHECK-LABEL: func.func @matmul_bf16
+// CHECK-DAG:     %[[A:.*]] = tensor.pack {{.*}} inner_dims_pos = [0, 1] inner_tiles = [4, 8] {{.*}} : tensor<16x32xbf16> -> tensor<4x4x4x8xbf16>
+// CHECK-DAG:     %[[B:.*]] = tensor.pack {{.*}} inner_dims_pos = [0, 1] inner_tiles = [8, 4] {{.*}} : tensor<32x16xbf16> -> tensor<4x4x8x4xbf16>
+// CHECK-DAG:     %[[C:.*]] = tensor.pack {{.*}} inner_dims_pos = [0, 1] inner_tiles = [4, 4] {{.*}} : tensor<16x16xf32> -> tensor<4x4x4x4xf32>
+// CHECK:         %[[R:.*]] = linalg.generic
+// CHECK-SAME:        ins(%[[A]], %[[B]] : tensor<4x4x4x8xbf16>, tensor<4x4x8x4xbf16>)
+// CHECK-SAME:        outs(%[[C]] : tensor<4x4x4x4xf32>)
+// CHECK:         tensor.unpack %[[R]] {{.*}} : tensor<4x4x4x4xf32> -> tensor<16x16xf32>
+func.func @matmul_bf16(%A : tensor<16x32xbf16>, %B : tensor<32x16xbf16>,
+                       %C : tensor<16x16xf32>) -> tensor<16x16xf32> {
+  %0 = linalg.matmul ins(%A, %B : tensor<16x32xbf16>, tensor<32x16xbf16>)
+                     outs(%C : tensor<16x16xf32>) -> tensor<16x16xf32>
+  return %0 : tensor<16x16xf32>
+}
+
+module attributes {transform.with_named_sequence} {
+  transform.named_sequence @__transform_main(%arg1: !transform.any_op {transform.readonly}) {
+    %0 = transform.structured.match ops{["linalg.matmul"]} in %arg1 : (!transform.any_op) -> !transform.any_op
+    %1 = transform.aievec.pack_for_mmul %0 : (!transform.any_op) -> !transform.any_op
+    transform.yield
+  }
+}
+
+// -----
+
+// The packed op vectorizes into 4x8x8 contractions.
+
+// CHECK-LABEL: func.func @matmul_i8
+// CHECK:         linalg.generic
+// CHECK-SAME:        ins({{.*}} : tensor<4x2xvector<4x8xi8>>, tensor<2x4xvector<8x8xi8>>)
+// CHECK:           vector.contract {{.*}} : vector<4x8xi8>, vector<8x8xi8> into vector<4x8xi32>
+func.func @matmul_i8(%A : tensor<16x16xi8>, %B : tensor<16x32xi8>,
+                     %C : tensor<16x32xi32>) -> tensor<16x32xi32> {
+  %0 = linalg.matmul ins(%A, %B : tensor<16x16xi8>, tensor<16x32xi8>)
+                     outs(%C : tensor<16x32xi32>) -> tensor<16x32xi32>
+  return %0 : tensor<16x32xi32>
+}
+
+module attributes {transform.with_named_sequence} {
+  transform.named_sequence @__transform_main(%arg1: !transform.any_op {transform.readonly}) {
+    %0 = transform.structured.match ops{["linalg.matmul"]} in %arg1 : (!transform.any_op) -> !transform.any_op
+    %1 = transform.aievec.pack_for_mmul %0 : (!transform.any_op) -> !transform.any_op
+    %2 = transform.structured.vectorize_contraction %1 : (!transform.any_op) -> !transform.any_op
+    transform.yield
+  }
+}
+
+// -----
+
+func.func @matmul_f32(%A : tensor<16x16xf32>, %B : tensor<16x16xf32>,
+                      %C : tensor<16x16xf32>) -> tensor<16x16xf32> {
+  %0 = linalg.matmul ins(%A, %B : tensor<16x16xf32>, tensor<16x16xf32>)
+                     outs(%C : tensor<16x16xf32>) -> tensor<16x16xf32>
+  return %0 : tensor<16x16xf32>
+}
+
+module attributes {transform.with_named_sequence} {
+  transform.named_sequence @__transform_main(%arg1: !transform.any_op {transform.readonly}) {
+    %0 = transform.structured.match ops{["linalg.matmul"]} in %arg1 : (!transform.any_op) -> !transform.any_op
+    // expected-error @+1 {{no aievec.matmul for the element types of the payload.}}
+    %1 = transform.aievec.pack_for_mmul %0 : (!transform.any_op) -> !transform.any_op
+    transform.yield
+  }
+}
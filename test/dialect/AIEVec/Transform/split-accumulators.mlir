@@ -0,0 +1,105 @@
+// RUN: aie-opt %s -transform-interpreter -split-input-file -verify-diagnostics | FileCheck %s
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// The contractions of even and odd iterations accumulate into different
+// registers, added together after the loop.
+
+// CHECK-LABEL: func.func @contract
+// CHECK-SAME:      %[[ACC0:[A-Za-z0-9]+]]: vector<4x4xf32>
+// CHECK-DAG:     %[[ZERO:.*]] = arith.constant dense<0.000000e+00> : vector<4x4xf32>
+// CHECK-DAG:     %[[C8:.*]] = arith.constant 8 : index
+// CHECK:         %[[R:.*]]:2 = scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %[[C8]]
+// CHECK-SAME:        iter_args(%[[X:.*]] = %[[ACC0]], %[[Y:.*]] = %[[ZERO]])
+// CHECK:           %[[A0:.*]] = vector.transfer_read %{{.*}}[%[[I]], %{{.*}}]
+// CHECK:           %[[P0:.*]] = vector.contract {{.*}} %[[A0]], %{{.*}}, %[[X]]
+// CHECK:           %[[I1:.*]] = arith.addi %[[I]], %{{.*}} : index
+// CHECK:           %[[A1:.*]] = vector.transfer_read %{{.*}}[%[[I1]], %{{.*}}]
+// CHECK:           %[[P1:.*]] = vector.contract {{.*}} %[[A1]], %{{.*}}, %[[Y]]
+// CHECK:           scf.yield %[[P0]], %[[P1]]
+// CHECK:         %[[SUM:.*]] = arith.addf %[[R]]#0, %[[R]]#1 : vector<4x4xf32>
+// CHECK:         return %[[SUM]]
+func.func @contract(%a : memref<64x8xbf16>, %b : vector<8x4xbf16>,
+                    %acc0 : vector<4x4xf32>) -> vector<4x4xf32> {
+  %c0 = arith.constant 0 : index
+  %c4 = arith.constant 4 : index
+  %c64 = arith.constant 64 : index
+  %pad = arith.constant 0.0 : bf16
+  %0 = scf.for %i = %c0 to %c64 step %c4 iter_args(%acc = %acc0) -> (vector<4x4xf32>) {
+    %va = vector.transfer_read %a[%i, %c0], %pad {in_bounds = [true, true]} : memref<64x8xbf16>, vector<4x8xbf16>
+    %1 = vector.contract {indexing_maps = [#map, #map1, #map2],
+                          iterator_types = ["parallel", "parallel", "reduction"],
+                          kind = #vector.kind<add>} %va, %b, %acc :
+                          vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+    scf.yield %1 : vector<4x4xf32>
+  }
+  return %0 : vector<4x4xf32>
+}
+
+module attributes {transform.with_named_sequence} {
+  transform.named_sequence @__transform_main(%arg1: !transform.any_op {transform.readonly}) {
+    %0 = transform.structured.match ops{["scf.for"]} in %arg1 : (!transform.any_op) -> !transform.op<"scf.for">
+    %1 = transform.aievec.split_accumulators %0 : (!transform.op<"scf.for">) -> !transform.any_op
+    transform.yield
+  }
+}
+
+// -----
+
+// Only the sum is split: the index carried by the loop is chained through the
+// copies of the body.
+
+// CHECK-LABEL: func.func @sum
+// CHECK:         %[[R:.*]]:5 = scf.for {{.*}} iter_args(%[[S0:.*]] = %{{.*}}, %[[P:.*]] = %{{.*}}, %[[S1:.*]] = %{{.*}}, %[[S2:.*]] = %{{.*}}, %[[S3:.*]] = %{{.*}})
+// CHECK-COUNT-4:   arith.addi {{.*}} : vector<16xi32>
+// CHECK:         %[[T0:.*]] = arith.addi %[[R]]#0, %[[R]]#2 : vector<16xi32>
+// CHECK:         %[[T1:.*]] = arith.addi %[[T0]], %[[R]]#3 : vector<16xi32>
+// CHECK:         %[[T2:.*]] = arith.addi %[[T1]], %[[R]]#4 : vector<16xi32>
+// CHECK:         return %[[T2]], %[[R]]#1
+func.func @sum(%a : memref<256xi32>, %init : vector<16xi32>) -> (vector<16xi32>, index) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c16 = arith.constant 16 : index
+  %pad = arith.constant 0 : i32
+  %0:2 = scf.for %i = %c0 to %c16 step %c1 iter_args(%s = %init, %p = %c0) -> (vector<16xi32>, index) {
+    %v = vector.transfer_read %a[%p], %pad {in_bounds = [true]} : memref<256xi32>, vector<16xi32>
+    %1 = arith.addi %v, %s : vector<16xi32>
+    %2 = arith.addi %p, %c16 : index
+    scf.yield %1, %2 : vector<16xi32>, index
+  }
+  return %0#0, %0#1 : vector<16xi32>, index
+}
+
+module attributes {transform.with_named_sequence} {
+  transform.named_sequence @__transform_main(%arg1: !transform.any_op {transform.readonly}) {
+    %0 = transform.structured.match ops{["scf.for"]} in %arg1 : (!transform.any_op) -> !transform.op<"scf.for">
+    %1 = transform.aievec.split_accumulators %0 {factor = 4} : (!transform.op<"scf.for">) -> !transform.any_op
+    transform.yield
+  }
+}
+
+// -----
+
+func.func @odd_trip_count(%a : memref<256xi32>, %init : vector<16xi32>) -> vector<16xi32> {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c48 = arith.constant 48 : index
+  %pad = arith.constant 0 : i32
+  %0 = scf.for %i = %c0 to %c48 step %c16 iter_args(%s = %init) -> (vector<16xi32>) {
+    %v = vector.transfer_read %a[%i], %pad {in_bounds = [true]} : memref<256xi32>, vector<16xi32>
+    %1 = arith.addi %s, %v : vector<16xi32>
+    scf.yield %1 : vector<16xi32>
+  }
+  return %0 : vector<16xi32>
+}
+
+module attributes {transform.with_named_sequence} {
+  transform.named_sequence @__transform_main(%arg1: !transform.any_op {transform.readonly}) {
+    %0 = transform.structured.match ops{["scf.for"]} in %arg1 : (!transform.any_op) -> !transform.op<"scf.for">
+    // expected-error @+1 {{trip count 3 is not a multiple of 2.}}
+    %1 = transform.aievec.split_accumulators %0 : (!transform.op<"scf.for">) -> !transform.any_op
+    transform.yield
+  }
+}
@@ -0,0 +1,76 @@
+// RUN: aie-opt %s -canonicalize-vector-for-aievec=aie-target=aieml -split-input-file | FileCheck %s
+
+// The output of the kernel is written directly into the objectFifo element.
+// CHECK-LABEL: aie.device(xcve2302)
+// CHECK:       aie.core
+// CHECK:         %[[SUB:.*]] = aie.objectfifo.acquire @of_out(Produce, 1)
+// CHECK:         %[[ELEM:.*]] = aie.objectfifo.subview.access %[[SUB]][0]
+// CHECK-NOT:     memref.alloc
+// CHECK:         func.call @kernel(%{{.*}}, %[[ELEM]])
+// CHECK-NOT:     memref.copy
+// CHECK:         aie.objectfifo.release @of_out(Produce, 1)
+aie.device(xcve2302) {
+  func.func private @kernel(memref<64xi16>, memref<64xi16>)
+  %tile_0_2 = aie.tile(0, 2)
+  %tile_0_3 = aie.tile(0, 3)
+  aie.objectfifo @of_out(%tile_0_2, {%tile_0_3}, 2 : i32) : !aie.objectfifo<memref<64xi16>>
+  %in = aie.buffer(%tile_0_2) : memref<64xi16>
+  %core_0_2 = aie.core(%tile_0_2) {
+    %tmp = memref.alloc() : memref<64xi16>
+    %sub = aie.objectfifo.acquire @of_out(Produce, 1) : !aie.objectfifosubview<memref<64xi16>>
+    %elem = aie.objectfifo.subview.access %sub[0] : !aie.objectfifosubview<memref<64xi16>> -> memref<64xi16>
+    func.call @kernel(%in, %tmp) : (memref<64xi16>, memref<64xi16>) -> ()
+    memref.copy %tmp, %elem : memref<64xi16> to memref<64xi16>
+    aie.objectfifo.release @of_out(Produce, 1)
+    aie.end
+  }
+}
+
+// -----
+
+// CHECK-LABEL: func.func @call_into_out_param(
+// CHECK-SAME:      %[[IN:.*]]: memref<64xi16>, %[[OUT:.*]]: memref<64xi16>)
+// CHECK-NOT:     memref.alloc
+// CHECK:         call @kernel(%[[IN]], %[[OUT]])
+// CHECK-NEXT:    call @kernel(%[[OUT]], %[[OUT]])
+// CHECK-NOT:     memref.copy
+func.func private @kernel(memref<64xi16>, memref<64xi16>)
+func.func @call_into_out_param(%in : memref<64xi16>, %out : memref<64xi16>) {
+  %tmp = memref.alloc() : memref<64xi16>
+  call @kernel(%in, %tmp) : (memref<64xi16>, memref<64xi16>) -> ()
+  call @kernel(%tmp, %tmp) : (memref<64xi16>, memref<64xi16>) -> ()
+  memref.copy %tmp, %out : memref<64xi16> to memref<64xi16>
+  return
+}
+
+// -----
+
+// The temporary is read after the copy, so it must stay.
+// CHECK-LABEL: func.func @temporary_read_after_copy(
+// CHECK:         %[[TMP:.*]] = memref.alloc()
+// CHECK:         call @kernel(%{{.*}}, %[[TMP]])
+// CHECK:         memref.copy %[[TMP]]
+func.func private @kernel(memref<64xi16>, memref<64xi16>)
+func.func @temporary_read_after_copy(%in : memref<64xi16>, %out : memref<64xi16>) -> i16 {
+  %c0 = arith.constant 0 : index
+  %tmp = memref.alloc() : memref<64xi16>
+  call @kernel(%in, %tmp) : (memref<64xi16>, memref<64xi16>) -> ()
+  memref.copy %tmp, %out : memref<64xi16> to memref<64xi16>
+  %v = memref.load %tmp[%c0] : memref<64xi16>
+  return %v : i16
+}
+
+// -----
+
+// The target is passed to the kernel along with the temporary.
+// CHECK-LABEL: func.func @target_used_by_call(
+// CHECK:         %[[TMP:.*]] = memref.alloc()
+// CHECK:         call @kernel(%{{.*}}, %[[TMP]])
+// CHECK:         memref.copy %[[TMP]]
+func.func private @kernel(memref<64xi16>, memref<64xi16>)
+func.func @target_used_by_call(%out : memref<64xi16>) {
+  %tmp = memref.alloc() : memref<64xi16>
+  call @kernel(%out, %tmp) : (memref<64xi16>, memref<64xi16>) -> ()
+  memref.copy %tmp, %out : memref<64xi16> to memref<64xi16>
+  return
+}
@@ -0,0 +1,87 @@
+// RUN: aie-opt %s --aievec-cross-iteration-reuse -split-input-file | FileCheck %s
+// RUN: aie-opt %s --aievec-cross-iteration-reuse="shift-windows=false" -split-input-file | FileCheck %s --check-prefix=NOSHIFT
+
+// The window at %i is the window at %i + 16 of the previous iteration: only
+// the latter is loaded in the loop.
+
+// CHECK-LABEL: func.func @adjacent
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: memref<272xi32>
+// CHECK:         %[[C0:.*]] = arith.constant 0 : index
+// CHECK:         %[[W0:.*]] = aievec.upd %[[A]][%[[C0]]]
+// CHECK:         %[[R:.*]]:2 = scf.for %[[I:.*]] = {{.*}} iter_args(%[[ACC:.*]] = %{{.*}}, %[[W:.*]] = %[[W0]])
+// CHECK:           %[[NEXT:.*]] = aievec.upd %[[A]]
+// CHECK-NOT:       aievec.upd
+// CHECK:           %[[M:.*]] = aievec.mac_elem %[[W]], %[[NEXT]], %[[ACC]]
+// CHECK:           scf.yield %[[M]], %[[NEXT]]
+func.func @adjacent(%a: memref<272xi32>, %acc0: vector<16xi64>) -> vector<16xi64> {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  %r = scf.for %i = %c0 to %c256 step %c16 iter_args(%acc = %acc0) -> (vector<16xi64>) {
+    %j = arith.addi %i, %c16 : index
+    %v0 = aievec.upd %a[%i] {index = 0 : i8, offset = 0 : i32} : memref<272xi32>, vector<16xi32>
+    %v1 = aievec.upd %a[%j] {index = 0 : i8, offset = 0 : i32} : memref<272xi32>, vector<16xi32>
+    %m = aievec.mac_elem %v0, %v1, %acc : vector<16xi32>, vector<16xi32>, vector<16xi64>
+    scf.yield %m : vector<16xi64>
+  }
+  return %r : vector<16xi64>
+}
+
+// -----
+
+// The loop slides by half a window: the window at %i of the next iteration is
+// the shift of the windows at %i and %i + 16 of the current one.
+
+// CHECK-LABEL: func.func @sliding
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: memref<272xi32>
+// CHECK:         %[[W0:.*]] = aievec.upd %[[A]]
+// CHECK:         scf.for %[[I:.*]] = {{.*}} iter_args(%[[ACC:.*]] = %{{.*}}, %[[W:.*]] = %[[W0]])
+// CHECK:           %[[HI:.*]] = aievec.upd %[[A]]
+// CHECK-NOT:       aievec.upd
+// CHECK:           %[[M:.*]] = aievec.mac_elem %[[W]], %[[HI]], %[[ACC]]
+// CHECK:           %[[C32:.*]] = arith.constant 32 : i32
+// CHECK:           %[[S:.*]] = aievec.shift %[[W]], %[[HI]], %[[C32]] {isAcc = false} : vector<16xi32>, vector<16xi32>, i32, vector<16xi32>
+// CHECK:           scf.yield %[[M]], %[[S]]
+
+// NOSHIFT-LABEL: func.func @sliding
+// NOSHIFT:         scf.for
+// NOSHIFT-NEXT:      arith.addi
+// NOSHIFT-NEXT:      aievec.upd
+// NOSHIFT-NEXT:      aievec.upd
+func.func @sliding(%a: memref<272xi32>, %acc0: vector<16xi64>) -> vector<16xi64> {
+  %c0 = arith.constant 0 : index
+  %c8 = arith.constant 8 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  %r = scf.for %i = %c0 to %c256 step %c8 iter_args(%acc = %acc0) -> (vector<16xi64>) {
+    %j = arith.addi %i, %c16 : index
+    %v0 = aievec.upd %a[%i] {index = 0 : i8, offset = 0 : i32} : memref<272xi32>, vector<16xi32>
+    %v1 = aievec.upd %a[%j] {index = 0 : i8, offset = 0 : i32} : memref<272xi32>, vector<16xi32>
+    %m = aievec.mac_elem %v0, %v1, %acc : vector<16xi32>, vector<16xi32>, vector<16xi64>
+    scf.yield %m : vector<16xi64>
+  }
+  return %r : vector<16xi64>
+}
+
+// -----
+
+// The loop writes the buffer it loads from.
+
+// CHECK-LABEL: func.func @in_place
+// CHECK:         scf.for
+// CHECK-NEXT:      arith.addi
+// CHECK-NEXT:      aievec.upd
+// CHECK-NEXT:      aievec.upd
+func.func @in_place(%a: memref<272xi32>) {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  scf.for %i = %c0 to %c256 step %c16 {
+    %j = arith.addi %i, %c16 : index
+    %v0 = aievec.upd %a[%i] {index = 0 : i8, offset = 0 : i32} : memref<272xi32>, vector<16xi32>
+    %v1 = aievec.upd %a[%j] {index = 0 : i8, offset = 0 : i32} : memref<272xi32>, vector<16xi32>
+    %s = arith.addi %v0, %v1 : vector<16xi32>
+    vector.transfer_write %s, %a[%i] : vector<16xi32>, memref<272xi32>
+  }
+  return
+}
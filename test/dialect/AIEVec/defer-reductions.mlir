@@ -0,0 +1,79 @@
+// RUN: aie-opt %s -canonicalize-vector-for-aievec=aie-target=aieml -canonicalize -cse -split-input-file | FileCheck %s
+
+// CHECK-LABEL: func.func @sum_i32(
+// CHECK-SAME: %[[MEM:[a-zA-Z0-9]+]]: memref<1024xi32>,
+// CHECK-SAME: %[[INIT:[a-zA-Z0-9]+]]: i32) -> i32 {
+// CHECK-DAG: %[[ZERO:.*]] = arith.constant dense<0> : vector<16xi32>
+// CHECK: %[[LANES:.*]] = scf.for %{{.*}} iter_args(%[[ACC:.*]] = %[[ZERO]]) -> (vector<16xi32>) {
+// CHECK: %[[V:.*]] = vector.transfer_read %[[MEM]]
+// CHECK-NOT: vector.reduction
+// CHECK: %[[NEXT:.*]] = arith.addi %[[ACC]], %[[V]] : vector<16xi32>
+// CHECK: scf.yield %[[NEXT]] : vector<16xi32>
+// CHECK: }
+// CHECK: %[[SUM:.*]] = vector.reduction <add>, %[[LANES]] : vector<16xi32> into i32
+// CHECK: %[[TOTAL:.*]] = arith.addi %[[INIT]], %[[SUM]] : i32
+// CHECK: return %[[TOTAL]] : i32
+func.func @sum_i32(%mem: memref<1024xi32>, %init: i32) -> i32 {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c1024 = arith.constant 1024 : index
+  %c0_i32 = arith.constant 0 : i32
+  %0 = scf.for %i = %c0 to %c1024 step %c16 iter_args(%acc = %init) -> (i32) {
+    %v = vector.transfer_read %mem[%i], %c0_i32 : memref<1024xi32>, vector<16xi32>
+    %r = vector.reduction <add>, %v : vector<16xi32> into i32
+    %next = arith.addi %acc, %r : i32
+    scf.yield %next : i32
+  }
+  return %0 : i32
+}
+
+// -----
+
+// The accumulator is carried by the reduction itself.
+
+// CHECK-LABEL: func.func @sum_f32(
+// CHECK-SAME: %[[MEM:[a-zA-Z0-9]+]]: memref<1024xf32>) -> f32 {
+// CHECK-DAG: %[[INIT:.*]] = arith.constant 0.000000e+00 : f32
+// CHECK-DAG: %[[ZERO:.*]] = arith.constant dense<0.000000e+00> : vector<16xf32>
+// CHECK: affine.for %{{.*}} = 0 to 1024 step 16 iter_args({{.*}}%[[ACC:[a-zA-Z0-9_]+]] = %[[ZERO]]) -> ({{.*}}vector<16xf32>) {
+// CHECK: %[[V:.*]] = vector.transfer_read %[[MEM]]
+// CHECK-NOT: vector.reduction
+// CHECK: %[[NEXT:.*]] = arith.addf %[[ACC]], %[[V]] : vector<16xf32>
+// CHECK: affine.yield {{.*}}%[[NEXT]] : {{.*}}vector<16xf32>
+// CHECK: }
+// CHECK: %[[SUM:.*]] = vector.reduction <add>, %{{.*}} : vector<16xf32> into f32
+// CHECK: %[[TOTAL:.*]] = arith.addf %[[SUM]], %[[INIT]] : f32
+// CHECK: return %[[TOTAL]] : f32
+func.func @sum_f32(%mem: memref<1024xf32>) -> f32 {
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = affine.for %i = 0 to 1024 step 16 iter_args(%acc = %cst) -> (f32) {
+    %v = vector.transfer_read %mem[%i], %cst : memref<1024xf32>, vector<16xf32>
+    %next = vector.reduction <add>, %v, %acc : vector<16xf32> into f32
+    affine.yield %next : f32
+  }
+  return %0 : f32
+}
+
+// -----
+
+// The partial sums are also used in the loop, so the reduction stays in it.
+
+// CHECK-LABEL: func.func @running_sum(
+// CHECK: scf.for
+// CHECK: vector.reduction <add>
+// CHECK: memref.store
+func.func @running_sum(%mem: memref<1024xi32>, %out: memref<64xi32>) -> i32 {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c1024 = arith.constant 1024 : index
+  %c0_i32 = arith.constant 0 : i32
+  %0 = scf.for %i = %c0 to %c1024 step %c16 iter_args(%acc = %c0_i32) -> (i32) {
+    %v = vector.transfer_read %mem[%i], %c0_i32 : memref<1024xi32>, vector<16xi32>
+    %r = vector.reduction <add>, %v : vector<16xi32> into i32
+    %next = arith.addi %acc, %r : i32
+    %j = arith.divui %i, %c16 : index
+    memref.store %next, %out[%j] : memref<64xi32>
+    scf.yield %next : i32
+  }
+  return %0 : i32
+}
@@ -37,3 +37,13 @@ func.func @invalidAccumulatorType(%A : vector<2x4xi16>, %B : vector<4x8xi16>,
                                   into vector<2x8xi32>
   return %0 : vector<2x8xi32>
 }
+
+// -----
+
+func.func @invalidRounding(%A : vector<16xi32>, %S : vector<16xi32>,
+                           %shift : i32) -> vector<16xi16> {
+  // expected-error @+1 {{op unknown rounding mode 'nearest'}}
+  %0 = aievec.requant %A, %S, %shift {rounding = "nearest"}
+       : vector<16xi32>, i32, vector<16xi16>
+  return %0 : vector<16xi16>
+}
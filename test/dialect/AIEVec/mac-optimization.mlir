@@ -102,3 +102,86 @@ func.func @merge_single_column_mac(%A : vector<16xi16>,
                                     : vector<32xi16>, vector<16xi16>, vector<16xi48>
     return %mac1 : vector<16xi48>
 }
+
+// -----
+
+// The chain alternates between two rhs vectors. It is reordered so that the
+// macs sharing the same rhs are merged in pairs.
+// CHECK-LABEL: func.func @merge_interleaved_single_column_macs(
+// CHECK-SAME: %[[VA:[A-Za-z0-9]+]]: vector<16xi16>,
+// CHECK-SAME: %[[VB:[A-Za-z0-9]+]]: vector<16xi16>,
+// CHECK-SAME: %[[VC:[A-Za-z0-9]+]]: vector<16xi16>,
+// CHECK-SAME: %[[VD:[A-Za-z0-9]+]]: vector<16xi16>) -> vector<16xi48> {
+func.func @merge_interleaved_single_column_macs(%A : vector<16xi16>,
+                                                %B : vector<16xi16>,
+                                                %C : vector<16xi16>,
+                                                %D : vector<16xi16>) -> vector<16xi48> {
+    // CHECK: %[[ACC:.*]] = arith.constant dense<0> : vector<16xi48>
+    // CHECK: %[[VAC:.*]] = aievec.concat %[[VA]], %[[VC]] : vector<16xi16>, vector<32xi16>
+    // CHECK: %[[MAC0:.*]] = aievec.mac %[[VAC]], %[[VC]], %[[ACC]] {
+    // CHECK-SAME: zstart = "0", zstep = "1"}
+    // CHECK: %[[VBD:.*]] = aievec.concat %[[VB]], %[[VD]] : vector<16xi16>, vector<32xi16>
+    // CHECK: %[[MAC1:.*]] = aievec.mac %[[VBD]], %[[VD]], %[[MAC0]] {
+    // CHECK-SAME: zstart = "0", zstep = "1"}
+    // CHECK-NEXT: return %[[MAC1]] : vector<16xi48>
+    %acc = arith.constant dense<0> : vector<16xi48>
+    %zvec = arith.constant dense<0> : vector<16xi16>
+    %la = aievec.concat %A, %zvec : vector<16xi16>, vector<32xi16>
+    %mac0 = aievec.mac %la, %C, %acc {xoffsets = "0x73727170",
+                                      xoffsets_hi = "0x77767574",
+                                      xsquare = "0x3120", xstart = "0",
+                                      zoffsets = "0", zoffsets_hi = "0",
+                                      zstart = "0", zstep = "1"}
+                                    : vector<32xi16>, vector<16xi16>, vector<16xi48>
+    %lb = aievec.concat %B, %zvec : vector<16xi16>, vector<32xi16>
+    %mac1 = aievec.mac %lb, %D, %mac0 {xoffsets = "0x73727170",
+                                       xoffsets_hi = "0x77767574",
+                                       xsquare = "0x3120", xstart = "0",
+                                       zoffsets = "0", zoffsets_hi = "0",
+                                       zstart = "0", zstep = "1"}
+                                    : vector<32xi16>, vector<16xi16>, vector<16xi48>
+    %lc = aievec.concat %C, %zvec : vector<16xi16>, vector<32xi16>
+    %mac2 = aievec.mac %lc, %C, %mac1 {xoffsets = "0x73727170",
+                                       xoffsets_hi = "0x77767574",
+                                       xsquare = "0x3120", xstart = "0",
+                                       zoffsets = "0", zoffsets_hi = "0",
+                                       zstart = "1", zstep = "1"}
+                                    : vector<32xi16>, vector<16xi16>, vector<16xi48>
+    %ld = aievec.concat %D, %zvec : vector<16xi16>, vector<32xi16>
+    %mac3 = aievec.mac %ld, %D, %mac2 {xoffsets = "0x73727170",
+                                       xoffsets_hi = "0x77767574",
+                                       xsquare = "0x3120", xstart = "0",
+                                       zoffsets = "0", zoffsets_hi = "0",
+                                       zstart = "1", zstep = "1"}
+                                    : vector<32xi16>, vector<16xi16>, vector<16xi48>
+    return %mac3 : vector<16xi48>
+}
+
+// -----
+
+// A mac and an msc can't be merged.
+// CHECK-LABEL: func.func @no_merge_mac_and_msc(
+// CHECK: aievec.mac
+// CHECK: aievec.mac
+// CHECK-SAME: fmsub = true
+func.func @no_merge_mac_and_msc(%A : vector<16xi16>,
+                                %B : vector<16xi16>,
+                                %C : vector<16xi16>) -> vector<16xi48> {
+    %acc = arith.constant dense<0> : vector<16xi48>
+    %zvec = arith.constant dense<0> : vector<16xi16>
+    %la = aievec.concat %A, %zvec : vector<16xi16>, vector<32xi16>
+    %mac0 = aievec.mac %la, %C, %acc {xoffsets = "0x73727170",
+                                      xoffsets_hi = "0x77767574",
+                                      xsquare = "0x3120", xstart = "0",
+                                      zoffsets = "0", zoffsets_hi = "0",
+                                      zstart = "0", zstep = "1"}
+                                    : vector<32xi16>, vector<16xi16>, vector<16xi48>
+    %lb = aievec.concat %B, %zvec : vector<16xi16>, vector<32xi16>
+    %mac1 = aievec.mac %lb, %C, %mac0 {fmsub = true, xoffsets = "0x73727170",
+                                       xoffsets_hi = "0x77767574",
+                                       xsquare = "0x3120", xstart = "0",
+                                       zoffsets = "0", zoffsets_hi = "0",
+                                       zstart = "1", zstep = "1"}
+                                    : vector<32xi16>, vector<16xi16>, vector<16xi48>
+    return %mac1 : vector<16xi48>
+}
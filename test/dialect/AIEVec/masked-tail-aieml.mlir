@@ -0,0 +1,53 @@
+// RUN: aie-opt %s -canonicalize-vector-for-aievec=aie-target=aieml -split-input-file | FileCheck %s
+
+// The tail of a loop whose trip count isn't a multiple of the vector length
+// is handled with selects instead of masked transfers.
+// CHECK-LABEL: func.func @masked_tail(
+// CHECK-SAME:      %[[A:.*]]: memref<?xi32>, %[[B:.*]]: memref<?xi32>,
+// CHECK-SAME:      %[[N:.*]]: index)
+// CHECK:         scf.for %[[I:.*]] = %{{.*}} to %[[N]] step %{{.*}} {
+// CHECK:           %[[REM:.*]] = affine.min
+// CHECK:           %[[LO:.*]] = arith.maxsi %[[REM]], %{{.*}} : index
+// CHECK:           %[[BOUND:.*]] = arith.minsi %[[LO]], %{{.*}} : index
+// CHECK:           %[[LANES:.*]] = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15]> : vector<16xi32>
+// CHECK:           %[[BOUNDI32:.*]] = arith.index_cast %[[BOUND]] : index to i32
+// CHECK:           %[[BOUNDS:.*]] = vector.broadcast %[[BOUNDI32]] : i32 to vector<16xi32>
+// CHECK:           %[[MASK:.*]] = arith.cmpi slt, %[[LANES]], %[[BOUNDS]] : vector<16xi32>
+// CHECK:           %[[READ:.*]] = vector.transfer_read %[[A]][%[[I]]], %{{.*}} {in_bounds = [true]} : memref<?xi32>, vector<16xi32>
+// CHECK:           %[[PAD:.*]] = vector.broadcast %{{.*}} : i32 to vector<16xi32>
+// CHECK:           %[[V:.*]] = arith.select %[[MASK]], %[[READ]], %[[PAD]] : vector<16xi1>, vector<16xi32>
+// CHECK:           %[[SUM:.*]] = arith.addi %[[V]], %[[V]] : vector<16xi32>
+// CHECK:           %[[OLD:.*]] = vector.transfer_read %[[B]][%[[I]]], %{{.*}} {in_bounds = [true]} : memref<?xi32>, vector<16xi32>
+// CHECK:           %[[NEW:.*]] = arith.select %{{.*}}, %[[SUM]], %[[OLD]] : vector<16xi1>, vector<16xi32>
+// CHECK:           vector.transfer_write %[[NEW]], %[[B]][%[[I]]] {in_bounds = [true]} : vector<16xi32>, memref<?xi32>
+#tail = affine_map<(d0)[s0] -> (16, s0 - d0)>
+func.func @masked_tail(%a : memref<?xi32>, %b : memref<?xi32>, %n : index) {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c0_i32 = arith.constant 0 : i32
+  scf.for %i = %c0 to %n step %c16 {
+    %rem = affine.min #tail(%i)[%n]
+    %mask = vector.create_mask %rem : vector<16xi1>
+    %v = vector.transfer_read %a[%i], %c0_i32, %mask : memref<?xi32>, vector<16xi32>
+    %sum = arith.addi %v, %v : vector<16xi32>
+    vector.transfer_write %sum, %b[%i], %mask : vector<16xi32>, memref<?xi32>
+  }
+  return
+}
+
+// -----
+
+// Masks that don't come from `vector.create_mask` are used as they are.
+// CHECK-LABEL: func.func @masked_by_value(
+// CHECK-SAME:      %[[A:.*]]: memref<32xi16>, %[[MASK:.*]]: vector<32xi1>)
+// CHECK:         %[[PADV:.*]] = arith.constant 7 : i16
+// CHECK:         %[[READ:.*]] = vector.transfer_read %[[A]][%{{.*}}], %[[PADV]] {in_bounds = [true]} : memref<32xi16>, vector<32xi16>
+// CHECK:         %[[PAD:.*]] = vector.broadcast %[[PADV]] : i16 to vector<32xi16>
+// CHECK:         %[[V:.*]] = arith.select %[[MASK]], %[[READ]], %[[PAD]] : vector<32xi1>, vector<32xi16>
+// CHECK:         return %[[V]]
+func.func @masked_by_value(%a : memref<32xi16>, %mask : vector<32xi1>) -> vector<32xi16> {
+  %c0 = arith.constant 0 : index
+  %pad = arith.constant 7 : i16
+  %v = vector.transfer_read %a[%c0], %pad, %mask : memref<32xi16>, vector<32xi16>
+  return %v : vector<32xi16>
+}
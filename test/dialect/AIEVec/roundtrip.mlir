@@ -157,3 +157,40 @@ func.func @matmul_bf16(%A : vector<4x8xbf16>, %B : vector<8x4xbf16>,
                                   into vector<4x4xf32>
   return %0 : vector<4x4xf32>
 }
+
+// -----
+
+// CHECK-LABEL: @matmul_sparse_i8i8
+// CHECK-SAME: %[[A:.*]]: vector<4x16xi8>
+// CHECK-SAME: %[[B:.*]]: vector<8x8xi8>
+// CHECK-SAME: %[[M:.*]]: vector<4xi32>
+// CHECK-SAME: %[[C:.*]]: vector<4x8xi32>
+// CHECK:      %[[RES:.*]] = aievec.matmul_sparse %[[A]], %[[B]], %[[M]], %[[C]] :
+// CHECK-SAME: vector<4x16xi8>, vector<8x8xi8>, vector<4xi32> into vector<4x8xi32>
+// CHECK: return %[[RES]] : vector<4x8xi32>
+func.func @matmul_sparse_i8i8(%A : vector<4x16xi8>, %B : vector<8x8xi8>,
+                              %M : vector<4xi32>,
+                              %C : vector<4x8xi32>) -> vector<4x8xi32> {
+  %0 = aievec.matmul_sparse %A, %B, %M, %C : vector<4x16xi8>,
+                                             vector<8x8xi8>, vector<4xi32>
+                                             into vector<4x8xi32>
+  return %0 : vector<4x8xi32>
+}
+
+// -----
+
+// CHECK-LABEL: @requant
+// CHECK-SAME: %[[A:.*]]: vector<16xi32>
+// CHECK-SAME: %[[S:.*]]: vector<16xi32>
+// CHECK-SAME: %[[SH:.*]]: i32
+// CHECK:      %[[R0:.*]] = aievec.requant %[[A]], %[[S]], %[[SH]] :
+// CHECK-SAME: vector<16xi32>, i32, vector<16xi16>
+// CHECK:      %[[R1:.*]] = aievec.requant %[[A]], %[[S]], %[[SH]] {rounding = "sym_inf"} :
+// CHECK-SAME: vector<16xi32>, i32, vector<16xi32>
+func.func @requant(%A : vector<16xi32>, %S : vector<16xi32>, %shift : i32)
+    -> (vector<16xi16>, vector<16xi32>) {
+  %0 = aievec.requant %A, %S, %shift : vector<16xi32>, i32, vector<16xi16>
+  %1 = aievec.requant %A, %S, %shift {rounding = "sym_inf"}
+       : vector<16xi32>, i32, vector<16xi32>
+  return %0, %1 : vector<16xi16>, vector<16xi32>
+}
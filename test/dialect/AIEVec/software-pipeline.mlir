@@ -0,0 +1,66 @@
+// RUN: aie-opt %s --aievec-software-pipeline -split-input-file | FileCheck %s
+// RUN: aie-opt %s --aievec-software-pipeline="vector-register-bits=1024" -split-input-file | FileCheck %s --check-prefix=PRESSURE
+
+// The loads of the next iteration are issued in the loop, ahead of the MAC of
+// the current one, with the loads of the first iteration in the prologue and
+// the MAC of the last one in the epilogue.
+
+// CHECK-LABEL: func.func @dot
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: memref<256xi32>, %[[B:[A-Za-z0-9]+]]: memref<256xi32>
+// CHECK:         %[[A0:.*]] = aievec.upd %[[A]]
+// CHECK:         %[[B0:.*]] = aievec.upd %[[B]]
+// CHECK:         %[[R:.*]]:3 = scf.for %[[I:.*]] = {{.*}} iter_args(
+// CHECK-SAME:        %[[VA:[A-Za-z0-9_]+]] = %[[A0]]
+// CHECK-SAME:        %[[VB:[A-Za-z0-9_]+]] = %[[B0]]
+// CHECK:           %[[NEXT:.*]] = arith.addi %[[I]]
+// CHECK:           %[[NA:.*]] = aievec.upd %[[A]][%[[NEXT]]]
+// CHECK:           %[[NB:.*]] = aievec.upd %[[B]][%[[NEXT]]]
+// CHECK:           %[[M:.*]] = aievec.mac_elem %[[VA]], %[[VB]]
+// CHECK:           scf.yield
+// CHECK:         %[[E:.*]] = aievec.mac_elem %[[R]]#{{[0-9]}}, %[[R]]#{{[0-9]}}, %[[R]]#{{[0-9]}}
+// CHECK:         return %[[E]]
+
+// Two iterations of the loaded vectors do not fit in 1024 bits.
+
+// PRESSURE-LABEL: func.func @dot
+// PRESSURE:         scf.for
+// PRESSURE-NEXT:      aievec.upd
+// PRESSURE-NEXT:      aievec.upd
+// PRESSURE-NEXT:      aievec.mac_elem
+func.func @dot(%a: memref<256xi32>, %b: memref<256xi32>, %acc0: vector<16xi64>) -> vector<16xi64> {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  %r = scf.for %i = %c0 to %c256 step %c16 iter_args(%acc = %acc0) -> (vector<16xi64>) {
+    %va = aievec.upd %a[%i] {index = 0 : i8, offset = 0 : i32} : memref<256xi32>, vector<16xi32>
+    %vb = aievec.upd %b[%i] {index = 0 : i8, offset = 0 : i32} : memref<256xi32>, vector<16xi32>
+    %m = aievec.mac_elem %va, %vb, %acc : vector<16xi32>, vector<16xi32>, vector<16xi64>
+    scf.yield %m : vector<16xi64>
+  }
+  return %r : vector<16xi64>
+}
+
+// -----
+
+// The loop writes the buffer it loads from: the load of the next iteration
+// could read an element stored by the current one.
+
+// CHECK-LABEL: func.func @in_place
+// CHECK:         scf.for
+// CHECK-NEXT:      aievec.upd
+// CHECK-NEXT:      aievec.ups
+// CHECK-NEXT:      aievec.srs
+// CHECK-NEXT:      vector.transfer_write
+func.func @in_place(%a: memref<256xi32>) {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  %shift = arith.constant 0 : i32
+  scf.for %i = %c0 to %c256 step %c16 {
+    %v = aievec.upd %a[%i] {index = 0 : i8, offset = 0 : i32} : memref<256xi32>, vector<16xi32>
+    %acc = aievec.ups %v {shift = 0 : i8} : vector<16xi32>, vector<16xi64>
+    %s = aievec.srs %acc, %shift : vector<16xi64>, i32, vector<16xi32>
+    vector.transfer_write %s, %a[%i] : vector<16xi32>, memref<256xi32>
+  }
+  return
+}
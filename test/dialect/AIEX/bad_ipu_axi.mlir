@@ -0,0 +1,47 @@
+//===- bad_ipu_axi.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -split-input-file --verify-diagnostics %s
+
+aie.device(ipu) {
+  func.func @sequence(%in : memref<1024xi32>) {
+    %c0 = arith.constant 0 : i64
+    %c1 = arith.constant 1 : i64
+    %c1024 = arith.constant 1024 : i64
+    // expected-error@+1 {{burst_length must be 64, 128 or 256 bytes}}
+    aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c1024][%c0,%c0,%c0]) { metadata = @of_fromMem, id = 0 : i64, burst_length = 32 : i32 } : memref<1024xi32>
+    return
+  }
+  aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+}
+
+// -----
+
+aie.device(ipu) {
+  func.func @sequence(%in : memref<1024xi32>) {
+    %c0 = arith.constant 0 : i64
+    %c1 = arith.constant 1 : i64
+    %c1024 = arith.constant 1024 : i64
+    // expected-error@+1 {{ax_qos exceeds the [0:15] range}}
+    aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c1024][%c0,%c0,%c0]) { metadata = @of_fromMem, id = 0 : i64, ax_qos = 16 : i32 } : memref<1024xi32>
+    return
+  }
+  aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+}
+
+// -----
+
+aie.device(ipu) {
+  func.func @sequence(%in : memref<32xi32>) {
+    // expected-error@+1 {{ax_cache exceeds the [0:15] range}}
+    aiex.ipu.writebd_shimtile {bd_id = 0 : i32, buffer_length = 32 : i32, buffer_offset = 0 : i32, column = 0 : i32, column_num = 1 : i32, d0_stride = 0 : i32, d0_size = 0 : i32, d1_stride = 0 : i32, d1_size = 0 : i32, d2_stride = 0 : i32, ddr_id = 0 : i32, enable_packet = 0 : i32, iteration_current = 0 : i32, iteration_stride = 0 : i32, iteration_size = 0 : i32, lock_acq_enable = 0 : i32, lock_acq_id = 0 : i32, lock_acq_val = 0 : i32, lock_rel_id = 0 : i32, lock_rel_val = 0 : i32, next_bd = 0 : i32, out_of_order_id = 0 : i32, packet_id = 0 : i32, packet_type = 0 : i32, use_next_bd = 0 : i32, valid_bd = 1 : i32, ax_cache = 16 : i32}
+    return
+  }
+}
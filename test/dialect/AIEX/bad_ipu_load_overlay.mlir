@@ -0,0 +1,48 @@
+//===- bad_ipu_load_overlay.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --verify-diagnostics --split-input-file %s
+
+aie.device(ipu) {
+  %tile_0_2 = aie.tile(0, 2)
+  %core_0_2 = aie.core(%tile_0_2) {
+    aie.end
+  } {overlays = ["conv.o", "pool.o"], overlay_size = 8192 : i32}
+  func.func @sequence() {
+    // expected-error@+1 {{overlay 2 is not one of the 2 overlays of the core}}
+    aiex.ipu.load_overlay(0, 2, 2)
+    return
+  }
+}
+
+// -----
+
+aie.device(ipu) {
+  %tile_0_2 = aie.tile(0, 2)
+  %core_0_2 = aie.core(%tile_0_2) {
+    aie.end
+  }
+  func.func @sequence() {
+    // expected-error@+1 {{the core of tile (0, 2) has no overlays}}
+    aiex.ipu.load_overlay(0, 2, 0)
+    return
+  }
+}
+
+// -----
+
+aie.device(ipu) {
+  %tile_0_3 = aie.tile(0, 3)
+  func.func @sequence() {
+    // expected-error@+1 {{tile (0, 3) has no core}}
+    aiex.ipu.load_overlay(0, 3, 0)
+    return
+  }
+}
@@ -0,0 +1,42 @@
+//===- bad_ipu_nd_runtime_param.mlir ---------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --verify-diagnostics --split-input-file %s
+
+module {
+  aie.device(ipu) {
+    func.func @sequence(%in : memref<4096xi32>, %cols : i64) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c4 = arith.constant 4 : i64
+      %c64 = arith.constant 64 : i64
+      // expected-error@+1 {{only the outermost of the three inner dimensions can have a runtime parameter size}}
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c4,%cols][%c0,%c0,%c64]) { metadata = @of_fromMem, id = 0 : i64 } : memref<4096xi32>
+      return
+    }
+    aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+  }
+}
+
+// -----
+
+module {
+  aie.device(ipu) {
+    func.func @sequence(%in : memref<4096xi32>, %repeats : i64) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c64 = arith.constant 64 : i64
+      // expected-error@+1 {{the size of the fourth dimension can't be a runtime parameter}}
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%repeats,%c1,%c1,%c64][%c64,%c0,%c0]) { metadata = @of_fromMem, id = 0 : i64 } : memref<4096xi32>
+      return
+    }
+    aie.shim_dma_allocation @of_fromMem (MM2S, 0, 0)
+  }
+}
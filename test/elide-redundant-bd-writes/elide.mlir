@@ -0,0 +1,60 @@
+//===- elide.mlir ----------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -aie-dma-to-ipu -aie-elide-redundant-bd-writes %s | FileCheck %s
+
+// The second batch writes the same BDs again, so it only pushes them.  The
+// third one uses another offset for the input, and the last one follows a
+// write to the BD registers, so both rewrite their BDs.
+// CHECK-LABEL: func.func @sequence
+// CHECK: aiex.ipu.writebd_shimtile {bd_id = 1 : i32, buffer_length = 64 : i32, buffer_offset = 0 : i32
+// CHECK: aiex.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 1 : ui32}
+// CHECK: aiex.ipu.writebd_shimtile {bd_id = 0 : i32
+// CHECK: aiex.ipu.write32 {address = 119300 : ui32, column = 0 : i32, row = 0 : i32, value = 2147483648 : ui32}
+// CHECK: aiex.ipu.sync
+// CHECK-NOT: aiex.ipu.writebd_shimtile
+// CHECK: aiex.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 1 : ui32}
+// CHECK-NOT: aiex.ipu.writebd_shimtile
+// CHECK: aiex.ipu.write32 {address = 119300 : ui32, column = 0 : i32, row = 0 : i32, value = 2147483648 : ui32}
+// CHECK: aiex.ipu.sync
+// CHECK: aiex.ipu.writebd_shimtile {bd_id = 1 : i32, buffer_length = 64 : i32, buffer_offset = 256 : i32
+// CHECK: aiex.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 1 : ui32}
+// CHECK-NOT: aiex.ipu.writebd_shimtile
+// CHECK: aiex.ipu.write32 {address = 119300 : ui32, column = 0 : i32, row = 0 : i32, value = 2147483648 : ui32}
+// CHECK: aiex.ipu.sync
+// CHECK: aiex.ipu.write32 {address = 118788 : ui32
+// CHECK: aiex.ipu.writebd_shimtile {bd_id = 0 : i32
+// CHECK: aiex.ipu.write32 {address = 119300 : ui32, column = 0 : i32, row = 0 : i32, value = 2147483648 : ui32}
+// CHECK: aiex.ipu.sync
+
+module {
+  aie.device(ipu) {
+    func.func @sequence(%in : memref<128xi32>, %out : memref<64xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c64 = arith.constant 64 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @in, id = 1 : i64 } : memref<128xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<64xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @in, id = 1 : i64 } : memref<128xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<64xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c64][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @in, id = 1 : i64 } : memref<128xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<64xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      aiex.ipu.write32 { column = 0 : i32, row = 0 : i32, address = 0x1D004 : ui32, value = 0 : ui32 }
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<64xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+    aie.shim_dma_allocation @in (MM2S, 0, 0)
+    aie.shim_dma_allocation @out (S2MM, 0, 0)
+  }
+}
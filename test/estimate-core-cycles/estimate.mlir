@@ -0,0 +1,119 @@
+//===- estimate.mlir -------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-estimate-core-cycles --verify-diagnostics %s
+// RUN: aie-opt --aie-estimate-core-cycles="json-file=%t.json" %s -o /dev/null 2>/dev/null
+// RUN: FileCheck %s < %t.json
+
+// The inner loop of (0, 2) issues two vector operations, two loads and a
+// store: 2 cycles per iteration. Each of its 4 outer iterations adds two
+// lock operations of 4 cycles, so 160 cycles. (0, 3) runs a 100 cycle
+// kernel per element, 4 * (100 + 16) cycles, and is the bottleneck of the
+// pipeline. The external @sink of (0, 4) counts as 1 cycle.
+
+// CHECK:      "cores": [
+// CHECK:          "col": 0,
+// CHECK-NEXT:     "row": 2,
+// CHECK-NEXT:     "cycles": 160,
+// CHECK-NEXT:     "pipeline": 0,
+// CHECK-NEXT:     "loops": [
+// CHECK-NEXT:       {
+// CHECK-NEXT:         "loc": "{{.*}}estimate.mlir":{{[0-9]+}}:{{[0-9]+}}",
+// CHECK-NEXT:         "trip_count": 16,
+// CHECK-NEXT:         "cycles_per_iteration": 2,
+// CHECK-NEXT:         "bound": "vector",
+// CHECK-NEXT:         "vector": 2,
+// CHECK-NEXT:         "load": 2,
+// CHECK-NEXT:         "store": 1,
+// CHECK-NEXT:         "scalar": 0
+// CHECK:          "col": 0,
+// CHECK-NEXT:     "row": 3,
+// CHECK-NEXT:     "cycles": 464,
+// CHECK:          "col": 0,
+// CHECK-NEXT:     "row": 4,
+// CHECK-NEXT:     "cycles": 36,
+// CHECK:          "unknown_calls": [
+// CHECK-NEXT:       "sink"
+// CHECK:      "bottlenecks": [
+// CHECK-NEXT:   {
+// CHECK-NEXT:     "col": 0,
+// CHECK-NEXT:     "row": 3,
+// CHECK-NEXT:     "cycles": 464
+
+module @estimate {
+ aie.device(xcve2302) {
+  %tile02 = aie.tile(0, 2)
+  %tile03 = aie.tile(0, 3)
+  %tile04 = aie.tile(0, 4)
+
+  aie.objectfifo @of0 (%tile02, {%tile03}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+  aie.objectfifo @of1 (%tile03, {%tile04}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+
+  func.func private @kernel(%in : memref<256xi32>, %out : memref<256xi32>) -> ()
+  func.func private @sink(%in : memref<256xi32>) -> ()
+
+  // expected-remark @+1 {{estimated 160 cycles}}
+  %core02 = aie.core(%tile02) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c4 = arith.constant 4 : index
+    %c16 = arith.constant 16 : index
+    scf.for %i = %c0 to %c4 step %c1 {
+      %sv = aie.objectfifo.acquire @of0 (Produce, 1) : !aie.objectfifosubview<memref<256xi32>>
+      %e = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>
+      // expected-note @+1 {{innermost loop: 2 cycles per iteration, bound by vector}}
+      scf.for %j = %c0 to %c16 step %c1 {
+        %a = vector.load %e[%j] : memref<256xi32>, vector<16xi32>
+        %b = vector.load %e[%c0] : memref<256xi32>, vector<16xi32>
+        %s = arith.addi %a, %b : vector<16xi32>
+        %p = arith.muli %s, %b : vector<16xi32>
+        vector.store %p, %e[%j] : memref<256xi32>, vector<16xi32>
+      }
+      aie.objectfifo.release @of0 (Produce, 1)
+    }
+    aie.end
+  }
+
+  // expected-remark @+2 {{estimated 464 cycles}}
+  // expected-remark @+1 {{bottleneck of a pipeline of 3 cores}}
+  %core03 = aie.core(%tile03) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c4 = arith.constant 4 : index
+    // expected-note @+1 {{innermost loop: 116 cycles per iteration, bound by serial}}
+    scf.for %i = %c0 to %c4 step %c1 {
+      %sv0 = aie.objectfifo.acquire @of0 (Consume, 1) : !aie.objectfifosubview<memref<256xi32>>
+      %e0 = aie.objectfifo.subview.access %sv0[0] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>
+      %sv1 = aie.objectfifo.acquire @of1 (Produce, 1) : !aie.objectfifosubview<memref<256xi32>>
+      %e1 = aie.objectfifo.subview.access %sv1[0] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>
+      func.call @kernel(%e0, %e1) {aie.cycles = 100 : i32} : (memref<256xi32>, memref<256xi32>) -> ()
+      aie.objectfifo.release @of0 (Consume, 1)
+      aie.objectfifo.release @of1 (Produce, 1)
+    }
+    aie.end
+  }
+
+  // expected-remark @+2 {{estimated 36 cycles}}
+  // expected-note @+1 {{call to @sink counted as 1 cycle; set aie.cycles on it}}
+  %core04 = aie.core(%tile04) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c4 = arith.constant 4 : index
+    // expected-note @+1 {{innermost loop: 9 cycles per iteration, bound by serial}}
+    scf.for %i = %c0 to %c4 step %c1 {
+      %sv = aie.objectfifo.acquire @of1 (Consume, 1) : !aie.objectfifosubview<memref<256xi32>>
+      %e = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>
+      func.call @sink(%e) : (memref<256xi32>) -> ()
+      aie.objectfifo.release @of1 (Consume, 1)
+    }
+    aie.end
+  }
+ }
+}
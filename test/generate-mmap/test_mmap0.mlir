@@ -138,6 +138,10 @@ module @test_mmap0 {
   %buf45_0 = aie.buffer(%t45) { sym_name = "t", address = 0x0 : i32 } : memref<8xi32>
 
   aie.core(%t44) {
+    %c0 = arith.constant 0 : index
+    %0 = memref.load %buf43_0[%c0] : memref<8xi32>
+    memref.store %0, %buf45_0[%c0] : memref<8xi32>
+    memref.store %0, %buf54_0[%c0] : memref<8xi32>
     aie.end
   }
  }
@@ -0,0 +1,79 @@
+//===- test_mmap_core_buffers.mlir -----------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --tilecol=4 --tilerow=4 --aie-generate-bcf %s | FileCheck --check-prefix=BCF44 %s
+// RUN: aie-translate --tilecol=4 --tilerow=4 --aie-generate-ldscript %s | FileCheck --check-prefix=LD44 %s
+// RUN: aie-translate --tilecol=4 --tilerow=5 --aie-generate-bcf %s | FileCheck --check-prefix=BCF45 %s
+
+// Only the neighbor buffers the core uses get a symbol, the buffers of its own
+// tile always do.
+
+// BCF44:      // south -------------------------------------------------
+// BCF44-NEXT: _reserved DMb 0x20000 0x8000  // Don't allocate variables in south neighbor
+// BCF44:      _symbol z 0x20000 32
+// BCF44-NOT:  _symbol unused_south
+// BCF44:      // west -------------------------------------------------
+// BCF44-NEXT: _symbol a 0x28000 16
+// BCF44:      _symbol unused_local 0x28010 64
+// BCF44:      // north -------------------------------------------------
+// BCF44-NEXT: _reserved DMb 0x30000 0x8000  // Don't allocate variables in north neighbor
+// BCF44-NOT:  _symbol
+// BCF44:      // east -------------------------------------------------
+// BCF44-NEXT: _reserved DMb 0x38000 0x8000  // Don't allocate variables in east neighbor
+// BCF44-NOT:  _symbol
+// BCF44:      // end mapping neighbors tile memory
+
+// LD44:      _sp_start_value_DM_stack = .;
+// LD44-NEXT: . += 0x400;
+// LD44-NEXT: . = 0x20000
+// LD44-NEXT: z = .;
+// LD44-NEXT: . += 0x20
+// LD44-NEXT: . = 0x28000
+// LD44-NEXT: a = .;
+// LD44-NEXT: . += 0x10
+// LD44-NEXT: . = 0x28010
+// LD44-NEXT: unused_local = .;
+// LD44-NEXT: . += 0x40
+// LD44-NEXT: .bss
+
+// The core of tile (4, 5) is linked with an object file, which may use any
+// buffer by its symbol.
+
+// BCF45:      _symbol a 0x20000 16
+// BCF45:      _symbol unused_local 0x20010 64
+// BCF45:      _symbol t 0x38000 32
+// BCF45:      _include _file kernel.o
+
+module @test_mmap_core_buffers {
+ aie.device(xcvc1902) {
+  %t44 = aie.tile(4, 4)
+  %t54 = aie.tile(5, 4)
+  %t43 = aie.tile(4, 3)
+  %t45 = aie.tile(4, 5)
+
+  %buf44_0 = aie.buffer(%t44) { sym_name = "a", address = 0x0 : i32 } : memref<4xi32>
+  %buf44_1 = aie.buffer(%t44) { sym_name = "unused_local", address = 0x10 : i32 } : memref<16xi32>
+  %buf54_0 = aie.buffer(%t54) { sym_name = "y", address = 0x0 : i32 } : memref<8xi32>
+  %buf43_0 = aie.buffer(%t43) { sym_name = "z", address = 0x0 : i32 } : memref<8xi32>
+  %buf43_1 = aie.buffer(%t43) { sym_name = "unused_south", address = 0x20 : i32 } : memref<8xi32>
+  %buf45_0 = aie.buffer(%t45) { sym_name = "t", address = 0x0 : i32 } : memref<8xi32>
+
+  aie.core(%t44) {
+    %c0 = arith.constant 0 : index
+    %0 = memref.load %buf43_0[%c0] : memref<8xi32>
+    memref.store %0, %buf44_0[%c0] : memref<4xi32>
+    aie.end
+  }
+
+  aie.core(%t45) {
+    aie.end
+  } { link_with = "kernel.o" }
+ }
+}
@@ -0,0 +1,41 @@
+//===- test_mmap_overlays.mlir ---------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --tilecol=0 --tilerow=2 --aie-generate-ldscript %s | FileCheck %s
+// RUN: not aie-translate --tilecol=0 --tilerow=2 --aie-generate-bcf %s 2>&1 | FileCheck --check-prefix=BCF %s
+
+// The resident code keeps the first 12KB of the program memory, the overlays
+// being linked in the last 4KB and loaded out of the tile address space.
+
+// CHECK:      program (RX) : ORIGIN = 0, LENGTH = 0x3000
+// CHECK:      *(EXCLUDE_FILE(*conv.o *pool.o) .text EXCLUDE_FILE(*conv.o *pool.o) .text.*)
+// CHECK-NEXT: } > program
+// CHECK-NEXT: OVERLAY 0x3000 : NOCROSSREFS AT (0x100000) {
+// CHECK-NEXT:   .overlay0 { *conv.o(.text .text.*) }
+// CHECK-NEXT:   .overlay1 { *pool.o(.text .text.*) }
+// CHECK-NEXT: }
+// CHECK-NEXT: ASSERT(SIZEOF(.overlay0) <= 0x1000, "overlay 0 is larger than the overlay_size of the core")
+// CHECK-NEXT: ASSERT(SIZEOF(.overlay1) <= 0x1000, "overlay 1 is larger than the overlay_size of the core")
+// CHECK-NEXT: .data : {
+// CHECK:      INPUT(kernel.o)
+// CHECK-NEXT: INPUT(conv.o)
+// CHECK-NEXT: INPUT(pool.o)
+// CHECK-NEXT: PROVIDE(_main = core_0_2);
+
+// BCF: error: 'aie.core' op overlays are only linked with the GNU linker script, not with a BCF
+
+module @test_mmap_overlays {
+ aie.device(ipu) {
+  %t02 = aie.tile(0, 2)
+  aie.core(%t02) {
+    aie.end
+  } { link_with = "kernel.o", overlays = ["conv.o", "pool.o"], overlay_size = 4096 : i32 }
+ }
+}
@@ -0,0 +1,49 @@
+//===- sync_timers.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -aie-insert-trace="sync-broadcast=14" %s | FileCheck %s
+
+// The timers of the core module of (0, 2) and of the memory module of (0, 3)
+// reset on broadcast 14 (event 121), on which the shim sends its
+// USER_EVENT_1 (127). The reset events and the broadcast are then cleared,
+// before the trace units start.
+
+// CHECK-LABEL: func.func @sequence
+// CHECK:         aiex.ipu.write32 {address = 119308 : ui32, column = 0 : i32, row = 0 : i32, value = 15 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 212992 : ui32, column = 0 : i32, row = 2 : i32, value = 30976 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 81920 : ui32, column = 0 : i32, row = 3 : i32, value = 30976 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 213064 : ui32, column = 0 : i32, row = 0 : i32, value = 127 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 213000 : ui32, column = 0 : i32, row = 0 : i32, value = 127 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 213064 : ui32, column = 0 : i32, row = 0 : i32, value = 0 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 212992 : ui32, column = 0 : i32, row = 2 : i32, value = 0 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 81920 : ui32, column = 0 : i32, row = 3 : i32, value = 0 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 213216 : ui32, column = 0 : i32, row = 2 : i32
+
+module {
+  aie.device(ipu) {
+    %t02 = aie.tile(0, 2)
+    %t03 = aie.tile(0, 3) { trace_events = array<i32>, trace_mem_events = array<i32: 90> }
+    %c02 = aie.core(%t02) {
+      aie.end
+    }
+    %c03 = aie.core(%t03) {
+      aie.end
+    }
+    func.func @sequence(%in : memref<64xi32>, %out : memref<128xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c64 = arith.constant 64 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<128xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+    aie.shim_dma_allocation @out (S2MM, 0, 0)
+  }
+}
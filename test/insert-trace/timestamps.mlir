@@ -0,0 +1,50 @@
+//===- timestamps.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -aie-insert-trace="timestamps=true" %s | FileCheck %s
+
+// Only the shim tile is traced. Channel 1 receives @out, so the traces go to
+// channel 0 and the shim traces the tasks of S2MM channel 1 rather than
+// its own.
+
+// CHECK:       %[[SHIM:.*]] = aie.tile(0, 0)
+// CHECK:       aie.packet_flow(1) {
+// CHECK-NEXT:    aie.packet_source<%[[SHIM]], Trace : 0>
+// CHECK-NEXT:    aie.packet_dest<%[[SHIM]], DMA : 0>
+// CHECK-NEXT:  } {keep_pkt_header = true}
+// CHECK:       aie.shim_dma_allocation @trace(S2MM, 0, 0)
+
+// CHECK-LABEL: func.func @sequence
+// CHECK-NEXT:    aiex.ipu.writebd_shimtile {bd_id = 15 : i32
+// CHECK-NEXT:    aiex.ipu.write32 {address = 119300 : ui32, column = 0 : i32, row = 0 : i32, value = 15 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 213216 : ui32, column = 0 : i32, row = 0 : i32, value = 403734398 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 213220 : ui32, column = 0 : i32, row = 0 : i32, value = 386865425 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 213204 : ui32, column = 0 : i32, row = 0 : i32, value = 8193 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 213200 : ui32, column = 0 : i32, row = 0 : i32, value = 65536 : ui32}
+// CHECK-NEXT:    aiex.ipu.dma_memcpy_nd
+
+module {
+  aie.device(ipu) {
+    %t00 = aie.tile(0, 0)
+    %t02 = aie.tile(0, 2) { trace_events = array<i32> }
+    %c02 = aie.core(%t02) {
+      aie.end
+    }
+    func.func @sequence(%in : memref<64xi32>, %out : memref<128xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c64 = arith.constant 64 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<128xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 1 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+    aie.shim_dma_allocation @out (S2MM, 1, 0)
+  }
+}
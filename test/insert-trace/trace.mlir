@@ -0,0 +1,69 @@
+//===- trace.mlir ----------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt -aie-insert-trace="trace-size=8192 trace-offset=256" %s | FileCheck %s
+
+// The core of tile (0, 2) is traced with the default events, and tile (0, 3)
+// only traces one event of its memory module.  Channel 1 of the shim already
+// receives @out, so the traces go to channel 0, which gets the BD 15 pointing
+// after the output.
+
+// CHECK:       %[[SHIM:.*]] = aie.tile(0, 0)
+// CHECK:       %[[T02:.*]] = aie.tile(0, 2)
+// CHECK:       %[[T03:.*]] = aie.tile(0, 3)
+// CHECK:       aie.packet_flow(4) {
+// CHECK-NEXT:    aie.packet_source<%[[T02]], Trace : 0>
+// CHECK-NEXT:    aie.packet_dest<%[[SHIM]], DMA : 0>
+// CHECK-NEXT:  } {keep_pkt_header = true}
+// CHECK:       aie.packet_flow(5) {
+// CHECK-NEXT:    aie.packet_source<%[[T03]], Trace : 1>
+// CHECK-NEXT:    aie.packet_dest<%[[SHIM]], DMA : 0>
+// CHECK-NEXT:  } {keep_pkt_header = true}
+// CHECK:       aie.shim_dma_allocation @trace(S2MM, 0, 0)
+
+// CHECK-LABEL: func.func @sequence
+// CHECK-NEXT:    aiex.ipu.writebd_shimtile {bd_id = 15 : i32, buffer_length = 2048 : i32, buffer_offset = 256 : i32, column = 0 : i32, column_num = 1 : i32, d0_size = 0 : i32, d0_stride = 0 : i32, d1_size = 0 : i32, d1_stride = 0 : i32, d2_stride = 0 : i32, ddr_id = 1 : i32
+// CHECK-SAME:    valid_bd = 1 : i32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 119300 : ui32, column = 0 : i32, row = 0 : i32, value = 15 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 213216 : ui32, column = 0 : i32, row = 2 : i32, value = 388309537 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 213220 : ui32, column = 0 : i32, row = 2 : i32, value = 471472408 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 213204 : ui32, column = 0 : i32, row = 2 : i32, value = 4 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 213200 : ui32, column = 0 : i32, row = 2 : i32, value = 65536 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 82144 : ui32, column = 0 : i32, row = 3 : i32, value = 90 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 82148 : ui32, column = 0 : i32, row = 3 : i32, value = 0 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 82132 : ui32, column = 0 : i32, row = 3 : i32, value = 4101 : ui32}
+// CHECK-NEXT:    aiex.ipu.write32 {address = 82128 : ui32, column = 0 : i32, row = 3 : i32, value = 65536 : ui32}
+// CHECK-NEXT:    aiex.ipu.dma_memcpy_nd
+
+module {
+  aie.device(ipu) {
+    %t02 = aie.tile(0, 2)
+    %t03 = aie.tile(0, 3) { trace_events = array<i32>, trace_mem_events = array<i32: 90> }
+    aie.packet_flow(3) {
+      aie.packet_source<%t02, DMA : 0>
+      aie.packet_dest<%t03, DMA : 0>
+    }
+    %c02 = aie.core(%t02) {
+      aie.end
+    }
+    %c03 = aie.core(%t03) {
+      aie.end
+    }
+    func.func @sequence(%in : memref<64xi32>, %out : memref<128xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c64 = arith.constant 64 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<128xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 1 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+    aie.shim_dma_allocation @out (S2MM, 1, 0)
+  }
+}
@@ -0,0 +1,57 @@
+//===- broadcast_latency.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The core of tile (0, 2) broadcasts its instruction event 0 north on
+// channel 15, and the core module of tile (0, 5) reflects broadcast 15 back
+// south on channel 14.  Tracing both events on tile (0, 2) gives the round
+// trip over 3 tiles on a single timer.  Like lock_latency.mlir, the core
+// waits for its input so that the trace and the broadcasts are set up.
+
+module {
+  aie.device(ipu) {
+    %t00 = aie.tile(0, 0)
+    %t02 = aie.tile(0, 2)
+
+    aie.objectfifo @in(%t00, {%t02}, 1 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @out(%t02, {%t00}, 1 : i32) : !aie.objectfifo<memref<16xi32>>
+
+    aie.core(%t02) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c16 = arith.constant 16 : index
+      %subview0 = aie.objectfifo.acquire @in(Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem0 = aie.objectfifo.subview.access %subview0[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      %subview1 = aie.objectfifo.acquire @out(Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem1 = aie.objectfifo.subview.access %subview1[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      aie.event(0)
+      scf.for %i = %c0 to %c16 step %c1 {
+        %0 = memref.load %elem0[%i] : memref<16xi32>
+        memref.store %0, %elem1[%i] : memref<16xi32>
+      }
+      aie.objectfifo.release @in(Consume, 1)
+      aie.objectfifo.release @out(Produce, 1)
+      aie.end
+    }
+
+    func.func @sequence(%in : memref<16xi32>, %unused : memref<1xi32>, %out : memref<16xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c16 = arith.constant 16 : i64
+      // Core module Event_Broadcast15 of (0, 2) = INSTR_EVENT_0.
+      aiex.ipu.write32 { address = 213068 : ui32, column = 0 : i32, row = 2 : i32, value = 33 : ui32 }
+      // Core module Event_Broadcast14 of (0, 5) = BROADCAST_15.
+      aiex.ipu.write32 { address = 213064 : ui32, column = 0 : i32, row = 5 : i32, value = 122 : ui32 }
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c16][%c0,%c0,%c0]) { metadata = @out, id = 1 : i64 } : memref<16xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c16][%c0,%c0,%c0]) { metadata = @in, id = 0 : i64 } : memref<16xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+  }
+}
@@ -0,0 +1,189 @@
+//===- host.cpp -------------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Host side of the IPU benchmarks. It runs the runtime sequence of a design
+// a number of times, checks its output and prints one JSON line with the
+// timings of the runs, which is also appended to the --results file. The
+// sequences take (in, unused, out) buffers; the trace buffer of the designs
+// traced with -aie-insert-trace follows the output, and is dumped to
+// --trace-file for report.py.
+
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+namespace po = boost::program_options;
+
+std::vector<uint32_t> load_instr_sequence(std::string instr_path) {
+  std::ifstream instr_file(instr_path);
+  std::string line;
+  std::vector<uint32_t> instr_v;
+  while (std::getline(instr_file, line)) {
+    std::istringstream iss(line);
+    uint32_t a;
+    if (!(iss >> std::hex >> a)) {
+      throw std::runtime_error("Unable to parse instruction file\n");
+    }
+    instr_v.push_back(a);
+  }
+  return instr_v;
+}
+
+int main(int argc, const char *argv[]) {
+  po::options_description desc("Allowed options");
+  desc.add_options()("help,h", "produce help message")(
+      "xclbin,x", po::value<std::string>()->required(),
+      "the input xclbin path")(
+      "kernel,k", po::value<std::string>()->default_value("MLIR_AIE"),
+      "the kernel name in the XCLBIN")(
+      "instr,i", po::value<std::string>()->required(),
+      "path of file containing userspace instructions to be sent to the LX6")(
+      "name", po::value<std::string>()->required(), "name of the benchmark")(
+      "in-words", po::value<int>()->default_value(1),
+      "number of 32-bit words read by the sequence")(
+      "out-words", po::value<int>()->default_value(1),
+      "number of 32-bit words written by the sequence")(
+      "channels", po::value<int>()->default_value(1),
+      "number of shim channels the input is spread over")(
+      "trace-bytes", po::value<int>()->default_value(0),
+      "size of the trace buffer following the output")(
+      "trace-file", po::value<std::string>(),
+      "file the trace buffer is written to, one word per line")(
+      "check-copy", "check that the output is a copy of the input")(
+      "iterations", po::value<int>()->default_value(20),
+      "number of timed runs")("warmup", po::value<int>()->default_value(2),
+                              "number of untimed runs")(
+      "results", po::value<std::string>(),
+      "file the JSON result line is appended to");
+  po::variables_map vm;
+
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    if (vm.count("help")) {
+      std::cout << desc << "\n";
+      return 1;
+    }
+    po::notify(vm);
+  } catch (const std::exception &ex) {
+    std::cerr << ex.what() << "\n\n";
+    std::cerr << "Usage:\n" << desc << "\n";
+    return 1;
+  }
+
+  std::vector<uint32_t> instr_v =
+      load_instr_sequence(vm["instr"].as<std::string>());
+  int inWords = vm["in-words"].as<int>();
+  int outWords = vm["out-words"].as<int>();
+  int traceBytes = vm["trace-bytes"].as<int>();
+  int iterations = vm["iterations"].as<int>();
+  int warmup = vm["warmup"].as<int>();
+
+  auto device = xrt::device(0);
+  auto xclbin = xrt::xclbin(vm["xclbin"].as<std::string>());
+  std::string node = vm["kernel"].as<std::string>();
+  auto xkernels = xclbin.get_kernels();
+  auto xkernel = *std::find_if(xkernels.begin(), xkernels.end(),
+                               [node](xrt::xclbin::kernel &k) {
+                                 return k.get_name().rfind(node, 0) == 0;
+                               });
+  device.register_xclbin(xclbin);
+  xrt::hw_context context(device, xclbin.get_uuid());
+  auto kernel = xrt::kernel(context, xkernel.get_name());
+
+  auto bo_instr = xrt::bo(device, instr_v.size() * sizeof(int),
+                          XCL_BO_FLAGS_CACHEABLE, kernel.group_id(0));
+  auto bo_in = xrt::bo(device, inWords * sizeof(uint32_t),
+                       XRT_BO_FLAGS_HOST_ONLY, kernel.group_id(2));
+  auto bo_unused =
+      xrt::bo(device, sizeof(uint32_t), XRT_BO_FLAGS_HOST_ONLY,
+              kernel.group_id(3));
+  auto bo_out = xrt::bo(device, outWords * sizeof(uint32_t) + traceBytes,
+                        XRT_BO_FLAGS_HOST_ONLY, kernel.group_id(4));
+
+  memcpy(bo_instr.map<void *>(), instr_v.data(), instr_v.size() * sizeof(int));
+  uint32_t *bufIn = bo_in.map<uint32_t *>();
+  for (int i = 0; i < inWords; i++)
+    bufIn[i] = i + 1;
+  bo_instr.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  bo_in.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+  std::vector<double> times;
+  for (int i = 0; i < warmup + iterations; i++) {
+    // Clear the trace of the previous run, so that only the frames of the
+    // last run are decoded.
+    memset(bo_out.map<void *>(), 0, bo_out.size());
+    bo_out.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    auto start = std::chrono::high_resolution_clock::now();
+    auto run = kernel(bo_instr, instr_v.size(), bo_in, bo_unused, bo_out);
+    run.wait();
+    auto stop = std::chrono::high_resolution_clock::now();
+    if (i >= warmup)
+      times.push_back(std::chrono::duration<double>(stop - start).count());
+  }
+  bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+  uint32_t *bufOut = bo_out.map<uint32_t *>();
+
+  int errors = 0;
+  if (vm.count("check-copy"))
+    for (int i = 0; i < std::min(inWords, outWords); i++)
+      errors += bufOut[i] != bufIn[i];
+
+  if (vm.count("trace-file")) {
+    std::ofstream trace(vm["trace-file"].as<std::string>());
+    for (int i = 0; i < traceBytes / 4; i++)
+      trace << std::setfill('0') << std::setw(8) << std::hex
+            << bufOut[outWords + i] << "\n";
+  }
+
+  std::sort(times.begin(), times.end());
+  double minTime = times.front();
+  double medianTime = times[times.size() / 2];
+  double bytes = static_cast<double>(inWords) * sizeof(uint32_t);
+  int channels = vm["channels"].as<int>();
+
+  // The input and output transfers overlap, so the throughput is the one of
+  // a direction.
+  std::ostringstream result;
+  result << std::setprecision(6) << "{\"benchmark\": \""
+         << vm["name"].as<std::string>() << "\", \"iterations\": "
+         << iterations << ", \"min_us\": " << minTime * 1e6
+         << ", \"median_us\": " << medianTime * 1e6;
+  if (vm.count("check-copy"))
+    result << ", \"bytes\": " << bytes
+           << ", \"GBps\": " << bytes / medianTime / 1e9
+           << ", \"GBps_per_channel\": "
+           << bytes / medianTime / 1e9 / channels;
+  result << ", \"errors\": " << errors << "}";
+
+  std::cout << result.str() << "\n";
+  if (vm.count("results")) {
+    std::ofstream results(vm["results"].as<std::string>(), std::ios::app);
+    results << result.str() << "\n";
+  }
+
+  if (!errors) {
+    std::cout << "\nPASS!\n\n";
+    return 0;
+  }
+  std::cout << "\nfailed.\n\n";
+  return 1;
+}
@@ -0,0 +1,60 @@
+//===- lock_latency.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The core acquires and releases a free local lock 256 times between
+// instruction events 0 and 1, then copies its input to its output.  The core
+// waits for the input, so that the loop runs after the sequence has started
+// the trace.
+
+module {
+  aie.device(ipu) {
+    %t00 = aie.tile(0, 0)
+    %t02 = aie.tile(0, 2)
+
+    %lock = aie.lock(%t02, 0) {init = 1 : i32, sym_name = "bench_lock"}
+
+    aie.objectfifo @in(%t00, {%t02}, 1 : i32) : !aie.objectfifo<memref<16xi32>>
+    aie.objectfifo @out(%t02, {%t00}, 1 : i32) : !aie.objectfifo<memref<16xi32>>
+
+    aie.core(%t02) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : index
+      %c16 = arith.constant 16 : index
+      %c256 = arith.constant 256 : index
+      %subview0 = aie.objectfifo.acquire @in(Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem0 = aie.objectfifo.subview.access %subview0[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      %subview1 = aie.objectfifo.acquire @out(Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %elem1 = aie.objectfifo.subview.access %subview1[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      aie.event(0)
+      scf.for %i = %c0 to %c256 step %c1 {
+        aie.use_lock(%lock, AcquireGreaterEqual, 1)
+        aie.use_lock(%lock, Release, 1)
+      }
+      aie.event(1)
+      scf.for %i = %c0 to %c16 step %c1 {
+        %0 = memref.load %elem0[%i] : memref<16xi32>
+        memref.store %0, %elem1[%i] : memref<16xi32>
+      }
+      aie.objectfifo.release @in(Consume, 1)
+      aie.objectfifo.release @out(Produce, 1)
+      aie.end
+    }
+
+    func.func @sequence(%in : memref<16xi32>, %unused : memref<1xi32>, %out : memref<16xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c16 = arith.constant 16 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c16][%c0,%c0,%c0]) { metadata = @out, id = 1 : i64 } : memref<16xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c16][%c0,%c0,%c0]) { metadata = @in, id = 0 : i64 } : memref<16xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+  }
+}
@@ -0,0 +1,34 @@
+//===- memtile_copy.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Copies 256 KiB from DDR through a memtile and back to DDR, over one shim
+// channel in each direction.
+
+module {
+  aie.device(ipu) {
+    %t00 = aie.tile(0, 0)
+    %t01 = aie.tile(0, 1)
+
+    aie.objectfifo @in(%t00, {%t01}, 2 : i32) : !aie.objectfifo<memref<1024xi32>>
+    aie.objectfifo @out(%t01, {%t00}, 2 : i32) : !aie.objectfifo<memref<1024xi32>>
+    aie.objectfifo.link [@in] -> [@out] ()
+
+    func.func @sequence(%in : memref<65536xi32>, %unused : memref<1xi32>, %out : memref<65536xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c64 = arith.constant 64 : i64
+      %c1024 = arith.constant 1024 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c64,%c1024][%c0,%c0,%c1024]) { metadata = @out, id = 1 : i64 } : memref<65536xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c64,%c1024][%c0,%c0,%c1024]) { metadata = @in, id = 0 : i64 } : memref<65536xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+  }
+}
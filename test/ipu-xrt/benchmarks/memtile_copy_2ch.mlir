@@ -0,0 +1,42 @@
+//===- memtile_copy_2ch.mlir -----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// Same copy as memtile_copy.mlir, with each half of the buffer going through
+// its own pair of shim channels, to compare the per-channel throughput when
+// both channels of the shim tile are busy.
+
+module {
+  aie.device(ipu) {
+    %t00 = aie.tile(0, 0)
+    %t01 = aie.tile(0, 1)
+
+    aie.objectfifo @in0(%t00, {%t01}, 2 : i32) : !aie.objectfifo<memref<1024xi32>>
+    aie.objectfifo @out0(%t01, {%t00}, 2 : i32) : !aie.objectfifo<memref<1024xi32>>
+    aie.objectfifo.link [@in0] -> [@out0] ()
+
+    aie.objectfifo @in1(%t00, {%t01}, 2 : i32) : !aie.objectfifo<memref<1024xi32>>
+    aie.objectfifo @out1(%t01, {%t00}, 2 : i32) : !aie.objectfifo<memref<1024xi32>>
+    aie.objectfifo.link [@in1] -> [@out1] ()
+
+    func.func @sequence(%in : memref<65536xi32>, %unused : memref<1xi32>, %out : memref<65536xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c32 = arith.constant 32 : i64
+      %c1024 = arith.constant 1024 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c32,%c1024][%c0,%c0,%c1024]) { metadata = @out0, id = 2 : i64 } : memref<65536xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c32,%c0][%c1,%c1,%c32,%c1024][%c0,%c0,%c1024]) { metadata = @out1, id = 3 : i64 } : memref<65536xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c32,%c1024][%c0,%c0,%c1024]) { metadata = @in0, id = 0 : i64 } : memref<65536xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c32,%c0][%c1,%c1,%c32,%c1024][%c0,%c0,%c1024]) { metadata = @in1, id = 1 : i64 } : memref<65536xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 1 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+  }
+}
@@ -0,0 +1,82 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Turn the trace of a latency benchmark into a JSON result line.
+
+The trace is decoded with aie.trace; the cycles are the ones of the timer of
+the traced tile, so only differences between events of that tile are used.
+
+    python3 report.py lock --trace trace.txt --name lock_latency
+"""
+
+import argparse
+import json
+import statistics
+
+from aie.trace import decode_frames, read_words, split_packets
+
+
+def event_cycles(words, col, row, slots):
+    """Return the cycles at which each of the slots of a core module fired."""
+    cycles = {slot: [] for slot in slots}
+    for cycle, mask in decode_frames(split_packets(words)[(col, row, 0)]):
+        for slot in slots:
+            if mask & (1 << slot):
+                cycles[slot].append(cycle)
+    return cycles
+
+
+# Traced with events=33,34,44,45: instruction events 0 and 1 around the
+# loop, then the lock acquire and release requests.
+def lock_latency(words, iterations):
+    cycles = event_cycles(words, 0, 2, range(4))
+    if not cycles[0] or not cycles[1]:
+        return {}
+    loop = cycles[1][0] - cycles[0][0]
+    result = {"cycles_per_acquire_release": loop / iterations}
+    pairs = [rel - acq for acq, rel in zip(cycles[2], cycles[3]) if rel >= acq]
+    if pairs:
+        result["acquire_to_release_cycles"] = statistics.median(pairs)
+    return result
+
+
+# Traced with events=33,121: instruction event 0 and broadcast 14, which is
+# broadcast 15 coming back from `hops` tiles away.
+def broadcast_latency(words, hops):
+    cycles = event_cycles(words, 0, 2, range(2))
+    if not cycles[0]:
+        return {}
+    back = [c for c in cycles[1] if c >= cycles[0][0]]
+    if not back:
+        return {}
+    round_trip = back[0] - cycles[0][0]
+    return {
+        "round_trip_cycles": round_trip,
+        "cycles_per_hop": round_trip / (2 * hops),
+    }
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("kind", choices=["lock", "broadcast"])
+    parser.add_argument("--trace", required=True, help="trace from host.cpp")
+    parser.add_argument("--name", required=True, help="name of the benchmark")
+    parser.add_argument("--iterations", type=int, default=256)
+    parser.add_argument("--hops", type=int, default=3)
+    parser.add_argument("--results", help="file the result line is appended to")
+    opts = parser.parse_args(argv)
+
+    words = read_words(opts.trace)
+    if opts.kind == "lock":
+        values = lock_latency(words, opts.iterations)
+    else:
+        values = broadcast_latency(words, opts.hops)
+    result = json.dumps({"benchmark": opts.name, **values, "decoded": bool(values)})
+    print(result)
+    if opts.results:
+        with open(opts.results, "a") as f:
+            f.write(result + "\n")
+    return 0 if values else 1
+
+
+if __name__ == "__main__":
+    exit(main())
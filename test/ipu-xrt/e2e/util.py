@@ -253,9 +253,12 @@ def make_core_elf(core_bcf, object_filename="input", debug=False):
     _run_command(cmd, debug)
 
 
-def make_design_pdi():
+def make_design_pdi(module):
+    # The work directory may hold the ELF CDOs of columns of earlier designs,
+    # so the columns are those of the cores of this one.
+    core_columns = sorted({col for col, _, _ in generate_cores_list(str(module))})
     with open(WORKDIR / "design.bif", "w") as f:
-        f.write(emit_design_bif(WORKDIR))
+        f.write(emit_design_bif(WORKDIR, core_columns))
 
     cmd = [
         "bootgen",
@@ -379,7 +382,7 @@ def compile_with_vectorization(
             partition_start_col=partition_start_col,
         )
 
-    make_design_pdi()
+    make_design_pdi(input_physical)
 
 
 def compile_without_vectorization(module, *, debug=False, partition_start_col=1):
@@ -423,7 +426,7 @@ def compile_without_vectorization(module, *, debug=False, partition_start_col=1)
             partition_start_col=partition_start_col,
         )
 
-    make_design_pdi()
+    make_design_pdi(input_physical)
 
 
 def grouper(iterable, n, *, incomplete="fill", fill_value=None):
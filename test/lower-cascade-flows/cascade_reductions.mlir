@@ -0,0 +1,97 @@
+//===- cascade_reductions.mlir ---------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-cascade-reductions %s | FileCheck %s
+// RUN: aie-opt --aie-cascade-reductions --aie-lower-cascade-flows %s | FileCheck %s --check-prefix=CONFIG
+
+// The chain "k" runs from (1, 4) down to (1, 3), then east to (2, 3),
+// whatever the order of its cores. The chain "w" passes its 1024-bit sum in
+// two pieces.
+
+// CHECK-LABEL: module @cascade_reductions
+// CHECK:       aie.core(%[[T23:.*]]) {
+// CHECK:         %[[P:.*]] = arith.constant dense<3> : vector<16xi32>
+// CHECK-NEXT:    %[[R:.*]] = aie.get_cascade() : vector<16xi32>
+// CHECK-NEXT:    %[[S:.*]] = arith.addi %[[R]], %[[P]] : vector<16xi32>
+// CHECK-NOT:     aie.put_cascade
+// CHECK:         vector.store %[[S]]
+// CHECK:       aie.core(%[[T14:.*]]) {
+// CHECK:         %[[P:.*]] = arith.constant dense<1> : vector<16xi32>
+// CHECK-NOT:     aie.get_cascade
+// CHECK-NEXT:    aie.put_cascade(%[[P]] : vector<16xi32>)
+// CHECK:       aie.core(%[[T13:.*]]) {
+// CHECK:         %[[P:.*]] = arith.constant dense<2> : vector<16xi32>
+// CHECK-NEXT:    %[[R:.*]] = aie.get_cascade() : vector<16xi32>
+// CHECK-NEXT:    %[[S:.*]] = arith.addi %[[R]], %[[P]] : vector<16xi32>
+// CHECK-NEXT:    aie.put_cascade(%[[S]] : vector<16xi32>)
+// CHECK:       aie.core(%[[T33:.*]]) {
+// CHECK:         %[[P:.*]] = arith.constant dense<1.000000e+00> : vector<32xf32>
+// CHECK-NEXT:    %[[LO:.*]] = vector.extract_strided_slice %[[P]] {offsets = [0], sizes = [16], strides = [1]}
+// CHECK-NEXT:    aie.put_cascade(%[[LO]] : vector<16xf32>)
+// CHECK-NEXT:    %[[HI:.*]] = vector.extract_strided_slice %[[P]] {offsets = [16], sizes = [16], strides = [1]}
+// CHECK-NEXT:    aie.put_cascade(%[[HI]] : vector<16xf32>)
+// CHECK:       aie.core(%[[T43:.*]]) {
+// CHECK:         %[[P:.*]] = arith.constant dense<2.000000e+00> : vector<32xf32>
+// CHECK-NEXT:    %[[R0:.*]] = aie.get_cascade() : vector<16xf32>
+// CHECK-NEXT:    %[[I0:.*]] = vector.insert_strided_slice %[[R0]], %[[P]] {offsets = [0], strides = [1]}
+// CHECK-NEXT:    %[[R1:.*]] = aie.get_cascade() : vector<16xf32>
+// CHECK-NEXT:    %[[I1:.*]] = vector.insert_strided_slice %[[R1]], %[[I0]] {offsets = [16], strides = [1]}
+// CHECK-NEXT:    arith.addf %[[I1]], %[[P]] : vector<32xf32>
+// CHECK:       aie.cascade_flow(%[[T14]], %[[T13]])
+// CHECK:       aie.cascade_flow(%[[T13]], %[[T23]])
+// CHECK:       aie.cascade_flow(%[[T33]], %[[T43]])
+
+// CONFIG-DAG:  aie.configure_cascade(%tile_1_4, North, South)
+// CONFIG-DAG:  aie.configure_cascade(%tile_1_3, North, East)
+// CONFIG-DAG:  aie.configure_cascade(%tile_2_3, West, South)
+// CONFIG-NOT:  aie.cascade_flow
+
+module @cascade_reductions {
+  aie.device(xcve2802) {
+    %t13 = aie.tile(1, 3)
+    %t14 = aie.tile(1, 4)
+    %t23 = aie.tile(2, 3)
+    %t33 = aie.tile(3, 3)
+    %t43 = aie.tile(4, 3)
+    %out = aie.buffer(%t23) : memref<16xi32>
+    %wout = aie.buffer(%t43) : memref<32xf32>
+
+    aie.core(%t23) {
+      %p = arith.constant dense<3> : vector<16xi32>
+      %sum = aie.cascade_reduce "k" (%p) : vector<16xi32>
+      %c0 = arith.constant 0 : index
+      vector.store %sum, %out[%c0] : memref<16xi32>, vector<16xi32>
+      aie.end
+    }
+    aie.core(%t14) {
+      %p = arith.constant dense<1> : vector<16xi32>
+      %sum = aie.cascade_reduce "k" (%p) : vector<16xi32>
+      aie.end
+    }
+    aie.core(%t13) {
+      %p = arith.constant dense<2> : vector<16xi32>
+      %sum = aie.cascade_reduce "k" (%p) : vector<16xi32>
+      aie.end
+    }
+
+    aie.core(%t33) {
+      %p = arith.constant dense<1.0> : vector<32xf32>
+      %sum = aie.cascade_reduce "w" (%p) : vector<32xf32>
+      aie.end
+    }
+    aie.core(%t43) {
+      %p = arith.constant dense<2.0> : vector<32xf32>
+      %sum = aie.cascade_reduce "w" (%p) : vector<32xf32>
+      %c0 = arith.constant 0 : index
+      vector.store %sum, %wout[%c0] : memref<32xf32>, vector<32xf32>
+      aie.end
+    }
+  }
+}
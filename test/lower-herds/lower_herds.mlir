@@ -0,0 +1,100 @@
+//===- lower_herds.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file --verify-diagnostics --aie-lower-herds %s | FileCheck %s
+
+// The herd @a is placed at (1, 3), and @b above it. The cores of @a only use
+// the buffers and locks of their own tile and share one ELF file; the cores of
+// @b read the buffers of @a and do not.
+
+// CHECK-LABEL: module @lower_herds
+// CHECK-DAG:   %[[T13:.*]] = aie.tile(1, 3)
+// CHECK-DAG:   %[[T23:.*]] = aie.tile(2, 3)
+// CHECK-DAG:   %[[T14:.*]] = aie.tile(1, 4)
+// CHECK-DAG:   %[[T24:.*]] = aie.tile(2, 4)
+// CHECK-NOT:   aiex.
+// CHECK:       %[[BUF00:.*]] = aie.buffer(%[[T13]]) {sym_name = "buf_0_0"} : memref<16xi32>
+// CHECK:       %[[BUF10:.*]] = aie.buffer(%[[T23]]) {sym_name = "buf_1_0"} : memref<16xi32>
+// CHECK:       %[[LOCK00:.*]] = aie.lock(%[[T13]], 0) {sym_name = "lock_0_0"}
+// CHECK:       %[[LOCK10:.*]] = aie.lock(%[[T23]], 0) {sym_name = "lock_1_0"}
+// CHECK:       aie.core(%[[T13]]) {
+// CHECK:         aie.use_lock(%[[LOCK00]], Acquire, 1)
+// CHECK:         memref.store %{{.*}}, %[[BUF00]]
+// CHECK:       } {elf_file = "a.elf"}
+// CHECK:       aie.core(%[[T23]]) {
+// CHECK:         aie.use_lock(%[[LOCK10]], Acquire, 1)
+// CHECK:         memref.store %{{.*}}, %[[BUF10]]
+// CHECK:       } {elf_file = "a.elf"}
+// CHECK:       aie.core(%[[T14]]) {
+// CHECK:         memref.load %[[BUF00]]
+// CHECK:       }
+// CHECK-NOT:   elf_file
+// CHECK:       aie.core(%[[T24]]) {
+// CHECK:         memref.load %[[BUF10]]
+// CHECK:       }
+// CHECK-NOT:   elf_file
+// CHECK:       aie.flow(%[[T13]], DMA : 0, %[[T14]], DMA : 0)
+// CHECK:       aie.flow(%[[T23]], DMA : 0, %[[T24]], DMA : 0)
+// CHECK-NOT:   aiex.
+
+module @lower_herds {
+  aie.device(xcve2802) {
+    %a = aiex.herd[2][1] {sym_name = "a", aie.col = 1 : i32, aie.row = 3 : i32}
+    %b = aiex.herd[2][1] {sym_name = "b"}
+    aiex.place(%a, %b, 0, 1)
+
+    %buf = aie.buffer(%a) {sym_name = "buf"} : memref<16xi32>
+    %lock = aie.lock(%a, 0) {sym_name = "lock"}
+
+    aie.core(%a) {
+      %c0 = arith.constant 0 : index
+      %c1 = arith.constant 1 : i32
+      aie.use_lock(%lock, Acquire, 1)
+      memref.store %c1, %buf[%c0] : memref<16xi32>
+      aie.use_lock(%lock, Release, 0)
+      aie.end
+    }
+
+    aie.core(%b) {
+      %c0 = arith.constant 0 : index
+      %v = memref.load %buf[%c0] : memref<16xi32>
+      aie.end
+    }
+
+    aie.flow(%a, DMA : 0, %b, DMA : 0)
+  }
+}
+
+// -----
+
+module @unplaced {
+  aie.device(xcve2802) {
+    // expected-error@+1 {{is not placed}}
+    %a = aiex.herd[2][1] {sym_name = "a"}
+    aie.core(%a) {
+      aie.end
+    }
+  }
+}
+
+// -----
+
+module @routes_left {
+  aie.device(xcve2802) {
+    %a = aiex.herd[1][1] {sym_name = "a", aie.col = 1 : i32, aie.row = 3 : i32}
+    %b = aiex.herd[1][1] {sym_name = "b"}
+    aiex.place(%a, %b, 1, 0)
+    %i = aiex.iter(0, 1, 1)
+    %sa = aiex.select(%a, %i, %i)
+    %sb = aiex.select(%b, %i, %i)
+    // expected-error@+1 {{must be routed by aie-herd-routing}}
+    aiex.route(<%sa, DMA : 0>, <%sb, DMA : 0>)
+  }
+}
@@ -12,12 +12,12 @@
 
 // CHECK33:  func.func @core_3_3() {
 // CHECK33:    %c56 = arith.constant 56 : index
-// CHECK33:    %0 = arith.index_cast %c56 : index to i32
-// CHECK33:    %c0_i32 = arith.constant 0 : i32
-// CHECK33:    call @llvm.aie.lock.acquire.reg(%0, %c0_i32) : (i32, i32) -> ()
-// CHECK33:    %1 = arith.index_cast %c56 : index to i32
-// CHECK33:    %c1_i32 = arith.constant 1 : i32
-// CHECK33:    call @llvm.aie.lock.release.reg(%1, %c1_i32) : (i32, i32) -> ()
+// CHECK33:    %[[LOCK0:.*]] = arith.constant 56 : i32
+// CHECK33:    %[[VAL0:.*]] = arith.constant 0 : i32
+// CHECK33:    call @llvm.aie.lock.acquire.reg(%[[LOCK0]], %[[VAL0]]) : (i32, i32) -> ()
+// CHECK33:    %[[LOCK1:.*]] = arith.constant 56 : i32
+// CHECK33:    %[[VAL1:.*]] = arith.constant 1 : i32
+// CHECK33:    call @llvm.aie.lock.release.reg(%[[LOCK1]], %[[VAL1]]) : (i32, i32) -> ()
 // CHECK33:    return
 // CHECK33:  }
 
@@ -0,0 +1,39 @@
+//===- lower_buffer_alignment.mlir -----------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-standard-lowering="tilecol=3 tilerow=3" %s | FileCheck %s
+
+// The alignment assumed for a buffer with an address is the alignment of its
+// address.
+
+// CHECK-LABEL:  func.func @core_3_3() {
+// CHECK:    %[[A:.*]] = memref.get_global @a : memref<16xi32>
+// CHECK:    memref.assume_alignment %[[A]], 1024 : memref<16xi32>
+// CHECK:    %[[B:.*]] = memref.get_global @b : memref<4xi32>
+// CHECK:    memref.assume_alignment %[[B]], 64 : memref<4xi32>
+// CHECK:    %[[C:.*]] = memref.get_global @c : memref<4xi32>
+// CHECK:    memref.assume_alignment %[[C]], 16 : memref<4xi32>
+// CHECK:    return
+
+module @buffer_alignment {
+ aie.device(xcve2302) {
+  %t33 = aie.tile(3, 3)
+  %a = aie.buffer(%t33) { sym_name = "a", address = 4096 : i32 } : memref<16xi32>
+  %b = aie.buffer(%t33) { sym_name = "b", address = 4160 : i32 } : memref<4xi32>
+  %c = aie.buffer(%t33) { sym_name = "c", address = 4176 : i32 } : memref<4xi32>
+  %core33 = aie.core(%t33) {
+    %0 = arith.constant 0 : index
+    %1 = memref.load %a[%0] : memref<16xi32>
+    memref.store %1, %b[%0] : memref<4xi32>
+    memref.store %1, %c[%0] : memref<4xi32>
+    aie.end
+  }
+ }
+}
@@ -22,33 +22,33 @@ module @test_core_llvm1 {
 // CHECK11:  memref.global "public" @a : memref<256xi32>
 // CHECK11:  func.func @core_1_1() {
 // CHECK11:    %c56 = arith.constant 56 : index
-// CHECK11:    %0 = arith.index_cast %c56 : index to i32
-// CHECK11:    %c0_i32 = arith.constant 0 : i32
-// CHECK11:    call @llvm.aie.lock.acquire.reg(%0, %c0_i32) : (i32, i32) -> ()
-// CHECK11:    %c1_i32 = arith.constant 1 : i32
+// CHECK11:    %[[LOCK0:.*]] = arith.constant 56 : i32
+// CHECK11:    %[[VAL0:.*]] = arith.constant 0 : i32
+// CHECK11:    call @llvm.aie.lock.acquire.reg(%[[LOCK0]], %[[VAL0]]) : (i32, i32) -> ()
+// CHECK11:    %[[ONE:.*]] = arith.constant 1 : i32
 // CHECK11:    %c16 = arith.constant 16 : index
-// CHECK11:    %1 = memref.get_global @a : memref<256xi32>
-// CHECK11:    memref.assume_alignment %1, 32 : memref<256xi32>
-// CHECK11:    memref.store %c1_i32, %1[%c16] : memref<256xi32>
-// CHECK11:    %2 = arith.index_cast %c56 : index to i32
-// CHECK11:    %c1_i32_0 = arith.constant 1 : i32
-// CHECK11:    call @llvm.aie.lock.release.reg(%2, %c1_i32_0) : (i32, i32) -> ()
+// CHECK11:    %[[A:.*]] = memref.get_global @a : memref<256xi32>
+// CHECK11:    memref.assume_alignment %[[A]], 32 : memref<256xi32>
+// CHECK11:    memref.store %[[ONE]], %[[A]][%c16] : memref<256xi32>
+// CHECK11:    %[[LOCK1:.*]] = arith.constant 56 : i32
+// CHECK11:    %[[VAL1:.*]] = arith.constant 1 : i32
+// CHECK11:    call @llvm.aie.lock.release.reg(%[[LOCK1]], %[[VAL1]]) : (i32, i32) -> ()
 // CHECK11:    return
 // CHECK11:  }
 
 // CHECK12:  memref.global "public" @a : memref<256xi32>
 // CHECK12:  func.func @core_1_2() {
 // CHECK12:    %c8 = arith.constant 8 : index
-// CHECK12:    %0 = arith.index_cast %c8 : index to i32
-// CHECK12:    %c1_i32 = arith.constant 1 : i32
-// CHECK12:    call @llvm.aie.lock.acquire.reg(%0, %c1_i32) : (i32, i32) -> ()
+// CHECK12:    %[[LOCK0:.*]] = arith.constant 8 : i32
+// CHECK12:    %[[VAL0:.*]] = arith.constant 1 : i32
+// CHECK12:    call @llvm.aie.lock.acquire.reg(%[[LOCK0]], %[[VAL0]]) : (i32, i32) -> ()
 // CHECK12:    %c16 = arith.constant 16 : index
-// CHECK12:    %1 = memref.get_global @a : memref<256xi32>
-// CHECK12:    memref.assume_alignment %1, 32 : memref<256xi32>
-// CHECK12:    %2 = memref.load %1[%c16] : memref<256xi32>
-// CHECK12:    %3 = arith.index_cast %c8 : index to i32
-// CHECK12:    %c0_i32 = arith.constant 0 : i32
-// CHECK12:    call @llvm.aie.lock.release.reg(%3, %c0_i32) : (i32, i32) -> ()
+// CHECK12:    %[[A:.*]] = memref.get_global @a : memref<256xi32>
+// CHECK12:    memref.assume_alignment %[[A]], 32 : memref<256xi32>
+// CHECK12:    memref.load %[[A]][%c16] : memref<256xi32>
+// CHECK12:    %[[LOCK1:.*]] = arith.constant 8 : i32
+// CHECK12:    %[[VAL1:.*]] = arith.constant 0 : i32
+// CHECK12:    call @llvm.aie.lock.release.reg(%[[LOCK1]], %[[VAL1]]) : (i32, i32) -> ()
 // CHECK12:    return
 // CHECK12:  }
   %tile11 = aie.tile(1, 1)
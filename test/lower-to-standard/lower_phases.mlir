@@ -0,0 +1,47 @@
+//===- lower_phases.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-standard-lowering="tilecol=0 tilerow=2" %s | FileCheck %s
+
+// CHECK-LABEL: func.func @core_0_2() {
+// CHECK:         %[[PHASE:.*]] = memref.load
+// CHECK:         cf.switch %[[PHASE]] : i32, [
+// CHECK-NEXT:      default: ^[[END:.*]],
+// CHECK-NEXT:      0: ^[[CONV:.*]],
+// CHECK-NEXT:      1: ^[[POOL:.*]]
+// CHECK-NEXT:    ]
+// CHECK:       ^[[CONV]]:
+// CHECK-NEXT:    call @conv()
+// CHECK-NEXT:    cf.br ^[[END]]
+// CHECK:       ^[[POOL]]:
+// CHECK-NEXT:    call @pool()
+// CHECK-NEXT:    cf.br ^[[END]]
+// CHECK:       ^[[END]]:
+// CHECK-NEXT:    return
+module @test {
+ aie.device(ipu) {
+  %tile_0_2 = aie.tile(0, 2)
+  %rtp = aie.buffer(%tile_0_2) {sym_name = "rtp"} : memref<16xi32>
+  func.func private @conv()
+  func.func private @pool()
+  %core_0_2 = aie.core(%tile_0_2) {
+    %c0 = arith.constant 0 : index
+    %phase = memref.load %rtp[%c0] : memref<16xi32>
+    aie.phases(%phase) {
+      func.call @conv() : () -> ()
+      aie.end
+    }, {
+      func.call @pool() : () -> ()
+      aie.end
+    }
+    aie.end
+  }
+ }
+}
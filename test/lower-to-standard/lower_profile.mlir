@@ -0,0 +1,50 @@
+//===- lower_profile.mlir --------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-standard-lowering %s | FileCheck %s
+
+// CHECK-LABEL: func.func @core_1_3()
+// CHECK:         %[[E0:.*]] = arith.constant 0 : i32
+// CHECK-NEXT:    call @llvm.aie2.event(%[[E0]])
+// CHECK-NEXT:    call @kernel() : () -> ()
+// CHECK-NEXT:    %[[E1:.*]] = arith.constant 1 : i32
+// CHECK-NEXT:    call @llvm.aie2.event(%[[E1]])
+// CHECK-NEXT:    call @kernel() : () -> ()
+// CHECK:         call @llvm.aie2.event
+// CHECK-NEXT:    scf.for
+// CHECK-NEXT:      call @kernel() : () -> ()
+// CHECK-NEXT:    }
+// CHECK-NEXT:    %[[E1:.*]] = arith.constant 1 : i32
+// CHECK-NEXT:    call @llvm.aie2.event(%[[E1]])
+// CHECK-NOT:     aie.profile
+
+// AIE1 cores call the intrinsic of each event.
+// RUN: sed 's/aie.device(ipu)/aie.device(xcvc1902)/' %s | aie-opt --aie-standard-lowering | FileCheck %s --check-prefix=AIE1
+// AIE1:          call @llvm.aie.event0()
+// AIE1-NEXT:     call @kernel() : () -> ()
+// AIE1-NEXT:     call @llvm.aie.event1()
+
+module @test {
+ aie.device(ipu) {
+  %tile13 = aie.tile(1, 3)
+  func.func private @kernel()
+  %core13 = aie.core(%tile13) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c4 = arith.constant 4 : index
+    func.call @kernel() {aie.profile} : () -> ()
+    func.call @kernel() : () -> ()
+    scf.for %i = %c0 to %c4 step %c1 {
+      func.call @kernel() : () -> ()
+    } {aie.profile}
+    aie.end
+  }
+ }
+}
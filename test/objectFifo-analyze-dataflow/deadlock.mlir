@@ -0,0 +1,125 @@
+//===- deadlock.mlir -------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-analyze-dataflow --split-input-file --verify-diagnostics %s
+
+// The consumer acquires more elements than the depth of @of lets the
+// producer release.
+
+module @acquire_too_many {
+ aie.device(xcve2302) {
+  %tile12 = aie.tile(1, 2)
+  %tile13 = aie.tile(1, 3)
+
+  aie.objectfifo @of (%tile12, {%tile13}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+
+  %core12 = aie.core(%tile12) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %cmax = arith.constant 4294967295 : index
+    scf.for %i = %c0 to %cmax step %c1 {
+      // expected-warning @+1 {{deadlock: core (1, 2) waits forever to acquire 1 element(s) of objectFifo @of}}
+      %sv = aie.objectfifo.acquire @of (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @of (Produce, 1)
+    }
+    aie.end
+  }
+
+  %core13 = aie.core(%tile13) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %cmax = arith.constant 4294967295 : index
+    scf.for %i = %c0 to %cmax step %c1 {
+      // expected-warning @+1 {{deadlock: core (1, 3) waits forever to acquire 3 element(s) of objectFifo @of}}
+      %sv = aie.objectfifo.acquire @of (Consume, 3) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @of (Consume, 3)
+    }
+    aie.end
+  }
+ }
+}
+
+// -----
+
+// The producer stops after 4 elements, the consumer waits for 8.
+
+module @early_end {
+ aie.device(xcve2302) {
+  %tile12 = aie.tile(1, 2)
+  %tile13 = aie.tile(1, 3)
+
+  aie.objectfifo @of (%tile12, {%tile13}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+
+  %core12 = aie.core(%tile12) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c4 = arith.constant 4 : index
+    scf.for %i = %c0 to %c4 step %c1 {
+      %sv = aie.objectfifo.acquire @of (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @of (Produce, 1)
+    }
+    aie.end
+  }
+
+  %core13 = aie.core(%tile13) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c8 = arith.constant 8 : index
+    scf.for %i = %c0 to %c8 step %c1 {
+      // expected-warning @+1 {{deadlock: core (1, 3) waits forever to acquire 1 element(s) of objectFifo @of}}
+      %sv = aie.objectfifo.acquire @of (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @of (Consume, 1)
+    }
+    aie.end
+  }
+ }
+}
+
+// -----
+
+// The producer releases two elements of @b for each one of @a, the consumer
+// one of each.
+
+module @unbalanced {
+ aie.device(xcve2302) {
+  %tile12 = aie.tile(1, 2)
+  %tile13 = aie.tile(1, 3)
+
+  aie.objectfifo @a (%tile12, {%tile13}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+  // expected-warning @+1 {{the rates of objectFifo @b don't balance with the rest of the graph: 2 element(s) released per iteration of core (1, 2), 1 per iteration of core (1, 3); the design deadlocks or accumulates elements}}
+  aie.objectfifo @b (%tile12, {%tile13}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+
+  %core12 = aie.core(%tile12) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %cmax = arith.constant 4294967295 : index
+    scf.for %i = %c0 to %cmax step %c1 {
+      %sa = aie.objectfifo.acquire @a (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @a (Produce, 1)
+      %sb = aie.objectfifo.acquire @b (Produce, 2) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @b (Produce, 2)
+    }
+    aie.end
+  }
+
+  %core13 = aie.core(%tile13) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %cmax = arith.constant 4294967295 : index
+    scf.for %i = %c0 to %cmax step %c1 {
+      %sa = aie.objectfifo.acquire @a (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @a (Consume, 1)
+      %sb = aie.objectfifo.acquire @b (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @b (Consume, 1)
+    }
+    aie.end
+  }
+ }
+}
@@ -0,0 +1,98 @@
+//===- throughput.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-analyze-dataflow --split-input-file --verify-diagnostics %s
+
+// The consumer is three times slower than the producer, which double
+// buffering can't hide.
+
+module @compute_bound {
+ // expected-remark @+1 {{steady-state iteration bound of 301 cycles, limited by core (1, 3)}}
+ aie.device(xcve2302) {
+  %tile12 = aie.tile(1, 2)
+  %tile13 = aie.tile(1, 3)
+
+  aie.objectfifo @of (%tile12, {%tile13}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+
+  func.func private @kernel(%buf : memref<16xi32>) -> ()
+
+  // expected-remark @+1 {{1 core loop iteration(s) per graph iteration, busy 34% of the time}}
+  %core12 = aie.core(%tile12) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %cmax = arith.constant 4294967295 : index
+    scf.for %i = %c0 to %cmax step %c1 {
+      %sv = aie.objectfifo.acquire @of (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %e = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @kernel(%e) {aie.cycles = 100 : i32} : (memref<16xi32>) -> ()
+      aie.objectfifo.release @of (Produce, 1)
+    }
+    aie.end
+  }
+
+  // expected-remark @+1 {{1 core loop iteration(s) per graph iteration, busy 100% of the time}}
+  %core13 = aie.core(%tile13) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %cmax = arith.constant 4294967295 : index
+    scf.for %i = %c0 to %cmax step %c1 {
+      %sv = aie.objectfifo.acquire @of (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %e = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @kernel(%e) {aie.cycles = 300 : i32} : (memref<16xi32>) -> ()
+      aie.objectfifo.release @of (Consume, 1)
+    }
+    aie.end
+  }
+ }
+}
+
+// -----
+
+// With a single element, the producer and the consumer of @of1 take turns.
+
+module @depth_bound {
+ // expected-remark @+1 {{steady-state iteration bound of 202 cycles, limited by objectFifo @of1}}
+ aie.device(xcve2302) {
+  %tile12 = aie.tile(1, 2)
+  %tile13 = aie.tile(1, 3)
+
+  aie.objectfifo @of1 (%tile12, {%tile13}, 1 : i32) : !aie.objectfifo<memref<16xi32>>
+
+  func.func private @kernel(%buf : memref<16xi32>) -> ()
+
+  // expected-remark @+1 {{1 core loop iteration(s) per graph iteration, busy 50% of the time}}
+  %core12 = aie.core(%tile12) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %cmax = arith.constant 4294967295 : index
+    scf.for %i = %c0 to %cmax step %c1 {
+      %sv = aie.objectfifo.acquire @of1 (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %e = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @kernel(%e) {aie.cycles = 100 : i32} : (memref<16xi32>) -> ()
+      aie.objectfifo.release @of1 (Produce, 1)
+    }
+    aie.end
+  }
+
+  // expected-remark @+1 {{1 core loop iteration(s) per graph iteration, busy 50% of the time}}
+  %core13 = aie.core(%tile13) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %cmax = arith.constant 4294967295 : index
+    scf.for %i = %c0 to %cmax step %c1 {
+      %sv = aie.objectfifo.acquire @of1 (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %e = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      func.call @kernel(%e) {aie.cycles = 100 : i32} : (memref<16xi32>) -> ()
+      aie.objectfifo.release @of1 (Consume, 1)
+    }
+    aie.end
+  }
+ }
+}
@@ -0,0 +1,86 @@
+//===- transpose.mlir ------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-propagate-layouts --split-input-file %s | FileCheck %s
+
+// CHECK-LABEL: module @transpose_in_dma
+// CHECK:         aie.objectfifo @rhs(%{{.*}}, {%{{.*}} fromStream [<size = 16, stride = 1>, <size = 16, stride = 16>]}, 2 : i32) : !aie.objectfifo<memref<16x16xi32>>
+// CHECK:         aie.objectfifo @lhs(%{{.*}}, {%{{.*}}}, 2 : i32) : !aie.objectfifo<memref<16x16xi32>>
+// CHECK:         aie.core
+// CHECK:           %[[RHS:.*]] = aie.objectfifo.subview.access %{{.*}}[0] : !aie.objectfifosubview<memref<16x16xi32>> -> memref<16x16xi32>
+// CHECK:           %[[LHS:.*]] = aie.objectfifo.subview.access %{{.*}}[0] : !aie.objectfifosubview<memref<16x16xi32>> -> memref<16x16xi32>
+// CHECK:           vector.transfer_read %[[RHS]][%[[C8:.*]], %[[C0:.*]]], %{{.*}} {in_bounds = [true, true]} : memref<16x16xi32>, vector<4x8xi32>
+// CHECK:           vector.transfer_read %[[RHS]][%[[C4:.*]], %[[C0]]], %{{.*}} {in_bounds = [true, true]} : memref<16x16xi32>, vector<8x4xi32>
+// CHECK-NOT:       vector.transpose
+// CHECK:           memref.load %[[RHS]][%[[C4]], %[[C8]]] : memref<16x16xi32>
+// CHECK:           vector.transfer_read %[[LHS]][%[[C0]], %[[C8]]], %{{.*}} {permutation_map = #{{.*}}} : memref<16x16xi32>, vector<4x8xi32>
+#transpose = affine_map<(d0, d1) -> (d1, d0)>
+module @transpose_in_dma {
+  aie.device(xcve2302) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_1 = aie.tile(0, 1)
+    %tile_0_2 = aie.tile(0, 2)
+    %tile_0_3 = aie.tile(0, 3)
+    aie.objectfifo @rhs(%tile_0_0, {%tile_0_2}, 2 : i32) : !aie.objectfifo<memref<16x16xi32>>
+    // The lhs is produced by a core: transposing it would cost a DMA.
+    aie.objectfifo @lhs(%tile_0_3, {%tile_0_2}, 2 : i32) : !aie.objectfifo<memref<16x16xi32>>
+    %out = aie.buffer(%tile_0_2) : memref<4x8xi32>
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c4 = arith.constant 4 : index
+      %c8 = arith.constant 8 : index
+      %c0_i32 = arith.constant 0 : i32
+      %0 = aie.objectfifo.acquire @rhs(Consume, 1) : !aie.objectfifosubview<memref<16x16xi32>>
+      %rhs = aie.objectfifo.subview.access %0[0] : !aie.objectfifosubview<memref<16x16xi32>> -> memref<16x16xi32>
+      %1 = aie.objectfifo.acquire @lhs(Consume, 1) : !aie.objectfifosubview<memref<16x16xi32>>
+      %lhs = aie.objectfifo.subview.access %1[0] : !aie.objectfifosubview<memref<16x16xi32>> -> memref<16x16xi32>
+      %v0 = vector.transfer_read %rhs[%c0, %c8], %c0_i32 {in_bounds = [true, true], permutation_map = #transpose} : memref<16x16xi32>, vector<4x8xi32>
+      %v1 = vector.transfer_read %rhs[%c0, %c4], %c0_i32 {in_bounds = [true, true]} : memref<16x16xi32>, vector<4x8xi32>
+      %v2 = vector.transpose %v1, [1, 0] : vector<4x8xi32> to vector<8x4xi32>
+      %s = memref.load %rhs[%c8, %c4] : memref<16x16xi32>
+      %v3 = vector.transfer_read %lhs[%c0, %c8], %c0_i32 {permutation_map = #transpose} : memref<16x16xi32>, vector<4x8xi32>
+      vector.transfer_write %v0, %out[%c0, %c0] : vector<4x8xi32>, memref<4x8xi32>
+      vector.transfer_write %v3, %out[%c0, %c0] : vector<4x8xi32>, memref<4x8xi32>
+      %v4 = vector.extract %v2[0] : vector<4xi32> from vector<8x4xi32>
+      %v5 = vector.broadcast %s : i32 to vector<4xi32>
+      %v6 = arith.addi %v4, %v5 : vector<4xi32>
+      vector.transfer_write %v6, %out[%c0, %c0] : vector<4xi32>, memref<4x8xi32>
+      aie.objectfifo.release @rhs(Consume, 1)
+      aie.objectfifo.release @lhs(Consume, 1)
+      aie.end
+    }
+  }
+}
+
+// -----
+
+// The element is passed to a kernel, whose accesses are unknown.
+// CHECK-LABEL: module @kernel_access
+// CHECK:         aie.objectfifo @rhs(%{{.*}}, {%{{.*}}}, 2 : i32)
+module @kernel_access {
+  aie.device(xcve2302) {
+    func.func private @kernel(memref<16x16xi32>)
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_2 = aie.tile(0, 2)
+    aie.objectfifo @rhs(%tile_0_0, {%tile_0_2}, 2 : i32) : !aie.objectfifo<memref<16x16xi32>>
+    %out = aie.buffer(%tile_0_2) : memref<4x8xi32>
+    %core_0_2 = aie.core(%tile_0_2) {
+      %c0 = arith.constant 0 : index
+      %c0_i32 = arith.constant 0 : i32
+      %0 = aie.objectfifo.acquire @rhs(Consume, 1) : !aie.objectfifosubview<memref<16x16xi32>>
+      %rhs = aie.objectfifo.subview.access %0[0] : !aie.objectfifosubview<memref<16x16xi32>> -> memref<16x16xi32>
+      %v0 = vector.transfer_read %rhs[%c0, %c0], %c0_i32 {permutation_map = affine_map<(d0, d1) -> (d1, d0)>} : memref<16x16xi32>, vector<4x8xi32>
+      vector.transfer_write %v0, %out[%c0, %c0] : vector<4x8xi32>, memref<4x8xi32>
+      func.call @kernel(%rhs) : (memref<16x16xi32>) -> ()
+      aie.objectfifo.release @rhs(Consume, 1)
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,35 @@
+//===- balance_shim_dmas_test.mlir -----------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform="balance-shim-dmas=true" %s | FileCheck %s
+
+// All the inputs are declared on the shim tile of column 2. The second large
+// input moves to the idle shim tile of column 3, while the small input stays
+// on column 2, which then moves as many bytes as column 3.
+
+// CHECK-DAG: aie.flow(%{{.*}}tile_2_0, DMA : 0, %{{.*}}tile_2_2, DMA : 0)
+// CHECK-DAG: aie.flow(%{{.*}}tile_2_0, DMA : 1, %{{.*}}tile_3_2, DMA : 0)
+// CHECK-DAG: aie.flow(%{{.*}}tile_3_0, DMA : 0, %{{.*}}tile_3_2, DMA : 1)
+// CHECK-DAG: aie.shim_dma_allocation @big_in(MM2S, 0, 2)
+// CHECK-DAG: aie.shim_dma_allocation @big_in2(MM2S, 0, 3)
+// CHECK-DAG: aie.shim_dma_allocation @small_in(MM2S, 1, 2)
+
+module @balance_shim_dmas {
+  aie.device(xcve2302) {
+    %tile20 = aie.tile(2, 0)
+    %tile30 = aie.tile(3, 0)
+    %tile22 = aie.tile(2, 2)
+    %tile32 = aie.tile(3, 2)
+
+    aie.objectfifo @big_in (%tile20, {%tile22}, 2 : i32) : !aie.objectfifo<memref<1024xi32>>
+    aie.objectfifo @small_in (%tile20, {%tile32}, 2 : i32) : !aie.objectfifo<memref<64xi32>>
+    aie.objectfifo @big_in2 (%tile20, {%tile32}, 2 : i32) : !aie.objectfifo<memref<1024xi32>>
+  }
+}
@@ -0,0 +1,53 @@
+//===- coalesce_locks_AIE2.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform=coalesce-locks %s | FileCheck %s
+
+// The two releases of the consumer are merged into one, the acquires of the
+// producer are not as a release of another lock separates them.
+
+// CHECK-LABEL: module @coalesce_locks
+// CHECK:   %[[of_prod_lock:.*]] = aie.lock(%{{.*}}tile_1_2, 0) {init = 2 : i32, sym_name = "of_prod_lock"}
+// CHECK:   %[[of_cons_lock:.*]] = aie.lock(%{{.*}}tile_1_2, 1) {init = 0 : i32, sym_name = "of_cons_lock"}
+// CHECK:   aie.core(%{{.*}}tile_1_2) {
+// CHECK:     aie.use_lock(%[[of_prod_lock]], AcquireGreaterEqual, 1)
+// CHECK:     aie.use_lock(%[[of_cons_lock]], Release, 1)
+// CHECK:     aie.use_lock(%[[of_prod_lock]], AcquireGreaterEqual, 1)
+// CHECK:     aie.use_lock(%[[of_cons_lock]], Release, 1)
+// CHECK:     aie.end
+// CHECK:   aie.core(%{{.*}}tile_1_3) {
+// CHECK:     aie.use_lock(%[[of_cons_lock]], AcquireGreaterEqual, 2)
+// CHECK:     aie.use_lock(%[[of_prod_lock]], Release, 2)
+// CHECK-NOT: aie.use_lock
+// CHECK:     aie.end
+
+module @coalesce_locks {
+  aie.device(xcve2302) {
+    %tile12 = aie.tile(1, 2)
+    %tile13 = aie.tile(1, 3)
+
+    aie.objectfifo @of (%tile12, {%tile13}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+
+    %core12 = aie.core(%tile12) {
+      %0 = aie.objectfifo.acquire @of (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @of (Produce, 1)
+      %1 = aie.objectfifo.acquire @of (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @of (Produce, 1)
+      aie.end
+    }
+
+    %core13 = aie.core(%tile13) {
+      %0 = aie.objectfifo.acquire @of (Consume, 2) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @of (Consume, 1)
+      aie.objectfifo.release @of (Consume, 1)
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,33 @@
+//===- compression_AIE2.mlir -----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform %s | FileCheck %s
+
+// The tiles are adjacent, but the compressed objectFifo goes through their
+// DMAs: the producer compresses and the consumer decompresses.
+
+// CHECK-DAG: %[[of0_buff_0:.*]] = aie.buffer(%{{.*}}) {sym_name = "of0_buff_0"} : memref<256xi8>
+// CHECK-DAG: %[[of0_cons_buff_0:.*]] = aie.buffer(%{{.*}}) {sym_name = "of0_cons_buff_0"} : memref<256xi8>
+// CHECK: aie.flow(%{{.*}}, DMA : 0, %{{.*}}, DMA : 0)
+// CHECK: aie.mem
+// CHECK: aie.dma_start(MM2S, 0
+// CHECK: aie.dma_bd(%[[of0_buff_0]] : memref<256xi8>, 0, 256) {compression}
+// CHECK: aie.mem
+// CHECK: aie.dma_start(S2MM, 0
+// CHECK: aie.dma_bd(%[[of0_cons_buff_0]] : memref<256xi8>, 0, 256) {compression}
+
+module @compressionAIE2 {
+ aie.device(xcve2302) {
+    %tile12 = aie.tile(1, 2)
+    %tile13 = aie.tile(1, 3)
+
+    aie.objectfifo @of0 (%tile12, {%tile13}, 2 : i32) {compression} : !aie.objectfifo<memref<256xi8>>
+ }
+}
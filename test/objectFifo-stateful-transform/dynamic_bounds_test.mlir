@@ -0,0 +1,79 @@
+//===- dynamic_bounds_test.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform --split-input-file --verify-diagnostics %s | FileCheck %s
+
+// The number of iterations is read from a runtime parameter: the loop is
+// unrolled twice, for the two elements of the objectFifo, and runs the pairs
+// of iterations it contains.
+// CHECK:     %[[BUFF0:.*]] = aie.buffer(%{{.*}}) {sym_name = "fifo_cons_buff_0"} : memref<16xi32>
+// CHECK:     %[[BUFF1:.*]] = aie.buffer(%{{.*}}) {sym_name = "fifo_cons_buff_1"} : memref<16xi32>
+// CHECK:     aie.core(%{{.*}}) {
+// CHECK:       %[[C0:.*]] = arith.constant 0 : index
+// CHECK:       %[[N:.*]] = arith.index_cast
+// CHECK:       %[[STEP:.*]] = arith.constant 2 : index
+// CHECK:       %[[D:.*]] = arith.subi %[[N]], %[[C0]] : index
+// CHECK:       %[[PAIRS:.*]] = arith.divui %[[D]], %[[STEP]] : index
+// CHECK:       %[[U:.*]] = arith.muli %[[PAIRS]], %[[STEP]] : index
+// CHECK:       %[[UB:.*]] = arith.addi %[[C0]], %[[U]] : index
+// CHECK:       scf.for %{{.*}} = %[[C0]] to %[[UB]] step %[[STEP]] {
+// CHECK:         memref.load %[[BUFF0]]
+// CHECK:         memref.load %[[BUFF1]]
+// CHECK:       }
+// CHECK-NEXT:  aie.end
+
+module @dynamic_bounds {
+ aie.device(xcve2302) {
+  %tile12 = aie.tile(1, 2)
+  %tile13 = aie.tile(1, 3)
+  %rtp = aie.buffer(%tile13) {sym_name = "rtp"} : memref<16xi32>
+
+  aie.objectfifo @fifo (%tile12, {%tile13}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+
+  %core13 = aie.core(%tile13) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %count = memref.load %rtp[%c0] : memref<16xi32>
+    %n = arith.index_cast %count : i32 to index
+    scf.for %i = %c0 to %n step %c1 {
+      %sv = aie.objectfifo.acquire @fifo (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %e = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      %x = memref.load %e[%c0] : memref<16xi32>
+      aie.objectfifo.release @fifo (Consume, 1)
+    }
+    aie.end
+  }
+ }
+}
+
+// -----
+
+module @dynamic_step {
+ aie.device(xcve2302) {
+  %tile12 = aie.tile(1, 2)
+  %tile13 = aie.tile(1, 3)
+  %rtp = aie.buffer(%tile13) {sym_name = "rtp"} : memref<16xi32>
+
+  aie.objectfifo @fifo (%tile12, {%tile13}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+
+  %core13 = aie.core(%tile13) {
+    %c0 = arith.constant 0 : index
+    %c8 = arith.constant 8 : index
+    %count = memref.load %rtp[%c0] : memref<16xi32>
+    %step = arith.index_cast %count : i32 to index
+    // expected-error@+1 {{accesses objectFifos, its step must be a constant to be unrolled}}
+    scf.for %i = %c0 to %c8 step %step {
+      %sv = aie.objectfifo.acquire @fifo (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+      aie.objectfifo.release @fifo (Consume, 1)
+    }
+    aie.end
+  }
+ }
+}
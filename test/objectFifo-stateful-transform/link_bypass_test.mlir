@@ -0,0 +1,48 @@
+//===- link_bypass_test.mlir -----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform="bypass-pass-through-links=true" %s | FileCheck %s
+
+// The link through the memtile only forwards the elements of @to_memTile,
+// so @from_memTile is fed directly by the shim tile.
+// CHECK-LABEL:   aie.device(xcve2302) {
+// CHECK-NOT:       @to_memTile
+// CHECK:           memref.global "public" @from_memTile_cons : memref<16xi32>
+// CHECK:           memref.global "public" @from_memTile : memref<16xi32>
+// CHECK:           %[[SHIM:.*]] = aie.tile(2, 0)
+// CHECK:           %[[MEM:.*]] = aie.tile(2, 1)
+// CHECK:           %[[CORE:.*]] = aie.tile(2, 2)
+// CHECK:           aie.buffer(%[[CORE]]) {sym_name = "from_memTile_cons_buff_0"} : memref<16xi32>
+// CHECK:           aie.buffer(%[[CORE]]) {sym_name = "from_memTile_cons_buff_1"} : memref<16xi32>
+// CHECK:           aie.lock(%[[CORE]], 0) {init = 2 : i32, sym_name = "from_memTile_cons_prod_lock"}
+// CHECK:           aie.lock(%[[CORE]], 1) {init = 0 : i32, sym_name = "from_memTile_cons_cons_lock"}
+// CHECK:           aie.lock(%[[SHIM]], 0) {init = 1 : i32, sym_name = "from_memTile_prod_lock"}
+// CHECK:           aie.lock(%[[SHIM]], 1) {init = 0 : i32, sym_name = "from_memTile_cons_lock"}
+// CHECK:           aie.flow(%[[SHIM]], DMA : 0, %[[CORE]], DMA : 0)
+// CHECK:           aie.external_buffer {sym_name = "ext_buff_in"} : memref<16xi32>
+// CHECK:           aie.shim_dma_allocation @from_memTile(MM2S, 0, 2)
+// CHECK:           aie.shim_dma(%[[SHIM]]) {
+// CHECK-NOT:       aie.memtile_dma
+// CHECK:           aie.mem(%[[CORE]]) {
+
+module @link_bypass {
+    aie.device(xcve2302) {
+        %tile20 = aie.tile(2, 0)
+        %tile21 = aie.tile(2, 1)
+        %tile22 = aie.tile(2, 2)
+
+        aie.objectfifo @to_memTile (%tile20, {%tile21}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+        aie.objectfifo @from_memTile (%tile21, {%tile22}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+        aie.objectfifo.link [@to_memTile] -> [@from_memTile] ()
+
+        %ext_buff_in = aie.external_buffer {sym_name = "ext_buff_in"}: memref<16xi32>
+        aie.objectfifo.register_external_buffers @to_memTile (%tile20, {%ext_buff_in}) : (memref<16xi32>)
+    }
+}
@@ -0,0 +1,58 @@
+//===- link_test_offsets.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt %s | FileCheck %s --check-prefix=ROUNDTRIP
+// RUN: aie-opt --aie-objectFifo-stateful-transform %s | FileCheck %s
+
+// An uneven distribute and join at explicit offsets: each part keeps a
+// channel of the memtile, and its BDs read or write its offset in the
+// buffers of the larger objectFifo.
+
+// ROUNDTRIP: aie.objectfifo.link [@dist_in] -> [@dist_out0, @dist_out1]{{ ?}}(offsets [56, 0])
+// ROUNDTRIP: aie.objectfifo.link [@join_in0, @join_in1] -> [@join_out]{{ ?}}(offsets [24, 0])
+
+// CHECK-LABEL: aie.device(xcve2302)
+// CHECK:         aie.memtile_dma
+// CHECK:           aie.dma_start(S2MM, 0
+// CHECK:           aie.dma_bd(%{{.*}} : memref<96xi32>, 0, 96)
+// CHECK:           aie.dma_start(MM2S, 0
+// CHECK:           aie.dma_bd(%{{.*}} : memref<96xi32>, 224, 40)
+// CHECK:           aie.dma_start(MM2S, 1
+// CHECK:           aie.dma_bd(%{{.*}} : memref<96xi32>, 0, 56)
+// CHECK:         aie.memtile_dma
+// CHECK:           aie.dma_start(S2MM, 0
+// CHECK:           aie.dma_bd(%{{.*}} : memref<32xi32>, 96, 8)
+// CHECK:           aie.dma_start(S2MM, 1
+// CHECK:           aie.dma_bd(%{{.*}} : memref<32xi32>, 0, 24)
+// CHECK:           aie.dma_start(MM2S, 0
+// CHECK:           aie.dma_bd(%{{.*}} : memref<32xi32>, 0, 32)
+
+module @link_offsets {
+  aie.device(xcve2302) {
+    %tile20 = aie.tile(2, 0)
+    %tile21 = aie.tile(2, 1)
+    %tile22 = aie.tile(2, 2)
+    %tile23 = aie.tile(2, 3)
+    %tile30 = aie.tile(3, 0)
+    %tile31 = aie.tile(3, 1)
+    %tile32 = aie.tile(3, 2)
+    %tile33 = aie.tile(3, 3)
+
+    aie.objectfifo @dist_in (%tile20, {%tile21}, 2 : i32) : !aie.objectfifo<memref<96xi32>>
+    aie.objectfifo @dist_out0 (%tile21, {%tile22}, 2 : i32) : !aie.objectfifo<memref<40xi32>>
+    aie.objectfifo @dist_out1 (%tile21, {%tile23}, 2 : i32) : !aie.objectfifo<memref<56xi32>>
+    aie.objectfifo.link [@dist_in] -> [@dist_out0, @dist_out1] (offsets [56, 0])
+
+    aie.objectfifo @join_in0 (%tile32, {%tile31}, 2 : i32) : !aie.objectfifo<memref<8xi32>>
+    aie.objectfifo @join_in1 (%tile33, {%tile31}, 2 : i32) : !aie.objectfifo<memref<24xi32>>
+    aie.objectfifo @join_out (%tile31, {%tile30}, 2 : i32) : !aie.objectfifo<memref<32xi32>>
+    aie.objectfifo.link [@join_in0, @join_in1] -> [@join_out] (offsets [24, 0])
+  }
+}
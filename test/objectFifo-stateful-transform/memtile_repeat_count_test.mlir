@@ -0,0 +1,68 @@
+//===- memtile_repeat_count_test.mlir --------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform %s | FileCheck %s
+
+// The memtile sends each element of @weights twice before the shim refills
+// it: its locks count sends, and the MM2S has one BD per send.
+
+// CHECK-LABEL:   aie.device(xcve2302) {
+// CHECK-DAG:       %[[BUFF_0:.*]] = aie.buffer(%{{.*}}tile_0_1) {sym_name = "weights_in_cons_buff_0"} : memref<256xi32>
+// CHECK-DAG:       %[[BUFF_1:.*]] = aie.buffer(%{{.*}}tile_0_1) {sym_name = "weights_in_cons_buff_1"} : memref<256xi32>
+// CHECK-DAG:       %[[PROD_LOCK:.*]] = aie.lock(%{{.*}}tile_0_1, {{.*}}) {init = 4 : i32, sym_name = "weights_in_cons_prod_lock"}
+// CHECK-DAG:       %[[CONS_LOCK:.*]] = aie.lock(%{{.*}}tile_0_1, {{.*}}) {init = 0 : i32, sym_name = "weights_in_cons_cons_lock"}
+// CHECK:           aie.memtile_dma(%{{.*}}tile_0_1) {
+// CHECK:             aie.dma_start(S2MM, 0, ^bb1, ^bb3)
+// CHECK:           ^bb1:
+// CHECK:             aie.use_lock(%[[PROD_LOCK]], AcquireGreaterEqual, 2)
+// CHECK:             aie.dma_bd(%[[BUFF_0]] : memref<256xi32>, 0, 256)
+// CHECK:             aie.use_lock(%[[CONS_LOCK]], Release, 2)
+// CHECK:             aie.next_bd ^bb2
+// CHECK:           ^bb2:
+// CHECK:             aie.use_lock(%[[PROD_LOCK]], AcquireGreaterEqual, 2)
+// CHECK:             aie.dma_bd(%[[BUFF_1]] : memref<256xi32>, 0, 256)
+// CHECK:             aie.use_lock(%[[CONS_LOCK]], Release, 2)
+// CHECK:             aie.next_bd ^bb1
+// CHECK:           ^bb3:
+// CHECK:             aie.dma_start(MM2S, 0, ^bb4, ^bb8)
+// CHECK:           ^bb4:
+// CHECK:             aie.use_lock(%[[CONS_LOCK]], AcquireGreaterEqual, 1)
+// CHECK:             aie.dma_bd(%[[BUFF_0]] : memref<256xi32>, 0, 256)
+// CHECK:             aie.use_lock(%[[PROD_LOCK]], Release, 1)
+// CHECK:             aie.next_bd ^bb5
+// CHECK:           ^bb5:
+// CHECK:             aie.use_lock(%[[CONS_LOCK]], AcquireGreaterEqual, 1)
+// CHECK:             aie.dma_bd(%[[BUFF_0]] : memref<256xi32>, 0, 256)
+// CHECK:             aie.use_lock(%[[PROD_LOCK]], Release, 1)
+// CHECK:             aie.next_bd ^bb6
+// CHECK:           ^bb6:
+// CHECK:             aie.use_lock(%[[CONS_LOCK]], AcquireGreaterEqual, 1)
+// CHECK:             aie.dma_bd(%[[BUFF_1]] : memref<256xi32>, 0, 256)
+// CHECK:             aie.use_lock(%[[PROD_LOCK]], Release, 1)
+// CHECK:             aie.next_bd ^bb7
+// CHECK:           ^bb7:
+// CHECK:             aie.use_lock(%[[CONS_LOCK]], AcquireGreaterEqual, 1)
+// CHECK:             aie.dma_bd(%[[BUFF_1]] : memref<256xi32>, 0, 256)
+// CHECK:             aie.use_lock(%[[PROD_LOCK]], Release, 1)
+// CHECK:             aie.next_bd ^bb4
+// CHECK:           ^bb8:
+// CHECK:             aie.end
+// CHECK:           }
+
+module @memtile_repeat_count {
+  aie.device(xcve2302) {
+    %tile_0_0 = aie.tile(0, 0)
+    %tile_0_1 = aie.tile(0, 1)
+    %tile_0_2 = aie.tile(0, 2)
+    aie.objectfifo @weights_in (%tile_0_0, {%tile_0_1}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+    aie.objectfifo @weights (%tile_0_1, {%tile_0_2}, 2 : i32) {repeat_count = 2 : i32} : !aie.objectfifo<memref<256xi32>>
+    aie.objectfifo.link [@weights_in] -> [@weights] ()
+  }
+}
@@ -0,0 +1,51 @@
+//===- nd_dma_distribute_dims_AIE2.mlir ------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform %s | FileCheck %s
+
+// Data layout transformations apply on every endpoint of a distribute link:
+// when the memtile receives @of0, when it sends the broadcast @of1, and when
+// (2, 3) receives @of2.
+// CHECK:     %[[tile_1_1:.*]] = aie.tile(1, 1)
+// CHECK:     %[[tile_2_3:.*]] = aie.tile(2, 3)
+// CHECK:     aie.memtile_dma(%[[tile_1_1]]) {
+// CHECK:       aie.dma_start(S2MM, 0, ^bb1, ^bb3)
+// CHECK:       aie.dma_bd(%{{.*}} : memref<256xi32>, 0, 256, [<size = 32, stride = 8>, <size = 8, stride = 1>])
+// CHECK:       aie.dma_start(MM2S, 0, ^bb4, ^bb6)
+// CHECK:       aie.dma_bd(%{{.*}} : memref<256xi32>, 0, 128, [<size = 8, stride = 16>, <size = 16, stride = 1>])
+// CHECK:       aie.dma_start(MM2S, 1, ^bb7, ^bb9)
+// CHECK:       aie.dma_bd(%{{.*}} : memref<256xi32>, 512, 128)
+// CHECK:     aie.mem(%[[tile_2_3]]) {
+// CHECK:       aie.dma_start(S2MM, 0, ^bb1, ^bb3)
+// CHECK:       aie.dma_bd(%{{.*}} : memref<128xi32>, 0, 128, [<size = 16, stride = 8>, <size = 8, stride = 1>])
+
+module @ndDMADistributeDimsAIE2 {
+ aie.device(xcve2302) {
+    %tile10 = aie.tile(1, 0)
+    %tile11 = aie.tile(1, 1)
+    %tile12 = aie.tile(1, 2)
+    %tile22 = aie.tile(2, 2)
+    %tile23 = aie.tile(2, 3)
+
+    aie.objectfifo @of0 (%tile10, {%tile11 fromStream [<size = 32, stride = 8>,
+                                                       <size = 8, stride = 1>]},
+                         2 : i32) : !aie.objectfifo<memref<256xi32>>
+
+    aie.objectfifo @of1 (%tile11 toStream [<size = 8, stride = 16>,
+                                           <size = 16, stride = 1>],
+                        {%tile12, %tile22}, 2 : i32) : !aie.objectfifo<memref<128xi32>>
+
+    aie.objectfifo @of2 (%tile11, {%tile23 fromStream [<size = 16, stride = 8>,
+                                                       <size = 8, stride = 1>]},
+                         2 : i32) : !aie.objectfifo<memref<128xi32>>
+
+   aie.objectfifo.link [ @of0 ] -> [ @of1, @of2 ] ()
+ }
+}
@@ -0,0 +1,47 @@
+//===- nd_dma_padding_AIE2.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform %s | FileCheck %s
+
+// The memtile holds the 4x8 blocks as they arrive and pads them to 5x10 when
+// sending them to the core.
+
+// CHECK-DAG: %[[of1_cons_buff_0:.*]] = aie.buffer(%{{.*}}) {sym_name = "of1_cons_buff_0"} : memref<50xi32>
+// CHECK-DAG: %[[of0_cons_buff_0:.*]] = aie.buffer(%{{.*}}) {sym_name = "of0_cons_buff_0"} : memref<32xi32>
+// CHECK-DAG: %[[of0_cons_buff_1:.*]] = aie.buffer(%{{.*}}) {sym_name = "of0_cons_buff_1"} : memref<32xi32>
+// CHECK: aie.memtile_dma
+// CHECK: aie.dma_start(S2MM, 0
+// CHECK: aie.dma_bd(%[[of0_cons_buff_0]] : memref<32xi32>, 0, 32)
+// CHECK: aie.dma_bd(%[[of0_cons_buff_1]] : memref<32xi32>, 0, 32)
+// CHECK: aie.dma_start(MM2S, 0
+// CHECK: aie.dma_bd(%[[of0_cons_buff_0]] : memref<32xi32>, 0, 50, [<size = 4, stride = 8>, <size = 8, stride = 1>], [<const_pad_before = 0, const_pad_after = 1>, <const_pad_before = 1, const_pad_after = 1>])
+// CHECK: aie.dma_bd(%[[of0_cons_buff_1]] : memref<32xi32>, 0, 50, [<size = 4, stride = 8>, <size = 8, stride = 1>], [<const_pad_before = 0, const_pad_after = 1>, <const_pad_before = 1, const_pad_after = 1>])
+// CHECK: aie.mem
+// CHECK: aie.dma_start(S2MM, 0
+// CHECK: aie.dma_bd(%[[of1_cons_buff_0]] : memref<50xi32>, 0, 50)
+
+module @ndDMAPaddingAIE2 {
+ aie.device(xcve2302) {
+    %tile10 = aie.tile(1, 0)
+    %tile11 = aie.tile(1, 1)
+    %tile22 = aie.tile(2, 2)
+
+    aie.objectfifo @of0 (%tile10, {%tile11},
+                         2 : i32) : !aie.objectfifo<memref<32xi32>>
+
+    aie.objectfifo @of1 (%tile11 toStream [<size = 4, stride = 8>,
+                                           <size = 8, stride = 1>],
+                         {%tile22}, 2 : i32)
+                        {padDimensions = #aie<bd_pad_layout_arr[<const_pad_before = 0, const_pad_after = 1>,
+                                                                <const_pad_before = 1, const_pad_after = 1>]>}
+                        : !aie.objectfifo<memref<50xi32>>
+   aie.objectfifo.link [ @of0 ] -> [ @of1 ] ()
+ }
+}
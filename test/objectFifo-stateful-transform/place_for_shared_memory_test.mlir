@@ -0,0 +1,47 @@
+//===- place_for_shared_memory_test.mlir -----------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform="place-for-shared-memory=true diagnose-dma-fifos=true" --verify-diagnostics %s | FileCheck %s
+
+// The consumer of @of moves next to its producer and @of uses shared memory.
+// The core of the consumer of @pinned accesses the memory of (5, 3), so the
+// tile stays in place and @pinned keeps its DMAs.
+
+// CHECK:     aie.tile(1, 3)
+// CHECK:     aie.tile(5, 2)
+// CHECK-NOT: of_cons
+// CHECK:     aie.buffer({{.*}}) {sym_name = "pinned_cons_buff_0"}
+// CHECK-NOT: of_cons
+
+module @place_for_shared_memory {
+ aie.device(xcve2302) {
+  %tile12 = aie.tile(1, 2)
+  %tile43 = aie.tile(4, 3)
+  %tile72 = aie.tile(7, 2)
+  %tile52 = aie.tile(5, 2)
+  %tile53 = aie.tile(5, 3)
+  %buf53 = aie.buffer(%tile53) {sym_name = "buf53"} : memref<16xi32>
+
+  // expected-remark@+1 {{moved the consumer tile from (4, 3) to (1, 3) to use shared memory}}
+  aie.objectfifo @of (%tile12, {%tile43}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+  // expected-warning@+1 {{uses DMAs because its producer tile (7, 2) and consumer tile (5, 2) don't share memory}}
+  aie.objectfifo @pinned (%tile72, {%tile52}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+
+  %core52 = aie.core(%tile52) {
+    %c0 = arith.constant 0 : index
+    %subview = aie.objectfifo.acquire @pinned (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+    %elem = aie.objectfifo.subview.access %subview[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+    %v = memref.load %elem[%c0] : memref<16xi32>
+    memref.store %v, %buf53[%c0] : memref<16xi32>
+    aie.objectfifo.release @pinned (Consume, 1)
+    aie.end
+  }
+ }
+}
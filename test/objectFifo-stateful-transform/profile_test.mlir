@@ -0,0 +1,83 @@
+//===- profile_test.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (C) 2024, Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// This tests the profiling of objectFifo acquires: the use_lock operations of
+// each acquire are bracketed by the two instruction events of the core, and
+// the profile map lists the objectFifos timed by the counter of each core.
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform="profile=true profile-map=%t.map" %s | FileCheck %s
+// RUN: FileCheck %s --check-prefix=MAP < %t.map
+// RUN: aie-opt --aie-objectFifo-stateful-transform="profile=true profile-fifo=b" %s | FileCheck %s --check-prefix=FIFO
+
+// CHECK:     %[[APL:.*]] = aie.lock(%{{.*}}, 0) {init = 2 : i32, sym_name = "a_prod_lock"}
+// CHECK:     %[[ACL:.*]] = aie.lock(%{{.*}}, 1) {init = 0 : i32, sym_name = "a_cons_lock"}
+// CHECK:     %[[BPL:.*]] = aie.lock(%{{.*}}, 0) {init = 2 : i32, sym_name = "b_prod_lock"}
+// CHECK:     %[[BCL:.*]] = aie.lock(%{{.*}}, 1) {init = 0 : i32, sym_name = "b_cons_lock"}
+// CHECK:     aie.core
+// CHECK:       aie.event(0)
+// CHECK-NEXT:  aie.use_lock(%[[APL]], AcquireGreaterEqual, 1)
+// CHECK-NEXT:  aie.event(1)
+// CHECK:       aie.use_lock(%[[ACL]], Release, 1)
+// CHECK-NEXT:  aie.event(0)
+// CHECK-NEXT:  aie.use_lock(%[[BCL]], AcquireGreaterEqual, 1)
+// CHECK-NEXT:  aie.event(1)
+// CHECK:       aie.use_lock(%[[BPL]], Release, 1)
+// CHECK:     aie.core
+// CHECK:       aie.event(0)
+// CHECK-NEXT:  aie.use_lock(%[[ACL]], AcquireGreaterEqual, 1)
+// CHECK-NEXT:  aie.event(1)
+// CHECK:       aie.event(0)
+// CHECK-NEXT:  aie.use_lock(%[[BPL]], AcquireGreaterEqual, 1)
+// CHECK-NEXT:  aie.event(1)
+
+// MAP: 2 2 0 a,b
+// MAP: 2 3 0 a,b
+
+// FIFO:     aie.core
+// FIFO-NOT:   aie.event
+// FIFO:       aie.use_lock(%{{.*}}, Release, 1)
+// FIFO-NEXT:  aie.event(0)
+// FIFO-NEXT:  aie.use_lock(%{{.*}}, AcquireGreaterEqual, 1)
+// FIFO-NEXT:  aie.event(1)
+// FIFO:     aie.core
+// FIFO-NOT:   aie.event
+// FIFO:       aie.event(0)
+// FIFO-NEXT:  aie.use_lock(%{{.*}}, AcquireGreaterEqual, 1)
+// FIFO-NEXT:  aie.event(1)
+
+module @profile {
+    aie.device(xcve2302) {
+        %tile22 = aie.tile(2, 2)
+        %tile23 = aie.tile(2, 3)
+
+        aie.objectfifo @a (%tile22, {%tile23}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+        aie.objectfifo @b (%tile23, {%tile22}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+
+        %core22 = aie.core(%tile22) {
+            %subviewA = aie.objectfifo.acquire @a (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+            %elemA = aie.objectfifo.subview.access %subviewA[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+            aie.objectfifo.release @a (Produce, 1)
+            %subviewB = aie.objectfifo.acquire @b (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+            %elemB = aie.objectfifo.subview.access %subviewB[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+            aie.objectfifo.release @b (Consume, 1)
+            aie.end
+        }
+
+        %core23 = aie.core(%tile23) {
+            %subviewA = aie.objectfifo.acquire @a (Consume, 1) : !aie.objectfifosubview<memref<16xi32>>
+            %elemA = aie.objectfifo.subview.access %subviewA[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+            %subviewB = aie.objectfifo.acquire @b (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+            %elemB = aie.objectfifo.subview.access %subviewB[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+            aie.objectfifo.release @a (Consume, 1)
+            aie.objectfifo.release @b (Produce, 1)
+            aie.end
+        }
+    }
+}
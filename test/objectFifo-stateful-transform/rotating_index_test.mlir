@@ -0,0 +1,85 @@
+//===- rotating_index_test.mlir --------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform="rotating-index=true" %s | FileCheck %s
+
+// The loops of both cores are kept rolled: the producer selects the buffer
+// of element %i mod 3, and the consumer, which takes two elements per
+// iteration, elements 2 * %i mod 3 and 2 * %i + 1 mod 3.
+// CHECK:     %[[BUFF0:.*]] = aie.buffer(%{{.*}}) {sym_name = "fifo_buff_0"} : memref<16xi32>
+// CHECK:     %[[BUFF1:.*]] = aie.buffer(%{{.*}}) {sym_name = "fifo_buff_1"} : memref<16xi32>
+// CHECK:     %[[BUFF2:.*]] = aie.buffer(%{{.*}}) {sym_name = "fifo_buff_2"} : memref<16xi32>
+// CHECK:     %[[PL:.*]] = aie.lock(%{{.*}}, 0) {init = 3 : i32, sym_name = "fifo_prod_lock"}
+// CHECK:     %[[CL:.*]] = aie.lock(%{{.*}}, 1) {init = 0 : i32, sym_name = "fifo_cons_lock"}
+// CHECK:     aie.core(%{{.*}}) {
+// CHECK:       scf.for %[[I:.*]] = %[[LB:.*]] to %{{.*}} step %[[STEP:.*]] {
+// CHECK:         aie.use_lock(%[[PL]], AcquireGreaterEqual, 1)
+// CHECK:         %[[D:.*]] = arith.subi %[[I]], %[[LB]] : index
+// CHECK:         %[[K:.*]] = arith.divui %[[D]], %[[STEP]] : index
+// CHECK:         %[[OFFSET:.*]] = arith.muli %[[K]], %{{.*}} : index
+// CHECK:         %[[POS:.*]] = arith.addi %[[OFFSET]], %{{.*}} : index
+// CHECK:         %[[SEL:.*]] = arith.remui %[[POS]], %{{.*}} : index
+// CHECK:         %[[ELEM:.*]] = scf.index_switch %[[SEL]] -> memref<16xi32>
+// CHECK:         case 0 {
+// CHECK:           scf.yield %[[BUFF0]] : memref<16xi32>
+// CHECK:         case 1 {
+// CHECK:           scf.yield %[[BUFF1]] : memref<16xi32>
+// CHECK:         case 2 {
+// CHECK:           scf.yield %[[BUFF2]] : memref<16xi32>
+// CHECK:         memref.store %{{.*}}, %[[ELEM]][%{{.*}}] : memref<16xi32>
+// CHECK:         aie.use_lock(%[[CL]], Release, 1)
+// CHECK:       }
+// CHECK:       aie.end
+// CHECK:     aie.core(%{{.*}}) {
+// CHECK:       scf.for
+// CHECK:         aie.use_lock(%[[CL]], AcquireGreaterEqual, 2)
+// CHECK-COUNT-2: scf.index_switch
+// CHECK:         aie.use_lock(%[[PL]], Release, 2)
+// CHECK:       }
+// CHECK-NOT:   scf.for
+// CHECK:       aie.end
+
+module @rotating_index {
+ aie.device(xcve2302) {
+  %tile22 = aie.tile(2, 2)
+  %tile23 = aie.tile(2, 3)
+
+  aie.objectfifo @fifo (%tile22, {%tile23}, 3 : i32) : !aie.objectfifo<memref<16xi32>>
+
+  %core22 = aie.core(%tile22) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c12 = arith.constant 12 : index
+    %v = arith.constant 1 : i32
+    scf.for %i = %c0 to %c12 step %c1 {
+      %sv = aie.objectfifo.acquire @fifo (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %e = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      memref.store %v, %e[%c0] : memref<16xi32>
+      aie.objectfifo.release @fifo (Produce, 1)
+    }
+    aie.end
+  }
+
+  %core23 = aie.core(%tile23) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c6 = arith.constant 6 : index
+    scf.for %i = %c0 to %c6 step %c1 {
+      %sv = aie.objectfifo.acquire @fifo (Consume, 2) : !aie.objectfifosubview<memref<16xi32>>
+      %e0 = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      %e1 = aie.objectfifo.subview.access %sv[1] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      %x = memref.load %e0[%c0] : memref<16xi32>
+      memref.store %x, %e1[%c0] : memref<16xi32>
+      aie.objectfifo.release @fifo (Consume, 2)
+    }
+    aie.end
+  }
+ }
+}
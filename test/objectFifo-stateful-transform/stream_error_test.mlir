@@ -0,0 +1,58 @@
+//===- stream_error_test.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file --verify-diagnostics %s
+
+aie.device(xcvc1902) {
+  %tile12 = aie.tile(1, 2)
+  %tile13 = aie.tile(1, 3)
+  aie.objectfifo @of (%tile12, {%tile13}, 1 : i32) {stream} : !aie.objectfifo<memref<i32>>
+  %core12 = aie.core(%tile12) {
+    // expected-error @below {{cannot acquire elements of a stream objectFifo}}
+    %0 = aie.objectfifo.acquire @of (Produce, 1) : !aie.objectfifosubview<memref<i32>>
+    aie.end
+  }
+}
+
+// -----
+
+aie.device(xcvc1902) {
+  %tile12 = aie.tile(1, 2)
+  %tile13 = aie.tile(1, 3)
+  aie.objectfifo @of (%tile12, {%tile13}, 1 : i32) : !aie.objectfifo<memref<i32>>
+  %core12 = aie.core(%tile12) {
+    %v = arith.constant 7 : i32
+    // expected-error @below {{requires an objectFifo with the `stream` attribute}}
+    aie.objectfifo.put @of (%v : i32)
+    aie.end
+  }
+}
+
+// -----
+
+aie.device(xcvc1902) {
+  %tile12 = aie.tile(1, 2)
+  %tile13 = aie.tile(1, 3)
+  aie.objectfifo @of (%tile12, {%tile13}, 1 : i32) {stream} : !aie.objectfifo<memref<i32>>
+  %core13 = aie.core(%tile13) {
+    // expected-error @below {{value type 'f32' doesn't match the objectFifo element type 'i32'}}
+    %v = aie.objectfifo.get @of : f32
+    aie.end
+  }
+}
+
+// -----
+
+aie.device(xcve2302) {
+  %tile10 = aie.tile(1, 0)
+  %tile13 = aie.tile(1, 3)
+  // expected-error @below {{stream objectFifos must be between core tiles}}
+  aie.objectfifo @of (%tile10, {%tile13}, 1 : i32) {stream} : !aie.objectfifo<memref<i32>>
+}
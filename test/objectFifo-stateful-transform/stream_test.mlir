@@ -0,0 +1,64 @@
+//===- stream_test.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform %s | FileCheck %s
+
+// The stream objectFifo becomes a flow between the cores, on the channels
+// left free by the existing flow, and needs neither buffers nor locks.
+
+// CHECK-LABEL: module @stream
+// CHECK:   %[[T12:.*]] = aie.tile(1, 2)
+// CHECK:   %[[T13:.*]] = aie.tile(1, 3)
+// CHECK:   %[[T33:.*]] = aie.tile(3, 3)
+// CHECK-NOT: aie.buffer
+// CHECK-NOT: aie.lock
+// CHECK:   aie.flow(%[[T12]], Core : 0, %[[T33]], Core : 0)
+// CHECK:   aie.flow(%[[T12]], Core : 1, %[[T13]], Core : 0)
+// CHECK:   aie.flow(%[[T12]], Core : 1, %[[T33]], Core : 1)
+// CHECK:   aie.core(%[[T12]]) {
+// CHECK:     %[[C1:.*]] = arith.constant 1 : i32
+// CHECK:     aie.put_stream(%[[C1]] : i32, %{{.*}} : i32)
+// CHECK:   aie.core(%[[T13]]) {
+// CHECK:     %[[C0:.*]] = arith.constant 0 : i32
+// CHECK:     %[[V13:.*]] = aie.get_stream(%[[C0]] : i32) : i32
+// CHECK:     memref.store %[[V13]]
+// CHECK:   aie.core(%[[T33]]) {
+// CHECK:     %[[C1_33:.*]] = arith.constant 1 : i32
+// CHECK:     %{{.*}} = aie.get_stream(%[[C1_33]] : i32) : i32
+
+module @stream {
+  aie.device(xcvc1902) {
+    %tile12 = aie.tile(1, 2)
+    %tile13 = aie.tile(1, 3)
+    %tile33 = aie.tile(3, 3)
+
+    aie.flow(%tile12, Core : 0, %tile33, Core : 0)
+    aie.objectfifo @of (%tile12, {%tile13, %tile33}, 1 : i32) {stream} : !aie.objectfifo<memref<i32>>
+
+    %buf13 = aie.buffer(%tile13) : memref<i32>
+
+    %core12 = aie.core(%tile12) {
+      %v = arith.constant 7 : i32
+      aie.objectfifo.put @of (%v : i32)
+      aie.end
+    }
+
+    %core13 = aie.core(%tile13) {
+      %v = aie.objectfifo.get @of : i32
+      memref.store %v, %buf13[] : memref<i32>
+      aie.end
+    }
+
+    %core33 = aie.core(%tile33) {
+      %v = aie.objectfifo.get @of : i32
+      aie.end
+    }
+  }
+}
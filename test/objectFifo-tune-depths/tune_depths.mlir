@@ -0,0 +1,96 @@
+//===- tune_depths.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-tune-depths --verify-diagnostics %s
+// RUN: aie-opt --aie-objectFifo-tune-depths="apply=true" %s | FileCheck %s
+
+// @in and @in2 run at the pace of the kernel, slower than their DMAs, so
+// double buffering is enough. The cores of @of are faster than the DMA
+// latency, which takes 5 more elements to hide. Two elements of @big don't
+// fit next to the stack of (5, 2).
+// CHECK: aie.objectfifo @in(%{{.*}}, {%{{.*}}}, [2, 2])
+// CHECK: aie.objectfifo @in2(%{{.*}}, {%{{.*}}}, [2, 2])
+// CHECK: aie.objectfifo @of(%{{.*}}, {%{{.*}}}, [6, 7])
+// CHECK: aie.objectfifo @big(%{{.*}}, {%{{.*}}}, 1 : i32)
+
+module @tune_depths {
+ aie.device(xcve2302) {
+  %tile00 = aie.tile(0, 0)
+  %tile01 = aie.tile(0, 1)
+  %tile02 = aie.tile(0, 2)
+  %tile12 = aie.tile(1, 2)
+  %tile32 = aie.tile(3, 2)
+  %tile52 = aie.tile(5, 2)
+  %tile53 = aie.tile(5, 3)
+
+  // expected-remark @+1 {{suggested depth [2, 2] for an estimated period of 1005 cycles}}
+  aie.objectfifo @in (%tile00, {%tile01}, 4 : i32) : !aie.objectfifo<memref<256xi32>>
+  // expected-remark @+1 {{suggested depth [2, 2] for an estimated period of 1005 cycles}}
+  aie.objectfifo @in2 (%tile01, {%tile02}, 4 : i32) : !aie.objectfifo<memref<256xi32>>
+  aie.objectfifo.link [@in] -> [@in2] ()
+  // expected-remark @+1 {{suggested depth [6, 7] for an estimated period of 16 cycles}}
+  aie.objectfifo @of (%tile12, {%tile32}, 2 : i32) : !aie.objectfifo<memref<16xi32>>
+  // expected-remark @+1 {{suggested depth 1 for an estimated period of 3 cycles}}
+  aie.objectfifo @big (%tile52, {%tile53}, 2 : i32) : !aie.objectfifo<memref<8192xi32>>
+
+  func.func private @kernel(%buf : memref<256xi32>) -> ()
+
+  %core02 = aie.core(%tile02) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c16 = arith.constant 16 : index
+    scf.for %i = %c0 to %c16 step %c1 {
+      %sv = aie.objectfifo.acquire @in2 (Consume, 1) : !aie.objectfifosubview<memref<256xi32>>
+      %e = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<256xi32>> -> memref<256xi32>
+      func.call @kernel(%e) {aie.cycles = 1000 : i32} : (memref<256xi32>) -> ()
+      aie.objectfifo.release @in2 (Consume, 1)
+    }
+    aie.end
+  }
+
+  %core12 = aie.core(%tile12) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c8 = arith.constant 8 : index
+    %v = arith.constant 1 : i32
+    scf.for %i = %c0 to %c8 step %c1 {
+      %sv = aie.objectfifo.acquire @of (Produce, 1) : !aie.objectfifosubview<memref<16xi32>>
+      %e = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      memref.store %v, %e[%c0] : memref<16xi32>
+      aie.objectfifo.release @of (Produce, 1)
+    }
+    aie.end
+  }
+
+  %core32 = aie.core(%tile32) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c4 = arith.constant 4 : index
+    scf.for %i = %c0 to %c4 step %c1 {
+      %sv = aie.objectfifo.acquire @of (Consume, 2) : !aie.objectfifosubview<memref<16xi32>>
+      %e = aie.objectfifo.subview.access %sv[0] : !aie.objectfifosubview<memref<16xi32>> -> memref<16xi32>
+      aie.objectfifo.release @of (Consume, 2)
+    }
+    aie.end
+  }
+
+  %core52 = aie.core(%tile52) {
+    %sv = aie.objectfifo.acquire @big (Produce, 1) : !aie.objectfifosubview<memref<8192xi32>>
+    aie.objectfifo.release @big (Produce, 1)
+    aie.end
+  }
+
+  %core53 = aie.core(%tile53) {
+    %sv = aie.objectfifo.acquire @big (Consume, 1) : !aie.objectfifosubview<memref<8192xi32>>
+    aie.objectfifo.release @big (Consume, 1)
+    aie.end
+  }
+ }
+}
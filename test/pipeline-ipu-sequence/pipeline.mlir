@@ -0,0 +1,64 @@
+//===- pipeline.mlir -------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-pipeline-ipu-sequence %s | FileCheck %s
+
+// The input of each batch is issued before the sync of the previous one, on
+// BDs alternating between 2 and 1.
+// CHECK-LABEL: func.func @sequence
+// CHECK: aiex.ipu.dma_memcpy_nd(0, 0, %arg0{{.*}} {id = 1 : i64, metadata = @in}
+// CHECK: aiex.ipu.dma_memcpy_nd(0, 0, %arg2{{.*}} {id = 0 : i64, metadata = @out}
+// CHECK: aiex.ipu.dma_memcpy_nd(0, 0, %arg1{{.*}} {id = 2 : i64, metadata = @in}
+// CHECK: aiex.ipu.sync
+// CHECK: aiex.ipu.dma_memcpy_nd(0, 0, %arg3{{.*}} {id = 0 : i64, metadata = @out}
+// CHECK: aiex.ipu.dma_memcpy_nd(0, 0, %arg0{{.*}} {id = 1 : i64, metadata = @in}
+// CHECK: aiex.ipu.sync
+// CHECK: aiex.ipu.dma_memcpy_nd(0, 0, %arg2{{.*}} {id = 0 : i64, metadata = @out}
+// CHECK: aiex.ipu.sync
+
+// The second input reads the output of the first batch, so it waits for it.
+// CHECK-LABEL: func.func @dependent
+// CHECK: aiex.ipu.dma_memcpy_nd(0, 0, %arg0{{.*}} {id = 1 : i64, metadata = @in}
+// CHECK: aiex.ipu.dma_memcpy_nd(0, 0, %arg1{{.*}} {id = 0 : i64, metadata = @out}
+// CHECK: aiex.ipu.sync
+// CHECK: aiex.ipu.dma_memcpy_nd(0, 0, %arg1{{.*}} {id = 1 : i64, metadata = @in}
+
+module {
+  aie.device(ipu) {
+    func.func @sequence(%in0 : memref<64xi32>, %in1 : memref<64xi32>, %out0 : memref<64xi32>, %out1 : memref<64xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c64 = arith.constant 64 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %in0[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @in, id = 1 : i64 } : memref<64xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %out0[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<64xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      aiex.ipu.dma_memcpy_nd (0, 0, %in1[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @in, id = 1 : i64 } : memref<64xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %out1[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<64xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      aiex.ipu.dma_memcpy_nd (0, 0, %in0[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @in, id = 1 : i64 } : memref<64xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %out0[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<64xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+    func.func @dependent(%in : memref<64xi32>, %out : memref<64xi32>) {
+      %c0 = arith.constant 0 : i64
+      %c1 = arith.constant 1 : i64
+      %c64 = arith.constant 64 : i64
+      aiex.ipu.dma_memcpy_nd (0, 0, %in[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @in, id = 1 : i64 } : memref<64xi32>
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @out, id = 0 : i64 } : memref<64xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      aiex.ipu.dma_memcpy_nd (0, 0, %out[%c0,%c0,%c0,%c0][%c1,%c1,%c1,%c64][%c0,%c0,%c0]) { metadata = @in, id = 1 : i64 } : memref<64xi32>
+      aiex.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+    aie.shim_dma_allocation @in (MM2S, 0, 0)
+    aie.shim_dma_allocation @out (S2MM, 0, 0)
+  }
+}
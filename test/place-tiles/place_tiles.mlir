@@ -0,0 +1,42 @@
+//===- place_tiles.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --split-input-file --aie-place-tiles --verify-diagnostics %s | FileCheck %s
+
+// The heavy objectFifos @ab and @bc connect neighbouring tiles, which share
+// memory, while @in and @out stay short.
+// CHECK-LABEL: module @chain
+// CHECK:     aie.tile(0, 0)
+// CHECK-NEXT:  aie.tile(0, 3)
+// CHECK-NEXT:  aie.tile(0, 2)
+// CHECK-NEXT:  aie.tile(1, 2)
+// CHECK-NOT:   aie.place
+
+module @chain {
+ aie.device(ipu) {
+  %shim = aie.tile(0, 0)
+  %a = aie.tile(4, 5) {aie.place}
+  %b = aie.tile(0, 5) {aie.place}
+  %c = aie.tile(4, 2) {aie.place}
+  aie.objectfifo @in(%shim, {%a}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+  aie.objectfifo @ab(%a, {%b}, 2 : i32) {aie.bandwidth = 8 : i32} : !aie.objectfifo<memref<256xi32>>
+  aie.objectfifo @bc(%b, {%c}, 2 : i32) {aie.bandwidth = 8 : i32} : !aie.objectfifo<memref<256xi32>>
+  aie.objectfifo @out(%c, {%shim}, 2 : i32) : !aie.objectfifo<memref<256xi32>>
+ }
+}
+
+// -----
+
+module @shim {
+ aie.device(ipu) {
+  // expected-error@+1 {{only core tiles can be placed}}
+  %shim = aie.tile(0, 0) {aie.place}
+ }
+}
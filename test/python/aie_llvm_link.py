@@ -0,0 +1,39 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# RUN: %python %s | FileCheck %s
+
+from aie.dialects.aie import aie_llvm_link
+
+core = """
+define i32 @core() {
+  %r = call i32 @kernel(i32 20)
+  ret i32 %r
+}
+
+declare i32 @kernel(i32)
+"""
+
+kernel = """
+define i32 @kernel(i32 %x) {
+  %y = add i32 %x, 22
+  ret i32 %y
+}
+"""
+
+# Without an optimization level, the modules are only linked.
+# CHECK-LABEL: opt_level=0
+# CHECK: define i32 @core()
+# CHECK: call i32 @kernel(i32 20)
+# CHECK: define i32 @kernel(i32 %x)
+print("opt_level=0")
+print(aie_llvm_link([core, kernel]))
+
+# The kernel is inlined into the core and folded, and, being internalized, it
+# is dropped once it has no caller left.
+# CHECK-LABEL: opt_level=2
+# CHECK: define i32 @core()
+# CHECK-NEXT: ret i32 42
+# CHECK-NOT: @kernel
+print("opt_level=2")
+print(aie_llvm_link([core, kernel], opt_level=2))
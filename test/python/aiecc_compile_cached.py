@@ -0,0 +1,40 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# RUN: rm -rf %t.cache
+# RUN: %PYTHON %s %t.cache --no-xchesscc --no-xbridge --peano=%PEANO_INSTALL_DIR | FileCheck %s
+# REQUIRES: peano
+
+# CHECK: compiled: True True
+# CHECK: cached: True
+# CHECK: other arguments: False
+
+import os
+import sys
+
+import aie.compiler.aiecc.main as aiecc
+
+module = """
+module {
+  aie.device(ipu) {
+    %12 = aie.tile(1, 2)
+    %buf = aie.buffer(%12) : memref<256xi32>
+    %4 = aie.core(%12)  {
+      %0 = arith.constant 0 : i32
+      %1 = arith.constant 0 : index
+      memref.store %0, %buf[%1] : memref<256xi32>
+      aie.end
+    }
+  }
+}
+"""
+
+cache_dir, args = sys.argv[1], sys.argv[2:]
+paths = aiecc.compile_cached(module, args, cache_dir)
+print("compiled:", *(os.path.isfile(p) for p in paths))
+
+# The second compilation of the design is the entry of the first one.
+print("cached:", aiecc.compile_cached(module, args, cache_dir) == paths)
+
+key = aiecc.design_key(module, args + ["--unified"])
+print("other arguments:", aiecc.cached_design(cache_dir, key) is not None)
@@ -0,0 +1,46 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# RUN: %python %s | FileCheck %s
+
+from aie.compiler.aiecc.main import emit_design_bif, generate_cores_list
+
+# The cores are in columns 1 and 2, column 0 only has a shim tile.
+module = """
+module {
+  aie.device(ipu) {
+    %00 = aie.tile(0, 0)
+    %12 = aie.tile(1, 2)
+    %22 = aie.tile(2, 2)
+    %23 = aie.tile(2, 3)
+    %c12 = aie.core(%12) {
+      aie.end
+    }
+    %c22 = aie.core(%22) {
+      aie.end
+    }
+    %c23 = aie.core(%23) {
+      aie.end
+    }
+  }
+}
+"""
+
+# The ELFs are loaded by one CDO for each of the columns of the cores.
+# CHECK:      { type=cdo
+# CHECK-NEXT:   file=/work/aie_cdo_error_handling.bin
+# CHECK-NEXT:   file=/work/aie_cdo_elfs_1.bin
+# CHECK-NEXT:   file=/work/aie_cdo_elfs_2.bin
+# CHECK-NEXT:   file=/work/aie_cdo_init.bin
+# CHECK-NEXT:   file=/work/aie_cdo_enable.bin
+# CHECK-NEXT: }
+print(emit_design_bif("/work", sorted({c[0] for c in generate_cores_list(module)})))
+
+# Without cores, there is neither an ELF nor an enable CDO.
+# CHECK:      { type=cdo
+# CHECK-NEXT:   file=/work/aie_cdo_error_handling.bin
+# CHECK-NOT:    aie_cdo_elfs
+# CHECK:        file=/work/aie_cdo_init.bin
+# CHECK-NOT:    aie_cdo_enable
+# CHECK:      }
+print(emit_design_bif("/work"))
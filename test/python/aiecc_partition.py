@@ -0,0 +1,23 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# RUN: %python %s | FileCheck %s
+
+from aie.compiler.aiecc.main import emit_partition
+
+# The design spans columns 1 and 2 of the 5 columns of the device.
+module = """
+module {
+  aie.device(ipu) {
+    %12 = aie.tile(1, 2)
+    %22 = aie.tile(2, 2)
+    %32 = aie.tile(2, 3)
+  }
+}
+"""
+
+# CHECK: {'column_width': 2, 'start_columns': [1, 2, 3]}
+print(emit_partition(module)["aie_partition"]["partition"])
+
+# CHECK: {'column_width': 2, 'start_columns': [1, 3]}
+print(emit_partition(module, start_columns=[1, 3])["aie_partition"]["partition"])
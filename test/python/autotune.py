@@ -0,0 +1,51 @@
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 AMD Inc.
+
+# RUN: %python %s | FileCheck %s
+
+from aie.autotune import candidates, estimated_cycles, over_resources, update_db
+
+space = {
+    "shapes": [{"M": 64}, {"M": 96}],
+    "params": {"m": [16, 32, 64]},
+    "constraints": ["M % m == 0"],
+}
+
+# CHECK: {'M': 64, 'm': 16}
+# CHECK: {'M': 64, 'm': 32}
+# CHECK: {'M': 64, 'm': 64}
+# CHECK: {'M': 96, 'm': 16}
+# CHECK: {'M': 96, 'm': 32}
+# CHECK-NOT: {'M': 96, 'm': 64}
+for candidate in candidates(space):
+    print(candidate)
+
+
+def usage(used, available):
+    return {"used": used, "available": available}
+
+
+report = {
+    "tiles": [
+        {"tile": "(0, 0)", "bds": usage(4, 16), "locks": usage(2, 16)},
+        {"tile": "(0, 2)", "memory_bytes": usage(70000, 65536), "bds": usage(4, 16)},
+    ]
+}
+# CHECK: ['memory_bytes of (0, 2)']
+print(over_resources(report))
+
+# CHECK: 464
+print(estimated_cycles({"cores": [{"cycles": 160}, {"cycles": 464}]}))
+
+db = {}
+# CHECK: True
+print(update_db(db, {"M": 64}, {"M": 64, "m": 32}, {"mean_us": 20.0}, "mean_us"))
+# CHECK: False
+print(update_db(db, {"M": 64}, {"M": 64, "m": 16}, {"mean_us": 25.0}, "mean_us"))
+# CHECK: True
+print(update_db(db, {"M": 64}, {"M": 64, "m": 64}, {"mean_us": 10.0}, "mean_us"))
+# CHECK: {'M=64': {'params': {'m': 64}, 'result': {'mean_us': 10.0}}}
+print(db)
@@ -0,0 +1,72 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# RUN: %python %s | FileCheck %s
+
+import aie.extras.types as T
+from aie.dialects.aie import (
+    AIEDevice,
+    Core,
+    Device,
+    ObjectFifoPort,
+    ObjectFifoType,
+    acquire,
+    buffer,
+    call_chain,
+    end,
+    external_func,
+    objectfifo,
+    objectfifo_release,
+    tile,
+)
+from aie.ir import TypeAttr, Block, InsertionPoint
+
+from util import construct_and_print_module
+
+
+# CHECK-LABEL: call_chain
+# CHECK:      %[[TILE:.*]] = aie.tile(1, 3)
+# CHECK:      %[[TMP:.*]] = aie.buffer(%[[TILE]]) {sym_name = "tmp"} : memref<64xui8>
+# CHECK:      aie.core(%[[TILE]]) {
+# CHECK:        %[[IN:.*]] = aie.objectfifo.subview.access
+# CHECK:        %[[OUT:.*]] = aie.objectfifo.subview.access
+# CHECK:        func.call @scale(%[[IN]], %[[TMP]], %{{.*}})
+# CHECK:        func.call @offset(%[[TMP]], %[[OUT]])
+# CHECK-NOT:    aie.objectfifo.acquire
+# CHECK:        aie.objectfifo.release @in(Consume, 1)
+# CHECK:        aie.objectfifo.release @out(Produce, 1)
+@construct_and_print_module
+def call_chain_test():
+    line_ty = T.memref(64, T.ui8())
+    dev = Device(AIEDevice.xcve2802)
+    dev_block = Block.create_at_start(dev.body_region)
+    with InsertionPoint(dev_block):
+        scale = external_func("scale", inputs=[line_ty, line_ty, T.i32()])
+        offset = external_func("offset", inputs=[line_ty, line_ty])
+
+        S = tile(1, 2)
+        C = tile(1, 3)
+        tmp = buffer(C, (64,), T.ui8(), name="tmp")
+        line_fifo_ty = TypeAttr.get(ObjectFifoType.get(line_ty))
+        objectfifo("in", S, [C], 2, line_fifo_ty, [], [])
+        objectfifo("out", C, [S], 2, line_fifo_ty, [], [])
+
+        core = Core(C, "chain.o")
+        bb = Block.create_at_start(core.body)
+        with InsertionPoint(bb):
+            elem_in = acquire(ObjectFifoPort.Consume, "in", 1, line_ty).acquired_elem()
+            elem_out = acquire(
+                ObjectFifoPort.Produce, "out", 1, line_ty
+            ).acquired_elem()
+            call_chain(
+                [
+                    (scale, lambda src, dst: [src, dst, 3]),
+                    (offset, lambda src, dst: [src, dst]),
+                ],
+                elem_in,
+                elem_out,
+                [tmp],
+            )
+            objectfifo_release(ObjectFifoPort.Consume, "in", 1)
+            objectfifo_release(ObjectFifoPort.Produce, "out", 1)
+            end()
@@ -0,0 +1,71 @@
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 Advanced Micro Devices, Inc.
+
+# RUN: %python %s | FileCheck %s
+
+from aie.dialects.aiex import ipu
+
+
+def print_words(words):
+    print(" ".join(f"{w:08X}" for w in words))
+
+
+# CHECK-LABEL: sync
+# CHECK: 03000000 00010100
+print("sync")
+print_words(ipu.sync(column=0, row=0, direction=0, channel=0))
+
+# CHECK-LABEL: write32
+# CHECK: 02010000 0001D004 80000000
+print("write32")
+print_words(ipu.write32(1, 0, 0x1D004, 0x80000000))
+
+# The strides are given in elements and the offset in elements of data_width
+# bits, as in aiex.ipu_writebd_shimtile.
+# CHECK-LABEL: writebd_shimtile
+# CHECK: 06020101 00000000 00000040 00000010 00000000 00800000 80400007 00000000 00000000 16043200
+print("writebd_shimtile")
+print_words(
+    ipu.writebd_shimtile(
+        bd_id=1,
+        buffer_length=64,
+        buffer_offset=4,
+        column=2,
+        d1_size=4,
+        d1_stride=8,
+        d0_size=8,
+        lock_acq_enable=1,
+        lock_acq_val=16,
+        lock_rel_id=1,
+        lock_rel_val=1,
+        next_bd=2,
+        use_next_bd=1,
+    )
+)
+
+# CHECK-LABEL: writebd_shimtile_axi
+# CHECK: 06020101 00000000 00000040 00000010 00000000 00800000 40400007 04200000 00000000 16043200
+print("writebd_shimtile_axi")
+print_words(
+    ipu.writebd_shimtile(
+        bd_id=1,
+        buffer_length=64,
+        buffer_offset=4,
+        column=2,
+        d1_size=4,
+        d1_stride=8,
+        d0_size=8,
+        lock_acq_enable=1,
+        lock_acq_val=16,
+        lock_rel_id=1,
+        lock_rel_val=1,
+        next_bd=2,
+        use_next_bd=1,
+        burst_length=128,
+        ax_cache=2,
+        ax_qos=4,
+    )
+)
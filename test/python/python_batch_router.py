@@ -0,0 +1,108 @@
+# Copyright (C) 2024, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# RUN: %PYTHON %s | FileCheck %s
+# REQUIRES: python_passes
+
+from collections import deque
+from pathlib import Path
+
+import numpy as np
+
+from aie._mlir_libs._aie_python_passes import (
+    create_python_batch_router_pass,
+    pass_manager_add_owned_pass,
+)
+
+# noinspection PyUnresolvedReferences
+import aie.dialects.aie
+from aie.ir import Context, Location, Module
+from aie.passmanager import PassManager
+
+
+def run(f):
+    with Context(), Location.unknown():
+        print("\nTEST:", f.__name__)
+        f()
+
+
+THIS_FILE = __file__
+
+
+# Route each flow along a breadth-first tree from its source, ignoring the
+# capacities, which is enough for small designs.
+class ShortestPathSolver:
+    def __init__(self):
+        self.problem = None
+
+    def solve(self, problem):
+        self.problem = problem
+        outgoing = {}
+        for index, (src, _, _) in enumerate(problem["channels"]):
+            outgoing.setdefault(int(src), []).append(index)
+        destinations = problem["flow_destinations"]
+        used = set()
+        for flow, (src, _, _) in enumerate(problem["flow_sources"]):
+            src = int(src)
+            pred = {src: None}
+            queue = deque([src])
+            while queue:
+                sb = queue.popleft()
+                for index in outgoing.get(sb, []):
+                    target = int(problem["channels"][index][1])
+                    if target not in pred:
+                        pred[target] = index
+                        queue.append(target)
+            for dst in destinations[destinations[:, 0] == flow][:, 1]:
+                sb = int(dst)
+                while pred[sb] is not None:
+                    used.add((flow, pred[sb]))
+                    sb = int(problem["channels"][pred[sb]][0])
+        return np.array(sorted(used), dtype=np.int64).reshape(-1, 2)
+
+
+# CHECK-LABEL: TEST: test_broadcast
+@run
+def test_broadcast():
+    with open(Path(THIS_FILE).parent.parent / "create-flows" / "broadcast.mlir") as f:
+        mlir_module = Module.parse(f.read())
+    solver = ShortestPathSolver()
+    pass_ = create_python_batch_router_pass(solver)
+    pm = PassManager()
+    pass_manager_add_owned_pass(pm, pass_)
+    pm.add("aie-find-flows")
+
+    device = mlir_module.body.operations[0]
+    pm.run(device.operation)
+
+    # The whole problem is handed over in one call.
+    # CHECK: switchboxes (2,) int32
+    # CHECK: channels (3,) int32
+    # CHECK: capacity () int32
+    # CHECK: flow_sources (3,) int32
+    # CHECK: flow_destinations (4,) int32
+    # CHECK: flow_bandwidth () float64
+    # CHECK: 2 flows to 8 destinations
+    for name, array in solver.problem.items():
+        print(name, array.shape[1:], array.dtype)
+    print(
+        len(solver.problem["flow_sources"]),
+        "flows to",
+        len(solver.problem["flow_destinations"]),
+        "destinations",
+    )
+
+    # CHECK: %[[T13:.*]] = aie.tile(1, 3)
+    # CHECK: %[[T20:.*]] = aie.tile(2, 0)
+    # CHECK: %[[T31:.*]] = aie.tile(3, 1)
+    # CHECK: %[[T60:.*]] = aie.tile(6, 0)
+    # CHECK: %[[T71:.*]] = aie.tile(7, 1)
+    # CHECK: %[[T82:.*]] = aie.tile(8, 2)
+    # CHECK: %[[T83:.*]] = aie.tile(8, 3)
+    #
+    # CHECK: aie.flow(%[[T20]], DMA : 0, %[[T71]], DMA : 0)
+    # CHECK: aie.flow(%[[T20]], DMA : 0, %[[T31]], DMA : 0)
+    # CHECK: aie.flow(%[[T20]], DMA : 0, %[[T82]], DMA : 0)
+    # CHECK: aie.flow(%[[T20]], DMA : 0, %[[T13]], DMA : 0)
+    # CHECK: aie.flow(%[[T60]], DMA : 0, %[[T83]], DMA : 1)
+    print(mlir_module)
@@ -0,0 +1,45 @@
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 AMD Inc.
+
+# RUN: %python %s | FileCheck %s
+
+import numpy as np
+
+from aie.sparsity import is_sparse, pack, pack_block, prune, unpack
+
+# Groups of 1, 2, 3, 4 along K, negated in the odd columns: the 3s and 4s are
+# kept, which are rows 2 and 3 of each group, so bits 16 to 31 of each word of
+# the mask.
+b = np.tile((np.arange(16) % 4 + 1)[:, None], (1, 8)).astype(np.int8)
+b[:, 1::2] *= -1
+
+# CHECK: False True
+pruned = prune(b)
+print(is_sparse(b), is_sparse(pruned))
+
+# CHECK: ffff0000 ffff0000 ffff0000 ffff0000
+# CHECK: [3, -3, 3, -3, 3, -3, 3, -3]
+# CHECK: [4, -4, 4, -4, 4, -4, 4, -4]
+words, values = pack_block(pruned)
+print(" ".join(f"{int(w):08x}" for w in words))
+print(values[0].tolist())
+print(values[1].tolist())
+
+# Ties keep the first elements of the group.
+# CHECK: [1, 1, 0, 0]
+print(prune(np.ones((4, 8), dtype=np.int8))[:, 0].tolist())
+
+# CHECK: 320 True
+rng = np.random.default_rng(0)
+b = prune(rng.integers(-128, 128, (32, 16)).astype(np.int8))
+packed = pack(b)
+print(packed.size, bool((unpack(packed, 32, 16) == b).all()))
+
+# CHECK: more than 2 of 4 elements along K are non-zero
+try:
+    pack_block(np.ones((16, 8), dtype=np.int8))
+except ValueError as e:
+    print(e)
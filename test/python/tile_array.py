@@ -405,3 +405,36 @@ def buffer_test_this_needs_to_distinct_from_all_other_mentions_of_buffer_in_this
         # CHECK: (1, 1) MemRef(%buffer_3_3_4, memref<7x8xi32>)
         for idx, c in np.ndenumerate(cs):
             print(idx, c)
+
+
+# CHECK-LABEL: bulk_builders
+@construct_and_print_module
+def bulk_builders(module):
+    @aie.device(AIEDevice.ipu)
+    def ipu():
+        ts = aie.tiles([1, 2], [2, 3])
+        # CHECK: %tile_1_2 = aie.tile(1, 2)
+        # CHECK: %tile_1_3 = aie.tile(1, 3)
+        # CHECK: %tile_2_2 = aie.tile(2, 2)
+        # CHECK: %tile_2_3 = aie.tile(2, 3)
+        assert len(ts) == 2 and len(ts[0]) == 2
+
+        # CHECK: aie.objectfifo @fifo_0(%tile_1_2, {%tile_1_3}, 2 : i32) : !aie.objectfifo<memref<8xi32>>
+        # CHECK: aie.objectfifo @fifo_1(%tile_2_2, {%tile_2_3, %tile_1_3}, 2 : i32) : !aie.objectfifo<memref<8xi32>>
+        fifos = aie.object_fifos(
+            "fifo",
+            [ts[0][0], ts[1][0]],
+            [ts[0][1], [ts[1][1], ts[0][1]]],
+            2,
+            T.memref(8, T.i32()),
+        )
+        assert len(fifos) == 2
+
+        # The index of the device follows the ops created between lookups.
+        assert find_neighbors(ts[1][1]).west == ts[0][1]
+        aie.flow(ts[0][0], dest=ts[1][0])
+        assert len(aie.find_matching_flows([ts[1][0]])) == 1
+        aie.flow(ts[1][0], dest=ts[1][1])
+        assert len(aie.find_matching_flows([ts[1][0]])) == 2
+        assert len(aie.find_matching_flows([ts[1][0]], filter_dest=True)) == 1
+        assert len(aie.find_matching_flows([ts[0][0], ts[1][0]])) == 2
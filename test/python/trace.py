@@ -0,0 +1,27 @@
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 AMD Inc.
+
+# RUN: %python %s | FileCheck %s
+
+import json
+
+from aie.trace import to_perfetto
+
+# One packet of the core of tile (0, 2): a Start frame at cycle 100, STREAM_STALL
+# (slot 4) 3 cycles later and repeated twice, INSTR_EVENT_0 (slot 0) 5 cycles
+# later, and then fillers.
+words = [0x00020004, 0xF0000000, 0x00000064, 0x43D205FF] + [0xFFFFFFFF] * 4
+
+# CHECK: "name": "core (0, 2)"
+# CHECK: {"name": "INSTR_EVENT_0", "ph": "X", "pid": 0, "tid": 0, "ts": 110, "dur": 1}
+# CHECK: {"name": "STREAM_STALL", "ph": "X", "pid": 0, "tid": 4, "ts": 103, "dur": 3}
+for event in to_perfetto(words)["traceEvents"]:
+    print(json.dumps(event))
+
+# CHECK: {"timers": "per-tile"}
+# CHECK: {"timers": "synchronized"}
+print(json.dumps(to_perfetto(words)["otherData"]))
+print(json.dumps(to_perfetto(words, synced_timers=True)["otherData"]))
@@ -0,0 +1,27 @@
+//===- resource_initial_values.mlir ----------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --pass-pipeline="builtin.module(aie.device(aie-resource-initial-values{min-bytes=16}))" %s | FileCheck %s
+// RUN: aie-opt --pass-pipeline="builtin.module(aie.device(aie-resource-initial-values{min-bytes=16}))" --emit-bytecode %s | aie-opt | FileCheck %s
+
+// CHECK-LABEL: aie.device(ipu)
+// CHECK: aie.buffer(%{{.*}}) {sym_name = "weights"} : memref<8xi32> = dense_resource<weights>
+// CHECK: aie.buffer(%{{.*}}) {sym_name = "small"} : memref<2xi32> = dense<[1, 2]>
+// CHECK: aie.buffer(%{{.*}}) {sym_name = "zeros"} : memref<8xi32> = dense<0>
+// CHECK: aie.buffer(%{{.*}}) {sym_name = "flags"} : memref<32xi1> = dense<
+// CHECK: dialect_resources
+// CHECK: weights: "0x08000000010000000200000003000000040000000500000006000000070000000800000
+aie.device(ipu) {
+  %t = aie.tile(1, 2)
+  %weights = aie.buffer(%t) {sym_name = "weights"} : memref<8xi32> = dense<[1, 2, 3, 4, 5, 6, 7, 8]>
+  %small = aie.buffer(%t) {sym_name = "small"} : memref<2xi32> = dense<[1, 2]>
+  %zeros = aie.buffer(%t) {sym_name = "zeros"} : memref<8xi32> = dense<0>
+  %flags = aie.buffer(%t) {sym_name = "flags"} : memref<32xi1> = dense<[true, false, true, false, true, false, true, false, true, false, true, false, true, false, true, false, true, false, true, false, true, false, true, false, true, false, true, false, true, false, true, false]>
+}
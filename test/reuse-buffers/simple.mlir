@@ -0,0 +1,66 @@
+//===- simple.mlir ---------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-reuse-buffers %s | FileCheck %s
+
+// %a and %b are used one after the other, so %b reuses %a.  %c is live
+// during the whole loop, which also uses %d, and %e is accessed by a DMA,
+// so none of them can be merged.
+// CHECK-LABEL: aie.device(xcvc1902)
+// CHECK: %[[T:.*]] = aie.tile(3, 3)
+// CHECK: %[[A:.*]] = aie.buffer(%[[T]]) : memref<16xi32>
+// CHECK-NOT: aie.buffer(%[[T]]) : memref<16xi32>
+// CHECK: %[[C:.*]] = aie.buffer(%[[T]]) : memref<8xi32>
+// CHECK: %[[D:.*]] = aie.buffer(%[[T]]) : memref<8xi32>
+// CHECK: %[[E:.*]] = aie.buffer(%[[T]]) : memref<8xi32>
+// CHECK: aie.core(%[[T]])
+// CHECK: memref.store %{{.*}}, %[[A]][%{{.*}}] : memref<16xi32>
+// CHECK: memref.load %[[A]][%{{.*}}] : memref<16xi32>
+// CHECK: memref.store %{{.*}}, %[[A]][%{{.*}}] : memref<16xi32>
+// CHECK: scf.for
+// CHECK: memref.store %{{.*}}, %[[C]][%{{.*}}] : memref<8xi32>
+// CHECK: memref.store %{{.*}}, %[[D]][%{{.*}}] : memref<8xi32>
+// CHECK: memref.load %[[C]][%{{.*}}] : memref<8xi32>
+// CHECK: memref.store %{{.*}}, %[[E]][%{{.*}}] : memref<8xi32>
+
+module @test {
+ aie.device(xcvc1902) {
+  %t33 = aie.tile(3, 3)
+  %a = aie.buffer(%t33) : memref<16xi32>
+  %b = aie.buffer(%t33) : memref<16xi32>
+  %c = aie.buffer(%t33) : memref<8xi32>
+  %d = aie.buffer(%t33) : memref<8xi32>
+  %e = aie.buffer(%t33) : memref<8xi32>
+  %core = aie.core(%t33) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c4 = arith.constant 4 : index
+    %v = arith.constant 7 : i32
+    memref.store %v, %a[%c0] : memref<16xi32>
+    %x = memref.load %a[%c0] : memref<16xi32>
+    memref.store %x, %b[%c0] : memref<16xi32>
+    scf.for %i = %c0 to %c4 step %c1 {
+      memref.store %v, %c[%i] : memref<8xi32>
+      memref.store %v, %d[%i] : memref<8xi32>
+    }
+    %y = memref.load %c[%c0] : memref<8xi32>
+    memref.store %y, %e[%c0] : memref<8xi32>
+    aie.end
+  }
+  %mem = aie.mem(%t33) {
+    %dma = aie.dma_start(MM2S, 0, ^bd0, ^end)
+  ^bd0:
+    aie.dma_bd(%e : memref<8xi32>, 0, 8)
+    aie.next_bd ^end
+  ^end:
+    aie.end
+  }
+ }
+}
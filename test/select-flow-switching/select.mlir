@@ -0,0 +1,97 @@
+//===- select.mlir ---------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-select-flow-switching="apply=true" %s | FileCheck %s
+// RUN: aie-opt --aie-select-flow-switching %s -verify-diagnostics -o /dev/null
+
+// The two low-bandwidth flows from the DMAs of tile (2, 3) are switched to
+// packets, the fanout of channel 1 with both its destinations.  The flow
+// above the threshold, the flow without annotation and the flow from the
+// core stay circuit-switched.
+
+// CHECK-LABEL: aie.device(xcvc1902)
+// CHECK:       aie.packet_flow(1) {
+// CHECK-NEXT:    aie.packet_source<%[[T23:.*]], DMA : 0>
+// CHECK-NEXT:    aie.packet_dest<%[[T33:.*]], DMA : 0>
+// CHECK-NEXT:  } {bandwidth = 100 : i32}
+// CHECK:       aie.packet_flow(2) {
+// CHECK-NEXT:    aie.packet_source<%[[T23]], DMA : 1>
+// CHECK-NEXT:    aie.packet_dest<%[[T43:.*]], DMA : 0>
+// CHECK-NEXT:    aie.packet_dest<%[[T53:.*]], DMA : 0>
+// CHECK-NEXT:  } {bandwidth = 400 : i32}
+// CHECK:       aie.flow(%[[T33]], DMA : 0, %[[T43]], DMA : 1) {bandwidth = 3000 : i32}
+// CHECK:       aie.flow(%[[T33]], DMA : 1, %[[T53]], DMA : 1)
+// CHECK:       aie.flow(%[[T43]], Core : 0, %[[T53]], Core : 0) {bandwidth = 10 : i32}
+// CHECK:       aie.mem(%[[T23]])
+// CHECK:         aie.dma_start(MM2S, 0
+// CHECK:         aie.dma_bd_packet(0, 1)
+// CHECK-NEXT:    aie.dma_bd(%{{.*}} : memref<16xi32>, 0, 16)
+// CHECK:         aie.dma_start(MM2S, 1
+// CHECK:         aie.dma_bd_packet(0, 2)
+// CHECK-NEXT:    aie.dma_bd(%{{.*}} : memref<16xi32>, 0, 16)
+// CHECK:         aie.dma_bd_packet(0, 2)
+// CHECK-NEXT:    aie.dma_bd(%{{.*}} : memref<16xi32>, 0, 16)
+
+module {
+  aie.device(xcvc1902) {
+    %t23 = aie.tile(2, 3)
+    %t33 = aie.tile(3, 3)
+    %t43 = aie.tile(4, 3)
+    %t53 = aie.tile(5, 3)
+    %t73 = aie.tile(7, 3)
+    %buf0 = aie.buffer(%t23) : memref<16xi32>
+    %buf1 = aie.buffer(%t23) : memref<16xi32>
+    %buf2 = aie.buffer(%t23) : memref<16xi32>
+    %buf3 = aie.buffer(%t33) : memref<16xi32>
+
+    aie.packet_flow(0) {
+      aie.packet_source<%t73, DMA : 0>
+      aie.packet_dest<%t73, DMA : 1>
+    }
+    // expected-remark@+1 {{packet switching 1 flow(s) of 100 MB/s with id 1}}
+    aie.flow(%t23, DMA : 0, %t33, DMA : 0) {bandwidth = 100 : i32}
+    // expected-remark@+1 {{packet switching 2 flow(s) of 400 MB/s with id 2}}
+    aie.flow(%t23, DMA : 1, %t43, DMA : 0) {bandwidth = 400 : i32}
+    aie.flow(%t23, DMA : 1, %t53, DMA : 0) {bandwidth = 200 : i32}
+    aie.flow(%t33, DMA : 0, %t43, DMA : 1) {bandwidth = 3000 : i32}
+    aie.flow(%t33, DMA : 1, %t53, DMA : 1)
+    aie.flow(%t43, Core : 0, %t53, Core : 0) {bandwidth = 10 : i32}
+
+    %m23 = aie.mem(%t23) {
+      %s0 = aie.dma_start(MM2S, 0, ^bd0, ^dma1)
+    ^bd0:
+      aie.dma_bd(%buf0 : memref<16xi32>, 0, 16)
+      aie.next_bd ^bd0
+    ^dma1:
+      %s1 = aie.dma_start(MM2S, 1, ^bd1, ^end)
+    ^bd1:
+      aie.dma_bd(%buf1 : memref<16xi32>, 0, 16)
+      aie.next_bd ^bd2
+    ^bd2:
+      aie.dma_bd(%buf2 : memref<16xi32>, 0, 16)
+      aie.next_bd ^bd1
+    ^end:
+      aie.end
+    }
+    %m33 = aie.mem(%t33) {
+      %s0 = aie.dma_start(MM2S, 0, ^bd0, ^dma1)
+    ^bd0:
+      aie.dma_bd(%buf3 : memref<16xi32>, 0, 16)
+      aie.next_bd ^bd0
+    ^dma1:
+      %s1 = aie.dma_start(MM2S, 1, ^bd1, ^end)
+    ^bd1:
+      aie.dma_bd(%buf3 : memref<16xi32>, 0, 16)
+      aie.next_bd ^bd1
+    ^end:
+      aie.end
+    }
+  }
+}
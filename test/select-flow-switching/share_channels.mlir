@@ -0,0 +1,93 @@
+//===- share_channels.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-select-flow-switching="apply=true share-channels=true" %s | FileCheck %s
+
+// The memtile distributes to two cores through two low-bandwidth flows. Both
+// are switched to packets and sent through its MM2S channel 0, which
+// alternates between the BDs of the two chains, freeing channel 1.
+
+// CHECK-LABEL: aie.device(xcve2302)
+// CHECK:       aie.packet_flow(0) {
+// CHECK-NEXT:    aie.packet_source<%[[T11:.*]], DMA : 0>
+// CHECK-NEXT:    aie.packet_dest<%{{.*}}, DMA : 0>
+// CHECK-NEXT:  } {bandwidth = 100 : i32}
+// CHECK:       aie.packet_flow(1) {
+// CHECK-NEXT:    aie.packet_source<%[[T11]], DMA : 0>
+// CHECK-NEXT:    aie.packet_dest<%{{.*}}, DMA : 0>
+// CHECK-NEXT:  } {bandwidth = 100 : i32}
+// CHECK:       aie.memtile_dma(%[[T11]]) {
+// CHECK-NEXT:    aie.dma_start(MM2S, 0, ^bb1, ^bb5)
+// CHECK-NOT:     aie.dma_start
+// CHECK:       ^bb1:
+// CHECK:         aie.dma_bd_packet(0, 0)
+// CHECK-NEXT:    aie.dma_bd(%[[A0:.*]] : memref<16xi32>, 0, 16)
+// CHECK:         aie.next_bd ^bb3
+// CHECK:       ^bb2:
+// CHECK:         aie.dma_bd_packet(0, 0)
+// CHECK-NEXT:    aie.dma_bd(%[[A1:.*]] : memref<16xi32>, 0, 16)
+// CHECK:         aie.next_bd ^bb4
+// CHECK:       ^bb3:
+// CHECK:         aie.dma_bd_packet(0, 1)
+// CHECK-NEXT:    aie.dma_bd(%[[B0:.*]] : memref<16xi32>, 0, 16)
+// CHECK:         aie.next_bd ^bb2
+// CHECK:       ^bb4:
+// CHECK:         aie.dma_bd_packet(0, 1)
+// CHECK-NEXT:    aie.dma_bd(%[[B1:.*]] : memref<16xi32>, 0, 16)
+// CHECK:         aie.next_bd ^bb1
+// CHECK:       ^bb5:
+// CHECK-NEXT:    aie.end
+
+module {
+  aie.device(xcve2302) {
+    %t11 = aie.tile(1, 1)
+    %t12 = aie.tile(1, 2)
+    %t22 = aie.tile(2, 2)
+    %a0 = aie.buffer(%t11) : memref<16xi32>
+    %a1 = aie.buffer(%t11) : memref<16xi32>
+    %b0 = aie.buffer(%t11) : memref<16xi32>
+    %b1 = aie.buffer(%t11) : memref<16xi32>
+    %a_prod = aie.lock(%t11, 0) {init = 2 : i32}
+    %a_cons = aie.lock(%t11, 1) {init = 0 : i32}
+    %b_prod = aie.lock(%t11, 2) {init = 2 : i32}
+    %b_cons = aie.lock(%t11, 3) {init = 0 : i32}
+
+    aie.flow(%t11, DMA : 0, %t12, DMA : 0) {bandwidth = 100 : i32}
+    aie.flow(%t11, DMA : 1, %t22, DMA : 0) {bandwidth = 100 : i32}
+
+    %m11 = aie.memtile_dma(%t11) {
+      %s0 = aie.dma_start(MM2S, 0, ^bd0, ^dma1)
+    ^bd0:
+      aie.use_lock(%a_cons, AcquireGreaterEqual, 1)
+      aie.dma_bd(%a0 : memref<16xi32>, 0, 16)
+      aie.use_lock(%a_prod, Release, 1)
+      aie.next_bd ^bd1
+    ^bd1:
+      aie.use_lock(%a_cons, AcquireGreaterEqual, 1)
+      aie.dma_bd(%a1 : memref<16xi32>, 0, 16)
+      aie.use_lock(%a_prod, Release, 1)
+      aie.next_bd ^bd0
+    ^dma1:
+      %s1 = aie.dma_start(MM2S, 1, ^bd2, ^end)
+    ^bd2:
+      aie.use_lock(%b_cons, AcquireGreaterEqual, 1)
+      aie.dma_bd(%b0 : memref<16xi32>, 0, 16)
+      aie.use_lock(%b_prod, Release, 1)
+      aie.next_bd ^bd3
+    ^bd3:
+      aie.use_lock(%b_cons, AcquireGreaterEqual, 1)
+      aie.dma_bd(%b1 : memref<16xi32>, 0, 16)
+      aie.use_lock(%b_prod, Release, 1)
+      aie.next_bd ^bd2
+    ^end:
+      aie.end
+    }
+  }
+}
@@ -0,0 +1,41 @@
+//===- serve.mlir ----------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// The requests served by one process share its context.
+
+// RUN: printf '%%s\n' \
+// RUN:   '{"pipeline": "builtin.module(aie.device(aie-assign-lock-ids))", "input": "%s", "output": "%t.locks.mlir"}' \
+// RUN:   '{"pipeline": "builtin.module(aie-no-such-pass)", "input": "%s", "output": "%t.none.mlir"}' \
+// RUN:   '{"pipeline": "builtin.module(canonicalize)", "input": "%t.locks.mlir", "output": "%t.mlirbc", "bytecode": true}' \
+// RUN:   | aie-opt --serve | FileCheck %s --check-prefix=OPT
+// RUN: FileCheck %s --check-prefix=LOCKS < %t.locks.mlir
+// RUN: printf '%%s\n' \
+// RUN:   '{"translation": "aie-generate-target-arch", "input": "%t.mlirbc", "output": "%t.arch"}' \
+// RUN:   '{"translation": "aie-no-such-translation", "input": "%s", "output": "%t.none"}' \
+// RUN:   | aie-translate --serve | FileCheck %s --check-prefix=TRANSLATE
+// RUN: FileCheck %s --check-prefix=ARCH < %t.arch
+
+// OPT: {"diagnostics":"","success":true}
+// OPT-NEXT: {"diagnostics":"{{.*}}aie-no-such-pass{{.*}}","success":false}
+// OPT-NEXT: {"diagnostics":"","success":true}
+
+// LOCKS: aie.lock(%{{.*}}, 0)
+// LOCKS: aie.lock(%{{.*}}, 1)
+
+// TRANSLATE: {"diagnostics":"","success":true}
+// TRANSLATE-NEXT: {"diagnostics":"unknown translation 'aie-no-such-translation'\n","success":false}
+
+// ARCH: AIE2
+
+aie.device(xcve2802) {
+  %t = aie.tile(2, 3)
+  %l0 = aie.lock(%t)
+  %l1 = aie.lock(%t)
+}
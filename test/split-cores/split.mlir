@@ -0,0 +1,77 @@
+//===- split.mlir ----------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Xilinx Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-split-cores %s | FileCheck %s
+
+// Each core only keeps the tiles, buffers and locks it uses, the kernel
+// declaration, and none of the configuration of the device.
+// CHECK-LABEL: module @core_1_1
+// CHECK:   aie.device(xcvc1902)
+// CHECK-NEXT: %[[T11:.*]] = aie.tile(1, 1)
+// CHECK-NEXT: %[[LOCK:.*]] = aie.lock(%[[T11]], 8)
+// CHECK-NEXT: %[[A:.*]] = aie.buffer(%[[T11]]) {sym_name = "a"}
+// CHECK-NEXT: func.func private @kernel(memref<256xi32>)
+// CHECK-NEXT: aie.core(%[[T11]])
+// CHECK:        aie.use_lock(%[[LOCK]], Acquire, 0)
+// CHECK:        func.call @kernel(%[[A]])
+// CHECK-NOT:  aie.tile
+// CHECK-NOT:  aie.flow
+// CHECK-NOT:  aie.mem
+// CHECK-LABEL: module @core_1_2
+// CHECK:   aie.device(xcvc1902)
+// CHECK-NEXT: %[[T11:.*]] = aie.tile(1, 1)
+// CHECK-NEXT: %[[T12:.*]] = aie.tile(1, 2)
+// CHECK-NEXT: %[[LOCK:.*]] = aie.lock(%[[T11]], 8)
+// CHECK-NEXT: %[[A:.*]] = aie.buffer(%[[T11]]) {sym_name = "a"}
+// CHECK-NOT:  aie.buffer
+// CHECK:      func.func private @kernel(memref<256xi32>)
+// CHECK-NEXT: aie.core(%[[T12]])
+// CHECK:        aie.use_lock(%[[LOCK]], Acquire, 1)
+// CHECK:        memref.load %[[A]]
+// CHECK-NOT:  aie.flow
+module @split {
+  aie.device(xcvc1902) {
+    %tile11 = aie.tile(1, 1)
+    %tile12 = aie.tile(1, 2)
+    %tile21 = aie.tile(2, 1)
+
+    %lock11_8 = aie.lock(%tile11, 8)
+    %buf11_0 = aie.buffer(%tile11) { sym_name = "a" } : memref<256xi32>
+    %buf12_0 = aie.buffer(%tile12) { sym_name = "b" } : memref<256xi32>
+
+    func.func private @kernel(%buf : memref<256xi32>)
+
+    aie.flow(%tile11, DMA : 0, %tile21, DMA : 0)
+
+    %mem11 = aie.mem(%tile11) {
+      %dma = aie.dma_start(MM2S, 0, ^bd0, ^end)
+    ^bd0:
+      aie.dma_bd(%buf11_0 : memref<256xi32>, 0, 256)
+      aie.next_bd ^end
+    ^end:
+      aie.end
+    }
+
+    %core11 = aie.core(%tile11) {
+      aie.use_lock(%lock11_8, Acquire, 0)
+      func.call @kernel(%buf11_0) : (memref<256xi32>) -> ()
+      aie.use_lock(%lock11_8, Release, 1)
+      aie.end
+    }
+
+    %core12 = aie.core(%tile12) {
+      aie.use_lock(%lock11_8, Acquire, 1)
+      %idx1 = arith.constant 16 : index
+      %val = memref.load %buf11_0[%idx1] : memref<256xi32>
+      aie.use_lock(%lock11_8, Release, 0)
+      aie.end
+    }
+  }
+}
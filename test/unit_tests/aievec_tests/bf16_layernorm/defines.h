@@ -0,0 +1,6 @@
+#pragma once
+constexpr unsigned const IN0_SIZE = 256;
+constexpr unsigned const IN1_SIZE = 256;
+constexpr unsigned const IN2_SIZE = 256;
+constexpr unsigned const OUT0_SIZE = 256;
+constexpr float const EPSILON = 1e-5f;
@@ -0,0 +1,7 @@
+#include "defines.h"
+#include "nn_ops.h"
+
+void dut(bfloat16 *restrict in0, bfloat16 *restrict in1,
+         bfloat16 *restrict in2, bfloat16 *restrict out0) {
+  layerNormBf16(in0, in1, in2, out0, IN0_SIZE, EPSILON);
+}
@@ -0,0 +1,72 @@
+#include "../common/testbench.h"
+#include "defines.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+void dut(bfloat16 *restrict in0, bfloat16 *restrict in1,
+         bfloat16 *restrict in2, bfloat16 *restrict out0);
+void dut_ref(bfloat16 *in0, bfloat16 *in1, bfloat16 *in2, bfloat16 *out0);
+
+alignas(32) bfloat16 g_in0[IN0_SIZE];
+alignas(32) bfloat16 g_in1[IN1_SIZE];
+alignas(32) bfloat16 g_in2[IN2_SIZE];
+alignas(32) bfloat16 g_out0[OUT0_SIZE];
+alignas(32) bfloat16 g_out0Ref[OUT0_SIZE];
+
+int main(int argc, char *argv[]) {
+  std::string dataDir(TO_STR(DATA_DIR));
+  srand(10);
+  std::generate(g_in0, g_in0 + IN0_SIZE,
+                [&]() { return random_bfloat16(-2, 0, 2); });
+  std::generate(g_in1, g_in1 + IN1_SIZE,
+                [&]() { return random_bfloat16(-1, 0, 2); });
+  std::generate(g_in2, g_in2 + IN2_SIZE,
+                [&]() { return random_bfloat16(-2, 0, 2); });
+
+  writeData(g_in0, IN0_SIZE, dataDir + "/in0.txt");
+  writeData(g_in1, IN1_SIZE, dataDir + "/in1.txt");
+  writeData(g_in2, IN2_SIZE, dataDir + "/in2.txt");
+
+  chess_memory_fence();
+  auto cyclesBegin = chess_cycle_count();
+  dut(g_in0, g_in1, g_in2, g_out0);
+  auto cyclesEnd = chess_cycle_count();
+  chess_memory_fence();
+
+  auto cycleCount = (int)(cyclesEnd - cyclesBegin);
+  reportCycleCount(cycleCount, dataDir + "/cycle_count.txt");
+
+  writeData(g_out0, OUT0_SIZE, dataDir + "/out0.txt");
+
+  dut_ref(g_in0, g_in1, g_in2, g_out0Ref);
+  writeData(g_out0Ref, OUT0_SIZE, dataDir + "/out0_ref.txt");
+
+  bool ok = true;
+  ok &= checkData(g_out0, g_out0Ref, OUT0_SIZE, 0, 3e-2, 5e-2);
+
+  if (ok)
+    printf("TEST PASSED\n");
+  else
+    printf("TEST FAILED\n");
+
+  return ok ? 0 : 1;
+}
+
+void dut_ref(bfloat16 *in0, bfloat16 *in1, bfloat16 *in2, bfloat16 *out0) {
+  float sum = 0.0f;
+  for (unsigned k = 0; k < IN0_SIZE; ++k)
+    sum += in0[k];
+  float mean = sum / IN0_SIZE;
+
+  float var = 0.0f;
+  for (unsigned k = 0; k < IN0_SIZE; ++k)
+    var += ((float)in0[k] - mean) * ((float)in0[k] - mean);
+  var /= IN0_SIZE;
+
+  float rstd = 1.0f / sqrt(var + EPSILON);
+  for (unsigned k = 0; k < IN0_SIZE; ++k)
+    out0[k] = (bfloat16)(((float)in0[k] - mean) * rstd * in1[k] + in2[k]);
+}
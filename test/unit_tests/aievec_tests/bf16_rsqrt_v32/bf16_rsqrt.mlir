@@ -8,6 +8,7 @@
 // RUN: mkdir -p data
 // RUN: xca_udm_dbg --aiearch aie-ml -qf -T -P %aietools/data/aie_ml/lib/ -t "%S/../profiling.tcl ./work/a.out" >& xca_udm_dbg.stdout
 // RUN: FileCheck --input-file=./xca_udm_dbg.stdout %s
+// RUN: %PYTHON %S/../check_cycles.py --test %S xca_udm_dbg.stdout
 // CHECK: TEST PASSED
 // Cycle count: 1040
 
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 Advanced Micro Devices, Inc.
+"""Compare the cycles of an AIEVec kernel with its checked-in baseline.
+
+The testbench of each test prints the cycles of the vectorized kernel under
+the ISS with reportCycleCount.  This reads them from the simulator output
+and compares them with the entry of the test in cycle_baselines.json, keyed
+by the directory of the test:
+
+    check_cycles.py --test %S xca_udm_dbg.stdout
+
+A kernel more than --tolerance slower than its baseline fails the test, so
+the performance impact of a vectorizer change shows up next to its effect
+on correctness.  A kernel faster by as much is reported, as a hint to
+refresh its baseline.  A test without a baseline only prints its cycles:
+--update, or running the tests with lit -Dupdate_cycle_baselines=1, records
+the cycles measured as the new baseline of the test.  Tests running several
+kernels name each one with --variant.
+"""
+
+import argparse
+import fcntl
+import json
+import os
+import re
+import sys
+
+BASELINES = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                         "cycle_baselines.json")
+
+
+def read_cycles(path):
+    with open(path) as f:
+        counts = re.findall(r"^Cycle count: (\d+)$", f.read(), re.MULTILINE)
+    return int(counts[-1]) if counts else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("output", help="output of the simulator")
+    parser.add_argument("--test", required=True, help="directory of the test")
+    parser.add_argument("--baselines", default=BASELINES)
+    parser.add_argument("--tolerance", type=float, default=0.05,
+                        help="relative change allowed (default: 0.05)")
+    parser.add_argument("--variant",
+                        help="name of the kernel, for tests running several")
+    parser.add_argument("--update", action="store_true",
+                        default=bool(os.environ.get(
+                            "AIEVEC_UPDATE_CYCLE_BASELINES")),
+                        help="record the cycles as the baseline of the test")
+    args = parser.parse_args()
+
+    name = os.path.basename(os.path.normpath(args.test))
+    if args.variant:
+        name += "/" + args.variant
+    cycles = read_cycles(args.output)
+    if cycles is None:
+        print(f"{name}: no cycle count in {args.output}", file=sys.stderr)
+        return 1
+
+    if args.update:
+        # lit runs the tests in parallel, each updating its own entry.
+        with open(args.baselines, "r+") as f:
+            fcntl.flock(f, fcntl.LOCK_EX)
+            baselines = json.load(f)
+            baselines[name] = cycles
+            f.seek(0)
+            f.truncate()
+            json.dump(baselines, f, indent=2, sort_keys=True)
+            f.write("\n")
+        print(f"{name}: baseline set to {cycles} cycles")
+        return 0
+
+    with open(args.baselines) as f:
+        fcntl.flock(f, fcntl.LOCK_SH)
+        baselines = json.load(f)
+    baseline = baselines.get(name)
+    if baseline is None:
+        print(f"{name}: {cycles} cycles, no baseline to compare with: "
+              f"record one with --update")
+        return 0
+    change = (cycles - baseline) / baseline
+    print(f"{name}: {cycles} cycles, baseline {baseline} ({change:+.1%})")
+    if change > args.tolerance:
+        print(f"{name}: slower than its baseline by more than "
+              f"{args.tolerance:.0%}", file=sys.stderr)
+        return 1
+    if change < -args.tolerance:
+        print(f"{name}: faster than its baseline, consider updating it "
+              f"with --update")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -235,6 +235,9 @@ bool checkData<cint32>(cint32 const *data, cint32 const *expected, unsigned num,
                             2 * num, absTol, relTol, absTolF);
 }
 
+// Report the cycles of the kernel under test. check_cycles.py reads the
+// "Cycle count" line from the simulator output to compare it with the
+// baseline of the test.
 inline void reportCycleCount(int count, std::string const &filename) {
 #ifdef __chess__
   printf("Cycle count: %d\n", count);
@@ -0,0 +1,50 @@
+//===- coalesce_loads.mlir -------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2024 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-vector-opt=coalesce-loads %s | FileCheck %s
+
+// The two 256-bit reads of consecutive elements become one 512-bit load.
+// CHECK-LABEL: func.func @consecutive
+// CHECK:     %[[WIDE:.*]] = vector.load %{{.*}} : memref<64xi32>, vector<16xi32>
+// CHECK-NOT: vector.load
+// CHECK-DAG: vector.extract_strided_slice %[[WIDE]] {offsets = [0], sizes = [8], strides = [1]}
+// CHECK-DAG: vector.extract_strided_slice %[[WIDE]] {offsets = [8], sizes = [8], strides = [1]}
+func.func @consecutive(%buf: memref<64xi32>, %i: index) -> vector<8xi32> {
+  %c8 = arith.constant 8 : index
+  %pad = arith.constant 0 : i32
+  %a = vector.transfer_read %buf[%i], %pad {in_bounds = [true]} : memref<64xi32>, vector<8xi32>
+  %j = arith.addi %i, %c8 : index
+  %b = vector.transfer_read %buf[%j], %pad {in_bounds = [true]} : memref<64xi32>, vector<8xi32>
+  %sum = arith.addi %a, %b : vector<8xi32>
+  return %sum : vector<8xi32>
+}
+
+// A store between the reads may change the second vector, and two 512-bit
+// reads don't fit in one load.
+// CHECK-LABEL: func.func @not_coalesced
+// CHECK-COUNT-2: vector.load %{{.*}} : memref<64xi32>, vector<8xi32>
+// CHECK-COUNT-2: vector.load %{{.*}} : memref<64xi32>, vector<16xi32>
+// CHECK-NOT: vector.extract_strided_slice
+func.func @not_coalesced(%buf: memref<64xi32>, %v: vector<8xi32>) -> vector<16xi32> {
+  %c0 = arith.constant 0 : index
+  %c4 = arith.constant 4 : index
+  %c8 = arith.constant 8 : index
+  %c16 = arith.constant 16 : index
+  %c32 = arith.constant 32 : index
+  %pad = arith.constant 0 : i32
+  %a = vector.transfer_read %buf[%c0], %pad {in_bounds = [true]} : memref<64xi32>, vector<8xi32>
+  vector.transfer_write %v, %buf[%c4] {in_bounds = [true]} : vector<8xi32>, memref<64xi32>
+  %b = vector.transfer_read %buf[%c8], %pad {in_bounds = [true]} : memref<64xi32>, vector<8xi32>
+  %c = vector.transfer_read %buf[%c16], %pad {in_bounds = [true]} : memref<64xi32>, vector<16xi32>
+  %d = vector.transfer_read %buf[%c32], %pad {in_bounds = [true]} : memref<64xi32>, vector<16xi32>
+  %ab = arith.addi %a, %b : vector<8xi32>
+  %cd = arith.addi %c, %d : vector<16xi32>
+  return %cd : vector<16xi32>
+}
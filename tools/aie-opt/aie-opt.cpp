@@ -8,9 +8,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "mlir/Bytecode/BytecodeWriter.h"
 #include "mlir/InitAllDialects.h"
 #include "mlir/InitAllExtensions.h"
 #include "mlir/InitAllPasses.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "mlir/Support/FileUtilities.h"
 #include "mlir/Tools/mlir-opt/MlirOptMain.h"
 
 #include "aie/Conversion/Passes.h"
@@ -22,9 +27,106 @@
 #include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
 #include "aie/InitialAllDialect.h"
 
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ToolOutputFile.h"
+
+#include <iostream>
+
 using namespace llvm;
 using namespace mlir;
 
+// Run the pass pipeline of a request of the server on its input file and
+// write the result to its output file, reporting the errors to `os`.
+static LogicalResult serveRequest(MLIRContext &context, StringRef line,
+                                  raw_ostream &os) {
+  Expected<json::Value> request = json::parse(line);
+  if (!request) {
+    os << "invalid request: " << toString(request.takeError()) << "\n";
+    return failure();
+  }
+  json::Object *object = request->getAsObject();
+  std::optional<StringRef> pipeline, input, output;
+  if (object) {
+    pipeline = object->getString("pipeline");
+    input = object->getString("input");
+    output = object->getString("output");
+  }
+  if (!pipeline || !input || !output) {
+    os << "invalid request: expected an object with a pipeline, an input and "
+          "an output\n";
+    return failure();
+  }
+  bool bytecode = object->getBoolean("bytecode").value_or(false);
+
+  FailureOr<OpPassManager> parsed = parsePassPipeline(*pipeline, os);
+  if (failed(parsed))
+    return failure();
+  if (parsed->getOpName() != ModuleOp::getOperationName()) {
+    os << "the pipeline must be anchored on '" << ModuleOp::getOperationName()
+       << "'\n";
+    return failure();
+  }
+  PassManager pm(&context);
+  static_cast<OpPassManager &>(pm) = std::move(*parsed);
+
+  std::string errorMessage;
+  std::unique_ptr<MemoryBuffer> file = openInputFile(*input, &errorMessage);
+  if (!file) {
+    os << errorMessage << "\n";
+    return failure();
+  }
+  SourceMgr sourceMgr;
+  sourceMgr.AddNewSourceBuffer(std::move(file), SMLoc());
+  SourceMgrDiagnosticHandler handler(sourceMgr, &context, os);
+  OwningOpRef<ModuleOp> module =
+      parseSourceFile<ModuleOp>(sourceMgr, ParserConfig(&context));
+  if (!module || failed(pm.run(*module)))
+    return failure();
+
+  std::unique_ptr<ToolOutputFile> outputFile =
+      openOutputFile(*output, &errorMessage);
+  if (!outputFile) {
+    os << errorMessage << "\n";
+    return failure();
+  }
+  if (bytecode) {
+    if (failed(writeBytecodeToFile(*module, outputFile->os())))
+      return failure();
+  } else {
+    module->print(outputFile->os());
+  }
+  outputFile->keep();
+  return success();
+}
+
+// Serve the requests read from stdin, one JSON object per line:
+//
+//   {"pipeline": "builtin.module(...)", "input": "in.mlir",
+//    "output": "out.mlir", "bytecode": false}
+//
+// and answer each of them on stdout with one JSON object on a line giving
+// its "success" and the "diagnostics" it produced. All the requests share a
+// context in which the dialects are loaded once, which spares the scripts
+// running many small compilations the startup of a process for each of them.
+static int serve(DialectRegistry &registry) {
+  MLIRContext context(registry);
+  context.loadAllAvailableDialects();
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    if (StringRef(line).trim().empty())
+      continue;
+    std::string diagnostics;
+    raw_string_ostream os(diagnostics);
+    bool success = succeeded(serveRequest(context, line, os));
+    json::Object response{{"success", success},
+                          {"diagnostics", std::move(os.str())}};
+    outs() << json::Value(std::move(response)) << "\n";
+    outs().flush();
+  }
+  return 0;
+}
+
 int main(int argc, char **argv) {
 
   registerAllPasses();
@@ -43,6 +145,9 @@ int main(int argc, char **argv) {
 
   xilinx::aievec::registerTransformDialectExtension(registry);
 
+  if (argc == 2 && StringRef(argv[1]) == "--serve")
+    return serve(registry);
+
   return failed(
       MlirOptMain(argc, argv, "MLIR modular optimizer driver\n", registry));
 }
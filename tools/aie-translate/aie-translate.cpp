@@ -10,15 +10,24 @@
 
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIEVec/IR/AIEVecDialect.h"
+#include "aie/InitialAllDialect.h"
 #include "aie/Target/LLVMIR/Dialect/All.h"
 #include "mlir/Dialect/DLTI/DLTI.h"
+#include "mlir/InitAllDialects.h"
 #include "mlir/InitAllTranslations.h"
+#include "mlir/Support/FileUtilities.h"
 #include "mlir/Support/LogicalResult.h"
 #include "mlir/Target/LLVMIR/Dialect/All.h"
 #include "mlir/Target/LLVMIR/Export.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 #include "mlir/Tools/mlir-translate/Translation.h"
 
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ToolOutputFile.h"
+
+#include <iostream>
+
 using namespace mlir;
 
 namespace aie {
@@ -44,6 +53,91 @@ void registerToLLVMIRTranslation() {
 }
 } // namespace aie
 
+using TranslationOption =
+    llvm::cl::opt<const Translation *, false, TranslationParser>;
+
+// Run the translation of a request of the server on its input file and write
+// the result to its output file, reporting the errors to `os`.
+static LogicalResult serveRequest(MLIRContext &context,
+                                  TranslationOption &translations,
+                                  StringRef line, raw_ostream &os) {
+  llvm::Expected<llvm::json::Value> request = llvm::json::parse(line);
+  if (!request) {
+    os << "invalid request: " << llvm::toString(request.takeError()) << "\n";
+    return failure();
+  }
+  llvm::json::Object *object = request->getAsObject();
+  std::optional<StringRef> name, input, output;
+  if (object) {
+    name = object->getString("translation");
+    input = object->getString("input");
+    output = object->getString("output");
+  }
+  if (!name || !input || !output) {
+    os << "invalid request: expected an object with a translation, an input "
+          "and an output\n";
+    return failure();
+  }
+
+  const Translation *translation = nullptr;
+  if (translations.getParser().parse(translations, *name, *name,
+                                     translation)) {
+    os << "unknown translation '" << *name << "'\n";
+    return failure();
+  }
+
+  std::string errorMessage;
+  auto file = openInputFile(*input, &errorMessage);
+  if (!file) {
+    os << errorMessage << "\n";
+    return failure();
+  }
+  auto outputFile = openOutputFile(*output, &errorMessage);
+  if (!outputFile) {
+    os << errorMessage << "\n";
+    return failure();
+  }
+  auto sourceMgr = std::make_shared<llvm::SourceMgr>();
+  sourceMgr->AddNewSourceBuffer(std::move(file), SMLoc());
+  SourceMgrDiagnosticHandler handler(*sourceMgr, &context, os);
+  if (failed((*translation)(sourceMgr, outputFile->os(), &context)))
+    return failure();
+  outputFile->keep();
+  return success();
+}
+
+// Serve the requests read from stdin, one JSON object per line:
+//
+//   {"translation": "aie-generate-mmap", "input": "in.mlir",
+//    "output": "out.txt"}
+//
+// and answer each of them on stdout with one JSON object on a line giving
+// its "success" and the "diagnostics" it produced, as aie-opt --serve does.
+// All the requests share a context in which the dialects are loaded once.
+static int serve() {
+  DialectRegistry registry;
+  registerAllDialects(registry);
+  xilinx::registerAllDialects(registry);
+  MLIRContext context(registry);
+  context.loadAllAvailableDialects();
+  // The translations are looked up by name as on the command line, which is
+  // not parsed in this mode.
+  TranslationOption translations(llvm::cl::ReallyHidden);
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    if (StringRef(line).trim().empty())
+      continue;
+    std::string diagnostics;
+    llvm::raw_string_ostream os(diagnostics);
+    bool success = succeeded(serveRequest(context, translations, line, os));
+    llvm::json::Object response{{"success", success},
+                                {"diagnostics", std::move(os.str())}};
+    llvm::outs() << llvm::json::Value(std::move(response)) << "\n";
+    llvm::outs().flush();
+  }
+  return 0;
+}
+
 int main(int argc, char **argv) {
   // NOTE: these are the contents of registerAllTranslations();
   registerFromLLVMIRTranslation();
@@ -55,5 +149,8 @@ int main(int argc, char **argv) {
   xilinx::AIE::registerAIETranslations();
   xilinx::aievec::registerAIEVecToCppTranslation();
 
+  if (argc == 2 && StringRef(argv[1]) == "--serve")
+    return serve();
+
   return failed(mlirTranslateMain(argc, argv, "AIE Translation Tool"));
 }
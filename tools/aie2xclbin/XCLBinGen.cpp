@@ -23,6 +23,7 @@
 #include "mlir/Conversion/MemRefToLLVM/MemRefToLLVM.h"
 #include "mlir/Conversion/SCFToControlFlow/SCFToControlFlow.h"
 #include "mlir/Conversion/VectorToLLVM/ConvertVectorToLLVMPass.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/MemRef/Transforms/Passes.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/Pass/PassManager.h"
@@ -30,14 +31,25 @@
 #include "mlir/Target/LLVMIR/Export.h"
 #include "mlir/Transforms/Passes.h"
 
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Object/Archive.h"
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Object/ObjectFile.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/LEB128.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
+#include "llvm/Support/SHA256.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 
+#include <limits>
 #include <regex>
+#include <set>
 #include <unordered_map>
 
 #ifdef _WIN32
@@ -126,16 +138,17 @@ static void addLowerToLLVMPasses(OpPassManager &pm) {
 }
 
 int runTool(StringRef Program, ArrayRef<std::string> Args, bool Verbose,
-            std::optional<ArrayRef<StringRef>> Env = std::nullopt) {
+            std::optional<ArrayRef<StringRef>> Env = std::nullopt,
+            raw_ostream &OS = llvm::outs()) {
   if (Verbose) {
-    llvm::outs() << "Run:";
+    OS << "Run:";
     if (Env)
       for (auto &s : *Env)
-        llvm::outs() << " " << s;
-    llvm::outs() << " " << Program;
+        OS << " " << s;
+    OS << " " << Program;
     for (auto &s : Args)
-      llvm::outs() << " " << s;
-    llvm::outs() << "\n";
+      OS << " " << s;
+    OS << "\n";
   }
   std::string err_msg;
   sys::ProcessStatistics stats;
@@ -145,14 +158,76 @@ int runTool(StringRef Program, ArrayRef<std::string> Args, bool Verbose,
   int result = sys::ExecuteAndWait(Program, PArgs, Env, {}, 0, 0, &err_msg,
                                    nullptr, &opt_stats);
   if (Verbose)
-    llvm::outs() << (result == 0 ? "Succeeded " : "Failed ") << "in "
-                 << std::chrono::duration_cast<std::chrono::duration<float>>(
-                        stats.TotalTime)
-                        .count()
-                 << " code: " << result << "\n";
+    OS << (result == 0 ? "Succeeded " : "Failed ") << "in "
+       << std::chrono::duration_cast<std::chrono::duration<float>>(
+              stats.TotalTime)
+              .count()
+       << " code: " << result << "\n";
   return result;
 }
 
+// Compute the key of an entry in the compile cache from the command line
+// \p parts and the contents of the input \p files.  Paths into the temporary
+// directory are made relative, so that rebuilds in a fresh directory still
+// hit.  Returns an empty key if caching is disabled or an input is missing.
+static std::string computeCacheKey(const XCLBinGenConfig &TK,
+                                   ArrayRef<std::string> parts,
+                                   ArrayRef<std::string> files) {
+  if (TK.CacheDir.empty())
+    return "";
+  SHA256 hasher;
+  auto addPart = [&hasher](StringRef part) {
+    hasher.update(part);
+    hasher.update(ArrayRef<uint8_t>{0});
+  };
+  addPart(TK.TargetArch);
+  addPart(TK.UseChess ? "chess" : "peano");
+  addPart(TK.PeanoDir);
+  addPart(TK.AIEToolsDir);
+  for (const auto &part : parts) {
+    std::string relPart = part;
+    for (size_t pos = relPart.find(TK.TempDir); pos != std::string::npos;
+         pos = relPart.find(TK.TempDir, pos))
+      relPart.erase(pos, TK.TempDir.size());
+    addPart(relPart);
+  }
+  for (const auto &file : files) {
+    auto buffer = MemoryBuffer::getFile(file);
+    if (!buffer)
+      return "";
+    addPart((*buffer)->getBuffer());
+  }
+  return toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+// Copy the cached entry \p key to \p dest.  Returns true on a cache hit.
+static bool fetchFromCache(const XCLBinGenConfig &TK, StringRef key,
+                           StringRef dest) {
+  if (key.empty())
+    return false;
+  SmallString<64> cached(TK.CacheDir);
+  sys::path::append(cached, key);
+  if (!sys::fs::exists(cached))
+    return false;
+  return !sys::fs::copy_file(cached, dest);
+}
+
+// Record \p src as the cached entry \p key.  The entry is written to a
+// unique file first and renamed into place, so that concurrent builds sharing
+// a cache never observe a partial file.
+static void storeToCache(const XCLBinGenConfig &TK, StringRef key,
+                         StringRef src) {
+  if (key.empty())
+    return;
+  SmallString<64> cached(TK.CacheDir);
+  sys::path::append(cached, key);
+  SmallString<64> tmp;
+  sys::fs::createUniquePath(cached + "-%%%%%%.tmp", tmp,
+                            /*MakeAbsolute=*/false);
+  if (sys::fs::copy_file(src, tmp) || sys::fs::rename(tmp, cached))
+    sys::fs::remove(tmp);
+}
+
 template <unsigned N>
 static void aieTargetDefines(SmallVector<std::string, N> &Args,
                              std::string aie_target) {
@@ -162,6 +237,230 @@ static void aieTargetDefines(SmallVector<std::string, N> &Args,
     Args.push_back("-D__AIEARCH__=10");
 }
 
+namespace {
+// A single link step producing the ELF file of one core.  Jobs are prepared
+// serially (they need the IR), run concurrently, and reported in tile order.
+struct CoreElfJob {
+  AIE::CoreOp coreOp;
+  int col;
+  int row;
+  std::string program;
+  SmallVector<std::string> flags;
+  std::string errorMessage;
+  std::string elfFile;
+  std::string cacheKey;
+  // Filled in by the worker.
+  std::string log;
+  int result = 0;
+};
+
+// A precompiled kernel library, with the symbols defined by its objects.  A
+// library without a symbol table is linked with every core.
+struct KernelLib {
+  std::string path;
+  std::optional<StringSet<>> symbols;
+};
+} // namespace
+
+// Find the kernel libraries of the configuration, given by path or by name as
+// lib<name>.a in the first kernel library directory which has it, the kernels
+// installed for the target being searched last, and read their symbols.
+static LogicalResult findKernelLibs(ModuleOp moduleOp,
+                                    const XCLBinGenConfig &TK,
+                                    std::vector<KernelLib> &libs) {
+  std::vector<std::string> dirs = TK.KernelLibDirs;
+  SmallString<64> installed(TK.InstallDir);
+  sys::path::append(installed, "aie_runtime_lib", TK.TargetArch, "kernels");
+  dirs.emplace_back(std::string(installed));
+
+  for (const std::string &name : TK.KernelLibs) {
+    std::string path;
+    if (sys::fs::is_regular_file(name)) {
+      path = name;
+    } else {
+      for (const std::string &dir : dirs) {
+        SmallString<64> candidate(dir);
+        sys::path::append(candidate, "lib" + name + ".a");
+        if (sys::fs::is_regular_file(candidate)) {
+          path = std::string(candidate);
+          break;
+        }
+      }
+    }
+    if (path.empty())
+      return moduleOp.emitOpError("kernel library ") << name << " not found";
+
+    auto buffer = MemoryBuffer::getFile(path);
+    if (!buffer)
+      return moduleOp.emitOpError("failed to read ")
+             << path << ": " << buffer.getError().message();
+    auto archive = object::Archive::create((*buffer)->getMemBufferRef());
+    if (!archive)
+      return moduleOp.emitOpError("failed to read the archive ")
+             << path << ": " << toString(archive.takeError());
+    KernelLib &lib = libs.emplace_back();
+    lib.path = path;
+    StringSet<> symbols;
+    for (const object::Archive::Symbol &symbol : (*archive)->symbols())
+      symbols.insert(symbol.getName());
+    if (!symbols.empty())
+      lib.symbols = std::move(symbols);
+  }
+  return success();
+}
+
+// The kernel libraries defining a function declared without a body which the
+// core calls.  The linker only pulls the objects of a library defining the
+// symbols referenced.
+static SmallVector<std::string>
+getCoreKernelLibs(AIE::CoreOp coreOp, ArrayRef<KernelLib> libs) {
+  StringSet<> calls;
+  coreOp.walk([&](func::CallOp call) {
+    auto callee = SymbolTable::lookupNearestSymbolFrom<func::FuncOp>(
+        call, call.getCalleeAttr());
+    if (callee && callee.isExternal())
+      calls.insert(callee.getName());
+  });
+  SmallVector<std::string> paths;
+  for (const KernelLib &lib : libs)
+    if (!lib.symbols || llvm::any_of(calls, [&](const auto &call) {
+          return lib.symbols->contains(call.getKey());
+        }))
+      paths.push_back(lib.path);
+  return paths;
+}
+
+// Prepare the link step (BCF or ld script and tool invocation) for one core.
+static LogicalResult prepareCoreElfJob(ModuleOp moduleOp, AIE::TileOp tileOp,
+                                       AIE::CoreOp coreOp,
+                                       const StringRef objFile,
+                                       ArrayRef<KernelLib> kernelLibs,
+                                       XCLBinGenConfig &TK, CoreElfJob &job) {
+  int col = tileOp.colIndex();
+  int row = tileOp.rowIndex();
+  job.coreOp = coreOp;
+  job.col = col;
+  job.row = row;
+
+  std::string errorMessage;
+  std::string elfFileName;
+  if (auto fileAttr = coreOp.getElfFileAttr()) {
+    elfFileName = std::string(fileAttr.getValue());
+  } else {
+    elfFileName = std::string("core_") + std::to_string(col) + "_" +
+                  std::to_string(row) + ".elf";
+    coreOp.setElfFile(elfFileName);
+  }
+
+  SmallString<64> elfFile(TK.TempDir);
+  sys::path::append(elfFile, elfFileName);
+  job.elfFile = std::string(elfFile);
+  SmallVector<std::string> coreKernelLibs =
+      getCoreKernelLibs(coreOp, kernelLibs);
+  std::vector<std::string> linkedFiles = {std::string(objFile)};
+  llvm::append_range(linkedFiles, coreKernelLibs);
+
+  if (TK.UseChess) {
+    // Use xbridge (to remove any peano dependency with use-chess option)
+    SmallString<64> bcfPath(TK.TempDir);
+    sys::path::append(bcfPath, elfFileName + ".bcf");
+
+    {
+      auto bcfOutput = openOutputFile(bcfPath, &errorMessage);
+      if (!bcfOutput)
+        return coreOp.emitOpError(errorMessage);
+
+      if (failed(AIE::AIETranslateToBCF(moduleOp, bcfOutput->os(), col, row)))
+        return coreOp.emitOpError("Failed to generate BCF");
+      bcfOutput->keep();
+    }
+
+    std::vector<std::string> extractedIncludes;
+    {
+      auto bcfFileIn = openInputFile(bcfPath, &errorMessage);
+      if (!bcfFileIn)
+        return moduleOp.emitOpError(errorMessage);
+
+      std::string bcfFile = std::string(bcfFileIn->getBuffer());
+      std::regex r("^_include _file (.*)", std::regex::multiline);
+      auto begin = std::sregex_iterator(bcfFile.begin(), bcfFile.end(), r);
+      auto end = std::sregex_iterator();
+      for (std::sregex_iterator i = begin; i != end; ++i)
+        extractedIncludes.push_back(i->str(1));
+    }
+
+    SmallString<64> chessWrapperBin(TK.InstallDir);
+    sys::path::append(chessWrapperBin, "bin", "xchesscc_wrapper");
+    // The links may run concurrently, so each has its own work directory.
+    SmallString<64> chessworkDir(TK.TempDir);
+    sys::path::append(chessworkDir, "chesswork_" + std::to_string(col) + "_" +
+                                        std::to_string(row));
+
+    job.program = std::string(chessWrapperBin);
+    job.flags = {StringRef(TK.TargetArch).lower(),
+                 "+w",
+                 std::string(chessworkDir),
+                 "-d",
+                 "+l",
+                 std::string(bcfPath),
+                 "-o",
+                 std::string(elfFile),
+                 "-f",
+                 std::string(objFile)};
+    for (const auto &inc : extractedIncludes)
+      job.flags.push_back(inc);
+    llvm::append_range(job.flags, coreKernelLibs);
+    job.errorMessage = "Failed to link with xbridge";
+    linkedFiles.push_back(std::string(bcfPath));
+    job.cacheKey = computeCacheKey(TK, job.flags, linkedFiles);
+    return success();
+  }
+
+  SmallString<64> ldscript_path(TK.TempDir);
+  sys::path::append(ldscript_path, elfFileName + ".ld");
+  {
+    auto ldscript_output = openOutputFile(ldscript_path, &errorMessage);
+    if (!ldscript_output)
+      return coreOp.emitOpError(errorMessage);
+
+    if (failed(AIE::AIETranslateToLdScript(moduleOp, ldscript_output->os(),
+                                           col, row)))
+      return coreOp.emitOpError("failed to generate ld script for core (")
+             << col << "," << row << ")";
+    ldscript_output->keep();
+  }
+
+  // We are running a clang command for now, but really this is an lld
+  // command.
+  std::string targetLower = StringRef(TK.TargetArch).lower();
+  job.flags.push_back("-O2");
+  std::string targetFlag = "--target=" + targetLower + "-none-elf";
+  job.flags.push_back(targetFlag);
+  job.flags.emplace_back(objFile);
+  SmallString<64> meBasicPath(TK.InstallDir);
+  sys::path::append(meBasicPath, "aie_runtime_lib", TK.TargetArch,
+                    "me_basic.o");
+  job.flags.emplace_back(meBasicPath);
+  llvm::append_range(job.flags, coreKernelLibs);
+  SmallString<64> libcPath(TK.PeanoDir);
+  sys::path::append(libcPath, "lib", targetLower + "-none-unknown-elf",
+                    "libc.a");
+  job.flags.emplace_back(libcPath);
+  job.flags.push_back("-Wl,--gc-sections");
+  std::string ldScriptFlag = "-Wl,-T," + std::string(ldscript_path);
+  job.flags.push_back(ldScriptFlag);
+  job.flags.push_back("-o");
+  job.flags.emplace_back(elfFile);
+  SmallString<64> clangBin(TK.PeanoDir);
+  sys::path::append(clangBin, "bin", "clang");
+  job.program = std::string(clangBin);
+  job.errorMessage = "failed to link elf file for core(" +
+                     std::to_string(col) + "," + std::to_string(row) + ")";
+  linkedFiles.push_back(std::string(ldscript_path));
+  job.cacheKey = computeCacheKey(TK, job.flags, linkedFiles);
+  return success();
+}
+
 // Generate the elf files for the core
 static LogicalResult generateCoreElfFiles(ModuleOp moduleOp,
                                           const StringRef objFile,
@@ -173,122 +472,57 @@ static LogicalResult generateCoreElfFiles(ModuleOp moduleOp,
   AIE::DeviceOp deviceOp = *deviceOps.begin();
   auto tileOps = deviceOp.getOps<AIE::TileOp>();
 
-  std::string errorMessage;
+  std::vector<KernelLib> kernelLibs;
+  if (failed(findKernelLibs(moduleOp, TK, kernelLibs)))
+    return failure();
 
+  std::vector<CoreElfJob> jobs;
   for (auto tileOp : tileOps) {
-    int col = tileOp.colIndex();
-    int row = tileOp.rowIndex();
     auto coreOp = tileOp.getCoreOp();
     if (!coreOp)
       continue;
+    CoreElfJob &job = jobs.emplace_back();
+    if (failed(prepareCoreElfJob(moduleOp, tileOp, coreOp, objFile, kernelLibs,
+                                 TK, job)))
+      return failure();
+  }
 
-    std::string elfFileName;
-    if (auto fileAttr = coreOp.getElfFileAttr()) {
-      elfFileName = std::string(fileAttr.getValue());
-    } else {
-      elfFileName = std::string("core_") + std::to_string(col) + "_" +
-                    std::to_string(row) + ".elf";
-      coreOp.setElfFile(elfFileName);
+  auto runJob = [&TK](CoreElfJob &job) {
+    raw_string_ostream logStream(job.log);
+    if (fetchFromCache(TK, job.cacheKey, job.elfFile)) {
+      if (TK.Verbose)
+        logStream << "Using cached " << job.elfFile << "\n";
+      return;
     }
+    job.result =
+        runTool(job.program, job.flags, TK.Verbose, std::nullopt, logStream);
+    if (job.result == 0)
+      storeToCache(TK, job.cacheKey, job.elfFile);
+  };
 
-    SmallString<64> elfFile(TK.TempDir);
-    sys::path::append(elfFile, elfFileName);
-
-    if (TK.UseChess) {
-      // Use xbridge (to remove any peano dependency with use-chess option)
-      SmallString<64> bcfPath(TK.TempDir);
-      sys::path::append(bcfPath, elfFileName + ".bcf");
-
-      {
-        auto bcfOutput = openOutputFile(bcfPath, &errorMessage);
-        if (!bcfOutput)
-          return coreOp.emitOpError(errorMessage);
-
-        if (failed(AIE::AIETranslateToBCF(moduleOp, bcfOutput->os(), col, row)))
-          return coreOp.emitOpError("Failed to generate BCF");
-        bcfOutput->keep();
-      }
-
-      std::vector<std::string> extractedIncludes;
-      {
-        auto bcfFileIn = openInputFile(bcfPath, &errorMessage);
-        if (!bcfFileIn)
-          moduleOp.emitOpError(errorMessage);
-
-        std::string bcfFile = std::string(bcfFileIn->getBuffer());
-        std::regex r("^_include _file (.*)", std::regex::multiline);
-        auto begin = std::sregex_iterator(bcfFile.begin(), bcfFile.end(), r);
-        auto end = std::sregex_iterator();
-        for (std::sregex_iterator i = begin; i != end; ++i)
-          extractedIncludes.push_back(i->str(1));
-      }
-
-      SmallString<64> chessWrapperBin(TK.InstallDir);
-      sys::path::append(chessWrapperBin, "bin", "xchesscc_wrapper");
-      SmallString<64> chessworkDir(TK.TempDir);
-      sys::path::append(chessworkDir, "chesswork");
-
-      SmallVector<std::string> flags{StringRef(TK.TargetArch).lower(),
-                                     "+w",
-                                     std::string(chessworkDir),
-                                     "-d",
-                                     "+l",
-                                     std::string(bcfPath),
-                                     "-o",
-                                     std::string(elfFile),
-                                     "-f",
-                                     std::string(objFile)};
-      for (const auto &inc : extractedIncludes)
-        flags.push_back(inc);
-
-      if (runTool(chessWrapperBin, flags, TK.Verbose) != 0)
-        coreOp.emitOpError("Failed to link with xbridge");
-    } else {
-      SmallString<64> ldscript_path(TK.TempDir);
-      sys::path::append(ldscript_path, elfFileName + ".ld");
-      {
-        auto ldscript_output = openOutputFile(ldscript_path, &errorMessage);
-        if (!ldscript_output)
-          return coreOp.emitOpError(errorMessage);
-
-        if (failed(AIE::AIETranslateToLdScript(moduleOp, ldscript_output->os(),
-                                               col, row)))
-          return coreOp.emitOpError("failed to generate ld script for core (")
-                 << col << "," << row << ")";
-        ldscript_output->keep();
-      }
+  if (TK.NumWorkers == 1 || jobs.size() < 2) {
+    for (auto &job : jobs)
+      runJob(job);
+  } else {
+    ThreadPoolStrategy strategy = TK.NumWorkers == 0
+                                      ? hardware_concurrency()
+                                      : hardware_concurrency(TK.NumWorkers);
+    ThreadPool pool(strategy);
+    for (auto &job : jobs)
+      pool.async(runJob, std::ref(job));
+    pool.wait();
+  }
 
-      // We are running a clang command for now, but really this is an lld
-      // command.
-      {
-        std::string targetLower = StringRef(TK.TargetArch).lower();
-        SmallVector<std::string, 10> flags;
-        flags.push_back("-O2");
-        std::string targetFlag = "--target=" + targetLower + "-none-elf";
-        flags.push_back(targetFlag);
-        flags.emplace_back(objFile);
-        SmallString<64> meBasicPath(TK.InstallDir);
-        sys::path::append(meBasicPath, "aie_runtime_lib", TK.TargetArch,
-                          "me_basic.o");
-        flags.emplace_back(meBasicPath);
-        SmallString<64> libcPath(TK.PeanoDir);
-        sys::path::append(libcPath, "lib", targetLower + "-none-unknown-elf",
-                          "libc.a");
-        flags.emplace_back(libcPath);
-        flags.push_back("-Wl,--gc-sections");
-        std::string ldScriptFlag = "-Wl,-T," + std::string(ldscript_path);
-        flags.push_back(ldScriptFlag);
-        flags.push_back("-o");
-        flags.emplace_back(elfFile);
-        SmallString<64> clangBin(TK.PeanoDir);
-        sys::path::append(clangBin, "bin", "clang");
-        if (runTool(clangBin, flags, TK.Verbose) != 0)
-          return coreOp.emitOpError("failed to link elf file for core(")
-                 << col << "," << row << ")";
-      }
+  // Report in tile order so that the output does not depend on scheduling.
+  bool anyFailed = false;
+  for (auto &job : jobs) {
+    llvm::outs() << job.log;
+    if (job.result != 0) {
+      job.coreOp.emitOpError(job.errorMessage);
+      anyFailed = true;
     }
   }
-  return success();
+  return failure(anyFailed);
 }
 
 static LogicalResult generateCDO(MLIRContext *context, ModuleOp moduleOp,
@@ -397,45 +631,50 @@ static LogicalResult generateXCLBin(MLIRContext *context, ModuleOp moduleOp,
     if (!aiePartitionJsonOut)
       return moduleOp.emitOpError(errorMessage);
 
-    std::string aie_partition_json_data = R"(
-      {
-        "aie_partition": {
-          "name": "QoS",
-          "operations_per_cycle": "2048",
-          "inference_fingerprint": "23423",
-          "pre_post_fingerprint": "12345",
-          "partition": {
-            "column_width": 1,
-            "start_columns": [
-              1,
-              2,
-              3,
-              4
-            ]
-          },
-          "PDIs": [
-            {
-              "uuid": "00000000-0000-0000-0000-000000008025",
-              "file_name": "./design.pdi",
-              "cdo_groups": [
-                {
-                  "name": "DPU",
-                  "type": "PRIMARY",
-                  "pdi_id": "0x01",
-                  "dpu_kernel_ids": [
-                    "0x901"
-                  ],
-                  "pre_cdo_groups": [
-                    "0xC1"
-                  ]
-                }
-              ]
-            }
-          ]
-        }
-      }
-    )";
-    aiePartitionJsonOut->os() << aie_partition_json_data;
+    // The partition spans the columns of the tiles of the design, and can be
+    // loaded at each of the start columns, so that several partitions of the
+    // device can run the design at the same time.
+    int minCol = std::numeric_limits<int>::max(), maxCol = 0;
+    int deviceColumns = 5;
+    for (auto deviceOp : moduleOp.getOps<AIE::DeviceOp>())
+      deviceColumns = deviceOp.getTargetModel().columns();
+    moduleOp.walk([&](AIE::TileOp tileOp) {
+      minCol = std::min(minCol, tileOp.colIndex());
+      maxCol = std::max(maxCol, tileOp.colIndex());
+    });
+    int columnWidth = minCol <= maxCol ? maxCol - minCol + 1 : 1;
+    json::Array startColumns;
+    if (TK.StartColumns.empty()) {
+      for (int col = 1; col + columnWidth <= deviceColumns; col++)
+        startColumns.push_back(col);
+    } else {
+      for (unsigned col : TK.StartColumns)
+        startColumns.push_back(col);
+    }
+
+    json::Object aie_partition_json_data{
+        {"aie_partition",
+         json::Object{
+             {"name", "QoS"},
+             {"operations_per_cycle", "2048"},
+             {"inference_fingerprint", "23423"},
+             {"pre_post_fingerprint", "12345"},
+             {"partition",
+              json::Object{{"column_width", columnWidth},
+                           {"start_columns", std::move(startColumns)}}},
+             {"PDIs",
+              json::Array{json::Object{
+                  {"uuid", "00000000-0000-0000-0000-000000008025"},
+                  {"file_name", "./design.pdi"},
+                  {"cdo_groups",
+                   json::Array{json::Object{
+                       {"name", "DPU"},
+                       {"type", "PRIMARY"},
+                       {"pdi_id", "0x01"},
+                       {"dpu_kernel_ids", json::Array{TK.XCLBinKernelID}},
+                       {"pre_cdo_groups", json::Array{"0xC1"}}}}}}}}}}};
+    aiePartitionJsonOut->os() << formatv(
+        "{0:2}", json::Value(std::move(aie_partition_json_data)));
     aiePartitionJsonOut->keep();
   }
 
@@ -458,6 +697,22 @@ static LogicalResult generateXCLBin(MLIRContext *context, ModuleOp moduleOp,
                                     json::Value(std::move(kernels_data)));
     kernelsJsonOut->keep();
   }
+  // The ELFs of the cores are loaded by one CDO per column.
+  std::set<int> coreColumns;
+  moduleOp.walk(
+      [&](AIE::CoreOp coreOp) { coreColumns.insert(coreOp.getTileID().col); });
+  std::vector<std::string> cdoFiles{"aie_cdo_error_handling.bin"};
+  for (int col : coreColumns)
+    cdoFiles.push_back("aie_cdo_elfs_" + std::to_string(col) + ".bin");
+  cdoFiles.push_back("aie_cdo_init.bin");
+  if (!coreColumns.empty())
+    cdoFiles.push_back("aie_cdo_enable.bin");
+  for (auto &cdoFile : cdoFiles) {
+    SmallString<64> path(TK.TempDir);
+    sys::path::append(path, cdoFile);
+    cdoFile = std::string(path);
+  }
+
   // Create design.bif.
   SmallString<64> designBifFile(TK.TempDir);
   sys::path::append(designBifFile, "design.bif");
@@ -473,19 +728,17 @@ static LogicalResult generateXCLBin(MLIRContext *context, ModuleOp moduleOp,
                        << "\timage\n"
                        << "\t{\n"
                        << "\t\tname=aie_image, id=0x1c000000\n"
-                       << "\t\t{ type=cdo\n"
-                       << "\t\t  file=" << TK.TempDir
-                       << "/aie_cdo_error_handling.bin\n"
-                       << "\t\t  file=" << TK.TempDir << "/aie_cdo_elfs.bin\n"
-                       << "\t\t  file=" << TK.TempDir << "/aie_cdo_init.bin\n"
-                       << "\t\t  file=" << TK.TempDir << "/aie_cdo_enable.bin\n"
-                       << "\t\t}\n"
+                       << "\t\t{ type=cdo\n";
+    for (const auto &cdoFile : cdoFiles)
+      designBifOut->os() << "\t\t  file=" << cdoFile << "\n";
+    designBifOut->os() << "\t\t}\n"
                        << "\t}\n"
                        << "}";
     designBifOut->keep();
   }
 
-  // Execute the bootgen command.
+  // Execute the bootgen command.  The CDOs are only regenerated when their
+  // inputs change, so the PDI packaging them is cached on their contents.
   SmallString<64> designPdiFile(TK.TempDir);
   sys::path::append(designPdiFile, "design.pdi");
   {
@@ -493,11 +746,20 @@ static LogicalResult generateXCLBin(MLIRContext *context, ModuleOp moduleOp,
                                       "-image", std::string(designBifFile),
                                       "-o",     std::string(designPdiFile),
                                       "-w"};
-
-    SmallString<64> bootgenBin(TK.InstallDir);
-    sys::path::append(bootgenBin, "bin", "bootgen");
-    if (runTool(bootgenBin, flags, TK.Verbose) != 0)
-      return moduleOp.emitOpError("failed to execute bootgen");
+    std::vector<std::string> keyParts(flags.begin(), flags.end());
+    keyParts.insert(keyParts.begin(), "bootgen");
+    keyParts.insert(keyParts.end(), cdoFiles.begin(), cdoFiles.end());
+    std::string cacheKey = computeCacheKey(TK, keyParts, cdoFiles);
+    if (fetchFromCache(TK, cacheKey, designPdiFile)) {
+      if (TK.Verbose)
+        llvm::outs() << "Using cached " << designPdiFile << "\n";
+    } else {
+      SmallString<64> bootgenBin(TK.InstallDir);
+      sys::path::append(bootgenBin, "bin", "bootgen");
+      if (runTool(bootgenBin, flags, TK.Verbose) != 0)
+        return moduleOp.emitOpError("failed to execute bootgen");
+      storeToCache(TK, cacheKey, designPdiFile);
+    }
   }
 
   // Execute the xclbinutil command.
@@ -516,12 +778,25 @@ static LogicalResult generateXCLBin(MLIRContext *context, ModuleOp moduleOp,
                                        "--output",
                                        std::string(Output)};
 
+    // The output path doesn't change the contents of the xclbin.
+    std::vector<std::string> keyParts(flags.begin(), flags.end() - 1);
+    keyParts.insert(keyParts.begin(), "xclbinutil");
+    std::string cacheKey = computeCacheKey(
+        TK, keyParts,
+        {std::string(memTopologyJsonFile), std::string(kernelsJsonFile),
+         std::string(aiePartitionJsonFile), std::string(designPdiFile)});
+    if (fetchFromCache(TK, cacheKey, Output)) {
+      if (TK.Verbose)
+        llvm::outs() << "Using cached " << Output << "\n";
+      return success();
+    }
     if (auto xclbinutil = sys::findProgramByName("xclbinutil")) {
       if (runTool(*xclbinutil, flags, TK.Verbose) != 0)
         return moduleOp.emitOpError("failed to execute xclbinutil");
     } else {
       return moduleOp.emitOpError("could not find xclbinutil");
     }
+    storeToCache(TK, cacheKey, Output);
   }
   return success();
 }
@@ -588,6 +863,18 @@ static LogicalResult generateUnifiedObject(MLIRContext *context,
     output->keep();
   }
 
+  std::string cacheKey = computeCacheKey(
+      TK,
+      {"unified-object", TK.InferStackSize ? "stack-size-section" : "",
+       TK.OptimizeForSize ? "optimize-for-size" : ""},
+      {std::string(LLVMIRFile)});
+  if (fetchFromCache(TK, cacheKey, outputFile)) {
+    if (TK.Verbose)
+      llvm::outs() << "Using cached " << outputFile << "\n";
+    copy->erase();
+    return success();
+  }
+
   if (TK.UseChess) {
     SmallString<64> chessWrapperBin(TK.InstallDir);
     sys::path::append(chessWrapperBin, "bin", "xchesscc_wrapper");
@@ -683,24 +970,343 @@ static LogicalResult generateUnifiedObject(MLIRContext *context,
 
     SmallString<64> OptLLVMIRFile(TK.TempDir);
     sys::path::append(OptLLVMIRFile, "input.opt.ll");
-    if (runTool(peanoOptBin,
-                {"-O2", "--inline-threshold=10", "-S", std::string(LLVMIRFile),
-                 "-o", std::string(OptLLVMIRFile)},
-                TK.Verbose) != 0)
+    SmallVector<std::string> optFlags = {"-O2", "--inline-threshold=10"};
+    if (TK.OptimizeForSize)
+      optFlags = {"-Os"};
+    optFlags.append({"-S", std::string(LLVMIRFile), "-o",
+                     std::string(OptLLVMIRFile)});
+    if (runTool(peanoOptBin, optFlags, TK.Verbose) != 0)
       return moduleOp.emitOpError("Failed to optimize");
 
-    if (runTool(peanoLLCBin,
-                {std::string(OptLLVMIRFile), "-O2",
-                 "--march=" + StringRef(TK.TargetArch).lower(),
-                 "--function-sections", "--filetype=obj", "-o",
-                 std::string(outputFile)},
-                TK.Verbose) != 0)
+    SmallVector<std::string> llcFlags = {
+        std::string(OptLLVMIRFile), "-O2",
+        "--march=" + StringRef(TK.TargetArch).lower(), "--function-sections",
+        "--filetype=obj", "-o", outputFile};
+    // The stack frame sizes of the functions are what the stack of each core
+    // is inferred from.
+    if (TK.InferStackSize)
+      llcFlags.push_back("--stack-size-section");
+    if (runTool(peanoLLCBin, llcFlags, TK.Verbose) != 0)
       return moduleOp.emitOpError("Failed to assemble");
   }
+  storeToCache(TK, cacheKey, outputFile);
   copy->erase();
   return success();
 }
 
+// The stack frame of a function of the unified object, and the functions it
+// calls.  A function that references an undefined symbol may call code that
+// is not in the object, so its stack depth is unknown.
+namespace {
+struct StackFrame {
+  std::optional<uint64_t> size;
+  SmallVector<StringRef> callees;
+  bool callsUnknown = false;
+};
+} // namespace
+
+// Read the stack frames of the functions of the object \p objFile, from the
+// .stack_sizes sections emitted by llc and from the relocations of the
+// function sections.
+static LogicalResult readStackFrames(StringRef objFile,
+                                     object::OwningBinary<object::Binary> &bin,
+                                     StringMap<StackFrame> &frames) {
+  auto binOrErr = object::createBinary(objFile);
+  if (!binOrErr) {
+    consumeError(binOrErr.takeError());
+    return failure();
+  }
+  bin = std::move(*binOrErr);
+  auto *obj = dyn_cast<object::ELFObjectFileBase>(bin.getBinary());
+  if (!obj)
+    return failure();
+
+  // With --function-sections, each function is alone in its section.
+  DenseMap<uint64_t, StringRef> sectionFunctions;
+  for (const object::SymbolRef &sym : obj->symbols()) {
+    auto type = sym.getType();
+    auto name = sym.getName();
+    auto section = sym.getSection();
+    if (!type || !name || !section) {
+      consumeError(type.takeError());
+      consumeError(name.takeError());
+      consumeError(section.takeError());
+      return failure();
+    }
+    if (*type != object::SymbolRef::ST_Function ||
+        *section == obj->section_end())
+      continue;
+    sectionFunctions[(*section)->getIndex()] = *name;
+    frames[*name];
+  }
+
+  // Return the function that a relocation refers to, if any.
+  auto getRelocatedFunction =
+      [&](const object::RelocationRef &reloc) -> std::optional<StringRef> {
+    object::symbol_iterator sym = reloc.getSymbol();
+    if (sym == obj->symbol_end())
+      return std::nullopt;
+    auto section = sym->getSection();
+    if (!section) {
+      consumeError(section.takeError());
+      return std::nullopt;
+    }
+    if (*section == obj->section_end())
+      return StringRef();
+    auto it = sectionFunctions.find((*section)->getIndex());
+    if (it == sectionFunctions.end())
+      return std::nullopt;
+    return it->second;
+  };
+
+  for (const object::SectionRef &relSection : obj->sections()) {
+    auto relocated = relSection.getRelocatedSection();
+    if (!relocated) {
+      consumeError(relocated.takeError());
+      return failure();
+    }
+    if (*relocated == obj->section_end())
+      continue;
+    auto sectionName = (*relocated)->getName();
+    if (!sectionName) {
+      consumeError(sectionName.takeError());
+      return failure();
+    }
+
+    if (sectionName->starts_with(".stack_sizes")) {
+      // Each entry is the address of a function, set by a relocation, followed
+      // by the ULEB128 size of its frame.
+      auto contents = (*relocated)->getContents();
+      if (!contents) {
+        consumeError(contents.takeError());
+        return failure();
+      }
+      DenseMap<uint64_t, StringRef> entryFunctions;
+      for (const object::RelocationRef &reloc : relSection.relocations())
+        if (std::optional<StringRef> fn = getRelocatedFunction(reloc))
+          entryFunctions[reloc.getOffset()] = *fn;
+      const auto *data = contents->bytes_begin();
+      uint64_t offset = 0;
+      while (offset < contents->size()) {
+        auto fn = entryFunctions.find(offset);
+        offset += obj->getBytesInAddress();
+        unsigned len = 0;
+        const char *error = nullptr;
+        uint64_t size = decodeULEB128(data + offset, &len,
+                                      contents->bytes_end(), &error);
+        if (error || fn == entryFunctions.end())
+          return failure();
+        offset += len;
+        frames[fn->second].size = size;
+      }
+      continue;
+    }
+
+    auto fn = sectionFunctions.find((*relocated)->getIndex());
+    if (fn == sectionFunctions.end())
+      continue;
+    StackFrame &frame = frames[fn->second];
+    for (const object::RelocationRef &reloc : relSection.relocations()) {
+      std::optional<StringRef> callee = getRelocatedFunction(reloc);
+      if (!callee)
+        continue;
+      if (callee->empty())
+        frame.callsUnknown = true;
+      else
+        frame.callees.push_back(*callee);
+    }
+  }
+  return success();
+}
+
+// Return the largest depth of the stack of the calls from \p function, or
+// nothing if it calls code out of the object or is recursive.
+static std::optional<uint64_t>
+getStackDepth(StringRef function, StringMap<StackFrame> &frames,
+              StringMap<std::optional<uint64_t>> &depths,
+              StringSet<> &onPath) {
+  if (auto it = depths.find(function); it != depths.end())
+    return it->second;
+  auto frame = frames.find(function);
+  if (frame == frames.end() || !frame->second.size ||
+      frame->second.callsUnknown || !onPath.insert(function).second)
+    return std::nullopt;
+
+  std::optional<uint64_t> depth = 0;
+  for (StringRef callee : frame->second.callees) {
+    std::optional<uint64_t> calleeDepth =
+        getStackDepth(callee, frames, depths, onPath);
+    if (!calleeDepth) {
+      depth = std::nullopt;
+      break;
+    }
+    depth = std::max(*depth, *calleeDepth);
+  }
+  if (depth)
+    *depth += *frame->second.size;
+  onPath.erase(function);
+  depths[function] = depth;
+  return depth;
+}
+
+// Return the alignment of a buffer at \p address, as assumed by the lowering
+// of the cores.
+static uint32_t getBufferAlignment(int32_t address) {
+  auto offset = static_cast<uint32_t>(address);
+  return offset ? std::min(offset & (~offset + 1), 1024u) : 1024u;
+}
+
+// Shrink the stack of the cores to the depth of their calls in the unified
+// object \p objFile, and assign the buffer addresses again.  The stack of a
+// core is shrunk by whole KiB, so that the buffers keep the alignment the
+// object was compiled for, and is not changed if the depth of its calls is
+// unknown.
+static LogicalResult inferStackSizes(MLIRContext *context, ModuleOp moduleOp,
+                                     XCLBinGenConfig &TK, StringRef objFile) {
+  // The startup code of me_basic.o runs on the stack before the core.
+  constexpr uint64_t startupStackSize = 64;
+  constexpr int64_t stackSizeGranule = 1024;
+
+  object::OwningBinary<object::Binary> bin;
+  StringMap<StackFrame> frames;
+  if (failed(readStackFrames(objFile, bin, frames))) {
+    if (TK.Verbose)
+      llvm::outs() << "Couldn't read the stack frames of " << objFile << "\n";
+    return success();
+  }
+
+  auto deviceOps = moduleOp.getOps<AIE::DeviceOp>();
+  if (!llvm::hasSingleElement(deviceOps))
+    return moduleOp.emitOpError("expected a single device op");
+  AIE::DeviceOp deviceOp = *deviceOps.begin();
+
+  StringMap<std::optional<uint64_t>> depths;
+  DenseMap<Operation *, int32_t> oldStackSizes;
+  for (auto coreOp : deviceOp.getOps<AIE::CoreOp>()) {
+    std::string coreName = "core_" + std::to_string(coreOp.colIndex()) + "_" +
+                           std::to_string(coreOp.rowIndex());
+    StringSet<> onPath;
+    std::optional<uint64_t> depth =
+        getStackDepth(coreName, frames, depths, onPath);
+    if (!depth) {
+      if (TK.Verbose)
+        llvm::outs() << "Keeping the stack size of " << coreName << "\n";
+      continue;
+    }
+    int64_t needed = alignTo(*depth + startupStackSize, 16);
+    int32_t stackSize = coreOp.getStackSize();
+    int64_t newStackSize =
+        stackSize - (stackSize - needed) / stackSizeGranule * stackSizeGranule;
+    if (newStackSize >= stackSize)
+      continue;
+    if (TK.Verbose)
+      llvm::outs() << "Shrinking the stack of " << coreName << " from "
+                   << stackSize << " to " << newStackSize << " bytes ("
+                   << needed << " used)\n";
+    oldStackSizes[coreOp] = stackSize;
+    coreOp.setStackSizeAttr(
+        IntegerAttr::get(IntegerType::get(context, 32), newStackSize));
+  }
+  if (oldStackSizes.empty())
+    return success();
+
+  DenseMap<Operation *, int32_t> oldAddresses;
+  deviceOp.walk([&](AIE::BufferOp buffer) {
+    if (std::optional<int32_t> address = buffer.getAddress())
+      oldAddresses[buffer] = *address;
+    buffer.removeAddressAttr();
+  });
+  PassManager pm(context, moduleOp.getOperationName());
+  pm.addNestedPass<AIE::DeviceOp>(AIE::createAIEAssignBufferAddressesPass());
+  if (failed(pm.run(moduleOp)))
+    return moduleOp.emitOpError("Failed to assign the buffer addresses");
+
+  // The bank-aware allocation may move a buffer to another bank once there is
+  // more room in the first one, so check that no alignment got smaller.
+  bool keepsAlignment = llvm::all_of(oldAddresses, [](auto &it) {
+    auto buffer = cast<AIE::BufferOp>(it.first);
+    return buffer.getAddress() && getBufferAlignment(*buffer.getAddress()) >=
+                                      getBufferAlignment(it.second);
+  });
+  if (keepsAlignment)
+    return success();
+
+  if (TK.Verbose)
+    llvm::outs() << "Keeping the stack sizes, as the new buffer addresses "
+                    "are less aligned\n";
+  for (auto [op, stackSize] : oldStackSizes)
+    cast<AIE::CoreOp>(op).setStackSizeAttr(
+        IntegerAttr::get(IntegerType::get(context, 32), stackSize));
+  OpBuilder builder(context);
+  for (auto [op, address] : oldAddresses)
+    cast<AIE::BufferOp>(op).setAddressAttr(builder.getI32IntegerAttr(address));
+  return success();
+}
+
+// Return the number of bytes of program memory used by the ELF file
+// \p elfFile, which is the end of its last executable section, or nothing if
+// the file can't be read.
+static std::optional<uint64_t> getProgramMemoryUse(StringRef elfFile) {
+  auto binOrErr = object::createBinary(elfFile);
+  if (!binOrErr) {
+    consumeError(binOrErr.takeError());
+    return std::nullopt;
+  }
+  auto *obj = dyn_cast<object::ELFObjectFileBase>(binOrErr->getBinary());
+  if (!obj)
+    return std::nullopt;
+  uint64_t end = 0;
+  for (const object::SectionRef &section : obj->sections())
+    if (section.isText())
+      end = std::max(end, section.getAddress() + section.getSize());
+  return end;
+}
+
+// Report the program memory used by the ELF file of each core, and return the
+// largest fraction of the program memory, in percent, that a core uses.  The
+// cores that don't fit are reported as errors if \p allowOverflow is false.
+static FailureOr<uint64_t> checkProgramMemory(ModuleOp moduleOp,
+                                              XCLBinGenConfig &TK,
+                                              bool allowOverflow) {
+  auto deviceOps = moduleOp.getOps<AIE::DeviceOp>();
+  if (!llvm::hasSingleElement(deviceOps))
+    return moduleOp.emitOpError("expected a single device op");
+  AIE::DeviceOp deviceOp = *deviceOps.begin();
+  uint64_t limit = deviceOp.getTargetModel().getProgramMemorySize();
+
+  uint64_t maxPercent = 0;
+  bool overflow = false;
+  for (auto coreOp : deviceOp.getOps<AIE::CoreOp>()) {
+    auto elfFileAttr = coreOp.getElfFileAttr();
+    if (!elfFileAttr)
+      continue;
+    SmallString<64> elfFile(TK.TempDir);
+    sys::path::append(elfFile, elfFileAttr.getValue());
+    std::optional<uint64_t> size = getProgramMemoryUse(elfFile);
+    if (!size) {
+      if (TK.Verbose)
+        llvm::outs() << "Couldn't read the program size of " << elfFile
+                     << "\n";
+      continue;
+    }
+    uint64_t percent = *size * 100 / limit;
+    maxPercent = std::max(maxPercent, percent);
+    if (TK.Verbose || TK.ReportProgramMemory)
+      llvm::outs() << "Program memory of core (" << coreOp.colIndex() << ","
+                   << coreOp.rowIndex() << "): " << *size << " of " << limit
+                   << " bytes (" << percent << "%)\n";
+    if (*size > limit && !allowOverflow) {
+      coreOp.emitOpError("program of ")
+          << *size << " bytes doesn't fit in the " << limit
+          << " bytes of program memory";
+      overflow = true;
+    }
+  }
+  if (overflow)
+    return failure();
+  return maxPercent;
+}
+
 LogicalResult xilinx::aie2xclbin(MLIRContext *ctx, ModuleOp moduleOp,
                                  XCLBinGenConfig &TK, StringRef OutputIPU,
                                  StringRef OutputXCLBin) {
@@ -751,11 +1357,39 @@ LogicalResult xilinx::aie2xclbin(MLIRContext *ctx, ModuleOp moduleOp,
 
   SmallString<64> unifiedObj(TK.TempDir);
   sys::path::append(unifiedObj, "input.o");
-  if (failed(generateUnifiedObject(ctx, moduleOp, TK, std::string(unifiedObj))))
-    return moduleOp.emitOpError("Failed to generate unified object");
-
-  if (failed(generateCoreElfFiles(moduleOp, unifiedObj, TK)))
-    return moduleOp.emitOpError("Failed to generate core ELF file(s)");
+  auto generateCores = [&]() -> LogicalResult {
+    if (failed(
+            generateUnifiedObject(ctx, moduleOp, TK, std::string(unifiedObj))))
+      return moduleOp.emitOpError("Failed to generate unified object");
+
+    if (TK.InferStackSize && !TK.UseChess &&
+        failed(inferStackSizes(ctx, moduleOp, TK, unifiedObj)))
+      return moduleOp.emitOpError("Failed to infer the stack sizes");
+
+    if (failed(generateCoreElfFiles(moduleOp, unifiedObj, TK)))
+      return moduleOp.emitOpError("Failed to generate core ELF file(s)");
+    return success();
+  };
+  if (failed(generateCores()))
+    return failure();
+
+  // The cores are compiled again for size if one of them is close to the
+  // size of the program memory.
+  bool canOptimizeForSize =
+      !TK.UseChess && !TK.OptimizeForSize && TK.SizeOptThreshold;
+  FailureOr<uint64_t> programMemoryUse =
+      checkProgramMemory(moduleOp, TK, canOptimizeForSize);
+  if (failed(programMemoryUse))
+    return failure();
+  if (canOptimizeForSize && *programMemoryUse >= TK.SizeOptThreshold) {
+    if (TK.Verbose)
+      llvm::outs() << "A core uses " << *programMemoryUse
+                   << "% of the program memory, compiling for size\n";
+    TK.OptimizeForSize = true;
+    if (failed(generateCores()) ||
+        failed(checkProgramMemory(moduleOp, TK, /*allowOverflow=*/false)))
+      return failure();
+  }
 
   if (failed(generateCDO(ctx, moduleOp, TK)))
     return moduleOp.emitOpError("Failed to generate CDO");
@@ -14,6 +14,7 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include <string>
+#include <vector>
 
 #pragma once
 
@@ -31,6 +32,30 @@ struct XCLBinGenConfig {
   std::string XCLBinKernelID;
   std::string XCLBinInstanceName;
   bool UseChess = false;
+  // Number of per-core ELF files to build concurrently.  Zero selects the
+  // hardware concurrency of the host.
+  unsigned NumWorkers = 1;
+  // Directory of the persistent compile cache.  Empty disables caching.
+  std::string CacheDir;
+  // Shrink the stack reserved for each core to the depth of its calls in the
+  // compiled object.  Only supported with peano.
+  bool InferStackSize = false;
+  // Print the program memory used by each core.
+  bool ReportProgramMemory = false;
+  // Optimize the cores for size rather than speed.
+  bool OptimizeForSize = false;
+  // Compile the cores again for size when one of them uses at least this
+  // percentage of the program memory.  Zero disables it.  Only supported with
+  // peano.
+  unsigned SizeOptThreshold = 90;
+  // Columns at which the partition of the design can be loaded.  Empty allows
+  // each column the design fits at.
+  std::vector<unsigned> StartColumns;
+  // Precompiled kernel libraries, given by path or by name as lib<name>.a in
+  // the kernel library directories, and linked with the cores calling a
+  // function they define.
+  std::vector<std::string> KernelLibs;
+  std::vector<std::string> KernelLibDirs;
 };
 
 void findVitis(XCLBinGenConfig &TK);
@@ -87,6 +87,56 @@ cl::opt<std::string> InstallDir("install-dir",
 cl::opt<bool> UseChess("use-chess",
                        cl::desc("Use chess compiler instead of peano"),
                        cl::cat(AIE2XCLBinCat));
+cl::opt<unsigned>
+    NumWorkers("j",
+               cl::desc("Compile core ELF files with at most n threads "
+                        "(default is 1).  An argument of zero corresponds to "
+                        "the maximum number of threads on the machine."),
+               cl::init(1), cl::cat(AIE2XCLBinCat));
+cl::opt<bool> InferStackSize(
+    "infer-stack-size",
+    cl::desc("Shrink the stack of each core to the depth of its calls in the "
+             "compiled object, and give the freed memory to the buffers "
+             "(peano only)"),
+    cl::cat(AIE2XCLBinCat));
+cl::opt<bool>
+    ReportProgramMemory("report-program-memory",
+                        cl::desc("Print the program memory used by each core"),
+                        cl::cat(AIE2XCLBinCat));
+cl::opt<bool> OptimizeForSize("Os",
+                              cl::desc("Optimize the cores for size (peano "
+                                       "only)"),
+                              cl::cat(AIE2XCLBinCat));
+cl::opt<unsigned> SizeOptThreshold(
+    "size-opt-threshold",
+    cl::desc("Compile the cores again for size when a core uses at least this "
+             "percentage of the program memory (default is 90).  An argument "
+             "of zero disables it."),
+    cl::init(90), cl::cat(AIE2XCLBinCat));
+cl::list<unsigned>
+    StartColumns("start-columns", cl::CommaSeparated,
+                 cl::desc("Columns at which the partition of the design can be "
+                          "loaded (default is each column it fits at)"),
+                 cl::cat(AIE2XCLBinCat));
+cl::list<std::string>
+    KernelLibs("kernel-lib",
+               cl::desc("Precompiled kernel library linked with the cores "
+                        "calling the functions it defines, given by path or by "
+                        "name as lib<name>.a in the kernel library "
+                        "directories"),
+               cl::cat(AIE2XCLBinCat));
+cl::list<std::string>
+    KernelLibDirs("kernel-lib-dir",
+                  cl::desc("Directory searched for the kernel libraries given "
+                           "by name, before the kernels installed in "
+                           "aie_runtime_lib/<target>/kernels"),
+                  cl::cat(AIE2XCLBinCat));
+cl::opt<std::string>
+    CacheDir("cache-dir",
+             cl::desc("Directory used to cache compiled objects, core ELF "
+                      "files, PDIs and xclbins across builds (default is no "
+                      "caching)"),
+             cl::cat(AIE2XCLBinCat));
 
 int main(int argc, char *argv[]) {
   registerAsmPrinterCLOptions();
@@ -101,6 +151,15 @@ int main(int argc, char *argv[]) {
   TK.XCLBinKernelID = XCLBinKernelID;
   TK.XCLBinInstanceName = XCLBinInstanceName;
   TK.UseChess = UseChess;
+  TK.NumWorkers = NumWorkers;
+  TK.CacheDir = CacheDir;
+  TK.InferStackSize = InferStackSize;
+  TK.ReportProgramMemory = ReportProgramMemory;
+  TK.OptimizeForSize = OptimizeForSize;
+  TK.SizeOptThreshold = SizeOptThreshold;
+  TK.StartColumns.assign(StartColumns.begin(), StartColumns.end());
+  TK.KernelLibs.assign(KernelLibs.begin(), KernelLibs.end());
+  TK.KernelLibDirs.assign(KernelLibDirs.begin(), KernelLibDirs.end());
 
   findVitis(TK);
 
@@ -142,6 +201,19 @@ int main(int argc, char *argv[]) {
   if (Verbose)
     llvm::errs() << "Created temporary directory " << TK.TempDir << "\n";
 
+  if (TK.CacheDir.size()) {
+    SmallString<64> cacheDir(TK.CacheDir);
+    err = sys::fs::make_absolute(cacheDir);
+    if (!err)
+      err = sys::fs::create_directories(cacheDir);
+    if (err) {
+      llvm::errs() << "Failed to create cache directory " << TK.CacheDir
+                   << ": " << err.message() << "\n";
+      return 1;
+    }
+    TK.CacheDir = std::string(cacheDir);
+  }
+
   MLIRContext ctx;
   ParserConfig pcfg(&ctx);
   SourceMgr srcMgr;
@@ -0,0 +1,358 @@
+#!/usr/bin/env python3
+#
+# This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+# (c) Copyright 2024 Advanced Micro Devices, Inc.
+"""Time aie-opt pipelines and aie-translate targets on synthetic designs.
+
+Each benchmark generates designs of growing size, runs one tool invocation
+on each and records its wall time and peak memory as one JSON line, so that
+the scaling of the passes can be tracked across compiler versions.  The size
+is the number of tiles, flows or loops of the design:
+
+    objectfifo    a chain of objectFifos through 1 to 400 cores, lowered by
+                  -aie-objectFifo-stateful-transform
+    pathfinder    10 to 1500 circuit flows routed by
+                  -aie-create-pathfinder-flows
+    packet        10 to 2000 packet flows routed by -aie-create-packet-flows
+    aievec        1 to 400 vectorized loops lowered to AIEVec for AIE2
+    xaie, airbin  the routed pathfinder designs through aie-translate
+
+Run through the check-aie-compile-perf target, or directly:
+
+    compile_perf.py --aie-opt build/bin/aie-opt --aie-translate \\
+        build/bin/aie-translate -o compile-perf.jsonl
+
+With --baseline, the results more than --tolerance times slower or larger
+than those of an earlier results file fail the run.
+"""
+
+import argparse
+import json
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+# xcvc1902 has 50 columns of 8 core tiles.
+COLS = 50
+ROWS = 8
+
+TILE_SIZES = [1, 4, 16, 64, 144, 256, 400]
+FLOW_SIZES = [10, 100, 500, 1000, 1500]
+PACKET_FLOW_SIZES = [10, 100, 500, 1000, 2000]
+
+# Circuit flows use each of these ports of a core tile at most once, as
+# source and as destination.
+PORTS = [("DMA", 0), ("DMA", 1), ("Core", 0), ("Core", 1)]
+
+
+def core_tiles(count):
+    """The first `count` core tiles, filling the columns from the left."""
+    return [(c, r) for c in range(COLS) for r in range(1, ROWS + 1)][:count]
+
+
+def tile_decls(tiles):
+    return "".join(f"    %t{c}_{r} = aie.tile({c}, {r})\n" for c, r in tiles)
+
+
+def objectfifo_design(tiles):
+    """A chain of depth 2 objectFifos, each core forwarding to the next."""
+    tiles = core_tiles(tiles)
+    body = tile_decls(tiles)
+    for i, (a, b) in enumerate(zip(tiles, tiles[1:])):
+        body += (
+            f"    aie.objectfifo @of{i}(%t{a[0]}_{a[1]}, {{%t{b[0]}_{b[1]}}}, "
+            "2 : i32) : !aie.objectfifo<memref<256xi32>>\n"
+        )
+    for i, (c, r) in enumerate(tiles):
+        ops = ""
+        if i > 0:
+            ops += (
+                f"        %in = aie.objectfifo.acquire @of{i - 1}(Consume, 1) : "
+                "!aie.objectfifosubview<memref<256xi32>>\n"
+                f"        aie.objectfifo.release @of{i - 1}(Consume, 1)\n"
+            )
+        if i + 1 < len(tiles):
+            ops += (
+                f"        %out = aie.objectfifo.acquire @of{i}(Produce, 1) : "
+                "!aie.objectfifosubview<memref<256xi32>>\n"
+                f"        aie.objectfifo.release @of{i}(Produce, 1)\n"
+            )
+        body += (
+            f"    aie.core(%t{c}_{r}) {{\n"
+            "      %c0 = arith.constant 0 : index\n"
+            "      %c1 = arith.constant 1 : index\n"
+            "      %c16 = arith.constant 16 : index\n"
+            "      scf.for %i = %c0 to %c16 step %c1 {\n"
+            f"{ops}"
+            "      }\n"
+            "      aie.end\n"
+            "    }\n"
+        )
+    return f"module {{\n  aie.device(xcvc1902) {{\n{body}  }}\n}}\n"
+
+
+def random_pairs(flows, rng):
+    """Source and destination ports of circuit flows between core tiles at
+    most 8 tiles apart, each port being used once."""
+    tiles = core_tiles(COLS * ROWS)
+    sources = [(t, p) for t in tiles for p in PORTS]
+    dests = list(sources)
+    rng.shuffle(sources)
+    pairs = []
+    for (src, sport) in sources[:flows]:
+        near = [
+            d
+            for d in dests
+            if d[0] != src and abs(d[0][0] - src[0]) + abs(d[0][1] - src[1]) <= 8
+        ]
+        if not near:
+            continue
+        dst = rng.choice(near)
+        dests.remove(dst)
+        pairs.append(((src, sport), dst))
+    return pairs
+
+
+def port(p):
+    return f"{p[0]} : {p[1]}"
+
+
+def flow_design(flows, seed=0):
+    rng = random.Random(seed)
+    pairs = random_pairs(flows, rng)
+    body = tile_decls(core_tiles(COLS * ROWS))
+    for (src, sport), (dst, dport) in pairs:
+        body += (
+            f"    aie.flow(%t{src[0]}_{src[1]}, {port(sport)}, "
+            f"%t{dst[0]}_{dst[1]}, {port(dport)})\n"
+        )
+    return f"module {{\n  aie.device(xcvc1902) {{\n{body}  }}\n}}\n"
+
+
+def packet_flow_design(flows, seed=0):
+    """Packet flows from the DMA channels of the core tiles to the DMA
+    channels of tiles at most 8 tiles away, sharing ports beyond 800 flows."""
+    rng = random.Random(seed)
+    tiles = core_tiles(COLS * ROWS)
+    body = tile_decls(tiles)
+    for i in range(flows):
+        src = tiles[i % len(tiles)]
+        near = [
+            t
+            for t in tiles
+            if t != src and abs(t[0] - src[0]) + abs(t[1] - src[1]) <= 8
+        ]
+        dst = rng.choice(near)
+        channel = (i // len(tiles)) % 2
+        body += (
+            f"    aie.packet_flow({i % 32}) {{\n"
+            f"      aie.packet_source<%t{src[0]}_{src[1]}, DMA : {channel}>\n"
+            f"      aie.packet_dest<%t{dst[0]}_{dst[1]}, DMA : {channel}>\n"
+            "    }\n"
+        )
+    return f"module {{\n  aie.device(xcvc1902) {{\n{body}  }}\n}}\n"
+
+
+def aievec_design(loops):
+    """`loops` elementwise multiply-add loops, one function each, as the
+    kernels of as many cores would be."""
+    funcs = ""
+    for i in range(loops):
+        funcs += (
+            f"  func.func @kernel{i}(%a: memref<1024xi32>, %b: memref<1024xi32>, "
+            "%c: memref<1024xi32>) {\n"
+            "    affine.for %i = 0 to 1024 {\n"
+            "      %0 = affine.load %a[%i] : memref<1024xi32>\n"
+            "      %1 = affine.load %b[%i] : memref<1024xi32>\n"
+            "      %2 = arith.muli %0, %1 : i32\n"
+            "      %3 = arith.addi %2, %0 : i32\n"
+            "      affine.store %3, %c[%i] : memref<1024xi32>\n"
+            "    }\n"
+            "    return\n"
+            "  }\n"
+        )
+    return f"module {{\n{funcs}}}\n"
+
+
+# name: (generator, sizes, tool, arguments)
+BENCHMARKS = {
+    "objectfifo": (
+        objectfifo_design,
+        TILE_SIZES,
+        "aie-opt",
+        ["-aie-objectFifo-stateful-transform"],
+    ),
+    "pathfinder": (
+        flow_design,
+        FLOW_SIZES,
+        "aie-opt",
+        ["-aie-create-pathfinder-flows"],
+    ),
+    "packet": (
+        packet_flow_design,
+        PACKET_FLOW_SIZES,
+        "aie-opt",
+        ["-aie-create-packet-flows"],
+    ),
+    "aievec": (
+        aievec_design,
+        TILE_SIZES,
+        "aie-opt",
+        [
+            "-affine-super-vectorize=virtual-vector-size=16",
+            "--convert-vector-to-aievec=aie-target=aieml",
+            "-lower-affine",
+        ],
+    ),
+}
+
+# Translations of the routed flow designs.
+TRANSLATIONS = {
+    "xaie": ["--aie-generate-xaie"],
+    "airbin": ["--aie-generate-airbin"],
+}
+
+
+def run(cmd):
+    """Run `cmd`, returning its wall time in seconds, peak resident memory
+    in KiB, exit status and error output."""
+    # The error output goes to a file rather than a pipe, which the child
+    # could fill before it is waited for.
+    with tempfile.TemporaryFile() as err:
+        start = time.perf_counter()
+        proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=err)
+        _, status, usage = os.wait4(proc.pid, 0)
+        elapsed = time.perf_counter() - start
+        proc.returncode = os.waitstatus_to_exitcode(status)
+        err.seek(0)
+        stderr = err.read().decode(errors="replace")
+    return elapsed, usage.ru_maxrss, proc.returncode, stderr
+
+
+def load_baseline(path):
+    """The last result of each (benchmark, size) of a previous results file."""
+    baseline = {}
+    with open(path) as f:
+        for line in f:
+            result = json.loads(line)
+            baseline[(result["benchmark"], result["size"])] = result
+    return baseline
+
+
+class Recorder:
+    """Writes the results, and compares them to a baseline if one is given."""
+
+    def __init__(self, out, baseline, tolerance):
+        self.out = out
+        self.baseline = baseline
+        self.tolerance = tolerance
+        self.failures = 0
+
+    def record(self, benchmark, size, elapsed, rss, status, stderr):
+        result = {
+            "benchmark": benchmark,
+            "size": size,
+            "seconds": round(elapsed, 4),
+            "max_rss_kib": rss,
+            "status": status,
+        }
+        line = json.dumps(result)
+        print(line, flush=True)
+        self.out.write(line + "\n")
+        self.out.flush()
+        if status:
+            self.failures += 1
+            sys.stderr.write(stderr)
+            return
+        old = self.baseline.get((benchmark, size))
+        if not old or old["status"]:
+            return
+        # Ignore the noise of runs too short to time reliably.
+        for key, floor in (("seconds", 0.1), ("max_rss_kib", 64 * 1024)):
+            if result[key] > max(old[key] * self.tolerance, floor):
+                self.failures += 1
+                print(
+                    f"regression: {benchmark} {size}: {key} {old[key]} -> "
+                    f"{result[key]}",
+                    file=sys.stderr,
+                )
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(
+        description="Time the compiler on synthetic designs of growing size"
+    )
+    parser.add_argument("--aie-opt", default="aie-opt")
+    parser.add_argument("--aie-translate", default="aie-translate")
+    parser.add_argument(
+        "-o", "--output", default="compile-perf.jsonl", help="JSON lines results"
+    )
+    parser.add_argument(
+        "--benchmarks",
+        default=",".join(list(BENCHMARKS) + list(TRANSLATIONS)),
+        help="comma separated benchmarks to run",
+    )
+    parser.add_argument(
+        "--max-size", type=int, help="skip the designs larger than this"
+    )
+    parser.add_argument(
+        "--baseline", help="fail on the results slower or larger than these"
+    )
+    parser.add_argument(
+        "--tolerance",
+        type=float,
+        default=1.5,
+        help="ratio to the baseline counted as a regression",
+    )
+    parser.add_argument(
+        "--keep", metavar="DIR", help="keep the generated designs in DIR"
+    )
+    opts = parser.parse_args(argv)
+
+    selected = opts.benchmarks.split(",")
+    translations = [t for t in TRANSLATIONS if t in selected]
+    tools = {"aie-opt": opts.aie_opt, "aie-translate": opts.aie_translate}
+    baseline = load_baseline(opts.baseline) if opts.baseline else {}
+    workdir = opts.keep or tempfile.mkdtemp(prefix="aie-compile-perf-")
+    os.makedirs(workdir, exist_ok=True)
+
+    with open(opts.output, "a") as out:
+        recorder = Recorder(out, baseline, opts.tolerance)
+        for name, (generate, sizes, tool, args) in BENCHMARKS.items():
+            # The translations run on the routed pathfinder designs.
+            if name not in selected and not (name == "pathfinder" and translations):
+                continue
+            for size in sizes:
+                if opts.max_size and size > opts.max_size:
+                    continue
+                design = os.path.join(workdir, f"{name}_{size}.mlir")
+                with open(design, "w") as f:
+                    f.write(generate(size))
+                lowered = os.path.join(workdir, f"{name}_{size}.out.mlir")
+                elapsed, rss, status, stderr = run(
+                    [tools[tool], *args, design, "-o", lowered]
+                )
+                if name in selected:
+                    recorder.record(name, size, elapsed, rss, status, stderr)
+                if status or name != "pathfinder":
+                    continue
+                for tname in translations:
+                    target = os.path.join(workdir, f"{tname}_{size}")
+                    cmd = [tools["aie-translate"], *TRANSLATIONS[tname]]
+                    recorder.record(
+                        tname, size, *run(cmd + [lowered, "-o", target])
+                    )
+    if not opts.keep:
+        shutil.rmtree(workdir)
+    return 1 if recorder.failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())